@@ -40,10 +40,13 @@
 #ifdef URHO3D_PHYSICS
 #include <Urho3D/Physics/PhysicsWorld.h>
 #endif
+#include <Urho3D/Resource/JSONFile.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Resource/XMLFile.h>
 #include <Urho3D/Scene/Scene.h>
 
+#include <EASTL/sort.h>
+
 #ifdef WIN32
 #include <windows.h>
 #endif
@@ -164,6 +167,9 @@ bool noOverwriteTexture_ = false;
 bool noOverwriteNewerTexture_ = false;
 bool checkUniqueModel_ = true;
 bool moveToBindPose_ = false;
+bool optimizeMeshes_ = true;
+ea::vector<float> lodDistances_;
+ea::vector<float> lodRatios_;
 unsigned maxBones_ = 64;
 ea::vector<ea::string> nonSkinningBoneIncludes_;
 ea::vector<ea::string> nonSkinningBoneExcludes_;
@@ -179,6 +185,8 @@ bool suppressFbxPivotNodes_ = true;
 
 int main(int argc, char** argv);
 void Run(const ea::vector<ea::string>& arguments);
+void RunBatch(const ea::vector<ea::string>& arguments);
+unsigned HashFileContent(const ea::string& fileName);
 void DumpNodes(aiNode* rootNode, unsigned level);
 
 void ExportModel(const ea::string& outName, bool animationOnly);
@@ -189,6 +197,10 @@ void CollectBonesFinal(ea::vector<aiNode*>& dest, const ea::hash_set<aiNode*>& n
 void MoveToBindPose(OutModel& model, aiNode* current);
 void CollectAnimations(OutModel* model = nullptr);
 void BuildBoneCollisionInfo(OutModel& model);
+void OptimizeIndexOrder(ea::vector<unsigned>& indices, unsigned vertexCount);
+void OptimizeVertexFetch(ea::vector<unsigned>& indices, unsigned char* vertexData, unsigned vertexCount, unsigned vertexSize);
+ea::vector<unsigned> GenerateLodIndices(const ea::vector<unsigned>& srcIndices, const ea::vector<Vector3>& positions,
+    unsigned targetTriangles);
 void BuildAndSaveModel(OutModel& model);
 void BuildAndSaveAnimations(OutModel* model = nullptr);
 
@@ -217,8 +229,6 @@ ea::string GenerateMaterialName(aiMaterial* material);
 ea::string GenerateTextureName(unsigned texIndex);
 unsigned GetNumValidFaces(aiMesh* mesh);
 
-void WriteShortIndices(unsigned short*& dest, aiMesh* mesh, unsigned index, unsigned offset);
-void WriteLargeIndices(unsigned*& dest, aiMesh* mesh, unsigned index, unsigned offset);
 void WriteVertex(float*& dest, aiMesh* mesh, unsigned index, bool isSkinned, BoundingBox& box,
     const Matrix3x4& vertexTransform, const Matrix3& normalTransform, ea::vector<ea::vector<unsigned char> >& blendIndices,
     ea::vector<ea::vector<float> >& blendWeights);
@@ -271,6 +281,9 @@ void Run(const ea::vector<ea::string>& arguments)
             "dump        Dump scene node structure. No output file is generated\n"
             "lod         Combine several Urho3D models as LOD levels of the output model\n"
             "            Syntax: lod <dist0> <mdl0> <dist1 <mdl1> ... <output file>\n"
+            "batch       Import all assets found in a directory with parallel child processes,\n"
+            "            skipping assets whose source files are unchanged since the last run\n"
+            "            Syntax: batch <model|anim|scene|node> <input dir> <output dir> [options]\n"
             "\n"
             "Options:\n"
             "-b          Save scene in binary format, default format is XML\n"
@@ -287,6 +300,11 @@ void Run(const ea::vector<ea::string>& arguments)
             "-nz         Do not create a zone and a directional light (scene mode only)\n"
             "-nf         Do not fix infacing normals\n"
             "-ne         Do not save empty nodes (scene mode only)\n"
+            "-no         Do not optimize vertex and index order for GPU cache efficiency\n"
+            "-lods <d1> <r1> [<d2> <r2> ...]\n"
+            "            Generate automatic LOD levels for model geometries. Each distance/\n"
+            "            ratio pair adds a level simplified to the given ratio (0-1) of the\n"
+            "            original triangle count, used beyond the given distance\n"
             "-mb <x>     Maximum number of bones per submesh. Default 64\n"
             "-p <path>   Set path for scene resources. Default is output file path\n"
             "-pp <path>  Prepend path to resources. Default is empty\n"
@@ -323,6 +341,12 @@ void Run(const ea::vector<ea::string>& arguments)
     ea::string command = arguments[0].to_lower();
     ea::string rootNodeName;
 
+    if (command == "batch")
+    {
+        RunBatch(arguments);
+        return;
+    }
+
     unsigned flags =
         aiProcess_ConvertToLeftHanded |
         aiProcess_JoinIdenticalVertices |
@@ -405,6 +429,10 @@ void Run(const ea::vector<ea::string>& arguments)
                         suppressFbxPivotNodes_ = false;
                     break;
 
+                case 'o':
+                    optimizeMeshes_ = false;
+                    break;
+
                 }
             }
             else if (argument == "mb" && !value.empty())
@@ -463,6 +491,24 @@ void Run(const ea::vector<ea::string>& arguments)
                 checkUniqueModel_ = false;
             else if (argument == "bp")
                 moveToBindPose_ = true;
+            else if (argument == "lods")
+            {
+                // Read distance/ratio pairs until the next option
+                while (i + 2 < arguments.size() && arguments[i + 1][0] != '-' && arguments[i + 2][0] != '-')
+                {
+                    float distance = ToFloat(arguments[i + 1]);
+                    float ratio = ToFloat(arguments[i + 2]);
+                    i += 2;
+                    if (ratio <= 0.0f || ratio >= 1.0f)
+                        ErrorExit("LOD triangle ratio must be between 0 and 1");
+                    if (lodDistances_.size() && distance <= lodDistances_.back())
+                        ErrorExit("LOD distances must be in ascending order");
+                    lodDistances_.push_back(distance);
+                    lodRatios_.push_back(ratio);
+                }
+                if (lodRatios_.empty())
+                    ErrorExit("No distance/ratio pairs given for -lods");
+            }
             else if (argument == "split")
             {
                 ea::string value2 = i + 2 < arguments.size() ? arguments[i + 2] : EMPTY_STRING;
@@ -625,6 +671,184 @@ void Run(const ea::vector<ea::string>& arguments)
         ErrorExit("Unrecognized command " + command);
 }
 
+unsigned HashFileContent(const ea::string& fileName)
+{
+    File file(context_);
+    if (!file.Open(fileName))
+        return 0;
+
+    unsigned hash = 0;
+    unsigned char buffer[4096];
+    while (!file.IsEof())
+    {
+        unsigned readBytes = file.Read(buffer, sizeof(buffer));
+        for (unsigned i = 0; i < readBytes; ++i)
+            hash = SDBMHash(hash, buffer[i]);
+    }
+
+    return hash;
+}
+
+void RunBatch(const ea::vector<ea::string>& arguments)
+{
+    if (arguments.size() < 4)
+        ErrorExit("Usage: AssetImporter batch <model|anim|scene|node> <input dir> <output dir> [options]");
+
+    ea::string command = arguments[1].to_lower();
+    if (command != "model" && command != "anim" && command != "scene" && command != "node")
+        ErrorExit("Unsupported batch command " + command);
+
+    ea::string inputDir = AddTrailingSlash(GetInternalPath(arguments[2]));
+    ea::string outputDir = AddTrailingSlash(GetInternalPath(arguments[3]));
+    ea::vector<ea::string> options;
+    for (unsigned i = 4; i < arguments.size(); ++i)
+        options.push_back(arguments[i]);
+
+    auto* fileSystem = context_->GetFileSystem();
+    fileSystem->CreateDirsRecursive(outputDir);
+
+    // The import options take part in the cache key so that changing flags re-imports everything
+    unsigned optionsHash = 0;
+    for (char c : command)
+        optionsHash = SDBMHash(optionsHash, (unsigned char)c);
+    for (const ea::string& option : options)
+    {
+        for (char c : option)
+            optionsHash = SDBMHash(optionsHash, (unsigned char)c);
+    }
+
+    // Output extension follows the command and the requested scene format
+    ea::string outExtension = command == "model" ? ".mdl" : command == "anim" ? ".ani" : ".xml";
+    if (command == "scene" || command == "node")
+    {
+        if (options.contains("-b"))
+            outExtension = ".bin";
+        else if (options.contains("-j"))
+            outExtension = ".json";
+    }
+
+    const char* importExtensions[] = {
+        ".fbx", ".dae", ".obj", ".blend", ".3ds", ".x", ".gltf", ".glb", ".lwo", ".ase", ".ply", nullptr
+    };
+
+    ea::vector<ea::string> fileNames;
+    fileSystem->ScanDir(fileNames, inputDir, "*", SCAN_FILES, true);
+    ea::quick_sort(fileNames.begin(), fileNames.end());
+
+    // Load the import cache. Entries record source file modification time, content hash and options hash
+    ea::string cacheFileName = outputDir + "AssetImporterCache.json";
+    SharedPtr<JSONFile> cacheFile(new JSONFile(context_));
+    {
+        File src(context_);
+        if (src.Open(cacheFileName))
+            cacheFile->Load(src);
+    }
+    JSONValue& cacheRoot = cacheFile->GetRoot();
+
+    struct BatchItem
+    {
+        ea::string sourceName_;
+        ea::string cacheValue_;
+        int exitCode_{-1};
+    };
+
+    ea::vector<BatchItem> items;
+    unsigned skipped = 0;
+
+    for (const ea::string& fileName : fileNames)
+    {
+        ea::string extension = GetExtension(fileName);
+        bool importable = false;
+        for (unsigned i = 0; importExtensions[i]; ++i)
+        {
+            if (extension == importExtensions[i])
+            {
+                importable = true;
+                break;
+            }
+        }
+        if (!importable)
+            continue;
+
+        unsigned mtime = fileSystem->GetLastModifiedTime(inputDir + fileName);
+        ea::vector<ea::string> cached = cacheRoot.Get(fileName).GetString().split('/');
+
+        // Unchanged modification time short-circuits content hashing entirely
+        if (cached.size() == 3 && cached[0] == ea::to_string(mtime) && cached[2] == ea::to_string(optionsHash))
+        {
+            ++skipped;
+            continue;
+        }
+
+        unsigned contentHash = HashFileContent(inputDir + fileName);
+        ea::string cacheValue = ea::to_string(mtime) + "/" + ea::to_string(contentHash) + "/" + ea::to_string(optionsHash);
+        if (cached.size() == 3 && cached[1] == ea::to_string(contentHash) && cached[2] == ea::to_string(optionsHash))
+        {
+            // Content is unchanged, only refresh the stored modification time
+            cacheRoot.Set(fileName, JSONValue(cacheValue));
+            ++skipped;
+            continue;
+        }
+
+        BatchItem item;
+        item.sourceName_ = fileName;
+        item.cacheValue_ = cacheValue;
+        items.push_back(ea::move(item));
+    }
+
+    if (!items.empty())
+    {
+        // Import the changed assets with parallel child processes so that the Assimp decode, scene processing and
+        // output writing of different files overlap
+        auto* workQueue = context_->GetSubsystem<WorkQueue>();
+        workQueue->CreateThreads(Min((unsigned)items.size(), GetNumLogicalCPUs()));
+
+        ea::string exeFileName = fileSystem->GetProgramFileName();
+
+        for (BatchItem& item : items)
+        {
+            workQueue->AddWorkItem([&item, &command, &inputDir, &outputDir, &outExtension, &options, &exeFileName, fileSystem]()
+            {
+                ea::vector<ea::string> childArguments;
+                childArguments.push_back(command);
+                childArguments.push_back(inputDir + item.sourceName_);
+                childArguments.push_back(outputDir + ReplaceExtension(item.sourceName_, outExtension));
+                childArguments.insert(childArguments.end(), options.begin(), options.end());
+                item.exitCode_ = fileSystem->SystemRun(exeFileName, childArguments);
+            }, M_MAX_UNSIGNED);
+        }
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+
+    unsigned imported = 0;
+    unsigned failed = 0;
+    for (const BatchItem& item : items)
+    {
+        if (item.exitCode_ == 0)
+        {
+            cacheRoot.Set(item.sourceName_, JSONValue(item.cacheValue_));
+            ++imported;
+        }
+        else
+        {
+            PrintLine("Import failed for " + item.sourceName_);
+            ++failed;
+        }
+    }
+
+    {
+        File dest(context_);
+        if (dest.Open(cacheFileName, FILE_WRITE))
+            cacheFile->Save(dest, "\t");
+        else
+            PrintLine("Warning: could not save import cache " + cacheFileName);
+    }
+
+    PrintLine("Imported " + ea::to_string(imported) + " assets, skipped " + ea::to_string(skipped) + " unchanged");
+    if (failed)
+        ErrorExit(ea::to_string(failed) + " assets failed to import");
+}
+
 void DumpNodes(aiNode* rootNode, unsigned level)
 {
     if (!rootNode)
@@ -991,6 +1215,345 @@ void BuildBoneCollisionInfo(OutModel& model)
     }
 }
 
+static const unsigned OPTIMIZE_VERTEX_CACHE_SIZE = 32;
+
+float CalculateVertexScore(int cachePosition, unsigned activeTriangles)
+{
+    // Linear-speed vertex cache optimization scoring (Forsyth.) Vertices with no remaining triangles never get chosen
+    if (!activeTriangles)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+        {
+            // The most recent triangle's vertices get a fixed score to avoid just emitting fans of adjacent triangles
+            score = 0.75f;
+        }
+        else
+            score = Pow(1.0f - (float)(cachePosition - 3) / (float)(OPTIMIZE_VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+
+    // Boost vertices with few remaining triangles so that lone vertices get finished off early
+    score += 2.0f * Pow((float)activeTriangles, -0.5f);
+    return score;
+}
+
+void OptimizeIndexOrder(ea::vector<unsigned>& indices, unsigned vertexCount)
+{
+    unsigned triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || !vertexCount)
+        return;
+
+    // Build per-vertex triangle adjacency
+    ea::vector<unsigned> activeTriangles(vertexCount, 0);
+    for (unsigned i = 0; i < indices.size(); ++i)
+        ++activeTriangles[indices[i]];
+
+    ea::vector<unsigned> triangleOffsets(vertexCount + 1, 0);
+    for (unsigned i = 0; i < vertexCount; ++i)
+        triangleOffsets[i + 1] = triangleOffsets[i] + activeTriangles[i];
+
+    ea::vector<unsigned> vertexTriangles(indices.size());
+    {
+        ea::vector<unsigned> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (unsigned t = 0; t < triangleCount; ++t)
+        {
+            for (unsigned j = 0; j < 3; ++j)
+                vertexTriangles[fillOffsets[indices[t * 3 + j]]++] = t;
+        }
+    }
+
+    ea::vector<float> vertexScores(vertexCount);
+    ea::vector<int> cachePositions(vertexCount, -1);
+    for (unsigned i = 0; i < vertexCount; ++i)
+        vertexScores[i] = CalculateVertexScore(-1, activeTriangles[i]);
+
+    ea::vector<float> triangleScores(triangleCount);
+    ea::vector<bool> triangleEmitted(triangleCount, false);
+    for (unsigned t = 0; t < triangleCount; ++t)
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+    ea::vector<unsigned> newIndices;
+    newIndices.reserve(indices.size());
+
+    // Modeled cache holds three extra entries for the vertices of the triangle being emitted
+    unsigned cache[OPTIMIZE_VERTEX_CACHE_SIZE + 3];
+    unsigned cacheCount = 0;
+    int bestTriangle = -1;
+
+    for (unsigned emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        if (bestTriangle < 0)
+        {
+            // No candidate among the cached vertices' triangles; fall back to a scan for the best remaining one
+            float bestScore = -M_INFINITY;
+            for (unsigned t = 0; t < triangleCount; ++t)
+            {
+                if (!triangleEmitted[t] && triangleScores[t] > bestScore)
+                {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (int)t;
+                }
+            }
+        }
+
+        unsigned emitTriangle = (unsigned)bestTriangle;
+        triangleEmitted[emitTriangle] = true;
+
+        unsigned newCache[OPTIMIZE_VERTEX_CACHE_SIZE + 3];
+        unsigned newCacheCount = 0;
+
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            unsigned v = indices[emitTriangle * 3 + j];
+            newIndices.push_back(v);
+            newCache[newCacheCount++] = v;
+
+            // Remove the emitted triangle from the vertex's remaining triangle list
+            unsigned begin = triangleOffsets[v];
+            unsigned end = begin + activeTriangles[v];
+            for (unsigned k = begin; k < end; ++k)
+            {
+                if (vertexTriangles[k] == emitTriangle)
+                {
+                    vertexTriangles[k] = vertexTriangles[end - 1];
+                    break;
+                }
+            }
+            --activeTriangles[v];
+        }
+
+        // Push the old cache contents after the emitted triangle's vertices
+        for (unsigned j = 0; j < cacheCount; ++j)
+        {
+            unsigned v = cache[j];
+            if (v == newCache[0] || v == newCache[1] || v == newCache[2])
+                continue;
+            if (newCacheCount < OPTIMIZE_VERTEX_CACHE_SIZE + 3)
+                newCache[newCacheCount++] = v;
+            else
+                cachePositions[v] = -1;
+        }
+
+        memcpy(cache, newCache, newCacheCount * sizeof(unsigned));
+        cacheCount = newCacheCount;
+
+        // Rescore the cached vertices and find the next best triangle among their remaining triangles
+        bestTriangle = -1;
+        float bestScore = -M_INFINITY;
+        for (unsigned j = 0; j < cacheCount; ++j)
+        {
+            unsigned v = cache[j];
+            cachePositions[v] = j < OPTIMIZE_VERTEX_CACHE_SIZE ? (int)j : -1;
+            float newScore = CalculateVertexScore(cachePositions[v], activeTriangles[v]);
+            float delta = newScore - vertexScores[v];
+            vertexScores[v] = newScore;
+
+            unsigned begin = triangleOffsets[v];
+            unsigned end = begin + activeTriangles[v];
+            for (unsigned k = begin; k < end; ++k)
+                triangleScores[vertexTriangles[k]] += delta;
+        }
+        for (unsigned j = 0; j < cacheCount; ++j)
+        {
+            unsigned v = cache[j];
+            unsigned begin = triangleOffsets[v];
+            unsigned end = begin + activeTriangles[v];
+            for (unsigned k = begin; k < end; ++k)
+            {
+                unsigned t = vertexTriangles[k];
+                if (!triangleEmitted[t] && triangleScores[t] > bestScore)
+                {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (int)t;
+                }
+            }
+        }
+    }
+
+    indices = newIndices;
+}
+
+void OptimizeVertexFetch(ea::vector<unsigned>& indices, unsigned char* vertexData, unsigned vertexCount, unsigned vertexSize)
+{
+    // Reorder vertices into first-use order so that the post-transform index sequence also reads vertex memory linearly
+    ea::vector<unsigned> remap(vertexCount, M_MAX_UNSIGNED);
+    unsigned nextVertex = 0;
+    for (unsigned i = 0; i < indices.size(); ++i)
+    {
+        unsigned& newIndex = remap[indices[i]];
+        if (newIndex == M_MAX_UNSIGNED)
+            newIndex = nextVertex++;
+        indices[i] = newIndex;
+    }
+    // Keep unreferenced vertices at the end in their original relative order
+    for (unsigned i = 0; i < vertexCount; ++i)
+    {
+        if (remap[i] == M_MAX_UNSIGNED)
+            remap[i] = nextVertex++;
+    }
+
+    ea::vector<unsigned char> oldData(vertexData, vertexData + (size_t)vertexCount * vertexSize);
+    for (unsigned i = 0; i < vertexCount; ++i)
+        memcpy(vertexData + (size_t)remap[i] * vertexSize, &oldData[(size_t)i * vertexSize], vertexSize);
+}
+
+/// Symmetric 4x4 error quadric accumulated from face planes, used for LOD simplification.
+struct ErrorQuadric
+{
+    /// Upper triangle of the symmetric matrix.
+    double m_[10]{};
+
+    void AddPlane(double a, double b, double c, double d, double w)
+    {
+        m_[0] += a * a * w; m_[1] += a * b * w; m_[2] += a * c * w; m_[3] += a * d * w;
+        m_[4] += b * b * w; m_[5] += b * c * w; m_[6] += b * d * w;
+        m_[7] += c * c * w; m_[8] += c * d * w;
+        m_[9] += d * d * w;
+    }
+
+    void Add(const ErrorQuadric& rhs)
+    {
+        for (unsigned i = 0; i < 10; ++i)
+            m_[i] += rhs.m_[i];
+    }
+
+    double Evaluate(const Vector3& p) const
+    {
+        double x = p.x_, y = p.y_, z = p.z_;
+        return m_[0] * x * x + 2.0 * m_[1] * x * y + 2.0 * m_[2] * x * z + 2.0 * m_[3] * x +
+            m_[4] * y * y + 2.0 * m_[5] * y * z + 2.0 * m_[6] * y +
+            m_[7] * z * z + 2.0 * m_[8] * z +
+            m_[9];
+    }
+};
+
+ea::vector<unsigned> GenerateLodIndices(const ea::vector<unsigned>& srcIndices, const ea::vector<Vector3>& positions,
+    unsigned targetTriangles)
+{
+    // Quadric edge collapse simplification. Collapses always move a vertex onto an existing neighbor, so the
+    // simplified index list reuses the original vertex data and no new attributes need to be synthesized.
+    // Edges appearing in only one triangle (open borders, and both sides of attribute seams in an unwelded
+    // mesh) are locked to preserve the silhouette and texture seams
+    unsigned vertexCount = positions.size();
+    ea::vector<unsigned> collapseMap(vertexCount);
+    for (unsigned i = 0; i < vertexCount; ++i)
+        collapseMap[i] = i;
+
+    ea::vector<unsigned> indices;
+    static const unsigned MAX_SIMPLIFY_PASSES = 25;
+
+    for (unsigned pass = 0; pass < MAX_SIMPLIFY_PASSES; ++pass)
+    {
+        // Apply the collapses so far and drop triangles that have become degenerate
+        indices.clear();
+        for (unsigned i = 0; i + 2 < srcIndices.size(); i += 3)
+        {
+            unsigned tri[3];
+            for (unsigned j = 0; j < 3; ++j)
+            {
+                unsigned v = srcIndices[i + j];
+                while (collapseMap[v] != v)
+                    v = collapseMap[v];
+                tri[j] = v;
+            }
+            if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2])
+            {
+                indices.push_back(tri[0]);
+                indices.push_back(tri[1]);
+                indices.push_back(tri[2]);
+            }
+        }
+
+        unsigned triangleCount = indices.size() / 3;
+        if (triangleCount <= targetTriangles)
+            break;
+
+        // Accumulate a quadric per vertex from the area-weighted planes of its triangles
+        ea::vector<ErrorQuadric> quadrics(vertexCount);
+        for (unsigned i = 0; i < indices.size(); i += 3)
+        {
+            const Vector3& p0 = positions[indices[i]];
+            const Vector3& p1 = positions[indices[i + 1]];
+            const Vector3& p2 = positions[indices[i + 2]];
+            Vector3 normal = (p1 - p0).CrossProduct(p2 - p0);
+            float doubleArea = normal.Length();
+            if (doubleArea < M_EPSILON)
+                continue;
+            normal /= doubleArea;
+            float d = -normal.DotProduct(p0);
+            for (unsigned j = 0; j < 3; ++j)
+                quadrics[indices[i + j]].AddPlane(normal.x_, normal.y_, normal.z_, d, 0.5f * doubleArea);
+        }
+
+        // Count undirected edge occurrences to find locked border/seam vertices
+        ea::unordered_map<unsigned long long, unsigned> edges;
+        for (unsigned i = 0; i < indices.size(); i += 3)
+        {
+            for (unsigned j = 0; j < 3; ++j)
+            {
+                unsigned v0 = indices[i + j];
+                unsigned v1 = indices[i + (j + 1) % 3];
+                unsigned long long key = v0 < v1 ? ((unsigned long long)v0 << 32u | v1) : ((unsigned long long)v1 << 32u | v0);
+                ++edges[key];
+            }
+        }
+
+        ea::vector<bool> locked(vertexCount, false);
+        for (auto it = edges.begin(); it != edges.end(); ++it)
+        {
+            if (it->second == 1)
+            {
+                locked[(unsigned)(it->first >> 32u)] = true;
+                locked[(unsigned)(it->first & 0xffffffffull)] = true;
+            }
+        }
+
+        // Build collapse candidates for both directions of each interior edge, cheapest first
+        ea::vector<ea::pair<double, ea::pair<unsigned, unsigned> > > candidates;
+        candidates.reserve(edges.size());
+        for (auto it = edges.begin(); it != edges.end(); ++it)
+        {
+            if (it->second < 2)
+                continue;
+            unsigned v0 = (unsigned)(it->first >> 32u);
+            unsigned v1 = (unsigned)(it->first & 0xffffffffull);
+            ErrorQuadric combined = quadrics[v0];
+            combined.Add(quadrics[v1]);
+            if (!locked[v0])
+                candidates.push_back(ea::make_pair(combined.Evaluate(positions[v1]), ea::make_pair(v0, v1)));
+            if (!locked[v1])
+                candidates.push_back(ea::make_pair(combined.Evaluate(positions[v0]), ea::make_pair(v1, v0)));
+        }
+
+        ea::quick_sort(candidates.begin(), candidates.end());
+
+        // Apply non-conflicting collapses greedily; each collapse removes at least two triangles
+        ea::vector<bool> touched(vertexCount, false);
+        unsigned applied = 0;
+        for (unsigned i = 0; i < candidates.size(); ++i)
+        {
+            if (triangleCount <= targetTriangles + 2 * applied)
+                break;
+            unsigned src = candidates[i].second.first;
+            unsigned dest = candidates[i].second.second;
+            if (touched[src] || touched[dest])
+                continue;
+            collapseMap[src] = dest;
+            touched[src] = true;
+            touched[dest] = true;
+            ++applied;
+        }
+
+        if (!applied)
+            break;
+    }
+
+    return indices;
+}
+
 void BuildAndSaveModel(OutModel& model)
 {
     if (!model.rootNode_)
@@ -1043,6 +1606,55 @@ void BuildAndSaveModel(OutModel& model)
             combineBuffers = false;
     }
 
+    // Generate automatic LOD index chains first, as they add to the index buffer sizes. Simplification collapses
+    // vertices onto existing neighbors, so the LOD levels reuse the full-detail vertex data
+    ea::vector<ea::vector<ea::vector<unsigned> > > lodIndexChains(model.meshes_.size());
+    ea::vector<unsigned> lodIndexCounts(model.meshes_.size(), 0);
+    unsigned totalLodIndices = 0;
+    if (lodRatios_.size())
+    {
+        for (unsigned i = 0; i < model.meshes_.size(); ++i)
+        {
+            aiMesh* mesh = model.meshes_[i];
+            if (!GetNumValidFaces(mesh))
+                continue;
+
+            ea::vector<unsigned> baseIndices;
+            baseIndices.reserve(GetNumValidFaces(mesh) * 3);
+            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
+            {
+                if (mesh->mFaces[j].mNumIndices == 3)
+                {
+                    baseIndices.push_back(mesh->mFaces[j].mIndices[0]);
+                    baseIndices.push_back(mesh->mFaces[j].mIndices[1]);
+                    baseIndices.push_back(mesh->mFaces[j].mIndices[2]);
+                }
+            }
+
+            ea::vector<Vector3> positions(mesh->mNumVertices);
+            for (unsigned j = 0; j < mesh->mNumVertices; ++j)
+                positions[j] = ToVector3(mesh->mVertices[j]);
+
+            unsigned baseTriangles = baseIndices.size() / 3;
+            const ea::vector<unsigned>* prevLevel = &baseIndices;
+            for (unsigned j = 0; j < lodRatios_.size(); ++j)
+            {
+                unsigned targetTriangles = Max((unsigned)(baseTriangles * lodRatios_[j]), 1U);
+                ea::vector<unsigned> lodLevel = GenerateLodIndices(*prevLevel, positions, targetTriangles);
+                if (lodLevel.empty() || lodLevel.size() >= prevLevel->size())
+                {
+                    PrintLine("Warning: geometry " + ea::to_string(i) + " can not be simplified further, skipping LOD level " +
+                        ea::to_string(j + 1));
+                    break;
+                }
+                lodIndexChains[i].push_back(lodLevel);
+                lodIndexCounts[i] += lodLevel.size();
+                totalLodIndices += lodLevel.size();
+                prevLevel = &lodIndexChains[i].back();
+            }
+        }
+    }
+
     SharedPtr<IndexBuffer> ib;
     SharedPtr<VertexBuffer> vb;
     ea::vector<SharedPtr<VertexBuffer> > vbVector;
@@ -1064,7 +1676,7 @@ void BuildAndSaveModel(OutModel& model)
 
         bool largeIndices;
         if (combineBuffers)
-            largeIndices = model.totalIndices_ > 65535;
+            largeIndices = model.totalIndices_ + totalLodIndices > 65535;
         else
             largeIndices = mesh->mNumVertices > 65535;
 
@@ -1076,12 +1688,12 @@ void BuildAndSaveModel(OutModel& model)
 
             if (combineBuffers)
             {
-                ib->SetSize(model.totalIndices_, largeIndices);
+                ib->SetSize(model.totalIndices_ + totalLodIndices, largeIndices);
                 vb->SetSize(model.totalVertices_, elements);
             }
             else
             {
-                ib->SetSize(validFaces * 3, largeIndices);
+                ib->SetSize(validFaces * 3 + lodIndexCounts[i], largeIndices);
                 vb->SetSize(mesh->mNumVertices, elements);
             }
 
@@ -1100,10 +1712,9 @@ void BuildAndSaveModel(OutModel& model)
         vertexTransform = Matrix3x4(pos, rot, scale);
         normalTransform = rot.RotationMatrix();
 
-        SharedPtr<Geometry> geom(new Geometry(context_));
-
         PrintLine("Writing geometry " + ea::to_string(i) + " with " + ea::to_string(mesh->mNumVertices) + " vertices " +
-            ea::to_string(validFaces * 3) + " indices");
+            ea::to_string(validFaces * 3) + " indices" + (lodIndexChains[i].size() ?
+            " and " + ea::to_string(lodIndexChains[i].size()) + " automatic LOD levels" : ""));
 
         if (model.bones_.size() > 0 && !mesh->HasBones())
             PrintLine("Warning: model has bones but geometry " + ea::to_string(i) + " has no skinning information");
@@ -1111,19 +1722,21 @@ void BuildAndSaveModel(OutModel& model)
         unsigned char* vertexData = vb->GetShadowData();
         unsigned char* indexData = ib->GetShadowData();
 
-        // Build the index data
-        if (!largeIndices)
+        // Build the index lists, LOD level 0 first followed by any automatic LOD levels
+        ea::vector<ea::vector<unsigned> > geometryIndices;
+        geometryIndices.resize(1);
+        geometryIndices[0].reserve(validFaces * 3);
+        for (unsigned j = 0; j < mesh->mNumFaces; ++j)
         {
-            unsigned short* dest = (unsigned short*)indexData + startIndexOffset;
-            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
-                WriteShortIndices(dest, mesh, j, startVertexOffset);
-        }
-        else
-        {
-            unsigned* dest = (unsigned*)indexData + startIndexOffset;
-            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
-                WriteLargeIndices(dest, mesh, j, startVertexOffset);
+            if (mesh->mFaces[j].mNumIndices == 3)
+            {
+                geometryIndices[0].push_back(mesh->mFaces[j].mIndices[0]);
+                geometryIndices[0].push_back(mesh->mFaces[j].mIndices[1]);
+                geometryIndices[0].push_back(mesh->mFaces[j].mIndices[2]);
+            }
         }
+        for (unsigned j = 0; j < lodIndexChains[i].size(); ++j)
+            geometryIndices.push_back(lodIndexChains[i][j]);
 
         // Build the vertex data
         // If there are bones, get blend data
@@ -1137,6 +1750,47 @@ void BuildAndSaveModel(OutModel& model)
         for (unsigned j = 0; j < mesh->mNumVertices; ++j)
             WriteVertex(dest, mesh, j, isSkinned, box, vertexTransform, normalTransform, blendIndices, blendWeights);
 
+        // Optimize each LOD level's index order for vertex cache efficiency, then remap the vertices into
+        // first-use order across all levels for fetch locality
+        if (optimizeMeshes_)
+        {
+            for (unsigned j = 0; j < geometryIndices.size(); ++j)
+                OptimizeIndexOrder(geometryIndices[j], mesh->mNumVertices);
+
+            ea::vector<unsigned> combinedIndices;
+            for (unsigned j = 0; j < geometryIndices.size(); ++j)
+                combinedIndices.insert(combinedIndices.end(), geometryIndices[j].begin(), geometryIndices[j].end());
+            OptimizeVertexFetch(combinedIndices, vertexData + (size_t)startVertexOffset * vb->GetVertexSize(),
+                mesh->mNumVertices, vb->GetVertexSize());
+            unsigned srcOffset = 0;
+            for (unsigned j = 0; j < geometryIndices.size(); ++j)
+            {
+                for (unsigned k = 0; k < geometryIndices[j].size(); ++k)
+                    geometryIndices[j][k] = combinedIndices[srcOffset + k];
+                srcOffset += geometryIndices[j].size();
+            }
+        }
+
+        // Write the index data
+        unsigned destIndexOffset = startIndexOffset;
+        for (unsigned j = 0; j < geometryIndices.size(); ++j)
+        {
+            const ea::vector<unsigned>& lodData = geometryIndices[j];
+            if (!largeIndices)
+            {
+                unsigned short* dest = (unsigned short*)indexData + destIndexOffset;
+                for (unsigned k = 0; k < lodData.size(); ++k)
+                    dest[k] = (unsigned short)(lodData[k] + startVertexOffset);
+            }
+            else
+            {
+                unsigned* dest = (unsigned*)indexData + destIndexOffset;
+                for (unsigned k = 0; k < lodData.size(); ++k)
+                    dest[k] = lodData[k] + startVertexOffset;
+            }
+            destIndexOffset += lodData.size();
+        }
+
         // Calculate the geometry center
         Vector3 center = Vector3::ZERO;
         if (validFaces)
@@ -1154,18 +1808,26 @@ void BuildAndSaveModel(OutModel& model)
             center /= (float)validFaces * 3;
         }
 
-        // Define the geometry
-        geom->SetIndexBuffer(ib);
-        geom->SetVertexBuffer(0, vb);
-        geom->SetDrawRange(TRIANGLE_LIST, startIndexOffset, validFaces * 3, true);
-        outModel->SetNumGeometryLodLevels(destGeomIndex, 1);
-        outModel->SetGeometry(destGeomIndex, 0, geom);
+        // Define the geometry and its LOD levels
+        outModel->SetNumGeometryLodLevels(destGeomIndex, geometryIndices.size());
+        unsigned lodIndexOffset = startIndexOffset;
+        for (unsigned j = 0; j < geometryIndices.size(); ++j)
+        {
+            SharedPtr<Geometry> geom(new Geometry(context_));
+            geom->SetIndexBuffer(ib);
+            geom->SetVertexBuffer(0, vb);
+            geom->SetDrawRange(TRIANGLE_LIST, lodIndexOffset, geometryIndices[j].size(), true);
+            if (j > 0)
+                geom->SetLodDistance(lodDistances_[j - 1]);
+            outModel->SetGeometry(destGeomIndex, j, geom);
+            lodIndexOffset += geometryIndices[j].size();
+        }
         outModel->SetGeometryCenter(destGeomIndex, center);
         if (model.bones_.size() > maxBones_)
             allBoneMappings.push_back(boneMappings);
 
         startVertexOffset += mesh->mNumVertices;
-        startIndexOffset += validFaces * 3;
+        startIndexOffset = lodIndexOffset;
         ++destGeomIndex;
     }
 
@@ -2421,26 +3083,6 @@ unsigned GetNumValidFaces(aiMesh* mesh)
     return ret;
 }
 
-void WriteShortIndices(unsigned short*& dest, aiMesh* mesh, unsigned index, unsigned offset)
-{
-    if (mesh->mFaces[index].mNumIndices == 3)
-    {
-        *dest++ = mesh->mFaces[index].mIndices[0] + offset;
-        *dest++ = mesh->mFaces[index].mIndices[1] + offset;
-        *dest++ = mesh->mFaces[index].mIndices[2] + offset;
-    }
-}
-
-void WriteLargeIndices(unsigned*& dest, aiMesh* mesh, unsigned index, unsigned offset)
-{
-    if (mesh->mFaces[index].mNumIndices == 3)
-    {
-        *dest++ = mesh->mFaces[index].mIndices[0] + offset;
-        *dest++ = mesh->mFaces[index].mIndices[1] + offset;
-        *dest++ = mesh->mFaces[index].mIndices[2] + offset;
-    }
-}
-
 void WriteVertex(float*& dest, aiMesh* mesh, unsigned index, bool isSkinned, BoundingBox& box,
     const Matrix3x4& vertexTransform, const Matrix3& normalTransform, ea::vector<ea::vector<unsigned char> >& blendIndices,
     ea::vector<ea::vector<float> >& blendWeights)
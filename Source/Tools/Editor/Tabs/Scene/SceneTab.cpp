@@ -1496,13 +1496,33 @@ void SceneTab::RenderDebugInfo()
             component->DrawDebugGeometry(debug, true);
     };
 
+    // Regenerate overlay geometry only when an object is newly selected or its transform changed, otherwise replay the
+    // cached copy. Entries not touched this frame belong to deselected objects and are swept by the swap at the end.
+    ea::unordered_map<void*, CachedDebugGeometry> liveCache;
+    auto renderCached = [&](void* key, const Matrix3x4& worldTransform, const auto& generate) {
+        CachedDebugGeometry& cached = liveCache[key];
+        auto it = debugGeometryCache_.find(key);
+        if (it != debugGeometryCache_.end() && it->second.worldTransform_.Equals(worldTransform))
+            cached = ea::move(it->second);
+        else
+        {
+            debug->BeginCapture(cached.geometry_);
+            generate();
+            debug->EndCapture();
+            cached.worldTransform_ = worldTransform;
+        }
+        debug->AddCached(cached.geometry_);
+    };
+
     const auto& selection = selectedNodes_;
     for (auto& node : selection)
     {
         if (node && !node->HasTag("DebugInfoNever"))
         {
-            for (auto& component: node->GetComponents())
-                renderDebugInfo(component);
+            renderCached(node.Get(), node->GetWorldTransform(), [&]() {
+                for (auto& component: node->GetComponents())
+                    renderDebugInfo(component);
+            });
         }
     }
 
@@ -1513,15 +1533,23 @@ void SceneTab::RenderDebugInfo()
         if (selection.contains(WeakPtr<Node>(node)))
             continue;
 
-        for (auto& component: node->GetComponents())
-            renderDebugInfo(component);
+        renderCached(node, node->GetWorldTransform(), [&]() {
+            for (auto& component: node->GetComponents())
+                renderDebugInfo(component);
+        });
     }
 
     for (auto& component : selectedComponents_)
     {
         if (component)
-            renderDebugInfo(component);
+        {
+            Node* node = component->GetNode();
+            renderCached(component.Get(), node ? node->GetWorldTransform() : Matrix3x4::IDENTITY,
+                [&]() { renderDebugInfo(component); });
+        }
     }
+
+    debugGeometryCache_.swap(liveCache);
 }
 
 void SceneTab::RenderViewManipulator(ImRect rect)
@@ -23,6 +23,7 @@
 #pragma once
 
 
+#include <Urho3D/Graphics/DebugRenderer.h>
 #include <Urho3D/IO/BinaryArchive.h>
 #include <Urho3D/Scene/SceneManager.h>
 #include <Toolbox/SystemUI/AttributeInspector.h>
@@ -212,6 +213,15 @@ protected:
     /// Editor camera rotation guide at the top-right corner.
     void RenderViewManipulator(ImRect rect);
 
+    /// Cached debug overlay geometry of a single node or component.
+    struct CachedDebugGeometry
+    {
+        /// Captured debug geometry.
+        DebugGeometryCache geometry_;
+        /// World transform of the object at capture time, used to detect when the geometry is stale.
+        Matrix3x4 worldTransform_;
+    };
+
     /// Rectangle dimensions that are rendered by this view.
     IntRect rect_;
     /// Texture to which scene is rendered.
@@ -224,6 +234,8 @@ protected:
     ea::hash_set<WeakPtr<Node>> selectedNodes_;
     /// Current selected component displayed in inspector.
     ea::hash_set<WeakPtr<Component>> selectedComponents_;
+    /// Cached debug overlay geometry keyed by node or component pointer. Entries of deselected objects are swept every frame.
+    ea::unordered_map<void*, CachedDebugGeometry> debugGeometryCache_;
     /// Flag indicating that mouse is hovering scene viewport.
     bool isViewportActive_ = false;
     /// Mouse button that clicked viewport.
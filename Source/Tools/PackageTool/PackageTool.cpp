@@ -24,9 +24,15 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryBuffer.h>
 #include <Urho3D/IO/PackageFile.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/XMLFile.h>
 
 #ifdef WIN32
 #include <windows.h>
@@ -42,6 +48,8 @@
 using namespace Urho3D;
 
 static const unsigned COMPRESSED_BLOCK_SIZE = 32768;
+/// Maximum amount of uncompressed file data held in memory at once while compressing in parallel.
+static const unsigned MAX_BATCH_BYTES = 128 * 1024 * 1024;
 
 struct FileEntry
 {
@@ -51,13 +59,47 @@ struct FileEntry
     unsigned checksum_{};
 };
 
+/// File data of a single entry being compressed by a work pool batch.
+struct PendingEntry
+{
+    /// Index into the entry list.
+    unsigned index_{};
+    /// Uncompressed file data.
+    ea::unique_ptr<unsigned char[]> data_;
+    /// Uncompressed data size.
+    unsigned dataSize_{};
+    /// Compressed data, either produced by a worker thread or copied from the previous package in update mode.
+    VectorBuffer compressed_;
+    /// Whether the compressed data was reused from the previous package.
+    bool reused_{};
+    /// Whether compression succeeded.
+    bool success_{true};
+};
+
+/// Location of an entry's compressed data within the previous package, used by update mode.
+struct OldEntryInfo
+{
+    /// Offset of the compressed data.
+    unsigned offset_{};
+    /// Uncompressed size.
+    unsigned size_{};
+    /// Entry checksum.
+    unsigned checksum_{};
+    /// Size of the compressed data.
+    unsigned compressedSize_{};
+};
+
 Context* context_ = nullptr;
 FileSystem* fileSystem_ = nullptr;
 ea::string basePath_;
 ea::vector<FileEntry> entries_;
 unsigned checksum_ = 0;
 bool compress_ = false;
+bool preparse_ = false;
 bool quiet_ = false;
+bool update_ = false;
+int compressLevel_ = 0;
+unsigned numThreads_ = 0;
 unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
 
 ea::string ignoreExtensions_[] = {
@@ -68,6 +110,8 @@ ea::string ignoreExtensions_[] = {
 int main(int argc, char** argv);
 void Run(const ea::vector<ea::string>& arguments);
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir);
+bool ConvertToPreParsed(const ea::string& fileName, ea::unique_ptr<unsigned char[]>& buffer, unsigned& dataSize);
+void CompressEntry(PendingEntry& pending);
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir);
 void WriteHeader(File& dest);
 
@@ -97,7 +141,11 @@ void Run(const ea::vector<ea::string>& arguments)
             "\n"
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
+            "-p      Pre-parse XML and JSON resources into binary form\n"
             "-q      Enable quiet mode\n"
+            "-u      Update mode: reuse compressed data of unchanged files from the existing package\n"
+            "-xN     LZ4HC compression level 1-12 (default 0 = library default)\n"
+            "-jN     Number of compression worker threads (default: number of logical CPUs)\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
             "Alternative output usage: PackageTool <output option> <package name>\n"
@@ -125,9 +173,21 @@ void Run(const ea::vector<ea::string>& arguments)
                     case 'c':
                         compress_ = true;
                         break;
+                    case 'p':
+                        preparse_ = true;
+                        break;
                     case 'q':
                         quiet_ = true;
                         break;
+                    case 'u':
+                        update_ = true;
+                        break;
+                    case 'x':
+                        compressLevel_ = Clamp(ToInt(arguments[i].substr(2)), 0, LZ4HC_CLEVEL_MAX);
+                        break;
+                    case 'j':
+                        numThreads_ = ToUInt(arguments[i].substr(2));
+                        break;
                     default:
                         ErrorExit("Unrecognized option");
                     }
@@ -252,14 +312,111 @@ void ProcessFile(const ea::string& fileName, const ea::string& rootDir)
     entries_.push_back(newEntry);
 }
 
+bool ConvertToPreParsed(const ea::string& fileName, ea::unique_ptr<unsigned char[]>& buffer, unsigned& dataSize)
+{
+    ea::string extension = GetExtension(fileName);
+    MemoryBuffer source(buffer.get(), dataSize);
+    VectorBuffer converted;
+
+    if (extension == ".xml")
+    {
+        // XML patch files requiring the resource cache (inherit attribute) fail to load here and stay as text
+        SharedPtr<XMLFile> xmlFile(new XMLFile(context_));
+        if (!xmlFile->Load(source) || !xmlFile->SaveBinary(converted))
+            return false;
+    }
+    else if (extension == ".json")
+    {
+        SharedPtr<JSONFile> jsonFile(new JSONFile(context_));
+        if (!jsonFile->Load(source) || !jsonFile->SaveBinary(converted))
+            return false;
+    }
+    else
+        return false;
+
+    if (!quiet_)
+        PrintLine(fileName + " pre-parsed, size " + ea::to_string(dataSize) + " -> " + ea::to_string(converted.GetSize()));
+
+    dataSize = converted.GetSize();
+    buffer.reset(new unsigned char[dataSize]);
+    memcpy(buffer.get(), converted.GetData(), dataSize);
+    return true;
+}
+
+void CompressEntry(PendingEntry& pending)
+{
+    ea::unique_ptr<unsigned char[]> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
+
+    unsigned pos = 0;
+
+    while (pos < pending.dataSize_)
+    {
+        unsigned unpackedSize = blockSize_;
+        if (pos + unpackedSize > pending.dataSize_)
+            unpackedSize = pending.dataSize_ - pos;
+
+        auto packedSize = (unsigned)LZ4_compress_HC((const char*)&pending.data_[pos], (char*)compressBuffer.get(), unpackedSize, LZ4_compressBound(unpackedSize), compressLevel_);
+        if (!packedSize)
+        {
+            pending.success_ = false;
+            return;
+        }
+
+        pending.compressed_.WriteUShort((unsigned short)unpackedSize);
+        pending.compressed_.WriteUShort((unsigned short)packedSize);
+        pending.compressed_.Write(compressBuffer.get(), packedSize);
+
+        pos += unpackedSize;
+    }
+}
+
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
 {
     if (!quiet_)
         PrintLine("Writing package");
 
+    // In update mode reuse compressed data of unchanged files from the existing package. Write to a temporary
+    // file in that case, as the old package must stay readable until the new one is complete
+    ea::unordered_map<ea::string, OldEntryInfo> oldEntries;
+    File oldData(context_);
+    unsigned oldPackageTime = 0;
+    ea::string destFileName = fileName;
+
+    if (update_ && compress_ && fileSystem_->Exists(fileName))
+    {
+        SharedPtr<PackageFile> oldPackage(new PackageFile(context_, fileName));
+        if (oldPackage->IsCompressed() && oldPackage->GetNumFiles() && oldData.Open(fileName))
+        {
+            oldPackageTime = fileSystem_->GetLastModifiedTime(fileName);
+
+            // Compressed data of an entry extends to the offset of the next entry, or to the end of the data region
+            ea::vector<ea::pair<const ea::string*, const PackageEntry*> > ordered;
+            for (const auto& pair : oldPackage->GetEntries())
+                ordered.push_back(ea::make_pair(&pair.first, &pair.second));
+            ea::quick_sort(ordered.begin(), ordered.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.second->offset_ < rhs.second->offset_; });
+
+            unsigned dataEnd = oldPackage->HasChunkIndex() ? oldPackage->GetChunkCoveredSize() :
+                oldPackage->GetTotalSize() - sizeof(unsigned);
+            for (unsigned i = 0; i < ordered.size(); ++i)
+            {
+                unsigned end = i + 1 < ordered.size() ? ordered[i + 1].second->offset_ : dataEnd;
+
+                OldEntryInfo info;
+                info.offset_ = ordered[i].second->offset_;
+                info.size_ = ordered[i].second->size_;
+                info.checksum_ = ordered[i].second->checksum_;
+                info.compressedSize_ = end - info.offset_;
+                oldEntries[*ordered[i].first] = info;
+            }
+
+            destFileName = fileName + ".new";
+        }
+    }
+
     File dest(context_);
-    if (!dest.Open(fileName, FILE_WRITE))
-        ErrorExit("Could not open output file " + fileName);
+    if (!dest.Open(destFileName, FILE_WRITE))
+        ErrorExit("Could not open output file " + destFileName);
 
     // Write ID, number of files & placeholder for checksum
     WriteHeader(dest);
@@ -273,73 +430,131 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
         dest.WriteUInt(entries_[i].checksum_);
     }
 
+    // Create worker threads for parallel compression
+    SharedPtr<WorkQueue> workQueue;
+    if (compress_)
+    {
+        workQueue = new WorkQueue(context_);
+        workQueue->CreateThreads(numThreads_ ? numThreads_ : GetNumLogicalCPUs());
+    }
+
     unsigned totalDataSize = 0;
-    unsigned lastOffset;
+    unsigned reusedEntries = 0;
 
-    // Write file data, calculate checksums & correct offsets
-    for (unsigned i = 0; i < entries_.size(); ++i)
+    // Process files in batches: read & checksum serially, compress the batch with the work pool, then write in order
+    for (unsigned first = 0; first < entries_.size();)
     {
-        lastOffset = entries_[i].offset_ = dest.GetSize();
-        ea::string fileFullPath = rootDir + "/" + entries_[i].name_;
+        ea::vector<PendingEntry> batch;
+        unsigned batchBytes = 0;
 
-        File srcFile(context_, fileFullPath);
-        if (!srcFile.IsOpen())
-            ErrorExit("Could not open file " + fileFullPath);
+        while (first < entries_.size() && (batch.empty() || batchBytes < MAX_BATCH_BYTES))
+        {
+            unsigned i = first++;
+            ea::string fileFullPath = rootDir + "/" + entries_[i].name_;
 
-        unsigned dataSize = entries_[i].size_;
-        totalDataSize += dataSize;
-        ea::unique_ptr<unsigned char[]> buffer(new unsigned char[dataSize]);
+            File srcFile(context_, fileFullPath);
+            if (!srcFile.IsOpen())
+                ErrorExit("Could not open file " + fileFullPath);
 
-        if (srcFile.Read(&buffer[0], dataSize) != dataSize)
-            ErrorExit("Could not read file " + fileFullPath);
-        srcFile.Close();
+            PendingEntry pending;
+            pending.index_ = i;
+            pending.dataSize_ = entries_[i].size_;
+            pending.data_.reset(new unsigned char[pending.dataSize_]);
 
-        for (unsigned j = 0; j < dataSize; ++j)
-        {
-            checksum_ = SDBMHash(checksum_, buffer[j]);
-            entries_[i].checksum_ = SDBMHash(entries_[i].checksum_, buffer[j]);
-        }
+            if (srcFile.Read(&pending.data_[0], pending.dataSize_) != pending.dataSize_)
+                ErrorExit("Could not read file " + fileFullPath);
+            srcFile.Close();
 
-        if (!compress_)
-        {
-            if (!quiet_)
-                PrintLine(entries_[i].name_ + " size " + ea::to_string(dataSize));
-            dest.Write(&buffer[0], entries_[i].size_);
+            // Optionally convert text resources into pre-parsed binary form under the same entry name
+            if (preparse_ && ConvertToPreParsed(entries_[i].name_, pending.data_, pending.dataSize_))
+                entries_[i].size_ = pending.dataSize_;
+            totalDataSize += pending.dataSize_;
+
+            for (unsigned j = 0; j < pending.dataSize_; ++j)
+            {
+                checksum_ = SDBMHash(checksum_, pending.data_[j]);
+                entries_[i].checksum_ = SDBMHash(entries_[i].checksum_, pending.data_[j]);
+            }
+
+            batchBytes += pending.dataSize_;
+            batch.push_back(ea::move(pending));
         }
-        else
-        {
-            ea::unique_ptr<unsigned char[]> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
 
-            unsigned pos = 0;
+        if (compress_)
+        {
+            // Copy compressed data of unchanged files from the old package instead of recompressing
+            for (PendingEntry& pending : batch)
+            {
+                const FileEntry& entry = entries_[pending.index_];
+                auto it = oldEntries.find(basePath_ + entry.name_);
+                if (it != oldEntries.end() && it->second.size_ == entry.size_ && it->second.checksum_ == entry.checksum_ &&
+                    fileSystem_->GetLastModifiedTime(rootDir + "/" + entry.name_) <= oldPackageTime)
+                {
+                    pending.compressed_.Resize(it->second.compressedSize_);
+                    oldData.Seek(it->second.offset_);
+                    if (oldData.Read(pending.compressed_.GetModifiableData(), it->second.compressedSize_) == it->second.compressedSize_)
+                    {
+                        pending.reused_ = true;
+                        ++reusedEntries;
+                    }
+                    else
+                        pending.compressed_.Clear();
+                }
+            }
 
-            while (pos < dataSize)
+            for (PendingEntry& pending : batch)
             {
-                unsigned unpackedSize = blockSize_;
-                if (pos + unpackedSize > dataSize)
-                    unpackedSize = dataSize - pos;
+                if (!pending.reused_)
+                    workQueue->AddWorkItem([&pending]() { CompressEntry(pending); }, M_MAX_UNSIGNED);
+            }
+            workQueue->Complete(M_MAX_UNSIGNED);
 
-                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.get(), unpackedSize, LZ4_compressBound(unpackedSize), 0);
-                if (!packedSize)
-                    ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + ea::to_string(pos));
+            for (const PendingEntry& pending : batch)
+            {
+                if (!pending.success_)
+                    ErrorExit("LZ4 compression failed for file " + entries_[pending.index_].name_);
+            }
+        }
 
-                dest.WriteUShort((unsigned short)unpackedSize);
-                dest.WriteUShort((unsigned short)packedSize);
-                dest.Write(compressBuffer.get(), packedSize);
+        // Write the batch & correct offsets
+        for (PendingEntry& pending : batch)
+        {
+            FileEntry& entry = entries_[pending.index_];
+            entry.offset_ = dest.GetSize();
 
-                pos += unpackedSize;
+            if (!compress_)
+            {
+                if (!quiet_)
+                    PrintLine(entry.name_ + " size " + ea::to_string(pending.dataSize_));
+                dest.Write(&pending.data_[0], entry.size_);
             }
-
-            if (!quiet_)
+            else
             {
-                unsigned totalPackedBytes = dest.GetSize() - lastOffset;
-                ea::string fileEntry(entries_[i].name_);
-                fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
-                    totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
-                PrintLine(fileEntry);
+                dest.Write(pending.compressed_.GetData(), pending.compressed_.GetSize());
+
+                if (!quiet_)
+                {
+                    unsigned totalPackedBytes = pending.compressed_.GetSize();
+                    ea::string fileEntry(entry.name_);
+                    fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f%s", pending.dataSize_, totalPackedBytes,
+                        totalPackedBytes ? 1.f * pending.dataSize_ / totalPackedBytes : 0.f, pending.reused_ ? "\t(reused)" : "");
+                    PrintLine(fileEntry);
+                }
             }
         }
     }
 
+    // Write the content chunk index used for delta patching: placeholder hashes now, the footer,
+    // then the real hashes once the header has been rewritten with final offsets & checksums
+    unsigned coveredSize = dest.GetSize();
+    unsigned numChunks = (coveredSize + PACKAGE_CHUNK_SIZE - 1) / PACKAGE_CHUNK_SIZE;
+    for (unsigned i = 0; i < numChunks; ++i)
+        dest.WriteUInt(0);
+    dest.WriteUInt(PACKAGE_CHUNK_SIZE);
+    dest.WriteUInt(coveredSize);
+    dest.WriteUInt(numChunks);
+    dest.WriteFileID("PIDX");
+
     // Write package size to the end of file to allow finding it linked to an executable file
     unsigned currentSize = dest.GetSize();
     dest.WriteUInt(currentSize + sizeof(unsigned));
@@ -356,11 +571,52 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
         dest.WriteUInt(entries_[i].checksum_);
     }
 
+    unsigned packageSize = dest.GetSize();
+    dest.Close();
+
+    // Hash the final file contents chunk by chunk and fill in the chunk index. Reopen in read-write
+    // mode, as the destination file was opened write-only
+    {
+        File indexFile(context_);
+        if (!indexFile.Open(destFileName, FILE_READWRITE))
+            ErrorExit("Could not reopen output file " + destFileName + " for chunk hashing");
+
+        ea::unique_ptr<unsigned char[]> chunkBuffer(new unsigned char[PACKAGE_CHUNK_SIZE]);
+        ea::vector<unsigned> chunkHashes(numChunks, 0);
+
+        for (unsigned i = 0; i < numChunks; ++i)
+        {
+            unsigned chunkStart = i * PACKAGE_CHUNK_SIZE;
+            unsigned chunkBytes = Min(PACKAGE_CHUNK_SIZE, coveredSize - chunkStart);
+            indexFile.Seek(chunkStart);
+            if (indexFile.Read(chunkBuffer.get(), chunkBytes) != chunkBytes)
+                ErrorExit("Could not read back package data for chunk hashing");
+            for (unsigned j = 0; j < chunkBytes; ++j)
+                chunkHashes[i] = SDBMHash(chunkHashes[i], chunkBuffer[j]);
+        }
+
+        indexFile.Seek(coveredSize);
+        for (unsigned i = 0; i < numChunks; ++i)
+            indexFile.WriteUInt(chunkHashes[i]);
+    }
+
+    // Replace the old package with the temporary file written by update mode
+    if (destFileName != fileName)
+    {
+        oldData.Close();
+        fileSystem_->Delete(fileName);
+        if (!fileSystem_->Rename(destFileName, fileName))
+            ErrorExit("Could not replace package " + fileName);
+    }
+
     if (!quiet_)
     {
         PrintLine("Number of files: " + ea::to_string(entries_.size()));
         PrintLine("File data size: " + ea::to_string(totalDataSize));
-        PrintLine("Package size: " + ea::to_string(dest.GetSize()));
+        PrintLine("Package size: " + ea::to_string(packageSize));
+        PrintLine("Chunk index: " + ea::to_string(numChunks) + " chunks of " + ea::to_string(PACKAGE_CHUNK_SIZE) + " bytes");
+        if (update_)
+            PrintLine("Reused entries: " + ea::to_string(reusedEntries));
         PrintLine("Checksum: " + ea::to_string(checksum_));
         PrintLine("Compressed: " + ea::string(compress_ ? "yes" : "no"));
     }
@@ -553,6 +553,90 @@ public:
     }
 };
 
+/// Undoes or redoes attribute patches produced by Serializable::DiffAttributes(). One action covers all changed
+/// attributes of one object, so bulk edits of large selections store only the changed values instead of full
+/// attribute snapshots per object.
+class URHO3D_TOOLBOX_API UndoEditAttributePatch : public UndoAction
+{
+    unsigned targetID = 0;
+    UIElementPath targetPath_;
+    AttributePatch undoPatch_;
+    AttributePatch redoPatch_;
+    StringHash targetType_;
+    WeakPtr<Scene> editorScene_;
+    WeakPtr<UIElement> root_;
+    WeakPtr<Serializable> target_;
+
+public:
+    UndoEditAttributePatch(Serializable* target, AttributePatch undoPatch, AttributePatch redoPatch)
+        : undoPatch_(ea::move(undoPatch))
+        , redoPatch_(ea::move(redoPatch))
+    {
+        targetType_ = target->GetType();
+        target_ = target;
+
+        if (auto* node = dynamic_cast<Node*>(target))
+        {
+            editorScene_ = node->GetScene();
+            targetID = node->GetID();
+        }
+        else if (auto* component = dynamic_cast<Component*>(target))
+        {
+            editorScene_ = component->GetScene();
+            targetID = component->GetID();
+        }
+        else if (auto* element = dynamic_cast<UIElement*>(target))
+        {
+            root_ = element->GetRoot();
+            targetPath_ = GetUIElementPath(element);
+        }
+    }
+
+    Serializable* GetTarget()
+    {
+        if (targetType_ == Node::GetTypeStatic())
+            return editorScene_->GetNode(targetID);
+        else if (targetType_ == Component::GetTypeStatic())
+            return editorScene_->GetComponent(targetID);
+        else if (targetType_ == UIElement::GetTypeStatic())
+            return GetUIElementByPath(root_, targetPath_);
+
+        return target_.Get();
+    }
+
+    bool IsExpired()
+    {
+        if (targetType_ == Node::GetTypeStatic() || targetType_ == Component::GetTypeStatic())
+            return editorScene_.Expired();
+        else if (targetType_ == UIElement::GetTypeStatic())
+            return root_.Expired();
+
+        return target_.Expired();
+    }
+
+    bool Undo(Context* context) override
+    {
+        if (IsExpired())
+            return false;
+
+        Serializable* target = GetTarget();
+        if (target != nullptr)
+            target->ApplyAttributePatch(undoPatch_);
+        return true;
+    }
+
+    bool Redo(Context* context) override
+    {
+        if (IsExpired())
+            return false;
+
+        Serializable* target = GetTarget();
+        if (target != nullptr)
+            target->ApplyAttributePatch(redoPatch_);
+        return true;
+    }
+};
+
 class URHO3D_TOOLBOX_API UndoCreateUIElement : public UndoAction
 {
     UIElementPath elementPath_;
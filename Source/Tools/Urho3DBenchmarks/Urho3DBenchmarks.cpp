@@ -0,0 +1,343 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/Batch.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Zone.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include <EASTL/sort.h>
+
+#include <Urho3D/DebugNew.h>
+
+using namespace Urho3D;
+
+/// Engine context shared by all benchmarks.
+static SharedPtr<Context> context_;
+/// Sink for benchmark results to defeat dead code elimination.
+static volatile unsigned long long benchmarkSink_ = 0;
+/// Minimum measured time per benchmark in microseconds.
+static const long long MIN_BENCHMARK_USEC = 200000;
+
+/// Benchmark timing state. Styled after google-benchmark: the measured section loops while KeepRunning() returns true,
+/// and the timer starts on the first call so that per-benchmark setup is excluded from the measurement.
+class BenchmarkState
+{
+public:
+    /// Construct with iteration count.
+    explicit BenchmarkState(long long maxIterations) :
+        maxIterations_(maxIterations)
+    {
+    }
+
+    /// Advance to the next iteration. Return false when the measurement is complete.
+    bool KeepRunning()
+    {
+        if (!iterations_)
+            timer_.Reset();
+        return iterations_++ < maxIterations_;
+    }
+
+    /// Return elapsed time of the measured section in microseconds.
+    long long GetElapsedUSec() { return timer_.GetUSec(false); }
+    /// Return number of measured iterations.
+    long long GetIterations() const { return maxIterations_; }
+
+private:
+    /// Iteration counter.
+    long long iterations_{};
+    /// Iterations to measure.
+    long long maxIterations_;
+    /// Timer started by the first KeepRunning() call.
+    HiresTimer timer_;
+};
+
+/// Run a benchmark function, scaling the iteration count until the measurement lasts long enough, and print the result.
+void RunBenchmark(const char* name, void (*function)(BenchmarkState& state))
+{
+    long long iterations = 1;
+
+    for (;;)
+    {
+        BenchmarkState state(iterations);
+        function(state);
+        long long elapsed = state.GetElapsedUSec();
+
+        if (elapsed >= MIN_BENCHMARK_USEC)
+        {
+            double nsPerIteration = (double)elapsed * 1000.0 / (double)state.GetIterations();
+            PrintLine(Format("{:<32} {:>12} iterations {:>14.1f} ns/iter", name, state.GetIterations(), nsPerIteration));
+            return;
+        }
+
+        // Scale towards the minimum time with some margin, at least doubling per attempt
+        if (elapsed <= 0)
+            iterations *= 16;
+        else
+            iterations = Max(iterations * 2, iterations * MIN_BENCHMARK_USEC * 5 / (elapsed * 4));
+    }
+}
+
+/// Octree frustum query over a scene of small drawables scattered in a cube.
+void BenchmarkOctreeGetDrawables(BenchmarkState& state)
+{
+    SetRandomSeed(1);
+
+    SharedPtr<Scene> scene(new Scene(context_));
+    auto* octree = scene->CreateComponent<Octree>();
+
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        Node* node = scene->CreateChild();
+        node->SetPosition(Vector3(Random(-500.0f, 500.0f), Random(-500.0f, 500.0f), Random(-500.0f, 500.0f)));
+        auto* zone = node->CreateComponent<Zone>();
+        zone->SetBoundingBox(BoundingBox(-5.0f, 5.0f));
+    }
+
+    // Settle the queued reinsertions so that the query sees the final octree structure
+    FrameInfo frame;
+    frame.frameNumber_ = 1;
+    frame.timeStep_ = 1.0f / 60.0f;
+    frame.camera_ = nullptr;
+    octree->Update(frame);
+
+    Frustum frustum;
+    frustum.Define(45.0f, 1.0f, 1.0f, 0.1f, 1000.0f, Matrix3x4::IDENTITY);
+
+    ea::vector<Drawable*> result;
+
+    while (state.KeepRunning())
+    {
+        result.clear();
+        FrustumOctreeQuery query(result, frustum);
+        octree->GetDrawables(query);
+        benchmarkSink_ += result.size();
+    }
+}
+
+/// Sorting a batch queue worth of batches by state sort key.
+void BenchmarkBatchSort(BenchmarkState& state)
+{
+    SetRandomSeed(1);
+
+    ea::vector<Batch> sourceBatches(10000);
+    for (Batch& batch : sourceBatches)
+    {
+        batch.sortKey_ = ((unsigned long long)Rand() << 32u) | (unsigned)Rand();
+        batch.distance_ = Random(1000.0f);
+        batch.renderOrder_ = (unsigned char)(Rand() & 7);
+    }
+
+    ea::vector<Batch> batches;
+
+    while (state.KeepRunning())
+    {
+        batches = sourceBatches;
+        ea::quick_sort(batches.begin(), batches.end(), [](const Batch& lhs, const Batch& rhs)
+        {
+            if (lhs.renderOrder_ != rhs.renderOrder_)
+                return lhs.renderOrder_ < rhs.renderOrder_;
+            if (lhs.sortKey_ != rhs.sortKey_)
+                return lhs.sortKey_ < rhs.sortKey_;
+            return lhs.distance_ < rhs.distance_;
+        });
+        benchmarkSink_ += batches[0].sortKey_;
+    }
+}
+
+/// Insert, look up and erase keys in a VariantMap.
+void BenchmarkVariantMapChurn(BenchmarkState& state)
+{
+    VariantMap map;
+
+    while (state.KeepRunning())
+    {
+        for (unsigned i = 0; i < 64; ++i)
+            map[StringHash(i * 2654435761u)] = i;
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            auto it = map.find(StringHash(i * 2654435761u));
+            if (it != map.end())
+                benchmarkSink_ += it->second.GetUInt();
+        }
+        map.clear();
+    }
+}
+
+/// Hashing strings and looking them up in a StringHash-keyed map.
+void BenchmarkStringHashLookup(BenchmarkState& state)
+{
+    ea::vector<ea::string> names;
+    ea::unordered_map<StringHash, unsigned> map;
+    for (unsigned i = 0; i < 1024; ++i)
+    {
+        names.push_back(Format("Parameter{}", i));
+        map[StringHash(names.back())] = i;
+    }
+
+    while (state.KeepRunning())
+    {
+        for (const ea::string& name : names)
+        {
+            auto it = map.find(StringHash(name));
+            if (it != map.end())
+                benchmarkSink_ += it->second;
+        }
+    }
+}
+
+/// Four-bone matrix palette skinning kernel, equivalent to the inner loop of SoftwareModelAnimator::ApplySkinning.
+void BenchmarkSkinningKernel(BenchmarkState& state)
+{
+    SetRandomSeed(1);
+
+    ea::vector<Matrix3x4> bones(64);
+    for (Matrix3x4& bone : bones)
+        bone = Matrix3x4(Vector3(Random(10.0f), Random(10.0f), Random(10.0f)), Quaternion(Random(360.0f), Vector3::UP), 1.0f);
+
+    struct SkinVertex
+    {
+        Vector3 position_;
+        unsigned char indices_[4];
+        float weights_[4];
+    };
+
+    ea::vector<SkinVertex> vertices(10000);
+    for (SkinVertex& vertex : vertices)
+    {
+        vertex.position_ = Vector3(Random(1.0f), Random(1.0f), Random(1.0f));
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            vertex.indices_[i] = (unsigned char)(Rand() & 63);
+            vertex.weights_[i] = 0.25f;
+        }
+    }
+
+    ea::vector<Vector3> skinned(vertices.size());
+
+    while (state.KeepRunning())
+    {
+        for (unsigned i = 0; i < vertices.size(); ++i)
+        {
+            const SkinVertex& vertex = vertices[i];
+            Matrix3x4 blended = bones[vertex.indices_[0]] * vertex.weights_[0];
+            for (unsigned j = 1; j < 4; ++j)
+                blended = blended + bones[vertex.indices_[j]] * vertex.weights_[j];
+            skinned[i] = blended * vertex.position_;
+        }
+        benchmarkSink_ += (unsigned long long)skinned[0].x_;
+    }
+}
+
+/// Dispatch overhead of posting trivial work items and completing them.
+void BenchmarkWorkQueueDispatch(BenchmarkState& state)
+{
+    auto* workQueue = context_->GetSubsystem<WorkQueue>();
+
+    while (state.KeepRunning())
+    {
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            workQueue->AddWorkItem([]()
+            {
+                benchmarkSink_ += 1;
+            }, M_MAX_UNSIGNED);
+        }
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+}
+
+/// Looking up a loaded resource from the cache by name.
+void BenchmarkResourceCacheGetResource(BenchmarkState& state)
+{
+    auto* cache = context_->GetSubsystem<ResourceCache>();
+
+    SharedPtr<XMLFile> file(new XMLFile(context_));
+    file->SetName("Benchmark.xml");
+    cache->AddManualResource(file);
+
+    while (state.KeepRunning())
+    {
+        XMLFile* resource = cache->GetResource<XMLFile>("Benchmark.xml");
+        benchmarkSink_ += resource != nullptr;
+    }
+
+    cache->ReleaseResource(XMLFile::GetTypeStatic(), "Benchmark.xml", true);
+}
+
+int main(int argc, char** argv)
+{
+    ea::vector<ea::string> arguments;
+
+#ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+#else
+    arguments = ParseArguments(argc, argv);
+#endif
+
+    // Optional substring filter for benchmark names
+    ea::string filter = arguments.size() ? arguments[0] : "";
+
+    context_ = new Context();
+    context_->RegisterSubsystem(new FileSystem(context_));
+    context_->RegisterSubsystem(new ResourceCache(context_));
+    context_->RegisterSubsystem(new WorkQueue(context_));
+    RegisterSceneLibrary(context_);
+    RegisterGraphicsLibrary(context_);
+
+    unsigned numThreads = GetNumPhysicalCPUs() - 1;
+    if (numThreads)
+        context_->GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
+
+    static const struct
+    {
+        const char* name_;
+        void (*function_)(BenchmarkState& state);
+    } benchmarks[] = {
+        { "OctreeGetDrawables", BenchmarkOctreeGetDrawables },
+        { "BatchSort", BenchmarkBatchSort },
+        { "VariantMapChurn", BenchmarkVariantMapChurn },
+        { "StringHashLookup", BenchmarkStringHashLookup },
+        { "SkinningKernel", BenchmarkSkinningKernel },
+        { "WorkQueueDispatch", BenchmarkWorkQueueDispatch },
+        { "ResourceCacheGetResource", BenchmarkResourceCacheGetResource },
+    };
+
+    for (const auto& benchmark : benchmarks)
+    {
+        if (filter.empty() || ea::string(benchmark.name_).contains(filter))
+            RunBenchmark(benchmark.name_, benchmark.function_);
+    }
+
+    context_ = nullptr;
+    return 0;
+}
@@ -22,18 +22,34 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/sort.h>
+
 #include "../Audio/Audio.h"
+#include "../Audio/AudioBus.h"
 #include "../Audio/Sound.h"
 #include "../Audio/SoundListener.h"
 #include "../Audio/SoundSource3D.h"
+#include "../Audio/SoundStream.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
 #include "../IO/Log.h"
+#include "../Math/Ray.h"
+#ifdef URHO3D_PHYSICS
+#include "../Physics/PhysicsWorld.h"
+#endif
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
 
 #include <SDL/SDL.h>
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -48,10 +64,85 @@ const char* AUDIO_CATEGORY = "Audio";
 static const int MIN_BUFFERLENGTH = 20;
 static const int MIN_MIXRATE = 11025;
 static const int MAX_MIXRATE = 48000;
+static const unsigned MAX_MIXER_THREADS = 3;
+static const unsigned MIN_THREADED_MIX_VOICES = 16;
+static const unsigned MAX_OCCLUSION_RAYS = 16;
+// An occluder must be at least this much closer than the source for the source to count as occluded
+static const float OCCLUSION_DISTANCE_MARGIN = 0.1f;
 static const StringHash SOUND_MASTER_HASH("Master");
 
 static void SDLAudioCallback(void* userdata, Uint8* stream, int len);
 
+/// Helper thread that assists the audio thread in mixing sound sources during a mix job.
+class AudioMixerThread : public Thread
+{
+public:
+    /// Construct.
+    AudioMixerThread(Audio* owner, unsigned workerIndex) :
+        Thread("AudioMixer"),
+        owner_(owner),
+        workerIndex_(workerIndex)
+    {
+    }
+
+    /// Wait for mix jobs and claim voices from them.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            if (owner_->mixJobActive_.load())
+            {
+                // Register as busy before re-checking the flag, so that the audio thread never modifies job state
+                // while a helper is still working on it
+                owner_->busyMixWorkers_.fetch_add(1);
+                bool worked = owner_->mixJobActive_.load() && owner_->MixJobWork(workerIndex_);
+                owner_->busyMixWorkers_.fetch_sub(1);
+
+                if (!worked)
+                    Time::Sleep(0);
+            }
+            else
+            {
+                // Sleep longer while idle; a mix job lasts only a fraction of the output buffer length,
+                // and the audio thread mixes on its own if the helpers wake up late
+                Time::Sleep(1);
+            }
+        }
+    }
+
+private:
+    /// Audio subsystem.
+    Audio* owner_;
+    /// Index of the per-worker mix buffer owned by this thread.
+    unsigned workerIndex_;
+};
+
+/// Background thread that keeps the pre-roll buffers of registered sound streams topped up.
+class AudioStreamDecoderThread : public Thread
+{
+public:
+    /// Construct.
+    explicit AudioStreamDecoderThread(Audio* owner) :
+        Thread("AudioStreamDecoder"),
+        owner_(owner)
+    {
+    }
+
+    /// Decode the registered streams periodically.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            owner_->UpdateBackgroundStreams();
+            Time::Sleep(5);
+        }
+    }
+
+private:
+    /// Audio subsystem.
+    Audio* owner_;
+};
+
 Audio::Audio(Context* context) :
     Object(context)
 {
@@ -69,6 +160,13 @@ Audio::Audio(Context* context) :
 Audio::~Audio()
 {
     Release();
+
+    if (streamDecoderThread_)
+    {
+        streamDecoderThread_->Stop();
+        streamDecoderThread_.reset();
+    }
+
     context_->ReleaseSDL();
 }
 
@@ -120,6 +218,25 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     interpolation_ = interpolation;
     clipBuffer_.reset(new int[stereo ? fragmentSize_ << 1u : fragmentSize_]);
 
+#ifdef URHO3D_THREADING
+    // Create helper threads for mixing large voice counts. The audio thread mixes on its own when only a few
+    // sources are playing
+    unsigned numHelpers = Min((unsigned)Max((int)GetNumPhysicalCPUs() - 1, 0), MAX_MIXER_THREADS);
+    if (numHelpers)
+    {
+        workerBuffers_.resize(numHelpers + 1);
+        workerBufferUsed_.resize(numHelpers + 1);
+        for (unsigned i = 0; i < workerBuffers_.size(); ++i)
+            workerBuffers_[i].reset(new int[stereo ? fragmentSize_ << 1u : fragmentSize_]);
+
+        for (unsigned i = 0; i < numHelpers; ++i)
+        {
+            mixerThreads_.push_back(ea::make_unique<AudioMixerThread>(this, i + 1));
+            mixerThreads_.back()->Run();
+        }
+    }
+#endif
+
     URHO3D_LOGINFO("Set audio mode " + ea::to_string(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " +
             (interpolation_ ? "interpolated" : ""));
 
@@ -203,6 +320,51 @@ void Audio::StopSound(Sound* sound)
     }
 }
 
+AudioBus* Audio::CreateBus(const ea::string& name, const ea::string& outputBusName)
+{
+    if (name.empty())
+    {
+        URHO3D_LOGERROR("Can not create a mixing bus without a name");
+        return nullptr;
+    }
+
+    AudioBus* bus = FindBus(StringHash(name));
+    if (!bus)
+    {
+        MutexLock lock(audioMutex_);
+        buses_.push_back(SharedPtr<AudioBus>(new AudioBus(this, name)));
+        bus = buses_.back();
+    }
+
+    if (!outputBusName.empty())
+    {
+        AudioBus* output = FindBus(StringHash(outputBusName));
+        if (!output)
+        {
+            MutexLock lock(audioMutex_);
+            buses_.push_back(SharedPtr<AudioBus>(new AudioBus(this, outputBusName)));
+            output = buses_.back();
+        }
+        bus->SetOutputBus(output);
+    }
+
+    return bus;
+}
+
+void Audio::RemoveBus(const ea::string& name)
+{
+    const StringHash nameHash(name);
+    for (auto i = buses_.begin(); i != buses_.end(); ++i)
+    {
+        if ((*i)->GetNameHash() == nameHash)
+        {
+            MutexLock lock(audioMutex_);
+            buses_.erase(i);
+            return;
+        }
+    }
+}
+
 float Audio::GetMasterGain(const ea::string& type) const
 {
     // By definition previously unknown types return full volume
@@ -218,6 +380,21 @@ bool Audio::IsSoundTypePaused(const ea::string& type) const
     return pausedSoundTypes_.contains(type);
 }
 
+AudioBus* Audio::GetBus(const ea::string& name) const
+{
+    return FindBus(StringHash(name));
+}
+
+AudioBus* Audio::FindBus(StringHash nameHash) const
+{
+    for (auto i = buses_.begin(); i != buses_.end(); ++i)
+    {
+        if ((*i)->GetNameHash() == nameHash)
+            return *i;
+    }
+    return nullptr;
+}
+
 SoundListener* Audio::GetListener() const
 {
     return listener_;
@@ -239,6 +416,42 @@ void Audio::RemoveSoundSource(SoundSource* soundSource)
     }
 }
 
+void Audio::AddBackgroundStream(SoundStream* stream)
+{
+    if (!stream)
+        return;
+
+    MutexLock lock(streamMutex_);
+    backgroundStreams_.push_back(WeakPtr<SoundStream>(stream));
+
+    if (!streamDecoderThread_)
+    {
+        streamDecoderThread_ = ea::make_unique<AudioStreamDecoderThread>(this);
+        streamDecoderThread_->Run();
+    }
+}
+
+void Audio::UpdateBackgroundStreams()
+{
+    // Take strong references under the mutex, then decode outside it so that registering new streams never
+    // blocks on the decode work
+    ea::vector<SharedPtr<SoundStream> > streams;
+    {
+        MutexLock lock(streamMutex_);
+        for (unsigned i = backgroundStreams_.size() - 1; i < backgroundStreams_.size(); --i)
+        {
+            SharedPtr<SoundStream> stream = backgroundStreams_[i].Lock();
+            if (stream)
+                streams.push_back(stream);
+            else
+                backgroundStreams_.erase_at(i);
+        }
+    }
+
+    for (unsigned i = 0; i < streams.size(); ++i)
+        streams[i]->UpdateBackgroundBuffer();
+}
+
 float Audio::GetSoundSourceMasterGain(StringHash typeHash) const
 {
     auto masterIt = masterGain_.find(SOUND_MASTER_HASH);
@@ -283,22 +496,61 @@ void Audio::MixOutput(void* dest, unsigned samples)
         int* clipPtr = clipBuffer_.get();
         memset(clipPtr, 0, clipSamples * sizeof(int));
 
-        // Mix samples to clip buffer
-        for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+        // Mix samples to clip buffer, splitting the voices across the mixer threads when many are playing
+        if (!buses_.empty())
+            MixBuses(clipPtr, workSamples);
+        else if (MixThreaded(workSamples))
         {
-            SoundSource* source = *i;
-
-            // Check for pause if necessary
-            if (!pausedSoundTypes_.empty())
+            // Sum the per-worker mix buffers into the clip buffer
+            for (unsigned i = 0; i < workerBuffers_.size(); ++i)
             {
-                if (pausedSoundTypes_.contains(source->GetSoundType()))
+                if (!workerBufferUsed_[i])
                     continue;
+
+                const int* src = workerBuffers_[i].get();
+                unsigned j = 0;
+#ifdef URHO3D_SSE
+                for (; j + 4 <= clipSamples; j += 4)
+                {
+                    _mm_storeu_si128((__m128i*)(clipPtr + j),
+                        _mm_add_epi32(_mm_loadu_si128((const __m128i*)(clipPtr + j)), _mm_loadu_si128((const __m128i*)(src + j))));
+                }
+#endif
+                for (; j < clipSamples; ++j)
+                    clipPtr[j] += src[j];
             }
+        }
+        else
+        {
+            for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+            {
+                SoundSource* source = *i;
 
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
+                // Check for pause if necessary
+                if (!pausedSoundTypes_.empty())
+                {
+                    if (pausedSoundTypes_.contains(source->GetSoundType()))
+                        continue;
+                }
+
+                source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
+            }
         }
+
         // Copy output from clip buffer to destination
         auto* destPtr = (short*)dest;
+#ifdef URHO3D_SSE
+        // Packing with saturation also performs the clamp to the 16-bit range
+        while (clipSamples >= 8)
+        {
+            __m128i lo = _mm_loadu_si128((const __m128i*)clipPtr);
+            __m128i hi = _mm_loadu_si128((const __m128i*)(clipPtr + 4));
+            _mm_storeu_si128((__m128i*)destPtr, _mm_packs_epi32(lo, hi));
+            clipPtr += 8;
+            destPtr += 8;
+            clipSamples -= 8;
+        }
+#endif
         while (clipSamples--)
             *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
         samples -= workSamples;
@@ -306,6 +558,208 @@ void Audio::MixOutput(void* dest, unsigned samples)
     }
 }
 
+bool Audio::MixThreaded(unsigned samples)
+{
+    if (mixerThreads_.empty())
+        return false;
+
+    // Wait out any helper that is still registered on the previous job before touching the job state
+    while (busyMixWorkers_.load() > 0)
+        Time::Sleep(0);
+    mixJobBuses_.clear();
+
+    // Collect the voices to mix. With only a few, the bookkeeping would cost more than the mixing
+    mixJobSources_.clear();
+    for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+    {
+        SoundSource* source = *i;
+
+        if (!pausedSoundTypes_.empty())
+        {
+            if (pausedSoundTypes_.contains(source->GetSoundType()))
+                continue;
+        }
+
+        mixJobSources_.push_back(source);
+    }
+    if (mixJobSources_.size() < MIN_THREADED_MIX_VOICES)
+        return false;
+
+    for (unsigned i = 0; i < workerBufferUsed_.size(); ++i)
+        workerBufferUsed_[i] = 0;
+
+    mixJobSamples_ = samples;
+    nextMixVoice_.store(0);
+    pendingMixVoices_.store((int)mixJobSources_.size());
+    mixJobActive_.store(true);
+
+    // The audio thread claims voices like the helpers do, so mixing completes even if they wake up late
+    MixJobWork(0);
+    while (pendingMixVoices_.load() > 0)
+        Time::Sleep(0);
+    mixJobActive_.store(false);
+
+    return true;
+}
+
+void Audio::MixBuses(int* dest, unsigned samples)
+{
+    const unsigned clipSamples = stereo_ ? samples << 1u : samples;
+
+    // Prepare the buses and route the voices: sources whose sound type matches a bus mix through it, the rest
+    // directly into the master output
+    for (unsigned i = 0; i < buses_.size(); ++i)
+    {
+        AudioBus* bus = buses_[i];
+        bus->EnsureBuffer(clipSamples);
+        bus->mixSources_.clear();
+        bus->receivesSends_ = false;
+    }
+    for (unsigned i = 0; i < buses_.size(); ++i)
+    {
+        if (AudioBus* output = buses_[i]->outputBus_)
+            output->receivesSends_ = true;
+    }
+
+    for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+    {
+        SoundSource* source = *i;
+
+        if (!pausedSoundTypes_.empty())
+        {
+            if (pausedSoundTypes_.contains(source->GetSoundType()))
+                continue;
+        }
+
+        AudioBus* bus = FindBus(source->GetSoundTypeHash());
+        if (bus)
+            bus->mixSources_.push_back(source);
+        else
+            source->Mix(dest, samples, mixRate_, stereo_, interpolation_);
+    }
+
+    // Mix the bus voices and the effect chains of leaf buses, on the mixer threads when available
+    mixJobSamples_ = samples;
+    if (!mixerThreads_.empty() && buses_.size() >= 2)
+    {
+        // Wait out any helper that is still registered on the previous job before touching the job state
+        while (busyMixWorkers_.load() > 0)
+            Time::Sleep(0);
+
+        mixJobBuses_.clear();
+        for (unsigned i = 0; i < buses_.size(); ++i)
+            mixJobBuses_.push_back(buses_[i]);
+
+        nextMixVoice_.store(0);
+        pendingMixVoices_.store((int)mixJobBuses_.size());
+        mixJobActive_.store(true);
+
+        // The audio thread claims buses like the helpers do, so mixing completes even if they wake up late
+        MixJobWork(0);
+        while (pendingMixVoices_.load() > 0)
+            Time::Sleep(0);
+        mixJobActive_.store(false);
+    }
+    else
+    {
+        for (unsigned i = 0; i < buses_.size(); ++i)
+            MixBusWork(buses_[i]);
+    }
+
+    // Cascade the sends deepest-first, so that a group bus has received all of its children before its own
+    // effect chain runs and it sends onward
+    busOrder_.clear();
+    for (unsigned i = 0; i < buses_.size(); ++i)
+        busOrder_.push_back(ea::make_pair(buses_[i]->GetDepth(), buses_[i].Get()));
+    ea::sort(busOrder_.begin(), busOrder_.end(),
+        [](const ea::pair<unsigned, AudioBus*>& lhs, const ea::pair<unsigned, AudioBus*>& rhs) { return lhs.first > rhs.first; });
+
+    for (unsigned i = 0; i < busOrder_.size(); ++i)
+    {
+        AudioBus* bus = busOrder_[i].second;
+        if (bus->receivesSends_)
+            bus->ProcessEffects(samples, stereo_, mixRate_);
+
+        AudioBus* output = bus->outputBus_;
+        int* target = output ? output->buffer_.get() : dest;
+        const int* src = bus->buffer_.get();
+        const float gain = bus->gain_;
+
+        if (gain == 1.0f)
+        {
+            unsigned j = 0;
+#ifdef URHO3D_SSE
+            for (; j + 4 <= clipSamples; j += 4)
+            {
+                _mm_storeu_si128((__m128i*)(target + j),
+                    _mm_add_epi32(_mm_loadu_si128((const __m128i*)(target + j)), _mm_loadu_si128((const __m128i*)(src + j))));
+            }
+#endif
+            for (; j < clipSamples; ++j)
+                target[j] += src[j];
+        }
+        else if (gain > 0.0f)
+        {
+            for (unsigned j = 0; j < clipSamples; ++j)
+                target[j] += (int)((float)src[j] * gain);
+        }
+    }
+}
+
+void Audio::MixBusWork(AudioBus* bus)
+{
+    int* buffer = bus->buffer_.get();
+    memset(buffer, 0, (stereo_ ? mixJobSamples_ << 1u : mixJobSamples_) * sizeof(int));
+
+    for (unsigned i = 0; i < bus->mixSources_.size(); ++i)
+        bus->mixSources_[i]->Mix(buffer, mixJobSamples_, mixRate_, stereo_, interpolation_);
+
+    // Group buses run their effect chains only once all of their sends have arrived; the effect chain runs
+    // even without routed sources so that reverb tails and similar effect state keep flowing
+    if (!bus->receivesSends_)
+        bus->ProcessEffects(mixJobSamples_, stereo_, mixRate_);
+}
+
+bool Audio::MixJobWork(unsigned workerIndex)
+{
+    // A bus job claims whole buses; a voice job claims individual voices into the per-worker buffers
+    if (!mixJobBuses_.empty())
+    {
+        bool worked = false;
+        for (;;)
+        {
+            int index = nextMixVoice_.fetch_add(1);
+            if (index >= (int)mixJobBuses_.size())
+                return worked;
+
+            MixBusWork(mixJobBuses_[index]);
+            pendingMixVoices_.fetch_sub(1);
+            worked = true;
+        }
+    }
+
+    bool worked = false;
+    int* buffer = workerBuffers_[workerIndex].get();
+
+    for (;;)
+    {
+        int index = nextMixVoice_.fetch_add(1);
+        if (index >= (int)mixJobSources_.size())
+            return worked;
+
+        // Clear the worker buffer lazily so that buffers of workers that never claim a voice need no summing
+        if (!workerBufferUsed_[workerIndex])
+        {
+            memset(buffer, 0, (stereo_ ? mixJobSamples_ << 1u : mixJobSamples_) * sizeof(int));
+            workerBufferUsed_[workerIndex] = 1;
+        }
+
+        mixJobSources_[index]->Mix(buffer, mixJobSamples_, mixRate_, stereo_, interpolation_);
+        pendingMixVoices_.fetch_sub(1);
+        worked = true;
+    }
+}
+
 void Audio::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace RenderUpdate;
@@ -322,6 +776,13 @@ void Audio::Release()
         SDL_CloseAudioDevice(deviceID_);
         deviceID_ = 0;
         clipBuffer_.reset();
+
+        // Stop the mixer threads only after the device is closed, so that no mix job can be active
+        for (unsigned i = 0; i < mixerThreads_.size(); ++i)
+            mixerThreads_[i]->Stop();
+        mixerThreads_.clear();
+        workerBuffers_.clear();
+        workerBufferUsed_.clear();
     }
 }
 
@@ -329,6 +790,8 @@ void Audio::UpdateInternal(float timeStep)
 {
     URHO3D_PROFILE("UpdateAudio");
 
+    UpdateSpatialSources(timeStep);
+
     // Update in reverse order, because sound sources might remove themselves
     for (unsigned i = soundSources_.size() - 1; i < soundSources_.size(); --i)
     {
@@ -345,6 +808,164 @@ void Audio::UpdateInternal(float timeStep)
     }
 }
 
+void Audio::UpdateSpatialSources(float timeStep)
+{
+    SoundListener* listener = listener_;
+    if (!listener || !listener->IsEnabledEffective() || !listener->GetNode())
+        return;
+
+    Node* listenerNode = listener->GetNode();
+    Scene* listenerScene = listener->GetScene();
+
+    // Gather the 3D sources this pass can update: the listener must either be sceneless or in the same scene.
+    // Sources that are skipped fall back to the per-source calculation in their own update
+    spatialSources_.clear();
+    for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+    {
+        auto* source = (*i)->Cast<SoundSource3D>();
+        if (source && source->GetNode() && (!listenerScene || listenerScene == source->GetScene()))
+            spatialSources_.push_back(source);
+    }
+    if (spatialSources_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateSpatialAudio");
+
+    // Pack source positions, padding to a multiple of four for the vector loop
+    unsigned numSources = spatialSources_.size();
+    unsigned paddedCount = (numSources + 3) & ~3u;
+    spatialPosX_.resize(paddedCount);
+    spatialPosY_.resize(paddedCount);
+    spatialPosZ_.resize(paddedCount);
+    spatialDistance_.resize(paddedCount);
+    spatialPanning_.resize(paddedCount);
+
+    for (unsigned i = 0; i < numSources; ++i)
+    {
+        Vector3 position = spatialSources_[i]->GetNode()->GetWorldPosition();
+        spatialPosX_[i] = position.x_;
+        spatialPosY_[i] = position.y_;
+        spatialPosZ_[i] = position.z_;
+    }
+    for (unsigned i = numSources; i < paddedCount; ++i)
+    {
+        spatialPosX_[i] = 0.0f;
+        spatialPosY_[i] = 0.0f;
+        spatialPosZ_[i] = 0.0f;
+    }
+
+    // Compute listener-relative distance and panning for all sources. Applying the inverse listener rotation
+    // equals multiplying by the transpose of its rotation matrix
+    const Vector3 listenerPos = listenerNode->GetWorldPosition();
+    const Matrix3 rot = listenerNode->GetWorldRotation().RotationMatrix();
+
+#ifdef URHO3D_SSE
+    const __m128 lx = _mm_set1_ps(listenerPos.x_);
+    const __m128 ly = _mm_set1_ps(listenerPos.y_);
+    const __m128 lz = _mm_set1_ps(listenerPos.z_);
+    const __m128 epsilon = _mm_set1_ps(M_EPSILON);
+
+    for (unsigned i = 0; i < paddedCount; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&spatialPosX_[i]), lx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&spatialPosY_[i]), ly);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&spatialPosZ_[i]), lz);
+
+        __m128 relX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(rot.m00_), dx), _mm_mul_ps(_mm_set1_ps(rot.m10_), dy)),
+            _mm_mul_ps(_mm_set1_ps(rot.m20_), dz));
+        __m128 relY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(rot.m01_), dx), _mm_mul_ps(_mm_set1_ps(rot.m11_), dy)),
+            _mm_mul_ps(_mm_set1_ps(rot.m21_), dz));
+        __m128 relZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(rot.m02_), dx), _mm_mul_ps(_mm_set1_ps(rot.m12_), dy)),
+            _mm_mul_ps(_mm_set1_ps(rot.m22_), dz));
+
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(relX, relX), _mm_mul_ps(relY, relY)),
+            _mm_mul_ps(relZ, relZ)));
+        // Mask panning to zero for sources at the listener position
+        __m128 panning = _mm_and_ps(_mm_div_ps(relX, distance), _mm_cmpgt_ps(distance, epsilon));
+
+        _mm_storeu_ps(&spatialDistance_[i], distance);
+        _mm_storeu_ps(&spatialPanning_[i], panning);
+    }
+#else
+    for (unsigned i = 0; i < numSources; ++i)
+    {
+        float dx = spatialPosX_[i] - listenerPos.x_;
+        float dy = spatialPosY_[i] - listenerPos.y_;
+        float dz = spatialPosZ_[i] - listenerPos.z_;
+
+        float relX = rot.m00_ * dx + rot.m10_ * dy + rot.m20_ * dz;
+        float relY = rot.m01_ * dx + rot.m11_ * dy + rot.m21_ * dz;
+        float relZ = rot.m02_ * dx + rot.m12_ * dy + rot.m22_ * dz;
+
+        float distance = sqrtf(relX * relX + relY * relY + relZ * relZ);
+        spatialDistance_[i] = distance;
+        spatialPanning_[i] = distance > M_EPSILON ? relX / distance : 0.0f;
+    }
+#endif
+
+    for (unsigned i = 0; i < numSources; ++i)
+        spatialSources_[i]->ApplyAttenuation(spatialDistance_[i], spatialPanning_[i], timeStep);
+
+#ifdef URHO3D_PHYSICS
+    // Amortized occlusion tests: accumulate priority so that every source eventually gets tested, louder ones
+    // sooner, and raycast a bounded batch of the most urgent sources per update
+    auto* physicsWorld = listenerScene ? listenerScene->GetComponent<PhysicsWorld>() : nullptr;
+    if (physicsWorld)
+    {
+        occlusionQueue_.clear();
+        for (unsigned i = 0; i < numSources; ++i)
+        {
+            SoundSource3D* source = spatialSources_[i];
+            if (!source->IsOcclusionEnabled())
+                continue;
+
+            if (spatialDistance_[i] <= OCCLUSION_DISTANCE_MARGIN)
+            {
+                // A source this close can not be occluded
+                source->occlusionTarget_ = 1.0f;
+                source->occlusionPriority_ = 0.0f;
+                continue;
+            }
+
+            source->occlusionPriority_ += 1.0f + source->GetAttenuation();
+            occlusionQueue_.push_back(ea::make_pair(source->occlusionPriority_, i));
+        }
+
+        if (!occlusionQueue_.empty())
+        {
+            unsigned numRays = Min((unsigned)occlusionQueue_.size(), MAX_OCCLUSION_RAYS);
+            if (occlusionQueue_.size() > numRays)
+            {
+                ea::partial_sort(occlusionQueue_.begin(), occlusionQueue_.begin() + numRays, occlusionQueue_.end(),
+                    [](const ea::pair<float, unsigned>& lhs, const ea::pair<float, unsigned>& rhs) { return lhs.first > rhs.first; });
+            }
+
+            Ray rays[MAX_OCCLUSION_RAYS];
+            PhysicsRaycastResult results[MAX_OCCLUSION_RAYS];
+            float maxDistance = 0.0f;
+            for (unsigned r = 0; r < numRays; ++r)
+            {
+                unsigned index = occlusionQueue_[r].second;
+                Vector3 sourcePos(spatialPosX_[index], spatialPosY_[index], spatialPosZ_[index]);
+                rays[r] = Ray(listenerPos, sourcePos - listenerPos);
+                maxDistance = Max(maxDistance, spatialDistance_[index]);
+            }
+
+            physicsWorld->RaycastSingleBatch(results, rays, numRays, maxDistance);
+
+            for (unsigned r = 0; r < numRays; ++r)
+            {
+                unsigned index = occlusionQueue_[r].second;
+                SoundSource3D* source = spatialSources_[index];
+                bool occluded = results[r].body_ && results[r].distance_ < spatialDistance_[index] - OCCLUSION_DISTANCE_MARGIN;
+                source->occlusionTarget_ = occluded ? source->GetOcclusionAttenuation() : 1.0f;
+                source->occlusionPriority_ = 0.0f;
+            }
+        }
+    }
+#endif
+}
+
 void RegisterAudioLibrary(Context* context)
 {
     Sound::RegisterObject(context);
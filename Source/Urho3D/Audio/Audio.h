@@ -24,6 +24,7 @@
 
 #include <EASTL/unique_ptr.h>
 #include <EASTL/hash_set.h>
+#include <atomic>
 
 #include "../Audio/AudioDefs.h"
 #include "../Core/Mutex.h"
@@ -32,16 +33,24 @@
 namespace Urho3D
 {
 
+class AudioBus;
 class AudioImpl;
+class AudioMixerThread;
+class AudioStreamDecoderThread;
 class Sound;
 class SoundListener;
 class SoundSource;
+class SoundSource3D;
+class SoundStream;
 
 /// %Audio subsystem.
 class URHO3D_API Audio : public Object
 {
     URHO3D_OBJECT(Audio, Object);
 
+    friend class AudioMixerThread;
+    friend class AudioStreamDecoderThread;
+
 public:
     /// Construct.
     explicit Audio(Context* context);
@@ -64,6 +73,10 @@ public:
     void ResumeSoundType(const ea::string& type);
     /// Resume playback of all sound types.
     void ResumeAll();
+    /// Create a named mixing bus, or return the existing bus of that name. Sound sources whose sound type matches the bus name are mixed through the bus. The bus sends its output to the named output bus, or to the master output when the name is empty.
+    AudioBus* CreateBus(const ea::string& name, const ea::string& outputBusName = EMPTY_STRING);
+    /// Remove a mixing bus. Its sources revert to mixing directly into the master output.
+    void RemoveBus(const ea::string& name);
     /// Set active sound listener for 3D sounds.
     void SetListener(SoundListener* listener);
     /// Stop any sound source playing a certain sound clip.
@@ -93,6 +106,11 @@ public:
     /// Return whether specific sound type has been paused.
     bool IsSoundTypePaused(const ea::string& type) const;
 
+    /// Return a mixing bus by name, or null if not found.
+    AudioBus* GetBus(const ea::string& name) const;
+    /// Return all mixing buses.
+    const ea::vector<SharedPtr<AudioBus> >& GetBuses() const { return buses_; }
+
     /// Return active sound listener.
     SoundListener* GetListener() const;
 
@@ -106,6 +124,8 @@ public:
     void AddSoundSource(SoundSource* soundSource);
     /// Remove a sound source. Called by SoundSource.
     void RemoveSoundSource(SoundSource* soundSource);
+    /// Register a sound stream for pre-roll decoding on the stream decoder thread. The stream is tracked weakly and unregisters itself by expiring.
+    void AddBackgroundStream(SoundStream* stream);
 
     /// Return audio thread mutex.
     Mutex& GetMutex() { return audioMutex_; }
@@ -123,6 +143,20 @@ private:
     void Release();
     /// Actually update sound sources with the specific timestep. Called internally.
     void UpdateInternal(float timeStep);
+    /// Mix a block of samples with the sound sources split across the mixer threads. Return false if the threaded path is not available or not worthwhile.
+    bool MixThreaded(unsigned samples);
+    /// Mix a block of samples through the bus graph. Bus voice mixing and leaf effect chains run on the mixer threads when available.
+    void MixBuses(int* dest, unsigned samples);
+    /// Mix the routed sources of one bus into its buffer and run its effect chain unless it receives sends from other buses. Called by both the audio thread and the mixer threads.
+    void MixBusWork(AudioBus* bus);
+    /// Return a mixing bus by name hash, or null if not found.
+    AudioBus* FindBus(StringHash nameHash) const;
+    /// Claim unmixed voices of the current mix job and mix them into the per-worker buffer. Called by both the audio thread and the mixer threads. Return true if at least one voice was mixed.
+    bool MixJobWork(unsigned workerIndex);
+    /// Top up the pre-roll buffers of the registered background streams and prune expired ones. Called by the stream decoder thread.
+    void UpdateBackgroundStreams();
+    /// Update 3D sound sources in a batched pass: gather positions into packed arrays, compute distance and panning vectorized, and run amortized occlusion raycasts.
+    void UpdateSpatialSources(float timeStep);
 
     /// Clipping buffer for mixing.
     ea::unique_ptr<int[]> clipBuffer_;
@@ -148,6 +182,48 @@ private:
     ea::hash_set<StringHash> pausedSoundTypes_;
     /// Sound sources.
     ea::vector<SoundSource*> soundSources_;
+    /// Helper threads that assist the audio thread in mixing.
+    ea::vector<ea::unique_ptr<AudioMixerThread> > mixerThreads_;
+    /// Per-worker mix buffers. Index 0 belongs to the audio thread.
+    ea::vector<ea::unique_ptr<int[]> > workerBuffers_;
+    /// Flags for worker buffers that have been written to during the current mix job.
+    ea::vector<unsigned> workerBufferUsed_;
+    /// Mixing buses in creation order.
+    ea::vector<SharedPtr<AudioBus> > buses_;
+    /// Buses of the current mix job. When non-empty, the mix job claims whole buses instead of voices.
+    ea::vector<AudioBus*> mixJobBuses_;
+    /// Scratch: buses ordered deepest-first for cascading sends of the current mix block.
+    ea::vector<ea::pair<unsigned, AudioBus*> > busOrder_;
+    /// Sound sources of the current mix job.
+    ea::vector<SoundSource*> mixJobSources_;
+    /// Sample count of the current mix job.
+    unsigned mixJobSamples_{};
+    /// Next unclaimed voice index of the current mix job.
+    std::atomic<int> nextMixVoice_{};
+    /// Claimed voices of the current mix job that have not finished mixing yet.
+    std::atomic<int> pendingMixVoices_{};
+    /// Number of mixer threads currently working on the mix job.
+    std::atomic<int> busyMixWorkers_{};
+    /// Mix job active flag. Signals the mixer threads to start claiming voices.
+    std::atomic<bool> mixJobActive_{};
+    /// Scratch: 3D sources of the current spatial update.
+    ea::vector<SoundSource3D*> spatialSources_;
+    /// Scratch: packed source world positions of the current spatial update.
+    ea::vector<float> spatialPosX_;
+    ea::vector<float> spatialPosY_;
+    ea::vector<float> spatialPosZ_;
+    /// Scratch: computed listener distances of the current spatial update.
+    ea::vector<float> spatialDistance_;
+    /// Scratch: computed pannings of the current spatial update.
+    ea::vector<float> spatialPanning_;
+    /// Scratch: occlusion candidates as (priority, source index) of the current spatial update.
+    ea::vector<ea::pair<float, unsigned> > occlusionQueue_;
+    /// Sound streams registered for background pre-roll decoding.
+    ea::vector<WeakPtr<SoundStream> > backgroundStreams_;
+    /// Mutex for the background stream list.
+    Mutex streamMutex_;
+    /// Stream decoder thread. Created when the first background stream is registered.
+    ea::unique_ptr<AudioStreamDecoderThread> streamDecoderThread_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
 };
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/Audio.h"
+#include "../Audio/AudioBus.h"
+#include "../IO/Log.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+AudioBus::AudioBus(Audio* audio, const ea::string& name) :
+    audio_(audio),
+    name_(name),
+    nameHash_(name)
+{
+}
+
+void AudioBus::SetGain(float gain)
+{
+    gain_ = Max(gain, 0.0f);
+}
+
+void AudioBus::SetOutputBus(AudioBus* bus)
+{
+    // Refuse cycles: walking the sends from the new output must never arrive back at this bus
+    for (AudioBus* out = bus; out; out = out->outputBus_)
+    {
+        if (out == this)
+        {
+            URHO3D_LOGERROR("Can not set output of bus " + name_ + ", would create a send cycle");
+            return;
+        }
+    }
+
+    MutexLock lock(audio_->GetMutex());
+    outputBus_ = bus;
+}
+
+void AudioBus::AddEffect(AudioEffect* effect)
+{
+    if (!effect)
+        return;
+
+    MutexLock lock(audio_->GetMutex());
+    effects_.push_back(SharedPtr<AudioEffect>(effect));
+}
+
+void AudioBus::RemoveEffect(AudioEffect* effect)
+{
+    auto i = effects_.find(SharedPtr<AudioEffect>(effect));
+    if (i != effects_.end())
+    {
+        MutexLock lock(audio_->GetMutex());
+        effects_.erase(i);
+    }
+}
+
+void AudioBus::RemoveAllEffects()
+{
+    MutexLock lock(audio_->GetMutex());
+    effects_.clear();
+}
+
+AudioEffect* AudioBus::GetEffect(unsigned index) const
+{
+    return index < effects_.size() ? effects_[index] : nullptr;
+}
+
+void AudioBus::EnsureBuffer(unsigned capacity)
+{
+    if (bufferCapacity_ < capacity)
+    {
+        buffer_.reset(new int[capacity]);
+        bufferCapacity_ = capacity;
+    }
+}
+
+void AudioBus::ProcessEffects(unsigned numFrames, bool stereo, int mixRate)
+{
+    for (unsigned i = 0; i < effects_.size(); ++i)
+    {
+        if (!effects_[i]->IsBypassed())
+            effects_[i]->Process(buffer_.get(), numFrames, stereo, mixRate);
+    }
+}
+
+unsigned AudioBus::GetDepth() const
+{
+    // Guard against a send cycle created by outside means, even though SetOutputBus() refuses them
+    unsigned depth = 0;
+    for (AudioBus* out = outputBus_; out && depth < 256; out = out->outputBus_)
+        ++depth;
+    return depth;
+}
+
+}
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unique_ptr.h>
+
+#include "../Audio/AudioEffect.h"
+#include "../Container/Ptr.h"
+#include "../Container/Str.h"
+#include "../Math/StringHash.h"
+
+namespace Urho3D
+{
+
+class Audio;
+class SoundSource;
+
+/// Mixing bus with an effect chain. Sound sources whose sound type matches the bus name are mixed through the
+/// bus, whose output is sent to another bus or to the master output. Created with Audio::CreateBus().
+class URHO3D_API AudioBus : public RefCounted
+{
+    friend class Audio;
+
+public:
+    /// Construct. Use Audio::CreateBus() instead of constructing directly.
+    AudioBus(Audio* audio, const ea::string& name);
+
+    /// Set bus gain, applied to the output after the effect chain.
+    void SetGain(float gain);
+    /// Set the bus this bus sends its output to, or null to send to the master output. Refuses to create a send cycle.
+    void SetOutputBus(AudioBus* bus);
+    /// Add an effect to the end of the effect chain.
+    void AddEffect(AudioEffect* effect);
+    /// Remove an effect from the effect chain.
+    void RemoveEffect(AudioEffect* effect);
+    /// Remove all effects.
+    void RemoveAllEffects();
+
+    /// Return bus name.
+    const ea::string& GetName() const { return name_; }
+    /// Return bus name hash.
+    StringHash GetNameHash() const { return nameHash_; }
+    /// Return bus gain.
+    float GetGain() const { return gain_; }
+    /// Return the bus this bus sends its output to, or null for the master output.
+    AudioBus* GetOutputBus() const { return outputBus_; }
+    /// Return number of effects in the effect chain.
+    unsigned GetNumEffects() const { return effects_.size(); }
+    /// Return effect in the effect chain by index.
+    AudioEffect* GetEffect(unsigned index) const;
+
+private:
+    /// Reallocate the mix buffer if the needed capacity in samples has grown.
+    void EnsureBuffer(unsigned capacity);
+    /// Run the effect chain on the mix buffer. Called on the audio or a mixer thread.
+    void ProcessEffects(unsigned numFrames, bool stereo, int mixRate);
+    /// Return the number of sends between this bus and the master output.
+    unsigned GetDepth() const;
+
+    /// Audio subsystem.
+    Audio* audio_;
+    /// Bus name.
+    ea::string name_;
+    /// Bus name hash.
+    StringHash nameHash_;
+    /// Bus gain.
+    float gain_{1.0f};
+    /// Output bus. Expires to the master output if the bus is removed.
+    WeakPtr<AudioBus> outputBus_;
+    /// Effect chain. Modified only while holding the audio mutex.
+    ea::vector<SharedPtr<AudioEffect> > effects_;
+    /// Mix buffer for the sources routed to this bus.
+    ea::unique_ptr<int[]> buffer_;
+    /// Mix buffer capacity in samples.
+    unsigned bufferCapacity_{};
+    /// Scratch: sources routed to this bus during the current mix block.
+    ea::vector<SoundSource*> mixSources_;
+    /// Scratch: whether another bus sends to this bus during the current mix block. Group buses run their effects only after receiving all sends.
+    bool receivesSends_{};
+};
+
+}
@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioEffect.h"
+#include "../Math/MathDefs.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// Comb and allpass delay lengths in samples at 44100 Hz, scaled to the actual mix rate. The mutually prime
+// comb lengths spread the echo density; the right channel is offset slightly for stereo width
+static const unsigned REVERB_COMB_LENGTHS[] = { 1116, 1188, 1277, 1356 };
+static const unsigned REVERB_ALLPASS_LENGTHS[] = { 556, 441 };
+static const unsigned REVERB_STEREO_SPREAD = 23;
+static const float REVERB_ALLPASS_FEEDBACK = 0.5f;
+
+/// Convert decibels to a linear gain factor.
+static inline float DbToGain(float db)
+{
+    return Pow(10.0f, db / 20.0f);
+}
+
+AudioBiquadEffect::AudioBiquadEffect(AudioFilterType type, float frequency, float q, float gain) :
+    type_(type),
+    frequency_(frequency),
+    q_(q),
+    gain_(gain)
+{
+}
+
+void AudioBiquadEffect::SetFilterType(AudioFilterType type)
+{
+    type_ = type;
+    coeffMixRate_ = 0;
+}
+
+void AudioBiquadEffect::SetFrequency(float frequency)
+{
+    frequency_ = Max(frequency, 1.0f);
+    coeffMixRate_ = 0;
+}
+
+void AudioBiquadEffect::SetQ(float q)
+{
+    q_ = Max(q, M_EPSILON);
+    coeffMixRate_ = 0;
+}
+
+void AudioBiquadEffect::SetGain(float gain)
+{
+    gain_ = gain;
+    coeffMixRate_ = 0;
+}
+
+void AudioBiquadEffect::Reset()
+{
+    z1_[0] = z1_[1] = 0.0f;
+    z2_[0] = z2_[1] = 0.0f;
+}
+
+void AudioBiquadEffect::UpdateCoefficients(int mixRate)
+{
+    // Standard RBJ audio EQ cookbook coefficients, normalized by a0
+    const float omega = 2.0f * M_PI * Min(frequency_, 0.45f * (float)mixRate) / (float)mixRate;
+    const float sinOmega = sinf(omega);
+    const float cosOmega = cosf(omega);
+    const float alpha = sinOmega / (2.0f * q_);
+    const float a = DbToGain(gain_ * 0.5f);
+
+    float b0, b1, b2, a0, a1, a2;
+    switch (type_)
+    {
+    case FILTER_HIGHPASS:
+        b0 = (1.0f + cosOmega) * 0.5f;
+        b1 = -(1.0f + cosOmega);
+        b2 = b0;
+        a0 = 1.0f + alpha;
+        a1 = -2.0f * cosOmega;
+        a2 = 1.0f - alpha;
+        break;
+
+    case FILTER_BANDPASS:
+        b0 = alpha;
+        b1 = 0.0f;
+        b2 = -alpha;
+        a0 = 1.0f + alpha;
+        a1 = -2.0f * cosOmega;
+        a2 = 1.0f - alpha;
+        break;
+
+    case FILTER_PEAKING:
+        b0 = 1.0f + alpha * a;
+        b1 = -2.0f * cosOmega;
+        b2 = 1.0f - alpha * a;
+        a0 = 1.0f + alpha / a;
+        a1 = -2.0f * cosOmega;
+        a2 = 1.0f - alpha / a;
+        break;
+
+    case FILTER_LOWSHELF:
+        {
+            const float beta = 2.0f * Sqrt(a) * alpha;
+            b0 = a * ((a + 1.0f) - (a - 1.0f) * cosOmega + beta);
+            b1 = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cosOmega);
+            b2 = a * ((a + 1.0f) - (a - 1.0f) * cosOmega - beta);
+            a0 = (a + 1.0f) + (a - 1.0f) * cosOmega + beta;
+            a1 = -2.0f * ((a - 1.0f) + (a + 1.0f) * cosOmega);
+            a2 = (a + 1.0f) + (a - 1.0f) * cosOmega - beta;
+        }
+        break;
+
+    case FILTER_HIGHSHELF:
+        {
+            const float beta = 2.0f * Sqrt(a) * alpha;
+            b0 = a * ((a + 1.0f) + (a - 1.0f) * cosOmega + beta);
+            b1 = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cosOmega);
+            b2 = a * ((a + 1.0f) + (a - 1.0f) * cosOmega - beta);
+            a0 = (a + 1.0f) - (a - 1.0f) * cosOmega + beta;
+            a1 = 2.0f * ((a - 1.0f) - (a + 1.0f) * cosOmega);
+            a2 = (a + 1.0f) - (a - 1.0f) * cosOmega - beta;
+        }
+        break;
+
+    case FILTER_LOWPASS:
+    default:
+        b0 = (1.0f - cosOmega) * 0.5f;
+        b1 = 1.0f - cosOmega;
+        b2 = b0;
+        a0 = 1.0f + alpha;
+        a1 = -2.0f * cosOmega;
+        a2 = 1.0f - alpha;
+        break;
+    }
+
+    const float invA0 = 1.0f / a0;
+    b0_ = b0 * invA0;
+    b1_ = b1 * invA0;
+    b2_ = b2 * invA0;
+    a1_ = a1 * invA0;
+    a2_ = a2 * invA0;
+    coeffMixRate_ = mixRate;
+}
+
+void AudioBiquadEffect::Process(int* buffer, unsigned numFrames, bool stereo, int mixRate)
+{
+    if (coeffMixRate_ != mixRate)
+        UpdateCoefficients(mixRate);
+
+    const unsigned channels = stereo ? 2 : 1;
+    for (unsigned c = 0; c < channels; ++c)
+    {
+        int* ptr = buffer + c;
+        float z1 = z1_[c];
+        float z2 = z2_[c];
+
+        for (unsigned i = 0; i < numFrames; ++i)
+        {
+            const float in = (float)*ptr;
+            const float out = b0_ * in + z1;
+            z1 = b1_ * in - a1_ * out + z2;
+            z2 = b2_ * in - a2_ * out;
+            *ptr = (int)out;
+            ptr += channels;
+        }
+
+        z1_[c] = z1;
+        z2_[c] = z2;
+    }
+}
+
+AudioCompressorEffect::AudioCompressorEffect(float threshold, float ratio, float attack, float release, float makeupGain) :
+    threshold_(threshold),
+    ratio_(Max(ratio, 1.0f)),
+    attack_(Max(attack, 0.01f)),
+    release_(Max(release, 0.01f)),
+    makeupGain_(makeupGain)
+{
+}
+
+void AudioCompressorEffect::SetRatio(float ratio)
+{
+    ratio_ = Max(ratio, 1.0f);
+}
+
+void AudioCompressorEffect::SetAttack(float attack)
+{
+    attack_ = Max(attack, 0.01f);
+}
+
+void AudioCompressorEffect::SetRelease(float release)
+{
+    release_ = Max(release, 0.01f);
+}
+
+void AudioCompressorEffect::Reset()
+{
+    envelope_ = -120.0f;
+}
+
+void AudioCompressorEffect::Process(int* buffer, unsigned numFrames, bool stereo, int mixRate)
+{
+    const unsigned channels = stereo ? 2 : 1;
+    const float attackCoeff = expf(-1000.0f / (attack_ * (float)mixRate));
+    const float releaseCoeff = expf(-1000.0f / (release_ * (float)mixRate));
+    const float makeup = DbToGain(makeupGain_);
+    const float slope = 1.0f - 1.0f / ratio_;
+
+    int* ptr = buffer;
+    float envelope = envelope_;
+
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        // Detect the peak level of the frame across channels, in dB relative to 16-bit full scale
+        float peak = Abs((float)ptr[0]);
+        if (stereo)
+            peak = Max(peak, Abs((float)ptr[1]));
+        const float levelDb = 20.0f * log10f(Max(peak / 32768.0f, 1e-6f));
+
+        // Smooth the level with separate attack and release time constants
+        const float coeff = levelDb > envelope ? attackCoeff : releaseCoeff;
+        envelope = coeff * envelope + (1.0f - coeff) * levelDb;
+
+        // Reduce gain above the threshold according to the ratio
+        const float overDb = envelope - threshold_;
+        const float gain = (overDb > 0.0f ? DbToGain(-overDb * slope) : 1.0f) * makeup;
+
+        for (unsigned c = 0; c < channels; ++c)
+            ptr[c] = (int)((float)ptr[c] * gain);
+        ptr += channels;
+    }
+
+    envelope_ = envelope;
+}
+
+AudioReverbEffect::AudioReverbEffect(float roomSize, float damping, float mix) :
+    roomSize_(Clamp(roomSize, 0.0f, 1.0f)),
+    damping_(Clamp(damping, 0.0f, 1.0f)),
+    mix_(Clamp(mix, 0.0f, 1.0f))
+{
+}
+
+void AudioReverbEffect::SetRoomSize(float roomSize)
+{
+    roomSize_ = Clamp(roomSize, 0.0f, 1.0f);
+}
+
+void AudioReverbEffect::SetDamping(float damping)
+{
+    damping_ = Clamp(damping, 0.0f, 1.0f);
+}
+
+void AudioReverbEffect::SetMix(float mix)
+{
+    mix_ = Clamp(mix, 0.0f, 1.0f);
+}
+
+void AudioReverbEffect::Reset()
+{
+    for (unsigned c = 0; c < 2; ++c)
+    {
+        for (unsigned i = 0; i < NUM_COMBS; ++i)
+        {
+            ea::fill(combBuffers_[c][i].begin(), combBuffers_[c][i].end(), 0.0f);
+            combDampState_[c][i] = 0.0f;
+        }
+        for (unsigned i = 0; i < NUM_ALLPASSES; ++i)
+            ea::fill(allpassBuffers_[c][i].begin(), allpassBuffers_[c][i].end(), 0.0f);
+    }
+}
+
+void AudioReverbEffect::EnsureDelayLines(int mixRate)
+{
+    if (delayMixRate_ == mixRate)
+        return;
+
+    for (unsigned c = 0; c < 2; ++c)
+    {
+        const unsigned spread = c ? REVERB_STEREO_SPREAD : 0;
+        for (unsigned i = 0; i < NUM_COMBS; ++i)
+        {
+            const unsigned length = Max((REVERB_COMB_LENGTHS[i] + spread) * (unsigned)mixRate / 44100, 1U);
+            combBuffers_[c][i].clear();
+            combBuffers_[c][i].resize(length, 0.0f);
+            combPositions_[c][i] = 0;
+            combDampState_[c][i] = 0.0f;
+        }
+        for (unsigned i = 0; i < NUM_ALLPASSES; ++i)
+        {
+            const unsigned length = Max((REVERB_ALLPASS_LENGTHS[i] + spread) * (unsigned)mixRate / 44100, 1U);
+            allpassBuffers_[c][i].clear();
+            allpassBuffers_[c][i].resize(length, 0.0f);
+            allpassPositions_[c][i] = 0;
+        }
+    }
+
+    delayMixRate_ = mixRate;
+}
+
+void AudioReverbEffect::Process(int* buffer, unsigned numFrames, bool stereo, int mixRate)
+{
+    EnsureDelayLines(mixRate);
+
+    const unsigned channels = stereo ? 2 : 1;
+    const float feedback = 0.7f + roomSize_ * 0.28f;
+    const float damp = damping_ * 0.4f;
+    const float wet = mix_ / (float)NUM_COMBS;
+    const float dry = 1.0f - mix_;
+
+    for (unsigned c = 0; c < channels; ++c)
+    {
+        int* ptr = buffer + c;
+        for (unsigned i = 0; i < numFrames; ++i)
+        {
+            const float in = (float)*ptr;
+            float out = 0.0f;
+
+            // Parallel damped comb filters build the reverb tail
+            for (unsigned j = 0; j < NUM_COMBS; ++j)
+            {
+                ea::vector<float>& line = combBuffers_[c][j];
+                unsigned& pos = combPositions_[c][j];
+                const float delayed = line[pos];
+                combDampState_[c][j] = delayed * (1.0f - damp) + combDampState_[c][j] * damp;
+                line[pos] = in + combDampState_[c][j] * feedback;
+                if (++pos >= line.size())
+                    pos = 0;
+                out += delayed;
+            }
+            out *= wet;
+
+            // Serial allpass filters diffuse the echoes
+            for (unsigned j = 0; j < NUM_ALLPASSES; ++j)
+            {
+                ea::vector<float>& line = allpassBuffers_[c][j];
+                unsigned& pos = allpassPositions_[c][j];
+                const float delayed = line[pos];
+                line[pos] = out + delayed * REVERB_ALLPASS_FEEDBACK;
+                if (++pos >= line.size())
+                    pos = 0;
+                out = delayed - out * REVERB_ALLPASS_FEEDBACK;
+            }
+
+            *ptr = (int)(in * dry + out);
+            ptr += channels;
+        }
+    }
+}
+
+}
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/vector.h>
+
+#include "../Container/RefCounted.h"
+
+namespace Urho3D
+{
+
+/// Biquad filter type.
+enum AudioFilterType
+{
+    FILTER_LOWPASS = 0,
+    FILTER_HIGHPASS,
+    FILTER_BANDPASS,
+    FILTER_PEAKING,
+    FILTER_LOWSHELF,
+    FILTER_HIGHSHELF
+};
+
+/// Base class for mixing bus effects. Effects process blocks of mixed 32-bit samples in place on the audio thread.
+class URHO3D_API AudioEffect : public RefCounted
+{
+public:
+    /// Process a block of mixed samples in place. The buffer is interleaved and holds 2 * numFrames samples when stereo. Called on the audio thread.
+    virtual void Process(int* buffer, unsigned numFrames, bool stereo, int mixRate) = 0;
+    /// Reset the internal filter state, e.g. after an abrupt scene change.
+    virtual void Reset() { }
+
+    /// Set whether the effect is bypassed without removing it from its bus.
+    void SetBypassed(bool bypass) { bypassed_ = bypass; }
+    /// Return whether the effect is bypassed.
+    bool IsBypassed() const { return bypassed_; }
+
+private:
+    /// Bypass flag.
+    bool bypassed_{};
+};
+
+/// Biquad EQ filter effect.
+class URHO3D_API AudioBiquadEffect : public AudioEffect
+{
+public:
+    /// Construct with filter parameters. Gain is used by the peaking and shelf types only.
+    explicit AudioBiquadEffect(AudioFilterType type = FILTER_LOWPASS, float frequency = 1000.0f, float q = 0.707f, float gain = 0.0f);
+
+    /// Filter the sample block in place.
+    void Process(int* buffer, unsigned numFrames, bool stereo, int mixRate) override;
+    /// Reset the filter delay state.
+    void Reset() override;
+
+    /// Set filter type.
+    void SetFilterType(AudioFilterType type);
+    /// Set corner or center frequency in Hz.
+    void SetFrequency(float frequency);
+    /// Set filter Q (resonance.)
+    void SetQ(float q);
+    /// Set peaking or shelf gain in dB.
+    void SetGain(float gain);
+
+    /// Return filter type.
+    AudioFilterType GetFilterType() const { return type_; }
+    /// Return corner or center frequency in Hz.
+    float GetFrequency() const { return frequency_; }
+    /// Return filter Q.
+    float GetQ() const { return q_; }
+    /// Return peaking or shelf gain in dB.
+    float GetGain() const { return gain_; }
+
+private:
+    /// Recalculate the filter coefficients for the mix rate.
+    void UpdateCoefficients(int mixRate);
+
+    /// Filter type.
+    AudioFilterType type_;
+    /// Corner or center frequency in Hz.
+    float frequency_;
+    /// Filter Q.
+    float q_;
+    /// Peaking or shelf gain in dB.
+    float gain_;
+    /// Mix rate the current coefficients were calculated for. Zero when parameters have changed.
+    int coeffMixRate_{};
+    /// Filter coefficients.
+    float b0_{}, b1_{}, b2_{}, a1_{}, a2_{};
+    /// Per-channel delay state (transposed direct form II.)
+    float z1_[2]{};
+    float z2_[2]{};
+};
+
+/// Dynamic range compressor effect. Can also be used for ducking by routing the bus to compress through it.
+class URHO3D_API AudioCompressorEffect : public AudioEffect
+{
+public:
+    /// Construct with compression parameters.
+    explicit AudioCompressorEffect(float threshold = -12.0f, float ratio = 4.0f, float attack = 10.0f, float release = 200.0f, float makeupGain = 0.0f);
+
+    /// Compress the sample block in place.
+    void Process(int* buffer, unsigned numFrames, bool stereo, int mixRate) override;
+    /// Reset the envelope follower.
+    void Reset() override;
+
+    /// Set threshold in dB below full scale.
+    void SetThreshold(float threshold) { threshold_ = threshold; }
+    /// Set compression ratio.
+    void SetRatio(float ratio);
+    /// Set attack time in milliseconds.
+    void SetAttack(float attack);
+    /// Set release time in milliseconds.
+    void SetRelease(float release);
+    /// Set makeup gain in dB.
+    void SetMakeupGain(float gain) { makeupGain_ = gain; }
+
+    /// Return threshold in dB.
+    float GetThreshold() const { return threshold_; }
+    /// Return compression ratio.
+    float GetRatio() const { return ratio_; }
+    /// Return attack time in milliseconds.
+    float GetAttack() const { return attack_; }
+    /// Return release time in milliseconds.
+    float GetRelease() const { return release_; }
+    /// Return makeup gain in dB.
+    float GetMakeupGain() const { return makeupGain_; }
+
+private:
+    /// Threshold in dB below full scale.
+    float threshold_;
+    /// Compression ratio.
+    float ratio_;
+    /// Attack time in milliseconds.
+    float attack_;
+    /// Release time in milliseconds.
+    float release_;
+    /// Makeup gain in dB.
+    float makeupGain_;
+    /// Envelope follower level in dB.
+    float envelope_{-120.0f};
+};
+
+/// Algorithmic (convolution-free) reverb effect using parallel comb and serial allpass filters.
+class URHO3D_API AudioReverbEffect : public AudioEffect
+{
+public:
+    /// Construct with reverb parameters.
+    explicit AudioReverbEffect(float roomSize = 0.5f, float damping = 0.5f, float mix = 0.3f);
+
+    /// Add reverberation to the sample block in place.
+    void Process(int* buffer, unsigned numFrames, bool stereo, int mixRate) override;
+    /// Clear the reverb tail.
+    void Reset() override;
+
+    /// Set room size (0 = small, 1 = large.)
+    void SetRoomSize(float roomSize);
+    /// Set high frequency damping (0 = bright, 1 = dark.)
+    void SetDamping(float damping);
+    /// Set wet/dry mix (0 = dry only, 1 = wet only.)
+    void SetMix(float mix);
+
+    /// Return room size.
+    float GetRoomSize() const { return roomSize_; }
+    /// Return high frequency damping.
+    float GetDamping() const { return damping_; }
+    /// Return wet/dry mix.
+    float GetMix() const { return mix_; }
+
+private:
+    /// Number of parallel comb filters per channel.
+    static const unsigned NUM_COMBS = 4;
+    /// Number of serial allpass filters per channel.
+    static const unsigned NUM_ALLPASSES = 2;
+
+    /// Allocate the delay lines for the mix rate.
+    void EnsureDelayLines(int mixRate);
+
+    /// Room size.
+    float roomSize_;
+    /// High frequency damping.
+    float damping_;
+    /// Wet/dry mix.
+    float mix_;
+    /// Mix rate the delay lines were allocated for.
+    int delayMixRate_{};
+    /// Comb filter delay lines, per channel.
+    ea::vector<float> combBuffers_[2][NUM_COMBS];
+    /// Comb filter write positions, per channel.
+    unsigned combPositions_[2][NUM_COMBS]{};
+    /// Comb filter damping state, per channel.
+    float combDampState_[2][NUM_COMBS]{};
+    /// Allpass filter delay lines, per channel.
+    ea::vector<float> allpassBuffers_[2][NUM_ALLPASSES];
+    /// Allpass filter write positions, per channel.
+    unsigned allpassPositions_[2][NUM_ALLPASSES]{};
+};
+
+}
@@ -22,8 +22,12 @@
 
 #include "../Precompiled.h"
 
+#include "../Audio/Audio.h"
 #include "../Audio/OggVorbisSoundStream.h"
 #include "../Audio/Sound.h"
+#include "../Core/Context.h"
+#include "../IO/File.h"
+#include "../Resource/ResourceCache.h"
 
 #include <STB/stb_vorbis.h>
 
@@ -32,6 +36,13 @@
 namespace Urho3D
 {
 
+/// Length of pre-rolled decoded data to keep per stream, in seconds.
+static const float STREAM_PREROLL_LENGTH = 1.0f;
+/// Size of one background decode chunk in bytes.
+static const unsigned STREAM_DECODE_CHUNK = 16384;
+/// Initial encoded input buffer size of a streamed sound in bytes. Grown on demand.
+static const unsigned STREAM_INPUT_BUFFER_SIZE = 32768;
+
 OggVorbisSoundStream::OggVorbisSoundStream(const Sound* sound)
 {
     assert(sound && sound->IsCompressed());
@@ -40,11 +51,33 @@ OggVorbisSoundStream::OggVorbisSoundStream(const Sound* sound)
     // If the sound is looped, the stream will automatically rewind at end
     SetStopAtEnd(!sound->IsLooped());
 
-    // Initialize decoder
-    data_ = sound->GetData();
-    dataSize_ = sound->GetDataSize();
-    int error;
-    decoder_ = stb_vorbis_open_memory((unsigned char*)data_.get(), dataSize_, &error, nullptr);
+    // Initialize decoder. Streamed sounds decode straight from their source file with the pushdata API;
+    // others keep the whole compressed data resident
+    decoder_ = nullptr;
+    dataSize_ = 0;
+    if (sound->IsStreamed())
+    {
+        OpenStreamed(sound);
+    }
+    else
+    {
+        data_ = sound->GetData();
+        dataSize_ = sound->GetDataSize();
+        int error;
+        decoder_ = stb_vorbis_open_memory((unsigned char*)data_.get(), dataSize_, &error, nullptr);
+    }
+
+    // Register for background decoding, so that the mixing thread normally does not stall on vorbis decode
+    if (decoder_)
+    {
+        auto* audio = sound->GetContext()->GetSubsystem<Audio>();
+        if (audio)
+        {
+            ringSize_ = NextPowerOfTwo((unsigned)(frequency_ * GetSampleSize() * STREAM_PREROLL_LENGTH));
+            ringBuffer_.reset(new signed char[ringSize_]);
+            audio->AddBackgroundStream(this);
+        }
+    }
 }
 
 OggVorbisSoundStream::~OggVorbisSoundStream()
@@ -64,6 +97,21 @@ bool OggVorbisSoundStream::Seek(unsigned sample_number)
     if (!decoder_)
         return false;
 
+    MutexLock lock(decodeMutex_);
+
+    // Drop data already pre-rolled past the old position
+    if (ringBuffer_)
+    {
+        ringWrite_.store(ringRead_.load());
+        endOfStream_.store(false);
+    }
+
+    if (file_)
+    {
+        SeekStreamed(sample_number);
+        return true;
+    }
+
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     return stb_vorbis_seek(vorbis, sample_number) == 1;
@@ -74,6 +122,67 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     if (!decoder_)
         return 0;
 
+    // Without background decoding, decode synchronously as before
+    if (!ringBuffer_)
+    {
+        MutexLock lock(decodeMutex_);
+        return Decode(dest, numBytes);
+    }
+
+    // Consume pre-rolled data from the ring buffer without touching the decoder
+    unsigned outBytes = ReadRing(dest, numBytes);
+    if (outBytes == numBytes || endOfStream_.load())
+        return outBytes;
+
+    // Pre-roll underrun, typically right after playback start. Decode the rest synchronously; drain the ring
+    // once more under the lock in case the decoder thread managed to add data in the meanwhile
+    MutexLock lock(decodeMutex_);
+    outBytes += ReadRing(dest + outBytes, numBytes - outBytes);
+    if (outBytes < numBytes)
+        outBytes += Decode(dest + outBytes, numBytes - outBytes);
+
+    return outBytes;
+}
+
+void OggVorbisSoundStream::UpdateBackgroundBuffer()
+{
+    if (!decoder_ || !ringBuffer_ || endOfStream_.load())
+        return;
+
+    MutexLock lock(decodeMutex_);
+
+    // Keep the ring buffer topped up, decoding a chunk at a time
+    for (;;)
+    {
+        unsigned write = ringWrite_.load(std::memory_order_relaxed);
+        unsigned space = ringSize_ - (write - ringRead_.load(std::memory_order_acquire));
+        if (space < STREAM_DECODE_CHUNK)
+            return;
+
+        // Decode in up to two parts if the chunk wraps around the ring end
+        unsigned index = write & (ringSize_ - 1);
+        unsigned first = Min(STREAM_DECODE_CHUNK, ringSize_ - index);
+        unsigned got = Decode(ringBuffer_.get() + index, first);
+        if (got == first && first < STREAM_DECODE_CHUNK)
+            got += Decode(ringBuffer_.get(), STREAM_DECODE_CHUNK - first);
+
+        ringWrite_.store(write + got, std::memory_order_release);
+
+        if (got < STREAM_DECODE_CHUNK)
+        {
+            // A non-looping stream has been decoded to the end
+            if (stopAtEnd_)
+                endOfStream_.store(true);
+            return;
+        }
+    }
+}
+
+unsigned OggVorbisSoundStream::Decode(signed char* dest, unsigned numBytes)
+{
+    if (file_)
+        return DecodeStreamed(dest, numBytes);
+
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     unsigned channels = stereo_ ? 2 : 1;
@@ -93,4 +202,189 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     return outBytes;
 }
 
+unsigned OggVorbisSoundStream::ReadRing(signed char* dest, unsigned numBytes)
+{
+    unsigned read = ringRead_.load(std::memory_order_relaxed);
+    unsigned avail = ringWrite_.load(std::memory_order_acquire) - read;
+    unsigned copyBytes = Min(numBytes, avail);
+    if (!copyBytes)
+        return 0;
+
+    // Copy in up to two parts if the data wraps around the ring end
+    unsigned index = read & (ringSize_ - 1);
+    unsigned first = Min(copyBytes, ringSize_ - index);
+    memcpy(dest, ringBuffer_.get() + index, first);
+    if (copyBytes > first)
+        memcpy(dest + first, ringBuffer_.get(), copyBytes - first);
+
+    ringRead_.store(read + copyBytes, std::memory_order_release);
+    return copyBytes;
+}
+
+bool OggVorbisSoundStream::OpenStreamed(const Sound* sound)
+{
+    auto* cache = sound->GetContext()->GetSubsystem<ResourceCache>();
+    if (!cache)
+        return false;
+
+    file_ = cache->GetFile(sound->GetName());
+    if (!file_)
+        return false;
+
+    streamedSound_ = const_cast<Sound*>(sound);
+    inputBuffer_.resize(STREAM_INPUT_BUFFER_SIZE);
+
+    // Parse the stream headers, reading more encoded data until the decoder has enough
+    for (;;)
+    {
+        unsigned got = file_->Read(&inputBuffer_[inputFill_], inputBuffer_.size() - inputFill_);
+        inputFill_ += got;
+
+        int used = 0;
+        int error = 0;
+        stb_vorbis* vorbis = stb_vorbis_open_pushdata(inputBuffer_.data(), (int)inputFill_, &used, &error, nullptr);
+        if (vorbis)
+        {
+            inputPos_ = (unsigned)used;
+            decoder_ = vorbis;
+            return true;
+        }
+
+        if (error != VORBIS_need_more_data || !got)
+        {
+            file_.Reset();
+            streamedSound_.Reset();
+            return false;
+        }
+
+        if (inputFill_ == inputBuffer_.size())
+            inputBuffer_.resize(inputBuffer_.size() * 2);
+    }
+}
+
+unsigned OggVorbisSoundStream::DecodeStreamed(signed char* dest, unsigned numBytes)
+{
+    const unsigned channels = stereo_ ? 2 : 1;
+    auto* destShorts = (short*)dest;
+    unsigned remaining = numBytes >> 1u;
+    unsigned produced = 0;
+
+    while (remaining)
+    {
+        if (pendingPos_ >= pendingPcm_.size())
+        {
+            if (!DecodeStreamedFrame())
+            {
+                if (stopAtEnd_)
+                    break;
+
+                // Rewind a looping stream to the first audio page and retry once
+                SeekStreamed(0);
+                if (!DecodeStreamedFrame())
+                    break;
+            }
+        }
+
+        unsigned copySamples = Min(remaining, (unsigned)pendingPcm_.size() - pendingPos_);
+        memcpy(destShorts + produced, &pendingPcm_[pendingPos_], copySamples * sizeof(short));
+        pendingPos_ += copySamples;
+        produced += copySamples;
+        remaining -= copySamples;
+    }
+
+    // Keep whole frames: round down to the channel count in case of an odd split
+    produced -= produced % channels;
+    return produced << 1u;
+}
+
+bool OggVorbisSoundStream::DecodeStreamedFrame()
+{
+    auto* vorbis = static_cast<stb_vorbis*>(decoder_);
+    const unsigned channels = stereo_ ? 2 : 1;
+
+    for (;;)
+    {
+        int frameChannels = 0;
+        float** outputs = nullptr;
+        int numSamples = 0;
+        int used = stb_vorbis_decode_frame_pushdata(vorbis, inputBuffer_.data() + inputPos_,
+            (int)(inputFill_ - inputPos_), &frameChannels, &outputs, &numSamples);
+
+        if (used)
+        {
+            inputPos_ += (unsigned)used;
+            // Resynchronization after a seek may consume data without producing output
+            if (!numSamples)
+                continue;
+
+            // Drop samples decoded ahead of the exact seek target
+            if (skipSamples_ >= (unsigned)numSamples)
+            {
+                skipSamples_ -= (unsigned)numSamples;
+                continue;
+            }
+
+            pendingPcm_.resize((unsigned)numSamples * channels);
+            pendingPos_ = skipSamples_ * channels;
+            skipSamples_ = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (unsigned c = 0; c < channels; ++c)
+                {
+                    const float value = outputs[Min(c, (unsigned)frameChannels - 1)][i];
+                    pendingPcm_[(unsigned)i * channels + c] = (short)Clamp((int)(value * 32767.0f), -32768, 32767);
+                }
+            }
+            return true;
+        }
+
+        // The decoder needs more data: compact the input buffer and read the next piece of the file
+        if (inputPos_ > 0)
+        {
+            memmove(inputBuffer_.data(), inputBuffer_.data() + inputPos_, inputFill_ - inputPos_);
+            inputFill_ -= inputPos_;
+            inputPos_ = 0;
+        }
+        if (inputFill_ == inputBuffer_.size())
+            inputBuffer_.resize(inputBuffer_.size() * 2);
+
+        unsigned got = file_->Read(inputBuffer_.data() + inputFill_, inputBuffer_.size() - inputFill_);
+        if (!got)
+            return false;
+        inputFill_ += got;
+    }
+}
+
+void OggVorbisSoundStream::SeekStreamed(unsigned sampleNumber)
+{
+    const ea::vector<ea::pair<unsigned, unsigned> >& seekTable = streamedSound_->GetSeekTable();
+    if (seekTable.empty())
+        return;
+
+    // Binary search for the last page boundary at or before the target sample
+    unsigned index = 0;
+    unsigned left = 0;
+    unsigned right = seekTable.size();
+    while (left < right)
+    {
+        unsigned mid = (left + right) >> 1u;
+        if (seekTable[mid].second <= sampleNumber)
+        {
+            index = mid;
+            left = mid + 1;
+        }
+        else
+            right = mid;
+    }
+
+    file_->Seek(seekTable[index].first);
+    inputPos_ = 0;
+    inputFill_ = 0;
+    pendingPcm_.clear();
+    pendingPos_ = 0;
+    skipSamples_ = sampleNumber - seekTable[index].second;
+    stb_vorbis_flush_pushdata(static_cast<stb_vorbis*>(decoder_));
+}
+
 }
@@ -23,12 +23,18 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+#include <atomic>
 
 #include "../Audio/SoundStream.h"
+#include "../Container/Ptr.h"
+#include "../Core/Mutex.h"
 
 namespace Urho3D
 {
 
+class File;
 class Sound;
 
 /// Ogg Vorbis sound stream.
@@ -45,14 +51,57 @@ public:
 
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     unsigned GetData(signed char* dest, unsigned numBytes) override;
+    /// Decode more data into the pre-roll ring buffer. Called by the audio stream decoder thread.
+    void UpdateBackgroundBuffer() override;
 
 protected:
+    /// Decode data from the vorbis stream, rewinding at the end if looping. Return number of bytes produced. The decode mutex must be held.
+    unsigned Decode(signed char* dest, unsigned numBytes);
+    /// Consume pre-rolled data from the ring buffer. Return number of bytes read.
+    unsigned ReadRing(signed char* dest, unsigned numBytes);
+    /// Open the pushdata decoder of a streamed sound from its source file. Return true on success.
+    bool OpenStreamed(const Sound* sound);
+    /// Decode data with the pushdata decoder, reading the source file as needed. The decode mutex must be held.
+    unsigned DecodeStreamed(signed char* dest, unsigned numBytes);
+    /// Decode the next frame of the streamed sound into the pending sample buffer. Return false at end of stream.
+    bool DecodeStreamedFrame();
+    /// Seek the streamed decoder to a sample position: jump to the nearest preceding page boundary from the seek table and decode ahead to the exact sample.
+    void SeekStreamed(unsigned sampleNumber);
+
     /// Decoder state.
     void* decoder_;
     /// Compressed sound data.
     ea::shared_array<signed char> data_;
     /// Compressed sound data size in bytes.
     unsigned dataSize_;
+    /// Sound resource of a streamed sound. Keeps the seek table alive; null when decoding from resident memory.
+    SharedPtr<Sound> streamedSound_;
+    /// Source file of a streamed sound.
+    SharedPtr<File> file_;
+    /// Encoded input buffer of the pushdata decoder.
+    ea::vector<unsigned char> inputBuffer_;
+    /// Number of valid bytes in the input buffer.
+    unsigned inputFill_{};
+    /// Read position within the input buffer.
+    unsigned inputPos_{};
+    /// Decoded samples of the current frame, interleaved.
+    ea::vector<short> pendingPcm_;
+    /// Read position within the pending decoded samples.
+    unsigned pendingPos_{};
+    /// Samples per channel still to drop after seeking to a page boundary before the target sample.
+    unsigned skipSamples_{};
+    /// Pre-roll ring buffer for background-decoded data. Null when decoding synchronously in GetData().
+    ea::unique_ptr<signed char[]> ringBuffer_;
+    /// Ring buffer size in bytes. Always a power of two.
+    unsigned ringSize_{};
+    /// Total bytes consumed from the ring buffer. Written by the mixing thread.
+    std::atomic<unsigned> ringRead_{};
+    /// Total bytes produced into the ring buffer. Written by the decoder thread.
+    std::atomic<unsigned> ringWrite_{};
+    /// Set by the decoder thread when a stop-at-end stream has been fully decoded.
+    std::atomic<bool> endOfStream_{};
+    /// Mutex guarding the decoder state between the decoder thread, Seek() and synchronous decode on underrun.
+    Mutex decodeMutex_;
 };
 
 }
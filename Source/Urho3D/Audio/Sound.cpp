@@ -59,6 +59,12 @@ struct WavHeader
 };
 
 static const unsigned IP_SAFETY = 4;
+/// Interval between seek table entries of a streamed sound, as a fraction of a second of audio.
+static const unsigned SEEK_TABLE_INTERVAL_DIVIDER = 2;
+/// Minimum size of an Ogg page header in bytes.
+static const unsigned OGG_PAGE_HEADER_SIZE = 27;
+
+unsigned Sound::streamingThreshold_ = 1024 * 1024;
 
 Sound::Sound(Context* context) :
     ResourceWithMetadata(context),
@@ -81,6 +87,16 @@ void Sound::RegisterObject(Context* context)
     context->RegisterFactory<Sound>();
 }
 
+void Sound::SetStreamingThreshold(unsigned sizeBytes)
+{
+    streamingThreshold_ = sizeBytes;
+}
+
+unsigned Sound::GetStreamingThreshold()
+{
+    return streamingThreshold_;
+}
+
 bool Sound::BeginLoad(Deserializer& source)
 {
     URHO3D_PROFILE("LoadSound");
@@ -122,15 +138,83 @@ bool Sound::LoadOggVorbis(Deserializer& source)
     stereo_ = info.channels > 1;
     stb_vorbis_close(vorbis);
 
-    data_.swap(data);
-    dataSize_ = dataSize;
     sixteenBit_ = true;
     compressed_ = true;
+    dataSize_ = dataSize;
+
+    // Large files stream straight from their source file with a page-level seek table instead of staying
+    // resident in memory. Requires the resource name to be set, so that the decoder stream can reopen the file
+    if (streamingThreshold_ && dataSize >= streamingThreshold_ && !GetName().empty() &&
+        BuildSeekTable((const unsigned char*)data.get(), dataSize))
+    {
+        streamed_ = true;
+        SetMemoryUse((unsigned)(seekTable_.size() * sizeof(ea::pair<unsigned, unsigned>)));
+        return true;
+    }
 
+    data_.swap(data);
     SetMemoryUse(dataSize);
     return true;
 }
 
+bool Sound::BuildSeekTable(const unsigned char* data, unsigned dataSize)
+{
+    seekTable_.clear();
+
+    // One entry per a fraction of a second of audio keeps the table small while bounding the decode-ahead
+    // needed to reach an exact sample after seeking to a page boundary
+    const unsigned sampleInterval = Max(frequency_ / SEEK_TABLE_INTERVAL_DIVIDER, 1U);
+    unsigned long long lastGranule = 0;
+    unsigned lastRecordedSample = 0;
+    bool inAudio = false;
+
+    unsigned pos = 0;
+    while (pos + OGG_PAGE_HEADER_SIZE <= dataSize)
+    {
+        // Give up and fall back to resident data if page sync is lost
+        if (memcmp(data + pos, "OggS", 4) != 0)
+            return false;
+
+        const unsigned segments = data[pos + 26];
+        if (pos + OGG_PAGE_HEADER_SIZE + segments > dataSize)
+            break;
+
+        unsigned long long granule = 0;
+        for (unsigned i = 0; i < 8; ++i)
+            granule |= (unsigned long long)data[pos + 6 + i] << (i * 8);
+
+        unsigned pageSize = OGG_PAGE_HEADER_SIZE + segments;
+        for (unsigned i = 0; i < segments; ++i)
+            pageSize += data[pos + OGG_PAGE_HEADER_SIZE + i];
+
+        // Pages before the first audio page carry the stream headers. The first sample of each audio page is
+        // the granule position of the page before it; pages with granule -1 hold only a continued packet and
+        // are not usable as index points
+        if (!inAudio)
+        {
+            if (granule != 0)
+            {
+                inAudio = true;
+                seekTable_.push_back(ea::make_pair(pos, 0U));
+                lastGranule = granule;
+            }
+        }
+        else if (granule != ~0ull)
+        {
+            if (lastGranule - lastRecordedSample >= sampleInterval && lastGranule <= M_MAX_UNSIGNED)
+            {
+                seekTable_.push_back(ea::make_pair(pos, (unsigned)lastGranule));
+                lastRecordedSample = (unsigned)lastGranule;
+            }
+            lastGranule = granule;
+        }
+
+        pos += pageSize;
+    }
+
+    return !seekTable_.empty();
+}
+
 bool Sound::LoadWav(Deserializer& source)
 {
     WavHeader header{};
@@ -24,6 +24,8 @@
 
 
 #include <EASTL/shared_array.h>
+#include <EASTL/utility.h>
+#include <EASTL/vector.h>
 
 #include "../Resource/Resource.h"
 
@@ -44,6 +46,10 @@ public:
     ~Sound() override;
     /// Register object factory.
     static void RegisterObject(Context* context);
+    /// Set the compressed data size threshold in bytes above which Ogg Vorbis sounds stream from their source file instead of staying resident in memory. 0 disables streaming. Affects sounds loaded afterwards.
+    static void SetStreamingThreshold(unsigned sizeBytes);
+    /// Return the streaming data size threshold in bytes.
+    static unsigned GetStreamingThreshold();
 
     /// Load resource from stream. May be called from a worker thread. Return true if successful.
     bool BeginLoad(Deserializer& source) override;
@@ -107,12 +113,20 @@ public:
     /// Return whether is compressed.
     bool IsCompressed() const { return compressed_; }
 
+    /// Return whether the compressed data streams from the source file instead of staying resident in memory.
+    bool IsStreamed() const { return streamed_; }
+
+    /// Return the seek table of a streamed sound as (byte offset, sample number) pairs of Ogg page boundaries.
+    const ea::vector<ea::pair<unsigned, unsigned> >& GetSeekTable() const { return seekTable_; }
+
     /// Fix interpolation by copying data from loop start to loop end (looped), or adding silence (oneshot). Called internally, does not normally need to be called, unless the sound data is modified manually on the fly.
     void FixInterpolation();
 
 private:
     /// Load optional parameters from an XML file.
     void LoadParameters();
+    /// Build the seek table of a streamed sound by scanning the Ogg page headers. No decoding is involved. Return true on success.
+    bool BuildSeekTable(const unsigned char* data, unsigned dataSize);
 
     /// Sound data.
     ea::shared_array<signed char> data_;
@@ -132,8 +146,15 @@ private:
     bool stereo_;
     /// Compressed flag.
     bool compressed_;
+    /// Streamed-from-file flag.
+    bool streamed_{};
     /// Compressed sound length.
     float compressedLength_;
+    /// Seek table of a streamed sound: (byte offset, sample number) pairs of Ogg page boundaries.
+    ea::vector<ea::pair<unsigned, unsigned> > seekTable_;
+
+    /// Compressed data size threshold in bytes for streaming from the source file. 0 disables streaming.
+    static unsigned streamingThreshold_;
 };
 
 }
@@ -33,6 +33,10 @@
 #include "../Scene/Node.h"
 #include "../Scene/ReplicationState.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -94,6 +98,85 @@ namespace Urho3D
 
 #define GET_IP_SAMPLE_RIGHT() (((((int)pos[3] - (int)pos[1]) * fractPos) / 65536) + (int)pos[1])
 
+#ifdef URHO3D_SSE
+
+/// Multiply packed 32-bit integers, keeping the low 32 bits of each product. SSE2 lacks _mm_mullo_epi32.
+static inline __m128i MulLoEpi32(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/// Divide packed 32-bit integers by a power of two with truncation toward zero, matching C signed division.
+static inline __m128i DivTruncEpi32(__m128i x, int shift, int mask)
+{
+    return _mm_srai_epi32(_mm_add_epi32(x, _mm_and_si128(_mm_srai_epi32(x, 31), _mm_set1_epi32(mask))), shift);
+}
+
+/// Mix a block of 16-bit mono samples to a stereo buffer, four output frames at a time. Mixes only frames whose
+/// source reads stay within the sound data; the caller steps over loop and end boundaries with the scalar code.
+/// Return the number of frames mixed, advancing the position accordingly.
+static unsigned MixMonoToStereoBlock(short*& pos, const short* end, int& fractPos, int intAdd, int fractAdd,
+    int leftVol, int rightVol, int*& dest, unsigned samples, bool interpolation)
+{
+    long long step = ((long long)intAdd << 16) + fractAdd;
+    long long avail = end - pos;
+    if (step <= 0 || avail <= 0)
+        return 0;
+
+    // The fixed-point sample position of frame n is fractPos + n * step; limit the frame count so that the last
+    // read sample index stays below avail. Interpolation reading one sample ahead at the last valid index is
+    // allowed, as the scalar code relies on the same padding at the end of the sound data
+    auto numFrames = (unsigned long long)(((avail << 16) - fractPos + step - 1) / step);
+    numFrames = Min(numFrames, (unsigned long long)samples) & ~3ull;
+    if (!numFrames)
+        return 0;
+
+    const __m128i vLeft = _mm_set1_epi32(leftVol);
+    const __m128i vRight = _mm_set1_epi32(rightVol);
+    long long acc = fractPos;
+
+    for (unsigned long long i = 0; i < numFrames; i += 4)
+    {
+        long long a0 = acc;
+        long long a1 = acc + step;
+        long long a2 = acc + 2 * step;
+        long long a3 = acc + 3 * step;
+        const short* p0 = pos + (a0 >> 16);
+        const short* p1 = pos + (a1 >> 16);
+        const short* p2 = pos + (a2 >> 16);
+        const short* p3 = pos + (a3 >> 16);
+
+        __m128i sample = _mm_set_epi32(p3[0], p2[0], p1[0], p0[0]);
+        if (interpolation)
+        {
+            __m128i next = _mm_set_epi32(p3[1], p2[1], p1[1], p0[1]);
+            __m128i fract = _mm_set_epi32((int)(a3 & 65535), (int)(a2 & 65535), (int)(a1 & 65535), (int)(a0 & 65535));
+            __m128i delta = MulLoEpi32(_mm_sub_epi32(next, sample), fract);
+            sample = _mm_add_epi32(sample, DivTruncEpi32(delta, 16, 65535));
+        }
+
+        __m128i left = DivTruncEpi32(MulLoEpi32(sample, vLeft), 8, 255);
+        __m128i right = DivTruncEpi32(MulLoEpi32(sample, vRight), 8, 255);
+
+        // Interleave to frame order and accumulate
+        __m128i lo = _mm_unpacklo_epi32(left, right);
+        __m128i hi = _mm_unpackhi_epi32(left, right);
+        _mm_storeu_si128((__m128i*)dest, _mm_add_epi32(_mm_loadu_si128((const __m128i*)dest), lo));
+        _mm_storeu_si128((__m128i*)(dest + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(dest + 4)), hi));
+        dest += 8;
+
+        acc += 4 * step;
+    }
+
+    pos += (int)(acc >> 16);
+    fractPos = (int)(acc & 65535);
+    return (unsigned)numFrames;
+}
+
+#endif
+
 static const int STREAM_SAFETY_SAMPLES = 4;
 
 extern const char* AUDIO_CATEGORY;
@@ -698,24 +781,43 @@ void SoundSource::MixMonoToStereo(Sound* sound, int dest[], unsigned samples, in
 
         if (sound->IsLooped())
         {
-            while (samples--)
+            while (samples)
             {
+#ifdef URHO3D_SSE
+                samples -= MixMonoToStereoBlock(pos, end, fractPos, intAdd, fractAdd, leftVol, rightVol, dest, samples, false);
+                if (!samples)
+                    break;
+                while (pos >= end)
+                    pos -= (end - repeat);
+#endif
                 *dest = *dest + (*pos * leftVol) / 256;
                 ++dest;
                 *dest = *dest + (*pos * rightVol) / 256;
                 ++dest;
+                --samples;
                 INC_POS_LOOPED();
             }
             position_ = (signed char*)pos;
         }
         else
         {
-            while (samples--)
+            while (samples)
             {
+#ifdef URHO3D_SSE
+                samples -= MixMonoToStereoBlock(pos, end, fractPos, intAdd, fractAdd, leftVol, rightVol, dest, samples, false);
+                if (!samples)
+                    break;
+                if (pos >= end)
+                {
+                    pos = 0;
+                    break;
+                }
+#endif
                 *dest = *dest + (*pos * leftVol) / 256;
                 ++dest;
                 *dest = *dest + (*pos * rightVol) / 256;
                 ++dest;
+                --samples;
                 INC_POS_ONESHOT();
             }
             position_ = (signed char*)pos;
@@ -853,26 +955,45 @@ void SoundSource::MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples,
 
         if (sound->IsLooped())
         {
-            while (samples--)
+            while (samples)
             {
+#ifdef URHO3D_SSE
+                samples -= MixMonoToStereoBlock(pos, end, fractPos, intAdd, fractAdd, leftVol, rightVol, dest, samples, true);
+                if (!samples)
+                    break;
+                while (pos >= end)
+                    pos -= (end - repeat);
+#endif
                 int s = GET_IP_SAMPLE();
                 *dest = *dest + (s * leftVol) / 256;
                 ++dest;
                 *dest = *dest + (s * rightVol) / 256;
                 ++dest;
+                --samples;
                 INC_POS_LOOPED();
             }
             position_ = (signed char*)pos;
         }
         else
         {
-            while (samples--)
+            while (samples)
             {
+#ifdef URHO3D_SSE
+                samples -= MixMonoToStereoBlock(pos, end, fractPos, intAdd, fractAdd, leftVol, rightVol, dest, samples, true);
+                if (!samples)
+                    break;
+                if (pos >= end)
+                {
+                    pos = 0;
+                    break;
+                }
+#endif
                 int s = GET_IP_SAMPLE();
                 *dest = *dest + (s * leftVol) / 256;
                 ++dest;
                 *dest = *dest + (s * rightVol) / 256;
                 ++dest;
+                --samples;
                 INC_POS_ONESHOT();
             }
             position_ = (signed char*)pos;
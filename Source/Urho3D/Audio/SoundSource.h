@@ -86,6 +86,9 @@ public:
     /// Return sound type, determines the master gain group.
     ea::string GetSoundType() const { return soundType_; }
 
+    /// Return sound type hash, used for master gain and mixing bus lookups.
+    StringHash GetSoundTypeHash() const { return soundTypeHash_; }
+
     /// Return playback time position.
     float GetTimePosition() const { return timePosition_; }
 
@@ -38,6 +38,9 @@ static const float DEFAULT_FARDISTANCE = 100.0f;
 static const float DEFAULT_ROLLOFF = 2.0f;
 static const float DEFAULT_ANGLE = 360.0f;
 static const float MIN_ROLLOFF = 0.1f;
+static const float DEFAULT_OCCLUSION_ATTENUATION = 0.5f;
+// How fast the occlusion factor fades toward the latest raycast result, per second
+static const float OCCLUSION_FADE_SPEED = 2.0f;
 static const Color INNER_COLOR(1.0f, 0.5f, 1.0f);
 static const Color OUTER_COLOR(1.0f, 0.0f, 1.0f);
 
@@ -49,7 +52,13 @@ SoundSource3D::SoundSource3D(Context* context) :
     farDistance_(DEFAULT_FARDISTANCE),
     innerAngle_(DEFAULT_ANGLE),
     outerAngle_(DEFAULT_ANGLE),
-    rolloffFactor_(DEFAULT_ROLLOFF)
+    rolloffFactor_(DEFAULT_ROLLOFF),
+    occlusionEnabled_(false),
+    occlusionAttenuation_(DEFAULT_OCCLUSION_ATTENUATION),
+    occlusionFactor_(1.0f),
+    occlusionTarget_(1.0f),
+    occlusionPriority_(0.0f),
+    spatialUpdated_(false)
 {
     // Start from zero volume until attenuation properly calculated
     attenuation_ = 0.0f;
@@ -68,6 +77,8 @@ void SoundSource3D::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Inner Angle", float, innerAngle_, DEFAULT_ANGLE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Outer Angle", float, outerAngle_, DEFAULT_ANGLE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Rolloff Factor", float, rolloffFactor_, DEFAULT_ROLLOFF, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Occlusion Enabled", bool, occlusionEnabled_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Occlusion Attenuation", float, occlusionAttenuation_, DEFAULT_OCCLUSION_ATTENUATION, AM_DEFAULT);
 }
 
 void SoundSource3D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -97,7 +108,12 @@ void SoundSource3D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 
 void SoundSource3D::Update(float timeStep)
 {
-    CalculateAttenuation();
+    // The batched spatial update pass in Audio normally computes attenuation before the sources update;
+    // fall back to the per-source calculation when it has not run, e.g. when there is no listener
+    if (!spatialUpdated_)
+        CalculateAttenuation();
+    spatialUpdated_ = false;
+
     SoundSource::Update(timeStep);
 }
 
@@ -146,6 +162,23 @@ void SoundSource3D::SetRolloffFactor(float factor)
     MarkNetworkUpdate();
 }
 
+void SoundSource3D::SetOcclusionEnabled(bool enable)
+{
+    occlusionEnabled_ = enable;
+    if (!enable)
+    {
+        occlusionFactor_ = 1.0f;
+        occlusionTarget_ = 1.0f;
+    }
+    MarkNetworkUpdate();
+}
+
+void SoundSource3D::SetOcclusionAttenuation(float attenuation)
+{
+    occlusionAttenuation_ = Clamp(attenuation, 0.0f, 1.0f);
+    MarkNetworkUpdate();
+}
+
 void SoundSource3D::CalculateAttenuation()
 {
     if (!audio_)
@@ -175,27 +208,10 @@ void SoundSource3D::CalculateAttenuation()
 
             // Angle attenuation
             if (innerAngle_ < DEFAULT_ANGLE && outerAngle_ > 0.0f)
-            {
-                Vector3 listenerRelativePos
-                    (node_->GetWorldRotation().Inverse() * (listenerNode->GetWorldPosition() - node_->GetWorldPosition()));
-                float listenerDot = Vector3::FORWARD.DotProduct(listenerRelativePos.Normalized());
-                float listenerAngle = acosf(listenerDot) * M_RADTODEG * 2.0f;
-                float angleInterval = Max(outerAngle_ - innerAngle_, 0.0f);
-                float angleAttenuation = 1.0f;
-
-                if (angleInterval > 0.0f)
-                {
-                    if (listenerAngle > innerAngle_)
-                    {
-                        angleAttenuation = powf(1.0f - Clamp(listenerAngle - innerAngle_, 0.0f, angleInterval) / angleInterval,
-                            rolloffFactor_);
-                    }
-                }
-                else
-                    angleAttenuation = listenerAngle <= innerAngle_ ? 1.0f : 0.0f;
-
-                attenuation_ *= angleAttenuation;
-            }
+                attenuation_ *= CalculateAngleAttenuation(listenerNode);
+
+            if (occlusionEnabled_)
+                attenuation_ *= occlusionFactor_;
         }
         else
             attenuation_ = 0.0f;
@@ -204,4 +220,57 @@ void SoundSource3D::CalculateAttenuation()
         attenuation_ = 0.0f;
 }
 
+void SoundSource3D::ApplyAttenuation(float distance, float panning, float timeStep)
+{
+    // Distance attenuation
+    float interval = farDistance_ - nearDistance_;
+    if (interval > 0.0f)
+        attenuation_ = powf(1.0f - Clamp(distance - nearDistance_, 0.0f, interval) / interval, rolloffFactor_);
+    else
+        attenuation_ = distance <= nearDistance_ ? 1.0f : 0.0f;
+
+    panning_ = panning;
+
+    // Angle attenuation
+    if (innerAngle_ < DEFAULT_ANGLE && outerAngle_ > 0.0f && node_ && audio_)
+    {
+        SoundListener* listener = audio_->GetListener();
+        if (listener && listener->GetNode())
+            attenuation_ *= CalculateAngleAttenuation(listener->GetNode());
+    }
+
+    // Occlusion: fade toward the latest raycast result to avoid pops
+    if (occlusionEnabled_)
+    {
+        float maxStep = OCCLUSION_FADE_SPEED * timeStep;
+        occlusionFactor_ += Clamp(occlusionTarget_ - occlusionFactor_, -maxStep, maxStep);
+        attenuation_ *= occlusionFactor_;
+    }
+
+    spatialUpdated_ = true;
+}
+
+float SoundSource3D::CalculateAngleAttenuation(Node* listenerNode)
+{
+    Vector3 listenerRelativePos
+        (node_->GetWorldRotation().Inverse() * (listenerNode->GetWorldPosition() - node_->GetWorldPosition()));
+    float listenerDot = Vector3::FORWARD.DotProduct(listenerRelativePos.Normalized());
+    float listenerAngle = acosf(listenerDot) * M_RADTODEG * 2.0f;
+    float angleInterval = Max(outerAngle_ - innerAngle_, 0.0f);
+    float angleAttenuation = 1.0f;
+
+    if (angleInterval > 0.0f)
+    {
+        if (listenerAngle > innerAngle_)
+        {
+            angleAttenuation = powf(1.0f - Clamp(listenerAngle - innerAngle_, 0.0f, angleInterval) / angleInterval,
+                rolloffFactor_);
+        }
+    }
+    else
+        angleAttenuation = listenerAngle <= innerAngle_ ? 1.0f : 0.0f;
+
+    return angleAttenuation;
+}
+
 }
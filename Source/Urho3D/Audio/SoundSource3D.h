@@ -34,6 +34,8 @@ class URHO3D_API SoundSource3D : public SoundSource
 {
     URHO3D_OBJECT(SoundSource3D, SoundSource);
 
+    friend class Audio;
+
 public:
     /// Construct.
     explicit SoundSource3D(Context* context);
@@ -59,8 +61,14 @@ public:
     void SetOuterAngle(float angle);
     /// Set rolloff power factor, defines attenuation function shape.
     void SetRolloffFactor(float factor);
+    /// Set whether raycast occlusion tests against physics geometry are performed for this source. Tests are amortized over several frames by the batched spatial update in Audio.
+    void SetOcclusionEnabled(bool enable);
+    /// Set the gain multiplier applied when the source is occluded from the listener. Default 0.5.
+    void SetOcclusionAttenuation(float attenuation);
     /// Calculate attenuation and panning based on current position and listener position.
     void CalculateAttenuation();
+    /// Apply attenuation and panning from precomputed listener-relative distance and direction. Called by Audio from the batched spatial update.
+    void ApplyAttenuation(float distance, float panning, float timeStep);
 
     /// Return near distance.
     float GetNearDistance() const { return nearDistance_; }
@@ -77,7 +85,19 @@ public:
     /// Return rolloff power factor.
     float RollAngleoffFactor() const { return rolloffFactor_; }
 
+    /// Return whether occlusion tests are enabled.
+    bool IsOcclusionEnabled() const { return occlusionEnabled_; }
+
+    /// Return the gain multiplier applied when occluded.
+    float GetOcclusionAttenuation() const { return occlusionAttenuation_; }
+
+    /// Return the current smoothed occlusion factor (1 = unoccluded.)
+    float GetOcclusionFactor() const { return occlusionFactor_; }
+
 protected:
+    /// Calculate the directional attenuation toward the listener node.
+    float CalculateAngleAttenuation(Node* listenerNode);
+
     /// Near distance.
     float nearDistance_;
     /// Far distance.
@@ -88,6 +108,18 @@ protected:
     float outerAngle_;
     /// Rolloff power factor.
     float rolloffFactor_;
+    /// Occlusion tests enabled flag.
+    bool occlusionEnabled_;
+    /// Gain multiplier applied when occluded.
+    float occlusionAttenuation_;
+    /// Current smoothed occlusion factor.
+    float occlusionFactor_;
+    /// Occlusion factor from the latest raycast, faded toward to avoid pops. Written by Audio.
+    float occlusionTarget_;
+    /// Accumulated priority for the next occlusion test. Managed by Audio.
+    float occlusionPriority_;
+    /// Set when the batched spatial update has already computed attenuation this frame.
+    bool spatialUpdated_;
 };
 
 }
@@ -41,6 +41,8 @@ public:
 
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     virtual unsigned GetData(signed char* dest, unsigned numBytes) = 0;
+    /// Decode more data into the background pre-roll buffer, if the stream uses one. Called by the audio stream decoder thread. Default no-op for streams that produce data directly in GetData().
+    virtual void UpdateBackgroundBuffer() {}
 
     /// Set sound data format.
     void SetFormat(unsigned frequency, bool sixteenBit, bool stereo);
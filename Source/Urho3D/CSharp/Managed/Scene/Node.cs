@@ -20,10 +20,29 @@
 // THE SOFTWARE.
 //
 
+using System;
+using System.Runtime.InteropServices;
+
 namespace Urho3DNet
 {
     public partial class Node
     {
+        [DllImport("Urho3D", EntryPoint = "Urho3D_Node_GetChildrenPtrs")]
+        private static extern uint Urho3D_Node_GetChildrenPtrs(HandleRef node, [MarshalAs(UnmanagedType.U1)] bool recursive, IntPtr[] dest, uint capacity);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_Node_GetComponentsPtrs")]
+        private static extern uint Urho3D_Node_GetComponentsPtrs(HandleRef node, IntPtr[] dest, uint capacity);
+
+        // Scratch buffer shared by the batch accessors below so they do not allocate after warm-up.
+        [ThreadStatic] private static IntPtr[] _pointerScratch;
+
+        private static IntPtr[] GetPointerScratch(int capacity)
+        {
+            var scratch = _pointerScratch;
+            if (scratch == null || scratch.Length < capacity)
+                _pointerScratch = scratch = new IntPtr[Math.Max(capacity, 64)];
+            return scratch;
+        }
+
         public T CreateComponent<T>(CreateMode mode = CreateMode.Replicated, uint id = 0) where T: Component
         {
             return (T)CreateComponent(typeof(T).Name, mode, id);
@@ -55,5 +74,42 @@ namespace Urho3DNet
             GetComponents(componentList, typeof(T).Name, recursive);
             return componentList;
         }
+
+        /// <summary>
+        /// Fill <paramref name="dest"/> with child nodes in a single native call. Wrappers come from the instance
+        /// cache, so iterating children every frame through a reused array does not allocate. Returns the total
+        /// number of children; when it exceeds the array length only the first <c>dest.Length</c> are written.
+        /// </summary>
+        public int GetChildren(Node[] dest, bool recursive = false)
+        {
+            if (dest == null)
+                throw new ArgumentNullException(nameof(dest));
+            IntPtr[] ptrs = GetPointerScratch(dest.Length);
+            uint total = Urho3D_Node_GetChildrenPtrs(swigCPtr, recursive, ptrs, (uint)dest.Length);
+            int count = (int)Math.Min(total, (uint)dest.Length);
+            for (int i = 0; i < count; ++i)
+                dest[i] = wrap(ptrs[i], false);
+            for (int i = count; i < dest.Length; ++i)
+                dest[i] = null;
+            return (int)total;
+        }
+
+        /// <summary>
+        /// Fill <paramref name="dest"/> with all components in a single native call. Same contract as
+        /// <see cref="GetChildren(Node[],bool)"/>.
+        /// </summary>
+        public int GetComponents(Component[] dest)
+        {
+            if (dest == null)
+                throw new ArgumentNullException(nameof(dest));
+            IntPtr[] ptrs = GetPointerScratch(dest.Length);
+            uint total = Urho3D_Node_GetComponentsPtrs(swigCPtr, ptrs, (uint)dest.Length);
+            int count = (int)Math.Min(total, (uint)dest.Length);
+            for (int i = 0; i < count; ++i)
+                dest[i] = Component.wrap(ptrs[i], false);
+            for (int i = count; i < dest.Length; ++i)
+                dest[i] = null;
+            return (int)total;
+        }
     }
 }
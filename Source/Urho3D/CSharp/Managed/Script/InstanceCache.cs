@@ -38,11 +38,13 @@ namespace Urho3DNet
         /// </summary>
         private const int CacheIterationInterval = 30000;
 
-        internal struct CacheEntry
+        internal class CacheEntry
         {
             // Strong reference is kept for some time after last object access and then set to null. This prevents
             // garbage-collection of often used objects whose reference is not kept around. When weak reference expires
-            // entry is removed from cache.
+            // entry is removed from cache. This must be a class: the dictionary hands out copies of value types, so a
+            // struct entry would lose the last access refresh and often-used wrappers would still expire and be
+            // re-created, churning the GC.
 
             private T _target;
             private readonly WeakReference<T> _targetWeak;
@@ -53,8 +55,8 @@ namespace Urho3DNet
                 get
                 {
                     var result = _target;
-                    if (result == null)
-                        _targetWeak.TryGetTarget(out result);
+                    if (result == null && _targetWeak.TryGetTarget(out result))
+                        _target = result;   // Re-pin the object while it is being accessed again.
 
                     if (result == null)
                         return null;
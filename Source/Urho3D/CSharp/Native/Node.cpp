@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Scene/Component.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Script/Script.h>
+
+namespace Urho3D
+{
+
+// Batch accessors for hot scene collections. The managed side pins one pointer array and crosses the interop
+// boundary once per call instead of once per element, then rewraps the pointers through its instance cache.
+
+extern "C"
+{
+
+URHO3D_EXPORT_API unsigned SWIGSTDCALL Urho3D_Node_GetChildrenPtrs(Node* node, bool recursive, Node** dest, unsigned capacity)
+{
+    if (!node || !dest)
+        return 0;
+
+    if (!recursive)
+    {
+        const ea::vector<SharedPtr<Node> >& children = node->GetChildren();
+        const unsigned count = Min((unsigned)children.size(), capacity);
+        for (unsigned i = 0; i < count; ++i)
+            dest[i] = children[i];
+        return (unsigned)children.size();
+    }
+
+    ea::vector<Node*> children;
+    node->GetChildren(children, true);
+    const unsigned count = Min((unsigned)children.size(), capacity);
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = children[i];
+    return (unsigned)children.size();
+}
+
+URHO3D_EXPORT_API unsigned SWIGSTDCALL Urho3D_Node_GetComponentsPtrs(Node* node, Component** dest, unsigned capacity)
+{
+    if (!node || !dest)
+        return 0;
+
+    const ea::vector<SharedPtr<Component> >& components = node->GetComponents();
+    const unsigned count = Min((unsigned)components.size(), capacity);
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = components[i];
+    return (unsigned)components.size();
+}
+
+}   // extern "C"
+
+}   // namespace Urho3D
@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/OctreeQuery.h>
+#include <Urho3D/Script/Script.h>
+
+#include <EASTL/shared_ptr.h>
+#include <EASTL/unique_ptr.h>
+
+namespace Urho3D
+{
+
+// Plain data mirrors of ray query input and output, laid out so the managed side can pin one array of queries and
+// one array of results and cross the interop boundary once per batch instead of once per raycast.
+
+/// One raycast query submitted from the managed side.
+struct BatchRaycastQuery
+{
+    /// Ray origin.
+    Vector3 origin_;
+    /// Ray direction. Does not need to be normalized.
+    Vector3 direction_;
+    /// Maximum ray distance.
+    float maxDistance_;
+    /// Raycast detail level (RayQueryLevel).
+    int level_;
+    /// Drawable flags to include.
+    unsigned drawableFlags_;
+    /// Drawable layers to include.
+    unsigned viewMask_;
+};
+
+/// One raycast hit returned to the managed side.
+struct BatchRaycastResult
+{
+    /// Hit position in world space.
+    Vector3 position_;
+    /// Hit normal in world space.
+    Vector3 normal_;
+    /// Hit texture position.
+    Vector2 textureUV_;
+    /// Distance from ray origin.
+    float distance_;
+    /// Drawable, or null for no hit.
+    Drawable* drawable_;
+    /// Scene node.
+    Node* node_;
+    /// Drawable-specific subobject index.
+    unsigned subObject_;
+};
+
+typedef void(SWIGSTDCALL* BatchRaycastCallback)(BatchRaycastResult* results, unsigned* resultCounts, unsigned numQueries);
+
+static RayOctreeQuery* CreateBatchQuery(const BatchRaycastQuery& query)
+{
+    return new RayOctreeQuery(Ray(query.origin_, query.direction_), (RayQueryLevel)query.level_, query.maxDistance_,
+        DrawableFlags(static_cast<DrawableFlags::Integer>(query.drawableFlags_)), query.viewMask_);
+}
+
+static unsigned CopyBatchResults(const ea::vector<RayQueryResult>& results, BatchRaycastResult* dest, unsigned maxResults)
+{
+    const unsigned count = Min((unsigned)results.size(), maxResults);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const RayQueryResult& result = results[i];
+        dest[i].position_ = result.position_;
+        dest[i].normal_ = result.normal_;
+        dest[i].textureUV_ = result.textureUV_;
+        dest[i].distance_ = result.distance_;
+        dest[i].drawable_ = result.drawable_;
+        dest[i].node_ = result.node_;
+        dest[i].subObject_ = result.subObject_;
+    }
+    return count;
+}
+
+extern "C"
+{
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Octree_RaycastBatch(Octree* octree, const BatchRaycastQuery* queries,
+    unsigned numQueries, BatchRaycastResult* results, unsigned maxResultsPerQuery, unsigned* resultCounts)
+{
+    if (!octree || !queries || !numQueries || !results || !maxResultsPerQuery || !resultCounts)
+        return;
+
+    ea::vector<ea::unique_ptr<RayOctreeQuery> > nativeQueries;
+    ea::vector<RayOctreeQuery*> queryPtrs;
+    nativeQueries.reserve(numQueries);
+    queryPtrs.reserve(numQueries);
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        nativeQueries.push_back(ea::unique_ptr<RayOctreeQuery>(CreateBatchQuery(queries[i])));
+        queryPtrs.push_back(nativeQueries.back().get());
+    }
+
+    octree->RaycastBatch(&queryPtrs[0], numQueries);
+
+    for (unsigned i = 0; i < numQueries; ++i)
+        resultCounts[i] = CopyBatchResults(queryPtrs[i]->result_, results + (size_t)i * maxResultsPerQuery, maxResultsPerQuery);
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Octree_RaycastSingleBatch(Octree* octree, const BatchRaycastQuery* queries,
+    unsigned numQueries, BatchRaycastResult* results)
+{
+    if (!octree || !queries || !numQueries || !results)
+        return;
+
+    ea::vector<unsigned> resultCounts(numQueries);
+    Urho3D_Octree_RaycastBatch(octree, queries, numQueries, results, 1, &resultCounts[0]);
+
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        if (!resultCounts[i])
+            results[i].drawable_ = nullptr;
+    }
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Octree_RaycastBatchAsync(Octree* octree, const BatchRaycastQuery* queries,
+    unsigned numQueries, unsigned maxResultsPerQuery, BatchRaycastCallback callback, void* callbackHandle)
+{
+    GCHandleRef callbackHandleHolder(callbackHandle);
+    if (!octree || !queries || !numQueries || !maxResultsPerQuery || !callback)
+        return;
+
+    // Results are accumulated into one buffer shared by the whole batch and the managed callback is invoked once,
+    // when the last queued raycast has completed. Async raycast callbacks always run on the main thread, so no
+    // synchronization is needed. The GC handle keeps the managed delegate alive until the batch state is destroyed.
+    struct BatchState
+    {
+        ea::vector<BatchRaycastResult> results_;
+        ea::vector<unsigned> resultCounts_;
+        unsigned remaining_;
+        unsigned maxResultsPerQuery_;
+        BatchRaycastCallback callback_;
+        GCHandleRef callbackHandle_;
+    };
+
+    auto state = ea::make_shared<BatchState>();
+    state->results_.resize((size_t)numQueries * maxResultsPerQuery);
+    state->resultCounts_.resize(numQueries);
+    state->remaining_ = numQueries;
+    state->maxResultsPerQuery_ = maxResultsPerQuery;
+    state->callback_ = callback;
+    state->callbackHandle_ = ea::move(callbackHandleHolder);
+
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        const BatchRaycastQuery& query = queries[i];
+        octree->RaycastAsync(Ray(query.origin_, query.direction_),
+            [state, i](const ea::vector<RayQueryResult>& results)
+            {
+                state->resultCounts_[i] = CopyBatchResults(results,
+                    &state->results_[(size_t)i * state->maxResultsPerQuery_], state->maxResultsPerQuery_);
+                if (!--state->remaining_)
+                    state->callback_(&state->results_[0], &state->resultCounts_[0], state->resultCounts_.size());
+            },
+            (RayQueryLevel)query.level_, query.maxDistance_,
+            DrawableFlags(static_cast<DrawableFlags::Integer>(query.drawableFlags_)), query.viewMask_);
+    }
+}
+
+}   // extern "C"
+
+}   // namespace Urho3D
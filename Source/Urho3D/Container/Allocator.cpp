@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Container/Allocator.h"
+#include "../Container/MemoryTracker.h"
 #include "../Core/Profiler.h"
 
 #if URHO3D_STATIC
@@ -49,7 +50,9 @@ AllocatorBlock* AllocatorReserveBlock(AllocatorBlock* allocator, unsigned nodeSi
     if (!capacity)
         capacity = 1;
 
-    auto* blockPtr = new unsigned char[sizeof(AllocatorBlock) + capacity * (sizeof(AllocatorNode) + nodeSize)];
+    const size_t blockSize = sizeof(AllocatorBlock) + capacity * (sizeof(AllocatorNode) + nodeSize);
+    auto* blockPtr = new unsigned char[blockSize];
+    MemoryTracker::TrackAlloc(blockPtr, blockSize);
     auto* newBlock = reinterpret_cast<AllocatorBlock*>(blockPtr);
     newBlock->nodeSize_ = nodeSize;
     newBlock->capacity_ = capacity;
@@ -100,6 +103,7 @@ void AllocatorUninitialize(AllocatorBlock* allocator)
     while (allocator)
     {
         AllocatorBlock* next = allocator->next_;
+        MemoryTracker::TrackFree(allocator);
         delete[] reinterpret_cast<unsigned char*>(allocator);
         allocator = next;
     }
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include <cassert>
+
+#include "../Container/FrameAllocator.h"
+#include "../Container/MemoryTracker.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+FrameArena::FrameArena(unsigned capacity) :
+    buffer_(new unsigned char[capacity]),
+    capacity_(capacity)
+{
+    URHO3D_MEMORY_TAG("FrameArena");
+    MemoryTracker::TrackAlloc(buffer_, capacity_);
+}
+
+FrameArena::~FrameArena()
+{
+    Reset();
+    MemoryTracker::TrackFree(buffer_);
+    delete[] buffer_;
+}
+
+void* FrameArena::Allocate(unsigned size, unsigned alignment)
+{
+    assert(alignment <= DEFAULT_ALIGNMENT);
+
+    // Round up so every cursor position stays aligned
+    size = (size + DEFAULT_ALIGNMENT - 1) & ~(DEFAULT_ALIGNMENT - 1);
+
+    const unsigned offset = cursor_.fetch_add(size, std::memory_order_relaxed);
+    if (offset + size <= capacity_)
+        return buffer_ + offset;
+
+    // Buffer exhausted: fall back to the heap until the next reset grows the buffer
+    auto* allocation = new unsigned char[size];
+    MemoryTracker::TrackAlloc(allocation, size);
+
+    MutexLock lock(overflowMutex_);
+    overflowAllocations_.push_back(allocation);
+    overflowSize_ += size;
+    return allocation;
+}
+
+void FrameArena::Reset()
+{
+    for (unsigned char* allocation : overflowAllocations_)
+    {
+        MemoryTracker::TrackFree(allocation);
+        delete[] allocation;
+    }
+    overflowAllocations_.clear();
+    overflowSize_ = 0;
+
+    // Grow to the high-water mark so the next frame stays on the fast path
+    const unsigned used = cursor_.load(std::memory_order_relaxed);
+    if (used > capacity_)
+    {
+        MemoryTracker::TrackFree(buffer_);
+        delete[] buffer_;
+        capacity_ = NextPowerOfTwo(used);
+        URHO3D_MEMORY_TAG("FrameArena");
+        buffer_ = new unsigned char[capacity_];
+        MemoryTracker::TrackAlloc(buffer_, capacity_);
+    }
+
+    cursor_.store(0, std::memory_order_relaxed);
+}
+
+void* FrameAllocator::allocate(size_t n, int flags)
+{
+    return arena_ ? arena_->Allocate((unsigned)n) : new unsigned char[n];
+}
+
+void* FrameAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags)
+{
+    return arena_ ? arena_->Allocate((unsigned)n, (unsigned)alignment) : new unsigned char[n];
+}
+
+void FrameAllocator::deallocate(void* p, size_t n)
+{
+    // Arena allocations are released in bulk at FrameArena::Reset(); only the heap fallback frees
+    if (!arena_)
+        delete[] static_cast<unsigned char*>(p);
+}
+
+}
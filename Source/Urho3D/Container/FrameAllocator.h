@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <EASTL/vector.h>
+#include <atomic>
+
+#include "../Core/Mutex.h"
+#include "../Math/MathDefs.h"
+
+namespace Urho3D
+{
+
+/// Frame-scoped linear arena. Allocation is a single atomic bump of the cursor, deallocation
+/// is a no-op, and the whole arena is reset once per frame at E_ENDFRAME. Allocations that do
+/// not fit the current buffer fall back to the heap and are released at reset, after which the
+/// buffer is grown to the observed high-water mark.
+class URHO3D_API FrameArena
+{
+public:
+    /// Construct with initial buffer capacity in bytes.
+    explicit FrameArena(unsigned capacity = 1024 * 1024);
+    /// Destruct.
+    ~FrameArena();
+
+    /// Allocate memory valid until the next Reset(). Lock-free on the fast path, may be called from any thread.
+    void* Allocate(unsigned size, unsigned alignment = DEFAULT_ALIGNMENT);
+    /// Release all allocations and grow the buffer if it overflowed during the frame. Must not race with Allocate().
+    void Reset();
+
+    /// Return buffer capacity in bytes.
+    unsigned GetCapacity() const { return capacity_; }
+    /// Return number of bytes allocated since the last reset, including overflow.
+    unsigned GetUsed() const { return Min(cursor_.load(std::memory_order_relaxed), capacity_) + overflowSize_; }
+
+private:
+    /// Default allocation alignment. All allocation sizes are rounded up to this.
+    static const unsigned DEFAULT_ALIGNMENT = 16;
+
+    /// Linear buffer.
+    unsigned char* buffer_;
+    /// Buffer capacity in bytes.
+    unsigned capacity_;
+    /// Bump cursor.
+    std::atomic<unsigned> cursor_{};
+    /// Heap allocations made after the buffer overflowed.
+    ea::vector<unsigned char*> overflowAllocations_;
+    /// Total size of overflow allocations.
+    unsigned overflowSize_{};
+    /// Mutex protecting the overflow list.
+    Mutex overflowMutex_;
+};
+
+/// EASTL-compatible allocator adapter on top of a FrameArena. Deallocation of arena-backed
+/// memory is a no-op and the container contents must not outlive the arena reset. Adapters
+/// default-constructed without an arena fall back to regular heap allocation.
+class URHO3D_API FrameAllocator
+{
+public:
+    /// Construct unbound. Needed by EASTL container default constructors; allocations fall back to the heap.
+    explicit FrameAllocator(const char* name = nullptr) { (void)name; }
+    /// Construct bound to an arena.
+    explicit FrameAllocator(FrameArena* arena) : arena_(arena) {}
+
+    /// Allocate memory.
+    void* allocate(size_t n, int flags = 0);
+    /// Allocate memory with alignment.
+    void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0);
+    /// Free memory. No-op for arena-backed allocations.
+    void deallocate(void* p, size_t n);
+
+    /// Return debug name.
+    const char* get_name() const { return "FrameAllocator"; }
+    /// Set debug name. Ignored.
+    void set_name(const char* name) { (void)name; }
+
+    /// Return the arena.
+    FrameArena* GetArena() const { return arena_; }
+
+private:
+    /// Arena, or null for heap fallback.
+    FrameArena* arena_{};
+};
+
+/// Compare allocator adapters. Allocators are interchangeable when bound to the same arena.
+inline bool operator ==(const FrameAllocator& lhs, const FrameAllocator& rhs) { return lhs.GetArena() == rhs.GetArena(); }
+/// Compare allocator adapters for inequality.
+inline bool operator !=(const FrameAllocator& lhs, const FrameAllocator& rhs) { return lhs.GetArena() != rhs.GetArena(); }
+
+}
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/InternedString.h"
+#include "../Container/Str.h"
+#include "../Core/Mutex.h"
+
+#include <EASTL/unordered_set.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Process-wide intern table.
+struct InternTable
+{
+    /// Table lock.
+    Mutex mutex_;
+    /// Interned strings. Node-based, so element addresses stay stable across rehashing.
+    ea::unordered_set<ea::string> strings_;
+};
+
+/// Return the intern table. Leaked on purpose so that interned strings outlive static destruction.
+static InternTable& GetInternTable()
+{
+    static auto* table = new InternTable();
+    return *table;
+}
+
+/// Intern a string and return its stable storage.
+static const ea::string* Intern(const ea::string& str)
+{
+    InternTable& table = GetInternTable();
+    MutexLock lock(table.mutex_);
+    return &(*table.strings_.insert(str).first);
+}
+
+InternedString::InternedString() :
+    string_(Intern(EMPTY_STRING)),
+    hash_(StringHash::ZERO)
+{
+}
+
+InternedString::InternedString(const ea::string& str) :
+    string_(Intern(str)),
+    hash_(str)
+{
+}
+
+InternedString::InternedString(const char* str) :
+    InternedString(ea::string(str))
+{
+}
+
+unsigned InternedString::GetTableSize()
+{
+    InternTable& table = GetInternTable();
+    MutexLock lock(table.mutex_);
+    return table.strings_.size();
+}
+
+}
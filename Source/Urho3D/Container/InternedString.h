@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/StringHash.h"
+
+#include <EASTL/string.h>
+
+namespace Urho3D
+{
+
+/// Name string interned into a process-wide table. Each distinct string is stored once; copies are pointer
+/// sized, comparison is a pointer compare and the hash is computed once at interning time. Interning takes a
+/// lock and hashes the full string, so intern at API boundaries and pass the InternedString around. The table
+/// is never freed, which is fine for bounded name sets (resource names, attribute and event names) but makes
+/// the type unsuitable for unbounded user data.
+class URHO3D_API InternedString
+{
+public:
+    /// Construct an empty interned string.
+    InternedString();
+    /// Construct by interning a string.
+    explicit InternedString(const ea::string& str);
+    /// Construct by interning a C string.
+    explicit InternedString(const char* str);
+
+    /// Test for equality with another interned string.
+    bool operator ==(const InternedString& rhs) const { return string_ == rhs.string_; }
+    /// Test for inequality with another interned string.
+    bool operator !=(const InternedString& rhs) const { return string_ != rhs.string_; }
+    /// Order lexically, e.g. for sorted name listings.
+    bool operator <(const InternedString& rhs) const { return *string_ < *rhs.string_; }
+
+    /// Return the interned string. The reference stays valid for the lifetime of the process.
+    const ea::string& GetString() const { return *string_; }
+    /// Convert to the interned string.
+    operator const ea::string&() const { return *string_; }
+    /// Return the C string.
+    const char* CString() const { return string_->c_str(); }
+    /// Return the hash computed at interning time.
+    StringHash GetHash() const { return hash_; }
+    /// Return whether the string is empty.
+    bool Empty() const { return string_->empty(); }
+
+    /// Return hash value for HashSet & HashMap.
+    unsigned ToHash() const { return hash_.Value(); }
+
+    /// Return number of strings in the intern table.
+    static unsigned GetTableSize();
+
+private:
+    /// Interned string storage, owned by the table.
+    const ea::string* string_;
+    /// Hash of the string.
+    StringHash hash_;
+};
+
+}
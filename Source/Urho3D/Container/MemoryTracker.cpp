@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/MemoryTracker.h"
+#include "../Core/Mutex.h"
+#include "../Core/Profiler.h"
+#include "../IO/Log.h"
+
+#include <atomic>
+#include <cstring>
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Tag used for allocations made outside any URHO3D_MEMORY_TAG scope.
+static const char* const DEFAULT_MEMORY_TAG = "Untagged";
+/// Maximum nesting depth of memory tag scopes per thread.
+static const unsigned MAX_MEMORY_TAG_DEPTH = 16;
+
+/// Per-thread stack of active memory tags.
+static thread_local const char* memoryTagStack[MAX_MEMORY_TAG_DEPTH];
+/// Per-thread memory tag stack depth.
+static thread_local unsigned memoryTagDepth = 0;
+
+/// Live counters of one memory tag. Never destroyed, as frees may be tracked during static destruction.
+struct MemoryTagCounter
+{
+    /// Tag name.
+    const char* name_;
+    /// Currently allocated bytes.
+    std::atomic<long long> bytes_{0};
+    /// Currently live allocations.
+    std::atomic<unsigned> allocations_{0};
+};
+
+/// Bookkeeping of one tracked allocation.
+struct TrackedAllocation
+{
+    /// Counter of the tag the allocation was made under.
+    MemoryTagCounter* counter_;
+    /// Allocation size.
+    size_t size_;
+};
+
+/// Return mutex guarding the tracker state. Function-local and intentionally leaked so that it is valid
+/// during static initialization and destruction.
+static Mutex& GetTrackerMutex()
+{
+    static auto* mutex = new Mutex();
+    return *mutex;
+}
+
+/// Return counters of all tags. Intentionally leaked, see above.
+static ea::vector<MemoryTagCounter*>& GetTagCounters()
+{
+    static auto* counters = new ea::vector<MemoryTagCounter*>();
+    return *counters;
+}
+
+/// Return bookkeeping of all tracked allocations. Intentionally leaked, see above.
+static ea::unordered_map<const void*, TrackedAllocation>& GetAllocationMap()
+{
+    static auto* allocations = new ea::unordered_map<const void*, TrackedAllocation>();
+    return *allocations;
+}
+
+/// Return counter for a named tag, creating it on demand. The tracker mutex must be held.
+static MemoryTagCounter* GetOrCreateTagCounter(const char* name)
+{
+    for (MemoryTagCounter* counter : GetTagCounters())
+    {
+        if (counter->name_ == name || !strcmp(counter->name_, name))
+            return counter;
+    }
+
+    auto* counter = new MemoryTagCounter();
+    counter->name_ = name;
+    GetTagCounters().push_back(counter);
+    return counter;
+}
+
+void MemoryTracker::PushTag(const char* name)
+{
+    if (memoryTagDepth < MAX_MEMORY_TAG_DEPTH)
+        memoryTagStack[memoryTagDepth] = name;
+    ++memoryTagDepth;
+}
+
+void MemoryTracker::PopTag()
+{
+    if (memoryTagDepth)
+        --memoryTagDepth;
+}
+
+const char* MemoryTracker::GetCurrentTag()
+{
+    if (!memoryTagDepth)
+        return DEFAULT_MEMORY_TAG;
+
+    // If the stack has overflowed, the innermost stored tag is the best available attribution
+    const unsigned depth = memoryTagDepth < MAX_MEMORY_TAG_DEPTH ? memoryTagDepth : MAX_MEMORY_TAG_DEPTH;
+    return memoryTagStack[depth - 1];
+}
+
+void MemoryTracker::TrackAlloc(const void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    {
+        MutexLock lock(GetTrackerMutex());
+        MemoryTagCounter* counter = GetOrCreateTagCounter(GetCurrentTag());
+        GetAllocationMap()[ptr] = TrackedAllocation{counter, size};
+        counter->bytes_.fetch_add((long long)size, std::memory_order_relaxed);
+        counter->allocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    TracyAlloc(ptr, size);
+}
+
+void MemoryTracker::TrackFree(const void* ptr)
+{
+    if (!ptr)
+        return;
+
+    {
+        MutexLock lock(GetTrackerMutex());
+        auto& allocations = GetAllocationMap();
+        auto it = allocations.find(ptr);
+        if (it == allocations.end())
+            return;
+
+        MemoryTagCounter* counter = it->second.counter_;
+        counter->bytes_.fetch_sub((long long)it->second.size_, std::memory_order_relaxed);
+        counter->allocations_.fetch_sub(1, std::memory_order_relaxed);
+        allocations.erase(it);
+    }
+
+    TracyFree(ptr);
+}
+
+long long MemoryTracker::GetMemoryUse(const char* name)
+{
+    MutexLock lock(GetTrackerMutex());
+    for (MemoryTagCounter* counter : GetTagCounters())
+    {
+        if (counter->name_ == name || !strcmp(counter->name_, name))
+            return counter->bytes_.load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+void MemoryTracker::GetMemoryUse(ea::vector<MemoryTagInfo>& result)
+{
+    result.clear();
+
+    MutexLock lock(GetTrackerMutex());
+    for (MemoryTagCounter* counter : GetTagCounters())
+    {
+        MemoryTagInfo info;
+        info.name_ = counter->name_;
+        info.bytes_ = counter->bytes_.load(std::memory_order_relaxed);
+        info.allocations_ = counter->allocations_.load(std::memory_order_relaxed);
+        result.push_back(info);
+    }
+}
+
+void MemoryTracker::Dump()
+{
+    ea::vector<MemoryTagInfo> tags;
+    GetMemoryUse(tags);
+
+    long long totalBytes = 0;
+    unsigned totalAllocations = 0;
+    for (const MemoryTagInfo& tag : tags)
+    {
+        URHO3D_LOGINFO("{}: {} kb in {} allocations", tag.name_, (tag.bytes_ + 512) / 1024, tag.allocations_);
+        totalBytes += tag.bytes_;
+        totalAllocations += tag.allocations_;
+    }
+    URHO3D_LOGINFO("Total tracked memory {} kb in {} allocations", (totalBytes + 512) / 1024, totalAllocations);
+}
+
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <cstddef>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Live statistics of one memory tag.
+struct MemoryTagInfo
+{
+    /// Tag name.
+    const char* name_{};
+    /// Currently allocated bytes.
+    long long bytes_{};
+    /// Currently live allocations.
+    unsigned allocations_{};
+};
+
+/// Allocation tracking facility. Allocations reported through TrackAlloc() are attributed to the innermost
+/// URHO3D_MEMORY_TAG scope on the calling thread and counted per tag until the matching TrackFree(); the live
+/// counters can be queried at runtime in any build. The tracked allocations are also forwarded to the Tracy
+/// memory profiler when profiling is enabled. The engine's pooled allocators (Allocator, FrameArena) report
+/// their block allocations automatically; other allocation sites can opt in by calling TrackAlloc()/TrackFree().
+class URHO3D_API MemoryTracker
+{
+public:
+    /// Push a memory tag on the calling thread. The name must be a string literal or otherwise outlive the scope.
+    static void PushTag(const char* name);
+    /// Pop the innermost memory tag of the calling thread.
+    static void PopTag();
+    /// Return the innermost memory tag of the calling thread.
+    static const char* GetCurrentTag();
+
+    /// Attribute an allocation to the current memory tag. Thread-safe.
+    static void TrackAlloc(const void* ptr, size_t size);
+    /// Remove a tracked allocation, crediting the tag it was allocated under. Thread-safe.
+    static void TrackFree(const void* ptr);
+
+    /// Return currently allocated bytes of a named tag, or 0 if the tag is unknown.
+    static long long GetMemoryUse(const char* name);
+    /// Return live statistics of all tags.
+    static void GetMemoryUse(ea::vector<MemoryTagInfo>& result);
+    /// Log live statistics of all tags.
+    static void Dump();
+};
+
+/// Scoped memory tag. Allocations tracked on the calling thread during the scope are attributed to the tag.
+class URHO3D_API MemoryTagScope
+{
+public:
+    /// Construct and push the tag.
+    explicit MemoryTagScope(const char* name) { MemoryTracker::PushTag(name); }
+    /// Destruct and pop the tag.
+    ~MemoryTagScope() { MemoryTracker::PopTag(); }
+};
+
+}
+
+/// Attribute tracked allocations made in the enclosing scope on this thread to a named memory tag.
+#define URHO3D_MEMORY_TAG(name) Urho3D::MemoryTagScope memoryTagScope(name)
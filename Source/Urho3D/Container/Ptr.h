@@ -179,9 +179,9 @@ public:
         if (ptr_)
         {
             RefCount* refCount = RefCountPtr();
-            ea::Internal::atomic_increment(&refCount->refs_); // 2 refs
+            refCount->refs_.fetch_add(1, std::memory_order_relaxed); // 2 refs
             Reset(); // 1 ref
-            ea::Internal::atomic_decrement(&refCount->refs_); // 0 refs
+            refCount->refs_.fetch_sub(1, std::memory_order_relaxed); // 0 refs
         }
         return ptr;
     }
@@ -485,7 +485,11 @@ public:
     bool NotNull() const { return refCount_ != nullptr; }
 
     /// Return the object's reference count, or 0 if null pointer or if object has expired.
-    int Refs() const { return (refCount_ && refCount_->refs_ >= 0) ? refCount_->refs_ : 0; }
+    int Refs() const
+    {
+        const int refs = refCount_ ? refCount_->refs_.load(std::memory_order_relaxed) : 0;
+        return refs >= 0 ? refs : 0;
+    }
 
     /// Return the object's weak reference count.
     int WeakRefs() const
@@ -493,11 +497,11 @@ public:
         if (!Expired())
             return ptr_->WeakRefs();
         else
-            return refCount_ ? refCount_->weakRefs_ : 0;
+            return refCount_ ? refCount_->weakRefs_.load(std::memory_order_relaxed) : 0;
     }
 
     /// Return whether the object has expired. If null pointer, always return true.
-    bool Expired() const { return refCount_ ? refCount_->refs_ < 0 : true; }
+    bool Expired() const { return refCount_ ? refCount_->refs_.load(std::memory_order_acquire) < 0 : true; }
 
     /// Return pointer to the RefCount structure.
     RefCount* RefCountPtr() const { return refCount_; }
@@ -513,8 +517,8 @@ private:
     {
         if (refCount_)
         {
-            assert(refCount_->weakRefs_ >= 0);
-            ea::Internal::atomic_increment(&refCount_->weakRefs_);
+            assert(refCount_->weakRefs_.load(std::memory_order_relaxed) >= 0);
+            refCount_->weakRefs_.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -523,8 +527,8 @@ private:
     {
         if (refCount_)
         {
-            assert(refCount_->weakRefs_ > 0);
-            int weakRefs = ea::Internal::atomic_decrement(&refCount_->weakRefs_);
+            assert(refCount_->weakRefs_.load(std::memory_order_relaxed) > 0);
+            int weakRefs = refCount_->weakRefs_.fetch_sub(1, std::memory_order_acq_rel) - 1;
 
             if (Expired() && weakRefs == 0)
                 RefCount::Free(refCount_);
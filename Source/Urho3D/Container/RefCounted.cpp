@@ -24,8 +24,6 @@
 
 #include <cassert>
 
-#include <EASTL/internal/thread_support.h>
-
 #include "../Container/RefCounted.h"
 #include "../Core/Macros.h"
 #if URHO3D_CSHARP
@@ -35,6 +33,13 @@
 namespace Urho3D
 {
 
+/// Padding that keeps the object aligned like a plain heap allocation when the reference count is embedded in front of it.
+static const size_t embeddedRefCountPadding = 16;
+static_assert(sizeof(RefCount) <= embeddedRefCountPadding, "RefCount does not fit in the embedded block header");
+
+/// Reference count embedded in the block most recently allocated by RefCounted::operator new on this thread, waiting to be adopted by the constructor.
+static thread_local RefCount* pendingRefCount = nullptr;
+
 RefCount* RefCount::Allocate()
 {
     void* const memory = EASTLAlloc(*ea::get_default_allocator((Allocator*)nullptr), sizeof(RefCount));
@@ -44,22 +49,68 @@ RefCount* RefCount::Allocate()
 
 void RefCount::Free(RefCount* instance)
 {
+    // An embedded count sits at the start of the object allocation block and releases the whole block
+    const size_t size = instance->allocationSize_ ? instance->allocationSize_ : sizeof(RefCount);
     instance->~RefCount();
-    EASTLFree(*ea::get_default_allocator((Allocator*)nullptr), instance, sizeof(RefCount));
+    EASTLFree(*ea::get_default_allocator((Allocator*)nullptr), instance, size);
+}
+
+void* RefCounted::operator new(size_t size)
+{
+    const size_t blockSize = embeddedRefCountPadding + size;
+    void* const memory = EASTLAlloc(*ea::get_default_allocator((RefCount::Allocator*)nullptr), blockSize);
+    assert(memory != nullptr);
+
+    auto* refCount = ::new(memory) RefCount();
+    refCount->allocationSize_ = (unsigned)blockSize;
+    pendingRefCount = refCount;
+    return static_cast<char*>(memory) + embeddedRefCountPadding;
+}
+
+void RefCounted::operator delete(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    auto* refCount = reinterpret_cast<RefCount*>(static_cast<char*>(ptr) - embeddedRefCountPadding);
+
+    // Clear the pending count if the constructor never ran, e.g. an argument of the new-expression threw
+    if (pendingRefCount == refCount)
+        pendingRefCount = nullptr;
+
+    // When the constructor did not adopt the embedded count, no weak references can point at it either
+    if (refCount->weakRefs_.load(std::memory_order_relaxed) == 0)
+    {
+        RefCount::Free(refCount);
+        return;
+    }
+
+    // Release the self weak reference the destructor left behind; the block stays alive until the last weak reference is gone
+    if (refCount->weakRefs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        RefCount::Free(refCount);
 }
 
 RefCounted::RefCounted()
-    : refCount_(RefCount::Allocate())
 {
+    // Adopt the reference count embedded in the allocation block when created through operator new. Otherwise
+    // (external storage, or the pending count was orphaned by an allocation in between) allocate it separately.
+    RefCount* const pending = pendingRefCount;
+    pendingRefCount = nullptr;
+    if (pending && reinterpret_cast<char*>(this) >= reinterpret_cast<char*>(pending) &&
+        reinterpret_cast<char*>(this) < reinterpret_cast<char*>(pending) + pending->allocationSize_)
+        refCount_ = pending;
+    else
+        refCount_ = RefCount::Allocate();
+
     // Hold a weak ref to self to avoid possible double delete of the refcount
-    refCount_->weakRefs_++;
+    refCount_->weakRefs_.fetch_add(1, std::memory_order_relaxed);
 }
 
 RefCounted::~RefCounted()
 {
     assert(refCount_);
-    assert(refCount_->refs_ == 0);
-    assert(refCount_->weakRefs_ > 0);
+    assert(refCount_->refs_.load(std::memory_order_relaxed) == 0);
+    assert(refCount_->weakRefs_.load(std::memory_order_relaxed) > 0);
 
 #if URHO3D_CSHARP
     // Dispose of managed object when native object was a part of other object (did not use refcounting). Native
@@ -76,18 +127,25 @@ RefCounted::~RefCounted()
     }
 #endif
 
-    // Mark object as expired, release the self weak ref and delete the refcount if no other weak refs exist
-    refCount_->refs_ = -1;
+    // Mark object as expired. Release order so that a thread dropping the last weak reference sees the destructed object.
+    refCount_->refs_.store(-1, std::memory_order_release);
 
-    if (ea::Internal::atomic_decrement(&refCount_->weakRefs_) == 0)
-        RefCount::Free(refCount_);
+    if (refCount_->allocationSize_ == 0)
+    {
+        // Release the self weak ref and delete the refcount if no other weak refs exist
+        if (refCount_->weakRefs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            RefCount::Free(refCount_);
+    }
+    // An embedded refcount shares the object allocation block; operator delete releases the self weak ref
+    // once the block is no longer accessed
 
     refCount_ = nullptr;
 }
 
 int RefCounted::AddRef()
 {
-    int refs = ea::Internal::atomic_increment(&refCount_->refs_);
+    // Relaxed order suffices: taking a new reference requires holding an existing one
+    int refs = refCount_->refs_.fetch_add(1, std::memory_order_relaxed) + 1;
     assert(refs > 0);
 #if URHO3D_CSHARP
     if (URHO3D_UNLIKELY(scriptObject_ && !isScriptStrongRef_))
@@ -105,7 +163,8 @@ int RefCounted::AddRef()
 
 int RefCounted::ReleaseRef()
 {
-    int refs = ea::Internal::atomic_decrement(&refCount_->refs_);
+    // Release so preceding writes are visible to the deleting thread, acquire so the delete sees them
+    int refs = refCount_->refs_.fetch_sub(1, std::memory_order_acq_rel) - 1;
     assert(refs >= 0);
 #if URHO3D_CSHARP
     if (refs == 0)
@@ -131,13 +190,13 @@ int RefCounted::ReleaseRef()
 
 int RefCounted::Refs() const
 {
-    return refCount_->refs_;
+    return refCount_->refs_.load(std::memory_order_relaxed);
 }
 
 int RefCounted::WeakRefs() const
 {
     // Subtract one to not return the internally held reference
-    return refCount_->weakRefs_ - 1;
+    return refCount_->weakRefs_.load(std::memory_order_relaxed) - 1;
 }
 #if URHO3D_CSHARP
 void RefCounted::SetScriptObject(void* handle, bool isStrong)
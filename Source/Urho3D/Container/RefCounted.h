@@ -26,12 +26,17 @@
 
 #include <Urho3D/Urho3D.h>
 
+#include <atomic>
+
 namespace Urho3D
 {
 
-/// Reference count structure.
+/// Reference count structure. Counters are atomic so that shared pointers may be handed to other threads,
+/// e.g. resources or work items finished on a worker thread, without external locking.
 struct URHO3D_API RefCount
 {
+    friend class RefCounted;
+
 protected:
     using Allocator = EASTLAllocatorType;
 
@@ -43,19 +48,21 @@ public:
     ~RefCount()
     {
         // Set reference counts below zero to fire asserts if this object is still accessed
-        refs_ = -1;
-        weakRefs_ = -1;
+        refs_.store(-1, std::memory_order_relaxed);
+        weakRefs_.store(-1, std::memory_order_relaxed);
     }
 
     /// Allocate RefCount using it's default allocator.
     static RefCount* Allocate();
-    /// Free RefCount using it's default allocator.
+    /// Free RefCount using it's default allocator. Frees the whole object block when the count is embedded in it.
     static void Free(RefCount* instance);
 
     /// Reference count. If below zero, the object has been destroyed.
-    int refs_ = 0;
+    std::atomic<int> refs_{0};
     /// Weak reference count.
-    int weakRefs_ = 0;
+    std::atomic<int> weakRefs_{0};
+    /// Size of the allocation block when the count is embedded in the object allocation, 0 when allocated separately.
+    unsigned allocationSize_{0};
 };
 
 /// Base class for intrusively reference-counted objects. These are noncopyable and non-assignable.
@@ -72,6 +79,24 @@ public:
     /// Prevent assignment.
     RefCounted& operator =(const RefCounted& rhs) = delete;
 
+    /// Allocate with the reference count embedded in the same block, saving a separate allocation per object
+    /// and a second cache miss per smart pointer operation.
+    static void* operator new(size_t size);
+    /// Free the allocation block, unless outside weak references still need the embedded reference count.
+    static void operator delete(void* ptr);
+
+    /// Placement construction into external storage. The reference count is allocated separately then.
+    static void* operator new(size_t, void* ptr) { return ptr; }
+    /// Placement delete counterpart, called when a placement-constructed object throws.
+    static void operator delete(void*, void*) {}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+    /// Match the block type, file and line form that the debug heap macro in DebugNew.h rewrites new-expressions into.
+    static void* operator new(size_t size, int, const char*, int) { return operator new(size); }
+    /// Counterpart called when construction throws.
+    static void operator delete(void* ptr, int, const char*, int) { operator delete(ptr); }
+#endif
+
     /// Increment reference count. Can also be called outside of a SharedPtr for traditional reference counting. Returns new reference count value. Operation is atomic.
     int AddRef();
     /// Decrement reference count and delete self if no more references. Can also be called outside of a SharedPtr for traditional reference counting. Returns new reference count value. Operation is atomic.
@@ -38,6 +38,16 @@ ValueCache::~ValueCache()
     Clear();
 }
 
+void ValueCache::AddInvalidationEvent(StringHash eventType)
+{
+    SubscribeToEvent(eventType, [this](StringHash, VariantMap&) { Clear(); });
+}
+
+void ValueCache::AddInvalidationEvent(Object* sender, StringHash eventType)
+{
+    SubscribeToEvent(sender, eventType, [this](StringHash, VariantMap&) { Clear(); });
+}
+
 void ValueCache::Expire()
 {
     if (expireTimer_.GetMSec(false) < 10000)
@@ -46,34 +56,70 @@ void ValueCache::Expire()
 
     auto time = GetSubsystem<Time>();
     unsigned framesNow = time->GetFrameNumber();
-    for (auto it = cache_.begin(); it != cache_.end();)
+    for (Shard& shard : shards_)
     {
-        CacheEntry& entry = it->second;
-        if ((framesNow - entry.lastUsed_) > expireFrames_)
+        MutexLock lock(shard.mutex_);
+        for (auto it = shard.cache_.begin(); it != shard.cache_.end();)
         {
+            CacheEntry& entry = it->second;
+            if ((framesNow - entry.lastUsed_) > expireFrames_)
+            {
+                entry.deleter_(entry.value_);
+                entry.value_ = nullptr;
+                it = shard.cache_.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+void ValueCache::Clear()
+{
+    for (Shard& shard : shards_)
+    {
+        MutexLock lock(shard.mutex_);
+        for (auto& pair : shard.cache_)
+        {
+            CacheEntry& entry = pair.second;
             entry.deleter_(entry.value_);
             entry.value_ = nullptr;
-            it = cache_.erase(it);
         }
-        else
-            ++it;
+        shard.cache_.clear();
     }
 }
 
-void ValueCache::Clear()
+float ValueCache::GetHitRatio() const
+{
+    const unsigned hits = hits_.load(std::memory_order_relaxed);
+    const unsigned misses = misses_.load(std::memory_order_relaxed);
+    const unsigned total = hits + misses;
+    return total ? (float)hits / (float)total : 0.0f;
+}
+
+unsigned ValueCache::GetSize() const
 {
-    for (auto& pair : cache_)
+    unsigned size = 0;
+    for (const Shard& shard : shards_)
     {
-        CacheEntry& entry = pair.second;
-        entry.deleter_(entry.value_);
-        entry.value_ = nullptr;
+        MutexLock lock(shard.mutex_);
+        size += shard.cache_.size();
     }
-    cache_.clear();
+    return size;
+}
+
+void ValueCache::ResetStats()
+{
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
 }
 
 void ValueCache::OnEndFrame(StringHash, VariantMap&)
 {
-    Expire();
+    if (invalidationMode_ == CACHE_INVALIDATE_FRAME)
+        Clear();
+    else if (invalidationMode_ == CACHE_INVALIDATE_EXPIRE)
+        Expire();
 }
 
 }
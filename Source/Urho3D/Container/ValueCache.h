@@ -22,15 +22,35 @@
 #pragma once
 
 #include "../Container/Hash.h"
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Core/Timer.h"
 
 #include <EASTL/unordered_map.h>
 
+#include <atomic>
+
 namespace Urho3D
 {
 
-/// A cache of temporary objects that expire when not accessed for certain number of frames.
+/// Cache invalidation behavior.
+enum CacheInvalidationMode
+{
+    /// Purge entries not accessed for the configured number of frames. Default.
+    CACHE_INVALIDATE_EXPIRE = 0,
+    /// Clear all entries at the end of every frame.
+    CACHE_INVALIDATE_FRAME,
+    /// Clear only explicitly or through bound invalidation events.
+    CACHE_INVALIDATE_MANUAL
+};
+
+/// A keyed cache of temporary objects with pluggable invalidation, used to memoize expensive derived data.
+/// By default entries expire when not accessed for a certain number of frames. A cache can instead be cleared
+/// at the end of every frame for per-frame derived data, or only on explicit triggers; any cache can
+/// additionally be bound to events, e.g. E_RELOADFINISHED of a resource for reload-scoped caching. The entry
+/// map is sharded with one mutex per shard, so concurrent lookups from worker threads mostly take different
+/// locks; the owner must still ensure invalidation does not race with use of returned pointers. Hit and miss
+/// counts are tracked to judge what is worth caching.
 class URHO3D_API ValueCache : public Object
 {
     URHO3D_OBJECT(ValueCache, Object);
@@ -39,20 +59,34 @@ public:
     explicit ValueCache(Context* context);
     /// Destruct.
     ~ValueCache() override;
+    /// Set invalidation behavior.
+    void SetInvalidationMode(CacheInvalidationMode mode) { invalidationMode_ = mode; }
+    /// Get invalidation behavior.
+    CacheInvalidationMode GetInvalidationMode() const { return invalidationMode_; }
     /// Set number of frames after which unused items will be purged.
     void SetExpireFrames(unsigned frames) { expireFrames_ = frames; }
     /// Get number of frames after which unused items will be purged.
     unsigned GetExpireFrames() const { return expireFrames_; }
+    /// Clear the cache whenever the given event is sent.
+    void AddInvalidationEvent(StringHash eventType);
+    /// Clear the cache whenever the given sender sends the given event, e.g. E_RELOADFINISHED of a resource.
+    void AddInvalidationEvent(Object* sender, StringHash eventType);
     /// Get item from cache or make a new one if it does not exist.
     template<typename T, typename... Args>
     T* Get(unsigned hash, Args&&... args)
     {
-        CacheEntry* entry = nullptr;
+        const unsigned frameNumber = GetSubsystem<Time>()->GetFrameNumber();
         hash = GetTypeHash<T>(hash);
-        auto it = cache_.find(hash);
-        if (it == cache_.end())
+
+        Shard& shard = GetShard(hash);
+        MutexLock lock(shard.mutex_);
+
+        CacheEntry* entry = nullptr;
+        auto it = shard.cache_.find(hash);
+        if (it == shard.cache_.end())
         {
-            entry = &cache_[hash];
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            entry = &shard.cache_[hash];
 #if URHO3D_DEBUG
             entry->typeId_ = typeid(T).hash_code();
 #endif
@@ -61,13 +95,13 @@ public:
         }
         else
         {
+            hits_.fetch_add(1, std::memory_order_relaxed);
             entry = &it->second;
 #if URHO3D_DEBUG
             assert(entry->typeId_ == typeid(T).hash_code());
 #endif
         }
-        auto time = GetSubsystem<Time>();
-        entry->lastUsed_ = time->GetFrameNumber();
+        entry->lastUsed_ = frameNumber;
         return static_cast<T*>(entry->value_);
     }
     /// Get item from cache if exists or return nullptr otherwise.
@@ -75,9 +109,17 @@ public:
     T* Peek(unsigned hash)
     {
         hash = GetTypeHash<T>(hash);
-        auto it = cache_.find(hash);
-        if (it != cache_.end())
+
+        Shard& shard = GetShard(hash);
+        MutexLock lock(shard.mutex_);
+
+        auto it = shard.cache_.find(hash);
+        if (it != shard.cache_.end())
+        {
+            hits_.fetch_add(1, std::memory_order_relaxed);
             return static_cast<T*>(it->second.value_);
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
         return nullptr;
     }
     /// Remove a specific cache entry.
@@ -85,13 +127,17 @@ public:
     void Remove(unsigned hash)
     {
         hash = GetTypeHash<T>(hash);
-        auto it = cache_.find(hash);
-        if (it != cache_.end())
+
+        Shard& shard = GetShard(hash);
+        MutexLock lock(shard.mutex_);
+
+        auto it = shard.cache_.find(hash);
+        if (it != shard.cache_.end())
         {
             CacheEntry& entry = it->second;
             entry.deleter_(entry.value_);
             entry.value_ = nullptr;
-            cache_.erase(it);
+            shard.cache_.erase(it);
         }
     }
     /// Remove value from cache and return it.
@@ -99,12 +145,16 @@ public:
     T* Detach(unsigned hash)
     {
         hash = GetTypeHash<T>(hash);
-        auto it = cache_.find(hash);
-        if (it != cache_.end())
+
+        Shard& shard = GetShard(hash);
+        MutexLock lock(shard.mutex_);
+
+        auto it = shard.cache_.find(hash);
+        if (it != shard.cache_.end())
         {
             CacheEntry& entry = it->second;
             T* result = static_cast<T*>(entry.value_);
-            cache_.erase(it);
+            shard.cache_.erase(it);
             return result;
         }
         return nullptr;
@@ -114,7 +164,21 @@ public:
     /// Remove all cache entries.
     void Clear();
 
+    /// Return number of cache hits since creation or the last ResetStats().
+    unsigned GetHits() const { return hits_.load(std::memory_order_relaxed); }
+    /// Return number of cache misses since creation or the last ResetStats().
+    unsigned GetMisses() const { return misses_.load(std::memory_order_relaxed); }
+    /// Return cache hit ratio in the 0-1 range, or 0 if the cache has not been queried.
+    float GetHitRatio() const;
+    /// Return number of cached entries.
+    unsigned GetSize() const;
+    /// Reset hit and miss counters.
+    void ResetStats();
+
 private:
+    /// Number of lock shards.
+    static const unsigned NUM_SHARDS = 8;
+
     struct CacheEntry
     {
 #if URHO3D_DEBUG
@@ -129,6 +193,15 @@ private:
         void(*deleter_)(void*);
     };
 
+    /// One lock shard of the entry map.
+    struct Shard
+    {
+        /// Shard lock.
+        mutable Mutex mutex_;
+        /// Cached entries of the shard.
+        ea::unordered_map<unsigned, CacheEntry> cache_{};
+    };
+
     /// Combine seed and type hash.
     template<typename T>
     unsigned GetTypeHash(unsigned seed)
@@ -140,15 +213,23 @@ private:
         CombineHash(seed, static_cast<unsigned>(typeId));
         return seed;
     }
+    /// Return the shard holding the given hash.
+    Shard& GetShard(unsigned hash) { return shards_[hash % NUM_SHARDS]; }
     /// Garbage-collect unused objects.
     void OnEndFrame(StringHash, VariantMap&);
 
-    /// Number of milliseconds after which unused items will be purged.
+    /// Invalidation behavior.
+    CacheInvalidationMode invalidationMode_ = CACHE_INVALIDATE_EXPIRE;
+    /// Number of frames after which unused items will be purged.
     unsigned expireFrames_ = 60;
     /// Expiration timer.
     Timer expireTimer_{};
-    /// Cache.
-    ea::unordered_map<unsigned, CacheEntry> cache_{};
+    /// Lock shards of the entry map.
+    Shard shards_[NUM_SHARDS];
+    /// Number of cache hits.
+    std::atomic<unsigned> hits_{0};
+    /// Number of cache misses.
+    std::atomic<unsigned> misses_{0};
 };
 
 }
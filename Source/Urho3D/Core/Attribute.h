@@ -53,6 +53,8 @@ enum AttributeMode
     AM_NODEIDVECTOR = 0x40,
     /// Attribute is readonly. Can't be used with binary serialized objects.
     AM_READONLY = 0x80,
+    /// Attribute is quantized in network replication: Vector3 values are sent as variable-length fixed point and Quaternion values with smallest-three encoding.
+    AM_QUANTIZE = 0x100,
 };
 URHO3D_FLAGSET(AttributeMode, AttributeModeFlags);
 
@@ -22,7 +22,11 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/Allocator.h"
+#include "../Container/FrameAllocator.h"
+#include "../Container/MemoryTracker.h"
 #include "../Core/Context.h"
+#include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 
@@ -71,6 +75,69 @@ static void HandleIKLog(const char* msg)
 }
 #endif
 
+namespace
+{
+
+/// Chunked fixed-size pool for one object type.
+struct ObjectPool
+{
+    /// Mutex protecting the allocator.
+    Mutex mutex_;
+    /// Chunked fixed-size allocator.
+    AllocatorBlock* allocator_{};
+};
+
+/// Return registry of object pools. Intentionally leaked because pooled objects may be deleted during static destruction.
+ea::unordered_map<StringHash, ObjectPool*>& GetObjectPools()
+{
+    static auto* pools = new ea::unordered_map<StringHash, ObjectPool*>();
+    return *pools;
+}
+
+/// Return mutex protecting the object pool registry. Intentionally leaked, see above.
+Mutex& GetObjectPoolsMutex()
+{
+    static auto* mutex = new Mutex();
+    return *mutex;
+}
+
+/// Return pool for given object type, creating it on demand.
+ObjectPool* GetObjectPool(StringHash objectType, unsigned size)
+{
+    MutexLock lock(GetObjectPoolsMutex());
+    ObjectPool*& pool = GetObjectPools()[objectType];
+    if (!pool)
+    {
+        pool = new ObjectPool();
+        pool->allocator_ = AllocatorInitialize(size, 16);
+    }
+    return pool;
+}
+
+}
+
+void* Context::AllocateFromObjectPool(StringHash objectType, unsigned size)
+{
+    URHO3D_MEMORY_TAG("ObjectPools");
+    ObjectPool* pool = GetObjectPool(objectType, size);
+    MutexLock lock(pool->mutex_);
+    return AllocatorReserve(pool->allocator_);
+}
+
+void Context::FreeToObjectPool(StringHash objectType, void* ptr)
+{
+    ObjectPool* pool;
+    {
+        MutexLock lock(GetObjectPoolsMutex());
+        auto& pools = GetObjectPools();
+        auto it = pools.find(objectType);
+        assert(it != pools.end());
+        pool = it->second;
+    }
+    MutexLock lock(pool->mutex_);
+    AllocatorFree(pool->allocator_, ptr);
+}
+
 void EventReceiverGroup::BeginSendEvent()
 {
     ++inSend_;
@@ -147,6 +214,13 @@ Context::Context() :
 
     // Set the main thread ID (assuming the Context is created in it)
     Thread::SetMainThread();
+
+    frameArena_ = ea::make_unique<FrameArena>();
+
+    // Initialize the cross-thread event queue with a stub node
+    auto* stub = new QueuedEvent();
+    crossThreadEventHead_.store(stub, std::memory_order_relaxed);
+    crossThreadEventTail_ = stub;
 }
 
 Context::~Context()
@@ -174,6 +248,14 @@ Context::~Context()
     for (auto i = eventDataMaps_.begin(); i != eventDataMaps_.end(); ++i)
         delete *i;
     eventDataMaps_.clear();
+
+    // Delete remaining cross-thread events including the stub node
+    while (crossThreadEventTail_)
+    {
+        QueuedEvent* next = crossThreadEventTail_->next_.load(std::memory_order_acquire);
+        delete crossThreadEventTail_;
+        crossThreadEventTail_ = next;
+    }
 }
 
 SharedPtr<Object> Context::CreateObject(StringHash objectType)
@@ -185,6 +267,12 @@ SharedPtr<Object> Context::CreateObject(StringHash objectType)
         return SharedPtr<Object>();
 }
 
+ObjectFactory* Context::GetFactory(StringHash objectType) const
+{
+    auto i = factories_.find(objectType);
+    return i != factories_.end() ? i->second.Get() : nullptr;
+}
+
 void Context::RegisterFactory(ObjectFactory* factory)
 {
     if (!factory)
@@ -275,6 +363,7 @@ AttributeHandle Context::RegisterAttribute(StringHash objectType, const Attribut
     ea::vector<AttributeInfo>& objectAttributes = attributes_[objectType];
     objectAttributes.push_back(attr);
     handle.attributeInfo_ = &objectAttributes.back();
+    attributeIndexTables_.erase(objectType);
 
     if (attr.mode_ & AM_NET)
     {
@@ -289,12 +378,35 @@ void Context::RemoveAttribute(StringHash objectType, const char* name)
 {
     RemoveNamedAttribute(attributes_, objectType, name);
     RemoveNamedAttribute(networkAttributes_, objectType, name);
+    attributeIndexTables_.erase(objectType);
 }
 
 void Context::RemoveAllAttributes(StringHash objectType)
 {
     attributes_.erase(objectType);
     networkAttributes_.erase(objectType);
+    attributeIndexTables_.erase(objectType);
+}
+
+unsigned Context::GetAttributeIndex(StringHash objectType, StringHash nameHash) const
+{
+    auto tableIter = attributeIndexTables_.find(objectType);
+    if (tableIter == attributeIndexTables_.end())
+    {
+        // Resolve the name hash to index table once; attribute registration normally completes during startup
+        auto attrIter = attributes_.find(objectType);
+        if (attrIter == attributes_.end())
+            return M_MAX_UNSIGNED;
+
+        ea::unordered_map<StringHash, unsigned>& table = attributeIndexTables_[objectType];
+        const ea::vector<AttributeInfo>& objectAttributes = attrIter->second;
+        for (unsigned i = 0; i < objectAttributes.size(); ++i)
+            table.emplace(objectAttributes[i].nameHash_, i);
+        tableIter = attributeIndexTables_.find(objectType);
+    }
+
+    auto i = tableIter->second.find(nameHash);
+    return i != tableIter->second.end() ? i->second : M_MAX_UNSIGNED;
 }
 
 void Context::UpdateAttributeDefaultValue(StringHash objectType, const char* name, const Variant& defaultValue)
@@ -315,6 +427,38 @@ VariantMap& Context::GetEventDataMap()
     return ret;
 }
 
+void Context::QueueCrossThreadEvent(Object* sender, StringHash eventType, const VariantMap& eventData)
+{
+    // Vyukov-style lock-free multi-producer push: publish the node, then link the predecessor to it
+    auto* node = new QueuedEvent();
+    node->sender_ = sender;
+    node->eventType_ = eventType;
+    node->eventData_ = eventData;
+
+    QueuedEvent* prev = crossThreadEventHead_.exchange(node, std::memory_order_acq_rel);
+    prev->next_.store(node, std::memory_order_release);
+}
+
+void Context::ProcessCrossThreadEvents()
+{
+    assert(Thread::IsMainThread());
+
+    for (;;)
+    {
+        QueuedEvent* tail = crossThreadEventTail_;
+        QueuedEvent* next = tail->next_.load(std::memory_order_acquire);
+        if (!next)
+            break;
+
+        // The consumed node becomes the new stub; the old stub is released
+        crossThreadEventTail_ = next;
+        delete tail;
+
+        if (Object* sender = next->sender_)
+            sender->SendEvent(next->eventType_, next->eventData_);
+    }
+}
+
 #ifndef MINI_URHO
 bool Context::RequireSDL(unsigned int sdlFlags)
 {
@@ -414,6 +558,7 @@ void Context::CopyBaseAttributes(StringHash baseType, StringHash derivedType)
             if (attr.mode_ & AM_NET)
                 networkAttributes_[derivedType].push_back(attr);
         }
+        attributeIndexTables_.erase(derivedType);
     }
 }
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/unique_ptr.h>
+#include <atomic>
 
 #include "../Container/Ptr.h"
 #include "../Core/Attribute.h"
@@ -31,6 +32,8 @@
 namespace Urho3D
 {
 
+class FrameArena;
+
 /// Tracking structure for event receivers.
 class URHO3D_API EventReceiverGroup : public RefCounted
 {
@@ -82,6 +85,16 @@ public:
     }
     /// Create an object by type hash. Return pointer to it or null if no factory found.
     SharedPtr<Object> CreateObject(StringHash objectType);
+    /// Return the factory for an object type or null if not registered. The pointer stays valid until the factory
+    /// is removed; spawn-heavy code should resolve it once and create objects through it directly, skipping the
+    /// per-creation hash lookup.
+    ObjectFactory* GetFactory(StringHash objectType) const;
+    /// Template version of returning an object factory.
+    template <class T> ObjectFactory* GetFactory() const { return GetFactory(T::GetTypeStatic()); }
+    /// Reserve memory for a pooled object of given type. Creates the pool on first use. Thread-safe.
+    static void* AllocateFromObjectPool(StringHash objectType, unsigned size);
+    /// Return memory of a pooled object to the pool of given type. Thread-safe.
+    static void FreeToObjectPool(StringHash objectType, void* ptr);
     /// Register a factory for an object type.
     void RegisterFactory(ObjectFactory* factory);
     /// Register a factory for an object type and specify the object category.
@@ -106,6 +119,12 @@ public:
     void UpdateAttributeDefaultValue(StringHash objectType, const char* name, const Variant& defaultValue);
     /// Return a preallocated map for event data. Used for optimization to avoid constant re-allocation of event data maps.
     VariantMap& GetEventDataMap();
+    /// Return the frame-scoped linear arena, which is reset at the end of each frame.
+    FrameArena* GetFrameArena() const { return frameArena_.get(); }
+    /// Queue an event to be sent by the given sender when cross-thread events are next processed. Lock-free, may be called from any thread.
+    void QueueCrossThreadEvent(Object* sender, StringHash eventType, const VariantMap& eventData);
+    /// Send all queued cross-thread events in submission order. Must be called from the main thread; done automatically at frame start.
+    void ProcessCrossThreadEvents();
     /// Initialises the specified SDL systems, if not already. Returns true if successful. This call must be matched with ReleaseSDL() when SDL functions are no longer required, even if this call fails.
     bool RequireSDL(unsigned int sdlFlags);
     /// Indicate that you are done with using SDL. Must be called after using RequireSDL().
@@ -195,6 +214,9 @@ public:
     /// Return all registered attributes.
     const ea::unordered_map<StringHash, ea::vector<AttributeInfo> >& GetAllAttributes() const { return attributes_; }
 
+    /// Return index of an attribute for an object type by name hash, or M_MAX_UNSIGNED if not found. The per-type lookup table is built on first query and reused until the type's attributes are modified.
+    unsigned GetAttributeIndex(StringHash objectType, StringHash nameHash) const;
+
     /// Return event receivers for a sender and event type, or null if they do not exist.
     EventReceiverGroup* GetEventReceivers(Object* sender, StringHash eventType)
     {
@@ -314,10 +336,25 @@ private:
     ea::unordered_map<StringHash, ea::vector<AttributeInfo> > attributes_;
     /// Network replication attribute descriptions per object type.
     ea::unordered_map<StringHash, ea::vector<AttributeInfo> > networkAttributes_;
+    /// Attribute name hash to index lookup tables per object type. Built lazily by GetAttributeIndex(), invalidated whenever a type's attributes change.
+    mutable ea::unordered_map<StringHash, ea::unordered_map<StringHash, unsigned> > attributeIndexTables_;
     /// Event receivers for non-specific events.
     ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
     /// Event receivers for specific senders' events.
     ea::unordered_map<Object*, ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > > specificEventReceivers_;
+    /// Queued cross-thread event. Node of a lock-free multi-producer single-consumer list.
+    struct QueuedEvent
+    {
+        /// Next queued event.
+        std::atomic<QueuedEvent*> next_{};
+        /// Event sender.
+        WeakPtr<Object> sender_;
+        /// Event type.
+        StringHash eventType_;
+        /// Event parameters.
+        VariantMap eventData_;
+    };
+
     /// Event sender stack.
     ea::vector<Object*> eventSenders_;
     /// Event data stack.
@@ -328,6 +365,12 @@ private:
     ea::unordered_map<ea::string, ea::vector<StringHash> > objectCategories_;
     /// Variant map for global variables that can persist throughout application execution.
     VariantMap globalVars_;
+    /// Frame-scoped linear arena.
+    ea::unique_ptr<FrameArena> frameArena_;
+    /// Push end of the cross-thread event queue.
+    std::atomic<QueuedEvent*> crossThreadEventHead_{};
+    /// Consume end of the cross-thread event queue. Accessed only by the main thread.
+    QueuedEvent* crossThreadEventTail_{};
 
     /// Cached pointer of engine susbsystem.
     WeakPtr<Engine> engine_;
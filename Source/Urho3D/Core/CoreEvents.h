@@ -34,6 +34,13 @@ URHO3D_EVENT(E_BEGINFRAME, BeginFrame)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Application-wide fixed-timestep logic update event. Sent zero or more times per rendered frame, before the
+/// variable-timestep update, when a fixed update frequency has been set on the Engine.
+URHO3D_EVENT(E_FIXEDUPDATE, FixedUpdate)
+{
+    URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
+}
+
 /// Application-wide logic update event.
 URHO3D_EVENT(E_UPDATE, Update)
 {
@@ -63,4 +70,12 @@ URHO3D_EVENT(E_ENDFRAME, EndFrame)
 {
 }
 
+/// Frame budget of a counter exceeded during the last frame.
+URHO3D_EVENT(E_FRAMEBUDGETEXCEEDED, FrameBudgetExceeded)
+{
+    URHO3D_PARAM(P_NAME, Name);                    // String
+    URHO3D_PARAM(P_VALUE, Value);                  // float (milliseconds)
+    URHO3D_PARAM(P_BUDGET, Budget);                // float (milliseconds)
+}
+
 }
@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/CoreEvents.h"
+#include "../Core/FrameBudget.h"
+#include "../Core/Mutex.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Return mutex guarding the global counter registry. Function-local so that it is valid during static initialization.
+static Mutex& GetCounterRegistryMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+/// Return the global counter registry. Counters are never unregistered, as they are function-local statics.
+static ea::vector<FrameBudgetCounter*>& GetCounterRegistry()
+{
+    static ea::vector<FrameBudgetCounter*> registry;
+    return registry;
+}
+
+FrameBudgetCounter::FrameBudgetCounter(const char* name) :
+    name_(name)
+{
+    MutexLock lock(GetCounterRegistryMutex());
+    GetCounterRegistry().push_back(this);
+}
+
+FrameBudget::FrameBudget(Context* context) :
+    Object(context)
+{
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(FrameBudget, HandleBeginFrame));
+}
+
+void FrameBudget::SetBudget(const ea::string& name, float maxMs)
+{
+    if (maxMs > 0.0f)
+        budgets_[name] = maxMs;
+    else
+        budgets_.erase(name);
+}
+
+float FrameBudget::GetBudget(const ea::string& name) const
+{
+    auto i = budgets_.find(name);
+    return i != budgets_.end() ? i->second : 0.0f;
+}
+
+float FrameBudget::GetLastFrameMs(const ea::string& name) const
+{
+    for (const FrameBudgetInfo& counter : counters_)
+    {
+        if (name == counter.name_)
+            return counter.lastFrameMs_;
+    }
+    return 0.0f;
+}
+
+void FrameBudget::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    counters_.clear();
+
+    {
+        MutexLock lock(GetCounterRegistryMutex());
+        const ea::vector<FrameBudgetCounter*>& registry = GetCounterRegistry();
+        counters_.reserve(registry.size());
+
+        for (FrameBudgetCounter* counter : registry)
+        {
+            FrameBudgetInfo info;
+            info.name_ = counter->GetName();
+            info.lastFrameMs_ = (float)counter->Collect() / 1000.0f;
+            info.budgetMs_ = GetBudget(info.name_);
+            counters_.push_back(info);
+        }
+    }
+
+    // Send the events outside of the registry lock, as handlers may start new samples
+    for (const FrameBudgetInfo& counter : counters_)
+    {
+        if (counter.budgetMs_ > 0.0f && counter.lastFrameMs_ > counter.budgetMs_)
+        {
+            using namespace FrameBudgetExceeded;
+
+            VariantMap& newEventData = GetEventDataMap();
+            newEventData[P_NAME] = counter.name_;
+            newEventData[P_VALUE] = counter.lastFrameMs_;
+            newEventData[P_BUDGET] = counter.budgetMs_;
+            SendEvent(E_FRAMEBUDGETEXCEEDED, newEventData);
+        }
+    }
+}
+
+}
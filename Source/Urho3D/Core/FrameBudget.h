@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Core/Timer.h"
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+/// Named counter that accumulates time spent within URHO3D_FRAME_BUDGET scopes during a frame.
+/// Counters register themselves globally on construction and are collected by the FrameBudget subsystem
+/// at the start of each frame. Always enabled, unlike the Tracy-based profiler macros.
+class URHO3D_API FrameBudgetCounter
+{
+public:
+    /// Construct and register. The name must be a string literal or otherwise outlive the counter.
+    explicit FrameBudgetCounter(const char* name);
+
+    /// Accumulate elapsed time. Thread-safe.
+    void Add(long long usec) { accumulated_.fetch_add(usec, std::memory_order_relaxed); }
+    /// Return the accumulated time and reset the counter. Called by the FrameBudget subsystem at frame start.
+    long long Collect() { return accumulated_.exchange(0, std::memory_order_relaxed); }
+    /// Return counter name.
+    const char* GetName() const { return name_; }
+
+private:
+    /// Counter name.
+    const char* name_;
+    /// Time accumulated during the current frame in microseconds.
+    std::atomic<long long> accumulated_{0};
+};
+
+/// Scoped timer that adds the elapsed time to a frame budget counter on destruction.
+class URHO3D_API FrameBudgetSample
+{
+public:
+    /// Construct with counter to accumulate into.
+    explicit FrameBudgetSample(FrameBudgetCounter& counter) : counter_(counter) {}
+    /// Destruct and accumulate the elapsed time.
+    ~FrameBudgetSample() { counter_.Add(timer_.GetUSec(false)); }
+
+private:
+    /// Destination counter.
+    FrameBudgetCounter& counter_;
+    /// Elapsed time timer.
+    HiresTimer timer_;
+};
+
+/// Per-frame counter statistics collected by the FrameBudget subsystem.
+struct FrameBudgetInfo
+{
+    /// Counter name.
+    const char* name_{};
+    /// Time accumulated during the last frame in milliseconds.
+    float lastFrameMs_{};
+    /// Budget threshold in milliseconds, 0 if no budget is set.
+    float budgetMs_{};
+};
+
+/// Frame budget tracking subsystem. Collects URHO3D_FRAME_BUDGET counters once per frame and sends
+/// E_FRAMEBUDGETEXCEEDED when a counter with a configured budget goes over it.
+class URHO3D_API FrameBudget : public Object
+{
+    URHO3D_OBJECT(FrameBudget, Object);
+
+public:
+    /// Construct.
+    explicit FrameBudget(Context* context);
+
+    /// Set budget threshold for a named counter in milliseconds. Zero removes the budget.
+    void SetBudget(const ea::string& name, float maxMs);
+    /// Return budget threshold of a named counter in milliseconds, or 0 if no budget is set.
+    float GetBudget(const ea::string& name) const;
+    /// Return time accumulated by a named counter during the last frame in milliseconds, or 0 if the counter is unknown.
+    float GetLastFrameMs(const ea::string& name) const;
+    /// Return statistics of all counters for the last frame.
+    const ea::vector<FrameBudgetInfo>& GetCounters() const { return counters_; }
+
+private:
+    /// Handle begin frame. Collect the counters accumulated during the previous frame and check budgets.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+
+    /// Statistics of all counters for the last frame.
+    ea::vector<FrameBudgetInfo> counters_;
+    /// Budget thresholds by counter name in milliseconds.
+    ea::unordered_map<ea::string, float> budgets_;
+};
+
+}
+
+/// Accumulate the time spent in the enclosing scope into a named frame budget counter. Only one per scope.
+#define URHO3D_FRAME_BUDGET(name) \
+    static Urho3D::FrameBudgetCounter frameBudgetCounter(name); \
+    Urho3D::FrameBudgetSample frameBudgetSample(frameBudgetCounter)
@@ -26,6 +26,7 @@
 #   include "Urho3D/WindowsSupport.h"
 #else
 #   include <mutex>
+#   include <shared_mutex>
 #endif
 
 #include <Urho3D/Urho3D.h>
@@ -77,6 +78,50 @@ private:
     MutexType lock_;
 };
 
+#if _WIN32
+namespace Detail
+{
+struct URHO3D_API SlimReadWriteLock
+{
+    /// Construct.
+    inline SlimReadWriteLock() noexcept { InitializeSRWLock(&lock_); }
+
+    /// Acquire the lock exclusively. Block while held by anyone else.
+    inline void lock() { AcquireSRWLockExclusive(&lock_); }
+    /// Release the exclusive lock.
+    inline void unlock() { ReleaseSRWLockExclusive(&lock_); }
+    /// Acquire the lock in shared mode. Block while exclusively held.
+    inline void lock_shared() { AcquireSRWLockShared(&lock_); }
+    /// Release the shared lock.
+    inline void unlock_shared() { ReleaseSRWLockShared(&lock_); }
+
+private:
+    SRWLOCK lock_;
+};
+}
+using SharedMutexType = Detail::SlimReadWriteLock;
+#else
+using SharedMutexType = std::shared_mutex;
+#endif
+
+/// Reader-writer mutual exclusion primitive. Multiple readers may hold the mutex simultaneously, writers are exclusive. Not recursive.
+class URHO3D_API RWMutex
+{
+public:
+    /// Acquire the mutex in shared mode. Block while a writer holds it.
+    void AcquireRead() { lock_.lock_shared(); }
+    /// Release the mutex held in shared mode.
+    void ReleaseRead() { lock_.unlock_shared(); }
+    /// Acquire the mutex exclusively. Block while any reader or another writer holds it.
+    void AcquireWrite() { lock_.lock(); }
+    /// Release the exclusively held mutex.
+    void ReleaseWrite() { lock_.unlock(); }
+
+private:
+    /// Underlying mutex object.
+    SharedMutexType lock_;
+};
+
 #if URHO3D_PROFILING
 class URHO3D_API ProfiledMutex
 {
@@ -114,4 +159,32 @@ private:
     Mutex& mutex_;
 };
 
+/// Lock that automatically acquires and releases a reader-writer mutex in shared mode.
+class ReadLock : private NonCopyable
+{
+public:
+    /// Construct and acquire the mutex in shared mode.
+    explicit ReadLock(RWMutex& mutex) : mutex_(mutex) { mutex_.AcquireRead(); }
+    /// Destruct. Release the mutex.
+    ~ReadLock() { mutex_.ReleaseRead(); }
+
+private:
+    /// Mutex reference.
+    RWMutex& mutex_;
+};
+
+/// Lock that automatically acquires and releases a reader-writer mutex in exclusive mode.
+class WriteLock : private NonCopyable
+{
+public:
+    /// Construct and acquire the mutex exclusively.
+    explicit WriteLock(RWMutex& mutex) : mutex_(mutex) { mutex_.AcquireWrite(); }
+    /// Destruct. Release the mutex.
+    ~WriteLock() { mutex_.ReleaseWrite(); }
+
+private:
+    /// Mutex reference.
+    RWMutex& mutex_;
+};
+
 }
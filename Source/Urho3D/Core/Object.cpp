@@ -312,6 +312,16 @@ void Object::SendEvent(StringHash eventType)
     SendEvent(eventType, noEventData);
 }
 
+bool Object::HasEventReceivers(StringHash eventType)
+{
+    EventReceiverGroup* group = context_->GetEventReceivers(eventType);
+    if (group && !group->receivers_.empty())
+        return true;
+
+    EventReceiverGroup* specificGroup = context_->GetEventReceivers(this, eventType);
+    return specificGroup && !specificGroup->receivers_.empty();
+}
+
 void Object::SendEvent(StringHash eventType, VariantMap& eventData)
 {
     if (!Thread::IsMainThread())
@@ -507,6 +517,16 @@ void Object::SendEvent(StringHash eventType, const VariantMap& eventData)
     SendEvent(eventType, eventDataCopy);
 }
 
+void Object::QueueEvent(StringHash eventType)
+{
+    context_->QueueCrossThreadEvent(this, eventType, VariantMap());
+}
+
+void Object::QueueEvent(StringHash eventType, const VariantMap& eventData)
+{
+    context_->QueueCrossThreadEvent(this, eventType, eventData);
+}
+
 template <> Engine* Object::GetSubsystem<Engine>() const
 {
     return context_->engine_;
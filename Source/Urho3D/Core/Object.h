@@ -108,6 +108,31 @@ private:
         static const ea::string& GetTypeNameStatic() { return GetTypeInfoStatic()->GetTypeName(); } \
         static const Urho3D::TypeInfo* GetTypeInfoStatic() { static const Urho3D::TypeInfo typeInfoStatic(#typeName, BaseClassName::GetTypeInfoStatic()); return &typeInfoStatic; } \
 
+/// Declare pooled allocation for an object class. Place inside the class definition and pair with
+/// URHO3D_DEFINE_OBJECT_POOL in the translation unit. Instances are carved from a chunked fixed-size pool
+/// registered in Context, so that objects of the same type stay contiguous in memory and systems iterating
+/// a whole type stream memory linearly. Pointers remain stable; subclasses fall back to the heap.
+#define URHO3D_OBJECT_POOL(typeName) \
+    public: \
+        static void* operator new(std::size_t size); \
+        static void operator delete(void* ptr, std::size_t size); \
+
+/// Define pooled allocation operators declared with URHO3D_OBJECT_POOL.
+#define URHO3D_DEFINE_OBJECT_POOL(typeName) \
+    void* typeName::operator new(std::size_t size) \
+    { \
+        if (size != sizeof(typeName)) \
+            return ::operator new(size); \
+        return Urho3D::Context::AllocateFromObjectPool(typeName::GetTypeStatic(), (unsigned)size); \
+    } \
+    void typeName::operator delete(void* ptr, std::size_t size) \
+    { \
+        if (size != sizeof(typeName)) \
+            ::operator delete(ptr); \
+        else \
+            Urho3D::Context::FreeToObjectPool(typeName::GetTypeStatic(), ptr); \
+    } \
+
 /// Base class for objects with type identification, subsystem access and event sending/receiving capability.
 class URHO3D_API Object : public RefCounted
 {
@@ -174,6 +199,8 @@ public:
     void SendEvent(StringHash eventType);
     /// Send event with parameters to all subscribers.
     void SendEvent(StringHash eventType, VariantMap& eventData);
+    /// Return whether any receivers are subscribed to given event, either without specific sender or with this object as sender. Can be used to skip expensive event data preparation.
+    bool HasEventReceivers(StringHash eventType);
     /// Return a preallocated map for event data. Used for optimization to avoid constant re-allocation of event data maps.
     VariantMap& GetEventDataMap() const;
     /// Send event with variadic parameter pairs to all subscribers. The parameter pairs is a list of paramID and paramValue separated by comma, one pair after another.
@@ -211,6 +238,10 @@ public:
 
     /// Send event with parameters to all subscribers.
     void SendEvent(StringHash eventType, const VariantMap& eventData);
+    /// Queue an event to be sent from the main thread when cross-thread events are next processed, normally at frame start. Lock-free, may be called from any thread.
+    void QueueEvent(StringHash eventType);
+    /// Queue an event with parameters to be sent from the main thread when cross-thread events are next processed, normally at frame start. Lock-free, may be called from any thread.
+    void QueueEvent(StringHash eventType, const VariantMap& eventData);
     /// Block object from sending and receiving events.
     void SetBlockEvents(bool block) { blockEvents_ = block; }
     /// Return sending and receiving events blocking status.
@@ -426,7 +457,7 @@ inline void Object::SubscribeToEvent(Object* sender, StringHash eventType, void(
 URHO3D_API StringHashRegister& GetEventNameRegister();
 
 /// Describe an event's hash ID and begin a namespace in which to define its parameters.
-#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(#eventName)); namespace eventName
+#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(Urho3D::StringHash(#eventName), #eventName)); namespace eventName
 /// Describe an event's parameter hash ID. Should be used inside an event namespace.
 #define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID = #paramName
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function.
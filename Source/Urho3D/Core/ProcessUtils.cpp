@@ -517,6 +517,87 @@ unsigned GetNumLogicalCPUs()
 #endif
 }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+/// Parse a sysfs CPU list such as "0-7,16-23" into an affinity mask covering the first 64 logical CPUs.
+static unsigned long long ParseCPUListMask(FILE* fp)
+{
+    unsigned long long mask = 0;
+    unsigned first, last;
+    int c;
+    while (fscanf(fp, "%u", &first) == 1)                           // NOLINT(cert-err34-c)
+    {
+        last = first;
+        c = fgetc(fp);
+        if (c == '-')
+        {
+            if (fscanf(fp, "%u", &last) != 1)                       // NOLINT(cert-err34-c)
+                break;
+            c = fgetc(fp);
+        }
+        for (unsigned i = first; i <= last && i < 64; ++i)
+            mask |= 1ull << i;
+        if (c != ',')
+            break;
+    }
+    return mask;
+}
+#endif
+
+unsigned GetNumNUMANodes()
+{
+#if defined(_WIN32)
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode))
+        return (unsigned)highestNode + 1;
+    return 1;
+#elif defined(__linux__) && !defined(__ANDROID__)
+    unsigned numNodes = 0;
+    for (;;)
+    {
+        char path[64];
+        sprintf(path, "/sys/devices/system/node/node%u/cpulist", numNodes);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            break;
+        fclose(fp);
+        ++numNodes;
+    }
+    return Max(numNodes, 1U);
+#else
+    return 1;
+#endif
+}
+
+unsigned long long GetNUMANodeCPUMask(unsigned node)
+{
+#if defined(_WIN32)
+    ULONGLONG processorMask = 0;
+    if (GetNumaNodeProcessorMask((UCHAR)node, &processorMask))
+        return (unsigned long long)processorMask;
+    return 0;
+#elif defined(__linux__) && !defined(__ANDROID__)
+    char path[64];
+    sprintf(path, "/sys/devices/system/node/node%u/cpulist", node);
+    FILE* fp = fopen(path, "r");
+    if (fp)
+    {
+        unsigned long long mask = ParseCPUListMask(fp);
+        fclose(fp);
+        return mask;
+    }
+    // Fall through to the single-node mask when sysfs does not expose NUMA topology
+    if (node != 0)
+        return 0;
+    const unsigned numCPUs = Min(GetNumLogicalCPUs(), 64U);
+    return numCPUs == 64 ? ~0ull : (1ull << numCPUs) - 1;
+#else
+    if (node != 0)
+        return 0;
+    const unsigned numCPUs = Min(GetNumLogicalCPUs(), 64U);
+    return numCPUs == 64 ? ~0ull : (1ull << numCPUs) - 1;
+#endif
+}
+
 void SetMiniDumpDir(const ea::string& pathName)
 {
     miniDumpDir = AddTrailingSlash(pathName);
@@ -75,6 +75,10 @@ URHO3D_API ea::string GetPlatform();
 URHO3D_API unsigned GetNumPhysicalCPUs();
 /// Return the number of logical CPUs (different from physical if hyperthreading is used).
 URHO3D_API unsigned GetNumLogicalCPUs();
+/// Return the number of NUMA memory nodes. Return 1 on platforms without NUMA topology information.
+URHO3D_API unsigned GetNumNUMANodes();
+/// Return the logical CPU affinity mask of a NUMA node, covering the first 64 logical CPUs. Return zero for an invalid node.
+URHO3D_API unsigned long long GetNUMANodeCPUMask(unsigned node);
 /// Set minidump write location as an absolute path. If empty, uses default (UserProfile/AppData/Roaming/urho3D/crashdumps) Minidumps are only supported on MSVC compiler.
 URHO3D_API void SetMiniDumpDir(const ea::string& pathName);
 /// Return minidump write location.
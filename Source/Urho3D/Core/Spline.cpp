@@ -55,6 +55,14 @@ Spline::Spline(const ea::vector<Variant>& knots, InterpolationMode mode) :
 
 Variant Spline::GetPoint(float f) const
 {
+    // Baked: one lerp between the two nearest uniform samples
+    if (!bakedKnots_.empty())
+    {
+        const float pos = Clamp(f, 0.0f, 1.0f) * (float)(bakedKnots_.size() - 1);
+        const unsigned index = Min((unsigned)pos, (unsigned)bakedKnots_.size() - 2);
+        return LinearInterpolation(bakedKnots_[index], bakedKnots_[index + 1], pos - (float)index);
+    }
+
     if (knots_.size() < 2)
         return knots_.size() == 1 ? knots_[0] : Variant::EMPTY;
 
@@ -101,8 +109,26 @@ Variant Spline::GetPoint(float f) const
     }
 }
 
+void Spline::Bake(unsigned numSamples)
+{
+    bakedKnots_.clear();
+    if (knots_.size() < 2)
+        return;
+
+    // Sample into a separate vector, as GetPoint() must evaluate the original curve while baking
+    numSamples = Max(numSamples, 2u);
+    VariantVector samples;
+    samples.reserve(numSamples);
+    for (unsigned i = 0; i < numSamples; ++i)
+        samples.push_back(GetPoint((float)i / (float)(numSamples - 1)));
+
+    bakedKnots_ = ea::move(samples);
+}
+
 void Spline::SetKnot(const Variant& knot, unsigned index)
 {
+    bakedKnots_.clear();
+
     if (index < knots_.size())
     {
         if (knots_.size() > 0 && knots_[0].GetType() == knot.GetType())
@@ -117,6 +143,8 @@ void Spline::SetKnot(const Variant& knot, unsigned index)
 
 void Spline::AddKnot(const Variant& knot)
 {
+    bakedKnots_.clear();
+
     if (knots_.size() > 0 && knots_[0].GetType() == knot.GetType())
         knots_.push_back(knot);
     else if (knots_.empty())
@@ -128,6 +156,8 @@ void Spline::AddKnot(const Variant& knot)
 
 void Spline::AddKnot(const Variant& knot, unsigned index)
 {
+    bakedKnots_.clear();
+
     if (index > knots_.size())
         index = knots_.size();
 
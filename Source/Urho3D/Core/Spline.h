@@ -85,11 +85,26 @@ public:
     /// Return the T of the point of the spline at f from 0.f - 1.f.
     Variant GetPoint(float f) const;
 
+    /// Bake the spline into uniformly spaced samples so that GetPoint() becomes a single lerp instead of a
+    /// full basis evaluation. Baking approximates the curve between samples and is cleared by any modification.
+    void Bake(unsigned numSamples);
+
+    /// Return whether the spline has been baked.
+    bool IsBaked() const { return !bakedKnots_.empty(); }
+
     /// Set the interpolation mode.
-    void SetInterpolationMode(InterpolationMode interpolationMode) { interpolationMode_ = interpolationMode; }
+    void SetInterpolationMode(InterpolationMode interpolationMode)
+    {
+        interpolationMode_ = interpolationMode;
+        bakedKnots_.clear();
+    }
 
     /// Set the knots of the spline.
-    void SetKnots(const ea::vector<Variant>& knots) { knots_ = knots; }
+    void SetKnots(const ea::vector<Variant>& knots)
+    {
+        knots_ = knots;
+        bakedKnots_.clear();
+    }
 
     /// Set the value of an existing knot.
     void SetKnot(const Variant& knot, unsigned index);
@@ -99,13 +114,25 @@ public:
     void AddKnot(const Variant& knot, unsigned index);
 
     /// Remove the last knot on the spline.
-    void RemoveKnot() { knots_.pop_back(); }
+    void RemoveKnot()
+    {
+        knots_.pop_back();
+        bakedKnots_.clear();
+    }
 
     /// Remove the knot at the specific index.
-    void RemoveKnot(unsigned index) { knots_.erase_at(index); }
+    void RemoveKnot(unsigned index)
+    {
+        knots_.erase_at(index);
+        bakedKnots_.clear();
+    }
 
     /// Clear the spline.
-    void Clear() { knots_.clear(); }
+    void Clear()
+    {
+        knots_.clear();
+        bakedKnots_.clear();
+    }
 
 private:
     /// Perform Bezier interpolation on the spline.
@@ -121,6 +148,8 @@ private:
     InterpolationMode interpolationMode_;
     /// Knots on the spline.
     VariantVector knots_;
+    /// Uniformly sampled points when baked. Always holds at least two samples when non-empty.
+    VariantVector bakedKnots_;
 };
 
 }
@@ -33,7 +33,8 @@
 namespace Urho3D
 {
 
-StringHashRegister::StringHashRegister(bool threadSafe)
+StringHashRegister::StringHashRegister(bool threadSafe) :
+    map_(std::make_shared<const StringMap>())
 {
     if (threadSafe)
         mutex_ = ea::make_unique<Mutex>();
@@ -47,18 +48,31 @@ StringHashRegister::~StringHashRegister()       // NOLINT(hicpp-use-equals-defau
 
 StringHash StringHashRegister::RegisterString(const StringHash& hash, ea::string_view string)
 {
+    // Fast lock-free path for already registered strings, which are the common case
+    {
+        const std::shared_ptr<const StringMap> map = GetSnapshot();
+        auto iter = map->find(hash);
+        if (iter != map->end())
+        {
+            if (ea::string_view(iter->second) != string)
+            {
+                URHO3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s",
+                    string, iter->second.c_str(), hash.ToString().c_str());
+            }
+            return hash;
+        }
+    }
+
     if (mutex_)
         mutex_->Acquire();
 
-    auto iter = map_.find(hash);
-    if (iter == map_.end())
+    // Re-check under the mutex, then publish a new snapshot so that readers never observe a rehashing map
+    const std::shared_ptr<const StringMap> map = GetSnapshot();
+    if (map->find(hash) == map->end())
     {
-        map_.populate(hash, ea::string(string));
-    }
-    else if (ea::string_view(iter->second) != string)
-    {
-        URHO3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s",
-            string, iter->second.c_str(), hash.ToString().c_str());
+        auto newMap = std::make_shared<StringMap>(*map);
+        newMap->populate(hash, ea::string(string));
+        std::atomic_store_explicit(&map_, std::shared_ptr<const StringMap>(ea::move(newMap)), std::memory_order_release);
     }
 
     if (mutex_)
@@ -75,34 +89,33 @@ StringHash StringHashRegister::RegisterString(ea::string_view string)
 
 ea::string StringHashRegister::GetStringCopy(const StringHash& hash) const
 {
-    if (mutex_)
-        mutex_->Acquire();
-
-    const ea::string copy = GetString(hash);
-
-    if (mutex_)
-        mutex_->Release();
-
-    return copy;
+    // The snapshot keeps the string alive while copying, no lock needed
+    const std::shared_ptr<const StringMap> map = GetSnapshot();
+    auto iter = map->find(hash);
+    return iter == map->end() ? EMPTY_STRING : iter->second;
 }
 
 bool StringHashRegister::Contains(const StringHash& hash) const
 {
-    if (mutex_)
-        mutex_->Acquire();
-
-    const bool contains = map_.contains(hash);
+    const std::shared_ptr<const StringMap> map = GetSnapshot();
+    return map->contains(hash);
+}
 
-    if (mutex_)
-        mutex_->Release();
+const ea::string& StringHashRegister::GetString(const StringHash& hash) const
+{
+    const std::shared_ptr<const StringMap> map = GetSnapshot();
+    auto iter = map->find(hash);
+    return iter == map->end() ? EMPTY_STRING : iter->second;
+}
 
-    return contains;
+const StringMap& StringHashRegister::GetInternalMap() const
+{
+    return *GetSnapshot();
 }
 
-const ea::string& StringHashRegister::GetString(const StringHash& hash) const
+std::shared_ptr<const StringMap> StringHashRegister::GetSnapshot() const
 {
-    auto iter = map_.find(hash);
-    return iter == map_.end() ? EMPTY_STRING : iter->second;
+    return std::atomic_load_explicit(&map_, std::memory_order_acquire);
 }
 
 }
@@ -24,6 +24,8 @@
 
 #include <EASTL/unique_ptr.h>
 
+#include <memory>
+
 #include "../Container/Str.h"
 #include "../Core/Variant.h"
 #include "../Math/StringHash.h"
@@ -55,12 +57,15 @@ public:
     /// Return String for given StringHash. Return value is unsafe to use if RegisterString is called from other threads.
     const ea::string& GetString(const StringHash& hash) const;
     /// Return map of hashes. Return value is unsafe to use if RegisterString is called from other threads.
-    const StringMap& GetInternalMap() const { return map_; }
+    const StringMap& GetInternalMap() const;
 
 private:
-    /// Hash to string map.
-    StringMap map_;
-    /// Mutex.
+    /// Return the current map snapshot without locking.
+    std::shared_ptr<const StringMap> GetSnapshot() const;
+
+    /// Hash to string map. Published as an immutable snapshot: readers load it lock-free, RegisterString replaces it under the mutex.
+    std::shared_ptr<const StringMap> map_;
+    /// Mutex serializing registrations.
     ea::unique_ptr<Mutex> mutex_;
 };
 
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/TaskGraph.h"
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+
+namespace Urho3D
+{
+
+TaskGraph::TaskGraph(Context* context) :
+    Object(context),
+    workQueue_(GetSubsystem<WorkQueue>())
+{
+}
+
+TaskGraph::~TaskGraph() = default;
+
+TaskGraph::TaskId TaskGraph::AddTask(std::function<void(unsigned)> work)
+{
+    auto task = ea::make_unique<Task>();
+    task->graph_ = this;
+    task->work_ = std::move(work);
+    task->item_ = new WorkItem();
+    task->item_->workFunction_ = &TaskGraph::ExecuteTask;
+    task->item_->aux_ = task.get();
+    task->item_->priority_ = M_MAX_UNSIGNED;
+
+    tasks_.push_back(std::move(task));
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::AddDependency(TaskId task, TaskId dependsOn)
+{
+    if (task >= tasks_.size() || dependsOn >= tasks_.size() || task == dependsOn)
+    {
+        URHO3D_LOGERROR("Invalid task dependency");
+        return;
+    }
+
+    tasks_[dependsOn]->successors_.push_back(task);
+    ++tasks_[task]->numDependencies_;
+}
+
+void TaskGraph::Execute()
+{
+    if (tasks_.empty())
+        return;
+
+    for (const auto& task : tasks_)
+    {
+        task->remainingDependencies_.store((int)task->numDependencies_, std::memory_order_relaxed);
+        task->item_->completed_ = false;
+    }
+    remainingTasks_.store(tasks_.size(), std::memory_order_release);
+
+    // Make sure workers are running, then release the roots
+    workQueue_->Resume();
+    for (const auto& task : tasks_)
+    {
+        if (task->numDependencies_ == 0)
+            workQueue_->PostInternal(task->item_, 0);
+    }
+
+    // Assist with execution until the whole graph has retired
+    while (remainingTasks_.load(std::memory_order_acquire) != 0)
+    {
+        if (!workQueue_->ExecuteOneItem(0))
+            Time::Sleep(0);
+    }
+}
+
+void TaskGraph::Clear()
+{
+    tasks_.clear();
+}
+
+void TaskGraph::ExecuteTask(const WorkItem* item, unsigned threadIndex)
+{
+    auto* task = static_cast<Task*>(item->aux_);
+    task->work_(threadIndex);
+    task->graph_->OnTaskCompleted(*task, threadIndex);
+}
+
+void TaskGraph::OnTaskCompleted(Task& task, unsigned threadIndex)
+{
+    for (TaskId successorId : task.successors_)
+    {
+        Task& successor = *tasks_[successorId];
+        if (successor.remainingDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            workQueue_->PostInternal(successor.item_, threadIndex);
+    }
+
+    remainingTasks_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+}
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+#include <atomic>
+
+#include "../Core/Object.h"
+#include "../Core/WorkQueue.h"
+
+namespace Urho3D
+{
+
+/// Graph of dependent tasks executed on the WorkQueue. A task starts as soon as all of its
+/// predecessors have retired, which lets phases such as culling, light processing and batch
+/// sorting overlap instead of draining at global Complete() barriers. The graph structure is
+/// reusable: build it once, then call Execute() every frame.
+class URHO3D_API TaskGraph : public Object
+{
+    URHO3D_OBJECT(TaskGraph, Object);
+
+public:
+    /// Task handle.
+    using TaskId = unsigned;
+
+    /// Construct.
+    explicit TaskGraph(Context* context);
+    /// Destruct.
+    ~TaskGraph() override;
+
+    /// Add a task. The function is called with the executing thread index (0 = main thread). Return the task handle.
+    TaskId AddTask(std::function<void(unsigned)> work);
+    /// Declare that a task may start only after another task has completed. The graph must stay acyclic.
+    void AddDependency(TaskId task, TaskId dependsOn);
+    /// Execute all tasks and block until the whole graph has retired. The calling thread assists with execution. Must be called from the main thread.
+    void Execute();
+    /// Remove all tasks and dependencies.
+    void Clear();
+
+    /// Return number of tasks.
+    unsigned GetNumTasks() const { return tasks_.size(); }
+
+private:
+    /// Task state.
+    struct Task
+    {
+        /// Owning graph.
+        TaskGraph* graph_{};
+        /// Work function.
+        std::function<void(unsigned)> work_;
+        /// Tasks that depend on this task.
+        ea::vector<TaskId> successors_;
+        /// Number of predecessor tasks.
+        unsigned numDependencies_{};
+        /// Predecessors not yet retired during the current execution.
+        std::atomic<int> remainingDependencies_{};
+        /// Work item posted to the queue when the task becomes ready.
+        SharedPtr<WorkItem> item_;
+    };
+
+    /// Work item function: execute the task and retire it.
+    static void ExecuteTask(const WorkItem* item, unsigned threadIndex);
+    /// Retire a task: release its successors and post the ones that became ready.
+    void OnTaskCompleted(Task& task, unsigned threadIndex);
+
+    /// Work queue subsystem.
+    WorkQueue* workQueue_{};
+    /// Tasks in creation order.
+    ea::vector<ea::unique_ptr<Task> > tasks_;
+    /// Tasks not yet retired during the current execution.
+    std::atomic<unsigned> remainingTasks_{};
+};
+
+}
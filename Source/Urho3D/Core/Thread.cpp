@@ -190,6 +190,30 @@ void Thread::SetPriority(int priority)
 #endif // URHO3D_THREADING
 }
 
+bool Thread::SetAffinity(unsigned long long coreMask)
+{
+#ifdef URHO3D_THREADING
+#ifdef _WIN32
+    if (handle_)
+        return SetThreadAffinityMask((HANDLE)handle_, (DWORD_PTR)coreMask) != 0;
+#elif defined(__linux__) && !defined(__ANDROID__) && !defined(__EMSCRIPTEN__)
+    auto thread = (pthread_t)handle_;
+    if (thread)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (unsigned i = 0; i < sizeof(coreMask) * 8; ++i)
+        {
+            if (coreMask & (1ull << i))
+                CPU_SET(i, &cpuSet);
+        }
+        return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+    }
+#endif
+#endif // URHO3D_THREADING
+    return false;
+}
+
 void Thread::SetMainThread()
 {
     mainThreadID = GetCurrentThreadID();
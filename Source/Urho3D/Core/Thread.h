@@ -54,6 +54,8 @@ public:
     void Stop();
     /// Set thread priority. The thread must have been started first.
     void SetPriority(int priority);
+    /// Set CPU core affinity of the thread on supported platforms. Each set bit in the mask allows the thread to run on the corresponding logical CPU. The thread must have been started first. Return true if successful.
+    bool SetAffinity(unsigned long long coreMask);
 
     /// Return whether thread exists.
     bool IsStarted() const { return handle_ != nullptr; }
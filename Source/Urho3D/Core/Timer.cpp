@@ -118,13 +118,19 @@ void Time::BeginFrame(float timeStep)
     {
         URHO3D_PROFILE("BeginFrame");
 
-        // Frame begin event
-        using namespace BeginFrame;
-
-        VariantMap& eventData = GetEventDataMap();
-        eventData[P_FRAMENUMBER] = frameNumber_;
-        eventData[P_TIMESTEP] = timeStep_;
-        SendEvent(E_BEGINFRAME, eventData);
+        // Invoke direct subscribers first, they bypass the event plumbing
+        onBeginFrame_(this, timeStep_);
+
+        // Frame begin event. Skip the event data packing when nobody is subscribed
+        if (HasEventReceivers(E_BEGINFRAME))
+        {
+            using namespace BeginFrame;
+
+            VariantMap& eventData = GetEventDataMap();
+            eventData[P_FRAMENUMBER] = frameNumber_;
+            eventData[P_TIMESTEP] = timeStep_;
+            SendEvent(E_BEGINFRAME, eventData);
+        }
     }
 }
 
@@ -133,11 +139,16 @@ void Time::EndFrame()
     {
         URHO3D_PROFILE("EndFrame");
 
+        // Invoke direct subscribers first, they bypass the event plumbing
+        onEndFrame_(this);
+
         // Frame end event
-        SendEvent(E_ENDFRAME);
+        if (HasEventReceivers(E_ENDFRAME))
+            SendEvent(E_ENDFRAME);
 
         // Internal frame end event used only by the engine/tools
-        SendEvent(E_ENDFRAMEPRIVATE);
+        if (HasEventReceivers(E_ENDFRAMEPRIVATE))
+            SendEvent(E_ENDFRAMEPRIVATE);
     }
 }
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Core/Object.h"
+#include "../Core/Signal.h"
 
 namespace Urho3D
 {
@@ -91,6 +92,12 @@ public:
     void BeginFrame(float timeStep);
     /// End frame. Increment total time and send frame end event.
     void EndFrame();
+
+    /// Sent at the beginning of a frame, before the begin frame event. Direct subscribers bypass the event plumbing; intended for engine-internal per-frame work.
+    Signal<float, Time> onBeginFrame_;
+    /// Sent at the end of a frame, before the end frame events. Direct subscribers bypass the event plumbing; intended for engine-internal per-frame work.
+    Signal<void, Time> onEndFrame_;
+
     /// Set the low-resolution timer period in milliseconds. 0 resets to the default period.
     void SetTimerPeriod(unsigned mSec);
 
@@ -139,6 +139,54 @@ Variant& Variant::operator =(const Variant& rhs)
     return *this;
 }
 
+Variant& Variant::operator =(Variant&& rhs)
+{
+    if (this == &rhs)
+        return *this;
+
+    switch (rhs.GetType())
+    {
+    case VAR_STRING:
+        SetType(VAR_STRING);
+        value_.string_ = ea::move(rhs.value_.string_);
+        break;
+
+    case VAR_BUFFER:
+        SetType(VAR_BUFFER);
+        value_.buffer_ = ea::move(rhs.value_.buffer_);
+        break;
+
+    case VAR_RESOURCEREFLIST:
+        SetType(VAR_RESOURCEREFLIST);
+        value_.resourceRefList_ = ea::move(rhs.value_.resourceRefList_);
+        break;
+
+    case VAR_VARIANTVECTOR:
+        SetType(VAR_VARIANTVECTOR);
+        value_.variantVector_ = ea::move(rhs.value_.variantVector_);
+        break;
+
+    case VAR_STRINGVECTOR:
+        SetType(VAR_STRINGVECTOR);
+        value_.stringVector_ = ea::move(rhs.value_.stringVector_);
+        break;
+
+    case VAR_VARIANTMAP:
+        // Steal the heap-allocated map; the source gets this variant's (possibly fresh) map and is then cleared
+        SetType(VAR_VARIANTMAP);
+        ea::swap(value_.variantMap_, rhs.value_.variantMap_);
+        break;
+
+    default:
+        // The remaining types are stored inline and are cheap to copy
+        *this = rhs;
+        return *this;
+    }
+
+    rhs.SetType(VAR_NONE);
+    return *this;
+}
+
 Variant& Variant::operator =(const VectorBuffer& rhs)
 {
     SetType(VAR_BUFFER);
@@ -512,6 +512,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from a string.
+    Variant(ea::string&& value)             // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a C string.
     Variant(const char* value)          // NOLINT(google-explicit-constructor)
     {
@@ -524,6 +530,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from a buffer.
+    Variant(VariantBuffer&& value)           // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a %VectorBuffer and store as a buffer.
     Variant(const VectorBuffer& value)  // NOLINT(google-explicit-constructor)
     {
@@ -548,24 +560,48 @@ public:
         *this = value;
     }
 
+    /// Move-construct from a resource reference list.
+    Variant(ResourceRefList&& value)        // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a variant vector.
     Variant(const VariantVector& value) // NOLINT(google-explicit-constructor)
     {
         *this = value;
     }
 
+    /// Move-construct from a variant vector.
+    Variant(VariantVector&& value)      // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a variant map.
     Variant(const VariantMap& value)    // NOLINT(google-explicit-constructor)
     {
         *this = value;
     }
 
+    /// Move-construct from a variant map.
+    Variant(VariantMap&& value)         // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a string vector.
     Variant(const StringVector& value)  // NOLINT(google-explicit-constructor)
     {
         *this = value;
     }
 
+    /// Move-construct from a string vector.
+    Variant(StringVector&& value)       // NOLINT(google-explicit-constructor)
+    {
+        *this = ea::move(value);
+    }
+
     /// Construct from a rect.
     Variant(const Rect& value)          // NOLINT(google-explicit-constructor)
     {
@@ -647,6 +683,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from another variant. The source variant is left empty.
+    Variant(Variant&& value)
+    {
+        *this = ea::move(value);
+    }
+
     /// Destruct.
     ~Variant()
     {
@@ -662,6 +704,9 @@ public:
     /// Assign from another variant.
     Variant& operator =(const Variant& rhs);
 
+    /// Move-assign from another variant. Heap-backed values are stolen without copying and the source variant is left empty.
+    Variant& operator =(Variant&& rhs);
+
     /// Assign from an integer.
     Variant& operator =(int rhs)
     {
@@ -774,6 +819,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a string.
+    Variant& operator =(ea::string&& rhs)
+    {
+        SetType(VAR_STRING);
+        value_.string_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a C string.
     Variant& operator =(const char* rhs)
     {
@@ -790,6 +843,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a buffer.
+    Variant& operator =(VariantBuffer&& rhs)
+    {
+        SetType(VAR_BUFFER);
+        value_.buffer_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a %VectorBuffer and store as a buffer.
     Variant& operator =(const VectorBuffer& rhs);
 
@@ -817,6 +878,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a resource reference list.
+    Variant& operator =(ResourceRefList&& rhs)
+    {
+        SetType(VAR_RESOURCEREFLIST);
+        value_.resourceRefList_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a variant vector.
     Variant& operator =(const VariantVector& rhs)
     {
@@ -825,6 +894,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a variant vector.
+    Variant& operator =(VariantVector&& rhs)
+    {
+        SetType(VAR_VARIANTVECTOR);
+        value_.variantVector_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a string vector.
     Variant& operator =(const StringVector& rhs)
     {
@@ -833,6 +910,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a string vector.
+    Variant& operator =(StringVector&& rhs)
+    {
+        SetType(VAR_STRINGVECTOR);
+        value_.stringVector_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a variant map.
     Variant& operator =(const VariantMap& rhs)
     {
@@ -841,6 +926,14 @@ public:
         return *this;
     }
 
+    /// Move-assign from a variant map.
+    Variant& operator =(VariantMap&& rhs)
+    {
+        SetType(VAR_VARIANTMAP);
+        *value_.variantMap_ = ea::move(rhs);
+        return *this;
+    }
+
     /// Assign from a rect.
     Variant& operator =(const Rect& rhs)
     {
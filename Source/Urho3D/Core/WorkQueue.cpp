@@ -63,6 +63,145 @@ private:
     unsigned index_;
 };
 
+/// Index of the calling thread. Zero for the main thread and for threads not owned by the work queue.
+static thread_local unsigned currentThreadIndex = 0;
+
+/// Chase-Lev lock-free work-stealing deque. The owner thread pushes and pops items at the bottom
+/// while other threads steal from the top. The circular buffer is grown on demand; retired buffers
+/// are kept alive until destruction because concurrent stealers may still be reading them.
+class WorkStealingDeque
+{
+public:
+    /// Construct with initial capacity, which must be a power of two.
+    explicit WorkStealingDeque(unsigned initialCapacity = 256) :
+        buffer_(new Buffer(initialCapacity))
+    {
+    }
+
+    /// Destruct. Must not be called while other threads may access the deque.
+    ~WorkStealingDeque()
+    {
+        delete buffer_.load(std::memory_order_relaxed);
+        for (Buffer* buffer : retiredBuffers_)
+            delete buffer;
+    }
+
+    /// Push an item at the bottom. May be called only by the owner thread.
+    void Push(WorkItem* item)
+    {
+        const long long bottom = bottom_.load(std::memory_order_relaxed);
+        const long long top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+        if (bottom - top > (long long)buffer->capacity_ - 1)
+            buffer = Grow(buffer, top, bottom);
+
+        buffer->Set(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /// Pop an item from the bottom. May be called only by the owner thread. Return null if the deque is empty or the last item was lost to a stealer.
+    WorkItem* Pop()
+    {
+        const long long bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        long long top = top_.load(std::memory_order_relaxed);
+        WorkItem* item = nullptr;
+        if (top <= bottom)
+        {
+            item = buffer->Get(bottom);
+            if (top == bottom)
+            {
+                // Last item: race against stealers for it
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+
+        return item;
+    }
+
+    /// Steal an item from the top. May be called by any thread. Return null if the deque is empty or the steal raced with another thread.
+    WorkItem* Steal()
+    {
+        long long top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const long long bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return nullptr;
+
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        WorkItem* item = buffer->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return item;
+    }
+
+    /// Return whether the deque appears empty. Approximate when called by non-owner threads.
+    bool Empty() const
+    {
+        return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+    }
+
+private:
+    /// Circular item buffer.
+    struct Buffer
+    {
+        /// Construct with capacity, which must be a power of two.
+        explicit Buffer(unsigned capacity) :
+            capacity_(capacity),
+            mask_(capacity - 1),
+            items_(new std::atomic<WorkItem*>[capacity])
+        {
+        }
+
+        /// Destruct.
+        ~Buffer() { delete[] items_; }
+
+        /// Return item at index.
+        WorkItem* Get(long long index) const { return items_[index & mask_].load(std::memory_order_relaxed); }
+        /// Store item at index.
+        void Set(long long index, WorkItem* item) { items_[index & mask_].store(item, std::memory_order_relaxed); }
+
+        /// Capacity of the buffer.
+        unsigned capacity_;
+        /// Index mask.
+        unsigned mask_;
+        /// Item storage.
+        std::atomic<WorkItem*>* items_;
+    };
+
+    /// Reallocate the buffer at double capacity. May be called only by the owner thread.
+    Buffer* Grow(Buffer* buffer, long long top, long long bottom)
+    {
+        auto* newBuffer = new Buffer(buffer->capacity_ * 2);
+        for (long long i = top; i < bottom; ++i)
+            newBuffer->Set(i, buffer->Get(i));
+
+        buffer_.store(newBuffer, std::memory_order_release);
+        retiredBuffers_.push_back(buffer);
+        return newBuffer;
+    }
+
+    /// Top index, incremented by stealers.
+    std::atomic<long long> top_{};
+    /// Bottom index, modified by the owner thread.
+    std::atomic<long long> bottom_{};
+    /// Current circular buffer.
+    std::atomic<Buffer*> buffer_;
+    /// Retired buffers, accessed only by the owner thread.
+    ea::vector<Buffer*> retiredBuffers_;
+};
+
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
     shutDown_(false),
@@ -73,7 +212,17 @@ WorkQueue::WorkQueue(Context* context) :
     lastSize_(0),
     maxNonThreadedWorkMs_(5)
 {
-    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
+    // Prefer the direct frame begin signal; fall back to the event when the Time subsystem does not exist yet (e.g. in tools)
+    if (auto* time = GetSubsystem<Time>())
+        time->onBeginFrame_.Subscribe(this, &WorkQueue::HandleBeginFrame);
+    else
+    {
+        SubscribeToEvent(E_BEGINFRAME, [this](StringHash, VariantMap& eventData)
+        {
+            float timeStep = eventData[BeginFrame::P_TIMESTEP].GetFloat();
+            HandleBeginFrame(timeStep);
+        });
+    }
 }
 
 WorkQueue::~WorkQueue()
@@ -94,6 +243,13 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     if (!threads_.empty())
         return;
 
+    // Create the per-thread deques before starting any thread, as the worker loop selects its mode by their presence
+    if (workStealingEnabled_ && numThreads > 0)
+    {
+        for (unsigned i = 0; i < numThreads + 1; ++i)
+            stealingDeques_.push_back(ea::make_unique<WorkStealingDeque>());
+    }
+
     // Start threads in paused mode
     Pause();
 
@@ -109,6 +265,29 @@ void WorkQueue::CreateThreads(unsigned numThreads)
 #endif
 }
 
+bool WorkQueue::SetThreadAffinity(unsigned threadIndex, unsigned long long coreMask)
+{
+    if (threadIndex < 1 || threadIndex > threads_.size() || !coreMask)
+        return false;
+    return threads_[threadIndex - 1]->SetAffinity(coreMask);
+}
+
+unsigned WorkQueue::PinWorkerThreadsToNUMANodes()
+{
+    const unsigned numNodes = GetNumNUMANodes();
+    if (numNodes < 2 || threads_.empty())
+        return 0;
+
+    unsigned numPinned = 0;
+    for (unsigned i = 0; i < threads_.size(); ++i)
+    {
+        const unsigned long long nodeMask = GetNUMANodeCPUMask(i % numNodes);
+        if (nodeMask && threads_[i]->SetAffinity(nodeMask))
+            ++numPinned;
+    }
+    return numPinned;
+}
+
 SharedPtr<WorkItem> WorkQueue::GetFreeItem()
 {
     if (!poolItems_.empty())
@@ -142,6 +321,41 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
     workItems_.push_back(item);
     item->completed_ = false;
 
+    // Background items go to a separate queue that completion barriers never drain or wait on;
+    // workers pick them up when no regular work remains
+    if (item->background_)
+    {
+        if (IsWorkStealingActive())
+        {
+            MutexLock lock(queueMutex_);
+            backgroundQueue_.push_back(item.Get());
+            stealingPaused_.store(false, std::memory_order_release);
+        }
+        else
+        {
+            if (threads_.size() && !paused_)
+                queueMutex_.Acquire();
+
+            backgroundQueue_.push_back(item.Get());
+
+            if (threads_.size())
+            {
+                queueMutex_.Release();
+                paused_ = false;
+            }
+        }
+        return;
+    }
+
+    // In work-stealing mode items go to the main thread's deque, from which the workers steal.
+    // Callers submit work in descending priority order, which steals then consume oldest-first.
+    if (IsWorkStealingActive())
+    {
+        stealingDeques_[0]->Push(item.Get());
+        stealingPaused_.store(false, std::memory_order_release);
+        return;
+    }
+
     // Make sure worker threads' list is safe to modify
     if (threads_.size() && !paused_)
         queueMutex_.Acquire();
@@ -184,21 +398,38 @@ SharedPtr<WorkItem> WorkQueue::AddWorkItem(std::function<void()> workFunction, u
     return item;
 }
 
+SharedPtr<WorkItem> WorkQueue::AddBackgroundWorkItem(std::function<void()> workFunction, unsigned token)
+{
+    SharedPtr<WorkItem> item = GetFreeItem();
+    item->workLambda_ = std::move(workFunction);
+    item->workFunction_ = [](const WorkItem* item, unsigned) { item->workLambda_(); };
+    item->priority_ = 0;
+    item->token_ = token;
+    item->background_ = true;
+    AddWorkItem(item);
+    return item;
+}
+
 bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 {
     if (!item)
         return false;
 
+    // Work-stealing deques do not support removal of pending items; the background queue does
+    if (IsWorkStealingActive() && !item->background_)
+        return false;
+
     MutexLock lock(queueMutex_);
 
     // Can only remove successfully if the item was not yet taken by threads for execution
-    auto i = ea::find(queue_.begin(), queue_.end(), item.Get());
-    if (i != queue_.end())
+    ea::list<WorkItem*>& queue = item->background_ ? backgroundQueue_ : queue_;
+    auto i = ea::find(queue.begin(), queue.end(), item.Get());
+    if (i != queue.end())
     {
         auto j = ea::find(workItems_.begin(), workItems_.end(), item);
         if (j != workItems_.end())
         {
-            queue_.erase(i);
+            queue.erase(i);
             ReturnToPool(item);
             workItems_.erase(j);
             return true;
@@ -210,6 +441,9 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 
 unsigned WorkQueue::RemoveWorkItems(const ea::vector<SharedPtr<WorkItem> >& items)
 {
+    if (IsWorkStealingActive())
+        return 0;
+
     MutexLock lock(queueMutex_);
     unsigned removed = 0;
 
@@ -234,6 +468,12 @@ unsigned WorkQueue::RemoveWorkItems(const ea::vector<SharedPtr<WorkItem> >& item
 
 void WorkQueue::Pause()
 {
+    if (IsWorkStealingActive())
+    {
+        stealingPaused_.store(true, std::memory_order_release);
+        return;
+    }
+
     if (!paused_)
     {
         pausing_ = true;
@@ -247,6 +487,12 @@ void WorkQueue::Pause()
 
 void WorkQueue::Resume()
 {
+    if (IsWorkStealingActive())
+    {
+        stealingPaused_.store(false, std::memory_order_release);
+        return;
+    }
+
     if (paused_)
     {
         queueMutex_.Release();
@@ -259,6 +505,53 @@ void WorkQueue::Complete(unsigned priority)
 {
     completing_ = true;
 
+    if (IsWorkStealingActive())
+    {
+        Resume();
+
+        // Help with eligible work in the main thread. Ineligible stolen items are buffered and
+        // returned to the main thread's deque afterwards, exactly like the priority cutoff of the
+        // central queue.
+        ea::vector<WorkItem*> deferredItems;
+        bool helped = true;
+        while (helped)
+        {
+            helped = false;
+            for (unsigned i = 0; i < stealingDeques_.size(); ++i)
+            {
+                while (WorkItem* item = stealingDeques_[i]->Steal())
+                {
+                    if (item->priority_ >= priority)
+                    {
+                        item->workFunction_(item, 0);
+                        item->completed_ = true;
+                        helped = true;
+                    }
+                    else
+                    {
+                        deferredItems.push_back(item);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Wait for stolen work still executing on worker threads
+        while (!IsCompleted(priority))
+        {
+        }
+
+        for (WorkItem* item : deferredItems)
+            stealingDeques_[0]->Push(item);
+
+        if (deferredItems.empty() && stealingDeques_[0]->Empty() && backgroundQueue_.empty())
+            Pause();
+
+        PurgeCompleted(priority);
+        completing_ = false;
+        return;
+    }
+
     if (threads_.size())
     {
         Resume();
@@ -288,7 +581,7 @@ void WorkQueue::Complete(unsigned priority)
         }
 
         // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.empty())
+        if (queue_.empty() && backgroundQueue_.empty())
             Pause();
     }
     else
@@ -307,12 +600,113 @@ void WorkQueue::Complete(unsigned priority)
     completing_ = false;
 }
 
+void WorkQueue::CompleteToken(unsigned token)
+{
+    if (!token)
+        return;
+
+    completing_ = true;
+    Resume();
+
+    // Help with the token's work in the main thread. Items of other tokens are left alone, so one
+    // system's barrier no longer drains work another system queued at a lower priority.
+    if (IsWorkStealingActive())
+    {
+        // The deques have no ordering to rely on: sweep them fully, buffering foreign items,
+        // and hand those back afterwards for the workers to continue with
+        ea::vector<WorkItem*> deferredItems;
+        for (unsigned i = 0; i < stealingDeques_.size(); ++i)
+        {
+            while (WorkItem* item = stealingDeques_[i]->Steal())
+            {
+                if (item->token_ == token)
+                {
+                    item->workFunction_(item, 0);
+                    item->completed_ = true;
+                }
+                else
+                    deferredItems.push_back(item);
+            }
+        }
+
+        for (WorkItem* item : deferredItems)
+            stealingDeques_[0]->Push(item);
+    }
+
+    // Execute the token's pending items, including background items
+    while (WorkItem* item = TakeTokenItem(token))
+    {
+        item->workFunction_(item, 0);
+        item->completed_ = true;
+    }
+
+    // Wait for the token's items still executing on worker threads
+    while (!IsTokenCompleted(token))
+    {
+    }
+
+    // Purge the token's completed items and send their events
+    for (auto i = workItems_.begin(); i != workItems_.end();)
+    {
+        if ((*i)->completed_ && (*i)->token_ == token)
+        {
+            if ((*i)->sendEvent_)
+            {
+                using namespace WorkItemCompleted;
+
+                VariantMap& eventData = GetEventDataMap();
+                eventData[P_ITEM] = i->Get();
+                SendEvent(E_WORKITEMCOMPLETED, eventData);
+            }
+
+            ReturnToPool(*i);
+            i = workItems_.erase(i);
+        }
+        else
+            ++i;
+    }
+
+    completing_ = false;
+}
+
+WorkItem* WorkQueue::TakeTokenItem(unsigned token)
+{
+    MutexLock lock(queueMutex_);
+
+    for (auto i = queue_.begin(); i != queue_.end(); ++i)
+    {
+        if ((*i)->token_ == token)
+        {
+            WorkItem* item = *i;
+            queue_.erase(i);
+            return item;
+        }
+    }
+
+    for (auto i = backgroundQueue_.begin(); i != backgroundQueue_.end(); ++i)
+    {
+        if ((*i)->token_ == token)
+        {
+            WorkItem* item = *i;
+            backgroundQueue_.erase(i);
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+unsigned WorkQueue::GetThreadIndex()
+{
+    return currentThreadIndex;
+}
+
 unsigned WorkQueue::GetNumIncomplete(unsigned priority) const
 {
     unsigned incomplete = 0;
     for (const auto& workItem : workItems_)
     {
-        if (workItem->priority_ >= priority && !workItem->completed_)
+        if (workItem->priority_ >= priority && !workItem->completed_ && !workItem->background_)
             ++incomplete;
     }
 
@@ -323,15 +717,140 @@ bool WorkQueue::IsCompleted(unsigned priority) const
 {
     for (const auto & workItem : workItems_)
     {
-        if (workItem->priority_ >= priority && !workItem->completed_)
+        if (workItem->priority_ >= priority && !workItem->completed_ && !workItem->background_)
+            return false;
+    }
+
+    return true;
+}
+
+bool WorkQueue::IsTokenCompleted(unsigned token) const
+{
+    for (const auto& workItem : workItems_)
+    {
+        if (workItem->token_ == token && !workItem->completed_)
             return false;
     }
 
     return true;
 }
 
+void WorkQueue::SetWorkStealingEnabled(bool enable)
+{
+    if (!threads_.empty())
+    {
+        URHO3D_LOGERROR("Work stealing can not be toggled after worker threads have been created");
+        return;
+    }
+
+    workStealingEnabled_ = enable;
+}
+
+WorkItem* WorkQueue::StealWork(unsigned threadIndex)
+{
+    // Pop own work first, then sweep the peers starting from the next one to reduce contention
+    if (WorkItem* item = stealingDeques_[threadIndex]->Pop())
+        return item;
+
+    const unsigned numDeques = stealingDeques_.size();
+    for (unsigned offset = 1; offset < numDeques; ++offset)
+    {
+        if (WorkItem* item = stealingDeques_[(threadIndex + offset) % numDeques]->Steal())
+            return item;
+    }
+
+    return nullptr;
+}
+
+void WorkQueue::PostInternal(const SharedPtr<WorkItem>& item, unsigned threadIndex)
+{
+    // In work-stealing mode each thread owns its deque and may push to it freely
+    if (IsWorkStealingActive())
+    {
+        stealingDeques_[threadIndex]->Push(item.Get());
+        stealingPaused_.store(false, std::memory_order_release);
+        return;
+    }
+
+    MutexLock lock(queueMutex_);
+
+    // Keep the queue sorted by priority as in AddWorkItem
+    bool inserted = false;
+    for (auto i = queue_.begin(); i != queue_.end(); ++i)
+    {
+        if ((*i)->priority_ <= item->priority_)
+        {
+            queue_.insert(i, item.Get());
+            inserted = true;
+            break;
+        }
+    }
+
+    if (!inserted)
+        queue_.push_back(item.Get());
+}
+
+bool WorkQueue::ExecuteOneItem(unsigned threadIndex)
+{
+    WorkItem* item = nullptr;
+
+    if (IsWorkStealingActive())
+        item = StealWork(threadIndex);
+    else
+    {
+        MutexLock lock(queueMutex_);
+        if (!queue_.empty())
+        {
+            item = queue_.front();
+            queue_.pop_front();
+        }
+    }
+
+    if (!item)
+        return false;
+
+    item->workFunction_(item, threadIndex);
+    item->completed_ = true;
+    return true;
+}
+
 void WorkQueue::ProcessItems(unsigned threadIndex)
 {
+    currentThreadIndex = threadIndex;
+
+    if (IsWorkStealingActive())
+    {
+        while (!shutDown_)
+        {
+            if (stealingPaused_.load(std::memory_order_acquire))
+            {
+                Time::Sleep(0);
+                continue;
+            }
+
+            WorkItem* item = StealWork(threadIndex);
+            if (!item)
+            {
+                // No regular work: service the frame-spanning background queue
+                MutexLock lock(queueMutex_);
+                if (!backgroundQueue_.empty())
+                {
+                    item = backgroundQueue_.front();
+                    backgroundQueue_.pop_front();
+                }
+            }
+
+            if (item)
+            {
+                item->workFunction_(item, threadIndex);
+                item->completed_ = true;
+            }
+            else
+                Time::Sleep(0);
+        }
+        return;
+    }
+
     bool wasActive = false;
 
     for (;;)
@@ -344,12 +863,24 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
         else
         {
             queueMutex_.Acquire();
+
+            // Take regular work first; fall back to the frame-spanning background queue
+            WorkItem* item = nullptr;
             if (!queue_.empty())
+            {
+                item = queue_.front();
+                queue_.pop_front();
+            }
+            else if (!backgroundQueue_.empty())
+            {
+                item = backgroundQueue_.front();
+                backgroundQueue_.pop_front();
+            }
+
+            if (item)
             {
                 wasActive = true;
 
-                WorkItem* item = queue_.front();
-                queue_.pop_front();
                 queueMutex_.Release();
                 item->workFunction_(item, threadIndex);
                 item->completed_ = true;
@@ -372,7 +903,9 @@ void WorkQueue::PurgeCompleted(unsigned priority)
     // render update, which is not allowed
     for (auto i = workItems_.begin(); i != workItems_.end();)
     {
-        if ((*i)->completed_ && (*i)->priority_ >= priority)
+        // Signal background items only at a full purge, like other low-priority work
+        const unsigned effectivePriority = (*i)->background_ ? 0 : (*i)->priority_;
+        if ((*i)->completed_ && effectivePriority >= priority)
         {
             if ((*i)->sendEvent_)
             {
@@ -417,6 +950,8 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
         item->aux_ = nullptr;
         item->workFunction_ = nullptr;
         item->priority_ = M_MAX_UNSIGNED;
+        item->token_ = 0;
+        item->background_ = false;
         item->sendEvent_ = false;
         item->completed_ = false;
 
@@ -424,19 +959,31 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
     }
 }
 
-void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+void WorkQueue::HandleBeginFrame(float& timeStep)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.empty() && !queue_.empty())
+    if (threads_.empty() && (!queue_.empty() || !backgroundQueue_.empty()))
     {
         URHO3D_PROFILE("CompleteWorkNonthreaded");
 
         HiresTimer timer;
 
-        while (!queue_.empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.front();
-            queue_.pop_front();
+            WorkItem* item = nullptr;
+            if (!queue_.empty())
+            {
+                item = queue_.front();
+                queue_.pop_front();
+            }
+            else if (!backgroundQueue_.empty())
+            {
+                item = backgroundQueue_.front();
+                backgroundQueue_.pop_front();
+            }
+            else
+                break;
+
             item->workFunction_(item, 0);
             item->completed_ = true;
         }
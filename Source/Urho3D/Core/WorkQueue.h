@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/list.h>
+#include <EASTL/unique_ptr.h>
 #include <atomic>
 
 #include "../Core/Mutex.h"
@@ -40,6 +41,7 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 }
 
 class WorkerThread;
+class WorkStealingDeque;
 
 /// Work queue item.
 struct WorkItem : public RefCounted
@@ -57,6 +59,10 @@ public:
     void* aux_{};
     /// Priority. Higher value = will be completed first.
     unsigned priority_{};
+    /// Completion token the item belongs to, allocated from WorkQueue::AllocateToken(). 0 for none.
+    unsigned token_{};
+    /// Frame-spanning background item: executed when no regular work remains, and never waited on by Complete().
+    bool background_{};
     /// Whether to send event on completion.
     bool sendEvent_{};
     /// Completed flag.
@@ -74,6 +80,7 @@ class URHO3D_API WorkQueue : public Object
     URHO3D_OBJECT(WorkQueue, Object);
 
     friend class WorkerThread;
+    friend class TaskGraph;
 
 public:
     /// Construct.
@@ -89,6 +96,10 @@ public:
     void AddWorkItem(const SharedPtr<WorkItem>& item);
     /// Add a work item and resume worker threads.
     SharedPtr<WorkItem> AddWorkItem(std::function<void()> workFunction, unsigned priority = 0);
+    /// Add a frame-spanning background work item, e.g. a navigation mesh rebuild or lightmap update. Executed
+    /// when workers have no regular work, persists across frames and is never waited on by Complete(). Use a
+    /// token to wait for it explicitly with CompleteToken().
+    SharedPtr<WorkItem> AddBackgroundWorkItem(std::function<void()> workFunction, unsigned token = 0);
     /// Remove a work item before it has started executing. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
@@ -97,9 +108,26 @@ public:
     void Pause();
     /// Resume worker threads.
     void Resume();
-    /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
+    /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains. Background items are never waited on.
     void Complete(unsigned priority);
 
+    /// Allocate a completion token for grouping work items. Set it on items before submitting, then wait with CompleteToken(), so that independent systems stop waiting on each other's priorities.
+    unsigned AllocateToken() { return nextToken_.fetch_add(1, std::memory_order_relaxed); }
+    /// Finish all queued work belonging to the given token, regardless of priority. The main thread executes the token's items; other queued work is left to the worker threads.
+    void CompleteToken(unsigned token);
+    /// Return whether all work belonging to the given token is finished.
+    bool IsTokenCompleted(unsigned token) const;
+
+    /// Set the CPU core affinity mask of a worker thread (1 to GetNumThreads()). Each set bit in the mask allows the thread to run on the corresponding logical CPU. Return true if successful.
+    bool SetThreadAffinity(unsigned threadIndex, unsigned long long coreMask);
+    /// Pin each worker thread to the CPUs of one NUMA node, distributing the threads over the nodes in round-robin order. No-op on single-node systems and on platforms without NUMA topology information. Return the number of threads successfully pinned.
+    unsigned PinWorkerThreadsToNUMANodes();
+
+    /// Enable or disable the per-thread work-stealing scheduler. Must be called before CreateThreads().
+    void SetWorkStealingEnabled(bool enable);
+    /// Return whether the work-stealing scheduler is enabled.
+    bool IsWorkStealingEnabled() const { return workStealingEnabled_; }
+
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
 
@@ -109,9 +137,13 @@ public:
     /// Return number of worker threads.
     unsigned GetNumThreads() const { return threads_.size(); }
 
-    /// Return number of incomplete tasks with at least the specified priority.
+    /// Return index of the calling thread: 1 to GetNumThreads() for worker threads, 0 for the main thread and for
+    /// threads not owned by the work queue. Can be used to index per-thread data.
+    static unsigned GetThreadIndex();
+
+    /// Return number of incomplete tasks with at least the specified priority. Background items are not counted.
     unsigned GetNumIncomplete(unsigned priority) const;
-    /// Return whether all work with at least the specified priority is finished.
+    /// Return whether all work with at least the specified priority is finished. Background items are not considered.
     bool IsCompleted(unsigned priority) const;
     /// Return whether the queue is currently completing work in the main thread.
     bool IsCompleting() const { return completing_; }
@@ -132,16 +164,30 @@ private:
     /// Return a work item to the pool.
     void ReturnToPool(SharedPtr<WorkItem>& item);
     /// Handle frame start event. Purge completed work from the main thread queue, and perform work if no threads at all.
-    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    void HandleBeginFrame(float& timeStep);
+    /// Return whether the work-stealing scheduler is active. Deques are created by CreateThreads() and never destroyed while threads run.
+    bool IsWorkStealingActive() const { return !stealingDeques_.empty(); }
+    /// Return the next work item in work-stealing mode, or null. Pops the calling thread's own deque first, then steals from peers.
+    WorkItem* StealWork(unsigned threadIndex);
+    /// Remove and return a pending work item belonging to the given token, from the regular or the background queue. Return null if none remain.
+    WorkItem* TakeTokenItem(unsigned token);
+    /// Post an externally owned work item from any thread. The item is not tracked by the queue; the caller manages its lifetime and completion. Used by TaskGraph.
+    void PostInternal(const SharedPtr<WorkItem>& item, unsigned threadIndex);
+    /// Execute one pending work item on the calling thread if one is immediately available. Return true on success. Used by TaskGraph to let the main thread assist.
+    bool ExecuteOneItem(unsigned threadIndex);
 
     /// Worker threads.
     ea::vector<SharedPtr<WorkerThread> > threads_;
+    /// Per-thread work-stealing deques. Index 0 belongs to the main thread. Empty unless work stealing is enabled.
+    ea::vector<ea::unique_ptr<WorkStealingDeque> > stealingDeques_;
     /// Work item pool for reuse to cut down on allocation. The bool is a flag for item pooling and whether it is available or not.
     ea::list<SharedPtr<WorkItem> > poolItems_;
     /// Work item collection. Accessed only by the main thread.
     ea::list<SharedPtr<WorkItem> > workItems_;
     /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems).
     ea::list<WorkItem*> queue_;
+    /// Frame-spanning background work queue, serviced when the regular queue is empty. Guarded by queueMutex_.
+    ea::list<WorkItem*> backgroundQueue_;
     /// Worker queue mutex.
     Mutex queueMutex_;
     /// Shutting down flag.
@@ -158,6 +204,12 @@ private:
     unsigned lastSize_;
     /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
     int maxNonThreadedWorkMs_;
+    /// Work-stealing scheduler enabled flag.
+    bool workStealingEnabled_{};
+    /// Paused flag for work-stealing mode, where worker threads never hold the queue mutex.
+    std::atomic<bool> stealingPaused_{true};
+    /// Next completion token to hand out. 0 is reserved for items without a token.
+    std::atomic<unsigned> nextToken_{1};
 };
 
 }
@@ -23,8 +23,11 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Container/FrameAllocator.h"
+#include "../Container/MemoryTracker.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameBudget.h"
 #include "../Core/Profiler.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Thread.h"
@@ -38,6 +41,7 @@
 #include "../Engine/EngineDefs.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
+#include "../Graphics/TransientBuffer.h"
 #include "../Input/Input.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -113,10 +117,13 @@ Engine::Engine(Context* context) :
     maxInactiveFps_(60),
     pauseMinimized_(false),
 #endif
+    fixedUpdateFps_(0),
+    fixedUpdateAccumulator_(0.0f),
 #ifdef URHO3D_TESTING
     timeOut_(0),
 #endif
     autoExit_(true),
+    framePipelining_(false),
     initialized_(false),
     exiting_(false),
     headless_(false),
@@ -127,6 +134,7 @@ Engine::Engine(Context* context) :
 
     // Create subsystems which do not depend on engine initialization or startup parameters
     context_->RegisterSubsystem(new Time(context_));
+    context_->RegisterSubsystem(new FrameBudget(context_));
     context_->RegisterSubsystem(new WorkQueue(context_));
     context_->RegisterSubsystem(new FileSystem(context_));
 #ifdef URHO3D_LOGGING
@@ -164,7 +172,7 @@ Engine::Engine(Context* context) :
 #endif
 
     SubscribeToEvent(E_EXITREQUESTED, URHO3D_HANDLER(Engine, HandleExitRequested));
-    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(Engine, HandleEndFrame));
+    GetSubsystem<Time>()->onEndFrame_.Subscribe(this, &Engine::HandleEndFrame);
 }
 
 Engine::~Engine() = default;
@@ -196,6 +204,7 @@ bool Engine::Initialize(const VariantMap& parameters)
     {
         context_->RegisterSubsystem(new Graphics(context_));
         context_->RegisterSubsystem(new Renderer(context_));
+        context_->RegisterSubsystem(new TransientBuffer(context_));
     }
     else
     {
@@ -215,6 +224,14 @@ bool Engine::Initialize(const VariantMap& parameters)
     if (GetParameter(parameters, EP_FRAME_LIMITER, true) == false)
         SetMaxFps(0);
 
+    // Configure frame pipelining
+    if (GetParameter(parameters, EP_FRAME_PIPELINING, false).GetBool())
+        SetFramePipelining(true);
+
+    // Configure fixed-timestep logic updates
+    if (HasParameter(parameters, EP_FIXED_UPDATE_FPS))
+        SetFixedUpdateFps(GetParameter(parameters, EP_FIXED_UPDATE_FPS).GetInt());
+
     // Set amount of worker threads according to the available physical CPU cores. Using also hyperthreaded cores results in
     // unpredictable extra synchronization overhead. Also reserve one core for the main thread
 #ifdef URHO3D_THREADING
@@ -288,6 +305,14 @@ bool Engine::Initialize(const VariantMap& parameters)
         renderer->SetTextureQuality((MaterialQuality)GetParameter(parameters, EP_TEXTURE_QUALITY, QUALITY_HIGH).GetInt());
         renderer->SetTextureFilterMode((TextureFilterMode)GetParameter(parameters, EP_TEXTURE_FILTER_MODE, FILTER_TRILINEAR).GetInt());
         renderer->SetTextureAnisotropy(GetParameter(parameters, EP_TEXTURE_ANISOTROPY, 4).GetInt());
+        if (GetParameter(parameters, EP_DYNAMIC_RESOLUTION, false).GetBool())
+        {
+            renderer->SetDynamicResolutionScaleRange(
+                GetParameter(parameters, EP_DYNAMIC_RESOLUTION_MIN_SCALE, 0.5f).GetFloat(), 1.0f);
+            const float targetFPS = GetParameter(parameters, EP_DYNAMIC_RESOLUTION_TARGET_FPS, 60.0f).GetFloat();
+            renderer->SetDynamicResolutionTargetFrameTime(1000.0f / Max(targetFPS, 1.0f));
+            renderer->SetDynamicResolution(true);
+        }
 
         if (GetParameter(parameters, EP_SOUND, true).GetBool())
         {
@@ -513,6 +538,18 @@ void Engine::RunFrame()
         URHO3D_PROFILE("DoFrame");
         time->BeginFrame(timeStep_);
 
+        // In pipelined mode render the views prepared during the previous frame's update first, so that the GPU
+        // consumes the submitted frame while the CPU runs this frame's update. The previous frame's arena
+        // allocations are released only after the render state prepared from them has been consumed
+        if (framePipelining_)
+        {
+            Render();
+            context_->GetFrameArena()->Reset();
+        }
+
+        // Deliver events queued from worker threads in one batch
+        context_->ProcessCrossThreadEvents();
+
         // If pause when minimized -mode is in use, stop updates and audio as necessary
         if (pauseMinimized_ && input->IsMinimized())
         {
@@ -534,12 +571,18 @@ void Engine::RunFrame()
             Update();
         }
 
-        Render();
+        if (!framePipelining_)
+            Render();
     }
     ApplyFrameLimit();
 
     time->EndFrame();
 
+    // Release all frame-scoped arena allocations. In pipelined mode this is deferred to the start of the next
+    // frame, after the queued render state has been consumed
+    if (!framePipelining_)
+        context_->GetFrameArena()->Reset();
+
     URHO3D_PROFILE_FRAME();
 }
 
@@ -617,6 +660,17 @@ void Engine::SetAutoExit(bool enable)
     autoExit_ = enable;
 }
 
+void Engine::SetFramePipelining(bool enable)
+{
+    framePipelining_ = enable;
+}
+
+void Engine::SetFixedUpdateFps(int fps)
+{
+    fixedUpdateFps_ = (unsigned)Max(fps, 0);
+    fixedUpdateAccumulator_ = 0.0f;
+}
+
 void Engine::SetNextTimeStep(float seconds)
 {
     timeStep_ = Max(seconds, 0.0f);
@@ -672,6 +726,7 @@ void Engine::DumpResources(bool dumpFileName)
 void Engine::DumpMemory()
 {
 #ifdef URHO3D_LOGGING
+    MemoryTracker::Dump();
 #if defined(_MSC_VER) && defined(_DEBUG)
     _CrtMemState state;
     _CrtMemCheckpoint(&state);
@@ -704,30 +759,115 @@ void Engine::DumpMemory()
 
     URHO3D_LOGINFO("Total allocated memory {} bytes in {} blocks", total, blocks);
 #else
-    URHO3D_LOGINFO("DumpMemory() supported on MSVC debug mode only");
+    URHO3D_LOGINFO("Per-allocation dump supported on MSVC debug mode only");
 #endif
 #endif
 }
 
-void Engine::Update()
+void Engine::SubscribeToFrameEvent(StringHash eventType, Object* receiver, std::function<void(float)> callback)
 {
-    URHO3D_PROFILE("Update");
+    if (!receiver || !callback)
+        return;
+
+    ea::vector<FrameEventSubscription>& subscriptions = frameEventCallbacks_[eventType];
+    for (FrameEventSubscription& subscription : subscriptions)
+    {
+        if (subscription.receiver_ == receiver)
+        {
+            subscription.callback_ = ea::move(callback);
+            return;
+        }
+    }
+
+    subscriptions.push_back(FrameEventSubscription{ WeakPtr<Object>(receiver), ea::move(callback) });
+}
+
+void Engine::UnsubscribeFromFrameEvent(StringHash eventType, Object* receiver)
+{
+    auto it = frameEventCallbacks_.find(eventType);
+    if (it == frameEventCallbacks_.end())
+        return;
+
+    // Only reset the slot so that unsubscription during dispatch stays safe. Compacted on the next dispatch
+    for (FrameEventSubscription& subscription : it->second)
+    {
+        if (subscription.receiver_ == receiver)
+        {
+            subscription.receiver_.Reset();
+            subscription.callback_ = nullptr;
+        }
+    }
+}
+
+void Engine::SendFrameEvent(StringHash eventType)
+{
+    SendFrameEvent(eventType, timeStep_);
+}
+
+void Engine::SendFrameEvent(StringHash eventType, float timeStep)
+{
+    // Invoke direct-dispatch callbacks first. Iterate by index because callbacks may subscribe more
+    auto it = frameEventCallbacks_.find(eventType);
+    if (it != frameEventCallbacks_.end())
+    {
+        ea::vector<FrameEventSubscription>& subscriptions = it->second;
+        bool hasExpired = false;
+        for (unsigned i = 0; i < subscriptions.size(); ++i)
+        {
+            if (subscriptions[i].receiver_)
+                subscriptions[i].callback_(timeStep);
+            else
+                hasExpired = true;
+        }
+
+        if (hasExpired)
+        {
+            subscriptions.erase(ea::remove_if(subscriptions.begin(), subscriptions.end(),
+                [](const FrameEventSubscription& subscription) { return !subscription.receiver_; }), subscriptions.end());
+        }
+    }
+
+    // Legacy event path. Skip the VariantMap packing entirely when nobody is subscribed
+    if (!HasEventReceivers(eventType))
+        return;
 
-    // Logic update event
     using namespace Update;
 
     VariantMap& eventData = GetEventDataMap();
-    eventData[P_TIMESTEP] = timeStep_;
-    SendEvent(E_UPDATE, eventData);
+    eventData[P_TIMESTEP] = timeStep;
+    SendEvent(eventType, eventData);
+}
+
+void Engine::Update()
+{
+    URHO3D_PROFILE("Update");
+
+    // Fixed-timestep logic updates. The accumulator carries the remainder between frames; clamping of the frame
+    // timestep via the minimum FPS bounds the number of steps taken on a slow frame
+    if (fixedUpdateFps_)
+    {
+        URHO3D_PROFILE("FixedUpdate");
+
+        const float fixedTimeStep = 1.0f / (float)fixedUpdateFps_;
+        fixedUpdateAccumulator_ += timeStep_;
+        while (fixedUpdateAccumulator_ >= fixedTimeStep)
+        {
+            fixedUpdateAccumulator_ -= fixedTimeStep;
+            SendFrameEvent(E_FIXEDUPDATE, fixedTimeStep);
+        }
+    }
+
+    // Logic update event
+    SendFrameEvent(E_UPDATE);
 
     // Logic post-update event
-    SendEvent(E_POSTUPDATE, eventData);
+    SendFrameEvent(E_POSTUPDATE);
 
     // Rendering update event
-    SendEvent(E_RENDERUPDATE, eventData);
+    SendFrameEvent(E_RENDERUPDATE);
 
     // Post-render update event
-    SendEvent(E_POSTRENDERUPDATE, eventData);
+    SendFrameEvent(E_POSTRENDERUPDATE);
 }
 
 void Engine::Render()
@@ -1002,7 +1142,7 @@ void Engine::HandleExitRequested(StringHash eventType, VariantMap& eventData)
     exiting_ = true;
 }
 
-void Engine::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+void Engine::HandleEndFrame()
 {
     if (exiting_ && autoExit_)
     {
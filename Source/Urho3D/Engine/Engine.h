@@ -71,6 +71,15 @@ public:
     void SetPauseMinimized(bool enable);
     /// Set whether to exit automatically on exit request (window close button).
     void SetAutoExit(bool enable);
+    /// Set whether to pipeline frames: render the views prepared during the previous frame before running this
+    /// frame's update, so the GPU consumes the submitted frame while the CPU updates the next one. Adds one frame
+    /// of latency. Scenes referenced by queued render state must only be modified from the update events.
+    void SetFramePipelining(bool enable);
+    /// Set frequency of fixed-timestep logic updates (E_FIXEDUPDATE), 0 disables the fixed update loop. Fixed
+    /// updates are sent zero or more times per rendered frame from an accumulator, before the variable update.
+    /// Attach SmoothedTransform to nodes moved by fixed update logic to interpolate their rendering at full
+    /// frame rate.
+    void SetFixedUpdateFps(int fps);
     /// Override timestep of the next frame. Should be called in between RunFrame() calls.
     void SetNextTimeStep(float seconds);
     /// Close the graphics window and set the exit flag. No-op on iOS/tvOS, as an iOS/tvOS application can not legally exit.
@@ -79,7 +88,7 @@ public:
     void DumpProfiler();
     /// Dump information of all resources to the log.
     void DumpResources(bool dumpFileName = false);
-    /// Dump information of all memory allocations to the log. Supported in MSVC debug mode only.
+    /// Dump memory tag statistics and, on MSVC debug mode, information of all memory allocations to the log.
     void DumpMemory();
 
     /// Return preference directory name.
@@ -106,6 +115,16 @@ public:
     /// Return whether to exit automatically on exit request.
     bool GetAutoExit() const { return autoExit_; }
 
+    /// Return whether frames are pipelined.
+    bool GetFramePipelining() const { return framePipelining_; }
+
+    /// Return frequency of fixed-timestep logic updates, 0 if disabled.
+    int GetFixedUpdateFps() const { return (int)fixedUpdateFps_; }
+
+    /// Return interpolation factor in range [0, 1) describing the render frame's position between the latest and
+    /// the next fixed update. Zero when the fixed update loop is disabled.
+    float GetFixedUpdateInterpolation() const { return fixedUpdateFps_ ? fixedUpdateAccumulator_ * (float)fixedUpdateFps_ : 0.0f; }
+
     /// Return whether engine has been initialized.
     bool IsInitialized() const { return initialized_; }
 
@@ -115,6 +134,15 @@ public:
     /// Return whether the engine has been created in headless mode.
     bool IsHeadless() const { return headless_; }
 
+    /// Subscribe a typed callback invoked directly when the engine sends given per-frame event
+    /// (E_UPDATE, E_POSTUPDATE, E_RENDERUPDATE or E_POSTRENDERUPDATE). Bypasses the event plumbing:
+    /// no receiver group lookup, no virtual handler invocation and no VariantMap packing.
+    /// Callbacks are invoked before legacy event subscribers. One callback per receiver and event;
+    /// subscribing again replaces the previous callback. The subscription expires with the receiver.
+    void SubscribeToFrameEvent(StringHash eventType, Object* receiver, std::function<void(float)> callback);
+    /// Unsubscribe a receiver's typed callback from given per-frame event.
+    void UnsubscribeFromFrameEvent(StringHash eventType, Object* receiver);
+
     /// Send frame update events.
     void Update();
     /// Render after frame update.
@@ -131,13 +159,28 @@ public:
         & GetParameter(const VariantMap& parameters, const ea::string& parameter, const Variant& defaultValue = Variant::EMPTY);
 
 private:
+    /// Typed callback subscribed to a per-frame event.
+    struct FrameEventSubscription
+    {
+        /// Receiver object used as subscription key. Null when the slot awaits compaction.
+        WeakPtr<Object> receiver_;
+        /// Callback receiving the frame timestep.
+        std::function<void(float)> callback_;
+    };
+
+    /// Send a per-frame event with the frame timestep: invoke direct-dispatch callbacks, then legacy event subscribers if any exist.
+    void SendFrameEvent(StringHash eventType);
+    /// Send a per-frame event with an explicit timestep.
+    void SendFrameEvent(StringHash eventType, float timeStep);
     /// Set flag indicating that exit request has to be handled.
     void HandleExitRequested(StringHash eventType, VariantMap& eventData);
     /// Do housekeeping tasks at the end of frame. Actually handles exit requested event. Auto-exit if enabled.
-    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    void HandleEndFrame();
     /// Actually perform the exit actions.
     void DoExit();
 
+    /// Direct-dispatch callback lists for per-frame events.
+    ea::unordered_map<StringHash, ea::vector<FrameEventSubscription>> frameEventCallbacks_;
     /// App preference directory.
     ea::string appPreferencesDir_;
     /// Frame update timer.
@@ -156,12 +199,18 @@ private:
     unsigned maxInactiveFps_;
     /// Pause when minimized flag.
     bool pauseMinimized_;
+    /// Frequency of fixed-timestep logic updates, 0 if disabled.
+    unsigned fixedUpdateFps_;
+    /// Time accumulated toward the next fixed-timestep logic update.
+    float fixedUpdateAccumulator_;
 #ifdef URHO3D_TESTING
     /// Time out counter for testing.
     long long timeOut_;
 #endif
     /// Auto-exit flag.
     bool autoExit_;
+    /// Frame pipelining flag.
+    bool framePipelining_;
     /// Initialized flag.
     bool initialized_;
     /// Exiting flag.
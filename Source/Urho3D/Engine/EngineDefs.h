@@ -33,10 +33,15 @@ namespace Urho3D
 static const ea::string EP_AUTOLOAD_PATHS = "AutoloadPaths";
 static const ea::string EP_BORDERLESS = "Borderless";
 static const ea::string EP_DUMP_SHADERS = "DumpShaders";
+static const ea::string EP_DYNAMIC_RESOLUTION = "DynamicResolution";
+static const ea::string EP_DYNAMIC_RESOLUTION_MIN_SCALE = "DynamicResolutionMinScale";
+static const ea::string EP_DYNAMIC_RESOLUTION_TARGET_FPS = "DynamicResolutionTargetFPS";
 static const ea::string EP_EXTERNAL_WINDOW = "ExternalWindow";
+static const ea::string EP_FIXED_UPDATE_FPS = "FixedUpdateFPS";
 static const ea::string EP_FLUSH_GPU = "FlushGPU";
 static const ea::string EP_FORCE_GL2 = "ForceGL2";
 static const ea::string EP_FRAME_LIMITER = "FrameLimiter";
+static const ea::string EP_FRAME_PIPELINING = "FramePipelining";
 static const ea::string EP_FULL_SCREEN = "FullScreen";
 static const ea::string EP_HEADLESS = "Headless";
 static const ea::string EP_HIGH_DPI = "HighDPI";
@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/FrameBudget.h"
+#include "../Core/StringUtils.h"
+#include "../Engine/Engine.h"
+#include "../Engine/FrameReplay.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+#include "../Scene/Scene.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// File identifier of frame capture files.
+static const ea::string captureFileID = "UFRC";
+/// Current frame capture file format version.
+static const unsigned char CAPTURE_VERSION = 1;
+
+FrameReplay::FrameReplay(Context* context) :
+    Object(context)
+{
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(FrameReplay, HandleBeginFrame));
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameReplay, HandleEndFrame));
+}
+
+FrameReplay::~FrameReplay()
+{
+    EndRecording();
+    EndPlayback();
+}
+
+void FrameReplay::SetScene(Scene* scene)
+{
+    scene_ = scene;
+}
+
+void FrameReplay::AddTrackedNode(Node* node)
+{
+    WeakPtr<Node> nodeWeak(node);
+    if (node && !trackedNodes_.contains(nodeWeak))
+        trackedNodes_.push_back(nodeWeak);
+}
+
+void FrameReplay::ClearTrackedNodes()
+{
+    trackedNodes_.clear();
+}
+
+bool FrameReplay::BeginRecording(const ea::string& fileName)
+{
+    if (IsRecording() || playing_)
+    {
+        URHO3D_LOGERROR("Frame recording or playback already in progress");
+        return false;
+    }
+    if (!scene_)
+    {
+        URHO3D_LOGERROR("No scene set for frame recording");
+        return false;
+    }
+
+    SharedPtr<File> file(new File(context_, fileName, FILE_WRITE));
+    if (!file->IsOpen())
+        return false;
+
+    file->WriteFileID(captureFileID);
+    file->WriteUByte(CAPTURE_VERSION);
+
+    recordFile_ = file;
+    pendingEvents_.clear();
+    recordTimeStep_ = 0.0f;
+    frameNumber_ = 0;
+    return true;
+}
+
+void FrameReplay::EndRecording()
+{
+    if (!recordFile_)
+        return;
+
+    URHO3D_LOGINFO("Recorded {} frames to {}", frameNumber_, recordFile_->GetName());
+    recordFile_ = nullptr;
+    pendingEvents_.clear();
+}
+
+void FrameReplay::RecordEvent(StringHash eventType, const VariantMap& eventData)
+{
+    if (!recordFile_)
+        return;
+
+    RecordedEvent event;
+    event.eventType_ = eventType;
+    event.eventData_ = eventData;
+    pendingEvents_.push_back(ea::move(event));
+}
+
+bool FrameReplay::BeginPlayback(const ea::string& fileName)
+{
+    if (IsRecording() || playing_)
+    {
+        URHO3D_LOGERROR("Frame recording or playback already in progress");
+        return false;
+    }
+    if (!scene_)
+    {
+        URHO3D_LOGERROR("No scene set for frame playback");
+        return false;
+    }
+
+    SharedPtr<File> file(new File(context_, fileName, FILE_READ));
+    if (!file->IsOpen())
+        return false;
+
+    if (file->ReadFileID() != captureFileID)
+    {
+        URHO3D_LOGERROR(fileName + " is not a valid frame capture file");
+        return false;
+    }
+    unsigned char version = file->ReadUByte();
+    if (version > CAPTURE_VERSION)
+    {
+        URHO3D_LOGERROR(fileName + " has an unsupported frame capture version");
+        return false;
+    }
+
+    frames_.clear();
+    while (!file->IsEof())
+    {
+        FrameRecord frame;
+        frame.timeStep_ = file->ReadFloat();
+
+        unsigned numNodes = file->ReadVLE();
+        frame.nodeStates_.resize(numNodes);
+        for (NodeState& state : frame.nodeStates_)
+        {
+            state.nodeId_ = file->ReadUInt();
+            state.position_ = file->ReadVector3();
+            state.rotation_ = file->ReadQuaternion();
+            state.scale_ = file->ReadVector3();
+        }
+
+        unsigned numEvents = file->ReadVLE();
+        frame.events_.resize(numEvents);
+        for (RecordedEvent& event : frame.events_)
+        {
+            event.eventType_ = file->ReadStringHash();
+            event.eventData_ = file->ReadVariantMap();
+        }
+
+        frames_.push_back(ea::move(frame));
+    }
+
+    if (frames_.empty())
+    {
+        URHO3D_LOGERROR(fileName + " contains no frames");
+        return false;
+    }
+
+    if (!timingFileName_.empty())
+    {
+        timingFile_ = new File(context_, timingFileName_, FILE_WRITE);
+        if (!timingFile_->IsOpen())
+            timingFile_ = nullptr;
+    }
+
+    playing_ = true;
+    frameNumber_ = 0;
+    playbackTimeStep_ = 0.0f;
+    timingHeaderWritten_ = false;
+
+    // Force the recorded timestep of the first frame; subsequent timesteps are forced as each frame is applied
+    if (auto* engine = GetSubsystem<Engine>())
+        engine->SetNextTimeStep(frames_[0].timeStep_);
+
+    URHO3D_LOGINFO("Playing back {} frames from {}", frames_.size(), fileName);
+    return true;
+}
+
+void FrameReplay::EndPlayback()
+{
+    if (!playing_)
+        return;
+
+    playing_ = false;
+    frames_.clear();
+    timingFile_ = nullptr;
+}
+
+void FrameReplay::SetTimingOutput(const ea::string& fileName)
+{
+    timingFileName_ = fileName;
+}
+
+Scene* FrameReplay::GetScene() const
+{
+    return scene_;
+}
+
+void FrameReplay::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (recordFile_)
+        recordTimeStep_ = eventData[BeginFrame::P_TIMESTEP].GetFloat();
+
+    if (playing_)
+    {
+        // The FrameBudget subsystem subscribes to begin frame before this object exists, so at this point its
+        // counters hold the timings of the frame that just ended
+        if (frameNumber_ > 0 && timingFile_)
+            WriteTimingRow(frameNumber_ - 1, playbackTimeStep_);
+
+        if (frameNumber_ >= frames_.size())
+        {
+            URHO3D_LOGINFO("Frame playback finished");
+            EndPlayback();
+            return;
+        }
+
+        const FrameRecord& frame = frames_[frameNumber_];
+        ApplyFrame(frame);
+        playbackTimeStep_ = frame.timeStep_;
+
+        // Force the timestep the next frame will be run with
+        if (frameNumber_ + 1 < frames_.size())
+        {
+            if (auto* engine = GetSubsystem<Engine>())
+                engine->SetNextTimeStep(frames_[frameNumber_ + 1].timeStep_);
+        }
+
+        ++frameNumber_;
+    }
+}
+
+void FrameReplay::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (!recordFile_)
+        return;
+
+    FrameRecord frame;
+    frame.timeStep_ = recordTimeStep_;
+
+    for (const WeakPtr<Node>& node : trackedNodes_)
+    {
+        if (!node)
+            continue;
+
+        NodeState state;
+        state.nodeId_ = node->GetID();
+        state.position_ = node->GetWorldPosition();
+        state.rotation_ = node->GetWorldRotation();
+        state.scale_ = node->GetWorldScale();
+        frame.nodeStates_.push_back(state);
+    }
+
+    frame.events_ = ea::move(pendingEvents_);
+    pendingEvents_.clear();
+
+    WriteFrame(frame);
+    ++frameNumber_;
+}
+
+void FrameReplay::ApplyFrame(const FrameRecord& frame)
+{
+    for (const NodeState& state : frame.nodeStates_)
+    {
+        if (Node* node = scene_ ? scene_->GetNode(state.nodeId_) : nullptr)
+            node->SetWorldTransform(state.position_, state.rotation_, state.scale_);
+    }
+
+    for (const RecordedEvent& event : frame.events_)
+    {
+        if (scene_)
+        {
+            VariantMap eventData = event.eventData_;
+            scene_->SendEvent(event.eventType_, eventData);
+        }
+    }
+}
+
+void FrameReplay::WriteFrame(const FrameRecord& frame)
+{
+    recordFile_->WriteFloat(frame.timeStep_);
+
+    recordFile_->WriteVLE(frame.nodeStates_.size());
+    for (const NodeState& state : frame.nodeStates_)
+    {
+        recordFile_->WriteUInt(state.nodeId_);
+        recordFile_->WriteVector3(state.position_);
+        recordFile_->WriteQuaternion(state.rotation_);
+        recordFile_->WriteVector3(state.scale_);
+    }
+
+    recordFile_->WriteVLE(frame.events_.size());
+    for (const RecordedEvent& event : frame.events_)
+    {
+        recordFile_->WriteStringHash(event.eventType_);
+        recordFile_->WriteVariantMap(event.eventData_);
+    }
+}
+
+void FrameReplay::WriteTimingRow(unsigned frameNumber, float timeStep)
+{
+    auto* frameBudget = GetSubsystem<FrameBudget>();
+
+    if (!timingHeaderWritten_)
+    {
+        ea::string header = "Frame,TimeStepMs";
+        if (frameBudget)
+        {
+            for (const FrameBudgetInfo& counter : frameBudget->GetCounters())
+                header += Format(",{}", counter.name_);
+        }
+        timingFile_->WriteLine(header);
+        timingHeaderWritten_ = true;
+    }
+
+    ea::string row = Format("{},{:.3f}", frameNumber, timeStep * 1000.0f);
+    if (frameBudget)
+    {
+        for (const FrameBudgetInfo& counter : frameBudget->GetCounters())
+            row += Format(",{:.3f}", counter.lastFrameMs_);
+    }
+    timingFile_->WriteLine(row);
+}
+
+}
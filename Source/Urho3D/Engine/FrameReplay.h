@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+
+namespace Urho3D
+{
+
+class File;
+class Node;
+class Scene;
+
+/// Frame capture and replay harness. While recording, writes the timestep, the transforms of the tracked
+/// nodes (typically cameras) and any events recorded through RecordEvent() for each frame into a compact
+/// binary stream. During playback the stream drives the engine deterministically: the recorded timesteps
+/// are forced through Engine::SetNextTimeStep(), the tracked node transforms are reapplied, and the
+/// recorded events are re-sent through the scene so that gameplay code can respawn its entities. Works in
+/// headless mode, which makes it suitable for validating engine or content upgrades against captured
+/// production workloads. Optionally emits per-frame subsystem timings from the FrameBudget counters as CSV.
+/// Not registered by the engine; create and register as a subsystem when needed.
+class URHO3D_API FrameReplay : public Object
+{
+    URHO3D_OBJECT(FrameReplay, Object);
+
+public:
+    /// Construct.
+    explicit FrameReplay(Context* context);
+    /// Destruct. End recording or playback in progress.
+    ~FrameReplay() override;
+
+    /// Set the scene whose nodes are tracked during recording and driven during playback.
+    void SetScene(Scene* scene);
+    /// Add a node whose world transform is recorded every frame and reapplied on playback. The node is
+    /// matched by ID during playback, so the replayed scene must assign the same node IDs as the recording.
+    void AddTrackedNode(Node* node);
+    /// Remove all tracked nodes.
+    void ClearTrackedNodes();
+
+    /// Begin recording frames into a file. Return true if successful.
+    bool BeginRecording(const ea::string& fileName);
+    /// End recording and close the file.
+    void EndRecording();
+    /// Record a custom event for the current frame, for example an entity spawn. The event is re-sent
+    /// through the scene at the same frame during playback. No-op when not recording.
+    void RecordEvent(StringHash eventType, const VariantMap& eventData);
+
+    /// Begin playback of a previously recorded file. Return true if successful.
+    bool BeginPlayback(const ea::string& fileName);
+    /// End playback before the recording runs out.
+    void EndPlayback();
+    /// Set the file per-frame subsystem timings are written to as CSV during playback. The columns are the
+    /// frame number, the timestep and one column per FrameBudget counter. Must be set before BeginPlayback().
+    void SetTimingOutput(const ea::string& fileName);
+
+    /// Return the scene.
+    Scene* GetScene() const;
+    /// Return whether recording is in progress.
+    bool IsRecording() const { return recordFile_ != nullptr; }
+    /// Return whether playback is in progress.
+    bool IsPlaying() const { return playing_; }
+    /// Return number of frames recorded or played back so far.
+    unsigned GetFrameNumber() const { return frameNumber_; }
+    /// Return total number of frames in the loaded recording.
+    unsigned GetNumFrames() const { return frames_.size(); }
+
+private:
+    /// Recorded world transform of a tracked node.
+    struct NodeState
+    {
+        /// Node ID in the scene.
+        unsigned nodeId_;
+        /// World position.
+        Vector3 position_;
+        /// World rotation.
+        Quaternion rotation_;
+        /// World scale.
+        Vector3 scale_;
+    };
+
+    /// Event recorded during a frame.
+    struct RecordedEvent
+    {
+        /// Event type.
+        StringHash eventType_;
+        /// Event parameters.
+        VariantMap eventData_;
+    };
+
+    /// Contents of one recorded frame.
+    struct FrameRecord
+    {
+        /// Frame timestep in seconds.
+        float timeStep_{};
+        /// Tracked node transforms at the end of the frame.
+        ea::vector<NodeState> nodeStates_;
+        /// Events recorded during the frame.
+        ea::vector<RecordedEvent> events_;
+    };
+
+    /// Handle begin frame. Write the timing CSV row for the previous frame and apply the next one during playback.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Handle end frame. Write out the current frame during recording.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Apply a recorded frame: reapply tracked node transforms and re-send recorded events.
+    void ApplyFrame(const FrameRecord& frame);
+    /// Write one frame record to the recording file.
+    void WriteFrame(const FrameRecord& frame);
+    /// Write the timing CSV row of the frame that just ended.
+    void WriteTimingRow(unsigned frameNumber, float timeStep);
+
+    /// Scene being recorded or driven.
+    WeakPtr<Scene> scene_;
+    /// Nodes whose transforms are recorded every frame.
+    ea::vector<WeakPtr<Node>> trackedNodes_;
+    /// Destination file while recording.
+    SharedPtr<File> recordFile_;
+    /// Timing CSV file while playing back.
+    SharedPtr<File> timingFile_;
+    /// Timing CSV file name.
+    ea::string timingFileName_;
+    /// Loaded recording during playback.
+    ea::vector<FrameRecord> frames_;
+    /// Events recorded during the current frame.
+    ea::vector<RecordedEvent> pendingEvents_;
+    /// Timestep of the current frame while recording.
+    float recordTimeStep_{};
+    /// Timestep of the last applied frame while playing back.
+    float playbackTimeStep_{};
+    /// Current frame index.
+    unsigned frameNumber_{};
+    /// Playback in progress flag.
+    bool playing_{};
+    /// Timing CSV header written flag.
+    bool timingHeaderWritten_{};
+};
+
+}
@@ -62,4 +62,15 @@ ea::shared_ptr<const BakedLightmap> BakedLightMemoryCache::LoadLightmap(unsigned
     return iter != lightmapCache_.end() ? iter->second : nullptr;
 }
 
+void BakedLightMemoryCache::StoreChunkHash(const IntVector3& chunk, unsigned long long hash)
+{
+    chunkHashCache_[chunk] = hash;
+}
+
+unsigned long long BakedLightMemoryCache::LoadChunkHash(const IntVector3& chunk)
+{
+    auto iter = chunkHashCache_.find(chunk);
+    return iter != chunkHashCache_.end() ? iter->second : 0;
+}
+
 }
@@ -75,6 +75,11 @@ public:
     virtual void StoreLightmap(unsigned lightmapIndex, BakedLightmap bakedLightmap) = 0;
     /// Load baked lightmap.
     virtual ea::shared_ptr<const BakedLightmap> LoadLightmap(unsigned lightmapIndex) = 0;
+
+    /// Store hash of baking inputs for the chunk. Called when the chunk is fully baked.
+    virtual void StoreChunkHash(const IntVector3& chunk, unsigned long long hash) {}
+    /// Return hash of baking inputs for the chunk from the previous bake. Return 0 if not cached.
+    virtual unsigned long long LoadChunkHash(const IntVector3& chunk) { return 0; }
 };
 
 /// Memory lightmap cache.
@@ -96,6 +101,11 @@ public:
     /// Load baked lightmap.
     ea::shared_ptr<const BakedLightmap> LoadLightmap(unsigned lightmapIndex) override;
 
+    /// Store hash of baking inputs for the chunk.
+    void StoreChunkHash(const IntVector3& chunk, unsigned long long hash) override;
+    /// Return hash of baking inputs for the chunk from the previous bake.
+    unsigned long long LoadChunkHash(const IntVector3& chunk) override;
+
 private:
     /// Baking contexts cache.
     ea::unordered_map<IntVector3, ea::shared_ptr<const BakedSceneChunk>> bakedChunkCache_;
@@ -103,6 +113,8 @@ private:
     ea::unordered_map<unsigned, ea::shared_ptr<const LightmapChartBakedDirect>> directLightCache_;
     /// Baked lightmaps.
     ea::unordered_map<unsigned, ea::shared_ptr<const BakedLightmap>> lightmapCache_;
+    /// Chunk input hashes.
+    ea::unordered_map<IntVector3, unsigned long long> chunkHashCache_;
 };
 
 }
@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#include "../Glow/HLODBaker.h"
+
+#include "../Core/Context.h"
+#include "../Glow/BakedSceneCollector.h"
+#include "../Graphics/HLODGroup.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/ModelView.h"
+#include "../Graphics/StaticModel.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Transform model vertex from source node space into group space.
+ModelVertex TransformVertex(const ModelVertex& source, const Matrix3x4& transform)
+{
+    ModelVertex vertex = source;
+    vertex.SetPosition(transform * source.GetPosition());
+    vertex.normal_ = Vector4((transform * Vector4(static_cast<Vector3>(source.normal_), 0.0f)).Normalized(), 0.0f);
+    vertex.tangent_ = Vector4((transform * Vector4(static_cast<Vector3>(source.tangent_), 0.0f)).Normalized(),
+        source.tangent_.w_);
+    vertex.binormal_ = Vector4((transform * Vector4(static_cast<Vector3>(source.binormal_), 0.0f)).Normalized(), 0.0f);
+    return vertex;
+}
+
+/// Merge the coarsest LODs of the source models into a single proxy model with one geometry per unique material.
+SharedPtr<Model> BuildProxyModel(Context* context, const ea::vector<StaticModel*>& sourceModels,
+    const Matrix3x4& inverseGroupTransform, ea::vector<Material*>& materials)
+{
+    ea::vector<GeometryView> geometries;
+
+    for (StaticModel* sourceModel : sourceModels)
+    {
+        auto sourceView = MakeShared<ModelView>(context);
+        if (!sourceView->ImportModel(sourceModel->GetModel()))
+        {
+            URHO3D_LOGWARNING("Model '{}' cannot be merged into HLOD proxy", sourceModel->GetModel()->GetName());
+            continue;
+        }
+
+        const Matrix3x4 transform = inverseGroupTransform * sourceModel->GetNode()->GetWorldTransform();
+
+        const ea::vector<GeometryView>& sourceGeometries = sourceView->GetGeometries();
+        for (unsigned geometryIndex = 0; geometryIndex < sourceGeometries.size(); ++geometryIndex)
+        {
+            // Use the coarsest LOD of the source geometry as the stand-in for distant rendering
+            if (sourceGeometries[geometryIndex].lods_.empty())
+                continue;
+            const GeometryLODView& sourceLOD = sourceGeometries[geometryIndex].lods_.back();
+            if (sourceLOD.indices_.empty())
+                continue;
+
+            // Batch geometries by material so that the proxy costs one draw call per unique material
+            Material* material = sourceModel->GetMaterial(geometryIndex);
+            unsigned materialIndex = materials.index_of(material);
+            if (materialIndex == materials.size())
+            {
+                materials.push_back(material);
+                geometries.push_back();
+                geometries.back().lods_.resize(1);
+            }
+
+            GeometryLODView& destLOD = geometries[materialIndex].lods_[0];
+            const unsigned baseVertex = destLOD.vertices_.size();
+            for (const ModelVertex& vertex : sourceLOD.vertices_)
+                destLOD.vertices_.push_back(TransformVertex(vertex, transform));
+            for (unsigned index : sourceLOD.indices_)
+                destLOD.indices_.push_back(baseVertex + index);
+        }
+    }
+
+    if (geometries.empty())
+        return nullptr;
+
+    ModelVertexFormat vertexFormat;
+    vertexFormat.position_ = TYPE_VECTOR3;
+    vertexFormat.normal_ = TYPE_VECTOR3;
+    vertexFormat.tangent_ = TYPE_VECTOR4;
+    vertexFormat.uv_[0] = TYPE_VECTOR2;
+
+    auto modelView = MakeShared<ModelView>(context);
+    modelView->SetVertexFormat(vertexFormat);
+    modelView->SetGeometries(ea::move(geometries));
+    return modelView->ExportModel();
+}
+
+/// Baked group waiting to be instantiated in the scene.
+struct BakedHLODGroup
+{
+    /// Source static models.
+    ea::vector<StaticModel*> sourceModels_;
+    /// Proxy model.
+    SharedPtr<Model> proxyModel_;
+    /// Proxy materials, one per proxy model geometry.
+    ea::vector<Material*> materials_;
+    /// World-space center of the group.
+    Vector3 center_;
+    /// Chunk the group was baked from.
+    IntVector3 chunk_;
+};
+
+}
+
+unsigned HLODBaker::Bake(Scene* scene, BakedSceneCollector* collector, const HLODBakingSettings& settings)
+{
+    if (!scene || !collector)
+        return 0;
+
+    Context* context = scene->GetContext();
+
+    // Collect and merge geometry while the scene is locked, but instantiate groups only after unlocking
+    ea::vector<BakedHLODGroup> bakedGroups;
+
+    collector->LockScene(scene, settings.chunkSize_);
+    const ea::vector<IntVector3> chunks = collector->GetChunks();
+    for (const IntVector3& chunk : chunks)
+    {
+        const ea::vector<Component*> chunkGeometries = collector->GetUniqueGeometries(chunk);
+
+        // Merge only plain static models with a model assigned. Groups, skyboxes and other
+        // specialized drawables are left alone.
+        ea::vector<StaticModel*> sourceModels;
+        for (Component* geometry : chunkGeometries)
+        {
+            if (geometry->GetType() == StaticModel::GetTypeStatic())
+            {
+                auto* staticModel = static_cast<StaticModel*>(geometry);
+                if (staticModel->GetModel())
+                    sourceModels.push_back(staticModel);
+            }
+        }
+
+        if (sourceModels.size() < settings.minModelsPerGroup_)
+            continue;
+
+        const Vector3 center = collector->GetChunkBoundingBox(chunk).Center();
+        const Matrix3x4 inverseGroupTransform = Matrix3x4(center, Quaternion::IDENTITY, 1.0f).Inverse();
+
+        ea::vector<Material*> materials;
+        SharedPtr<Model> proxyModel = BuildProxyModel(context, sourceModels, inverseGroupTransform, materials);
+        if (!proxyModel)
+            continue;
+
+        BakedHLODGroup bakedGroup;
+        bakedGroup.sourceModels_ = ea::move(sourceModels);
+        bakedGroup.proxyModel_ = proxyModel;
+        bakedGroup.materials_ = ea::move(materials);
+        bakedGroup.center_ = center;
+        bakedGroup.chunk_ = chunk;
+        bakedGroups.push_back(ea::move(bakedGroup));
+    }
+    collector->UnlockScene();
+
+    auto* cache = context->GetCache();
+    for (const BakedHLODGroup& bakedGroup : bakedGroups)
+    {
+        const IntVector3& chunk = bakedGroup.chunk_;
+        Model* proxyModel = bakedGroup.proxyModel_;
+
+        proxyModel->SetName(Format("{}Proxy_{}_{}_{}.mdl",
+            settings.modelNamePrefix_, chunk.x_, chunk.y_, chunk.z_));
+        cache->AddManualResource(proxyModel);
+
+        if (!settings.outputDirectory_.empty())
+        {
+            const ea::string fileName = AddTrailingSlash(settings.outputDirectory_) + proxyModel->GetName();
+            context->GetFileSystem()->CreateDirsRecursive(GetPath(fileName));
+            if (!proxyModel->SaveFile(fileName))
+                URHO3D_LOGWARNING("Cannot save HLOD proxy model to '{}'", fileName);
+        }
+
+        Node* groupNode = scene->CreateChild(Format("HLOD_{}_{}_{}", chunk.x_, chunk.y_, chunk.z_));
+        groupNode->SetWorldPosition(bakedGroup.center_);
+
+        Node* proxyNode = groupNode->CreateChild("HLODProxy");
+        auto* proxyStaticModel = proxyNode->CreateComponent<StaticModel>();
+        proxyStaticModel->SetModel(proxyModel);
+        for (unsigned i = 0; i < bakedGroup.materials_.size(); ++i)
+            proxyStaticModel->SetMaterial(i, bakedGroup.materials_[i]);
+        proxyNode->SetEnabled(false);
+
+        auto* group = groupNode->CreateComponent<HLODGroup>();
+        group->SetDistance(settings.distance_);
+        group->SetProxyNode(proxyNode);
+        for (StaticModel* sourceModel : bakedGroup.sourceModels_)
+            group->AddSourceNode(sourceModel->GetNode());
+    }
+
+    return bakedGroups.size();
+}
+
+}
@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+#include <EASTL/string.h>
+
+namespace Urho3D
+{
+
+class BakedSceneCollector;
+class Scene;
+
+/// Settings of HLOD baking.
+struct HLODBakingSettings
+{
+    /// Size of the chunk. Each chunk of the scene produces at most one HLOD group.
+    Vector3 chunkSize_{128.0f, 128.0f, 128.0f};
+    /// Camera distance beyond which the proxies are shown.
+    float distance_{200.0f};
+    /// Minimum number of static models within a chunk to justify a group.
+    unsigned minModelsPerGroup_{8};
+    /// Resource name prefix of generated proxy models.
+    ea::string modelNamePrefix_{"HLOD/"};
+    /// Output directory for saving generated proxy models. If empty, the models are kept as manual resources only.
+    ea::string outputDirectory_;
+};
+
+/// Bakes hierarchical LOD groups for static scene geometry. For every chunk of the scene containing enough static
+/// models, the coarsest LODs of the models are merged into one proxy model with a single geometry per unique
+/// material, and an HLODGroup component is created that swaps the originals for the proxy beyond the distance.
+class URHO3D_API HLODBaker
+{
+public:
+    /// Construct.
+    HLODBaker() {}
+
+    /// Bake HLOD groups for the scene. Return number of groups created.
+    unsigned Bake(Scene* scene, BakedSceneCollector* collector, const HLODBakingSettings& settings);
+};
+
+}
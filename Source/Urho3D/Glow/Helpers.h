@@ -34,6 +34,7 @@
 
 #include <EASTL/string.h>
 
+#include <atomic>
 #include <future>
 
 namespace Urho3D
@@ -61,6 +62,35 @@ void ParallelFor(unsigned count, unsigned numTasks, const T& callback)
         task.wait();
 }
 
+/// Parallel loop with dynamic scheduling. Tasks pull small batches of elements from a shared counter,
+/// so unevenly expensive elements don't leave tasks idle at the end of the loop.
+template <class T>
+void ParallelForDynamic(unsigned count, unsigned numTasks, unsigned batchSize, const T& callback)
+{
+    std::atomic<unsigned> nextIndex{ 0 };
+
+    // Post async tasks
+    ea::vector<std::future<void>> tasks;
+    for (unsigned i = 0; i < numTasks; ++i)
+    {
+        tasks.push_back(std::async([&]()
+        {
+            for (;;)
+            {
+                const unsigned fromIndex = nextIndex.fetch_add(batchSize, std::memory_order_relaxed);
+                if (fromIndex >= count)
+                    break;
+                const unsigned toIndex = ea::min(fromIndex + batchSize, count);
+                callback(fromIndex, toIndex);
+            }
+        }));
+    }
+
+    // Wait for async tasks
+    for (auto& task : tasks)
+        task.wait();
+}
+
 /// Load render path.
 inline SharedPtr<RenderPath> LoadRenderPath(Context* context, const ea::string& renderPathName)
 {
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#include "../Glow/ImpostorBaker.h"
+
+#include "../Core/Context.h"
+#include "../Glow/Helpers.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/Octree.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/StaticModel.h"
+#include "../Graphics/Texture2D.h"
+#include "../Graphics/View.h"
+#include "../Graphics/Viewport.h"
+#include "../Graphics/Zone.h"
+#include "../IO/Log.h"
+#include "../Resource/Image.h"
+#include "../Scene/Scene.h"
+
+namespace Urho3D
+{
+
+SharedPtr<Image> ImpostorBaker::BakeAtlas(Context* context, Model* model,
+    const ea::vector<Material*>& materials, const ImpostorBakingSettings& settings)
+{
+    Graphics* graphics = context->GetGraphics();
+    Renderer* renderer = context->GetRenderer();
+    if (!graphics || !graphics->IsInitialized() || !renderer)
+    {
+        URHO3D_LOGERROR("Cannot bake impostor atlas without initialized graphics subsystem");
+        return nullptr;
+    }
+
+    if (!model || settings.numAngles_ == 0 || settings.frameSize_ == 0)
+        return nullptr;
+
+    SharedPtr<RenderPath> renderPath = LoadRenderPath(context, settings.renderPathName_);
+    if (!renderPath)
+    {
+        URHO3D_LOGERROR("Cannot load render path \"{}\"", settings.renderPathName_);
+        return nullptr;
+    }
+
+    // Setup baking scene: the model at the origin, flat white ambient and transparent background
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    auto* zone = scene->CreateComponent<Zone>();
+    zone->SetBoundingBox(BoundingBox(-M_LARGE_VALUE, M_LARGE_VALUE));
+    zone->SetAmbientColor(Color::WHITE);
+    zone->SetFogColor(Color::TRANSPARENT_BLACK);
+
+    Node* modelNode = scene->CreateChild();
+    auto* staticModel = modelNode->CreateComponent<StaticModel>();
+    staticModel->SetModel(model);
+    for (unsigned i = 0; i < materials.size(); ++i)
+        staticModel->SetMaterial(i, materials[i]);
+
+    // Fit the whole model into the frame from any angle
+    const BoundingBox boundingBox = model->GetBoundingBox();
+    const Vector3 center = boundingBox.Center();
+    const float radius = Max(boundingBox.HalfSize().Length(), M_EPSILON);
+
+    Node* cameraNode = scene->CreateChild();
+    auto* camera = cameraNode->CreateComponent<Camera>();
+    camera->SetOrthographic(true);
+    camera->SetOrthoSize(2.0f * radius);
+    camera->SetFarClip(4.0f * radius);
+
+    // Layout frames in a row-major square grid
+    const unsigned numColumns = static_cast<unsigned>(Ceil(Sqrt(static_cast<float>(settings.numAngles_))));
+    const unsigned numRows = (settings.numAngles_ + numColumns - 1) / numColumns;
+    const int frameSize = static_cast<int>(settings.frameSize_);
+
+    auto atlas = MakeShared<Image>(context);
+    atlas->SetSize(static_cast<int>(numColumns) * frameSize, static_cast<int>(numRows) * frameSize, 4);
+    atlas->Clear(Color::TRANSPARENT_BLACK);
+
+    if (!graphics->BeginFrame())
+    {
+        URHO3D_LOGERROR("Failed to begin impostor atlas rendering");
+        return nullptr;
+    }
+
+    Texture* renderTexture = renderer->GetScreenBuffer(
+        frameSize, frameSize, Graphics::GetRGBAFormat(), 1, true, false, false, false);
+    RenderSurface* renderSurface = static_cast<Texture2D*>(renderTexture)->GetRenderSurface();
+
+    Viewport viewport(context);
+    viewport.SetCamera(camera);
+    viewport.SetRect(IntRect::ZERO);
+    viewport.SetRenderPath(renderPath);
+    viewport.SetScene(scene);
+
+    Image frameImage(context);
+    for (unsigned angleIndex = 0; angleIndex < settings.numAngles_; ++angleIndex)
+    {
+        // Orbit the camera around the vertical axis, starting from the +Z view
+        const Quaternion rotation(360.0f * angleIndex / settings.numAngles_, Vector3::UP);
+        cameraNode->SetPosition(center + rotation * Vector3::BACK * 2.0f * radius);
+        cameraNode->LookAt(center);
+
+        View view(context);
+        view.Define(renderSurface, &viewport);
+        view.Update(FrameInfo());
+        view.Render();
+
+        if (!static_cast<Texture2D*>(renderTexture)->GetImage(frameImage))
+        {
+            URHO3D_LOGERROR("Failed to read back impostor frame {}", angleIndex);
+            graphics->EndFrame();
+            return nullptr;
+        }
+
+        const int x = static_cast<int>(angleIndex % numColumns) * frameSize;
+        const int y = static_cast<int>(angleIndex / numColumns) * frameSize;
+        atlas->SetSubimage(&frameImage, IntRect(x, y, x + frameSize, y + frameSize));
+    }
+
+    graphics->EndFrame();
+    return atlas;
+}
+
+}
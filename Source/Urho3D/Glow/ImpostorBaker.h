@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Context;
+class Image;
+class Material;
+class Model;
+
+/// Settings of impostor atlas baking.
+struct ImpostorBakingSettings
+{
+    /// Number of horizontal view angles around the vertical axis.
+    unsigned numAngles_{8};
+    /// Size of one atlas frame in texels.
+    unsigned frameSize_{256};
+    /// Render path used for baking frames.
+    ea::string renderPathName_{"RenderPaths/Forward.xml"};
+};
+
+/// Bakes impostor texture atlases for models. The model is rendered from evenly spaced horizontal angles into a
+/// square grid of frames, in azimuth order starting from the +Z view. The resulting atlas is used by the Impostor
+/// component to replace distant models with a single billboard.
+class URHO3D_API ImpostorBaker
+{
+public:
+    /// Construct.
+    ImpostorBaker() {}
+
+    /// Bake impostor atlas for the model rendered with given materials. Return null on failure.
+    SharedPtr<Image> BakeAtlas(Context* context, Model* model,
+        const ea::vector<Material*>& materials, const ImpostorBakingSettings& settings);
+};
+
+}
@@ -38,6 +38,7 @@
 #include "../Graphics/Model.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../IO/VectorBuffer.h"
 #include "../Math/TetrahedralMesh.h"
 #include "../Resource/Image.h"
 #include "../Resource/ResourceCache.h"
@@ -67,6 +68,33 @@ ea::string GetResourceName(ResourceCache* cache, const ea::string& fileName)
 /// Per-component min for 3D integer vector.
 IntVector3 MinIntVector3(const IntVector3& lhs, const IntVector3& rhs) { return VectorMin(lhs, rhs); }
 
+/// Combine 64-bit FNV-1a hash with the given bytes.
+void CombineHash64(unsigned long long& hash, const void* data, unsigned size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+/// Combine hash with serialized state and world transform of the component.
+/// Per-component hashes are combined with addition so that the query order doesn't matter.
+void CombineComponentHash(unsigned long long& hash, Component* component, VectorBuffer& buffer)
+{
+    unsigned long long componentHash = 0xcbf29ce484222325ull;
+
+    const Matrix3x4 worldTransform = component->GetNode()->GetWorldTransform();
+    CombineHash64(componentHash, &worldTransform, sizeof(worldTransform));
+
+    buffer.Clear();
+    component->Save(buffer);
+    CombineHash64(componentHash, buffer.GetData(), buffer.GetSize());
+
+    hash += componentHash;
+}
+
 /// Swizzle components of 3D integer vector.
 unsigned long long Swizzle(const IntVector3& vec, const IntVector3& base = IntVector3::ZERO)
 {
@@ -211,6 +239,7 @@ struct IncrementalLightBaker::Impl
             }
 
             // Update base index
+            chunkCharts_[chunk] = ea::make_pair(numLightmapCharts_, static_cast<unsigned>(charts.size()));
             numLightmapCharts_ += charts.size();
         }
 
@@ -230,14 +259,55 @@ struct IncrementalLightBaker::Impl
         }
     }
 
-    /// Generate baking chunks.
+    /// Generate baking chunks. Chunks whose baking inputs are unchanged since the last bake are reused from the cache.
     void GenerateBakingChunks()
     {
+        chunkHashes_.clear();
+        dirtyChunks_.clear();
+        staleIndirectChunks_.clear();
+
+        VectorBuffer hashBuffer;
         for (const IntVector3& chunk : chunks_)
         {
+            const unsigned long long hash = CalculateChunkHash(chunk, hashBuffer);
+            chunkHashes_[chunk] = hash;
+
+            if (hash == cache_->LoadChunkHash(chunk) && cache_->LoadBakedChunk(chunk))
+                continue;
+
+            dirtyChunks_.insert(chunk);
             BakedSceneChunk bakedChunk = CreateBakedSceneChunk(context_, *collector_, chunk, settings_);
             cache_->StoreBakedChunk(chunk, ea::move(bakedChunk));
         }
+
+        // Indirect light of a chunk gathers from surfaces around it, so changes ripple to all chunks
+        // within the influence radius of a dirty chunk
+        const Vector3& chunkSize = settings_.incremental_.chunkSize_;
+        const float influenceRadius = GetInfluenceRadius();
+        const IntVector3 chunkRadius{
+            CeilToInt(influenceRadius / chunkSize.x_),
+            CeilToInt(influenceRadius / chunkSize.y_),
+            CeilToInt(influenceRadius / chunkSize.z_) };
+
+        for (const IntVector3& chunk : chunks_)
+        {
+            for (const IntVector3& dirtyChunk : dirtyChunks_)
+            {
+                const IntVector3 distance = chunk - dirtyChunk;
+                if (Abs(distance.x_) <= chunkRadius.x_ && Abs(distance.y_) <= chunkRadius.y_
+                    && Abs(distance.z_) <= chunkRadius.z_)
+                {
+                    staleIndirectChunks_.insert(chunk);
+                    break;
+                }
+            }
+        }
+
+        if (dirtyChunks_.size() != chunks_.size())
+        {
+            URHO3D_LOGINFO("Reusing baked data for {} of {} chunks",
+                chunks_.size() - dirtyChunks_.size(), chunks_.size());
+        }
     }
 
     /// Step direct light for charts.
@@ -246,6 +316,7 @@ struct IncrementalLightBaker::Impl
         for (const IntVector3 chunk : chunks_)
         {
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
+            const bool dirty = dirtyChunks_.find(chunk) != dirtyChunks_.end();
 
             // Bake direct lighting
             for (unsigned i = 0; i < bakedChunk->lightmaps_.size(); ++i)
@@ -254,6 +325,11 @@ struct IncrementalLightBaker::Impl
                     return false;
 
                 const unsigned lightmapIndex = bakedChunk->lightmaps_[i];
+
+                // Direct light of an unchanged chunk is still valid
+                if (!dirty && cache_->LoadDirectLight(lightmapIndex))
+                    continue;
+
                 const LightmapChartGeometryBuffer& geometryBuffer = bakedChunk->geometryBuffers_[i];
                 LightmapChartBakedDirect bakedDirect{ geometryBuffer.lightmapSize_ };
 
@@ -292,6 +368,15 @@ struct IncrementalLightBaker::Impl
 
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
 
+            // Skip if neither the chunk nor its neighborhood changed and the outputs are still cached
+            if (staleIndirectChunks_.find(chunk) == staleIndirectChunks_.end())
+            {
+                const bool outputsCached = ea::all_of(bakedChunk->lightmaps_.begin(), bakedChunk->lightmaps_.end(),
+                    [&](unsigned lightmapIndex) { return cache_->LoadLightmap(lightmapIndex) != nullptr; });
+                if (outputsCached)
+                    continue;
+            }
+
             // Collect required direct lightmaps
             ea::vector<ea::shared_ptr<const LightmapChartBakedDirect>> bakedDirectLightmapsRefs(numLightmapCharts_);
             ea::vector<const LightmapChartBakedDirect*> bakedDirectLightmaps(numLightmapCharts_);
@@ -379,6 +464,9 @@ struct IncrementalLightBaker::Impl
                         groupName, chunk.ToString());
                 }
             }
+
+            // The chunk is fully baked now, remember its input hash so the next bake can reuse it
+            cache_->StoreChunkHash(chunk, chunkHashes_[chunk]);
         }
         return true;
     }
@@ -405,6 +493,10 @@ struct IncrementalLightBaker::Impl
         // Process all chunks
         for (const IntVector3 chunk : chunks_)
         {
+            // Images of unchanged chunks are already on disk
+            if (staleIndirectChunks_.find(chunk) == staleIndirectChunks_.end())
+                continue;
+
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
             for (unsigned i = 0; i < bakedChunk->lightmaps_.size(); ++i)
             {
@@ -448,6 +540,46 @@ struct IncrementalLightBaker::Impl
     }
 
 private:
+    /// Return radius around the chunk within which scene changes affect its baked light.
+    float GetInfluenceRadius() const
+    {
+        return ea::max(settings_.incremental_.indirectPadding_,
+            settings_.incremental_.directionalLightShadowDistance_);
+    }
+
+    /// Calculate hash of all baking inputs affecting the chunk.
+    unsigned long long CalculateChunkHash(const IntVector3& chunk, VectorBuffer& buffer) const
+    {
+        unsigned long long hash = 0xcbf29ce484222325ull;
+
+        // Hash settings that affect baked output
+        CombineHash64(hash, &settings_.charting_.lightmapSize_, sizeof(settings_.charting_.lightmapSize_));
+        CombineHash64(hash, &settings_.directChartTracing_.maxSamples_, sizeof(settings_.directChartTracing_.maxSamples_));
+        CombineHash64(hash, &settings_.indirectChartTracing_.maxSamples_, sizeof(settings_.indirectChartTracing_.maxSamples_));
+        CombineHash64(hash, &settings_.indirectChartTracing_.maxBounces_, sizeof(settings_.indirectChartTracing_.maxBounces_));
+        CombineHash64(hash, &settings_.properties_.emissionBrightness_, sizeof(settings_.properties_.emissionBrightness_));
+
+        // Hash chart allocation so that shifts in global lightmap indices invalidate the chunk
+        const auto chartsIter = chunkCharts_.find(chunk);
+        if (chartsIter != chunkCharts_.end())
+            CombineHash64(hash, &chartsIter->second, sizeof(chartsIter->second));
+
+        // Hash every object that may affect lighting within the chunk
+        const float influenceRadius = GetInfluenceRadius();
+        BoundingBox volume = collector_->GetChunkBoundingBox(chunk);
+        volume.min_ -= Vector3::ONE * influenceRadius;
+        volume.max_ += Vector3::ONE * influenceRadius;
+
+        for (Component* geometry : collector_->GetGeometriesInBoundingBox(chunk, volume))
+            CombineComponentHash(hash, geometry, buffer);
+        for (Light* light : collector_->GetLightsInBoundingBox(chunk, volume))
+            CombineComponentHash(hash, light, buffer);
+        for (LightProbeGroup* group : collector_->GetLightProbeGroupsInBoundingBox(chunk, volume))
+            CombineComponentHash(hash, group, buffer);
+
+        return hash;
+    }
+
     /// Return lightmap file name.
     ea::string GetLightmapFileName(unsigned lightmapIndex)
     {
@@ -481,6 +613,14 @@ private:
     ea::vector<IntVector3> chunks_;
     /// Number of lightmap charts.
     unsigned numLightmapCharts_{};
+    /// First lightmap chart index and number of charts per chunk.
+    ea::unordered_map<IntVector3, ea::pair<unsigned, unsigned>> chunkCharts_;
+    /// Hashes of baking inputs for chunks, calculated for the current bake.
+    ea::unordered_map<IntVector3, unsigned long long> chunkHashes_;
+    /// Chunks whose baking inputs changed since the last fully completed bake.
+    ea::hash_set<IntVector3> dirtyChunks_;
+    /// Chunks that need indirect light update: dirty chunks and their neighborhood.
+    ea::hash_set<IntVector3> staleIndirectChunks_;
 };
 
 IncrementalLightBaker::~IncrementalLightBaker()
@@ -46,6 +46,31 @@ float CalculateBiasScale(const Vector3& position)
     return ea::min(1.0f, ea::max({ Abs(position.x_), Abs(position.y_), Abs(position.z_) }));
 }
 
+/// Size of a texel tile traced as one batch.
+const unsigned texelTileSize = 8;
+
+/// Build tile-swizzled traversal order for square lightmap charts. Texels of an 8x8 tile map to consecutive
+/// indices so that each batch of rays starts from a compact surface area and stays coherent.
+ea::vector<unsigned> BuildTexelTileOrder(unsigned lightmapSize)
+{
+    ea::vector<unsigned> order;
+    order.reserve(lightmapSize * lightmapSize);
+    for (unsigned tileY = 0; tileY < lightmapSize; tileY += texelTileSize)
+    {
+        for (unsigned tileX = 0; tileX < lightmapSize; tileX += texelTileSize)
+        {
+            const unsigned endY = ea::min(tileY + texelTileSize, lightmapSize);
+            const unsigned endX = ea::min(tileX + texelTileSize, lightmapSize);
+            for (unsigned y = tileY; y < endY; ++y)
+            {
+                for (unsigned x = tileX; x < endX; ++x)
+                    order.push_back(y * lightmapSize + x);
+            }
+        }
+    }
+    return order;
+}
+
 /// Generate random 3D direction.
 void RandomDirection3(Vector3& result)
 {
@@ -386,6 +411,8 @@ struct ChartDirectTracingKernel
     bool bakeDirect_{};
     /// Whether to bake direct light for indirect lighting.
     bool bakeIndirect_{};
+    /// Tile-swizzled texel traversal order.
+    const ea::vector<unsigned>* elementOrder_{};
 
     /// Current smooth interpolated normal.
     Vector3 currentSmoothNormal_;
@@ -398,6 +425,9 @@ struct ChartDirectTracingKernel
     /// Return number of elements to trace.
     unsigned GetNumElements() const { return bakedDirect_->directLight_.size(); }
 
+    /// Map loop index to element index.
+    unsigned MapElement(unsigned index) const { return elementOrder_ ? (*elementOrder_)[index] : index; }
+
     /// Return number of samples.
     unsigned GetNumSamples() const { return numSamples_; }
 
@@ -487,6 +517,9 @@ struct LightProbeDirectTracingKernel
     /// Return number of elements to trace.
     unsigned GetNumElements() const { return bakedData_->Size(); }
 
+    /// Map loop index to element index.
+    unsigned MapElement(unsigned index) const { return index; }
+
     /// Return number of samples.
     unsigned GetNumSamples() const { return numSamples_; }
 
@@ -545,7 +578,7 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
     RTCScene scene = raytracerScene.GetEmbreeScene();
     const ea::vector<RaytracerGeometry>& raytracerGeometries = raytracerScene.GetGeometries();
 
-    ParallelFor(sharedKernel.GetNumElements(), settings.numTasks_,
+    ParallelForDynamic(sharedKernel.GetNumElements(), settings.numTasks_, texelTileSize * texelTileSize,
         [&](unsigned fromIndex, unsigned toIndex)
     {
         auto kernel = sharedKernel;
@@ -563,8 +596,10 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
         rayHit.ray.id = 0;
         rayHit.ray.flags = 0;
 
-        for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
+        for (unsigned index = fromIndex; index < toIndex; ++index)
         {
+            const unsigned elementIndex = kernel.MapElement(index);
+
             Vector3 position;
             if (!kernel.BeginElement(elementIndex, rayContext, position))
                 continue;
@@ -639,6 +674,8 @@ struct ChartIndirectTracingKernel
     const ea::vector<RaytracerGeometry>* raytracerGeometries_{};
     /// Settings.
     const IndirectLightTracingSettings* settings_{};
+    /// Tile-swizzled texel traversal order.
+    const ea::vector<unsigned>* elementOrder_{};
 
     /// Current position.
     Vector3 currentPosition_;
@@ -658,6 +695,9 @@ struct ChartIndirectTracingKernel
     /// Return number of elements to trace.
     unsigned GetNumElements() const { return bakedIndirect_->light_.size(); }
 
+    /// Map loop index to element index.
+    unsigned MapElement(unsigned index) const { return elementOrder_ ? (*elementOrder_)[index] : index; }
+
     /// Return number of samples.
     unsigned GetNumSamples() const { return settings_->maxSamples_; }
 
@@ -736,6 +776,9 @@ struct LightProbeIndirectTracingKernel
     /// Return number of elements to trace.
     unsigned GetNumElements() const { return bakedData_->Size(); }
 
+    /// Map loop index to element index.
+    unsigned MapElement(unsigned index) const { return index; }
+
     /// Return number of samples.
     unsigned GetNumSamples() const { return settings_->maxSamples_; }
 
@@ -783,7 +826,7 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
 {
     assert(settings.maxBounces_ <= IndirectLightTracingSettings::MaxBounces);
 
-    ParallelFor(sharedKernel.GetNumElements(), settings.numTasks_,
+    ParallelForDynamic(sharedKernel.GetNumElements(), settings.numTasks_, texelTileSize * texelTileSize,
         [&](unsigned fromIndex, unsigned toIndex)
     {
         T kernel = sharedKernel;
@@ -809,8 +852,9 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
         rayHit.ray.mask = RaytracerScene::PrimaryLODGeometry;
         rayHit.ray.flags = 0;
 
-        for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
+        for (unsigned index = fromIndex; index < toIndex; ++index)
         {
+            const unsigned elementIndex = kernel.MapElement(index);
             if (!kernel.BeginElement(elementIndex))
                 continue;
 
@@ -920,7 +964,7 @@ void PreprocessGeometryBuffer(LightmapChartGeometryBuffer& geometryBuffer,
 {
     RTCScene scene = raytracerScene.GetEmbreeScene();
     const ea::vector<RaytracerGeometry>& raytracerGeometries = raytracerScene.GetGeometries();
-    ParallelFor(geometryBuffer.positions_.size(), settings.numTasks_,
+    ParallelForDynamic(geometryBuffer.positions_.size(), settings.numTasks_, texelTileSize * texelTileSize,
         [&](unsigned fromIndex, unsigned toIndex)
     {
         RTCRayHit rayHit;
@@ -1036,8 +1080,10 @@ void BakeDirectLightForCharts(LightmapChartBakedDirect& bakedDirect, const Light
     const bool bakeDirect = light.lightMode_ == LM_BAKED;
     const bool bakeIndirect = true;
     const unsigned numSamples = CalculateNumSamples(light, settings.maxSamples_);
+    const ea::vector<unsigned> elementOrder = BuildTexelTileOrder(geometryBuffer.lightmapSize_);
     const ChartDirectTracingKernel kernel{ &bakedDirect, &geometryBuffer, &geometryBufferToRaytracer,
-        &raytracerScene.GetGeometries(), &settings, light.indirectBrightness_, numSamples, bakeDirect, bakeIndirect };
+        &raytracerScene.GetGeometries(), &settings, light.indirectBrightness_, numSamples, bakeDirect, bakeIndirect,
+        &elementOrder };
 
     if (light.lightType_ == LIGHT_DIRECTIONAL)
     {
@@ -1095,8 +1141,9 @@ void BakeIndirectLightForCharts(LightmapChartBakedIndirect& bakedIndirect,
     if (settings.maxBounces_ == 0)
         return;
 
+    const ea::vector<unsigned> elementOrder = BuildTexelTileOrder(geometryBuffer.lightmapSize_);
     const ChartIndirectTracingKernel kernel{ &bakedIndirect, &geometryBuffer, &lightProbesMesh, &lightProbesData,
-        &geometryBufferToRaytracer, &raytracerScene.GetGeometries(), &settings };
+        &geometryBufferToRaytracer, &raytracerScene.GetGeometries(), &settings, &elementOrder };
     TraceIndirectLight(kernel, bakedDirect, raytracerScene, settings);
 }
 
@@ -25,8 +25,8 @@
 #pragma once
 
 #include "../Graphics/LightBakingSettings.h"
-#include "../Math/AreaAllocator.h"
 #include "../Math/Rect.h"
+#include "../Math/SkylinePacker.h"
 #include "../Math/Vector2.h"
 #include "../Math/Vector4.h"
 
@@ -90,7 +90,7 @@ struct LightmapChart
     /// Lightmap chart size.
     unsigned lightmapSize_{};
     /// Used region allocator.
-    AreaAllocator allocator_;
+    SkylinePacker allocator_;
     /// Allocated elements.
     ea::vector<LightmapChartElement> elements_;
 
@@ -100,7 +100,7 @@ struct LightmapChart
     LightmapChart(unsigned index, unsigned size)
         : index_(index)
         , lightmapSize_{ size }
-        , allocator_{ static_cast<int>(size), static_cast<int>(size), 0, 0, false }
+        , allocator_{ static_cast<int>(size), static_cast<int>(size), 0, 0 }
     {
     }
 };
@@ -139,18 +139,49 @@ void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
     });
 }
 
+/// Apply the filter repeatedly with doubling kernel step (a-trous wavelet denoising).
+template <class T>
+void FilterArrayMultipass(const ea::vector<T>& input, ea::vector<T>& output,
+    const LightmapChartGeometryBuffer& geometryBuffer,
+    const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
+{
+    const unsigned numIterations = ea::max(1u, params.numIterations_);
+    if (numIterations == 1)
+    {
+        FilterArray(input, output, geometryBuffer, params, numTasks);
+        return;
+    }
+
+    ea::vector<T> bufferA(input.size());
+    ea::vector<T> bufferB;
+    if (numIterations > 2)
+        bufferB.resize(input.size());
+
+    const ea::vector<T>* source = &input;
+    for (unsigned i = 0; i < numIterations; ++i)
+    {
+        EdgeStoppingGaussFilterParameters iterationParams = params;
+        iterationParams.upscale_ = params.upscale_ << i;
+
+        ea::vector<T>& destination = i == numIterations - 1 ? output
+            : (source == &bufferA ? bufferB : bufferA);
+        FilterArray(*source, destination, geometryBuffer, iterationParams, numTasks);
+        source = &destination;
+    }
+}
+
 }
 
 void FilterDirectLight(const LightmapChartBakedDirect& bakedDirect, ea::vector<Vector3>& outputBuffer,
     const LightmapChartGeometryBuffer& geometryBuffer, const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
 {
-    FilterArray(bakedDirect.directLight_, outputBuffer, geometryBuffer, params, numTasks);
+    FilterArrayMultipass(bakedDirect.directLight_, outputBuffer, geometryBuffer, params, numTasks);
 }
 
 void FilterIndirectLight(const LightmapChartBakedIndirect& bakedIndirect, ea::vector<Vector4>& outputBuffer,
     const LightmapChartGeometryBuffer& geometryBuffer, const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
 {
-    FilterArray(bakedIndirect.light_, outputBuffer, geometryBuffer, params, numTasks);
+    FilterArrayMultipass(bakedIndirect.light_, outputBuffer, geometryBuffer, params, numTasks);
 }
 
 }
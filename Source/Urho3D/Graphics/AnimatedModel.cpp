@@ -28,6 +28,7 @@
 #include "../Core/Profiler.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
+#include "../Graphics/AnimationController.h"
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
@@ -40,6 +41,7 @@
 #include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/SoftwareModelAnimator.h"
+#include "../Graphics/Texture2D.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
@@ -53,6 +55,11 @@ namespace Urho3D
 
 extern const char* GEOMETRY_CATEGORY;
 
+/// Maximum number of morphs supported by GPU morphing. Must match the uniform array size in the MORPHTEX vertex shader code.
+static const unsigned MAX_GPU_MORPHS = 64;
+/// Width of the morph delta texture. Must match the constant in the MORPHTEX vertex shader code.
+static const unsigned MORPH_TEXTURE_WIDTH = 1024;
+
 static const StringVector animationStatesStructureElementNames =
 {
     "Anim State Count",
@@ -73,6 +80,7 @@ static const unsigned MAX_ANIMATION_STATES = 256;
 
 AnimatedModel::AnimatedModel(Context* context) :
     StaticModel(context),
+    staticBoneBoundingBox_(Vector3::ZERO, Vector3::ZERO),
     animationLodFrameNumber_(0),
     animationLodBias_(1.0f),
     animationLodTimer_(-1.0f),
@@ -123,6 +131,13 @@ void AnimatedModel::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Shadow Distance", GetShadowDistance, SetShadowDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Animation LOD Bias", GetAnimationLodBias, SetAnimationLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("GPU Morphing", GetGPUMorphing, SetGPUMorphing, bool, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Use Static Bone Box", bool, useStaticBoneBoundingBox_, OnStaticBoneBoundingBoxChanged, false,
+        AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Static Bone Box Min", Vector3, staticBoneBoundingBox_.min_, OnStaticBoneBoundingBoxChanged,
+        Vector3::ZERO, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Static Bone Box Max", Vector3, staticBoneBoundingBox_.max_, OnStaticBoneBoundingBoxChanged,
+        Vector3::ZERO, AM_DEFAULT);
     URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Bone Animation Enabled", GetBonesEnabledAttr, SetBonesEnabledAttr, VariantVector,
         Variant::emptyVariantVector, AM_FILE | AM_NOEDIT);
@@ -244,6 +259,10 @@ void AnimatedModel::ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQ
 
 void AnimatedModel::Update(const FrameInfo& frame)
 {
+    // Advance the animation controller first if it deferred its update to the threaded drawable update
+    if (auto* controller = node_->GetComponent<AnimationController>())
+        controller->ApplyDeferredUpdate();
+
     // If node was invisible last frame, need to decide animation LOD distance here
     // If headless, retain the current animation distance (should be 0)
     if (frame.camera_ && abs((int)frame.frameNumber_ - (int)viewFrameNumber_) > 1)
@@ -361,6 +380,9 @@ void AnimatedModel::SetModel(Model* model, bool createBones)
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
+    // Restore the original materials and release GPU morphing resources of the previous model
+    RemoveGPUMorphs();
+
     model_ = model;
 
     if (model)
@@ -462,6 +484,23 @@ void AnimatedModel::SetModel(Model* model, bool createBones)
     MarkNetworkUpdate();
 }
 
+void AnimatedModel::SetMaterial(Material* material)
+{
+    StaticModel::SetMaterial(material);
+
+    // Morph material clones are recreated from the new material on the next update
+    if (useGPUMorphs_)
+        MarkMorphsDirty();
+}
+
+bool AnimatedModel::SetMaterial(unsigned index, Material* material)
+{
+    bool success = StaticModel::SetMaterial(index, material);
+    if (success && useGPUMorphs_)
+        MarkMorphsDirty();
+    return success;
+}
+
 AnimationState* AnimatedModel::AddAnimationState(Animation* animation)
 {
     if (!isMaster_)
@@ -576,9 +615,12 @@ void AnimatedModel::SetMorphWeight(unsigned index, float weight)
     if (index >= morphs_.size())
         return;
 
-    // If morph vertex buffers have not been created yet, create now
-    if (weight != 0.0f && !modelAnimator_)
-        CloneGeometries();
+    // If morph vertex buffers have not been created yet, create now. Prefer GPU morphing when enabled and supported
+    if (weight != 0.0f && !modelAnimator_ && !useGPUMorphs_)
+    {
+        if (!gpuMorphing_ || !InitializeGPUMorphs())
+            CloneGeometries();
+    }
 
     if (weight != morphs_[index].weight_)
     {
@@ -603,6 +645,46 @@ void AnimatedModel::SetMorphWeight(unsigned index, float weight)
     }
 }
 
+void AnimatedModel::SetGPUMorphing(bool enable)
+{
+    if (enable == gpuMorphing_)
+        return;
+
+    gpuMorphing_ = enable;
+
+    bool hasActiveMorphs = false;
+    for (unsigned i = 0; i < morphs_.size(); ++i)
+    {
+        if (morphs_[i].weight_ != 0.0f)
+            hasActiveMorphs = true;
+    }
+
+    if (!enable && useGPUMorphs_)
+    {
+        // Fall back to the CPU morphing path
+        RemoveGPUMorphs();
+        if (hasActiveMorphs)
+            CloneGeometries();
+        MarkMorphsDirty();
+    }
+    else if (enable && modelAnimator_ && !softwareSkinning_)
+    {
+        // Release the cloned vertex buffers and restore the original geometries before switching
+        modelAnimator_ = nullptr;
+        const ea::vector<ea::vector<SharedPtr<Geometry> > >& modelGeometries = model_->GetGeometries();
+        for (unsigned i = 0; i < geometries_.size() && i < modelGeometries.size(); ++i)
+            geometries_[i] = modelGeometries[i];
+        ResetLodLevels();
+
+        // If the model turns out not to be compatible, return to the CPU path
+        if (!InitializeGPUMorphs() && hasActiveMorphs)
+            CloneGeometries();
+        MarkMorphsDirty();
+    }
+
+    MarkNetworkUpdate();
+}
+
 void AnimatedModel::SetMorphWeight(const ea::string& name, float weight)
 {
     for (unsigned i = 0; i < morphs_.size(); ++i)
@@ -933,6 +1015,14 @@ const ea::vector<unsigned char>& AnimatedModel::GetMorphsAttr() const
 
 void AnimatedModel::UpdateBoneBoundingBox()
 {
+    if (useStaticBoneBoundingBox_)
+    {
+        boneBoundingBox_ = staticBoneBoundingBox_;
+        boneBoundingBoxDirty_ = false;
+        worldBoundingBoxDirty_ = true;
+        return;
+    }
+
     if (skeleton_.GetNumBones())
     {
         // The bone bounding box is in local space, so need the node's inverse transform
@@ -978,8 +1068,9 @@ void AnimatedModel::OnMarkedDirty(Node* node)
     if (skeleton_.GetNumBones())
     {
         skinningDirty_ = true;
-        // Bone bounding box doesn't need to be marked dirty when only the base scene node moves
-        if (node != node_)
+        // Bone bounding box doesn't need to be marked dirty when only the base scene node moves, or when a
+        // conservative static box stands in for the per-bone merge
+        if (node != node_ && !useStaticBoneBoundingBox_)
             boneBoundingBoxDirty_ = true;
     }
 }
@@ -1132,6 +1223,11 @@ void AnimatedModel::MarkMorphsDirty()
 
 void AnimatedModel::CloneGeometries()
 {
+    // In headless mode the cloned vertex data would never be rendered, so keep the model's original geometries.
+    // Animation and morph weight state is still tracked normally
+    if (!GetSubsystem<Graphics>())
+        return;
+
     modelAnimator_ = MakeShared<SoftwareModelAnimator>(context_);
     modelAnimator_->Initialize(model_, softwareSkinning_, numSoftwareSkinningBones_);
     geometries_ = modelAnimator_->GetGeometries();
@@ -1141,6 +1237,221 @@ void AnimatedModel::CloneGeometries()
     MarkMorphsDirty();
 }
 
+bool AnimatedModel::InitializeGPUMorphs()
+{
+    auto* graphics = GetSubsystem<Graphics>();
+    if (!graphics || !model_ || morphs_.empty() || softwareSkinning_)
+        return false;
+
+#ifdef URHO3D_OPENGL
+    // The morph fetch shader requires OpenGL 3 for texelFetch and gl_VertexID
+    if (!Graphics::GetGL3Support())
+        return false;
+#else
+    // Only implemented for the OpenGL renderer
+    return false;
+#endif
+
+    if (morphs_.size() > MAX_GPU_MORPHS)
+        return false;
+
+    // All morphs must target the same vertex buffer so that the vertex index addresses the delta texture unambiguously
+    unsigned bufferIndex = M_MAX_UNSIGNED;
+    for (unsigned i = 0; i < morphs_.size(); ++i)
+    {
+        for (auto j = morphs_[i].buffers_.begin(); j != morphs_[i].buffers_.end(); ++j)
+        {
+            if (bufferIndex == M_MAX_UNSIGNED)
+                bufferIndex = j->first;
+            else if (bufferIndex != j->first)
+                return false;
+        }
+    }
+    if (bufferIndex >= model_->GetVertexBuffers().size())
+        return false;
+
+    ModelMorphTexture* morphTexture = model_->GetMorphTexture();
+    if (!morphTexture)
+    {
+        // Build the delta texture once; it is shared between the model's instances
+        VertexBuffer* buffer = model_->GetVertexBuffers()[bufferIndex];
+        const unsigned vertexCount = buffer->GetVertexCount();
+
+        VertexMaskFlags elementMask = MASK_NONE;
+        for (unsigned i = 0; i < morphs_.size(); ++i)
+        {
+            for (auto j = morphs_[i].buffers_.begin(); j != morphs_[i].buffers_.end(); ++j)
+                elementMask |= j->second.elementMask_;
+        }
+        if (!(elementMask & MASK_POSITION))
+            return false;
+
+        const bool hasNormals = (elementMask & MASK_NORMAL) ? true : false;
+        const bool hasTangents = (elementMask & MASK_TANGENT) ? true : false;
+        const unsigned texelsPerVertex = 1 + (hasNormals ? 1 : 0) + (hasTangents ? 1 : 0);
+        const unsigned totalTexels = morphs_.size() * vertexCount * texelsPerVertex;
+        const unsigned height = (totalTexels + MORPH_TEXTURE_WIDTH - 1) / MORPH_TEXTURE_WIDTH;
+        if (!vertexCount || !height)
+            return false;
+
+        // Scatter the packed <index, data> morph deltas into a dense per-vertex layout
+        ea::vector<Vector4> textureData(MORPH_TEXTURE_WIDTH * height, Vector4::ZERO);
+        for (unsigned morphIndex = 0; morphIndex < morphs_.size(); ++morphIndex)
+        {
+            auto bufferMorphIter = morphs_[morphIndex].buffers_.find(bufferIndex);
+            if (bufferMorphIter == morphs_[morphIndex].buffers_.end())
+                continue;
+
+            const VertexBufferMorph& vertexBufferMorph = bufferMorphIter->second;
+            const VertexMaskFlags morphMask = vertexBufferMorph.elementMask_;
+            const unsigned baseTexel = morphIndex * vertexCount * texelsPerVertex;
+
+            const unsigned char* srcData = vertexBufferMorph.morphData_.get();
+            unsigned morphVertexCount = vertexBufferMorph.vertexCount_;
+            while (morphVertexCount--)
+            {
+                const unsigned vertexIndex = *reinterpret_cast<const unsigned*>(srcData);
+                srcData += sizeof(unsigned);
+                if (vertexIndex >= vertexCount)
+                    return false;
+
+                Vector4* dest = &textureData[baseTexel + vertexIndex * texelsPerVertex];
+                if (morphMask & MASK_POSITION)
+                {
+                    const float* src = reinterpret_cast<const float*>(srcData);
+                    dest[0] = Vector4(src[0], src[1], src[2], 0.0f);
+                    srcData += 3 * sizeof(float);
+                }
+                if (morphMask & MASK_NORMAL)
+                {
+                    const float* src = reinterpret_cast<const float*>(srcData);
+                    dest[1] = Vector4(src[0], src[1], src[2], 0.0f);
+                    srcData += 3 * sizeof(float);
+                }
+                if (morphMask & MASK_TANGENT)
+                {
+                    const float* src = reinterpret_cast<const float*>(srcData);
+                    dest[hasNormals ? 2 : 1] = Vector4(src[0], src[1], src[2], 0.0f);
+                    srcData += 3 * sizeof(float);
+                }
+            }
+        }
+
+        auto texture = MakeShared<Texture2D>(context_);
+        texture->SetNumLevels(1);
+        texture->SetFilterMode(FILTER_NEAREST);
+        if (!texture->SetSize((int)MORPH_TEXTURE_WIDTH, (int)height, Graphics::GetRGBAFloat32Format(), TEXTURE_STATIC))
+        {
+            URHO3D_LOGERROR("Failed to create morph delta texture");
+            return false;
+        }
+        texture->SetData(0, 0, 0, texture->GetWidth(), texture->GetHeight(), &textureData[0]);
+
+        auto newMorphTexture = ea::make_unique<ModelMorphTexture>();
+        newMorphTexture->texture_ = texture;
+        newMorphTexture->bufferIndex_ = bufferIndex;
+        newMorphTexture->vertexCount_ = vertexCount;
+        newMorphTexture->elementMask_ = elementMask;
+        model_->SetMorphTexture(ea::move(newMorphTexture));
+    }
+
+    // Determine which geometries draw from the morphed vertex buffer
+    VertexBuffer* morphedBuffer = model_->GetVertexBuffers()[bufferIndex];
+    morphedGeometries_.clear();
+    morphedGeometries_.resize(geometries_.size(), false);
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        for (unsigned j = 0; j < geometries_[i].size(); ++j)
+        {
+            Geometry* geometry = geometries_[i][j];
+            if (!geometry)
+                continue;
+
+            const ea::vector<SharedPtr<VertexBuffer> >& buffers = geometry->GetVertexBuffers();
+            for (unsigned k = 0; k < buffers.size(); ++k)
+            {
+                if (buffers[k] == morphedBuffer)
+                    morphedGeometries_[i] = true;
+            }
+        }
+    }
+
+    morphMaterials_.clear();
+    morphMaterials_.resize(geometries_.size());
+    morphSourceMaterials_.clear();
+    morphSourceMaterials_.resize(geometries_.size());
+
+    useGPUMorphs_ = true;
+    MarkMorphsDirty();
+    return true;
+}
+
+void AnimatedModel::RemoveGPUMorphs()
+{
+    if (!useGPUMorphs_)
+        return;
+
+    // Restore the original materials
+    for (unsigned i = 0; i < batches_.size() && i < morphMaterials_.size(); ++i)
+    {
+        if (morphMaterials_[i] && batches_[i].material_ == morphMaterials_[i])
+            batches_[i].material_ = morphSourceMaterials_[i];
+    }
+
+    morphMaterials_.clear();
+    morphSourceMaterials_.clear();
+    morphedGeometries_.clear();
+    useGPUMorphs_ = false;
+}
+
+void AnimatedModel::UpdateGPUMorphMaterials()
+{
+    ModelMorphTexture* morphTexture = model_ ? model_->GetMorphTexture() : nullptr;
+    if (!morphTexture)
+        return;
+
+    // Pack the weights for the uniform array
+    ea::vector<unsigned char> weightData(morphs_.size() * sizeof(float));
+    for (unsigned i = 0; i < morphs_.size(); ++i)
+        memcpy(&weightData[i * sizeof(float)], &morphs_[i].weight_, sizeof(float));
+
+    for (unsigned i = 0; i < batches_.size() && i < morphedGeometries_.size(); ++i)
+    {
+        if (!morphedGeometries_[i])
+            continue;
+
+        Material* currentMaterial = batches_[i].material_;
+        if (!currentMaterial)
+            continue;
+
+        // (Re)clone when the material was assigned or changed since the last update
+        if (currentMaterial != morphMaterials_[i])
+        {
+            SharedPtr<Material> clonedMaterial = currentMaterial->Clone();
+
+            ea::string defines = clonedMaterial->GetVertexShaderDefines();
+            if (!defines.empty())
+                defines += ' ';
+            defines += "MORPHTEX";
+            if (morphTexture->elementMask_ & MASK_NORMAL)
+                defines += " MORPHNORMAL";
+            if (morphTexture->elementMask_ & MASK_TANGENT)
+                defines += " MORPHTANGENT";
+            clonedMaterial->SetVertexShaderDefines(defines);
+
+            clonedMaterial->SetTexture(TU_CUSTOM1, morphTexture->texture_);
+            clonedMaterial->SetShaderParameter("NumMorphs", (float)morphs_.size());
+            clonedMaterial->SetShaderParameter("MorphVertexCount", (float)morphTexture->vertexCount_);
+
+            morphSourceMaterials_[i] = currentMaterial;
+            morphMaterials_[i] = clonedMaterial;
+            batches_[i].material_ = clonedMaterial;
+        }
+
+        morphMaterials_[i]->SetShaderParameter("MorphWeights", weightData);
+    }
+}
+
 void AnimatedModel::SetGeometryBoneMappings()
 {
     geometrySkinMatrices_.clear();
@@ -1200,6 +1511,37 @@ void AnimatedModel::UpdateAnimation(const FrameInfo& frame)
     ApplyAnimation();
 }
 
+void AnimatedModel::SetStaticBoneBoundingBox(const BoundingBox& box)
+{
+    staticBoneBoundingBox_ = box;
+    useStaticBoneBoundingBox_ = box.Defined();
+    OnStaticBoneBoundingBoxChanged();
+    MarkNetworkUpdate();
+}
+
+void AnimatedModel::ClearStaticBoneBoundingBox()
+{
+    if (!useStaticBoneBoundingBox_)
+        return;
+
+    useStaticBoneBoundingBox_ = false;
+    OnStaticBoneBoundingBoxChanged();
+    MarkNetworkUpdate();
+}
+
+void AnimatedModel::OnStaticBoneBoundingBoxChanged()
+{
+    if (useStaticBoneBoundingBox_)
+    {
+        boneBoundingBox_ = staticBoneBoundingBox_;
+        boneBoundingBoxDirty_ = false;
+    }
+    else
+        boneBoundingBoxDirty_ = true;
+
+    worldBoundingBoxDirty_ = true;
+}
+
 void AnimatedModel::ApplyAnimation()
 {
     // Make sure animations are in ascending priority order
@@ -1209,16 +1551,38 @@ void AnimatedModel::ApplyAnimation()
         animationOrderDirty_ = false;
     }
 
-    // Reset skeleton, apply all animations, calculate bones' bounding box. Make sure this is only done for the master model
-    // (first AnimatedModel in a node)
+    // Blend all animations into the shared pose buffer, then write bone node transforms once. Make sure this is only done
+    // for the master model (first AnimatedModel in a node)
     if (isMaster_)
     {
-        skeleton_.ResetSilent();
+        const ea::vector<Bone>& bones = skeleton_.GetBones();
+
+        // Initialize the pose from the bind pose instead of resetting the bone nodes
+        animationPose_.resize(bones.size());
+        for (unsigned i = 0; i < bones.size(); ++i)
+        {
+            AnimationPoseBone& poseBone = animationPose_[i];
+            poseBone.position_ = bones[i].initialPosition_;
+            poseBone.rotation_ = bones[i].initialRotation_;
+            poseBone.scale_ = bones[i].initialScale_;
+        }
+
         for (auto i = animationStates_.begin(); i !=
             animationStates_.end(); ++i)
-            (*i)->Apply();
+            (*i)->ApplyToPose(animationPose_);
+
+        // Write the final pose with a single pass over the bone nodes. The transforms are applied "silently" to avoid
+        // repeated marking dirty; mark dirty now
+        for (unsigned i = 0; i < bones.size(); ++i)
+        {
+            const Bone& bone = bones[i];
+            if (bone.animated_ && bone.node_)
+            {
+                const AnimationPoseBone& poseBone = animationPose_[i];
+                bone.node_->SetTransformSilent(poseBone.position_, poseBone.rotation_, poseBone.scale_);
+            }
+        }
 
-        // Skeleton reset and animations apply the node transforms "silently" to avoid repeated marking dirty. Mark dirty now
         node_->MarkDirty();
 
         // Calculate new bone bounding box
@@ -1277,12 +1641,36 @@ void AnimatedModel::UpdateMorphs()
     if (!graphics)
         return;
 
+    if (useGPUMorphs_)
+    {
+        // Only the material weight uniforms need to be refreshed; vertex data stays untouched
+        UpdateGPUMorphMaterials();
+        morphsDirty_ = false;
+        return;
+    }
+
     if (modelAnimator_)
     {
         modelAnimator_->ResetAnimation();
         modelAnimator_->ApplyMorphs(morphs_);
         if (softwareSkinning_)
-            modelAnimator_->ApplySkinning(skinMatrices_);
+        {
+            // Find the most detailed LOD level currently selected so that distant models skin fewer vertices
+            unsigned lodLevel = M_MAX_UNSIGNED;
+            for (unsigned i = 0; i < batches_.size() && i < geometries_.size(); ++i)
+            {
+                const ea::vector<SharedPtr<Geometry>>& batchGeometries = geometries_[i];
+                for (unsigned j = 0; j < batchGeometries.size(); ++j)
+                {
+                    if (batchGeometries[j] == batches_[i].geometry_)
+                    {
+                        lodLevel = Min(lodLevel, j);
+                        break;
+                    }
+                }
+            }
+            modelAnimator_->ApplySkinning(skinMatrices_, lodLevel != M_MAX_UNSIGNED ? lodLevel : 0);
+        }
         modelAnimator_->Commit();
     }
 
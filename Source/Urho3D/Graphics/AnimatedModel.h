@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Graphics/AnimationState.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Skeleton.h"
 #include "../Graphics/StaticModel.h"
@@ -74,6 +75,10 @@ public:
 
     /// Set model.
     void SetModel(Model* model, bool createBones = true);
+    /// Set material on all geometries.
+    void SetMaterial(Material* material) override;
+    /// Set material on one geometry. Return true if successful.
+    bool SetMaterial(unsigned index, Material* material) override;
     /// Add an animation.
     AnimationState* AddAnimationState(Animation* animation);
     /// Remove an animation by animation pointer.
@@ -100,6 +105,14 @@ public:
     void SetMorphWeight(StringHash nameHash, float weight);
     /// Reset all vertex morphs to zero.
     void ResetMorphWeights();
+    /// Set whether to apply vertex morphs on the GPU when supported. When unsupported, the CPU morphing path is used as before.
+    void SetGPUMorphing(bool enable);
+    /// Set a conservative static bone bounding box in local space and use it in place of per-bone merges. Bake the
+    /// maximum bone excursion of the model's animation clips into the box at import time; the world bounding box
+    /// then costs one transform per update. Clear while IK or ragdoll may move bones outside the envelope.
+    void SetStaticBoneBoundingBox(const BoundingBox& box);
+    /// Revert to exact per-bone bounding box updates.
+    void ClearStaticBoneBoundingBox();
     /// Apply all animation states to nodes.
     void ApplyAnimation();
 
@@ -143,6 +156,15 @@ public:
     /// Return vertex morph weight by name hash.
     float GetMorphWeight(StringHash nameHash) const;
 
+    /// Return whether GPU morphing is enabled.
+    bool GetGPUMorphing() const { return gpuMorphing_; }
+
+    /// Return the static bone bounding box.
+    const BoundingBox& GetStaticBoneBoundingBox() const { return staticBoneBoundingBox_; }
+
+    /// Return whether a static bone bounding box is in use.
+    bool HasStaticBoneBoundingBox() const { return useStaticBoneBoundingBox_; }
+
     /// Return whether is the master (first) animated model.
     bool IsMaster() const { return isMaster_; }
 
@@ -199,6 +221,12 @@ private:
     void SetGeometryBoneMappings();
     /// Clone geometries for vertex morphing.
     void CloneGeometries();
+    /// Initialize GPU morphing resources. Return false if the model or the graphics API is not compatible.
+    bool InitializeGPUMorphs();
+    /// Release GPU morphing resources and restore the original materials.
+    void RemoveGPUMorphs();
+    /// Refresh morph material clones and upload the current morph weights as shader parameters.
+    void UpdateGPUMorphMaterials();
     /// Recalculate animations. Called from Update().
     void UpdateAnimation(const FrameInfo& frame);
     /// Recalculate skinning.
@@ -207,6 +235,8 @@ private:
     void UpdateMorphs();
     /// Handle model reload finished.
     void HandleModelReloadFinished(StringHash eventType, VariantMap& eventData);
+    /// React to the static bone bounding box changing through attributes or setters.
+    void OnStaticBoneBoundingBoxChanged();
 
     /// Skeleton.
     Skeleton skeleton_;
@@ -216,6 +246,8 @@ private:
     ea::vector<ModelMorph> morphs_;
     /// Animation states.
     ea::vector<SharedPtr<AnimationState> > animationStates_;
+    /// Shared local-space pose buffer the animation states are blended into before the bone nodes are written once.
+    ea::vector<AnimationPoseBone> animationPose_;
     /// Skinning matrices.
     ea::vector<Matrix3x4> skinMatrices_;
     /// Mapping of subgeometry bone indices, used if more bones than skinning shader can manage.
@@ -226,6 +258,10 @@ private:
     ea::vector<ea::vector<Matrix3x4*> > geometrySkinMatrixPtrs_;
     /// Bounding box calculated from bones.
     BoundingBox boneBoundingBox_;
+    /// Conservative static bone-space bounding box, used in place of per-bone merges when enabled.
+    BoundingBox staticBoneBoundingBox_;
+    /// Whether to use the static bone bounding box.
+    bool useStaticBoneBoundingBox_{};
     /// Attribute buffer.
     mutable VectorBuffer attrBuffer_;
     /// The frame number animation LOD distance was last calculated on.
@@ -250,6 +286,16 @@ private:
     bool boneBoundingBoxDirty_;
     /// Software skinning flag.
     bool softwareSkinning_{};
+    /// GPU morphing enabled flag.
+    bool gpuMorphing_{};
+    /// Whether GPU morphing resources are initialized and in use.
+    bool useGPUMorphs_{};
+    /// Per-geometry material clones with morphing defines and parameters. Null for geometries without morphs.
+    ea::vector<SharedPtr<Material> > morphMaterials_;
+    /// Materials the morph material clones were created from.
+    ea::vector<WeakPtr<Material> > morphSourceMaterials_;
+    /// Per-geometry flags for geometries that draw from the morphed vertex buffer.
+    ea::vector<bool> morphedGeometries_;
     /// Number of bones used for software skinning.
     unsigned numSoftwareSkinningBones_{ 4 };
     /// Master model flag.
@@ -0,0 +1,368 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/AnimatedModelGroup.h"
+#include "../Graphics/Animation.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/Texture2D.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+// Per-instance data element carrying the frame pair and blend factor read by the vertex shader
+static const unsigned ANIM_PARAMS_ELEMENT = 0;
+// Per-instance data element carrying the authoritative clip index, time and playback speed
+static const unsigned ANIM_STATE_ELEMENT = 1;
+static const unsigned NUM_RESERVED_INSTANCE_ELEMENTS = 2;
+
+AnimatedModelGroup::AnimatedModelGroup(Context* context) :
+    StaticModelGroup(context)
+{
+    SetNumInstanceDataElements(NUM_RESERVED_INSTANCE_ELEMENTS);
+}
+
+AnimatedModelGroup::~AnimatedModelGroup() = default;
+
+void AnimatedModelGroup::RegisterObject(Context* context)
+{
+    context->RegisterFactory<AnimatedModelGroup>(GEOMETRY_CATEGORY);
+
+    URHO3D_COPY_BASE_ATTRIBUTES(StaticModelGroup);
+    URHO3D_ACCESSOR_ATTRIBUTE("Animation Clips", GetAnimationClipsAttr, SetAnimationClipsAttr, ResourceRefList,
+        ResourceRefList(Animation::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Bake FPS", GetBakeFps, SetBakeFps, float, 30.0f, AM_DEFAULT);
+}
+
+void AnimatedModelGroup::SetNumAnimationClips(unsigned num)
+{
+    if (num == animationClips_.size())
+        return;
+
+    animationClips_.resize(num);
+    MarkAnimationBakeDirty();
+    MarkNetworkUpdate();
+}
+
+void AnimatedModelGroup::SetAnimationClip(unsigned index, Animation* clip)
+{
+    if (index >= animationClips_.size())
+        animationClips_.resize(index + 1);
+    if (animationClips_[index] == clip)
+        return;
+
+    animationClips_[index] = clip;
+    MarkAnimationBakeDirty();
+    MarkNetworkUpdate();
+}
+
+void AnimatedModelGroup::SetInstanceAnimation(unsigned nodeIndex, unsigned clipIndex, float startTime, float speed)
+{
+    SetInstanceData(nodeIndex, ANIM_STATE_ELEMENT, Vector4((float)clipIndex, startTime, speed, 0.0f));
+}
+
+void AnimatedModelGroup::SetBakeFps(float fps)
+{
+    fps = Max(fps, 1.0f);
+    if (fps == bakeFps_)
+        return;
+
+    bakeFps_ = fps;
+    MarkAnimationBakeDirty();
+    MarkNetworkUpdate();
+}
+
+Animation* AnimatedModelGroup::GetAnimationClip(unsigned index) const
+{
+    return index < animationClips_.size() ? animationClips_[index].Get() : nullptr;
+}
+
+void AnimatedModelGroup::SetAnimationClipsAttr(const ResourceRefList& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetNumAnimationClips(value.names_.size());
+    for (unsigned i = 0; i < value.names_.size(); ++i)
+        SetAnimationClip(i, cache->GetResource<Animation>(value.names_[i]));
+}
+
+const ResourceRefList& AnimatedModelGroup::GetAnimationClipsAttr() const
+{
+    animationClipsAttr_.names_.resize(animationClips_.size());
+    for (unsigned i = 0; i < animationClips_.size(); ++i)
+        animationClipsAttr_.names_[i] = GetResourceName(animationClips_[i]);
+
+    return animationClipsAttr_;
+}
+
+void AnimatedModelGroup::OnSceneSet(Scene* scene)
+{
+    StaticModelGroup::OnSceneSet(scene);
+
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedModelGroup, HandleScenePostUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void AnimatedModelGroup::MarkAnimationBakeDirty()
+{
+    animationBakeDirty_ = true;
+}
+
+bool AnimatedModelGroup::BakeAnimationTexture()
+{
+    animationBakeDirty_ = false;
+    bakedClips_.clear();
+    animationTexture_.Reset();
+    bakedModel_ = GetModel();
+    numBakedBones_ = 0;
+    // The existing crowd materials refer to the old texture; re-clone them on the next update
+    crowdMaterialsDirty_ = true;
+
+    Model* model = GetModel();
+    if (!model || animationClips_.empty() || !GetSubsystem<Graphics>())
+        return false;
+
+    const ea::vector<Bone>& bones = model->GetSkeleton().GetBones();
+    const unsigned numBones = bones.size();
+    if (!numBones)
+        return false;
+
+    // Lay out the clips: each stores numFrames * numBones skinning matrices, 3 texels each
+    unsigned totalMatrices = 0;
+    bakedClips_.reserve(animationClips_.size());
+    for (unsigned i = 0; i < animationClips_.size(); ++i)
+    {
+        BakedClip baked;
+        baked.length_ = animationClips_[i] ? animationClips_[i]->GetLength() : 0.0f;
+        baked.numFrames_ = (unsigned)(baked.length_ * bakeFps_) + 1;
+        baked.baseMatrix_ = totalMatrices;
+        totalMatrices += baked.numFrames_ * numBones;
+        bakedClips_.push_back(baked);
+    }
+
+    const unsigned height = (totalMatrices * 3 + SKIN_TEXTURE_WIDTH - 1) / SKIN_TEXTURE_WIDTH;
+    ea::vector<Vector4> textureData(SKIN_TEXTURE_WIDTH * height, Vector4::ZERO);
+
+    ea::vector<Matrix3x4> localTransforms(numBones);
+    ea::vector<Matrix3x4> worldTransforms(numBones);
+
+    for (unsigned clipIndex = 0; clipIndex < animationClips_.size(); ++clipIndex)
+    {
+        Animation* clip = animationClips_[clipIndex];
+        const BakedClip& baked = bakedClips_[clipIndex];
+
+        for (unsigned frame = 0; frame < baked.numFrames_; ++frame)
+        {
+            const float time = Min((float)frame / bakeFps_, baked.length_);
+
+            // Evaluate the local transform of each bone at the frame time, starting from the bind pose
+            for (unsigned i = 0; i < numBones; ++i)
+            {
+                const Bone& bone = bones[i];
+                Vector3 position = bone.initialPosition_;
+                Quaternion rotation = bone.initialRotation_;
+                Vector3 scale = bone.initialScale_;
+
+                const AnimationTrack* track = clip ? clip->GetTrack(bone.nameHash_) : nullptr;
+                if (track && track->GetNumKeyFrames())
+                {
+                    unsigned keyIndex = 0;
+                    track->GetKeyFrameIndex(time, keyIndex);
+                    const unsigned nextKeyIndex = Min(keyIndex + 1, track->GetNumKeyFrames() - 1);
+                    const AnimationKeyFrame& keyFrame = track->keyFrames_[keyIndex];
+                    const AnimationKeyFrame& nextKeyFrame = track->keyFrames_[nextKeyIndex];
+                    const float t = nextKeyFrame.time_ > keyFrame.time_ ?
+                        Clamp((time - keyFrame.time_) / (nextKeyFrame.time_ - keyFrame.time_), 0.0f, 1.0f) : 0.0f;
+
+                    if (track->channelMask_ & CHANNEL_POSITION)
+                        position = keyFrame.position_.Lerp(nextKeyFrame.position_, t);
+                    if (track->channelMask_ & CHANNEL_ROTATION)
+                        rotation = keyFrame.rotation_.Slerp(nextKeyFrame.rotation_, t);
+                    if (track->channelMask_ & CHANNEL_SCALE)
+                        scale = keyFrame.scale_.Lerp(nextKeyFrame.scale_, t);
+                }
+
+                localTransforms[i] = Matrix3x4(position, rotation, scale);
+            }
+
+            // Concatenate along the bone hierarchy; model skeletons store parents before their children
+            for (unsigned i = 0; i < numBones; ++i)
+            {
+                const unsigned parentIndex = bones[i].parentIndex_;
+                if (parentIndex != i && parentIndex < numBones)
+                    worldTransforms[i] = worldTransforms[parentIndex] * localTransforms[i];
+                else
+                    worldTransforms[i] = localTransforms[i];
+            }
+
+            // Write the skinning matrices in the same layout as the skin matrix texture of bone palette skinning
+            const unsigned baseMatrix = baked.baseMatrix_ + frame * numBones;
+            for (unsigned i = 0; i < numBones; ++i)
+            {
+                const Matrix3x4 skinMatrix = worldTransforms[i] * bones[i].offsetMatrix_;
+                memcpy(&textureData[(baseMatrix + i) * 3], skinMatrix.Data(), sizeof(Matrix3x4));
+            }
+        }
+    }
+
+    animationTexture_ = MakeShared<Texture2D>(context_);
+    animationTexture_->SetNumLevels(1);
+    animationTexture_->SetFilterMode(FILTER_NEAREST);
+    if (!animationTexture_->SetSize((int)SKIN_TEXTURE_WIDTH, (int)height, Graphics::GetRGBAFloat32Format(), TEXTURE_STATIC))
+    {
+        URHO3D_LOGERROR("Failed to create crowd animation texture");
+        animationTexture_.Reset();
+        bakedClips_.clear();
+        return false;
+    }
+    animationTexture_->SetData(0, 0, 0, animationTexture_->GetWidth(), animationTexture_->GetHeight(), &textureData[0]);
+    numBakedBones_ = numBones;
+
+    // The per-instance animation parameters travel in the extra instancing buffer elements
+    if (auto* renderer = GetSubsystem<Renderer>())
+    {
+        if (renderer->GetNumExtraInstancingBufferElements() < (int)NUM_RESERVED_INSTANCE_ELEMENTS)
+            renderer->SetNumExtraInstancingBufferElements((int)NUM_RESERVED_INSTANCE_ELEMENTS);
+    }
+
+    return true;
+}
+
+void AnimatedModelGroup::ApplyCrowdMaterials()
+{
+    crowdMaterials_.resize(batches_.size());
+    sourceMaterials_.resize(batches_.size());
+
+    for (unsigned i = 0; i < batches_.size(); ++i)
+    {
+        SourceBatch& batch = batches_[i];
+        const bool isCrowdMaterial = batch.material_ && batch.material_ == crowdMaterials_[i];
+
+        if (!animationTexture_)
+        {
+            // Baking failed or there is nothing to bake; revert to the source material and normal instancing
+            if (isCrowdMaterial)
+                batch.material_ = sourceMaterials_[i];
+            batch.geometryType_ = GEOM_STATIC;
+            crowdMaterials_[i].Reset();
+            sourceMaterials_[i].Reset();
+            continue;
+        }
+
+        // Instancing is mandatory for the crowd path; the animation parameters only exist in the instancing buffer
+        batch.geometryType_ = GEOM_INSTANCED;
+
+        if (isCrowdMaterial && !crowdMaterialsDirty_)
+            continue;
+
+        // The material has been (re)assigned or the animation texture has changed; clone the source material with
+        // the crowd shader defines. The clone keeps the source's name so that the material attribute still
+        // serializes the source resource
+        Material* source = isCrowdMaterial ? sourceMaterials_[i].Get() : batch.material_.Get();
+        if (!source)
+        {
+            auto* renderer = GetSubsystem<Renderer>();
+            source = renderer ? renderer->GetDefaultMaterial() : nullptr;
+        }
+        if (!source)
+            continue;
+
+        SharedPtr<Material> crowdMaterial = source->Clone(source->GetName());
+        const ea::string& defines = source->GetVertexShaderDefines();
+        crowdMaterial->SetVertexShaderDefines(defines.empty() ? "SKINNED SKINTEX CROWD" : defines + " SKINNED SKINTEX CROWD");
+        crowdMaterial->SetTexture(TU_CUSTOM2, animationTexture_);
+
+        sourceMaterials_[i] = source;
+        crowdMaterials_[i] = crowdMaterial;
+        batch.material_ = crowdMaterial;
+    }
+
+    crowdMaterialsDirty_ = false;
+}
+
+void AnimatedModelGroup::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    if (!IsEnabledEffective())
+        return;
+
+    if (animationBakeDirty_ || GetModel() != bakedModel_)
+        BakeAnimationTexture();
+
+    ApplyCrowdMaterials();
+
+    if (!animationTexture_ || !numBakedBones_)
+        return;
+
+    // Guard against the reserved data elements being reduced through the attribute
+    if (GetNumInstanceDataElements() < NUM_RESERVED_INSTANCE_ELEMENTS)
+        SetNumInstanceDataElements(NUM_RESERVED_INSTANCE_ELEMENTS);
+
+    const float timeStep = eventData[P_TIMESTEP].GetFloat();
+    const unsigned numNodes = GetNumInstanceNodes();
+
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        const Vector4 state = GetInstanceData(i, ANIM_STATE_ELEMENT);
+        const auto clipIndex = (unsigned)state.x_;
+        if (clipIndex >= bakedClips_.size())
+            continue;
+
+        const BakedClip& clip = bakedClips_[clipIndex];
+        float time = state.y_ + state.z_ * timeStep;
+        if (clip.length_ > 0.0f)
+        {
+            time = fmodf(time, clip.length_);
+            if (time < 0.0f)
+                time += clip.length_;
+        }
+        else
+            time = 0.0f;
+
+        if (time != state.y_)
+            SetInstanceData(i, ANIM_STATE_ELEMENT, Vector4(state.x_, time, state.z_, 0.0f));
+
+        // Frame pair and blend factor for the vertex shader, as base matrix indices into the animation texture
+        const float framePos = time * bakeFps_;
+        const unsigned frameA = Min((unsigned)framePos, clip.numFrames_ - 1);
+        const unsigned frameB = Min(frameA + 1, clip.numFrames_ - 1);
+        SetInstanceData(i, ANIM_PARAMS_ELEMENT, Vector4((float)(clip.baseMatrix_ + frameA * numBakedBones_),
+            (float)(clip.baseMatrix_ + frameB * numBakedBones_), Clamp(framePos - (float)frameA, 0.0f, 1.0f), 0.0f));
+    }
+}
+
+}
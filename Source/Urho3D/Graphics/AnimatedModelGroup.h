@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Graphics/StaticModelGroup.h"
+
+namespace Urho3D
+{
+
+class Animation;
+class Texture2D;
+
+/// Renders a crowd of skinned instances of one model as instanced draw calls. The animation clips are baked into a
+/// bone matrix texture and sampled in the vertex shader using per-instance clip and time parameters, so neither CPU
+/// skinning nor per-character draw calls are needed. Requires the OpenGL renderer with bone palette skinning support.
+/// Per-instance data elements 0 and 1 are reserved for the animation parameters; the Renderer must be configured with
+/// at least two extra instancing buffer elements (done automatically when the animation texture is baked.)
+class URHO3D_API AnimatedModelGroup : public StaticModelGroup
+{
+    URHO3D_OBJECT(AnimatedModelGroup, StaticModelGroup);
+
+public:
+    /// Construct.
+    explicit AnimatedModelGroup(Context* context);
+    /// Destruct.
+    ~AnimatedModelGroup() override;
+    /// Register object factory. StaticModelGroup must be registered first.
+    static void RegisterObject(Context* context);
+
+    /// Set number of animation clips.
+    void SetNumAnimationClips(unsigned num);
+    /// Set an animation clip. The clip must animate the bones of the group's model.
+    void SetAnimationClip(unsigned index, Animation* clip);
+    /// Set the animation state of an instance: the clip index, the start time within the clip and the playback speed.
+    /// The animation loops over the clip length. Speed 0 freezes the instance at the given time.
+    void SetInstanceAnimation(unsigned nodeIndex, unsigned clipIndex, float startTime = 0.0f, float speed = 1.0f);
+    /// Set the framerate at which the clips are sampled into the animation texture.
+    void SetBakeFps(float fps);
+
+    /// Return number of animation clips.
+    unsigned GetNumAnimationClips() const { return animationClips_.size(); }
+
+    /// Return an animation clip by index.
+    Animation* GetAnimationClip(unsigned index) const;
+
+    /// Return the framerate at which the clips are sampled into the animation texture.
+    float GetBakeFps() const { return bakeFps_; }
+
+    /// Return the baked animation texture.
+    Texture2D* GetAnimationTexture() const { return animationTexture_; }
+
+    /// Set animation clips attribute.
+    void SetAnimationClipsAttr(const ResourceRefList& value);
+    /// Return animation clips attribute.
+    const ResourceRefList& GetAnimationClipsAttr() const;
+
+protected:
+    /// Handle scene being assigned. Subscribe to the scene update to advance the instance animations.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Baked location of one animation clip in the animation texture.
+    struct BakedClip
+    {
+        /// Index of the clip's first bone matrix in the animation texture.
+        unsigned baseMatrix_;
+        /// Number of sampled frames.
+        unsigned numFrames_;
+        /// Clip length in seconds.
+        float length_;
+    };
+
+    /// Mark the animation texture and the crowd materials out of date.
+    void MarkAnimationBakeDirty();
+    /// Sample the animation clips into the bone matrix texture and clone the materials with the crowd shader defines.
+    /// Return true on success.
+    bool BakeAnimationTexture();
+    /// Assign the crowd materials and instanced geometry type to the source batches. Re-clones the crowd material for
+    /// a batch if its material has been changed since the last bake.
+    void ApplyCrowdMaterials();
+    /// Advance the instance animations and refresh the per-instance shader parameters.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+
+    /// Animation clips to bake.
+    ea::vector<SharedPtr<Animation> > animationClips_;
+    /// Clip locations in the animation texture.
+    ea::vector<BakedClip> bakedClips_;
+    /// Materials cloned with the crowd shader defines and the animation texture, in the same order as the batches.
+    ea::vector<SharedPtr<Material> > crowdMaterials_;
+    /// Materials the crowd materials were cloned from, for detecting material changes and for reverting.
+    ea::vector<SharedPtr<Material> > sourceMaterials_;
+    /// Baked bone matrix animation texture.
+    SharedPtr<Texture2D> animationTexture_;
+    /// Model the animation texture was baked against.
+    WeakPtr<Model> bakedModel_;
+    /// Animation clips attribute.
+    mutable ResourceRefList animationClipsAttr_;
+    /// Framerate at which the clips are sampled into the animation texture.
+    float bakeFps_{30.0f};
+    /// Number of bones in the baked skeleton.
+    unsigned numBakedBones_{};
+    /// Whether the animation texture needs to be rebaked.
+    bool animationBakeDirty_{true};
+    /// Whether the crowd materials need to be re-cloned after a rebake.
+    bool crowdMaterialsDirty_{};
+};
+
+}
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
@@ -50,12 +51,16 @@ inline bool CompareKeyFrames(const AnimationKeyFrame& lhs, const AnimationKeyFra
     return lhs.time_ < rhs.time_;
 }
 
+/// Max keys the cursor is stepped incrementally before falling back to binary search.
+static const unsigned MAX_KEYFRAME_CURSOR_STEPS = 8;
+
 void AnimationTrack::SetKeyFrame(unsigned index, const AnimationKeyFrame& keyFrame)
 {
     if (index < keyFrames_.size())
     {
         keyFrames_[index] = keyFrame;
         ea::quick_sort(keyFrames_.begin(), keyFrames_.end(), CompareKeyFrames);
+        UpdateKeyFrameTimes();
     }
     else if (index == keyFrames_.size())
         AddKeyFrame(keyFrame);
@@ -67,22 +72,26 @@ void AnimationTrack::AddKeyFrame(const AnimationKeyFrame& keyFrame)
     keyFrames_.push_back(keyFrame);
     if (needSort)
         ea::quick_sort(keyFrames_.begin(), keyFrames_.end(), CompareKeyFrames);
+    UpdateKeyFrameTimes();
 }
 
 void AnimationTrack::InsertKeyFrame(unsigned index, const AnimationKeyFrame& keyFrame)
 {
     keyFrames_.insert_at(index, keyFrame);
     ea::quick_sort(keyFrames_.begin(), keyFrames_.end(), CompareKeyFrames);
+    UpdateKeyFrameTimes();
 }
 
 void AnimationTrack::RemoveKeyFrame(unsigned index)
 {
     keyFrames_.erase_at(index);
+    UpdateKeyFrameTimes();
 }
 
 void AnimationTrack::RemoveAllKeyFrames()
 {
     keyFrames_.clear();
+    keyTimes_.clear();
 }
 
 AnimationKeyFrame* AnimationTrack::GetKeyFrame(unsigned index)
@@ -95,23 +104,51 @@ bool AnimationTrack::GetKeyFrameIndex(float time, unsigned& index) const
     if (keyFrames_.empty())
         return false;
 
+    // Rebuild the packed time array if the keyframes have been modified directly, e.g. on load
+    if (keyTimes_.size() != keyFrames_.size())
+        UpdateKeyFrameTimes();
+
     if (time < 0.0f)
         time = 0.0f;
 
-    if (index >= keyFrames_.size())
-        index = keyFrames_.size() - 1;
+    const unsigned numKeyFrames = keyTimes_.size();
+    if (index >= numKeyFrames)
+        index = numKeyFrames - 1;
+
+    // Step the cursor incrementally: monotonically advancing playback moves at most a few keys per frame
+    unsigned steps = MAX_KEYFRAME_CURSOR_STEPS;
 
     // Check for being too far ahead
-    while (index && time < keyFrames_[index].time_)
+    while (steps && index && time < keyTimes_[index])
+    {
         --index;
+        --steps;
+    }
 
     // Check for being too far behind
-    while (index < keyFrames_.size() - 1 && time >= keyFrames_[index + 1].time_)
+    while (steps && index < numKeyFrames - 1 && time >= keyTimes_[index + 1])
+    {
         ++index;
+        --steps;
+    }
+
+    // On a long seek, e.g. loop wrap or an explicit time change, fall back to binary search over the packed times
+    if (!steps)
+    {
+        auto i = ea::upper_bound(keyTimes_.begin(), keyTimes_.end(), time);
+        index = i == keyTimes_.begin() ? 0 : (unsigned)(i - keyTimes_.begin() - 1);
+    }
 
     return true;
 }
 
+void AnimationTrack::UpdateKeyFrameTimes() const
+{
+    keyTimes_.resize(keyFrames_.size());
+    for (unsigned i = 0; i < keyFrames_.size(); ++i)
+        keyTimes_[i] = keyFrames_[i].time_;
+}
+
 Animation::Animation(Context* context) :
     ResourceWithMetadata(context),
     length_(0.f)
@@ -99,6 +99,8 @@ struct URHO3D_API AnimationTrack
     unsigned GetNumKeyFrames() const { return keyFrames_.size(); }
     /// Return keyframe index based on time and previous index. Return false if animation is empty.
     bool GetKeyFrameIndex(float time, unsigned& index) const;
+    /// Rebuild the packed keyframe time array. Called automatically by the keyframe modification functions and when the keyframe count changes.
+    void UpdateKeyFrameTimes() const;
 
     /// Bone or scene node name.
     ea::string name_;
@@ -108,6 +110,8 @@ struct URHO3D_API AnimationTrack
     AnimationChannelFlags channelMask_{};
     /// Keyframes.
     ea::vector<AnimationKeyFrame> keyFrames_;
+    /// Packed keyframe times for cache-friendly cursor stepping and search. Kept in sync with keyFrames_.
+    mutable ea::vector<float> keyTimes_;
 
     /// Instance equality operator.
     bool operator ==(const AnimationTrack& rhs) const
@@ -40,6 +40,8 @@
 namespace Urho3D
 {
 
+URHO3D_DEFINE_OBJECT_POOL(AnimationController)
+
 static const unsigned char CTRL_LOOPED = 0x1;
 static const unsigned char CTRL_STARTBONE = 0x2;
 static const unsigned char CTRL_AUTOFADE = 0x4;
@@ -79,9 +81,16 @@ void AnimationController::OnSetEnabled()
     if (scene)
     {
         if (IsEnabledEffective())
+        {
             SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimationController, HandleScenePostUpdate));
+            SubscribeToEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED,
+                URHO3D_HANDLER(AnimationController, HandleSceneDrawableUpdateFinished));
+        }
         else
+        {
             UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+            UnsubscribeFromEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED);
+        }
     }
 }
 
@@ -156,6 +165,15 @@ void AnimationController::Update(float timeStep)
         (*i)->Apply();
 }
 
+void AnimationController::ApplyDeferredUpdate()
+{
+    if (!deferredUpdatePending_)
+        return;
+
+    deferredUpdatePending_ = false;
+    Update(deferredUpdateTimeStep_);
+}
+
 bool AnimationController::Play(const ea::string& name, unsigned char layer, bool looped, float fadeInTime)
 {
     // Get the animation resource first to be able to get the canonical resource name
@@ -839,9 +857,16 @@ VariantVector AnimationController::GetNodeAnimationStatesAttr() const
 void AnimationController::OnSceneSet(Scene* scene)
 {
     if (scene && IsEnabledEffective())
+    {
         SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimationController, HandleScenePostUpdate));
+        SubscribeToEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED,
+            URHO3D_HANDLER(AnimationController, HandleSceneDrawableUpdateFinished));
+    }
     else if (!scene)
+    {
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        UnsubscribeFromEvent(E_SCENEDRAWABLEUPDATEFINISHED);
+    }
 }
 
 AnimationState* AnimationController::AddAnimationState(Animation* animation)
@@ -912,7 +937,52 @@ void AnimationController::HandleScenePostUpdate(StringHash eventType, VariantMap
 {
     using namespace ScenePostUpdate;
 
-    Update(eventData[P_TIMESTEP].GetFloat());
+    const float timeStep = eventData[P_TIMESTEP].GetFloat();
+
+    // When the node has an AnimatedModel in the octree, defer the update to the octree's threaded drawable update so that
+    // all animated models advance their animations concurrently. Animation events are collected on the worker threads and
+    // sent from HandleSceneDrawableUpdateFinished()
+    auto* model = GetComponent<AnimatedModel>();
+    if (model && model->GetOctant())
+    {
+        deferredUpdateTimeStep_ = timeStep;
+        deferredUpdatePending_ = true;
+        model->MarkForUpdate();
+        return;
+    }
+
+    Update(timeStep);
+}
+
+void AnimationController::HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData)
+{
+    // If the octree did not process the model this frame, run the missed update now on the main thread
+    if (deferredUpdatePending_)
+    {
+        deferredUpdatePending_ = false;
+        Update(deferredUpdateTimeStep_);
+    }
+
+    // Send animation events collected during the threaded update. Copy the states first, as event handlers may modify them
+    auto* model = GetComponent<AnimatedModel>();
+    const ea::vector<SharedPtr<AnimationState> >& currentStates = model ? model->GetAnimationStates() : nodeAnimationStates_;
+
+    bool eventsPending = false;
+    for (const SharedPtr<AnimationState>& state : currentStates)
+    {
+        if (state->HasPendingEvents())
+        {
+            eventsPending = true;
+            break;
+        }
+    }
+
+    if (eventsPending)
+    {
+        const ea::vector<SharedPtr<AnimationState> > states(currentStates);
+        for (const SharedPtr<AnimationState>& state : states)
+            state->SendPendingEvents();
+    }
 }
 
 }
@@ -96,6 +96,7 @@ struct URHO3D_API AnimationControl
 class URHO3D_API AnimationController : public Component
 {
     URHO3D_OBJECT(AnimationController, Component);
+    URHO3D_OBJECT_POOL(AnimationController);
 
 public:
     /// Construct.
@@ -110,6 +111,8 @@ public:
 
     /// Update the animations. Is called from HandleScenePostUpdate().
     virtual void Update(float timeStep);
+    /// Run an update deferred to the octree's threaded drawable update. Called by AnimatedModel from a worker thread; animation events are collected and sent later from the main thread.
+    void ApplyDeferredUpdate();
     /// Play an animation and set full target weight. Name must be the full resource name. Return true on success.
     bool Play(const ea::string& name, unsigned char layer, bool looped, float fadeInTime = 0.0f);
     /// Play an animation, set full target weight and fade out all other animations on the same layer. Name must be the full resource name. Return true on success.
@@ -213,6 +216,8 @@ private:
     void FindAnimation(const ea::string& name, unsigned& index, AnimationState*& state) const;
     /// Handle scene post-update event.
     void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle scene drawable update finished. Runs a deferred update that was not picked up by the octree, and sends animation events collected on worker threads.
+    void HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData);
 
     /// Animation control structures.
     ea::vector<AnimationControl> animations_;
@@ -220,6 +225,10 @@ private:
     ea::vector<SharedPtr<AnimationState> > nodeAnimationStates_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
+    /// Time step of the update deferred to the threaded drawable update.
+    float deferredUpdateTimeStep_{};
+    /// Whether an update has been deferred to the threaded drawable update.
+    bool deferredUpdatePending_{};
 };
 
 }
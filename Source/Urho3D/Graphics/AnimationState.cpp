@@ -25,6 +25,7 @@
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
 #include "../Graphics/AnimationState.h"
+#include "../Core/Thread.h"
 #include "../Graphics/DrawableEvents.h"
 #include "../IO/Log.h"
 
@@ -36,6 +37,7 @@ namespace Urho3D
 AnimationStateTrack::AnimationStateTrack() :
     track_(nullptr),
     bone_(nullptr),
+    boneIndex_(M_MAX_UNSIGNED),
     weight_(1.0f),
     keyFrame_(0)
 {
@@ -150,6 +152,7 @@ void AnimationState::SetStartBone(Bone* startBone)
         if (trackBone && trackBone->node_)
         {
             stateTrack.bone_ = trackBone;
+            stateTrack.boneIndex_ = skeleton.GetBoneIndex(nameHash);
             stateTrack.node_ = trackBone->node_;
             stateTracks_.push_back(stateTrack);
         }
@@ -291,21 +294,34 @@ void AnimationState::AddTime(float delta)
     // Process finish event
     if (sendFinishEvent)
     {
-        using namespace AnimationFinished;
+        if (!Thread::IsMainThread())
+        {
+            // Events can not be sent from worker threads: collect for SendPendingEvents()
+            DeferredAnimationEvent event;
+            event.eventType_ = E_ANIMATIONFINISHED;
+            event.senderNode_ = model_ ? model_->GetNode() : node_.Get();
+            event.animation_ = animation_;
+            event.looped_ = looped_;
+            pendingEvents_.push_back(event);
+        }
+        else
+        {
+            using namespace AnimationFinished;
 
-        WeakPtr<AnimationState> self(this);
-        WeakPtr<Node> senderNode(model_ ? model_->GetNode() : node_.Get());
+            WeakPtr<AnimationState> self(this);
+            WeakPtr<Node> senderNode(model_ ? model_->GetNode() : node_.Get());
 
-        VariantMap& eventData = senderNode->GetEventDataMap();
-        eventData[P_NODE] = senderNode;
-        eventData[P_ANIMATION] = animation_;
-        eventData[P_NAME] = animation_->GetAnimationName();
-        eventData[P_LOOPED] = looped_;
+            VariantMap& eventData = senderNode->GetEventDataMap();
+            eventData[P_NODE] = senderNode;
+            eventData[P_ANIMATION] = animation_;
+            eventData[P_NAME] = animation_->GetAnimationName();
+            eventData[P_LOOPED] = looped_;
 
-        // Note: this may cause arbitrary deletion of animation states, including the one we are currently processing
-        senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
-        if (senderNode.Expired() || self.Expired())
-            return;
+            // Note: this may cause arbitrary deletion of animation states, including the one we are currently processing
+            senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
+            if (senderNode.Expired() || self.Expired())
+                return;
+        }
     }
 
     // Process animation triggers
@@ -341,6 +357,19 @@ void AnimationState::AddTime(float delta)
 
             if (oldTime <= frameTime && time > frameTime)
             {
+                if (!Thread::IsMainThread())
+                {
+                    // Events can not be sent from worker threads: collect for SendPendingEvents()
+                    DeferredAnimationEvent event;
+                    event.eventType_ = E_ANIMATIONTRIGGER;
+                    event.senderNode_ = model_ ? model_->GetNode() : node_.Get();
+                    event.animation_ = animation_;
+                    event.time_ = i->time_;
+                    event.data_ = i->data_;
+                    pendingEvents_.push_back(event);
+                    continue;
+                }
+
                 using namespace AnimationTrigger;
 
                 WeakPtr<AnimationState> self(this);
@@ -362,6 +391,54 @@ void AnimationState::AddTime(float delta)
     }
 }
 
+void AnimationState::SendPendingEvents()
+{
+    if (pendingEvents_.empty())
+        return;
+
+    // Move the events to a local vector first, as event handlers may modify this state
+    ea::vector<DeferredAnimationEvent> events(ea::move(pendingEvents_));
+    pendingEvents_.clear();
+
+    WeakPtr<AnimationState> self(this);
+    for (const DeferredAnimationEvent& event : events)
+    {
+        Node* senderNode = event.senderNode_.Get();
+        if (!senderNode || !event.animation_)
+            continue;
+
+        if (event.eventType_ == E_ANIMATIONFINISHED)
+        {
+            using namespace AnimationFinished;
+
+            VariantMap& eventData = senderNode->GetEventDataMap();
+            eventData[P_NODE] = senderNode;
+            eventData[P_ANIMATION] = event.animation_;
+            eventData[P_NAME] = event.animation_->GetAnimationName();
+            eventData[P_LOOPED] = event.looped_;
+
+            senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
+        }
+        else
+        {
+            using namespace AnimationTrigger;
+
+            VariantMap& eventData = senderNode->GetEventDataMap();
+            eventData[P_NODE] = senderNode;
+            eventData[P_ANIMATION] = event.animation_;
+            eventData[P_NAME] = event.animation_->GetAnimationName();
+            eventData[P_TIME] = event.time_;
+            eventData[P_DATA] = event.data_;
+
+            senderNode->SendEvent(E_ANIMATIONTRIGGER, eventData);
+        }
+
+        // Note: the event handler may cause arbitrary deletion of animation states, including this one
+        if (self.Expired())
+            return;
+    }
+}
+
 void AnimationState::SetLayer(unsigned char layer)
 {
     if (layer != layer_)
@@ -475,14 +552,31 @@ void AnimationState::ApplyToNodes()
         ApplyTrack(*i, 1.0f, false);
 }
 
-void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent)
+void AnimationState::ApplyToPose(ea::vector<AnimationPoseBone>& pose)
 {
-    const AnimationTrack* track = stateTrack.track_;
-    Node* node = stateTrack.node_;
-
-    if (track->keyFrames_.empty() || !node)
+    if (!animation_ || !IsEnabled() || !model_)
         return;
 
+    for (auto i = stateTracks_.begin(); i != stateTracks_.end(); ++i)
+    {
+        AnimationStateTrack& stateTrack = *i;
+        float finalWeight = weight_ * stateTrack.weight_;
+
+        // Do not apply if zero effective weight or the bone has animation disabled
+        if (Equals(finalWeight, 0.0f) || !stateTrack.bone_->animated_ || stateTrack.boneIndex_ >= pose.size())
+            continue;
+
+        ApplyTrackToPose(stateTrack, pose[stateTrack.boneIndex_], finalWeight);
+    }
+}
+
+bool AnimationState::SampleTrack(AnimationStateTrack& stateTrack, Vector3& newPosition, Quaternion& newRotation,
+    Vector3& newScale)
+{
+    const AnimationTrack* track = stateTrack.track_;
+    if (track->keyFrames_.empty())
+        return false;
+
     unsigned& frame = stateTrack.keyFrame_;
     track->GetKeyFrameIndex(time_, frame);
 
@@ -503,10 +597,6 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
     const AnimationKeyFrame* keyFrame = &track->keyFrames_[frame];
     const AnimationChannelFlags channelMask = track->channelMask_;
 
-    Vector3 newPosition;
-    Quaternion newRotation;
-    Vector3 newScale;
-
     if (interpolate)
     {
         const AnimationKeyFrame* nextKeyFrame = &track->keyFrames_[nextFrame];
@@ -532,6 +622,79 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
             newScale = keyFrame->scale_;
     }
 
+    return true;
+}
+
+void AnimationState::ApplyTrackToPose(AnimationStateTrack& stateTrack, AnimationPoseBone& poseBone, float weight)
+{
+    Vector3 newPosition;
+    Quaternion newRotation;
+    Vector3 newScale;
+
+    if (!SampleTrack(stateTrack, newPosition, newRotation, newScale))
+        return;
+
+    const AnimationChannelFlags channelMask = stateTrack.track_->channelMask_;
+
+    if (blendingMode_ == ABM_ADDITIVE) // not ABM_LERP
+    {
+        if (channelMask & CHANNEL_POSITION)
+        {
+            Vector3 delta = newPosition - stateTrack.bone_->initialPosition_;
+            poseBone.position_ += delta * weight;
+        }
+        if (channelMask & CHANNEL_ROTATION)
+        {
+            Quaternion delta = newRotation * stateTrack.bone_->initialRotation_.Inverse();
+            newRotation = (delta * poseBone.rotation_).Normalized();
+            if (!Equals(weight, 1.0f))
+                newRotation = poseBone.rotation_.Slerp(newRotation, weight);
+            poseBone.rotation_ = newRotation;
+        }
+        if (channelMask & CHANNEL_SCALE)
+        {
+            Vector3 delta = newScale - stateTrack.bone_->initialScale_;
+            poseBone.scale_ += delta * weight;
+        }
+    }
+    else
+    {
+        if (!Equals(weight, 1.0f)) // not full weight
+        {
+            if (channelMask & CHANNEL_POSITION)
+                poseBone.position_ = poseBone.position_.Lerp(newPosition, weight);
+            if (channelMask & CHANNEL_ROTATION)
+                poseBone.rotation_ = poseBone.rotation_.Slerp(newRotation, weight);
+            if (channelMask & CHANNEL_SCALE)
+                poseBone.scale_ = poseBone.scale_.Lerp(newScale, weight);
+        }
+        else
+        {
+            if (channelMask & CHANNEL_POSITION)
+                poseBone.position_ = newPosition;
+            if (channelMask & CHANNEL_ROTATION)
+                poseBone.rotation_ = newRotation;
+            if (channelMask & CHANNEL_SCALE)
+                poseBone.scale_ = newScale;
+        }
+    }
+}
+
+void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent)
+{
+    Node* node = stateTrack.node_;
+    if (!node)
+        return;
+
+    Vector3 newPosition;
+    Quaternion newRotation;
+    Vector3 newScale;
+
+    if (!SampleTrack(stateTrack, newPosition, newRotation, newScale))
+        return;
+
+    const AnimationChannelFlags channelMask = stateTrack.track_->channelMask_;
+
     if (blendingMode_ == ABM_ADDITIVE) // not ABM_LERP
     {
         if (channelMask & CHANNEL_POSITION)
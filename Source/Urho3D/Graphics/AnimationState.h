@@ -27,6 +27,7 @@
 #include <EASTL/unordered_map.h>
 
 #include "../Container/Ptr.h"
+#include "../Core/Variant.h"
 #include "../Math/StringHash.h"
 
 namespace Urho3D
@@ -50,6 +51,17 @@ enum AnimationBlendMode
     ABM_ADDITIVE
 };
 
+/// Blended local-space transform of a single bone. Laid out contiguously per skeleton for cache-friendly pose blending.
+struct AnimationPoseBone
+{
+    /// Position.
+    Vector3 position_;
+    /// Rotation.
+    Quaternion rotation_;
+    /// Scale.
+    Vector3 scale_;
+};
+
 /// %Animation instance per-track data.
 struct URHO3D_API AnimationStateTrack
 {
@@ -74,6 +86,8 @@ struct URHO3D_API AnimationStateTrack
     const AnimationTrack* track_;
     /// Bone pointer.
     Bone* bone_;
+    /// Bone index in the model's skeleton, or M_MAX_UNSIGNED in node animation mode.
+    unsigned boneIndex_;
     /// Scene node pointer.
     WeakPtr<Node> node_;
     /// Blending weight.
@@ -82,6 +96,23 @@ struct URHO3D_API AnimationStateTrack
     unsigned keyFrame_;
 };
 
+/// %Animation event collected during a threaded update, to be sent later from the main thread.
+struct DeferredAnimationEvent
+{
+    /// Event type: E_ANIMATIONFINISHED or E_ANIMATIONTRIGGER.
+    StringHash eventType_;
+    /// Sender node.
+    WeakPtr<Node> senderNode_;
+    /// Animation.
+    SharedPtr<Animation> animation_;
+    /// Trigger time position.
+    float time_{};
+    /// Trigger data.
+    Variant data_;
+    /// Looped flag.
+    bool looped_{};
+};
+
 /// %Animation instance.
 class URHO3D_API AnimationState : public RefCounted
 {
@@ -111,14 +142,19 @@ public:
     void SetBoneWeight(StringHash nameHash, float weight, bool recursive = false);
     /// Modify blending weight.
     void AddWeight(float delta);
-    /// Modify time position. %Animation triggers will be fired.
+    /// Modify time position. %Animation triggers will be fired. When called from a worker thread, events are collected instead of sent and must be flushed with SendPendingEvents() from the main thread.
     void AddTime(float delta);
+    /// Send events collected by AddTime() during a threaded update. Must be called from the main thread.
+    void SendPendingEvents();
     /// Set blending layer.
     void SetLayer(unsigned char layer);
 
     /// Return animation.
     Animation* GetAnimation() const { return animation_; }
 
+    /// Return whether events collected during a threaded update are waiting to be sent.
+    bool HasPendingEvents() const { return !pendingEvents_.empty(); }
+
     /// Return animated model this state belongs to (model mode).
     AnimatedModel* GetModel() const;
     /// Return root scene node this state controls (node hierarchy mode).
@@ -161,6 +197,8 @@ public:
 
     /// Apply the animation at the current time position.
     void Apply();
+    /// Evaluate the animation at the current time position and blend it into a skeleton-indexed pose buffer instead of writing to bone nodes. Model mode only.
+    void ApplyToPose(ea::vector<AnimationPoseBone>& pose);
 
 private:
     /// Apply animation to a skeleton. Transform changes are applied silently, so the model needs to dirty its root model afterward.
@@ -169,6 +207,10 @@ private:
     void ApplyToNodes();
     /// Apply track.
     void ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent);
+    /// Blend a track into a pose buffer bone.
+    void ApplyTrackToPose(AnimationStateTrack& stateTrack, AnimationPoseBone& poseBone, float weight);
+    /// Sample a track's channels at the current time position. Return false if the track has no keyframes.
+    bool SampleTrack(AnimationStateTrack& stateTrack, Vector3& newPosition, Quaternion& newRotation, Vector3& newScale);
 
     /// Animated model (model mode).
     WeakPtr<AnimatedModel> model_;
@@ -190,6 +232,8 @@ private:
     unsigned char layer_;
     /// Blending mode.
     AnimationBlendMode blendingMode_;
+    /// Events collected during a threaded update, waiting to be sent from the main thread.
+    ea::vector<DeferredAnimationEvent> pendingEvents_;
 };
 
 }
@@ -83,6 +83,67 @@ inline bool CompareBatchGroupOrder(const BatchGroup* lhs, const BatchGroup* rhs)
     return lhs->renderOrder_ < rhs->renderOrder_;
 }
 
+/// Minimum number of batches before radix sort pays off; quick_sort handles small queues faster.
+static const unsigned RADIX_SORT_BATCH_THRESHOLD = 128;
+
+/// Encode a float so that ascending unsigned integer comparison matches ascending float comparison.
+inline unsigned EncodeSortableDistance(float distance)
+{
+    unsigned bits;
+    memcpy(&bits, &distance, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/// Stable LSD radix sort of batch pointers by a packed 64-bit key. Performs one pass per key byte,
+/// skipping bytes on which all keys agree.
+template <class T, class GetKey> void RadixSortBatches(ea::vector<T>& batches, GetKey getKey)
+{
+    const unsigned size = batches.size();
+
+    ea::vector<ea::pair<unsigned long long, T> > keys;
+    ea::vector<ea::pair<unsigned long long, T> > temp;
+    keys.reserve(size);
+    temp.resize(size);
+    for (T batch : batches)
+        keys.push_back(ea::make_pair(getKey(batch), batch));
+
+    for (unsigned shift = 0; shift < 64; shift += 8)
+    {
+        unsigned counts[256] = {};
+        for (const auto& entry : keys)
+            ++counts[(entry.first >> shift) & 0xffu];
+
+        if (counts[(keys[0].first >> shift) & 0xffu] == size)
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned& count : counts)
+        {
+            const unsigned start = offset;
+            offset += count;
+            count = start;
+        }
+
+        for (const auto& entry : keys)
+            temp[counts[(entry.first >> shift) & 0xffu]++] = entry;
+
+        ea::swap(keys, temp);
+    }
+
+    for (unsigned i = 0; i < size; ++i)
+        batches[i] = keys[i].second;
+}
+
+/// Pack render order, distance and state tiebreaker into a flat 64-bit distance-major sort key.
+inline unsigned long long PackDistanceSortKey(const Batch* batch, bool backToFront)
+{
+    unsigned distance = EncodeSortableDistance(batch->distance_);
+    if (backToFront)
+        distance = ~distance;
+    return ((unsigned long long)batch->renderOrder_ << 56u) | ((unsigned long long)distance << 24u) |
+        ((batch->sortKey_ >> 40u) & 0xffffffu);
+}
+
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
 {
     Camera* shadowCamera = queue->shadowSplits_[split].shadowCamera_;
@@ -237,7 +298,11 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
 
         // Use the "least filled" fill mode combined from camera & material
         graphics->SetFillMode((FillMode)(Max(camera->GetFillMode(), material_->GetFillMode())));
-        graphics->SetDepthTest(pass_->GetDepthTestMode());
+        // The render path command may override the pass depth test, e.g. to depth-equal after a depth prepass.
+        // Only passes that would write depth are affected, so e.g. skybox passes keep their own test
+        CompareMode depthTestOverride = view->GetCommandDepthTest();
+        graphics->SetDepthTest(depthTestOverride != MAX_COMPAREMODES && pass_->GetDepthWrite() ?
+            depthTestOverride : pass_->GetDepthTestMode());
         graphics->SetDepthWrite(pass_->GetDepthWrite() && allowDepthWrite);
     }
 
@@ -263,8 +328,18 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
         SetInstanceShaderParameters(graphics, shaderParameters_);
         if (geometryType_ == GEOM_SKINNED)
         {
-            graphics->SetShaderParameter(VSP_SKINMATRICES, reinterpret_cast<const float*>(worldTransform_),
-                12 * numWorldTransforms_);
+            Texture2D* skinMatrixTexture = renderer->GetSkinMatrixTexture();
+            if (skinMatrixOffset_ != M_MAX_UNSIGNED && skinMatrixTexture)
+            {
+                // Bone palette skinning: the shader fetches the bone transforms from the skin matrix texture
+                graphics->SetShaderParameter(VSP_SKINMATRIXINDEX, (float)skinMatrixOffset_);
+                graphics->SetTexture(TU_CUSTOM2, skinMatrixTexture);
+            }
+            else
+            {
+                graphics->SetShaderParameter(VSP_SKINMATRICES, reinterpret_cast<const float*>(worldTransform_),
+                    12 * numWorldTransforms_);
+            }
         }
         else
             graphics->SetShaderParameter(VSP_MODEL, *worldTransform_);
@@ -284,6 +359,9 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
         graphics->SetShaderParameter(VSP_LMOFFSET, *lightmapScaleOffset_);
     }
 
+    if (lodMorphParameters_)
+        graphics->SetShaderParameter(VSP_LODMORPH, *lodMorphParameters_);
+
     // Set zone-related shader parameters
     BlendMode blend = graphics->GetBlendMode();
     // If the pass is additive, override fog color to black so that shaders do not need a separate additive path
@@ -620,12 +698,13 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
     // Set material-specific shader parameters and textures
     if (material_)
     {
-        if (graphics->NeedParameterUpdate(SP_MATERIAL, reinterpret_cast<const void*>(material_->GetShaderParameterHash())))
+        // Identical parameter blocks are shared between materials, so cloned materials with equal parameters
+        // compare as the same state here
+        MaterialParameterBlock* parameterBlock = material_->GetShaderParameterBlock();
+        if (parameterBlock && graphics->NeedParameterUpdate(SP_MATERIAL, parameterBlock))
         {
-            const ea::unordered_map<StringHash, MaterialShaderParameter>& parameters = material_->GetShaderParameters();
-            for (auto i = parameters.begin(); i !=
-                parameters.end(); ++i)
-                graphics->SetShaderParameter(i->first, i->second.value_);
+            for (const auto& parameter : parameterBlock->parameters_)
+                graphics->SetShaderParameter(parameter.first, parameter.second);
         }
 
         const ea::unordered_map<TextureUnit, SharedPtr<Texture> >& textures = material_->GetTextures();
@@ -646,6 +725,10 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
         }
     }
 
+    // Set reflection probe environment texture, overriding the material's own environment map
+    if (environmentTexture_ && graphics->HasTextureUnit(TU_ENVIRONMENT))
+        graphics->SetTexture(TU_ENVIRONMENT, environmentTexture_);
+
     // Set light-related textures
     if (light)
     {
@@ -777,7 +860,11 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.size(); ++i)
         sortedBatches_[i] = &batches_[i];
 
-    ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesBackToFront);
+    // Radix sort large queues (typically alpha batches in particle-heavy scenes) on a flat 64-bit key
+    if (sortedBatches_.size() >= RADIX_SORT_BATCH_THRESHOLD)
+        RadixSortBatches(sortedBatches_, [](const Batch* batch) { return PackDistanceSortKey(batch, true); });
+    else
+        ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesBackToFront);
 
     sortedBatchGroups_.resize(batchGroups_.size());
 
@@ -826,6 +913,24 @@ void BatchQueue::SortFrontToBack()
     SortFrontToBack2Pass(sortedBatchGroups_);
 }
 
+void BatchQueue::SortByState()
+{
+    sortedBatches_.resize(batches_.size());
+
+    for (unsigned i = 0; i < batches_.size(); ++i)
+        sortedBatches_[i] = &batches_[i];
+
+    ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesState);
+
+    sortedBatchGroups_.resize(batchGroups_.size());
+
+    unsigned index = 0;
+    for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
+        sortedBatchGroups_[index++] = &i->second;
+
+    ea::quick_sort(sortedBatchGroups_.begin(), sortedBatchGroups_.end(), CompareBatchGroupOrder);
+}
+
 template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
 {
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
@@ -834,7 +939,10 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
 #else
     // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesFrontToBack);
+    if (batches.size() >= RADIX_SORT_BATCH_THRESHOLD)
+        RadixSortBatches(batches, [](const Batch* batch) { return PackDistanceSortKey(batch, false); });
+    else
+        ea::quick_sort(batches.begin(), batches.end(), CompareBatchesFrontToBack);
 
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -882,7 +990,21 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     geometryRemapping_.clear();
 
     // Finally sort again with the rewritten ID's
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
+    if (batches.size() >= RADIX_SORT_BATCH_THRESHOLD)
+    {
+        RadixSortBatches(batches, [](const Batch* batch)
+        {
+            // After remapping the shader ID is sequential plus the base pass flag in the top bit, so it fits in
+            // 24 bits; the distance tiebreaker of the comparison function is dropped
+            const auto shaderID = (unsigned)(batch->sortKey_ >> 32u);
+            return ((unsigned long long)batch->renderOrder_ << 56u) |
+                ((unsigned long long)((shaderID >> 31u) & 1u) << 55u) |
+                ((unsigned long long)(shaderID & 0x7fffffu) << 32u) |
+                (batch->sortKey_ & 0xffffffffu);
+        });
+    }
+    else
+        ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
 #endif
 }
 
@@ -44,6 +44,7 @@ class Material;
 class Matrix3x4;
 class Pass;
 class ShaderVariation;
+class Texture;
 class Texture2D;
 class VertexBuffer;
 class View;
@@ -78,10 +79,12 @@ struct Batch
         worldTransform_(rhs.worldTransform_),
         numWorldTransforms_(rhs.numWorldTransforms_),
         instancingData_(rhs.instancingData_),
+        instancingDataStride_(rhs.instancingDataStride_),
         lightQueue_(nullptr),
         geometryType_(rhs.geometryType_),
         lightmapScaleOffset_(rhs.lightmapScaleOffset_),
-        lightmapIndex_(rhs.lightmapIndex_)
+        lightmapIndex_(rhs.lightmapIndex_),
+        lodMorphParameters_(rhs.lodMorphParameters_)
     {
     }
 
@@ -112,8 +115,12 @@ struct Batch
     unsigned numWorldTransforms_{};
     /// Per-instance data. If not null, must contain enough data to fill instancing buffer.
     void* instancingData_{};
+    /// Per-instance data stride in bytes, or zero if all world transforms share the same data.
+    unsigned instancingDataStride_{};
     /// Zone.
     Zone* zone_{};
+    /// Reflection probe environment texture, or null to use the material's own.
+    Texture* environmentTexture_{};
     /// Light properties.
     LightBatchQueue* lightQueue_{};
     /// Material pass.
@@ -130,6 +137,10 @@ struct Batch
     Vector4* lightmapScaleOffset_{};
     /// Lightmap index.
     unsigned lightmapIndex_{};
+    /// LOD morph factor and level for terrain geomorphing.
+    Vector4* lodMorphParameters_{};
+    /// Offset of the bone transforms in the renderer's skin matrix texture, or M_MAX_UNSIGNED when uploaded as shader constants.
+    unsigned skinMatrixOffset_{M_MAX_UNSIGNED};
 };
 
 /// Data for one geometry instance.
@@ -189,6 +200,11 @@ struct BatchGroup : public Batch
         {
             newInstance.worldTransform_ = &batch.worldTransform_[i];
             instances_.push_back(newInstance);
+
+            // Step to the next per-instance data block when the batch provides one per transform
+            if (batch.instancingData_ && batch.instancingDataStride_)
+                newInstance.instancingData_ =
+                    static_cast<const unsigned char*>(newInstance.instancingData_) + batch.instancingDataStride_;
         }
     }
 
@@ -261,6 +277,8 @@ public:
     void SortBackToFront();
     /// Sort instanced and non-instanced draw calls front to back.
     void SortFrontToBack();
+    /// Sort batches by render state only, e.g. when a depth prepass has already eliminated overdraw.
+    void SortByState();
     /// Sort batches front to back while also maintaining state sorting.
     template <class T> void SortFrontToBack2Pass(ea::vector<T>& batches);
     /// Pre-set instance data of all groups. The vertex buffer must be big enough to hold all data.
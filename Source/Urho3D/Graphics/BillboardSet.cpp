@@ -26,6 +26,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/BillboardSet.h"
 #include "../Graphics/Camera.h"
@@ -96,7 +97,9 @@ BillboardSet::BillboardSet(Context* context) :
     sortThisFrame_(false),
     hasOrthoCamera_(false),
     sortFrameNumber_(0),
-    previousOffset_(Vector3::ZERO)
+    previousOffset_(Vector3::ZERO),
+    workVertexCount_(0),
+    commitPending_(false)
 {
     geometry_->SetVertexBuffer(0, vertexBuffer_);
     geometry_->SetIndexBuffer(indexBuffer_);
@@ -242,14 +245,44 @@ void BillboardSet::UpdateGeometry(const FrameInfo& frame)
 
     if (bufferDirty_ || sortThisFrame_ || vertexBuffer_->IsDataLost())
         UpdateVertexBuffer(frame);
+
+    // When updated on the main thread, upload immediately; worker thread updates are committed by the view
+    if (commitPending_ && Thread::IsMainThread())
+        CommitGeometry();
+}
+
+void BillboardSet::CommitGeometry()
+{
+    if (!commitPending_)
+        return;
+
+    commitPending_ = false;
+
+    // Verify that the buffer still matches the prepared data; if not, the next update will rewrite it
+    if (!workVertexCount_ || vertexBuffer_->GetVertexCount() < workVertexCount_ ||
+        workVertexData_.size() * sizeof(float) != (size_t)workVertexCount_ * vertexBuffer_->GetVertexSize())
+        return;
+
+    void* dest = vertexBuffer_->Lock(0, workVertexCount_, true);
+    if (dest)
+    {
+        memcpy(dest, &workVertexData_[0], workVertexData_.size() * sizeof(float));
+        vertexBuffer_->Unlock();
+    }
+
+    vertexBuffer_->ClearDataLost();
 }
 
 UpdateGeometryType BillboardSet::GetUpdateGeometryType()
 {
-    // If using camera facing, always need some kind of geometry update, in case the billboard set is rendered from several views
-    if (bufferDirty_ || bufferSizeDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost() || sortThisFrame_ ||
-        faceCameraMode_ != FC_NONE || fixedScreenSize_)
+    // Buffer resize and lost data recovery are GPU work and must happen on the main thread
+    if (bufferSizeDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost())
         return UPDATE_MAIN_THREAD;
+    // Sorting and camera-facing vertex math write into CPU memory and can run in a worker thread; the upload
+    // happens in CommitGeometry(). If using camera facing, always need some kind of geometry update, in case
+    // the billboard set is rendered from several views
+    else if (bufferDirty_ || sortThisFrame_ || faceCameraMode_ != FC_NONE || fixedScreenSize_)
+        return UPDATE_WORKER_THREAD;
     else
         return UPDATE_NONE;
 }
@@ -635,9 +668,10 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
         previousOffset_ = (worldPos - frame.camera_->GetNode()->GetWorldPosition());
     }
 
-    auto* dest = (float*)vertexBuffer_->Lock(0, enabledBillboards * 4, true);
-    if (!dest)
-        return;
+    // Write into CPU memory; the buffer upload happens in CommitGeometry() on the main thread
+    workVertexCount_ = enabledBillboards * 4;
+    workVertexData_.resize(workVertexCount_ * (vertexBuffer_->GetVertexSize() / sizeof(float)));
+    float* dest = &workVertexData_[0];
 
     if (faceCameraMode_ != FC_DIRECTION)
     {
@@ -650,46 +684,49 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             if (fixedScreenSize_)
                 size *= billboard.screenScaleFactor_;
 
-            float rotationMatrix[2][2];
-            SinCos(billboard.rotation_, rotationMatrix[0][1], rotationMatrix[0][0]);
-            rotationMatrix[1][0] = -rotationMatrix[0][1];
-            rotationMatrix[1][1] = rotationMatrix[0][0];
+            // Evaluate the rotated corner offset terms once instead of per corner
+            float sinRot;
+            float cosRot;
+            SinCos(billboard.rotation_, sinRot, cosRot);
+            float xCos = size.x_ * cosRot;
+            float xSin = size.x_ * sinRot;
+            float yCos = size.y_ * cosRot;
+            float ySin = size.y_ * sinRot;
+
+#ifdef URHO3D_SSE
+            // Position and color are shared by all four vertices
+            __m128 posColor = _mm_set_ps(*reinterpret_cast<float*>(&color), billboard.position_.z_,
+                billboard.position_.y_, billboard.position_.x_);
+            _mm_storeu_ps(dest, posColor);
+            _mm_storeu_ps(dest + 8, posColor);
+            _mm_storeu_ps(dest + 16, posColor);
+            _mm_storeu_ps(dest + 24, posColor);
+#else
+            dest[0] = dest[8] = dest[16] = dest[24] = billboard.position_.x_;
+            dest[1] = dest[9] = dest[17] = dest[25] = billboard.position_.y_;
+            dest[2] = dest[10] = dest[18] = dest[26] = billboard.position_.z_;
+            ((unsigned&)dest[3]) = ((unsigned&)dest[11]) = ((unsigned&)dest[19]) = ((unsigned&)dest[27]) = color;
+#endif
 
-            dest[0] = billboard.position_.x_;
-            dest[1] = billboard.position_.y_;
-            dest[2] = billboard.position_.z_;
-            ((unsigned&)dest[3]) = color;
             dest[4] = billboard.uv_.min_.x_;
             dest[5] = billboard.uv_.min_.y_;
-            dest[6] = -size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[7] = -size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
+            dest[6] = -xCos + ySin;
+            dest[7] = xSin + yCos;
 
-            dest[8] = billboard.position_.x_;
-            dest[9] = billboard.position_.y_;
-            dest[10] = billboard.position_.z_;
-            ((unsigned&)dest[11]) = color;
             dest[12] = billboard.uv_.max_.x_;
             dest[13] = billboard.uv_.min_.y_;
-            dest[14] = size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[15] = size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
+            dest[14] = xCos + ySin;
+            dest[15] = -xSin + yCos;
 
-            dest[16] = billboard.position_.x_;
-            dest[17] = billboard.position_.y_;
-            dest[18] = billboard.position_.z_;
-            ((unsigned&)dest[19]) = color;
             dest[20] = billboard.uv_.max_.x_;
             dest[21] = billboard.uv_.max_.y_;
-            dest[22] = size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[23] = size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
+            dest[22] = xCos - ySin;
+            dest[23] = -xSin - yCos;
 
-            dest[24] = billboard.position_.x_;
-            dest[25] = billboard.position_.y_;
-            dest[26] = billboard.position_.z_;
-            ((unsigned&)dest[27]) = color;
             dest[28] = billboard.uv_.min_.x_;
             dest[29] = billboard.uv_.max_.y_;
-            dest[30] = -size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[31] = -size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
+            dest[30] = -xCos - ySin;
+            dest[31] = xSin - yCos;
 
             dest += 32;
         }
@@ -705,10 +742,14 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             if (fixedScreenSize_)
                 size *= billboard.screenScaleFactor_;
 
-            float rot2D[2][2];
-            SinCos(billboard.rotation_, rot2D[0][1], rot2D[0][0]);
-            rot2D[1][0] = -rot2D[0][1];
-            rot2D[1][1] = rot2D[0][0];
+            // Evaluate the rotated corner offset terms once instead of per corner
+            float sinRot;
+            float cosRot;
+            SinCos(billboard.rotation_, sinRot, cosRot);
+            float xCos = size.x_ * cosRot;
+            float xSin = size.x_ * sinRot;
+            float yCos = size.y_ * cosRot;
+            float ySin = size.y_ * sinRot;
 
             dest[0] = billboard.position_.x_;
             dest[1] = billboard.position_.y_;
@@ -719,8 +760,8 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             ((unsigned&)dest[6]) = color;
             dest[7] = billboard.uv_.min_.x_;
             dest[8] = billboard.uv_.min_.y_;
-            dest[9] = -size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[10] = -size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
+            dest[9] = -xCos + ySin;
+            dest[10] = xSin + yCos;
 
             dest[11] = billboard.position_.x_;
             dest[12] = billboard.position_.y_;
@@ -731,8 +772,8 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             ((unsigned&)dest[17]) = color;
             dest[18] = billboard.uv_.max_.x_;
             dest[19] = billboard.uv_.min_.y_;
-            dest[20] = size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[21] = size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
+            dest[20] = xCos + ySin;
+            dest[21] = -xSin + yCos;
 
             dest[22] = billboard.position_.x_;
             dest[23] = billboard.position_.y_;
@@ -743,8 +784,8 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             ((unsigned&)dest[28]) = color;
             dest[29] = billboard.uv_.max_.x_;
             dest[30] = billboard.uv_.max_.y_;
-            dest[31] = size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[32] = size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+            dest[31] = xCos - ySin;
+            dest[32] = -xSin - yCos;
 
             dest[33] = billboard.position_.x_;
             dest[34] = billboard.position_.y_;
@@ -755,15 +796,14 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
             ((unsigned&)dest[39]) = color;
             dest[40] = billboard.uv_.min_.x_;
             dest[41] = billboard.uv_.max_.y_;
-            dest[42] = -size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[43] = -size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+            dest[42] = -xCos - ySin;
+            dest[43] = xSin - yCos;
 
             dest += 44;
         }
     }
 
-    vertexBuffer_->Unlock();
-    vertexBuffer_->ClearDataLost();
+    commitPending_ = true;
 }
 
 void BillboardSet::MarkPositionsDirty()
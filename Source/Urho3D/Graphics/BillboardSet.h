@@ -88,6 +88,8 @@ public:
     void UpdateBatches(const FrameInfo& frame) override;
     /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update).
     void UpdateGeometry(const FrameInfo& frame) override;
+    /// Upload billboard vertex data prepared by a worker thread update.
+    void CommitGeometry() override;
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     UpdateGeometryType GetUpdateGeometryType() override;
 
@@ -217,6 +219,12 @@ private:
     Vector3 previousOffset_;
     /// Billboard pointers for sorting.
     ea::vector<Billboard*> sortedBillboards_;
+    /// Vertex data prepared by a worker thread update, pending upload in CommitGeometry().
+    ea::vector<float> workVertexData_;
+    /// Number of vertices pending upload.
+    unsigned workVertexCount_;
+    /// Vertex data pending upload flag.
+    bool commitPending_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
 };
@@ -690,4 +690,49 @@ void Camera::UpdateProjection() const
     customProjection_ = false;
 }
 
+void CameraSnapshot::Define(Camera* camera)
+{
+    // Calling the getters also primes the camera's own lazily evaluated caches, so that any remaining const reads
+    // through the camera from worker threads no longer mutate its state
+    frustum_ = camera->GetFrustum();
+    view_ = camera->GetView();
+    projection_ = camera->GetProjection();
+    worldPosition_ = camera->GetNode() ? camera->GetNode()->GetWorldPosition() : Vector3::ZERO;
+    viewMask_ = camera->GetViewMask();
+    nearClip_ = camera->GetNearClip();
+    farClip_ = camera->GetFarClip();
+    lodBias_ = camera->GetLodBias();
+    zoom_ = camera->GetZoom();
+    orthoSize_ = camera->GetOrthoSize();
+    orthographic_ = camera->IsOrthographic();
+}
+
+float CameraSnapshot::GetDistance(const Vector3& worldPos) const
+{
+    if (!orthographic_)
+        return (worldPos - worldPosition_).Length();
+    else
+        return Abs((view_ * worldPos).z_);
+}
+
+float CameraSnapshot::GetDistanceSquared(const Vector3& worldPos) const
+{
+    if (!orthographic_)
+        return (worldPos - worldPosition_).LengthSquared();
+    else
+    {
+        float distance = (view_ * worldPos).z_;
+        return distance * distance;
+    }
+}
+
+float CameraSnapshot::GetLodDistance(float distance, float scale, float bias) const
+{
+    float d = Max(lodBias_ * bias * scale * zoom_, M_EPSILON);
+    if (!orthographic_)
+        return distance / d;
+    else
+        return orthoSize_ / d;
+}
+
 }
@@ -284,4 +284,68 @@ private:
     mutable bool customProjection_;
 };
 
+/// Immutable per-frame snapshot of a camera's derived data. Defined once on the main thread at the start of view
+/// update, so that worker threads can read culling and LOD data without triggering the camera's lazy recomputation.
+class URHO3D_API CameraSnapshot
+{
+public:
+    /// Define from a camera. Also primes the camera's own lazily evaluated caches. Call from the main thread only.
+    void Define(Camera* camera);
+
+    /// Return frustum in world space.
+    const Frustum& GetFrustum() const { return frustum_; }
+
+    /// Return view matrix.
+    const Matrix3x4& GetView() const { return view_; }
+
+    /// Return projection matrix.
+    const Matrix4& GetProjection() const { return projection_; }
+
+    /// Return camera world position.
+    const Vector3& GetWorldPosition() const { return worldPosition_; }
+
+    /// Return view mask.
+    unsigned GetViewMask() const { return viewMask_; }
+
+    /// Return near clip distance.
+    float GetNearClip() const { return nearClip_; }
+
+    /// Return far clip distance.
+    float GetFarClip() const { return farClip_; }
+
+    /// Return orthographic flag.
+    bool IsOrthographic() const { return orthographic_; }
+
+    /// Return distance to position. In orthographic mode uses only Z coordinate.
+    float GetDistance(const Vector3& worldPos) const;
+    /// Return squared distance to position. In orthographic mode uses only Z coordinate.
+    float GetDistanceSquared(const Vector3& worldPos) const;
+    /// Return a scene node's LOD scaled distance.
+    float GetLodDistance(float distance, float scale, float bias) const;
+
+private:
+    /// World space frustum.
+    Frustum frustum_;
+    /// View matrix.
+    Matrix3x4 view_;
+    /// Projection matrix.
+    Matrix4 projection_;
+    /// Camera world position.
+    Vector3 worldPosition_;
+    /// View mask.
+    unsigned viewMask_{M_MAX_UNSIGNED};
+    /// Near clip distance.
+    float nearClip_{};
+    /// Far clip distance.
+    float farClip_{};
+    /// LOD bias.
+    float lodBias_{1.0f};
+    /// Zoom.
+    float zoom_{1.0f};
+    /// Orthographic view size.
+    float orthoSize_{};
+    /// Orthographic mode flag.
+    bool orthographic_{};
+};
+
 }
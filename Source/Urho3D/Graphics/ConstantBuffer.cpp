@@ -53,6 +53,9 @@ void ConstantBuffer::SetParameter(unsigned offset, unsigned size, const void* da
     if (offset + size > size_)
         return; // Would overflow the buffer
 
+    if (memcmp(shadowData_.get() + offset, data, size) == 0)
+        return; // Value unchanged, avoid re-uploading the whole buffer
+
     memcpy(shadowData_.get() + offset, data, size);
     dirty_ = true;
 }
@@ -64,16 +67,19 @@ void ConstantBuffer::SetVector3ArrayParameter(unsigned offset, unsigned rows, co
 
     auto* dest = (float*)&shadowData_[offset];
     const auto* src = (const float*)data;
+    bool changed = false;
 
     while (rows--)
     {
+        changed |= dest[0] != src[0] || dest[1] != src[1] || dest[2] != src[2];
         *dest++ = *src++;
         *dest++ = *src++;
         *dest++ = *src++;
         ++dest; // Skip over the w coordinate
     }
 
-    dirty_ = true;
+    if (changed)
+        dirty_ = true;
 }
 
 }
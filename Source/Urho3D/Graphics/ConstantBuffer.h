@@ -54,9 +54,9 @@ public:
 
     /// Set size and create GPU-side buffer. Return true on success.
     bool SetSize(unsigned size);
-    /// Set a generic parameter and mark buffer dirty.
+    /// Set a generic parameter and mark buffer dirty. No-op if the data is unchanged.
     void SetParameter(unsigned offset, unsigned size, const void* data);
-    /// Set a Vector3 array parameter and mark buffer dirty.
+    /// Set a Vector3 array parameter and mark buffer dirty. No-op if the data is unchanged.
     void SetVector3ArrayParameter(unsigned offset, unsigned rows, const void* data);
     /// Apply to GPU.
     void Apply();
@@ -28,6 +28,7 @@
 #include "../Graphics/Camera.h"
 #include "../Graphics/CustomGeometry.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
 #include "../Graphics/OctreeQuery.h"
@@ -47,12 +48,17 @@ extern const char* GEOMETRY_CATEGORY;
 CustomGeometry::CustomGeometry(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
     vertexBuffer_(context->CreateObject<VertexBuffer>()),
+    indexBuffer_(context->CreateObject<IndexBuffer>()),
     elementMask_(MASK_POSITION),
     geometryIndex_(0),
+    dirtyVertexStart_(0),
+    dirtyVertexEnd_(0),
     materialsAttr_(Material::GetTypeStatic()),
-    dynamic_(false)
+    dynamic_(false),
+    structureDirty_(true)
 {
     vertexBuffer_->SetShadowed(true);
+    indexBuffer_->SetShadowed(true);
     SetNumGeometries(1);
 }
 
@@ -155,7 +161,7 @@ unsigned CustomGeometry::GetNumOccluderTriangles()
         if (mat && !mat->GetOcclusion())
             continue;
 
-        triangles += geometry->GetVertexCount() / 3;
+        triangles += (geometry->GetIndexCount() ? geometry->GetIndexCount() : geometry->GetVertexCount()) / 3;
     }
 
     return triangles;
@@ -194,8 +200,16 @@ bool CustomGeometry::DrawOcclusion(OcclusionBuffer* buffer)
             continue;
 
         // Draw and check for running out of triangles
-        success = buffer->AddTriangles(node_->GetWorldTransform(), vertexData, vertexSize, geometry->GetVertexStart(),
-            geometry->GetVertexCount());
+        if (indexData && geometry->GetIndexCount())
+        {
+            success = buffer->AddTriangles(node_->GetWorldTransform(), vertexData, vertexSize, indexData, indexSize,
+                geometry->GetIndexStart(), geometry->GetIndexCount());
+        }
+        else
+        {
+            success = buffer->AddTriangles(node_->GetWorldTransform(), vertexData, vertexSize, geometry->GetVertexStart(),
+                geometry->GetVertexCount());
+        }
 
         if (!success)
             break;
@@ -496,6 +510,8 @@ void CustomGeometry::Clear()
     geometries_.clear();
     primitiveTypes_.clear();
     vertices_.clear();
+    indices_.clear();
+    structureDirty_ = true;
 }
 
 void CustomGeometry::SetNumGeometries(unsigned num)
@@ -504,6 +520,8 @@ void CustomGeometry::SetNumGeometries(unsigned num)
     geometries_.resize(num);
     primitiveTypes_.resize(num);
     vertices_.resize(num);
+    indices_.resize(num);
+    structureDirty_ = true;
 
     for (unsigned i = 0; i < geometries_.size(); ++i)
     {
@@ -532,12 +550,26 @@ void CustomGeometry::BeginGeometry(unsigned index, PrimitiveType type)
     geometryIndex_ = index;
     primitiveTypes_[index] = type;
     vertices_[index].clear();
+    indices_[index].clear();
+    structureDirty_ = true;
 
     // If beginning the first geometry, reset the element mask
     if (!index)
         elementMask_ = MASK_POSITION;
 }
 
+void CustomGeometry::ReserveVertices(unsigned numVertices)
+{
+    if (geometryIndex_ < vertices_.size())
+        vertices_[geometryIndex_].reserve(numVertices);
+}
+
+void CustomGeometry::ReserveIndices(unsigned numIndices)
+{
+    if (geometryIndex_ < indices_.size())
+        indices_[geometryIndex_].reserve(numIndices);
+}
+
 void CustomGeometry::DefineVertex(const Vector3& position)
 {
     if (vertices_.size() < geometryIndex_)
@@ -545,6 +577,25 @@ void CustomGeometry::DefineVertex(const Vector3& position)
 
     vertices_[geometryIndex_].resize(vertices_[geometryIndex_].size() + 1);
     vertices_[geometryIndex_].back().position_ = position;
+    structureDirty_ = true;
+}
+
+void CustomGeometry::DefineVertex(const CustomGeometryVertex& vertex)
+{
+    if (vertices_.size() < geometryIndex_)
+        return;
+
+    vertices_[geometryIndex_].push_back(vertex);
+    structureDirty_ = true;
+}
+
+void CustomGeometry::DefineIndex(unsigned index)
+{
+    if (indices_.size() < geometryIndex_)
+        return;
+
+    indices_[geometryIndex_].push_back(index);
+    structureDirty_ = true;
 }
 
 void CustomGeometry::DefineNormal(const Vector3& normal)
@@ -595,6 +646,7 @@ void CustomGeometry::DefineGeometry(unsigned index, PrimitiveType type, unsigned
     geometryIndex_ = index;
     primitiveTypes_[index] = type;
     vertices_[index].resize(numVertices);
+    structureDirty_ = true;
 
     // If defining the first geometry, reset the element mask
     if (!index)
@@ -614,11 +666,13 @@ void CustomGeometry::Commit()
     URHO3D_PROFILE("CommitCustomGeometry");
 
     unsigned totalVertices = 0;
+    unsigned totalIndices = 0;
     boundingBox_.Clear();
 
     for (unsigned i = 0; i < vertices_.size(); ++i)
     {
         totalVertices += vertices_[i].size();
+        totalIndices += indices_[i].size();
 
         for (unsigned j = 0; j < vertices_[i].size(); ++j)
             boundingBox_.Merge(vertices_[i][j].position_);
@@ -627,71 +681,170 @@ void CustomGeometry::Commit()
     // Make sure world-space bounding box will be updated
     OnMarkedDirty(node_);
 
+    // If only a known span of vertices was modified and the buffer layout is unchanged, upload just that span
+    if (!structureDirty_ && dirtyVertexEnd_ > dirtyVertexStart_ && vertexBuffer_->GetVertexCount() == totalVertices &&
+        vertexBuffer_->GetElementMask() == elementMask_ && vertexBuffer_->IsDynamic() == dynamic_)
+    {
+        auto* dest = (unsigned char*)vertexBuffer_->Lock(dirtyVertexStart_, dirtyVertexEnd_ - dirtyVertexStart_);
+        if (dest)
+        {
+            unsigned vertexStart = 0;
+
+            for (unsigned i = 0; i < vertices_.size(); ++i)
+            {
+                // Skip geometries fully outside the modified span
+                if (vertexStart + vertices_[i].size() > dirtyVertexStart_ && vertexStart < dirtyVertexEnd_)
+                {
+                    for (unsigned j = 0; j < vertices_[i].size(); ++j)
+                    {
+                        unsigned index = vertexStart + j;
+                        if (index >= dirtyVertexStart_ && index < dirtyVertexEnd_)
+                            WriteVertex(dest, vertices_[i][j]);
+                    }
+                }
+
+                vertexStart += vertices_[i].size();
+            }
+
+            vertexBuffer_->Unlock();
+        }
+        else
+            URHO3D_LOGERROR("Failed to lock custom geometry vertex buffer");
+
+        dirtyVertexStart_ = dirtyVertexEnd_ = 0;
+        return;
+    }
+
     // Resize (recreate) the vertex buffer only if necessary
     if (vertexBuffer_->GetVertexCount() != totalVertices || vertexBuffer_->GetElementMask() != elementMask_ ||
         vertexBuffer_->IsDynamic() != dynamic_)
         vertexBuffer_->SetSize(totalVertices, elementMask_, dynamic_);
 
+    // Use 32-bit indices only when necessary
+    bool largeIndices = totalVertices > 0xffff;
+    unsigned indexSize = largeIndices ? sizeof(unsigned) : sizeof(unsigned short);
+    if (totalIndices && (indexBuffer_->GetIndexCount() != totalIndices || indexBuffer_->GetIndexSize() != indexSize ||
+        indexBuffer_->IsDynamic() != dynamic_))
+        indexBuffer_->SetSize(totalIndices, largeIndices, dynamic_);
+
     if (totalVertices)
     {
         auto* dest = (unsigned char*)vertexBuffer_->Lock(0, totalVertices, true);
+        auto* destIndices = totalIndices ? (unsigned char*)indexBuffer_->Lock(0, totalIndices, true) : nullptr;
+        if (totalIndices && !destIndices)
+            URHO3D_LOGERROR("Failed to lock custom geometry index buffer");
+
         if (dest)
         {
             unsigned vertexStart = 0;
+            unsigned indexStart = 0;
 
             for (unsigned i = 0; i < vertices_.size(); ++i)
             {
-                unsigned vertexCount = 0;
+                unsigned vertexCount = vertices_[i].size();
+                unsigned indexCount = destIndices ? indices_[i].size() : 0;
 
-                for (unsigned j = 0; j < vertices_[i].size(); ++j)
-                {
-                    *((Vector3*)dest) = vertices_[i][j].position_;
-                    dest += sizeof(Vector3);
+                for (unsigned j = 0; j < vertexCount; ++j)
+                    WriteVertex(dest, vertices_[i][j]);
 
-                    if (elementMask_ & MASK_NORMAL)
-                    {
-                        *((Vector3*)dest) = vertices_[i][j].normal_;
-                        dest += sizeof(Vector3);
-                    }
-                    if (elementMask_ & MASK_COLOR)
-                    {
-                        *((unsigned*)dest) = vertices_[i][j].color_;
-                        dest += sizeof(unsigned);
-                    }
-                    if (elementMask_ & MASK_TEXCOORD1)
+                // Write indices relative to the combined vertex buffer
+                for (unsigned j = 0; j < indexCount; ++j)
+                {
+                    if (largeIndices)
                     {
-                        *((Vector2*)dest) = vertices_[i][j].texCoord_;
-                        dest += sizeof(Vector2);
+                        *((unsigned*)destIndices) = vertexStart + indices_[i][j];
+                        destIndices += sizeof(unsigned);
                     }
-                    if (elementMask_ & MASK_TANGENT)
+                    else
                     {
-                        *((Vector4*)dest) = vertices_[i][j].tangent_;
-                        dest += sizeof(Vector4);
+                        *((unsigned short*)destIndices) = (unsigned short)(vertexStart + indices_[i][j]);
+                        destIndices += sizeof(unsigned short);
                     }
-
-                    ++vertexCount;
                 }
 
                 geometries_[i]->SetVertexBuffer(0, vertexBuffer_);
-                geometries_[i]->SetDrawRange(primitiveTypes_[i], 0, 0, vertexStart, vertexCount);
+                geometries_[i]->SetIndexBuffer(indexCount ? indexBuffer_ : nullptr);
+                if (indexCount)
+                    geometries_[i]->SetDrawRange(primitiveTypes_[i], indexStart, indexCount, vertexStart, vertexCount);
+                else
+                    geometries_[i]->SetDrawRange(primitiveTypes_[i], 0, 0, vertexStart, vertexCount);
                 vertexStart += vertexCount;
+                indexStart += indexCount;
             }
 
             vertexBuffer_->Unlock();
+            if (destIndices)
+                indexBuffer_->Unlock();
         }
         else
+        {
+            if (destIndices)
+                indexBuffer_->Unlock();
             URHO3D_LOGERROR("Failed to lock custom geometry vertex buffer");
+        }
     }
     else
     {
         for (unsigned i = 0; i < geometries_.size(); ++i)
         {
             geometries_[i]->SetVertexBuffer(0, vertexBuffer_);
+            geometries_[i]->SetIndexBuffer(nullptr);
             geometries_[i]->SetDrawRange(primitiveTypes_[i], 0, 0, 0, 0);
         }
     }
 
     vertexBuffer_->ClearDataLost();
+    indexBuffer_->ClearDataLost();
+    structureDirty_ = false;
+    dirtyVertexStart_ = dirtyVertexEnd_ = 0;
+}
+
+void CustomGeometry::MarkVertexDirty(unsigned geometryIndex, unsigned vertexNum)
+{
+    if (geometryIndex >= vertices_.size() || vertexNum >= vertices_[geometryIndex].size())
+        return;
+
+    unsigned index = vertexNum;
+    for (unsigned i = 0; i < geometryIndex; ++i)
+        index += vertices_[i].size();
+
+    if (dirtyVertexEnd_ <= dirtyVertexStart_)
+    {
+        dirtyVertexStart_ = index;
+        dirtyVertexEnd_ = index + 1;
+    }
+    else
+    {
+        dirtyVertexStart_ = Min(dirtyVertexStart_, index);
+        dirtyVertexEnd_ = Max(dirtyVertexEnd_, index + 1);
+    }
+}
+
+void CustomGeometry::WriteVertex(unsigned char*& dest, const CustomGeometryVertex& vertex) const
+{
+    *((Vector3*)dest) = vertex.position_;
+    dest += sizeof(Vector3);
+
+    if (elementMask_ & MASK_NORMAL)
+    {
+        *((Vector3*)dest) = vertex.normal_;
+        dest += sizeof(Vector3);
+    }
+    if (elementMask_ & MASK_COLOR)
+    {
+        *((unsigned*)dest) = vertex.color_;
+        dest += sizeof(unsigned);
+    }
+    if (elementMask_ & MASK_TEXCOORD1)
+    {
+        *((Vector2*)dest) = vertex.texCoord_;
+        dest += sizeof(Vector2);
+    }
+    if (elementMask_ & MASK_TANGENT)
+    {
+        *((Vector4*)dest) = vertex.tangent_;
+        dest += sizeof(Vector4);
+    }
 }
 
 void CustomGeometry::SetMaterial(Material* material)
@@ -720,6 +873,11 @@ unsigned CustomGeometry::GetNumVertices(unsigned index) const
     return index < vertices_.size() ? vertices_[index].size() : 0;
 }
 
+unsigned CustomGeometry::GetNumIndices(unsigned index) const
+{
+    return index < indices_.size() ? indices_[index].size() : 0;
+}
+
 Material* CustomGeometry::GetMaterial(unsigned index) const
 {
     return index < batches_.size() ? batches_[index].material_ : nullptr;
@@ -727,8 +885,14 @@ Material* CustomGeometry::GetMaterial(unsigned index) const
 
 CustomGeometryVertex* CustomGeometry::GetVertex(unsigned geometryIndex, unsigned vertexNum)
 {
-    return (geometryIndex < vertices_.size() && vertexNum < vertices_[geometryIndex].size()) ?
-           &vertices_[geometryIndex][vertexNum] : nullptr;
+    if (geometryIndex < vertices_.size() && vertexNum < vertices_[geometryIndex].size())
+    {
+        // Assume the vertex will be edited, so that the next Commit() can upload only the modified range
+        MarkVertexDirty(geometryIndex, vertexNum);
+        return &vertices_[geometryIndex][vertexNum];
+    }
+
+    return nullptr;
 }
 
 void CustomGeometry::SetGeometryDataAttr(const ea::vector<unsigned char>& value)
@@ -762,6 +926,16 @@ void CustomGeometry::SetGeometryDataAttr(const ea::vector<unsigned char>& value)
         }
     }
 
+    // Index data follows all vertex data; it may be absent from data saved before indexed geometry support
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        unsigned numIndices = buffer.IsEof() ? 0 : buffer.ReadVLE();
+        indices_[i].resize(numIndices);
+
+        for (unsigned j = 0; j < numIndices; ++j)
+            indices_[i][j] = buffer.ReadVLE();
+    }
+
     Commit();
 }
 
@@ -800,6 +974,15 @@ ea::vector<unsigned char> CustomGeometry::GetGeometryDataAttr() const
         }
     }
 
+    // Write index data after all vertex data to stay readable by code without indexed geometry support
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        ret.WriteVLE(indices_[i].size());
+
+        for (unsigned j = 0; j < indices_[i].size(); ++j)
+            ret.WriteVLE(indices_[i][j]);
+    }
+
     return ret.GetBuffer();
 }
 
@@ -54,6 +54,7 @@ struct CustomGeometryVertex
     Vector4 tangent_;
 };
 
+class IndexBuffer;
 class VertexBuffer;
 
 /// Custom geometry component.
@@ -117,10 +118,18 @@ public:
     void SetNumGeometries(unsigned num);
     /// Set vertex buffer dynamic mode. A dynamic buffer should be faster to update frequently. Effective at the next Commit() call.
     void SetDynamic(bool enable);
-    /// Begin defining a geometry. Clears existing vertices in that index.
+    /// Begin defining a geometry. Clears existing vertices and indices in that index.
     void BeginGeometry(unsigned index, PrimitiveType type);
+    /// Reserve space for vertices in the current geometry to avoid reallocation during definition.
+    void ReserveVertices(unsigned numVertices);
+    /// Reserve space for indices in the current geometry to avoid reallocation during definition.
+    void ReserveIndices(unsigned numIndices);
     /// Define a vertex position. This begins a new vertex.
     void DefineVertex(const Vector3& position);
+    /// Define a complete vertex in one call. The element mask is not affected; declare the elements in use with DefineGeometry() or the individual Define functions.
+    void DefineVertex(const CustomGeometryVertex& vertex);
+    /// Define an index into the current geometry's vertices. When indices are defined, the geometry is drawn indexed.
+    void DefineIndex(unsigned index);
     /// Define a vertex normal.
     void DefineNormal(const Vector3& normal);
     /// Define a vertex color.
@@ -133,8 +142,10 @@ public:
     void DefineGeometry
         (unsigned index, PrimitiveType type, unsigned numVertices, bool hasNormals, bool hasColors, bool hasTexCoords,
             bool hasTangents);
-    /// Update vertex buffer and calculate the bounding box. Call after finishing defining geometry.
+    /// Update vertex buffer and calculate the bounding box. Call after finishing defining geometry. Uploads only the modified vertex range when possible.
     void Commit();
+    /// Mark a vertex as modified, so that the next Commit() can upload only the modified range. Called automatically by GetVertex().
+    void MarkVertexDirty(unsigned geometryIndex, unsigned vertexNum);
     /// Set material on all geometries.
     void SetMaterial(Material* material);
     /// Set material on one geometry. Return true if successful.
@@ -146,14 +157,21 @@ public:
     /// Return number of vertices in a geometry.
     unsigned GetNumVertices(unsigned index) const;
 
+    /// Return number of indices in a geometry.
+    unsigned GetNumIndices(unsigned index) const;
+
     /// Return whether vertex buffer dynamic mode is enabled.
     bool IsDynamic() const { return dynamic_; }
 
     /// Return material by geometry index.
     Material* GetMaterial(unsigned index = 0) const;
 
-    /// Return all vertices. These can be edited; calling Commit() updates the vertex buffer.
-    ea::vector<ea::vector<CustomGeometryVertex> >& GetVertices() { return vertices_; }
+    /// Return all vertices. These can be edited; calling Commit() updates the vertex buffer. Forces a full buffer update on the next Commit(), as the edits can not be tracked.
+    ea::vector<ea::vector<CustomGeometryVertex> >& GetVertices()
+    {
+        structureDirty_ = true;
+        return vertices_;
+    }
 
     /// Return a vertex in a geometry for editing, or null if out of bounds. After the edits are finished, calling Commit() updates  the vertex buffer.
     CustomGeometryVertex* GetVertex(unsigned geometryIndex, unsigned vertexNum);
@@ -172,22 +190,35 @@ protected:
     void OnWorldBoundingBoxUpdate() override;
 
 private:
+    /// Write one vertex into the vertex buffer and advance the destination pointer.
+    void WriteVertex(unsigned char*& dest, const CustomGeometryVertex& vertex) const;
+
     /// Primitive type per geometry.
     ea::vector<PrimitiveType> primitiveTypes_;
     /// Source vertices per geometry.
     ea::vector<ea::vector<CustomGeometryVertex> > vertices_;
+    /// Source indices per geometry. May be empty, in which case the geometry is drawn non-indexed.
+    ea::vector<ea::vector<unsigned> > indices_;
     /// All geometries.
     ea::vector<SharedPtr<Geometry> > geometries_;
     /// Vertex buffer.
     SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Index buffer.
+    SharedPtr<IndexBuffer> indexBuffer_;
     /// Element mask used so far.
     VertexMaskFlags elementMask_;
     /// Current geometry being updated.
     unsigned geometryIndex_;
+    /// First modified vertex in the combined vertex buffer.
+    unsigned dirtyVertexStart_;
+    /// One past the last modified vertex in the combined vertex buffer.
+    unsigned dirtyVertexEnd_;
     /// Material list attribute.
     mutable ResourceRefList materialsAttr_;
     /// Vertex buffer dynamic flag.
     bool dynamic_;
+    /// Structure (vertex or index counts, draw ranges) changed flag. Forces a full buffer update on Commit().
+    bool structureDirty_;
 };
 
 }
@@ -25,15 +25,19 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Light.h"
 #include "../Graphics/ShaderVariation.h"
+#include "../Graphics/TransientBuffer.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Geometry.h"
+#include "../IO/Log.h"
 #include "../Math/Polyhedron.h"
 #include "../Resource/ResourceCache.h"
 
@@ -53,7 +57,8 @@ DebugRenderer::DebugRenderer(Context* context) :
     Component(context),
     lineAntiAlias_(false)
 {
-    vertexBuffer_ = context_->CreateObject<VertexBuffer>();
+    if (auto* workQueue = GetSubsystem<WorkQueue>())
+        threadBuffers_.resize(workQueue->GetNumThreads());
 
     SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(DebugRenderer, HandleEndFrame));
 }
@@ -94,6 +99,34 @@ void DebugRenderer::AddLine(const Vector3& start, const Vector3& end, const Colo
 
 void DebugRenderer::AddLine(const Vector3& start, const Vector3& end, unsigned color, bool depthTest)
 {
+    if (!Thread::IsMainThread())
+    {
+        // On a worker thread, append to the per-thread buffer. Threads not owned by the work queue have no buffer
+        // and their geometry is dropped
+        unsigned threadIndex = WorkQueue::GetThreadIndex();
+        if (!threadIndex || threadIndex > threadBuffers_.size())
+            return;
+
+        ThreadBuffer& buffer = threadBuffers_[threadIndex - 1];
+        if (buffer.lines_.size() + buffer.noDepthLines_.size() >= MAX_LINES / threadBuffers_.size())
+            return;
+
+        if (depthTest)
+            buffer.lines_.push_back(DebugLine(start, end, color));
+        else
+            buffer.noDepthLines_.push_back(DebugLine(start, end, color));
+        return;
+    }
+
+    if (captureCache_)
+    {
+        if (depthTest)
+            captureCache_->lines_.push_back(DebugLine(start, end, color));
+        else
+            captureCache_->noDepthLines_.push_back(DebugLine(start, end, color));
+        return;
+    }
+
     if (lines_.size() + noDepthLines_.size() >= MAX_LINES)
         return;
 
@@ -124,6 +157,34 @@ void DebugRenderer::AddTriangle(const Vector3& v1, const Vector3& v2, const Vect
 
 void DebugRenderer::AddTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, unsigned color, bool depthTest)
 {
+    if (!Thread::IsMainThread())
+    {
+        // On a worker thread, append to the per-thread buffer. Threads not owned by the work queue have no buffer
+        // and their geometry is dropped
+        unsigned threadIndex = WorkQueue::GetThreadIndex();
+        if (!threadIndex || threadIndex > threadBuffers_.size())
+            return;
+
+        ThreadBuffer& buffer = threadBuffers_[threadIndex - 1];
+        if (buffer.triangles_.size() + buffer.noDepthTriangles_.size() >= MAX_TRIANGLES / threadBuffers_.size())
+            return;
+
+        if (depthTest)
+            buffer.triangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        else
+            buffer.noDepthTriangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        return;
+    }
+
+    if (captureCache_)
+    {
+        if (depthTest)
+            captureCache_->triangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        else
+            captureCache_->noDepthTriangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        return;
+    }
+
     if (triangles_.size() + noDepthTriangles_.size() >= MAX_TRIANGLES)
         return;
 
@@ -481,7 +542,15 @@ void DebugRenderer::AddTriangleMesh(Node* node, const Color& color, bool depthTe
             const auto& ib = geometry->GetIndexBuffer();
             for (const auto& vb : geometry->GetVertexBuffers())
             {
-                AddTriangleMesh(vb->GetShadowData(), vb->GetVertexSize(), geometry->GetVertexStart(),
+                const unsigned char* vertexData = vb->GetShadowData();
+                unsigned vertexSize = vb->GetVertexSize();
+                if (!vertexData && vb->GetPositionShadowData())
+                {
+                    // Fall back to the packed position-only shadow copy
+                    vertexData = vb->GetPositionShadowData();
+                    vertexSize = sizeof(Vector3);
+                }
+                AddTriangleMesh(vertexData, vertexSize, geometry->GetVertexStart(),
                                 ib->GetShadowData(), ib->GetIndexSize(), geometry->GetIndexStart(),
                                 geometry->GetIndexCount(), node->GetWorldTransform(), color, depthTest);
             }
@@ -538,8 +607,102 @@ void DebugRenderer::AddQuad(const Vector3& center, float width, float height, co
     AddLine(v3, v0, uintColor, depthTest);
 }
 
+unsigned DebugRenderer::AddRetainedLine(const Vector3& start, const Vector3& end, const Color& color, unsigned frames,
+    bool depthTest)
+{
+    RetainedLine retained;
+    retained.line_ = DebugLine(start, end, color.ToUInt());
+    retained.handle_ = nextRetainedHandle_++;
+    retained.framesLeft_ = frames;
+    retained.depthTest_ = depthTest;
+    retainedLines_.push_back(retained);
+
+    // Submit for the current frame as well; subsequent frames are submitted when the frame ends
+    AddLine(start, end, retained.line_.color_, depthTest);
+    return retained.handle_;
+}
+
+unsigned DebugRenderer::AddRetainedTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, const Color& color,
+    unsigned frames, bool depthTest)
+{
+    RetainedTriangle retained;
+    retained.triangle_ = DebugTriangle(v1, v2, v3, color.ToUInt());
+    retained.handle_ = nextRetainedHandle_++;
+    retained.framesLeft_ = frames;
+    retained.depthTest_ = depthTest;
+    retainedTriangles_.push_back(retained);
+
+    // Submit for the current frame as well; subsequent frames are submitted when the frame ends
+    AddTriangle(v1, v2, v3, retained.triangle_.color_, depthTest);
+    return retained.handle_;
+}
+
+void DebugRenderer::RemoveRetained(unsigned handle)
+{
+    for (auto i = retainedLines_.begin(); i != retainedLines_.end(); ++i)
+    {
+        if (i->handle_ == handle)
+        {
+            retainedLines_.erase(i);
+            return;
+        }
+    }
+
+    for (auto i = retainedTriangles_.begin(); i != retainedTriangles_.end(); ++i)
+    {
+        if (i->handle_ == handle)
+        {
+            retainedTriangles_.erase(i);
+            return;
+        }
+    }
+}
+
+void DebugRenderer::ClearRetained()
+{
+    retainedLines_.clear();
+    retainedTriangles_.clear();
+}
+
+void DebugRenderer::BeginCapture(DebugGeometryCache& cache)
+{
+    if (!Thread::IsMainThread())
+    {
+        URHO3D_LOGERROR("Debug geometry capture is only supported on the main thread");
+        return;
+    }
+
+    cache.Clear();
+    captureCache_ = &cache;
+}
+
+void DebugRenderer::EndCapture()
+{
+    captureCache_ = nullptr;
+}
+
+void DebugRenderer::AddCached(const DebugGeometryCache& cache)
+{
+    // Insert as much of the captured geometry as the per-frame limits allow
+    unsigned linesLeft = MAX_LINES - Min((unsigned)(lines_.size() + noDepthLines_.size()), MAX_LINES);
+    lines_.insert(lines_.end(), cache.lines_.begin(), cache.lines_.begin() + Min((unsigned)cache.lines_.size(), linesLeft));
+    linesLeft -= Min((unsigned)cache.lines_.size(), linesLeft);
+    noDepthLines_.insert(noDepthLines_.end(), cache.noDepthLines_.begin(),
+        cache.noDepthLines_.begin() + Min((unsigned)cache.noDepthLines_.size(), linesLeft));
+
+    unsigned trianglesLeft = MAX_TRIANGLES - Min((unsigned)(triangles_.size() + noDepthTriangles_.size()), MAX_TRIANGLES);
+    triangles_.insert(triangles_.end(), cache.triangles_.begin(),
+        cache.triangles_.begin() + Min((unsigned)cache.triangles_.size(), trianglesLeft));
+    trianglesLeft -= Min((unsigned)cache.triangles_.size(), trianglesLeft);
+    noDepthTriangles_.insert(noDepthTriangles_.end(), cache.noDepthTriangles_.begin(),
+        cache.noDepthTriangles_.begin() + Min((unsigned)cache.noDepthTriangles_.size(), trianglesLeft));
+}
+
 void DebugRenderer::Render()
 {
+    // Make geometry appended by worker threads visible before checking for content
+    FlushThreadBuffers();
+
     if (!HasContent())
         return;
 
@@ -552,12 +715,14 @@ void DebugRenderer::Render()
     ShaderVariation* vs = graphics->GetShader(VS, "Basic", "VERTEXCOLOR");
     ShaderVariation* ps = graphics->GetShader(PS, "Basic", "VERTEXCOLOR");
 
-    unsigned numVertices = (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
-    // Resize the vertex buffer if too small or much too large
-    if (vertexBuffer_->GetVertexCount() < numVertices || vertexBuffer_->GetVertexCount() > numVertices * 2)
-        vertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, true);
+    auto* transientBuffer = GetSubsystem<TransientBuffer>();
+    if (!transientBuffer)
+        return;
 
-    auto* dest = (float*)vertexBuffer_->Lock(0, numVertices, true);
+    unsigned numVertices = (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
+    VertexBuffer* vertexBuffer = nullptr;
+    unsigned startVertex = 0;
+    auto* dest = (float*)transientBuffer->AllocateVertices(MASK_POSITION | MASK_COLOR, numVertices, vertexBuffer, startVertex);
     if (!dest)
         return;
 
@@ -637,7 +802,7 @@ void DebugRenderer::Render()
         dest += 12;
     }
 
-    vertexBuffer_->Unlock();
+    vertexBuffer->Unlock();
 
     graphics->SetBlendMode(lineAntiAlias_ ? BLEND_ALPHA : BLEND_REPLACE);
     graphics->SetColorWrite(true);
@@ -652,9 +817,9 @@ void DebugRenderer::Render()
     graphics->SetShaderParameter(VSP_VIEWINV, view_.Inverse());
     graphics->SetShaderParameter(VSP_VIEWPROJ, gpuProjection_ * view_);
     graphics->SetShaderParameter(PSP_MATDIFFCOLOR, Color(1.0f, 1.0f, 1.0f, 1.0f));
-    graphics->SetVertexBuffer(vertexBuffer_);
+    graphics->SetVertexBuffer(vertexBuffer);
 
-    unsigned start = 0;
+    unsigned start = startVertex;
     unsigned count = 0;
     if (lines_.size())
     {
@@ -701,8 +866,27 @@ bool DebugRenderer::HasContent() const
     return !(lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty());
 }
 
+void DebugRenderer::FlushThreadBuffers()
+{
+    for (ThreadBuffer& buffer : threadBuffers_)
+    {
+        lines_.insert(lines_.end(), buffer.lines_.begin(), buffer.lines_.end());
+        noDepthLines_.insert(noDepthLines_.end(), buffer.noDepthLines_.begin(), buffer.noDepthLines_.end());
+        triangles_.insert(triangles_.end(), buffer.triangles_.begin(), buffer.triangles_.end());
+        noDepthTriangles_.insert(noDepthTriangles_.end(), buffer.noDepthTriangles_.begin(), buffer.noDepthTriangles_.end());
+
+        buffer.lines_.clear();
+        buffer.noDepthLines_.clear();
+        buffer.triangles_.clear();
+        buffer.noDepthTriangles_.clear();
+    }
+}
+
 void DebugRenderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
 {
+    // Clear also the worker thread buffers in case the geometry was never rendered
+    FlushThreadBuffers();
+
     // When the amount of debug geometry is reduced, release memory
     unsigned linesSize = lines_.size();
     unsigned noDepthLinesSize = noDepthLines_.size();
@@ -722,6 +906,37 @@ void DebugRenderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
         triangles_.reserve(trianglesSize);
     if (noDepthTriangles_.capacity() > noDepthTrianglesSize * 2)
         noDepthTriangles_.reserve(noDepthTrianglesSize);
+
+    // Re-submit the retained shapes for the next frame, dropping those whose frame count has expired
+    for (auto i = retainedLines_.begin(); i != retainedLines_.end();)
+    {
+        if (i->framesLeft_ && !--i->framesLeft_)
+        {
+            i = retainedLines_.erase(i);
+            continue;
+        }
+
+        if (i->depthTest_)
+            lines_.push_back(i->line_);
+        else
+            noDepthLines_.push_back(i->line_);
+        ++i;
+    }
+
+    for (auto i = retainedTriangles_.begin(); i != retainedTriangles_.end();)
+    {
+        if (i->framesLeft_ && !--i->framesLeft_)
+        {
+            i = retainedTriangles_.erase(i);
+            continue;
+        }
+
+        if (i->depthTest_)
+            triangles_.push_back(i->triangle_);
+        else
+            noDepthTriangles_.push_back(i->triangle_);
+        ++i;
+    }
 }
 
 }
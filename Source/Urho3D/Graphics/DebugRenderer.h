@@ -38,7 +38,6 @@ class Matrix3x4;
 class Renderer;
 class Skeleton;
 class Sphere;
-class VertexBuffer;
 
 /// Debug rendering line.
 struct DebugLine
@@ -87,6 +86,34 @@ struct DebugTriangle
     unsigned color_{};
 };
 
+/// Captured debug geometry that can be re-submitted over multiple frames without regenerating it.
+struct URHO3D_API DebugGeometryCache
+{
+    /// Remove all captured geometry.
+    void Clear()
+    {
+        lines_.clear();
+        noDepthLines_.clear();
+        triangles_.clear();
+        noDepthTriangles_.clear();
+    }
+
+    /// Return whether any geometry has been captured.
+    bool IsEmpty() const
+    {
+        return lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty();
+    }
+
+    /// Lines rendered with depth test.
+    ea::vector<DebugLine> lines_;
+    /// Lines rendered without depth test.
+    ea::vector<DebugLine> noDepthLines_;
+    /// Triangles rendered with depth test.
+    ea::vector<DebugTriangle> triangles_;
+    /// Triangles rendered without depth test.
+    ea::vector<DebugTriangle> noDepthTriangles_;
+};
+
 /// Debug geometry rendering component. Should be added only to the root scene node.
 class URHO3D_API DebugRenderer : public Component
 {
@@ -106,7 +133,8 @@ public:
     void SetView(Camera* camera);
     /// Add a line.
     void AddLine(const Vector3& start, const Vector3& end, const Color& color, bool depthTest = true);
-    /// Add a line with color already converted to unsigned.
+    /// Add a line with color already converted to unsigned. May also be called from WorkQueue worker threads, in which
+    /// case the line is appended to a per-thread buffer and becomes visible once the worker items have completed.
     void AddLine(const Vector3& start, const Vector3& end, unsigned color, bool depthTest = true);
     /// Add a line in 2D screen space.
     void AddLine2D(const Vector2& start, const Vector2& end, const Color& color, bool depthTest = true);
@@ -114,7 +142,8 @@ public:
     void AddLine2D(const Vector2& start, const Vector2& end, unsigned color, bool depthTest = true);
     /// Add a solid triangle.
     void AddTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, const Color& color, bool depthTest = true);
-    /// Add a solid triangle with color already converted to unsigned.
+    /// Add a solid triangle with color already converted to unsigned. May also be called from WorkQueue worker threads,
+    /// in which case the triangle is appended to a per-thread buffer and becomes visible once the worker items have completed.
     void AddTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, unsigned color, bool depthTest = true);
     /// Add a solid quadrangular polygon.
     void AddPolygon(const Vector3& v1, const Vector3& v2, const Vector3& v3, const Vector3& v4, const Color& color, bool depthTest = true);
@@ -156,6 +185,22 @@ public:
     /// Add a quad on the XZ plane.
     void AddQuad(const Vector3& center, float width, float height, const Color& color, bool depthTest = true);
 
+    /// Add a retained line that is rendered every frame until removed or its frame count expires. Return shape handle.
+    unsigned AddRetainedLine(const Vector3& start, const Vector3& end, const Color& color, unsigned frames = 0, bool depthTest = true);
+    /// Add a retained solid triangle that is rendered every frame until removed or its frame count expires. Return shape handle.
+    unsigned AddRetainedTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, const Color& color, unsigned frames = 0, bool depthTest = true);
+    /// Remove a retained shape by handle.
+    void RemoveRetained(unsigned handle);
+    /// Remove all retained shapes.
+    void ClearRetained();
+
+    /// Begin redirecting subsequently added geometry into a cache instead of the per-frame lists. Main thread only.
+    void BeginCapture(DebugGeometryCache& cache);
+    /// Stop redirecting geometry into the capture cache.
+    void EndCapture();
+    /// Submit previously captured geometry for rendering this frame.
+    void AddCached(const DebugGeometryCache& cache);
+
     /// Update vertex buffer and render all debug lines. The viewport and rendertarget should be set before.
     void Render();
 
@@ -177,8 +222,49 @@ public:
     bool HasContent() const;
 
 private:
-    /// Handle end of frame. Clear debug geometry.
+    /// Geometry append buffer for a single worker thread.
+    struct ThreadBuffer
+    {
+        /// Lines rendered with depth test.
+        ea::vector<DebugLine> lines_;
+        /// Lines rendered without depth test.
+        ea::vector<DebugLine> noDepthLines_;
+        /// Triangles rendered with depth test.
+        ea::vector<DebugTriangle> triangles_;
+        /// Triangles rendered without depth test.
+        ea::vector<DebugTriangle> noDepthTriangles_;
+    };
+
+    /// Retained debug line that persists over frames.
+    struct RetainedLine
+    {
+        /// Line geometry.
+        DebugLine line_;
+        /// Shape handle.
+        unsigned handle_;
+        /// Remaining frames to render, 0 if retained until removed.
+        unsigned framesLeft_;
+        /// Depth test flag.
+        bool depthTest_;
+    };
+
+    /// Retained debug triangle that persists over frames.
+    struct RetainedTriangle
+    {
+        /// Triangle geometry.
+        DebugTriangle triangle_;
+        /// Shape handle.
+        unsigned handle_;
+        /// Remaining frames to render, 0 if retained until removed.
+        unsigned framesLeft_;
+        /// Depth test flag.
+        bool depthTest_;
+    };
+
+    /// Handle end of frame. Clear debug geometry and re-submit retained shapes.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Move worker thread append buffers into the main geometry lists. Worker items appending geometry must have completed.
+    void FlushThreadBuffers();
 
     /// Lines rendered with depth test.
     ea::vector<DebugLine> lines_;
@@ -188,6 +274,16 @@ private:
     ea::vector<DebugTriangle> triangles_;
     /// Triangles rendered without depth test.
     ea::vector<DebugTriangle> noDepthTriangles_;
+    /// Append buffers for WorkQueue worker threads, indexed by thread index - 1.
+    ea::vector<ThreadBuffer> threadBuffers_;
+    /// Retained lines.
+    ea::vector<RetainedLine> retainedLines_;
+    /// Retained triangles.
+    ea::vector<RetainedTriangle> retainedTriangles_;
+    /// Next free retained shape handle.
+    unsigned nextRetainedHandle_{1};
+    /// Active capture cache, or null when geometry goes into the per-frame lists.
+    DebugGeometryCache* captureCache_{};
     /// View transform.
     Matrix3x4 view_;
     /// Projection transform.
@@ -196,8 +292,6 @@ private:
     Matrix4 gpuProjection_;
     /// View frustum.
     Frustum frustum_;
-    /// Vertex buffer.
-    SharedPtr<VertexBuffer> vertexBuffer_;
     /// Line antialiasing flag.
     bool lineAntiAlias_;
     /// Active camera.
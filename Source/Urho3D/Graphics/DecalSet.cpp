@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
@@ -40,6 +41,8 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -56,6 +59,8 @@ static const unsigned MIN_INDICES = 6;
 static const unsigned MAX_VERTICES = 65536;
 static const unsigned DEFAULT_MAX_VERTICES = 512;
 static const unsigned DEFAULT_MAX_INDICES = 1024;
+static const unsigned MIN_TRIANGLES_FOR_INDEX = 64;
+static const unsigned MAX_TRIANGLES_PER_LEAF = 16;
 static const VertexMaskFlags STATIC_ELEMENT_MASK = MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT;
 static const VertexMaskFlags SKINNED_ELEMENT_MASK = MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT |
     MASK_BLENDWEIGHTS | MASK_BLENDINDICES;
@@ -128,6 +133,214 @@ static void ClipPolygon(ea::vector<DecalVertex>& dest, const ea::vector<DecalVer
         dest.push_back(ClipEdge(src[last], src[0], lastDistance, distance, skinned));
 }
 
+/// Triangle lookup tree over one target geometry, so that decal clipping only examines triangles near the decal
+/// frustum. Built from the bind pose positions, which stay valid for skinned targets as well.
+struct DecalSet::GeometryTriangleIndex : public RefCounted
+{
+    /// One indexed triangle.
+    struct Triangle
+    {
+        /// Triangle indices.
+        unsigned i0_, i1_, i2_;
+    };
+
+    /// One node of the tree.
+    struct TreeNode
+    {
+        /// Bounding box of the contained triangles.
+        BoundingBox box_;
+        /// Index of the left child node. Zero for a leaf.
+        unsigned left_{};
+        /// Index of the right child node.
+        unsigned right_{};
+        /// First triangle for a leaf.
+        unsigned start_{};
+        /// Number of triangles for a leaf.
+        unsigned count_{};
+    };
+
+    /// Triangle with build-time data.
+    struct BuildTriangle
+    {
+        /// Triangle indices.
+        unsigned i0_, i1_, i2_;
+        /// Triangle bounding box.
+        BoundingBox box_;
+        /// Triangle centroid.
+        Vector3 centroid_;
+    };
+
+    /// Build the tree from the geometry's index and position data.
+    void Define(Geometry* geometry, const unsigned char* positionData, unsigned positionStride,
+        const unsigned char* indexData, unsigned indexStride);
+    /// Collect the triangles whose bounding boxes touch the frustum.
+    void Query(const Frustum& frustum, ea::vector<Triangle>& result) const;
+
+    /// Geometry the tree was built from, for detecting a stale tree.
+    WeakPtr<Geometry> geometry_;
+    /// Triangles in tree order.
+    ea::vector<Triangle> triangles_;
+    /// Tree nodes. The root is at index zero.
+    ea::vector<TreeNode> nodes_;
+
+private:
+    /// Build a subtree over a triangle range by median splits. Return the node index.
+    unsigned BuildNode(ea::vector<BuildTriangle>& buildTriangles, unsigned start, unsigned count);
+};
+
+void DecalSet::GeometryTriangleIndex::Define(Geometry* geometry, const unsigned char* positionData,
+    unsigned positionStride, const unsigned char* indexData, unsigned indexStride)
+{
+    geometry_ = geometry;
+    triangles_.clear();
+    nodes_.clear();
+
+    const unsigned indexStart = geometry->GetIndexStart();
+    const unsigned indexCount = geometry->GetIndexCount();
+
+    ea::vector<BuildTriangle> buildTriangles;
+    buildTriangles.reserve(indexCount / 3);
+
+    for (unsigned i = indexStart; i + 2 < indexStart + indexCount; i += 3)
+    {
+        BuildTriangle triangle;
+        if (indexStride == sizeof(unsigned short))
+        {
+            const unsigned short* indices = (const unsigned short*)indexData;
+            triangle.i0_ = indices[i];
+            triangle.i1_ = indices[i + 1];
+            triangle.i2_ = indices[i + 2];
+        }
+        else
+        {
+            const unsigned* indices = (const unsigned*)indexData;
+            triangle.i0_ = indices[i];
+            triangle.i1_ = indices[i + 1];
+            triangle.i2_ = indices[i + 2];
+        }
+
+        const Vector3& v0 = *((const Vector3*)(&positionData[triangle.i0_ * positionStride]));
+        const Vector3& v1 = *((const Vector3*)(&positionData[triangle.i1_ * positionStride]));
+        const Vector3& v2 = *((const Vector3*)(&positionData[triangle.i2_ * positionStride]));
+
+        triangle.box_.Merge(v0);
+        triangle.box_.Merge(v1);
+        triangle.box_.Merge(v2);
+        triangle.centroid_ = (v0 + v1 + v2) / 3.0f;
+        buildTriangles.push_back(triangle);
+    }
+
+    if (buildTriangles.empty())
+        return;
+
+    BuildNode(buildTriangles, 0, buildTriangles.size());
+
+    triangles_.reserve(buildTriangles.size());
+    for (const BuildTriangle& triangle : buildTriangles)
+        triangles_.push_back(Triangle{triangle.i0_, triangle.i1_, triangle.i2_});
+}
+
+unsigned DecalSet::GeometryTriangleIndex::BuildNode(ea::vector<BuildTriangle>& buildTriangles, unsigned start, unsigned count)
+{
+    const unsigned nodeIndex = nodes_.size();
+    nodes_.push_back(TreeNode());
+
+    BoundingBox box;
+    BoundingBox centroidBox;
+    for (unsigned i = start; i < start + count; ++i)
+    {
+        box.Merge(buildTriangles[i].box_);
+        centroidBox.Merge(buildTriangles[i].centroid_);
+    }
+    nodes_[nodeIndex].box_ = box;
+
+    if (count <= MAX_TRIANGLES_PER_LEAF)
+    {
+        nodes_[nodeIndex].start_ = start;
+        nodes_[nodeIndex].count_ = count;
+        return nodeIndex;
+    }
+
+    // Split at the median along the longest axis of the centroid bounds
+    const Vector3 size = centroidBox.Size();
+    unsigned axis = 0;
+    if (size.y_ > size.x_)
+        axis = 1;
+    if (size.z_ > (axis ? size.y_ : size.x_))
+        axis = 2;
+
+    const unsigned halfCount = count / 2;
+    ea::nth_element(buildTriangles.begin() + start, buildTriangles.begin() + start + halfCount,
+        buildTriangles.begin() + start + count, [axis](const BuildTriangle& lhs, const BuildTriangle& rhs)
+        { return lhs.centroid_.Data()[axis] < rhs.centroid_.Data()[axis]; });
+
+    // Note: assign child indices through the node index, as recursion may reallocate the node vector
+    const unsigned left = BuildNode(buildTriangles, start, halfCount);
+    const unsigned right = BuildNode(buildTriangles, start + halfCount, count - halfCount);
+    nodes_[nodeIndex].left_ = left;
+    nodes_[nodeIndex].right_ = right;
+    return nodeIndex;
+}
+
+void DecalSet::GeometryTriangleIndex::Query(const Frustum& frustum, ea::vector<Triangle>& result) const
+{
+    if (nodes_.empty())
+        return;
+
+    ea::vector<unsigned> nodeStack;
+    nodeStack.push_back(0);
+
+    while (!nodeStack.empty())
+    {
+        const TreeNode& node = nodes_[nodeStack.back()];
+        nodeStack.pop_back();
+
+        if (frustum.IsInside(node.box_) == OUTSIDE)
+            continue;
+
+        if (!node.left_)
+        {
+            for (unsigned i = node.start_; i < node.start_ + node.count_; ++i)
+                result.push_back(triangles_[i]);
+        }
+        else
+        {
+            nodeStack.push_back(node.left_);
+            nodeStack.push_back(node.right_);
+        }
+    }
+}
+
+/// Queued asynchronous decal creation request. The decal geometry is built by a worker thread and the finished
+/// request is committed on scene post-update.
+struct DecalSet::AsyncDecalRequest : public RefCounted
+{
+    /// Candidate faces gathered from the target geometry.
+    ea::vector<ea::vector<DecalVertex> > faces_;
+    /// Decal being built.
+    Decal decal_;
+    /// Decal frustum.
+    Frustum frustum_;
+    /// Decal frustum transform.
+    Matrix3x4 frustumTransform_;
+    /// Transform from the target geometry to the decal set local space.
+    Matrix3x4 vertexTransform_;
+    /// UV coordinates for the top left corner.
+    Vector2 topLeftUV_;
+    /// UV coordinates for the bottom right corner.
+    Vector2 bottomRightUV_;
+    /// Decal size.
+    float size_{};
+    /// Decal aspect ratio.
+    float aspectRatio_{};
+    /// Decal depth.
+    float depth_{};
+    /// Skinned mode at the time of queuing.
+    bool skinned_{};
+    /// Work item building the decal geometry.
+    SharedPtr<WorkItem> workItem_;
+};
+
 void Decal::AddVertex(const DecalVertex& vertex)
 {
     for (unsigned i = 0; i < vertices_.size(); ++i)
@@ -304,6 +517,74 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
 {
     URHO3D_PROFILE("AddDecal");
 
+    ea::vector<ea::vector<DecalVertex> > faces;
+    Frustum decalFrustum;
+    Matrix3x4 frustumTransform;
+    if (!GatherDecalFaces(faces, decalFrustum, frustumTransform, target, worldPosition, worldRotation, size, aspectRatio,
+        depth, normalCutoff, subGeometry))
+        return false;
+
+    Decal newDecal;
+    newDecal.timeToLive_ = timeToLive;
+
+    // Transform vertices to this node's local space; skinned decal vertices stay in bind pose space
+    const Matrix3x4 vertexTransform = skinned_ ? Matrix3x4::IDENTITY :
+        node_->GetWorldTransform().Inverse() * target->GetNode()->GetWorldTransform();
+
+    // Check if resulted in no triangles
+    if (!BuildDecalGeometry(newDecal, faces, skinned_, decalFrustum, frustumTransform, size, aspectRatio, depth,
+        topLeftUV, bottomRightUV, vertexTransform))
+        return true;
+
+    return CommitDecal(newDecal);
+}
+
+bool DecalSet::AddDecalAsync(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size,
+    float aspectRatio, float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive, float normalCutoff,
+    unsigned subGeometry)
+{
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue || !workQueue->GetNumThreads())
+        return AddDecal(target, worldPosition, worldRotation, size, aspectRatio, depth, topLeftUV, bottomRightUV,
+            timeToLive, normalCutoff, subGeometry);
+
+    URHO3D_PROFILE("AddDecalAsync");
+
+    SharedPtr<AsyncDecalRequest> request(new AsyncDecalRequest());
+    if (!GatherDecalFaces(request->faces_, request->frustum_, request->frustumTransform_, target, worldPosition,
+        worldRotation, size, aspectRatio, depth, normalCutoff, subGeometry))
+        return false;
+
+    if (request->faces_.empty())
+        return true;
+
+    request->decal_.timeToLive_ = timeToLive;
+    request->vertexTransform_ = skinned_ ? Matrix3x4::IDENTITY :
+        node_->GetWorldTransform().Inverse() * target->GetNode()->GetWorldTransform();
+    request->topLeftUV_ = topLeftUV;
+    request->bottomRightUV_ = bottomRightUV;
+    request->size_ = size;
+    request->aspectRatio_ = aspectRatio;
+    request->depth_ = depth;
+    request->skinned_ = skinned_;
+
+    // The worker owns a reference to the request, so an unfinished request stays valid if the component is destroyed
+    request->workItem_ = workQueue->AddWorkItem([request]()
+    {
+        BuildDecalGeometry(request->decal_, request->faces_, request->skinned_, request->frustum_,
+            request->frustumTransform_, request->size_, request->aspectRatio_, request->depth_, request->topLeftUV_,
+            request->bottomRightUV_, request->vertexTransform_);
+    });
+
+    pendingDecals_.push_back(request);
+    UpdateEventSubscription(false);
+    return true;
+}
+
+bool DecalSet::GatherDecalFaces(ea::vector<ea::vector<DecalVertex> >& faces, Frustum& frustum, Matrix3x4& frustumTransform,
+    Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
+    float depth, float normalCutoff, unsigned subGeometry)
+{
     // Do not add decals in headless mode
     if (!node_ || !GetSubsystem<Graphics>())
         return false;
@@ -373,32 +654,32 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
     }
 
     // Build the decal frustum
-    Frustum decalFrustum;
-    Matrix3x4 frustumTransform = targetTransform * Matrix3x4(adjustedWorldPosition, worldRotation, 1.0f);
-    decalFrustum.DefineOrtho(size, aspectRatio, 1.0, 0.0f, depth, frustumTransform);
+    frustumTransform = targetTransform * Matrix3x4(adjustedWorldPosition, worldRotation, 1.0f);
+    frustum.DefineOrtho(size, aspectRatio, 1.0, 0.0f, depth, frustumTransform);
 
     Vector3 decalNormal = (targetTransform * Vector4(worldRotation * Vector3::BACK, 0.0f)).Normalized();
 
-    decals_.resize(decals_.size() + 1);
-    Decal& newDecal = decals_.back();
-    newDecal.timeToLive_ = timeToLive;
-
-    ea::vector<ea::vector<DecalVertex> > faces;
-    ea::vector<DecalVertex> tempFace;
-
     unsigned numBatches = target->GetBatches().size();
 
     // Use either a specified subgeometry in the target, or all
     if (subGeometry < numBatches)
-        GetFaces(faces, target, subGeometry, decalFrustum, decalNormal, normalCutoff);
+        GetFaces(faces, target, subGeometry, frustum, decalNormal, normalCutoff);
     else
     {
         for (unsigned i = 0; i < numBatches; ++i)
-            GetFaces(faces, target, i, decalFrustum, decalNormal, normalCutoff);
+            GetFaces(faces, target, i, frustum, decalNormal, normalCutoff);
     }
 
+    return true;
+}
+
+bool DecalSet::BuildDecalGeometry(Decal& decal, ea::vector<ea::vector<DecalVertex> >& faces, bool skinned,
+    const Frustum& frustum, const Matrix3x4& frustumTransform, float size, float aspectRatio, float depth,
+    const Vector2& topLeftUV, const Vector2& bottomRightUV, const Matrix3x4& vertexTransform)
+{
     // Clip the acquired faces against all frustum planes
-    for (const auto& plane : decalFrustum.planes_)
+    ea::vector<DecalVertex> tempFace;
+    for (const auto& plane : frustum.planes_)
     {
         for (unsigned j = 0; j < faces.size(); ++j)
         {
@@ -406,7 +687,7 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
             if (face.empty())
                 continue;
 
-            ClipPolygon(tempFace, face, plane, skinned_);
+            ClipPolygon(tempFace, face, plane, skinned);
             face = tempFace;
         }
     }
@@ -420,33 +701,14 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
 
         for (unsigned j = 2; j < face.size(); ++j)
         {
-            newDecal.AddVertex(face[0]);
-            newDecal.AddVertex(face[j - 1]);
-            newDecal.AddVertex(face[j]);
+            decal.AddVertex(face[0]);
+            decal.AddVertex(face[j - 1]);
+            decal.AddVertex(face[j]);
         }
     }
 
-    // Check if resulted in no triangles
-    if (newDecal.vertices_.empty())
-    {
-        decals_.pop_back();
-        return true;
-    }
-
-    if (newDecal.vertices_.size() > maxVertices_)
-    {
-        URHO3D_LOGWARNING("Can not add decal, vertex count " + ea::to_string(newDecal.vertices_.size()) + " exceeds maximum " +
-                   ea::to_string(maxVertices_));
-        decals_.pop_back();
-        return false;
-    }
-    if (newDecal.indices_.size() > maxIndices_)
-    {
-        URHO3D_LOGWARNING("Can not add decal, index count " + ea::to_string(newDecal.indices_.size()) + " exceeds maximum " +
-                   ea::to_string(maxIndices_));
-        decals_.pop_back();
+    if (decal.vertices_.empty())
         return false;
-    }
 
     // Calculate UVs
     Matrix4 projection(Matrix4::ZERO);
@@ -455,33 +717,73 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
     projection.m22_ = 1.0f / depth;
     projection.m33_ = 1.0f;
 
-    CalculateUVs(newDecal, frustumTransform.Inverse(), projection, topLeftUV, bottomRightUV);
+    CalculateUVs(decal, frustumTransform.Inverse(), projection, topLeftUV, bottomRightUV);
 
-    // Transform vertices to this node's local space and generate tangents
-    Matrix3x4 decalTransform = node_->GetWorldTransform().Inverse() * target->GetNode()->GetWorldTransform();
-    TransformVertices(newDecal, skinned_ ? Matrix3x4::IDENTITY : decalTransform);
-    GenerateTangents(&newDecal.vertices_[0], sizeof(DecalVertex), &newDecal.indices_[0], sizeof(unsigned short), 0,
-        newDecal.indices_.size(), offsetof(DecalVertex, normal_), offsetof(DecalVertex, texCoord_), offsetof(DecalVertex,
+    // Transform vertices to the decal set's local space and generate tangents
+    TransformVertices(decal, vertexTransform);
+    GenerateTangents(&decal.vertices_[0], sizeof(DecalVertex), &decal.indices_[0], sizeof(unsigned short), 0,
+        decal.indices_.size(), offsetof(DecalVertex, normal_), offsetof(DecalVertex, texCoord_), offsetof(DecalVertex,
         tangent_));
 
-    newDecal.CalculateBoundingBox();
-    numVertices_ += newDecal.vertices_.size();
-    numIndices_ += newDecal.indices_.size();
+    decal.CalculateBoundingBox();
+    return true;
+}
+
+bool DecalSet::CommitDecal(Decal& decal)
+{
+    if (decal.vertices_.size() > maxVertices_)
+    {
+        URHO3D_LOGWARNING("Can not add decal, vertex count " + ea::to_string(decal.vertices_.size()) + " exceeds maximum " +
+                   ea::to_string(maxVertices_));
+        return false;
+    }
+    if (decal.indices_.size() > maxIndices_)
+    {
+        URHO3D_LOGWARNING("Can not add decal, index count " + ea::to_string(decal.indices_.size()) + " exceeds maximum " +
+                   ea::to_string(maxIndices_));
+        return false;
+    }
+
+    const unsigned numNewVertices = decal.vertices_.size();
+    const bool timeLimited = decal.timeToLive_ > 0.0f;
+
+    numVertices_ += decal.vertices_.size();
+    numIndices_ += decal.indices_.size();
+    decals_.push_back(ea::move(decal));
 
     // Remove oldest decals if total vertices exceeded
     while (decals_.size() && (numVertices_ > maxVertices_ || numIndices_ > maxIndices_))
         RemoveDecals(1);
 
-    URHO3D_LOGDEBUG("Added decal with " + ea::to_string(newDecal.vertices_.size()) + " vertices");
+    URHO3D_LOGDEBUG("Added decal with " + ea::to_string(numNewVertices) + " vertices");
 
     // If new decal is time limited, subscribe to scene post-update
-    if (newDecal.timeToLive_ > 0.0f && !subscribed_)
+    if (timeLimited && !subscribed_)
         UpdateEventSubscription(false);
 
     MarkDecalsDirty();
     return true;
 }
 
+void DecalSet::FinishAsyncDecals()
+{
+    for (auto i = pendingDecals_.begin(); i != pendingDecals_.end();)
+    {
+        AsyncDecalRequest* request = *i;
+        if (!request->workItem_->completed_)
+        {
+            ++i;
+            continue;
+        }
+
+        // Drop the decal if static/skinned mode was switched while the request was in flight
+        if (request->skinned_ == skinned_ && !request->decal_.vertices_.empty())
+            CommitDecal(request->decal_);
+
+        i = pendingDecals_.erase(i);
+    }
+}
+
 void DecalSet::RemoveDecals(unsigned num)
 {
     while (num-- && decals_.size())
@@ -558,8 +860,7 @@ void DecalSet::SetDecalsAttr(const ea::vector<unsigned char>& value)
             }
         }
 
-        for (auto i = newDecal.indices_.begin(); i != newDecal.indices_.end(); ++i)
-            *i = buffer.ReadUShort();
+        buffer.ReadArray(ea::span<unsigned short>(newDecal.indices_));
 
         newDecal.CalculateBoundingBox();
         numVertices_ += newDecal.vertices_.size();
@@ -628,8 +929,7 @@ ea::vector<unsigned char> DecalSet::GetDecalsAttr() const
             }
         }
 
-        for (auto j = i->indices_.begin(); j != i->indices_.end(); ++j)
-            ret.WriteUShort(*j);
+        ret.WriteArray(ea::span<const unsigned short>(i->indices_));
     }
 
     if (skinned_)
@@ -694,6 +994,32 @@ void DecalSet::OnWorldBoundingBoxUpdate()
     }
 }
 
+DecalSet::GeometryTriangleIndex* DecalSet::GetTriangleIndex(Geometry* geometry, const unsigned char* positionData,
+    unsigned positionStride, const unsigned char* indexData, unsigned indexStride)
+{
+    auto i = triangleIndices_.find(geometry);
+    if (i != triangleIndices_.end())
+    {
+        if (!i->second->geometry_.Expired())
+            return i->second;
+        triangleIndices_.erase(i);
+    }
+
+    // Prune trees whose geometries have been destroyed, so that the cache can not grow without bound
+    for (auto j = triangleIndices_.begin(); j != triangleIndices_.end();)
+    {
+        if (j->second->geometry_.Expired())
+            j = triangleIndices_.erase(j);
+        else
+            ++j;
+    }
+
+    SharedPtr<GeometryTriangleIndex> newIndex(new GeometryTriangleIndex());
+    newIndex->Define(geometry, positionData, positionStride, indexData, indexStride);
+    triangleIndices_[geometry] = newIndex;
+    return newIndex;
+}
+
 void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* target, unsigned batchIndex, const Frustum& frustum,
     const Vector3& decalNormal, float normalCutoff)
 {
@@ -714,6 +1040,8 @@ void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* t
     IndexBuffer* ib = geometry->GetIndexBuffer();
     if (ib)
     {
+        // Decals are a rare full-data consumer; populate the shadow copy by readback if necessary
+        ib->EnsureShadowData();
         indexData = ib->GetShadowData();
         indexStride = ib->GetIndexSize();
     }
@@ -726,6 +1054,7 @@ void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* t
             continue;
 
         unsigned elementMask = vb->GetElementMask();
+        vb->EnsureShadowData();
         unsigned char* data = vb->GetShadowData();
         if (!data)
             continue;
@@ -765,6 +1094,21 @@ void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* t
         unsigned indexStart = geometry->GetIndexStart();
         unsigned indexCount = geometry->GetIndexCount();
 
+        // For large meshes use a cached triangle lookup tree so that only triangles near the decal frustum are examined
+        if (indexCount >= 3 * MIN_TRIANGLES_FOR_INDEX)
+        {
+            GeometryTriangleIndex* triangleIndex = GetTriangleIndex(geometry, positionData, positionStride, indexData, indexStride);
+            ea::vector<GeometryTriangleIndex::Triangle> candidates;
+            triangleIndex->Query(frustum, candidates);
+
+            for (const GeometryTriangleIndex::Triangle& triangle : candidates)
+            {
+                GetFace(faces, target, batchIndex, triangle.i0_, triangle.i1_, triangle.i2_, positionData, normalData,
+                    skinningData, positionStride, normalStride, skinningStride, frustum, decalNormal, normalCutoff);
+            }
+            return;
+        }
+
         // 16-bit indices
         if (indexStride == sizeof(unsigned short))
         {
@@ -1140,8 +1484,8 @@ void DecalSet::UpdateEventSubscription(bool checkAllDecals)
             }
         }
 
-        // If no time limited decals, no need to subscribe to scene update
-        enabled = hasTimeLimitedDecals;
+        // If no time limited decals and no pending asynchronous decals, no need to subscribe to scene update
+        enabled = hasTimeLimitedDecals || !pendingDecals_.empty();
     }
 
     if (enabled && !subscribed_)
@@ -1162,6 +1506,9 @@ void DecalSet::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData
 
     float timeStep = eventData[P_TIMESTEP].GetFloat();
 
+    // Commit finished asynchronous decals
+    FinishAsyncDecals();
+
     for (auto i = decals_.begin(); i != decals_.end();)
     {
         i->timer_ += timeStep;
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/list.h>
+#include <EASTL/unordered_map.h>
 
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Skeleton.h"
@@ -31,6 +32,7 @@
 namespace Urho3D
 {
 
+class Geometry;
 class IndexBuffer;
 class VertexBuffer;
 
@@ -150,6 +152,11 @@ public:
     bool AddDecal(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
         float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive = 0.0f, float normalCutoff = 0.1f,
         unsigned subGeometry = M_MAX_UNSIGNED);
+    /// Add a decal like AddDecal(), but clip the geometry on a worker thread; the decal appears on a following frame.
+    /// Falls back to synchronous creation when no worker threads exist. Return true unless the target was invalid.
+    bool AddDecalAsync(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size,
+        float aspectRatio, float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive = 0.0f,
+        float normalCutoff = 0.1f, unsigned subGeometry = M_MAX_UNSIGNED);
     /// Remove n oldest decals.
     void RemoveDecals(unsigned num);
     /// Remove all decals.
@@ -192,6 +199,27 @@ protected:
     void OnMarkedDirty(Node* node) override;
 
 private:
+    /// Cached triangle lookup tree for a target geometry.
+    struct GeometryTriangleIndex;
+    /// Queued asynchronous decal creation request.
+    struct AsyncDecalRequest;
+
+    /// Validate the target, set up the decal frustum and collect the candidate faces. Return false on error.
+    bool GatherDecalFaces(ea::vector<ea::vector<DecalVertex> >& faces, Frustum& frustum, Matrix3x4& frustumTransform,
+        Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
+        float depth, float normalCutoff, unsigned subGeometry);
+    /// Clip and triangulate gathered faces into a decal, calculate UVs and tangents, and transform the vertices into
+    /// the given space. Executed on a worker thread for asynchronous decals. Return false if no geometry resulted.
+    static bool BuildDecalGeometry(Decal& decal, ea::vector<ea::vector<DecalVertex> >& faces, bool skinned,
+        const Frustum& frustum, const Matrix3x4& frustumTransform, float size, float aspectRatio, float depth,
+        const Vector2& topLeftUV, const Vector2& bottomRightUV, const Matrix3x4& vertexTransform);
+    /// Add a built decal, removing oldest decals if the vertex or index budget is exceeded. Return true if successful.
+    bool CommitDecal(Decal& decal);
+    /// Commit finished asynchronous decal requests.
+    void FinishAsyncDecals();
+    /// Return the cached triangle lookup tree for a geometry, building it if necessary.
+    GeometryTriangleIndex* GetTriangleIndex(Geometry* geometry, const unsigned char* positionData, unsigned positionStride,
+        const unsigned char* indexData, unsigned indexStride);
     /// Get triangle faces from the target geometry.
     void GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* target, unsigned batchIndex, const Frustum& frustum,
         const Vector3& decalNormal, float normalCutoff);
@@ -205,10 +233,10 @@ private:
     bool GetBones(Drawable* target, unsigned batchIndex, const float* blendWeights, const unsigned char* blendIndices,
         unsigned char* newBlendIndices);
     /// Calculate UV coordinates for the decal.
-    void CalculateUVs
+    static void CalculateUVs
         (Decal& decal, const Matrix3x4& view, const Matrix4& projection, const Vector2& topLeftUV, const Vector2& bottomRightUV);
     /// Transform decal's vertices from the target geometry to the decal set local space.
-    void TransformVertices(Decal& decal, const Matrix3x4& transform);
+    static void TransformVertices(Decal& decal, const Matrix3x4& transform);
     /// Remove a decal by iterator and return iterator to the next decal.
     ea::list<Decal>::iterator RemoveDecal(ea::list<Decal>::iterator i);
     /// Mark decals and the bounding box dirty.
@@ -236,6 +264,10 @@ private:
     SharedPtr<IndexBuffer> indexBuffer_;
     /// Decals.
     ea::list<Decal> decals_;
+    /// Pending asynchronous decal creation requests.
+    ea::vector<SharedPtr<AsyncDecalRequest> > pendingDecals_;
+    /// Cached triangle lookup trees for target geometries, reused across decals.
+    ea::unordered_map<Geometry*, SharedPtr<GeometryTriangleIndex> > triangleIndices_;
     /// Bones used for skinned decals.
     ea::vector<Bone> bones_;
     /// Skinning matrices.
@@ -74,7 +74,13 @@ bool ConstantBuffer::SetSize(unsigned size)
         bufferDesc.CPUAccessFlags = 0;
         bufferDesc.Usage = D3D11_USAGE_DEFAULT;
 
-        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateBuffer(&bufferDesc, 0, (ID3D11Buffer**)&object_.ptr_);
+        // Initialize the GPU buffer from the zeroed shadow data. The unchanged-data checks in SetParameter assume
+        // the GPU contents match the shadow buffer, so an all-zero first write must not be skipped over undefined data
+        D3D11_SUBRESOURCE_DATA initialData;
+        memset(&initialData, 0, sizeof initialData);
+        initialData.pSysMem = shadowData_.get();
+
+        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateBuffer(&bufferDesc, &initialData, (ID3D11Buffer**)&object_.ptr_);
         if (FAILED(hr))
         {
             URHO3D_SAFE_RELEASE(object_.ptr_);
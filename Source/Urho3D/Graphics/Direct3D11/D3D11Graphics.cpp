@@ -40,6 +40,7 @@
 #include "../../Graphics/VertexBuffer.h"
 #include "../../IO/File.h"
 #include "../../IO/Log.h"
+#include "../../Resource/Image.h"
 #include "../../Resource/ResourceCache.h"
 
 #include <SDL/SDL.h>
@@ -248,6 +249,9 @@ Graphics::~Graphics()
     }
     impl_->rasterizerStates_.clear();
 
+    CleanupGPUTimingQueries();
+    CleanupScreenShotReadbacks();
+
     URHO3D_SAFE_RELEASE(impl_->defaultRenderTargetView_);
     URHO3D_SAFE_RELEASE(impl_->defaultDepthStencilView_);
     URHO3D_SAFE_RELEASE(impl_->defaultDepthTexture_);
@@ -448,6 +452,76 @@ bool Graphics::TakeScreenShot(Image& destImage)
     return true;
 }
 
+bool Graphics::TakeScreenShotAsync()
+{
+    if (!impl_->device_)
+        return false;
+
+    ScreenShotReadback& readback = impl_->screenShotReadbacks_[impl_->screenShotWriteIndex_];
+    // All readback slots still in flight
+    if (readback.pending_)
+        return false;
+
+    if (readback.stagingTexture_ && (readback.width_ != width_ || readback.height_ != height_))
+    {
+        readback.stagingTexture_->Release();
+        readback.stagingTexture_ = nullptr;
+    }
+
+    if (!readback.stagingTexture_)
+    {
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof textureDesc);
+        textureDesc.Width = (UINT)width_;
+        textureDesc.Height = (UINT)height_;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Usage = D3D11_USAGE_STAGING;
+        textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+        HRESULT hr = impl_->device_->CreateTexture2D(&textureDesc, nullptr, &readback.stagingTexture_);
+        if (FAILED(hr))
+        {
+            URHO3D_SAFE_RELEASE(readback.stagingTexture_);
+            URHO3D_LOGD3DERROR("Could not create staging texture for async screenshot", hr);
+            return false;
+        }
+    }
+
+    ID3D11Resource* source = nullptr;
+    impl_->defaultRenderTargetView_->GetResource(&source);
+
+    if (screenParams_.multiSample_ > 1)
+    {
+        // If backbuffer is multisampled, need another DEFAULT usage texture to resolve the data to first
+        CreateResolveTexture();
+
+        if (!impl_->resolveTexture_)
+        {
+            source->Release();
+            return false;
+        }
+
+        impl_->deviceContext_->ResolveSubresource(impl_->resolveTexture_, 0, source, 0, DXGI_FORMAT_R8G8B8A8_UNORM);
+        impl_->deviceContext_->CopyResource(readback.stagingTexture_, impl_->resolveTexture_);
+    }
+    else
+        impl_->deviceContext_->CopyResource(readback.stagingTexture_, source);
+
+    source->Release();
+
+    // The staging texture is mapped with DO_NOT_WAIT once the GPU has finished the copy, so the pipeline is
+    // never stalled
+    readback.width_ = width_;
+    readback.height_ = height_;
+    readback.pending_ = true;
+    impl_->screenShotWriteIndex_ = (impl_->screenShotWriteIndex_ + 1) % NUM_SCREENSHOT_READBACKS;
+    return true;
+}
+
 bool Graphics::BeginFrame()
 {
     if (!IsInitialized())
@@ -484,6 +558,10 @@ void Graphics::EndFrame()
         URHO3D_PROFILE("Present");
 
         SendEvent(E_ENDRENDERING);
+
+        UpdateGPUTimings();
+        UpdateScreenShotReadbacks();
+
         impl_->swapChain_->Present(screenParams_.vsync_ ? 1 : 0, 0);
     }
 
@@ -501,6 +579,228 @@ void Graphics::EndFrame()
     }
 }
 
+bool Graphics::GetGPUTimingSupport() const
+{
+    return impl_->device_ != nullptr;
+}
+
+void Graphics::BeginGPUTiming(const ea::string& name)
+{
+    if (!gpuTimingEnabled_ || !impl_->device_)
+        return;
+
+    GPUTimingFrame& frame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    // Refuse to nest timed sections or to add to a frame whose results are still pending
+    if (frame.pending_ || impl_->currentTimingSection_ != M_MAX_UNSIGNED)
+        return;
+
+    D3D11_QUERY_DESC queryDesc;
+    queryDesc.MiscFlags = 0;
+
+    // Open the frame's disjoint query, which provides the timestamp frequency and validity for the whole frame
+    if (frame.queries_.empty())
+    {
+        if (!frame.disjointQuery_)
+        {
+            queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+            HRESULT hr = impl_->device_->CreateQuery(&queryDesc, &frame.disjointQuery_);
+            if (FAILED(hr))
+            {
+                URHO3D_SAFE_RELEASE(frame.disjointQuery_);
+                URHO3D_LOGD3DERROR("Failed to create timestamp disjoint query", hr);
+                return;
+            }
+        }
+
+        impl_->deviceContext_->Begin(frame.disjointQuery_);
+    }
+
+    GPUTimingQuery query;
+    query.name_ = name;
+
+    ID3D11Query** newQueries[] = { &query.beginQuery_, &query.endQuery_ };
+    for (ID3D11Query** newQuery : newQueries)
+    {
+        if (!impl_->freeTimingQueries_.empty())
+        {
+            *newQuery = impl_->freeTimingQueries_.back();
+            impl_->freeTimingQueries_.pop_back();
+        }
+        else
+        {
+            queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+            HRESULT hr = impl_->device_->CreateQuery(&queryDesc, newQuery);
+            if (FAILED(hr))
+            {
+                URHO3D_SAFE_RELEASE(query.beginQuery_);
+                URHO3D_SAFE_RELEASE(query.endQuery_);
+                URHO3D_LOGD3DERROR("Failed to create timestamp query", hr);
+                return;
+            }
+        }
+    }
+
+    impl_->deviceContext_->End(query.beginQuery_);
+
+    impl_->currentTimingSection_ = frame.queries_.size();
+    frame.queries_.push_back(ea::move(query));
+}
+
+void Graphics::EndGPUTiming()
+{
+    if (impl_->currentTimingSection_ == M_MAX_UNSIGNED)
+        return;
+
+    GPUTimingFrame& frame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    impl_->deviceContext_->End(frame.queries_[impl_->currentTimingSection_].endQuery_);
+    impl_->currentTimingSection_ = M_MAX_UNSIGNED;
+}
+
+void Graphics::UpdateGPUTimings()
+{
+    // Close the frame being written and advance the ring
+    GPUTimingFrame& writeFrame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    if (!writeFrame.queries_.empty())
+    {
+        impl_->deviceContext_->End(writeFrame.disjointQuery_);
+        writeFrame.pending_ = true;
+        impl_->timingWriteFrame_ = (impl_->timingWriteFrame_ + 1) % NUM_GPU_TIMING_FRAMES;
+    }
+
+    // Resolve pending frames oldest first. Do not wait for query results unless the ring is about to wrap around
+    while (impl_->timingFrames_[impl_->timingReadFrame_].pending_)
+    {
+        GPUTimingFrame& readFrame = impl_->timingFrames_[impl_->timingReadFrame_];
+        const bool forceResolve = impl_->timingReadFrame_ == impl_->timingWriteFrame_;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        HRESULT hr;
+        for (;;)
+        {
+            hr = impl_->deviceContext_->GetData(readFrame.disjointQuery_, &disjoint, sizeof disjoint, 0);
+            if (hr != S_FALSE || !forceResolve)
+                break;
+        }
+        if (hr == S_FALSE)
+            break;
+
+        gpuTimingResults_.clear();
+        for (GPUTimingQuery& query : readFrame.queries_)
+        {
+            UINT64 beginTime = 0;
+            UINT64 endTime = 0;
+            while (impl_->deviceContext_->GetData(query.beginQuery_, &beginTime, sizeof beginTime, 0) == S_FALSE)
+            {
+            }
+            while (impl_->deviceContext_->GetData(query.endQuery_, &endTime, sizeof endTime, 0) == S_FALSE)
+            {
+            }
+
+            // Discard the whole frame if the counter was disjoint, for example due to a clock frequency change
+            if (SUCCEEDED(hr) && !disjoint.Disjoint && disjoint.Frequency)
+            {
+                GPUTimingResult result;
+                result.name_ = ea::move(query.name_);
+                result.gpuTimeMs_ = (float)((endTime - beginTime) * (1000.0 / (double)disjoint.Frequency));
+                gpuTimingResults_.push_back(ea::move(result));
+            }
+
+            impl_->freeTimingQueries_.push_back(query.beginQuery_);
+            impl_->freeTimingQueries_.push_back(query.endQuery_);
+        }
+
+        readFrame.queries_.clear();
+        readFrame.pending_ = false;
+        impl_->timingReadFrame_ = (impl_->timingReadFrame_ + 1) % NUM_GPU_TIMING_FRAMES;
+    }
+
+    // When timing has been disabled, keep draining the ring but do not expose stale results
+    if (!gpuTimingEnabled_)
+        gpuTimingResults_.clear();
+}
+
+void Graphics::CleanupGPUTimingQueries()
+{
+    for (GPUTimingFrame& frame : impl_->timingFrames_)
+    {
+        for (GPUTimingQuery& query : frame.queries_)
+        {
+            URHO3D_SAFE_RELEASE(query.beginQuery_);
+            URHO3D_SAFE_RELEASE(query.endQuery_);
+        }
+        frame.queries_.clear();
+        frame.pending_ = false;
+
+        URHO3D_SAFE_RELEASE(frame.disjointQuery_);
+    }
+
+    for (ID3D11Query*& query : impl_->freeTimingQueries_)
+    {
+        URHO3D_SAFE_RELEASE(query);
+    }
+    impl_->freeTimingQueries_.clear();
+
+    impl_->timingWriteFrame_ = 0;
+    impl_->timingReadFrame_ = 0;
+    impl_->currentTimingSection_ = M_MAX_UNSIGNED;
+    gpuTimingResults_.clear();
+}
+
+void Graphics::UpdateScreenShotReadbacks()
+{
+    while (impl_->screenShotReadbacks_[impl_->screenShotReadIndex_].pending_)
+    {
+        ScreenShotReadback& readback = impl_->screenShotReadbacks_[impl_->screenShotReadIndex_];
+
+        D3D11_MAPPED_SUBRESOURCE mappedData;
+        mappedData.pData = nullptr;
+        HRESULT hr = impl_->deviceContext_->Map(readback.stagingTexture_, 0, D3D11_MAP_READ,
+            D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedData);
+        // Deliver in submission order; stop at the first copy the GPU has not finished yet
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            return;
+
+        readback.pending_ = false;
+        impl_->screenShotReadIndex_ = (impl_->screenShotReadIndex_ + 1) % NUM_SCREENSHOT_READBACKS;
+
+        if (FAILED(hr) || !mappedData.pData)
+        {
+            URHO3D_LOGD3DERROR("Could not map staging texture for async screenshot", hr);
+            continue;
+        }
+
+        SharedPtr<Image> image(MakeShared<Image>(context_));
+        image->SetSize(readback.width_, readback.height_, 3);
+        unsigned char* destData = image->GetData();
+        for (int y = 0; y < readback.height_; ++y)
+        {
+            unsigned char* src = (unsigned char*)mappedData.pData + y * mappedData.RowPitch;
+            for (int x = 0; x < readback.width_; ++x)
+            {
+                *destData++ = *src++;
+                *destData++ = *src++;
+                *destData++ = *src++;
+                ++src;
+            }
+        }
+
+        impl_->deviceContext_->Unmap(readback.stagingTexture_, 0);
+        SendScreenShotEvent(image);
+    }
+}
+
+void Graphics::CleanupScreenShotReadbacks()
+{
+    for (ScreenShotReadback& readback : impl_->screenShotReadbacks_)
+    {
+        URHO3D_SAFE_RELEASE(readback.stagingTexture_);
+        readback.pending_ = false;
+    }
+
+    impl_->screenShotWriteIndex_ = 0;
+    impl_->screenShotReadIndex_ = 0;
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     IntVector2 rtSize = GetRenderTargetDimensions();
@@ -1002,7 +1302,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
 void Graphics::SetShaderParameter(StringHash param, const float data[], unsigned count)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1014,7 +1315,8 @@ void Graphics::SetShaderParameter(StringHash param, const float data[], unsigned
 void Graphics::SetShaderParameter(StringHash param, float value)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1026,7 +1328,8 @@ void Graphics::SetShaderParameter(StringHash param, float value)
 void Graphics::SetShaderParameter(StringHash param, int value)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1038,7 +1341,8 @@ void Graphics::SetShaderParameter(StringHash param, int value)
 void Graphics::SetShaderParameter(StringHash param, bool value)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1050,7 +1354,8 @@ void Graphics::SetShaderParameter(StringHash param, bool value)
 void Graphics::SetShaderParameter(StringHash param, const Color& color)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1062,7 +1367,8 @@ void Graphics::SetShaderParameter(StringHash param, const Color& color)
 void Graphics::SetShaderParameter(StringHash param, const Vector2& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1074,7 +1380,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector2& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix3& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1086,7 +1393,8 @@ void Graphics::SetShaderParameter(StringHash param, const Matrix3& matrix)
 void Graphics::SetShaderParameter(StringHash param, const Vector3& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1098,7 +1406,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector3& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix4& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1110,7 +1419,8 @@ void Graphics::SetShaderParameter(StringHash param, const Matrix4& matrix)
 void Graphics::SetShaderParameter(StringHash param, const Vector4& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1122,7 +1432,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector4& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix3x4& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     ConstantBuffer* buffer = i->second.bufferPtr_;
@@ -1144,7 +1455,8 @@ bool Graphics::NeedParameterUpdate(ShaderParameterGroup group, const void* sourc
 
 bool Graphics::HasShaderParameter(StringHash param)
 {
-    return impl_->shaderProgram_ && impl_->shaderProgram_->parameters_.find(param) != impl_->shaderProgram_->parameters_.end();
+    return impl_->shaderProgram_ && impl_->shaderProgram_->MayHaveParameter(param) &&
+        impl_->shaderProgram_->parameters_.find(param) != impl_->shaderProgram_->parameters_.end();
 }
 
 bool Graphics::HasTextureUnit(TextureUnit unit)
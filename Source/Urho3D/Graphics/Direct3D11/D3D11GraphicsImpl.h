@@ -42,6 +42,47 @@ using ShaderProgramMap = ea::unordered_map<ea::pair<ShaderVariation*, ShaderVari
 using VertexDeclarationMap = ea::unordered_map<unsigned long long, SharedPtr<VertexDeclaration> >;
 using ConstantBufferMap = ea::unordered_map<unsigned, SharedPtr<ConstantBuffer> >;
 
+/// Number of frames of GPU timestamp queries kept in flight before results are read back.
+static const unsigned NUM_GPU_TIMING_FRAMES = 4;
+
+/// Timestamp query object pair bracketing one GPU timed section.
+struct GPUTimingQuery
+{
+    /// Name of the timed section.
+    ea::string name_;
+    /// Query object written at the start of the section.
+    ID3D11Query* beginQuery_{};
+    /// Query object written at the end of the section.
+    ID3D11Query* endQuery_{};
+};
+
+/// One frame's worth of issued GPU timestamp queries.
+struct GPUTimingFrame
+{
+    /// Disjoint query providing the timestamp frequency for the frame, created on demand.
+    ID3D11Query* disjointQuery_{};
+    /// Queries in submission order.
+    ea::vector<GPUTimingQuery> queries_;
+    /// Submitted and awaiting result readback flag.
+    bool pending_{};
+};
+
+/// Number of slots in the asynchronous screenshot readback ring.
+static const unsigned NUM_SCREENSHOT_READBACKS = 3;
+
+/// One in-flight asynchronous screenshot readback.
+struct ScreenShotReadback
+{
+    /// Staging texture receiving the backbuffer contents.
+    ID3D11Texture2D* stagingTexture_{};
+    /// Captured width.
+    int width_{};
+    /// Captured height.
+    int height_{};
+    /// Issued and awaiting delivery flag.
+    bool pending_{};
+};
+
 /// %Graphics implementation. Holds API-specific objects.
 class URHO3D_API GraphicsImpl
 {
@@ -149,6 +190,22 @@ private:
     ShaderProgramMap shaderPrograms_;
     /// Shader program in use.
     ShaderProgram* shaderProgram_;
+    /// Ring of per-frame GPU timestamp queries.
+    GPUTimingFrame timingFrames_[NUM_GPU_TIMING_FRAMES];
+    /// Ring index of the frame currently receiving timestamp queries.
+    unsigned timingWriteFrame_{};
+    /// Ring index of the oldest frame awaiting timestamp query readback.
+    unsigned timingReadFrame_{};
+    /// Index of the currently open timed section in the write frame, or M_MAX_UNSIGNED if none.
+    unsigned currentTimingSection_{M_MAX_UNSIGNED};
+    /// Unused timestamp query objects available for reuse.
+    ea::vector<ID3D11Query*> freeTimingQueries_;
+    /// Ring of asynchronous screenshot readbacks.
+    ScreenShotReadback screenShotReadbacks_[NUM_SCREENSHOT_READBACKS];
+    /// Ring index of the next screenshot readback slot to issue into.
+    unsigned screenShotWriteIndex_{};
+    /// Ring index of the oldest screenshot readback awaiting delivery.
+    unsigned screenShotReadIndex_{};
 };
 
 }
@@ -264,6 +264,46 @@ bool IndexBuffer::UpdateToGPU()
         return false;
 }
 
+bool IndexBuffer::GetData(void* dest) const
+{
+    if (!dest || !indexCount_ || !indexSize_ || !object_.ptr_ || !graphics_)
+        return false;
+
+    // Copy to a staging buffer which the CPU is allowed to map for reading
+    D3D11_BUFFER_DESC bufferDesc;
+    memset(&bufferDesc, 0, sizeof bufferDesc);
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    bufferDesc.Usage = D3D11_USAGE_STAGING;
+    bufferDesc.ByteWidth = (UINT)(indexCount_ * indexSize_);
+
+    ID3D11Buffer* stagingBuffer = nullptr;
+    HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateBuffer(&bufferDesc, nullptr, &stagingBuffer);
+    if (FAILED(hr))
+    {
+        URHO3D_SAFE_RELEASE(stagingBuffer);
+        URHO3D_LOGD3DERROR("Failed to create staging buffer for index buffer readback", hr);
+        return false;
+    }
+
+    ID3D11DeviceContext* deviceContext = graphics_->GetImpl()->GetDeviceContext();
+    deviceContext->CopyResource(stagingBuffer, (ID3D11Buffer*)object_.ptr_);
+
+    D3D11_MAPPED_SUBRESOURCE mappedData;
+    mappedData.pData = nullptr;
+    hr = deviceContext->Map(stagingBuffer, 0, D3D11_MAP_READ, 0, &mappedData);
+    if (FAILED(hr) || !mappedData.pData)
+    {
+        URHO3D_LOGD3DERROR("Failed to map staging buffer for index buffer readback", hr);
+        URHO3D_SAFE_RELEASE(stagingBuffer);
+        return false;
+    }
+
+    memcpy(dest, mappedData.pData, indexCount_ * (size_t)indexSize_);
+    deviceContext->Unmap(stagingBuffer, 0);
+    URHO3D_SAFE_RELEASE(stagingBuffer);
+    return true;
+}
+
 void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     void* hwData = nullptr;
@@ -273,13 +313,14 @@ void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
         D3D11_MAPPED_SUBRESOURCE mappedData;
         mappedData.pData = nullptr;
 
+        // Dynamic buffers must be mapped with either discard or no-overwrite; a plain write map is invalid for them
         HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->Map((ID3D11Buffer*)object_.ptr_, 0, discard ? D3D11_MAP_WRITE_DISCARD :
-            D3D11_MAP_WRITE, 0, &mappedData);
+            D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedData);
         if (FAILED(hr) || !mappedData.pData)
             URHO3D_LOGD3DERROR("Failed to map index buffer", hr);
         else
         {
-            hwData = mappedData.pData;
+            hwData = (unsigned char*)mappedData.pData + start * indexSize_;
             lockState_ = LOCK_HARDWARE;
         }
     }
@@ -59,6 +59,7 @@ public:
         {
             parameters_[i->first] = i->second;
             parameters_[i->first].bufferPtr_ = vsConstantBuffers_[i->second.buffer_].Get();
+            parametersFilter_ |= 1ull << (i->first.Value() & 63u);
         }
 
         const ea::unordered_map<StringHash, ShaderParameter>& psParams = pixelShader->GetParameters();
@@ -66,6 +67,7 @@ public:
         {
             parameters_[i->first] = i->second;
             parameters_[i->first].bufferPtr_ = psConstantBuffers_[i->second.buffer_].Get();
+            parametersFilter_ |= 1ull << (i->first.Value() & 63u);
         }
 
         // Optimize shader parameter lookup by rehashing to next power of two
@@ -78,8 +80,14 @@ public:
     {
     }
 
+    /// Return whether may use a shader parameter. False positives are possible, but a false return is certain, which
+    /// allows skipping the parameter map lookup for parameters the program does not use.
+    bool MayHaveParameter(StringHash param) const { return (parametersFilter_ & (1ull << (param.Value() & 63u))) != 0; }
+
     /// Combined parameters from the vertex and pixel shader.
     ea::unordered_map<StringHash, ShaderParameter> parameters_;
+    /// Bitmask of shader parameter name hashes for fast rejection of unused parameters.
+    unsigned long long parametersFilter_{};
     /// Vertex shader constant buffers.
     SharedPtr<ConstantBuffer> vsConstantBuffers_[MAX_SHADER_PARAMETER_GROUPS];
     /// Pixel shader constant buffers.
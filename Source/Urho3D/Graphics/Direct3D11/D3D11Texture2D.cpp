@@ -191,7 +191,10 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         unsigned format = 0;
 
         // Discard unnecessary mip levels
-        for (unsigned i = 0; i < mipsToSkip_[quality]; ++i)
+        unsigned mipsToSkip = mipsToSkip_[quality] + streamLevel_;
+        while (mipsToSkip && (levelWidth / (1 << mipsToSkip) < 4 || levelHeight / (1 << mipsToSkip) < 4))
+            --mipsToSkip;
+        for (unsigned i = 0; i < mipsToSkip; ++i)
         {
             mipImage = image->GetNextLevel(); image = mipImage;
             levelData = image->GetData();
@@ -246,7 +249,7 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             needDecompress = true;
         }
 
-        unsigned mipsToSkip = mipsToSkip_[quality];
+        unsigned mipsToSkip = mipsToSkip_[quality] + streamLevel_;
         if (mipsToSkip >= levels)
             mipsToSkip = levels - 1;
         while (mipsToSkip && (width / (1 << mipsToSkip) < 4 || height / (1 << mipsToSkip) < 4))
@@ -266,8 +269,22 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
                 SetData(i, 0, 0, level.width_, level.height_, level.data_);
                 memoryUse += level.rows_ * level.rowSize_;
             }
+            else if (level.depth_ == 1 && level.format_ >= CF_DXT1 && level.format_ <= CF_ETC2_RGBA)
+            {
+                // Decompress and upload one row of blocks at a time to avoid allocating a full-size RGBA copy of the level
+                unsigned char* rgbaData = new unsigned char[level.width_ * 4 * 4];
+                for (int y = 0; y < level.height_; y += 4)
+                {
+                    int rowCount = Min(4, level.height_ - y);
+                    level.Decompress(rgbaData, y, rowCount);
+                    SetData(i, 0, y, level.width_, rowCount, rgbaData);
+                }
+                memoryUse += level.width_ * level.height_ * 4;
+                delete[] rgbaData;
+            }
             else
             {
+                // PVRTC interleaves its blocks over the whole level and can only be decompressed in one go
                 unsigned char* rgbaData = new unsigned char[level.width_ * level.height_ * 4];
                 level.Decompress(rgbaData);
                 SetData(i, 0, 0, level.width_, level.height_, rgbaData);
@@ -75,6 +75,8 @@ bool VertexBuffer::SetData(const void* data)
     if (shadowData_ && data != shadowData_.get())
         memcpy(shadowData_.get(), data, vertexCount_ * vertexSize_);
 
+    UpdateShadowDataRange(data, 0, vertexCount_);
+
     if (object_.ptr_)
     {
         if (dynamic_)
@@ -134,6 +136,8 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
     if (shadowData_ && shadowData_.get() + start * vertexSize_ != data)
         memcpy(shadowData_.get() + start * vertexSize_, data, count * vertexSize_);
 
+    UpdateShadowDataRange(data, start, count);
+
     if (object_.ptr_)
     {
         if (dynamic_)
@@ -269,6 +273,46 @@ bool VertexBuffer::UpdateToGPU()
         return false;
 }
 
+bool VertexBuffer::GetData(void* dest) const
+{
+    if (!dest || !vertexCount_ || !vertexSize_ || !object_.ptr_ || !graphics_)
+        return false;
+
+    // Copy to a staging buffer which the CPU is allowed to map for reading
+    D3D11_BUFFER_DESC bufferDesc;
+    memset(&bufferDesc, 0, sizeof bufferDesc);
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    bufferDesc.Usage = D3D11_USAGE_STAGING;
+    bufferDesc.ByteWidth = (UINT)(vertexCount_ * vertexSize_);
+
+    ID3D11Buffer* stagingBuffer = nullptr;
+    HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateBuffer(&bufferDesc, nullptr, &stagingBuffer);
+    if (FAILED(hr))
+    {
+        URHO3D_SAFE_RELEASE(stagingBuffer);
+        URHO3D_LOGD3DERROR("Failed to create staging buffer for vertex buffer readback", hr);
+        return false;
+    }
+
+    ID3D11DeviceContext* deviceContext = graphics_->GetImpl()->GetDeviceContext();
+    deviceContext->CopyResource(stagingBuffer, (ID3D11Buffer*)object_.ptr_);
+
+    D3D11_MAPPED_SUBRESOURCE mappedData;
+    mappedData.pData = nullptr;
+    hr = deviceContext->Map(stagingBuffer, 0, D3D11_MAP_READ, 0, &mappedData);
+    if (FAILED(hr) || !mappedData.pData)
+    {
+        URHO3D_LOGD3DERROR("Failed to map staging buffer for vertex buffer readback", hr);
+        URHO3D_SAFE_RELEASE(stagingBuffer);
+        return false;
+    }
+
+    memcpy(dest, mappedData.pData, vertexCount_ * (size_t)vertexSize_);
+    deviceContext->Unmap(stagingBuffer, 0);
+    URHO3D_SAFE_RELEASE(stagingBuffer);
+    return true;
+}
+
 void* VertexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     void* hwData = nullptr;
@@ -278,13 +322,14 @@ void* VertexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
         D3D11_MAPPED_SUBRESOURCE mappedData;
         mappedData.pData = nullptr;
 
+        // Dynamic buffers must be mapped with either discard or no-overwrite; a plain write map is invalid for them
         HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->Map((ID3D11Buffer*)object_.ptr_, 0, discard ? D3D11_MAP_WRITE_DISCARD :
-            D3D11_MAP_WRITE, 0, &mappedData);
+            D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedData);
         if (FAILED(hr) || !mappedData.pData)
             URHO3D_LOGD3DERROR("Failed to map vertex buffer", hr);
         else
         {
-            hwData = mappedData.pData;
+            hwData = (unsigned char*)mappedData.pData + start * vertexSize_;
             lockState_ = LOCK_HARDWARE;
         }
     }
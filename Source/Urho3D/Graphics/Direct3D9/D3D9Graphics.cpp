@@ -38,6 +38,7 @@
 #include "../../Graphics/VertexDeclaration.h"
 #include "../../IO/File.h"
 #include "../../IO/Log.h"
+#include "../../Resource/Image.h"
 #include "../../Resource/ResourceCache.h"
 
 #include <SDL/SDL.h>
@@ -609,6 +610,25 @@ bool Graphics::TakeScreenShot(Image& destImage)
     return true;
 }
 
+bool Graphics::TakeScreenShotAsync()
+{
+    // Async readback not implemented on Direct3D9; capture synchronously, still delivered through the event
+    SharedPtr<Image> image(MakeShared<Image>(context_));
+    if (!TakeScreenShot(*image))
+        return false;
+
+    SendScreenShotEvent(image);
+    return true;
+}
+
+void Graphics::UpdateScreenShotReadbacks()
+{
+}
+
+void Graphics::CleanupScreenShotReadbacks()
+{
+}
+
 bool Graphics::BeginFrame()
 {
     if (!IsInitialized())
@@ -711,6 +731,20 @@ void Graphics::EndFrame()
     }
 }
 
+bool Graphics::GetGPUTimingSupport() const
+{
+    // Not implemented on Direct3D9
+    return false;
+}
+
+void Graphics::BeginGPUTiming(const ea::string& name)
+{
+}
+
+void Graphics::EndGPUTiming()
+{
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     DWORD d3dFlags = 0;
@@ -1148,7 +1182,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
 void Graphics::SetShaderParameter(StringHash param, const float data[], unsigned count)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1160,7 +1195,8 @@ void Graphics::SetShaderParameter(StringHash param, const float data[], unsigned
 void Graphics::SetShaderParameter(StringHash param, float value)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     static Vector4 data(Vector4::ZERO);
@@ -1176,7 +1212,8 @@ void Graphics::SetShaderParameter(StringHash param, int value)
 {
     /// \todo Int constants seem to have no effect on Direct3D9
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1189,7 +1226,8 @@ void Graphics::SetShaderParameter(StringHash param, bool value)
 {
     /// \todo Bool constants seem to have no effect on Direct3D9
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     BOOL data = value;
@@ -1203,7 +1241,8 @@ void Graphics::SetShaderParameter(StringHash param, bool value)
 void Graphics::SetShaderParameter(StringHash param, const Color& color)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1215,7 +1254,8 @@ void Graphics::SetShaderParameter(StringHash param, const Color& color)
 void Graphics::SetShaderParameter(StringHash param, const Vector2& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     static Vector4 data(Vector4::ZERO);
@@ -1231,7 +1271,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector2& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix3& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     static Matrix3x4 data(Matrix3x4::ZERO);
@@ -1254,7 +1295,8 @@ void Graphics::SetShaderParameter(StringHash param, const Matrix3& matrix)
 void Graphics::SetShaderParameter(StringHash param, const Vector3& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     static Vector4 data(Vector4::ZERO);
@@ -1271,7 +1313,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector3& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix4& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1283,7 +1326,8 @@ void Graphics::SetShaderParameter(StringHash param, const Matrix4& matrix)
 void Graphics::SetShaderParameter(StringHash param, const Vector4& vector)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1295,7 +1339,8 @@ void Graphics::SetShaderParameter(StringHash param, const Vector4& vector)
 void Graphics::SetShaderParameter(StringHash param, const Matrix3x4& matrix)
 {
     ea::unordered_map<StringHash, ShaderParameter>::iterator i;
-    if (!impl_->shaderProgram_ || (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
+    if (!impl_->shaderProgram_ || !impl_->shaderProgram_->MayHaveParameter(param) ||
+        (i = impl_->shaderProgram_->parameters_.find(param)) == impl_->shaderProgram_->parameters_.end())
         return;
 
     if (i->second.type_ == VS)
@@ -1317,7 +1362,8 @@ bool Graphics::NeedParameterUpdate(ShaderParameterGroup group, const void* sourc
 
 bool Graphics::HasShaderParameter(StringHash param)
 {
-    return impl_->shaderProgram_ && impl_->shaderProgram_->parameters_.find(param) != impl_->shaderProgram_->parameters_.end();
+    return impl_->shaderProgram_ && impl_->shaderProgram_->MayHaveParameter(param) &&
+        impl_->shaderProgram_->parameters_.find(param) != impl_->shaderProgram_->parameters_.end();
 }
 
 bool Graphics::HasTextureUnit(TextureUnit unit)
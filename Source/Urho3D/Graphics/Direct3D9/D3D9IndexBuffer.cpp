@@ -269,6 +269,25 @@ bool IndexBuffer::UpdateToGPU()
         return false;
 }
 
+bool IndexBuffer::GetData(void* dest) const
+{
+    if (!dest || !indexCount_ || !indexSize_ || !object_.ptr_ || !graphics_ || graphics_->IsDeviceLost())
+        return false;
+
+    // Read-only lock fails on dynamic write-only buffers; readback is then unavailable
+    void* source = nullptr;
+    HRESULT hr = ((IDirect3DIndexBuffer9*)object_.ptr_)->Lock(0, indexCount_ * indexSize_, &source, D3DLOCK_READONLY);
+    if (FAILED(hr) || !source)
+    {
+        URHO3D_LOGD3DERROR("Could not lock index buffer for readback", hr);
+        return false;
+    }
+
+    memcpy(dest, source, indexCount_ * (size_t)indexSize_);
+    ((IDirect3DIndexBuffer9*)object_.ptr_)->Unlock();
+    return true;
+}
+
 void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     void* hwData = nullptr;
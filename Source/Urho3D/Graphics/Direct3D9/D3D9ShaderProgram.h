@@ -39,18 +39,30 @@ public:
     {
         const ea::unordered_map<StringHash, ShaderParameter>& vsParams = vertexShader->GetParameters();
         for (auto i = vsParams.begin(); i != vsParams.end(); ++i)
+        {
             parameters_[i->first] = i->second;
+            parametersFilter_ |= 1ull << (i->first.Value() & 63u);
+        }
 
         const ea::unordered_map<StringHash, ShaderParameter>& psParams = pixelShader->GetParameters();
         for (auto i = psParams.begin(); i != psParams.end(); ++i)
+        {
             parameters_[i->first] = i->second;
+            parametersFilter_ |= 1ull << (i->first.Value() & 63u);
+        }
 
         // Optimize shader parameter lookup by rehashing to next power of two
         parameters_.rehash(Max(2, NextPowerOfTwo(parameters_.size())));
     }
 
+    /// Return whether may use a shader parameter. False positives are possible, but a false return is certain, which
+    /// allows skipping the parameter map lookup for parameters the program does not use.
+    bool MayHaveParameter(StringHash param) const { return (parametersFilter_ & (1ull << (param.Value() & 63u))) != 0; }
+
     /// Combined parameters from the vertex and pixel shader.
     ea::unordered_map<StringHash, ShaderParameter> parameters_;
+    /// Bitmask of shader parameter name hashes for fast rejection of unused parameters.
+    unsigned long long parametersFilter_{};
 };
 
 }
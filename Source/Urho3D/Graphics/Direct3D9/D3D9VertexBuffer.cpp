@@ -86,6 +86,8 @@ bool VertexBuffer::SetData(const void* data)
     if (shadowData_ && data != shadowData_.get())
         memcpy(shadowData_.get(), data, vertexCount_ * vertexSize_);
 
+    UpdateShadowDataRange(data, 0, vertexCount_);
+
     if (object_.ptr_)
     {
         if (graphics_->IsDeviceLost())
@@ -138,6 +140,8 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
     if (shadowData_ && shadowData_.get() + start * vertexSize_ != data)
         memcpy(shadowData_.get() + start * vertexSize_, data, count * vertexSize_);
 
+    UpdateShadowDataRange(data, start, count);
+
     if (object_.ptr_)
     {
         if (graphics_->IsDeviceLost())
@@ -274,6 +278,25 @@ bool VertexBuffer::UpdateToGPU()
         return false;
 }
 
+bool VertexBuffer::GetData(void* dest) const
+{
+    if (!dest || !vertexCount_ || !vertexSize_ || !object_.ptr_ || !graphics_ || graphics_->IsDeviceLost())
+        return false;
+
+    // Read-only lock fails on dynamic write-only buffers; readback is then unavailable
+    void* source = nullptr;
+    HRESULT hr = ((IDirect3DVertexBuffer9*)object_.ptr_)->Lock(0, vertexCount_ * vertexSize_, &source, D3DLOCK_READONLY);
+    if (FAILED(hr) || !source)
+    {
+        URHO3D_LOGD3DERROR("Could not lock vertex buffer for readback", hr);
+        return false;
+    }
+
+    memcpy(dest, source, vertexCount_ * (size_t)vertexSize_);
+    ((IDirect3DVertexBuffer9*)object_.ptr_)->Unlock();
+    return true;
+}
+
 void* VertexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     void* hwData = nullptr;
@@ -69,6 +69,7 @@ Drawable::Drawable(Context* context, DrawableFlags drawableFlags) :
     updateQueued_(false),
     zoneDirty_(false),
     octant_(nullptr),
+    octantIndex_(0),
     zone_(nullptr),
     viewMask_(DEFAULT_VIEWMASK),
     lightMask_(DEFAULT_LIGHTMASK),
@@ -189,6 +190,8 @@ void Drawable::SetLodBias(float bias)
 void Drawable::SetViewMask(unsigned mask)
 {
     viewMask_ = mask;
+    if (octant_)
+        octant_->RefreshDrawableCullData(this);
     MarkNetworkUpdate();
 }
 
@@ -57,6 +57,7 @@ class Material;
 class OcclusionBuffer;
 class Octant;
 class RayOctreeQuery;
+class Technique;
 class Zone;
 struct RayQueryResult;
 struct WorkItem;
@@ -107,12 +108,31 @@ struct URHO3D_API SourceBatch
     unsigned numWorldTransforms_{1};
     /// Per-instance data. If not null, must contain enough data to fill instancing buffer.
     void* instancingData_{};
+    /// Per-instance data stride in bytes. If nonzero, instancingData_ is an array with one block of this size per
+    /// world transform; if zero, all world transforms share the same data.
+    unsigned instancingDataStride_{};
     /// %Geometry type.
     GeometryType geometryType_{GEOM_STATIC};
     /// Lightmap UV scale and offset.
     Vector4* lightmapScaleOffset_{};
+
+    /// Cached technique resolved from the material by the view. Valid while the material, its technique list
+    /// version and the material quality match, and the LOD distance stays within the band below.
+    mutable Technique* resolvedTechnique_{};
+    /// Material the technique was resolved from.
+    mutable Material* resolvedTechniqueMaterial_{};
+    /// Material technique list version at resolve time.
+    mutable unsigned resolvedTechniqueVersion_{};
+    /// Material quality at resolve time.
+    mutable int resolvedTechniqueQuality_{};
+    /// Lower bound (inclusive) of the LOD distance band in which the resolved technique stays valid.
+    mutable float resolvedTechniqueLodBegin_{};
+    /// Upper bound (exclusive) of the LOD distance band in which the resolved technique stays valid.
+    mutable float resolvedTechniqueLodEnd_{};
     /// Lightmap texture index.
     unsigned lightmapIndex_{};
+    /// LOD morph factor and level for terrain geomorphing. Not used if null.
+    Vector4* lodMorphParameters_{};
 
     /// Equality comparison operator.
     bool operator==(const SourceBatch& other) const
@@ -121,7 +141,8 @@ struct URHO3D_API SourceBatch
             return true;
         return distance_ == other.distance_ && geometry_ == other.geometry_ && material_ == other.material_ &&
             worldTransform_ == other.worldTransform_ && numWorldTransforms_ == other.numWorldTransforms_ &&
-            instancingData_ == other.instancingData_ && geometryType_ == other.geometryType_;
+            instancingData_ == other.instancingData_ && instancingDataStride_ == other.instancingDataStride_ &&
+            geometryType_ == other.geometryType_;
     }
 
     /// Inequality comparison operator.
@@ -158,6 +179,8 @@ public:
     virtual void UpdateBatches(const FrameInfo& frame);
     /// Prepare geometry for rendering.
     virtual void UpdateGeometry(const FrameInfo& frame) { }
+    /// Upload geometry prepared by a worker thread update. Is called on the main thread after all threaded geometry updates have completed.
+    virtual void CommitGeometry() { }
 
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     virtual UpdateGeometryType GetUpdateGeometryType() { return UPDATE_NONE; }
@@ -290,6 +313,9 @@ public:
     /// Return sorting value.
     float GetSortValue() const { return sortValue_; }
 
+    /// Return the frame number the drawable was last in view.
+    unsigned GetViewFrameNumber() const { return viewFrameNumber_; }
+
     /// Return whether is in view on the current frame. Called by View.
     bool IsInView(const FrameInfo& frame, bool anyCamera = false) const;
 
@@ -375,6 +401,8 @@ protected:
     bool zoneDirty_;
     /// Octree octant.
     Octant* octant_;
+    /// Index of this drawable in its octant's drawable and culling data arrays. Maintained by Octant.
+    unsigned octantIndex_;
     /// Current zone.
     Zone* zone_;
     /// View mask.
@@ -236,8 +236,23 @@ void Geometry::GetRawData(const unsigned char*& vertexData, unsigned& vertexSize
     else if (vertexBuffers_.size() && vertexBuffers_[0])
     {
         vertexData = vertexBuffers_[0]->GetShadowData();
-        vertexSize = vertexBuffers_[0]->GetVertexSize();
-        elements = &vertexBuffers_[0]->GetElements();
+        if (vertexData)
+        {
+            vertexSize = vertexBuffers_[0]->GetVertexSize();
+            elements = &vertexBuffers_[0]->GetElements();
+        }
+        else if (vertexBuffers_[0]->GetPositionShadowData())
+        {
+            // Fall back to the packed position-only shadow copy; sufficient for raycasts and other spatial queries
+            vertexData = vertexBuffers_[0]->GetPositionShadowData();
+            vertexSize = sizeof(Vector3);
+            elements = &VertexBuffer::GetPositionShadowElements();
+        }
+        else
+        {
+            vertexSize = 0;
+            elements = nullptr;
+        }
     }
     else
     {
@@ -281,8 +296,23 @@ void Geometry::GetRawDataShared(ea::shared_array<unsigned char>& vertexData, uns
     else if (vertexBuffers_.size() && vertexBuffers_[0])
     {
         vertexData = vertexBuffers_[0]->GetShadowDataShared();
-        vertexSize = vertexBuffers_[0]->GetVertexSize();
-        elements = &vertexBuffers_[0]->GetElements();
+        if (vertexData)
+        {
+            vertexSize = vertexBuffers_[0]->GetVertexSize();
+            elements = &vertexBuffers_[0]->GetElements();
+        }
+        else if (vertexBuffers_[0]->GetPositionShadowData())
+        {
+            // Fall back to the packed position-only shadow copy; sufficient for raycasts and other spatial queries
+            vertexData = vertexBuffers_[0]->GetPositionShadowDataShared();
+            vertexSize = sizeof(Vector3);
+            elements = &VertexBuffer::GetPositionShadowElements();
+        }
+        else
+        {
+            vertexSize = 0;
+            elements = nullptr;
+        }
     }
     else
     {
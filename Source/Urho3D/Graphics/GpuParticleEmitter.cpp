@@ -0,0 +1,581 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/GpuParticleEmitter.h"
+#include "../Graphics/ParticleEffect.h"
+#include "../Graphics/Technique.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ResourceEvents.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+static const unsigned DEFAULT_MAX_GPU_PARTICLES = 10000;
+static const char* GPU_PARTICLE_TECHNIQUE = "Techniques/DiffGpuParticleAlpha.xml";
+
+// Spawn data layout of one particle quad vertex; must match the vertex inputs of Shaders/GpuParticle
+static const ea::vector<VertexElement> gpuParticleElements =
+{
+    VertexElement(TYPE_VECTOR4, SEM_POSITION),      // Spawn position, spawn time
+    VertexElement(TYPE_UBYTE4_NORM, SEM_COLOR),     // Base color
+    VertexElement(TYPE_VECTOR2, SEM_TEXCOORD, 0),   // Corner UV
+    VertexElement(TYPE_VECTOR2, SEM_TEXCOORD, 1),   // Corner signs
+    VertexElement(TYPE_VECTOR4, SEM_TANGENT),       // Initial velocity, time to live
+    VertexElement(TYPE_VECTOR4, SEM_BLENDWEIGHTS)   // Size, rotation, rotation speed
+};
+
+static const unsigned GPU_PARTICLE_VERTEX_FLOATS = 17;
+static const unsigned GPU_PARTICLE_QUAD_FLOATS = GPU_PARTICLE_VERTEX_FLOATS * 4;
+
+GpuParticleEmitter::GpuParticleEmitter(Context* context) :
+    Drawable(context, DRAWABLE_GEOMETRY),
+    geometry_(context->CreateObject<Geometry>()),
+    vertexBuffer_(context_->CreateObject<VertexBuffer>()),
+    indexBuffer_(context_->CreateObject<IndexBuffer>()),
+    transform_(Matrix3x4::IDENTITY),
+    maxParticles_(DEFAULT_MAX_GPU_PARTICLES),
+    nextParticle_(0),
+    spawnStart_(0),
+    spawnCount_(0),
+    bufferSizeDirty_(true),
+    emitting_(true),
+    relative_(false),
+    periodTimer_(0.0f),
+    emissionTimer_(0.0f),
+    maxDeathTime_(0.0f),
+    boundsMargin_(0.0f)
+{
+    geometry_->SetVertexBuffer(0, vertexBuffer_);
+    geometry_->SetIndexBuffer(indexBuffer_);
+
+    batches_.resize(1);
+    batches_[0].geometry_ = geometry_;
+    batches_[0].geometryType_ = GEOM_STATIC;
+    batches_[0].worldTransform_ = &transform_;
+}
+
+GpuParticleEmitter::~GpuParticleEmitter() = default;
+
+void GpuParticleEmitter::RegisterObject(Context* context)
+{
+    context->RegisterFactory<GpuParticleEmitter>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Effect", GetEffectAttr, SetEffectAttr, ResourceRef, ResourceRef(ParticleEffect::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Particles", GetMaxParticles, SetMaxParticles, unsigned, DEFAULT_MAX_GPU_PARTICLES, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Is Emitting", bool, emitting_, true, AM_FILE);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
+}
+
+void GpuParticleEmitter::OnSetEnabled()
+{
+    Drawable::OnSetEnabled();
+
+    Scene* scene = GetScene();
+    if (scene)
+    {
+        if (IsEnabledEffective())
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GpuParticleEmitter, HandleScenePostUpdate));
+        else
+            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+    }
+}
+
+void GpuParticleEmitter::UpdateBatches(const FrameInfo& frame)
+{
+    distance_ = frame.camera_->GetDistance(GetWorldBoundingBox().Center());
+    batches_[0].distance_ = distance_;
+    transform_ = relative_ ? node_->GetWorldTransform() : Matrix3x4::IDENTITY;
+
+    float scale = GetWorldBoundingBox().Size().DotProduct(DOT_SCALE);
+    lodDistance_ = frame.camera_->GetLodDistance(distance_, scale, lodBias_);
+}
+
+void GpuParticleEmitter::UpdateGeometry(const FrameInfo& frame)
+{
+    if (bufferSizeDirty_)
+    {
+        unsigned numVertices = maxParticles_ * 4;
+        vertexBuffer_->SetSize(numVertices, gpuParticleElements, true);
+        geometry_->SetVertexBuffer(0, vertexBuffer_);
+
+        // Clear the whole buffer so that unspawned slots hold degenerate quads
+        void* vertexDest = vertexBuffer_->Lock(0, numVertices, true);
+        if (vertexDest)
+        {
+            memset(vertexDest, 0, (size_t)numVertices * vertexBuffer_->GetVertexSize());
+            vertexBuffer_->Unlock();
+        }
+
+        // Indices do not change for a given particle capacity
+        bool largeIndices = numVertices >= 65536;
+        indexBuffer_->SetSize(maxParticles_ * 6, largeIndices);
+        void* indexDest = indexBuffer_->Lock(0, maxParticles_ * 6, true);
+        if (indexDest)
+        {
+            unsigned numParticles = maxParticles_;
+            if (!largeIndices)
+            {
+                auto* dest = (unsigned short*)indexDest;
+                unsigned short vertexIndex = 0;
+                while (numParticles--)
+                {
+                    dest[0] = vertexIndex;
+                    dest[1] = vertexIndex + 1;
+                    dest[2] = vertexIndex + 2;
+                    dest[3] = vertexIndex + 2;
+                    dest[4] = vertexIndex + 3;
+                    dest[5] = vertexIndex;
+
+                    dest += 6;
+                    vertexIndex += 4;
+                }
+            }
+            else
+            {
+                auto* dest = (unsigned*)indexDest;
+                unsigned vertexIndex = 0;
+                while (numParticles--)
+                {
+                    dest[0] = vertexIndex;
+                    dest[1] = vertexIndex + 1;
+                    dest[2] = vertexIndex + 2;
+                    dest[3] = vertexIndex + 2;
+                    dest[4] = vertexIndex + 3;
+                    dest[5] = vertexIndex;
+
+                    dest += 6;
+                    vertexIndex += 4;
+                }
+            }
+            indexBuffer_->Unlock();
+        }
+
+        geometry_->SetDrawRange(TRIANGLE_LIST, 0, maxParticles_ * 6, false);
+
+        // Remap the pending spawns to the start of the new ring
+        spawnStart_ = 0;
+        nextParticle_ = spawnCount_ % maxParticles_;
+
+        bufferSizeDirty_ = false;
+    }
+    else if (vertexBuffer_->IsDataLost())
+    {
+        // Particles spawned before the data loss are gone; clear the buffer to avoid rendering garbage quads
+        void* vertexDest = vertexBuffer_->Lock(0, maxParticles_ * 4, true);
+        if (vertexDest)
+        {
+            memset(vertexDest, 0, (size_t)maxParticles_ * 4 * vertexBuffer_->GetVertexSize());
+            vertexBuffer_->Unlock();
+        }
+        vertexBuffer_->ClearDataLost();
+    }
+
+    // Upload the pending spawn quads into the ring; at most two contiguous ranges because of wrapping
+    if (spawnCount_)
+    {
+        unsigned firstCount = Min(spawnCount_, maxParticles_ - spawnStart_);
+        vertexBuffer_->SetDataRange(spawnStaging_.data(), spawnStart_ * 4, firstCount * 4);
+        if (spawnCount_ > firstCount)
+            vertexBuffer_->SetDataRange(spawnStaging_.data() + firstCount * GPU_PARTICLE_QUAD_FLOATS, 0,
+                (spawnCount_ - firstCount) * 4);
+
+        spawnStaging_.clear();
+        spawnCount_ = 0;
+    }
+}
+
+UpdateGeometryType GpuParticleEmitter::GetUpdateGeometryType()
+{
+    if (bufferSizeDirty_ || spawnCount_ || vertexBuffer_->IsDataLost())
+        return UPDATE_MAIN_THREAD;
+    else
+        return UPDATE_NONE;
+}
+
+void GpuParticleEmitter::SetEffect(ParticleEffect* effect)
+{
+    if (effect == effect_)
+        return;
+
+    RemoveAllParticles();
+
+    // Unsubscribe from the reload event of previous effect (if any), then subscribe to the new
+    if (effect_)
+        UnsubscribeFromEvent(effect_, E_RELOADFINISHED);
+
+    effect_ = effect;
+
+    if (effect_)
+        SubscribeToEvent(effect_, E_RELOADFINISHED, URHO3D_HANDLER(GpuParticleEmitter, HandleEffectReloadFinished));
+
+    UpdateMaterial();
+    MarkNetworkUpdate();
+}
+
+void GpuParticleEmitter::SetMaxParticles(unsigned num)
+{
+    // Prevent negative value being assigned from the editor
+    if (num > M_MAX_INT)
+        num = 0;
+    num = Max(num, 1U);
+
+    if (num == maxParticles_)
+        return;
+
+    maxParticles_ = num;
+    bufferSizeDirty_ = true;
+    MarkNetworkUpdate();
+}
+
+void GpuParticleEmitter::SetEmitting(bool enable)
+{
+    if (enable != emitting_)
+    {
+        emitting_ = enable;
+        periodTimer_ = 0.0f;
+        // Note: network update does not need to be marked as this is a file only attribute
+    }
+}
+
+void GpuParticleEmitter::RemoveAllParticles()
+{
+    // Clearing the buffer removes the live quads from the GPU as well
+    bufferSizeDirty_ = true;
+    spawnStaging_.clear();
+    spawnCount_ = 0;
+    maxDeathTime_ = 0.0f;
+    spawnBounds_.Clear();
+    OnMarkedDirty(node_);
+}
+
+ParticleEffect* GpuParticleEmitter::GetEffect() const
+{
+    return effect_;
+}
+
+void GpuParticleEmitter::SetEffectAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetEffect(cache->GetResource<ParticleEffect>(value.name_));
+}
+
+ResourceRef GpuParticleEmitter::GetEffectAttr() const
+{
+    return GetResourceRef(effect_, ParticleEffect::GetTypeStatic());
+}
+
+void GpuParticleEmitter::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    if (scene && IsEnabledEffective())
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GpuParticleEmitter, HandleScenePostUpdate));
+    else if (!scene)
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void GpuParticleEmitter::OnWorldBoundingBoxUpdate()
+{
+    BoundingBox worldBox;
+
+    if (spawnBounds_.Defined())
+    {
+        // Pad the spawn bounds to cover the worst case travel over a full particle lifetime
+        BoundingBox padded = spawnBounds_;
+        padded.min_ -= Vector3::ONE * boundsMargin_;
+        padded.max_ += Vector3::ONE * boundsMargin_;
+        worldBox = relative_ ? padded.Transformed(node_->GetWorldTransform()) : padded;
+    }
+
+    // Always merge the node's own position to keep the emitter rendered while it has no particles
+    worldBox.Merge(node_->GetWorldPosition());
+
+    worldBoundingBox_ = worldBox;
+}
+
+void GpuParticleEmitter::UpdateMaterial()
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    auto* technique = cache->GetResource<Technique>(GPU_PARTICLE_TECHNIQUE);
+
+    if (effect_ && effect_->GetMaterial())
+        material_ = effect_->GetMaterial()->Clone();
+    else
+        material_ = context_->CreateObject<Material>();
+
+    // Replace the CPU particle technique with the GPU simulation shaders, keeping the texture and render state
+    material_->SetNumTechniques(1);
+    material_->SetTechnique(0, technique);
+
+    if (effect_)
+    {
+        relative_ = effect_->IsRelative();
+
+        material_->SetShaderParameter("ConstantForce", effect_->GetConstantForce());
+        material_->SetShaderParameter("DampingForce", effect_->GetDampingForce());
+        material_->SetShaderParameter("SizeAdd", effect_->GetSizeAdd());
+        material_->SetShaderParameter("SizeMul", effect_->GetSizeMul());
+
+        // Multi-frame color animation is approximated by interpolating between the first and the last frame
+        const ea::vector<ColorFrame>& colorFrames = effect_->GetColorFrames();
+        const Color colorStart = colorFrames.size() ? colorFrames.front().color_ : Color::WHITE;
+        const Color colorEnd = colorFrames.size() ? colorFrames.back().color_ : Color::WHITE;
+        const Vector2 colorTimeRange(colorFrames.size() ? colorFrames.front().time_ : 0.0f,
+            colorFrames.size() ? colorFrames.back().time_ : 1.0f);
+        material_->SetShaderParameter("ColorStart", colorStart);
+        material_->SetShaderParameter("ColorEnd", colorEnd);
+        material_->SetShaderParameter("ColorTimeRange", colorTimeRange);
+
+        // Worst case travel distance for bounding box estimation; ignores damping, hence conservative
+        const float maxTime = effect_->GetMaxTimeToLive();
+        const float travel = Abs(effect_->GetMaxVelocity()) * maxTime +
+            0.5f * effect_->GetConstantForce().Length() * maxTime * maxTime;
+        const Vector2& maxSize = effect_->GetMaxParticleSize();
+        boundsMargin_ = travel + Max(maxSize.x_, maxSize.y_);
+    }
+
+    batches_[0].material_ = material_;
+}
+
+Vector3 GpuParticleEmitter::SpawnNewParticle(float spawnTime)
+{
+    Vector3 startDir = effect_->GetRandomDirection();
+    startDir.Normalize();
+
+    // Keep the emitter shapes in sync with ParticleEmitter::EmitNewParticle()
+    Vector3 startPos;
+    switch (effect_->GetEmitterType())
+    {
+    case EMITTER_SPHERE:
+        {
+            Vector3 dir(
+                Random(2.0f) - 1.0f,
+                Random(2.0f) - 1.0f,
+                Random(2.0f) - 1.0f
+            );
+            dir.Normalize();
+            startPos = effect_->GetEmitterSize() * dir * 0.5f;
+        }
+        break;
+
+    case EMITTER_BOX:
+        {
+            const Vector3& emitterSize = effect_->GetEmitterSize();
+            startPos = Vector3(
+                Random(emitterSize.x_) - emitterSize.x_ * 0.5f,
+                Random(emitterSize.y_) - emitterSize.y_ * 0.5f,
+                Random(emitterSize.z_) - emitterSize.z_ * 0.5f
+            );
+        }
+        break;
+
+    case EMITTER_SPHEREVOLUME:
+        {
+            Vector3 dir(
+                Random(2.0f) - 1.0f,
+                Random(2.0f) - 1.0f,
+                Random(2.0f) - 1.0f
+            );
+            dir.Normalize();
+            startPos = effect_->GetEmitterSize() * dir * Pow(Random(), 1.0f / 3.0f) * 0.5f;
+        }
+        break;
+
+    case EMITTER_CYLINDER:
+        {
+            float angle = Random(360.0f);
+            float radius = Sqrt(Random()) * 0.5f;
+            startPos = Vector3(Cos(angle) * radius, Random() - 0.5f, Sin(angle) * radius) * effect_->GetEmitterSize();
+        }
+        break;
+
+    case EMITTER_RING:
+        {
+            float angle = Random(360.0f);
+            startPos = Vector3(Cos(angle), Random(2.0f) - 1.0f, Sin(angle)) * effect_->GetEmitterSize() * 0.5f;
+        }
+        break;
+    }
+
+    if (!relative_)
+    {
+        startPos = node_->GetWorldTransform() * startPos;
+        startDir = node_->GetWorldRotation() * startDir;
+    }
+
+    const Vector3 velocity = effect_->GetRandomVelocity() * startDir;
+    const Vector2 size = effect_->GetRandomSize();
+    const float timeToLive = effect_->GetRandomTimeToLive();
+    const float rotation = effect_->GetRandomRotation();
+    const float rotationSpeed = effect_->GetRandomRotationSpeed();
+
+    const ea::vector<ColorFrame>& colorFrames = effect_->GetColorFrames();
+    const unsigned color = (colorFrames.size() ? colorFrames.front().color_ : Color::WHITE).ToUInt();
+    const ea::vector<TextureFrame>& textureFrames = effect_->GetTextureFrames();
+    const Rect& uv = textureFrames.size() ? textureFrames.front().uv_ : Rect::POSITIVE;
+
+    // Corner UVs and expansion signs per quad vertex
+    static const Vector2 cornerSigns[4] = { Vector2(-1.0f, 1.0f), Vector2(1.0f, 1.0f), Vector2(1.0f, -1.0f), Vector2(-1.0f, -1.0f) };
+    const Vector2 cornerUvs[4] = { uv.min_, Vector2(uv.max_.x_, uv.min_.y_), uv.max_, Vector2(uv.min_.x_, uv.max_.y_) };
+
+    const unsigned destIndex = spawnStaging_.size();
+    spawnStaging_.resize(destIndex + GPU_PARTICLE_QUAD_FLOATS);
+    float* dest = &spawnStaging_[destIndex];
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        dest[0] = startPos.x_;
+        dest[1] = startPos.y_;
+        dest[2] = startPos.z_;
+        dest[3] = spawnTime;
+        ((unsigned&)dest[4]) = color;
+        dest[5] = cornerUvs[i].x_;
+        dest[6] = cornerUvs[i].y_;
+        dest[7] = cornerSigns[i].x_;
+        dest[8] = cornerSigns[i].y_;
+        dest[9] = velocity.x_;
+        dest[10] = velocity.y_;
+        dest[11] = velocity.z_;
+        dest[12] = timeToLive;
+        dest[13] = size.x_;
+        dest[14] = size.y_;
+        dest[15] = rotation;
+        dest[16] = rotationSpeed;
+
+        dest += GPU_PARTICLE_VERTEX_FLOATS;
+    }
+
+    maxDeathTime_ = Max(maxDeathTime_, spawnTime + timeToLive);
+    return startPos;
+}
+
+void GpuParticleEmitter::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    if (!effect_ || !node_)
+        return;
+
+    const float timeStep = eventData[P_TIMESTEP].GetFloat();
+    Scene* scene = GetScene();
+    const float now = scene ? scene->GetElapsedTime() : 0.0f;
+
+    // Check active/inactive period switching
+    periodTimer_ += timeStep;
+    if (emitting_)
+    {
+        float activeTime = effect_->GetActiveTime();
+        if (activeTime && periodTimer_ >= activeTime)
+        {
+            emitting_ = false;
+            periodTimer_ -= activeTime;
+        }
+    }
+    else
+    {
+        float inactiveTime = effect_->GetInactiveTime();
+        if (inactiveTime && periodTimer_ >= inactiveTime)
+        {
+            emitting_ = true;
+            periodTimer_ -= inactiveTime;
+        }
+        // If emitter has an indefinite stop interval, keep period timer reset to allow restarting emission in the editor
+        if (inactiveTime == 0.0f)
+            periodTimer_ = 0.0f;
+    }
+
+    // Forget the spawn bounds once all particles are gone, so a moved emitter does not keep inflating its box
+    if (!spawnCount_ && now >= maxDeathTime_ && spawnBounds_.Defined())
+    {
+        spawnBounds_.Clear();
+        OnMarkedDirty(node_);
+    }
+
+    if (!emitting_)
+        return;
+
+    // Spawn new particles. Unlike the CPU emitter the cost is independent of the live particle count, so no
+    // per-frame cap beyond the ring capacity is needed
+    emissionTimer_ += timeStep;
+
+    float intervalMin = 1.0f / effect_->GetMaxEmissionRate();
+    float intervalMax = 1.0f / effect_->GetMinEmissionRate();
+
+    // If emission timer has a longer delay than max. interval, clamp it
+    if (emissionTimer_ < -intervalMax)
+        emissionTimer_ = -intervalMax;
+
+    unsigned counter = maxParticles_;
+    bool spawned = false;
+
+    while (emissionTimer_ > 0.0f && counter)
+    {
+        emissionTimer_ -= Lerp(intervalMin, intervalMax, Random(1.0f));
+
+        if (!spawnCount_)
+            spawnStart_ = nextParticle_;
+        else if (spawnCount_ == maxParticles_)
+        {
+            // The ring wrapped a full turn within one update; drop the oldest pending spawn
+            spawnStaging_.erase(spawnStaging_.begin(), spawnStaging_.begin() + GPU_PARTICLE_QUAD_FLOATS);
+            --spawnCount_;
+            spawnStart_ = (spawnStart_ + 1) % maxParticles_;
+        }
+
+        spawnBounds_.Merge(SpawnNewParticle(now));
+        ++spawnCount_;
+        nextParticle_ = (nextParticle_ + 1) % maxParticles_;
+
+        --counter;
+        spawned = true;
+    }
+
+    if (spawned)
+        OnMarkedDirty(node_);
+}
+
+void GpuParticleEmitter::HandleEffectReloadFinished(StringHash eventType, VariantMap& eventData)
+{
+    // When particle effect file is live-edited, remove existing particles and reapply the effect parameters
+    RemoveAllParticles();
+    UpdateMaterial();
+}
+
+}
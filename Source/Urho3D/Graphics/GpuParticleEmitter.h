@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Graphics/Drawable.h"
+
+namespace Urho3D
+{
+
+class Geometry;
+class IndexBuffer;
+class Material;
+class ParticleEffect;
+class VertexBuffer;
+
+/// GPU-simulated particle emitter component. The CPU only writes spawn data into a ring of quads; the particles are
+/// integrated analytically in the vertex shader from the %ParticleEffect parameters, so the per-frame CPU and upload
+/// cost is proportional to the emission rate instead of the live particle count. Unsupported effect features
+/// (multi-frame color and texture animation, per-frame size curves) are approximated; use %ParticleEmitter when exact
+/// CPU simulation is required.
+class URHO3D_API GpuParticleEmitter : public Drawable
+{
+    URHO3D_OBJECT(GpuParticleEmitter, Drawable);
+
+public:
+    /// Construct.
+    explicit GpuParticleEmitter(Context* context);
+    /// Destruct.
+    ~GpuParticleEmitter() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+    /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
+    void UpdateBatches(const FrameInfo& frame) override;
+    /// Prepare geometry for rendering. Called from the main view update thread.
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
+
+    /// Set particle effect.
+    void SetEffect(ParticleEffect* effect);
+    /// Set maximum number of simultaneously live particles.
+    void SetMaxParticles(unsigned num);
+    /// Set whether should be emitting. The period timer is reset on change.
+    void SetEmitting(bool enable);
+    /// Remove all current particles.
+    void RemoveAllParticles();
+
+    /// Return particle effect.
+    ParticleEffect* GetEffect() const;
+
+    /// Return maximum number of simultaneously live particles.
+    unsigned GetMaxParticles() const { return maxParticles_; }
+
+    /// Return whether is currently emitting.
+    bool IsEmitting() const { return emitting_; }
+
+    /// Set particle effect attribute.
+    void SetEffectAttr(const ResourceRef& value);
+    /// Return particle effect attribute.
+    ResourceRef GetEffectAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+
+private:
+    /// Rebuild the material from the effect material and apply the simulation shader parameters.
+    void UpdateMaterial();
+    /// Write the spawn quad of one new particle into the staging data. Return the particle position.
+    Vector3 SpawnNewParticle(float spawnTime);
+    /// Handle scene post-update event. Advances the emission timers and spawns new particles.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle live reload of the particle effect.
+    void HandleEffectReloadFinished(StringHash eventType, VariantMap& eventData);
+
+    /// Particle effect.
+    SharedPtr<ParticleEffect> effect_;
+    /// Material with the GPU simulation technique and parameters.
+    SharedPtr<Material> material_;
+    /// Geometry.
+    SharedPtr<Geometry> geometry_;
+    /// Vertex buffer holding the spawn data ring.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Index buffer.
+    SharedPtr<IndexBuffer> indexBuffer_;
+    /// World transform of the batch. Identity unless the effect is relative.
+    Matrix3x4 transform_;
+    /// Staging data of the particles spawned since the last geometry update.
+    ea::vector<float> spawnStaging_;
+    /// Maximum number of simultaneously live particles.
+    unsigned maxParticles_;
+    /// Ring cursor of the next particle slot to overwrite.
+    unsigned nextParticle_;
+    /// First ring slot written by the pending spawns.
+    unsigned spawnStart_;
+    /// Number of pending spawns.
+    unsigned spawnCount_;
+    /// Buffers need resize flag.
+    bool bufferSizeDirty_;
+    /// Currently emitting flag.
+    bool emitting_;
+    /// Relative position mode copied from the effect.
+    bool relative_;
+    /// Active/inactive period timer.
+    float periodTimer_;
+    /// New particle emission timer.
+    float emissionTimer_;
+    /// Scene time at which the newest particle dies; used to detect when all particles are gone.
+    float maxDeathTime_;
+    /// Extent added around the spawn bounds to cover particle travel over a full lifetime.
+    float boundsMargin_;
+    /// Bounding box of the live spawn positions, in emitter space.
+    BoundingBox spawnBounds_;
+};
+
+}
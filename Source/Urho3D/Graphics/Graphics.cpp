@@ -24,11 +24,13 @@
 
 #include "../Core/Profiler.h"
 #include "../Graphics/AnimatedModel.h"
+#include "../Graphics/AnimatedModelGroup.h"
 #include "../Graphics/Animation.h"
 #include "../Graphics/AnimationController.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/ConstantBuffer.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/GpuParticleEmitter.h"
 #include "../Graphics/CustomGeometry.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/DecalSet.h"
@@ -36,6 +38,8 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
+#include "../Graphics/HLODGroup.h"
+#include "../Graphics/Impostor.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/LightBaker.h"
 #include "../Graphics/LightProbeGroup.h"
@@ -44,6 +48,7 @@
 #include "../Graphics/Octree.h"
 #include "../Graphics/ParticleEffect.h"
 #include "../Graphics/ParticleEmitter.h"
+#include "../Graphics/ReflectionProbe.h"
 #include "../Graphics/RibbonTrail.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/ShaderPrecache.h"
@@ -64,6 +69,7 @@
 #include "../Graphics/Zone.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../Resource/Image.h"
 
 #include <SDL/SDL.h>
 
@@ -113,6 +119,13 @@ void Graphics::SetOrientations(const ea::string& orientations)
     SDL_SetHint(SDL_HINT_ORIENTATIONS, orientations_.c_str());
 }
 
+void Graphics::SetGPUTimingEnabled(bool enable)
+{
+    gpuTimingEnabled_ = enable && GetGPUTimingSupport();
+    if (!gpuTimingEnabled_)
+        gpuTimingResults_.clear();
+}
+
 bool Graphics::SetScreenMode(int width, int height)
 {
     return SetScreenMode(width, height, screenParams_);
@@ -613,6 +626,15 @@ void Graphics::OnScreenModeChanged()
     SendEvent(E_SCREENMODE, eventData);
 }
 
+void Graphics::SendScreenShotEvent(Image* image)
+{
+    using namespace ScreenShotReady;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_IMAGE] = image;
+    SendEvent(E_SCREENSHOTREADY, eventData);
+}
+
 void RegisterGraphicsLibrary(Context* context)
 {
     Animation::RegisterObject(context);
@@ -632,12 +654,16 @@ void RegisterGraphicsLibrary(Context* context)
     GlobalIllumination::RegisterObject(context);
     StaticModel::RegisterObject(context);
     StaticModelGroup::RegisterObject(context);
+    HLODGroup::RegisterObject(context);
     Skybox::RegisterObject(context);
     AnimatedModel::RegisterObject(context);
+    AnimatedModelGroup::RegisterObject(context);
     AnimationController::RegisterObject(context);
     BillboardSet::RegisterObject(context);
+    Impostor::RegisterObject(context);
     ParticleEffect::RegisterObject(context);
     ParticleEmitter::RegisterObject(context);
+    GpuParticleEmitter::RegisterObject(context);
     RibbonTrail::RegisterObject(context);
     CustomGeometry::RegisterObject(context);
     DecalSet::RegisterObject(context);
@@ -646,6 +672,8 @@ void RegisterGraphicsLibrary(Context* context)
     DebugRenderer::RegisterObject(context);
     Octree::RegisterObject(context);
     Zone::RegisterObject(context);
+    ReflectionProbeManager::RegisterObject(context);
+    ReflectionProbe::RegisterObject(context);
     VertexBuffer::RegisterObject(context);
     IndexBuffer::RegisterObject(context);
     Geometry::RegisterObject(context);
@@ -125,6 +125,15 @@ struct ScreenModeParams
     bool operator !=(const ScreenModeParams& rhs) const { return !(*this == rhs); }
 };
 
+/// GPU time spent in one timed render pass, resolved from timestamp queries.
+struct GPUTimingResult
+{
+    /// Name of the timed section.
+    ea::string name_;
+    /// GPU time in milliseconds.
+    float gpuTimeMs_{};
+};
+
 /// Window mode parameters.
 struct WindowModeParams
 {
@@ -179,6 +188,8 @@ public:
     void SetDither(bool enable);
     /// Set whether to flush the GPU command buffer to prevent multiple frames being queued and uneven frame timesteps. Default off, may decrease performance if enabled. Not currently implemented on OpenGL.
     void SetFlushGPU(bool enable);
+    /// Set whether to measure GPU time of timed render passes with timestamp queries. Default false. Results are read back through a ring of query objects a few frames later to avoid stalling the GPU pipeline. Effective only after the initial screen mode has been set.
+    void SetGPUTimingEnabled(bool enable);
     /// Set forced use of OpenGL 2 even if OpenGL 3 is available. Must be called before setting the screen mode for the first time. Default false. No effect on Direct3D9 & 11.
     void SetForceGL2(bool enable);
     /// Set allowed screen orientations as a space-separated list of "LandscapeLeft", "LandscapeRight", "Portrait" and "PortraitUpsideDown". Affects currently only iOS platform.
@@ -189,10 +200,16 @@ public:
     void Close();
     /// Take a screenshot. Return true if successful.
     bool TakeScreenShot(Image& destImage);
+    /// Queue an asynchronous screenshot of the backbuffer. The captured image is delivered with the E_SCREENSHOTREADY event a few frames later once the GPU has finished the transfer, without stalling the pipeline. Return false if all readback slots are still in flight. Where async readback is not supported the capture happens synchronously, but is still delivered through the event.
+    bool TakeScreenShotAsync();
     /// Begin frame rendering. Return true if device available and can render.
     bool BeginFrame();
     /// End frame rendering and swap buffers.
     void EndFrame();
+    /// Begin a GPU timed section bracketing subsequent rendering commands. Sections may not nest. No-op if GPU timing is disabled or not supported.
+    void BeginGPUTiming(const ea::string& name);
+    /// End the current GPU timed section.
+    void EndGPUTiming();
     /// Clear any or all of rendertarget, depth buffer and stencil buffer.
     void Clear(ClearTargetFlags flags, const Color& color = Color::TRANSPARENT_BLACK, float depth = 1.0f, unsigned stencil = 0);
     /// Resolve multisampled backbuffer to a texture rendertarget. The texture's size should match the viewport size.
@@ -407,6 +424,15 @@ public:
     /// Return number of batches drawn this frame.
     unsigned GetNumBatches() const { return numBatches_; }
 
+    /// Return whether GPU pass timing is enabled.
+    bool GetGPUTimingEnabled() const { return gpuTimingEnabled_; }
+
+    /// Return whether GPU timestamp queries are supported.
+    bool GetGPUTimingSupport() const;
+
+    /// Return GPU pass timings from the most recent frame whose timestamp queries have completed, in submission order.
+    const ea::vector<GPUTimingResult>& GetGPUTimings() const { return gpuTimingResults_; }
+
     /// Return dummy color texture format for shadow maps. Is "NULL" (consume no video memory) if supported.
     unsigned GetDummyColorFormat() const { return dummyColorFormat_; }
 
@@ -701,6 +727,18 @@ private:
     void PrepareDraw();
     /// Create intermediate texture for multisampled backbuffer resolve. No-op if already exists.
     void CreateResolveTexture();
+    /// Resolve completed GPU timestamp queries and rotate the query ring. Called once per frame from EndFrame().
+    void UpdateGPUTimings();
+    /// Release all GPU timestamp query objects. Called when destroying the device/context.
+    void CleanupGPUTimingQueries();
+    /// Deliver completed asynchronous screenshot readbacks in submission order. Called once per frame from EndFrame().
+    void UpdateScreenShotReadbacks();
+    /// Release asynchronous screenshot readback resources and discard pending readbacks. Called when destroying the device/context.
+    void CleanupScreenShotReadbacks();
+    /// Send the E_SCREENSHOTREADY event for a captured image.
+    void SendScreenShotEvent(Image* image);
+    /// Return an unused timestamp query object, creating one as necessary. Used only on OpenGL.
+    unsigned GetOrCreateTimingQuery();
     /// Clean up all framebuffers. Called when destroying the context. Used only on OpenGL.
     void CleanupFramebuffers();
     /// Create a framebuffer using either extension or core functionality. Used only on OpenGL.
@@ -783,6 +821,10 @@ private:
     unsigned numPrimitives_{};
     /// Number of batches this frame.
     unsigned numBatches_{};
+    /// GPU pass timing enabled flag.
+    bool gpuTimingEnabled_{};
+    /// Resolved GPU pass timings from the most recent completed frame.
+    ea::vector<GPUTimingResult> gpuTimingResults_;
     /// Largest scratch buffer request this frame.
     unsigned maxScratchBufferRequest_{};
     /// GPU objects.
@@ -57,8 +57,10 @@ extern URHO3D_API const StringHash VSP_VOFFSET("VOffset");
 extern URHO3D_API const StringHash VSP_ZONE("Zone");
 extern URHO3D_API const StringHash VSP_LIGHTMATRICES("LightMatrices");
 extern URHO3D_API const StringHash VSP_SKINMATRICES("SkinMatrices");
+extern URHO3D_API const StringHash VSP_SKINMATRIXINDEX("SkinMatrixIndex");
 extern URHO3D_API const StringHash VSP_VERTEXLIGHTS("VertexLights");
 extern URHO3D_API const StringHash VSP_LMOFFSET("LMOffset");
+extern URHO3D_API const StringHash VSP_LODMORPH("LodMorph");
 #if URHO3D_SPHERICAL_HARMONICS
 extern URHO3D_API const StringHash VSP_SHAR("SHAr");
 extern URHO3D_API const StringHash VSP_SHAG("SHAg");
@@ -130,6 +130,17 @@ enum LockState
     LOCK_SCRATCH
 };
 
+/// Vertex/index buffer CPU-side shadow data policy.
+enum ShadowDataPolicy
+{
+    /// No CPU-side copy of the buffer data.
+    SHADOW_DATA_NONE = 0,
+    /// Keep only a packed copy of vertex positions for raycasts and collision queries. Not applicable to index buffers.
+    SHADOW_DATA_POSITIONS,
+    /// Keep a full CPU-side copy of the buffer data.
+    SHADOW_DATA_FULL
+};
+
 /// Hardcoded legacy vertex elements.
 enum LegacyVertexElement
 {
@@ -407,8 +418,10 @@ extern URHO3D_API const StringHash VSP_VOFFSET;
 extern URHO3D_API const StringHash VSP_ZONE;
 extern URHO3D_API const StringHash VSP_LIGHTMATRICES;
 extern URHO3D_API const StringHash VSP_SKINMATRICES;
+extern URHO3D_API const StringHash VSP_SKINMATRIXINDEX;
 extern URHO3D_API const StringHash VSP_VERTEXLIGHTS;
 extern URHO3D_API const StringHash VSP_LMOFFSET;
+extern URHO3D_API const StringHash VSP_LODMORPH;
 #if URHO3D_SPHERICAL_HARMONICS
 extern URHO3D_API const StringHash VSP_SHAR;
 extern URHO3D_API const StringHash VSP_SHAG;
@@ -495,6 +508,7 @@ URHO3D_FLAGSET(VertexMask, VertexMaskFlags);
 static const int MAX_RENDERTARGETS = 8;
 static const int MAX_VERTEX_STREAMS = 4;
 static const int MAX_CONSTANT_REGISTERS = 256;
+static const int MAX_EXTRA_INSTANCING_BUFFER_ELEMENTS = 4;
 
 static const int BITS_PER_COMPONENT = 8;
 }
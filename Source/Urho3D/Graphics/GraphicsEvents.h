@@ -62,6 +62,12 @@ URHO3D_EVENT(E_ENDRENDERING, EndRendering)
 {
 }
 
+/// Asynchronous screenshot readback completed. Sent when the GPU has finished transferring a frame queued with TakeScreenShotAsync().
+URHO3D_EVENT(E_SCREENSHOTREADY, ScreenShotReady)
+{
+    URHO3D_PARAM(P_IMAGE, Image);                  // Image pointer
+}
+
 /// Update of a view started.
 URHO3D_EVENT(E_BEGINVIEWUPDATE, BeginViewUpdate)
 {
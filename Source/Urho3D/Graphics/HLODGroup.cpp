@@ -0,0 +1,284 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Drawable.h"
+#include "../Graphics/HLODGroup.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/Viewport.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+static const StringVector sourceNodesStructureElementNames =
+{
+    "Source Count",
+    "   NodeID"
+};
+
+HLODGroup::HLODGroup(Context* context) :
+    Component(context)
+{
+}
+
+HLODGroup::~HLODGroup()
+{
+    // Make sure the source drawables are not left hidden
+    if (useProxy_)
+        ApplyVisibility(false);
+}
+
+void HLODGroup::RegisterObject(Context* context)
+{
+    context->RegisterFactory<HLODGroup>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Distance", GetDistance, SetDistance, float, 200.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Hysteresis", GetHysteresis, SetHysteresis, float, 0.1f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Proxy Node", GetProxyNodeIDAttr, SetProxyNodeIDAttr, unsigned, 0, AM_DEFAULT | AM_NODEID);
+    URHO3D_ACCESSOR_ATTRIBUTE("Source Nodes", GetNodeIDsAttr, SetNodeIDsAttr,
+        VariantVector, Variant::emptyVariantVector, AM_DEFAULT | AM_NODEIDVECTOR)
+        .SetMetadata(AttributeMetadata::P_VECTOR_STRUCT_ELEMENTS, sourceNodesStructureElementNames);
+}
+
+void HLODGroup::ApplyAttributes()
+{
+    if (!nodesDirty_)
+        return;
+
+    sourceNodes_.clear();
+    proxyNode_.Reset();
+
+    Scene* scene = GetScene();
+    if (scene)
+    {
+        proxyNode_ = scene->GetNode(proxyNodeIDAttr_);
+
+        // The first index stores the number of IDs redundantly. This is for editing
+        for (unsigned i = 1; i < nodeIDsAttr_.size(); ++i)
+        {
+            Node* node = scene->GetNode(nodeIDsAttr_[i].GetUInt());
+            if (node)
+                sourceNodes_.push_back(WeakPtr<Node>(node));
+        }
+    }
+
+    nodesDirty_ = false;
+
+    // Start from the source state; the next scene update re-evaluates the distance
+    useProxy_ = false;
+    ApplyVisibility(false);
+}
+
+void HLODGroup::SetProxyNode(Node* node)
+{
+    if (useProxy_)
+        ApplyVisibility(false);
+
+    proxyNode_ = node;
+    nodeIDsDirty_ = true;
+    MarkNetworkUpdate();
+}
+
+void HLODGroup::AddSourceNode(Node* node)
+{
+    if (!node || sourceNodes_.contains(WeakPtr<Node>(node)))
+        return;
+
+    sourceNodes_.push_back(WeakPtr<Node>(node));
+    nodeIDsDirty_ = true;
+    MarkNetworkUpdate();
+}
+
+void HLODGroup::RemoveSourceNode(Node* node)
+{
+    if (!node)
+        return;
+
+    sourceNodes_.erase_first(WeakPtr<Node>(node));
+    nodeIDsDirty_ = true;
+    MarkNetworkUpdate();
+}
+
+void HLODGroup::RemoveAllSourceNodes()
+{
+    if (useProxy_)
+        ApplyVisibility(false);
+
+    sourceNodes_.clear();
+    nodeIDsDirty_ = true;
+    MarkNetworkUpdate();
+}
+
+void HLODGroup::SetDistance(float distance)
+{
+    distance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void HLODGroup::SetHysteresis(float hysteresis)
+{
+    hysteresis_ = Clamp(hysteresis, 0.0f, 1.0f);
+    MarkNetworkUpdate();
+}
+
+Node* HLODGroup::GetSourceNode(unsigned index) const
+{
+    return index < sourceNodes_.size() ? sourceNodes_[index] : nullptr;
+}
+
+void HLODGroup::SetProxyNodeIDAttr(unsigned value)
+{
+    proxyNodeIDAttr_ = value;
+    nodesDirty_ = true;
+    nodeIDsDirty_ = false;
+}
+
+unsigned HLODGroup::GetProxyNodeIDAttr() const
+{
+    if (nodeIDsDirty_)
+        proxyNodeIDAttr_ = proxyNode_ ? proxyNode_->GetID() : 0;
+
+    return proxyNodeIDAttr_;
+}
+
+void HLODGroup::SetNodeIDsAttr(const VariantVector& value)
+{
+    // Just remember the node IDs. They need to go through the SceneResolver, and we actually find the nodes during
+    // ApplyAttributes()
+    if (value.size())
+    {
+        nodeIDsAttr_.clear();
+
+        unsigned index = 0;
+        unsigned numSources = value[index++].GetUInt();
+        // Prevent crash on entering negative value in the editor
+        if (numSources > M_MAX_INT)
+            numSources = 0;
+
+        nodeIDsAttr_.push_back(numSources);
+        while (numSources--)
+        {
+            // If vector contains less IDs than should, fill the rest with zeroes
+            if (index < value.size())
+                nodeIDsAttr_.push_back(value[index++].GetUInt());
+            else
+                nodeIDsAttr_.push_back(0);
+        }
+    }
+    else
+    {
+        nodeIDsAttr_.clear();
+        nodeIDsAttr_.push_back(0);
+    }
+
+    nodesDirty_ = true;
+    nodeIDsDirty_ = false;
+}
+
+const VariantVector& HLODGroup::GetNodeIDsAttr() const
+{
+    if (nodeIDsDirty_)
+    {
+        nodeIDsAttr_.clear();
+        nodeIDsAttr_.push_back((unsigned)sourceNodes_.size());
+        for (const WeakPtr<Node>& node : sourceNodes_)
+            nodeIDsAttr_.push_back(node ? node->GetID() : 0);
+        nodeIDsDirty_ = false;
+    }
+
+    return nodeIDsAttr_;
+}
+
+void HLODGroup::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(HLODGroup, HandleSceneUpdate));
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+        if (useProxy_)
+            ApplyVisibility(false);
+    }
+}
+
+void HLODGroup::OnSetEnabled()
+{
+    // When disabled, fall back to the full-detail source nodes
+    if (!IsEnabledEffective() && useProxy_)
+        ApplyVisibility(false);
+}
+
+void HLODGroup::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsEnabledEffective() || !node_)
+        return;
+
+    auto* renderer = GetSubsystem<Renderer>();
+    if (!renderer)
+        return;
+
+    Viewport* viewport = renderer->GetViewportForScene(GetScene(), 0);
+    Camera* camera = viewport ? viewport->GetCamera() : nullptr;
+    if (!camera || !camera->GetNode())
+        return;
+
+    const float distance = (camera->GetNode()->GetWorldPosition() - node_->GetWorldPosition()).Length();
+
+    // Switch to the proxy beyond the distance and back slightly below it to avoid flickering at the threshold
+    if (!useProxy_ && distance > distance_)
+        ApplyVisibility(true);
+    else if (useProxy_ && distance < distance_ * (1.0f - hysteresis_))
+        ApplyVisibility(false);
+}
+
+void HLODGroup::ApplyVisibility(bool useProxy)
+{
+    useProxy_ = useProxy;
+
+    if (proxyNode_)
+        proxyNode_->SetEnabled(useProxy);
+
+    // Toggle only the drawables so that logic components on the source nodes keep running
+    ea::vector<Drawable*> drawables;
+    for (const WeakPtr<Node>& node : sourceNodes_)
+    {
+        if (!node)
+            continue;
+
+        node->GetDerivedComponents<Drawable>(drawables, true);
+        for (Drawable* drawable : drawables)
+            drawable->SetEnabled(!useProxy);
+    }
+}
+
+}
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Scene/Component.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Hierarchical LOD group. Swaps a set of source scene nodes for a single merged proxy node beyond a distance
+/// threshold, collapsing many distant draw calls into one. Groups are typically created offline by HLODBaker.
+class URHO3D_API HLODGroup : public Component
+{
+    URHO3D_OBJECT(HLODGroup, Component);
+
+public:
+    /// Construct.
+    explicit HLODGroup(Context* context);
+    /// Destruct.
+    ~HLODGroup() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
+    void ApplyAttributes() override;
+
+    /// Set the proxy scene node containing the merged stand-in geometry.
+    void SetProxyNode(Node* node);
+    /// Add a source scene node. Its drawables are hidden while the proxy is shown.
+    void AddSourceNode(Node* node);
+    /// Remove a source scene node.
+    void RemoveSourceNode(Node* node);
+    /// Remove all source scene nodes.
+    void RemoveAllSourceNodes();
+    /// Set the camera distance beyond which the proxy is shown.
+    void SetDistance(float distance);
+    /// Set switch hysteresis as a fraction of the distance. Prevents flickering at the threshold.
+    void SetHysteresis(float hysteresis);
+
+    /// Return the proxy scene node.
+    Node* GetProxyNode() const { return proxyNode_; }
+
+    /// Return number of source nodes.
+    unsigned GetNumSourceNodes() const { return sourceNodes_.size(); }
+
+    /// Return source node by index.
+    Node* GetSourceNode(unsigned index) const;
+
+    /// Return the camera distance beyond which the proxy is shown.
+    float GetDistance() const { return distance_; }
+
+    /// Return switch hysteresis fraction.
+    float GetHysteresis() const { return hysteresis_; }
+
+    /// Return whether the proxy is currently shown instead of the source nodes.
+    bool IsUsingProxy() const { return useProxy_; }
+
+    /// Set proxy node ID attribute.
+    void SetProxyNodeIDAttr(unsigned value);
+    /// Return proxy node ID attribute.
+    unsigned GetProxyNodeIDAttr() const;
+    /// Set source node IDs attribute.
+    void SetNodeIDsAttr(const VariantVector& value);
+    /// Return source node IDs attribute.
+    const VariantVector& GetNodeIDsAttr() const;
+
+protected:
+    /// Handle scene being assigned. Subscribe to scene update for distance evaluation.
+    void OnSceneSet(Scene* scene) override;
+    /// Handle enabled/disabled state change. Restores source visibility when disabled.
+    void OnSetEnabled() override;
+
+private:
+    /// Handle scene update. Evaluates camera distance and switches between sources and proxy.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    /// Show either the proxy or the source nodes' drawables.
+    void ApplyVisibility(bool useProxy);
+
+    /// Proxy node with the merged geometry.
+    WeakPtr<Node> proxyNode_;
+    /// Source nodes.
+    ea::vector<WeakPtr<Node> > sourceNodes_;
+    /// Node IDs for serialization.
+    mutable VariantVector nodeIDsAttr_;
+    /// Proxy node ID for serialization.
+    mutable unsigned proxyNodeIDAttr_{};
+    /// Switch distance.
+    float distance_{200.0f};
+    /// Switch hysteresis fraction.
+    float hysteresis_{0.1f};
+    /// Whether the proxy is currently shown.
+    bool useProxy_{};
+    /// Whether node IDs have been set and nodes should be searched for during ApplyAttributes.
+    mutable bool nodesDirty_{};
+    /// Whether nodes have been manipulated by the API and node ID attributes should be refreshed.
+    mutable bool nodeIDsDirty_{};
+};
+
+}
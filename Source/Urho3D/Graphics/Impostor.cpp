@@ -0,0 +1,212 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/BillboardSet.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Impostor.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/StaticModel.h"
+#include "../Graphics/Viewport.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+Impostor::Impostor(Context* context) :
+    Component(context)
+{
+}
+
+Impostor::~Impostor() = default;
+
+void Impostor::RegisterObject(Context* context)
+{
+    context->RegisterFactory<Impostor>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef,
+        ResourceRef(Material::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Num Angles", GetNumAngles, SetNumAngles, unsigned, 8, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Distance", GetDistance, SetDistance, float, 100.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Fade Distance", GetFadeDistance, SetFadeDistance, float, 10.0f, AM_DEFAULT);
+}
+
+void Impostor::SetMaterial(Material* material)
+{
+    material_ = material;
+    if (billboardSet_)
+        billboardSet_->SetMaterial(material);
+    MarkNetworkUpdate();
+}
+
+void Impostor::SetNumAngles(unsigned numAngles)
+{
+    numAngles_ = Max(numAngles, 1U);
+    MarkNetworkUpdate();
+}
+
+void Impostor::SetDistance(float distance)
+{
+    distance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void Impostor::SetFadeDistance(float fadeDistance)
+{
+    fadeDistance_ = Max(fadeDistance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+Material* Impostor::GetMaterial() const
+{
+    return material_;
+}
+
+void Impostor::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+ResourceRef Impostor::GetMaterialAttr() const
+{
+    return GetResourceRef(material_, Material::GetTypeStatic());
+}
+
+void Impostor::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(Impostor, HandleSceneUpdate));
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+        UpdateImpostor(nullptr, 0.0f);
+    }
+}
+
+void Impostor::OnSetEnabled()
+{
+    // When disabled, fall back to the full-detail model
+    if (!IsEnabledEffective())
+        UpdateImpostor(nullptr, 0.0f);
+}
+
+void Impostor::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsEnabledEffective() || !node_)
+        return;
+
+    auto* renderer = GetSubsystem<Renderer>();
+    if (!renderer)
+        return;
+
+    Viewport* viewport = renderer->GetViewportForScene(GetScene(), 0);
+    Camera* camera = viewport ? viewport->GetCamera() : nullptr;
+    if (!camera || !camera->GetNode())
+        return;
+
+    const float distance = (camera->GetNode()->GetWorldPosition() - node_->GetWorldPosition()).Length();
+    const float fade = Clamp((distance - (distance_ - fadeDistance_)) / Max(fadeDistance_, M_EPSILON), 0.0f, 1.0f);
+    UpdateImpostor(camera, fade);
+}
+
+void Impostor::UpdateImpostor(Camera* camera, float fade)
+{
+    auto* staticModel = node_ ? node_->GetComponent<StaticModel>() : nullptr;
+
+    if (fade <= 0.0f)
+    {
+        if (billboardSet_)
+            billboardSet_->SetEnabled(false);
+        if (staticModel)
+            staticModel->SetEnabled(true);
+        return;
+    }
+
+    BillboardSet* billboardSet = GetOrCreateBillboardSet();
+    if (!billboardSet)
+        return;
+
+    billboardSet->SetEnabled(true);
+    // The billboard alpha-fades in over the fade band; the model is switched off only once the fade is complete
+    if (staticModel)
+        staticModel->SetEnabled(fade < 1.0f);
+
+    Billboard* billboard = billboardSet->GetBillboard(0);
+    const BoundingBox boundingBox = staticModel && staticModel->GetModel() ?
+        staticModel->GetModel()->GetBoundingBox() : BoundingBox(-0.5f, 0.5f);
+    const Vector3 halfSize = boundingBox.HalfSize();
+    billboard->enabled_ = true;
+    billboard->position_ = boundingBox.Center();
+    billboard->size_ = Vector2(Max(halfSize.x_, halfSize.z_), halfSize.y_);
+    billboard->color_ = Color(1.0f, 1.0f, 1.0f, fade);
+
+    // Select the atlas frame matching the camera azimuth in node space. Frames are laid out in a row-major
+    // square grid in azimuth order starting from the +Z view, as baked by ImpostorBaker.
+    const Vector3 cameraDirection = camera ?
+        node_->GetWorldRotation().Inverse() * (camera->GetNode()->GetWorldPosition() - node_->GetWorldPosition()) :
+        Vector3::FORWARD;
+    float azimuth = Atan2(cameraDirection.x_, cameraDirection.z_);
+    if (azimuth < 0.0f)
+        azimuth += 360.0f;
+    const unsigned frame = static_cast<unsigned>(RoundToInt(azimuth * numAngles_ / 360.0f)) % numAngles_;
+
+    const unsigned numColumns = static_cast<unsigned>(Ceil(Sqrt(static_cast<float>(numAngles_))));
+    const unsigned numRows = (numAngles_ + numColumns - 1) / numColumns;
+    const float frameWidth = 1.0f / numColumns;
+    const float frameHeight = 1.0f / numRows;
+    const float u = (frame % numColumns) * frameWidth;
+    const float v = (frame / numColumns) * frameHeight;
+    billboard->uv_ = Rect(u, v, u + frameWidth, v + frameHeight);
+
+    billboardSet->Commit();
+}
+
+BillboardSet* Impostor::GetOrCreateBillboardSet()
+{
+    if (billboardSet_)
+        return billboardSet_;
+    if (!node_)
+        return nullptr;
+
+    auto* billboardSet = node_->CreateComponent<BillboardSet>();
+    billboardSet->SetTemporary(true);
+    billboardSet->SetNumBillboards(1);
+    billboardSet->SetMaterial(material_);
+    billboardSet->SetEnabled(false);
+    billboardSet_ = billboardSet;
+    return billboardSet;
+}
+
+}
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class BillboardSet;
+class Camera;
+class Material;
+class StaticModel;
+
+/// Replaces the node's StaticModel with a single pre-baked billboard beyond a distance threshold. The billboard
+/// frame is selected from an impostor atlas by camera azimuth; atlases are generated offline by ImpostorBaker.
+/// The billboard alpha-fades in over the fade band before the model is switched off.
+class URHO3D_API Impostor : public Component
+{
+    URHO3D_OBJECT(Impostor, Component);
+
+public:
+    /// Construct.
+    explicit Impostor(Context* context);
+    /// Destruct.
+    ~Impostor() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Set impostor material. Expected to use the atlas texture with an alpha-blended technique.
+    void SetMaterial(Material* material);
+    /// Set number of horizontal view angles in the atlas. Must match the baking settings.
+    void SetNumAngles(unsigned numAngles);
+    /// Set the camera distance beyond which the impostor is fully shown.
+    void SetDistance(float distance);
+    /// Set the width of the fade band before the distance threshold.
+    void SetFadeDistance(float fadeDistance);
+
+    /// Return impostor material.
+    Material* GetMaterial() const;
+
+    /// Return number of horizontal view angles in the atlas.
+    unsigned GetNumAngles() const { return numAngles_; }
+
+    /// Return the camera distance beyond which the impostor is fully shown.
+    float GetDistance() const { return distance_; }
+
+    /// Return the width of the fade band.
+    float GetFadeDistance() const { return fadeDistance_; }
+
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+
+protected:
+    /// Handle scene being assigned. Subscribe to scene update for distance evaluation.
+    void OnSceneSet(Scene* scene) override;
+    /// Handle enabled/disabled state change. Restores the model when disabled.
+    void OnSetEnabled() override;
+
+private:
+    /// Handle scene update. Evaluates camera distance and updates the billboard.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    /// Update the billboard frame, size and fade for given camera. Pass zero fade to hide the impostor.
+    void UpdateImpostor(Camera* camera, float fade);
+    /// Return the internal billboard set, creating it on first use.
+    BillboardSet* GetOrCreateBillboardSet();
+
+    /// Impostor material.
+    SharedPtr<Material> material_;
+    /// Internal billboard set. Created on demand and not serialized.
+    WeakPtr<BillboardSet> billboardSet_;
+    /// Number of horizontal view angles in the atlas.
+    unsigned numAngles_{8};
+    /// Distance beyond which the impostor is fully shown.
+    float distance_{100.0f};
+    /// Width of the fade band.
+    float fadeDistance_{10.0f};
+};
+
+}
@@ -81,6 +81,30 @@ void IndexBuffer::SetShadowed(bool enable)
     }
 }
 
+bool IndexBuffer::EnsureShadowData() const
+{
+    if (shadowData_)
+        return true;
+    if (!indexCount_ || !indexSize_)
+        return false;
+
+    ea::shared_array<unsigned char> data(new unsigned char[(size_t)indexCount_ * indexSize_]);
+    if (!GetData(data.get()))
+        return false;
+
+    shadowData_ = data;
+    return true;
+}
+
+bool IndexBuffer::SetData(const ea::shared_array<unsigned char>& data)
+{
+    // Adopt the array as the shadow copy; SetData() skips the shadow memcpy when given the shadow data itself
+    if (shadowed_ && data && indexCount_ && indexSize_)
+        shadowData_ = data;
+
+    return SetData(data.get());
+}
+
 bool IndexBuffer::SetSize(unsigned indexCount, bool largeIndices, bool dynamic)
 {
     Unlock();
@@ -99,7 +123,7 @@ bool IndexBuffer::SetSize(unsigned indexCount, bool largeIndices, bool dynamic)
 
 bool IndexBuffer::GetUsedVertexRange(unsigned start, unsigned count, unsigned& minVertex, unsigned& vertexCount)
 {
-    if (!shadowData_)
+    if (!EnsureShadowData())
     {
         URHO3D_LOGERROR("Used vertex range can only be queried from an index buffer with shadow data");
         return false;
@@ -145,7 +169,7 @@ bool IndexBuffer::GetUsedVertexRange(unsigned start, unsigned count, unsigned& m
 
 ea::vector<unsigned> IndexBuffer::GetUnpackedData(unsigned start, unsigned count) const
 {
-    if (start >= indexCount_ || count == 0 || !IsShadowed())
+    if (start >= indexCount_ || count == 0 || !EnsureShadowData())
         return {};
 
     // Clamp count to index buffer size.
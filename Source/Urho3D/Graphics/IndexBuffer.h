@@ -60,6 +60,8 @@ public:
     bool SetSize(unsigned indexCount, bool largeIndices, bool dynamic = false);
     /// Set all data in the buffer.
     bool SetData(const void* data);
+    /// Set all data in the buffer, adopting the array as the shadow copy instead of copying it when shadowing is enabled.
+    bool SetData(const ea::shared_array<unsigned char>& data);
     /// Set a data range in the buffer. Optionally discard data outside the range.
     bool SetDataRange(const void* data, unsigned start, unsigned count, bool discard = false);
     /// Lock the buffer for write-only editing. Return data pointer if successful. Optionally discard data outside the range.
@@ -67,6 +69,12 @@ public:
     /// Unlock the buffer and apply changes to the GPU buffer.
     void Unlock();
 
+    /// Read the buffer data back from the GPU into the destination. Potentially slow; not supported on OpenGL ES.
+    bool GetData(void* dest) const;
+    /// Populate the shadow data by reading back from the GPU if it does not exist yet. The copy is kept until
+    /// the buffer is resized. Return true if shadow data is available.
+    bool EnsureShadowData() const;
+
     /// Return whether CPU memory shadowing is enabled.
     bool IsShadowed() const { return shadowed_; }
 
@@ -113,8 +121,8 @@ private:
     /// Unmap the GPU buffer. Not used on OpenGL.
     void UnmapBuffer();
 
-    /// Shadow data.
-    ea::shared_array<unsigned char> shadowData_;
+    /// Shadow data. Mutable to allow lazily populated readback.
+    mutable ea::shared_array<unsigned char> shadowData_;
     /// Number of indices.
     unsigned indexCount_;
     /// Index size.
@@ -133,6 +133,9 @@ struct EdgeStoppingGaussFilterParameters
     int kernelRadius_{ 2 };
     /// Upscale factor for offsets.
     int upscale_{ 1 };
+    /// Number of denoise iterations. The kernel step doubles every iteration (a-trous wavelet filtering),
+    /// so few iterations of a small kernel cover a large effective radius without smearing across edges.
+    unsigned numIterations_{ 1 };
     /// Color weight. The lesser value is, the more color details are preserved on flat surface.
     float luminanceSigma_{ 10.0f };
     /// Normal weight. The higher value is, the more color details are preserved on normal edges.
@@ -26,6 +26,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
 #include "../Core/Thread.h"
 #include "../Graphics/Graphics.h"
@@ -53,6 +54,26 @@ namespace Urho3D
 
 extern const char* wrapModeNames[];
 
+/// Registry of shared material parameter blocks, keyed by parameter data hash.
+static ea::unordered_map<unsigned, WeakPtr<MaterialParameterBlock> > parameterBlockRegistry;
+/// Mutex for the shared parameter block registry.
+static Mutex parameterBlockRegistryMutex;
+
+/// Return a shared parameter block identical to the given one, registering the given block if none exists yet.
+static SharedPtr<MaterialParameterBlock> GetOrRegisterParameterBlock(const SharedPtr<MaterialParameterBlock>& block)
+{
+    MutexLock lock(parameterBlockRegistryMutex);
+
+    WeakPtr<MaterialParameterBlock>& registered = parameterBlockRegistry[block->hash_];
+    SharedPtr<MaterialParameterBlock> existing = registered.Lock();
+    // Share only on exact match to guard against hash collisions
+    if (existing && existing->parameters_ == block->parameters_)
+        return existing;
+
+    registered = block;
+    return block;
+}
+
 TextureUnit ParseTextureUnitName(ea::string name)
 {
     name.make_lower();
@@ -233,7 +254,8 @@ bool Material::EndLoad()
 
 bool Material::BeginLoadXML(Deserializer& source)
 {
-    ResetToDefaults();
+    // Do not reset yet: if this is a reload, Load() may be able to patch the material in place,
+    // and a reload that fails to parse should not destroy the current state either
     loadXMLFile_ = context_->CreateObject<XMLFile>();
     if (loadXMLFile_->Load(source))
     {
@@ -288,8 +310,7 @@ bool Material::BeginLoadXML(Deserializer& source)
 
 bool Material::BeginLoadJSON(Deserializer& source)
 {
-    // Attempt to load a JSON file
-    ResetToDefaults();
+    // Attempt to load a JSON file. As with XML, do not reset the current state yet
     loadXMLFile_.Reset();
 
     // Attempt to load from JSON file instead
@@ -358,26 +379,30 @@ bool Material::Save(Serializer& dest) const
 
 bool Material::Load(const XMLElement& source)
 {
-    ResetToDefaults();
-
     if (source.IsNull())
     {
+        ResetToDefaults();
         URHO3D_LOGERROR("Can not load material from null XML element");
         return false;
     }
 
     auto* cache = GetSubsystem<ResourceCache>();
 
+    // Parse the shader defines and technique entries up front. A reload that keeps the technique topology (the same
+    // techniques with the same defines) is patched in place: parameters, textures and render states are re-applied
+    // without recreating the techniques, so cached technique resolutions of drawables using this material stay
+    // valid and no shader variations need reloading
+    ea::string vertexShaderDefines;
+    ea::string pixelShaderDefines;
     XMLElement shaderElem = source.GetChild("shader");
     if (shaderElem)
     {
-        vertexShaderDefines_ = shaderElem.GetAttribute("vsdefines");
-        pixelShaderDefines_ = shaderElem.GetAttribute("psdefines");
+        vertexShaderDefines = shaderElem.GetAttribute("vsdefines");
+        pixelShaderDefines = shaderElem.GetAttribute("psdefines");
     }
 
+    ea::vector<TechniqueEntry> techniques;
     XMLElement techniqueElem = source.GetChild("technique");
-    techniques_.clear();
-
     while (techniqueElem)
     {
         auto* tech = cache->GetResource<Technique>(techniqueElem.GetAttribute("name"));
@@ -389,14 +414,22 @@ bool Material::Load(const XMLElement& source)
                 newTechnique.qualityLevel_ = (MaterialQuality)techniqueElem.GetInt("quality");
             if (techniqueElem.HasAttribute("loddistance"))
                 newTechnique.lodDistance_ = techniqueElem.GetFloat("loddistance");
-            techniques_.push_back(newTechnique);
+            techniques.push_back(newTechnique);
         }
 
         techniqueElem = techniqueElem.GetNext("technique");
     }
 
-    SortTechniques();
-    ApplyShaderDefines();
+    if (!BeginPatchLoad(techniques, vertexShaderDefines, pixelShaderDefines))
+    {
+        ResetToDefaults();
+
+        vertexShaderDefines_ = vertexShaderDefines;
+        pixelShaderDefines_ = pixelShaderDefines;
+        techniques_ = ea::move(techniques);
+        SortTechniques();
+        ApplyShaderDefines();
+    }
 
     XMLElement textureElem = source.GetChild("texture");
     while (textureElem)
@@ -509,27 +542,30 @@ bool Material::Load(const XMLElement& source)
 
 bool Material::Load(const JSONValue& source)
 {
-    ResetToDefaults();
-
     if (source.IsNull())
     {
+        ResetToDefaults();
         URHO3D_LOGERROR("Can not load material from null JSON element");
         return false;
     }
 
     auto* cache = GetSubsystem<ResourceCache>();
 
+    // Parse the shader defines and technique entries up front so that a topology-preserving reload can be patched
+    // in place, as in the XML variant above
+    ea::string vertexShaderDefines;
+    ea::string pixelShaderDefines;
     const JSONValue& shaderVal = source.Get("shader");
     if (!shaderVal.IsNull())
     {
-        vertexShaderDefines_ = shaderVal.Get("vsdefines").GetString();
-        pixelShaderDefines_ = shaderVal.Get("psdefines").GetString();
+        vertexShaderDefines = shaderVal.Get("vsdefines").GetString();
+        pixelShaderDefines = shaderVal.Get("psdefines").GetString();
     }
 
     // Load techniques
     JSONArray techniquesArray = source.Get("techniques").GetArray();
-    techniques_.clear();
-    techniques_.reserve(techniquesArray.size());
+    ea::vector<TechniqueEntry> techniques;
+    techniques.reserve(techniquesArray.size());
 
     for (unsigned i = 0; i < techniquesArray.size(); i++)
     {
@@ -545,12 +581,20 @@ bool Material::Load(const JSONValue& source)
             JSONValue lodDistanceVal = techVal.Get("loddistance");
             if (!lodDistanceVal.IsNull())
                 newTechnique.lodDistance_ = lodDistanceVal.GetFloat();
-            techniques_.push_back(newTechnique);
+            techniques.push_back(newTechnique);
         }
     }
 
-    SortTechniques();
-    ApplyShaderDefines();
+    if (!BeginPatchLoad(techniques, vertexShaderDefines, pixelShaderDefines))
+    {
+        ResetToDefaults();
+
+        vertexShaderDefines_ = vertexShaderDefines;
+        pixelShaderDefines_ = pixelShaderDefines;
+        techniques_ = ea::move(techniques);
+        SortTechniques();
+        ApplyShaderDefines();
+    }
 
     // Load textures
     JSONObject textureObject = source.Get("textures").GetObject();
@@ -883,6 +927,7 @@ void Material::SetNumTechniques(unsigned num)
         return;
 
     techniques_.resize(num);
+    ++techniquesVersion_;
     RefreshMemoryUse();
 }
 
@@ -892,6 +937,7 @@ void Material::SetTechnique(unsigned index, Technique* tech, MaterialQuality qua
         return;
 
     techniques_[index] = TechniqueEntry(tech, qualityLevel, lodDistance);
+    ++techniquesVersion_;
     ApplyShaderDefines(index);
 }
 
@@ -1134,6 +1180,7 @@ SharedPtr<Material> Material::Clone(const ea::string& cloneName) const
 void Material::SortTechniques()
 {
     ea::quick_sort(techniques_.begin(), techniques_.end(), CompareTechniqueEntries);
+    ++techniquesVersion_;
 }
 
 void Material::MarkForAuxView(unsigned frameNumber)
@@ -1141,6 +1188,19 @@ void Material::MarkForAuxView(unsigned frameNumber)
     auxViewFrameNumber_ = frameNumber;
 }
 
+void Material::MarkTexturesUsed(unsigned frameNumber)
+{
+    if (frameNumber == texturesUseFrameNumber_)
+        return;
+    texturesUseFrameNumber_ = frameNumber;
+
+    for (auto i = textures_.begin(); i != textures_.end(); ++i)
+    {
+        if (i->second)
+            i->second->MarkUse(frameNumber);
+    }
+}
+
 const TechniqueEntry& Material::GetTechniqueEntry(unsigned index) const
 {
     return index < techniques_.size() ? techniques_[index] : noEntry;
@@ -1220,6 +1280,14 @@ void Material::ResetToDefaults()
     SetTechnique(0, renderer ? renderer->GetDefaultTechnique() :
         GetSubsystem<ResourceCache>()->GetResource<Technique>("Techniques/NoTexture.xml"));
 
+    ResetShaderParametersAndStates();
+
+    RefreshShaderParameterHash();
+    RefreshMemoryUse();
+}
+
+void Material::ResetShaderParametersAndStates()
+{
     textures_.clear();
 
     batchedParameterUpdate_ = true;
@@ -1240,19 +1308,56 @@ void Material::ResetToDefaults()
     depthBias_ = BiasParameters(0.0f, 0.0f);
     renderOrder_ = DEFAULT_RENDER_ORDER;
     occlusion_ = true;
+}
 
-    RefreshShaderParameterHash();
-    RefreshMemoryUse();
+bool Material::BeginPatchLoad(const ea::vector<TechniqueEntry>& techniques, const ea::string& vertexShaderDefines,
+    const ea::string& pixelShaderDefines)
+{
+    if (!Thread::IsMainThread())
+        return false;
+
+    // Only a reload of an already loaded material can be patched
+    if (techniques.empty() || techniques_.empty())
+        return false;
+
+    if (vertexShaderDefines != vertexShaderDefines_ || pixelShaderDefines != pixelShaderDefines_)
+        return false;
+
+    // The technique entries must match the current ones exactly after sorting
+    ea::vector<TechniqueEntry> sortedTechniques = techniques;
+    ea::quick_sort(sortedTechniques.begin(), sortedTechniques.end(), CompareTechniqueEntries);
+    if (sortedTechniques.size() != techniques_.size())
+        return false;
+    for (unsigned i = 0; i < sortedTechniques.size(); ++i)
+    {
+        const TechniqueEntry& newEntry = sortedTechniques[i];
+        const TechniqueEntry& oldEntry = techniques_[i];
+        if (newEntry.original_ != oldEntry.original_ || newEntry.qualityLevel_ != oldEntry.qualityLevel_ ||
+            newEntry.lodDistance_ != oldEntry.lodDistance_)
+            return false;
+    }
+
+    // Reset everything except the techniques, the rest of the load re-applies it from the file
+    ResetShaderParametersAndStates();
+    return true;
 }
 
 void Material::RefreshShaderParameterHash()
 {
-    VectorBuffer temp;
+    // Compile the parameters into an ordered block so that batch preparation can apply them with a flat walk
+    SharedPtr<MaterialParameterBlock> block(new MaterialParameterBlock());
+    block->parameters_.reserve(shaderParameters_.size());
     for (auto i = shaderParameters_.begin();
          i != shaderParameters_.end(); ++i)
+        block->parameters_.emplace_back(i->first, i->second.value_);
+    ea::quick_sort(block->parameters_.begin(), block->parameters_.end(),
+        [](const ea::pair<StringHash, Variant>& lhs, const ea::pair<StringHash, Variant>& rhs) { return lhs.first < rhs.first; });
+
+    VectorBuffer temp;
+    for (unsigned i = 0; i < block->parameters_.size(); ++i)
     {
-        temp.WriteStringHash(i->first);
-        temp.WriteVariant(i->second.value_);
+        temp.WriteStringHash(block->parameters_[i].first);
+        temp.WriteVariant(block->parameters_[i].second);
     }
 
     shaderParameterHash_ = 0;
@@ -1260,6 +1365,10 @@ void Material::RefreshShaderParameterHash()
     unsigned dataSize = temp.GetSize();
     for (unsigned i = 0; i < dataSize; ++i)
         shaderParameterHash_ = SDBMHash(shaderParameterHash_, data[i]);
+
+    // Deduplicate identical blocks across material instances so that state sharing detection is pointer equality
+    block->hash_ = shaderParameterHash_;
+    shaderParameterBlock_ = GetOrRegisterParameterBlock(block);
 }
 
 void Material::RefreshMemoryUse()
@@ -1343,6 +1452,8 @@ void Material::ApplyShaderDefines(unsigned index)
         techniques_[index].technique_ = techniques_[index].original_;
     else
         techniques_[index].technique_ = techniques_[index].original_->CloneWithDefines(vertexShaderDefines_, pixelShaderDefines_);
+
+    ++techniquesVersion_;
 }
 
 }
@@ -96,6 +96,17 @@ struct MaterialShaderParameter
     Variant value_;
 };
 
+/// Compiled block of material shader parameters, ordered by parameter name hash. Identical blocks are shared
+/// between material instances, so identical parameter state implies pointer equality.
+class URHO3D_API MaterialParameterBlock : public RefCounted
+{
+public:
+    /// Parameters sorted by name hash.
+    ea::vector<ea::pair<StringHash, Variant> > parameters_;
+    /// SDBM hash of the parameter data.
+    unsigned hash_{};
+};
+
 /// %Material's technique list entry.
 struct URHO3D_API TechniqueEntry
 {
@@ -233,6 +244,8 @@ public:
     void SortTechniques();
     /// Mark material for auxiliary view rendering.
     void MarkForAuxView(unsigned frameNumber);
+    /// Mark the material's textures as rendered on a frame. Used for texture streaming decisions.
+    void MarkTexturesUsed(unsigned frameNumber);
 
     /// Return number of techniques.
     unsigned GetNumTechniques() const { return techniques_.size(); }
@@ -240,6 +253,9 @@ public:
     /// Return all techniques.
     const ea::vector<TechniqueEntry>& GetTechniques() const { return techniques_; }
 
+    /// Return technique list version number, incremented whenever the techniques change. Used to invalidate cached technique resolution.
+    unsigned GetTechniquesVersion() const { return techniquesVersion_; }
+
     /// Return technique entry by index.
     const TechniqueEntry& GetTechniqueEntry(unsigned index) const;
     /// Return technique by index.
@@ -308,6 +324,9 @@ public:
     /// Return shader parameter hash value. Used as an optimization to avoid setting shader parameters unnecessarily.
     unsigned GetShaderParameterHash() const { return shaderParameterHash_; }
 
+    /// Return compiled shader parameter block, shared with other materials that have identical parameters.
+    MaterialParameterBlock* GetShaderParameterBlock() const { return shaderParameterBlock_; }
+
     /// Return name for texture unit.
     static ea::string GetTextureUnitName(TextureUnit unit);
     /// Parse a shader parameter value from a string. Retunrs either a bool, a float, or a 2 to 4-component vector.
@@ -321,6 +340,12 @@ private:
 
     /// Reset to defaults.
     void ResetToDefaults();
+    /// Reset textures, shader parameters and render states to defaults, keeping the techniques.
+    void ResetShaderParametersAndStates();
+    /// Check whether a reload keeps the technique topology (same techniques and shader defines) and can be patched
+    /// in place, and reset the non-technique state for re-application if so.
+    bool BeginPatchLoad(const ea::vector<TechniqueEntry>& techniques, const ea::string& vertexShaderDefines,
+        const ea::string& pixelShaderDefines);
     /// Recalculate shader parameter hash.
     void RefreshShaderParameterHash();
     /// Recalculate the memory used by the material.
@@ -336,6 +361,8 @@ private:
 
     /// Techniques.
     ea::vector<TechniqueEntry> techniques_;
+    /// Technique list version number.
+    unsigned techniquesVersion_{};
     /// Textures.
     ea::unordered_map<TextureUnit, SharedPtr<Texture> > textures_;
     /// %Shader parameters.
@@ -358,8 +385,12 @@ private:
     unsigned char renderOrder_{};
     /// Last auxiliary view rendered frame number.
     unsigned auxViewFrameNumber_{};
+    /// Last frame number on which the textures were marked as rendered.
+    unsigned texturesUseFrameNumber_{};
     /// Shader parameter hash value.
     unsigned shaderParameterHash_{};
+    /// Compiled shader parameter block, shared between materials with identical parameters.
+    SharedPtr<MaterialParameterBlock> shaderParameterBlock_;
     /// Alpha-to-coverage flag.
     bool alphaToCoverage_{};
     /// Line antialiasing flag.
@@ -28,6 +28,7 @@
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Graphics.h"
+#include "../Graphics/Texture2D.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../IO/File.h"
@@ -40,6 +41,9 @@
 namespace Urho3D
 {
 
+/// Model file flag for skipping CPU-side shadow copies of the buffer data.
+static const unsigned MODEL_FLAG_UNSHADOWED = 0x1;
+
 unsigned LookupVertexBuffer(VertexBuffer* buffer, const ea::vector<SharedPtr<VertexBuffer> >& buffers)
 {
     for (unsigned i = 0; i < buffers.size(); ++i)
@@ -76,13 +80,19 @@ bool Model::BeginLoad(Deserializer& source)
 {
     // Check ID
     ea::string fileID = source.ReadFileID();
-    if (fileID != "UMDL" && fileID != "UMD2")
+    if (fileID != "UMDL" && fileID != "UMD2" && fileID != "UMD3")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid model file");
         return false;
     }
 
-    bool hasVertexDeclarations = (fileID == "UMD2");
+    bool hasVertexDeclarations = (fileID != "UMDL");
+
+    // The UMD3 format adds a flags field after the file ID
+    unsigned flags = 0;
+    if (fileID == "UMD3")
+        flags = source.ReadUInt();
+    loadBuffersShadowed_ = (flags & MODEL_FLAG_UNSHADOWED) == 0;
 
     geometries_.clear();
     geometryBoneMappings_.clear();
@@ -131,7 +141,8 @@ bool Model::BeginLoad(Deserializer& source)
         unsigned vertexSize = VertexBuffer::GetVertexSize(desc.vertexElements_);
         desc.dataSize_ = desc.vertexCount_ * vertexSize;
 
-        // Prepare vertex buffer data to be uploaded during EndLoad()
+        // Prepare vertex buffer data to be uploaded during EndLoad(). The source bytes do not outlive
+        // BeginLoad(), so a copy must be kept; EndLoad() adopts it as the shadow data without copying again
         if (async)
         {
             desc.data_ = new unsigned char[desc.dataSize_];
@@ -139,13 +150,37 @@ bool Model::BeginLoad(Deserializer& source)
         }
         else
         {
-            // If not async loading, use locking to avoid extra allocation & copy
             desc.data_.reset(); // Make sure no previous data
-            buffer->SetShadowed(true);
+            // Morphed buffers need the full shadow copy for CPU morphing; static buffers only keep packed
+            // positions for raycasts. Full data can still be recovered on demand through EnsureShadowData()
+            if (morphRangeCounts_[i])
+                buffer->SetShadowPolicy(SHADOW_DATA_FULL);
+            else
+                buffer->SetShadowPolicy(loadBuffersShadowed_ ? SHADOW_DATA_POSITIONS : SHADOW_DATA_NONE);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
-            void* dest = buffer->Lock(0, desc.vertexCount_);
-            source.Read(dest, desc.vertexCount_ * vertexSize);
-            buffer->Unlock();
+
+            // Upload straight from the memory-resident source bytes without an intermediate copy. A truncated
+            // source must take the Read() path instead, which clamps at the end of the stream
+            const unsigned char* directData = source.GetCurrentData();
+            if (directData && source.GetSize() - source.GetPosition() >= desc.dataSize_)
+            {
+                buffer->SetData(directData);
+                source.SeekRelative((int)desc.dataSize_);
+            }
+            else if (buffer->IsShadowed())
+            {
+                // Use locking to read into the shadow copy and avoid an extra allocation & copy
+                void* dest = buffer->Lock(0, desc.vertexCount_);
+                source.Read(dest, desc.vertexCount_ * vertexSize);
+                buffer->Unlock();
+            }
+            else
+            {
+                // No direct access and no shadow copy; read through a temporary buffer
+                ea::shared_array<unsigned char> data(new unsigned char[desc.dataSize_]);
+                source.Read(data.get(), desc.dataSize_);
+                buffer->SetData(data.get());
+            }
         }
 
         memoryUse += sizeof(VertexBuffer) + desc.vertexCount_ * vertexSize;
@@ -174,13 +209,32 @@ bool Model::BeginLoad(Deserializer& source)
         }
         else
         {
-            // If not async loading, use locking to avoid extra allocation & copy
             loadIBData_[i].data_.reset(); // Make sure no previous data
-            buffer->SetShadowed(true);
+            buffer->SetShadowed(loadBuffersShadowed_);
             buffer->SetSize(indexCount, indexSize > sizeof(unsigned short));
-            void* dest = buffer->Lock(0, indexCount);
-            source.Read(dest, indexCount * indexSize);
-            buffer->Unlock();
+
+            // Upload straight from the memory-resident source bytes without an intermediate copy. A truncated
+            // source must take the Read() path instead, which clamps at the end of the stream
+            const unsigned char* directData = source.GetCurrentData();
+            if (directData && source.GetSize() - source.GetPosition() >= indexCount * indexSize)
+            {
+                buffer->SetData(directData);
+                source.SeekRelative((int)(indexCount * indexSize));
+            }
+            else if (buffer->IsShadowed())
+            {
+                // Use locking to read into the shadow copy and avoid an extra allocation & copy
+                void* dest = buffer->Lock(0, indexCount);
+                source.Read(dest, indexCount * indexSize);
+                buffer->Unlock();
+            }
+            else
+            {
+                // No direct access and no shadow copy; read through a temporary buffer
+                ea::shared_array<unsigned char> data(new unsigned char[indexCount * indexSize]);
+                source.Read(data.get(), indexCount * indexSize);
+                buffer->SetData(data.get());
+            }
         }
 
         memoryUse += sizeof(IndexBuffer) + indexCount * indexSize;
@@ -300,9 +354,11 @@ bool Model::BeginLoad(Deserializer& source)
     // Read bounding box
     boundingBox_ = source.ReadBoundingBox();
 
-    // Read geometry centers
-    for (unsigned i = 0; i < geometries_.size() && !source.IsEof(); ++i)
-        geometryCenters_.push_back(source.ReadVector3());
+    // Read geometry centers as one block. Old files may end before all centers are present
+    const unsigned numCenters =
+        Min((unsigned)geometries_.size(), (source.GetSize() - source.GetPosition()) / (unsigned)sizeof(Vector3));
+    geometryCenters_.resize(numCenters);
+    source.ReadArray(ea::span<Vector3>(geometryCenters_));
     while (geometryCenters_.size() < geometries_.size())
         geometryCenters_.push_back(Vector3::ZERO);
     memoryUse += sizeof(Vector3) * geometries_.size();
@@ -327,9 +383,15 @@ bool Model::EndLoad()
         VertexBufferDesc& desc = loadVBData_[i];
         if (desc.data_)
         {
-            buffer->SetShadowed(true);
+            // Morphed buffers need the full shadow copy for CPU morphing; static buffers only keep packed
+            // positions for raycasts. Full data can still be recovered on demand through EnsureShadowData()
+            if (morphRangeCounts_[i])
+                buffer->SetShadowPolicy(SHADOW_DATA_FULL);
+            else
+                buffer->SetShadowPolicy(loadBuffersShadowed_ ? SHADOW_DATA_POSITIONS : SHADOW_DATA_NONE);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
-            buffer->SetData(desc.data_.get());
+            // Adopts the loaded array as the shadow copy instead of copying the data a second time
+            buffer->SetData(desc.data_);
         }
     }
 
@@ -340,9 +402,10 @@ bool Model::EndLoad()
         IndexBufferDesc& desc = loadIBData_[i];
         if (desc.data_)
         {
-            buffer->SetShadowed(true);
+            buffer->SetShadowed(loadBuffersShadowed_);
             buffer->SetSize(desc.indexCount_, desc.indexSize_ > sizeof(unsigned short));
-            buffer->SetData(desc.data_.get());
+            // Adopts the loaded array as the shadow copy instead of copying the data a second time
+            buffer->SetData(desc.data_);
         }
     }
 
@@ -388,6 +451,11 @@ bool Model::Save(Serializer& dest) const
         }
         dest.WriteUInt(morphRangeStarts_[i]);
         dest.WriteUInt(morphRangeCounts_[i]);
+        if (!buffer->EnsureShadowData())
+        {
+            URHO3D_LOGERROR("Can not save model, vertex buffer data is not available");
+            return false;
+        }
         dest.Write(buffer->GetShadowData(), buffer->GetVertexCount() * buffer->GetVertexSize());
     }
     // Write index buffers
@@ -397,6 +465,11 @@ bool Model::Save(Serializer& dest) const
         IndexBuffer* buffer = indexBuffers_[i];
         dest.WriteUInt(buffer->GetIndexCount());
         dest.WriteUInt(buffer->GetIndexSize());
+        if (!buffer->EnsureShadowData())
+        {
+            URHO3D_LOGERROR("Can not save model, index buffer data is not available");
+            return false;
+        }
         dest.Write(buffer->GetShadowData(), buffer->GetIndexCount() * buffer->GetIndexSize());
     }
     // Write geometries
@@ -458,8 +531,7 @@ bool Model::Save(Serializer& dest) const
     dest.WriteBoundingBox(boundingBox_);
 
     // Write geometry centers
-    for (unsigned i = 0; i < geometryCenters_.size(); ++i)
-        dest.WriteVector3(geometryCenters_[i]);
+    dest.WriteArray(ea::span<const Vector3>(geometryCenters_));
 
     // Write metadata
     if (HasMetadata())
@@ -637,9 +709,9 @@ SharedPtr<Model> Model::Clone(const ea::string& cloneName) const
         if (origBuffer)
         {
             cloneBuffer = context_->CreateObject<VertexBuffer>();
+            cloneBuffer->SetShadowPolicy(origBuffer->GetShadowPolicy());
             cloneBuffer->SetSize(origBuffer->GetVertexCount(), origBuffer->GetElementMask(), origBuffer->IsDynamic());
-            cloneBuffer->SetShadowed(origBuffer->IsShadowed());
-            if (origBuffer->IsShadowed())
+            if (origBuffer->EnsureShadowData())
                 cloneBuffer->SetData(origBuffer->GetShadowData());
             else
             {
@@ -667,7 +739,7 @@ SharedPtr<Model> Model::Clone(const ea::string& cloneName) const
             cloneBuffer->SetSize(origBuffer->GetIndexCount(), origBuffer->GetIndexSize() == sizeof(unsigned),
                 origBuffer->IsDynamic());
             cloneBuffer->SetShadowed(origBuffer->IsShadowed());
-            if (origBuffer->IsShadowed())
+            if (origBuffer->EnsureShadowData())
                 cloneBuffer->SetData(origBuffer->GetShadowData());
             else
             {
@@ -781,4 +853,9 @@ unsigned Model::GetMorphRangeCount(unsigned bufferIndex) const
     return bufferIndex < vertexBuffers_.size() ? morphRangeCounts_[bufferIndex] : 0;
 }
 
+void Model::SetMorphTexture(ea::unique_ptr<ModelMorphTexture> morphTexture)
+{
+    morphTexture_ = ea::move(morphTexture);
+}
+
 }
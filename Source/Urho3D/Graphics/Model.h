@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
 
 #include "../Container/Ptr.h"
 #include "../Graphics/GraphicsDefs.h"
@@ -36,6 +37,7 @@ namespace Urho3D
 class Geometry;
 class IndexBuffer;
 class Graphics;
+class Texture2D;
 class VertexBuffer;
 
 /// Vertex buffer morph data.
@@ -76,6 +78,19 @@ struct ModelMorph
     ea::unordered_map<unsigned, VertexBufferMorph> buffers_;
 };
 
+/// GPU morphing data created on demand, shared between the model's instances.
+struct ModelMorphTexture
+{
+    /// Morph delta texture. For each morph and vertex a position delta texel, followed by optional normal and tangent delta texels.
+    SharedPtr<Texture2D> texture_;
+    /// Index of the morphed vertex buffer.
+    unsigned bufferIndex_{};
+    /// Vertex count of the morphed vertex buffer.
+    unsigned vertexCount_{};
+    /// Union of the morphs' element masks.
+    VertexMaskFlags elementMask_{};
+};
+
 /// Description of vertex buffer data for asynchronous loading.
 struct VertexBufferDesc
 {
@@ -220,6 +235,11 @@ public:
     /// Return morph range vertex counts for each vertex buffer.
     const ea::vector<unsigned>& GetMorphRangeCounts() const { return morphRangeCounts_; }
 
+    /// Return GPU morphing data, or null if not created.
+    ModelMorphTexture* GetMorphTexture() const { return morphTexture_.get(); }
+    /// Store GPU morphing data for sharing between the model's instances.
+    void SetMorphTexture(ea::unique_ptr<ModelMorphTexture> morphTexture);
+
 private:
     /// Bounding box.
     BoundingBox boundingBox_;
@@ -241,12 +261,16 @@ private:
     ea::vector<unsigned> morphRangeStarts_;
     /// Vertex buffer morph range vertex count.
     ea::vector<unsigned> morphRangeCounts_;
+    /// GPU morphing data, created on demand.
+    ea::unique_ptr<ModelMorphTexture> morphTexture_;
     /// Vertex buffer data for asynchronous loading.
     ea::vector<VertexBufferDesc> loadVBData_;
     /// Index buffer data for asynchronous loading.
     ea::vector<IndexBufferDesc> loadIBData_;
     /// Geometry definitions for asynchronous loading.
     ea::vector<ea::vector<GeometryDesc> > loadGeometries_;
+    /// Whether the buffers being loaded should keep CPU-side shadow data.
+    bool loadBuffersShadowed_{true};
 };
 
 }
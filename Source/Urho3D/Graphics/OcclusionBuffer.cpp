@@ -45,6 +45,12 @@ enum ClipMask : unsigned
 };
 URHO3D_FLAGSET(ClipMask, ClipMaskFlags);
 
+void MergeOcclusionBuffersWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* buffer = reinterpret_cast<OcclusionBuffer*>(item->aux_);
+    buffer->MergeBuffersRange((int*)item->start_, (int*)item->end_);
+}
+
 void DrawOcclusionBatchWork(const WorkItem* item, unsigned threadIndex)
 {
     URHO3D_PROFILE("DrawOcclusionBatchWork");
@@ -819,6 +825,38 @@ struct Edge
     int invZStep_;
 };
 
+/// Rasterize a depth span, writing the interpolated depth wherever it is closer than the existing value.
+/// Processes four pixels at a time with SSE when available.
+inline void RasterizeSpan(int* dest, int* end, int invZ, int dInvZdX)
+{
+#ifdef URHO3D_SSE
+    if (end - dest >= 4)
+    {
+        __m128i vInvZ = _mm_add_epi32(_mm_set1_epi32(invZ), _mm_setr_epi32(0, dInvZdX, dInvZdX * 2, dInvZdX * 3));
+        const __m128i vStep = _mm_set1_epi32(dInvZdX * 4);
+
+        while (end - dest >= 4)
+        {
+            __m128i vDest = _mm_loadu_si128((__m128i*)dest);
+            __m128i mask = _mm_cmplt_epi32(vInvZ, vDest);
+            _mm_storeu_si128((__m128i*)dest, _mm_or_si128(_mm_and_si128(mask, vInvZ), _mm_andnot_si128(mask, vDest)));
+
+            vInvZ = _mm_add_epi32(vInvZ, vStep);
+            dest += 4;
+            invZ += dInvZdX * 4;
+        }
+    }
+#endif
+
+    while (dest < end)
+    {
+        if (invZ < *dest)
+            *dest = invZ;
+        invZ += dInvZdX;
+        ++dest;
+    }
+}
+
 void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, unsigned threadIndex)
 {
     int top, middle, bottom;
@@ -908,16 +946,8 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + middleY * width_;
             while (row < endRow)
             {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (topToMiddle.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                RasterizeSpan(row + (topToBottom.x_ >> 16u), row + (topToMiddle.x_ >> 16u), topToBottom.invZ_,
+                    gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -934,16 +964,8 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + bottomY * width_;
             while (row < endRow)
             {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (middleToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                RasterizeSpan(row + (topToBottom.x_ >> 16u), row + (middleToBottom.x_ >> 16u), topToBottom.invZ_,
+                    gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -962,16 +984,8 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + middleY * width_;
             while (row < endRow)
             {
-                int invZ = topToMiddle.invZ_;
-                int* dest = row + (topToMiddle.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                RasterizeSpan(row + (topToMiddle.x_ >> 16u), row + (topToBottom.x_ >> 16u), topToMiddle.invZ_,
+                    gradients.dInvZdXInt_);
 
                 topToMiddle.x_ += topToMiddle.xStep_;
                 topToMiddle.invZ_ += topToMiddle.invZStep_;
@@ -988,16 +1002,8 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + bottomY * width_;
             while (row < endRow)
             {
-                int invZ = middleToBottom.invZ_;
-                int* dest = row + (middleToBottom.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                RasterizeSpan(row + (middleToBottom.x_ >> 16u), row + (topToBottom.x_ >> 16u), middleToBottom.invZ_,
+                    gradients.dInvZdXInt_);
 
                 middleToBottom.x_ += middleToBottom.xStep_;
                 middleToBottom.invZ_ += middleToBottom.invZStep_;
@@ -1012,22 +1018,65 @@ void OcclusionBuffer::MergeBuffers()
 {
     URHO3D_PROFILE("MergeBuffers");
 
+    bool anyUsed = false;
+    for (unsigned i = 1; i < buffers_.size(); ++i)
+        anyUsed |= buffers_[i].used_;
+    if (!anyUsed)
+        return;
+
+    // Merge in row slices over the worker threads
+    auto* queue = GetSubsystem<WorkQueue>();
+    int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
+    int rowsPerItem = Max(height_ / numWorkItems, 1);
+
+    for (int y = 0; y < height_; y += rowsPerItem)
+    {
+        int endY = Min(y + rowsPerItem, height_);
+
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = MergeOcclusionBuffersWork;
+        item->aux_ = this;
+        item->start_ = buffers_[0].data_ + y * width_;
+        item->end_ = buffers_[0].data_ + endY * width_;
+        queue->AddWorkItem(item);
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+void OcclusionBuffer::MergeBuffersRange(int* dest, int* end)
+{
+    const auto offset = (unsigned)(dest - buffers_[0].data_);
+
     for (unsigned i = 1; i < buffers_.size(); ++i)
     {
         if (!buffers_[i].used_)
             continue;
 
-        int* src = buffers_[i].data_;
-        int* dest = buffers_[0].data_;
-        int count = width_ * height_;
+        const int* src = buffers_[i].data_ + offset;
+        int* out = dest;
+
+#ifdef URHO3D_SSE
+        while (end - out >= 4)
+        {
+            __m128i vSrc = _mm_loadu_si128((const __m128i*)src);
+            __m128i vDest = _mm_loadu_si128((__m128i*)out);
+            __m128i mask = _mm_cmplt_epi32(vSrc, vDest);
+            _mm_storeu_si128((__m128i*)out, _mm_or_si128(_mm_and_si128(mask, vSrc), _mm_andnot_si128(mask, vDest)));
+
+            src += 4;
+            out += 4;
+        }
+#endif
 
-        while (count--)
+        while (out < end)
         {
             // If thread buffer's depth value is closer, overwrite the original
-            if (*src < *dest)
-                *dest = *src;
+            if (*src < *out)
+                *out = *src;
             ++src;
-            ++dest;
+            ++out;
         }
     }
 }
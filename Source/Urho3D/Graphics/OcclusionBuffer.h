@@ -160,6 +160,8 @@ public:
 
     /// Draw a batch. Called internally.
     void DrawBatch(const OcclusionBatch& batch, unsigned threadIndex);
+    /// Merge a range of the thread work buffers into the first buffer. Called internally.
+    void MergeBuffersRange(int* dest, int* end);
 
 private:
     /// Apply modelview transform to vertex.
@@ -28,6 +28,7 @@
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
 #include "../Core/Thread.h"
+#include "../Core/Timer.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
@@ -185,13 +186,17 @@ Octant::~Octant()
     if (root_)
     {
         // Remove the drawables (if any) from this octant to the root octant
-        for (auto i = drawables_.begin(); i != drawables_.end(); ++i)
+        for (unsigned i = 0; i < drawables_.size(); ++i)
         {
-            (*i)->SetOctant(root_);
-            root_->drawables_.push_back(*i);
-            root_->QueueUpdate(*i);
+            Drawable* drawable = drawables_[i];
+            drawable->SetOctant(root_);
+            drawable->octantIndex_ = root_->drawables_.size();
+            root_->drawables_.push_back(drawable);
+            root_->cullData_.push_back(cullData_[i]);
+            root_->QueueUpdate(drawable);
         }
         drawables_.clear();
+        cullData_.clear();
         numDrawables_ = 0;
     }
 
@@ -268,6 +273,28 @@ void Octant::InsertDrawable(Drawable* drawable)
     }
 }
 
+void Octant::ReinsertDrawable(Drawable* drawable)
+{
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+
+    // Non-occludees always live in the root octant. Otherwise ascend only as far as needed:
+    // once the box is fully inside the culling bounds and its center is inside the octant,
+    // a top-down insertion from the root would pass through this octant anyway, so the
+    // placement is identical while the cost stays proportional to the actual movement
+    Octant* octant = this;
+    if (!drawable->IsOccludee())
+        octant = root_;
+    else
+    {
+        while (octant != root_ &&
+            (octant->cullingBox_.IsInside(box) != INSIDE ||
+                octant->worldBoundingBox_.IsInside(box.Center()) != INSIDE))
+            octant = octant->parent_;
+    }
+
+    octant->InsertDrawable(drawable);
+}
+
 bool Octant::CheckDrawableFit(const BoundingBox& box) const
 {
     Vector3 boxSize = box.Size();
@@ -292,6 +319,12 @@ bool Octant::CheckDrawableFit(const BoundingBox& box) const
     return false;
 }
 
+void Octant::MarkOctreeDirty()
+{
+    if (root_)
+        ++root_->structureVersion_;
+}
+
 void Octant::ResetRoot()
 {
     root_ = nullptr;
@@ -347,7 +380,7 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
     {
         auto** start = const_cast<Drawable**>(&drawables_[0]);
         Drawable** end = start + drawables_.size();
-        query.TestDrawables(start, end, inside);
+        query.TestDrawables(start, end, &cullData_[0], inside);
     }
 
     for (auto child : children_)
@@ -365,15 +398,11 @@ void Octant::GetDrawablesInternal(RayOctreeQuery& query) const
 
     if (drawables_.size())
     {
-        auto** start = const_cast<Drawable**>(&drawables_[0]);
-        Drawable** end = start + drawables_.size();
-
-        while (start != end)
+        for (unsigned i = 0; i < drawables_.size(); ++i)
         {
-            Drawable* drawable = *start++;
-
-            if ((drawable->GetDrawableFlags() & query.drawableFlags_) && (drawable->GetViewMask() & query.viewMask_))
-                drawable->ProcessRayQuery(query, query.result_);
+            const DrawableCullData& data = cullData_[i];
+            if ((data.drawableFlags_ & query.drawableFlags_) && (data.viewMask_ & query.viewMask_))
+                drawables_[i]->ProcessRayQuery(query, query.result_);
         }
     }
 
@@ -392,22 +421,92 @@ void Octant::GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable
 
     if (drawables_.size())
     {
-        auto** start = const_cast<Drawable**>(&drawables_[0]);
-        Drawable** end = start + drawables_.size();
+        for (unsigned i = 0; i < drawables_.size(); ++i)
+        {
+            const DrawableCullData& data = cullData_[i];
+            if ((data.drawableFlags_ & query.drawableFlags_) && (data.viewMask_ & query.viewMask_))
+                drawables.push_back(drawables_[i]);
+        }
+    }
 
-        while (start != end)
+    for (auto child : children_)
+    {
+        if (child)
+            child->GetDrawablesOnlyInternal(query, drawables);
+    }
+}
+
+/// State of a four-ray packet traversal.
+struct RayQueryPacket
+{
+    /// Queries in the packet.
+    RayOctreeQuery* queries_[4]{};
+    /// Number of valid rays.
+    unsigned numRays_{};
+    /// Candidate drawables per ray.
+    ea::vector<Drawable*> candidates_[4];
+#ifdef URHO3D_SSE
+    /// Ray origins, one register per component.
+    __m128 originX_, originY_, originZ_;
+    /// Reciprocal ray directions, one register per component.
+    __m128 invDirX_, invDirY_, invDirZ_;
+    /// Maximum hit distances.
+    __m128 maxDistance_;
+#endif
+};
+
+void Octant::GetDrawablesPacketInternal(RayQueryPacket& packet, unsigned activeMask) const
+{
+#ifdef URHO3D_SSE
+    // Slab test of all four rays against the culling box at once
+    const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.min_.x_), packet.originX_), packet.invDirX_);
+    const __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.max_.x_), packet.originX_), packet.invDirX_);
+    const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.min_.y_), packet.originY_), packet.invDirY_);
+    const __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.max_.y_), packet.originY_), packet.invDirY_);
+    const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.min_.z_), packet.originZ_), packet.invDirZ_);
+    const __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(cullingBox_.max_.z_), packet.originZ_), packet.invDirZ_);
+
+    const __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+        _mm_max_ps(_mm_min_ps(t1z, t2z), _mm_setzero_ps()));
+    const __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+        _mm_max_ps(t1z, t2z));
+
+    activeMask &= (unsigned)_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(tMin, tMax), _mm_cmplt_ps(tMin, packet.maxDistance_)));
+#else
+    for (unsigned i = 0; i < packet.numRays_; ++i)
+    {
+        if (!(activeMask & (1u << i)))
+            continue;
+
+        const RayOctreeQuery& query = *packet.queries_[i];
+        if (query.ray_.HitDistance(cullingBox_) >= query.maxDistance_)
+            activeMask &= ~(1u << i);
+    }
+#endif
+
+    if (!activeMask)
+        return;
+
+    if (drawables_.size())
+    {
+        for (unsigned drawableIndex = 0; drawableIndex < drawables_.size(); ++drawableIndex)
         {
-            Drawable* drawable = *start++;
+            const DrawableCullData& data = cullData_[drawableIndex];
 
-            if ((drawable->GetDrawableFlags() & query.drawableFlags_) && (drawable->GetViewMask() & query.viewMask_))
-                drawables.push_back(drawable);
+            for (unsigned i = 0; i < packet.numRays_; ++i)
+            {
+                const RayOctreeQuery& query = *packet.queries_[i];
+                if ((activeMask & (1u << i)) && (data.drawableFlags_ & query.drawableFlags_) &&
+                    (data.viewMask_ & query.viewMask_))
+                    packet.candidates_[i].push_back(drawables_[drawableIndex]);
+            }
         }
     }
 
     for (auto child : children_)
     {
         if (child)
-            child->GetDrawablesOnlyInternal(query, drawables);
+            child->GetDrawablesPacketInternal(packet, activeMask);
     }
 }
 
@@ -416,16 +515,16 @@ Octree::Octree(Context* context) :
     Octant(BoundingBox(-DEFAULT_OCTREE_SIZE, DEFAULT_OCTREE_SIZE), 0, nullptr, this),
     numLevels_(DEFAULT_OCTREE_LEVELS)
 {
-    // If the engine is running headless, subscribe to RenderUpdate events for manually updating the octree
-    // to allow raycasts and animation update
-    if (!GetSubsystem<Graphics>())
-        SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Octree, HandleRenderUpdate));
+    // Subscribe to RenderUpdate events for executing queued asynchronous raycasts. If the engine is running headless,
+    // the octree is also updated manually during the event to allow raycasts and animation update
+    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Octree, HandleRenderUpdate));
 }
 
 Octree::~Octree()
 {
     // Reset root pointer from all child octants now so that they do not move their drawables to root
     drawableUpdates_.clear();
+    deferredDrawableUpdates_.clear();
     ResetRoot();
 }
 
@@ -439,6 +538,8 @@ void Octree::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Bounding Box Min", Vector3, worldBoundingBox_.min_, UpdateOctreeSize, defaultBoundsMin, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Bounding Box Max", Vector3, worldBoundingBox_.max_, UpdateOctreeSize, defaultBoundsMax, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Number of Levels", int, numLevels_, UpdateOctreeSize, DEFAULT_OCTREE_LEVELS, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Drawable Update Budget", unsigned, drawableUpdateBudget_, 0, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Drawable Update Lag", unsigned, maxDrawableUpdateLag_, 4, AM_DEFAULT);
 }
 
 void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -472,6 +573,44 @@ void Octree::Update(const FrameInfo& frame)
         return;
     }
 
+    // Apply the drawable update budget: drawables recently in view and deferred updates at the staleness cap
+    // always update this frame, the rest fill what is left of the budget oldest first and are otherwise deferred
+    if (drawableUpdateBudget_ && drawableUpdates_.size() + deferredDrawableUpdates_.size() > drawableUpdateBudget_)
+    {
+        URHO3D_PROFILE("PrioritizeDrawableUpdates");
+
+        ea::vector<Drawable*> updates;
+        ea::vector<ea::pair<Drawable*, unsigned> > stillDeferred;
+        updates.reserve(Min((unsigned)(drawableUpdates_.size() + deferredDrawableUpdates_.size()), drawableUpdateBudget_));
+
+        for (const auto& deferred : deferredDrawableUpdates_)
+        {
+            if (deferred.second + 1 >= maxDrawableUpdateLag_ || updates.size() < drawableUpdateBudget_)
+                updates.push_back(deferred.first);
+            else
+                stillDeferred.push_back(ea::make_pair(deferred.first, deferred.second + 1));
+        }
+
+        for (Drawable* drawable : drawableUpdates_)
+        {
+            // Consider drawables in view last frame as visible; the current frame has not been culled yet
+            if (frame.frameNumber_ - drawable->GetViewFrameNumber() <= 1 || updates.size() < drawableUpdateBudget_)
+                updates.push_back(drawable);
+            else
+                stillDeferred.push_back(ea::make_pair(drawable, 1u));
+        }
+
+        drawableUpdates_ = ea::move(updates);
+        deferredDrawableUpdates_ = ea::move(stillDeferred);
+    }
+    else if (!deferredDrawableUpdates_.empty())
+    {
+        // Everything fits the budget (or it is disabled): flush the deferred updates
+        for (const auto& deferred : deferredDrawableUpdates_)
+            drawableUpdates_.push_back(deferred.first);
+        deferredDrawableUpdates_.clear();
+    }
+
     // Let drawables update themselves before reinsertion. This can be used for animation
     if (!drawableUpdates_.empty())
     {
@@ -547,6 +686,10 @@ void Octree::Update(const FrameInfo& frame)
     {
         URHO3D_PROFILE("ReinsertToOctree");
 
+        // Bounding boxes may change without the drawable moving to another octant, so invalidate cached query results
+        // whenever any update was processed
+        ++structureVersion_;
+
         for (auto i = drawableUpdates_.begin(); i != drawableUpdates_.end(); ++i)
         {
             Drawable* drawable = *i;
@@ -557,11 +700,17 @@ void Octree::Update(const FrameInfo& frame)
             // Skip if no octant or does not belong to this octree anymore
             if (!octant || octant->GetRoot() != this)
                 continue;
-            // Skip if still fits the current octant
+            // If the drawable still fits the current octant, only refresh its stored culling data
             if (drawable->IsOccludee() && octant->GetCullingBox().IsInside(box) == INSIDE && octant->CheckDrawableFit(box))
+            {
+                octant->RefreshDrawableCullData(drawable);
                 continue;
+            }
 
-            InsertDrawable(drawable);
+            octant->ReinsertDrawable(drawable);
+            // Reinsertion may have kept the drawable in the same octant, in which case the culling data is stale
+            if (Octant* newOctant = drawable->GetOctant())
+                newOctant->RefreshDrawableCullData(drawable);
 
 #ifdef _DEBUG
             // Verify that the drawable will be culled correctly
@@ -596,8 +745,29 @@ void Octree::RemoveManualDrawable(Drawable* drawable)
         octant->RemoveDrawable(drawable);
 }
 
+void Octree::RefreshQueuedCullData() const
+{
+    // Drawables queued for an update may have moved since their culling data was stored; refresh them so that queries
+    // issued between octree updates see the same bounding boxes as the drawables would report themselves
+    for (Drawable* drawable : drawableUpdates_)
+    {
+        Octant* octant = drawable->GetOctant();
+        if (octant && octant->GetRoot() == this)
+            octant->RefreshDrawableCullData(drawable);
+    }
+
+    for (const auto& deferred : deferredDrawableUpdates_)
+    {
+        Octant* octant = deferred.first->GetOctant();
+        if (octant && octant->GetRoot() == this)
+            octant->RefreshDrawableCullData(deferred.first);
+    }
+}
+
 void Octree::GetDrawables(OctreeQuery& query) const
 {
+    RefreshQueuedCullData();
+
     query.result_.clear();
     GetDrawablesInternal(query, false);
 }
@@ -606,6 +776,8 @@ void Octree::Raycast(RayOctreeQuery& query) const
 {
     URHO3D_PROFILE("Raycast");
 
+    RefreshQueuedCullData();
+
     query.result_.clear();
     GetDrawablesInternal(query);
     ea::quick_sort(query.result_.begin(), query.result_.end(), CompareRayQueryResults);
@@ -615,6 +787,8 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
 {
     URHO3D_PROFILE("Raycast");
 
+    RefreshQueuedCullData();
+
     query.result_.clear();
     rayQueryDrawables_.clear();
     GetDrawablesOnlyInternal(query, rayQueryDrawables_);
@@ -651,6 +825,159 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
     }
 }
 
+void Octree::RaycastBatch(RayOctreeQuery** queries, unsigned numQueries) const
+{
+    URHO3D_PROFILE("RaycastBatch");
+
+    if (!numQueries)
+        return;
+
+    RefreshQueuedCullData();
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+
+    // Build four-ray packets. Unused lanes replicate the first ray and stay masked out
+    ea::vector<RayQueryPacket> packets((numQueries + 3) / 4);
+    for (unsigned packetIndex = 0; packetIndex < packets.size(); ++packetIndex)
+    {
+        RayQueryPacket& packet = packets[packetIndex];
+        packet.numRays_ = Min(numQueries - packetIndex * 4, 4u);
+        for (unsigned i = 0; i < 4; ++i)
+            packet.queries_[i] = queries[packetIndex * 4 + Min(i, packet.numRays_ - 1)];
+
+#ifdef URHO3D_SSE
+        float originX[4], originY[4], originZ[4], invDirX[4], invDirY[4], invDirZ[4], maxDistance[4];
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            const Ray& ray = packet.queries_[i]->ray_;
+            originX[i] = ray.origin_.x_;
+            originY[i] = ray.origin_.y_;
+            originZ[i] = ray.origin_.z_;
+            invDirX[i] = 1.0f / ray.direction_.x_;
+            invDirY[i] = 1.0f / ray.direction_.y_;
+            invDirZ[i] = 1.0f / ray.direction_.z_;
+            maxDistance[i] = packet.queries_[i]->maxDistance_;
+        }
+        packet.originX_ = _mm_loadu_ps(originX);
+        packet.originY_ = _mm_loadu_ps(originY);
+        packet.originZ_ = _mm_loadu_ps(originZ);
+        packet.invDirX_ = _mm_loadu_ps(invDirX);
+        packet.invDirY_ = _mm_loadu_ps(invDirY);
+        packet.invDirZ_ = _mm_loadu_ps(invDirZ);
+        packet.maxDistance_ = _mm_loadu_ps(maxDistance);
+#endif
+    }
+
+    // Traverse and test each packet on the worker threads. The octree is not modified during the queries
+    for (RayQueryPacket& packet : packets)
+    {
+        workQueue->AddWorkItem([this, &packet]()
+        {
+            GetDrawablesPacketInternal(packet, (1u << packet.numRays_) - 1);
+
+            for (unsigned i = 0; i < packet.numRays_; ++i)
+            {
+                RayOctreeQuery& query = *packet.queries_[i];
+                query.result_.clear();
+                for (Drawable* drawable : packet.candidates_[i])
+                    drawable->ProcessRayQuery(query, query.result_);
+                ea::quick_sort(query.result_.begin(), query.result_.end(), CompareRayQueryResults);
+            }
+        }, M_MAX_UNSIGNED);
+    }
+
+    workQueue->Complete(M_MAX_UNSIGNED);
+}
+
+StopToken Octree::RaycastAsync(const Ray& ray, const AsyncRaycastCallback& callback, RayQueryLevel level,
+    float maxDistance, DrawableFlags drawableFlags, unsigned viewMask)
+{
+    AsyncRaycast raycast;
+    raycast.query_ = ea::make_unique<RayOctreeQuery>(ray, level, maxDistance, drawableFlags, viewMask);
+    raycast.callback_ = callback;
+    asyncRaycasts_.push_back(ea::move(raycast));
+    return asyncRaycasts_.back().stopToken_;
+}
+
+StopToken Octree::RaycastSingleAsync(const Ray& ray, const AsyncRaycastCallback& callback, RayQueryLevel level,
+    float maxDistance, DrawableFlags drawableFlags, unsigned viewMask)
+{
+    StopToken stopToken = RaycastAsync(ray, callback, level, maxDistance, drawableFlags, viewMask);
+    asyncRaycasts_.back().single_ = true;
+    return stopToken;
+}
+
+void Octree::SetAsyncRaycastMs(int ms)
+{
+    asyncRaycastMs_ = Max(ms, 0);
+}
+
+void Octree::SetDrawableUpdateBudget(unsigned budget)
+{
+    drawableUpdateBudget_ = budget;
+}
+
+void Octree::SetMaxDrawableUpdateLag(unsigned frames)
+{
+    maxDrawableUpdateLag_ = Max(frames, 1U);
+}
+
+void Octree::UpdateAsyncRaycasts()
+{
+    if (asyncRaycasts_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateAsyncRaycasts");
+
+    // Move the queue out before executing, so that callbacks may safely queue new raycasts
+    ea::vector<AsyncRaycast> raycasts(ea::move(asyncRaycasts_));
+    asyncRaycasts_.clear();
+
+    HiresTimer timer;
+    unsigned processed = 0;
+
+    while (processed < raycasts.size())
+    {
+        // Collect the next packet of queries, completing cancelled raycasts without executing them
+        RayOctreeQuery* queries[4];
+        AsyncRaycast* batch[4];
+        unsigned numQueries = 0;
+        while (numQueries < 4 && processed < raycasts.size())
+        {
+            AsyncRaycast& raycast = raycasts[processed++];
+            if (raycast.stopToken_.IsStopped())
+                continue;
+            queries[numQueries] = raycast.query_.get();
+            batch[numQueries++] = &raycast;
+        }
+
+        if (numQueries)
+        {
+            RaycastBatch(queries, numQueries);
+
+            for (unsigned i = 0; i < numQueries; ++i)
+            {
+                AsyncRaycast& raycast = *batch[i];
+                if (raycast.single_ && raycast.query_->result_.size() > 1)
+                    raycast.query_->result_.resize(1);
+                if (raycast.callback_)
+                    raycast.callback_(raycast.query_->result_);
+            }
+        }
+
+        // At least one packet is always executed so that queued raycasts make progress even under a zero budget
+        if (timer.GetUSec(false) >= asyncRaycastMs_ * 1000LL)
+            break;
+    }
+
+    // Return the raycasts that did not fit the budget to the queue, ahead of any queued from the callbacks
+    if (processed < raycasts.size())
+    {
+        asyncRaycasts_.insert(asyncRaycasts_.begin(), ea::make_move_iterator(raycasts.begin() + processed),
+            ea::make_move_iterator(raycasts.end()));
+    }
+}
+
 Zone* Octree::GetZone(unsigned viewMask) const
 {
     ZoneOctreeQuery query(viewMask);
@@ -685,6 +1012,14 @@ void Octree::CancelUpdate(Drawable* drawable)
     // This doesn't have to take into account scene being in threaded update, because it is called only
     // when removing a drawable from octree, which should only ever happen from the main thread.
     drawableUpdates_.erase_first(drawable);
+    for (auto i = deferredDrawableUpdates_.begin(); i != deferredDrawableUpdates_.end(); ++i)
+    {
+        if (i->first == drawable)
+        {
+            deferredDrawableUpdates_.erase(i);
+            break;
+        }
+    }
     drawable->updateQueued_ = false;
 }
 
@@ -696,19 +1031,24 @@ void Octree::DrawDebugGeometry(bool depthTest)
 
 void Octree::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
 {
-    // When running in headless mode, update the Octree manually during the RenderUpdate event
     Scene* scene = GetScene();
     if (!scene || !scene->IsUpdateEnabled())
         return;
 
-    using namespace RenderUpdate;
+    // When running in headless mode, update the Octree manually during the RenderUpdate event
+    if (!GetSubsystem<Graphics>())
+    {
+        using namespace RenderUpdate;
 
-    FrameInfo frame;
-    frame.frameNumber_ = GetSubsystem<Time>()->GetFrameNumber();
-    frame.timeStep_ = eventData[P_TIMESTEP].GetFloat();
-    frame.camera_ = nullptr;
+        FrameInfo frame;
+        frame.frameNumber_ = GetSubsystem<Time>()->GetFrameNumber();
+        frame.timeStep_ = eventData[P_TIMESTEP].GetFloat();
+        frame.camera_ = nullptr;
+
+        Update(frame);
+    }
 
-    Update(frame);
+    UpdateAsyncRaycasts();
 }
 
 }
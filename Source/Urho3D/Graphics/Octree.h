@@ -23,15 +23,24 @@
 #pragma once
 
 #include "../Core/Mutex.h"
+#include "../Core/StopToken.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/OctreeQuery.h"
 
+#include <EASTL/unique_ptr.h>
+
+#include <functional>
+
 namespace Urho3D
 {
 
 class Octree;
 class Skybox;
 class Zone;
+struct RayQueryPacket;
+
+/// Callback invoked on the main thread when an asynchronous octree raycast completes.
+using AsyncRaycastCallback = std::function<void(const ea::vector<RayQueryResult>& results)>;
 
 static const int NUM_OCTANTS = 8;
 static const unsigned ROOT_INDEX = M_MAX_UNSIGNED;
@@ -51,27 +60,53 @@ public:
     void DeleteChild(unsigned index);
     /// Insert a drawable object by checking for fit recursively.
     void InsertDrawable(Drawable* drawable);
+    /// Reinsert a drawable object bottom-up: walk towards the root only as far as needed, then insert top-down from there.
+    void ReinsertDrawable(Drawable* drawable);
     /// Check if a drawable object fits.
     bool CheckDrawableFit(const BoundingBox& box) const;
+    /// Increment the octree structure version. Called whenever a drawable is added to or removed from an octant.
+    void MarkOctreeDirty();
 
     /// Add a drawable object to this octant.
     void AddDrawable(Drawable* drawable)
     {
         drawable->SetOctant(this);
+        drawable->octantIndex_ = drawables_.size();
         drawables_.push_back(drawable);
+        cullData_.push_back(DrawableCullData{drawable->GetWorldBoundingBox(), drawable->GetViewMask(), drawable->GetDrawableFlags()});
         IncDrawableCount();
+        MarkOctreeDirty();
     }
 
     /// Remove a drawable object from this octant.
     void RemoveDrawable(Drawable* drawable, bool resetOctant = true)
     {
-        auto it = drawables_.find(drawable);
-        if (it != drawables_.end())
+        const unsigned index = drawable->octantIndex_;
+        if (index < drawables_.size() && drawables_[index] == drawable)
         {
-            drawables_.erase(it);
+            // Swap-erase to keep the culling data array parallel and compact; fix up the index of the moved drawable
+            drawables_[index] = drawables_.back();
+            drawables_[index]->octantIndex_ = index;
+            drawables_.pop_back();
+            cullData_[index] = cullData_.back();
+            cullData_.pop_back();
             if (resetOctant)
                 drawable->SetOctant(nullptr);
             DecDrawableCount();
+            MarkOctreeDirty();
+        }
+    }
+
+    /// Refresh the stored culling data of a drawable after its bounding box or masks have changed in place.
+    void RefreshDrawableCullData(Drawable* drawable)
+    {
+        const unsigned index = drawable->octantIndex_;
+        if (index < drawables_.size() && drawables_[index] == drawable)
+        {
+            DrawableCullData& data = cullData_[index];
+            data.box_ = drawable->GetWorldBoundingBox();
+            data.viewMask_ = drawable->GetViewMask();
+            data.drawableFlags_ = drawable->GetDrawableFlags();
         }
     }
 
@@ -93,6 +128,16 @@ public:
     /// Return number of drawables.
     unsigned GetNumDrawables() const { return numDrawables_; }
 
+    /// Return the cached zone if it was stored with the given zone cache version, null otherwise.
+    Zone* GetCachedZone(unsigned version) const { return cachedZoneVersion_ == version ? cachedZone_ : nullptr; }
+
+    /// Cache the zone that wholly contains this octant, stamped with the current zone cache version.
+    void SetCachedZone(Zone* zone, unsigned version)
+    {
+        cachedZone_ = zone;
+        cachedZoneVersion_ = version;
+    }
+
     /// Return true if there are no drawable objects in this octant and child octants.
     bool IsEmpty() { return numDrawables_ == 0; }
 
@@ -110,6 +155,8 @@ protected:
     void GetDrawablesInternal(RayOctreeQuery& query) const;
     /// Return drawable objects only for a threaded ray query, called internally.
     void GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const;
+    /// Collect candidate drawables for a four-ray packet in a single traversal, called internally.
+    void GetDrawablesPacketInternal(RayQueryPacket& packet, unsigned activeMask) const;
 
     /// Increase drawable object count recursively.
     void IncDrawableCount()
@@ -141,6 +188,8 @@ protected:
     BoundingBox cullingBox_;
     /// Drawable objects.
     ea::vector<Drawable*> drawables_;
+    /// Culling-hot data of the drawable objects, parallel to drawables_. Queries stream through this instead of the drawables themselves.
+    ea::vector<DrawableCullData> cullData_;
     /// Child octants.
     Octant* children_[NUM_OCTANTS]{};
     /// World bounding box center.
@@ -157,6 +206,10 @@ protected:
     Octree* root_;
     /// Octant index relative to its siblings or ROOT_INDEX for root octant.
     unsigned index_;
+    /// Zone that wholly contains this octant, for accelerating drawable zone assignment.
+    Zone* cachedZone_{};
+    /// Zone cache version at the time the cached zone was stored. Zero is never valid.
+    unsigned cachedZoneVersion_{};
 };
 
 /// %Octree component. Should be added only to the root scene node.
@@ -190,15 +243,65 @@ public:
     void Raycast(RayOctreeQuery& query) const;
     /// Return the closest drawable object by a ray query.
     void RaycastSingle(RayOctreeQuery& query) const;
+    /// Perform a batch of ray queries. Rays are traversed in four-ray packets with SIMD octant tests when available,
+    /// and per-drawable tests are distributed over WorkQueue threads. Each query's results are sorted as in Raycast().
+    void RaycastBatch(RayOctreeQuery** queries, unsigned numQueries) const;
+    /// Queue a raycast for deferred execution and return a stop token that can be used to cancel it before it executes.
+    /// Queued raycasts are executed in packets within the per-frame asynchronous raycast budget, so completion may take
+    /// more than one frame. The callback is invoked on the main thread with the results sorted by distance. Raycasts
+    /// still queued when the octree is destroyed are dropped without invoking the callback.
+    StopToken RaycastAsync(const Ray& ray, const AsyncRaycastCallback& callback, RayQueryLevel level = RAY_TRIANGLE,
+        float maxDistance = M_INFINITY, DrawableFlags drawableFlags = DRAWABLE_ANY, unsigned viewMask = DEFAULT_VIEWMASK);
+    /// Queue a raycast returning only the closest result for deferred execution. Otherwise behaves like RaycastAsync().
+    StopToken RaycastSingleAsync(const Ray& ray, const AsyncRaycastCallback& callback, RayQueryLevel level = RAY_TRIANGLE,
+        float maxDistance = M_INFINITY, DrawableFlags drawableFlags = DRAWABLE_ANY, unsigned viewMask = DEFAULT_VIEWMASK);
     /// Return active Zone or default renderer zone if none found.
     /// Behavior is underfined if there are multiple active zones.
     Zone* GetZone(unsigned viewMask = DEFAULT_VIEWMASK) const;
     /// Return active Skybox. Behavior is underfined if there are multiple active skyboxes.
     Skybox* GetSkybox(unsigned viewMask = DEFAULT_VIEWMASK) const;
 
+    /// Set maximum milliseconds per frame to spend on executing asynchronous raycasts. At least one packet is executed
+    /// per frame regardless of the budget, so that queued raycasts always make progress.
+    void SetAsyncRaycastMs(int ms);
+
+    /// Return maximum milliseconds per frame spent on executing asynchronous raycasts.
+    int GetAsyncRaycastMs() const { return asyncRaycastMs_; }
+
+    /// Return number of queued asynchronous raycasts.
+    unsigned GetNumAsyncRaycasts() const { return asyncRaycasts_.size(); }
+
+    /// Set the per-frame drawable update budget. When more updates are queued, drawables recently in view still
+    /// update immediately while off-screen ones are amortized over subsequent frames. 0 disables the budget and
+    /// updates everything on the frame it was queued. Default 0.
+    void SetDrawableUpdateBudget(unsigned budget);
+
+    /// Set the maximum number of frames a deferred drawable update may wait before it is forced through
+    /// regardless of the budget. Default 4.
+    void SetMaxDrawableUpdateLag(unsigned frames);
+
+    /// Return per-frame drawable update budget.
+    unsigned GetDrawableUpdateBudget() const { return drawableUpdateBudget_; }
+
+    /// Return maximum frames a deferred drawable update may wait.
+    unsigned GetMaxDrawableUpdateLag() const { return maxDrawableUpdateLag_; }
+
+    /// Return number of drawable updates currently deferred past the budget.
+    unsigned GetNumDeferredDrawableUpdates() const { return deferredDrawableUpdates_.size(); }
+
     /// Return subdivision levels.
     unsigned GetNumLevels() const { return numLevels_; }
 
+    /// Return structure version, incremented whenever a drawable is added, removed or reinserted.
+    /// Can be used to detect whether cached query results are still valid.
+    unsigned GetStructureVersion() const { return structureVersion_; }
+
+    /// Invalidate the per-octant zone cache. Called whenever a zone is added, removed or modified.
+    void MarkZoneCacheDirty() { ++zoneCacheVersion_; }
+
+    /// Return zone cache version. Octants holding a cached zone with an older version re-resolve their zone lazily.
+    unsigned GetZoneCacheVersion() const { return zoneCacheVersion_; }
+
     /// Mark drawable object as requiring an update and a reinsertion.
     void QueueUpdate(Drawable* drawable);
     /// Cancel drawable object's update.
@@ -207,21 +310,54 @@ public:
     void DrawDebugGeometry(bool depthTest);
 
 private:
-    /// Handle render update in case of headless execution.
+    /// Queued asynchronous raycast.
+    struct AsyncRaycast
+    {
+        /// Query with builtin result storage.
+        ea::unique_ptr<RayOctreeQuery> query_;
+        /// Completion callback.
+        AsyncRaycastCallback callback_;
+        /// Token for cancelling the raycast before it executes.
+        StopToken stopToken_;
+        /// Whether to return only the closest result.
+        bool single_{};
+    };
+
+    /// Handle render update for executing asynchronous raycasts, and for updating the octree in case of headless execution.
     void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Execute queued asynchronous raycasts in packets until the time budget is exhausted.
+    void UpdateAsyncRaycasts();
+    /// Refresh the stored culling data of drawables that are queued for an update, so that queries between octree updates see fresh bounding boxes.
+    void RefreshQueuedCullData() const;
     /// Update octree size.
     void UpdateOctreeSize() { SetSize(worldBoundingBox_, numLevels_); }
 
     /// Drawable objects that require update.
     ea::vector<Drawable*> drawableUpdates_;
+    /// Drawable objects whose update was deferred past the budget, with the number of frames each has waited.
+    ea::vector<ea::pair<Drawable*, unsigned> > deferredDrawableUpdates_;
     /// Drawable objects that were inserted during threaded update phase.
     ea::vector<Drawable*> threadedDrawableUpdates_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
     /// Ray query temporary list of drawables.
     mutable ea::vector<Drawable*> rayQueryDrawables_;
+    /// Queued asynchronous raycasts.
+    ea::vector<AsyncRaycast> asyncRaycasts_;
+    /// Maximum milliseconds per frame to spend on executing asynchronous raycasts.
+    int asyncRaycastMs_{1};
+    /// Per-frame drawable update budget. 0 = unlimited.
+    unsigned drawableUpdateBudget_{};
+    /// Maximum frames a deferred drawable update may wait before it is forced through.
+    unsigned maxDrawableUpdateLag_{4};
     /// Subdivision level.
     unsigned numLevels_;
+    /// Structure version, incremented on every octant content change.
+    unsigned structureVersion_{};
+    /// Zone cache version, incremented on every zone change. Starts from one so that default-constructed octant stamps are invalid.
+    unsigned zoneCacheVersion_{1};
+
+    friend class Octant;
 };
 
 }
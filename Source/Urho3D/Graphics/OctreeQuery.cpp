@@ -51,6 +51,21 @@ void PointOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool insi
     }
 }
 
+void PointOctreeQuery::TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+{
+    while (start != end)
+    {
+        const DrawableCullData& data = *cullData++;
+        Drawable* drawable = *start++;
+
+        if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+        {
+            if (inside || data.box_.IsInside(point_))
+                result_.push_back(drawable);
+        }
+    }
+}
+
 Intersection SphereOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -73,6 +88,21 @@ void SphereOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool ins
     }
 }
 
+void SphereOctreeQuery::TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+{
+    while (start != end)
+    {
+        const DrawableCullData& data = *cullData++;
+        Drawable* drawable = *start++;
+
+        if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+        {
+            if (inside || sphere_.IsInsideFast(data.box_))
+                result_.push_back(drawable);
+        }
+    }
+}
+
 Intersection BoxOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -95,6 +125,21 @@ void BoxOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside
     }
 }
 
+void BoxOctreeQuery::TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+{
+    while (start != end)
+    {
+        const DrawableCullData& data = *cullData++;
+        Drawable* drawable = *start++;
+
+        if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+        {
+            if (inside || box_.IsInsideFast(data.box_))
+                result_.push_back(drawable);
+        }
+    }
+}
+
 Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -105,15 +150,103 @@ Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 
 void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
 {
+    if (inside)
+    {
+        while (start != end)
+        {
+            Drawable* drawable = *start++;
+
+            if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
+                result_.push_back(drawable);
+        }
+        return;
+    }
+
+    // Gather bounding boxes of mask-accepted drawables into packed SoA chunks and cull them with the SIMD batch kernel
+    const unsigned MAX_BATCH_SIZE = 32;
+    float minX[MAX_BATCH_SIZE], minY[MAX_BATCH_SIZE], minZ[MAX_BATCH_SIZE];
+    float maxX[MAX_BATCH_SIZE], maxY[MAX_BATCH_SIZE], maxZ[MAX_BATCH_SIZE];
+    Drawable* batch[MAX_BATCH_SIZE];
+    unsigned char insideFlags[MAX_BATCH_SIZE];
+
     while (start != end)
     {
-        Drawable* drawable = *start++;
+        unsigned batchSize = 0;
+        while (start != end && batchSize < MAX_BATCH_SIZE)
+        {
+            Drawable* drawable = *start++;
 
-        if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
+            if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
+            {
+                const BoundingBox& box = drawable->GetWorldBoundingBox();
+                minX[batchSize] = box.min_.x_;
+                minY[batchSize] = box.min_.y_;
+                minZ[batchSize] = box.min_.z_;
+                maxX[batchSize] = box.max_.x_;
+                maxY[batchSize] = box.max_.y_;
+                maxZ[batchSize] = box.max_.z_;
+                batch[batchSize++] = drawable;
+            }
+        }
+
+        frustum_.IsInsideFastBatch(batchSize, minX, minY, minZ, maxX, maxY, maxZ, insideFlags);
+        for (unsigned i = 0; i < batchSize; ++i)
         {
-            if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+            if (insideFlags[i])
+                result_.push_back(batch[i]);
+        }
+    }
+}
+
+void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+{
+    if (inside)
+    {
+        while (start != end)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+
+            if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
                 result_.push_back(drawable);
         }
+        return;
+    }
+
+    // Same batched SIMD culling as the pointer-based overload, but the masks and boxes are streamed from the octant's
+    // contiguous culling data instead of being gathered through the drawable pointers
+    const unsigned MAX_BATCH_SIZE = 32;
+    float minX[MAX_BATCH_SIZE], minY[MAX_BATCH_SIZE], minZ[MAX_BATCH_SIZE];
+    float maxX[MAX_BATCH_SIZE], maxY[MAX_BATCH_SIZE], maxZ[MAX_BATCH_SIZE];
+    Drawable* batch[MAX_BATCH_SIZE];
+    unsigned char insideFlags[MAX_BATCH_SIZE];
+
+    while (start != end)
+    {
+        unsigned batchSize = 0;
+        while (start != end && batchSize < MAX_BATCH_SIZE)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+
+            if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+            {
+                minX[batchSize] = data.box_.min_.x_;
+                minY[batchSize] = data.box_.min_.y_;
+                minZ[batchSize] = data.box_.min_.z_;
+                maxX[batchSize] = data.box_.max_.x_;
+                maxY[batchSize] = data.box_.max_.y_;
+                maxZ[batchSize] = data.box_.max_.z_;
+                batch[batchSize++] = drawable;
+            }
+        }
+
+        frustum_.IsInsideFastBatch(batchSize, minX, minY, minZ, maxX, maxY, maxZ, insideFlags);
+        for (unsigned i = 0; i < batchSize; ++i)
+        {
+            if (insideFlags[i])
+                result_.push_back(batch[i]);
+        }
     }
 }
 
@@ -134,4 +267,16 @@ void AllContentOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool
     }
 }
 
+void AllContentOctreeQuery::TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+{
+    while (start != end)
+    {
+        const DrawableCullData& data = *cullData++;
+        Drawable* drawable = *start++;
+
+        if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+            result_.push_back(drawable);
+    }
+}
+
 }
@@ -37,6 +37,18 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Culling-hot data of a drawable. Octants keep these in an array parallel to their drawable list, so that queries
+/// stream through contiguous memory instead of touching one cache line per drawable through a pointer.
+struct DrawableCullData
+{
+    /// World-space bounding box.
+    BoundingBox box_;
+    /// View mask.
+    unsigned viewMask_;
+    /// Drawable flags.
+    DrawableFlags drawableFlags_;
+};
+
 /// Base class for octree queries.
 class URHO3D_API OctreeQuery : private NonCopyable
 {
@@ -57,6 +69,13 @@ public:
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside) = 0;
 
+    /// Intersection test for drawables using the octant's contiguous culling data. The default implementation forwards
+    /// to the pointer-based overload, so custom queries keep working without changes.
+    virtual void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside)
+    {
+        TestDrawables(start, end, inside);
+    }
+
     /// Result vector reference.
     ea::vector<Drawable*>& result_;
     /// Drawable flags to include.
@@ -81,6 +100,8 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override;
 
     /// Point.
     Vector3 point_;
@@ -102,6 +123,8 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override;
 
     /// Sphere.
     Sphere sphere_;
@@ -123,6 +146,8 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override;
 
     /// Bounding box.
     BoundingBox box_;
@@ -144,6 +169,8 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override;
 
     /// Frustum.
     Frustum frustum_;
@@ -272,6 +299,8 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override;
 };
 
 }
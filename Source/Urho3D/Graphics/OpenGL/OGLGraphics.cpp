@@ -41,6 +41,7 @@
 #include "../../Graphics/VertexBuffer.h"
 #include "../../IO/File.h"
 #include "../../IO/Log.h"
+#include "../../Resource/Image.h"
 #include "../../Resource/ResourceCache.h"
 
 #include <SDL/SDL.h>
@@ -593,6 +594,54 @@ bool Graphics::TakeScreenShot(Image& destImage)
     return true;
 }
 
+bool Graphics::TakeScreenShotAsync()
+{
+    if (!IsInitialized())
+        return false;
+
+    if (IsDeviceLost())
+    {
+        URHO3D_LOGERROR("Can not take screenshot while device is lost");
+        return false;
+    }
+
+#ifndef GL_ES_VERSION_2_0
+    if (gl3Support)
+    {
+        ScreenShotReadback& readback = impl_->screenShotReadbacks_[impl_->screenShotWriteIndex_];
+        // All readback slots still in flight
+        if (readback.pending_)
+            return false;
+
+        ResetRenderTargets();
+
+        // Read into a pixel buffer object and insert a fence; the data is mapped and delivered once the fence
+        // signals, so the pipeline is never stalled
+        if (!readback.pbo_)
+            glGenBuffers(1, &readback.pbo_);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo_);
+        glBufferData(GL_PIXEL_PACK_BUFFER, width_ * height_ * 3, nullptr, GL_STREAM_READ);
+        glReadPixels(0, 0, width_, height_, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        readback.sync_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        readback.width_ = width_;
+        readback.height_ = height_;
+        readback.pending_ = true;
+        impl_->screenShotWriteIndex_ = (impl_->screenShotWriteIndex_ + 1) % NUM_SCREENSHOT_READBACKS;
+        return true;
+    }
+#endif
+
+    // Without fence syncs fall back to a synchronous capture, still delivered through the event
+    SharedPtr<Image> image(MakeShared<Image>(context_));
+    if (!TakeScreenShot(*image))
+        return false;
+
+    SendScreenShotEvent(image);
+    return true;
+}
+
 bool Graphics::BeginFrame()
 {
     if (!IsInitialized() || IsDeviceLost())
@@ -639,6 +688,9 @@ void Graphics::EndFrame()
 
     SendEvent(E_ENDRENDERING);
 
+    UpdateGPUTimings();
+    UpdateScreenShotReadbacks();
+
     SDL_GL_SwapWindow(window_);
 
     // Clean up too large scratch buffers
@@ -655,6 +707,209 @@ void Graphics::EndFrame()
     }
 }
 
+bool Graphics::GetGPUTimingSupport() const
+{
+#ifndef GL_ES_VERSION_2_0
+    return gl3Support && glQueryCounter && glGetQueryObjectui64v;
+#else
+    return false;
+#endif
+}
+
+void Graphics::BeginGPUTiming(const ea::string& name)
+{
+#ifndef GL_ES_VERSION_2_0
+    if (!gpuTimingEnabled_ || !impl_->context_ || !GetGPUTimingSupport())
+        return;
+
+    GPUTimingFrame& frame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    // Refuse to nest timed sections or to add to a frame whose results are still pending
+    if (frame.pending_ || impl_->currentTimingSection_ != M_MAX_UNSIGNED)
+        return;
+
+    GPUTimingQuery query;
+    query.name_ = name;
+    query.beginQuery_ = GetOrCreateTimingQuery();
+    query.endQuery_ = GetOrCreateTimingQuery();
+    glQueryCounter(query.beginQuery_, GL_TIMESTAMP);
+
+    impl_->currentTimingSection_ = frame.queries_.size();
+    frame.queries_.push_back(ea::move(query));
+#endif
+}
+
+void Graphics::EndGPUTiming()
+{
+#ifndef GL_ES_VERSION_2_0
+    if (impl_->currentTimingSection_ == M_MAX_UNSIGNED)
+        return;
+
+    GPUTimingFrame& frame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    glQueryCounter(frame.queries_[impl_->currentTimingSection_].endQuery_, GL_TIMESTAMP);
+    impl_->currentTimingSection_ = M_MAX_UNSIGNED;
+#endif
+}
+
+void Graphics::UpdateGPUTimings()
+{
+#ifndef GL_ES_VERSION_2_0
+    // Close the frame being written and advance the ring
+    GPUTimingFrame& writeFrame = impl_->timingFrames_[impl_->timingWriteFrame_];
+    if (!writeFrame.queries_.empty())
+    {
+        writeFrame.pending_ = true;
+        impl_->timingWriteFrame_ = (impl_->timingWriteFrame_ + 1) % NUM_GPU_TIMING_FRAMES;
+    }
+
+    // Resolve pending frames oldest first. Do not wait for query results unless the ring is about to wrap around
+    while (impl_->timingFrames_[impl_->timingReadFrame_].pending_)
+    {
+        GPUTimingFrame& readFrame = impl_->timingFrames_[impl_->timingReadFrame_];
+        if (impl_->timingReadFrame_ != impl_->timingWriteFrame_)
+        {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(readFrame.queries_.back().endQuery_, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+
+        gpuTimingResults_.clear();
+        for (GPUTimingQuery& query : readFrame.queries_)
+        {
+            GLuint64 beginTime = 0;
+            GLuint64 endTime = 0;
+            glGetQueryObjectui64v(query.beginQuery_, GL_QUERY_RESULT, &beginTime);
+            glGetQueryObjectui64v(query.endQuery_, GL_QUERY_RESULT, &endTime);
+
+            GPUTimingResult result;
+            result.name_ = ea::move(query.name_);
+            result.gpuTimeMs_ = (float)((endTime - beginTime) * (1.0 / 1000000.0));
+            gpuTimingResults_.push_back(ea::move(result));
+
+            impl_->freeTimingQueries_.push_back(query.beginQuery_);
+            impl_->freeTimingQueries_.push_back(query.endQuery_);
+        }
+
+        readFrame.queries_.clear();
+        readFrame.pending_ = false;
+        impl_->timingReadFrame_ = (impl_->timingReadFrame_ + 1) % NUM_GPU_TIMING_FRAMES;
+    }
+
+    // When timing has been disabled, keep draining the ring but do not expose stale results
+    if (!gpuTimingEnabled_)
+        gpuTimingResults_.clear();
+#endif
+}
+
+void Graphics::CleanupGPUTimingQueries()
+{
+#ifndef GL_ES_VERSION_2_0
+    for (GPUTimingFrame& frame : impl_->timingFrames_)
+    {
+        for (GPUTimingQuery& query : frame.queries_)
+        {
+            if (!IsDeviceLost())
+            {
+                glDeleteQueries(1, &query.beginQuery_);
+                glDeleteQueries(1, &query.endQuery_);
+            }
+        }
+        frame.queries_.clear();
+        frame.pending_ = false;
+    }
+
+    if (!IsDeviceLost())
+    {
+        for (unsigned query : impl_->freeTimingQueries_)
+            glDeleteQueries(1, &query);
+    }
+    impl_->freeTimingQueries_.clear();
+
+    impl_->timingWriteFrame_ = 0;
+    impl_->timingReadFrame_ = 0;
+    impl_->currentTimingSection_ = M_MAX_UNSIGNED;
+    gpuTimingResults_.clear();
+#endif
+}
+
+void Graphics::UpdateScreenShotReadbacks()
+{
+#ifndef GL_ES_VERSION_2_0
+    while (impl_->screenShotReadbacks_[impl_->screenShotReadIndex_].pending_)
+    {
+        ScreenShotReadback& readback = impl_->screenShotReadbacks_[impl_->screenShotReadIndex_];
+        // Deliver in submission order; stop at the first readback the GPU has not finished yet
+        const GLenum status = glClientWaitSync((GLsync)readback.sync_, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+            return;
+
+        glDeleteSync((GLsync)readback.sync_);
+        readback.sync_ = nullptr;
+        readback.pending_ = false;
+        impl_->screenShotReadIndex_ = (impl_->screenShotReadIndex_ + 1) % NUM_SCREENSHOT_READBACKS;
+
+        if (status == GL_WAIT_FAILED)
+            continue;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo_);
+        const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.width_ * readback.height_ * 3, GL_MAP_READ_BIT);
+        if (data)
+        {
+            SharedPtr<Image> image(MakeShared<Image>(context_));
+            image->SetSize(readback.width_, readback.height_, 3);
+            memcpy(image->GetData(), data, (size_t)(readback.width_ * readback.height_ * 3));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            image->FlipVertical();
+            SendScreenShotEvent(image);
+        }
+        else
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+#endif
+}
+
+void Graphics::CleanupScreenShotReadbacks()
+{
+#ifndef GL_ES_VERSION_2_0
+    for (ScreenShotReadback& readback : impl_->screenShotReadbacks_)
+    {
+        if (!IsDeviceLost())
+        {
+            if (readback.sync_)
+                glDeleteSync((GLsync)readback.sync_);
+            if (readback.pbo_)
+                glDeleteBuffers(1, &readback.pbo_);
+        }
+        readback.sync_ = nullptr;
+        readback.pbo_ = 0;
+        readback.pending_ = false;
+    }
+
+    impl_->screenShotWriteIndex_ = 0;
+    impl_->screenShotReadIndex_ = 0;
+#endif
+}
+
+unsigned Graphics::GetOrCreateTimingQuery()
+{
+#ifndef GL_ES_VERSION_2_0
+    if (!impl_->freeTimingQueries_.empty())
+    {
+        unsigned query = impl_->freeTimingQueries_.back();
+        impl_->freeTimingQueries_.pop_back();
+        return query;
+    }
+
+    unsigned query = 0;
+    glGenQueries(1, &query);
+    return query;
+#else
+    return 0;
+#endif
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     PrepareDraw();
@@ -2405,6 +2660,8 @@ void Graphics::Release(bool clearGPUObjects, bool closeWindow)
     }
 
     CleanupFramebuffers();
+    CleanupGPUTimingQueries();
+    CleanupScreenShotReadbacks();
     impl_->depthTextures_.clear();
 
     // End fullscreen mode first to counteract transition and getting stuck problems on OS X
@@ -3318,6 +3575,8 @@ void Graphics::SetTextureUnitMappings()
     textureUnits_["LightSpotMap"] = TU_LIGHTSHAPE;
     textureUnits_["LightCubeMap"] = TU_LIGHTSHAPE;
     textureUnits_["ShadowMap"] = TU_SHADOWMAP;
+    textureUnits_["MorphDeltaMap"] = TU_CUSTOM1;
+    textureUnits_["SkinMatrixMap"] = TU_CUSTOM2;
 #ifndef GL_ES_VERSION_2_0
     textureUnits_["VolumeMap"] = TU_VOLUMEMAP;
     textureUnits_["FaceSelectCubeMap"] = TU_FACESELECT;
@@ -91,6 +91,47 @@ class Context;
 using ConstantBufferMap = ea::unordered_map<unsigned, SharedPtr<ConstantBuffer> >;
 using ShaderProgramMap = ea::unordered_map<ea::pair<ShaderVariation*, ShaderVariation*>, SharedPtr<ShaderProgram> >;
 
+/// Number of frames of GPU timestamp queries kept in flight before results are read back.
+static const unsigned NUM_GPU_TIMING_FRAMES = 4;
+
+/// Timestamp query object pair bracketing one GPU timed section.
+struct GPUTimingQuery
+{
+    /// Name of the timed section.
+    ea::string name_;
+    /// Query object written at the start of the section.
+    unsigned beginQuery_{};
+    /// Query object written at the end of the section.
+    unsigned endQuery_{};
+};
+
+/// One frame's worth of issued GPU timestamp queries.
+struct GPUTimingFrame
+{
+    /// Queries in submission order.
+    ea::vector<GPUTimingQuery> queries_;
+    /// Submitted and awaiting result readback flag.
+    bool pending_{};
+};
+
+/// Number of slots in the asynchronous screenshot readback ring.
+static const unsigned NUM_SCREENSHOT_READBACKS = 3;
+
+/// One in-flight asynchronous screenshot readback.
+struct ScreenShotReadback
+{
+    /// Pixel buffer object receiving the framebuffer contents.
+    unsigned pbo_{};
+    /// Fence sync object signaled when the GPU has finished the transfer.
+    void* sync_{};
+    /// Captured width.
+    int width_{};
+    /// Captured height.
+    int height_{};
+    /// Issued and awaiting delivery flag.
+    bool pending_{};
+};
+
 /// Cached state of a frame buffer object.
 struct FrameBufferObject
 {
@@ -163,6 +204,22 @@ private:
     ShaderProgram* shaderProgram_{};
     /// Linked shader programs.
     ShaderProgramMap shaderPrograms_;
+    /// Ring of per-frame GPU timestamp queries.
+    GPUTimingFrame timingFrames_[NUM_GPU_TIMING_FRAMES];
+    /// Ring index of the frame currently receiving timestamp queries.
+    unsigned timingWriteFrame_{};
+    /// Ring index of the oldest frame awaiting timestamp query readback.
+    unsigned timingReadFrame_{};
+    /// Index of the currently open timed section in the write frame, or M_MAX_UNSIGNED if none.
+    unsigned currentTimingSection_{M_MAX_UNSIGNED};
+    /// Unused timestamp query objects available for reuse.
+    ea::vector<unsigned> freeTimingQueries_;
+    /// Ring of asynchronous screenshot readbacks.
+    ScreenShotReadback screenShotReadbacks_[NUM_SCREENSHOT_READBACKS];
+    /// Ring index of the next screenshot readback slot to issue into.
+    unsigned screenShotWriteIndex_{};
+    /// Ring index of the oldest screenshot readback awaiting delivery.
+    unsigned screenShotReadIndex_{};
     /// Need FBO commit flag.
     bool fboDirty_{};
     /// Need vertex attribute pointer update flag.
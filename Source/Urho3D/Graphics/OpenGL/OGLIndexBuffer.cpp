@@ -144,10 +144,13 @@ bool IndexBuffer::SetDataRange(const void* data, unsigned start, unsigned count,
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetIndexBuffer(this);
-            if (!discard || start != 0)
-                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, start * (size_t)indexSize_, count * indexSize_, data);
-            else
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * (size_t)indexSize_, data, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            if (discard)
+            {
+                // Orphan the full buffer storage before the partial write so that the driver does not stall
+                // if the old contents are still in use
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount_ * (size_t)indexSize_, nullptr, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            }
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, start * (size_t)indexSize_, count * indexSize_, data);
         }
         else
         {
@@ -262,6 +265,24 @@ bool IndexBuffer::UpdateToGPU()
         return false;
 }
 
+bool IndexBuffer::GetData(void* dest) const
+{
+    if (!dest || !indexCount_ || !indexSize_)
+        return false;
+
+#ifndef GL_ES_VERSION_2_0
+    if (object_.name_ && graphics_ && !graphics_->IsDeviceLost())
+    {
+        // Binding only changes the device state, not the buffer contents
+        graphics_->SetIndexBuffer(const_cast<IndexBuffer*>(this));
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount_ * (size_t)indexSize_, dest);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
 void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     // Never called on OpenGL
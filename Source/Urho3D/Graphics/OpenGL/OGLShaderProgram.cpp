@@ -25,8 +25,11 @@
 #include "../../Graphics/ConstantBuffer.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/Shader.h"
 #include "../../Graphics/ShaderProgram.h"
 #include "../../Graphics/ShaderVariation.h"
+#include "../../IO/File.h"
+#include "../../IO/FileSystem.h"
 #include "../../IO/Log.h"
 
 #include "../../DebugNew.h"
@@ -55,6 +58,21 @@ static unsigned NumberPostfix(const ea::string& str)
     return M_MAX_UNSIGNED;
 }
 
+#ifndef GL_ES_VERSION_2_0
+static unsigned GetDriverHash()
+{
+    // Program binaries are driver-specific blobs, so key them to the exact driver and GL version in use
+    ea::string driver;
+    if (const char* vendor = (const char*)glGetString(GL_VENDOR))
+        driver += vendor;
+    if (const char* renderer = (const char*)glGetString(GL_RENDERER))
+        driver += renderer;
+    if (const char* version = (const char*)glGetString(GL_VERSION))
+        driver += version;
+    return StringHash(driver).Value();
+}
+#endif
+
 unsigned ShaderProgram::globalFrameNumber = 0;
 const void* ShaderProgram::globalParameterSources[MAX_SHADER_PARAMETER_GROUPS];
 
@@ -103,6 +121,7 @@ void ShaderProgram::Release()
         object_.name_ = 0;
         linkerOutput_.clear();
         shaderParameters_.clear();
+        parametersFilter_ = 0;
         vertexAttributes_.clear();
         usedVertexAttributes_ = 0;
 
@@ -127,23 +146,34 @@ bool ShaderProgram::Link()
         return false;
     }
 
-    glAttachShader(object_.name_, vertexShader_->GetGPUObjectName());
-    glAttachShader(object_.name_, pixelShader_->GetGPUObjectName());
-    glLinkProgram(object_.name_);
-
-    int linked, length;
-    glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
-    if (!linked)
+    if (!LoadBinary())
     {
-        glGetProgramiv(object_.name_, GL_INFO_LOG_LENGTH, &length);
-        linkerOutput_.resize((unsigned) length);
-        int outLength;
-        glGetProgramInfoLog(object_.name_, length, &outLength, &linkerOutput_[0]);
-        glDeleteProgram(object_.name_);
-        object_.name_ = 0;
+        glAttachShader(object_.name_, vertexShader_->GetGPUObjectName());
+        glAttachShader(object_.name_, pixelShader_->GetGPUObjectName());
+#ifndef GL_ES_VERSION_2_0
+        // Ask the driver to keep a retrievable binary so that the link result can be cached on disk
+        if (GLEW_ARB_get_program_binary)
+            glProgramParameteri(object_.name_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+        glLinkProgram(object_.name_);
+
+        int linked, length;
+        glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            glGetProgramiv(object_.name_, GL_INFO_LOG_LENGTH, &length);
+            linkerOutput_.resize((unsigned) length);
+            int outLength;
+            glGetProgramInfoLog(object_.name_, length, &outLength, &linkerOutput_[0]);
+            glDeleteProgram(object_.name_);
+            object_.name_ = 0;
+        }
+        else
+        {
+            linkerOutput_.clear();
+            SaveBinary();
+        }
     }
-    else
-        linkerOutput_.clear();
 
     if (!object_.name_)
         return false;
@@ -296,7 +326,11 @@ bool ShaderProgram::Link()
 #endif
 
             if (store)
-                shaderParameters_[StringHash(paramName)] = parameter;
+            {
+                StringHash nameHash(paramName);
+                shaderParameters_[nameHash] = parameter;
+                parametersFilter_ |= 1ull << (nameHash.Value() & 63u);
+            }
         }
         else if (location >= 0 && name[0] == 's')
         {
@@ -320,6 +354,120 @@ bool ShaderProgram::Link()
     return true;
 }
 
+ea::string ShaderProgram::GetBinaryName() const
+{
+    const ea::string& cacheDir = graphics_->GetShaderCacheDir();
+    if (cacheDir.empty() || !vertexShader_ || !pixelShader_)
+        return ea::string();
+
+    return cacheDir + vertexShader_->GetName() + "_" + StringHash(vertexShader_->GetDefines()).ToString() + "_" +
+        pixelShader_->GetName() + "_" + StringHash(pixelShader_->GetDefines()).ToString() + ".glp";
+}
+
+#ifndef GL_ES_VERSION_2_0
+
+bool ShaderProgram::LoadBinary()
+{
+    if (!GLEW_ARB_get_program_binary)
+        return false;
+
+    ea::string binaryName = GetBinaryName();
+    if (binaryName.empty())
+        return false;
+
+    auto* fileSystem = graphics_->GetSubsystem<FileSystem>();
+    if (!fileSystem->FileExists(binaryName))
+        return false;
+
+    // If shader source code is loaded from a package, its timestamp will be zero. Else check that the binary is not
+    // older than either source file
+    Shader* vsOwner = vertexShader_->GetOwner();
+    Shader* psOwner = pixelShader_->GetOwner();
+    unsigned sourceTimeStamp = Max(vsOwner ? vsOwner->GetTimeStamp() : 0u, psOwner ? psOwner->GetTimeStamp() : 0u);
+    if (sourceTimeStamp && fileSystem->GetLastModifiedTime(binaryName) < sourceTimeStamp)
+        return false;
+
+    File file(graphics_->GetContext(), binaryName);
+    if (!file.IsOpen() || file.ReadFileID() != "UGLP")
+        return false;
+
+    // Reject binaries produced by a different driver or GL version
+    if (file.ReadUInt() != GetDriverHash())
+        return false;
+
+    unsigned format = file.ReadUInt();
+    unsigned length = file.ReadUInt();
+    if (!length)
+        return false;
+
+    ea::vector<unsigned char> binary(length);
+    if (file.Read(&binary[0], length) != length)
+        return false;
+
+    glProgramBinary(object_.name_, format, &binary[0], (GLsizei)length);
+
+    // The driver may still reject the binary, in which case fall back to a normal link
+    int linked = 0;
+    glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
+    if (linked)
+    {
+        URHO3D_LOGDEBUG(
+            "Loaded cached shader program " + vertexShader_->GetFullName() + " " + pixelShader_->GetFullName());
+    }
+    return linked != 0;
+}
+
+void ShaderProgram::SaveBinary()
+{
+    if (!GLEW_ARB_get_program_binary)
+        return;
+
+    ea::string binaryName = GetBinaryName();
+    if (binaryName.empty())
+        return;
+
+    // Do not save if either source is from a package, as the binary could then never be timestamp-validated
+    Shader* vsOwner = vertexShader_->GetOwner();
+    Shader* psOwner = pixelShader_->GetOwner();
+    if (!vsOwner || !psOwner || !vsOwner->GetTimeStamp() || !psOwner->GetTimeStamp())
+        return;
+
+    int length = 0;
+    glGetProgramiv(object_.name_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ea::vector<unsigned char> binary((unsigned)length);
+    GLenum format = 0;
+    GLsizei outLength = 0;
+    glGetProgramBinary(object_.name_, length, &outLength, &format, &binary[0]);
+    if (!outLength)
+        return;
+
+    auto* fileSystem = graphics_->GetSubsystem<FileSystem>();
+    ea::string path = GetPath(binaryName);
+    if (!fileSystem->DirExists(path))
+        fileSystem->CreateDir(path);
+
+    File file(graphics_->GetContext(), binaryName, FILE_WRITE);
+    if (!file.IsOpen())
+        return;
+
+    file.WriteFileID("UGLP");
+    file.WriteUInt(GetDriverHash());
+    file.WriteUInt((unsigned)format);
+    file.WriteUInt((unsigned)outLength);
+    file.Write(&binary[0], (unsigned)outLength);
+}
+
+#else
+
+bool ShaderProgram::LoadBinary() { return false; }
+
+void ShaderProgram::SaveBinary() {}
+
+#endif
+
 ShaderVariation* ShaderProgram::GetVertexShader() const
 {
     return vertexShader_;
@@ -332,11 +480,14 @@ ShaderVariation* ShaderProgram::GetPixelShader() const
 
 bool ShaderProgram::HasParameter(StringHash param) const
 {
-    return shaderParameters_.find(param) != shaderParameters_.end();
+    return MayHaveParameter(param) && shaderParameters_.find(param) != shaderParameters_.end();
 }
 
 const ShaderParameter* ShaderProgram::GetParameter(StringHash param) const
 {
+    if (!MayHaveParameter(param))
+        return nullptr;
+
     auto i = shaderParameters_.find(param);
     if (i != shaderParameters_.end())
         return &i->second;
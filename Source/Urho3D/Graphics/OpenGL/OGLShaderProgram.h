@@ -59,6 +59,10 @@ public:
     /// Return whether uses a shader parameter.
     bool HasParameter(StringHash param) const;
 
+    /// Return whether may use a shader parameter. False positives are possible, but a false return is certain, which
+    /// allows skipping the parameter map lookup for parameters the program does not use.
+    bool MayHaveParameter(StringHash param) const { return (parametersFilter_ & (1ull << (param.Value() & 63u))) != 0; }
+
     /// Return whether uses a texture unit.
     bool HasTextureUnit(TextureUnit unit) const { return useTextureUnits_[unit]; }
 
@@ -88,12 +92,21 @@ public:
     static void ClearGlobalParameterSource(ShaderParameterGroup group);
 
 private:
+    /// Return the program binary cache file name, or empty if binary caching is unavailable.
+    ea::string GetBinaryName() const;
+    /// Try to load a cached program binary instead of linking. Return true on success.
+    bool LoadBinary();
+    /// Save the linked program binary to the shader cache directory.
+    void SaveBinary();
+
     /// Vertex shader.
     WeakPtr<ShaderVariation> vertexShader_;
     /// Pixel shader.
     WeakPtr<ShaderVariation> pixelShader_;
     /// Shader parameters.
     ea::unordered_map<StringHash, ShaderParameter> shaderParameters_;
+    /// Bitmask of shader parameter name hashes for fast rejection of unused parameters.
+    unsigned long long parametersFilter_{};
     /// Texture unit use.
     bool useTextureUnits_[MAX_TEXTURE_UNITS]{};
     /// Vertex attributes.
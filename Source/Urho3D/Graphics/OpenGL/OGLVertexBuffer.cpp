@@ -95,6 +95,8 @@ bool VertexBuffer::SetData(const void* data)
     if (shadowData_ && data != shadowData_.get())
         memcpy(shadowData_.get(), data, vertexCount_ * (size_t)vertexSize_);
 
+    UpdateShadowDataRange(data, 0, vertexCount_);
+
     if (object_.name_)
     {
         if (!graphics_->IsDeviceLost())
@@ -142,15 +144,20 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
     if (shadowData_ && shadowData_.get() + start * vertexSize_ != data)
         memcpy(shadowData_.get() + start * vertexSize_, data, count * (size_t)vertexSize_);
 
+    UpdateShadowDataRange(data, start, count);
+
     if (object_.name_)
     {
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetVBO(object_.name_);
-            if (!discard || start != 0)
-                glBufferSubData(GL_ARRAY_BUFFER, start * (size_t)vertexSize_, count * vertexSize_, data);
-            else
-                glBufferData(GL_ARRAY_BUFFER, count * (size_t)vertexSize_, data, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            if (discard)
+            {
+                // Orphan the full buffer storage before the partial write so that the driver does not stall
+                // if the old contents are still in use
+                glBufferData(GL_ARRAY_BUFFER, vertexCount_ * (size_t)vertexSize_, nullptr, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, start * (size_t)vertexSize_, count * vertexSize_, data);
         }
         else
         {
@@ -265,6 +272,23 @@ bool VertexBuffer::UpdateToGPU()
         return false;
 }
 
+bool VertexBuffer::GetData(void* dest) const
+{
+    if (!dest || !vertexCount_ || !vertexSize_)
+        return false;
+
+#ifndef GL_ES_VERSION_2_0
+    if (object_.name_ && graphics_ && !graphics_->IsDeviceLost())
+    {
+        graphics_->SetVBO(object_.name_);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount_ * (size_t)vertexSize_, dest);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
 void* VertexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
 {
     // Never called on OpenGL
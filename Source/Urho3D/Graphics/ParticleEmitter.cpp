@@ -165,13 +165,30 @@ void ParticleEmitter::Update(const FrameInfo& frame)
         }
     }
 
-    // Update existing particles
+    // Update existing particles. Hoist all effect parameters out of the loop and precompute the integration
+    // factors so that the per-particle work reduces to multiply-adds
     Vector3 relativeConstantForce = node_->GetWorldRotation().Inverse() * effect_->GetConstantForce();
     // If billboards are not relative, apply scaling to the position update
     Vector3 scaleVector = Vector3::ONE;
     if (scaled_ && !relative_)
         scaleVector = node_->GetWorldScale();
 
+    const Vector3& constantForce = effect_->GetConstantForce();
+    const bool hasForce = constantForce != Vector3::ZERO;
+    // velocity += dt * force; velocity += dt * (-damping * velocity)
+    const Vector3 forceAdd = lastTimeStep_ * (relative_ ? relativeConstantForce : constantForce);
+    const float dampingForce = effect_->GetDampingForce();
+    const float velocityMul = 1.0f - lastTimeStep_ * dampingForce;
+    const float sizeAdd = effect_->GetSizeAdd();
+    const float sizeMul = effect_->GetSizeMul();
+    const bool hasSizeChange = sizeAdd != 0.0f || sizeMul != 1.0f;
+    const float scaleAdd = lastTimeStep_ * sizeAdd;
+    const float scaleMul = lastTimeStep_ * (sizeMul - 1.0f) + 1.0f;
+    const ea::vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
+    const ea::vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
+
+    freeParticles_.clear();
+
     for (unsigned i = 0; i < particles_.size(); ++i)
     {
         Particle& particle = particles_[i];
@@ -185,26 +202,16 @@ void ParticleEmitter::Update(const FrameInfo& frame)
             if (particle.timer_ >= particle.timeToLive_)
             {
                 billboard.enabled_ = false;
+                freeParticles_.push_back(i);
                 continue;
             }
             particle.timer_ += lastTimeStep_;
 
             // Velocity & position
-            const Vector3& constantForce = effect_->GetConstantForce();
-            if (constantForce != Vector3::ZERO)
-            {
-                if (relative_)
-                    particle.velocity_ += lastTimeStep_ * relativeConstantForce;
-                else
-                    particle.velocity_ += lastTimeStep_ * constantForce;
-            }
-
-            float dampingForce = effect_->GetDampingForce();
+            if (hasForce)
+                particle.velocity_ += forceAdd;
             if (dampingForce != 0.0f)
-            {
-                Vector3 force = -dampingForce * particle.velocity_;
-                particle.velocity_ += lastTimeStep_ * force;
-            }
+                particle.velocity_ *= velocityMul;
             billboard.position_ += lastTimeStep_ * particle.velocity_ * scaleVector;
             billboard.direction_ = particle.velocity_.Normalized();
 
@@ -212,21 +219,18 @@ void ParticleEmitter::Update(const FrameInfo& frame)
             billboard.rotation_ += lastTimeStep_ * particle.rotationSpeed_;
 
             // Scaling
-            float sizeAdd = effect_->GetSizeAdd();
-            float sizeMul = effect_->GetSizeMul();
-            if (sizeAdd != 0.0f || sizeMul != 1.0f)
+            if (hasSizeChange)
             {
-                particle.scale_ += lastTimeStep_ * sizeAdd;
+                particle.scale_ += scaleAdd;
                 if (particle.scale_ < 0.0f)
                     particle.scale_ = 0.0f;
                 if (sizeMul != 1.0f)
-                    particle.scale_ *= (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
+                    particle.scale_ *= scaleMul;
                 billboard.size_ = particle.size_ * particle.scale_;
             }
 
             // Color interpolation
             unsigned& index = particle.colorIndex_;
-            const ea::vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
             if (index < colorFrames_.size())
             {
                 if (index < colorFrames_.size() - 1)
@@ -242,7 +246,6 @@ void ParticleEmitter::Update(const FrameInfo& frame)
 
             // Texture animation
             unsigned& texIndex = particle.texIndex_;
-            const ea::vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
             if (textureFrames_.size() && texIndex < textureFrames_.size() - 1)
             {
                 if (particle.timer_ >= textureFrames_[texIndex + 1].time_)
@@ -252,6 +255,8 @@ void ParticleEmitter::Update(const FrameInfo& frame)
                 }
             }
         }
+        else
+            freeParticles_.push_back(i);
     }
 
     if (needCommit)
@@ -547,15 +552,31 @@ bool ParticleEmitter::EmitNewParticle()
     return true;
 }
 
-unsigned ParticleEmitter::GetFreeParticle() const
+unsigned ParticleEmitter::GetFreeParticle()
 {
-    for (unsigned i = 0; i < billboards_.size(); ++i)
+    // Consume the free indices cached during the last update. Skip stale entries, as billboards may have been
+    // enabled from the outside in between
+    while (!freeParticles_.empty())
+    {
+        unsigned index = freeParticles_.back();
+        freeParticles_.pop_back();
+        if (index < billboards_.size() && !billboards_[index].enabled_)
+            return index;
+    }
+
+    // Cache empty or stale (e.g. first emission after resize); fall back to a scan and cache the rest
+    for (unsigned i = billboards_.size() - 1; i < billboards_.size(); --i)
     {
         if (!billboards_[i].enabled_)
-            return i;
+            freeParticles_.push_back(i);
     }
 
-    return M_MAX_UNSIGNED;
+    if (freeParticles_.empty())
+        return M_MAX_UNSIGNED;
+
+    unsigned index = freeParticles_.back();
+    freeParticles_.pop_back();
+    return index;
 }
 
 bool ParticleEmitter::CheckActiveParticles() const
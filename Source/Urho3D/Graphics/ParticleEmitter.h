@@ -119,8 +119,8 @@ protected:
 
     /// Create a new particle. Return true if there was room.
     bool EmitNewParticle();
-    /// Return a free particle index.
-    unsigned GetFreeParticle() const;
+    /// Return a free particle index, consuming the free index cache. Return M_MAX_UNSIGNED if no room.
+    unsigned GetFreeParticle();
     /// Return whether has active particles.
     bool CheckActiveParticles() const;
 
@@ -134,6 +134,8 @@ private:
     SharedPtr<ParticleEffect> effect_;
     /// Particles.
     ea::vector<Particle> particles_;
+    /// Free particle indices, rebuilt during update to avoid scanning all billboards per emitted particle.
+    ea::vector<unsigned> freeParticles_;
     /// Active/inactive period timer.
     float periodTimer_;
     /// New particle emission timer.
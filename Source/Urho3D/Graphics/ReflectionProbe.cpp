@@ -0,0 +1,400 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/DebugRenderer.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/GraphicsEvents.h"
+#include "../Graphics/ReflectionProbe.h"
+#include "../Graphics/RenderSurface.h"
+#include "../Graphics/TextureCube.h"
+#include "../Graphics/Viewport.h"
+#include "../IO/Log.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* SCENE_CATEGORY;
+
+static const Vector3 DEFAULT_BOUNDING_BOX_MIN(-10.0f, -10.0f, -10.0f);
+static const Vector3 DEFAULT_BOUNDING_BOX_MAX(10.0f, 10.0f, 10.0f);
+static const int DEFAULT_TEXTURE_SIZE = 128;
+static const float DEFAULT_NEAR_CLIP = 0.1f;
+static const float DEFAULT_FAR_CLIP = 1000.0f;
+static const int DEFAULT_MAX_FACES_PER_FRAME = 6;
+static const unsigned ALL_FACES_MASK = (1u << MAX_CUBEMAP_FACES) - 1;
+
+/// World-space camera rotations for rendering each cubemap face.
+static const Quaternion faceRotations[MAX_CUBEMAP_FACES] = {
+    Quaternion(0.0f, 90.0f, 0.0f),
+    Quaternion(0.0f, -90.0f, 0.0f),
+    Quaternion(-90.0f, 0.0f, 0.0f),
+    Quaternion(90.0f, 0.0f, 0.0f),
+    Quaternion(0.0f, 0.0f, 0.0f),
+    Quaternion(0.0f, 180.0f, 0.0f)
+};
+
+static bool CompareProbePriorities(ReflectionProbe* lhs, ReflectionProbe* rhs)
+{
+    return lhs->GetPriority() > rhs->GetPriority();
+}
+
+ReflectionProbe::ReflectionProbe(Context* context) :
+    Component(context),
+    textureSize_(DEFAULT_TEXTURE_SIZE),
+    nearClip_(DEFAULT_NEAR_CLIP),
+    farClip_(DEFAULT_FAR_CLIP)
+{
+    boundingBox_ = BoundingBox(DEFAULT_BOUNDING_BOX_MIN, DEFAULT_BOUNDING_BOX_MAX);
+}
+
+ReflectionProbe::~ReflectionProbe()
+{
+    if (manager_)
+        manager_->RemoveProbe(this);
+}
+
+void ReflectionProbe::RegisterObject(Context* context)
+{
+    context->RegisterFactory<ReflectionProbe>(SCENE_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Bounding Box Min", Vector3, boundingBox_.min_, DEFAULT_BOUNDING_BOX_MIN, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Bounding Box Max", Vector3, boundingBox_.max_, DEFAULT_BOUNDING_BOX_MAX, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Priority", int, priority_, 0, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Dynamic", IsDynamic, SetDynamic, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Texture Size", GetTextureSize, SetTextureSize, int, DEFAULT_TEXTURE_SIZE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Near Clip", GetNearClip, SetNearClip, float, DEFAULT_NEAR_CLIP, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Far Clip", GetFarClip, SetFarClip, float, DEFAULT_FAR_CLIP, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("View Mask", GetViewMask, SetViewMask, unsigned, M_MAX_UNSIGNED, AM_DEFAULT);
+}
+
+void ReflectionProbe::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
+{
+    if (debug && IsEnabledEffective())
+        debug->AddBoundingBox(boundingBox_, node_->GetWorldTransform(), Color::CYAN, depthTest);
+}
+
+void ReflectionProbe::SetBoundingBox(const BoundingBox& box)
+{
+    boundingBox_ = box;
+    MarkNetworkUpdate();
+}
+
+void ReflectionProbe::SetPriority(int priority)
+{
+    priority_ = priority;
+    MarkNetworkUpdate();
+}
+
+void ReflectionProbe::SetDynamic(bool enable)
+{
+    if (enable != dynamic_)
+    {
+        dynamic_ = enable;
+        if (dynamic_)
+            QueueUpdate();
+        MarkNetworkUpdate();
+    }
+}
+
+void ReflectionProbe::SetTextureSize(int size)
+{
+    size = (int)NextPowerOfTwo((unsigned)Max(size, 1));
+    if (size != textureSize_)
+    {
+        textureSize_ = size;
+        ReleaseRenderTexture();
+        QueueUpdate();
+        MarkNetworkUpdate();
+    }
+}
+
+void ReflectionProbe::SetNearClip(float nearClip)
+{
+    nearClip_ = Max(nearClip, M_MIN_NEARCLIP);
+    if (cameraNode_)
+    {
+        if (auto* camera = cameraNode_->GetComponent<Camera>())
+            camera->SetNearClip(nearClip_);
+    }
+    MarkNetworkUpdate();
+}
+
+void ReflectionProbe::SetFarClip(float farClip)
+{
+    farClip_ = Max(farClip, M_MIN_NEARCLIP);
+    if (cameraNode_)
+    {
+        if (auto* camera = cameraNode_->GetComponent<Camera>())
+            camera->SetFarClip(farClip_);
+    }
+    MarkNetworkUpdate();
+}
+
+void ReflectionProbe::SetViewMask(unsigned mask)
+{
+    viewMask_ = mask;
+    if (cameraNode_)
+    {
+        if (auto* camera = cameraNode_->GetComponent<Camera>())
+            camera->SetViewMask(viewMask_);
+    }
+    QueueUpdate();
+    MarkNetworkUpdate();
+}
+
+void ReflectionProbe::QueueUpdate()
+{
+    dirtyFaces_ = ALL_FACES_MASK;
+}
+
+TextureCube* ReflectionProbe::GetTexture() const
+{
+    return hasContent_ ? texture_.Get() : nullptr;
+}
+
+bool ReflectionProbe::IsInside(const Vector3& point) const
+{
+    if (!node_)
+        return false;
+
+    Vector3 localPoint(GetInverseWorldTransform() * point);
+    return boundingBox_.IsInside(localPoint) != OUTSIDE;
+}
+
+bool ReflectionProbe::RenderNextFace()
+{
+    if (!dirtyFaces_ || !node_)
+        return false;
+
+    if (!texture_ && !InitializeRenderTexture())
+    {
+        dirtyFaces_ = 0;
+        return false;
+    }
+
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        if (!(dirtyFaces_ & (1u << i)))
+            continue;
+
+        cameraNode_->SetWorldPosition(node_->GetWorldPosition());
+        cameraNode_->SetWorldRotation(faceRotations[i]);
+        texture_->GetRenderSurface((CubeMapFace)i)->QueueUpdate();
+
+        dirtyFaces_ &= ~(1u << i);
+        if (!dirtyFaces_)
+        {
+            hasContent_ = true;
+            // A dynamic probe starts over once all faces have been rendered, amortizing the refresh across frames
+            if (dynamic_)
+                dirtyFaces_ = ALL_FACES_MASK;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void ReflectionProbe::OnSceneSet(Scene* scene)
+{
+    if (scene)
+    {
+        manager_ = scene->GetOrCreateComponent<ReflectionProbeManager>(LOCAL);
+        manager_->AddProbe(this);
+        QueueUpdate();
+    }
+    else
+    {
+        if (manager_)
+            manager_->RemoveProbe(this);
+        manager_.Reset();
+        ReleaseRenderTexture();
+    }
+}
+
+void ReflectionProbe::OnMarkedDirty(Node* node)
+{
+    inverseWorldDirty_ = true;
+    // Re-render as the probe has moved. A dynamic probe is re-rendered continuously anyway
+    if (!dynamic_)
+        QueueUpdate();
+}
+
+void ReflectionProbe::OnNodeSet(Node* node)
+{
+    if (node)
+        node->AddListener(this);
+}
+
+bool ReflectionProbe::InitializeRenderTexture()
+{
+    auto* graphics = GetSubsystem<Graphics>();
+    Scene* scene = GetScene();
+    if (!graphics || !scene)
+        return false;
+
+    auto newTexture = MakeShared<TextureCube>(context_);
+    if (!newTexture->SetSize(textureSize_, Graphics::GetRGBFormat(), TEXTURE_RENDERTARGET))
+    {
+        URHO3D_LOGERROR("Failed to create reflection probe cubemap");
+        return false;
+    }
+    newTexture->SetFilterMode(FILTER_BILINEAR);
+    texture_ = newTexture;
+
+    cameraNode_ = node_->CreateChild("ReflectionProbeCamera", LOCAL, 0, true);
+    auto* camera = cameraNode_->CreateComponent<Camera>(LOCAL);
+    camera->SetFov(90.0f);
+    camera->SetAspectRatio(1.0f);
+    camera->SetNearClip(nearClip_);
+    camera->SetFarClip(farClip_);
+    camera->SetViewMask(viewMask_);
+
+    viewport_ = MakeShared<Viewport>(context_, scene, camera);
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        RenderSurface* surface = texture_->GetRenderSurface((CubeMapFace)i);
+        surface->SetViewport(0, viewport_);
+        surface->SetUpdateMode(SURFACE_MANUALUPDATE);
+    }
+
+    return true;
+}
+
+void ReflectionProbe::ReleaseRenderTexture()
+{
+    if (cameraNode_)
+        cameraNode_->Remove();
+    cameraNode_.Reset();
+    viewport_.Reset();
+    texture_.Reset();
+    hasContent_ = false;
+}
+
+const Matrix3x4& ReflectionProbe::GetInverseWorldTransform() const
+{
+    if (inverseWorldDirty_)
+    {
+        inverseWorld_ = node_ ? node_->GetWorldTransform().Inverse() : Matrix3x4::IDENTITY;
+        inverseWorldDirty_ = false;
+    }
+
+    return inverseWorld_;
+}
+
+ReflectionProbeManager::ReflectionProbeManager(Context* context) :
+    Component(context),
+    maxFacesPerFrame_(DEFAULT_MAX_FACES_PER_FRAME)
+{
+    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(ReflectionProbeManager, HandleRenderUpdate));
+}
+
+ReflectionProbeManager::~ReflectionProbeManager() = default;
+
+void ReflectionProbeManager::RegisterObject(Context* context)
+{
+    context->RegisterFactory<ReflectionProbeManager>(SCENE_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Faces Per Frame", int, maxFacesPerFrame_, DEFAULT_MAX_FACES_PER_FRAME, AM_DEFAULT);
+}
+
+void ReflectionProbeManager::SetMaxFacesPerFrame(int count)
+{
+    maxFacesPerFrame_ = Max(count, 1);
+    MarkNetworkUpdate();
+}
+
+ReflectionProbe* ReflectionProbeManager::GetProbe(const Vector3& position) const
+{
+    ReflectionProbe* best = nullptr;
+    int bestPriority = M_MIN_INT;
+
+    for (auto i = probes_.begin(); i != probes_.end(); ++i)
+    {
+        ReflectionProbe* probe = *i;
+        if (probe->GetPriority() > bestPriority && probe->IsEnabledEffective() && probe->IsInside(position))
+        {
+            best = probe;
+            bestPriority = probe->GetPriority();
+        }
+    }
+
+    return best;
+}
+
+TextureCube* ReflectionProbeManager::GetProbeTexture(const Vector3& position) const
+{
+    ReflectionProbe* probe = GetProbe(position);
+    return probe ? probe->GetTexture() : nullptr;
+}
+
+void ReflectionProbeManager::AddProbe(ReflectionProbe* probe)
+{
+    if (!probes_.contains(probe))
+        probes_.push_back(probe);
+}
+
+void ReflectionProbeManager::RemoveProbe(ReflectionProbe* probe)
+{
+    probes_.erase_first(probe);
+}
+
+void ReflectionProbeManager::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsEnabledEffective() || probes_.empty())
+        return;
+
+    ea::vector<ReflectionProbe*> pending;
+    for (auto i = probes_.begin(); i != probes_.end(); ++i)
+    {
+        ReflectionProbe* probe = *i;
+        if (probe->IsEnabledEffective() && probe->HasPendingFaces())
+            pending.push_back(probe);
+    }
+    if (pending.empty())
+        return;
+
+    ea::quick_sort(pending.begin(), pending.end(), CompareProbePriorities);
+
+    // Render at most one face per probe per frame, so that a probe's shared face camera is not retargeted mid-frame
+    int budget = maxFacesPerFrame_;
+    for (auto i = pending.begin(); i != pending.end() && budget > 0; ++i)
+    {
+        if ((*i)->RenderNextFace())
+            --budget;
+    }
+}
+
+}
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Matrix3x4.h"
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class ReflectionProbeManager;
+class TextureCube;
+class Viewport;
+
+/// %Component that renders the surrounding scene into a cached reflection cubemap.
+/// Baking is time-sliced one cubemap face at a time by the scene's ReflectionProbeManager.
+class URHO3D_API ReflectionProbe : public Component
+{
+    URHO3D_OBJECT(ReflectionProbe, Component);
+
+public:
+    /// Construct.
+    explicit ReflectionProbe(Context* context);
+    /// Destruct.
+    ~ReflectionProbe() override;
+    /// Register object factory. ReflectionProbeManager must be registered first.
+    static void RegisterObject(Context* context);
+
+    /// Visualize the component as debug geometry.
+    void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) override;
+
+    /// Set local-space bounding box. Will be used as an oriented bounding box to test whether objects are inside.
+    void SetBoundingBox(const BoundingBox& box);
+    /// Set probe priority. If an object is inside several probes, the one with highest priority is used.
+    void SetPriority(int priority);
+    /// Set dynamic mode. A dynamic probe re-renders continuously, one face per frame. A static probe renders once.
+    void SetDynamic(bool enable);
+    /// Set cubemap face size. Forces a re-render.
+    void SetTextureSize(int size);
+    /// Set near clip distance for rendering.
+    void SetNearClip(float nearClip);
+    /// Set far clip distance for rendering.
+    void SetFarClip(float farClip);
+    /// Set view mask for the objects rendered into the cubemap.
+    void SetViewMask(unsigned mask);
+    /// Queue a re-render of all cubemap faces. The previous cubemap remains in use until the faces are replaced.
+    void QueueUpdate();
+
+    /// Return local-space bounding box.
+    const BoundingBox& GetBoundingBox() const { return boundingBox_; }
+
+    /// Return probe priority.
+    int GetPriority() const { return priority_; }
+
+    /// Return whether dynamic mode is enabled.
+    bool IsDynamic() const { return dynamic_; }
+
+    /// Return cubemap face size.
+    int GetTextureSize() const { return textureSize_; }
+
+    /// Return near clip distance for rendering.
+    float GetNearClip() const { return nearClip_; }
+
+    /// Return far clip distance for rendering.
+    float GetFarClip() const { return farClip_; }
+
+    /// Return view mask for the objects rendered into the cubemap.
+    unsigned GetViewMask() const { return viewMask_; }
+
+    /// Return the reflection cubemap, or null if all faces have not been rendered yet.
+    TextureCube* GetTexture() const;
+
+    /// Check whether a world-space point is inside the probe's bounding box.
+    bool IsInside(const Vector3& point) const;
+
+    /// Return whether cubemap faces are pending a render. Called by ReflectionProbeManager.
+    bool HasPendingFaces() const { return dirtyFaces_ != 0; }
+
+    /// Queue a render of the next pending cubemap face. Return true if a face was queued. Called by ReflectionProbeManager.
+    bool RenderNextFace();
+
+protected:
+    /// Handle scene being assigned. Register to the scene's reflection probe manager.
+    void OnSceneSet(Scene* scene) override;
+    /// Handle node transform being dirtied. Queues a re-render as the probe has moved.
+    void OnMarkedDirty(Node* node) override;
+    /// Handle node being assigned. Begin listening to transform changes.
+    void OnNodeSet(Node* node) override;
+
+private:
+    /// Create the render texture, camera and viewport. Return true if successful.
+    bool InitializeRenderTexture();
+    /// Release the render texture, camera and viewport.
+    void ReleaseRenderTexture();
+    /// Return inverse world transform of the node.
+    const Matrix3x4& GetInverseWorldTransform() const;
+
+    /// Local-space bounding box.
+    BoundingBox boundingBox_;
+    /// Probe priority.
+    int priority_{};
+    /// Dynamic mode flag.
+    bool dynamic_{};
+    /// Cubemap face size.
+    int textureSize_;
+    /// Near clip distance.
+    float nearClip_;
+    /// Far clip distance.
+    float farClip_;
+    /// View mask for rendering.
+    unsigned viewMask_{M_MAX_UNSIGNED};
+    /// Bitmask of cubemap faces pending a render.
+    unsigned dirtyFaces_{};
+    /// Whether all faces have been rendered at least once.
+    bool hasContent_{};
+    /// Reflection cubemap render target.
+    SharedPtr<TextureCube> texture_;
+    /// Camera scene node used for rendering the faces.
+    SharedPtr<Node> cameraNode_;
+    /// Viewport shared by the cubemap face render surfaces.
+    SharedPtr<Viewport> viewport_;
+    /// Manager the probe is registered to.
+    WeakPtr<ReflectionProbeManager> manager_;
+    /// Cached inverse world transform matrix.
+    mutable Matrix3x4 inverseWorld_;
+    /// Inverse transform dirty flag.
+    mutable bool inverseWorldDirty_{true};
+};
+
+/// %Component that manages time-sliced reflection probe baking. Created automatically on the root scene node.
+class URHO3D_API ReflectionProbeManager : public Component
+{
+    URHO3D_OBJECT(ReflectionProbeManager, Component);
+
+public:
+    /// Construct.
+    explicit ReflectionProbeManager(Context* context);
+    /// Destruct.
+    ~ReflectionProbeManager() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Set maximum cubemap faces rendered per frame. Pending probes are served in priority order, one face per probe per frame.
+    void SetMaxFacesPerFrame(int count);
+
+    /// Return maximum cubemap faces rendered per frame.
+    int GetMaxFacesPerFrame() const { return maxFacesPerFrame_; }
+
+    /// Return highest priority enabled probe containing the point, or null if none.
+    ReflectionProbe* GetProbe(const Vector3& position) const;
+    /// Return the reflection cubemap of the highest priority probe containing the point, or null if none is available.
+    TextureCube* GetProbeTexture(const Vector3& position) const;
+
+    /// Register a probe. Called by ReflectionProbe.
+    void AddProbe(ReflectionProbe* probe);
+    /// Unregister a probe. Called by ReflectionProbe.
+    void RemoveProbe(ReflectionProbe* probe);
+
+private:
+    /// Handle render update event. Queues pending cubemap face renders within the per-frame budget.
+    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+
+    /// Registered probes.
+    ea::vector<ReflectionProbe*> probes_;
+    /// Maximum cubemap faces rendered per frame.
+    int maxFacesPerFrame_;
+};
+
+}
@@ -55,6 +55,7 @@ static const char* sortModeNames[] =
 {
     "fronttoback",
     "backtofront",
+    "state",
     nullptr
 };
 
@@ -152,6 +153,15 @@ void RenderPathCommand::Load(const XMLElement& element)
             markToStencil_ = element.GetBool("marktostencil");
         if (element.HasAttribute("vertexlights"))
             vertexLights_ = element.GetBool("vertexlights");
+        if (element.HasAttribute("depthtest"))
+        {
+            depthTest_ = (CompareMode)GetStringListIndex(element.GetAttributeLower("depthtest").c_str(), compareModeNames,
+                MAX_COMPAREMODES);
+        }
+        if (element.HasAttribute("depthwrite"))
+            depthWrite_ = element.GetBool("depthwrite");
+        if (element.HasAttribute("colorwrite"))
+            colorWrite_ = element.GetBool("colorwrite");
         break;
 
     case CMD_FORWARDLIGHTS:
@@ -230,12 +240,17 @@ void RenderPathCommand::Load(const XMLElement& element)
 
         textureElem = textureElem.GetNext("texture");
     }
+
+    RefreshViewportFlags();
 }
 
 void RenderPathCommand::SetTextureName(TextureUnit unit, const ea::string& name)
 {
     if (unit < MAX_TEXTURE_UNITS)
+    {
         textureNames_[unit] = name;
+        RefreshViewportFlags();
+    }
 }
 
 void RenderPathCommand::SetShaderParameter(const ea::string& name, const Variant& value)
@@ -252,6 +267,7 @@ void RenderPathCommand::SetNumOutputs(unsigned num)
 {
     num = (unsigned)Clamp((int)num, 1, MAX_RENDERTARGETS);
     outputs_.resize(num);
+    RefreshViewportFlags();
 }
 
 void RenderPathCommand::SetOutput(unsigned index, const ea::string& name, CubeMapFace face)
@@ -260,6 +276,8 @@ void RenderPathCommand::SetOutput(unsigned index, const ea::string& name, CubeMa
         outputs_[index] = ea::make_pair(name, face);
     else if (index == outputs_.size() && index < MAX_RENDERTARGETS)
         outputs_.push_back(ea::make_pair(name, face));
+
+    RefreshViewportFlags();
 }
 
 void RenderPathCommand::SetOutputName(unsigned index, const ea::string& name)
@@ -268,6 +286,8 @@ void RenderPathCommand::SetOutputName(unsigned index, const ea::string& name)
         outputs_[index].first = name;
     else if (index == outputs_.size() && index < MAX_RENDERTARGETS)
         outputs_.push_back(ea::make_pair(name, FACE_POSITIVE_X));
+
+    RefreshViewportFlags();
 }
 
 void RenderPathCommand::SetOutputFace(unsigned index, CubeMapFace face)
@@ -284,6 +304,29 @@ void RenderPathCommand::SetDepthStencilName(const ea::string& name)
     depthStencilName_ = name;
 }
 
+void RenderPathCommand::RefreshViewportFlags()
+{
+    readsViewport_ = false;
+    for (const auto& textureName : textureNames_)
+    {
+        if (!textureName.empty() && !textureName.comparei("viewport"))
+        {
+            readsViewport_ = true;
+            break;
+        }
+    }
+
+    writesViewport_ = false;
+    for (unsigned i = 0; i < outputs_.size(); ++i)
+    {
+        if (!outputs_[i].first.comparei("viewport"))
+        {
+            writesViewport_ = true;
+            break;
+        }
+    }
+}
+
 const ea::string& RenderPathCommand::GetTextureName(TextureUnit unit) const
 {
     return unit < MAX_TEXTURE_UNITS ? textureNames_[unit] : EMPTY_STRING;
@@ -55,7 +55,8 @@ enum RenderCommandType
 enum RenderCommandSortMode
 {
     SORT_FRONTTOBACK = 0,
-    SORT_BACKTOFRONT
+    SORT_BACKTOFRONT,
+    SORT_STATE
 };
 
 /// Rendertarget size mode.
@@ -131,6 +132,8 @@ struct URHO3D_API RenderPathCommand
     void SetOutputFace(unsigned index, CubeMapFace face);
     /// Set depth-stencil output name. When empty, will assign a depth-stencil buffer automatically.
     void SetDepthStencilName(const ea::string& name);
+    /// Refresh the cached viewport read/write flags from the texture names and outputs. Called automatically by Load() and the setter functions; call manually after modifying textureNames_ or outputs_ directly.
+    void RefreshViewportFlags();
 
     /// Return texture resource name.
     const ea::string& GetTextureName(TextureUnit unit) const;
@@ -166,6 +169,12 @@ struct URHO3D_API RenderPathCommand
     RenderCommandType type_{};
     /// Sorting mode.
     RenderCommandSortMode sortMode_{};
+    /// Depth test override for scene pass batches, or MAX_COMPAREMODES to use each pass's own mode.
+    CompareMode depthTest_{MAX_COMPAREMODES};
+    /// Allow depth write in scene pass batches.
+    bool depthWrite_{true};
+    /// Color write flag for scene passes.
+    bool colorWrite_{true};
     /// Scene pass name.
     ea::string pass_;
     /// Scene pass index. Filled by View.
@@ -210,6 +219,10 @@ struct URHO3D_API RenderPathCommand
     bool vertexLights_{};
     /// Event name.
     ea::string eventName_;
+    /// Cached flag for sampling the viewport as a texture. Refreshed by RefreshViewportFlags() so per-frame command execution avoids name comparisons.
+    bool readsViewport_{};
+    /// Cached flag for writing to the viewport output. Refreshed by RefreshViewportFlags().
+    bool writesViewport_{};
 };
 
 /// Rendering path definition. A sequence of commands (e.g. clear screen, draw objects with specific pass) that yields the scene rendering result.
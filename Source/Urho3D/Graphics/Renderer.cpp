@@ -25,6 +25,7 @@
 #include "../Core/CoreEvents.h"
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Geometry.h"
@@ -50,6 +51,8 @@
 #include "../Scene/Scene.h"
 
 #include <EASTL/functional.h>
+#include <EASTL/set.h>
+#include <EASTL/sort.h>
 
 #include "../DebugNew.h"
 
@@ -255,7 +258,6 @@ static const char* heightFogVariations[] =
 
 static const unsigned MAX_BUFFER_AGE = 1000;
 
-static const int MAX_EXTRA_INSTANCING_BUFFER_ELEMENTS = 4;
 
 inline ea::vector<VertexElement> CreateInstancingBufferElements(unsigned numExtraElements)
 {
@@ -394,6 +396,42 @@ void Renderer::SetMaterialQuality(MaterialQuality quality)
     }
 }
 
+void Renderer::SetTextureStreamingBudget(unsigned long long budget)
+{
+    textureStreamingBudget_ = budget;
+}
+
+void Renderer::SetDynamicResolution(bool enable)
+{
+    if (enable == dynamicResolution_)
+        return;
+
+    dynamicResolution_ = enable;
+    dynamicResolutionScale_ = Clamp(1.0f, minDynamicResolutionScale_, maxDynamicResolutionScale_);
+    dynamicResolutionHeadroomFrames_ = 0;
+
+    // The feedback loop needs resolved GPU frame times
+    if (enable && graphics_)
+    {
+        if (!graphics_->GetGPUTimingSupport())
+            URHO3D_LOGWARNING("GPU timing is not supported, dynamic resolution scale will not adapt");
+        else if (!graphics_->GetGPUTimingEnabled())
+            graphics_->SetGPUTimingEnabled(true);
+    }
+}
+
+void Renderer::SetDynamicResolutionScaleRange(float minScale, float maxScale)
+{
+    minDynamicResolutionScale_ = Clamp(minScale, 0.1f, 1.0f);
+    maxDynamicResolutionScale_ = Clamp(maxScale, minDynamicResolutionScale_, 2.0f);
+    dynamicResolutionScale_ = Clamp(dynamicResolutionScale_, minDynamicResolutionScale_, maxDynamicResolutionScale_);
+}
+
+void Renderer::SetDynamicResolutionTargetFrameTime(float ms)
+{
+    dynamicResolutionTargetFrameTime_ = Max(ms, M_EPSILON);
+}
+
 void Renderer::SetDrawShadows(bool enable)
 {
     if (!graphics_ || !graphics_->GetShadowMapFormat())
@@ -507,6 +545,33 @@ void Renderer::SetDynamicInstancing(bool enable)
     dynamicInstancing_ = enable;
 }
 
+void Renderer::SetBonePaletteSkinning(bool enable)
+{
+#ifdef URHO3D_OPENGL
+    if (enable && !Graphics::GetGL3Support())
+    {
+        URHO3D_LOGWARNING("Bone palette skinning requires OpenGL 3, request ignored");
+        enable = false;
+    }
+#else
+    if (enable)
+    {
+        URHO3D_LOGWARNING("Bone palette skinning is only implemented for the OpenGL renderer, request ignored");
+        enable = false;
+    }
+#endif
+
+    if (enable == bonePaletteSkinning_)
+        return;
+
+    bonePaletteSkinning_ = enable;
+    if (!enable)
+        skinMatrixTexture_.Reset();
+
+    // Skinned geometry shaders must be recompiled with or without the texture fetch path
+    ReloadShaders();
+}
+
 void Renderer::SetNumExtraInstancingBufferElements(int elements)
 {
     if (numExtraInstancingBufferElements_ != elements)
@@ -589,6 +654,136 @@ void Renderer::ReloadShaders()
     shadersDirty_ = true;
 }
 
+void Renderer::PrewarmShaders(RenderPath* renderPath)
+{
+    if (!graphics_ || !graphics_->IsInitialized() || graphics_->IsDeviceLost())
+        return;
+
+    if (!renderPath)
+        renderPath = defaultRenderPath_;
+    if (!renderPath)
+        return;
+
+    URHO3D_PROFILE("PrewarmShaders");
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    ea::vector<Material*> materials;
+    cache->GetResources<Material>(materials);
+    if (materials.empty())
+        return;
+
+    // Collect the scene passes of the render path together with the commands providing their extra shader defines.
+    // Base and alpha passes also have lit counterparts used together with forward lights
+    ea::vector<ea::pair<unsigned, const RenderPathCommand*> > scenePasses;
+    for (const RenderPathCommand& command : renderPath->commands_)
+    {
+        if (!command.enabled_ || command.pass_.empty())
+            continue;
+        if (command.type_ != CMD_SCENEPASS && command.type_ != CMD_FORWARDLIGHTS)
+            continue;
+
+        scenePasses.push_back(ea::make_pair(Technique::GetPassIndex(command.pass_), &command));
+        if (command.type_ == CMD_SCENEPASS && (command.metadata_ == "base" || command.metadata_ == "alpha"))
+            scenePasses.push_back(ea::make_pair(Technique::GetPassIndex("lit" + command.pass_), &command));
+    }
+    if (drawShadows_)
+        scenePasses.push_back(ea::make_pair(Technique::GetPassIndex("shadow"), (const RenderPathCommand*)nullptr));
+
+    // Geometry types worth pre-warming; trail and direction-aligned billboard geometries are rare enough to compile
+    // on first use
+    ea::vector<unsigned> geometryTypes;
+    geometryTypes.push_back(GEOM_STATIC);
+    if (dynamicInstancing_)
+        geometryTypes.push_back(GEOM_INSTANCED);
+    geometryTypes.push_back(GEOM_SKINNED);
+    geometryTypes.push_back(GEOM_BILLBOARD);
+
+    BatchQueue queue;
+
+    for (unsigned i = 0; i < scenePasses.size(); ++i)
+    {
+        const unsigned passIndex = scenePasses[i].first;
+        const RenderPathCommand* command = scenePasses[i].second;
+
+        // Carry the command's extra shader defines into LoadPassShaders() the same way View does for its batch queues
+        ea::string vsDefines = command ? command->vertexShaderDefines_.trimmed() : EMPTY_STRING;
+        ea::string psDefines = command ? command->pixelShaderDefines_.trimmed() : EMPTY_STRING;
+        if (vsDefines.length() || psDefines.length())
+        {
+            queue.hasExtraDefines_ = true;
+            queue.vsExtraDefines_ = vsDefines;
+            queue.psExtraDefines_ = psDefines;
+            queue.vsExtraDefinesHash_ = StringHash(vsDefines);
+            queue.psExtraDefinesHash_ = StringHash(psDefines);
+        }
+        else
+            queue.hasExtraDefines_ = false;
+
+        // The same pass may be shared between several materials' techniques
+        ea::hash_set<Pass*> processedPasses;
+
+        for (Material* material : materials)
+        {
+            for (unsigned j = 0; j < material->GetNumTechniques(); ++j)
+            {
+                Technique* tech = material->GetTechnique(j);
+                Pass* pass = tech ? tech->GetPass(passIndex) : nullptr;
+                if (!pass || !processedPasses.insert(pass).second)
+                    continue;
+
+                if (pass->GetShadersLoadedFrameNumber() != shadersChangedFrameNumber_)
+                    pass->ReleaseShaders();
+
+                ea::vector<SharedPtr<ShaderVariation> >& vertexShaders =
+                    queue.hasExtraDefines_ ? pass->GetVertexShaders(queue.vsExtraDefinesHash_) : pass->GetVertexShaders();
+                ea::vector<SharedPtr<ShaderVariation> >& pixelShaders =
+                    queue.hasExtraDefines_ ? pass->GetPixelShaders(queue.psExtraDefinesHash_) : pass->GetPixelShaders();
+                if (!vertexShaders.size() || !pixelShaders.size())
+                    LoadPassShaders(pass, vertexShaders, pixelShaders, queue);
+                if (!vertexShaders.size() || !pixelShaders.size())
+                    continue;
+
+                // Pair the shader variations as SetBatchShaders() would and set them active to compile and link them.
+                // Height fog, shadow normal offset and point light mask variations still compile on first use
+                if (pass->GetLightingMode() == LIGHTING_PERPIXEL)
+                {
+                    static const unsigned lightVS[] = { LVS_DIR, LVS_SPOT, LVS_POINT };
+                    static const unsigned lightPS[] = { LPS_NONE, LPS_SPOT, LPS_POINT };
+
+                    for (unsigned g : geometryTypes)
+                    {
+                        for (unsigned l = 0; l < 3; ++l)
+                        {
+                            for (unsigned shadow = 0; shadow < (drawShadows_ ? 2u : 1u); ++shadow)
+                            {
+                                const unsigned vsi = g * MAX_LIGHT_VS_VARIATIONS + lightVS[l] + (shadow ? LVS_SHADOW : 0);
+                                for (unsigned spec = 0; spec < (specularLighting_ ? 2u : 1u); ++spec)
+                                {
+                                    const unsigned psi = lightPS[l] + (shadow ? LPS_SHADOW : 0) + (spec ? LPS_SPEC : 0);
+                                    graphics_->SetShaders(vertexShaders[vsi], pixelShaders[psi]);
+                                }
+                            }
+                        }
+                    }
+                }
+                else if (pass->GetLightingMode() == LIGHTING_PERVERTEX)
+                {
+                    for (unsigned g : geometryTypes)
+                    {
+                        for (unsigned l = 0; l < MAX_VERTEXLIGHT_VS_VARIATIONS; ++l)
+                            graphics_->SetShaders(vertexShaders[g * MAX_VERTEXLIGHT_VS_VARIATIONS + l], pixelShaders[0]);
+                    }
+                }
+                else
+                {
+                    for (unsigned g : geometryTypes)
+                        graphics_->SetShaders(vertexShaders[g], pixelShaders[0]);
+                }
+            }
+        }
+    }
+}
+
 void Renderer::ApplyShadowMapFilter(View* view, Texture2D* shadowMap, float blurScale)
 {
     if (shadowMapFilterInstance_ && shadowMapFilter_)
@@ -729,6 +924,9 @@ void Renderer::Update(float timeStep)
     if (shadersDirty_)
         LoadShaders();
 
+    // Adapt the dynamic resolution scale from the previous frames' GPU timings before views are defined
+    UpdateDynamicResolution();
+
     // Queue update of the main viewports. Use reverse order, as rendering order is also reverse
     // to render auxiliary views before dependent main views
     for (unsigned i = viewports_.size() - 1; i < viewports_.size(); --i)
@@ -736,18 +934,25 @@ void Renderer::Update(float timeStep)
 
     // Update main viewports. This may queue further views
     unsigned numMainViewports = queuedViewports_.size();
-    for (unsigned i = 0; i < numMainViewports; ++i)
-        UpdateQueuedViewport(i);
+    UpdateViewports(0, numMainViewports);
 
     // Gather queued & autoupdated render surfaces
     SendEvent(E_RENDERSURFACEUPDATE);
 
-    // Update viewports that were added as result of the event above
-    for (unsigned i = numMainViewports; i < queuedViewports_.size(); ++i)
-        UpdateQueuedViewport(i);
+    // Update viewports that were added as result of the event above. Updates may queue even more viewports
+    unsigned firstPendingViewport = numMainViewports;
+    while (firstPendingViewport < queuedViewports_.size())
+    {
+        unsigned endPendingViewport = queuedViewports_.size();
+        UpdateViewports(firstPendingViewport, endPendingViewport);
+        firstPendingViewport = endPendingViewport;
+    }
 
     queuedViewports_.clear();
     resetViews_ = false;
+
+    UpdateTextureStreaming();
+    PruneShadowMapCache();
 }
 
 void Renderer::Render()
@@ -806,6 +1011,14 @@ void Renderer::Render()
     // Remove unused occlusion buffers and renderbuffers
     RemoveUnusedBuffers();
 
+#if URHO3D_PROFILING
+    // Report resolved GPU pass timings to the profiler. Plot names must remain valid for the lifetime of the
+    // program, so intern them in a node-based set
+    static ea::set<ea::string> gpuTimingPlotNames;
+    for (const GPUTimingResult& timing : graphics_->GetGPUTimings())
+        URHO3D_PROFILE_VALUE(gpuTimingPlotNames.insert(timing.name_).first->c_str(), timing.gpuTimeMs_);
+#endif
+
     // All views done, custom rendering can now be done before UI
     SendEvent(E_ENDALLVIEWSRENDER);
 }
@@ -961,14 +1174,35 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
             return shadowMaps_[searchKey][0];
         else
         {
-            // If not reused, check allocation count and return existing shadow map if possible
-            unsigned allocated = shadowMapAllocations_[searchKey].size();
-            if (allocated < shadowMaps_[searchKey].size())
+            // If not reused, allocate a free shadow map, preferring the one the light rendered to previously
+            // so that its cached contents remain valid
+            ea::vector<SharedPtr<Texture2D> >& maps = shadowMaps_[searchKey];
+            ea::vector<Light*>& allocations = shadowMapAllocations_[searchKey];
+            allocations.resize(maps.size(), nullptr);
+
+            auto cached = cachedShadowMaps_.find(light);
+            if (cached != cachedShadowMaps_.end())
+            {
+                for (unsigned i = 0; i < maps.size(); ++i)
+                {
+                    if (!allocations[i] && maps[i] && maps[i] == cached->second.texture_)
+                    {
+                        allocations[i] = light;
+                        return maps[i];
+                    }
+                }
+            }
+
+            for (unsigned i = 0; i < maps.size(); ++i)
             {
-                shadowMapAllocations_[searchKey].push_back(light);
-                return shadowMaps_[searchKey][allocated];
+                if (!allocations[i] && maps[i])
+                {
+                    allocations[i] = light;
+                    return maps[i];
+                }
             }
-            else if ((int)allocated >= maxShadowMaps_)
+
+            if ((int)maps.size() >= maxShadowMaps_)
                 return nullptr;
         }
     }
@@ -1052,11 +1286,36 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
 
     shadowMaps_[searchKey].push_back(newShadowMap);
     if (!reuseShadowMaps_)
-        shadowMapAllocations_[searchKey].push_back(light);
+    {
+        ea::vector<Light*>& allocations = shadowMapAllocations_[searchKey];
+        allocations.resize(shadowMaps_[searchKey].size(), nullptr);
+        if (newShadowMap)
+            allocations.back() = light;
+    }
 
     return newShadowMap;
 }
 
+unsigned Renderer::CheckShadowMapCache(Light* light, Texture2D* shadowMap, const unsigned* splitHashes, unsigned numSplits)
+{
+    ShadowMapCache& cache = cachedShadowMaps_[light];
+
+    unsigned validMask = 0;
+    if (cache.texture_ == shadowMap && cache.splitHashes_.size() == numSplits)
+    {
+        for (unsigned i = 0; i < numSplits; ++i)
+        {
+            if (splitHashes[i] && cache.splitHashes_[i] == splitHashes[i])
+                validMask |= 1u << i;
+        }
+    }
+
+    cache.light_ = light;
+    cache.texture_ = shadowMap;
+    cache.splitHashes_.assign(splitHashes, splitHashes + numSplits);
+    return validMask;
+}
+
 Texture* Renderer::GetScreenBuffer(int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb,
     unsigned persistentKey)
 {
@@ -1433,6 +1692,34 @@ bool Renderer::ResizeInstancingBuffer(unsigned numInstances)
     return true;
 }
 
+bool Renderer::ResizeSkinMatrixTexture(unsigned numMatrices)
+{
+    if (!bonePaletteSkinning_ || !numMatrices)
+        return false;
+
+    // Each matrix occupies 3 RGBA32 texels. The width is fixed; the vertex shader hard-codes it for the fetch math
+    unsigned height = (numMatrices * 3 + SKIN_TEXTURE_WIDTH - 1) / SKIN_TEXTURE_WIDTH;
+    if (skinMatrixTexture_ && (unsigned)skinMatrixTexture_->GetHeight() >= height)
+        return true;
+
+    if (!skinMatrixTexture_)
+    {
+        skinMatrixTexture_ = context_->CreateObject<Texture2D>();
+        skinMatrixTexture_->SetNumLevels(1);
+        skinMatrixTexture_->SetFilterMode(FILTER_NEAREST);
+    }
+
+    if (!skinMatrixTexture_->SetSize((int)SKIN_TEXTURE_WIDTH, (int)height, Graphics::GetRGBAFloat32Format(), TEXTURE_DYNAMIC))
+    {
+        URHO3D_LOGERROR("Failed to resize skin matrix texture to height " + ea::to_string(height));
+        skinMatrixTexture_.Reset();
+        return false;
+    }
+
+    URHO3D_LOGDEBUG("Resized skin matrix texture to height " + ea::to_string(height));
+    return true;
+}
+
 void Renderer::OptimizeLightByScissor(Light* light, Camera* camera)
 {
     if (light && light->GetLightType() != LIGHT_DIRECTIONAL)
@@ -1536,14 +1823,14 @@ const Rect& Renderer::GetLightScissor(Light* light, Camera* camera)
     }
 }
 
-void Renderer::UpdateQueuedViewport(unsigned index)
+View* Renderer::DefineQueuedViewport(unsigned index)
 {
     WeakPtr<RenderSurface>& renderTarget = queuedViewports_[index].first;
     WeakPtr<Viewport>& viewport = queuedViewports_[index].second;
 
     // Null pointer means backbuffer view. Differentiate between that and an expired rendersurface
     if ((renderTarget && renderTarget.Expired()) || viewport.Expired())
-        return;
+        return nullptr;
 
     // (Re)allocate the view structure if necessary
     if (!viewport->GetView() || resetViews_)
@@ -1553,14 +1840,14 @@ void Renderer::UpdateQueuedViewport(unsigned index)
     assert(view);
     // Check if view can be defined successfully (has either valid scene, camera and octree, or no scene passes)
     if (!view->Define(renderTarget, viewport))
-        return;
+        return nullptr;
 
     views_.push_back(WeakPtr<View>(view));
 
     const IntRect& viewRect = viewport->GetRect();
     Scene* scene = viewport->GetScene();
     if (!scene)
-        return;
+        return nullptr;
 
     auto* octree = scene->GetComponent<Octree>();
 
@@ -1582,9 +1869,156 @@ void Renderer::UpdateQueuedViewport(unsigned index)
             debug->SetView(viewport->GetCamera());
     }
 
-    // Update view. This may queue further views. View will send update begin/end events once its state is set
-    ResetShadowMapAllocations(); // Each view can reuse the same shadow maps
-    view->Update(frame_);
+    return view;
+}
+
+void Renderer::UpdateQueuedViewport(unsigned index)
+{
+    if (View* view = DefineQueuedViewport(index))
+    {
+        // Update view. This may queue further views. View will send update begin/end events once its state is set
+        ResetShadowMapAllocations(); // Each view can reuse the same shadow maps
+        view->Update(frame_);
+    }
+}
+
+void Renderer::UpdateViewports(unsigned beginIndex, unsigned endIndex)
+{
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const bool threaded = threadedViewUpdate_ && workQueue && workQueue->GetNumThreads() > 0 && endIndex - beginIndex > 1;
+
+    if (!threaded)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            UpdateQueuedViewport(i);
+        return;
+    }
+
+    // Define all views and update their octrees on the main thread first, then run the
+    // independent read-only octree queries of the views concurrently before the serial
+    // per-view update consumes the prepared results
+    ea::vector<View*> definedViews;
+    for (unsigned i = beginIndex; i < endIndex; ++i)
+    {
+        if (View* view = DefineQueuedViewport(i))
+            definedViews.push_back(view);
+    }
+
+    for (View* view : definedViews)
+        workQueue->AddWorkItem([view]() { view->PrepareDrawablesQuery(); }, M_MAX_UNSIGNED);
+    workQueue->Complete(M_MAX_UNSIGNED);
+
+    for (View* view : definedViews)
+    {
+        ResetShadowMapAllocations(); // Each view can reuse the same shadow maps
+        view->Update(frame_);
+    }
+}
+
+void Renderer::UpdateDynamicResolution()
+{
+    if (!dynamicResolution_ || !graphics_->GetGPUTimingSupport())
+        return;
+
+    // Keep GPU timing enabled, the feedback loop is useless without it
+    if (!graphics_->GetGPUTimingEnabled())
+        graphics_->SetGPUTimingEnabled(true);
+
+    // Sum the resolved per-pass GPU times into the scene GPU cost of the frame. The timestamp results lag a few
+    // frames behind the CPU, which only smooths the feedback
+    float gpuTimeMs = 0.0f;
+    for (const GPUTimingResult& result : graphics_->GetGPUTimings())
+        gpuTimeMs += result.gpuTimeMs_;
+    if (gpuTimeMs <= 0.0f)
+        return;
+
+    // Scale resolution down immediately when over budget, but back up only after sustained headroom below a lower
+    // threshold, so that the scale does not oscillate around the budget
+    static const float SCALE_STEP = 0.05f;
+    static const float UP_THRESHOLD = 0.85f;
+    static const unsigned UP_DELAY_FRAMES = 60;
+
+    float scale = dynamicResolutionScale_;
+    if (gpuTimeMs > dynamicResolutionTargetFrameTime_)
+    {
+        scale -= SCALE_STEP;
+        dynamicResolutionHeadroomFrames_ = 0;
+    }
+    else if (gpuTimeMs < dynamicResolutionTargetFrameTime_ * UP_THRESHOLD)
+    {
+        if (++dynamicResolutionHeadroomFrames_ >= UP_DELAY_FRAMES)
+        {
+            scale += SCALE_STEP;
+            dynamicResolutionHeadroomFrames_ = 0;
+        }
+    }
+    else
+        dynamicResolutionHeadroomFrames_ = 0;
+
+    dynamicResolutionScale_ = Clamp(scale, minDynamicResolutionScale_, maxDynamicResolutionScale_);
+}
+
+void Renderer::UpdateTextureStreaming()
+{
+    if (!textureStreamingBudget_)
+        return;
+
+    URHO3D_PROFILE("UpdateTextureStreaming");
+
+    // Promote at most this many textures per frame to bound the re-upload cost
+    static const unsigned MAX_STREAM_PROMOTIONS = 4;
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    ea::vector<Texture2D*> textures;
+    cache->GetResources<Texture2D>(textures);
+
+    unsigned long long total = 0;
+    ea::vector<Texture2D*> streamable;
+    for (Texture2D* texture : textures)
+    {
+        total += (unsigned long long)texture->GetMemoryUse();
+        if (texture->IsStreamable())
+            streamable.push_back(texture);
+    }
+
+    // Promote textures rendered on this frame one mip level at a time while there is headroom. Promoting a level at
+    // most quadruples the texture's memory use
+    unsigned promotions = MAX_STREAM_PROMOTIONS;
+    for (Texture2D* texture : streamable)
+    {
+        if (!promotions)
+            break;
+
+        if (texture->GetStreamLevel() && texture->GetLastUseFrameNumber() == frame_.frameNumber_ &&
+            total + 3 * (unsigned long long)texture->GetMemoryUse() <= textureStreamingBudget_)
+        {
+            auto oldUse = (unsigned long long)texture->GetMemoryUse();
+            texture->SetStreamLevel(texture->GetStreamLevel() - 1);
+            total = total - oldUse + (unsigned long long)texture->GetMemoryUse();
+            --promotions;
+        }
+    }
+
+    if (total <= textureStreamingBudget_)
+        return;
+
+    // Over budget: demote textures starting from the least recently rendered
+    ea::quick_sort(streamable.begin(), streamable.end(),
+        [](Texture2D* lhs, Texture2D* rhs) { return lhs->GetLastUseFrameNumber() < rhs->GetLastUseFrameNumber(); });
+
+    for (Texture2D* texture : streamable)
+    {
+        unsigned maxLevel = texture->GetMaxStreamLevel();
+        while (total > textureStreamingBudget_ && texture->GetStreamLevel() < maxLevel)
+        {
+            auto oldUse = (unsigned long long)texture->GetMemoryUse();
+            texture->SetStreamLevel(texture->GetStreamLevel() + 1);
+            total = total - oldUse + (unsigned long long)texture->GetMemoryUse();
+        }
+
+        if (total <= textureStreamingBudget_)
+            break;
+    }
 }
 
 void Renderer::PrepareViewRender()
@@ -1628,6 +2062,17 @@ void Renderer::RemoveUnusedBuffers()
     }
 }
 
+void Renderer::PruneShadowMapCache()
+{
+    for (auto i = cachedShadowMaps_.begin(); i != cachedShadowMaps_.end();)
+    {
+        if (i->second.light_.Expired() || i->second.texture_.Expired())
+            i = cachedShadowMaps_.erase(i);
+        else
+            ++i;
+    }
+}
+
 void Renderer::ResetShadowMapAllocations()
 {
     for (auto i = shadowMapAllocations_.begin(); i != shadowMapAllocations_.end(); ++i)
@@ -1742,6 +2187,12 @@ void Renderer::LoadPassShaders(Pass* pass, ea::vector<SharedPtr<ShaderVariation>
         psDefines += "VSM_SHADOW ";
     }
 
+    // With bone palette skinning, skinned geometry fetches its bone transforms from the skin matrix texture
+    auto geometryDefines = [this](unsigned g) -> const char*
+    {
+        return g == GEOM_SKINNED && bonePaletteSkinning_ ? "SKINNED SKINTEX " : geometryVSVariations[g];
+    };
+
     if (pass->GetLightingMode() == LIGHTING_PERPIXEL)
     {
         // Load forward pixel lit variations
@@ -1754,7 +2205,7 @@ void Renderer::LoadPassShaders(Pass* pass, ea::vector<SharedPtr<ShaderVariation>
             unsigned l = j % MAX_LIGHT_VS_VARIATIONS;
 
             vertexShaders[j] = graphics_->GetShader(VS, pass->GetVertexShader(),
-                vsDefines + lightVSVariations[l] + geometryVSVariations[g]);
+                vsDefines + lightVSVariations[l] + geometryDefines(g));
         }
         for (unsigned j = 0; j < MAX_LIGHT_PS_VARIATIONS * 2; ++j)
         {
@@ -1783,7 +2234,7 @@ void Renderer::LoadPassShaders(Pass* pass, ea::vector<SharedPtr<ShaderVariation>
                 unsigned g = j / MAX_VERTEXLIGHT_VS_VARIATIONS;
                 unsigned l = j % MAX_VERTEXLIGHT_VS_VARIATIONS;
                 vertexShaders[j] = graphics_->GetShader(VS, pass->GetVertexShader(),
-                    vsDefines + vertexLightVSVariations[l] + geometryVSVariations[g]);
+                    vsDefines + vertexLightVSVariations[l] + geometryDefines(g));
             }
         }
         else
@@ -1792,7 +2243,7 @@ void Renderer::LoadPassShaders(Pass* pass, ea::vector<SharedPtr<ShaderVariation>
             for (unsigned j = 0; j < MAX_GEOMETRYTYPES; ++j)
             {
                 vertexShaders[j] = graphics_->GetShader(VS, pass->GetVertexShader(),
-                    vsDefines + geometryVSVariations[j]);
+                    vsDefines + geometryDefines(j));
             }
         }
 
@@ -1969,6 +2420,7 @@ void Renderer::ResetShadowMaps()
     shadowMaps_.clear();
     shadowMapAllocations_.clear();
     colorShadowMaps_.clear();
+    cachedShadowMaps_.clear();
 }
 
 void Renderer::ResetBuffers()
@@ -60,6 +60,8 @@ struct BatchQueue;
 
 static const int SHADOW_MIN_PIXELS = 64;
 static const int INSTANCING_BUFFER_DEFAULT_SIZE = 1024;
+/// Width of the skin matrix texture in texels. Must match the constant in the SKINTEX vertex shader code.
+static const unsigned SKIN_TEXTURE_WIDTH = 1024;
 
 /// Light vertex shader variations.
 enum LightVSVariation
@@ -218,6 +220,17 @@ public:
     void SetTextureQuality(MaterialQuality quality);
     /// Set material quality level. See the QUALITY constants in GraphicsDefs.h.
     void SetMaterialQuality(MaterialQuality quality);
+    /// Set texture streaming memory budget in bytes, or 0 to disable streaming. When enabled, textures loaded through
+    /// the resource cache retain their source images and are streamed between mip levels to stay within the budget.
+    void SetTextureStreamingBudget(unsigned long long budget);
+    /// Set dynamic resolution scaling on/off. When enabled, backbuffer scene views are rendered at a reduced
+    /// resolution chosen from GPU frame time feedback and upscaled into the viewport, while UI and render-to-texture
+    /// views keep full resolution. Requires GPU timing support and enables GPU timing on the Graphics subsystem.
+    void SetDynamicResolution(bool enable);
+    /// Set the allowed dynamic resolution scale range. The scale is applied to both view dimensions.
+    void SetDynamicResolutionScaleRange(float minScale, float maxScale);
+    /// Set the GPU frame time budget for dynamic resolution in milliseconds.
+    void SetDynamicResolutionTargetFrameTime(float ms);
     /// Set shadows on/off.
     void SetDrawShadows(bool enable);
     /// Set shadow map resolution.
@@ -238,6 +251,8 @@ public:
     void SetMaxShadowMaps(int shadowMaps);
     /// Set dynamic instancing on/off. When on (default), drawables using the same static-type geometry and material will be automatically combined to an instanced draw call.
     void SetDynamicInstancing(bool enable);
+    /// Set bone palette skinning on/off. When on, the bone transforms of all visible skeletons are uploaded into a shared float texture once per frame and skinned draw calls only set a palette offset, instead of re-uploading the matrices as shader constants per draw. Requires the OpenGL 3 renderer. Default false.
+    void SetBonePaletteSkinning(bool enable);
     /// Set number of extra instancing buffer elements. Default is 0. Extra 4-vectors are available through TEXCOORD7 and further.
     void SetNumExtraInstancingBufferElements(int elements);
     /// Set minimum number of instances required in a batch group to render as instanced.
@@ -252,6 +267,8 @@ public:
     void SetOccluderSizeThreshold(float screenSize);
     /// Set whether to thread occluder rendering. Default false.
     void SetThreadedOcclusion(bool enable);
+    /// Set whether to prepare the octree queries of multiple queued viewports concurrently on WorkQueue threads. Default false.
+    void SetThreadedViewUpdate(bool enable) { threadedViewUpdate_ = enable; }
     /// Set shadow depth bias multiplier for mobile platforms to counteract possible worse shadow map precision. Default 1.0 (no effect).
     void SetMobileShadowBiasMul(float mul);
     /// Set shadow depth bias addition for mobile platforms to counteract possible worse shadow map precision. Default 0.0 (no effect).
@@ -266,6 +283,8 @@ public:
     void SetNumSoftwareSkinningBones(unsigned numBones);
     /// Force reload of shaders.
     void ReloadShaders();
+    /// Precompile and link shader programs for combinations of the currently loaded materials and the scene passes of a render path, to avoid first-use hitches during rendering. Uses the default render path if null. Call on the main thread after loading a scene's resources. Rarely used variations are still compiled on first use.
+    void PrewarmShaders(RenderPath* renderPath = nullptr);
 
     /// Apply post processing filter to the shadow map. Called by View.
     void ApplyShadowMapFilter(View* view, Texture2D* shadowMap, float blurScale);
@@ -303,6 +322,24 @@ public:
     /// Return material quality level.
     MaterialQuality GetMaterialQuality() const { return materialQuality_; }
 
+    /// Return texture streaming memory budget in bytes.
+    unsigned long long GetTextureStreamingBudget() const { return textureStreamingBudget_; }
+
+    /// Return whether dynamic resolution scaling is enabled.
+    bool GetDynamicResolution() const { return dynamicResolution_; }
+
+    /// Return minimum dynamic resolution scale.
+    float GetMinDynamicResolutionScale() const { return minDynamicResolutionScale_; }
+
+    /// Return maximum dynamic resolution scale.
+    float GetMaxDynamicResolutionScale() const { return maxDynamicResolutionScale_; }
+
+    /// Return the GPU frame time budget for dynamic resolution in milliseconds.
+    float GetDynamicResolutionTargetFrameTime() const { return dynamicResolutionTargetFrameTime_; }
+
+    /// Return the current dynamic resolution scale.
+    float GetDynamicResolutionScale() const { return dynamicResolutionScale_; }
+
     /// Return shadow map resolution.
     int GetShadowMapSize() const { return shadowMapSize_; }
 
@@ -327,6 +364,9 @@ public:
     /// Return whether dynamic instancing is in use.
     bool GetDynamicInstancing() const { return dynamicInstancing_; }
 
+    /// Return whether bone palette skinning is enabled.
+    bool GetBonePaletteSkinning() const { return bonePaletteSkinning_; }
+
     /// Return number of extra instancing buffer elements.
     int GetNumExtraInstancingBufferElements() const { return numExtraInstancingBufferElements_; };
 
@@ -348,6 +388,9 @@ public:
     /// Return whether occlusion rendering is threaded.
     bool GetThreadedOcclusion() const { return threadedOcclusion_; }
 
+    /// Return whether queued viewport octree queries are prepared concurrently.
+    bool GetThreadedViewUpdate() const { return threadedViewUpdate_; }
+
     /// Return shadow depth bias multiplier for mobile platforms.
     float GetMobileShadowBiasMul() const { return mobileShadowBiasMul_; }
 
@@ -405,6 +448,9 @@ public:
     /// Return the instancing vertex buffer.
     VertexBuffer* GetInstancingBuffer() const { return dynamicInstancing_ ? instancingBuffer_.Get() : nullptr; }
 
+    /// Return the skin matrix texture used for bone palette skinning, or null if disabled.
+    Texture2D* GetSkinMatrixTexture() const { return bonePaletteSkinning_ ? skinMatrixTexture_.Get() : nullptr; }
+
     /// Return the frame update parameters.
     const FrameInfo& GetFrameInfo() const { return frame_; }
 
@@ -425,6 +471,8 @@ public:
     Geometry* GetQuadGeometry();
     /// Allocate a shadow map. If shadow map reuse is disabled, a different map is returned each time.
     Texture2D* GetShadowMap(Light* light, Camera* camera, unsigned viewWidth, unsigned viewHeight);
+    /// Compare and update the cached shadow map content hashes of a light's shadow splits. Return a bitmask of splits whose cached contents are still valid and need no re-rendering.
+    unsigned CheckShadowMapCache(Light* light, Texture2D* shadowMap, const unsigned* splitHashes, unsigned numSplits);
     /// Allocate a rendertarget or depth-stencil texture for deferred rendering or postprocessing. Should only be called during actual rendering, not before.
     Texture* GetScreenBuffer
         (int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb, unsigned persistentKey = 0);
@@ -447,6 +495,8 @@ public:
     void SetCullMode(CullMode mode, Camera* camera);
     /// Ensure sufficient size of the instancing vertex buffer. Return true if successful.
     bool ResizeInstancingBuffer(unsigned numInstances);
+    /// Ensure sufficient size of the skin matrix texture for bone palette skinning. Return true if successful.
+    bool ResizeSkinMatrixTexture(unsigned numMatrices);
     /// Optimize a light by scissor rectangle.
     void OptimizeLightByScissor(Light* light, Camera* camera);
     /// Optimize a light by marking it to the stencil buffer and setting a stencil test.
@@ -474,14 +524,24 @@ private:
     void CreateInstancingBuffer();
     /// Create point light shadow indirection texture data.
     void SetIndirectionTextureData();
+    /// Define the view of a queued viewport and update its octree. Return the view if it should be updated.
+    View* DefineQueuedViewport(unsigned index);
     /// Update a queued viewport for rendering.
     void UpdateQueuedViewport(unsigned index);
+    /// Update a range of queued viewports, preparing their octree queries concurrently when threaded view update is enabled.
+    void UpdateViewports(unsigned beginIndex, unsigned endIndex);
+    /// Adjust streamable textures' resident mip levels to stay within the texture streaming budget.
+    void UpdateTextureStreaming();
+    /// Update the dynamic resolution scale from the resolved GPU frame times.
+    void UpdateDynamicResolution();
     /// Prepare for rendering of a new view.
     void PrepareViewRender();
     /// Remove unused occlusion and screen buffers.
     void RemoveUnusedBuffers();
     /// Reset shadow map allocation counts.
     void ResetShadowMapAllocations();
+    /// Remove cached shadow map contents of destroyed lights.
+    void PruneShadowMapCache();
     /// Reset screem buffer allocation counts.
     void ResetScreenBufferAllocations();
     /// Remove all shadow maps. Called when global shadow map resolution or format is changed.
@@ -513,6 +573,8 @@ private:
     SharedPtr<Geometry> pointLightGeometry_;
     /// Instance stream vertex buffer.
     SharedPtr<VertexBuffer> instancingBuffer_;
+    /// Skin matrix texture for bone palette skinning.
+    SharedPtr<Texture2D> skinMatrixTexture_;
     /// Default material.
     SharedPtr<Material> defaultMaterial_;
     /// Default range attenuation texture.
@@ -533,6 +595,20 @@ private:
     ea::unordered_map<int, SharedPtr<Texture2D> > colorShadowMaps_;
     /// Shadow map allocations by resolution.
     ea::unordered_map<int, ea::vector<Light*> > shadowMapAllocations_;
+
+    /// Cached shadow map contents of one light.
+    struct ShadowMapCache
+    {
+        /// Light weak pointer for detecting destroyed lights.
+        WeakPtr<Light> light_;
+        /// Shadow map the contents were rendered to.
+        WeakPtr<Texture2D> texture_;
+        /// Content hash of each shadow split.
+        ea::vector<unsigned> splitHashes_;
+    };
+
+    /// Cached shadow map contents per light.
+    ea::unordered_map<Light*, ShadowMapCache> cachedShadowMaps_;
     /// Instance of shadow map filter.
     Object* shadowMapFilterInstance_{};
     /// Function pointer of shadow map filter.
@@ -573,6 +649,8 @@ private:
     MaterialQuality textureQuality_{QUALITY_HIGH};
     /// Material quality level.
     MaterialQuality materialQuality_{QUALITY_HIGH};
+    /// Texture streaming memory budget in bytes. 0 disables streaming.
+    unsigned long long textureStreamingBudget_{};
     /// Shadow map resolution.
     int shadowMapSize_{1024};
     /// Shadow quality.
@@ -615,6 +693,18 @@ private:
     unsigned shadersChangedFrameNumber_{M_MAX_UNSIGNED};
     /// Current stencil value for light optimization.
     unsigned char lightStencilValue_{};
+    /// Dynamic resolution scaling flag.
+    bool dynamicResolution_{};
+    /// Minimum dynamic resolution scale.
+    float minDynamicResolutionScale_{0.5f};
+    /// Maximum dynamic resolution scale.
+    float maxDynamicResolutionScale_{1.0f};
+    /// GPU frame time budget for dynamic resolution in milliseconds.
+    float dynamicResolutionTargetFrameTime_{1000.0f / 60.0f};
+    /// Current dynamic resolution scale.
+    float dynamicResolutionScale_{1.0f};
+    /// Number of consecutive frames with enough GPU headroom to scale the resolution back up.
+    unsigned dynamicResolutionHeadroomFrames_{};
     /// HDR rendering flag.
     bool hdrRendering_{};
     /// Specular lighting flag.
@@ -625,10 +715,14 @@ private:
     bool reuseShadowMaps_{true};
     /// Dynamic instancing flag.
     bool dynamicInstancing_{true};
+    /// Bone palette skinning flag.
+    bool bonePaletteSkinning_{};
     /// Number of extra instancing data elements.
     int numExtraInstancingBufferElements_{};
     /// Threaded occlusion rendering flag.
     bool threadedOcclusion_{};
+    /// Threaded viewport update flag.
+    bool threadedViewUpdate_{};
     /// Shaders need reloading flag.
     bool shadersDirty_{true};
     /// Initialized flag.
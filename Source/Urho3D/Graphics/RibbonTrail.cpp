@@ -25,6 +25,7 @@
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
+#include "../Core/Thread.h"
 #include "../Graphics/RibbonTrail.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../Graphics/IndexBuffer.h"
@@ -83,6 +84,8 @@ RibbonTrail::RibbonTrail(Context* context) :
     startColor_(Color(1.0f, 1.0f, 1.0f, 1.0f)),
     lastUpdateFrameNumber_(M_MAX_UNSIGNED),
     needUpdate_(false),
+    workVertexCount_(0),
+    commitPending_(false),
     sorted_(false),
     previousOffset_(Vector3::ZERO),
     forceUpdate_(false),
@@ -403,12 +406,43 @@ void RibbonTrail::UpdateGeometry(const FrameInfo& frame)
 
     if (bufferDirty_ || vertexBuffer_->IsDataLost())
         UpdateVertexBuffer(frame);
+
+    // When updated on the main thread, upload immediately; worker thread updates are committed by the view
+    if (commitPending_ && Thread::IsMainThread())
+        CommitGeometry();
+}
+
+void RibbonTrail::CommitGeometry()
+{
+    if (!commitPending_)
+        return;
+
+    commitPending_ = false;
+
+    // Verify that the buffer still matches the prepared data; if not, the next update will rewrite it
+    if (!workVertexCount_ || vertexBuffer_->GetVertexCount() < workVertexCount_ ||
+        workVertexData_.size() * sizeof(float) != (size_t)workVertexCount_ * vertexBuffer_->GetVertexSize())
+        return;
+
+    void* dest = vertexBuffer_->Lock(0, workVertexCount_, true);
+    if (dest)
+    {
+        memcpy(dest, &workVertexData_[0], workVertexData_.size() * sizeof(float));
+        vertexBuffer_->Unlock();
+    }
+
+    vertexBuffer_->ClearDataLost();
 }
 
 UpdateGeometryType RibbonTrail::GetUpdateGeometryType()
 {
-    if (bufferDirty_ || bufferSizeDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost())
+    // Buffer resize and lost data recovery are GPU work and must happen on the main thread
+    if (bufferSizeDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost())
         return UPDATE_MAIN_THREAD;
+    // Trail sorting and vertex generation write into CPU memory and can run in a worker thread; the upload
+    // happens in CommitGeometry()
+    else if (bufferDirty_)
+        return UPDATE_WORKER_THREAD;
     else
         return UPDATE_NONE;
 }
@@ -577,9 +611,10 @@ void RibbonTrail::UpdateVertexBuffer(const FrameInfo& frame)
     bufferDirty_ = false;
     forceUpdate_ = false;
 
-    auto* dest = (float*)vertexBuffer_->Lock(0, (numPoints_ - 1) * vertexPerSegment, true);
-    if (!dest)
-        return;
+    // Write into CPU memory; the buffer upload happens in CommitGeometry() on the main thread
+    workVertexCount_ = (numPoints_ - 1) * vertexPerSegment;
+    workVertexData_.resize(workVertexCount_ * (vertexBuffer_->GetVertexSize() / sizeof(float)));
+    float* dest = &workVertexData_[0];
 
     // Generate trail mesh
     if (trailType_ == TT_FACE_CAMERA)
@@ -807,8 +842,7 @@ void RibbonTrail::UpdateVertexBuffer(const FrameInfo& frame)
         }
     }
 
-    vertexBuffer_->Unlock();
-    vertexBuffer_->ClearDataLost();
+    commitPending_ = true;
 }
 
 void RibbonTrail::SetLifetime(float time)
@@ -83,6 +83,8 @@ public:
     void UpdateBatches(const FrameInfo& frame) override;
     /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update).
     void UpdateGeometry(const FrameInfo& frame) override;
+    /// Upload trail vertex data prepared by a worker thread update.
+    void CommitGeometry() override;
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     UpdateGeometryType GetUpdateGeometryType() override;
 
@@ -241,6 +243,12 @@ private:
     Vector3 previousOffset_;
     /// Trail pointers for sorting.
     ea::vector<TrailPoint*> sortedPoints_;
+    /// Vertex data prepared by a worker thread update, pending upload in CommitGeometry().
+    ea::vector<float> workVertexData_;
+    /// Number of vertices pending upload.
+    unsigned workVertexCount_;
+    /// Vertex data pending upload flag.
+    bool commitPending_;
     /// Force update flag (ignore animation LOD momentarily).
     bool forceUpdate_;
     /// Currently emitting flag.
@@ -66,6 +66,8 @@ void SoftwareModelAnimator::Initialize(Model* model, bool skinned, unsigned numB
     numBones_ = numBones;
     CloneModelGeometries();
     InitializeAnimationData();
+    if (skinned_)
+        CalculateLodVertexRanges();
 }
 
 void SoftwareModelAnimator::ResetAnimation()
@@ -105,7 +107,7 @@ void SoftwareModelAnimator::ApplyMorphs(ea::span<const ModelMorph> morphs)
     }
 }
 
-void SoftwareModelAnimator::ApplySkinning(ea::span<const Matrix3x4> worldTransforms)
+void SoftwareModelAnimator::ApplySkinning(ea::span<const Matrix3x4> worldTransforms, unsigned lodLevel)
 {
     if (!skinned_)
         return;
@@ -117,20 +119,33 @@ void SoftwareModelAnimator::ApplySkinning(ea::span<const Matrix3x4> worldTransfo
         if (!clonedBuffer || !animationData.hasSkeletalAnimation_)
             continue;
 
+        // Restrict skinning to the vertices used by the current LOD level
+        unsigned startVertex = 0;
+        unsigned endVertex = clonedBuffer->GetVertexCount();
+        if (bufferIndex < lodVertexRanges_.size() && !lodVertexRanges_[bufferIndex].empty())
+        {
+            const auto& ranges = lodVertexRanges_[bufferIndex];
+            const auto& range = ranges[Min(lodLevel, ranges.size() - 1)];
+            if (range.first >= range.second)
+                continue; // Buffer not used by this LOD
+            startVertex = range.first;
+            endVertex = Min(range.second, endVertex);
+        }
+
         if (!animationData.skinNormals_ && !animationData.skinTangents_)
-            ApplyVertexBufferSkinning<false, false>(clonedBuffer, animationData, worldTransforms);
+            ApplyVertexBufferSkinning<false, false>(clonedBuffer, animationData, worldTransforms, startVertex, endVertex);
         else if (animationData.skinNormals_ && !animationData.skinTangents_)
-            ApplyVertexBufferSkinning<true, false>(clonedBuffer, animationData, worldTransforms);
+            ApplyVertexBufferSkinning<true, false>(clonedBuffer, animationData, worldTransforms, startVertex, endVertex);
         else if (animationData.skinNormals_ && animationData.skinTangents_)
-            ApplyVertexBufferSkinning<true, true>(clonedBuffer, animationData, worldTransforms);
+            ApplyVertexBufferSkinning<true, true>(clonedBuffer, animationData, worldTransforms, startVertex, endVertex);
         else
-            ApplyVertexBufferSkinning<false, true>(clonedBuffer, animationData, worldTransforms); // this is really weird case
+            ApplyVertexBufferSkinning<false, true>(clonedBuffer, animationData, worldTransforms, startVertex, endVertex); // this is really weird case
     }
 }
 
 template <bool SkinNormals, bool SkinTangents>
 void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer, const VertexBufferAnimationData& animationData,
-    ea::span<const Matrix3x4> worldTransforms) const
+    ea::span<const Matrix3x4> worldTransforms, unsigned startVertex, unsigned endVertex) const
 {
     const unsigned clonedVertexSize = clonedBuffer->GetVertexSize();
     const unsigned normalOffset = clonedBuffer->GetElementOffset(TYPE_VECTOR3, SEM_NORMAL);
@@ -138,16 +153,85 @@ void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer
 
     unsigned char* clonedBufferData = clonedBuffer->GetShadowData();
 
-    unsigned char* positionsData = clonedBufferData;
-    unsigned char* normalsData = SkinNormals ? clonedBufferData + normalOffset : nullptr;
-    unsigned char* tangentsData = SkinTangents ? clonedBufferData + tangentOffset : nullptr;
+    unsigned char* positionsData = clonedBufferData + startVertex * clonedVertexSize;
+    unsigned char* normalsData = SkinNormals ? clonedBufferData + normalOffset + startVertex * clonedVertexSize : nullptr;
+    unsigned char* tangentsData = SkinTangents ? clonedBufferData + tangentOffset + startVertex * clonedVertexSize : nullptr;
+
+    const unsigned char* indicesData = animationData.blendIndices_.data() + startVertex * numBones_;
+    const float* weightsData = animationData.blendWeights_.data() + startVertex * numBones_;
+
+#ifdef URHO3D_SSE
+    for (unsigned vertexIndex = startVertex; vertexIndex < endVertex; ++vertexIndex)
+    {
+        // Blend the bone matrices a full row at a time
+        const float* matrixData = worldTransforms[indicesData[0]].Data();
+        __m128 weight = _mm_set1_ps(weightsData[0]);
+        __m128 row0 = _mm_mul_ps(_mm_loadu_ps(matrixData), weight);
+        __m128 row1 = _mm_mul_ps(_mm_loadu_ps(matrixData + 4), weight);
+        __m128 row2 = _mm_mul_ps(_mm_loadu_ps(matrixData + 8), weight);
+        for (unsigned boneIndex = 1; boneIndex < numBones_; ++boneIndex)
+        {
+            matrixData = worldTransforms[indicesData[boneIndex]].Data();
+            weight = _mm_set1_ps(weightsData[boneIndex]);
+            row0 = _mm_add_ps(row0, _mm_mul_ps(_mm_loadu_ps(matrixData), weight));
+            row1 = _mm_add_ps(row1, _mm_mul_ps(_mm_loadu_ps(matrixData + 4), weight));
+            row2 = _mm_add_ps(row2, _mm_mul_ps(_mm_loadu_ps(matrixData + 8), weight));
+        }
+
+        // Transpose the rows into basis and translation columns so that vectors transform without horizontal adds
+        __m128 col0 = row0;
+        __m128 col1 = row1;
+        __m128 col2 = row2;
+        __m128 col3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+        float result[4];
+        auto positionData = reinterpret_cast<float*>(positionsData);
+        __m128 vec = _mm_add_ps(col3, _mm_mul_ps(col0, _mm_set1_ps(positionData[0])));
+        vec = _mm_add_ps(vec, _mm_mul_ps(col1, _mm_set1_ps(positionData[1])));
+        vec = _mm_add_ps(vec, _mm_mul_ps(col2, _mm_set1_ps(positionData[2])));
+        _mm_storeu_ps(result, vec);
+        positionData[0] = result[0];
+        positionData[1] = result[1];
+        positionData[2] = result[2];
 
-    const unsigned char* indicesData = animationData.blendIndices_.data();
-    const float* weightsData = animationData.blendWeights_.data();
+        if (SkinNormals)
+        {
+            auto normalData = reinterpret_cast<float*>(normalsData);
+            vec = _mm_mul_ps(col0, _mm_set1_ps(normalData[0]));
+            vec = _mm_add_ps(vec, _mm_mul_ps(col1, _mm_set1_ps(normalData[1])));
+            vec = _mm_add_ps(vec, _mm_mul_ps(col2, _mm_set1_ps(normalData[2])));
+            _mm_storeu_ps(result, vec);
+            normalData[0] = result[0];
+            normalData[1] = result[1];
+            normalData[2] = result[2];
+        }
 
-    const unsigned numVertices = clonedBuffer->GetVertexCount();
+        if (SkinTangents)
+        {
+            auto tangentData = reinterpret_cast<float*>(tangentsData);
+            vec = _mm_mul_ps(col0, _mm_set1_ps(tangentData[0]));
+            vec = _mm_add_ps(vec, _mm_mul_ps(col1, _mm_set1_ps(tangentData[1])));
+            vec = _mm_add_ps(vec, _mm_mul_ps(col2, _mm_set1_ps(tangentData[2])));
+            _mm_storeu_ps(result, vec);
+            tangentData[0] = result[0];
+            tangentData[1] = result[1];
+            tangentData[2] = result[2];
+        }
+
+        // Advance
+        indicesData += numBones_;
+        weightsData += numBones_;
+
+        positionsData += clonedVertexSize;
+        if (SkinNormals)
+            normalsData += clonedVertexSize;
+        if (SkinTangents)
+            tangentsData += clonedVertexSize;
+    }
+#else
     Matrix3x4 matrix;
-    for (unsigned vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+    for (unsigned vertexIndex = startVertex; vertexIndex < endVertex; ++vertexIndex)
     {
         matrix = worldTransforms[indicesData[0]] * weightsData[0];
         for (unsigned boneIndex = 1; boneIndex < numBones_; ++boneIndex)
@@ -178,7 +262,86 @@ void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer
         if (SkinTangents)
             tangentsData += clonedVertexSize;
     }
+#endif
+}
+
+void SoftwareModelAnimator::CalculateLodVertexRanges()
+{
+    // The number of LOD levels is the maximum across geometries; geometries with fewer levels repeat their last one
+    unsigned numLods = 1;
+    for (const auto& geometryLods : geometries_)
+        numLods = Max(numLods, (unsigned)geometryLods.size());
 
+    lodVertexRanges_.resize(vertexBuffers_.size());
+    for (auto& ranges : lodVertexRanges_)
+    {
+        ranges.clear();
+        ranges.resize(numLods, ea::pair<unsigned, unsigned>(M_MAX_UNSIGNED, 0));
+    }
+
+    for (const auto& geometryLods : geometries_)
+    {
+        if (geometryLods.empty())
+            continue;
+
+        for (unsigned lod = 0; lod < numLods; ++lod)
+        {
+            Geometry* geometry = geometryLods[Min(lod, geometryLods.size() - 1)];
+            if (!geometry)
+                continue;
+
+            // Find the range of vertices referenced by the geometry
+            unsigned minVertex = M_MAX_UNSIGNED;
+            unsigned maxVertex = 0;
+            IndexBuffer* indexBuffer = geometry->GetIndexBuffer();
+            const unsigned char* indexData = indexBuffer ? indexBuffer->GetShadowData() : nullptr;
+            if (indexData)
+            {
+                const unsigned indexSize = indexBuffer->GetIndexSize();
+                const unsigned indexStart = geometry->GetIndexStart();
+                const unsigned indexCount = geometry->GetIndexCount();
+                if (indexSize == sizeof(unsigned short))
+                {
+                    const unsigned short* indices = reinterpret_cast<const unsigned short*>(indexData) + indexStart;
+                    for (unsigned i = 0; i < indexCount; ++i)
+                    {
+                        minVertex = Min(minVertex, (unsigned)indices[i]);
+                        maxVertex = Max(maxVertex, (unsigned)indices[i]);
+                    }
+                }
+                else
+                {
+                    const unsigned* indices = reinterpret_cast<const unsigned*>(indexData) + indexStart;
+                    for (unsigned i = 0; i < indexCount; ++i)
+                    {
+                        minVertex = Min(minVertex, indices[i]);
+                        maxVertex = Max(maxVertex, indices[i]);
+                    }
+                }
+            }
+            else if (geometry->GetVertexCount())
+            {
+                minVertex = geometry->GetVertexStart();
+                maxVertex = geometry->GetVertexStart() + geometry->GetVertexCount() - 1;
+            }
+
+            if (minVertex > maxVertex)
+                continue;
+
+            // Extend the range of each cloned buffer the geometry draws from
+            for (VertexBuffer* buffer : geometry->GetVertexBuffers())
+            {
+                for (unsigned bufferIndex = 0; bufferIndex < vertexBuffers_.size(); ++bufferIndex)
+                {
+                    if (vertexBuffers_[bufferIndex] != buffer)
+                        continue;
+                    auto& range = lodVertexRanges_[bufferIndex][lod];
+                    range.first = Min(range.first, minVertex);
+                    range.second = Max(range.second, maxVertex + 1);
+                }
+            }
+        }
+    }
 }
 
 void SoftwareModelAnimator::Commit()
@@ -268,7 +431,14 @@ void SoftwareModelAnimator::CloneModelGeometries()
             continue;
         }
 
-        // Clone buffer
+        // Clone buffer. The original buffer may only shadow positions; populate the full copy by readback then.
+        // The copy stays cached and is also read by InitializeAnimationData() and ResetAnimation()
+        if (!originalVertexBuffer->EnsureShadowData())
+        {
+            URHO3D_LOGERROR("Vertex buffer data is not available for software skinning and morphing");
+            continue;
+        }
+
         auto clonedVertexBuffer = MakeShared<VertexBuffer>(context_);
         clonedVertexBuffer->SetShadowed(true);
         clonedVertexBuffer->SetSize(originalVertexBuffer->GetVertexCount(), clonedBufferMask, true);
@@ -68,8 +68,8 @@ public:
     void ResetAnimation();
     /// Apply morphs. Safe to call from worker thread.
     void ApplyMorphs(ea::span<const ModelMorph> morphs);
-    /// Apply skinning.
-    void ApplySkinning(ea::span<const Matrix3x4> worldTransforms);
+    /// Apply skinning to the vertices used by the given geometry LOD level. Level 0 skins all vertices.
+    void ApplySkinning(ea::span<const Matrix3x4> worldTransforms, unsigned lodLevel = 0);
     /// Commit data to GPU.
     void Commit();
 
@@ -86,6 +86,8 @@ private:
     void CloneModelGeometries();
     /// Initialize skeletal animation data.
     void InitializeAnimationData();
+    /// Calculate the used vertex range per vertex buffer and LOD level so that lower LODs skin fewer vertices.
+    void CalculateLodVertexRanges();
     /// Copy morph vertices.
     void CopyMorphVertices(void* destVertexData, const void* srcVertexData, unsigned vertexCount,
         VertexBuffer* destBuffer, VertexBuffer* srcBuffer) const;
@@ -94,7 +96,7 @@ private:
     /// Apply skinning for given vertex buffer.
     template <bool SkinNormals, bool SkinTangents>
     void ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer, const VertexBufferAnimationData& animationData,
-        ea::span<const Matrix3x4> worldTransforms) const;
+        ea::span<const Matrix3x4> worldTransforms, unsigned startVertex, unsigned endVertex) const;
 
     /// Original model.
     SharedPtr<Model> originalModel_;
@@ -109,6 +111,8 @@ private:
     unsigned numBones_{};
     /// Animation data for vertex buffers.
     ea::vector<VertexBufferAnimationData> vertexBuffersData_;
+    /// Used vertex range per vertex buffer and LOD level, as [begin, end) pairs.
+    ea::vector<ea::vector<ea::pair<unsigned, unsigned>>> lodVertexRanges_;
 };
 
 }
@@ -63,6 +63,10 @@ void StaticModelGroup::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Instance Nodes", GetNodeIDsAttr, SetNodeIDsAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT | AM_NODEIDVECTOR)
         .SetMetadata(AttributeMetadata::P_VECTOR_STRUCT_ELEMENTS, instanceNodesStructureElementNames);
+    URHO3D_ACCESSOR_ATTRIBUTE("Instance Data Elements", GetNumInstanceDataElements, SetNumInstanceDataElements, unsigned, 0,
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Instance Data", GetInstanceDataAttr, SetInstanceDataAttr, VariantVector,
+        Variant::emptyVariantVector, AM_DEFAULT | AM_NOEDIT);
 }
 
 void StaticModelGroup::ApplyAttributes()
@@ -97,6 +101,8 @@ void StaticModelGroup::ApplyAttributes()
     }
 
     worldTransforms_.resize(instanceNodes_.size());
+    instanceData_.resize(instanceNodes_.size() * numInstanceDataElements_, Vector4::ZERO);
+    packedInstanceData_.resize(instanceData_.size());
     numWorldTransforms_ = 0; // Correct amount will be found during world bounding box update
     nodesDirty_ = false;
 
@@ -173,6 +179,10 @@ void StaticModelGroup::UpdateBatches(const FrameInfo& frame)
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
     distance_ = frame.camera_->GetDistance(worldBoundingBox.Center());
 
+    const bool hasInstanceData = numInstanceDataElements_ && numWorldTransforms_;
+    void* instancingData = hasInstanceData ? &packedInstanceData_[0] : nullptr;
+    const unsigned instancingDataStride = hasInstanceData ? numInstanceDataElements_ * (unsigned)sizeof(Vector4) : 0;
+
     if (batches_.size() > 1)
     {
         for (unsigned i = 0; i < batches_.size(); ++i)
@@ -180,6 +190,8 @@ void StaticModelGroup::UpdateBatches(const FrameInfo& frame)
             batches_[i].distance_ = frame.camera_->GetDistance(worldTransform * geometryData_[i].center_);
             batches_[i].worldTransform_ = numWorldTransforms_ ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
             batches_[i].numWorldTransforms_ = numWorldTransforms_;
+            batches_[i].instancingData_ = instancingData;
+            batches_[i].instancingDataStride_ = instancingDataStride;
         }
     }
     else if (batches_.size() == 1)
@@ -187,6 +199,8 @@ void StaticModelGroup::UpdateBatches(const FrameInfo& frame)
         batches_[0].distance_ = distance_;
         batches_[0].worldTransform_ = numWorldTransforms_ ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
         batches_[0].numWorldTransforms_ = numWorldTransforms_;
+        batches_[0].instancingData_ = instancingData;
+        batches_[0].instancingDataStride_ = instancingDataStride;
     }
 
     float scale = worldBoundingBox.Size().DotProduct(DOT_SCALE);
@@ -295,6 +309,12 @@ void StaticModelGroup::RemoveInstanceNode(Node* node)
     if (i == instanceNodes_.end())
         return;
 
+    // Erase the instance's data elements so that the remaining instances keep theirs
+    const auto nodeIndex = (unsigned)(i - instanceNodes_.begin());
+    if (numInstanceDataElements_)
+        instanceData_.erase(instanceData_.begin() + nodeIndex * numInstanceDataElements_,
+            instanceData_.begin() + (nodeIndex + 1) * numInstanceDataElements_);
+
     node->RemoveListener(this);
     instanceNodes_.erase(i);
     UpdateNumTransforms();
@@ -318,6 +338,46 @@ Node* StaticModelGroup::GetInstanceNode(unsigned index) const
     return index < instanceNodes_.size() ? instanceNodes_[index].Get() : nullptr;
 }
 
+void StaticModelGroup::SetNumInstanceDataElements(unsigned num)
+{
+    num = Clamp((int)num, 0, MAX_EXTRA_INSTANCING_BUFFER_ELEMENTS);
+    if (num == numInstanceDataElements_)
+        return;
+
+    // Repack existing data so that instances keep the elements they already have
+    ea::vector<Vector4> newData(instanceNodes_.size() * num, Vector4::ZERO);
+    for (unsigned i = 0; i < instanceNodes_.size(); ++i)
+    {
+        for (unsigned j = 0; j < Min(num, numInstanceDataElements_); ++j)
+            newData[i * num + j] = instanceData_[i * numInstanceDataElements_ + j];
+    }
+
+    instanceData_ = ea::move(newData);
+    packedInstanceData_.resize(instanceData_.size());
+    numInstanceDataElements_ = num;
+
+    OnMarkedDirty(GetNode());
+    MarkNetworkUpdate();
+}
+
+void StaticModelGroup::SetInstanceData(unsigned nodeIndex, unsigned elementIndex, const Vector4& data)
+{
+    if (nodeIndex >= instanceNodes_.size() || elementIndex >= numInstanceDataElements_)
+        return;
+
+    instanceData_[nodeIndex * numInstanceDataElements_ + elementIndex] = data;
+
+    // Dirty the bounding box to repack the data in the same order as the world transforms
+    OnMarkedDirty(GetNode());
+    MarkNetworkUpdate();
+}
+
+const Vector4& StaticModelGroup::GetInstanceData(unsigned nodeIndex, unsigned elementIndex) const
+{
+    return nodeIndex < instanceNodes_.size() && elementIndex < numInstanceDataElements_ ?
+        instanceData_[nodeIndex * numInstanceDataElements_ + elementIndex] : Vector4::ZERO;
+}
+
 void StaticModelGroup::SetNodeIDsAttr(const VariantVector& value)
 {
     // Just remember the node IDs. They need to go through the SceneResolver, and we actually find the nodes during
@@ -360,6 +420,26 @@ const VariantVector& StaticModelGroup::GetNodeIDsAttr() const
     return nodeIDsAttr_;
 }
 
+void StaticModelGroup::SetInstanceDataAttr(const VariantVector& value)
+{
+    // Instance nodes are found during ApplyAttributes(), which will also resize the data to match them
+    instanceData_.resize(value.size());
+    for (unsigned i = 0; i < value.size(); ++i)
+        instanceData_[i] = value[i].GetVector4();
+
+    packedInstanceData_.resize(instanceData_.size());
+    OnMarkedDirty(GetNode());
+}
+
+VariantVector StaticModelGroup::GetInstanceDataAttr() const
+{
+    VariantVector ret;
+    ret.reserve(instanceData_.size());
+    for (const Vector4& data : instanceData_)
+        ret.push_back(data);
+    return ret;
+}
+
 void StaticModelGroup::OnNodeSetEnabled(Node* node)
 {
     Drawable::OnMarkedDirty(node);
@@ -379,7 +459,13 @@ void StaticModelGroup::OnWorldBoundingBoxUpdate()
             continue;
 
         const Matrix3x4& worldTransform = node->GetWorldTransform();
-        worldTransforms_[index++] = worldTransform;
+        worldTransforms_[index] = worldTransform;
+
+        // Keep per-instance data packed in the same order as the transforms, skipping disabled instances
+        for (unsigned j = 0; j < numInstanceDataElements_; ++j)
+            packedInstanceData_[index * numInstanceDataElements_ + j] = instanceData_[i * numInstanceDataElements_ + j];
+
+        ++index;
         worldBox.Merge(boundingBox_.Transformed(worldTransform));
     }
 
@@ -393,6 +479,8 @@ void StaticModelGroup::OnWorldBoundingBoxUpdate()
 void StaticModelGroup::UpdateNumTransforms()
 {
     worldTransforms_.resize(instanceNodes_.size());
+    instanceData_.resize(instanceNodes_.size() * numInstanceDataElements_, Vector4::ZERO);
+    packedInstanceData_.resize(instanceData_.size());
     numWorldTransforms_ = 0; // Correct amount will be during world bounding box update
     nodeIDsDirty_ = true;
 
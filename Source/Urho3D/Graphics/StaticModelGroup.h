@@ -64,12 +64,30 @@ public:
     /// Return instance node by index.
     Node* GetInstanceNode(unsigned index) const;
 
+    /// Set number of Vector4 data elements attached to each instance. The elements are written to the instancing
+    /// vertex buffer after the transform, so the count should match the extra instancing buffer elements configured
+    /// in the Renderer for the data to reach the vertex shader.
+    void SetNumInstanceDataElements(unsigned num);
+    /// Set a per-instance data element such as a color, UV offset or material-defined scalar parameters.
+    void SetInstanceData(unsigned nodeIndex, unsigned elementIndex, const Vector4& data);
+
+    /// Return number of Vector4 data elements per instance.
+    unsigned GetNumInstanceDataElements() const { return numInstanceDataElements_; }
+
+    /// Return a per-instance data element.
+    const Vector4& GetInstanceData(unsigned nodeIndex, unsigned elementIndex) const;
+
     /// Set node IDs attribute.
     void SetNodeIDsAttr(const VariantVector& value);
 
     /// Return node IDs attribute.
     const VariantVector& GetNodeIDsAttr() const;
 
+    /// Set instance data attribute.
+    void SetInstanceDataAttr(const VariantVector& value);
+    /// Return instance data attribute.
+    VariantVector GetInstanceDataAttr() const;
+
 protected:
     /// Handle scene node enabled status changing.
     void OnNodeSetEnabled(Node* node) override;
@@ -86,10 +104,16 @@ private:
     ea::vector<WeakPtr<Node> > instanceNodes_;
     /// World transforms of valid (existing and visible) instances.
     ea::vector<Matrix3x4> worldTransforms_;
+    /// Per-instance data elements, numInstanceDataElements_ per instance node.
+    ea::vector<Vector4> instanceData_;
+    /// Per-instance data elements packed in the same order as worldTransforms_.
+    ea::vector<Vector4> packedInstanceData_;
     /// IDs of instance nodes for serialization.
     mutable VariantVector nodeIDsAttr_;
     /// Number of valid instance node transforms.
     unsigned numWorldTransforms_{};
+    /// Number of Vector4 data elements per instance.
+    unsigned numInstanceDataElements_{};
     /// Whether node IDs have been set and nodes should be searched for during ApplyAttributes.
     mutable bool nodesDirty_{};
     /// Whether nodes have been manipulated by the API and node ID attribute should be refreshed.
@@ -0,0 +1,311 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#include "../Graphics/StaticSceneBatcher.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/ModelView.h"
+#include "../Graphics/StaticModel.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Render state that static models must share so that a merged model renders identically to the sources.
+struct MergeKey
+{
+    /// View mask.
+    unsigned viewMask_{};
+    /// Light mask.
+    unsigned lightMask_{};
+    /// Shadow mask.
+    unsigned shadowMask_{};
+    /// Zone mask.
+    unsigned zoneMask_{};
+    /// Lightmap texture index, or M_MAX_UNSIGNED if the drawable is not lightmapped.
+    unsigned lightmapIndex_{M_MAX_UNSIGNED};
+    /// Draw distance.
+    float drawDistance_{};
+    /// Shadow caster flag.
+    bool castShadows_{};
+    /// Occluder flag.
+    bool occluder_{};
+    /// Occludee flag.
+    bool occludee_{};
+
+    /// Test for equality with another key.
+    bool operator ==(const MergeKey& rhs) const
+    {
+        return viewMask_ == rhs.viewMask_
+            && lightMask_ == rhs.lightMask_
+            && shadowMask_ == rhs.shadowMask_
+            && zoneMask_ == rhs.zoneMask_
+            && lightmapIndex_ == rhs.lightmapIndex_
+            && drawDistance_ == rhs.drawDistance_
+            && castShadows_ == rhs.castShadows_
+            && occluder_ == rhs.occluder_
+            && occludee_ == rhs.occludee_;
+    }
+};
+
+/// Extract the render state key from a static model.
+MergeKey MakeMergeKey(StaticModel* staticModel)
+{
+    MergeKey key;
+    key.viewMask_ = staticModel->GetViewMask();
+    key.lightMask_ = staticModel->GetLightMask();
+    key.shadowMask_ = staticModel->GetShadowMask();
+    key.zoneMask_ = staticModel->GetZoneMask();
+    if (staticModel->GetBakeLightmapEffective())
+        key.lightmapIndex_ = staticModel->GetLightmapIndex();
+    key.drawDistance_ = staticModel->GetDrawDistance();
+    key.castShadows_ = staticModel->GetCastShadows();
+    key.occluder_ = staticModel->IsOccluder();
+    key.occludee_ = staticModel->IsOccludee();
+    return key;
+}
+
+/// Group of identically rendered static models within a cell.
+struct MergeGroup
+{
+    /// Shared render state.
+    MergeKey key_;
+    /// Source static models.
+    ea::vector<StaticModel*> sourceModels_;
+};
+
+/// Transform model vertex from source node space into merged model space.
+ModelVertex TransformVertex(const ModelVertex& source, const Matrix3x4& transform)
+{
+    ModelVertex vertex = source;
+    vertex.SetPosition(transform * source.GetPosition());
+    vertex.normal_ = Vector4((transform * Vector4(static_cast<Vector3>(source.normal_), 0.0f)).Normalized(), 0.0f);
+    vertex.tangent_ = Vector4((transform * Vector4(static_cast<Vector3>(source.tangent_), 0.0f)).Normalized(),
+        source.tangent_.w_);
+    vertex.binormal_ = Vector4((transform * Vector4(static_cast<Vector3>(source.binormal_), 0.0f)).Normalized(), 0.0f);
+    return vertex;
+}
+
+/// Merge the finest LODs of the group's source models into a single model with one geometry per unique material.
+/// Lightmap scale and offset of lightmapped sources is baked into the second UV channel.
+SharedPtr<Model> BuildMergedModel(Context* context, const MergeGroup& group, const Matrix3x4& inverseCellTransform,
+    ea::unordered_map<Model*, SharedPtr<ModelView>>& importedModels, ea::vector<Material*>& materials)
+{
+    const bool lightmapped = group.key_.lightmapIndex_ != M_MAX_UNSIGNED;
+    ea::vector<GeometryView> geometries;
+
+    for (StaticModel* sourceModel : group.sourceModels_)
+    {
+        // The same model resource is commonly instantiated many times, import it into editable form only once
+        SharedPtr<ModelView>& sourceView = importedModels[sourceModel->GetModel()];
+        if (!sourceView)
+        {
+            sourceView = MakeShared<ModelView>(context);
+            if (!sourceView->ImportModel(sourceModel->GetModel()))
+            {
+                URHO3D_LOGWARNING("Model '{}' cannot be merged", sourceModel->GetModel()->GetName());
+                sourceView = nullptr;
+                continue;
+            }
+        }
+
+        const Matrix3x4 transform = inverseCellTransform * sourceModel->GetNode()->GetWorldTransform();
+        const Vector4& lightmapScaleOffset = sourceModel->GetLightmapScaleOffset();
+
+        const ea::vector<GeometryView>& sourceGeometries = sourceView->GetGeometries();
+        for (unsigned geometryIndex = 0; geometryIndex < sourceGeometries.size(); ++geometryIndex)
+        {
+            // Merged cells are drawn at full detail, use the finest LOD of the source geometry
+            if (sourceGeometries[geometryIndex].lods_.empty())
+                continue;
+            const GeometryLODView& sourceLOD = sourceGeometries[geometryIndex].lods_.front();
+            if (sourceLOD.indices_.empty())
+                continue;
+
+            // Batch geometries by material so that the merged model costs one draw call per unique material
+            Material* material = sourceModel->GetMaterial(geometryIndex);
+            unsigned materialIndex = materials.index_of(material);
+            if (materialIndex == materials.size())
+            {
+                materials.push_back(material);
+                geometries.push_back();
+                geometries.back().lods_.resize(1);
+            }
+
+            GeometryLODView& destLOD = geometries[materialIndex].lods_[0];
+            const unsigned baseVertex = destLOD.vertices_.size();
+            for (const ModelVertex& sourceVertex : sourceLOD.vertices_)
+            {
+                ModelVertex vertex = TransformVertex(sourceVertex, transform);
+                // The merged drawable uses identity lightmap scale and offset, bake the per-drawable
+                // transform into the lightmap UV channel
+                if (lightmapped)
+                {
+                    vertex.uv_[1].x_ = vertex.uv_[1].x_ * lightmapScaleOffset.x_ + lightmapScaleOffset.z_;
+                    vertex.uv_[1].y_ = vertex.uv_[1].y_ * lightmapScaleOffset.y_ + lightmapScaleOffset.w_;
+                }
+                destLOD.vertices_.push_back(vertex);
+            }
+            for (unsigned index : sourceLOD.indices_)
+                destLOD.indices_.push_back(baseVertex + index);
+        }
+    }
+
+    if (geometries.empty())
+        return nullptr;
+
+    ModelVertexFormat vertexFormat;
+    vertexFormat.position_ = TYPE_VECTOR3;
+    vertexFormat.normal_ = TYPE_VECTOR3;
+    vertexFormat.tangent_ = TYPE_VECTOR4;
+    vertexFormat.uv_[0] = TYPE_VECTOR2;
+    if (lightmapped)
+        vertexFormat.uv_[1] = TYPE_VECTOR2;
+
+    auto modelView = MakeShared<ModelView>(context);
+    modelView->SetVertexFormat(vertexFormat);
+    modelView->SetGeometries(ea::move(geometries));
+    return modelView->ExportModel();
+}
+
+}
+
+unsigned StaticSceneBatcher::Bake(Scene* scene, const StaticSceneBatchingSettings& settings)
+{
+    if (!scene)
+        return 0;
+
+    Context* context = scene->GetContext();
+
+    // Merge only plain static models with a model assigned. Groups, skyboxes and other specialized
+    // drawables are left alone.
+    ea::vector<StaticModel*> staticModels;
+    scene->GetComponents(staticModels, true);
+
+    // Partition the sources into cells and group identically rendered models within each cell
+    ea::unordered_map<IntVector3, ea::vector<MergeGroup>> cells;
+    for (StaticModel* staticModel : staticModels)
+    {
+        if (!staticModel->GetModel() || !staticModel->IsEnabledEffective())
+            continue;
+        if (!settings.tagFilter_.empty() && !staticModel->GetNode()->HasTag(settings.tagFilter_))
+            continue;
+
+        const Vector3 center = staticModel->GetWorldBoundingBox().Center();
+        const IntVector3 cell = VectorFloorToInt(center / settings.cellSize_);
+        const MergeKey key = MakeMergeKey(staticModel);
+
+        ea::vector<MergeGroup>& groups = cells[cell];
+        MergeGroup* group = nullptr;
+        for (MergeGroup& existingGroup : groups)
+        {
+            if (existingGroup.key_ == key)
+            {
+                group = &existingGroup;
+                break;
+            }
+        }
+        if (!group)
+        {
+            groups.push_back();
+            group = &groups.back();
+            group->key_ = key;
+        }
+        group->sourceModels_.push_back(staticModel);
+    }
+
+    auto* cache = context->GetCache();
+    ea::unordered_map<Model*, SharedPtr<ModelView>> importedModels;
+    unsigned numMergedModels = 0;
+
+    for (const auto& cellAndGroups : cells)
+    {
+        const IntVector3& cell = cellAndGroups.first;
+        const Vector3 cellCenter = (Vector3(cell) + Vector3::ONE * 0.5f) * settings.cellSize_;
+        const Matrix3x4 inverseCellTransform = Matrix3x4(cellCenter, Quaternion::IDENTITY, 1.0f).Inverse();
+
+        for (const MergeGroup& group : cellAndGroups.second)
+        {
+            if (group.sourceModels_.size() < settings.minModelsPerBatch_)
+                continue;
+
+            ea::vector<Material*> materials;
+            SharedPtr<Model> mergedModel = BuildMergedModel(context, group, inverseCellTransform,
+                importedModels, materials);
+            if (!mergedModel)
+                continue;
+
+            mergedModel->SetName(Format("{}Cell_{}_{}_{}_{}.mdl",
+                settings.modelNamePrefix_, cell.x_, cell.y_, cell.z_, numMergedModels));
+            cache->AddManualResource(mergedModel);
+
+            Node* mergedNode = scene->CreateChild(Format("Merged_{}_{}_{}", cell.x_, cell.y_, cell.z_));
+            mergedNode->SetWorldPosition(cellCenter);
+
+            auto* mergedStaticModel = mergedNode->CreateComponent<StaticModel>();
+            mergedStaticModel->SetModel(mergedModel);
+            for (unsigned i = 0; i < materials.size(); ++i)
+                mergedStaticModel->SetMaterial(i, materials[i]);
+
+            const MergeKey& key = group.key_;
+            mergedStaticModel->SetViewMask(key.viewMask_);
+            mergedStaticModel->SetLightMask(key.lightMask_);
+            mergedStaticModel->SetShadowMask(key.shadowMask_);
+            mergedStaticModel->SetZoneMask(key.zoneMask_);
+            mergedStaticModel->SetDrawDistance(key.drawDistance_);
+            mergedStaticModel->SetCastShadows(key.castShadows_);
+            mergedStaticModel->SetOccluder(key.occluder_);
+            mergedStaticModel->SetOccludee(key.occludee_);
+            if (key.lightmapIndex_ != M_MAX_UNSIGNED)
+            {
+                mergedStaticModel->SetBakeLightmap(true);
+                mergedStaticModel->SetLightmapIndex(key.lightmapIndex_);
+                mergedStaticModel->SetLightmapScaleOffset(Vector4(1.0f, 1.0f, 0.0f, 0.0f));
+            }
+
+            for (StaticModel* sourceModel : group.sourceModels_)
+            {
+                if (settings.removeSourceComponents_)
+                    sourceModel->Remove();
+                else
+                    sourceModel->SetEnabled(false);
+            }
+
+            ++numMergedModels;
+        }
+    }
+
+    return numMergedModels;
+}
+
+}
@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+#include <EASTL/string.h>
+
+namespace Urho3D
+{
+
+class Scene;
+
+/// Settings of static scene batching.
+struct StaticSceneBatchingSettings
+{
+    /// Size of the cell. Models within a cell are merged together, so the cell size trades draw calls for culling
+    /// granularity.
+    Vector3 cellSize_{64.0f, 64.0f, 64.0f};
+    /// Minimum number of identically rendered static models within a cell to justify merging them.
+    unsigned minModelsPerBatch_{2};
+    /// Node tag filter. If non-empty, only static models on nodes with this tag are merged.
+    ea::string tagFilter_;
+    /// Resource name prefix of generated merged models.
+    ea::string modelNamePrefix_{"Merged/"};
+    /// Whether to remove the merged source components instead of disabling them.
+    bool removeSourceComponents_{};
+};
+
+/// Merges static scene geometry at load or tool time. Static models within a cell that render identically
+/// (same materials, lightmap, masks and shadow flags) are baked into shared models with one geometry per unique
+/// material, and the source drawables are disabled, collapsing many draw calls into few. Lightmap UVs are preserved
+/// by baking each source drawable's lightmap scale and offset into the merged vertices.
+class URHO3D_API StaticSceneBatcher
+{
+public:
+    /// Construct.
+    StaticSceneBatcher() {}
+
+    /// Merge static models in the scene. Return number of merged models created.
+    unsigned Bake(Scene* scene, const StaticSceneBatchingSettings& settings);
+};
+
+}
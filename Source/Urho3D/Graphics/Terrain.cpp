@@ -23,7 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DrawableEvents.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/IndexBuffer.h"
@@ -77,6 +80,10 @@ inline void GrowUpdateRegion(IntRect& updateRegion, int x, int y)
     }
 }
 
+TerrainPatchWork::TerrainPatchWork() = default;
+
+TerrainPatchWork::~TerrainPatchWork() = default;
+
 Terrain::Terrain(Context* context) :
     Component(context),
     indexBuffer_(context->CreateObject<IndexBuffer>()),
@@ -93,6 +100,8 @@ Terrain::Terrain(Context* context) :
     maxLodLevels_(MAX_LOD_LEVELS),
     occlusionLodLevel_(M_MAX_UNSIGNED),
     smoothing_(false),
+    asyncGeneration_(false),
+    lodMorphing_(false),
     visible_(true),
     castShadows_(false),
     occluder_(false),
@@ -116,7 +125,14 @@ Terrain::Terrain(Context* context) :
     indexBuffer_->SetShadowed(true);
 }
 
-Terrain::~Terrain() = default;
+Terrain::~Terrain()
+{
+    if (!pendingPatchWork_.empty())
+    {
+        ea::vector<IntVector2> droppedPatches;
+        CancelPatchGeometry(droppedPatches);
+    }
+}
 
 void Terrain::RegisterObject(Context* context)
 {
@@ -127,6 +143,10 @@ void Terrain::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
         AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Distant Material", GetDistantMaterialAttr, SetDistantMaterialAttr, ResourceRef,
+        ResourceRef(Material::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Distant Material Distance", GetDistantMaterialDistance, SetDistantMaterialDistance, float, 0.0f,
+        AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("North Neighbor NodeID", unsigned, northID_, MarkNeighborsDirty, 0, AM_DEFAULT | AM_NODEID);
     URHO3D_ATTRIBUTE_EX("South Neighbor NodeID", unsigned, southID_, MarkNeighborsDirty, 0, AM_DEFAULT | AM_NODEID);
     URHO3D_ATTRIBUTE_EX("West Neighbor NodeID", unsigned, westID_, MarkNeighborsDirty, 0, AM_DEFAULT | AM_NODEID);
@@ -135,6 +155,8 @@ void Terrain::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Patch Size", GetPatchSize, SetPatchSizeAttr, int, DEFAULT_PATCH_SIZE, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Max LOD Levels", GetMaxLodLevels, SetMaxLodLevelsAttr, unsigned, MAX_LOD_LEVELS, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Smooth Height Map", bool, smoothing_, MarkTerrainDirty, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Async Generation", GetAsyncGeneration, SetAsyncGeneration, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Morphing", GetLodMorphing, SetLodMorphingAttr, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Is Occluder", IsOccluder, SetOccluder, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Cast Shadows", GetCastShadows, SetCastShadows, bool, false, AM_DEFAULT);
@@ -246,6 +268,23 @@ void Terrain::SetSmoothing(bool enable)
     }
 }
 
+void Terrain::SetAsyncGeneration(bool enable)
+{
+    asyncGeneration_ = enable;
+}
+
+void Terrain::SetLodMorphing(bool enable)
+{
+    if (enable != lodMorphing_)
+    {
+        lodMorphing_ = enable;
+        lastPatchSize_ = 0; // Force full recreate
+
+        CreateGeometry();
+        MarkNetworkUpdate();
+    }
+}
+
 bool Terrain::SetHeightMap(Image* image)
 {
     bool success = SetHeightMapInternal(image, true);
@@ -266,6 +305,18 @@ void Terrain::SetMaterial(Material* material)
     MarkNetworkUpdate();
 }
 
+void Terrain::SetDistantMaterial(Material* material)
+{
+    distantMaterial_ = material;
+    MarkNetworkUpdate();
+}
+
+void Terrain::SetDistantMaterialDistance(float distance)
+{
+    distantMaterialDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
 void Terrain::SetNorthNeighbor(Terrain* north)
 {
     if (north == north_)
@@ -534,6 +585,11 @@ Material* Terrain::GetMaterial() const
     return material_;
 }
 
+Material* Terrain::GetDistantMaterial() const
+{
+    return distantMaterial_;
+}
+
 TerrainPatch* Terrain::GetPatch(unsigned index) const
 {
     return index < patches_.size() ? patches_[index].Get() : nullptr;
@@ -668,126 +724,350 @@ void Terrain::CreatePatchGeometry(TerrainPatch* patch)
 {
     URHO3D_PROFILE("CreatePatchGeometry");
 
-    auto row = (unsigned)(patchSize_ + 1);
-    VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
-    Geometry* geometry = patch->GetGeometry();
-    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
-    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
-
-    // Scale in lightmap is intentionally ignored here
-    // because lightmapper itself needs Terrain with lightmap UV but without lightmapping during rendering
-    VertexMaskFlags vertexMask{ MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT };
-    if (bakeLightmap_)
-        vertexMask |= MASK_TEXCOORD2;
+    SharedPtr<TerrainPatchWork> work(new TerrainPatchWork());
+    work->patch_ = patch;
+    work->coordinates_ = patch->GetCoordinates();
+    GeneratePatchGeometryData(*work);
+    CommitPatchGeometry(*work);
+}
 
-    if (vertexBuffer->GetVertexCount() != row * row || vertexBuffer->GetElementMask() != vertexMask)
-        vertexBuffer->SetSize(row * row, vertexMask);
+void Terrain::GeneratePatchGeometryData(TerrainPatchWork& work) const
+{
+    URHO3D_PROFILE("GeneratePatchGeometryData");
 
-    ea::shared_array<unsigned char> cpuVertexData(new unsigned char[row * row * sizeof(Vector3)]);
-    ea::shared_array<unsigned char> occlusionCpuVertexData(new unsigned char[row * row * sizeof(Vector3)]);
+    auto row = (unsigned)(patchSize_ + 1);
+    unsigned vertexSize = 12 * sizeof(float);
+    if (bakeLightmap_)
+        vertexSize += 2 * sizeof(float);
+    if (lodMorphing_)
+        vertexSize += 2 * sizeof(float);
+    // With LOD morphing, edge skirts add one extra ring of vertices per edge
+    unsigned vertexCount = row * row + (lodMorphing_ ? 4 * row : 0);
+
+    // In headless mode generate only the CPU position data used for raycasts and the bounding box; the render
+    // vertex data and the occlusion geometry would never be used
+    const bool renderData = GetSubsystem<Graphics>() != nullptr;
+    if (renderData)
+    {
+        work.vertexData_ = new unsigned char[vertexCount * vertexSize];
+        work.occlusionCpuVertexData_ = new unsigned char[vertexCount * sizeof(Vector3)];
+    }
+    work.cpuVertexData_ = new unsigned char[vertexCount * sizeof(Vector3)];
 
-    auto* vertexData = (float*)vertexBuffer->Lock(0, vertexBuffer->GetVertexCount());
-    auto* positionData = (float*)cpuVertexData.get();
-    auto* occlusionData = (float*)occlusionCpuVertexData.get();
+    auto* vertexData = (float*)work.vertexData_.get();
+    auto* positionData = (float*)work.cpuVertexData_.get();
+    auto* occlusionData = (float*)work.occlusionCpuVertexData_.get();
     BoundingBox box;
 
     unsigned occlusionLevel = occlusionLodLevel_;
     if (occlusionLevel > numLodLevels_ - 1)
         occlusionLevel = numLodLevels_ - 1;
 
-    if (vertexData)
-    {
-        const IntVector2& coords = patch->GetCoordinates();
-        unsigned lodExpand = (1u << (occlusionLevel)) - 1;
-        unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
+    const IntVector2& coords = work.coordinates_;
+    unsigned lodExpand = (1u << (occlusionLevel)) - 1;
+    unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
 
-        for (unsigned z = 0; z <= patchSize_; ++z)
+    for (unsigned z = 0; z <= patchSize_; ++z)
+    {
+        for (unsigned x = 0; x <= patchSize_; ++x)
         {
-            for (unsigned x = 0; x <= patchSize_; ++x)
+            int xPos = coords.x_ * patchSize_ + x;
+            int zPos = coords.y_ * patchSize_ + z;
+
+            // Position
+            Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
+            *positionData++ = position.x_;
+            *positionData++ = position.y_;
+            *positionData++ = position.z_;
+
+            box.Merge(position);
+
+            if (!renderData)
+                continue;
+
+            *vertexData++ = position.x_;
+            *vertexData++ = position.y_;
+            *vertexData++ = position.z_;
+
+            // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
+            // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
+            float minHeight = position.y_;
+            if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
             {
-                int xPos = coords.x_ * patchSize_ + x;
-                int zPos = coords.y_ * patchSize_ + z;
-
-                // Position
-                Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
-                *vertexData++ = position.x_;
-                *vertexData++ = position.y_;
-                *vertexData++ = position.z_;
-                *positionData++ = position.x_;
-                *positionData++ = position.y_;
-                *positionData++ = position.z_;
-
-                box.Merge(position);
-
-                // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
-                // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
-                float minHeight = position.y_;
-                if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
+                int minX = Max(xPos - halfLodExpand, 0);
+                int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
+                int minZ = Max(zPos - halfLodExpand, 0);
+                int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
+                for (int nZ = minZ; nZ <= maxZ; ++nZ)
                 {
-                    int minX = Max(xPos - halfLodExpand, 0);
-                    int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
-                    int minZ = Max(zPos - halfLodExpand, 0);
-                    int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
-                    for (int nZ = minZ; nZ <= maxZ; ++nZ)
-                    {
-                        for (int nX = minX; nX <= maxX; ++nX)
-                            minHeight = Min(minHeight, GetRawHeight(nX, nZ));
-                    }
+                    for (int nX = minX; nX <= maxX; ++nX)
+                        minHeight = Min(minHeight, GetRawHeight(nX, nZ));
                 }
-                *occlusionData++ = position.x_;
-                *occlusionData++ = minHeight;
-                *occlusionData++ = position.z_;
-
-                // Normal
-                Vector3 normal = GetRawNormal(xPos, zPos);
-                *vertexData++ = normal.x_;
-                *vertexData++ = normal.y_;
-                *vertexData++ = normal.z_;
-
-                // Texture coordinate(s)
-                const Vector2 texCoord = HeightMapToUV({ xPos, numVertices_.y_ - 1 - zPos });
+            }
+            *occlusionData++ = position.x_;
+            *occlusionData++ = minHeight;
+            *occlusionData++ = position.z_;
+
+            // Normal
+            Vector3 normal = GetRawNormal(xPos, zPos);
+            *vertexData++ = normal.x_;
+            *vertexData++ = normal.y_;
+            *vertexData++ = normal.z_;
+
+            // Texture coordinate(s)
+            const Vector2 texCoord = HeightMapToUV({ xPos, numVertices_.y_ - 1 - zPos });
+            *vertexData++ = texCoord.x_;
+            *vertexData++ = texCoord.y_;
+
+            if (bakeLightmap_)
+            {
                 *vertexData++ = texCoord.x_;
                 *vertexData++ = texCoord.y_;
+            }
 
-                if (bakeLightmap_)
+            // Tangent
+            Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
+            *vertexData++ = xyz.x_;
+            *vertexData++ = xyz.y_;
+            *vertexData++ = xyz.z_;
+            *vertexData++ = 1.0f;
+
+            if (lodMorphing_)
+            {
+                // Morph target: the height of this vertex on the first coarser LOD grid it is no longer part of
+                unsigned disappearLevel = numLodLevels_;
+                for (unsigned level = 1; level < numLodLevels_; ++level)
                 {
-                    *vertexData++ = texCoord.x_;
-                    *vertexData++ = texCoord.y_;
+                    unsigned mask = (1u << level) - 1;
+                    if ((x & mask) || (z & mask))
+                    {
+                        disappearLevel = level;
+                        break;
+                    }
                 }
 
-                // Tangent
-                Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
-                *vertexData++ = xyz.x_;
-                *vertexData++ = xyz.y_;
-                *vertexData++ = xyz.z_;
-                *vertexData++ = 1.0f;
+                if (disappearLevel < numLodLevels_)
+                {
+                    *vertexData++ = GetLodHeight(xPos, zPos, disappearLevel);
+                    *vertexData++ = (float)disappearLevel;
+                }
+                else
+                {
+                    // Part of the coarsest grid; never morphs
+                    *vertexData++ = position.y_;
+                    *vertexData++ = (float)numLodLevels_;
+                }
             }
         }
+    }
+
+    work.boundingBox_ = box;
+
+    if (lodMorphing_)
+    {
+        // Generate skirt vertices dropped to the lowest height of the patch. Any crack caused by morphing or by a
+        // coarser neighbor edge stays above the patch minimum, so the skirts are guaranteed to cover them
+        float skirtY = box.min_.y_;
+
+        auto writeSkirtVertex = [&](int x, int z)
+        {
+            int xPos = coords.x_ * patchSize_ + x;
+            int zPos = coords.y_ * patchSize_ + z;
+
+            Vector3 position((float)x * spacing_.x_, skirtY, (float)z * spacing_.z_);
+            *positionData++ = position.x_;
+            *positionData++ = position.y_;
+            *positionData++ = position.z_;
+
+            if (!renderData)
+                return;
+
+            *vertexData++ = position.x_;
+            *vertexData++ = position.y_;
+            *vertexData++ = position.z_;
+            *occlusionData++ = position.x_;
+            *occlusionData++ = position.y_;
+            *occlusionData++ = position.z_;
+
+            Vector3 normal = GetRawNormal(xPos, zPos);
+            *vertexData++ = normal.x_;
+            *vertexData++ = normal.y_;
+            *vertexData++ = normal.z_;
+
+            const Vector2 texCoord = HeightMapToUV({ xPos, numVertices_.y_ - 1 - zPos });
+            *vertexData++ = texCoord.x_;
+            *vertexData++ = texCoord.y_;
+
+            if (bakeLightmap_)
+            {
+                *vertexData++ = texCoord.x_;
+                *vertexData++ = texCoord.y_;
+            }
+
+            Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
+            *vertexData++ = xyz.x_;
+            *vertexData++ = xyz.y_;
+            *vertexData++ = xyz.z_;
+            *vertexData++ = 1.0f;
+
+            // Skirt vertices never morph
+            *vertexData++ = skirtY;
+            *vertexData++ = (float)(numLodLevels_ + 1);
+        };
+
+        for (int x = 0; x <= patchSize_; ++x)
+            writeSkirtVertex(x, 0);
+        for (int x = 0; x <= patchSize_; ++x)
+            writeSkirtVertex(x, patchSize_);
+        for (int z = 0; z <= patchSize_; ++z)
+            writeSkirtVertex(0, z);
+        for (int z = 0; z <= patchSize_; ++z)
+            writeSkirtVertex(patchSize_, z);
+    }
+
+    // LOD errors drive the rendered LOD selection only
+    if (renderData)
+        CalculateLodErrors(coords, work.lodErrors_);
+}
+
+void Terrain::CommitPatchGeometry(TerrainPatchWork& work)
+{
+    TerrainPatch* patch = work.patch_;
+    if (!patch || !work.cpuVertexData_)
+        return;
 
-        vertexBuffer->Unlock();
-        vertexBuffer->ClearDataLost();
+    auto row = (unsigned)(patchSize_ + 1);
+    unsigned vertexCount = row * row + (lodMorphing_ ? 4 * row : 0);
+    VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
+    Geometry* geometry = patch->GetGeometry();
+    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
+    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
+
+    // Scale in lightmap is intentionally ignored here
+    // because lightmapper itself needs Terrain with lightmap UV but without lightmapping during rendering
+    ea::vector<VertexElement> elements;
+    elements.push_back(VertexElement(TYPE_VECTOR3, SEM_POSITION));
+    elements.push_back(VertexElement(TYPE_VECTOR3, SEM_NORMAL));
+    elements.push_back(VertexElement(TYPE_VECTOR2, SEM_TEXCOORD, 0));
+    if (bakeLightmap_)
+        elements.push_back(VertexElement(TYPE_VECTOR2, SEM_TEXCOORD, 1));
+    elements.push_back(VertexElement(TYPE_VECTOR4, SEM_TANGENT));
+    if (lodMorphing_)
+        elements.push_back(VertexElement(TYPE_VECTOR2, SEM_TEXCOORD, 2));
+
+    // In headless mode only the raycast position data exists; leave the vertex buffer empty
+    if (work.vertexData_)
+    {
+        if (vertexBuffer->GetVertexCount() != vertexCount || vertexBuffer->GetElements() != elements)
+            vertexBuffer->SetSize(vertexCount, elements);
+
+        if (void* dest = vertexBuffer->Lock(0, vertexBuffer->GetVertexCount()))
+        {
+            memcpy(dest, work.vertexData_.get(), vertexCount * vertexBuffer->GetVertexSize());
+            vertexBuffer->Unlock();
+            vertexBuffer->ClearDataLost();
+        }
     }
 
-    patch->SetBoundingBox(box);
+    patch->SetBoundingBox(work.boundingBox_);
 
     if (drawRanges_.size())
     {
+        unsigned occlusionLevel = occlusionLodLevel_;
+        if (occlusionLevel > numLodLevels_ - 1)
+            occlusionLevel = numLodLevels_ - 1;
         unsigned occlusionDrawRange = occlusionLevel << 4u;
 
         geometry->SetIndexBuffer(indexBuffer_);
         geometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first, drawRanges_[0].second, false);
-        geometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        geometry->SetRawVertexData(work.cpuVertexData_, MASK_POSITION);
         maxLodGeometry->SetIndexBuffer(indexBuffer_);
         maxLodGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first, drawRanges_[0].second, false);
-        maxLodGeometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        maxLodGeometry->SetRawVertexData(work.cpuVertexData_, MASK_POSITION);
         occlusionGeometry->SetIndexBuffer(indexBuffer_);
         occlusionGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[occlusionDrawRange].first, drawRanges_[occlusionDrawRange].second, false);
-        occlusionGeometry->SetRawVertexData(occlusionCpuVertexData, MASK_POSITION);
+        occlusionGeometry->SetRawVertexData(work.occlusionCpuVertexData_, MASK_POSITION);
     }
 
+    patch->GetLodErrors() = work.lodErrors_;
     patch->ResetLod();
 }
 
+void Terrain::QueuePatchGeometry(TerrainPatch* patch)
+{
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue || !workQueue->GetNumThreads())
+    {
+        CreatePatchGeometry(patch);
+        return;
+    }
+
+    SharedPtr<TerrainPatchWork> work(new TerrainPatchWork());
+    work->patch_ = patch;
+    work->coordinates_ = patch->GetCoordinates();
+
+    if (pendingPatchWork_.empty())
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Terrain, HandleBeginFrame));
+    pendingPatchWork_.push_back(work);
+
+    work->workItem_ = workQueue->AddWorkItem([this, work]()
+    {
+        GeneratePatchGeometryData(*work);
+        work->generated_.store(true, std::memory_order_release);
+    });
+}
+
+void Terrain::CancelPatchGeometry(ea::vector<IntVector2>& droppedPatches)
+{
+    auto* workQueue = GetSubsystem<WorkQueue>();
+
+    for (unsigned i = 0; i < pendingPatchWork_.size(); ++i)
+    {
+        TerrainPatchWork& work = *pendingPatchWork_[i];
+
+        if (!work.generated_.load(std::memory_order_acquire))
+        {
+            // Not yet executed: remove from the queue if possible, otherwise wait for the worker thread to finish,
+            // as the height data the job reads is about to be modified
+            if (!workQueue || workQueue->RemoveWorkItem(work.workItem_))
+            {
+                droppedPatches.push_back(work.coordinates_);
+                continue;
+            }
+
+            while (!work.generated_.load(std::memory_order_acquire))
+                Time::Sleep(0);
+        }
+
+        // Upload the finished data so that it is not lost
+        CommitPatchGeometry(work);
+    }
+
+    pendingPatchWork_.clear();
+    UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
+void Terrain::HandleBeginFrame(StringHash /*eventType*/, VariantMap& eventData)
+{
+    URHO3D_PROFILE("CommitTerrainPatches");
+
+    // Upload the patches whose background generation has completed. The rest remain pending
+    for (unsigned i = 0; i < pendingPatchWork_.size();)
+    {
+        TerrainPatchWork& work = *pendingPatchWork_[i];
+        if (work.generated_.load(std::memory_order_acquire))
+        {
+            CommitPatchGeometry(work);
+            pendingPatchWork_.erase(pendingPatchWork_.begin() + i);
+        }
+        else
+            ++i;
+    }
+
+    if (pendingPatchWork_.empty())
+        UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
 void Terrain::UpdatePatchLod(TerrainPatch* patch)
 {
     Geometry* geometry = patch->GetGeometry();
@@ -822,6 +1102,12 @@ void Terrain::SetMaterialAttr(const ResourceRef& value)
     SetMaterial(cache->GetResource<Material>(value.name_));
 }
 
+void Terrain::SetDistantMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetDistantMaterial(cache->GetResource<Material>(value.name_));
+}
+
 void Terrain::SetHeightMapAttr(const ResourceRef& value)
 {
     auto* cache = GetSubsystem<ResourceCache>();
@@ -863,11 +1149,26 @@ void Terrain::SetOcclusionLodLevelAttr(unsigned value)
     }
 }
 
+void Terrain::SetLodMorphingAttr(bool value)
+{
+    if (value != lodMorphing_)
+    {
+        lodMorphing_ = value;
+        lastPatchSize_ = 0; // Force full recreate
+        recreateTerrain_ = true;
+    }
+}
+
 ResourceRef Terrain::GetMaterialAttr() const
 {
     return GetResourceRef(material_, Material::GetTypeStatic());
 }
 
+ResourceRef Terrain::GetDistantMaterialAttr() const
+{
+    return GetResourceRef(distantMaterial_, Material::GetTypeStatic());
+}
+
 ResourceRef Terrain::GetHeightMapAttr() const
 {
     return GetResourceRef(heightMap_, Image::GetTypeStatic());
@@ -903,6 +1204,11 @@ void Terrain::CreateGeometry()
 
     URHO3D_PROFILE("CreateTerrainGeometry");
 
+    // Finish pending background generation first, as the height data is about to change under the worker threads
+    ea::vector<IntVector2> droppedPatches;
+    if (!pendingPatchWork_.empty())
+        CancelPatchGeometry(droppedPatches);
+
     unsigned prevNumPatches = patches_.size();
 
     // Determine number of LOD levels
@@ -983,6 +1289,13 @@ void Terrain::CreateGeometry()
     for (unsigned i = 0; i < dirtyPatches.size(); ++i)
         dirtyPatches[i] = updateAll;
 
+    // Patches whose queued background generation was dropped must be regenerated
+    for (const IntVector2& coords : droppedPatches)
+    {
+        if (coords.x_ < numPatches_.x_ && coords.y_ < numPatches_.y_)
+            dirtyPatches[coords.y_ * numPatches_.x_ + coords.x_] = true;
+    }
+
     patches_.clear();
 
     if (heightMap_)
@@ -1170,8 +1483,10 @@ void Terrain::CreateGeometry()
 
             if (dirtyPatches[i])
             {
-                CreatePatchGeometry(patch);
-                CalculateLodErrors(patch);
+                if (asyncGeneration_)
+                    QueuePatchGeometry(patch);
+                else
+                    CreatePatchGeometry(patch);
             }
 
             SetPatchNeighbors(patch);
@@ -1341,6 +1656,59 @@ void Terrain::CreateIndexData()
                 }
             }
 
+            // Build the edge skirts when LOD morphing is enabled. The skirt step must match the drawn edge topology
+            if (lodMorphing_)
+            {
+                unsigned southBase = row * row;
+                unsigned northBase = southBase + row;
+                unsigned westBase = southBase + 2 * row;
+                unsigned eastBase = southBase + 3 * row;
+
+                int southSkip = (j & STITCH_SOUTH) ? skip * 2 : skip;
+                for (int x = 0; x < patchSize_; x += southSkip)
+                {
+                    indices.push_back((unsigned short) x);
+                    indices.push_back((unsigned short) (southBase + x + southSkip));
+                    indices.push_back((unsigned short) (southBase + x));
+                    indices.push_back((unsigned short) x);
+                    indices.push_back((unsigned short) (x + southSkip));
+                    indices.push_back((unsigned short) (southBase + x + southSkip));
+                }
+
+                int northSkip = (j & STITCH_NORTH) ? skip * 2 : skip;
+                for (int x = 0; x < patchSize_; x += northSkip)
+                {
+                    indices.push_back((unsigned short) (northBase + x));
+                    indices.push_back((unsigned short) (patchSize_ * row + x + northSkip));
+                    indices.push_back((unsigned short) (patchSize_ * row + x));
+                    indices.push_back((unsigned short) (northBase + x));
+                    indices.push_back((unsigned short) (northBase + x + northSkip));
+                    indices.push_back((unsigned short) (patchSize_ * row + x + northSkip));
+                }
+
+                int westSkip = (j & STITCH_WEST) ? skip * 2 : skip;
+                for (int z = 0; z < patchSize_; z += westSkip)
+                {
+                    indices.push_back((unsigned short) (westBase + z + westSkip));
+                    indices.push_back((unsigned short) (z * row));
+                    indices.push_back((unsigned short) (westBase + z));
+                    indices.push_back((unsigned short) (westBase + z + westSkip));
+                    indices.push_back((unsigned short) ((z + westSkip) * row));
+                    indices.push_back((unsigned short) (z * row));
+                }
+
+                int eastSkip = (j & STITCH_EAST) ? skip * 2 : skip;
+                for (int z = 0; z < patchSize_; z += eastSkip)
+                {
+                    indices.push_back((unsigned short) ((z + eastSkip) * row + patchSize_));
+                    indices.push_back((unsigned short) (eastBase + z));
+                    indices.push_back((unsigned short) (z * row + patchSize_));
+                    indices.push_back((unsigned short) ((z + eastSkip) * row + patchSize_));
+                    indices.push_back((unsigned short) (eastBase + z + eastSkip));
+                    indices.push_back((unsigned short) (eastBase + z));
+                }
+            }
+
             drawRanges_.push_back(ea::make_pair(indexStart, (unsigned)indices.size() - indexStart));
         }
     }
@@ -1417,12 +1785,10 @@ Vector3 Terrain::GetRawNormal(int x, int z) const
             Vector3(nwSlope, up, nwSlope)).Normalized();
 }
 
-void Terrain::CalculateLodErrors(TerrainPatch* patch)
+void Terrain::CalculateLodErrors(const IntVector2& coords, ea::vector<float>& lodErrors) const
 {
     URHO3D_PROFILE("CalculateLodErrors");
 
-    const IntVector2& coords = patch->GetCoordinates();
-    ea::vector<float>& lodErrors = patch->GetLodErrors();
     lodErrors.clear();
     lodErrors.reserve(numLodLevels_);
 
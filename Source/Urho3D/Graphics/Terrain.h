@@ -24,6 +24,9 @@
 
 #include <EASTL/shared_array.h>
 
+#include <atomic>
+
+#include "../Math/BoundingBox.h"
 #include "../Scene/Component.h"
 
 namespace Urho3D
@@ -34,6 +37,35 @@ class IndexBuffer;
 class Material;
 class Node;
 class TerrainPatch;
+struct WorkItem;
+
+/// Asynchronously generated geometry data of one terrain patch, pending upload to the GPU.
+struct TerrainPatchWork : public RefCounted
+{
+    /// Construct.
+    TerrainPatchWork();
+    /// Destruct.
+    ~TerrainPatchWork() override;
+
+    /// Work item processing the generation job.
+    SharedPtr<WorkItem> workItem_;
+    /// Target patch.
+    WeakPtr<TerrainPatch> patch_;
+    /// Patch coordinates.
+    IntVector2 coordinates_;
+    /// Generated vertex data.
+    ea::shared_array<unsigned char> vertexData_;
+    /// Generated CPU-side position data for raycasts.
+    ea::shared_array<unsigned char> cpuVertexData_;
+    /// Generated CPU-side occlusion position data.
+    ea::shared_array<unsigned char> occlusionCpuVertexData_;
+    /// Generated local-space bounding box.
+    BoundingBox boundingBox_;
+    /// Generated LOD error values.
+    ea::vector<float> lodErrors_;
+    /// Generation finished flag. Set by the worker thread.
+    std::atomic<bool> generated_{};
+};
 
 /// Heightmap terrain component.
 class URHO3D_API Terrain : public Component
@@ -65,10 +97,18 @@ public:
     void SetOcclusionLodLevel(unsigned level);
     /// Set smoothing of heightmap.
     void SetSmoothing(bool enable);
+    /// Set whether patch geometry is generated in worker threads and uploaded progressively instead of blocking on heightmap changes.
+    void SetAsyncGeneration(bool enable);
+    /// Set whether patches geomorph between LOD levels and generate edge skirts. Requires a material whose technique defines LODMORPH.
+    void SetLodMorphing(bool enable);
     /// Set heightmap image. Dimensions should be a power of two + 1. Uses 8-bit grayscale, or optionally red as MSB and green as LSB for 16-bit accuracy. Return true if successful.
     bool SetHeightMap(Image* image);
     /// Set material.
     void SetMaterial(Material* material);
+    /// Set optional distant material used by patches beyond the distant material distance. Typically a cheaper material that samples a pre-composited splat texture instead of blending all layers per fragment. Null to use the main material at all distances.
+    void SetDistantMaterial(Material* material);
+    /// Set distance beyond which patches use the distant material. 0 disables the switch.
+    void SetDistantMaterialDistance(float distance);
     /// Set north (positive Z) neighbor terrain for seamless LOD changes across terrains.
     void SetNorthNeighbor(Terrain* north);
     /// Set south (negative Z) neighbor terrain for seamless LOD changes across terrains.
@@ -127,10 +167,20 @@ public:
     /// Return whether smoothing is in use.
     bool GetSmoothing() const { return smoothing_; }
 
+    /// Return whether patch geometry is generated asynchronously.
+    bool GetAsyncGeneration() const { return asyncGeneration_; }
+
+    /// Return whether LOD morphing is in use.
+    bool GetLodMorphing() const { return lodMorphing_; }
+
     /// Return heightmap image.
     Image* GetHeightMap() const;
     /// Return material.
     Material* GetMaterial() const;
+    /// Return distant material, or null if not set.
+    Material* GetDistantMaterial() const;
+    /// Return distance beyond which patches use the distant material.
+    float GetDistantMaterialDistance() const { return distantMaterialDistance_; }
     /// Return patch by index.
     TerrainPatch* GetPatch(unsigned index) const;
     /// Return patch by patch coordinates.
@@ -207,16 +257,22 @@ public:
     void SetHeightMapAttr(const ResourceRef& value);
     /// Set material attribute.
     void SetMaterialAttr(const ResourceRef& value);
+    /// Set distant material attribute.
+    void SetDistantMaterialAttr(const ResourceRef& value);
     /// Set patch size attribute.
     void SetPatchSizeAttr(int value);
     /// Set max LOD levels attribute.
     void SetMaxLodLevelsAttr(unsigned value);
     /// Set occlusion LOD level attribute.
     void SetOcclusionLodLevelAttr(unsigned value);
+    /// Set LOD morphing attribute.
+    void SetLodMorphingAttr(bool value);
     /// Return heightmap attribute.
     ResourceRef GetHeightMapAttr() const;
     /// Return material attribute.
     ResourceRef GetMaterialAttr() const;
+    /// Return distant material attribute.
+    ResourceRef GetDistantMaterialAttr() const;
 
     /// Return world bounding box of the terrain. Calculations are not cached.
     BoundingBox CalculateWorldBoundingBox() const;
@@ -254,7 +310,17 @@ private:
     /// Get slope-based terrain normal at position.
     Vector3 GetRawNormal(int x, int z) const;
     /// Calculate LOD errors for a patch.
-    void CalculateLodErrors(TerrainPatch* patch);
+    void CalculateLodErrors(const IntVector2& coords, ea::vector<float>& lodErrors) const;
+    /// Fill the generated geometry data of one patch. May be called from worker threads; must not touch GPU resources.
+    void GeneratePatchGeometryData(TerrainPatchWork& work) const;
+    /// Upload generated geometry data to the patch. Must be called from the main thread.
+    void CommitPatchGeometry(TerrainPatchWork& work);
+    /// Queue background geometry generation for a patch. Falls back to immediate generation if worker threads are not available.
+    void QueuePatchGeometry(TerrainPatch* patch);
+    /// Cancel pending background patch generation before the height data changes. Completed or executing jobs are uploaded; coordinates of dropped jobs are returned for re-dirtying.
+    void CancelPatchGeometry(ea::vector<IntVector2>& droppedPatches);
+    /// Handle frame begin event. Uploads patches whose background generation has completed.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Set neighbors for a patch.
     void SetPatchNeighbors(TerrainPatch* patch);
     /// Set heightmap image and optionally recreate the geometry immediately. Return true if successful.
@@ -282,6 +348,10 @@ private:
     ea::shared_array<float> sourceHeightData_;
     /// Material.
     SharedPtr<Material> material_;
+    /// Optional distant material used beyond the distant material distance.
+    SharedPtr<Material> distantMaterial_;
+    /// Distance beyond which patches use the distant material. 0 disables the switch.
+    float distantMaterialDistance_{};
     /// Whether the lightmap is enabled.
     bool bakeLightmap_{};
     /// Texel density scale in lightmap.
@@ -292,6 +362,8 @@ private:
     Vector4 lightmapScaleOffset_{ 1.0f, 1.0f, 0.0f, 0.0f };
     /// Terrain patches.
     ea::vector<WeakPtr<TerrainPatch> > patches_;
+    /// Pending background patch generation jobs.
+    ea::vector<SharedPtr<TerrainPatchWork> > pendingPatchWork_;
     /// Draw ranges for different LODs and stitching combinations.
     ea::vector<ea::pair<unsigned, unsigned> > drawRanges_;
     /// North neighbor terrain.
@@ -328,6 +400,10 @@ private:
     unsigned occlusionLodLevel_;
     /// Smoothing enable flag.
     bool smoothing_;
+    /// Asynchronous patch generation flag.
+    bool asyncGeneration_;
+    /// LOD morphing and skirt generation flag.
+    bool lodMorphing_;
     /// Visible flag.
     bool visible_;
     /// Shadowcaster flag.
@@ -136,6 +136,36 @@ void TerrainPatch::UpdateBatches(const FrameInfo& frame)
     }
 
     lodLevel_ = GetCorrectedLodLevel(newLodLevel);
+
+    // Switch to the owner terrain's distant material beyond the configured distance to reduce fragment cost
+    if (owner_)
+    {
+        Material* distantMaterial = owner_->GetDistantMaterial();
+        if (distantMaterial)
+        {
+            const float distantDistance = owner_->GetDistantMaterialDistance();
+            const bool useDistant = distantDistance > 0.0f && distance_ >= distantDistance;
+            batches_[0].material_ = useDistant ? distantMaterial : owner_->GetMaterial();
+        }
+    }
+
+    // Expose the morph factor toward the next coarser LOD level when the owner terrain has LOD morphing enabled
+    if (owner_ && owner_->GetLodMorphing())
+    {
+        float morph = 0.0f;
+        if (lodLevel_ + 1 < lodErrors_.size())
+        {
+            // The morph completes exactly at the distance where the next LOD level would be selected
+            float switchDistance = lodErrors_[lodLevel_ + 1] / LOD_CONSTANT;
+            if (switchDistance > 0.0f)
+                morph = Clamp(2.0f * lodDistance_ / switchDistance - 1.0f, 0.0f, 1.0f);
+        }
+
+        lodMorphParameters_ = Vector4(morph, (float)lodLevel_, 0.0f, 0.0f);
+        batches_[0].lodMorphParameters_ = &lodMorphParameters_;
+    }
+    else
+        batches_[0].lodMorphParameters_ = nullptr;
 }
 
 void TerrainPatch::UpdateGeometry(const FrameInfo& frame)
@@ -153,6 +153,8 @@ private:
     IntVector2 coordinates_;
     /// Current LOD level.
     unsigned lodLevel_;
+    /// LOD morph factor and level, exposed to the vertex shader when the owner terrain has LOD morphing enabled.
+    Vector4 lodMorphParameters_;
 
     /// Whether the lightmap is enabled.
     bool bakeLightmap_{};
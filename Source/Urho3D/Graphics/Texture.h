@@ -69,6 +69,12 @@ public:
     /// Set mip levels to skip on a quality setting when loading. Ensures higher quality levels do not skip more.
     void SetMipsToSkip(MaterialQuality quality, int toSkip);
 
+    /// Mark the texture as rendered on a frame. Used for texture streaming decisions.
+    void MarkUse(unsigned frameNumber) { lastUseFrameNumber_ = frameNumber; }
+
+    /// Return the frame number on which the texture was last rendered.
+    unsigned GetLastUseFrameNumber() const { return lastUseFrameNumber_; }
+
     /// Return API-specific texture format.
     unsigned GetFormat() const { return format_; }
 
@@ -233,6 +239,8 @@ protected:
     unsigned anisotropy_{};
     /// Mip levels to skip when loading per texture quality setting.
     unsigned mipsToSkip_[MAX_TEXTURE_QUALITY_LEVELS]{2, 1, 0};
+    /// Frame number on which was last rendered.
+    unsigned lastUseFrameNumber_{};
     /// Border color.
     Color borderColor_;
     /// Multisampling level.
@@ -39,6 +39,11 @@
 namespace Urho3D
 {
 
+/// Minimum top level dimension to keep resident on a streamable texture.
+static const int MIN_TEXTURE_STREAM_SIZE = 4;
+/// Initial top level dimension to load a streamable texture at; higher mips are streamed in when rendered.
+static const int INITIAL_TEXTURE_STREAM_SIZE = 256;
+
 Texture2D::Texture2D(Context* context) :
     Texture(context)
 {
@@ -101,6 +106,21 @@ bool Texture2D::EndLoad()
     CheckTextureBudget(GetTypeStatic());
 
     SetParameters(loadParameters_);
+
+    // If the renderer has a texture streaming budget, retain the image for later mip residency changes and start at
+    // reduced detail. Renderer streams the higher mips in when the texture is rendered
+    auto* renderer = GetSubsystem<Renderer>();
+    if (renderer && renderer->GetTextureStreamingBudget())
+    {
+        streamImage_ = loadImage_;
+
+        unsigned level = 0;
+        while ((loadImage_->GetWidth() >> (level + 1)) >= INITIAL_TEXTURE_STREAM_SIZE &&
+               (loadImage_->GetHeight() >> (level + 1)) >= INITIAL_TEXTURE_STREAM_SIZE)
+            ++level;
+        streamLevel_ = Min(level, GetMaxStreamLevel());
+    }
+
     bool success = SetData(loadImage_);
 
     loadImage_.Reset();
@@ -109,6 +129,36 @@ bool Texture2D::EndLoad()
     return success;
 }
 
+bool Texture2D::SetStreamLevel(unsigned level)
+{
+    if (!streamImage_)
+        return false;
+
+    level = Min(level, GetMaxStreamLevel());
+    if (level == streamLevel_)
+        return true;
+
+    streamLevel_ = level;
+    return SetData(streamImage_);
+}
+
+unsigned Texture2D::GetMaxStreamLevel() const
+{
+    if (!streamImage_)
+        return 0;
+
+    unsigned level = 0;
+    while ((streamImage_->GetWidth() >> (level + 1)) >= MIN_TEXTURE_STREAM_SIZE &&
+           (streamImage_->GetHeight() >> (level + 1)) >= MIN_TEXTURE_STREAM_SIZE)
+        ++level;
+
+    // A compressed image can not be demoted past its stored mip chain
+    if (streamImage_->IsCompressed() && streamImage_->GetNumCompressedLevels())
+        level = Min(level, streamImage_->GetNumCompressedLevels() - 1);
+
+    return level;
+}
+
 bool Texture2D::SetSize(int width, int height, unsigned format, TextureUsage usage, int multiSample, bool autoResolve)
 {
     if (width <= 0 || height <= 0)
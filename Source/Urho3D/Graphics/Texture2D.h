@@ -73,9 +73,22 @@ public:
     /// Get image data from zero mip level. Only RGB and RGBA textures are supported.
     SharedPtr<Image> GetImage() const;
 
+    /// Set the resident mip level for a streamable texture and re-create the GPU texture from the retained image.
+    /// The level is clamped to keep a reasonable minimum size. Return true if successful.
+    bool SetStreamLevel(unsigned level);
+
     /// Return render surface.
     RenderSurface* GetRenderSurface() const { return renderSurface_; }
 
+    /// Return whether the source image is retained for mip streaming.
+    bool IsStreamable() const { return streamImage_ != nullptr; }
+
+    /// Return the current resident mip level of a streamable texture.
+    unsigned GetStreamLevel() const { return streamLevel_; }
+
+    /// Return the maximum mip level a streamable texture can be demoted to.
+    unsigned GetMaxStreamLevel() const;
+
 protected:
     /// Create the GPU texture.
     bool Create() override;
@@ -90,6 +103,10 @@ private:
     SharedPtr<Image> loadImage_;
     /// Parameter file acquired during BeginLoad.
     SharedPtr<XMLFile> loadParameters_;
+    /// Source image retained for mip streaming.
+    SharedPtr<Image> streamImage_;
+    /// Number of mip levels currently skipped for streaming, on top of the quality setting.
+    unsigned streamLevel_{};
 };
 
 }
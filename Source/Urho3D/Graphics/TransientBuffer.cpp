@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Graphics/TransientBuffer.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// Initial vertex count of a shared buffer. Small first allocations are rounded up to avoid regrowing
+static const unsigned INITIAL_TRANSIENT_VERTICES = 1024;
+
+TransientBuffer::TransientBuffer(Context* context) :
+    Object(context)
+{
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(TransientBuffer, HandleBeginFrame));
+}
+
+TransientBuffer::~TransientBuffer() = default;
+
+void* TransientBuffer::AllocateVertices(unsigned elementMask, unsigned count, VertexBuffer*& buffer, unsigned& start)
+{
+    buffer = nullptr;
+    start = 0;
+
+    if (!count)
+        return nullptr;
+
+    VertexAllocation& allocation = vertexAllocations_[elementMask];
+    if (!allocation.buffer_)
+        allocation.buffer_ = context_->CreateObject<VertexBuffer>();
+
+    if (allocation.used_ + count > allocation.buffer_->GetVertexCount())
+    {
+        // When out of space, retire the current buffer instead of resizing it, so that ranges already handed
+        // out during the frame remain valid for rendering, and continue in a larger buffer
+        unsigned newSize = Max(INITIAL_TRANSIENT_VERTICES, NextPowerOfTwo(count));
+        if (allocation.buffer_->GetVertexCount())
+        {
+            newSize = Max(newSize, allocation.buffer_->GetVertexCount() << 1u);
+            allocation.retired_.push_back(allocation.buffer_);
+            allocation.buffer_ = context_->CreateObject<VertexBuffer>();
+        }
+        if (!allocation.buffer_->SetSize(newSize, elementMask, true))
+            return nullptr;
+        allocation.used_ = 0;
+    }
+
+    // Discard the previous contents on the first lock of the frame; later locks append without synchronization
+    void* data = allocation.buffer_->Lock(allocation.used_, count, allocation.used_ == 0);
+    if (!data)
+        return nullptr;
+
+    buffer = allocation.buffer_;
+    start = allocation.used_;
+    allocation.used_ += count;
+    return data;
+}
+
+void TransientBuffer::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    // All allocations from the previous frame have been rendered by now; start over from the beginning
+    // of each buffer and release the buffers that were retired due to overflow
+    for (auto i = vertexAllocations_.begin(); i != vertexAllocations_.end(); ++i)
+    {
+        i->second.retired_.clear();
+        i->second.used_ = 0;
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Core/Object.h"
+#include "../Graphics/VertexBuffer.h"
+
+namespace Urho3D
+{
+
+/// %Transient vertex buffer allocator subsystem. Sub-allocates geometry that is rewritten every frame, such
+/// as debug draw vertices, from shared dynamic vertex buffers instead of each user uploading into its own.
+/// Allocated ranges stay valid for rendering until the beginning of the next frame.
+class URHO3D_API TransientBuffer : public Object
+{
+    URHO3D_OBJECT(TransientBuffer, Object);
+
+public:
+    /// Construct.
+    explicit TransientBuffer(Context* context);
+    /// Destruct.
+    ~TransientBuffer() override;
+
+    /// Allocate and lock a range of vertices from a shared dynamic buffer with the specified elements. Return
+    /// a pointer for writing the vertex data, or null on failure. On success the caller must fill the range,
+    /// call Unlock() on the returned buffer, and offset its draw calls by the returned start vertex.
+    void* AllocateVertices(unsigned elementMask, unsigned count, VertexBuffer*& buffer, unsigned& start);
+
+private:
+    /// Handle begin frame event. Recycles the buffers for reuse.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+
+    /// Allocation state of the shared buffer for one vertex element mask.
+    struct VertexAllocation
+    {
+        /// Buffer currently being sub-allocated from.
+        SharedPtr<VertexBuffer> buffer_;
+        /// Buffers retired after running out of space, kept alive until the frame ends.
+        ea::vector<SharedPtr<VertexBuffer> > retired_;
+        /// Number of vertices allocated so far during the frame.
+        unsigned used_{};
+    };
+
+    /// Shared vertex buffers per element mask.
+    ea::unordered_map<unsigned, VertexAllocation> vertexAllocations_;
+};
+
+}
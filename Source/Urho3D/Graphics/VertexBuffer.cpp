@@ -116,7 +116,10 @@ VertexBuffer::VertexBuffer(Context* context, bool forceHeadless) :
 
     // Force shadowing mode if graphics subsystem does not exist
     if (!graphics_)
+    {
+        shadowPolicy_ = SHADOW_DATA_FULL;
         shadowed_ = true;
+    }
 }
 
 VertexBuffer::~VertexBuffer()
@@ -131,19 +134,78 @@ void VertexBuffer::RegisterObject(Context* context)
 
 void VertexBuffer::SetShadowed(bool enable)
 {
-    // If no graphics subsystem, can not disable shadowing
+    SetShadowPolicy(enable ? SHADOW_DATA_FULL : SHADOW_DATA_NONE);
+}
+
+void VertexBuffer::SetShadowPolicy(ShadowDataPolicy policy)
+{
+    // If no graphics subsystem, a full CPU copy is mandatory
     if (!graphics_)
-        enable = true;
+        policy = SHADOW_DATA_FULL;
+
+    if (policy == shadowPolicy_)
+        return;
+
+    const bool hasData = vertexSize_ && vertexCount_;
 
-    if (enable != shadowed_)
+    if (policy == SHADOW_DATA_POSITIONS && hasData && GetElement(TYPE_VECTOR3, SEM_POSITION))
     {
-        if (enable && vertexSize_ && vertexCount_)
-            shadowData_ = new unsigned char[vertexCount_ * vertexSize_];
+        positionShadowData_ = new unsigned char[(size_t)vertexCount_ * sizeof(Vector3)];
+        shadowPolicy_ = policy;
+
+        // Recover existing contents from the old shadow copy, or from the GPU buffer when possible
+        if (shadowData_)
+            UpdateShadowDataRange(shadowData_.get(), 0, vertexCount_);
         else
-            shadowData_.reset();
+        {
+            ea::shared_array<unsigned char> data(new unsigned char[(size_t)vertexCount_ * vertexSize_]);
+            if (GetData(data.get()))
+                UpdateShadowDataRange(data.get(), 0, vertexCount_);
+        }
+    }
+    else
+    {
+        positionShadowData_.reset();
+        shadowPolicy_ = policy;
+    }
 
-        shadowed_ = enable;
+    shadowed_ = policy == SHADOW_DATA_FULL;
+
+    if (shadowed_)
+    {
+        if (hasData && !shadowData_)
+        {
+            shadowData_ = new unsigned char[(size_t)vertexCount_ * vertexSize_];
+            // Recover existing contents from the GPU buffer when possible
+            GetData(shadowData_.get());
+        }
     }
+    else
+        shadowData_.reset();
+}
+
+bool VertexBuffer::EnsureShadowData() const
+{
+    if (shadowData_)
+        return true;
+    if (!vertexCount_ || !vertexSize_)
+        return false;
+
+    ea::shared_array<unsigned char> data(new unsigned char[(size_t)vertexCount_ * vertexSize_]);
+    if (!GetData(data.get()))
+        return false;
+
+    shadowData_ = data;
+    return true;
+}
+
+bool VertexBuffer::SetData(const ea::shared_array<unsigned char>& data)
+{
+    // Adopt the array as the shadow copy; SetData() skips the shadow memcpy when given the shadow data itself
+    if (shadowed_ && data && vertexCount_ && vertexSize_)
+        shadowData_ = data;
+
+    return SetData(data.get());
 }
 
 bool VertexBuffer::SetSize(unsigned vertexCount, unsigned elementMask, bool dynamic)
@@ -166,9 +228,39 @@ bool VertexBuffer::SetSize(unsigned vertexCount, const ea::vector<VertexElement>
     else
         shadowData_.reset();
 
+    if (shadowPolicy_ == SHADOW_DATA_POSITIONS && vertexCount_ && GetElement(TYPE_VECTOR3, SEM_POSITION))
+        positionShadowData_ = new unsigned char[(size_t)vertexCount_ * sizeof(Vector3)];
+    else
+        positionShadowData_.reset();
+
     return Create();
 }
 
+void VertexBuffer::UpdateShadowDataRange(const void* data, unsigned start, unsigned count)
+{
+    if (!positionShadowData_ || !data)
+        return;
+
+    const VertexElement* element = GetElement(TYPE_VECTOR3, SEM_POSITION);
+    if (!element || start + count > vertexCount_)
+        return;
+
+    const unsigned char* source = reinterpret_cast<const unsigned char*>(data) + element->offset_;
+    unsigned char* dest = positionShadowData_.get() + start * sizeof(Vector3);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        memcpy(dest, source, sizeof(Vector3));
+        source += vertexSize_;
+        dest += sizeof(Vector3);
+    }
+}
+
+const ea::vector<VertexElement>& VertexBuffer::GetPositionShadowElements()
+{
+    static const ea::vector<VertexElement> positionShadowElements{ VertexElement(TYPE_VECTOR3, SEM_POSITION) };
+    return positionShadowElements;
+}
+
 void VertexBuffer::UpdateOffsets()
 {
     unsigned elementOffset = 0;
@@ -286,7 +378,7 @@ void VertexBuffer::UpdateOffsets(ea::vector<VertexElement>& elements)
 
 ea::vector<Vector4> VertexBuffer::GetUnpackedData(unsigned start, unsigned count) const
 {
-    if (start >= vertexCount_ || count == 0 || !IsShadowed())
+    if (start >= vertexCount_ || count == 0 || !EnsureShadowData())
         return {};
 
     // Clamp count to index buffer size.
@@ -57,12 +57,17 @@ public:
 
     /// Enable shadowing in CPU memory. Shadowing is forced on if the graphics subsystem does not exist.
     void SetShadowed(bool enable);
+    /// Set CPU memory shadowing policy. SHADOW_DATA_POSITIONS keeps only a packed copy of the vertex positions.
+    /// A full shadow copy is forced if the graphics subsystem does not exist.
+    void SetShadowPolicy(ShadowDataPolicy policy);
     /// Set size, vertex elements and dynamic mode. Previous data will be lost.
     bool SetSize(unsigned vertexCount, const ea::vector<VertexElement>& elements, bool dynamic = false);
     /// Set size and vertex elements and dynamic mode using legacy element bitmask. Previous data will be lost.
     bool SetSize(unsigned vertexCount, unsigned elementMask, bool dynamic = false);
     /// Set all data in the buffer.
     bool SetData(const void* data);
+    /// Set all data in the buffer, adopting the array as the shadow copy instead of copying it when shadowing is enabled.
+    bool SetData(const ea::shared_array<unsigned char>& data);
     /// Set a data range in the buffer. Optionally discard data outside the range.
     bool SetDataRange(const void* data, unsigned start, unsigned count, bool discard = false);
     /// Lock the buffer for write-only editing. Return data pointer if successful. Optionally discard data outside the range.
@@ -70,9 +75,18 @@ public:
     /// Unlock the buffer and apply changes to the GPU buffer.
     void Unlock();
 
-    /// Return whether CPU memory shadowing is enabled.
+    /// Read the buffer data back from the GPU into the destination. Potentially slow; not supported on OpenGL ES.
+    bool GetData(void* dest) const;
+    /// Populate the full shadow data by reading back from the GPU if it does not exist yet. The copy is kept until
+    /// the buffer is resized. Return true if shadow data is available.
+    bool EnsureShadowData() const;
+
+    /// Return whether full CPU memory shadowing is enabled.
     bool IsShadowed() const { return shadowed_; }
 
+    /// Return CPU memory shadowing policy.
+    ShadowDataPolicy GetShadowPolicy() const { return shadowPolicy_; }
+
     /// Return whether is dynamic.
     bool IsDynamic() const { return dynamic_; }
 
@@ -115,6 +129,15 @@ public:
     /// Return shared array pointer to the CPU memory shadow data.
     ea::shared_array<unsigned char> GetShadowDataShared() const { return shadowData_; }
 
+    /// Return packed position shadow data, or null if not kept. Stride is sizeof(Vector3).
+    const unsigned char* GetPositionShadowData() const { return positionShadowData_.get(); }
+
+    /// Return shared array pointer to the packed position shadow data.
+    ea::shared_array<unsigned char> GetPositionShadowDataShared() const { return positionShadowData_; }
+
+    /// Return vertex element list describing the packed position shadow data.
+    static const ea::vector<VertexElement>& GetPositionShadowElements();
+
     /// Return buffer hash for building vertex declarations. Used internally.
     unsigned long long GetBufferHash(unsigned streamIndex) { return elementHash_ << (streamIndex * 16); }
 
@@ -161,13 +184,17 @@ private:
     bool Create();
     /// Update the shadow data to the GPU buffer.
     bool UpdateToGPU();
+    /// Update the position shadow data from new buffer contents. No-op unless the positions-only policy is active.
+    void UpdateShadowDataRange(const void* data, unsigned start, unsigned count);
     /// Map the GPU buffer into CPU memory. Not used on OpenGL.
     void* MapBuffer(unsigned start, unsigned count, bool discard);
     /// Unmap the GPU buffer. Not used on OpenGL.
     void UnmapBuffer();
 
-    /// Shadow data.
-    ea::shared_array<unsigned char> shadowData_;
+    /// Shadow data. Mutable to allow lazily populated readback.
+    mutable ea::shared_array<unsigned char> shadowData_;
+    /// Packed position shadow data for the positions-only policy.
+    ea::shared_array<unsigned char> positionShadowData_;
     /// Number of vertices.
     unsigned vertexCount_{};
     /// Vertex size.
@@ -188,7 +215,9 @@ private:
     void* lockScratchData_{};
     /// Dynamic flag.
     bool dynamic_{};
-    /// Shadowed flag.
+    /// Shadowing policy.
+    ShadowDataPolicy shadowPolicy_{SHADOW_DATA_NONE};
+    /// Full shadow copy flag. Kept in sync with the shadowing policy.
     bool shadowed_{};
     /// Discard lock flag. Used by OpenGL only.
     bool discardLock_{};
@@ -25,12 +25,14 @@
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
+#include "../Core/FrameBudget.h"
 #include "../Core/Profiler.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/GlobalIllumination.h"
+#include "../Graphics/ReflectionProbe.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
@@ -61,6 +63,50 @@
 namespace Urho3D
 {
 
+/// Fraction of the far clip distance the camera may move before cached octree query results are requeried.
+static const float DRAWABLE_CACHE_POSITION_MARGIN = 0.02f;
+/// Camera rotation in degrees allowed before cached octree query results are requeried.
+static const float DRAWABLE_CACHE_ROTATION_MARGIN = 2.0f;
+/// Number of light grid cells along each axis.
+static const int LIGHT_GRID_SIZE = 8;
+/// Minimum number of visible lights before building the light grid pays off over per-light octree queries.
+static const unsigned MIN_LIGHTS_FOR_GRID = 8;
+
+/// Compute the range of light grid cells overlapped by a world-space bounding box.
+static void GetLightGridCellRange(const BoundingBox& gridBox, const Vector3& invCellSize, const BoundingBox& box,
+    IntVector3& beginCell, IntVector3& endCell)
+{
+    Vector3 minPos = (box.min_ - gridBox.min_) * invCellSize;
+    Vector3 maxPos = (box.max_ - gridBox.min_) * invCellSize;
+    beginCell = IntVector3(Clamp((int)minPos.x_, 0, LIGHT_GRID_SIZE - 1), Clamp((int)minPos.y_, 0, LIGHT_GRID_SIZE - 1),
+        Clamp((int)minPos.z_, 0, LIGHT_GRID_SIZE - 1));
+    endCell = IntVector3(Clamp((int)maxPos.x_, 0, LIGHT_GRID_SIZE - 1), Clamp((int)maxPos.y_, 0, LIGHT_GRID_SIZE - 1),
+        Clamp((int)maxPos.z_, 0, LIGHT_GRID_SIZE - 1));
+}
+
+/// Fallback names for GPU timed sections of render path commands without a tag or pass name.
+static const ea::string commandTimingNames[] =
+{
+    "none",
+    "clear",
+    "scenepass",
+    "quad",
+    "forwardlights",
+    "lightvolumes",
+    "renderui",
+    "sendevent"
+};
+
+/// Return the name identifying a render path command in GPU pass timings.
+static const ea::string& GetCommandTimingName(const RenderPathCommand& command)
+{
+    if (!command.tag_.empty())
+        return command.tag_;
+    if (!command.pass_.empty())
+        return command.pass_;
+    return commandTimingNames[command.type_];
+}
+
 /// Update ambient for Drawable.
 static void UpdateBatchAmbient(Batch& destBatch, GlobalIllumination* gi, Drawable* drawable)
 {
@@ -76,6 +122,13 @@ static void UpdateBatchAmbient(Batch& destBatch, GlobalIllumination* gi, Drawabl
     }
 }
 
+/// Update reflection probe environment texture for Drawable.
+static void UpdateBatchEnvironment(Batch& destBatch, ReflectionProbeManager* probeManager, Drawable* drawable)
+{
+    if (probeManager)
+        destBatch.environmentTexture_ = probeManager->GetProbeTexture(drawable->GetWorldBoundingBox().Center());
+}
+
 /// %Frustum octree query for shadowcasters.
 class ShadowCasterOctreeQuery : public FrustumOctreeQuery
 {
@@ -102,6 +155,67 @@ public:
             }
         }
     }
+
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override
+    {
+        while (start != end)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+
+            if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_) && drawable->GetCastShadows())
+            {
+                if (inside || frustum_.IsInsideFast(data.box_))
+                    result_.push_back(drawable);
+            }
+        }
+    }
+};
+
+/// %Bounding box octree query for shadowcasters. Used to gather a superset of all cascade shadow casters of a
+/// directional light with a single octree traversal.
+class ShadowCasterBoxOctreeQuery : public BoxOctreeQuery
+{
+public:
+    /// Construct with bounding box and query parameters.
+    ShadowCasterBoxOctreeQuery(ea::vector<Drawable*>& result, const BoundingBox& box, DrawableFlags drawableFlags = DRAWABLE_ANY,
+        unsigned viewMask = DEFAULT_VIEWMASK) :
+        BoxOctreeQuery(result, box, drawableFlags, viewMask)
+    {
+    }
+
+    /// Intersection test for drawables.
+    void TestDrawables(Drawable** start, Drawable** end, bool inside) override
+    {
+        while (start != end)
+        {
+            Drawable* drawable = *start++;
+
+            if (drawable->GetCastShadows() && (drawable->GetDrawableFlags() & drawableFlags_) &&
+                (drawable->GetViewMask() & viewMask_))
+            {
+                if (inside || box_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                    result_.push_back(drawable);
+            }
+        }
+    }
+
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override
+    {
+        while (start != end)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+
+            if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_) && drawable->GetCastShadows())
+            {
+                if (inside || box_.IsInsideFast(data.box_))
+                    result_.push_back(drawable);
+            }
+        }
+    }
 };
 
 /// %Frustum octree query for zones and occluders.
@@ -131,6 +245,24 @@ public:
             }
         }
     }
+
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override
+    {
+        while (start != end)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+            unsigned char flags = data.drawableFlags_;
+
+            if ((flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder())) &&
+                (data.viewMask_ & viewMask_))
+            {
+                if (inside || frustum_.IsInsideFast(data.box_))
+                    result_.push_back(drawable);
+            }
+        }
+    }
 };
 
 /// %Frustum octree query with occlusion.
@@ -174,6 +306,22 @@ public:
         }
     }
 
+    /// Intersection test for drawables using the octant's contiguous culling data.
+    void TestDrawables(Drawable** start, Drawable** end, const DrawableCullData* cullData, bool inside) override
+    {
+        while (start != end)
+        {
+            const DrawableCullData& data = *cullData++;
+            Drawable* drawable = *start++;
+
+            if ((data.drawableFlags_ & drawableFlags_) && (data.viewMask_ & viewMask_))
+            {
+                if (inside || frustum_.IsInsideFast(data.box_))
+                    result_.push_back(drawable);
+            }
+        }
+    }
+
     /// Occlusion buffer.
     OcclusionBuffer* buffer_;
 };
@@ -185,10 +333,10 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
     auto** start = reinterpret_cast<Drawable**>(item->start_);
     auto** end = reinterpret_cast<Drawable**>(item->end_);
     OcclusionBuffer* buffer = view->occlusionBuffer_;
-    const Matrix3x4& viewMatrix = view->cullCamera_->GetView();
+    const Matrix3x4& viewMatrix = view->cullCameraSnapshot_.GetView();
     Vector3 viewZ = Vector3(viewMatrix.m20_, viewMatrix.m21_, viewMatrix.m22_);
     Vector3 absViewZ = viewZ.Abs();
-    unsigned cameraViewMask = view->cullCamera_->GetViewMask();
+    unsigned cameraViewMask = view->cullCameraSnapshot_.GetViewMask();
     bool cameraZoneOverride = view->cameraZoneOverride_;
     PerThreadSceneResult& result = view->sceneResults_[threadIndex];
 
@@ -257,6 +405,15 @@ void ProcessLightWork(const WorkItem* item, unsigned threadIndex)
     view->ProcessLight(*query, threadIndex);
 }
 
+void GetLightBatchesWork(const WorkItem* item, unsigned threadIndex)
+{
+    URHO3D_PROFILE("GetLightBatchesWork");
+    auto* view = reinterpret_cast<View*>(item->aux_);
+    auto* job = reinterpret_cast<LightQueueJob*>(item->start_);
+
+    view->BuildLightQueueBatches(*job);
+}
+
 void UpdateDrawableGeometriesWork(const WorkItem* item, unsigned threadIndex)
 {
     URHO3D_PROFILE("UpdateDrawableGeometriesWork");
@@ -289,6 +446,14 @@ void SortBatchQueueBackToFrontWork(const WorkItem* item, unsigned threadIndex)
     queue->SortBackToFront();
 }
 
+void SortBatchQueueByStateWork(const WorkItem* item, unsigned threadIndex)
+{
+    URHO3D_PROFILE("SortBatchQueueByStateWork");
+    auto* queue = reinterpret_cast<BatchQueue*>(item->start_);
+
+    queue->SortByState();
+}
+
 void SortLightQueueWork(const WorkItem* item, unsigned threadIndex)
 {
     URHO3D_PROFILE("SortLightQueueWork");
@@ -351,6 +516,18 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     viewSize_ = viewRect_.Size();
     rtSize_ = IntVector2(rtWidth, rtHeight);
 
+    // Apply dynamic resolution: the scene is rendered at the scaled size into a substitute target and stretched
+    // into the viewport rect by the final blit. Render-to-texture views keep their requested size.
+    if (!renderTarget_)
+    {
+        const float resolutionScale = renderer_->GetDynamicResolutionScale();
+        if (resolutionScale != 1.0f)
+        {
+            viewSize_.x_ = Max(RoundToInt((float)viewSize_.x_ * resolutionScale), 1);
+            viewSize_.y_ = Max(RoundToInt((float)viewSize_.y_ * resolutionScale), 1);
+        }
+    }
+
     // On OpenGL flip the viewport if rendering to a texture for consistent UV addressing with Direct3D9
 #ifdef URHO3D_OPENGL
     if (renderTarget_)
@@ -381,6 +558,7 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
             forwardLightsCommand_ = sourceView_->forwardLightsCommand_;
             octree_ = sourceView_->octree_;
             globalIllumination_ = sourceView_->globalIllumination_;
+            reflectionProbeManager_ = sourceView_->reflectionProbeManager_;
             return true;
         }
         else
@@ -480,6 +658,7 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
 
     octree_ = nullptr;
     globalIllumination_ = nullptr;
+    reflectionProbeManager_ = nullptr;
     // Get default zone first in case we do not have zones defined
     cameraZone_ = farClipZone_ = renderer_->GetDefaultZone();
 
@@ -494,6 +673,7 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
 
         octree_ = scene_->GetComponent<Octree>();
         globalIllumination_ = scene_->GetComponent<GlobalIllumination>();
+        reflectionProbeManager_ = scene_->GetComponent<ReflectionProbeManager>();
         if (!octree_)
             return false;
 
@@ -551,6 +731,28 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     return true;
 }
 
+void View::PrepareDrawablesQuery()
+{
+    // Only the occlusion-free query path can run concurrently: occluder rendering allocates
+    // renderer state, and automatic aspect ratio mutates the camera inside Update()
+    preparedQueryValid_ = false;
+    if (sourceView_ || !octree_ || !cullCamera_ || maxOccluderTriangles_ > 0 || cullCamera_->GetAutoAspectRatio())
+        return;
+
+    {
+        ZoneOccluderOctreeQuery
+            query(preparedZoneDrawables_, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_ZONE, cullCamera_->GetViewMask());
+        octree_->GetDrawables(query);
+    }
+    {
+        FrustumOctreeQuery query(preparedGeometryDrawables_, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_LIGHT,
+            cullCamera_->GetViewMask());
+        octree_->GetDrawables(query);
+    }
+
+    preparedQueryValid_ = true;
+}
+
 void View::Update(const FrameInfo& frame)
 {
     // No need to update if using another prepared view
@@ -589,6 +791,10 @@ void View::Update(const FrameInfo& frame)
     if (cullCamera_ && cullCamera_->GetAutoAspectRatio())
         cullCamera_->SetAspectRatioInternal((float)frame_.viewSize_.x_ / (float)frame_.viewSize_.y_);
 
+    // Snapshot the culling camera's derived data so that worker threads read it without lazy recomputation
+    if (cullCamera_)
+        cullCameraSnapshot_.Define(cullCamera_);
+
     GetDrawables();
     GetBatches();
     renderer_->StorePreparedView(this, cullCamera_);
@@ -618,6 +824,9 @@ void View::Render()
     if (renderer_->GetDynamicInstancing() && graphics_->GetInstancingSupport())
         PrepareInstancingBuffer();
 
+    if (renderer_->GetBonePaletteSkinning())
+        PrepareSkinningBuffer();
+
     // It is possible, though not recommended, that the same camera is used for multiple main views. Set automatic aspect ratio
     // to ensure correct projection will be used
     if (camera_ && camera_->GetAutoAspectRatio())
@@ -786,6 +995,11 @@ void View::SetCameraShaderParameters(Camera* camera)
         SetCommandShaderParameters(*passCommand_);
 }
 
+CompareMode View::GetCommandDepthTest() const
+{
+    return passCommand_ ? passCommand_->depthTest_ : MAX_COMPAREMODES;
+}
+
 void View::SetCommandShaderParameters(const RenderPathCommand& command)
 {
     const ea::unordered_map<StringHash, Variant>& parameters = command.shaderParameters_;
@@ -815,17 +1029,79 @@ void View::SetGBufferShaderParameters(const IntVector2& texSize, const IntRect&
     graphics_->SetShaderParameter(PSP_GBUFFERINVSIZE, Vector2(invSizeX, invSizeY));
 }
 
+bool View::IsDrawableCacheReusable() const
+{
+    if (!drawableCacheValid_ || !octree_ || !cullCamera_)
+        return false;
+    if (octree_->GetStructureVersion() != cachedOctreeVersion_ || cullCamera_->GetViewMask() != cachedViewMask_ ||
+        cullCamera_->GetProjection() != cachedProjection_)
+        return false;
+
+    // The cached results were queried with a frustum pushed outward far enough to cover this much camera movement
+    Node* cameraNode = cullCamera_->GetNode();
+    const float maxMove = cullCamera_->GetFarClip() * DRAWABLE_CACHE_POSITION_MARGIN;
+    if ((cameraNode->GetWorldPosition() - cachedCameraPos_).LengthSquared() > maxMove * maxMove)
+        return false;
+    // Quaternion dot product is the cosine of half the rotation angle between the two orientations
+    return Abs(cameraNode->GetWorldRotation().DotProduct(cachedCameraRot_)) >= Cos(0.5f * DRAWABLE_CACHE_ROTATION_MARGIN);
+}
+
 void View::GetDrawables()
 {
     if (!octree_ || !cullCamera_)
         return;
 
     URHO3D_PROFILE("GetDrawables");
+    URHO3D_FRAME_BUDGET("Culling");
 
     auto* queue = GetSubsystem<WorkQueue>();
     ea::vector<Drawable*>& tempDrawables = tempDrawables_[0];
+    const Frustum& frustum = cullCamera_->GetFrustum();
+
+    // When occlusion is not in use, query the octree with a margin-expanded frustum and keep the result as a cache:
+    // while the camera stays within the margin and the octree does not change, the cached superset only needs to be
+    // refiltered against the exact frustum instead of traversing the octree. Teleports fall back to a full requery.
+    const bool cacheAllowed = maxOccluderTriangles_ <= 0 && !preparedQueryValid_;
+    const bool reuseCache = cacheAllowed && IsDrawableCacheReusable();
+
+    Frustum expandedFrustum;
+    if (cacheAllowed && !reuseCache)
+    {
+        drawableCacheValid_ = false;
+        expandedFrustum = frustum;
+        // Push each plane outward to cover both translation and rotation up to the margins
+        const float margin =
+            cullCamera_->GetFarClip() * (DRAWABLE_CACHE_POSITION_MARGIN + Sin(DRAWABLE_CACHE_ROTATION_MARGIN));
+        for (Plane& plane : expandedFrustum.planes_)
+            plane.d_ += margin;
+    }
 
     // Get zones and occluders first
+    if (preparedQueryValid_)
+        tempDrawables = preparedZoneDrawables_;
+    else if (reuseCache)
+    {
+        tempDrawables.clear();
+        for (Drawable* drawable : cachedZoneDrawables_)
+        {
+            if (frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else if (cacheAllowed)
+    {
+        ZoneOccluderOctreeQuery
+            query(cachedZoneDrawables_, expandedFrustum, DRAWABLE_GEOMETRY | DRAWABLE_ZONE, cullCamera_->GetViewMask());
+        octree_->GetDrawables(query);
+
+        tempDrawables.clear();
+        for (Drawable* drawable : cachedZoneDrawables_)
+        {
+            if (frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else
     {
         ZoneOccluderOctreeQuery
             query(tempDrawables, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_ZONE, cullCamera_->GetViewMask());
@@ -902,12 +1178,47 @@ void View::GetDrawables()
             (tempDrawables, cullCamera_->GetFrustum(), occlusionBuffer_, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, cullCamera_->GetViewMask());
         octree_->GetDrawables(query);
     }
+    else if (preparedQueryValid_)
+        tempDrawables = preparedGeometryDrawables_;
+    else if (reuseCache)
+    {
+        tempDrawables.clear();
+        for (Drawable* drawable : cachedGeometryDrawables_)
+        {
+            if (frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else if (cacheAllowed)
+    {
+        FrustumOctreeQuery query(cachedGeometryDrawables_, expandedFrustum, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT,
+            cullCamera_->GetViewMask());
+        octree_->GetDrawables(query);
+
+        tempDrawables.clear();
+        for (Drawable* drawable : cachedGeometryDrawables_)
+        {
+            if (frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+
+        // Remember what the cached supersets were queried with
+        Node* cameraNode = cullCamera_->GetNode();
+        cachedCameraPos_ = cameraNode->GetWorldPosition();
+        cachedCameraRot_ = cameraNode->GetWorldRotation();
+        cachedProjection_ = cullCamera_->GetProjection();
+        cachedViewMask_ = cullCamera_->GetViewMask();
+        cachedOctreeVersion_ = octree_->GetStructureVersion();
+        drawableCacheValid_ = true;
+    }
     else
     {
         FrustumOctreeQuery query(tempDrawables, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, cullCamera_->GetViewMask());
         octree_->GetDrawables(query);
     }
 
+    preparedQueryValid_ = false;
+
     // Check drawable occlusion, find zones for moved drawables and collect geometries & lights in worker threads
     {
         for (unsigned i = 0; i < sceneResults_.size(); ++i)
@@ -992,6 +1303,8 @@ void View::GetBatches()
     if (!octree_ || !cullCamera_)
         return;
 
+    URHO3D_FRAME_BUDGET("BatchPrep");
+
     nonThreadedGeometries_.clear();
     threadedGeometries_.clear();
 
@@ -1005,6 +1318,8 @@ void View::ProcessLights()
     // Process lit geometries and shadow casters for each light
     URHO3D_PROFILE("ProcessLights");
 
+    BuildLightGrid();
+
     auto* queue = GetSubsystem<WorkQueue>();
     lightQueryResults_.resize(lights_.size());
 
@@ -1026,6 +1341,84 @@ void View::ProcessLights()
     queue->Complete(M_MAX_UNSIGNED);
 }
 
+void View::BuildLightGrid()
+{
+    lightGridValid_ = false;
+    if (lights_.size() < MIN_LIGHTS_FOR_GRID || geometries_.empty())
+        return;
+
+    URHO3D_PROFILE("BuildLightGrid");
+
+    lightGridBox_.Clear();
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+        lightGridBox_.Merge(geometries_[i]->GetWorldBoundingBox());
+
+    Vector3 size = lightGridBox_.Size();
+    lightGridInvCellSize_ = Vector3((float)LIGHT_GRID_SIZE / Max(size.x_, M_EPSILON),
+        (float)LIGHT_GRID_SIZE / Max(size.y_, M_EPSILON), (float)LIGHT_GRID_SIZE / Max(size.z_, M_EPSILON));
+
+    lightGridCells_.resize((unsigned)(LIGHT_GRID_SIZE * LIGHT_GRID_SIZE * LIGHT_GRID_SIZE));
+    for (unsigned i = 0; i < lightGridCells_.size(); ++i)
+        lightGridCells_[i].clear();
+
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        IntVector3 beginCell, endCell;
+        GetLightGridCellRange(lightGridBox_, lightGridInvCellSize_, geometries_[i]->GetWorldBoundingBox(), beginCell, endCell);
+
+        for (int z = beginCell.z_; z <= endCell.z_; ++z)
+        {
+            for (int y = beginCell.y_; y <= endCell.y_; ++y)
+            {
+                for (int x = beginCell.x_; x <= endCell.x_; ++x)
+                    lightGridCells_[(unsigned)((z * LIGHT_GRID_SIZE + y) * LIGHT_GRID_SIZE + x)].push_back(i);
+            }
+        }
+    }
+
+    // Size the per-thread duplicate removal stamps. The stamps only ever increase, so old values can not
+    // collide with new queries and do not need to be cleared
+    lightGridMarks_.resize(tempDrawables_.size());
+    lightGridStamps_.resize(tempDrawables_.size());
+    for (unsigned i = 0; i < lightGridMarks_.size(); ++i)
+    {
+        if (lightGridMarks_[i].size() < geometries_.size())
+            lightGridMarks_[i].resize(geometries_.size(), 0);
+    }
+
+    lightGridValid_ = true;
+}
+
+void View::GetLightGridCandidates(const BoundingBox& box, ea::vector<Drawable*>& result, unsigned threadIndex)
+{
+    ea::vector<unsigned>& marks = lightGridMarks_[threadIndex];
+    unsigned stamp = ++lightGridStamps_[threadIndex];
+
+    IntVector3 beginCell, endCell;
+    GetLightGridCellRange(lightGridBox_, lightGridInvCellSize_, box, beginCell, endCell);
+
+    result.clear();
+    for (int z = beginCell.z_; z <= endCell.z_; ++z)
+    {
+        for (int y = beginCell.y_; y <= endCell.y_; ++y)
+        {
+            for (int x = beginCell.x_; x <= endCell.x_; ++x)
+            {
+                const ea::vector<unsigned>& cell = lightGridCells_[(unsigned)((z * LIGHT_GRID_SIZE + y) * LIGHT_GRID_SIZE + x)];
+                for (unsigned j = 0; j < cell.size(); ++j)
+                {
+                    unsigned index = cell[j];
+                    if (marks[index] != stamp)
+                    {
+                        marks[index] = stamp;
+                        result.push_back(geometries_[index]);
+                    }
+                }
+            }
+        }
+    }
+}
+
 void View::GetLightBatches()
 {
     BatchQueue* alphaQueue = batchQueues_.contains(alphaPassIndex_) ? &batchQueues_[alphaPassIndex_] : nullptr;
@@ -1046,6 +1439,8 @@ void View::GetLightBatches()
 
         lightQueues_.resize(numLightQueues);
         maxLightsDrawables_.clear();
+        lightQueueJobs_.clear();
+        lightQueueJobs_.reserve(numLightQueues);
         auto maxSortedInstances = (unsigned)renderer_->GetMaxSortedInstances();
 
         for (auto i = lightQueryResults_.begin(); i != lightQueryResults_.end(); ++i)
@@ -1092,22 +1487,18 @@ void View::GetLightBatches()
                         shadowSplits = 0;
                 }
 
-                // Setup shadow batch queues
+                // Setup shadow batch queues. The shadow split viewports and cameras are finalized and the caster
+                // batches collected by a worker job, but marking casters in view touches state shared between
+                // lights and is done here
                 lightQueue.shadowSplits_.resize(shadowSplits);
                 for (unsigned j = 0; j < shadowSplits; ++j)
                 {
                     ShadowBatchQueue& shadowQueue = lightQueue.shadowSplits_[j];
-                    Camera* shadowCamera = query.shadowCameras_[j];
-                    shadowQueue.shadowCamera_ = shadowCamera;
+                    shadowQueue.shadowCamera_ = query.shadowCameras_[j];
                     shadowQueue.nearSplit_ = query.shadowNearSplits_[j];
                     shadowQueue.farSplit_ = query.shadowFarSplits_[j];
                     shadowQueue.shadowBatches_.Clear(maxSortedInstances);
 
-                    // Setup the shadow split viewport and finalize shadow camera parameters
-                    shadowQueue.shadowViewport_ = GetShadowMapViewport(light, j, lightQueue.shadowMap_);
-                    FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
-
-                    // Loop through shadow casters
                     for (auto k = query.shadowCasters_.begin() + query.shadowCasterBegin_[j];
                          k < query.shadowCasters_.begin() + query.shadowCasterEnd_[j]; ++k)
                     {
@@ -1122,42 +1513,18 @@ void View::GetLightBatches()
                             else if (type == UPDATE_WORKER_THREAD)
                                 threadedGeometries_.push_back(drawable);
                         }
-
-                        const ea::vector<SourceBatch>& batches = drawable->GetBatches();
-
-                        for (unsigned l = 0; l < batches.size(); ++l)
-                        {
-                            const SourceBatch& srcBatch = batches[l];
-
-                            Technique* tech = GetTechnique(drawable, srcBatch.material_);
-                            if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
-                                continue;
-
-                            Pass* pass = tech->GetSupportedPass(Technique::shadowPassIndex);
-                            // Skip if material has no shadow pass
-                            if (!pass)
-                                continue;
-
-                            Batch destBatch(srcBatch);
-                            destBatch.pass_ = pass;
-                            destBatch.zone_ = nullptr;
-
-                            AddBatchToQueue(shadowQueue.shadowBatches_, destBatch, tech);
-                        }
                     }
                 }
 
-                // Process lit geometries
+                // Assign the light to lit geometries. The lit batches are collected by the worker job, except
+                // for drawables that limit maximum lights, which are recorded and checked after all queues exist
                 for (auto j = query.litGeometries_.begin(); j !=
                     query.litGeometries_.end(); ++j)
                 {
                     Drawable* drawable = *j;
                     drawable->AddLight(light);
 
-                    // If drawable limits maximum lights, only record the light, and check maximum count / build batches later
-                    if (!drawable->GetMaxLights())
-                        GetLitBatches(drawable, lightQueue, alphaQueue);
-                    else
+                    if (drawable->GetMaxLights())
                         maxLightsDrawables_.insert(drawable);
                 }
 
@@ -1180,6 +1547,12 @@ void View::GetLightBatches()
                         lightVolumeCommand_->pixelShaderDefines_);
                     lightQueue.volumeBatches_.push_back(volumeBatch);
                 }
+
+                // The remaining per-light work is independent of the other lights and runs as a worker job
+                LightQueueJob& job = lightQueueJobs_.push_back();
+                job.query_ = &query;
+                job.queue_ = &lightQueue;
+                job.batches_.clear();
             }
             // Per-vertex light
             else
@@ -1193,6 +1566,24 @@ void View::GetLightBatches()
                 }
             }
         }
+
+        // Finalize shadow cameras and collect each light's batches in parallel. Queue insertion resolves
+        // shaders and instancing groups, which is not thread-safe, so the collected batches are committed
+        // to the destination queues serially afterwards
+        auto* queue = GetSubsystem<WorkQueue>();
+        for (unsigned i = 0; i < lightQueueJobs_.size(); ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = GetLightBatchesWork;
+            item->aux_ = this;
+            item->start_ = &lightQueueJobs_[i];
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+
+        for (unsigned i = 0; i < lightQueueJobs_.size(); ++i)
+            CommitLightQueueBatches(lightQueueJobs_[i], alphaQueue);
     }
 
     // Process drawables with limited per-pixel light count
@@ -1200,6 +1591,9 @@ void View::GetLightBatches()
     {
         URHO3D_PROFILE("GetMaxLightsBatches");
 
+        LightQueueJob job;
+        job.query_ = nullptr;
+
         for (auto i = maxLightsDrawables_.begin(); i != maxLightsDrawables_.end(); ++i)
         {
             Drawable* drawable = *i;
@@ -1212,7 +1606,12 @@ void View::GetLightBatches()
                 // Find the correct light queue again
                 LightBatchQueue* queue = light->GetLightQueue();
                 if (queue)
-                    GetLitBatches(drawable, *queue, alphaQueue);
+                {
+                    job.queue_ = queue;
+                    job.batches_.clear();
+                    GetLitBatches(drawable, job);
+                    CommitLightQueueBatches(job, alphaQueue);
+                }
             }
         }
     }
@@ -1238,12 +1637,16 @@ void View::GetBaseBatches()
         {
             const SourceBatch& srcBatch = batches[j];
 
+            // Stamp the material's textures as rendered for texture streaming decisions
+            if (srcBatch.material_)
+                srcBatch.material_->MarkTexturesUsed(frame_.frameNumber_);
+
             // Check here if the material refers to a rendertarget texture with camera(s) attached
             // Only check this for backbuffer views (null rendertarget)
             if (srcBatch.material_ && srcBatch.material_->GetAuxViewFrameNumber() != frame_.frameNumber_ && !renderTarget_)
                 CheckMaterialForAuxView(srcBatch.material_);
 
-            Technique* tech = GetTechnique(drawable, srcBatch.material_);
+            Technique* tech = GetTechnique(drawable, srcBatch);
             if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
                 continue;
 
@@ -1263,6 +1666,7 @@ void View::GetBaseBatches()
                 destBatch.pass_ = pass;
                 destBatch.zone_ = GetZone(drawable);
                 UpdateBatchAmbient(destBatch, globalIllumination_, drawable);
+                UpdateBatchEnvironment(destBatch, reflectionProbeManager_, drawable);
                 destBatch.isBase_ = true;
                 destBatch.lightMask_ = (unsigned char)GetLightMask(drawable);
 
@@ -1333,8 +1737,12 @@ void View::UpdateGeometries()
             {
                 SharedPtr<WorkItem> item = queue->GetFreeItem();
                 item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ =
-                    command.sortMode_ == SORT_FRONTTOBACK ? SortBatchQueueFrontToBackWork : SortBatchQueueBackToFrontWork;
+                if (command.sortMode_ == SORT_FRONTTOBACK)
+                    item->workFunction_ = SortBatchQueueFrontToBackWork;
+                else if (command.sortMode_ == SORT_BACKTOFRONT)
+                    item->workFunction_ = SortBatchQueueBackToFrontWork;
+                else
+                    item->workFunction_ = SortBatchQueueByStateWork;
                 item->start_ = &batchQueues_[command.passIndex_];
                 queue->AddWorkItem(item);
             }
@@ -1405,11 +1813,101 @@ void View::UpdateGeometries()
 
     // Finally ensure all threaded work has completed
     queue->Complete(M_MAX_UNSIGNED);
+
+    // Commit threaded geometry updates that prepared data for a main thread upload
+    for (auto i = threadedGeometries_.begin(); i != threadedGeometries_.end(); ++i)
+    {
+        if (*i)
+            (*i)->CommitGeometry();
+    }
+
     geometriesUpdated_ = true;
 }
 
-void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQueue* alphaQueue)
+void View::BuildLightQueueBatches(LightQueueJob& job)
 {
+    LightQueryResult& query = *job.query_;
+    LightBatchQueue& lightQueue = *job.queue_;
+    Light* light = query.light_;
+
+    // Setup the shadow split viewports, finalize shadow camera parameters and collect shadow caster batches.
+    // Each split's shadow camera is owned by this light, so finalization is safe off the main thread
+    for (unsigned j = 0; j < lightQueue.shadowSplits_.size(); ++j)
+    {
+        ShadowBatchQueue& shadowQueue = lightQueue.shadowSplits_[j];
+        shadowQueue.shadowViewport_ = GetShadowMapViewport(light, j, lightQueue.shadowMap_);
+        FinalizeShadowCamera(shadowQueue.shadowCamera_, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
+
+        // Loop through shadow casters
+        for (auto k = query.shadowCasters_.begin() + query.shadowCasterBegin_[j];
+             k < query.shadowCasters_.begin() + query.shadowCasterEnd_[j]; ++k)
+        {
+            Drawable* drawable = *k;
+            const ea::vector<SourceBatch>& batches = drawable->GetBatches();
+
+            for (unsigned l = 0; l < batches.size(); ++l)
+            {
+                const SourceBatch& srcBatch = batches[l];
+
+                Technique* tech = GetTechnique(drawable, srcBatch);
+                if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
+                    continue;
+
+                Pass* pass = tech->GetSupportedPass(Technique::shadowPassIndex);
+                // Skip if material has no shadow pass
+                if (!pass)
+                    continue;
+
+                QueuedLightBatch& queued = job.batches_.push_back();
+                queued.batch_ = Batch(srcBatch);
+                queued.batch_.pass_ = pass;
+                queued.batch_.zone_ = nullptr;
+                queued.technique_ = tech;
+                queued.splitIndex_ = j;
+                queued.isLitAlpha_ = false;
+            }
+        }
+    }
+
+    // Collect lit batches. Drawables that limit their light count are handled after all queues are complete
+    for (auto j = query.litGeometries_.begin(); j != query.litGeometries_.end(); ++j)
+    {
+        Drawable* drawable = *j;
+        if (!drawable->GetMaxLights())
+            GetLitBatches(drawable, job);
+    }
+}
+
+void View::CommitLightQueueBatches(LightQueueJob& job, BatchQueue* alphaQueue)
+{
+    LightBatchQueue& lightQueue = *job.queue_;
+
+    for (unsigned i = 0; i < job.batches_.size(); ++i)
+    {
+        QueuedLightBatch& queued = job.batches_[i];
+        Batch& batch = queued.batch_;
+
+        if (queued.splitIndex_ != M_MAX_UNSIGNED)
+            AddBatchToQueue(lightQueue.shadowSplits_[queued.splitIndex_].shadowBatches_, batch, queued.technique_);
+        else if (!queued.isLitAlpha_)
+        {
+            if (batch.isBase_)
+                AddBatchToQueue(lightQueue.litBaseBatches_, batch, queued.technique_);
+            else
+                AddBatchToQueue(lightQueue.litBatches_, batch, queued.technique_);
+        }
+        else if (alphaQueue)
+        {
+            // Transparent batches can not be instanced, and shadows on transparencies can only be rendered if shadow maps
+            // are not reused
+            AddBatchToQueue(*alphaQueue, batch, queued.technique_, false, !renderer_->GetReuseShadowMaps());
+        }
+    }
+}
+
+void View::GetLitBatches(Drawable* drawable, LightQueueJob& job)
+{
+    LightBatchQueue& lightQueue = *job.queue_;
     Light* light = lightQueue.light_;
     Zone* zone = GetZone(drawable);
     const ea::vector<SourceBatch>& batches = drawable->GetBatches();
@@ -1423,7 +1921,7 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
     {
         const SourceBatch& srcBatch = batches[i];
 
-        Technique* tech = GetTechnique(drawable, srcBatch.material_);
+        Technique* tech = GetTechnique(drawable, srcBatch);
         if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
             continue;
 
@@ -1464,20 +1962,13 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
         destBatch.lightQueue_ = &lightQueue;
         destBatch.zone_ = zone;
         UpdateBatchAmbient(destBatch, globalIllumination_, drawable);
+        UpdateBatchEnvironment(destBatch, reflectionProbeManager_, drawable);
 
-        if (!isLitAlpha)
-        {
-            if (destBatch.isBase_)
-                AddBatchToQueue(lightQueue.litBaseBatches_, destBatch, tech);
-            else
-                AddBatchToQueue(lightQueue.litBatches_, destBatch, tech);
-        }
-        else if (alphaQueue)
-        {
-            // Transparent batches can not be instanced, and shadows on transparencies can only be rendered if shadow maps are
-            // not reused
-            AddBatchToQueue(*alphaQueue, destBatch, tech, false, !renderer_->GetReuseShadowMaps());
-        }
+        QueuedLightBatch& queued = job.batches_.push_back();
+        queued.batch_ = destBatch;
+        queued.technique_ = tech;
+        queued.splitIndex_ = M_MAX_UNSIGNED;
+        queued.isLitAlpha_ = isLitAlpha;
     }
 }
 
@@ -1490,12 +1981,17 @@ void View::ExecuteRenderPathCommands()
     {
         URHO3D_PROFILE("RenderShadowMaps");
 
+        if (graphics_->GetGPUTimingEnabled())
+            graphics_->BeginGPUTiming("shadowmaps");
+
         for (auto i = actualView->lightQueues_.begin(); i !=
             actualView->lightQueues_.end(); ++i)
         {
             if (NeedRenderShadowMap(*i))
                 RenderShadowMap(*i);
         }
+
+        graphics_->EndGPUTiming();
     }
 
     {
@@ -1596,6 +2092,9 @@ void View::ExecuteRenderPathCommands()
                     currentRenderTarget_ = substituteRenderTarget_ ? substituteRenderTarget_ : renderTarget_;
             }
 
+            if (graphics_->GetGPUTimingEnabled())
+                graphics_->BeginGPUTiming(GetCommandTimingName(command));
+
             switch (command.type_)
             {
             case CMD_CLEAR:
@@ -1619,7 +2118,8 @@ void View::ExecuteRenderPathCommands()
                         URHO3D_PROFILE("RenderScenePass");
 
                         SetRenderTargets(command);
-                        bool allowDepthWrite = SetTextures(command);
+                        bool allowDepthWrite = SetTextures(command) && command.depthWrite_;
+                        graphics_->SetColorWrite(command.colorWrite_);
                         graphics_->SetClipPlane(camera_->GetUseClipping(), camera_->GetClipPlane(), camera_->GetView(),
                             camera_->GetGPUProjection());
 
@@ -1628,12 +2128,16 @@ void View::ExecuteRenderPathCommands()
                             // If pass defines shader parameters, reset parameter sources now to ensure they all will be set
                             // (will be set after camera shader parameters)
                             graphics_->ClearParameterSources();
-                            passCommand_ = &command;
                         }
 
+                        // Make the command available to the batches for shader parameters and state overrides
+                        passCommand_ = &command;
+
                         queue.Draw(this, camera_, command.markToStencil_, false, allowDepthWrite);
 
                         passCommand_ = nullptr;
+                        if (!command.colorWrite_)
+                            graphics_->SetColorWrite(true);
                     }
                 }
                 break;
@@ -1756,6 +2260,8 @@ void View::ExecuteRenderPathCommands()
                 break;
             }
 
+            graphics_->EndGPUTiming();
+
             // If current command output to the viewport, mark it modified
             if (viewportWrite)
                 viewportModified = true;
@@ -1941,24 +2447,12 @@ bool View::IsNecessary(const RenderPathCommand& command)
 
 bool View::CheckViewportRead(const RenderPathCommand& command)
 {
-    for (const auto& textureName : command.textureNames_)
-    {
-        if (!textureName.empty() && !textureName.comparei("viewport"))
-            return true;
-    }
-
-    return false;
+    return command.readsViewport_;
 }
 
 bool View::CheckViewportWrite(const RenderPathCommand& command)
 {
-    for (unsigned i = 0; i < command.outputs_.size(); ++i)
-    {
-        if (!command.outputs_[i].first.comparei("viewport"))
-            return true;
-    }
-
-    return false;
+    return command.writesViewport_;
 }
 
 
@@ -2047,6 +2541,11 @@ void View::AllocateScreenBuffers()
             needSubstitute = true;
     }
 
+    // If dynamic resolution changed the scene render size, render to a substitute target of the scaled size and let
+    // the final blit stretch the result into the viewport rect
+    if (!renderTarget_ && viewSize_ != viewRect_.Size())
+        needSubstitute = true;
+
     // Follow final rendertarget format, or use RGB to match the backbuffer format
     unsigned format = renderTarget_ ? renderTarget_->GetParentTexture()->GetFormat() : Graphics::GetRGBFormat();
 
@@ -2315,7 +2814,7 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     Light* light = query.light_;
     LightType type = light->GetLightType();
     unsigned lightMask = light->GetLightMaskEffective();
-    const Frustum& frustum = cullCamera_->GetFrustum();
+    const Frustum& frustum = cullCameraSnapshot_.GetFrustum();
 
     // Check if light should be shadowed
     bool isShadowed = drawShadows_ && light->GetCastShadows() && !light->GetPerVertex() && light->GetShadowIntensity() < 1.0f;
@@ -2343,26 +2842,55 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
 
     case LIGHT_SPOT:
         {
-            FrustumOctreeQuery octreeQuery(tempDrawables, light->GetFrustum(), DRAWABLE_GEOMETRY,
-                cullCamera_->GetViewMask());
-            octree_->GetDrawables(octreeQuery);
-            for (unsigned i = 0; i < tempDrawables.size(); ++i)
+            const Frustum& lightFrustum = light->GetFrustum();
+            if (lightGridValid_)
+            {
+                // Query the per-view light grid instead of the octree; it only contains visible geometries
+                GetLightGridCandidates(BoundingBox(lightFrustum), tempDrawables, threadIndex);
+                for (unsigned i = 0; i < tempDrawables.size(); ++i)
+                {
+                    if ((GetLightMask(tempDrawables[i]) & lightMask) &&
+                        lightFrustum.IsInsideFast(tempDrawables[i]->GetWorldBoundingBox()) != OUTSIDE)
+                        query.litGeometries_.push_back(tempDrawables[i]);
+                }
+            }
+            else
             {
-                if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
-                    query.litGeometries_.push_back(tempDrawables[i]);
+                FrustumOctreeQuery octreeQuery(tempDrawables, lightFrustum, DRAWABLE_GEOMETRY,
+                    cullCamera_->GetViewMask());
+                octree_->GetDrawables(octreeQuery);
+                for (unsigned i = 0; i < tempDrawables.size(); ++i)
+                {
+                    if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
+                        query.litGeometries_.push_back(tempDrawables[i]);
+                }
             }
         }
         break;
 
     case LIGHT_POINT:
         {
-            SphereOctreeQuery octreeQuery(tempDrawables, Sphere(light->GetNode()->GetWorldPosition(), light->GetRange()),
-                DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
-            octree_->GetDrawables(octreeQuery);
-            for (unsigned i = 0; i < tempDrawables.size(); ++i)
+            Sphere lightSphere(light->GetNode()->GetWorldPosition(), light->GetRange());
+            if (lightGridValid_)
             {
-                if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
-                    query.litGeometries_.push_back(tempDrawables[i]);
+                GetLightGridCandidates(BoundingBox(lightSphere), tempDrawables, threadIndex);
+                for (unsigned i = 0; i < tempDrawables.size(); ++i)
+                {
+                    if ((GetLightMask(tempDrawables[i]) & lightMask) &&
+                        lightSphere.IsInsideFast(tempDrawables[i]->GetWorldBoundingBox()) != OUTSIDE)
+                        query.litGeometries_.push_back(tempDrawables[i]);
+                }
+            }
+            else
+            {
+                SphereOctreeQuery octreeQuery(tempDrawables, lightSphere, DRAWABLE_GEOMETRY,
+                    cullCamera_->GetViewMask());
+                octree_->GetDrawables(octreeQuery);
+                for (unsigned i = 0; i < tempDrawables.size(); ++i)
+                {
+                    if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
+                        query.litGeometries_.push_back(tempDrawables[i]);
+                }
             }
         }
         break;
@@ -2380,6 +2908,52 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
 
     // Process each split for shadow casters
     query.shadowCasters_.clear();
+
+    // For directional lights the cascades contain largely identical caster sets, so instead of traversing the octree
+    // once per split, gather a superset of all cascade casters with a single query over the merged split bounds and
+    // classify the casters into cascades below. The split-independent caster checks are also performed only once here.
+    if (type == LIGHT_DIRECTIONAL)
+    {
+        BoundingBox casterQueryBox;
+        for (unsigned i = 0; i < query.numSplits_; ++i)
+        {
+            if (minZ_ > query.shadowFarSplits_[i] || maxZ_ < query.shadowNearSplits_[i])
+                continue;
+            casterQueryBox.Merge(BoundingBox(query.shadowCameras_[i]->GetFrustum()));
+        }
+
+        tempDrawables.clear();
+        if (casterQueryBox.Defined())
+        {
+            ShadowCasterBoxOctreeQuery casterQuery(tempDrawables, casterQueryBox, DRAWABLE_GEOMETRY,
+                cullCamera_->GetViewMask());
+            octree_->GetDrawables(casterQuery);
+
+            unsigned numCasters = 0;
+            for (unsigned i = 0; i < tempDrawables.size(); ++i)
+            {
+                Drawable* drawable = tempDrawables[i];
+                // Check shadow mask
+                if (!(GetShadowMask(drawable) & lightMask))
+                    continue;
+                // Check shadow distance
+                // Note: as lights are processed threaded, it is possible a drawable's UpdateBatches() function is called
+                // several times. However, this should not cause problems as no scene modification happens at this point.
+                if (!drawable->IsInView(frame_, true))
+                    drawable->UpdateBatches(frame_);
+                float maxShadowDistance = drawable->GetShadowDistance();
+                float drawDistance = drawable->GetDrawDistance();
+                if (drawDistance > 0.0f && (maxShadowDistance <= 0.0f || drawDistance < maxShadowDistance))
+                    maxShadowDistance = drawDistance;
+                if (maxShadowDistance > 0.0f && drawable->GetDistance() > maxShadowDistance)
+                    continue;
+
+                tempDrawables[numCasters++] = drawable;
+            }
+            tempDrawables.resize(numCasters);
+        }
+    }
+
     for (unsigned i = 0; i < query.numSplits_; ++i)
     {
         Camera* shadowCamera = query.shadowCameras_[i];
@@ -2397,14 +2971,10 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
                 continue;
             if (maxZ_ < query.shadowNearSplits_[i])
                 continue;
-
-            // Reuse lit geometry query for all except directional lights
-            ShadowCasterOctreeQuery query(tempDrawables, shadowCameraFrustum, DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
-            octree_->GetDrawables(query);
         }
 
         // Check which shadow casters actually contribute to the shadowing
-        ProcessShadowCasters(query, tempDrawables, i);
+        ProcessShadowCasters(query, tempDrawables, i, type == LIGHT_DIRECTIONAL);
     }
 
     // If no shadow casters, the light can be rendered unshadowed. At this point we have not allocated a shadow map yet, so the
@@ -2413,7 +2983,8 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
         query.numSplits_ = 0;
 }
 
-void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex)
+void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex,
+    bool prefiltered)
 {
     Light* light = query.light_;
     unsigned lightMask = light->GetLightMaskEffective();
@@ -2448,29 +3019,34 @@ void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawab
     for (auto i = drawables.begin(); i != drawables.end(); ++i)
     {
         Drawable* drawable = *i;
-        // In case this is a point or spot light query result reused for optimization, we may have non-shadowcasters included.
-        // Check for that first
-        if (!drawable->GetCastShadows())
-            continue;
-        // Check shadow mask
-        if (!(GetShadowMask(drawable) & lightMask))
-            continue;
+        // Skip the split-independent checks when the caster list has been prefiltered by the superset query
+        if (!prefiltered)
+        {
+            // In case this is a point or spot light query result reused for optimization, we may have non-shadowcasters
+            // included. Check for that first
+            if (!drawable->GetCastShadows())
+                continue;
+            // Check shadow mask
+            if (!(GetShadowMask(drawable) & lightMask))
+                continue;
+
+            // Check shadow distance
+            // Note: as lights are processed threaded, it is possible a drawable's UpdateBatches() function is called
+            // several times. However, this should not cause problems as no scene modification happens at this point.
+            if (!drawable->IsInView(frame_, true))
+                drawable->UpdateBatches(frame_);
+            float maxShadowDistance = drawable->GetShadowDistance();
+            float drawDistance = drawable->GetDrawDistance();
+            if (drawDistance > 0.0f && (maxShadowDistance <= 0.0f || drawDistance < maxShadowDistance))
+                maxShadowDistance = drawDistance;
+            if (maxShadowDistance > 0.0f && drawable->GetDistance() > maxShadowDistance)
+                continue;
+        }
+
         // For point light, check that this drawable is inside the split shadow camera frustum
         if (type == LIGHT_POINT && shadowCameraFrustum.IsInsideFast(drawable->GetWorldBoundingBox()) == OUTSIDE)
             continue;
 
-        // Check shadow distance
-        // Note: as lights are processed threaded, it is possible a drawable's UpdateBatches() function is called several
-        // times. However, this should not cause problems as no scene modification happens at this point.
-        if (!drawable->IsInView(frame_, true))
-            drawable->UpdateBatches(frame_);
-        float maxShadowDistance = drawable->GetShadowDistance();
-        float drawDistance = drawable->GetDrawDistance();
-        if (drawDistance > 0.0f && (maxShadowDistance <= 0.0f || drawDistance < maxShadowDistance))
-            maxShadowDistance = drawDistance;
-        if (maxShadowDistance > 0.0f && drawable->GetDistance() > maxShadowDistance)
-            continue;
-
         // Project shadow caster bounding box to light view space for visibility check
         lightViewBox = drawable->GetWorldBoundingBox().Transformed(lightView);
 
@@ -2822,12 +3398,27 @@ void View::FindZone(Drawable* drawable)
 
     // If bounding box center is in view, the zone assignment is conclusive also for next frames. Otherwise it is temporary
     // (possibly incorrect) and must be re-evaluated on the next frame
-    bool temporary = !cullCamera_->GetFrustum().IsInside(center);
+    bool temporary = !cullCameraSnapshot_.GetFrustum().IsInside(center);
+
+    Octant* octant = drawable->GetOctant();
+    const unsigned zoneCacheVersion = octree_->GetZoneCacheVersion();
+
+    // If the drawable's octant is known to lie wholly inside one zone, that zone applies to any drawable in the octant
+    // with an unrestricted zone mask
+    if (octant && drawable->GetZoneMask() == DEFAULT_ZONEMASK)
+    {
+        Zone* cachedZone = octant->GetCachedZone(zoneCacheVersion);
+        if (cachedZone && (cachedZone->GetViewMask() & cullCameraSnapshot_.GetViewMask()))
+        {
+            drawable->SetZone(cachedZone, temporary);
+            return;
+        }
+    }
 
     // First check if the current zone remains a conclusive result
     Zone* lastZone = drawable->GetZone();
 
-    if (lastZone && (lastZone->GetViewMask() & cullCamera_->GetViewMask()) && lastZone->GetPriority() >= highestZonePriority_ &&
+    if (lastZone && (lastZone->GetViewMask() & cullCameraSnapshot_.GetViewMask()) && lastZone->GetPriority() >= highestZonePriority_ &&
         (drawable->GetZoneMask() & lastZone->GetZoneMask()) && lastZone->IsInside(center))
         newZone = lastZone;
     else
@@ -2844,11 +3435,41 @@ void View::FindZone(Drawable* drawable)
         }
     }
 
+    // Cache the zone in the octant when the result provably holds for the whole octant: the camera must not filter out
+    // any zones, the octant must be fully in view so that all zones overlapping it were collected, all of the octant's
+    // corners must be inside the zone, and no zone of equal or higher priority may touch the octant
+    if (octant && newZone && drawable->GetZoneMask() == DEFAULT_ZONEMASK && cullCameraSnapshot_.GetViewMask() == DEFAULT_VIEWMASK &&
+        cullCameraSnapshot_.GetFrustum().IsInside(octant->GetCullingBox()) == INSIDE)
+    {
+        const BoundingBox& octantBox = octant->GetCullingBox();
+        bool conclusive = true;
+
+        for (unsigned i = 0; i < 8 && conclusive; ++i)
+        {
+            Vector3 corner(i & 1u ? octantBox.max_.x_ : octantBox.min_.x_, i & 2u ? octantBox.max_.y_ : octantBox.min_.y_,
+                i & 4u ? octantBox.max_.z_ : octantBox.min_.z_);
+            if (!newZone->IsInside(corner))
+                conclusive = false;
+        }
+
+        for (auto i = zones_.begin(); i != zones_.end() && conclusive; ++i)
+        {
+            Zone* zone = *i;
+            if (zone != newZone && zone->GetPriority() >= newZone->GetPriority() &&
+                octantBox.IsInside(zone->GetWorldBoundingBox()) != OUTSIDE)
+                conclusive = false;
+        }
+
+        if (conclusive)
+            octant->SetCachedZone(newZone, zoneCacheVersion);
+    }
+
     drawable->SetZone(newZone, temporary);
 }
 
-Technique* View::GetTechnique(Drawable* drawable, Material* material)
+Technique* View::GetTechnique(Drawable* drawable, const SourceBatch& sourceBatch)
 {
+    Material* material = sourceBatch.material_;
     if (!material)
         return renderer_->GetDefaultMaterial()->GetTechniques()[0].technique_;
 
@@ -2860,11 +3481,22 @@ Technique* View::GetTechnique(Drawable* drawable, Material* material)
     {
         float lodDistance = drawable->GetLodDistance();
 
+        // Reuse the previously resolved technique while the LOD distance stays within its band and
+        // neither the material, its technique list nor the quality level have changed
+        if (sourceBatch.resolvedTechnique_ && sourceBatch.resolvedTechniqueMaterial_ == material &&
+            sourceBatch.resolvedTechniqueVersion_ == material->GetTechniquesVersion() &&
+            sourceBatch.resolvedTechniqueQuality_ == materialQuality_ &&
+            lodDistance >= sourceBatch.resolvedTechniqueLodBegin_ && lodDistance < sourceBatch.resolvedTechniqueLodEnd_)
+            return sourceBatch.resolvedTechnique_;
+
         // Check for suitable technique. Techniques should be ordered like this:
         // Most distant & highest quality
         // Most distant & lowest quality
         // Second most distant & highest quality
         // ...
+        Technique* chosen = nullptr;
+        float lodBegin = -M_INFINITY;
+        float lodEnd = M_INFINITY;
         for (unsigned i = 0; i < techniques.size(); ++i)
         {
             const TechniqueEntry& entry = techniques[i];
@@ -2873,11 +3505,29 @@ Technique* View::GetTechnique(Drawable* drawable, Material* material)
             if (!tech || (!tech->IsSupported()) || materialQuality_ < entry.qualityLevel_)
                 continue;
             if (lodDistance >= entry.lodDistance_)
-                return tech;
+            {
+                chosen = tech;
+                lodBegin = entry.lodDistance_;
+                break;
+            }
+            // Suitable entries with a higher LOD distance threshold bound the valid band of the chosen
+            // technique from above
+            lodEnd = Min(lodEnd, entry.lodDistance_);
         }
 
         // If no suitable technique found, fallback to the last
-        return techniques.size() ? techniques.back().technique_ : nullptr;
+        if (!chosen)
+            chosen = techniques.size() ? techniques.back().technique_ : nullptr;
+
+        // Concurrent light batch collection jobs may resolve the same source batch, but as the drawable's
+        // LOD distance and the quality level are fixed for the frame, they write identical values
+        sourceBatch.resolvedTechnique_ = chosen;
+        sourceBatch.resolvedTechniqueMaterial_ = material;
+        sourceBatch.resolvedTechniqueVersion_ = material->GetTechniquesVersion();
+        sourceBatch.resolvedTechniqueQuality_ = materialQuality_;
+        sourceBatch.resolvedTechniqueLodBegin_ = lodBegin;
+        sourceBatch.resolvedTechniqueLodEnd_ = lodEnd;
+        return chosen;
     }
 }
 
@@ -2937,6 +3587,10 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
     if (!batch.material_)
         batch.material_ = renderer_->GetDefaultMaterial();
 
+    // Batches that arrive already instanced can only be drawn with the instancing shaders, as they may carry
+    // per-instance data such as crowd animation parameters that only exist in the instancing buffer
+    bool demandsInstancing = batch.geometryType_ == GEOM_INSTANCED;
+
     // Convert to instanced if possible
     if (allowInstancing && batch.geometryType_ == GEOM_STATIC && batch.geometry_->GetIndexBuffer())
         batch.geometryType_ = GEOM_INSTANCED;
@@ -2951,7 +3605,7 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
             // Create a new group based on the batch
             // In case the group remains below the instancing limit, do not enable instancing shaders yet
             BatchGroup newGroup(batch);
-            newGroup.geometryType_ = GEOM_STATIC;
+            newGroup.geometryType_ = demandsInstancing ? GEOM_INSTANCED : GEOM_STATIC;
             renderer_->SetBatchShaders(newGroup, tech, allowShadows, queue);
             newGroup.CalculateSortKey();
             i = queue.batchGroups_.insert(ea::make_pair(key, newGroup)).first;
@@ -2960,7 +3614,7 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
         int oldSize = i->second.instances_.size();
         i->second.AddTransforms(batch);
         // Convert to using instancing shaders when the instancing limit is reached
-        if (oldSize < minInstances_ && (int) i->second.instances_.size() >= minInstances_)
+        if (i->second.geometryType_ != GEOM_INSTANCED && oldSize < minInstances_ && (int) i->second.instances_.size() >= minInstances_)
         {
             i->second.geometryType_ = GEOM_INSTANCED;
             renderer_->SetBatchShaders(i->second, tech, allowShadows, queue);
@@ -3038,6 +3692,71 @@ void View::PrepareInstancingBuffer()
     instancingBuffer->Unlock();
 }
 
+void View::PrepareSkinningBuffer()
+{
+    // Fill the skin matrix texture from the source view
+    if (sourceView_)
+    {
+        sourceView_->PrepareSkinningBuffer();
+        return;
+    }
+
+    URHO3D_PROFILE("PrepareSkinningBuffer");
+
+    // Collect skinned batches from all queues. The same skeleton is typically queued several times (base pass, lit
+    // passes, shadow casters), so the bone transform arrays are deduplicated below
+    ea::vector<Batch*> skinnedBatches;
+    auto collectBatches = [&skinnedBatches](BatchQueue& queue)
+    {
+        for (Batch& batch : queue.batches_)
+        {
+            if (batch.geometryType_ == GEOM_SKINNED && batch.worldTransform_ && batch.numWorldTransforms_)
+                skinnedBatches.push_back(&batch);
+        }
+    };
+
+    for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
+        collectBatches(i->second);
+
+    for (auto i = lightQueues_.begin(); i != lightQueues_.end(); ++i)
+    {
+        for (unsigned j = 0; j < i->shadowSplits_.size(); ++j)
+            collectBatches(i->shadowSplits_[j].shadowBatches_);
+        collectBatches(i->litBaseBatches_);
+        collectBatches(i->litBatches_);
+    }
+
+    if (skinnedBatches.empty())
+        return;
+
+    // Assign a palette offset per unique bone transform array
+    ea::unordered_map<const Matrix3x4*, ea::pair<unsigned, unsigned> > paletteRanges;
+    unsigned totalMatrices = 0;
+    for (Batch* batch : skinnedBatches)
+    {
+        if (paletteRanges.find(batch->worldTransform_) == paletteRanges.end())
+        {
+            paletteRanges[batch->worldTransform_] = ea::make_pair(totalMatrices, batch->numWorldTransforms_);
+            totalMatrices += batch->numWorldTransforms_;
+        }
+    }
+
+    if (!renderer_->ResizeSkinMatrixTexture(totalMatrices))
+        return;
+
+    Texture2D* texture = renderer_->GetSkinMatrixTexture();
+    skinMatrixData_.resize((unsigned)texture->GetWidth() * (unsigned)texture->GetHeight());
+
+    // Each matrix occupies 3 consecutive texels
+    for (const auto& range : paletteRanges)
+        memcpy(&skinMatrixData_[range.second.first * 3], range.first, range.second.second * sizeof(Matrix3x4));
+
+    for (Batch* batch : skinnedBatches)
+        batch->skinMatrixOffset_ = paletteRanges[batch->worldTransform_].first;
+
+    texture->SetData(0, 0, 0, texture->GetWidth(), texture->GetHeight(), &skinMatrixData_[0]);
+}
+
 void View::SetupLightVolumeBatch(Batch& batch)
 {
     Light* light = batch.lightQueue_->light_;
@@ -3087,6 +3806,61 @@ void View::SetupLightVolumeBatch(Batch& batch)
         graphics_->SetStencilTest(false);
 }
 
+/// Update a running hash with a block of bytes.
+static unsigned HashBytes(unsigned hash, const void* data, unsigned size)
+{
+    const auto* bytes = (const unsigned char*)data;
+    while (size--)
+        hash = SDBMHash(hash, *bytes++);
+    return hash;
+}
+
+/// Hash one batch's contents for shadow map caching. Skinned transforms include the bone matrices, so pose changes are detected.
+static unsigned HashShadowBatch(unsigned hash, const Batch& batch, unsigned frameNumber)
+{
+    // Geometry types with procedurally updated contents can not be validated through transforms alone; make their
+    // hash unique every frame so that the split is always considered changed
+    if (batch.geometryType_ != GEOM_STATIC && batch.geometryType_ != GEOM_STATIC_NOINSTANCING &&
+        batch.geometryType_ != GEOM_INSTANCED && batch.geometryType_ != GEOM_SKINNED)
+        hash = HashBytes(hash, &frameNumber, sizeof frameNumber);
+
+    hash = HashBytes(hash, &batch.geometry_, sizeof batch.geometry_);
+    if (batch.worldTransform_)
+        hash = HashBytes(hash, batch.worldTransform_, batch.numWorldTransforms_ * (unsigned)sizeof(Matrix3x4));
+    return hash;
+}
+
+/// Compute a content hash for a shadow split, used to check whether cached shadow map contents are still valid.
+static unsigned GetShadowSplitHash(const ShadowBatchQueue& shadowQueue, unsigned frameNumber)
+{
+    // Include the shadow camera transform and projection; shadow focusing and quantization make them depend on the lit scene
+    Matrix3x4 view = shadowQueue.shadowCamera_->GetView();
+    Matrix4 projection = shadowQueue.shadowCamera_->GetProjection();
+
+    unsigned hash = 0;
+    hash = HashBytes(hash, &view, sizeof view);
+    hash = HashBytes(hash, &projection, sizeof projection);
+    hash = HashBytes(hash, &shadowQueue.shadowViewport_, sizeof shadowQueue.shadowViewport_);
+
+    const BatchQueue& batches = shadowQueue.shadowBatches_;
+    for (unsigned i = 0; i < batches.batches_.size(); ++i)
+        hash = HashShadowBatch(hash, batches.batches_[i], frameNumber);
+
+    for (auto i = batches.batchGroups_.begin(); i != batches.batchGroups_.end(); ++i)
+    {
+        const BatchGroup& group = i->second;
+        hash = HashShadowBatch(hash, group, frameNumber);
+        for (unsigned j = 0; j < group.instances_.size(); ++j)
+        {
+            if (group.instances_[j].worldTransform_)
+                hash = HashBytes(hash, group.instances_[j].worldTransform_, sizeof(Matrix3x4));
+        }
+    }
+
+    // Zero is reserved for splits that can not be cached
+    return hash ? hash : 1;
+}
+
 bool View::NeedRenderShadowMap(const LightBatchQueue& queue)
 {
     // Must have a shadow map, and either forward or deferred lit batches
@@ -3099,6 +3873,25 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
     URHO3D_PROFILE("RenderShadowMap");
 
     Texture2D* shadowMap = queue.shadowMap_;
+
+    // When lights have their own persistent shadow maps, check if the contents rendered last frame are still
+    // valid, and skip re-rendering the unchanged splits. Directional light splits follow the view camera and
+    // VSM shadow maps get a whole-texture blur pass, so neither can reuse cached contents
+    unsigned validSplitMask = 0;
+    unsigned numSplits = queue.shadowSplits_.size();
+    if (!renderer_->GetReuseShadowMaps() && queue.light_->GetLightType() != LIGHT_DIRECTIONAL &&
+        shadowMap->GetUsage() == TEXTURE_DEPTHSTENCIL && numSplits && numSplits <= (unsigned)MAX_LIGHT_SPLITS)
+    {
+        unsigned splitHashes[MAX_LIGHT_SPLITS];
+        for (unsigned i = 0; i < numSplits; ++i)
+            splitHashes[i] = GetShadowSplitHash(queue.shadowSplits_[i], frame_.frameNumber_);
+        validSplitMask = renderer_->CheckShadowMapCache(queue.light_, shadowMap, splitHashes, numSplits);
+
+        // If every split is unchanged, the shadow map can be used as is
+        if (validSplitMask == (1u << numSplits) - 1)
+            return;
+    }
+
     graphics_->SetTexture(TU_SHADOWMAP, nullptr);
 
     graphics_->SetFillMode(FILL_SOLID);
@@ -3118,7 +3911,9 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
         for (unsigned i = 1; i < MAX_RENDERTARGETS; ++i)
             graphics_->SetRenderTarget(i, (RenderSurface*) nullptr);
         graphics_->SetViewport(IntRect(0, 0, shadowMap->GetWidth(), shadowMap->GetHeight()));
-        graphics_->Clear(CLEAR_DEPTH);
+        // When some splits are cached, clear only the dirty split viewports in the render loop below
+        if (!validSplitMask)
+            graphics_->Clear(CLEAR_DEPTH);
     }
     else // if the shadow map is a color rendertarget
     {
@@ -3140,6 +3935,10 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
     {
         const ShadowBatchQueue& shadowQueue = queue.shadowSplits_[i];
 
+        // Skip splits whose cached contents are still valid
+        if (validSplitMask & (1u << i))
+            continue;
+
         float multiplier = 1.0f;
         // For directional light cascade splits, adjust depth bias according to the far clip ratio of the splits
         if (i > 0 && queue.light_->GetLightType() == LIGHT_DIRECTIONAL)
@@ -3160,11 +3959,11 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
 
         graphics_->SetDepthBias(multiplier * parameters.constantBias_ + addition, multiplier * parameters.slopeScaledBias_);
 
+        graphics_->SetViewport(shadowQueue.shadowViewport_);
+        if (validSplitMask)
+            graphics_->Clear(CLEAR_DEPTH);
         if (!shadowQueue.shadowBatches_.IsEmpty())
-        {
-            graphics_->SetViewport(shadowQueue.shadowViewport_);
             shadowQueue.shadowBatches_.Draw(this, shadowQueue.shadowCamera_, false, false, true);
-        }
     }
 
     // Scale filter blur amount to shadow map viewport size so that different shadow map resolutions don't behave differently
@@ -26,6 +26,7 @@
 
 #include "../Core/Object.h"
 #include "../Graphics/Batch.h"
+#include "../Graphics/Camera.h"
 #include "../Graphics/Light.h"
 #include "../Graphics/Zone.h"
 #include "../Math/Polyhedron.h"
@@ -33,9 +34,9 @@
 namespace Urho3D
 {
 
-class Camera;
 class DebugRenderer;
 class GlobalIllumination;
+class ReflectionProbeManager;
 class Light;
 class Drawable;
 class Graphics;
@@ -77,6 +78,30 @@ struct LightQueryResult
     unsigned numSplits_;
 };
 
+/// Batch collected by a light queue build job, waiting for serial queue insertion.
+struct QueuedLightBatch
+{
+    /// Batch with resolved pass, zone and shader parameters.
+    Batch batch_;
+    /// Material technique used to choose shaders at queue insertion.
+    Technique* technique_;
+    /// Shadow split index, or M_MAX_UNSIGNED for a lit batch.
+    unsigned splitIndex_;
+    /// Whether the batch goes to the transparent alpha queue instead of the light's own queues.
+    bool isLitAlpha_;
+};
+
+/// Per-light batch collection job, executed by worker threads after light processing.
+struct LightQueueJob
+{
+    /// Light query result.
+    LightQueryResult* query_;
+    /// Destination light batch queue.
+    LightBatchQueue* queue_;
+    /// Collected batches. Inserted into the destination queues serially after the jobs complete.
+    ea::vector<QueuedLightBatch> batches_;
+};
+
 /// Scene render pass info.
 struct ScenePassInfo
 {
@@ -112,6 +137,7 @@ class URHO3D_API View : public Object
 {
     friend void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex);
     friend void ProcessLightWork(const WorkItem* item, unsigned threadIndex);
+    friend void GetLightBatchesWork(const WorkItem* item, unsigned threadIndex);
 
     URHO3D_OBJECT(View, Object);
 
@@ -126,6 +152,9 @@ public:
 
     /// Define with rendertarget and viewport. Return true if successful.
     bool Define(RenderSurface* renderTarget, Viewport* viewport);
+    /// Run the read-only octree queries for this view ahead of Update(). Safe to call from a worker thread.
+    /// Falls back to querying inside Update() when occlusion or automatic aspect ratio is in use.
+    void PrepareDrawablesQuery();
     /// Update and cull objects and construct rendering batches.
     void Update(const FrameInfo& frame);
     /// Render batches.
@@ -149,6 +178,9 @@ public:
     /// Return information of the frame being rendered.
     const FrameInfo& GetFrameInfo() const { return frame_; }
 
+    /// Return the depth test override of the currently executed scene pass command, or MAX_COMPAREMODES for none.
+    CompareMode GetCommandDepthTest() const;
+
     /// Return the rendertarget. 0 if using the backbuffer.
     RenderSurface* GetRenderTarget() const { return renderTarget_; }
 
@@ -207,18 +239,28 @@ public:
 private:
     /// Query the octree for drawable objects.
     void GetDrawables();
+    /// Return whether cached query results can be revalidated instead of repeating the octree query.
+    bool IsDrawableCacheReusable() const;
     /// Construct batches from the drawable objects.
     void GetBatches();
     /// Get lit geometries and shadowcasters for visible lights.
     void ProcessLights();
+    /// Build a uniform grid over the visible geometries to accelerate lit geometry queries when there are many lights.
+    void BuildLightGrid();
+    /// Collect visible geometries from light grid cells overlapping the given world-space bounds, without duplicates.
+    void GetLightGridCandidates(const BoundingBox& box, ea::vector<Drawable*>& result, unsigned threadIndex);
     /// Get batches from lit geometries and shadowcasters.
     void GetLightBatches();
+    /// Finalize the shadow cameras of a light and collect its shadow and lit batches. Safe to call from worker threads.
+    void BuildLightQueueBatches(LightQueueJob& job);
+    /// Insert the collected batches of a light queue build job into the destination queues. Resolves shaders and instancing groups, so must be called from the main thread.
+    void CommitLightQueueBatches(LightQueueJob& job, BatchQueue* alphaQueue);
     /// Get unlit batches.
     void GetBaseBatches();
     /// Update geometries and sort batches.
     void UpdateGeometries();
-    /// Get pixel lit batches for a certain light and drawable.
-    void GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQueue* alphaQueue);
+    /// Collect pixel lit batches of a drawable for a light queue build job. Safe to call from worker threads.
+    void GetLitBatches(Drawable* drawable, LightQueueJob& job);
     /// Execute render commands.
     void ExecuteRenderPathCommands();
     /// Set rendertargets for current render command.
@@ -229,9 +271,9 @@ private:
     void RenderQuad(RenderPathCommand& command);
     /// Check if a command is enabled and has content to render. To be called only after render update has completed for the frame.
     bool IsNecessary(const RenderPathCommand& command);
-    /// Check if a command reads the destination render target.
+    /// Check if a command reads the destination render target. Uses the flag cached in the command.
     bool CheckViewportRead(const RenderPathCommand& command);
-    /// Check if a command writes into the destination render target.
+    /// Check if a command writes into the destination render target. Uses the flag cached in the command.
     bool CheckViewportWrite(const RenderPathCommand& command);
     /// Check whether a command should use pingponging instead of resolve from destination render target to viewport texture.
     bool CheckPingpong(unsigned index);
@@ -245,8 +287,10 @@ private:
     void DrawOccluders(OcclusionBuffer* buffer, const ea::vector<Drawable*>& occluders);
     /// Query for lit geometries and shadow casters for a light.
     void ProcessLight(LightQueryResult& query, unsigned threadIndex);
-    /// Process shadow casters' visibilities and build their combined view- or projection-space bounding box.
-    void ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex);
+    /// Process shadow casters' visibilities and build their combined view- or projection-space bounding box. If the
+    /// drawables have been prefiltered by a superset caster query, the split-independent checks are skipped.
+    void ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex,
+        bool prefiltered = false);
     /// Set up initial shadow camera view(s).
     void SetupShadowCameras(LightQueryResult& query);
     /// Set up a directional light shadow camera.
@@ -264,8 +308,8 @@ private:
     IntRect GetShadowMapViewport(Light* light, int splitIndex, Texture2D* shadowMap);
     /// Find and set a new zone for a drawable when it has moved.
     void FindZone(Drawable* drawable);
-    /// Return material technique, considering the drawable's LOD distance.
-    Technique* GetTechnique(Drawable* drawable, Material* material);
+    /// Return material technique, considering the drawable's LOD distance. The resolution is cached on the source batch.
+    Technique* GetTechnique(Drawable* drawable, const SourceBatch& sourceBatch);
     /// Check if material should render an auxiliary view (if it has a camera attached).
     void CheckMaterialForAuxView(Material* material);
     /// Set shader defines for a batch queue if used.
@@ -274,6 +318,8 @@ private:
     void AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, bool allowInstancing = true, bool allowShadows = true);
     /// Prepare instancing buffer by filling it with all instance transforms.
     void PrepareInstancingBuffer();
+    /// Prepare the skin matrix texture for bone palette skinning by filling it with the bone transforms of all visible skeletons.
+    void PrepareSkinningBuffer();
     /// Set up a light volume rendering batch.
     void SetupLightVolumeBatch(Batch& batch);
     /// Check whether a light queue needs shadow rendering.
@@ -327,10 +373,14 @@ private:
     Octree* octree_{};
     /// Global illumination manager.
     GlobalIllumination* globalIllumination_{};
+    /// Reflection probe manager for the scene.
+    ReflectionProbeManager* reflectionProbeManager_{};
     /// Viewport (rendering) camera.
     Camera* camera_{};
     /// Culling camera. Usually same as the viewport camera.
     Camera* cullCamera_{};
+    /// Immutable per-frame snapshot of the culling camera's derived data, read by worker threads during view update.
+    CameraSnapshot cullCameraSnapshot_;
     /// Shared source view. Null if this view is using its own culling.
     WeakPtr<View> sourceView_;
     /// Zone the camera is inside, or default zone if not assigned.
@@ -397,6 +447,40 @@ private:
     RenderPath* renderPath_{};
     /// Per-thread octree query results.
     ea::vector<ea::vector<Drawable*> > tempDrawables_;
+    /// Uniform grid of visible geometry indices used to accelerate lit geometry queries when there are many lights.
+    ea::vector<ea::vector<unsigned> > lightGridCells_;
+    /// World-space bounds of the light grid.
+    BoundingBox lightGridBox_;
+    /// Inverse cell size of the light grid.
+    Vector3 lightGridInvCellSize_;
+    /// Light grid built flag, valid for the current frame only.
+    bool lightGridValid_{};
+    /// Per-thread stamps of the last light query that visited each geometry, for removing duplicates from grid cells.
+    ea::vector<ea::vector<unsigned> > lightGridMarks_;
+    /// Per-thread running light query stamps.
+    ea::vector<unsigned> lightGridStamps_;
+    /// Zone and occluder query results prepared ahead of Update().
+    ea::vector<Drawable*> preparedZoneDrawables_;
+    /// Geometry and light query results prepared ahead of Update().
+    ea::vector<Drawable*> preparedGeometryDrawables_;
+    /// Whether prepared query results are valid for the current frame.
+    bool preparedQueryValid_{};
+    /// Zone and occluder results of the last margin-expanded octree query, reused while the camera stays nearly static.
+    ea::vector<Drawable*> cachedZoneDrawables_;
+    /// Geometry and light results of the last margin-expanded octree query.
+    ea::vector<Drawable*> cachedGeometryDrawables_;
+    /// Camera world position when the cached query results were collected.
+    Vector3 cachedCameraPos_;
+    /// Camera world rotation when the cached query results were collected.
+    Quaternion cachedCameraRot_;
+    /// Camera projection when the cached query results were collected.
+    Matrix4 cachedProjection_;
+    /// Camera view mask when the cached query results were collected.
+    unsigned cachedViewMask_{};
+    /// Octree structure version when the cached query results were collected.
+    unsigned cachedOctreeVersion_{};
+    /// Whether cached query results are valid.
+    bool drawableCacheValid_{};
     /// Per-thread geometries, lights and Z range collection results.
     ea::vector<PerThreadSceneResult> sceneResults_;
     /// Visible zones.
@@ -420,6 +504,8 @@ private:
     ea::unordered_map<StringHash, Texture*> renderTargets_;
     /// Intermediate light processing results.
     ea::vector<LightQueryResult> lightQueryResults_;
+    /// Per-light batch collection jobs. Reused between frames to avoid reallocation.
+    ea::vector<LightQueueJob> lightQueueJobs_;
     /// Info for scene render passes defined by the renderpath.
     ea::vector<ScenePassInfo> scenePasses_;
     /// Per-pixel light queues.
@@ -428,6 +514,8 @@ private:
     ea::unordered_map<unsigned long long, LightBatchQueue> vertexLightQueues_;
     /// Batch queues by pass index.
     ea::unordered_map<unsigned, BatchQueue> batchQueues_;
+    /// CPU-side scratch buffer for filling the skin matrix texture.
+    ea::vector<Vector4> skinMatrixData_;
     /// Index of the GBuffer pass.
     unsigned gBufferPassIndex_{};
     /// Index of the opaque forward base pass.
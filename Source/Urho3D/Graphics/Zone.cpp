@@ -324,6 +324,10 @@ void Zone::OnRemoveFromOctree()
 
 void Zone::ClearDrawablesZone()
 {
+    // Invalidate octant zone caches, as a cached zone assignment may no longer hold
+    if (octant_)
+        octant_->GetRoot()->MarkZoneCacheDirty();
+
     if (octant_ && lastWorldBoundingBox_.Defined())
     {
         ea::vector<Drawable*> result;
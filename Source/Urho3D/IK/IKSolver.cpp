@@ -28,10 +28,14 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
+#include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
+#include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
 #include <ik/effector.h>
@@ -44,6 +48,8 @@ namespace Urho3D
 
 extern const char* IK_CATEGORY;
 
+int IKSolver::globalIterationBudget_ = 0;
+
 // ----------------------------------------------------------------------------
 IKSolver::IKSolver(Context* context) :
     Component(context),
@@ -396,10 +402,20 @@ void IKSolver::CalculateJointRotations()
 }
 
 // ----------------------------------------------------------------------------
-void IKSolver::Solve()
+void IKSolver::SetGlobalIterationBudget(int iterations)
 {
-    URHO3D_PROFILE("IKSolve");
+    globalIterationBudget_ = Max(iterations, 0);
+}
 
+// ----------------------------------------------------------------------------
+int IKSolver::GetGlobalIterationBudget()
+{
+    return globalIterationBudget_;
+}
+
+// ----------------------------------------------------------------------------
+bool IKSolver::PrepareSolve()
+{
     if (treeNeedsRebuild)
         RebuildTree();
 
@@ -407,7 +423,7 @@ void IKSolver::Solve()
         RebuildChainTrees();
 
     if (IsSolverTreeValid() == false)
-        return;
+        return false;
 
     if (features_ & UPDATE_ORIGINAL_POSE)
         ApplySceneToOriginalPose();
@@ -423,11 +439,61 @@ void IKSolver::Solve()
         (*it)->UpdateTargetNodePosition();
     }
 
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::ExecuteSolve()
+{
     ik_solver_solve(solver_);
 
     if (features_ & JOINT_ROTATIONS)
         ik_solver_calculate_joint_rotations(solver_);
 
+    // Measure whether all effectors ended up within tolerance of their targets. Because the solution is also the seed
+    // of the next solve, a converged solver is warm-started and can be given a smaller share of the iteration budget
+    ik_real toleranceSquared = solver_->tolerance * solver_->tolerance;
+    lastSolveConverged_ = true;
+    ORDERED_VECTOR_FOR_EACH(&solver_->effector_nodes_list, ik_node_t*, pnode)
+        vec3_t diff = (*pnode)->position;
+        vec3_sub_vec3(diff.f, (*pnode)->effector->target_position.f);
+        if (vec3_length_squared(diff.f) > toleranceSquared)
+        {
+            lastSolveConverged_ = false;
+            break;
+        }
+    ORDERED_VECTOR_END_EACH
+}
+
+// ----------------------------------------------------------------------------
+float IKSolver::GetSolveImportance() const
+{
+    // Prefer solvers that were drawn close to the camera; fall back to full importance without an AnimatedModel
+    float importance = 1.0f;
+    if (auto* model = GetComponent<AnimatedModel>())
+    {
+        importance = 1.0f / (1.0f + model->GetDistance());
+        if (!model->IsInView())
+            importance *= 0.25f;
+    }
+
+    // Converged solvers are warm-started by the previous solution and need fewer iterations to stay converged
+    if (lastSolveConverged_)
+        importance *= 0.5f;
+
+    return importance;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::Solve()
+{
+    URHO3D_PROFILE("IKSolve");
+
+    if (!PrepareSolve())
+        return;
+
+    ExecuteSolve();
+
     ApplyActivePoseToScene();
 }
 
@@ -722,7 +788,83 @@ void IKSolver::HandleNodeRemoved(StringHash eventType, VariantMap& eventData)
 // ----------------------------------------------------------------------------
 void IKSolver::HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData)
 {
-    Solve();
+    Scene* scene = GetScene();
+    if (!scene)
+        return;
+
+    // The first auto-solved solver to receive the event coordinates all auto-solved solvers in the scene for this
+    // frame, so that the iteration budget can be distributed between them and independent trees solved in parallel
+    const unsigned frameNumber = GetSubsystem<Time>()->GetFrameNumber();
+    if (lastAutoSolveFrame_ == frameNumber)
+        return;
+
+    URHO3D_PROFILE("SolveSceneIK");
+
+    ea::vector<Component*> components;
+    scene->GetComponents(components, IKSolver::GetTypeStatic(), true);
+
+    ea::vector<IKSolver*> solvers;
+    for (Component* component : components)
+    {
+        auto* solver = static_cast<IKSolver*>(component);
+        if (solver->IsEnabledEffective() && (solver->features_ & AUTO_SOLVE))
+            solvers.push_back(solver);
+    }
+
+    if (solvers.empty())
+        return;
+
+    // Distribute the global iteration budget by importance. The solvers' own maximum iteration counts are restored
+    // after solving, so budgeting never permanently alters their configuration
+    ea::vector<int> savedMaxIterations;
+    if (globalIterationBudget_ > 0)
+    {
+        float totalImportance = 0.0f;
+        for (IKSolver* solver : solvers)
+            totalImportance += solver->GetSolveImportance();
+
+        savedMaxIterations.reserve(solvers.size());
+        for (IKSolver* solver : solvers)
+        {
+            savedMaxIterations.push_back(solver->solver_->max_iterations);
+            const float share = solver->GetSolveImportance() / Max(totalImportance, M_EPSILON);
+            const int budgetedIterations = Max((int)(share * (float)globalIterationBudget_), 1);
+            solver->solver_->max_iterations = Min(budgetedIterations, solver->solver_->max_iterations);
+        }
+    }
+
+    // Rebuild trees and copy the scene poses on the main thread, then run the solver iterations of independent trees
+    // on worker threads. The solutions are applied back to the scene graph on the main thread afterward
+    ea::vector<IKSolver*> preparedSolvers;
+    for (IKSolver* solver : solvers)
+    {
+        solver->lastAutoSolveFrame_ = frameNumber;
+        if (solver->PrepareSolve())
+            preparedSolvers.push_back(solver);
+    }
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads() > 0 && preparedSolvers.size() > 1)
+    {
+        for (IKSolver* solver : preparedSolvers)
+            queue->AddWorkItem([solver]() { solver->ExecuteSolve(); }, M_MAX_UNSIGNED);
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (IKSolver* solver : preparedSolvers)
+            solver->ExecuteSolve();
+    }
+
+    for (IKSolver* solver : preparedSolvers)
+        solver->ApplyActivePoseToScene();
+
+    // Restore the configured maximum iteration counts
+    if (globalIterationBudget_ > 0)
+    {
+        for (unsigned i = 0; i < solvers.size(); ++i)
+            solvers[i]->solver_->max_iterations = savedMaxIterations[i];
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -269,6 +269,24 @@ public:
      */
     void Solve();
 
+    /*!
+     * @brief Sets a per-frame iteration budget shared by all auto-solved
+     * IKSolver components in a scene. Zero (the default) disables budgeting.
+     *
+     * When set, the budget is distributed between the solvers each frame
+     * proportionally to their on-screen importance: solvers attached to a
+     * nearby, visible AnimatedModel receive more iterations than distant or
+     * off-screen ones, and solvers that converged on the previous frame are
+     * assumed to be warm-started and receive a smaller share. A solver's own
+     * maximum iteration count (see SetMaximumIterations()) is never exceeded.
+     */
+    static void SetGlobalIterationBudget(int iterations);
+    /// Returns the per-frame iteration budget shared by all auto-solved solvers. Zero means unlimited.
+    static int GetGlobalIterationBudget();
+
+    /// Returns whether all effectors were within tolerance of their targets after the last solve.
+    bool IsConverged() const { return lastSolveConverged_; }
+
     /*!
      * Copies the original pose into the scene graph. This will reset the pose
      * to whatever state it had when the IKSolver component was first created,
@@ -318,6 +336,13 @@ private:
     /// Returns false if calling Solve() would cause the IK library to abort. Urho3D's error handling philosophy is to log an error and continue, not crash.
     bool IsSolverTreeValid() const;
 
+    /// Main thread part of Solve(): rebuilds trees and copies the scene graph into the solver's poses. Returns false if solving should be skipped.
+    bool PrepareSolve();
+    /// Thread-safe part of Solve(): runs the solver iterations on the internal tree only. Safe to call from a worker thread after PrepareSolve().
+    void ExecuteSolve();
+    /// Returns the relative importance of this solver for iteration budget distribution, based on the visibility and distance of an AnimatedModel on the same node.
+    float GetSolveImportance() const;
+
     /// Subscribe to drawable update finished event here.
     void OnSceneSet(Scene* scene) override;
     /// Destroys and creates the tree.
@@ -375,6 +400,12 @@ private:
     bool chainTreesNeedUpdating_;
     bool treeNeedsRebuild;
     bool solverTreeValid_;
+    /// Whether all effectors were within tolerance after the last solve. Converged solvers are warm-started and get a smaller budget share.
+    bool lastSolveConverged_{};
+    /// Frame number of the last auto-solve, so that only one solver coordinates the scene's solvers per frame.
+    unsigned lastAutoSolveFrame_{M_MAX_UNSIGNED};
+    /// Per-frame iteration budget shared by all auto-solved solvers in a scene. Zero means unlimited.
+    static int globalIterationBudget_;
 };
 
 } // namespace Urho3D
@@ -35,6 +35,10 @@
 namespace Urho3D
 {
 
+/// Block size used by the streaming compressor. Matches the LZ4 match window so each block can reference the
+/// whole previous block.
+static const unsigned STREAM_BLOCK_SIZE = 65536;
+
 unsigned EstimateCompressBound(unsigned srcSize)
 {
     return (unsigned)LZ4_compressBound(srcSize);
@@ -123,4 +127,131 @@ VectorBuffer DecompressVectorBuffer(VectorBuffer& src)
     return ret;
 }
 
+StreamCompressor::StreamCompressor() :
+    stream_(nullptr)
+{
+}
+
+StreamCompressor::~StreamCompressor()
+{
+    if (stream_)
+        LZ4_freeStreamHC((LZ4_streamHC_t*)stream_);
+}
+
+void StreamCompressor::SetDictionary(const void* data, unsigned size)
+{
+    dictionary_.clear();
+    if (data && size)
+        dictionary_.assign((const unsigned char*)data, (const unsigned char*)data + size);
+}
+
+bool StreamCompressor::Compress(Serializer& dest, Deserializer& src)
+{
+    const unsigned srcSize = src.GetSize() - src.GetPosition();
+    // Prepend the uncompressed size so that the decompressor knows how much data to expect
+    if (!dest.WriteUInt(srcSize))
+        return false;
+    if (!srcSize)
+        return true;
+
+    if (!stream_)
+        stream_ = LZ4_createStreamHC();
+    auto* stream = (LZ4_streamHC_t*)stream_;
+    LZ4_resetStreamHC(stream, 0);
+    if (!dictionary_.empty())
+        LZ4_loadDictHC(stream, (const char*)&dictionary_[0], (int)dictionary_.size());
+
+    // Double-buffered input window: the previous block stays addressable as the match window for the next
+    srcBuffer_.resize(2 * STREAM_BLOCK_SIZE);
+    destBuffer_.resize((unsigned)LZ4_compressBound(STREAM_BLOCK_SIZE));
+
+    unsigned remaining = srcSize;
+    unsigned bufferIndex = 0;
+    while (remaining)
+    {
+        const unsigned blockSize = Min(remaining, STREAM_BLOCK_SIZE);
+        char* srcPtr = (char*)&srcBuffer_[bufferIndex * STREAM_BLOCK_SIZE];
+        if (src.Read(srcPtr, blockSize) != blockSize)
+            return false;
+
+        const int compressedSize =
+            LZ4_compress_HC_continue(stream, srcPtr, (char*)&destBuffer_[0], (int)blockSize, (int)destBuffer_.size());
+        if (compressedSize <= 0)
+            return false;
+
+        if (!dest.WriteUInt((unsigned)compressedSize))
+            return false;
+        if (dest.Write(&destBuffer_[0], (unsigned)compressedSize) != (unsigned)compressedSize)
+            return false;
+
+        remaining -= blockSize;
+        bufferIndex ^= 1u;
+    }
+
+    return true;
+}
+
+StreamDecompressor::StreamDecompressor() :
+    stream_(nullptr)
+{
+}
+
+StreamDecompressor::~StreamDecompressor()
+{
+    if (stream_)
+        LZ4_freeStreamDecode((LZ4_streamDecode_t*)stream_);
+}
+
+void StreamDecompressor::SetDictionary(const void* data, unsigned size)
+{
+    dictionary_.clear();
+    if (data && size)
+        dictionary_.assign((const unsigned char*)data, (const unsigned char*)data + size);
+}
+
+bool StreamDecompressor::Decompress(Serializer& dest, Deserializer& src)
+{
+    if (src.IsEof())
+        return false;
+
+    const unsigned destSize = src.ReadUInt();
+    if (!destSize)
+        return true; // No data
+
+    if (!stream_)
+        stream_ = LZ4_createStreamDecode();
+    auto* stream = (LZ4_streamDecode_t*)stream_;
+    if (!LZ4_setStreamDecode(stream, dictionary_.empty() ? nullptr : (const char*)&dictionary_[0], (int)dictionary_.size()))
+        return false;
+
+    // Output window mirrors the compressor's double buffering so block back references stay valid
+    srcBuffer_.resize((unsigned)LZ4_compressBound(STREAM_BLOCK_SIZE));
+    destBuffer_.resize(2 * STREAM_BLOCK_SIZE);
+
+    unsigned remaining = destSize;
+    unsigned bufferIndex = 0;
+    while (remaining)
+    {
+        const unsigned blockSize = Min(remaining, STREAM_BLOCK_SIZE);
+        const unsigned compressedSize = src.ReadUInt();
+        if (!compressedSize || compressedSize > srcBuffer_.size())
+            return false; // Illegal block size reported, possibly not valid data
+        if (src.Read(&srcBuffer_[0], compressedSize) != compressedSize)
+            return false;
+
+        char* destPtr = (char*)&destBuffer_[bufferIndex * STREAM_BLOCK_SIZE];
+        const int decompressedSize =
+            LZ4_decompress_safe_continue(stream, (const char*)&srcBuffer_[0], destPtr, (int)compressedSize, (int)blockSize);
+        if (decompressedSize != (int)blockSize)
+            return false;
+        if (dest.Write(destPtr, blockSize) != blockSize)
+            return false;
+
+        remaining -= blockSize;
+        bufferIndex ^= 1u;
+    }
+
+    return true;
+}
+
 }
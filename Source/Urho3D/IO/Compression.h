@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <EASTL/vector.h>
+
 #include <Urho3D/Urho3D.h>
 
 namespace Urho3D
@@ -46,4 +48,69 @@ URHO3D_API VectorBuffer CompressVectorBuffer(VectorBuffer& src);
 /// Decompress a VectorBuffer produced using CompressVectorBuffer().
 URHO3D_API VectorBuffer DecompressVectorBuffer(VectorBuffer& src);
 
+/// Streaming LZ4 compressor with a reusable context. Compresses in fixed-size blocks chained to the previous
+/// window, so temporary memory stays bounded regardless of input size and the output stream can be consumed
+/// while compression progresses. An optional dictionary primes the window for a better ratio on small,
+/// similarly structured payloads such as replication messages. Not thread-safe; use one instance per thread.
+class URHO3D_API StreamCompressor
+{
+public:
+    /// Construct.
+    StreamCompressor();
+    /// Destruct. Free the compression context.
+    ~StreamCompressor();
+    /// Prevent copy construction.
+    StreamCompressor(const StreamCompressor& rhs) = delete;
+    /// Prevent assignment.
+    StreamCompressor& operator =(const StreamCompressor& rhs) = delete;
+
+    /// Set dictionary data used to prime the compression window at the start of each stream. The decompressor
+    /// must be configured with the same dictionary. Null data or zero size removes the dictionary.
+    void SetDictionary(const void* data, unsigned size);
+    /// Compress a source stream (from current position to the end) to the destination stream in fixed-size
+    /// blocks. Return true on success.
+    bool Compress(Serializer& dest, Deserializer& src);
+
+private:
+    /// LZ4 HC streaming state, reused between streams.
+    void* stream_;
+    /// Dictionary used to prime the compression window.
+    ea::vector<unsigned char> dictionary_;
+    /// Double-buffered input window.
+    ea::vector<unsigned char> srcBuffer_;
+    /// Compressed block output buffer.
+    ea::vector<unsigned char> destBuffer_;
+};
+
+/// Streaming LZ4 decompressor with a reusable context, consuming streams produced by StreamCompressor.
+/// Not thread-safe; use one instance per thread.
+class URHO3D_API StreamDecompressor
+{
+public:
+    /// Construct.
+    StreamDecompressor();
+    /// Destruct. Free the decompression context.
+    ~StreamDecompressor();
+    /// Prevent copy construction.
+    StreamDecompressor(const StreamDecompressor& rhs) = delete;
+    /// Prevent assignment.
+    StreamDecompressor& operator =(const StreamDecompressor& rhs) = delete;
+
+    /// Set dictionary data matching the one used for compression. Null data or zero size removes the dictionary.
+    void SetDictionary(const void* data, unsigned size);
+    /// Decompress a source stream produced using StreamCompressor::Compress() to the destination stream.
+    /// Return true on success.
+    bool Decompress(Serializer& dest, Deserializer& src);
+
+private:
+    /// LZ4 streaming decode state, reused between streams.
+    void* stream_;
+    /// Dictionary used to prime the decompression window.
+    ea::vector<unsigned char> dictionary_;
+    /// Compressed block input buffer.
+    ea::vector<unsigned char> srcBuffer_;
+    /// Double-buffered output window.
+    ea::vector<unsigned char> destBuffer_;
+};
+
 }
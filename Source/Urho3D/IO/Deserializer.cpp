@@ -212,6 +212,46 @@ Quaternion Deserializer::ReadPackedQuaternion()
     return ret;
 }
 
+Quaternion Deserializer::ReadQuaternionSmallestThree()
+{
+    const unsigned packed = ReadUInt();
+    const unsigned largest = packed >> 30u;
+    const float invScale = 1.0f / (1.41421356f * 511.0f);
+
+    float components[4];
+    float sumOfSquares = 0.0f;
+    unsigned shift = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        const int quantized = (int)((packed >> shift) & 0x3ffu) - 511;
+        components[i] = (float)quantized * invScale;
+        sumOfSquares += components[i] * components[i];
+        shift += 10;
+    }
+
+    // Reconstruct the omitted component, which the writer made non-negative
+    components[largest] = sqrtf(Max(1.0f - sumOfSquares, 0.0f));
+
+    Quaternion ret(components[0], components[1], components[2], components[3]);
+    ret.Normalize();
+    return ret;
+}
+
+Vector3 Deserializer::ReadQuantizedVector3()
+{
+    float components[3];
+    for (float& component : components)
+    {
+        const unsigned encoded = ReadVLE();
+        const int quantized = (int)(encoded >> 1u) ^ -(int)(encoded & 1u);
+        component = (float)quantized * (1.0f / 256.0f);
+    }
+    return Vector3(components[0], components[1], components[2]);
+}
+
 Matrix3 Deserializer::ReadMatrix3()
 {
     float data[9];
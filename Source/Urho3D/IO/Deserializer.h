@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <EASTL/span.h>
+
 #include "../Core/Variant.h"
 #include "../Math/BoundingBox.h"
 #include "../Math/Rect.h"
@@ -46,6 +48,8 @@ public:
     virtual unsigned Read(void* dest, unsigned size) = 0;
     /// Set position from the beginning of the stream. Return actual new position.
     virtual unsigned Seek(unsigned position) = 0;
+    /// Return a pointer to the data at the current read position if it is directly accessible in memory, otherwise null. The pointer is valid only while the deserializer stays open, and the caller must seek past the bytes it consumes.
+    virtual const unsigned char* GetCurrentData() const { return nullptr; }
     /// Return name of the stream.
     virtual const ea::string& GetName() const;
     /// Return a checksum if applicable.
@@ -105,6 +109,10 @@ public:
     Quaternion ReadQuaternion();
     /// Read a quaternion with each component packed in 16 bits.
     Quaternion ReadPackedQuaternion();
+    /// Read a quaternion packed into 32 bits with smallest-three encoding.
+    Quaternion ReadQuaternionSmallestThree();
+    /// Read a Vector3 quantized to 1/256 unit fixed point with variable-length encoded components.
+    Vector3 ReadQuantizedVector3();
     /// Read a Matrix3.
     Matrix3 ReadMatrix3();
     /// Read a Matrix3x4.
@@ -144,6 +152,18 @@ public:
     /// Read a text line.
     ea::string ReadLine();
 
+    /// Read an array of trivially copyable values as one block into a pre-sized destination span. The stream
+    /// layout matches reading each element individually with the unpacked per-element forms, but only one
+    /// virtual Read call is issued for the whole array.
+    template <class T> bool ReadArray(ea::span<T> values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Type should be trivially copyable to safely use byte serialization");
+        if (values.empty())
+            return true;
+        const auto size = (unsigned)(values.size() * sizeof(T));
+        return Read(values.data(), size) == size;
+    }
+
 protected:
     /// Stream position.
     unsigned position_;
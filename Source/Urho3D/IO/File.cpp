@@ -136,6 +136,28 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     if (!entry)
         return false;
 
+    // If the package is memory-mapped, serve the entry from the mapping without opening a file handle
+    if (package->GetMappedData())
+    {
+        Close();
+
+        package_ = package;
+        fileName_ = fileName;
+        absoluteFileName_ = package->GetName();
+        mode_ = FILE_READ;
+        position_ = 0;
+        offset_ = entry->offset_;
+        checksum_ = entry->checksum_;
+        size_ = entry->size_;
+        compressed_ = package->IsCompressed();
+        mappedBlockOffset_ = entry->offset_;
+        readBufferOffset_ = 0;
+        readBufferSize_ = 0;
+        readSyncNeeded_ = false;
+        writeSyncNeeded_ = false;
+        return true;
+    }
+
     bool success = OpenInternal(package->GetName(), FILE_READ, true);
     if (!success)
     {
@@ -173,6 +195,45 @@ unsigned File::Read(void* dest, unsigned size)
     if (!size)
         return 0;
 
+    if (package_)
+    {
+        const unsigned char* mappedData = package_->GetMappedData();
+
+        if (!compressed_)
+        {
+            memcpy(dest, mappedData + offset_ + position_, size);
+            position_ += size;
+            return size;
+        }
+
+        unsigned sizeLeft = size;
+        auto* destPtr = (unsigned char*)dest;
+
+        while (sizeLeft)
+        {
+            if (!cachedBlock_ || readBufferOffset_ >= readBufferSize_)
+            {
+                MemoryBuffer blockHeader(mappedData + mappedBlockOffset_, 4);
+                unsigned unpackedSize = blockHeader.ReadUShort();
+                unsigned packedSize = blockHeader.ReadUShort();
+
+                cachedBlock_ = package_->GetDecompressedBlock(mappedBlockOffset_, unpackedSize, packedSize);
+                mappedBlockOffset_ += 4 + packedSize;
+                readBufferSize_ = unpackedSize;
+                readBufferOffset_ = 0;
+            }
+
+            unsigned copySize = Min((readBufferSize_ - readBufferOffset_), sizeLeft);
+            memcpy(destPtr, cachedBlock_.get() + readBufferOffset_, copySize);
+            destPtr += copySize;
+            sizeLeft -= copySize;
+            readBufferOffset_ += copySize;
+            position_ += copySize;
+        }
+
+        return size;
+    }
+
 #ifdef __ANDROID__
     if (assetHandle_ && !compressed_)
     {
@@ -281,6 +342,36 @@ unsigned File::Seek(unsigned position)
     if (mode_ == FILE_READ && position > size_)
         position = size_;
 
+    if (package_)
+    {
+        if (!compressed_)
+        {
+            position_ = position;
+            return position_;
+        }
+
+        // Start over from the beginning
+        if (position == 0)
+        {
+            position_ = 0;
+            readBufferOffset_ = 0;
+            readBufferSize_ = 0;
+            cachedBlock_.reset();
+            mappedBlockOffset_ = offset_;
+        }
+        // Skip bytes
+        else if (position >= position_)
+        {
+            unsigned char skipBuffer[SKIP_BUFFER_SIZE];
+            while (position > position_)
+                Read(skipBuffer, Min(position - position_, SKIP_BUFFER_SIZE));
+        }
+        else
+            URHO3D_LOGERROR("Seeking backward in a compressed file is not supported");
+
+        return position_;
+    }
+
     if (compressed_)
     {
         // Start over from the beginning
@@ -311,6 +402,19 @@ unsigned File::Seek(unsigned position)
     return position_;
 }
 
+const unsigned char* File::GetCurrentData() const
+{
+    // Direct access is only possible when reading an uncompressed entry from a memory-mapped package
+    if (mode_ == FILE_READ && package_ && !compressed_)
+    {
+        const unsigned char* mappedData = package_->GetMappedData();
+        if (mappedData)
+            return mappedData + offset_ + position_;
+    }
+
+    return nullptr;
+}
+
 unsigned File::Write(const void* data, unsigned size)
 {
     if (!IsOpen())
@@ -393,6 +497,17 @@ void File::Close()
     readBuffer_.reset();
     inputBuffer_.reset();
 
+    if (package_)
+    {
+        package_.Reset();
+        cachedBlock_.reset();
+        mappedBlockOffset_ = 0;
+        position_ = 0;
+        size_ = 0;
+        offset_ = 0;
+        checksum_ = 0;
+    }
+
     if (handle_)
     {
         fclose((FILE*)handle_);
@@ -418,9 +533,9 @@ void File::SetName(const ea::string& name)
 bool File::IsOpen() const
 {
 #ifdef __ANDROID__
-    return handle_ != 0 || assetHandle_ != 0;
+    return handle_ != 0 || assetHandle_ != 0 || package_ != nullptr;
 #else
-    return handle_ != nullptr;
+    return handle_ != nullptr || package_ != nullptr;
 #endif
 }
 
@@ -79,6 +79,8 @@ public:
     unsigned Read(void* dest, unsigned size) override;
     /// Set position from the beginning of the file.
     unsigned Seek(unsigned position) override;
+    /// Return a pointer to the data at the current read position when reading an uncompressed entry from a memory-mapped package, otherwise null.
+    const unsigned char* GetCurrentData() const override;
     /// Write bytes to the file. Return number of bytes actually written.
     unsigned Write(const void* data, unsigned size) override;
 
@@ -154,6 +156,12 @@ private:
     ea::shared_array<unsigned char> readBuffer_;
     /// Decompression input buffer for compressed file loading.
     ea::shared_array<unsigned char> inputBuffer_;
+    /// Source package when reading through its memory mapping, to keep the mapping alive.
+    SharedPtr<PackageFile> package_;
+    /// Current decompressed block from the package's shared block cache.
+    ea::shared_array<unsigned char> cachedBlock_;
+    /// Offset of the next compressed block within the memory-mapped package file.
+    unsigned mappedBlockOffset_{};
     /// Read buffer position.
     unsigned readBufferOffset_;
     /// Bytes in the current read buffer.
@@ -54,7 +54,8 @@ FileWatcher::FileWatcher(Context* context) :
     Object(context),
     fileSystem_(GetSubsystem<FileSystem>()),
     delay_(1.0f),
-    watchSubDirs_(false)
+    watchSubDirs_(false),
+    contentHashing_(false)
 {
 #ifdef URHO3D_FILEWATCHER
 #ifdef __linux__
@@ -403,26 +404,115 @@ void FileWatcher::AddChange(const FileChange& change)
 
 bool FileWatcher::GetNextChange(FileChange& dest)
 {
-    MutexLock lock(changesMutex_);
+    auto delayMsec = (unsigned)(delay_ * 1000.0f);
+
+    for (;;)
+    {
+        {
+            MutexLock lock(changesMutex_);
+
+            bool found = false;
+            for (auto i = changes_.begin(); i != changes_.end(); ++i)
+            {
+                if (i->second.timer_.GetMSec(false) >= delayMsec)
+                {
+                    dest = i->second.change_;
+                    changes_.erase(i);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found)
+                return false;
+        }
+
+        // Hash outside of the mutex so that the watcher thread is not blocked on file IO
+        if (!contentHashing_ || IsContentChanged(dest))
+            return true;
+    }
+}
 
+bool FileWatcher::GetChanges(ea::vector<FileChange>& dest)
+{
     auto delayMsec = (unsigned)(delay_ * 1000.0f);
 
-    if (changes_.empty())
-        return false;
-    else
     {
-        for (auto i = changes_.begin(); i != changes_.end(); ++i)
+        MutexLock lock(changesMutex_);
+
+        for (auto i = changes_.begin(); i != changes_.end();)
         {
             if (i->second.timer_.GetMSec(false) >= delayMsec)
             {
-                dest = i->second.change_;
-                changes_.erase(i);
-                return true;
+                dest.push_back(i->second.change_);
+                i = changes_.erase(i);
             }
+            else
+                ++i;
         }
+    }
 
-        return false;
+    // Hash outside of the mutex so that the watcher thread is not blocked on file IO
+    if (contentHashing_)
+    {
+        for (auto i = dest.begin(); i != dest.end();)
+        {
+            if (IsContentChanged(*i))
+                ++i;
+            else
+                i = dest.erase(i);
+        }
+    }
+
+    return !dest.empty();
+}
+
+void FileWatcher::SetContentHashing(bool enable)
+{
+    contentHashing_ = enable;
+    if (!enable)
+        contentHashes_.clear();
+}
+
+bool FileWatcher::IsContentChanged(const FileChange& change)
+{
+    // Removals and renames always pass through, but drop the stale hash of the old name
+    if (change.kind_ == FILECHANGE_REMOVED)
+    {
+        contentHashes_.erase(change.fileName_);
+        return true;
+    }
+    if (change.kind_ == FILECHANGE_RENAMED)
+    {
+        contentHashes_.erase(change.oldFileName_);
+        return true;
+    }
+
+    const ea::string fullPath = path_ + change.fileName_;
+    if (!fileSystem_->FileExists(fullPath))
+        return true;
+
+    File file(context_, fullPath);
+    if (!file.IsOpen())
+        return true;
+
+    unsigned hash = 0;
+    unsigned char buffer[4096];
+    while (!file.IsEof())
+    {
+        unsigned length = file.Read(buffer, sizeof(buffer));
+        if (!length)
+            break;
+        for (unsigned i = 0; i < length; ++i)
+            hash = SDBMHash(hash, buffer[i]);
     }
+
+    auto it = contentHashes_.find(change.fileName_);
+    if (it != contentHashes_.end() && it->second == hash)
+        return false;
+
+    contentHashes_[change.fileName_] = hash;
+    return true;
 }
 
 }
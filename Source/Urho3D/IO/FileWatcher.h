@@ -80,6 +80,12 @@ public:
     void AddChange(const FileChange& change);
     /// Return a file change (true if was found, false if not).
     bool GetNextChange(FileChange& dest);
+    /// Return all file changes that have exceeded the delay as one batch (true if any were found).
+    bool GetChanges(ea::vector<FileChange>& dest);
+    /// \brief Enable or disable content hash filtering. When enabled, changed files are hashed when their change is
+    /// delivered and the change is dropped if the contents are identical to the last notification, e.g. when an editor
+    /// rewrites a file with unchanged bytes. Default false.
+    void SetContentHashing(bool enable);
 
     /// Return the path being watched, or empty if not watching.
     const ea::string& GetPath() const { return path_; }
@@ -87,7 +93,13 @@ public:
     /// Return the delay in seconds for notifying file changes.
     float GetDelay() const { return delay_; }
 
+    /// Return whether content hash filtering is enabled.
+    bool GetContentHashing() const { return contentHashing_; }
+
 private:
+    /// Return whether the file's content hash differs from the last notified one and update it. Prunes hashes of removed files.
+    bool IsContentChanged(const FileChange& change);
+
     struct TimedFileChange
     {
         /// File change information.
@@ -104,10 +116,14 @@ private:
     ea::unordered_map<ea::string, TimedFileChange> changes_;
     /// Mutex for the change buffer.
     Mutex changesMutex_;
+    /// Content hashes of notified files, used to filter out no-op changes. Accessed only from the consuming thread.
+    ea::unordered_map<ea::string, unsigned> contentHashes_;
     /// Delay in seconds for notifying changes.
     float delay_;
     /// Watch subdirectories flag.
     bool watchSubDirs_;
+    /// Content hash filtering flag.
+    bool contentHashing_;
 
 #ifdef _WIN32
 
@@ -39,9 +39,12 @@
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/details/null_mutex.h>
 
+#include <atomic>
 #include <mutex>
 #include <cstdio>
 
+#include <EASTL/unique_ptr.h>
+
 #ifdef __ANDROID__
 #include <android/log.h>
 #include <spdlog/sinks/android_sink.h>
@@ -139,6 +142,198 @@ protected:
 using MessageForwarderSink_mt = MessageForwarderSink<std::mutex>;
 using MessageForwarderSink_st = MessageForwarderSink<spdlog::details::null_mutex>;
 
+/// Flag for quick checking whether deferred logging is active, without reaching for the Log subsystem.
+static std::atomic<bool> deferredLoggingActive{false};
+
+/// Number of entries in a per-thread deferred log ring.
+static const unsigned DEFERRED_LOG_RING_SIZE = 256;
+
+/// Single-producer single-consumer ring of deferred log entries. The producer is the thread owning the ring, the consumer is the log thread.
+class DeferredLogRing
+{
+public:
+    /// Push an entry. Called only from the owning thread. Counts the message as dropped when the ring is full.
+    void Push(const DeferredLogEntry& entry)
+    {
+        unsigned head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= DEFERRED_LOG_RING_SIZE)
+        {
+            droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        entries_[head & (DEFERRED_LOG_RING_SIZE - 1)] = entry;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /// Pop an entry. Called only from the log thread.
+    bool Pop(DeferredLogEntry& entry)
+    {
+        unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        entry = entries_[tail & (DEFERRED_LOG_RING_SIZE - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Return and reset the number of messages dropped due to overload.
+    unsigned TakeDroppedMessages() { return droppedMessages_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    /// Entry storage.
+    DeferredLogEntry entries_[DEFERRED_LOG_RING_SIZE];
+    /// Write index, advanced by the producer.
+    std::atomic<unsigned> head_{0};
+    /// Read index, advanced by the consumer.
+    std::atomic<unsigned> tail_{0};
+    /// Number of messages dropped because the ring was full.
+    std::atomic<unsigned> droppedMessages_{0};
+};
+
+/// Registry of all per-thread rings. Rings stay alive for the lifetime of the process, as exiting threads may leave entries behind.
+static Mutex logRingsMutex;
+static ea::vector<DeferredLogRing*> logRings;
+/// Calling thread's ring, created and registered on the first deferred log call.
+static thread_local DeferredLogRing* threadLogRing = nullptr;
+
+/// Append a single packed argument to the output, formatted with the given placeholder.
+static void AppendDeferredArg(ea::string& dest, ea::string_view placeholder, const DeferredLogEntry& entry, const DeferredLogArg& arg)
+{
+    switch (arg.type_)
+    {
+    case DeferredLogArg::ARG_INT:
+        dest += Format(placeholder, arg.int_);
+        break;
+    case DeferredLogArg::ARG_UINT:
+        dest += Format(placeholder, arg.uint_);
+        break;
+    case DeferredLogArg::ARG_FLOAT:
+        dest += Format(placeholder, arg.float_);
+        break;
+    case DeferredLogArg::ARG_BOOL:
+        dest += Format(placeholder, arg.bool_);
+        break;
+    case DeferredLogArg::ARG_CHAR:
+        dest += Format(placeholder, arg.char_);
+        break;
+    case DeferredLogArg::ARG_STRING:
+        dest += Format(placeholder, &entry.strings_[arg.offset_]);
+        break;
+    default:
+        break;
+    }
+}
+
+/// Format a deferred log entry on the log thread by substituting the packed arguments into the format string.
+static ea::string FormatDeferredEntry(const DeferredLogEntry& entry)
+{
+    // Raw message: a single packed string without a format string
+    if (entry.format_ == nullptr)
+        return entry.numArgs_ ? ea::string(&entry.strings_[entry.args_[0].offset_]) : EMPTY_STRING;
+
+    ea::string result;
+    const char* c = entry.format_;
+    unsigned argIndex = 0;
+
+    while (*c)
+    {
+        if (c[0] == '{' && c[1] == '{')
+        {
+            result += '{';
+            c += 2;
+        }
+        else if (c[0] == '}' && c[1] == '}')
+        {
+            result += '}';
+            c += 2;
+        }
+        else if (c[0] == '{')
+        {
+            const char* end = strchr(c, '}');
+            if (end == nullptr)
+                break;
+
+            // Resolve an explicit positional index and strip it from the placeholder, as each argument is formatted separately
+            const char* spec = c + 1;
+            unsigned useIndex = argIndex;
+            bool explicitIndex = false;
+            while (*spec >= '0' && *spec <= '9')
+            {
+                useIndex = explicitIndex ? useIndex * 10 + (unsigned)(*spec - '0') : (unsigned)(*spec - '0');
+                explicitIndex = true;
+                ++spec;
+            }
+
+            ea::string placeholder("{");
+            placeholder.append(spec, (unsigned)(end - spec));
+            placeholder += '}';
+
+            if (useIndex < entry.numArgs_)
+                AppendDeferredArg(result, placeholder, entry, entry.args_[useIndex]);
+            if (!explicitIndex)
+                ++argIndex;
+            c = end + 1;
+        }
+        else
+            result += *c++;
+    }
+
+    return result;
+}
+
+/// Background thread that formats and writes deferred log entries.
+class DeferredLogProcessor : public Thread
+{
+public:
+    /// Construct.
+    DeferredLogProcessor() : Thread("DeferredLog") { }
+
+    /// Drain the rings until stopped, then drain whatever is left.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            if (!ProcessEntries())
+                Time::Sleep(1);
+        }
+
+        ProcessEntries();
+    }
+
+private:
+    /// Drain all rings once. Return true if any entry was processed.
+    bool ProcessEntries()
+    {
+        ea::vector<DeferredLogRing*> rings;
+        {
+            MutexLock lock(logRingsMutex);
+            rings = logRings;
+        }
+
+        bool processedAny = false;
+        DeferredLogEntry entry;
+        for (auto i = rings.begin(); i != rings.end(); ++i)
+        {
+            DeferredLogRing* ring = *i;
+            while (ring->Pop(entry))
+            {
+                processedAny = true;
+                auto* logger = reinterpret_cast<spdlog::logger*>(entry.logger_);
+                logger->log(ConvertLogLevel(entry.level_), FormatDeferredEntry(entry).c_str());
+            }
+
+            // Report overload shedding through the default logger
+            if (unsigned dropped = ring->TakeDroppedMessages())
+            {
+                if (std::shared_ptr<spdlog::logger> logger = spdlog::get("main"))
+                    logger->warn("Deferred logging overloaded, dropped {} messages", dropped);
+            }
+        }
+
+        return processedAny;
+    }
+};
+
 Logger::Logger(void* logger)
     : logger_(logger)
 {
@@ -149,6 +344,19 @@ void Logger::Write(LogLevel level, const ea::string& message) const
     if (logger_ == nullptr)
         return;
 
+    // In deferred mode hand the message over to the log thread instead of taking the sink mutexes here
+    if (Log::IsDeferredEnabled() && message.length() < DEFERRED_LOG_STRING_SIZE)
+    {
+        DeferredLogEntry entry;
+        entry.logger_ = logger_;
+        entry.level_ = level;
+        if (entry.PackArg(message))
+        {
+            Log::EnqueueDeferred(entry);
+            return;
+        }
+    }
+
     auto* logger = reinterpret_cast<spdlog::logger*>(logger_);
 
     switch (level)
@@ -215,6 +423,8 @@ public:
 #endif
     /// Sink that forwards messages to all other sinks.
     std::shared_ptr<spdlog::sinks::dist_sink_mt> sinkProxy_;
+    /// Background thread formatting and writing deferred log entries.
+    ea::unique_ptr<DeferredLogProcessor> deferredProcessor_;
 };
 
 Log::Log(Context* context) :
@@ -229,6 +439,7 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    SetDeferred(false);
     logInstance = nullptr;
 }
 
@@ -278,6 +489,49 @@ void Log::SetQuiet(bool quiet)
     impl_->platformSink_->set_level(ConvertLogLevel(quiet ? LOG_NONE : level_));
 }
 
+void Log::SetDeferred(bool enable)
+{
+    if (enable == deferred_)
+        return;
+
+    deferred_ = enable;
+
+    if (enable)
+    {
+        if (!impl_->deferredProcessor_)
+            impl_->deferredProcessor_ = ea::make_unique<DeferredLogProcessor>();
+        deferredLoggingActive.store(true, std::memory_order_relaxed);
+        impl_->deferredProcessor_->Run();
+    }
+    else if (impl_->deferredProcessor_)
+    {
+        // Stop producers first, then join the log thread, which drains the remaining entries on exit
+        deferredLoggingActive.store(false, std::memory_order_relaxed);
+        impl_->deferredProcessor_->Stop();
+    }
+}
+
+bool Log::IsDeferredEnabled()
+{
+    return deferredLoggingActive.load(std::memory_order_relaxed);
+}
+
+void Log::EnqueueDeferred(const DeferredLogEntry& entry)
+{
+    // Filter by level on the producer side to avoid paying ring traffic for suppressed messages
+    if (logInstance == nullptr || entry.level_ < logInstance->level_)
+        return;
+
+    if (threadLogRing == nullptr)
+    {
+        threadLogRing = new DeferredLogRing();
+        MutexLock lock(logRingsMutex);
+        logRings.push_back(threadLogRing);
+    }
+
+    threadLogRing->Push(entry);
+}
+
 void Log::SetLogFormat(const ea::string& format)
 {
     formatPattern_ = format;
@@ -24,6 +24,8 @@
 
 #include <EASTL/list.h>
 
+#include <cstring>
+
 #include "../Core/Macros.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
@@ -103,6 +105,154 @@ struct StoredLogMessage
     ea::string message_{};
 };
 
+/// Maximum number of packed arguments in a deferred log entry.
+static const unsigned MAX_DEFERRED_LOG_ARGS = 8;
+/// Inline storage for string arguments of a deferred log entry. Longer strings are truncated.
+static const unsigned DEFERRED_LOG_STRING_SIZE = 224;
+
+/// Packed argument of a deferred log entry.
+struct DeferredLogArg
+{
+    /// Argument type.
+    enum Type : unsigned char
+    {
+        ARG_NONE = 0,
+        ARG_INT,
+        ARG_UINT,
+        ARG_FLOAT,
+        ARG_BOOL,
+        ARG_CHAR,
+        ARG_STRING
+    };
+
+    /// Argument type.
+    Type type_;
+    union
+    {
+        /// Signed integer value.
+        long long int_;
+        /// Unsigned integer value.
+        unsigned long long uint_;
+        /// Floating point value.
+        double float_;
+        /// Boolean value.
+        bool bool_;
+        /// Character value.
+        char char_;
+        /// Offset of a string value in the entry's inline string storage.
+        unsigned offset_;
+    };
+};
+
+/// \brief Log entry captured on the calling thread in deferred mode: a format string pointer and packed arguments.
+/// Formatting happens later on the log thread, so the format string must stay valid until then, i.e. be a string literal.
+struct URHO3D_API DeferredLogEntry
+{
+    /// Spdlog logger that will write the message.
+    void* logger_{};
+    /// Format string, or null when the message is the single packed string argument.
+    const char* format_{};
+    /// Message level.
+    LogLevel level_{};
+    /// Number of packed arguments.
+    unsigned numArgs_{};
+    /// Used bytes of the inline string storage.
+    unsigned stringBytes_{};
+    /// Packed arguments.
+    DeferredLogArg args_[MAX_DEFERRED_LOG_ARGS];
+    /// Inline storage for string arguments.
+    char strings_[DEFERRED_LOG_STRING_SIZE];
+
+    /// Pack argument list. Return false when an argument can not be packed and the caller should format eagerly instead.
+    bool PackArgs() { return true; }
+    /// Pack argument list. Return false when an argument can not be packed and the caller should format eagerly instead.
+    template<typename First, typename... Rest> bool PackArgs(const First& first, const Rest&... rest)
+    {
+        return PackArg(first) && PackArgs(rest...);
+    }
+
+    /// Pack a single argument.
+    bool PackArg(int value) { return PackInt(value); }
+    bool PackArg(long value) { return PackInt(value); }
+    bool PackArg(long long value) { return PackInt(value); }
+    bool PackArg(unsigned value) { return PackUint(value); }
+    bool PackArg(unsigned long value) { return PackUint(value); }
+    bool PackArg(unsigned long long value) { return PackUint(value); }
+    bool PackArg(float value) { return PackFloat(value); }
+    bool PackArg(double value) { return PackFloat(value); }
+    bool PackArg(bool value)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS)
+            return false;
+        args_[numArgs_].type_ = DeferredLogArg::ARG_BOOL;
+        args_[numArgs_].bool_ = value;
+        ++numArgs_;
+        return true;
+    }
+    bool PackArg(char value)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS)
+            return false;
+        args_[numArgs_].type_ = DeferredLogArg::ARG_CHAR;
+        args_[numArgs_].char_ = value;
+        ++numArgs_;
+        return true;
+    }
+    bool PackArg(const char* value) { return PackString(value, (unsigned)strlen(value)); }
+    bool PackArg(const ea::string& value) { return PackString(value.c_str(), value.length()); }
+    bool PackArg(ea::string_view value) { return PackString(value.data(), value.length()); }
+    /// Unsupported argument type, the caller should format eagerly instead.
+    template<typename T> bool PackArg(const T& value) { return false; }
+
+private:
+    /// Pack a signed integer argument.
+    bool PackInt(long long value)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS)
+            return false;
+        args_[numArgs_].type_ = DeferredLogArg::ARG_INT;
+        args_[numArgs_].int_ = value;
+        ++numArgs_;
+        return true;
+    }
+    /// Pack an unsigned integer argument.
+    bool PackUint(unsigned long long value)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS)
+            return false;
+        args_[numArgs_].type_ = DeferredLogArg::ARG_UINT;
+        args_[numArgs_].uint_ = value;
+        ++numArgs_;
+        return true;
+    }
+    /// Pack a floating point argument.
+    bool PackFloat(double value)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS)
+            return false;
+        args_[numArgs_].type_ = DeferredLogArg::ARG_FLOAT;
+        args_[numArgs_].float_ = value;
+        ++numArgs_;
+        return true;
+    }
+    /// Pack a string argument into the inline storage, truncating if it does not fit.
+    bool PackString(const char* data, unsigned length)
+    {
+        if (numArgs_ >= MAX_DEFERRED_LOG_ARGS || stringBytes_ + 1 > DEFERRED_LOG_STRING_SIZE)
+            return false;
+        unsigned maxLength = DEFERRED_LOG_STRING_SIZE - stringBytes_ - 1;
+        if (length > maxLength)
+            length = maxLength;
+        memcpy(&strings_[stringBytes_], data, length);
+        strings_[stringBytes_ + length] = '\0';
+        args_[numArgs_].type_ = DeferredLogArg::ARG_STRING;
+        args_[numArgs_].offset_ = stringBytes_;
+        ++numArgs_;
+        stringBytes_ += length + 1;
+        return true;
+    }
+};
+
 class LogImpl;
 class Log;
 
@@ -123,7 +273,8 @@ public:
     template<typename... Args> void Info(const char* format, Args... args) const    { Write(LOG_INFO, format, args...); }
     template<typename... Args> void Warning(const char* format, Args... args) const { Write(LOG_WARNING, format, args...); }
     template<typename... Args> void Error(const char* format, Args... args) const   { Write(LOG_ERROR, format, args...); }
-    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const { Write(level, Format(format, args...)); }
+    /// Write a formatted message. In deferred mode the format string pointer and packed arguments are enqueued instead. Defined below %Log.
+    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const;
 
     template<typename... Args> void Trace(const ea::string& message) const   { Write(LOG_TRACE, message.c_str()); }
     template<typename... Args> void Debug(const ea::string& message) const   { Write(LOG_DEBUG, message.c_str()); }
@@ -161,6 +312,10 @@ public:
     void SetLogFormat(const ea::string& format);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     void SetQuiet(bool quiet);
+    /// \brief Enable or disable deferred logging. When enabled, log calls enqueue the format string pointer and packed
+    /// arguments into a per-thread lock-free ring and a background thread formats and writes the messages, keeping the
+    /// cost on the calling thread minimal. Messages are dropped when a ring overflows. Format strings must be literals.
+    void SetDeferred(bool enable);
 
     /// Return logging level.
     LogLevel GetLevel() const { return level_; }
@@ -168,6 +323,14 @@ public:
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     bool IsQuiet() const { return quiet_; }
 
+    /// Return whether deferred logging is enabled.
+    bool IsDeferred() const { return deferred_; }
+
+    /// Return whether deferred logging is active. Used by %Logger on the hot path.
+    static bool IsDeferredEnabled();
+    /// Enqueue a deferred log entry into the calling thread's ring. Drops the message when the ring is full.
+    static void EnqueueDeferred(const DeferredLogEntry& entry);
+
     /// Returns a logger with specified name.
     static Logger GetLogger(const ea::string& name);
     /// Returns default logger.
@@ -198,8 +361,29 @@ private:
     bool inWrite_ = false;
     /// Quiet mode flag.
     bool quiet_ = false;
+    /// Deferred logging flag.
+    bool deferred_ = false;
 };
 
+template<typename... Args> void Logger::Write(LogLevel level, const char* format, Args... args) const
+{
+    if (logger_ != nullptr && Log::IsDeferredEnabled())
+    {
+        DeferredLogEntry entry;
+        entry.logger_ = logger_;
+        entry.format_ = format;
+        entry.level_ = level;
+        if (entry.PackArgs(args...))
+        {
+            Log::EnqueueDeferred(entry);
+            return;
+        }
+        // Fall through to eager formatting when the arguments can not be packed
+    }
+
+    Write(level, Format(format, args...));
+}
+
 #ifdef URHO3D_LOGGING
 #define URHO3D_LOGTRACE(message, ...) Urho3D::Log::GetLogger().Trace(message, ##__VA_ARGS__)
 #define URHO3D_LOGDEBUG(message, ...) Urho3D::Log::GetLogger().Debug(message, ##__VA_ARGS__)
@@ -47,15 +47,26 @@ public:
     /// Write bytes to the memory area.
     unsigned Write(const void* data, unsigned size) override;
 
+    /// Return the name.
+    const ea::string& GetName() const override { return name_; }
+
+    /// Set the name. Used when the buffer stands in for a file, so that loaders relying on the source name keep working.
+    void SetName(const ea::string& name) { name_ = name; }
+
     /// Return memory area.
     unsigned char* GetData() { return buffer_; }
 
+    /// Return a pointer to the data at the current read position.
+    const unsigned char* GetCurrentData() const override { return buffer_ ? buffer_ + position_ : nullptr; }
+
     /// Return whether buffer is read-only.
     bool IsReadOnly() { return readOnly_; }
 
 private:
     /// Pointer to the memory area.
     unsigned char* buffer_;
+    /// Name.
+    ea::string name_;
     /// Read-only flag.
     bool readOnly_;
 };
@@ -27,9 +27,22 @@
 #include "../IO/PackageFile.h"
 #include "../IO/FileSystem.h"
 
+#include <LZ4/lz4.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace Urho3D
 {
 
+/// Maximum number of decompressed blocks kept in the shared cache. Blocks are at most 32KB when unpacked.
+static const unsigned MAX_CACHED_BLOCKS = 128;
+
 PackageFile::PackageFile(Context* context) :
     Object(context),
     totalSize_(0),
@@ -49,10 +62,15 @@ PackageFile::PackageFile(Context* context, const ea::string& fileName, unsigned
     Open(fileName, startOffset);
 }
 
-PackageFile::~PackageFile() = default;
+PackageFile::~PackageFile()
+{
+    UnmapFile();
+}
 
 bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
 {
+    UnmapFile();
+
     SharedPtr<File> file(new File(context_, fileName));
     if (!file->IsOpen())
         return false;
@@ -119,9 +137,46 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
             entries_[entryName] = newEntry;
     }
 
+    ReadChunkIndex(file);
+
     return true;
 }
 
+void PackageFile::ReadChunkIndex(File* file)
+{
+    chunkHashes_.clear();
+    chunkSize_ = 0;
+    chunkCoveredSize_ = 0;
+
+    // The chunk index footer is written just before the final package size trailer:
+    // [hashes] [chunk size] [covered size] [num chunks] ["PIDX"] [package size]
+    unsigned fileSize = file->GetSize();
+    if (fileSize < 6 * sizeof(unsigned))
+        return;
+
+    file->Seek(fileSize - 2 * sizeof(unsigned));
+    if (file->ReadFileID() != "PIDX")
+        return;
+
+    file->Seek(fileSize - 5 * sizeof(unsigned));
+    unsigned chunkSize = file->ReadUInt();
+    unsigned coveredSize = file->ReadUInt();
+    unsigned numChunks = file->ReadUInt();
+
+    // Sanity-check the footer in case the ID matched by accident in an old package
+    if (!chunkSize || chunkSize > 0x100000 || (chunkSize & (chunkSize - 1u)) || coveredSize > fileSize ||
+        numChunks != (coveredSize + chunkSize - 1) / chunkSize || fileSize < 6 * sizeof(unsigned) + numChunks * sizeof(unsigned))
+        return;
+
+    file->Seek(fileSize - 5 * sizeof(unsigned) - numChunks * sizeof(unsigned));
+    chunkHashes_.resize(numChunks);
+    for (unsigned i = 0; i < numChunks; ++i)
+        chunkHashes_[i] = file->ReadUInt();
+
+    chunkSize_ = chunkSize;
+    chunkCoveredSize_ = coveredSize;
+}
+
 bool PackageFile::Exists(const ea::string& fileName) const
 {
     bool found = entries_.find(fileName) != entries_.end();
@@ -198,4 +253,120 @@ void PackageFile::Scan(ea::vector<ea::string>& result, const ea::string& pathNam
     }
 }
 
+bool PackageFile::SetMemoryMapped(bool enable)
+{
+    if (!enable)
+    {
+        UnmapFile();
+        return true;
+    }
+
+    if (mappedData_)
+        return true;
+    if (fileName_.empty() || !totalSize_)
+        return false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(GetWideNativePath(fileName_).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        URHO3D_LOGERROR("Could not open package file " + fileName_ + " for memory mapping");
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        URHO3D_LOGERROR("Could not create file mapping for package file " + fileName_);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        URHO3D_LOGERROR("Could not map view of package file " + fileName_);
+        return false;
+    }
+
+    mappedFileHandle_ = file;
+    mappedViewHandle_ = mapping;
+    mappedData_ = (unsigned char*)view;
+#else
+    int fd = open(GetNativePath(fileName_).c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        URHO3D_LOGERROR("Could not open package file " + fileName_ + " for memory mapping");
+        return false;
+    }
+
+    void* data = mmap(nullptr, totalSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        URHO3D_LOGERROR("Could not memory-map package file " + fileName_);
+        return false;
+    }
+
+    mappedData_ = (unsigned char*)data;
+#endif
+
+    mappedSize_ = totalSize_;
+    return true;
+}
+
+MemoryBuffer PackageFile::OpenEntryView(const ea::string& fileName) const
+{
+    const PackageEntry* entry = GetEntry(fileName);
+    if (!entry || !mappedData_ || compressed_)
+        return MemoryBuffer((void*)nullptr, 0);
+
+    return MemoryBuffer(mappedData_ + entry->offset_, entry->size_);
+}
+
+ea::shared_array<unsigned char> PackageFile::GetDecompressedBlock(unsigned blockOffset, unsigned unpackedSize,
+    unsigned packedSize)
+{
+    MutexLock lock(blockCacheMutex_);
+
+    auto i = blockCache_.find(blockOffset);
+    if (i != blockCache_.end())
+        return i->second;
+
+    ea::shared_array<unsigned char> block(new unsigned char[unpackedSize]);
+    LZ4_decompress_fast((const char*)(mappedData_ + blockOffset + 4), (char*)block.get(), (int)unpackedSize);
+
+    // Keep the cache bounded; dropping it wholesale is acceptable as blocks are cheap to redecompress
+    if (blockCache_.size() >= MAX_CACHED_BLOCKS)
+        blockCache_.clear();
+    blockCache_[blockOffset] = block;
+
+    return block;
+}
+
+void PackageFile::UnmapFile()
+{
+    if (!mappedData_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData_);
+    CloseHandle((HANDLE)mappedViewHandle_);
+    CloseHandle((HANDLE)mappedFileHandle_);
+    mappedViewHandle_ = nullptr;
+    mappedFileHandle_ = nullptr;
+#else
+    munmap(mappedData_, mappedSize_);
+#endif
+
+    mappedData_ = nullptr;
+    mappedSize_ = 0;
+
+    MutexLock lock(blockCacheMutex_);
+    blockCache_.clear();
+}
+
 }
@@ -22,11 +22,18 @@
 
 #pragma once
 
+#include <EASTL/shared_array.h>
+
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
+#include "../IO/MemoryBuffer.h"
 
 namespace Urho3D
 {
 
+/// Size of the content chunks hashed for package delta patching. Must be a multiple of the network package fragment size.
+static const unsigned PACKAGE_CHUNK_SIZE = 65536;
+
 /// %File entry within the package file.
 struct PackageEntry
 {
@@ -82,6 +89,18 @@ public:
     /// Return whether the files are compressed.
     bool IsCompressed() const { return compressed_; }
 
+    /// Return whether the package contains a content chunk index for delta patching.
+    bool HasChunkIndex() const { return !chunkHashes_.empty(); }
+
+    /// Return the content chunk hashes, or an empty vector if the package has no chunk index.
+    const ea::vector<unsigned>& GetChunkHashes() const { return chunkHashes_; }
+
+    /// Return the size of the hashed content chunks.
+    unsigned GetChunkSize() const { return chunkSize_; }
+
+    /// Return the amount of bytes from the start of the package covered by the chunk index.
+    unsigned GetChunkCoveredSize() const { return chunkCoveredSize_; }
+
     /// Return list of file names in the package.
     const ea::vector<ea::string> GetEntryNames() const { return entries_.keys(); }
 
@@ -100,7 +119,30 @@ public:
     /// Scan package for specified files.
     void Scan(ea::vector<ea::string>& result, const ea::string& pathName, const ea::string& filter, bool recursive) const;
 
+    /// Map the package file into memory so that entries can be served without file reads, or unmap it.
+    /// Return true if successful.
+    bool SetMemoryMapped(bool enable);
+
+    /// Return whether the package file is memory-mapped.
+    bool IsMemoryMapped() const { return mappedData_ != nullptr; }
+
+    /// Return pointer to the start of the memory mapping, or null if not mapped.
+    const unsigned char* GetMappedData() const { return mappedData_; }
+
+    /// Return a zero-copy read-only view of an uncompressed entry, served from the memory mapping. The view is valid
+    /// only while the package stays mapped. Returns an empty buffer if the entry does not exist, the package is not
+    /// mapped, or the package is compressed.
+    MemoryBuffer OpenEntryView(const ea::string& fileName) const;
+
+    /// Return a decompressed block from the shared block cache, decompressing and caching it on miss. Called internally.
+    ea::shared_array<unsigned char> GetDecompressedBlock(unsigned blockOffset, unsigned unpackedSize, unsigned packedSize);
+
 private:
+    /// Unmap the package file and clear the block cache.
+    void UnmapFile();
+    /// Read the optional content chunk index from the end of the package file.
+    void ReadChunkIndex(File* file);
+
     /// File entries.
     ea::unordered_map<ea::string, PackageEntry> entries_;
     /// File name.
@@ -115,6 +157,24 @@ private:
     unsigned checksum_;
     /// Compressed flag.
     bool compressed_;
+    /// Content chunk hashes for delta patching. Empty if the package has no chunk index.
+    ea::vector<unsigned> chunkHashes_;
+    /// Size of the hashed content chunks.
+    unsigned chunkSize_{};
+    /// Amount of bytes from the start of the package covered by the chunk index.
+    unsigned chunkCoveredSize_{};
+    /// Memory mapping of the whole package file, or null if not mapped.
+    unsigned char* mappedData_{};
+    /// Size of the memory mapping.
+    unsigned mappedSize_{};
+    /// File handle backing the memory mapping. Used on Windows only.
+    void* mappedFileHandle_{};
+    /// File mapping object handle. Used on Windows only.
+    void* mappedViewHandle_{};
+    /// Cached decompressed blocks keyed by block start offset within the package file.
+    ea::unordered_map<unsigned, ea::shared_array<unsigned char> > blockCache_;
+    /// Mutex for the shared block cache.
+    mutable Mutex blockCacheMutex_;
 };
 
 }
@@ -153,6 +153,56 @@ bool Serializer::WritePackedQuaternion(const Quaternion& value)
     return Write(&coords[0], sizeof coords) == sizeof coords;
 }
 
+bool Serializer::WriteQuaternionSmallestThree(const Quaternion& value)
+{
+    Quaternion norm = value.Normalized();
+    float components[4] = {norm.w_, norm.x_, norm.y_, norm.z_};
+
+    // Find the component with the largest magnitude; the reader reconstructs it from the other three
+    unsigned largest = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largest]))
+            largest = i;
+    }
+
+    // Negate if necessary so that the omitted component is non-negative; q and -q represent the same rotation
+    if (components[largest] < 0.0f)
+    {
+        for (float& component : components)
+            component = -component;
+    }
+
+    // The remaining three components are within [-1/sqrt(2), 1/sqrt(2)]; quantize each to 10 bits
+    const float scale = 1.41421356f * 511.0f;
+    unsigned packed = largest << 30u;
+    unsigned shift = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        const int quantized = Clamp((int)Round(components[i] * scale), -511, 511);
+        packed |= (unsigned)(quantized + 511) << shift;
+        shift += 10;
+    }
+
+    return WriteUInt(packed);
+}
+
+bool Serializer::WriteQuantizedVector3(const Vector3& value)
+{
+    bool success = true;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        // Quantize to 1/256 unit and clamp into the range the 4-byte VLE encoding can represent (about +/- 1M units)
+        const int quantized = Clamp((int)Round(value.Data()[i] * 256.0f), -0xfffffff, 0xfffffff);
+        // Zigzag encoding so that small magnitudes of either sign produce short variable-length encodings
+        success &= WriteVLE(((unsigned)quantized << 1u) ^ (unsigned)(quantized >> 31));
+    }
+    return success;
+}
+
 bool Serializer::WriteMatrix3(const Matrix3& value)
 {
     return Write(value.Data(), sizeof value) == sizeof value;
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <EASTL/span.h>
 #include <EASTL/unordered_map.h>
 
 #include "../Core/Variant.h"
@@ -93,6 +94,10 @@ public:
     bool WriteQuaternion(const Quaternion& value);
     /// Write a quaternion with each component packed in 16 bits.
     bool WritePackedQuaternion(const Quaternion& value);
+    /// Write a quaternion packed into 32 bits with smallest-three encoding: the largest component is omitted and reconstructed by the reader.
+    bool WriteQuaternionSmallestThree(const Quaternion& value);
+    /// Write a Vector3 quantized to 1/256 unit fixed point, each component variable-length encoded so small magnitudes use fewer bytes.
+    bool WriteQuantizedVector3(const Vector3& value);
     /// Write a Matrix3.
     bool WriteMatrix3(const Matrix3& value);
     /// Write a Matrix3x4.
@@ -131,6 +136,18 @@ public:
     bool WriteNetID(unsigned value);
     /// Write a text line. Char codes 13 & 10 will be automatically appended.
     bool WriteLine(const ea::string& value);
+
+    /// Write an array of trivially copyable values as one block. The stream layout matches writing each element
+    /// individually with the unpacked per-element forms, but only one virtual Write call is issued for the
+    /// whole array.
+    template <class T> bool WriteArray(ea::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Type should be trivially copyable to safely use byte serialization");
+        if (values.empty())
+            return true;
+        const auto size = (unsigned)(values.size() * sizeof(T));
+        return Write(values.data(), size) == size;
+    }
 };
 
 }
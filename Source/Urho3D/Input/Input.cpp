@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/Timer.h"
 #include "../Core/Mutex.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
@@ -1560,7 +1561,17 @@ void Input::Initialize()
     ResetJoysticks();
     ResetState();
 
-    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Input, HandleBeginFrame));
+    // Prefer the direct frame begin signal; fall back to the event when the Time subsystem does not exist
+    if (auto* time = GetSubsystem<Time>())
+        time->onBeginFrame_.Subscribe(this, &Input::HandleBeginFrame);
+    else
+    {
+        SubscribeToEvent(E_BEGINFRAME, [this](StringHash, VariantMap& eventData)
+        {
+            float timeStep = eventData[BeginFrame::P_TIMESTEP].GetFloat();
+            HandleBeginFrame(timeStep);
+        });
+    }
 #ifdef __EMSCRIPTEN__
     SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(Input, HandleEndFrame));
 #endif
@@ -2461,7 +2472,7 @@ void Input::HandleScreenMode(StringHash eventType, VariantMap& eventData)
         inputScale_ = Vector2::ONE;
 }
 
-void Input::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+void Input::HandleBeginFrame(float& timeStep)
 {
     // Update input right at the beginning of the frame
     SendEvent(E_INPUTBEGIN);
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Math/BatchedMath.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void TransformPoints(const Matrix3x4& transform, ea::span<Vector3> points)
+{
+    TransformPoints(transform, points, points);
+}
+
+void TransformPoints(const Matrix3x4& transform, ea::span<const Vector3> source, ea::span<Vector3> dest)
+{
+#ifdef URHO3D_SSE
+    // Load the matrix rows once for the whole array instead of per point
+    const __m128 r0 = _mm_loadu_ps(&transform.m00_);
+    const __m128 r1 = _mm_loadu_ps(&transform.m10_);
+    const __m128 r2 = _mm_loadu_ps(&transform.m20_);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (unsigned i = 0; i < source.size(); ++i)
+    {
+        __m128 vec = _mm_set_ps(1.f, source[i].z_, source[i].y_, source[i].x_);
+        __m128 m0 = _mm_mul_ps(r0, vec);
+        __m128 m1 = _mm_mul_ps(r1, vec);
+        __m128 m2 = _mm_mul_ps(r2, vec);
+        __m128 t0 = _mm_add_ps(_mm_unpacklo_ps(m0, m1), _mm_unpackhi_ps(m0, m1));
+        __m128 t2 = _mm_add_ps(_mm_unpacklo_ps(m2, zero), _mm_unpackhi_ps(m2, zero));
+        vec = _mm_add_ps(_mm_movelh_ps(t0, t2), _mm_movehl_ps(t2, t0));
+
+        // Store only three floats to not write past the end of the last point
+        _mm_storel_pi(reinterpret_cast<__m64*>(&dest[i].x_), vec);
+        _mm_store_ss(&dest[i].z_, _mm_movehl_ps(vec, vec));
+    }
+#else
+    for (unsigned i = 0; i < source.size(); ++i)
+        dest[i] = transform * source[i];
+#endif
+}
+
+void SlerpBatch(ea::span<const Quaternion> from, ea::span<const Quaternion> to, float t, ea::span<Quaternion> dest)
+{
+    // Slerp cost is dominated by the scalar acos/sin evaluations; the batch form removes per-call overhead
+    // and lets the quaternion SSE operators inline, but has no wide kernel
+    for (unsigned i = 0; i < from.size(); ++i)
+        dest[i] = from[i].Slerp(to[i], t);
+}
+
+void NlerpBatch(ea::span<const Quaternion> from, ea::span<const Quaternion> to, float t, ea::span<Quaternion> dest,
+    bool shortestPath)
+{
+#ifdef URHO3D_SSE
+    const __m128 tVec = _mm_set1_ps(t);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (unsigned i = 0; i < from.size(); ++i)
+    {
+        __m128 a = _mm_loadu_ps(&from[i].w_);
+        __m128 b = _mm_loadu_ps(&to[i].w_);
+
+        if (shortestPath)
+        {
+            // Flip the target sign when the dot product is negative to rotate along the shorter arc
+            __m128 d = _mm_mul_ps(a, b);
+            d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+            d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 1, 2, 3)));
+            b = _mm_xor_ps(b, _mm_and_ps(signMask, _mm_cmplt_ps(d, _mm_setzero_ps())));
+        }
+
+        __m128 q = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), tVec));
+
+        // Renormalize with the same Newton-Raphson refined reciprocal square root as Quaternion::Normalize()
+        __m128 n = _mm_mul_ps(q, q);
+        n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(2, 3, 0, 1)));
+        n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(0, 1, 2, 3)));
+        __m128 e = _mm_rsqrt_ps(n);
+        __m128 e3 = _mm_mul_ps(_mm_mul_ps(e, e), e);
+        n = _mm_add_ps(e, _mm_mul_ps(half, _mm_sub_ps(e, _mm_mul_ps(n, e3))));
+        _mm_storeu_ps(&dest[i].w_, _mm_mul_ps(q, n));
+    }
+#else
+    for (unsigned i = 0; i < from.size(); ++i)
+        dest[i] = from[i].Nlerp(to[i], t, shortestPath);
+#endif
+}
+
+BoundingBox MergeBoxes(ea::span<const BoundingBox> boxes)
+{
+    if (boxes.empty())
+        return BoundingBox();
+
+#ifdef URHO3D_SSE
+    // Accumulate in registers instead of storing and reloading the result box on every merge
+    __m128 min = _mm_loadu_ps(&boxes[0].min_.x_);
+    __m128 max = _mm_loadu_ps(&boxes[0].max_.x_);
+    for (unsigned i = 1; i < boxes.size(); ++i)
+    {
+        min = _mm_min_ps(min, _mm_loadu_ps(&boxes[i].min_.x_));
+        max = _mm_max_ps(max, _mm_loadu_ps(&boxes[i].max_.x_));
+    }
+    return BoundingBox(min, max);
+#else
+    BoundingBox result = boxes[0];
+    for (unsigned i = 1; i < boxes.size(); ++i)
+        result.Merge(boxes[i]);
+    return result;
+#endif
+}
+
+void ComputePlaneDistances(const Plane& plane, ea::span<const Vector3> points, ea::span<float> distances)
+{
+    const float nx = plane.normal_.x_;
+    const float ny = plane.normal_.y_;
+    const float nz = plane.normal_.z_;
+    const float d = plane.d_;
+
+    for (unsigned i = 0; i < points.size(); ++i)
+        distances[i] = nx * points[i].x_ + ny * points[i].y_ + nz * points[i].z_ + d;
+}
+
+}
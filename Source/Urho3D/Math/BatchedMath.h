@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Plane.h"
+#include "../Math/Quaternion.h"
+
+#include <EASTL/span.h>
+
+namespace Urho3D
+{
+
+// Batched operations over arrays of math values. Unlike the per-value operators, the kernels keep the shared
+// operands (matrix rows, plane equation, box accumulators) in registers across the whole array instead of
+// reloading them per element, and use the SSE paths of the math classes when URHO3D_SSE is defined.
+
+/// Transform an array of points in place.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, ea::span<Vector3> points);
+/// Transform an array of points into a destination array of the same size.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, ea::span<const Vector3> source, ea::span<Vector3> dest);
+/// Spherically interpolate between two quaternion arrays of the same size with a common interpolation factor.
+URHO3D_API void SlerpBatch(ea::span<const Quaternion> from, ea::span<const Quaternion> to, float t,
+    ea::span<Quaternion> dest);
+/// Normalized-lerp between two quaternion arrays of the same size with a common interpolation factor.
+URHO3D_API void NlerpBatch(ea::span<const Quaternion> from, ea::span<const Quaternion> to, float t,
+    ea::span<Quaternion> dest, bool shortestPath = false);
+/// Merge an array of bounding boxes. Return an inside-out box if the array is empty.
+URHO3D_API BoundingBox MergeBoxes(ea::span<const BoundingBox> boxes);
+/// Compute signed plane distances for an array of points into a destination array of the same size.
+URHO3D_API void ComputePlaneDistances(const Plane& plane, ea::span<const Vector3> points, ea::span<float> distances);
+
+}
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Math/BatchedMath.h"
 #include "../Math/Frustum.h"
 
 #include "../DebugNew.h"
@@ -180,12 +181,66 @@ void Frustum::Transform(const Matrix3& transform)
 
 void Frustum::Transform(const Matrix3x4& transform)
 {
-    for (auto& vertice : vertices_)
-        vertice = transform * vertice;
+    TransformPoints(transform, vertices_);
 
     UpdatePlanes();
 }
 
+void Frustum::IsInsideFastBatch(unsigned count, const float* minX, const float* minY, const float* minZ,
+    const float* maxX, const float* maxY, const float* maxZ, unsigned char* results) const
+{
+    // Positive-vertex test: per plane, pick the component array holding the box corner
+    // furthest along the plane normal, so the inner loop is pure multiply-adds
+    const float* vertexX[NUM_FRUSTUM_PLANES];
+    const float* vertexY[NUM_FRUSTUM_PLANES];
+    const float* vertexZ[NUM_FRUSTUM_PLANES];
+    for (unsigned i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+    {
+        vertexX[i] = planes_[i].normal_.x_ >= 0.0f ? maxX : minX;
+        vertexY[i] = planes_[i].normal_.y_ >= 0.0f ? maxY : minY;
+        vertexZ[i] = planes_[i].normal_.z_ >= 0.0f ? maxZ : minZ;
+    }
+
+    unsigned index = 0;
+
+#ifdef URHO3D_SSE
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 outside = _mm_setzero_ps();
+        for (unsigned i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        {
+            const Plane& plane = planes_[i];
+            __m128 dist = _mm_mul_ps(_mm_set1_ps(plane.normal_.x_), _mm_loadu_ps(vertexX[i] + index));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.normal_.y_), _mm_loadu_ps(vertexY[i] + index)));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.normal_.z_), _mm_loadu_ps(vertexZ[i] + index)));
+            dist = _mm_add_ps(dist, _mm_set1_ps(plane.d_));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+        }
+
+        const int outsideMask = _mm_movemask_ps(outside);
+        for (unsigned lane = 0; lane < 4; ++lane)
+            results[index + lane] = (unsigned char)(~outsideMask >> lane) & 1u;
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        unsigned char inside = 1;
+        for (unsigned i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        {
+            const Plane& plane = planes_[i];
+            const float dist = plane.normal_.x_ * vertexX[i][index] + plane.normal_.y_ * vertexY[i][index] +
+                plane.normal_.z_ * vertexZ[i][index] + plane.d_;
+            if (dist < 0.0f)
+            {
+                inside = 0;
+                break;
+            }
+        }
+        results[index] = inside;
+    }
+}
+
 Frustum Frustum::Transformed(const Matrix3& transform) const
 {
     Frustum transformed;
@@ -199,8 +254,7 @@ Frustum Frustum::Transformed(const Matrix3& transform) const
 Frustum Frustum::Transformed(const Matrix3x4& transform) const
 {
     Frustum transformed;
-    for (unsigned i = 0; i < NUM_FRUSTUM_VERTICES; ++i)
-        transformed.vertices_[i] = transform * vertices_[i];
+    TransformPoints(transform, ea::span<const Vector3>(vertices_), ea::span<Vector3>(transformed.vertices_));
 
     transformed.UpdatePlanes();
     return transformed;
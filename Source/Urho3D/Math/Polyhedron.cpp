@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Math/BatchedMath.h"
 #include "../Math/Frustum.h"
 #include "../Math/Polyhedron.h"
 
@@ -106,9 +107,13 @@ void Polyhedron::Clip(const Plane& plane)
 
         outFace_.clear();
 
+        // Evaluate all plane distances of the face up front with the plane equation kept in registers
+        distances_.resize(face.size());
+        ComputePlaneDistances(plane, face, distances_);
+
         for (unsigned j = 0; j < face.size(); ++j)
         {
-            float distance = plane.Distance(face[j]);
+            float distance = distances_[j];
             if (distance >= 0.0f)
             {
                 if (lastDistance < 0.0f)
@@ -137,7 +142,7 @@ void Polyhedron::Clip(const Plane& plane)
         }
 
         // Recheck the distances of the last and first vertices and add the final clipped vertex if applicable
-        float distance = plane.Distance(face[0]);
+        float distance = distances_.empty() ? 0.0f : distances_[0];
         if ((lastDistance < 0.0f && distance >= 0.0f) || (lastDistance >= 0.0f && distance < 0.0f))
         {
             float t = lastDistance / (lastDistance - distance);
@@ -247,11 +252,7 @@ void Polyhedron::Transform(const Matrix3& transform)
 void Polyhedron::Transform(const Matrix3x4& transform)
 {
     for (unsigned i = 0; i < faces_.size(); ++i)
-    {
-        ea::vector<Vector3>& face = faces_[i];
-        for (unsigned j = 0; j < face.size(); ++j)
-            face[j] = transform * face[j];
-    }
+        TransformPoints(transform, faces_[i]);
 }
 
 Polyhedron Polyhedron::Transformed(const Matrix3& transform) const
@@ -116,6 +116,8 @@ private:
     ea::vector<Vector3> clippedVertices_;
     /// Internal vector for the new face being constructed.
     ea::vector<Vector3> outFace_;
+    /// Internal vector for per-vertex plane distances during clipping.
+    ea::vector<float> distances_;
 };
 
 }
@@ -0,0 +1,228 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Math/SkylinePacker.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+SkylinePacker::SkylinePacker()
+{
+    Reset(0, 0);
+}
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+    Reset(width, height, width, height);
+}
+
+SkylinePacker::SkylinePacker(int width, int height, int maxWidth, int maxHeight)
+{
+    Reset(width, height, maxWidth, maxHeight);
+}
+
+void SkylinePacker::Reset(int width, int height, int maxWidth, int maxHeight)
+{
+    doubleWidth_ = true;
+    size_ = IntVector2(width, height);
+    maxSize_ = IntVector2(maxWidth, maxHeight);
+
+    skyline_.clear();
+    skyline_.push_back(SkylineNode{0, 0, width});
+    allocated_.clear();
+}
+
+bool SkylinePacker::Allocate(int width, int height, int& x, int& y)
+{
+    if (width < 0)
+        width = 0;
+    if (height < 0)
+        height = 0;
+
+    unsigned bestIndex;
+    int bestX;
+    int bestY;
+
+    while (!FindPosition(width, height, bestIndex, bestX, bestY))
+    {
+        if (!Grow())
+            return false;
+    }
+
+    const IntRect reserved(bestX, bestY, bestX + width, bestY + height);
+    PlaceAt(bestIndex, reserved);
+    allocated_.push_back(reserved);
+
+    x = bestX;
+    y = bestY;
+    return true;
+}
+
+bool SkylinePacker::Defragment(const std::function<void(const IntRect& oldArea, const IntRect& newArea)>& relocate)
+{
+    if (allocated_.empty())
+        return true;
+
+    // Repack tallest-first into a fresh skyline, so the intermediate contour stays flat
+    SkylinePacker repacked(size_.x_, size_.y_, maxSize_.x_, maxSize_.y_);
+    repacked.doubleWidth_ = doubleWidth_;
+
+    ea::vector<unsigned> order(allocated_.size());
+    for (unsigned i = 0; i < order.size(); ++i)
+        order[i] = i;
+    ea::quick_sort(order.begin(), order.end(),
+        [this](unsigned lhs, unsigned rhs) { return allocated_[lhs].Height() > allocated_[rhs].Height(); });
+
+    ea::vector<IntRect> newAreas(allocated_.size());
+    for (unsigned index : order)
+    {
+        const IntRect& oldArea = allocated_[index];
+        int x{};
+        int y{};
+        // Can only fail if the repack lays out worse than the original at maximum size; leave the layout untouched then
+        if (!repacked.Allocate(oldArea.Width(), oldArea.Height(), x, y))
+            return false;
+        newAreas[index] = IntRect(x, y, x + oldArea.Width(), y + oldArea.Height());
+    }
+
+    // Commit the new layout and report the moved areas
+    for (unsigned i = 0; i < allocated_.size(); ++i)
+    {
+        if (relocate && newAreas[i] != allocated_[i])
+            relocate(allocated_[i], newAreas[i]);
+    }
+
+    skyline_ = ea::move(repacked.skyline_);
+    size_ = repacked.size_;
+    doubleWidth_ = repacked.doubleWidth_;
+    allocated_ = ea::move(newAreas);
+    return true;
+}
+
+bool SkylinePacker::FindPosition(int width, int height, unsigned& bestIndex, int& bestX, int& bestY) const
+{
+    bestY = M_MAX_INT;
+    bestX = M_MAX_INT;
+    bestIndex = M_MAX_UNSIGNED;
+
+    for (unsigned i = 0; i < skyline_.size(); ++i)
+    {
+        const int x = skyline_[i].x_;
+        if (x + width > size_.x_)
+            break;
+
+        // The landing height is the maximum of the segments the area would span
+        int y = skyline_[i].y_;
+        int widthLeft = width - skyline_[i].width_;
+        for (unsigned j = i + 1; widthLeft > 0 && j < skyline_.size(); ++j)
+        {
+            y = Max(y, skyline_[j].y_);
+            widthLeft -= skyline_[j].width_;
+        }
+
+        if (y + height > size_.y_)
+            continue;
+
+        // Prefer the lowest position, then the leftmost
+        if (y < bestY || (y == bestY && x < bestX))
+        {
+            bestIndex = i;
+            bestX = x;
+            bestY = y;
+        }
+    }
+
+    return bestIndex != M_MAX_UNSIGNED;
+}
+
+void SkylinePacker::PlaceAt(unsigned index, const IntRect& area)
+{
+    skyline_.insert_at(index, SkylineNode{area.left_, area.bottom_, area.Width()});
+
+    // Shrink or remove the segments shadowed by the new one
+    for (unsigned i = index + 1; i < skyline_.size();)
+    {
+        SkylineNode& node = skyline_[i];
+        if (node.x_ >= area.right_)
+            break;
+
+        const int shrink = area.right_ - node.x_;
+        if (node.width_ <= shrink)
+        {
+            skyline_.erase_at(i);
+            continue;
+        }
+
+        node.x_ += shrink;
+        node.width_ -= shrink;
+        break;
+    }
+
+    // Merge consecutive segments at the same height
+    for (unsigned i = 0; i + 1 < skyline_.size();)
+    {
+        if (skyline_[i].y_ == skyline_[i + 1].y_)
+        {
+            skyline_[i].width_ += skyline_[i + 1].width_;
+            skyline_.erase_at(i + 1);
+        }
+        else
+            ++i;
+    }
+}
+
+bool SkylinePacker::Grow()
+{
+    const bool canGrowWidth = size_.x_ < maxSize_.x_;
+    const bool canGrowHeight = size_.y_ < maxSize_.y_;
+    if (!canGrowWidth && !canGrowHeight)
+        return false;
+
+    if ((doubleWidth_ && canGrowWidth) || !canGrowHeight)
+    {
+        const int oldWidth = size_.x_;
+        size_.x_ = Max(1, size_.x_ << 1);
+
+        // The new column starts at ground level; extend the last segment if it is at ground level too
+        SkylineNode& last = skyline_.back();
+        if (last.y_ == 0)
+            last.width_ += size_.x_ - oldWidth;
+        else
+            skyline_.push_back(SkylineNode{oldWidth, 0, size_.x_ - oldWidth});
+    }
+    else
+    {
+        // More headroom; the skyline is unchanged
+        size_.y_ = Max(1, size_.y_ << 1);
+    }
+
+    doubleWidth_ = !doubleWidth_;
+    return true;
+}
+
+}
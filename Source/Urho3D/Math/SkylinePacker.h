@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Rect.h"
+
+#include <functional>
+
+namespace Urho3D
+{
+
+/// Rectangular area packer based on a bottom-left skyline. Unlike AreaAllocator, which scans a free rectangle
+/// list that fragments as allocations accumulate, the packer maintains one contour of skyline segments whose
+/// count is bounded by the atlas width, so per-allocation cost stays flat over long sessions. Grows by
+/// alternately doubling width and height up to the maximum size, like AreaAllocator. Individual areas can not
+/// be freed, matching how glyph and lightmap atlases are used; Defragment() repacks everything instead.
+class URHO3D_API SkylinePacker
+{
+public:
+    /// Default construct with empty size.
+    SkylinePacker();
+    /// Construct with given width and height.
+    SkylinePacker(int width, int height);
+    /// Construct with given width and height, and set the maximum it allows to grow.
+    SkylinePacker(int width, int height, int maxWidth, int maxHeight);
+
+    /// Reset to given width and height and remove all previous allocations.
+    void Reset(int width, int height, int maxWidth = 0, int maxHeight = 0);
+    /// Try to allocate an area. Return true if successful, with x & y coordinates filled.
+    bool Allocate(int width, int height, int& x, int& y);
+    /// Repack all allocated areas tallest-first from a clean skyline to reclaim wasted space. The callback is
+    /// invoked for each area that moved, so the caller can relocate the pixel data. Return true if successful;
+    /// on failure the current layout is left untouched.
+    bool Defragment(const std::function<void(const IntRect& oldArea, const IntRect& newArea)>& relocate);
+
+    /// Return the current width.
+    int GetWidth() const { return size_.x_; }
+
+    /// Return the current height.
+    int GetHeight() const { return size_.y_; }
+
+    /// Return number of allocated areas.
+    unsigned GetNumAllocations() const { return allocated_.size(); }
+
+private:
+    /// One segment of the skyline contour.
+    struct SkylineNode
+    {
+        /// Left edge of the segment.
+        int x_;
+        /// Height of the packed area below the segment.
+        int y_;
+        /// Width of the segment.
+        int width_;
+    };
+
+    /// Find the bottom-left-most position fitting the given size. Return true if found.
+    bool FindPosition(int width, int height, unsigned& bestIndex, int& bestX, int& bestY) const;
+    /// Raise the skyline over a placed area starting at the given segment.
+    void PlaceAt(unsigned index, const IntRect& area);
+    /// Grow the area towards the maximum size. Return true if grown.
+    bool Grow();
+
+    /// Skyline segments from left to right.
+    ea::vector<SkylineNode> skyline_;
+    /// Allocated areas, kept for defragmentation.
+    ea::vector<IntRect> allocated_;
+    /// Current size.
+    IntVector2 size_;
+    /// Maximum size it allows to grow. It is zero when it is not allowed to grow.
+    IntVector2 maxSize_;
+    /// The dimension to use for next growth.
+    bool doubleWidth_{true};
+};
+
+}
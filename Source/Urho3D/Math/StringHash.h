@@ -24,6 +24,8 @@
 
 #include <EASTL/string.h>
 
+#include <cstddef>
+
 #include "../Container/Hash.h"
 #include "../Math/MathDefs.h"
 
@@ -37,16 +39,16 @@ class URHO3D_API StringHash
 {
 public:
     /// Construct with zero value.
-    StringHash() noexcept :
+    constexpr StringHash() noexcept :
         value_(0)
     {
     }
 
     /// Copy-construct from another hash.
-    StringHash(const StringHash& rhs) noexcept = default;
+    constexpr StringHash(const StringHash& rhs) noexcept = default;
 
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) noexcept :
+    explicit constexpr StringHash(unsigned value) noexcept :
         value_(value)
     {
     }
@@ -84,22 +86,22 @@ public:
     }
 
     /// Test for equality with another hash.
-    bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
+    constexpr bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
 
     /// Test for inequality with another hash.
-    bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
+    constexpr bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
 
     /// Test if less than another hash.
-    bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
+    constexpr bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
 
     /// Test if greater than another hash.
-    bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
+    constexpr bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
 
     /// Return true if nonzero hash value.
-    explicit operator bool() const { return value_ != 0; }
+    explicit constexpr operator bool() const { return value_ != 0; }
 
     /// Return hash value.
-    unsigned Value() const { return value_; }
+    constexpr unsigned Value() const { return value_; }
 
     /// Return as string.
     ea::string ToString() const;
@@ -108,7 +110,7 @@ public:
     ea::string Reverse() const;
 
     /// Return hash value for HashSet & HashMap.
-    unsigned ToHash() const { return value_; }
+    constexpr unsigned ToHash() const { return value_; }
 #ifndef URHO3D_HASH_DEBUG
     /// Calculate hash value from a C string.
     static constexpr unsigned Calculate(const char* str, unsigned hash = 0)
@@ -135,4 +137,12 @@ private:
 
 static_assert(sizeof(StringHash) == sizeof(unsigned), "Unexpected StringHash size.");
 
+#ifndef URHO3D_HASH_DEBUG
+/// Construct a StringHash from a string literal at compile time, e.g. "Position"_sh.
+constexpr StringHash operator ""_sh(const char* str, std::size_t) { return StringHash(str); }
+#else
+/// Construct a StringHash from a string literal, e.g. "Position"_sh.
+inline StringHash operator ""_sh(const char* str, std::size_t) { return StringHash(str); }
+#endif
+
 }
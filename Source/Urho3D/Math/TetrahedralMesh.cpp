@@ -38,6 +38,12 @@ namespace Urho3D
 namespace
 {
 
+/// Max dimension of the query acceleration grid.
+static const int MAX_QUERY_GRID_SIZE = 64;
+
+/// Max number of steps the query walk takes from the cached tetrahedron before restarting near the query point.
+static const unsigned MAX_QUERY_STEPS_FROM_HINT = 16;
+
 /// Edge of tetrahedral mesh.
 struct TetrahedralMeshEdge
 {
@@ -153,6 +159,55 @@ void TetrahedralMesh::Define(ea::span<const Vector3> positions)
     boundingBox.max_ += Vector3::ONE;
     InitializeSuperMesh(boundingBox);
     BuildTetrahedrons(positions);
+    BuildQueryGrid();
+}
+
+void TetrahedralMesh::BuildQueryGrid()
+{
+    queryGridCells_.clear();
+    if (numInnerTetrahedrons_ == 0 || vertices_.empty())
+        return;
+
+    queryGridBoundingBox_ = BoundingBox(vertices_.data(), vertices_.size());
+    queryGridSize_ = Clamp(CeilToInt(Pow(static_cast<float>(numInnerTetrahedrons_), 1.0f / 3.0f)), 1, MAX_QUERY_GRID_SIZE);
+
+    // Walk to the tetrahedron containing (or closest to) the center of each cell.
+    // Scan order keeps consecutive cell centers nearby, so the walk takes few steps per cell.
+    // The grid itself must stay empty until fully built because the walk consults it.
+    ea::vector<unsigned> cells(queryGridSize_ * queryGridSize_ * queryGridSize_);
+    const Vector3 cellSize = queryGridBoundingBox_.Size() / static_cast<float>(queryGridSize_);
+    unsigned tetIndexHint = 0;
+    unsigned cellIndex = 0;
+    for (int z = 0; z < queryGridSize_; ++z)
+    {
+        for (int y = 0; y < queryGridSize_; ++y)
+        {
+            for (int x = 0; x < queryGridSize_; ++x)
+            {
+                const Vector3 cellCenter = queryGridBoundingBox_.min_
+                    + cellSize * Vector3(x + 0.5f, y + 0.5f, z + 0.5f);
+                GetInterpolationFactors(cellCenter, tetIndexHint);
+                if (tetIndexHint >= tetrahedrons_.size())
+                    tetIndexHint = 0;
+                cells[cellIndex++] = tetIndexHint;
+            }
+        }
+    }
+
+    queryGridCells_ = ea::move(cells);
+}
+
+unsigned TetrahedralMesh::GetQueryGridSeed(const Vector3& position) const
+{
+    if (queryGridCells_.empty())
+        return 0;
+
+    const Vector3 size = VectorMax(queryGridBoundingBox_.Size(), Vector3::ONE * M_EPSILON);
+    const Vector3 normalized = (position - queryGridBoundingBox_.min_) / size;
+    const int x = Clamp(FloorToInt(normalized.x_ * queryGridSize_), 0, queryGridSize_ - 1);
+    const int y = Clamp(FloorToInt(normalized.y_ * queryGridSize_), 0, queryGridSize_ - 1);
+    const int z = Clamp(FloorToInt(normalized.z_ * queryGridSize_), 0, queryGridSize_ - 1);
+    return queryGridCells_[(z * queryGridSize_ + y) * queryGridSize_ + x];
 }
 
 void TetrahedralMesh::CollectEdges(ea::vector<ea::pair<unsigned, unsigned>>& edges)
@@ -270,8 +325,12 @@ Vector4 TetrahedralMesh::GetInterpolationFactors(const Vector3& position, unsign
         return Vector4::ZERO;
 
     const unsigned maxIters = tetrahedrons_.size();
+    bool reseeded = queryGridCells_.empty();
     if (tetIndexHint >= maxIters)
-        tetIndexHint = 0;
+    {
+        tetIndexHint = GetQueryGridSeed(position);
+        reseeded = true;
+    }
 
     for (unsigned i = 0; i < maxIters; ++i)
     {
@@ -279,6 +338,14 @@ Vector4 TetrahedralMesh::GetInterpolationFactors(const Vector3& position, unsign
         if (weights.x_ >= 0.0f && weights.y_ >= 0.0f && weights.z_ >= 0.0f && weights.w_ >= 0.0f)
             return weights;
 
+        // If the walk from the cached tetrahedron takes too long, restart it near the query point
+        if (!reseeded && i >= MAX_QUERY_STEPS_FROM_HINT)
+        {
+            tetIndexHint = GetQueryGridSeed(position);
+            reseeded = true;
+            continue;
+        }
+
         if (weights.x_ < weights.y_ && weights.x_ < weights.z_ && weights.x_ < weights.w_)
             tetIndexHint = tetrahedrons_[tetIndexHint].neighbors_[0];
         else if (weights.y_ < weights.z_ && weights.y_ < weights.w_)
@@ -1244,6 +1311,11 @@ bool SerializeValue(Archive& archive, const char* name, TetrahedralMesh& value)
         SerializeVector(archive, "Tetrahedrons", "Tetrahedron", value.tetrahedrons_);
         SerializeVector(archive, "HullNormals", "Hulls", value.hullNormals_);
         SerializeValue(archive, "NumInnerTetrahedrons", value.numInnerTetrahedrons_);
+
+        // Acceleration grid is derived data, rebuild it instead of loading
+        if (archive.IsInput())
+            value.BuildQueryGrid();
+
         return true;
     }
     return false;
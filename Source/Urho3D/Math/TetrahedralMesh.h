@@ -303,6 +303,12 @@ public:
     /// Define mesh from vertices.
     void Define(ea::span<const Vector3> positions);
 
+    /// Build uniform grid used to seed position queries. Called automatically on mesh definition and loading.
+    void BuildQueryGrid();
+
+    /// Return tetrahedron used as starting point for walking to given position. Return 0 if the grid is not built.
+    unsigned GetQueryGridSeed(const Vector3& position) const;
+
     /// Collect all edges in the mesh, e.g. for debug rendering.
     void CollectEdges(ea::vector<ea::pair<unsigned, unsigned>>& edges);
 
@@ -424,6 +430,13 @@ public:
     /// Number of inner tetrahedrons.
     unsigned numInnerTetrahedrons_{};
 
+    /// Bounding box of the query acceleration grid.
+    BoundingBox queryGridBoundingBox_;
+    /// Dimension of the query acceleration grid (same for all axes).
+    int queryGridSize_{};
+    /// Starting tetrahedrons for each cell of the query acceleration grid.
+    ea::vector<unsigned> queryGridCells_;
+
     /// Debug array of edges related to errors in generation.
     mutable ea::vector<ea::pair<unsigned, unsigned>> debugHighlightEdges_;
 };
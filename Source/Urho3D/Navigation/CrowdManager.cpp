@@ -34,6 +34,7 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#include <Detour/DetourCommon.h>
 #include <DetourCrowd/DetourCrowd.h>
 
 #include "../DebugNew.h"
@@ -45,6 +46,7 @@ extern const char* NAVIGATION_CATEGORY;
 
 static const unsigned DEFAULT_MAX_AGENTS = 512;
 static const float DEFAULT_MAX_AGENT_RADIUS = 0.f;
+static const unsigned DEFAULT_FAR_UPDATE_RATIO = 4;
 
 static const StringVector filterTypesStructureElementNames =
 {
@@ -81,7 +83,8 @@ void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos,
 CrowdManager::CrowdManager(Context* context) :
     Component(context),
     maxAgents_(DEFAULT_MAX_AGENTS),
-    maxAgentRadius_(DEFAULT_MAX_AGENT_RADIUS)
+    maxAgentRadius_(DEFAULT_MAX_AGENT_RADIUS),
+    farUpdateRatio_(DEFAULT_FAR_UPDATE_RATIO)
 {
     // The actual buffer is allocated inside dtCrowd, we only track the number of "slots" being configured explicitly
     numAreas_.reserve(DT_CROWD_MAX_QUERY_FILTER_TYPE);
@@ -101,6 +104,9 @@ void CrowdManager::RegisterObject(Context* context)
 
     URHO3D_ATTRIBUTE("Max Agents", unsigned, maxAgents_, DEFAULT_MAX_AGENTS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Max Agent Radius", float, maxAgentRadius_, DEFAULT_MAX_AGENT_RADIUS, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Update Interval", float, updateInterval_, 0.f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("LOD Distance", float, lodDistance_, 0.f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Far Update Ratio", unsigned, farUpdateRatio_, DEFAULT_FAR_UPDATE_RATIO, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Navigation Mesh", unsigned, navigationMeshId_, 0, AM_DEFAULT | AM_COMPONENTID);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Filter Types", GetQueryFilterTypesAttr, SetQueryFilterTypesAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT)
@@ -115,6 +121,9 @@ void CrowdManager::ApplyAttributes()
     // Values from Editor, saved-file, or network must be checked before applying
     maxAgents_ = Max(1U, maxAgents_);
     maxAgentRadius_ = Max(0.f, maxAgentRadius_);
+    updateInterval_ = Max(0.f, updateInterval_);
+    lodDistance_ = Max(0.f, lodDistance_);
+    farUpdateRatio_ = Max(1U, farUpdateRatio_);
 
     bool navMeshChange = false;
     Scene* scene = GetScene();
@@ -391,6 +400,24 @@ void CrowdManager::SetObstacleAvoidanceParams(unsigned obstacleAvoidanceType, co
     }
 }
 
+void CrowdManager::SetUpdateInterval(float interval)
+{
+    updateInterval_ = Max(0.f, interval);
+    MarkNetworkUpdate();
+}
+
+void CrowdManager::SetLodDistance(float distance)
+{
+    lodDistance_ = Max(0.f, distance);
+    MarkNetworkUpdate();
+}
+
+void CrowdManager::SetFarUpdateRatio(unsigned ratio)
+{
+    farUpdateRatio_ = Max(1U, ratio);
+    MarkNetworkUpdate();
+}
+
 Vector3 CrowdManager::FindNearestPoint(const Vector3& point, int queryFilterType, dtPolyRef* nearestRef)
 {
     if (nearestRef)
@@ -680,7 +707,77 @@ void CrowdManager::Update(float delta)
 {
     assert(crowd_ && navigationMesh_);
     URHO3D_PROFILE("UpdateCrowd");
-    crowd_->update(delta, nullptr);
+
+    // Time-sliced update: accumulate time and step the crowd at the configured interval, extrapolating agents in between
+    updateAccumulator_ += delta;
+    if (updateInterval_ > 0.f && updateAccumulator_ < updateInterval_)
+    {
+        ExtrapolateAgents(delta);
+        return;
+    }
+
+    const float stepDelta = updateAccumulator_;
+    updateAccumulator_ = 0.f;
+    ++updateTick_;
+
+    const bool useLod = lodDistance_ > 0.f && farUpdateRatio_ > 1;
+    const bool farTick = useLod && updateTick_ % farUpdateRatio_ == 0;
+    if (useLod && !farTick)
+    {
+        // Deactivate far agents outside their own update tick so that the crowd skips them, and extrapolate them instead.
+        // Their path corridors are kept in sync, so on their own tick a regular step continues from the extrapolated position
+        const int numSlots = crowd_->getAgentCount();
+        for (int i = 0; i < numSlots; ++i)
+        {
+            dtCrowdAgent* agent = crowd_->getEditableAgent(i);
+            if (!agent->active || !agent->params.userData)
+                continue;
+            if ((Vector3(agent->npos) - lodCenter_).LengthSquared() > lodDistance_ * lodDistance_)
+            {
+                agent->active = false;
+                ExtrapolateAgent(agent, stepDelta);
+            }
+        }
+    }
+
+    crowd_->update(stepDelta, nullptr);
+
+    if (useLod && !farTick)
+    {
+        // Reactivate the skipped agents immediately so that agent addition and queries see the whole crowd
+        const int numSlots = crowd_->getAgentCount();
+        for (int i = 0; i < numSlots; ++i)
+        {
+            dtCrowdAgent* agent = crowd_->getEditableAgent(i);
+            if (!agent->active && agent->params.userData)
+                agent->active = true;
+        }
+    }
+}
+
+void CrowdManager::ExtrapolateAgent(dtCrowdAgent* agent, float dt)
+{
+    if (dtVlenSqr(agent->vel) < M_EPSILON)
+        return;
+
+    // Advance along the current velocity and constrain the position to the navigation mesh through the path corridor
+    float newPos[3];
+    dtVmad(newPos, agent->npos, agent->vel, dt);
+    agent->corridor.movePosition(newPos, const_cast<dtNavMeshQuery*>(crowd_->getNavMeshQuery()),
+        crowd_->getFilter(agent->params.queryFilterType));
+    dtVcopy(agent->npos, agent->corridor.getPos());
+    CrowdAgentUpdateCallback(true, agent, agent->npos, dt);
+}
+
+void CrowdManager::ExtrapolateAgents(float dt)
+{
+    const int numSlots = crowd_->getAgentCount();
+    for (int i = 0; i < numSlots; ++i)
+    {
+        dtCrowdAgent* agent = crowd_->getEditableAgent(i);
+        if (agent->active && agent->params.userData)
+            ExtrapolateAgent(agent, dt);
+    }
 }
 
 const dtCrowdAgent* CrowdManager::GetDetourCrowdAgent(int agent) const
@@ -109,6 +109,14 @@ public:
     void SetObstacleAvoidanceTypesAttr(const VariantVector& value);
     /// Set the params for the specified obstacle avoidance type.
     void SetObstacleAvoidanceParams(unsigned obstacleAvoidanceType, const CrowdObstacleAvoidanceParams& params);
+    /// Set the crowd update interval in seconds. 0 steps the crowd every frame; larger values accumulate time into fewer, larger crowd steps and extrapolate agent positions in between.
+    void SetUpdateInterval(float interval);
+    /// Set the distance from the LOD center beyond which agents are simulated at reduced rate. 0 disables agent update LOD.
+    void SetLodDistance(float distance);
+    /// Set the update rate divisor for agents beyond the LOD distance. A far agent participates in every Nth crowd step and is extrapolated along its velocity in between.
+    void SetFarUpdateRatio(unsigned ratio);
+    /// Set the world-space center used for agent update LOD, typically the camera or player position.
+    void SetLodCenter(const Vector3& center) { lodCenter_ = center; }
 
     /// Get all the crowd agent components in the specified node hierarchy. If the node is not specified then use scene node. When inCrowdFilter is set to true then only get agents that are in the crowd.
     ea::vector<CrowdAgent*> GetAgents(Node* node = nullptr, bool inCrowdFilter = true) const;
@@ -158,6 +166,18 @@ public:
     /// Get the params for the specified obstacle avoidance type.
     const CrowdObstacleAvoidanceParams& GetObstacleAvoidanceParams(unsigned obstacleAvoidanceType) const;
 
+    /// Get the crowd update interval.
+    float GetUpdateInterval() const { return updateInterval_; }
+
+    /// Get the agent update LOD distance.
+    float GetLodDistance() const { return lodDistance_; }
+
+    /// Get the update rate divisor for agents beyond the LOD distance.
+    unsigned GetFarUpdateRatio() const { return farUpdateRatio_; }
+
+    /// Get the world-space center used for agent update LOD.
+    const Vector3& GetLodCenter() const { return lodCenter_; }
+
 protected:
     /// Create and initialized internal Detour crowd object. When it is a recreate, it preserves the configuration and attempts to re-add existing agents in the previous crowd back to the newly created crowd.
     bool CreateCrowd();
@@ -186,6 +206,10 @@ private:
     void HandleNavMeshChanged(StringHash eventType, VariantMap& eventData);
     /// Handle component added in the scene to check for late addition of the navmesh.
     void HandleComponentAdded(StringHash eventType, VariantMap& eventData);
+    /// Advance an agent along its current velocity and move its path corridor, without a full crowd update.
+    void ExtrapolateAgent(dtCrowdAgent* agent, float dt);
+    /// Extrapolate all crowd agents. Used between time-sliced crowd steps.
+    void ExtrapolateAgents(float dt);
 
     /// Internal Detour crowd object.
     dtCrowd* crowd_{};
@@ -205,6 +229,18 @@ private:
     ea::vector<unsigned> numAreas_;
     /// Number of obstacle avoidance types configured in the crowd. Limit to DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS.
     unsigned numObstacleAvoidanceTypes_{};
+    /// Crowd update interval. 0 steps the crowd every frame.
+    float updateInterval_{};
+    /// Accumulated time towards the next crowd step.
+    float updateAccumulator_{};
+    /// Distance from the LOD center beyond which agents update at reduced rate. 0 disables agent update LOD.
+    float lodDistance_{};
+    /// Update rate divisor for agents beyond the LOD distance.
+    unsigned farUpdateRatio_{};
+    /// World-space center used for agent update LOD.
+    Vector3 lodCenter_;
+    /// Running crowd step counter for far agent update scheduling.
+    unsigned updateTick_{};
 };
 
 }
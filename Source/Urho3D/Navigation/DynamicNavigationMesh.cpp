@@ -746,6 +746,18 @@ ea::vector<unsigned char> DynamicNavigationMesh::GetNavigationDataAttr() const
     return ret.GetBuffer();
 }
 
+bool DynamicNavigationMesh::SaveTileData(const ea::string& fileName) const
+{
+    URHO3D_LOGERROR("Dynamic navigation mesh stores compressed tile cache data, tile data files are not supported");
+    return false;
+}
+
+bool DynamicNavigationMesh::LoadTileData(const ea::string& fileName)
+{
+    URHO3D_LOGERROR("Dynamic navigation mesh stores compressed tile cache data, tile data files are not supported");
+    return false;
+}
+
 void DynamicNavigationMesh::SetMaxLayers(unsigned maxLayers)
 {
     // Set 3 as a minimum due to the tendency of layers to be constructed inside the hollow space of stacked objects
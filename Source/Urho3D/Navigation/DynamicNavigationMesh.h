@@ -84,6 +84,11 @@ public:
     /// Return navigation data attribute.
     ea::vector<unsigned char> GetNavigationDataAttr() const override;
 
+    /// Save tile data. Not supported, as the dynamic navigation mesh stores compressed tile cache data instead of plain Detour tiles. Return false.
+    bool SaveTileData(const ea::string& fileName) const override;
+    /// Load tile data. Not supported. Return false.
+    bool LoadTileData(const ea::string& fileName) override;
+
     /// Set the maximum number of obstacles allowed.
     void SetMaxObstacles(unsigned maxObstacles) { maxObstacles_ = maxObstacles; }
     /// Set the maximum number of layers that navigation construction can create.
@@ -23,7 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -31,6 +34,8 @@
 #include "../Graphics/StaticModel.h"
 #include "../Graphics/TerrainPatch.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
 #include "../Navigation/CrowdAgent.h"
@@ -53,6 +58,14 @@
 #include <Detour/DetourNavMeshQuery.h>
 #include <Recast/Recast.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -83,6 +96,13 @@ static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 
 static const int MAX_POLYS = 2048;
 
+/// File identifier of standalone navigation tile data files.
+static const char* NAV_TILE_FILE_ID = "UNAV";
+/// Version of the navigation tile data file format.
+static const unsigned NAV_TILE_FILE_VERSION = 1;
+/// Alignment of tile data records in a tile data file. Matches the common memory page size so that mapped tiles stay page-aligned.
+static const unsigned NAV_TILE_FILE_ALIGNMENT = 4096;
+
 
 /// Temporary data for finding a path.
 struct FindPathData
@@ -97,12 +117,71 @@ struct FindPathData
     unsigned char pathFlags_[MAX_POLYS]{};
 };
 
+/// Maximum A* iterations advanced per sliced path query per frame.
+static const int MAX_PATH_QUERY_ITERATIONS = 512;
+
+/// An asynchronous path query request.
+struct AsyncPathQuery
+{
+    /// Query ID.
+    unsigned id_;
+    /// Priority. Higher priority queries are processed first.
+    int priority_;
+    /// Start position in navigation mesh local space.
+    Vector3 localStart_;
+    /// End position in navigation mesh local space.
+    Vector3 localEnd_;
+    /// Search extents for locating the start and end polygons.
+    Vector3 extents_;
+    /// Whether the query has completed.
+    bool done_;
+    /// Index of the pooled query slot processing this query, or -1 when waiting for a slot.
+    int slot_;
+    /// Resulting path in world space. Empty if no path was found.
+    ea::vector<Vector3> path_;
+};
+
+/// A pooled Detour query object advancing one sliced path query, possibly on a worker thread.
+struct PathQuerySlot
+{
+    /// Detour query object.
+    dtNavMeshQuery* query_{};
+    /// ID of the path query being processed, or 0 if the slot is free.
+    unsigned queryId_{};
+    /// End polygon of the sliced query, for clamping partial paths.
+    dtPolyRef endRef_{};
+    /// Status of the sliced query after the last update.
+    dtStatus status_{};
+    /// Temporary data for finalizing the path.
+    FindPathData pathData_;
+};
+
+/// State of the asynchronous path queries of a navigation mesh.
+struct AsyncPathData
+{
+    /// Waiting, in-progress and completed path queries.
+    ea::vector<AsyncPathQuery> queries_;
+    /// Pooled query slots, one per work queue thread plus the main thread.
+    ea::vector<PathQuerySlot> slots_;
+    /// Next query ID to assign. ID 0 signals failure to queue.
+    unsigned nextQueryId_{1};
+};
+
+/// Advance the sliced path query of one slot. Executed from worker threads.
+static void UpdatePathQuerySlotWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* slot = reinterpret_cast<PathQuerySlot*>(item->start_);
+    int doneIterations = 0;
+    slot->status_ = slot->query_->updateSlicedFindPath(MAX_PATH_QUERY_ITERATIONS, &doneIterations);
+}
+
 NavigationMesh::NavigationMesh(Context* context) :
     Component(context),
     navMesh_(nullptr),
     navMeshQuery_(nullptr),
     queryFilter_(new dtQueryFilter()),
     pathData_(new FindPathData()),
+    asyncPathData_(new AsyncPathData()),
     tileSize_(DEFAULT_TILE_SIZE),
     cellSize_(DEFAULT_CELL_SIZE),
     cellHeight_(DEFAULT_CELL_HEIGHT),
@@ -737,6 +816,89 @@ void NavigationMesh::FindPath(ea::vector<NavigationPathPoint>& dest, const Vecto
     }
 }
 
+unsigned NavigationMesh::FindPathAsync(const Vector3& start, const Vector3& end, const Vector3& extents, int priority)
+{
+    if (!navMesh_ || !node_)
+        return 0;
+
+    // Navigation data is in local space. Transform the end points from world to local up front, so that later node
+    // movement does not affect a query in flight
+    const Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+
+    AsyncPathQuery query;
+    query.id_ = asyncPathData_->nextQueryId_++;
+    query.priority_ = priority;
+    query.localStart_ = inverse * start;
+    query.localEnd_ = inverse * end;
+    query.extents_ = extents;
+    query.done_ = false;
+    query.slot_ = -1;
+    asyncPathData_->queries_.push_back(query);
+
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(NavigationMesh, HandleUpdate));
+    return query.id_;
+}
+
+bool NavigationMesh::IsPathQueryDone(unsigned queryId) const
+{
+    const ea::vector<AsyncPathQuery>& queries = asyncPathData_->queries_;
+    for (unsigned i = 0; i < queries.size(); ++i)
+    {
+        if (queries[i].id_ == queryId)
+            return queries[i].done_;
+    }
+
+    return false;
+}
+
+bool NavigationMesh::GetPathQueryResult(unsigned queryId, ea::vector<Vector3>& dest)
+{
+    ea::vector<AsyncPathQuery>& queries = asyncPathData_->queries_;
+    for (unsigned i = 0; i < queries.size(); ++i)
+    {
+        if (queries[i].id_ == queryId)
+        {
+            if (!queries[i].done_)
+                return false;
+
+            dest = ea::move(queries[i].path_);
+            queries.erase_at(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NavigationMesh::CancelPathQuery(unsigned queryId)
+{
+    ea::vector<AsyncPathQuery>& queries = asyncPathData_->queries_;
+    for (unsigned i = 0; i < queries.size(); ++i)
+    {
+        if (queries[i].id_ == queryId)
+        {
+            // Free the slot; the slot's sliced query state is reset when the slot is reused
+            if (queries[i].slot_ >= 0)
+                asyncPathData_->slots_[queries[i].slot_].queryId_ = 0;
+            queries.erase_at(i);
+            return;
+        }
+    }
+}
+
+unsigned NavigationMesh::GetNumPendingPathQueries() const
+{
+    unsigned numPending = 0;
+    const ea::vector<AsyncPathQuery>& queries = asyncPathData_->queries_;
+    for (unsigned i = 0; i < queries.size(); ++i)
+    {
+        if (!queries[i].done_)
+            ++numPending;
+    }
+
+    return numPending;
+}
+
 Vector3 NavigationMesh::GetRandomPoint(const dtQueryFilter* filter, dtPolyRef* randomRef)
 {
     if (!InitializeQuery())
@@ -950,6 +1112,201 @@ ea::vector<unsigned char> NavigationMesh::GetNavigationDataAttr() const
     return ret.GetBuffer();
 }
 
+bool NavigationMesh::SaveTileData(const ea::string& fileName) const
+{
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh not built, can not save tile data");
+        return false;
+    }
+
+    File dest(context_, fileName, FILE_WRITE);
+    if (!dest.IsOpen())
+        return false;
+
+    // Collect the existing tiles first so that the directory can be written up front
+    ea::vector<const dtMeshTile*> tiles;
+    ea::vector<IntVector2> tileCoords;
+    const dtNavMesh* navMesh = navMesh_;
+
+    for (int z = 0; z < numTilesZ_; ++z)
+    {
+        for (int x = 0; x < numTilesX_; ++x)
+        {
+            const dtMeshTile* tile = navMesh->getTileAt(x, z, 0);
+            if (tile)
+            {
+                tiles.push_back(tile);
+                tileCoords.push_back(IntVector2(x, z));
+            }
+        }
+    }
+
+    dest.WriteFileID(NAV_TILE_FILE_ID);
+    dest.WriteUInt(NAV_TILE_FILE_VERSION);
+    dest.WriteBoundingBox(boundingBox_);
+    dest.WriteInt(numTilesX_);
+    dest.WriteInt(numTilesZ_);
+
+    const dtNavMeshParams* params = navMesh_->getParams();
+    dest.WriteFloat(params->tileWidth);
+    dest.WriteFloat(params->tileHeight);
+    dest.WriteInt(params->maxTiles);
+    dest.WriteInt(params->maxPolys);
+    dest.WriteUInt(tiles.size());
+
+    // Directory: tile coordinates plus the aligned offset and size of each tile data record
+    unsigned offset = dest.GetSize() + tiles.size() * 4 * sizeof(unsigned);
+    for (unsigned i = 0; i < tiles.size(); ++i)
+    {
+        offset = (offset + NAV_TILE_FILE_ALIGNMENT - 1) & ~(NAV_TILE_FILE_ALIGNMENT - 1);
+        dest.WriteInt(tileCoords[i].x_);
+        dest.WriteInt(tileCoords[i].y_);
+        dest.WriteUInt(offset);
+        dest.WriteUInt((unsigned)tiles[i]->dataSize);
+        offset += (unsigned)tiles[i]->dataSize;
+    }
+
+    for (unsigned i = 0; i < tiles.size(); ++i)
+    {
+        while (dest.GetSize() & (NAV_TILE_FILE_ALIGNMENT - 1))
+            dest.WriteUByte(0);
+        dest.Write(tiles[i]->data, (unsigned)tiles[i]->dataSize);
+    }
+
+    return true;
+}
+
+bool NavigationMesh::LoadTileData(const ea::string& fileName)
+{
+    URHO3D_PROFILE("LoadNavigationTileData");
+
+    ReleaseNavigationMesh();
+
+    // Map the file copy-on-write, as Detour writes the poly links of each tile into the tile data
+#ifdef _WIN32
+    HANDLE file = CreateFileW(GetWideNativePath(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        URHO3D_LOGERROR("Could not open navigation tile data file " + fileName);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || !size.QuadPart)
+    {
+        CloseHandle(file);
+        URHO3D_LOGERROR("Could not get size of navigation tile data file " + fileName);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        URHO3D_LOGERROR("Could not create file mapping for navigation tile data file " + fileName);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        URHO3D_LOGERROR("Could not map view of navigation tile data file " + fileName);
+        return false;
+    }
+
+    mappedTileFileHandle_ = file;
+    mappedTileViewHandle_ = mapping;
+    mappedTileData_ = (unsigned char*)view;
+    mappedTileSize_ = (unsigned)size.QuadPart;
+#else
+    int fd = open(GetNativePath(fileName).c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        URHO3D_LOGERROR("Could not open navigation tile data file " + fileName);
+        return false;
+    }
+
+    unsigned size = (unsigned)lseek(fd, 0, SEEK_END);
+    void* data = size ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        URHO3D_LOGERROR("Could not memory-map navigation tile data file " + fileName);
+        return false;
+    }
+
+    mappedTileData_ = (unsigned char*)data;
+    mappedTileSize_ = size;
+#endif
+
+    MemoryBuffer buffer(mappedTileData_, mappedTileSize_);
+    if (buffer.ReadFileID() != NAV_TILE_FILE_ID || buffer.ReadUInt() != NAV_TILE_FILE_VERSION)
+    {
+        URHO3D_LOGERROR(fileName + " is not a valid navigation tile data file");
+        UnmapTileData();
+        return false;
+    }
+
+    boundingBox_ = buffer.ReadBoundingBox();
+    numTilesX_ = buffer.ReadInt();
+    numTilesZ_ = buffer.ReadInt();
+
+    dtNavMeshParams params;     // NOLINT(hicpp-member-init)
+    rcVcopy(params.orig, &boundingBox_.min_.x_);
+    params.tileWidth = buffer.ReadFloat();
+    params.tileHeight = buffer.ReadFloat();
+    params.maxTiles = buffer.ReadInt();
+    params.maxPolys = buffer.ReadInt();
+
+    navMesh_ = dtAllocNavMesh();
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Could not allocate navigation mesh");
+        UnmapTileData();
+        return false;
+    }
+
+    if (dtStatusFailed(navMesh_->init(&params)))
+    {
+        URHO3D_LOGERROR("Could not initialize navigation mesh");
+        ReleaseNavigationMesh();
+        return false;
+    }
+
+    const unsigned numTiles = buffer.ReadUInt();
+
+    for (unsigned i = 0; i < numTiles; ++i)
+    {
+        /*int x =*/ buffer.ReadInt();
+        /*int z =*/ buffer.ReadInt();
+        const unsigned offset = buffer.ReadUInt();
+        const unsigned dataSize = buffer.ReadUInt();
+
+        if (offset + dataSize > mappedTileSize_)
+        {
+            URHO3D_LOGERROR("Out of bounds tile data record in navigation tile data file " + fileName);
+            ReleaseNavigationMesh();
+            return false;
+        }
+
+        // Hand the tile to Detour in place without DT_TILE_FREE_DATA: the data stays owned by the mapping, so no
+        // per-tile allocation or copy happens and only the pages Detour links into are materialized
+        if (dtStatusFailed(navMesh_->addTile(mappedTileData_ + offset, (int)dataSize, 0, 0, nullptr)))
+        {
+            URHO3D_LOGERROR("Failed to add navigation mesh tile");
+            ReleaseNavigationMesh();
+            return false;
+        }
+    }
+
+    URHO3D_LOGDEBUG("Created navigation mesh with " + ea::to_string(numTiles) + " memory-mapped tiles from " + fileName);
+    return true;
+}
+
 void NavigationMesh::CollectGeometries(ea::vector<NavigationGeometryInfo>& geometryList)
 {
     URHO3D_PROFILE("CollectNavigationGeometry");
@@ -1306,11 +1663,24 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     // Remove previous tile (if any)
     navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
 
-    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
-
     SimpleNavBuildData build;
-
     rcConfig cfg;       // NOLINT(hicpp-member-init)
+    if (!PrepareTileBuild(geometryList, x, z, build, cfg))
+        return true; // Nothing to do
+
+    unsigned char* navData = nullptr;
+    int navDataSize = 0;
+    if (!BuildTileData(build, cfg, x, z, navData, navDataSize))
+        return false;
+
+    return InstallTileData(x, z, navData, navDataSize);
+}
+
+bool NavigationMesh::PrepareTileBuild(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, SimpleNavBuildData& build,
+    rcConfig& cfg)
+{
+    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
+
     memset(&cfg, 0, sizeof cfg);
     cfg.cs = cellSize_;
     cfg.ch = cellHeight_;
@@ -1340,9 +1710,12 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
     GetTileGeometry(&build, geometryList, expandedBox);
 
-    if (build.vertices_.empty() || build.indices_.empty())
-        return true; // Nothing to do
+    return !build.vertices_.empty() && !build.indices_.empty();
+}
 
+bool NavigationMesh::BuildTileData(SimpleNavBuildData& build, const rcConfig& cfg, int x, int z, unsigned char*& navData,
+    int& navDataSize)
+{
     build.heightField_ = rcAllocHeightfield();
     if (!build.heightField_)
     {
@@ -1462,9 +1835,6 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
             build.polyMesh_->flags[i] = 0x1;
     }
 
-    unsigned char* navData = nullptr;
-    int navDataSize = 0;
-
     dtNavMeshCreateParams params;       // NOLINT(hicpp-member-init)
     memset(&params, 0, sizeof params);
     params.verts = build.polyMesh_->verts;
@@ -1507,6 +1877,14 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         return false;
     }
 
+    return true;
+}
+
+bool NavigationMesh::InstallTileData(int x, int z, unsigned char* navData, int navDataSize)
+{
+    // Remove previous tile (if any) before adding the replacement
+    navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
+
     if (dtStatusFailed(navMesh_->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
     {
         URHO3D_LOGERROR("Failed to add navigation mesh tile");
@@ -1517,6 +1895,7 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     // Send a notification of the rebuild of this tile to anyone interested
     {
         using namespace NavigationAreaRebuilt;
+        const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
         VariantMap& eventData = GetContext()->GetEventDataMap();
         eventData[P_NODE] = GetNode();
         eventData[P_MESH] = this;
@@ -1527,10 +1906,82 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     return true;
 }
 
+namespace
+{
+
+/// One tile's worth of work for a parallel navigation mesh build.
+struct NavigationTileJob
+{
+    /// Tile coordinates.
+    IntVector2 tile_;
+    /// Recast build configuration.
+    rcConfig cfg_;      // NOLINT(hicpp-member-init)
+    /// Collected tile geometry and intermediate build data.
+    SimpleNavBuildData build_;
+    /// Cooked Detour tile data.
+    unsigned char* navData_{};
+    /// Size of the cooked tile data.
+    int navDataSize_{};
+    /// Cook result.
+    bool success_{};
+};
+
+}
+
 unsigned NavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
 {
     unsigned numTiles = 0;
 
+    auto* queue = GetSubsystem<WorkQueue>();
+    const unsigned totalTiles = (unsigned)((to.x_ - from.x_ + 1) * (to.y_ - from.y_ + 1));
+    // Cook the tiles in parallel on worker threads when possible. The parallel path bypasses the virtual BuildTile,
+    // so take it only when the tile build is not customized by a subclass
+    if (queue && queue->GetNumThreads() && totalTiles > 1 && GetType() == GetTypeStatic())
+    {
+        URHO3D_PROFILE("BuildNavigationMeshTilesParallel");
+
+        // Collect per-tile geometry and configuration on the main thread
+        ea::vector<ea::unique_ptr<NavigationTileJob> > jobs;
+        jobs.reserve(totalTiles);
+        for (int z = from.y_; z <= to.y_; ++z)
+        {
+            for (int x = from.x_; x <= to.x_; ++x)
+            {
+                // Remove previous tile (if any)
+                navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
+
+                auto job = ea::make_unique<NavigationTileJob>();
+                job->tile_ = IntVector2(x, z);
+                if (!PrepareTileBuild(geometryList, x, z, job->build_, job->cfg_))
+                {
+                    ++numTiles; // Empty tile counts as built
+                    continue;
+                }
+                jobs.push_back(ea::move(job));
+            }
+        }
+
+        // Run the Recast cooks on worker threads and help out on the main thread
+        for (auto& job : jobs)
+        {
+            NavigationTileJob* jobData = job.get();
+            queue->AddWorkItem([this, jobData]()
+            {
+                jobData->success_ = BuildTileData(jobData->build_, jobData->cfg_, jobData->tile_.x_, jobData->tile_.y_,
+                    jobData->navData_, jobData->navDataSize_);
+            }, M_MAX_UNSIGNED);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+
+        // Install the cooked tiles serially on the main thread
+        for (auto& job : jobs)
+        {
+            if (job->success_ && InstallTileData(job->tile_.x_, job->tile_.y_, job->navData_, job->navDataSize_))
+                ++numTiles;
+        }
+        return numTiles;
+    }
+
     for (int z = from.y_; z <= to.y_; ++z)
     {
         for (int x = from.x_; x <= to.x_; ++x)
@@ -1542,6 +1993,308 @@ unsigned NavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& geometry
     return numTiles;
 }
 
+void NavigationMesh::QueueTileRebuilds(const BoundingBox& boundingBox)
+{
+    if (!node_)
+        return;
+
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return;
+    }
+
+    BoundingBox localSpaceBox = boundingBox.Transformed(node_->GetWorldTransform().Inverse());
+
+    float tileEdgeLength = (float)tileSize_ * cellSize_;
+
+    int sx = Clamp((int)((localSpaceBox.min_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    int sz = Clamp((int)((localSpaceBox.min_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+    int ex = Clamp((int)((localSpaceBox.max_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    int ez = Clamp((int)((localSpaceBox.max_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+
+    for (int z = sz; z <= ez; ++z)
+    {
+        for (int x = sx; x <= ex; ++x)
+        {
+            const IntVector2 tile(x, z);
+            if (backgroundCookItem_ && backgroundTile_ == tile)
+                continue;
+            if (ea::find(queuedTiles_.begin(), queuedTiles_.end(), tile) == queuedTiles_.end())
+                queuedTiles_.push_back(tile);
+        }
+    }
+
+    if (!queuedTiles_.empty() && !backgroundCookItem_)
+    {
+        SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(NavigationMesh, HandleUpdate));
+        StartNextBackgroundTile();
+    }
+}
+
+unsigned NavigationMesh::GetNumQueuedTileRebuilds() const
+{
+    return queuedTiles_.size() + (backgroundCookItem_ ? 1 : 0);
+}
+
+void NavigationMesh::StartNextBackgroundTile()
+{
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (!queue || !queue->GetNumThreads())
+    {
+        // Without worker threads build the queued tiles immediately
+        ea::vector<NavigationGeometryInfo> geometryList;
+        CollectGeometries(geometryList);
+        for (unsigned i = 0; i < queuedTiles_.size(); ++i)
+            BuildTile(geometryList, queuedTiles_[i].x_, queuedTiles_[i].y_);
+        queuedTiles_.clear();
+        // HandleUpdate unsubscribes from the update event once path queries are idle as well
+        return;
+    }
+
+    // Take a fresh geometry snapshot so that the cook sees the latest Navigable changes
+    backgroundGeometry_.clear();
+    CollectGeometries(backgroundGeometry_);
+
+    while (!queuedTiles_.empty())
+    {
+        const IntVector2 tile = queuedTiles_.front();
+        queuedTiles_.erase(queuedTiles_.begin());
+
+        backgroundBuild_ = ea::make_unique<SimpleNavBuildData>();
+        backgroundConfig_ = ea::make_unique<rcConfig>();
+        if (!PrepareTileBuild(backgroundGeometry_, tile.x_, tile.y_, *backgroundBuild_, *backgroundConfig_))
+        {
+            // The tile no longer contains geometry; clear it immediately
+            navMesh_->removeTile(navMesh_->getTileRefAt(tile.x_, tile.y_, 0), nullptr, nullptr);
+            continue;
+        }
+
+        // Cook the tile on a worker thread at default priority so that the rendering work queue does not block on it
+        backgroundTile_ = tile;
+        backgroundNavData_ = nullptr;
+        backgroundNavDataSize_ = 0;
+        backgroundCookSuccess_ = false;
+        backgroundCookItem_ = queue->AddWorkItem([this]()
+        {
+            backgroundCookSuccess_ = BuildTileData(*backgroundBuild_, *backgroundConfig_, backgroundTile_.x_,
+                backgroundTile_.y_, backgroundNavData_, backgroundNavDataSize_);
+        });
+        return;
+    }
+}
+
+void NavigationMesh::ProcessPathQueries()
+{
+    AsyncPathData& data = *asyncPathData_;
+    if (!navMesh_ || !node_ || data.queries_.empty())
+        return;
+
+    URHO3D_PROFILE("ProcessPathQueries");
+
+    auto* queue = GetSubsystem<WorkQueue>();
+
+    // Create the pooled query objects on first use
+    if (data.slots_.empty())
+    {
+        const unsigned numSlots = (queue ? queue->GetNumThreads() : 0) + 1;
+        data.slots_.resize(numSlots);
+        for (unsigned i = 0; i < data.slots_.size(); ++i)
+        {
+            data.slots_[i].query_ = dtAllocNavMeshQuery();
+            if (!data.slots_[i].query_ || dtStatusFailed(data.slots_[i].query_->init(navMesh_, MAX_POLYS)))
+            {
+                URHO3D_LOGERROR("Could not create pooled navigation mesh query");
+                ReleasePathQueries();
+                return;
+            }
+        }
+    }
+
+    // Assign free slots to the highest priority waiting queries. Locating the end polygons is cheap compared to the
+    // path search itself, so it is done here on the main thread
+    for (unsigned slotIndex = 0; slotIndex < data.slots_.size(); ++slotIndex)
+    {
+        PathQuerySlot& slot = data.slots_[slotIndex];
+        while (!slot.queryId_)
+        {
+            AsyncPathQuery* best = nullptr;
+            for (unsigned i = 0; i < data.queries_.size(); ++i)
+            {
+                AsyncPathQuery& query = data.queries_[i];
+                if (!query.done_ && query.slot_ < 0 && (!best || query.priority_ > best->priority_))
+                    best = &query;
+            }
+            if (!best)
+                break;
+
+            dtPolyRef startRef = 0;
+            dtPolyRef endRef = 0;
+            slot.query_->findNearestPoly(&best->localStart_.x_, &best->extents_.x_, queryFilter_.get(), &startRef, nullptr);
+            slot.query_->findNearestPoly(&best->localEnd_.x_, &best->extents_.x_, queryFilter_.get(), &endRef, nullptr);
+            if (!startRef || !endRef)
+            {
+                // Off-mesh end points complete immediately with an empty path
+                best->done_ = true;
+                continue;
+            }
+
+            slot.queryId_ = best->id_;
+            slot.endRef_ = endRef;
+            slot.status_ = slot.query_->initSlicedFindPath(startRef, endRef, &best->localStart_.x_, &best->localEnd_.x_,
+                queryFilter_.get());
+            best->slot_ = (int)slotIndex;
+        }
+    }
+
+    // Advance the sliced queries in parallel. Each slot owns its own Detour query object and only reads the navigation
+    // mesh, and the main thread blocks on completion, so no modification can overlap the search
+    if (queue && queue->GetNumThreads())
+    {
+        bool anyBusy = false;
+        for (unsigned i = 0; i < data.slots_.size(); ++i)
+        {
+            if (!data.slots_[i].queryId_ || !dtStatusInProgress(data.slots_[i].status_))
+                continue;
+
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = UpdatePathQuerySlotWork;
+            item->aux_ = nullptr;
+            item->start_ = &data.slots_[i];
+            queue->AddWorkItem(item);
+            anyBusy = true;
+        }
+
+        if (anyBusy)
+            queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (unsigned i = 0; i < data.slots_.size(); ++i)
+        {
+            if (data.slots_[i].queryId_ && dtStatusInProgress(data.slots_[i].status_))
+            {
+                int doneIterations = 0;
+                data.slots_[i].status_ = data.slots_[i].query_->updateSlicedFindPath(MAX_PATH_QUERY_ITERATIONS,
+                    &doneIterations);
+            }
+        }
+    }
+
+    // Finalize completed queries and free their slots. Slots whose query is still in progress keep it across frames
+    const Matrix3x4& transform = node_->GetWorldTransform();
+
+    for (unsigned slotIndex = 0; slotIndex < data.slots_.size(); ++slotIndex)
+    {
+        PathQuerySlot& slot = data.slots_[slotIndex];
+        if (!slot.queryId_ || dtStatusInProgress(slot.status_))
+            continue;
+
+        AsyncPathQuery* query = nullptr;
+        for (unsigned i = 0; i < data.queries_.size(); ++i)
+        {
+            if (data.queries_[i].id_ == slot.queryId_)
+            {
+                query = &data.queries_[i];
+                break;
+            }
+        }
+        slot.queryId_ = 0;
+        if (!query)
+            continue;
+
+        query->slot_ = -1;
+        query->done_ = true;
+
+        int numPolys = 0;
+        slot.query_->finalizeSlicedFindPath(slot.pathData_.polys_, &numPolys, MAX_POLYS);
+        if (dtStatusFailed(slot.status_) || !numPolys)
+            continue;
+
+        Vector3 actualLocalEnd = query->localEnd_;
+
+        // If full path was not found, clamp end point to the end polygon
+        if (slot.pathData_.polys_[numPolys - 1] != slot.endRef_)
+            slot.query_->closestPointOnPoly(slot.pathData_.polys_[numPolys - 1], &query->localEnd_.x_,
+                &actualLocalEnd.x_, nullptr);
+
+        int numPathPoints = 0;
+        slot.query_->findStraightPath(&query->localStart_.x_, &actualLocalEnd.x_, slot.pathData_.polys_, numPolys,
+            &slot.pathData_.pathPoints_[0].x_, slot.pathData_.pathFlags_, slot.pathData_.pathPolys_, &numPathPoints,
+            MAX_POLYS);
+
+        // Transform path result back to world space
+        for (int i = 0; i < numPathPoints; ++i)
+            query->path_.push_back(transform * slot.pathData_.pathPoints_[i]);
+    }
+}
+
+void NavigationMesh::ReleasePathQueries()
+{
+    AsyncPathData& data = *asyncPathData_;
+
+    for (unsigned i = 0; i < data.slots_.size(); ++i)
+        dtFreeNavMeshQuery(data.slots_[i].query_);
+    data.slots_.clear();
+
+    // Complete outstanding queries with empty paths, as their local space end points are no longer valid
+    for (unsigned i = 0; i < data.queries_.size(); ++i)
+    {
+        data.queries_[i].done_ = true;
+        data.queries_[i].slot_ = -1;
+        data.queries_[i].path_.clear();
+    }
+}
+
+void NavigationMesh::CancelBackgroundRebuild()
+{
+    queuedTiles_.clear();
+
+    if (backgroundCookItem_)
+    {
+        // Wait for the worker to finish with the build data before discarding it
+        while (!backgroundCookItem_->completed_)
+            Time::Sleep(0);
+
+        if (backgroundNavData_)
+            dtFree(backgroundNavData_);
+        backgroundNavData_ = nullptr;
+        backgroundNavDataSize_ = 0;
+        backgroundCookItem_.Reset();
+        backgroundBuild_.reset();
+        backgroundConfig_.reset();
+    }
+
+    backgroundGeometry_.clear();
+    UnsubscribeFromEvent(E_UPDATE);
+}
+
+void NavigationMesh::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    ProcessPathQueries();
+
+    if (backgroundCookItem_ && backgroundCookItem_->completed_)
+    {
+        if (backgroundCookSuccess_)
+            InstallTileData(backgroundTile_.x_, backgroundTile_.y_, backgroundNavData_, backgroundNavDataSize_);
+        backgroundNavData_ = nullptr;
+        backgroundNavDataSize_ = 0;
+        backgroundCookItem_.Reset();
+        backgroundBuild_.reset();
+        backgroundConfig_.reset();
+    }
+
+    if (!queuedTiles_.empty() && !backgroundCookItem_)
+        StartNextBackgroundTile();
+
+    if (queuedTiles_.empty() && !backgroundCookItem_ && !GetNumPendingPathQueries())
+    {
+        backgroundGeometry_.clear();
+        UnsubscribeFromEvent(E_UPDATE);
+    }
+}
+
 bool NavigationMesh::InitializeQuery()
 {
     if (!navMesh_ || !node_)
@@ -1568,17 +2321,41 @@ bool NavigationMesh::InitializeQuery()
 
 void NavigationMesh::ReleaseNavigationMesh()
 {
+    CancelBackgroundRebuild();
+    ReleasePathQueries();
+
     dtFreeNavMesh(navMesh_);
     navMesh_ = nullptr;
 
     dtFreeNavMeshQuery(navMeshQuery_);
     navMeshQuery_ = nullptr;
 
+    UnmapTileData();
+
     numTilesX_ = 0;
     numTilesZ_ = 0;
     boundingBox_.Clear();
 }
 
+void NavigationMesh::UnmapTileData()
+{
+    if (!mappedTileData_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedTileData_);
+    CloseHandle((HANDLE)mappedTileViewHandle_);
+    CloseHandle((HANDLE)mappedTileFileHandle_);
+    mappedTileViewHandle_ = nullptr;
+    mappedTileFileHandle_ = nullptr;
+#else
+    munmap(mappedTileData_, mappedTileSize_);
+#endif
+
+    mappedTileData_ = nullptr;
+    mappedTileSize_ = 0;
+}
+
 void NavigationMesh::SetPartitionType(NavmeshPartitionType partitionType)
 {
     partitionType_ = partitionType;
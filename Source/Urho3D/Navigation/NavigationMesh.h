@@ -39,6 +39,7 @@ using dtPolyRef = unsigned int;
 class dtNavMesh;
 class dtNavMeshQuery;
 class dtQueryFilter;
+struct rcConfig;
 
 namespace Urho3D
 {
@@ -52,8 +53,11 @@ enum NavmeshPartitionType
 class Geometry;
 class NavArea;
 
+struct AsyncPathData;
 struct FindPathData;
 struct NavBuildData;
+struct SimpleNavBuildData;
+struct WorkItem;
 
 /// Description of a navigation mesh geometry component, with transform and bounds information.
 struct NavigationGeometryInfo
@@ -144,6 +148,10 @@ public:
     virtual bool Build(const BoundingBox& boundingBox);
     /// Rebuild part of the navigation mesh in the rectangular area. Return true if successful.
     virtual bool Build(const IntVector2& from, const IntVector2& to);
+    /// Queue background rebuilds of the tiles overlapping a world-space bounding box, e.g. where Navigable geometry has changed. The tiles are re-cooked one at a time on a worker thread and swapped in on the main thread without blocking gameplay. The mesh must have been built fully once.
+    void QueueTileRebuilds(const BoundingBox& boundingBox);
+    /// Return number of tiles queued or in progress for background rebuild.
+    unsigned GetNumQueuedTileRebuilds() const;
     /// Return tile data.
     virtual ea::vector<unsigned char> GetTileData(const IntVector2& tile) const;
     /// Add tile to navigation mesh.
@@ -171,6 +179,18 @@ public:
     void FindPath
         (ea::vector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE,
             const dtQueryFilter* filter = nullptr);
+    /// Queue an asynchronous path query between world space points, processed in parallel on the work queue with the
+    /// cost amortized over frames. Higher priority queries are processed first. Return the query ID, or 0 on failure.
+    unsigned FindPathAsync(const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE, int priority = 0);
+    /// Return whether an asynchronous path query has completed.
+    bool IsPathQueryDone(unsigned queryId) const;
+    /// Retrieve and remove the result of a completed asynchronous path query. Return false and leave the destination
+    /// unmodified if the query is still pending or unknown. An unreachable end point yields an empty path.
+    bool GetPathQueryResult(unsigned queryId, ea::vector<Vector3>& dest);
+    /// Cancel an asynchronous path query.
+    void CancelPathQuery(unsigned queryId);
+    /// Return number of asynchronous path queries that have not completed yet.
+    unsigned GetNumPendingPathQueries() const;
     /// Return a random point on the navigation mesh.
     Vector3 GetRandomPoint(const dtQueryFilter* filter = nullptr, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -262,6 +282,13 @@ public:
     /// Return navigation data attribute.
     virtual ea::vector<unsigned char> GetNavigationDataAttr() const;
 
+    /// Save the navigation data to a standalone file with page-aligned tiles for memory-mapped loading. Return true if successful.
+    virtual bool SaveTileData(const ea::string& fileName) const;
+    /// Load navigation data from a file saved with SaveTileData. The file is memory-mapped copy-on-write and the tiles
+    /// are handed to Detour in place, so loading cost is proportional to the tile count instead of the data size.
+    /// Return true if successful.
+    virtual bool LoadTileData(const ea::string& fileName);
+
     /// Draw debug geometry for OffMeshConnection components.
     void SetDrawOffMeshConnections(bool enable) { drawOffMeshConnections_ = enable; }
 
@@ -279,6 +306,18 @@ private:
     void WriteTile(Serializer& dest, int x, int z) const;
     /// Read tile data to the navigation mesh.
     bool ReadTile(Deserializer& source, bool silent);
+    /// Release the memory mapping of the tile data file, if any. The navigation mesh must be freed first.
+    void UnmapTileData();
+    /// Start cooking the next queued background tile on a worker thread.
+    void StartNextBackgroundTile();
+    /// Advance the queued asynchronous path queries across the work queue threads and finalize completed ones.
+    void ProcessPathQueries();
+    /// Free the pooled path query objects and complete outstanding path queries with empty paths.
+    void ReleasePathQueries();
+    /// Wait for the in-flight background tile cook to finish, discard its output and clear the rebuild queue.
+    void CancelBackgroundRebuild();
+    /// Handle frame update. Poll the in-flight background tile cook and install finished tiles.
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
 
 protected:
     /// Collect geometry from under Navigable components.
@@ -291,6 +330,12 @@ protected:
     void AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform);
     /// Build one tile of the navigation mesh. Return true if successful.
     virtual bool BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z);
+    /// Collect a tile's geometry and set up the Recast build configuration. Must be called on the main thread. Return false if the tile contains no geometry.
+    bool PrepareTileBuild(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, SimpleNavBuildData& build, rcConfig& cfg);
+    /// Run the Recast pipeline on prepared tile geometry and create the Detour tile data. Thread-safe. The tile data is allocated with dtAlloc and ownership passes to the caller.
+    bool BuildTileData(SimpleNavBuildData& build, const rcConfig& cfg, int x, int z, unsigned char*& navData, int& navDataSize);
+    /// Replace a tile with freshly cooked tile data and send the area rebuilt event. Return true if successful.
+    bool InstallTileData(int x, int z, unsigned char* navData, int navDataSize);
     /// Build tiles in the rectangular area. Return number of built tiles.
     unsigned BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
     /// Ensure that the navigation mesh query is initialized. Return true if successful.
@@ -308,6 +353,8 @@ protected:
     ea::unique_ptr<dtQueryFilter> queryFilter_;
     /// Temporary data for finding a path.
     ea::unique_ptr<FindPathData> pathData_;
+    /// State of the asynchronous path queries.
+    ea::unique_ptr<AsyncPathData> asyncPathData_;
     /// Tile size.
     int tileSize_;
     /// Cell size.
@@ -352,6 +399,32 @@ protected:
     bool drawNavAreas_;
     /// NavAreas for this NavMesh.
     ea::vector<WeakPtr<NavArea> > areas_;
+    /// Tiles queued for background rebuild.
+    ea::vector<IntVector2> queuedTiles_;
+    /// Geometry snapshot used by the in-flight background tile cook.
+    ea::vector<NavigationGeometryInfo> backgroundGeometry_;
+    /// Build data of the in-flight background tile cook.
+    ea::unique_ptr<SimpleNavBuildData> backgroundBuild_;
+    /// Recast configuration of the in-flight background tile cook.
+    ea::unique_ptr<rcConfig> backgroundConfig_;
+    /// Work item of the in-flight background tile cook.
+    SharedPtr<WorkItem> backgroundCookItem_;
+    /// Coordinates of the in-flight background tile.
+    IntVector2 backgroundTile_;
+    /// Tile data produced by the in-flight background cook.
+    unsigned char* backgroundNavData_{};
+    /// Size of the tile data produced by the in-flight background cook.
+    int backgroundNavDataSize_{};
+    /// Result of the in-flight background cook.
+    volatile bool backgroundCookSuccess_{};
+    /// Memory mapping of the tile data file that Detour tiles point into, or null if not mapped.
+    unsigned char* mappedTileData_{};
+    /// Size of the tile data mapping.
+    unsigned mappedTileSize_{};
+    /// File handle of the tile data mapping (Windows only).
+    void* mappedTileFileHandle_{};
+    /// File mapping handle of the tile data mapping (Windows only).
+    void* mappedTileViewHandle_{};
 };
 
 /// Register Navigation library objects.
@@ -23,7 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
+#include "../Graphics/Octree.h"
+#include "../Graphics/OctreeQuery.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -58,6 +61,9 @@ namespace Urho3D
 
 static const int STATS_INTERVAL_MSEC = 2000;
 
+/// Guards the nodes' and components' shared replication state lists while server updates for several connections are built in parallel.
+static Mutex replicationStateMutex;
+
 PackageDownload::PackageDownload() :
     totalFragments_(0),
     checksum_(0),
@@ -66,8 +72,12 @@ PackageDownload::PackageDownload() :
 }
 
 PackageUpload::PackageUpload() :
+    rangeIndex_(0),
     fragment_(0),
-    totalFragments_(0)
+    totalFragments_(0),
+    chunkSize_(0),
+    coveredSize_(0),
+    started_(false)
 {
 }
 
@@ -75,7 +85,15 @@ Connection::Connection(Context* context) :
     Object(context),
     timeStamp_(0),
     peer_(nullptr),
+    sendBufferIndex_(0),
     sendMode_(OPSM_NONE),
+    relevancyRadius_(0.0f),
+    sendRateScale_(1.0f),
+    updateRateAcc_(1.0f),
+    packetAggregation_(false),
+    adaptiveUpdateRate_(false),
+    aggregating_(false),
+    deferSends_(false),
     isClient_(false),
     connectPending_(false),
     sceneLoaded_(false),
@@ -121,18 +139,51 @@ void Connection::SendMessage(int msgID, bool reliable, bool inOrder, const unsig
         URHO3D_LOGERROR("Null pointer supplied for network message data");
         return;
     }
-    
-    VectorBuffer buffer;
-    buffer.WriteUByte((unsigned char)DefaultMessageIDTypes::ID_USER_PACKET_ENUM);
-    buffer.WriteUInt((unsigned int)msgID);
-    buffer.Write(data, numBytes);
+
+    // While the server update is being built on a worker thread, queue the message for the serial send phase
+    if (deferSends_)
+    {
+        deferredMessages_.resize(deferredMessages_.size() + 1);
+        QueuedMessage& queued = deferredMessages_.back();
+        queued.msgID_ = msgID;
+        queued.contentID_ = contentID;
+        queued.inOrder_ = inOrder;
+        queued.reliable_ = reliable;
+        queued.data_.assign(data, data + numBytes);
+        return;
+    }
+
+    // While an aggregated send is in progress, divert qualifying messages into the aggregation buffers instead
+    // of emitting one datagram each. Reliable unordered messages are upgraded to ordered and sequenced messages
+    // downgraded to plain unreliable delivery by sharing the aggregated datagram
+    if (aggregating_ && IsAggregatable(msgID))
+    {
+        AggregateMessage(reliable ? reliableAggregate_ : unreliableAggregate_, reliable, msgID, data, numBytes);
+        return;
+    }
+
     PacketReliability reliability = reliable ? (inOrder ? RELIABLE_ORDERED : RELIABLE) : (inOrder ? UNRELIABLE_SEQUENCED : UNRELIABLE);
     if (peer_) {
-        peer_->Send((const char *) buffer.GetData(), (int) buffer.GetSize(), HIGH_PRIORITY, reliability, (char) 0, *address_, false);
+        // Gather the header and the payload directly into the outgoing packet instead of concatenating them
+        // into a transient buffer first
+        unsigned char header[5];
+        header[0] = (unsigned char)DefaultMessageIDTypes::ID_USER_PACKET_ENUM;
+        memcpy(&header[1], &msgID, sizeof(unsigned));
+        const char* buffers[2] = { (const char*)header, (const char*)data };
+        const int lengths[2] = { (int)sizeof(header), (int)numBytes };
+        peer_->SendList(buffers, lengths, numBytes ? 2 : 1, HIGH_PRIORITY, reliability, (char) 0, *address_, false);
         tempPacketCounter_.y_++;
     }
 }
 
+VectorBuffer& Connection::AcquireSendBuffer()
+{
+    VectorBuffer& buffer = sendBuffers_[sendBufferIndex_];
+    sendBufferIndex_ = (sendBufferIndex_ + 1) % (sizeof(sendBuffers_) / sizeof(sendBuffers_[0]));
+    buffer.Clear();
+    return buffer;
+}
+
 void Connection::SendRemoteEvent(StringHash eventType, bool inOrder, const VariantMap& eventData)
 {
     RemoteEvent queuedEvent;
@@ -245,6 +296,115 @@ void Connection::SetLogStatistics(bool enable)
     logStatistics_ = enable;
 }
 
+void Connection::SetRelevancyRadius(float radius)
+{
+    relevancyRadius_ = Max(radius, 0.0f);
+    if (relevancyRadius_ <= 0.0f)
+        relevantNodes_.clear();
+}
+
+void Connection::SetPacketAggregation(bool enable)
+{
+    packetAggregation_ = enable;
+}
+
+void Connection::SetAdaptiveUpdateRate(bool enable)
+{
+    adaptiveUpdateRate_ = enable;
+    if (!enable)
+    {
+        sendRateScale_ = 1.0f;
+        updateRateAcc_ = 1.0f;
+    }
+}
+
+void Connection::BeginAggregatedSend()
+{
+    if (!packetAggregation_)
+        return;
+
+    reliableAggregate_.Clear();
+    unreliableAggregate_.Clear();
+    aggregating_ = true;
+}
+
+void Connection::EndAggregatedSend()
+{
+    if (!aggregating_)
+        return;
+
+    aggregating_ = false;
+    FlushAggregationBuffer(reliableAggregate_, true);
+    FlushAggregationBuffer(unreliableAggregate_, false);
+}
+
+void Connection::BeginDeferredSend()
+{
+    deferredMessages_.clear();
+    deferSends_ = true;
+}
+
+void Connection::EndDeferredSend()
+{
+    if (!deferSends_)
+        return;
+
+    deferSends_ = false;
+    for (auto i = deferredMessages_.begin(); i != deferredMessages_.end(); ++i)
+        SendMessage(i->msgID_, i->reliable_, i->inOrder_, i->data_.data(), i->data_.size(), i->contentID_);
+    deferredMessages_.clear();
+}
+
+bool Connection::IsAggregatable(int msgID)
+{
+    // Scene replication, remote events and controls are all produced within one network update and can share a
+    // datagram. Handshake and package transfer messages keep their own packets
+    return (msgID >= MSG_CREATENODE && msgID <= MSG_REMOVECOMPONENT) || msgID == MSG_REMOTEEVENT ||
+        msgID == MSG_REMOTENODEEVENT || msgID == MSG_CONTROLS;
+}
+
+void Connection::AggregateMessage(VectorBuffer& buffer, bool reliable, int msgID, const unsigned char* data, unsigned numBytes)
+{
+    // Flush early when the soft payload limit would be exceeded, so that the datagram stays within a typical MTU
+    if (buffer.GetSize() && buffer.GetSize() + numBytes + 5 > AGGREGATED_MESSAGE_LIMIT)
+        FlushAggregationBuffer(buffer, reliable);
+
+    buffer.WriteUByte((unsigned char)msgID);
+    buffer.WriteVLE(numBytes);
+    buffer.Write(data, numBytes);
+}
+
+void Connection::FlushAggregationBuffer(VectorBuffer& buffer, bool reliable)
+{
+    if (!buffer.GetSize())
+        return;
+
+    // MSG_AGGREGATEDUPDATE itself is not aggregatable, so this sends immediately even during an aggregated send
+    SendMessage(MSG_AGGREGATEDUPDATE, reliable, reliable, buffer);
+    buffer.Clear();
+}
+
+void Connection::UpdateSendRateScale()
+{
+    float packetLoss = 0.0f;
+    if (peer_)
+    {
+        SLNet::RakNetStatistics stats{};
+        if (peer_->GetStatistics(address_->systemAddress, &stats))
+            packetLoss = stats.packetlossLastSecond;
+    }
+
+    // Full rate until ~150 ms round trip, then inversely proportional to latency; packet loss cuts the rate
+    // further. Never drop below a quarter of the configured update rate, so that a congested client still
+    // receives regular updates
+    const float rtt = GetRoundTripTime();
+    float target = Clamp(150.0f / Max(rtt, 1.0f), 0.25f, 1.0f);
+    target *= Clamp(1.0f - 4.0f * packetLoss, 0.25f, 1.0f);
+
+    // Approach the target gradually to avoid oscillating along with the measurement
+    sendRateScale_ = Clamp(Lerp(sendRateScale_, target, 0.5f), 0.25f, 1.0f);
+}
+
 void Connection::Disconnect(int waitMSec)
 {
     peer_->CloseConnection(*address_, true);
@@ -255,6 +415,27 @@ void Connection::SendServerUpdate()
     if (!scene_ || !sceneLoaded_)
         return;
 
+    // Scale the replication frequency for this client by the measured link quality, accumulating sub-unity
+    // rates like the NetworkPriority component does. Skipped updates leave the dirty sets intact, so the next
+    // sent update naturally coalesces the changes
+    if (adaptiveUpdateRate_)
+    {
+        if (sendRateTimer_.GetMSec(false) >= 1000)
+        {
+            sendRateTimer_.Reset();
+            UpdateSendRateScale();
+        }
+
+        updateRateAcc_ += sendRateScale_;
+        if (updateRateAcc_ < 1.0f)
+            return;
+        updateRateAcc_ -= 1.0f;
+    }
+
+    // Refresh the relevancy set once per update so that nodes outside the radius can be skipped cheaply
+    if (relevancyRadius_ > 0.0f)
+        UpdateRelevancySet();
+
     // Always check the root node (scene) first so that the scene-wide components get sent first,
     // and all other replicated nodes get added to the dirty set for sending the initial state
     unsigned sceneID = scene_->GetID();
@@ -344,28 +525,48 @@ void Connection::SendRemoteEvents()
 
 void Connection::SendPackages()
 {
-    while (!uploads_.empty())
+    for (;;)
     {
         unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
+        bool sentData = false;
 
         for (auto i = uploads_.begin(); i != uploads_.end();)
         {
             auto current = i++;
             PackageUpload& upload = current->second;
+
+            // Wait until the client has confirmed which chunks it needs
+            if (!upload.started_)
+                continue;
+
+            // Fragments are not necessarily contiguous when delta patching, so seek explicitly
+            upload.file_->Seek(upload.fragment_ * PACKAGE_FRAGMENT_SIZE);
             auto fragmentSize =
                 (unsigned)Min((int)(upload.file_->GetSize() - upload.file_->GetPosition()), (int)PACKAGE_FRAGMENT_SIZE);
             upload.file_->Read(buffer, fragmentSize);
 
             msg_.Clear();
             msg_.WriteStringHash(current->first);
-            msg_.WriteUInt(upload.fragment_++);
+            msg_.WriteUInt(upload.fragment_);
             msg_.Write(buffer, fragmentSize);
             SendMessage(MSG_PACKAGEDATA, true, false, msg_);
+            sentData = true;
 
-            // Check if upload finished
-            if (upload.fragment_ == upload.totalFragments_)
-                uploads_.erase(current);
+            // Advance to the next fragment in the current range, or to the next range
+            if (upload.fragment_ < upload.ranges_[upload.rangeIndex_].second)
+                ++upload.fragment_;
+            else
+            {
+                ++upload.rangeIndex_;
+                if (upload.rangeIndex_ == upload.ranges_.size())
+                    uploads_.erase(current);
+                else
+                    upload.fragment_ = upload.ranges_[upload.rangeIndex_].first;
+            }
         }
+
+        if (!sentData)
+            break;
     }
 }
 
@@ -429,6 +630,8 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& msg)
 
     case MSG_REQUESTPACKAGE:
     case MSG_PACKAGEDATA:
+    case MSG_PACKAGECHUNKHASHES:
+    case MSG_REQUESTPACKAGECHUNKS:
         ProcessPackageDownload(msgID, msg);
         break;
 
@@ -460,6 +663,10 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& msg)
         ProcessPackageInfo(msgID, msg);
         break;
 
+    case MSG_AGGREGATEDUPDATE:
+        ProcessAggregatedUpdate(msgID, msg);
+        break;
+
     default:
         processed = false;
         break;
@@ -792,9 +999,42 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
 
                     URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
 
-                    uploads_[nameHash].file_ = file;
-                    uploads_[nameHash].fragment_ = 0;
-                    uploads_[nameHash].totalFragments_ = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+                    PackageUpload& upload = uploads_[nameHash];
+                    upload.file_ = file;
+                    upload.totalFragments_ = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+
+                    // Send the content chunk digest first and wait for the client to confirm which chunks it
+                    // needs, so an older cached version can be delta patched instead of fully re-downloaded.
+                    // Use the chunk index embedded in the package if present, else hash the file contents now
+                    ea::vector<unsigned> chunkHashes = package->GetChunkHashes();
+                    upload.chunkSize_ = package->GetChunkSize();
+                    upload.coveredSize_ = package->GetChunkCoveredSize();
+                    if (!package->HasChunkIndex())
+                    {
+                        upload.chunkSize_ = PACKAGE_CHUNK_SIZE;
+                        upload.coveredSize_ = file->GetSize();
+                        ea::unique_ptr<unsigned char[]> chunkBuffer(new unsigned char[PACKAGE_CHUNK_SIZE]);
+                        chunkHashes.resize((upload.coveredSize_ + PACKAGE_CHUNK_SIZE - 1) / PACKAGE_CHUNK_SIZE);
+                        for (unsigned j = 0; j < chunkHashes.size(); ++j)
+                        {
+                            unsigned chunkBytes = Min(PACKAGE_CHUNK_SIZE, upload.coveredSize_ - j * PACKAGE_CHUNK_SIZE);
+                            file->Seek(j * PACKAGE_CHUNK_SIZE);
+                            file->Read(chunkBuffer.get(), chunkBytes);
+                            unsigned hash = 0;
+                            for (unsigned k = 0; k < chunkBytes; ++k)
+                                hash = SDBMHash(hash, chunkBuffer[k]);
+                            chunkHashes[j] = hash;
+                        }
+                    }
+
+                    msg_.Clear();
+                    msg_.WriteStringHash(nameHash);
+                    msg_.WriteUInt(upload.chunkSize_);
+                    msg_.WriteUInt(upload.coveredSize_);
+                    msg_.WriteVLE(chunkHashes.size());
+                    for (unsigned j = 0; j < chunkHashes.size(); ++j)
+                        msg_.WriteUInt(chunkHashes[j]);
+                    SendMessage(MSG_PACKAGECHUNKHASHES, true, true, msg_);
                     return;
                 }
             }
@@ -881,6 +1121,160 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
         }
         break;
 
+    case MSG_PACKAGECHUNKHASHES:
+        if (IsClient())
+        {
+            URHO3D_LOGWARNING("Received unexpected PackageChunkHashes message from client");
+            return;
+        }
+        else
+        {
+            StringHash nameHash = msg.ReadStringHash();
+
+            auto i = downloads_.find(nameHash);
+            if (i == downloads_.end())
+                return;
+
+            PackageDownload& download = i->second;
+            unsigned chunkSize = msg.ReadUInt();
+            unsigned coveredSize = msg.ReadUInt();
+            unsigned numChunks = msg.ReadVLE();
+            ea::vector<unsigned> chunkHashes(numChunks);
+            for (unsigned j = 0; j < numChunks; ++j)
+                chunkHashes[j] = msg.ReadUInt();
+
+            // Open the destination file now. Prepend the checksum to the filename to allow multiple versions
+            if (!download.file_)
+            {
+                download.file_ = new File(context_,
+                    GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" + download.name_,
+                    FILE_WRITE);
+                if (!download.file_->IsOpen())
+                {
+                    OnPackageDownloadFailed(download.name_);
+                    return;
+                }
+            }
+
+            // Build a content-addressed map of aligned chunk hashes from older cached versions of the same package
+            ea::unordered_map<unsigned, ea::pair<File*, unsigned> > localChunks;
+            ea::vector<SharedPtr<File> > oldFiles;
+            ea::unique_ptr<unsigned char[]> chunkBuffer(new unsigned char[chunkSize]);
+
+            const ea::string& packageCacheDir = GetSubsystem<Network>()->GetPackageCacheDir();
+            ea::string checksumString = ToStringHex(download.checksum_);
+            ea::vector<ea::string> cacheFiles;
+            if (chunkSize >= PACKAGE_FRAGMENT_SIZE && !packageCacheDir.empty())
+                GetSubsystem<FileSystem>()->ScanDir(cacheFiles, packageCacheDir, "*.*", SCAN_FILES, false);
+
+            for (unsigned j = 0; j < cacheFiles.size(); ++j)
+            {
+                const ea::string& fileName = cacheFiles[j];
+                // In download cache, package file name format is checksum_packagename. Skip the version being downloaded
+                if (fileName.find(checksumString) == 0 || fileName.length() < 9 || fileName.substr(9).comparei(download.name_))
+                    continue;
+
+                SharedPtr<File> oldFile(new File(context_, packageCacheDir + fileName));
+                if (!oldFile->IsOpen())
+                    continue;
+                oldFiles.push_back(oldFile);
+
+                // Hash only full-size chunks; partial trailing chunks are downloaded from the server
+                for (unsigned offset = 0; offset + chunkSize <= oldFile->GetSize(); offset += chunkSize)
+                {
+                    oldFile->Seek(offset);
+                    oldFile->Read(chunkBuffer.get(), chunkSize);
+                    unsigned hash = 0;
+                    for (unsigned k = 0; k < chunkSize; ++k)
+                        hash = SDBMHash(hash, chunkBuffer[k]);
+                    if (!localChunks.contains(hash))
+                        localChunks[hash] = ea::make_pair(oldFile.Get(), offset);
+                }
+            }
+
+            // Copy chunks found locally into the destination file and request the rest from the server
+            ea::vector<unsigned> neededChunks;
+            for (unsigned c = 0; c < numChunks; ++c)
+            {
+                unsigned chunkStart = c * chunkSize;
+                unsigned chunkBytes = Min(chunkSize, coveredSize - chunkStart);
+                auto j = chunkBytes == chunkSize ? localChunks.find(chunkHashes[c]) : localChunks.end();
+                if (j != localChunks.end())
+                {
+                    File* oldFile = j->second.first;
+                    oldFile->Seek(j->second.second);
+                    oldFile->Read(chunkBuffer.get(), chunkBytes);
+                    download.file_->Seek(chunkStart);
+                    download.file_->Write(chunkBuffer.get(), chunkBytes);
+
+                    for (unsigned f = chunkStart / PACKAGE_FRAGMENT_SIZE; f < (chunkStart + chunkBytes) / PACKAGE_FRAGMENT_SIZE; ++f)
+                        download.receivedFragments_.insert(f);
+                }
+                else
+                    neededChunks.push_back(c);
+            }
+
+            if (neededChunks.size() < numChunks)
+            {
+                URHO3D_LOGINFO("Delta patching package " + download.name_ + ": reusing " +
+                    ea::to_string(numChunks - neededChunks.size()) + " of " + ea::to_string(numChunks) + " chunks");
+            }
+
+            msg_.Clear();
+            msg_.WriteStringHash(nameHash);
+            msg_.WriteVLE(neededChunks.size());
+            for (unsigned j = 0; j < neededChunks.size(); ++j)
+                msg_.WriteVLE(neededChunks[j]);
+            SendMessage(MSG_REQUESTPACKAGECHUNKS, true, true, msg_);
+        }
+        break;
+
+    case MSG_REQUESTPACKAGECHUNKS:
+        if (!IsClient())
+        {
+            URHO3D_LOGWARNING("Received unexpected RequestPackageChunks message from server");
+            return;
+        }
+        else
+        {
+            StringHash nameHash = msg.ReadStringHash();
+
+            auto i = uploads_.find(nameHash);
+            if (i == uploads_.end() || i->second.started_)
+                return;
+
+            PackageUpload& upload = i->second;
+            unsigned fragmentsPerChunk = Max(upload.chunkSize_ / PACKAGE_FRAGMENT_SIZE, 1U);
+            unsigned numChunks = msg.ReadVLE();
+
+            // Convert the requested chunks into fragment ranges, merging adjacent ones
+            for (unsigned j = 0; j < numChunks; ++j)
+            {
+                unsigned chunk = msg.ReadVLE();
+                unsigned first = chunk * fragmentsPerChunk;
+                if (first >= upload.totalFragments_)
+                    continue;
+                unsigned last = Min(first + fragmentsPerChunk - 1, upload.totalFragments_ - 1);
+                if (!upload.ranges_.empty() && first <= upload.ranges_.back().second + 1)
+                    upload.ranges_.back().second = Max(upload.ranges_.back().second, last);
+                else
+                    upload.ranges_.push_back(ea::make_pair(first, last));
+            }
+
+            // Always send the tail not covered by the chunk hashes (e.g. the chunk index itself), which also
+            // guarantees at least one fragment so the client can finalize the download
+            unsigned tailFirst = Min(upload.coveredSize_ / PACKAGE_FRAGMENT_SIZE, upload.totalFragments_ - 1);
+            if (!upload.ranges_.empty() && tailFirst <= upload.ranges_.back().second + 1)
+                upload.ranges_.back().second = upload.totalFragments_ - 1;
+            else
+                upload.ranges_.push_back(ea::make_pair(tailFirst, upload.totalFragments_ - 1));
+
+            upload.rangeIndex_ = 0;
+            upload.fragment_ = upload.ranges_[0].first;
+            upload.started_ = true;
+        }
+        break;
+
     default: break;
     }
 }
@@ -1011,6 +1405,26 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
     }
 }
 
+void Connection::ProcessAggregatedUpdate(int msgID, MemoryBuffer& msg)
+{
+    // Dispatch the coalesced messages in order. Each entry is a message ID byte, a VLE payload size and the payload
+    while (!msg.IsEof())
+    {
+        const int subMsgID = msg.ReadUByte();
+        const unsigned size = msg.ReadVLE();
+        if (msg.GetPosition() + size > msg.GetSize())
+        {
+            URHO3D_LOGWARNING("Truncated entry in aggregated update from " + ToString() + ", discarding the rest");
+            return;
+        }
+
+        MemoryBuffer subMsg(msg.GetData() + msg.GetPosition(), size);
+        msg.Seek(msg.GetPosition() + size);
+        if (!ProcessMessage(subMsgID, subMsg))
+            URHO3D_LOGWARNING("Unknown message ID " + ea::to_string(subMsgID) + " in aggregated update from " + ToString());
+    }
+}
+
 Scene* Connection::GetScene() const
 {
     return scene_;
@@ -1167,7 +1581,7 @@ void Connection::ProcessNode(unsigned nodeID)
             SendMessage(MSG_REMOVENODE, true, true, msg_);
             sceneState_.nodeStates_.erase(nodeID);
         }
-        else
+        else if (IsNodeRelevant(node))
             ProcessExistingNode(node, i->second);
     }
     else
@@ -1175,7 +1589,11 @@ void Connection::ProcessNode(unsigned nodeID)
         // Replication state not found: this is a new node
         Node* node = scene_->GetNode(nodeID);
         if (node)
-            ProcessNewNode(node);
+        {
+            // Defer creation of irrelevant nodes; the node stays in the dirty set and will be sent when it enters the radius
+            if (IsNodeRelevant(node))
+                ProcessNewNode(node);
+        }
         else
         {
             // Did not find the new node (may have been created, then removed immediately): erase from dirty set.
@@ -1202,7 +1620,11 @@ void Connection::ProcessNewNode(Node* node)
     nodeState.connection_ = this;
     nodeState.sceneState_ = &sceneState_;
     nodeState.node_ = node;
-    node->AddReplicationState(&nodeState);
+    {
+        // The node's replication state list is shared between connections, which may build their updates in parallel
+        MutexLock lock(replicationStateMutex);
+        node->AddReplicationState(&nodeState);
+    }
 
     // Write node's attributes
     node->WriteInitialDeltaUpdate(msg_, timeStamp_);
@@ -1230,7 +1652,10 @@ void Connection::ProcessNewNode(Node* node)
         componentState.connection_ = this;
         componentState.nodeState_ = &nodeState;
         componentState.component_ = component;
-        component->AddReplicationState(&componentState);
+        {
+            MutexLock lock(replicationStateMutex);
+            component->AddReplicationState(&componentState);
+        }
 
         msg_.WriteStringHash(component->GetType());
         msg_.WriteNetID(component->GetID());
@@ -1260,7 +1685,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
     if (priority && (!priority->GetAlwaysUpdateOwner() || node->GetOwner() != this))
     {
         float distance = (node->GetWorldPosition() - position_).Length();
-        if (!priority->CheckUpdate(distance, nodeState.priorityAcc_))
+        if (!priority->CheckUpdate(distance, nodeState.priorityAcc_, sendRateScale_))
             return;
     }
 
@@ -1403,7 +1828,11 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 componentState.connection_ = this;
                 componentState.nodeState_ = &nodeState;
                 componentState.component_ = component;
-                component->AddReplicationState(&componentState);
+                {
+                    // The component's replication state list is shared between connections
+                    MutexLock lock(replicationStateMutex);
+                    component->AddReplicationState(&componentState);
+                }
 
                 msg_.Clear();
                 msg_.WriteNetID(node->GetID());
@@ -1420,6 +1849,66 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
     sceneState_.dirtyNodes_.erase(node->GetID());
 }
 
+void Connection::UpdateRelevancySet()
+{
+    URHO3D_PROFILE("UpdateRelevancySet");
+
+    relevantNodes_.clear();
+
+    auto* octree = scene_->GetComponent<Octree>();
+    if (!octree)
+        return;
+
+    ea::vector<Drawable*> result;
+    SphereOctreeQuery query(result, Sphere(position_, relevancyRadius_));
+    octree->GetDrawables(query);
+
+    // Collect the nodes of the in-radius drawables, then pull in their dependencies (parent chains and
+    // component dependencies) so that creation messages never reference a node the client has not received
+    ea::vector<Node*> workList;
+    for (auto i = result.begin(); i != result.end(); ++i)
+    {
+        Node* node = (*i)->GetNode();
+        if (node->IsReplicated() && relevantNodes_.insert(node->GetID()).second)
+            workList.push_back(node);
+    }
+
+    while (workList.size())
+    {
+        Node* node = workList.back();
+        workList.pop_back();
+
+        for (Node* parent = node->GetParent(); parent && parent != scene_; parent = parent->GetParent())
+        {
+            if (parent->IsReplicated() && relevantNodes_.insert(parent->GetID()).second)
+                workList.push_back(parent);
+        }
+
+        const ea::vector<Node*>& dependencyNodes = node->GetDependencyNodes();
+        for (auto i = dependencyNodes.begin(); i != dependencyNodes.end(); ++i)
+        {
+            if ((*i)->IsReplicated() && relevantNodes_.insert((*i)->GetID()).second)
+                workList.push_back(*i);
+        }
+    }
+}
+
+bool Connection::IsNodeRelevant(Node* node) const
+{
+    if (relevancyRadius_ <= 0.0f)
+        return true;
+
+    // The scene root and the connection's own nodes are always relevant
+    if (node == scene_ || node->GetOwner() == this)
+        return true;
+
+    if (relevantNodes_.contains(node->GetID()))
+        return true;
+
+    // Nodes without drawable geometry have no extent in the octree and can not be queried spatially; replicate them always
+    return node->GetDerivedComponent<Drawable>() == nullptr;
+}
+
 bool Connection::RequestNeededPackages(unsigned numPackages, MemoryBuffer& msg)
 {
     auto* cache = GetSubsystem<ResourceCache>();
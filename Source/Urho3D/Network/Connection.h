@@ -93,10 +93,35 @@ struct PackageUpload
 
     /// Source file.
     SharedPtr<File> file_;
+    /// Fragment ranges to send (first and last fragment index, inclusive). Filled in once the client has confirmed which chunks it needs.
+    ea::vector<ea::pair<unsigned, unsigned> > ranges_;
+    /// Index of the current fragment range.
+    unsigned rangeIndex_;
     /// Current fragment index.
     unsigned fragment_;
     /// Total number of fragments.
     unsigned totalFragments_;
+    /// Size of the hashed content chunks.
+    unsigned chunkSize_;
+    /// Amount of bytes from the start of the package covered by the chunk hashes.
+    unsigned coveredSize_;
+    /// Whether the client has confirmed which chunks it needs and sending may proceed.
+    bool started_;
+};
+
+/// Outgoing message queued while sends are deferred during parallel server update construction.
+struct QueuedMessage
+{
+    /// Message ID.
+    int msgID_;
+    /// Content ID.
+    unsigned contentID_;
+    /// In order flag.
+    bool inOrder_;
+    /// Reliable flag.
+    bool reliable_;
+    /// Message payload.
+    ea::vector<unsigned char> data_;
 };
 
 /// Send modes for observer position/rotation. Activated by the client setting either position or rotation.
@@ -127,6 +152,8 @@ public:
     void SendMessage(int msgID, bool reliable, bool inOrder, const VectorBuffer& msg, unsigned contentID = 0);
     /// Send a message.
     void SendMessage(int msgID, bool reliable, bool inOrder, const unsigned char* data, unsigned numBytes, unsigned contentID = 0);
+    /// Acquire a pooled reusable buffer for building an outgoing message, to avoid transient allocations. The buffer stays valid until the ring of pooled buffers wraps around, so send the message before acquiring several more.
+    VectorBuffer& AcquireSendBuffer();
     /// Send a remote event.
     void SendRemoteEvent(StringHash eventType, bool inOrder, const VariantMap& eventData = Variant::emptyVariantMap);
     /// Send a remote event with the specified node as sender.
@@ -145,6 +172,12 @@ public:
     void SetConnectPending(bool connectPending);
     /// Set whether to log data in/out statistics.
     void SetLogStatistics(bool enable);
+    /// Set the radius around the observer position within which nodes are relevant and replicated. 0 (default) disables the relevancy check. Called on the server.
+    void SetRelevancyRadius(float radius);
+    /// Set whether to coalesce the scene replication, remote event and controls messages of a network update into aggregated datagrams, to reduce per-packet header overhead. Changes the wire format, so the remote end must understand MSG_AGGREGATEDUPDATE.
+    void SetPacketAggregation(bool enable);
+    /// Set whether to scale down the replication update rate for this connection based on measured round trip time and packet loss. Used on the server.
+    void SetAdaptiveUpdateRate(bool enable);
     /// Disconnect. If wait time is non-zero, will block while waiting for disconnect to finish.
     void Disconnect(int waitMSec = 0);
     /// Send scene update messages. Called by Network.
@@ -155,6 +188,14 @@ public:
     void SendRemoteEvents();
     /// Send package files to client. Called by network.
     void SendPackages();
+    /// Begin coalescing qualifying outgoing messages into aggregated datagrams. Called by Network before the update sends. No-op when packet aggregation is disabled.
+    void BeginAggregatedSend();
+    /// Send the aggregated datagrams built since BeginAggregatedSend(). Called by Network after the update sends.
+    void EndAggregatedSend();
+    /// Begin queuing outgoing messages instead of sending, so that the server update may be built on a worker thread. Called by Network.
+    void BeginDeferredSend();
+    /// Send the messages queued since BeginDeferredSend() in order. Called by Network on the main thread.
+    void EndDeferredSend();
     /// Process pending latest data for nodes and components.
     void ProcessPendingLatestData();
     /// Process a message from the server or client. Called by Network.
@@ -199,6 +240,18 @@ public:
     /// Return whether to log data in/out statistics.
     bool GetLogStatistics() const { return logStatistics_; }
 
+    /// Return the relevancy radius for interest management.
+    float GetRelevancyRadius() const { return relevancyRadius_; }
+
+    /// Return whether packet aggregation is enabled.
+    bool GetPacketAggregation() const { return packetAggregation_; }
+
+    /// Return whether the adaptive update rate is enabled.
+    bool GetAdaptiveUpdateRate() const { return adaptiveUpdateRate_; }
+
+    /// Return the current replication update rate scale. 1 when the link is healthy or the adaptive update rate is disabled.
+    float GetSendRateScale() const { return sendRateScale_; }
+
     /// Return remote address.
     ea::string GetAddress() const;
 
@@ -263,12 +316,26 @@ private:
     void ProcessSceneLoaded(int msgID, MemoryBuffer& msg);
     /// Process a remote event message from the client or server. Called by Network.
     void ProcessRemoteEvent(int msgID, MemoryBuffer& msg);
+    /// Process an aggregated update message by dispatching the coalesced messages within, in order.
+    void ProcessAggregatedUpdate(int msgID, MemoryBuffer& msg);
+    /// Return whether a message may be moved into an aggregated datagram.
+    static bool IsAggregatable(int msgID);
+    /// Append a message to an aggregation buffer, flushing the buffer first if the soft payload limit would be exceeded.
+    void AggregateMessage(VectorBuffer& buffer, bool reliable, int msgID, const unsigned char* data, unsigned numBytes);
+    /// Send the contents of an aggregation buffer as a single MSG_AGGREGATEDUPDATE message and clear it.
+    void FlushAggregationBuffer(VectorBuffer& buffer, bool reliable);
+    /// Recompute the update rate scale from the measured round trip time and packet loss.
+    void UpdateSendRateScale();
     /// Process a node for sending a network update. Recurses to process depended on node(s) first.
     void ProcessNode(unsigned nodeID);
     /// Process a node that the client has not yet received.
     void ProcessNewNode(Node* node);
     /// Process a node that the client has already received.
     void ProcessExistingNode(Node* node, NodeReplicationState& nodeState);
+    /// Rebuild the set of relevant node ID's from an octree query around the observer position.
+    void UpdateRelevancySet();
+    /// Return whether a node should be replicated to this connection. Always true when the relevancy check is disabled.
+    bool IsNodeRelevant(Node* node) const;
     /// Process a SyncPackagesInfo message from server.
     void ProcessPackageInfo(int msgID, MemoryBuffer& msg);
     /// Check a package list received from server and initiate package downloads as necessary. Return true on success, or false if failed to initialze downloads (cache dir not set).
@@ -298,8 +365,20 @@ private:
     ea::unordered_map<unsigned, ea::vector<unsigned char> > componentLatestData_;
     /// Node ID's to process during a replication update.
     ea::hash_set<unsigned> nodesToProcess_;
+    /// Node ID's inside the relevancy radius, plus their dependencies.
+    ea::hash_set<unsigned> relevantNodes_;
     /// Reusable message buffer.
     VectorBuffer msg_;
+    /// Ring of pooled send buffers handed out by AcquireSendBuffer. Capacity is retained across messages.
+    VectorBuffer sendBuffers_[8];
+    /// Index of the next pooled send buffer to hand out.
+    unsigned sendBufferIndex_;
+    /// Aggregation buffer for reliable messages while an aggregated send is in progress.
+    VectorBuffer reliableAggregate_;
+    /// Aggregation buffer for unreliable messages while an aggregated send is in progress.
+    VectorBuffer unreliableAggregate_;
+    /// Messages queued while sends are deferred during parallel server update construction.
+    ea::vector<QueuedMessage> deferredMessages_;
     /// Queued remote events.
     ea::vector<RemoteEvent> remoteEvents_;
     /// Scene file to load once all packages (if any) have been downloaded.
@@ -314,6 +393,22 @@ private:
     Quaternion rotation_;
     /// Send mode for the observer position & rotation.
     ObserverPositionSendMode sendMode_;
+    /// Relevancy radius around the observer position. 0 disables the relevancy check.
+    float relevancyRadius_;
+    /// Replication update rate scale derived from the measured round trip time and packet loss. 1 = full rate.
+    float sendRateScale_;
+    /// Accumulator for scaling the replication update rate, in the manner of the NetworkPriority accumulator. An update is sent whenever it reaches 1.
+    float updateRateAcc_;
+    /// Timer for recomputing the update rate scale.
+    Timer sendRateTimer_;
+    /// Packet aggregation flag.
+    bool packetAggregation_;
+    /// Adaptive update rate flag.
+    bool adaptiveUpdateRate_;
+    /// Whether an aggregated send is currently in progress.
+    bool aggregating_;
+    /// Whether outgoing messages are currently deferred into the message queue.
+    bool deferSends_;
     /// Client connection flag.
     bool isClient_;
     /// Connection pending flag.
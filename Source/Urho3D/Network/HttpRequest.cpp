@@ -24,6 +24,7 @@
 
 #include "../Core/Profiler.h"
 #include "../Core/Timer.h"
+#include "../IO/File.h"
 #include "../IO/Log.h"
 #include "../Network/HttpRequest.h"
 
@@ -36,17 +37,63 @@ namespace Urho3D
 
 static const unsigned ERROR_BUFFER_SIZE = 256;
 static const unsigned READ_BUFFER_SIZE = 65536; // Must be a power of two
+static const unsigned MAX_POOLED_HTTP_CONNECTIONS = 8;
 
-HttpRequest::HttpRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers, const ea::string& postData) :
+/// Idle keep-alive connection available for reuse, keyed by protocol, host and port.
+struct PooledHttpConnection
+{
+    /// Pool key in protocol://host:port form.
+    ea::string key_;
+    /// Civetweb client connection.
+    mg_connection* connection_;
+};
+
+static Mutex httpConnectionPoolMutex;
+static ea::vector<PooledHttpConnection> httpConnectionPool;
+
+static mg_connection* AcquireHttpConnection(const ea::string& key)
+{
+    MutexLock lock(httpConnectionPoolMutex);
+
+    for (unsigned i = 0; i < httpConnectionPool.size(); ++i)
+    {
+        if (httpConnectionPool[i].key_ == key)
+        {
+            mg_connection* connection = httpConnectionPool[i].connection_;
+            httpConnectionPool.erase(httpConnectionPool.begin() + i);
+            return connection;
+        }
+    }
+
+    return nullptr;
+}
+
+static void ReleaseHttpConnection(const ea::string& key, mg_connection* connection)
+{
+    MutexLock lock(httpConnectionPoolMutex);
+
+    if (httpConnectionPool.size() >= MAX_POOLED_HTTP_CONNECTIONS)
+    {
+        mg_close_connection(connection);
+        return;
+    }
+
+    httpConnectionPool.push_back(PooledHttpConnection{key, connection});
+}
+
+HttpRequest::HttpRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers, const ea::string& postData,
+    File* responseFile) :
     url_(url.trimmed()),
     verb_(!verb.empty() ? verb : "GET"),
     headers_(headers),
     postData_(postData),
+    responseFile_(responseFile),
     state_(HTTP_INITIALIZING),
     httpReadBuffer_(new unsigned char[READ_BUFFER_SIZE]),
     readBuffer_(new unsigned char[READ_BUFFER_SIZE]),
     readPosition_(0),
-    writePosition_(0)
+    writePosition_(0),
+    bytesReceived_(0)
 {
     // Size of response is unknown, so just set maximum value. The position will also be changed
     // to maximum value once the request is done, signaling end for Deserializer::IsEof().
@@ -119,26 +166,52 @@ void HttpRequest::ThreadFunction()
             headersStr += header + "\r\n";
     }
 
-    // Initiate the connection. This may block due to DNS query
-    mg_connection* connection = nullptr;
+    bool secure = protocol.comparei("https") >= 0;
+    ea::string poolKey = protocol + "://" + host + ":" + ea::to_string(port);
 
-    if (postData_.empty())
-    {
-        connection = mg_download(host.c_str(), port, protocol.comparei("https") >= 0 ? 1 : 0, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "\r\n", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str());
-    }
-    else
+    // Reuse an idle keep-alive connection to the same server if one exists, else connect.
+    // A pooled connection may have been closed by the server in the meantime; retry once with a fresh one in that case
+    mg_connection* connection = AcquireHttpConnection(poolKey);
+    bool fromPool = connection != nullptr;
+
+    for (;;)
     {
-        connection = mg_download(host.c_str(), port, protocol.comparei("https") >= 0 ? 1 : 0, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "Content-Length: %d\r\n"
-            "\r\n"
-            "%s", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str(), postData_.length(), postData_.c_str());
+        if (!connection)
+        {
+            // Initiate the connection. This may block due to DNS query
+            connection = mg_connect_client(host.c_str(), port, secure ? 1 : 0, errorBuffer, sizeof(errorBuffer));
+            fromPool = false;
+            if (!connection)
+                break;
+        }
+
+        // Send the request with HTTP/1.1 so that the server may keep the connection open afterward
+        if (postData_.empty())
+        {
+            mg_printf(connection,
+                "%s %s HTTP/1.1\r\n"
+                "Host: %s\r\n"
+                "%s"
+                "\r\n", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str());
+        }
+        else
+        {
+            mg_printf(connection,
+                "%s %s HTTP/1.1\r\n"
+                "Host: %s\r\n"
+                "%s"
+                "Content-Length: %d\r\n"
+                "\r\n"
+                "%s", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str(), postData_.length(), postData_.c_str());
+        }
+
+        if (mg_get_response(connection, errorBuffer, sizeof(errorBuffer), -1) >= 0)
+            break;
+
+        mg_close_connection(connection);
+        connection = nullptr;
+        if (!fromPool)
+            break;
     }
 
     {
@@ -153,13 +226,54 @@ void HttpRequest::ThreadFunction()
         }
     }
 
+    // Determine whether the server allows reusing the connection once the body has been fully read
+    bool keepAlive = false;
+    const mg_response_info* responseInfo = mg_get_response_info(connection);
+    if (responseInfo && responseInfo->http_version && strcmp(responseInfo->http_version, "1.1") == 0 &&
+        responseInfo->content_length >= 0)
+    {
+        keepAlive = true;
+        for (int i = 0; i < responseInfo->num_headers; ++i)
+        {
+            if (ea::string(responseInfo->http_headers[i].name).comparei("Connection") == 0 &&
+                ea::string(responseInfo->http_headers[i].value).comparei("close") == 0)
+            {
+                keepAlive = false;
+                break;
+            }
+        }
+    }
+
+    bool cleanEof = false;
+
     // Loop while should run, read data from the connection, copy to the main thread buffer if there is space
     while (shouldRun_)
     {
+        // When streaming to a file, write the received bytes to it directly from the worker thread and bypass
+        // the ring buffer entirely
+        if (responseFile_)
+        {
+            int bytesRead = mg_read(connection, httpReadBuffer_.get(), READ_BUFFER_SIZE);
+            if (bytesRead <= 0)
+            {
+                cleanEof = bytesRead == 0;
+                break;
+            }
+
+            responseFile_->Write(httpReadBuffer_.get(), (unsigned)bytesRead);
+
+            MutexLock lock(mutex_);
+            bytesReceived_ += (unsigned)bytesRead;
+            continue;
+        }
+
         // Read less than full buffer to be able to distinguish between full and empty ring buffer. Reading may block
         int bytesRead = mg_read(connection, httpReadBuffer_.get(), READ_BUFFER_SIZE / 4);
         if (bytesRead <= 0)
+        {
+            cleanEof = bytesRead == 0;
             break;
+        }
 
         mutex_.Acquire();
 
@@ -194,12 +308,20 @@ void HttpRequest::ThreadFunction()
 
         writePosition_ += bytesRead;
         writePosition_ &= READ_BUFFER_SIZE - 1;
+        bytesReceived_ += (unsigned)bytesRead;
 
         mutex_.Release();
     }
 
-    // Close the connection
-    mg_close_connection(connection);
+    if (responseFile_)
+        responseFile_->Flush();
+
+    // Return the connection to the pool if the body was read to completion and the server allows reuse,
+    // else close it
+    if (cleanEof && keepAlive && shouldRun_)
+        ReleaseHttpConnection(poolKey, connection);
+    else
+        mg_close_connection(connection);
 
     {
         MutexLock lock(mutex_);
@@ -207,9 +329,22 @@ void HttpRequest::ThreadFunction()
     }
 }
 
+void HttpRequest::CleanupConnectionPool()
+{
+    MutexLock lock(httpConnectionPoolMutex);
+
+    for (unsigned i = 0; i < httpConnectionPool.size(); ++i)
+        mg_close_connection(httpConnectionPool[i].connection_);
+    httpConnectionPool.clear();
+}
+
 unsigned HttpRequest::Read(void* dest, unsigned size)
 {
 #ifdef URHO3D_THREADING
+    // When streaming to a file, the body never enters the read buffer
+    if (responseFile_)
+        return 0;
+
     mutex_.Acquire();
 
     auto* destPtr = (unsigned char*)dest;
@@ -297,6 +432,12 @@ unsigned HttpRequest::GetAvailableSize() const
     return CheckAvailableSizeAndEof().first;
 }
 
+unsigned HttpRequest::GetBytesReceived() const
+{
+    MutexLock lock(mutex_);
+    return bytesReceived_;
+}
+
 ea::pair<unsigned, bool> HttpRequest::CheckAvailableSizeAndEof() const
 {
     unsigned size = (writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1);
@@ -27,6 +27,7 @@
 #include <EASTL/shared_array.h>
 
 #include "../Core/Mutex.h"
+#include "../Container/Ptr.h"
 #include "../Container/RefCounted.h"
 #include "../Core/Thread.h"
 #include "../IO/Deserializer.h"
@@ -34,6 +35,8 @@
 namespace Urho3D
 {
 
+class File;
+
 /// HTTP connection state.
 enum HttpRequestState
 {
@@ -47,15 +50,19 @@ enum HttpRequestState
 class URHO3D_API HttpRequest : public RefCounted, public Deserializer, public Thread
 {
 public:
-    /// Construct with parameters.
-    HttpRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers, const ea::string& postData);
+    /// Construct with parameters. If a response file is given, the worker thread streams the response body directly into it instead of buffering it for Read().
+    HttpRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers, const ea::string& postData,
+        File* responseFile = nullptr);
     /// Destruct. Release the connection object.
     ~HttpRequest() override;
 
     /// Process the connection in the worker thread until closed.
     void ThreadFunction() override;
 
-    /// Read response data from the HTTP connection and return number of bytes actually read. While the connection is open, will block while trying to read the specified size. To avoid blocking, only read up to as many bytes as GetAvailableSize() returns.
+    /// Close all pooled keep-alive connections. Called by Network at subsystem shutdown.
+    static void CleanupConnectionPool();
+
+    /// Read response data from the HTTP connection and return number of bytes actually read. While the connection is open, will block while trying to read the specified size. To avoid blocking, only read up to as many bytes as GetAvailableSize() returns. Always returns 0 when the response is streamed to a file.
     unsigned Read(void* dest, unsigned size) override;
     /// Set position from the beginning of the stream. Not supported.
     unsigned Seek(unsigned position) override;
@@ -74,6 +81,11 @@ public:
     HttpRequestState GetState() const;
     /// Return amount of bytes in the read buffer.
     unsigned GetAvailableSize() const;
+    /// Return total amount of response body bytes received so far.
+    unsigned GetBytesReceived() const;
+
+    /// Return the file the response is streamed into, or null if buffering for Read().
+    File* GetResponseFile() const { return responseFile_.Get(); }
 
     /// Return whether connection is in the open state.
     bool IsOpen() const { return GetState() == HTTP_OPEN; }
@@ -92,6 +104,8 @@ private:
     ea::vector<ea::string> headers_;
     /// POST data.
     ea::string postData_;
+    /// Optional destination file for streaming the response body.
+    SharedPtr<File> responseFile_;
     /// Connection state.
     HttpRequestState state_;
     /// Mutex for synchronizing the worker and the main thread.
@@ -104,6 +118,8 @@ private:
     unsigned readPosition_;
     /// Read buffer write cursor.
     unsigned writePosition_;
+    /// Total response body bytes received by the worker thread.
+    unsigned bytesReceived_;
 };
 
 }
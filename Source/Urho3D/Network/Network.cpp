@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Engine/EngineEvents.h"
 #include "../IO/FileSystem.h"
 #include "../Input/InputEvents.h"
@@ -289,6 +290,8 @@ Network::~Network()
     SLNet::RakPeerInterface::DestroyInstance(rakPeerClient_);
     rakPeer_ = nullptr;
     rakPeerClient_ = nullptr;
+
+    HttpRequest::CleanupConnectionPool();
 }
 
 void Network::HandleMessage(const SLNet::AddressOrGUID& source, int packetID, int msgID, const char* data, size_t numBytes)
@@ -532,13 +535,17 @@ void Network::BroadcastMessage(int msgID, bool reliable, bool inOrder, const uns
     if (!rakPeer_)
         return;
 
-    VectorBuffer msgData;
-    msgData.WriteUByte((unsigned char)ID_USER_PACKET_ENUM);
-    msgData.WriteUInt((unsigned int)msgID);
-    msgData.Write(data, numBytes);
-
     if (isServer_)
-        rakPeer_->Send((const char*)msgData.GetData(), (int)msgData.GetSize(), HIGH_PRIORITY, RELIABLE, (char)0, SLNet::UNASSIGNED_RAKNET_GUID, true);
+    {
+        // Gather the header and the payload directly into the outgoing packet instead of concatenating them
+        // into a transient buffer first
+        unsigned char header[5];
+        header[0] = (unsigned char)ID_USER_PACKET_ENUM;
+        memcpy(&header[1], &msgID, sizeof(unsigned));
+        const char* buffers[2] = { (const char*)header, (const char*)data };
+        const int lengths[2] = { (int)sizeof(header), (int)numBytes };
+        rakPeer_->SendList(buffers, lengths, numBytes ? 2 : 1, HIGH_PRIORITY, RELIABLE, (char)0, SLNet::UNASSIGNED_RAKNET_GUID, true);
+    }
     else
         URHO3D_LOGERROR("Server not running, can not broadcast messages");
 }
@@ -654,6 +661,15 @@ SharedPtr<HttpRequest> Network::MakeHttpRequest(const ea::string& url, const ea:
     return request;
 }
 
+SharedPtr<HttpRequest> Network::MakeHttpRequestToFile(const ea::string& url, File* responseFile, const ea::string& verb,
+    const ea::vector<ea::string>& headers, const ea::string& postData)
+{
+    URHO3D_PROFILE("MakeHttpRequest");
+
+    SharedPtr<HttpRequest> request(new HttpRequest(url, verb, headers, postData, responseFile));
+    return request;
+}
+
 void Network::BanAddress(const ea::string& address)
 {
     rakPeer_->AddToBanList(address.c_str(), 0);
@@ -952,11 +968,33 @@ void Network::PostUpdate(float timeStep)
             {
                 URHO3D_PROFILE("SendServerUpdate");
 
+                // Build each client's scene update on the worker threads when available: the delta computation
+                // against the connection's replication state is independent per connection. The resulting
+                // messages are queued and sent serially below
+                auto* workQueue = GetSubsystem<WorkQueue>();
+                const bool parallelUpdate = workQueue->GetNumThreads() && clientConnections_.size() > 1;
+                if (parallelUpdate)
+                {
+                    for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
+                    {
+                        Connection* connection = i->second;
+                        connection->BeginDeferredSend();
+                        workQueue->AddWorkItem([connection]() { connection->SendServerUpdate(); }, M_MAX_UNSIGNED);
+                    }
+                    workQueue->Complete(M_MAX_UNSIGNED);
+                }
+
                 // Then send server updates for each client connection
                 for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
                 {
-                    i->second->SendServerUpdate();
+                    // Coalesce the scene delta and remote events of this update into aggregated datagrams, if enabled
+                    i->second->BeginAggregatedSend();
+                    if (parallelUpdate)
+                        i->second->EndDeferredSend();
+                    else
+                        i->second->SendServerUpdate();
                     i->second->SendRemoteEvents();
+                    i->second->EndAggregatedSend();
                     i->second->SendPackages();
                 }
             }
@@ -965,8 +1003,10 @@ void Network::PostUpdate(float timeStep)
         if (serverConnection_)
         {
             // Send the client update
+            serverConnection_->BeginAggregatedSend();
             serverConnection_->SendClientUpdate();
             serverConnection_->SendRemoteEvents();
+            serverConnection_->EndAggregatedSend();
         }
 
         // Notify that the update was sent
@@ -995,7 +1035,7 @@ void Network::OnServerConnected(const SLNet::AddressOrGUID& address)
     URHO3D_LOGINFO("Connected to server!");
 
     // Send the identity map now
-    VectorBuffer msg;
+    VectorBuffer& msg = serverConnection_->AcquireSendBuffer();
     msg.WriteVariantMap(serverConnection_->GetIdentity());
     serverConnection_->SendMessage(MSG_IDENTITY, true, true, msg);
 
@@ -31,6 +31,7 @@
 namespace Urho3D
 {
 
+class File;
 class HttpRequest;
 class MemoryBuffer;
 class Scene;
@@ -103,6 +104,8 @@ public:
     void SendPackageToClients(Scene* scene, PackageFile* package);
     /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. Return a request object which can be used to read the response data.
     SharedPtr<HttpRequest> MakeHttpRequest(const ea::string& url, const ea::string& verb = EMPTY_STRING, const ea::vector<ea::string>& headers = ea::vector<ea::string>(), const ea::string& postData = EMPTY_STRING);
+    /// Perform an HTTP request and stream the response body directly into the specified file from the worker thread. Return a request object which can be used to track completion via its state.
+    SharedPtr<HttpRequest> MakeHttpRequestToFile(const ea::string& url, File* responseFile, const ea::string& verb = EMPTY_STRING, const ea::vector<ea::string>& headers = ea::vector<ea::string>(), const ea::string& postData = EMPTY_STRING);
     /// Ban specific IP addresses.
     void BanAddress(const ea::string& address);
     /// Return network update FPS.
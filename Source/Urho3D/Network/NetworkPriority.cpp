@@ -82,9 +82,9 @@ void NetworkPriority::SetAlwaysUpdateOwner(bool enable)
     MarkNetworkUpdate();
 }
 
-bool NetworkPriority::CheckUpdate(float distance, float& accumulator)
+bool NetworkPriority::CheckUpdate(float distance, float& accumulator, float frequencyScale)
 {
-    float currentPriority = Max(basePriority_ - distanceFactor_ * distance, minPriority_);
+    float currentPriority = Max(basePriority_ - distanceFactor_ * distance, minPriority_) * frequencyScale;
     accumulator += currentPriority;
     if (accumulator >= UPDATE_THRESHOLD)
     {
@@ -61,8 +61,10 @@ public:
     /// Return whether updates to owner should be sent always at full rate.
     bool GetAlwaysUpdateOwner() const { return alwaysUpdateOwner_; }
 
-    /// Increment and check priority accumulator. Return true if should update. Called by Connection.
-    bool CheckUpdate(float distance, float& accumulator);
+    /// Increment and check priority accumulator. Return true if should update. Called by Connection. The frequency scale
+    /// further multiplies the distance-based priority, e.g. by the connection's link quality, so that low-priority distant
+    /// nodes back off the most on a poor connection.
+    bool CheckUpdate(float distance, float& accumulator, float frequencyScale = 1.0f);
 
 private:
     /// Base priority.
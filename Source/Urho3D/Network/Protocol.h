@@ -63,10 +63,18 @@ static const int MSG_REMOTEEVENT = 0x96;
 static const int MSG_REMOTENODEEVENT = 0x97;
 /// Server->client: info about package.
 static const int MSG_PACKAGEINFO = 0x98;
+/// Server->client: content chunk hashes of a requested package, sent before any package data to enable delta patching.
+static const int MSG_PACKAGECHUNKHASHES = 0x99;
+/// Client->server: request transfer of only the specified package chunks.
+static const int MSG_REQUESTPACKAGECHUNKS = 0x9A;
+/// Client->server and server->client: several update messages coalesced into one datagram. The payload is a sequence of entries, each consisting of the message ID as a byte, the VLE-encoded payload size and the payload.
+static const int MSG_AGGREGATEDUPDATE = 0x9B;
 
 /// Fixed content ID for client controls update.
 static const unsigned CONTROLS_CONTENT_ID = 1;
 /// Package file fragment size.
 static const unsigned PACKAGE_FRAGMENT_SIZE = 1024;
+/// Soft payload limit for an aggregated update message, chosen to keep the datagram within a typical MTU.
+static const unsigned AGGREGATED_MESSAGE_LIMIT = 1200;
 
 }
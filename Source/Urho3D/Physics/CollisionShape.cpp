@@ -32,7 +32,9 @@
 #include "../Graphics/Model.h"
 #include "../Graphics/Terrain.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../IO/Deserializer.h"
 #include "../IO/Log.h"
+#include "../IO/Serializer.h"
 #include "../Physics/CollisionShape.h"
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
@@ -49,6 +51,7 @@
 #include <Bullet/BulletCollision/CollisionShapes/btConvexHullShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btCylinderShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <Bullet/BulletCollision/CollisionShapes/btOptimizedBvh.h>
 #include <Bullet/BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btSphereShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
@@ -60,8 +63,11 @@
 namespace Urho3D
 {
 
+URHO3D_DEFINE_OBJECT_POOL(CollisionShape)
+
 static const float DEFAULT_COLLISION_MARGIN = 0.04f;
 static const unsigned QUANTIZE_MAX_TRIANGLES = 1000000;
+static const unsigned COOKED_BVH_VERSION = 1;
 
 static const btVector3 WHITE(1.0f, 1.0f, 1.0f);
 static const btVector3 GREEN(0.0f, 1.0f, 0.0f);
@@ -205,6 +211,18 @@ TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel)
     btGenerateInternalEdgeInfo(shape_.get(), infoMap_.get());
 }
 
+TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel, Deserializer& cookedBvh)
+{
+    meshInterface_ = ea::make_unique<TriangleMeshInterface>(model, lodLevel);
+
+    // Fall back to building the BVH if the cooked data can not be used
+    if (!LoadCookedBvh(cookedBvh))
+        shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, true);
+
+    infoMap_ = ea::make_unique<btTriangleInfoMap>();
+    btGenerateInternalEdgeInfo(shape_.get(), infoMap_.get());
+}
+
 TriangleMeshData::TriangleMeshData(CustomGeometry* custom)
 {
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(custom);
@@ -214,6 +232,83 @@ TriangleMeshData::TriangleMeshData(CustomGeometry* custom)
     btGenerateInternalEdgeInfo(shape_.get(), infoMap_.get());
 }
 
+TriangleMeshData::~TriangleMeshData()
+{
+    // The shape's BVH points into the cooked buffer, so destroy the shape before freeing it
+    shape_.reset();
+    if (cookedBvhData_)
+        btAlignedFree(cookedBvhData_);
+}
+
+bool TriangleMeshData::SaveCookedBvh(Serializer& dest) const
+{
+    btOptimizedBvh* bvh = shape_ ? shape_->getOptimizedBvh() : nullptr;
+    if (!bvh)
+        return false;
+
+    const unsigned bufferSize = bvh->calculateSerializeBufferSize();
+    void* buffer = btAlignedAlloc(bufferSize, 16);
+    if (!bvh->serialize(buffer, bufferSize, false))
+    {
+        btAlignedFree(buffer);
+        return false;
+    }
+
+    bool success = dest.WriteFileID("UBVH");
+    success &= dest.WriteUInt(COOKED_BVH_VERSION);
+    success &= dest.WriteBool(meshInterface_->useQuantize_);
+    success &= dest.WriteUInt(bufferSize);
+    success &= dest.Write(buffer, bufferSize) == bufferSize;
+
+    btAlignedFree(buffer);
+    return success;
+}
+
+bool TriangleMeshData::LoadCookedBvh(Deserializer& source)
+{
+    if (source.ReadFileID() != "UBVH")
+    {
+        URHO3D_LOGWARNING("Cooked BVH " + source.GetName() + " is not a valid BVH sidecar file");
+        return false;
+    }
+    if (source.ReadUInt() != COOKED_BVH_VERSION)
+    {
+        URHO3D_LOGWARNING("Cooked BVH " + source.GetName() + " has an unsupported version, re-cook it");
+        return false;
+    }
+    // The quantization mode is derived from the triangle count, so a mismatch means the model has changed since cooking
+    if (source.ReadBool() != meshInterface_->useQuantize_)
+    {
+        URHO3D_LOGWARNING("Cooked BVH " + source.GetName() + " does not match the model geometry, re-cook it");
+        return false;
+    }
+
+    const unsigned bufferSize = source.ReadUInt();
+    if (!bufferSize || source.GetPosition() + bufferSize > source.GetSize())
+        return false;
+
+    cookedBvhData_ = static_cast<unsigned char*>(btAlignedAlloc(bufferSize, 16));
+    if (source.Read(cookedBvhData_, bufferSize) != bufferSize)
+    {
+        btAlignedFree(cookedBvhData_);
+        cookedBvhData_ = nullptr;
+        return false;
+    }
+
+    btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(cookedBvhData_, bufferSize, false);
+    if (!bvh)
+    {
+        btAlignedFree(cookedBvhData_);
+        cookedBvhData_ = nullptr;
+        return false;
+    }
+
+    // The shape takes a non-owning pointer into the cooked buffer instead of building the BVH
+    shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, false);
+    shape_->setOptimizedBvh(bvh);
+    return true;
+}
+
 GImpactMeshData::GImpactMeshData(Model* model, unsigned lodLevel)
 {
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(model, lodLevel);
@@ -394,11 +489,22 @@ bool HasDynamicBuffers(Model* model, unsigned lodLevel)
     return false;
 }
 
-CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* model, unsigned lodLevel)
+CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* model, unsigned lodLevel, ResourceCache* resourceCache = nullptr)
 {
     switch (shapeType)
     {
     case SHAPE_TRIANGLEMESH:
+        // Use an offline-cooked BVH sidecar if one exists in the resource system
+        if (resourceCache && !model->GetName().empty())
+        {
+            const ea::string bvhName = model->GetName() + ".bvh";
+            if (resourceCache->Exists(bvhName))
+            {
+                SharedPtr<File> file = resourceCache->GetFile(bvhName, false);
+                if (file)
+                    return new TriangleMeshData(model, lodLevel, *file);
+            }
+        }
         return new TriangleMeshData(model, lodLevel);
     case SHAPE_CONVEXHULL:
         return new ConvexData(model, lodLevel);
@@ -680,6 +786,25 @@ void CollisionShape::SetCustomTriangleMesh(CustomGeometry* custom, const Vector3
     SetCustomShape(SHAPE_TRIANGLEMESH, custom, scale, position, rotation);
 }
 
+bool CollisionShape::CookTriangleMesh(Model* model, unsigned lodLevel, Serializer& dest)
+{
+    if (!model)
+    {
+        URHO3D_LOGERROR("Null model for triangle mesh cooking");
+        return false;
+    }
+
+    URHO3D_PROFILE("CookTriangleMesh");
+
+    TriangleMeshData data(model, lodLevel);
+    if (!data.SaveCookedBvh(dest))
+    {
+        URHO3D_LOGERROR("Failed to cook triangle mesh BVH for model " + model->GetName());
+        return false;
+    }
+    return true;
+}
+
 void CollisionShape::SetConvexHull(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
@@ -1122,7 +1247,7 @@ void CollisionShape::UpdateCachedGeometryShape(CollisionGeometryDataCache& cache
             geometry_ = cachedGeometry->second;
         else
         {
-            geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_);
+            geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_, GetSubsystem<ResourceCache>());
             assert(geometry_);
             // Check if model has dynamic buffers, do not cache in that case
             if (!HasDynamicBuffers(model_, lodLevel_))
@@ -42,10 +42,12 @@ namespace Urho3D
 {
 
 class CustomGeometry;
+class Deserializer;
 class Geometry;
 class Model;
 class PhysicsWorld;
 class RigidBody;
+class Serializer;
 class Terrain;
 class TriangleMeshInterface;
 
@@ -78,8 +80,17 @@ struct TriangleMeshData : public CollisionGeometryData
 {
     /// Construct from a model.
     TriangleMeshData(Model* model, unsigned lodLevel);
+    /// Construct from a model, loading a previously cooked BVH from a sidecar stream instead of building it. Falls back to building on failure.
+    TriangleMeshData(Model* model, unsigned lodLevel, Deserializer& cookedBvh);
     /// Construct from a custom geometry.
     explicit TriangleMeshData(CustomGeometry* custom);
+    /// Destruct. Free the cooked BVH buffer if one was loaded.
+    ~TriangleMeshData() override;
+
+    /// Save the built BVH to a stream for offline cooking. Return true if successful.
+    bool SaveCookedBvh(Serializer& dest) const;
+    /// Load a cooked BVH and create the shape around it. Return false and leave the shape null on failure.
+    bool LoadCookedBvh(Deserializer& source);
 
     /// Bullet triangle mesh interface.
     ea::unique_ptr<TriangleMeshInterface> meshInterface_;
@@ -87,6 +98,8 @@ struct TriangleMeshData : public CollisionGeometryData
     ea::unique_ptr<btBvhTriangleMeshShape> shape_;
     /// Bullet triangle info map.
     ea::unique_ptr<btTriangleInfoMap> infoMap_;
+    /// Cooked BVH buffer when loaded from a sidecar; the shape's BVH points into it.
+    unsigned char* cookedBvhData_{};
 };
 
 /// Triangle mesh geometry data.
@@ -144,6 +157,7 @@ struct HeightfieldData : public CollisionGeometryData
 class URHO3D_API CollisionShape : public Component
 {
     URHO3D_OBJECT(CollisionShape, Component);
+    URHO3D_OBJECT_POOL(CollisionShape);
 
 public:
     /// Construct.
@@ -178,6 +192,8 @@ public:
     /// Set as a triangle mesh from CustomGeometry.
     void SetCustomTriangleMesh(CustomGeometry* custom, const Vector3& scale = Vector3::ONE, const Vector3& position = Vector3::ZERO,
         const Quaternion& rotation = Quaternion::IDENTITY);
+    /// Cook the triangle mesh BVH of a model into a stream for offline use. If the stream is saved as a "<model name>.bvh" sidecar resource, triangle mesh shape creation loads it instead of building the BVH. Re-cook whenever the model's geometry changes.
+    static bool CookTriangleMesh(Model* model, unsigned lodLevel, Serializer& dest);
     /// Set as a convex hull from Model.
     void SetConvexHull(Model* model, unsigned lodLevel = 0, const Vector3& scale = Vector3::ONE, const Vector3& position = Vector3::ZERO,
         const Quaternion& rotation = Quaternion::IDENTITY);
@@ -0,0 +1,390 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../IO/Log.h"
+#include "../Physics/KinematicCharacterController.h"
+#include "../Physics/PhysicsEvents.h"
+#include "../Physics/PhysicsUtils.h"
+#include "../Physics/PhysicsWorld.h"
+#include "../Scene/Scene.h"
+
+#include <Bullet/BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <Bullet/BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <Bullet/BulletDynamics/Character/btKinematicCharacterController.h>
+#include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* PHYSICS_CATEGORY;
+
+static const unsigned DEFAULT_COLLISION_LAYER = 0x1;
+static const unsigned DEFAULT_COLLISION_MASK = M_MAX_UNSIGNED;
+static const Vector3 DEFAULT_CHARACTER_GRAVITY(0.0f, -14.0f, 0.0f);
+static const float DEFAULT_CHARACTER_HEIGHT = 1.8f;
+static const float DEFAULT_CHARACTER_DIAMETER = 0.7f;
+static const Vector3 DEFAULT_CHARACTER_OFFSET(0.0f, 0.9f, 0.0f);
+static const float DEFAULT_CHARACTER_STEP_HEIGHT = 0.4f;
+static const float DEFAULT_CHARACTER_MAX_JUMP_HEIGHT = 2.0f;
+static const float DEFAULT_CHARACTER_FALL_SPEED = 55.0f;
+static const float DEFAULT_CHARACTER_JUMP_SPEED = 9.0f;
+static const float DEFAULT_CHARACTER_MAX_SLOPE = 45.0f;
+
+KinematicCharacterController::KinematicCharacterController(Context* context) :
+    Component(context),
+    collisionLayer_(DEFAULT_COLLISION_LAYER),
+    collisionMask_(DEFAULT_COLLISION_MASK),
+    gravity_(DEFAULT_CHARACTER_GRAVITY),
+    height_(DEFAULT_CHARACTER_HEIGHT),
+    diameter_(DEFAULT_CHARACTER_DIAMETER),
+    offset_(DEFAULT_CHARACTER_OFFSET),
+    stepHeight_(DEFAULT_CHARACTER_STEP_HEIGHT),
+    maxJumpHeight_(DEFAULT_CHARACTER_MAX_JUMP_HEIGHT),
+    fallSpeed_(DEFAULT_CHARACTER_FALL_SPEED),
+    jumpSpeed_(DEFAULT_CHARACTER_JUMP_SPEED),
+    maxSlope_(DEFAULT_CHARACTER_MAX_SLOPE),
+    readdToWorld_(false)
+{
+}
+
+KinematicCharacterController::~KinematicCharacterController()
+{
+    RemoveFromWorld();
+}
+
+void KinematicCharacterController::RegisterObject(Context* context)
+{
+    context->RegisterFactory<KinematicCharacterController>(PHYSICS_CATEGORY);
+
+    URHO3D_ATTRIBUTE("Is Enabled", bool, enabled_, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Collision Layer", int, collisionLayer_, MarkControllerDirty, DEFAULT_COLLISION_LAYER, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Collision Mask", int, collisionMask_, MarkControllerDirty, DEFAULT_COLLISION_MASK, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Gravity", Vector3, gravity_, DEFAULT_CHARACTER_GRAVITY, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Height", float, height_, MarkControllerDirty, DEFAULT_CHARACTER_HEIGHT, AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Diameter", float, diameter_, MarkControllerDirty, DEFAULT_CHARACTER_DIAMETER, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Offset", Vector3, offset_, DEFAULT_CHARACTER_OFFSET, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Step Height", float, stepHeight_, DEFAULT_CHARACTER_STEP_HEIGHT, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Jump Height", float, maxJumpHeight_, DEFAULT_CHARACTER_MAX_JUMP_HEIGHT, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Fall Speed", float, fallSpeed_, DEFAULT_CHARACTER_FALL_SPEED, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Jump Speed", float, jumpSpeed_, DEFAULT_CHARACTER_JUMP_SPEED, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Slope", float, maxSlope_, DEFAULT_CHARACTER_MAX_SLOPE, AM_DEFAULT);
+}
+
+void KinematicCharacterController::ApplyAttributes()
+{
+    if (readdToWorld_)
+    {
+        if (IsEnabledEffective())
+            AddToWorld();
+        readdToWorld_ = false;
+    }
+    else
+        ApplySettings();
+}
+
+void KinematicCharacterController::OnSetEnabled()
+{
+    if (IsEnabledEffective())
+        AddToWorld();
+    else
+        RemoveFromWorld();
+}
+
+void KinematicCharacterController::SetCollisionLayer(unsigned layer)
+{
+    if (layer != collisionLayer_)
+    {
+        collisionLayer_ = layer;
+        if (IsEnabledEffective())
+            AddToWorld();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetCollisionMask(unsigned mask)
+{
+    if (mask != collisionMask_)
+    {
+        collisionMask_ = mask;
+        if (IsEnabledEffective())
+            AddToWorld();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetCollisionLayerAndMask(unsigned layer, unsigned mask)
+{
+    if (layer != collisionLayer_ || mask != collisionMask_)
+    {
+        collisionLayer_ = layer;
+        collisionMask_ = mask;
+        if (IsEnabledEffective())
+            AddToWorld();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetGravity(const Vector3& gravity)
+{
+    if (gravity != gravity_)
+    {
+        gravity_ = gravity;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetHeight(float height)
+{
+    if (height != height_)
+    {
+        height_ = height;
+        if (IsEnabledEffective())
+            AddToWorld();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetDiameter(float diameter)
+{
+    if (diameter != diameter_)
+    {
+        diameter_ = diameter;
+        if (IsEnabledEffective())
+            AddToWorld();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetOffset(const Vector3& offset)
+{
+    if (offset != offset_)
+    {
+        offset_ = offset;
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetStepHeight(float stepHeight)
+{
+    if (stepHeight != stepHeight_)
+    {
+        stepHeight_ = stepHeight;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetMaxJumpHeight(float maxJumpHeight)
+{
+    if (maxJumpHeight != maxJumpHeight_)
+    {
+        maxJumpHeight_ = maxJumpHeight;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetFallSpeed(float fallSpeed)
+{
+    if (fallSpeed != fallSpeed_)
+    {
+        fallSpeed_ = fallSpeed;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetJumpSpeed(float jumpSpeed)
+{
+    if (jumpSpeed != jumpSpeed_)
+    {
+        jumpSpeed_ = jumpSpeed;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetMaxSlope(float maxSlope)
+{
+    if (maxSlope != maxSlope_)
+    {
+        maxSlope_ = maxSlope;
+        ApplySettings();
+        MarkNetworkUpdate();
+    }
+}
+
+void KinematicCharacterController::SetWalkIncrement(const Vector3& walkIncrement)
+{
+    walkIncrement_ = walkIncrement;
+    if (controller_)
+        controller_->setWalkDirection(ToBtVector3(walkIncrement_));
+}
+
+void KinematicCharacterController::Jump(const Vector3& jump)
+{
+    if (controller_ && controller_->canJump())
+        controller_->jump(ToBtVector3(jump));
+}
+
+void KinematicCharacterController::Warp(const Vector3& position)
+{
+    if (!controller_ || !node_)
+        return;
+
+    // The Bullet world may not be modified while a step is in flight
+    if (physicsWorld_)
+        physicsWorld_->FinishAsyncStep();
+
+    controller_->warp(ToBtVector3(position + node_->GetWorldRotation() * offset_));
+    node_->SetWorldPosition(position);
+}
+
+bool KinematicCharacterController::OnGround() const
+{
+    return controller_ && controller_->onGround();
+}
+
+Vector3 KinematicCharacterController::GetPosition() const
+{
+    if (!ghostObject_ || !node_)
+        return node_ ? node_->GetWorldPosition() : Vector3::ZERO;
+
+    return ToVector3(ghostObject_->getWorldTransform().getOrigin()) - node_->GetWorldRotation() * offset_;
+}
+
+void KinematicCharacterController::OnSceneSet(Scene* scene)
+{
+    if (scene)
+    {
+        if (scene == node_)
+            URHO3D_LOGWARNING(GetTypeName() + " should not be created to the root scene node");
+
+        physicsWorld_ = scene->GetOrCreateComponent<PhysicsWorld>();
+
+        if (IsEnabledEffective())
+            AddToWorld();
+    }
+    else
+    {
+        RemoveFromWorld();
+        physicsWorld_.Reset();
+    }
+}
+
+void KinematicCharacterController::AddToWorld()
+{
+    if (!physicsWorld_ || !node_)
+        return;
+
+    URHO3D_PROFILE("AddCharacterToWorld");
+
+    RemoveFromWorld();
+
+    // The Bullet world may not be modified while a step is in flight
+    physicsWorld_->FinishAsyncStep();
+
+    // The capsule sweep shape is created once and reused for all movement sweeps of the character
+    shape_ = ea::make_unique<btCapsuleShape>(diameter_ * 0.5f, Max(height_ - diameter_, 0.0f));
+
+    const Quaternion worldRotation = node_->GetWorldRotation();
+
+    ghostObject_ = ea::make_unique<btPairCachingGhostObject>();
+    btTransform transform;
+    transform.setOrigin(ToBtVector3(node_->GetWorldPosition() + worldRotation * offset_));
+    transform.setRotation(ToBtQuaternion(worldRotation));
+    ghostObject_->setWorldTransform(transform);
+    ghostObject_->setCollisionShape(shape_.get());
+    ghostObject_->setCollisionFlags(btCollisionObject::CF_CHARACTER_OBJECT);
+
+    controller_ = ea::make_unique<btKinematicCharacterController>(ghostObject_.get(), shape_.get(), stepHeight_,
+        ToBtVector3(Vector3::UP));
+    ApplySettings();
+    controller_->setWalkDirection(ToBtVector3(walkIncrement_));
+
+    btDiscreteDynamicsWorld* world = physicsWorld_->GetWorld();
+    world->addCollisionObject(ghostObject_.get(), (int)collisionLayer_, (int)collisionMask_);
+    world->addAction(controller_.get());
+
+    SubscribeToEvent(physicsWorld_, E_PHYSICSPOSTSTEP,
+        URHO3D_HANDLER(KinematicCharacterController, HandlePhysicsPostStep));
+}
+
+void KinematicCharacterController::RemoveFromWorld()
+{
+    if (!controller_ && !ghostObject_)
+        return;
+
+    if (physicsWorld_)
+    {
+        // The Bullet world may not be modified while a step is in flight
+        physicsWorld_->FinishAsyncStep();
+
+        btDiscreteDynamicsWorld* world = physicsWorld_->GetWorld();
+        if (controller_)
+            world->removeAction(controller_.get());
+        if (ghostObject_)
+            world->removeCollisionObject(ghostObject_.get());
+
+        UnsubscribeFromEvent(physicsWorld_, E_PHYSICSPOSTSTEP);
+    }
+
+    controller_.reset();
+    ghostObject_.reset();
+    shape_.reset();
+}
+
+void KinematicCharacterController::ApplySettings()
+{
+    if (!controller_)
+        return;
+
+    controller_->setGravity(ToBtVector3(gravity_));
+    controller_->setStepHeight(stepHeight_);
+    controller_->setMaxJumpHeight(maxJumpHeight_);
+    controller_->setFallSpeed(fallSpeed_);
+    controller_->setJumpSpeed(jumpSpeed_);
+    controller_->setMaxSlope(maxSlope_ * M_DEGTORAD);
+}
+
+void KinematicCharacterController::MarkControllerDirty()
+{
+    readdToWorld_ = true;
+}
+
+void KinematicCharacterController::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
+{
+    if (!node_ || !ghostObject_)
+        return;
+
+    node_->SetWorldPosition(
+        ToVector3(ghostObject_->getWorldTransform().getOrigin()) - node_->GetWorldRotation() * offset_);
+}
+
+}
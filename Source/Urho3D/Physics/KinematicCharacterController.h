@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <EASTL/unique_ptr.h>
+
+#include "../Scene/Component.h"
+
+class btCapsuleShape;
+class btKinematicCharacterController;
+class btPairCachingGhostObject;
+
+namespace Urho3D
+{
+
+class PhysicsWorld;
+
+/// Kinematic character controller component. Moves a capsule shaped ghost object through the physics world with
+/// stepping, sliding and gravity. The ghost object caches its overlapping broadphase pairs and the sweep shape is
+/// created once, so per-step movement does not allocate Bullet objects.
+class URHO3D_API KinematicCharacterController : public Component
+{
+    URHO3D_OBJECT(KinematicCharacterController, Component);
+
+public:
+    /// Construct.
+    explicit KinematicCharacterController(Context* context);
+    /// Destruct. Remove the character from the physics world.
+    ~KinematicCharacterController() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Apply attribute changes that can not be applied immediately. Recreate the Bullet objects if necessary.
+    void ApplyAttributes() override;
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+
+    /// Set collision layer.
+    void SetCollisionLayer(unsigned layer);
+    /// Set collision mask.
+    void SetCollisionMask(unsigned mask);
+    /// Set collision layer and mask.
+    void SetCollisionLayerAndMask(unsigned layer, unsigned mask);
+    /// Set gravity.
+    void SetGravity(const Vector3& gravity);
+    /// Set capsule height.
+    void SetHeight(float height);
+    /// Set capsule diameter.
+    void SetDiameter(float diameter);
+    /// Set capsule offset from the node position.
+    void SetOffset(const Vector3& offset);
+    /// Set maximum step height climbed automatically.
+    void SetStepHeight(float stepHeight);
+    /// Set maximum jump height.
+    void SetMaxJumpHeight(float maxJumpHeight);
+    /// Set maximum fall speed.
+    void SetFallSpeed(float fallSpeed);
+    /// Set vertical jump speed.
+    void SetJumpSpeed(float jumpSpeed);
+    /// Set maximum walkable slope in degrees.
+    void SetMaxSlope(float maxSlope);
+    /// Set the world space displacement to apply on each simulation step until changed.
+    void SetWalkIncrement(const Vector3& walkIncrement);
+    /// Jump with the given velocity, or straight up at the jump speed if zero.
+    void Jump(const Vector3& jump = Vector3::ZERO);
+    /// Teleport the character to a world space position.
+    void Warp(const Vector3& position);
+
+    /// Return collision layer.
+    unsigned GetCollisionLayer() const { return collisionLayer_; }
+
+    /// Return collision mask.
+    unsigned GetCollisionMask() const { return collisionMask_; }
+
+    /// Return gravity.
+    const Vector3& GetGravity() const { return gravity_; }
+
+    /// Return capsule height.
+    float GetHeight() const { return height_; }
+
+    /// Return capsule diameter.
+    float GetDiameter() const { return diameter_; }
+
+    /// Return capsule offset from the node position.
+    const Vector3& GetOffset() const { return offset_; }
+
+    /// Return maximum step height.
+    float GetStepHeight() const { return stepHeight_; }
+
+    /// Return maximum jump height.
+    float GetMaxJumpHeight() const { return maxJumpHeight_; }
+
+    /// Return maximum fall speed.
+    float GetFallSpeed() const { return fallSpeed_; }
+
+    /// Return jump speed.
+    float GetJumpSpeed() const { return jumpSpeed_; }
+
+    /// Return maximum walkable slope in degrees.
+    float GetMaxSlope() const { return maxSlope_; }
+
+    /// Return the pending walk displacement per simulation step.
+    const Vector3& GetWalkIncrement() const { return walkIncrement_; }
+
+    /// Return whether the character is standing on the ground.
+    bool OnGround() const;
+    /// Return the character world space position.
+    Vector3 GetPosition() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Create the ghost object, sweep shape and Bullet controller and add them to the physics world.
+    void AddToWorld();
+    /// Remove the controller and the ghost object from the physics world and release the Bullet objects.
+    void RemoveFromWorld();
+    /// Apply the movement settings to the Bullet controller.
+    void ApplySettings();
+    /// Mark for re-adding to the world on ApplyAttributes.
+    void MarkControllerDirty();
+    /// Handle physics post-step. Apply the simulated ghost object transform to the node.
+    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
+
+    /// Physics world.
+    WeakPtr<PhysicsWorld> physicsWorld_;
+    /// Ghost object caching the overlapping broadphase pairs used by the movement sweeps.
+    ea::unique_ptr<btPairCachingGhostObject> ghostObject_;
+    /// Reused capsule sweep shape.
+    ea::unique_ptr<btCapsuleShape> shape_;
+    /// Bullet character controller, stepped as an action by the physics world simulation.
+    ea::unique_ptr<btKinematicCharacterController> controller_;
+    /// Collision layer.
+    unsigned collisionLayer_;
+    /// Collision mask.
+    unsigned collisionMask_;
+    /// Gravity.
+    Vector3 gravity_;
+    /// Capsule height.
+    float height_;
+    /// Capsule diameter.
+    float diameter_;
+    /// Capsule offset from the node position.
+    Vector3 offset_;
+    /// Maximum step height.
+    float stepHeight_;
+    /// Maximum jump height.
+    float maxJumpHeight_;
+    /// Maximum fall speed.
+    float fallSpeed_;
+    /// Jump speed.
+    float jumpSpeed_;
+    /// Maximum walkable slope in degrees.
+    float maxSlope_;
+    /// Pending walk displacement per simulation step.
+    Vector3 walkIncrement_;
+    /// Re-add to world flag for ApplyAttributes.
+    bool readdToWorld_;
+};
+
+}
@@ -25,14 +25,19 @@
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Mutex.h"
+#include "../Core/FrameBudget.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
 #include "../IO/Log.h"
 #include "../Math/Ray.h"
 #include "../Physics/CollisionShape.h"
 #include "../Physics/Constraint.h"
+#include "../Physics/KinematicCharacterController.h"
 #include "../Physics/PhysicsEvents.h"
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
@@ -43,6 +48,7 @@
 
 #include <Bullet/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <Bullet/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <Bullet/BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <Bullet/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h>
 #include <Bullet/BulletCollision/CollisionShapes/btBoxShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btSphereShape.h>
@@ -118,6 +124,23 @@ void CleanupGeometryCacheImpl(CollisionGeometryDataCache& cache)
     }
 }
 
+/// Shared state of a batched physics query, split into ranges across worker threads.
+struct PhysicsBatchQueryState
+{
+    /// Physics world.
+    const PhysicsWorld* world_;
+    /// Caller-provided result array, one entry per query.
+    PhysicsRaycastResult* results_;
+    /// Query ray array.
+    const Ray* rays_;
+    /// Sphere radius for sweeps.
+    float radius_;
+    /// Maximum hit distance.
+    float maxDistance_;
+    /// Collision mask for the queries.
+    unsigned collisionMask_;
+};
+
 /// Callback for physics world queries.
 struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
 {
@@ -163,6 +186,9 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
 
     broadphase_ = ea::make_unique<btDbvtBroadphase>();
+    // Keep ghost object pair caches up to date, e.g. for kinematic character controllers
+    ghostPairCallback_ = ea::make_unique<btGhostPairCallback>();
+    broadphase_->getOverlappingPairCache()->setInternalGhostPairCallback(ghostPairCallback_.get());
     solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
     world_ = ea::make_unique<btDiscreteDynamicsWorld>(collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
 
@@ -177,6 +203,8 @@ PhysicsWorld::PhysicsWorld(Context* context) :
 
 PhysicsWorld::~PhysicsWorld()
 {
+    FinishAsyncStep();
+
     if (scene_)
     {
         // Force all remaining constraints, rigid bodies and collision shapes to release themselves
@@ -211,6 +239,7 @@ void PhysicsWorld::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Solver Iterations", GetNumIterations, SetNumIterations, int, 10, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Net Max Angular Vel.", float, maxNetworkAngularVelocity_, DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Async Stepping", GetAsyncStepping, SetAsyncStepping, bool, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Internal Edge Utility", bool, internalEdge_, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Split Impulse", GetSplitImpulse, SetSplitImpulse, bool, false, AM_DEFAULT);
 }
@@ -259,7 +288,35 @@ void PhysicsWorld::draw3dText(const btVector3& location, const char* textString)
 void PhysicsWorld::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdatePhysics");
+    URHO3D_FRAME_BUDGET("Physics");
+
+    // Make sure any previous asynchronous step has been fully applied before starting a new one
+    FinishAsyncStep();
 
+    delayedWorldTransforms_.clear();
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (asyncStepping_ && queue && queue->GetNumThreads())
+    {
+        // Send the pre-step event on the main thread before handing the step to a worker
+        PreStep(timeStep);
+
+        simulating_ = true;
+        bufferingTransforms_ = true;
+        asyncStepTimeStep_ = timeStep;
+        asyncStepItem_ = queue->AddWorkItem([this, timeStep]() { StepSimulation(timeStep); });
+        return;
+    }
+
+    simulating_ = true;
+    StepSimulation(timeStep);
+    simulating_ = false;
+
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::StepSimulation(float timeStep)
+{
     float internalTimeStep = 1.0f / fps_;
     int maxSubSteps = (int)(timeStep * fps_) + 1;
     if (maxSubSteps_ < 0)
@@ -270,9 +327,6 @@ void PhysicsWorld::Update(float timeStep)
     else if (maxSubSteps_ > 0)
         maxSubSteps = Min(maxSubSteps, maxSubSteps_);
 
-    delayedWorldTransforms_.clear();
-    simulating_ = true;
-
     if (interpolation_)
         world_->stepSimulation(timeStep, maxSubSteps, internalTimeStep);
     else
@@ -285,9 +339,10 @@ void PhysicsWorld::Update(float timeStep)
             --maxSubSteps;
         }
     }
+}
 
-    simulating_ = false;
-
+void PhysicsWorld::ApplyDelayedWorldTransforms()
+{
     // Apply delayed (parented) world transforms now
     while (!delayedWorldTransforms_.empty())
     {
@@ -308,8 +363,58 @@ void PhysicsWorld::Update(float timeStep)
     }
 }
 
+void PhysicsWorld::FinishAsyncStep()
+{
+    if (!asyncStepItem_)
+        return;
+
+    {
+        URHO3D_PROFILE("WaitPhysicsStep");
+        while (!asyncStepItem_->completed_)
+            Time::Sleep(0);
+    }
+    asyncStepItem_.Reset();
+
+    bufferingTransforms_ = false;
+    simulating_ = false;
+
+    // Apply the double-buffered rigid body transforms on the main thread
+    for (const BufferedWorldTransform& transform : bufferedWorldTransforms_)
+        transform.rigidBody_->ApplySimulationTransform(transform.worldPosition_, transform.worldRotation_);
+    bufferedWorldTransforms_.clear();
+
+    ApplyDelayedWorldTransforms();
+
+    // Send the collision events and post-step event that were deferred from the worker thread
+    PostStep(asyncStepTimeStep_);
+}
+
+void PhysicsWorld::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    FinishAsyncStep();
+}
+
+void PhysicsWorld::SetAsyncStepping(bool enable)
+{
+    if (enable == asyncStepping_)
+        return;
+
+    FinishAsyncStep();
+    asyncStepping_ = enable;
+
+    if (enable)
+        SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(PhysicsWorld, HandleEndFrame));
+    else
+        UnsubscribeFromEvent(E_ENDFRAME);
+
+    MarkNetworkUpdate();
+}
+
 void PhysicsWorld::UpdateCollisions()
 {
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
     world_->performDiscreteCollisionDetection();
 }
 
@@ -374,6 +479,9 @@ void PhysicsWorld::SetMaxNetworkAngularVelocity(float velocity)
 
 void PhysicsWorld::Raycast(ea::vector<PhysicsRaycastResult>& result, const Ray& ray, float maxDistance, unsigned collisionMask)
 {
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsRaycast");
 
     if (maxDistance >= M_INFINITY)
@@ -402,11 +510,19 @@ void PhysicsWorld::Raycast(ea::vector<PhysicsRaycastResult>& result, const Ray&
 
 void PhysicsWorld::RaycastSingle(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, unsigned collisionMask)
 {
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsRaycastSingle");
 
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
 
+    RaycastSingleInternal(result, ray, maxDistance, collisionMask);
+}
+
+void PhysicsWorld::RaycastSingleInternal(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, unsigned collisionMask) const
+{
     btCollisionWorld::ClosestRayResultCallback
         rayCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ + maxDistance * ray.direction_));
     rayCallback.m_collisionFilterGroup = (short)0xffff;
@@ -432,6 +548,56 @@ void PhysicsWorld::RaycastSingle(PhysicsRaycastResult& result, const Ray& ray, f
     }
 }
 
+void PhysicsWorld::RaycastSingleBatch(PhysicsRaycastResult* results, const Ray* rays, unsigned numRays, float maxDistance, unsigned collisionMask)
+{
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
+    URHO3D_PROFILE("PhysicsRaycastBatch");
+
+    if (!results || !rays || !numRays)
+        return;
+
+    if (maxDistance >= M_INFINITY)
+        URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
+
+    PhysicsBatchQueryState state{this, results, rays, 0.0f, maxDistance, collisionMask};
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads() && numRays > 1)
+    {
+        // Split the batch into ranges, one per worker thread plus the main thread
+        const unsigned numThreads = queue->GetNumThreads() + 1;
+        const unsigned raysPerItem = (numRays + numThreads - 1) / numThreads;
+        for (unsigned start = 0; start < numRays; start += raysPerItem)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = RaycastBatchWork;
+            item->aux_ = &state;
+            item->start_ = const_cast<Ray*>(rays + start);
+            item->end_ = const_cast<Ray*>(rays + Min(start + raysPerItem, numRays));
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (unsigned i = 0; i < numRays; ++i)
+            RaycastSingleInternal(results[i], rays[i], maxDistance, collisionMask);
+    }
+}
+
+void PhysicsWorld::RaycastBatchWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* state = reinterpret_cast<PhysicsBatchQueryState*>(item->aux_);
+    const Ray* start = reinterpret_cast<const Ray*>(item->start_);
+    const Ray* end = reinterpret_cast<const Ray*>(item->end_);
+
+    for (const Ray* ray = start; ray != end; ++ray)
+        state->world_->RaycastSingleInternal(state->results_[ray - state->rays_], *ray, state->maxDistance_, state->collisionMask_);
+}
+
 void PhysicsWorld::RaycastSingleSegmented(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, float segmentDistance, unsigned collisionMask, float overlapDistance)
 {
     URHO3D_PROFILE("PhysicsRaycastSingleSegmented");
@@ -486,11 +652,19 @@ void PhysicsWorld::RaycastSingleSegmented(PhysicsRaycastResult& result, const Ra
 
 void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance, unsigned collisionMask)
 {
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsSphereCast");
 
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics sphere cast is not supported");
 
+    SphereCastInternal(result, ray, radius, maxDistance, collisionMask);
+}
+
+void PhysicsWorld::SphereCastInternal(PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance, unsigned collisionMask) const
+{
     btSphereShape shape(radius);
     Vector3 endPos = ray.origin_ + maxDistance * ray.direction_;
 
@@ -520,9 +694,61 @@ void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, floa
     }
 }
 
+void PhysicsWorld::SphereCastBatch(PhysicsRaycastResult* results, const Ray* rays, unsigned numRays, float radius, float maxDistance, unsigned collisionMask)
+{
+    // Complete an in-flight asynchronous step first; the Bullet world may not be queried while stepping
+    FinishAsyncStep();
+
+    URHO3D_PROFILE("PhysicsSphereCastBatch");
+
+    if (!results || !rays || !numRays)
+        return;
+
+    if (maxDistance >= M_INFINITY)
+        URHO3D_LOGWARNING("Infinite maxDistance in physics sphere cast is not supported");
+
+    PhysicsBatchQueryState state{this, results, rays, radius, maxDistance, collisionMask};
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads() && numRays > 1)
+    {
+        // Split the batch into ranges, one per worker thread plus the main thread
+        const unsigned numThreads = queue->GetNumThreads() + 1;
+        const unsigned raysPerItem = (numRays + numThreads - 1) / numThreads;
+        for (unsigned start = 0; start < numRays; start += raysPerItem)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = SphereCastBatchWork;
+            item->aux_ = &state;
+            item->start_ = const_cast<Ray*>(rays + start);
+            item->end_ = const_cast<Ray*>(rays + Min(start + raysPerItem, numRays));
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (unsigned i = 0; i < numRays; ++i)
+            SphereCastInternal(results[i], rays[i], radius, maxDistance, collisionMask);
+    }
+}
+
+void PhysicsWorld::SphereCastBatchWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* state = reinterpret_cast<PhysicsBatchQueryState*>(item->aux_);
+    const Ray* start = reinterpret_cast<const Ray*>(item->start_);
+    const Ray* end = reinterpret_cast<const Ray*>(item->end_);
+
+    for (const Ray* ray = start; ray != end; ++ray)
+        state->world_->SphereCastInternal(state->results_[ray - state->rays_], *ray, state->radius_, state->maxDistance_, state->collisionMask_);
+}
+
 void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, CollisionShape* shape, const Vector3& startPos,
     const Quaternion& startRot, const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask)
 {
+    FinishAsyncStep();
+
     if (!shape || !shape->GetCollisionShape())
     {
         URHO3D_LOGERROR("Null collision shape for convex cast");
@@ -564,6 +790,8 @@ void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, CollisionShape* shap
 void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, btCollisionShape* shape, const Vector3& startPos,
     const Quaternion& startRot, const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask)
 {
+    FinishAsyncStep();
+
     if (!shape)
     {
         URHO3D_LOGERROR("Null collision shape for convex cast");
@@ -623,6 +851,8 @@ void PhysicsWorld::RemoveCachedGeometry(Model* model)
 
 void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const Sphere& sphere, unsigned collisionMask)
 {
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsSphereQuery");
 
     result.clear();
@@ -642,6 +872,8 @@ void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const Sphere&
 
 void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const BoundingBox& box, unsigned collisionMask)
 {
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsBoxQuery");
 
     result.clear();
@@ -660,6 +892,8 @@ void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const Bounding
 
 void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const RigidBody* body)
 {
+    FinishAsyncStep();
+
     URHO3D_PROFILE("PhysicsBodyQuery");
 
     result.clear();
@@ -725,6 +959,9 @@ void PhysicsWorld::AddRigidBody(RigidBody* body)
 
 void PhysicsWorld::RemoveRigidBody(RigidBody* body)
 {
+    // The Bullet world may not be modified while a step is in flight
+    FinishAsyncStep();
+
     rigidBodies_.erase_first(body);
     // Remove possible dangling pointer from the delayedWorldTransforms structure
     delayedWorldTransforms_.erase(body);
@@ -755,6 +992,17 @@ void PhysicsWorld::AddDelayedWorldTransform(const DelayedWorldTransform& transfo
     delayedWorldTransforms_[transform.rigidBody_] = transform;
 }
 
+void PhysicsWorld::AddBufferedWorldTransform(RigidBody* body, const Vector3& position, const Quaternion& rotation)
+{
+    MutexLock lock(bufferedTransformMutex_);
+
+    BufferedWorldTransform transform;
+    transform.rigidBody_ = body;
+    transform.worldPosition_ = position;
+    transform.worldRotation_ = rotation;
+    bufferedWorldTransforms_.push_back(transform);
+}
+
 void PhysicsWorld::DrawDebugGeometry(bool depthTest)
 {
     auto* debug = GetComponent<DebugRenderer>();
@@ -781,27 +1029,31 @@ void PhysicsWorld::CleanupGeometryCache()
 
 void PhysicsWorld::OnSceneSet(Scene* scene)
 {
-    // Subscribe to the scene subsystem update, which will trigger the physics simulation step
+    // Subscribe to the scene subsystem update signal, which will trigger the physics simulation step
     if (scene)
     {
         scene_ = GetScene();
-        SubscribeToEvent(scene_, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld, HandleSceneSubsystemUpdate));
+        scene_->onSubsystemUpdate_.Unsubscribe(this);
+        scene_->onSubsystemUpdate_.Subscribe(this, &PhysicsWorld::HandleSceneSubsystemUpdate);
     }
-    else
-        UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+    else if (scene_)
+        scene_->onSubsystemUpdate_.Unsubscribe(this);
 }
 
-void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+void PhysicsWorld::HandleSceneSubsystemUpdate(float& timeStep)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace SceneSubsystemUpdate;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(timeStep);
 }
 
 void PhysicsWorld::PreStep(float timeStep)
 {
+    // In asynchronous mode the internal tick runs on a worker thread; the event has already been sent on the main thread
+    if (!Thread::IsMainThread())
+        return;
+
     // Send pre-step event
     using namespace PhysicsPreStep;
 
@@ -816,6 +1068,10 @@ void PhysicsWorld::PreStep(float timeStep)
 
 void PhysicsWorld::PostStep(float timeStep)
 {
+    // In asynchronous mode the internal tick runs on a worker thread; collision and post-step events are sent at the sync point
+    if (!Thread::IsMainThread())
+        return;
+
     // URHO3D_PROFILE_END();
 
     SendCollisionEvents();
@@ -841,6 +1097,11 @@ void PhysicsWorld::SendCollisionEvents()
 
     if (numManifolds)
     {
+        // Determine the world level event subscriptions once per step, so that event construction can be skipped
+        // entirely for pairs that nobody listens to
+        const bool worldCollisionStart = HasEventReceivers(E_PHYSICSCOLLISIONSTART);
+        const bool worldCollision = HasEventReceivers(E_PHYSICSCOLLISION);
+
         physicsCollisionData_[PhysicsCollision::P_WORLD] = this;
 
         for (int i = 0; i < numManifolds; ++i)
@@ -867,6 +1128,8 @@ void PhysicsWorld::SendCollisionEvents()
             if (bodyA->GetCollisionEventMode() == COLLISION_ACTIVE && bodyB->GetCollisionEventMode() == COLLISION_ACTIVE &&
                 !bodyA->IsActive() && !bodyB->IsActive())
                 continue;
+            if (!(bodyA->GetCollisionEventMask() | bodyB->GetCollisionEventMask()))
+                continue;
 
             WeakPtr<RigidBody> bodyWeakA(bodyA);
             WeakPtr<RigidBody> bodyWeakB(bodyB);
@@ -902,25 +1165,39 @@ void PhysicsWorld::SendCollisionEvents()
             bool trigger = bodyA->IsTrigger() || bodyB->IsTrigger();
             bool newCollision = !previousCollisions_.contains(i->first);
 
-            physicsCollisionData_[PhysicsCollision::P_NODEA] = nodeA;
-            physicsCollisionData_[PhysicsCollision::P_NODEB] = nodeB;
-            physicsCollisionData_[PhysicsCollision::P_BODYA] = bodyA;
-            physicsCollisionData_[PhysicsCollision::P_BODYB] = bodyB;
-            physicsCollisionData_[PhysicsCollision::P_TRIGGER] = trigger;
+            // Determine the listeners of each event category up front, so that contact packing and event construction
+            // can be skipped when nobody would receive the events
+            const unsigned eventMask = bodyA->GetCollisionEventMask() | bodyB->GetCollisionEventMask();
+            const bool start = newCollision && (eventMask & COLLISION_EVENT_START);
+            const bool ongoing = (eventMask & COLLISION_EVENT_ONGOING) != 0;
+            const bool sendWorldStart = start && worldCollisionStart;
+            const bool sendWorldOngoing = ongoing && worldCollision;
+            const bool sendNodeAStart = start && HasNodeEventReceivers(nodeA, E_NODECOLLISIONSTART);
+            const bool sendNodeAOngoing = ongoing && HasNodeEventReceivers(nodeA, E_NODECOLLISION);
+            const bool sendNodeBStart = start && HasNodeEventReceivers(nodeB, E_NODECOLLISIONSTART);
+            const bool sendNodeBOngoing = ongoing && HasNodeEventReceivers(nodeB, E_NODECOLLISION);
+
+            // The pair stays tracked for collision end detection even when no events are sent
+            if (!sendWorldStart && !sendWorldOngoing && !sendNodeAStart && !sendNodeAOngoing && !sendNodeBStart &&
+                !sendNodeBOngoing)
+                continue;
 
-            contacts_.Clear();
+            // Pack the contacts once into the pooled buffer, from body A's perspective
+            contactBuffer_.clear();
 
-            // "Pointers not flipped"-manifold, send unmodified normals
+            // "Pointers not flipped"-manifold, store unmodified normals
             btPersistentManifold* contactManifold = i->second.manifold_;
             if (contactManifold)
             {
                 for (int j = 0; j < contactManifold->getNumContacts(); ++j)
                 {
                     btManifoldPoint& point = contactManifold->getContactPoint(j);
-                    contacts_.WriteVector3(ToVector3(point.m_positionWorldOnB));
-                    contacts_.WriteVector3(ToVector3(point.m_normalWorldOnB));
-                    contacts_.WriteFloat(point.m_distance1);
-                    contacts_.WriteFloat(point.m_appliedImpulse);
+                    PhysicsContact contact;
+                    contact.position_ = ToVector3(point.m_positionWorldOnB);
+                    contact.normal_ = ToVector3(point.m_normalWorldOnB);
+                    contact.distance_ = point.m_distance1;
+                    contact.impulse_ = point.m_appliedImpulse;
+                    contactBuffer_.push_back(contact);
                 }
             }
             // "Pointers flipped"-manifold, flip normals also
@@ -930,91 +1207,96 @@ void PhysicsWorld::SendCollisionEvents()
                 for (int j = 0; j < contactManifold->getNumContacts(); ++j)
                 {
                     btManifoldPoint& point = contactManifold->getContactPoint(j);
-                    contacts_.WriteVector3(ToVector3(point.m_positionWorldOnB));
-                    contacts_.WriteVector3(-ToVector3(point.m_normalWorldOnB));
-                    contacts_.WriteFloat(point.m_distance1);
-                    contacts_.WriteFloat(point.m_appliedImpulse);
+                    PhysicsContact contact;
+                    contact.position_ = ToVector3(point.m_positionWorldOnB);
+                    contact.normal_ = -ToVector3(point.m_normalWorldOnB);
+                    contact.distance_ = point.m_distance1;
+                    contact.impulse_ = point.m_appliedImpulse;
+                    contactBuffer_.push_back(contact);
                 }
             }
 
-            physicsCollisionData_[PhysicsCollision::P_CONTACTS] = contacts_.GetBuffer();
+            if (sendWorldStart || sendWorldOngoing || sendNodeAStart || sendNodeAOngoing)
+                WriteContacts(false);
 
-            // Send separate collision start event if collision is new
-            if (newCollision)
+            if (sendWorldStart || sendWorldOngoing)
             {
-                SendEvent(E_PHYSICSCOLLISIONSTART, physicsCollisionData_);
-                // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
-                if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                    continue;
-            }
-
-            // Then send the ongoing collision event
-            SendEvent(E_PHYSICSCOLLISION, physicsCollisionData_);
-            if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                continue;
+                physicsCollisionData_[PhysicsCollision::P_NODEA] = nodeA;
+                physicsCollisionData_[PhysicsCollision::P_NODEB] = nodeB;
+                physicsCollisionData_[PhysicsCollision::P_BODYA] = bodyA;
+                physicsCollisionData_[PhysicsCollision::P_BODYB] = bodyB;
+                physicsCollisionData_[PhysicsCollision::P_TRIGGER] = trigger;
+                physicsCollisionData_[PhysicsCollision::P_CONTACTS] = contacts_.GetBuffer();
+
+                // Send separate collision start event if collision is new
+                if (sendWorldStart)
+                {
+                    SendEvent(E_PHYSICSCOLLISIONSTART, physicsCollisionData_);
+                    // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
+                }
 
-            nodeCollisionData_[NodeCollision::P_BODY] = bodyA;
-            nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeB;
-            nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyB;
-            nodeCollisionData_[NodeCollision::P_TRIGGER] = trigger;
-            nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
+                // Then send the ongoing collision event
+                if (sendWorldOngoing)
+                {
+                    SendEvent(E_PHYSICSCOLLISION, physicsCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
+                }
+            }
 
-            if (newCollision)
+            if (sendNodeAStart || sendNodeAOngoing)
             {
-                nodeA->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
-                if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                    continue;
-            }
+                nodeCollisionData_[NodeCollision::P_BODY] = bodyA;
+                nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeB;
+                nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyB;
+                nodeCollisionData_[NodeCollision::P_TRIGGER] = trigger;
+                nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
 
-            nodeA->SendEvent(E_NODECOLLISION, nodeCollisionData_);
-            if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                continue;
+                if (sendNodeAStart)
+                {
+                    nodeA->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
+                }
 
-            // Flip perspective to body B
-            contacts_.Clear();
-            contactManifold = i->second.manifold_;
-            if (contactManifold)
-            {
-                for (int j = 0; j < contactManifold->getNumContacts(); ++j)
+                if (sendNodeAOngoing)
                 {
-                    btManifoldPoint& point = contactManifold->getContactPoint(j);
-                    contacts_.WriteVector3(ToVector3(point.m_positionWorldOnB));
-                    contacts_.WriteVector3(-ToVector3(point.m_normalWorldOnB));
-                    contacts_.WriteFloat(point.m_distance1);
-                    contacts_.WriteFloat(point.m_appliedImpulse);
+                    nodeA->SendEvent(E_NODECOLLISION, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
                 }
             }
-            contactManifold = i->second.flippedManifold_;
-            if (contactManifold)
+
+            if (sendNodeBStart || sendNodeBOngoing)
             {
-                for (int j = 0; j < contactManifold->getNumContacts(); ++j)
+                // Flip perspective to body B
+                WriteContacts(true);
+
+                nodeCollisionData_[NodeCollision::P_BODY] = bodyB;
+                nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeA;
+                nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyA;
+                nodeCollisionData_[NodeCollision::P_TRIGGER] = trigger;
+                nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
+
+                if (sendNodeBStart)
                 {
-                    btManifoldPoint& point = contactManifold->getContactPoint(j);
-                    contacts_.WriteVector3(ToVector3(point.m_positionWorldOnB));
-                    contacts_.WriteVector3(ToVector3(point.m_normalWorldOnB));
-                    contacts_.WriteFloat(point.m_distance1);
-                    contacts_.WriteFloat(point.m_appliedImpulse);
+                    nodeB->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
                 }
-            }
-
-            nodeCollisionData_[NodeCollision::P_BODY] = bodyB;
-            nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeA;
-            nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyA;
-            nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
 
-            if (newCollision)
-            {
-                nodeB->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
-                if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                    continue;
+                if (sendNodeBOngoing)
+                    nodeB->SendEvent(E_NODECOLLISION, nodeCollisionData_);
             }
-
-            nodeB->SendEvent(E_NODECOLLISION, nodeCollisionData_);
         }
     }
 
     // Send collision end events as applicable
     {
+        const bool worldCollisionEnd = HasEventReceivers(E_PHYSICSCOLLISIONEND);
+
         physicsCollisionData_[PhysicsCollisionEnd::P_WORLD] = this;
 
         for (auto
@@ -1037,37 +1319,52 @@ void PhysicsWorld::SendCollisionEvents()
                 if (bodyA->GetCollisionEventMode() == COLLISION_ACTIVE && bodyB->GetCollisionEventMode() == COLLISION_ACTIVE &&
                     !bodyA->IsActive() && !bodyB->IsActive())
                     continue;
+                if (!((bodyA->GetCollisionEventMask() | bodyB->GetCollisionEventMask()) & COLLISION_EVENT_END))
+                    continue;
 
                 Node* nodeA = bodyA->GetNode();
                 Node* nodeB = bodyB->GetNode();
                 WeakPtr<Node> nodeWeakA(nodeA);
                 WeakPtr<Node> nodeWeakB(nodeB);
 
-                physicsCollisionData_[PhysicsCollisionEnd::P_BODYA] = bodyA;
-                physicsCollisionData_[PhysicsCollisionEnd::P_BODYB] = bodyB;
-                physicsCollisionData_[PhysicsCollisionEnd::P_NODEA] = nodeA;
-                physicsCollisionData_[PhysicsCollisionEnd::P_NODEB] = nodeB;
-                physicsCollisionData_[PhysicsCollisionEnd::P_TRIGGER] = trigger;
-
-                SendEvent(E_PHYSICSCOLLISIONEND, physicsCollisionData_);
-                // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
-                if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                    continue;
+                const bool sendNodeAEnd = HasNodeEventReceivers(nodeA, E_NODECOLLISIONEND);
+                const bool sendNodeBEnd = HasNodeEventReceivers(nodeB, E_NODECOLLISIONEND);
 
-                nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyA;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeB;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyB;
-                nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
+                if (worldCollisionEnd)
+                {
+                    physicsCollisionData_[PhysicsCollisionEnd::P_BODYA] = bodyA;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_BODYB] = bodyB;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_NODEA] = nodeA;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_NODEB] = nodeB;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_TRIGGER] = trigger;
+
+                    SendEvent(E_PHYSICSCOLLISIONEND, physicsCollisionData_);
+                    // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
+                }
 
-                nodeA->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
-                if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
-                    continue;
+                if (sendNodeAEnd)
+                {
+                    nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyA;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeB;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyB;
+                    nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
+
+                    nodeA->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first.first || !i->first.second)
+                        continue;
+                }
 
-                nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyB;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeA;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyA;
+                if (sendNodeBEnd)
+                {
+                    nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyB;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeA;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyA;
+                    nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
 
-                nodeB->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                    nodeB->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                }
             }
         }
     }
@@ -1075,6 +1372,41 @@ void PhysicsWorld::SendCollisionEvents()
     previousCollisions_ = currentCollisions_;
 }
 
+bool PhysicsWorld::HasEventReceivers(StringHash eventType)
+{
+    // A group may conservatively report receivers that are queued for removal
+    EventReceiverGroup* group = context_->GetEventReceivers(eventType);
+    if (group && !group->receivers_.empty())
+        return true;
+
+    group = context_->GetEventReceivers(this, eventType);
+    return group && !group->receivers_.empty();
+}
+
+bool PhysicsWorld::HasNodeEventReceivers(Node* node, StringHash eventType)
+{
+    EventReceiverGroup* group = context_->GetEventReceivers(eventType);
+    if (group && !group->receivers_.empty())
+        return true;
+
+    group = context_->GetEventReceivers(node, eventType);
+    return group && !group->receivers_.empty();
+}
+
+void PhysicsWorld::WriteContacts(bool flipNormals)
+{
+    contacts_.Clear();
+
+    for (unsigned i = 0; i < contactBuffer_.size(); ++i)
+    {
+        const PhysicsContact& contact = contactBuffer_[i];
+        contacts_.WriteVector3(contact.position_);
+        contacts_.WriteVector3(flipNormals ? -contact.normal_ : contact.normal_);
+        contacts_.WriteFloat(contact.distance_);
+        contacts_.WriteFloat(contact.impulse_);
+    }
+}
+
 void RegisterPhysicsLibrary(Context* context)
 {
     CollisionShape::RegisterObject(context);
@@ -1082,6 +1414,7 @@ void RegisterPhysicsLibrary(Context* context)
     Constraint::RegisterObject(context);
     PhysicsWorld::RegisterObject(context);
     RaycastVehicle::RegisterObject(context);
+    KinematicCharacterController::RegisterObject(context);
 }
 
 }
@@ -24,6 +24,7 @@
 
 #include <EASTL/unique_ptr.h>
 
+#include "../Core/Mutex.h"
 #include "../IO/VectorBuffer.h"
 #include "../Math/BoundingBox.h"
 #include "../Math/Sphere.h"
@@ -39,6 +40,7 @@ class btConstraintSolver;
 class btDiscreteDynamicsWorld;
 class btDispatcher;
 class btDynamicsWorld;
+class btGhostPairCallback;
 class btPersistentManifold;
 
 namespace Urho3D
@@ -53,6 +55,7 @@ class Ray;
 class RigidBody;
 class Scene;
 class Serializer;
+struct WorkItem;
 class XMLElement;
 
 struct CollisionGeometryData;
@@ -91,6 +94,30 @@ struct DelayedWorldTransform
     Quaternion worldRotation_;
 };
 
+/// Buffered world transform assignment produced by an asynchronous simulation step. Applied on the main thread at the sync point.
+struct BufferedWorldTransform
+{
+    /// Rigid body.
+    RigidBody* rigidBody_;
+    /// New world position.
+    Vector3 worldPosition_;
+    /// New world rotation.
+    Quaternion worldRotation_;
+};
+
+/// Pooled contact of a colliding rigid body pair, stored from body A's perspective.
+struct PhysicsContact
+{
+    /// Contact position in world space.
+    Vector3 position_;
+    /// Contact normal in world space.
+    Vector3 normal_;
+    /// Contact distance. Negative when penetrating.
+    float distance_;
+    /// Applied impulse.
+    float impulse_;
+};
+
 /// Manifold pointers stored during collision processing.
 struct ManifoldPair
 {
@@ -178,6 +205,8 @@ public:
     void SetUpdateEnabled(bool enable);
     /// Set whether to interpolate between simulation steps.
     void SetInterpolation(bool enable);
+    /// Set whether to step the simulation asynchronously on a worker thread, overlapped with rendering. Rigid body transforms and collision events are buffered and applied at the end of the frame, so simulation results arrive with one frame of latency and the pre-step and post-step events are sent once per frame instead of once per substep. Disabled by default.
+    void SetAsyncStepping(bool enable);
     /// Set whether to use Bullet's internal edge utility for trimesh collisions. Disabled by default.
     void SetInternalEdge(bool enable);
     /// Set split impulse collision mode. This is more accurate, but slower. Disabled by default.
@@ -192,9 +221,13 @@ public:
     /// Perform a physics world segmented raycast and return the closest hit. Useful for big scenes with many bodies.
     /// overlapDistance is used to make sure there are no gap between segments, and must be smaller than segmentDistance.
     void RaycastSingleSegmented(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, float segmentDistance, unsigned collisionMask = M_MAX_UNSIGNED, float overlapDistance = 0.1f);
+    /// Perform a batch of physics world raycasts in parallel across worker threads and write the closest hit of each ray into the caller-provided result array. The result array must hold numRays entries; no per-query allocation is performed.
+    void RaycastSingleBatch(PhysicsRaycastResult* results, const Ray* rays, unsigned numRays, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
     /// Perform a physics world swept sphere test and return the closest hit.
     void SphereCast
         (PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Perform a batch of physics world swept sphere tests in parallel across worker threads and write the closest hit of each sweep into the caller-provided result array. The result array must hold numRays entries; no per-query allocation is performed.
+    void SphereCastBatch(PhysicsRaycastResult* results, const Ray* rays, unsigned numRays, float radius, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
     /// Perform a physics world swept convex test using a user-supplied collision shape and return the first hit.
     void ConvexCast(PhysicsRaycastResult& result, CollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
         const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask = M_MAX_UNSIGNED);
@@ -212,6 +245,10 @@ public:
     /// Return rigid bodies that have been in collision with the specified body on the last simulation step. Only returns collisions that were sent as events (depends on collision event mode) and excludes e.g. static-static collisions.
     void GetCollidingBodies(ea::vector<RigidBody*>& result, const RigidBody* body);
 
+    /// Return the pooled contacts of the collision currently being reported, from body A's perspective. Valid only
+    /// during collision event handling; negate the normals for body B's perspective.
+    const ea::vector<PhysicsContact>& GetCurrentContacts() const { return contactBuffer_; }
+
     /// Return gravity.
     Vector3 GetGravity() const;
 
@@ -227,6 +264,9 @@ public:
     /// Return whether interpolation between simulation steps is enabled.
     bool GetInterpolation() const { return interpolation_; }
 
+    /// Return whether asynchronous simulation stepping is enabled.
+    bool GetAsyncStepping() const { return asyncStepping_; }
+
     /// Return whether Bullet's internal edge utility for trimesh collisions is enabled.
     bool GetInternalEdge() const { return internalEdge_; }
 
@@ -253,6 +293,8 @@ public:
     void RemoveConstraint(Constraint* constraint);
     /// Add a delayed world transform assignment. Called by RigidBody.
     void AddDelayedWorldTransform(const DelayedWorldTransform& transform);
+    /// Add a buffered world transform assignment during an asynchronous simulation step. Called by RigidBody from the worker thread.
+    void AddBufferedWorldTransform(RigidBody* body, const Vector3& position, const Quaternion& rotation);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry(bool depthTest);
     /// Set debug renderer to use. Called both by PhysicsWorld itself and physics components.
@@ -284,6 +326,13 @@ public:
     /// Return whether is currently inside the Bullet substep loop.
     bool IsSimulating() const { return simulating_; }
 
+    /// Return whether an asynchronous simulation step is in flight and rigid body transforms should be buffered.
+    bool IsBufferingTransforms() const { return bufferingTransforms_; }
+
+    /// Wait for an in-flight asynchronous step, then apply buffered transforms and send the deferred collision and
+    /// post-step events. No-op if no step is in flight. Called automatically before modifications of the Bullet world.
+    void FinishAsyncStep();
+
     /// Overrides of the internal configuration.
     static struct PhysicsWorldConfig config;
 
@@ -293,13 +342,33 @@ protected:
 
 private:
     /// Handle the scene subsystem update event, step simulation here.
-    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneSubsystemUpdate(float& timeStep);
+    /// Handle the end of frame, the asynchronous step sync point.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Execute the Bullet simulation step. Runs on a worker thread in asynchronous mode.
+    void StepSimulation(float timeStep);
+    /// Apply delayed (parented) world transforms.
+    void ApplyDelayedWorldTransforms();
+    /// Perform a single raycast without completing asynchronous work first. Thread-safe as long as the world is not stepped or modified concurrently.
+    void RaycastSingleInternal(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, unsigned collisionMask) const;
+    /// Perform a single swept sphere test without completing asynchronous work first. Thread-safe as long as the world is not stepped or modified concurrently.
+    void SphereCastInternal(PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance, unsigned collisionMask) const;
+    /// Work function for a range of a batched raycast.
+    static void RaycastBatchWork(const WorkItem* item, unsigned threadIndex);
+    /// Work function for a range of a batched sphere cast.
+    static void SphereCastBatchWork(const WorkItem* item, unsigned threadIndex);
     /// Trigger update before each physics simulation step.
     void PreStep(float timeStep);
     /// Trigger update after each physics simulation step.
     void PostStep(float timeStep);
     /// Send accumulated collision events.
     void SendCollisionEvents();
+    /// Return whether anyone subscribes to the given event, either specifically from this physics world or from any sender.
+    bool HasEventReceivers(StringHash eventType);
+    /// Return whether anyone subscribes to the given event, either specifically from the given node or from any sender.
+    bool HasNodeEventReceivers(Node* node, StringHash eventType);
+    /// Serialize the pooled contacts into the contact byte buffer, optionally flipping the normals to body B's perspective.
+    void WriteContacts(bool flipNormals);
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_{};
@@ -307,6 +376,8 @@ private:
     ea::unique_ptr<btDispatcher> collisionDispatcher_;
     /// Bullet collision broadphase.
     ea::unique_ptr<btBroadphaseInterface> broadphase_;
+    /// Callback keeping the overlapping pair caches of ghost objects up to date.
+    ea::unique_ptr<btGhostPairCallback> ghostPairCallback_;
     /// Bullet constraint solver.
     ea::unique_ptr<btConstraintSolver> solver_;
     /// Bullet physics world.
@@ -325,6 +396,14 @@ private:
     ea::unordered_map<ea::pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair> previousCollisions_;
     /// Delayed (parented) world transform assignments.
     ea::unordered_map<RigidBody*, DelayedWorldTransform> delayedWorldTransforms_;
+    /// Buffered world transform assignments from the asynchronous simulation step.
+    ea::vector<BufferedWorldTransform> bufferedWorldTransforms_;
+    /// Mutex for the buffered world transforms.
+    Mutex bufferedTransformMutex_;
+    /// Work item for the in-flight asynchronous simulation step.
+    SharedPtr<WorkItem> asyncStepItem_;
+    /// Timestep of the in-flight asynchronous step.
+    float asyncStepTimeStep_{};
     /// Cache for trimesh geometry data by model and LOD level.
     CollisionGeometryDataCache triMeshCache_;
     /// Cache for convex geometry data by model and LOD level.
@@ -337,6 +416,8 @@ private:
     VariantMap nodeCollisionData_;
     /// Preallocated buffer for physics collision contact data.
     VectorBuffer contacts_;
+    /// Pooled contacts of the collision pair currently being reported.
+    ea::vector<PhysicsContact> contactBuffer_;
     /// Simulation substeps per second.
     unsigned fps_{DEFAULT_FPS};
     /// Maximum number of simulation substeps per frame. 0 (default) unlimited, or negative values for adaptive timestep.
@@ -355,6 +436,10 @@ private:
     bool applyingTransforms_{};
     /// Simulating flag.
     bool simulating_{};
+    /// Asynchronous stepping enabled flag.
+    bool asyncStepping_{};
+    /// Buffering transforms flag, set while an asynchronous step is in flight.
+    volatile bool bufferingTransforms_{};
     /// Debug draw depth test mode.
     bool debugDepthTest_{};
     /// Debug renderer.
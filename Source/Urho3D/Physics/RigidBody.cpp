@@ -44,6 +44,8 @@
 namespace Urho3D
 {
 
+URHO3D_DEFINE_OBJECT_POOL(RigidBody)
+
 static const float DEFAULT_MASS = 0.0f;
 static const float DEFAULT_FRICTION = 0.5f;
 static const float DEFAULT_RESTITUTION = 0.0f;
@@ -69,6 +71,7 @@ RigidBody::RigidBody(Context* context) :
     collisionLayer_(DEFAULT_COLLISION_LAYER),
     collisionMask_(DEFAULT_COLLISION_MASK),
     collisionEventMode_(COLLISION_ACTIVE),
+    collisionEventMask_(COLLISION_EVENT_ALL),
     lastPosition_(Vector3::ZERO),
     lastRotation_(Quaternion::IDENTITY),
     kinematic_(false),
@@ -122,6 +125,7 @@ void RigidBody::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Network Angular Velocity", GetNetAngularVelocityAttr, SetNetAngularVelocityAttr, ea::vector<unsigned char>,
         Variant::emptyBuffer, AM_NET | AM_LATESTDATA | AM_NOEDIT);
     URHO3D_ENUM_ATTRIBUTE_EX("Collision Event Mode", collisionEventMode_, MarkBodyDirty, collisionEventModeNames, COLLISION_ACTIVE, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Collision Event Mask", unsigned, collisionEventMask_, COLLISION_EVENT_ALL, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Use Gravity", GetUseGravity, SetUseGravity, bool, true, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Is Kinematic", bool, kinematic_, MarkBodyDirty, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Is Trigger", bool, trigger_, MarkBodyDirty, false, AM_DEFAULT);
@@ -166,34 +170,43 @@ void RigidBody::setWorldTransform(const btTransform& worldTrans)
 
     Quaternion newWorldRotation = ToQuaternion(worldTrans.getRotation());
     Vector3 newWorldPosition = ToVector3(worldTrans.getOrigin()) - newWorldRotation * centerOfMass_;
-    RigidBody* parentRigidBody = nullptr;
 
+    // During an asynchronous simulation step the scene graph must not be touched; buffer the transform for the sync point
+    if (physicsWorld_ && physicsWorld_->IsBufferingTransforms())
+        physicsWorld_->AddBufferedWorldTransform(this, newWorldPosition, newWorldRotation);
+    else
+        ApplySimulationTransform(newWorldPosition, newWorldRotation);
+
+    hasSimulated_ = true;
+}
+
+void RigidBody::ApplySimulationTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation)
+{
     // It is possible that the RigidBody component has been kept alive via a shared pointer,
     // while its scene node has already been destroyed
-    if (node_)
-    {
-        // If the rigid body is parented to another rigid body, can not set the transform immediately.
-        // In that case store it to PhysicsWorld for delayed assignment
-        Node* parent = node_->GetParent();
-        if (parent != GetScene() && parent)
-            parentRigidBody = parent->GetComponent<RigidBody>();
-
-        if (!parentRigidBody)
-            ApplyWorldTransform(newWorldPosition, newWorldRotation);
-        else
-        {
-            DelayedWorldTransform delayed;
-            delayed.rigidBody_ = this;
-            delayed.parentRigidBody_ = parentRigidBody;
-            delayed.worldPosition_ = newWorldPosition;
-            delayed.worldRotation_ = newWorldRotation;
-            physicsWorld_->AddDelayedWorldTransform(delayed);
-        }
+    if (!node_)
+        return;
 
-        MarkNetworkUpdate();
+    // If the rigid body is parented to another rigid body, can not set the transform immediately.
+    // In that case store it to PhysicsWorld for delayed assignment
+    RigidBody* parentRigidBody = nullptr;
+    Node* parent = node_->GetParent();
+    if (parent != GetScene() && parent)
+        parentRigidBody = parent->GetComponent<RigidBody>();
+
+    if (!parentRigidBody)
+        ApplyWorldTransform(newWorldPosition, newWorldRotation);
+    else
+    {
+        DelayedWorldTransform delayed;
+        delayed.rigidBody_ = this;
+        delayed.parentRigidBody_ = parentRigidBody;
+        delayed.worldPosition_ = newWorldPosition;
+        delayed.worldRotation_ = newWorldRotation;
+        physicsWorld_->AddDelayedWorldTransform(delayed);
     }
 
-    hasSimulated_ = true;
+    MarkNetworkUpdate();
 }
 
 void RigidBody::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -513,6 +526,12 @@ void RigidBody::SetCollisionEventMode(CollisionEventMode mode)
     MarkNetworkUpdate();
 }
 
+void RigidBody::SetCollisionEventMask(unsigned mask)
+{
+    collisionEventMask_ = mask;
+    MarkNetworkUpdate();
+}
+
 void RigidBody::ApplyForce(const Vector3& force)
 {
     if (body_ && force != Vector3::ZERO)
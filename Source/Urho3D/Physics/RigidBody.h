@@ -48,10 +48,20 @@ enum CollisionEventMode
     COLLISION_ALWAYS
 };
 
+/// Collision start events.
+static const unsigned COLLISION_EVENT_START = 0x1;
+/// Ongoing collision events.
+static const unsigned COLLISION_EVENT_ONGOING = 0x2;
+/// Collision end events.
+static const unsigned COLLISION_EVENT_END = 0x4;
+/// All collision event categories.
+static const unsigned COLLISION_EVENT_ALL = 0x7;
+
 /// Physics rigid body component.
 class URHO3D_API RigidBody : public Component, public btMotionState
 {
     URHO3D_OBJECT(RigidBody, Component);
+    URHO3D_OBJECT_POOL(RigidBody);
 
 public:
     /// Construct.
@@ -126,6 +136,9 @@ public:
     void SetCollisionLayerAndMask(unsigned layer, unsigned mask);
     /// Set collision event signaling mode. Default is to signal when rigid bodies are active.
     void SetCollisionEventMode(CollisionEventMode mode);
+    /// Set which collision event categories the body participates in, as a combination of COLLISION_EVENT bits.
+    /// Events of a category are sent when either body of a colliding pair has the corresponding bit set. Default all.
+    void SetCollisionEventMask(unsigned mask);
     /// Apply force to center of mass.
     void ApplyForce(const Vector3& force);
     /// Apply force at local position.
@@ -225,11 +238,16 @@ public:
     /// Return collision event signaling mode.
     CollisionEventMode GetCollisionEventMode() const { return collisionEventMode_; }
 
+    /// Return collision event category mask.
+    unsigned GetCollisionEventMask() const { return collisionEventMask_; }
+
     /// Return colliding rigid bodies from the last simulation step. Only returns collisions that were sent as events (depends on collision event mode) and excludes e.g. static-static collisions.
     void GetCollidingBodies(ea::vector<RigidBody*>& result) const;
 
     /// Apply new world transform after a simulation step. Called internally.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
+    /// Apply a world transform produced by the simulation, deferring parented bodies. Called internally and by PhysicsWorld at the asynchronous step sync point.
+    void ApplySimulationTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
     /// Update mass and inertia to the Bullet rigid body. Readd body to world if necessary: if was in world and the Bullet collision shape to use changed.
     void UpdateMass();
     /// Update gravity parameters to the Bullet rigid body.
@@ -291,6 +309,8 @@ private:
     unsigned collisionMask_;
     /// Collision event signaling mode.
     CollisionEventMode collisionEventMode_;
+    /// Collision event category mask.
+    unsigned collisionEventMask_;
     /// Last interpolated position from the simulation.
     mutable Vector3 lastPosition_;
     /// Last interpolated rotation from the simulation.
@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifdef URHO3D_THREADING
+
+#include "../Precompiled.h"
+
+#include "../Core/StringUtils.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../IO/File.h"
+#include "../Resource/AsyncFileReader.h"
+#include "../Resource/ResourceCache.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Number of reader threads. Enough to keep several requests in flight so that disk latency overlaps, without causing
+/// excessive seek contention on slow media.
+static const unsigned NUM_READER_THREADS = 4;
+
+/// Worker thread managed by the asynchronous file reader.
+class AsyncReaderThread : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit AsyncReaderThread(AsyncFileReader* owner) :
+        owner_(owner)
+    {
+    }
+
+    /// Process read requests until stopped.
+    void ThreadFunction() override
+    {
+        owner_->ProcessReadRequests();
+    }
+
+private:
+    /// Asynchronous file reader.
+    AsyncFileReader* owner_;
+};
+
+AsyncFileReader::AsyncFileReader(ResourceCache* owner) :
+    owner_(owner)
+{
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    shouldRun_ = false;
+    for (unsigned i = 0; i < threads_.size(); ++i)
+        threads_[i]->Stop();
+    threads_.clear();
+
+    MutexLock lock(requestMutex_);
+    requests_.clear();
+}
+
+void AsyncFileReader::QueueRead(const ea::string& name, int priority)
+{
+    MutexLock lock(requestMutex_);
+
+    for (auto i = requests_.begin(); i != requests_.end(); ++i)
+    {
+        if (i->name_ == name)
+        {
+            if (priority > i->priority_)
+                i->priority_ = priority;
+            return;
+        }
+    }
+
+    AsyncReadRequest request;
+    request.name_ = name;
+    request.priority_ = priority;
+    requests_.push_back(request);
+
+    StartReaderThreads();
+}
+
+bool AsyncFileReader::WaitForRead(const ea::string& name, ea::shared_array<unsigned char>& data, unsigned& size)
+{
+    for (;;)
+    {
+        requestMutex_.Acquire();
+
+        auto i = requests_.begin();
+        while (i != requests_.end() && i->name_ != name)
+            ++i;
+
+        if (i == requests_.end())
+        {
+            requestMutex_.Release();
+            return false;
+        }
+
+        if (i->state_ == READ_SUCCESS || i->state_ == READ_FAIL)
+        {
+            bool success = i->state_ == READ_SUCCESS;
+            data = i->data_;
+            size = i->size_;
+            requests_.erase(i);
+            requestMutex_.Release();
+            return success;
+        }
+
+        // Still queued or being read by a reader thread; other reads keep progressing while we wait
+        requestMutex_.Release();
+        Time::Sleep(1);
+    }
+}
+
+unsigned AsyncFileReader::GetNumPendingReads() const
+{
+    MutexLock lock(requestMutex_);
+
+    unsigned count = 0;
+    for (auto i = requests_.begin(); i != requests_.end(); ++i)
+    {
+        if (i->state_ == READ_QUEUED || i->state_ == READ_READING)
+            ++count;
+    }
+    return count;
+}
+
+void AsyncFileReader::ProcessReadRequests()
+{
+    while (shouldRun_)
+    {
+        requestMutex_.Acquire();
+
+        // Claim the highest priority request that has not been started yet; ties are broken by queuing order
+        AsyncReadRequest* request = nullptr;
+        for (auto i = requests_.begin(); i != requests_.end(); ++i)
+        {
+            if (i->state_ == READ_QUEUED && (!request || i->priority_ > request->priority_))
+                request = &(*i);
+        }
+        if (request)
+            request->state_ = READ_READING;
+        requestMutex_.Release();
+
+        if (!request)
+        {
+            Time::Sleep(5);
+            continue;
+        }
+
+        // The request stays in the queue while in flight, so the pointer remains valid without holding the mutex
+        ea::shared_array<unsigned char> data;
+        unsigned size = 0;
+        SharedPtr<File> file = owner_->GetFile(request->name_, false);
+        if (file && file->IsOpen())
+        {
+            size = file->GetSize();
+            data = ea::shared_array<unsigned char>(new unsigned char[size]);
+            if (file->Read(data.get(), size) != size)
+                data = nullptr;
+        }
+
+        MutexLock lock(requestMutex_);
+        if (data)
+        {
+            request->data_ = data;
+            request->size_ = size;
+            request->state_ = READ_SUCCESS;
+        }
+        else
+            request->state_ = READ_FAIL;
+    }
+}
+
+void AsyncFileReader::StartReaderThreads()
+{
+    if (!threads_.empty())
+        return;
+
+    shouldRun_ = true;
+    for (unsigned i = 0; i < NUM_READER_THREADS; ++i)
+    {
+        SharedPtr<AsyncReaderThread> thread(new AsyncReaderThread(this));
+        thread->SetName(Format("AsyncFileReader #{}", i + 1));
+        thread->Run();
+        threads_.push_back(thread);
+    }
+}
+
+}
+
+#endif
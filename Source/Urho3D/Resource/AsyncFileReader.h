@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/list.h>
+#include <EASTL/shared_array.h>
+#include <EASTL/vector.h>
+
+#include "../Container/Ptr.h"
+#include "../Container/Str.h"
+#include "../Core/Mutex.h"
+
+namespace Urho3D
+{
+
+class AsyncReaderThread;
+class ResourceCache;
+
+/// State of an asynchronous file read request.
+enum AsyncReadState
+{
+    READ_QUEUED = 0,
+    READ_READING,
+    READ_SUCCESS,
+    READ_FAIL
+};
+
+/// Asynchronous file read request.
+struct AsyncReadRequest
+{
+    /// Resource file name.
+    ea::string name_;
+    /// File contents once the read has completed.
+    ea::shared_array<unsigned char> data_;
+    /// File size in bytes.
+    unsigned size_{};
+    /// Read priority. Higher priority requests are served first.
+    int priority_{};
+    /// Request state.
+    AsyncReadState state_{READ_QUEUED};
+};
+
+/// Asynchronous file reader that keeps several reads in flight on a small pool of reader threads. Owned by the ResourceCache's background loader.
+class URHO3D_API AsyncFileReader : public RefCounted
+{
+public:
+    /// Construct.
+    explicit AsyncFileReader(ResourceCache* owner);
+    /// Destruct. Stop the reader threads and drop pending requests.
+    ~AsyncFileReader() override;
+
+    /// Queue an asynchronous read of a resource file. If the file is already queued, raise its priority if necessary.
+    void QueueRead(const ea::string& name, int priority = 0);
+    /// Block until a queued read has completed and take ownership of its contents. Return false if the read failed or was never queued.
+    bool WaitForRead(const ea::string& name, ea::shared_array<unsigned char>& data, unsigned& size);
+    /// Return number of requests that have not completed yet.
+    unsigned GetNumPendingReads() const;
+
+    /// Serve read requests until stopped. Called internally from the reader threads.
+    void ProcessReadRequests();
+
+private:
+    /// Start the reader threads if not started yet. Must be called with the request mutex held.
+    void StartReaderThreads();
+
+    /// Resource cache.
+    ResourceCache* owner_;
+    /// Read request queue. Requests stay in the queue while in flight and are removed when their result is taken.
+    ea::list<AsyncReadRequest> requests_;
+    /// Mutex for the request queue.
+    mutable Mutex requestMutex_;
+    /// Reader threads.
+    ea::vector<SharedPtr<AsyncReaderThread> > threads_;
+    /// Running flag for the reader threads.
+    volatile bool shouldRun_{};
+};
+
+}
@@ -25,8 +25,12 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
+#include "../Core/StringUtils.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
+#include "../Resource/AsyncFileReader.h"
 #include "../Resource/BackgroundLoader.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
@@ -36,13 +40,45 @@
 namespace Urho3D
 {
 
+/// Maximum number of loader threads. BeginLoad() is mostly CPU work (parsing, decompression), so the pool is capped to
+/// avoid starving the main thread and the file reader threads.
+static const unsigned MAX_LOADER_THREADS = 4;
+
+/// Additional loader thread that executes the owner's loading loop.
+class BackgroundLoaderThread : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit BackgroundLoaderThread(BackgroundLoader* owner) :
+        owner_(owner)
+    {
+    }
+
+    /// Load resources until the owner is stopped.
+    void ThreadFunction() override
+    {
+        owner_->ThreadFunction();
+    }
+
+private:
+    /// Background loader.
+    BackgroundLoader* owner_;
+};
+
 BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
-    owner_(owner)
+    owner_(owner),
+    fileReader_(new AsyncFileReader(owner))
 {
 }
 
 BackgroundLoader::~BackgroundLoader()
 {
+    // Stop the primary thread first; the pool threads share its running flag and exit their loops as well
+    Stop();
+    for (unsigned i = 0; i < threads_.size(); ++i)
+        threads_[i]->Stop();
+    threads_.clear();
+
     MutexLock lock(backgroundLoadMutex_);
 
     backgroundLoadQueue_.clear();
@@ -54,17 +90,16 @@ void BackgroundLoader::ThreadFunction()
     {
         backgroundLoadMutex_.Acquire();
 
-        // Search for a queued resource that has not been loaded yet
-        auto i = backgroundLoadQueue_.begin();
-        while (i != backgroundLoadQueue_.end())
+        // Search for the highest priority queued resource that has not been started yet
+        auto best = backgroundLoadQueue_.end();
+        for (auto i = backgroundLoadQueue_.begin(); i != backgroundLoadQueue_.end(); ++i)
         {
-            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
-                break;
-            else
-                ++i;
+            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED &&
+                (best == backgroundLoadQueue_.end() || i->second.priority_ > best->second.priority_))
+                best = i;
         }
 
-        if (i == backgroundLoadQueue_.end())
+        if (best == backgroundLoadQueue_.end())
         {
             // No resources to load found
             backgroundLoadMutex_.Release();
@@ -72,18 +107,30 @@ void BackgroundLoader::ThreadFunction()
         }
         else
         {
-            BackgroundLoadItem& item = i->second;
+            BackgroundLoadItem& item = best->second;
             Resource* resource = item.resource_;
+            // Claim the item while holding the mutex so that other loader threads do not pick it.
             // We can be sure that the item is not removed from the queue as long as it is in the
             // "queued" or "loading" state
+            resource->SetAsyncLoadState(ASYNC_LOADING);
             backgroundLoadMutex_.Release();
 
             bool success = false;
-            SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
-            if (file)
+            ea::shared_array<unsigned char> data;
+            unsigned dataSize = 0;
+            if (fileReader_->WaitForRead(resource->GetName(), data, dataSize))
+            {
+                // The file contents were read ahead by the async reader; load from memory
+                MemoryBuffer buffer(data.get(), dataSize);
+                buffer.SetName(resource->GetName());
+                success = resource->BeginLoad(buffer);
+            }
+            else
             {
-                resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
+                // Fall back to a synchronous read if the request was dropped or the read failed
+                SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
+                if (file)
+                    success = resource->BeginLoad(*file);
             }
 
             // Process dependencies now
@@ -108,7 +155,7 @@ void BackgroundLoader::ThreadFunction()
     }
 }
 
-bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller)
+bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller, int priority)
 {
     StringHash nameHash(name);
     ea::pair<StringHash, StringHash> key = ea::make_pair(type, nameHash);
@@ -116,10 +163,28 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
     MutexLock lock(backgroundLoadMutex_);
 
     // Check if already exists in the queue
-    if (backgroundLoadQueue_.find(key) != backgroundLoadQueue_.end())
+    auto existing = backgroundLoadQueue_.find(key);
+    if (existing != backgroundLoadQueue_.end())
+    {
+        BackgroundLoadItem& existingItem = existing->second;
+
+        // Raise the priority if requested again with a higher one
+        if (priority > existingItem.priority_)
+        {
+            existingItem.priority_ = priority;
+            fileReader_->QueueRead(name, priority);
+        }
+
+        // Still record the dependency so that the caller's finishing is deferred until this resource has loaded
+        AsyncLoadState state = existingItem.resource_->GetAsyncLoadState();
+        if (caller && (state == ASYNC_QUEUED || state == ASYNC_LOADING))
+            RegisterDependency(existingItem, key, caller);
+
         return false;
+    }
 
     BackgroundLoadItem& item = backgroundLoadQueue_[key];
+    item.priority_ = priority;
     item.sendEventOnFailure_ = sendEventOnFailure;
 
     // Make sure the pointer is non-null and is a Resource subclass
@@ -148,26 +213,55 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
 
     // If this is a resource calling for the background load of more resources, mark the dependency as necessary
     if (caller)
+        RegisterDependency(item, key, caller);
+
+    // Start reading the file contents ahead of time so that the data is already in memory when a loader thread gets to this item
+    fileReader_->QueueRead(name, item.priority_);
+
+    // Start the loader threads now
+    StartLoaderThreads();
+
+    return true;
+}
+
+void BackgroundLoader::RegisterDependency(BackgroundLoadItem& item, const ea::pair<StringHash, StringHash>& key, Resource* caller)
+{
+    ea::pair<StringHash, StringHash> callerKey = ea::make_pair(caller->GetType(), caller->GetNameHash());
+    auto j = backgroundLoadQueue_.find(callerKey);
+    if (j != backgroundLoadQueue_.end())
     {
-        ea::pair<StringHash, StringHash> callerKey = ea::make_pair(caller->GetType(), caller->GetNameHash());
-        auto j = backgroundLoadQueue_.find(
-            callerKey);
-        if (j != backgroundLoadQueue_.end())
+        BackgroundLoadItem& callerItem = j->second;
+        item.dependents_.insert(callerKey);
+        callerItem.dependencies_.insert(key);
+
+        // Dependencies inherit the caller's priority so that e.g. a high-priority material gets its textures and
+        // techniques loaded equally early
+        if (callerItem.priority_ > item.priority_)
         {
-            BackgroundLoadItem& callerItem = j->second;
-            item.dependents_.insert(callerKey);
-            callerItem.dependencies_.insert(key);
+            item.priority_ = callerItem.priority_;
+            fileReader_->QueueRead(item.resource_->GetName(), item.priority_);
         }
-        else
-            URHO3D_LOGWARNING("Resource " + caller->GetName() +
-                       " requested for a background loaded resource but was not in the background load queue");
     }
+    else
+        URHO3D_LOGWARNING("Resource " + caller->GetName() +
+                   " requested for a background loaded resource but was not in the background load queue");
+}
+
+void BackgroundLoader::StartLoaderThreads()
+{
+    if (IsStarted())
+        return;
 
-    // Start the background loader thread now
-    if (!IsStarted())
-        Run();
+    Run();
 
-    return true;
+    unsigned numThreads = Min(MAX_LOADER_THREADS, GetNumPhysicalCPUs());
+    for (unsigned i = 1; i < numThreads; ++i)
+    {
+        SharedPtr<BackgroundLoaderThread> thread(new BackgroundLoaderThread(this));
+        thread->SetName(Format("BackgroundLoader #{}", i + 1));
+        thread->Run();
+        threads_.push_back(thread);
+    }
 }
 
 void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
@@ -24,6 +24,7 @@
 
 #include <EASTL/hash_set.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include "../Core/Mutex.h"
 #include "../Container/Ptr.h"
@@ -33,6 +34,8 @@
 namespace Urho3D
 {
 
+class AsyncFileReader;
+class BackgroundLoaderThread;
 class Resource;
 class ResourceCache;
 
@@ -45,6 +48,8 @@ struct URHO3D_API BackgroundLoadItem
     ea::hash_set<ea::pair<StringHash, StringHash> > dependencies_;
     /// Resources that depend on this resource's loading.
     ea::hash_set<ea::pair<StringHash, StringHash> > dependents_;
+    /// Load priority. Higher priority resources are loaded first, and dependencies inherit their caller's priority.
+    int priority_;
     /// Whether to send failure event.
     bool sendEventOnFailure_;
 };
@@ -59,11 +64,11 @@ public:
     /// Destruct. Forcibly clear the load queue.
     ~BackgroundLoader() override;
 
-    /// Resource background loading loop.
+    /// Resource background loading loop. Executed by the primary loader thread and the additional pool threads.
     void ThreadFunction() override;
 
-    /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type).
-    bool QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller);
+    /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type). Higher priority resources are loaded first; use e.g. distance-based priority for streamed assets.
+    bool QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller, int priority = 0);
     /// Wait and finish possible loading of a resource when being requested from the cache.
     void WaitForResource(StringHash type, StringHash nameHash);
     /// Process resources that are ready to finish.
@@ -75,9 +80,17 @@ public:
 private:
     /// Finish one background loaded resource.
     void FinishBackgroundLoading(BackgroundLoadItem& item);
+    /// Register the caller's dependency on a queued item and inherit the caller's priority. Must be called with the mutex held.
+    void RegisterDependency(BackgroundLoadItem& item, const ea::pair<StringHash, StringHash>& key, Resource* caller);
+    /// Start the loader thread pool if not started yet.
+    void StartLoaderThreads();
 
     /// Resource cache.
     ResourceCache* owner_;
+    /// Asynchronous file reader used to keep file reads of queued resources in flight ahead of loading.
+    SharedPtr<AsyncFileReader> fileReader_;
+    /// Additional loader threads beyond the primary one.
+    ea::vector<SharedPtr<BackgroundLoaderThread> > threads_;
     /// Mutex for thread-safe access to the background load queue.
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
@@ -38,6 +38,10 @@
 #include <webp/mux.h>
 #endif
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifndef MAKEFOURCC
@@ -249,6 +253,36 @@ bool CompressedLevel::Decompress(unsigned char* dest) const
     }
 }
 
+bool CompressedLevel::Decompress(unsigned char* dest, int rowStart, int rowCount) const
+{
+    if (!data_ || depth_ > 1 || rowStart < 0 || (rowStart & 3) || rowCount <= 0 || rowStart + rowCount > height_)
+        return false;
+
+    // The block rows are stored consecutively, so a row range starting at a block boundary is itself valid block data
+    const unsigned char* blockRow = data_ + (unsigned)(rowStart / 4) * rowSize_;
+
+    switch (format_)
+    {
+    case CF_DXT1:
+    case CF_DXT3:
+    case CF_DXT5:
+        DecompressImageDXT(dest, blockRow, width_, rowCount, 1, format_);
+        return true;
+
+    case CF_ETC1:
+    case CF_ETC2_RGB:
+        DecompressImageETC(dest, blockRow, width_, rowCount, false);
+        return true;
+    case CF_ETC2_RGBA:
+        DecompressImageETC(dest, blockRow, width_, rowCount, true);
+        return true;
+
+    default:
+        // PVRTC interleaves its blocks over the whole level and can not be decompressed by rows
+        return false;
+    }
+}
+
 Image::Image(Context* context) :
     Resource(context)
 {
@@ -1749,7 +1783,26 @@ SharedPtr<Image> Image::GetNextLevel() const
                 const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 4];
                 unsigned char* out = &pixelDataOut[y * widthOut * 4];
 
-                for (int x = 0; x < widthOut * 4; x += 4)
+                int x = 0;
+
+#ifdef URHO3D_SSE
+                // Average 2x2 RGBA pixel blocks two output pixels at a time. The bytes are widened to 16 bits
+                // so that the sums stay exact and the result matches the truncating (sum >> 2) of the scalar loop
+                const __m128i zero = _mm_setzero_si128();
+                for (; x + 8 <= widthOut * 4; x += 8)
+                {
+                    __m128i upper = _mm_loadu_si128((const __m128i*)&inUpper[x * 2]);
+                    __m128i lower = _mm_loadu_si128((const __m128i*)&inLower[x * 2]);
+                    __m128i sumLo = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+                    __m128i sumHi = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+                    // Add the horizontally adjacent input pixels and pack back to bytes
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sumLo, sumHi), _mm_unpackhi_epi64(sumLo, sumHi));
+                    sum = _mm_srli_epi16(sum, 2);
+                    _mm_storel_epi64((__m128i*)&out[x], _mm_packus_epi16(sum, sum));
+                }
+#endif
+
+                for (; x < widthOut * 4; x += 4)
                 {
                     out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
                                               inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
@@ -1933,13 +1986,32 @@ SharedPtr<Image> Image::ConvertToRGBA() const
     switch (components_)
     {
     case 1:
-        for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
         {
-            unsigned char pixel = *src++;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = 255;
+            unsigned i = 0;
+            const auto count = static_cast<unsigned>(width_ * height_ * depth_);
+
+#ifdef URHO3D_SSE
+            // Expand four gray pixels to RGBA at a time by duplicating each byte into a whole 32-bit lane
+            const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i gray = _mm_cvtsi32_si128(*(const int*)src);
+                gray = _mm_unpacklo_epi8(gray, gray);
+                gray = _mm_unpacklo_epi16(gray, gray);
+                _mm_storeu_si128((__m128i*)dest, _mm_or_si128(gray, alpha));
+                src += 4;
+                dest += 16;
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                unsigned char pixel = *src++;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = 255;
+            }
         }
         break;
 
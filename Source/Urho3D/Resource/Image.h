@@ -57,6 +57,8 @@ struct URHO3D_API CompressedLevel
 {
     /// Decompress to RGBA. The destination buffer required is width * height * 4 bytes. Return true if successful.
     bool Decompress(unsigned char* dest) const;
+    /// Decompress a range of rows to RGBA. The start row must be a multiple of the block height (4) and the destination buffer required is width * rowCount * 4 bytes. Not supported for 3D levels or PVRTC formats, whose blocks interleave over the whole level. Return true if successful.
+    bool Decompress(unsigned char* dest, int rowStart, int rowCount) const;
 
     /// Compressed image data.
     unsigned char* data_{};
@@ -41,6 +41,144 @@ using namespace rapidjson;
 namespace Urho3D
 {
 
+/// File ID of the pre-parsed binary JSON format.
+static const char* binaryJSONFileID = "BJSN";
+
+/// Write a JSON value recursively in the pre-parsed binary JSON format.
+static bool WriteBinaryJSONValue(Serializer& dest, const JSONValue& jsonValue)
+{
+    bool success = dest.WriteUByte((unsigned char)jsonValue.GetValueType());
+
+    switch (jsonValue.GetValueType())
+    {
+    case JSON_NULL:
+        break;
+
+    case JSON_BOOL:
+        success &= dest.WriteBool(jsonValue.GetBool());
+        break;
+
+    case JSON_NUMBER:
+        success &= dest.WriteUByte((unsigned char)jsonValue.GetNumberType());
+        switch (jsonValue.GetNumberType())
+        {
+        case JSONNT_INT:
+            success &= dest.WriteInt(jsonValue.GetInt());
+            break;
+
+        case JSONNT_UINT:
+            success &= dest.WriteUInt(jsonValue.GetUInt());
+            break;
+
+        default:
+            success &= dest.WriteDouble(jsonValue.GetDouble());
+            break;
+        }
+        break;
+
+    case JSON_STRING:
+        success &= dest.WriteString(jsonValue.GetString());
+        break;
+
+    case JSON_ARRAY:
+        {
+            const JSONArray& jsonArray = jsonValue.GetArray();
+            success &= dest.WriteVLE(jsonArray.size());
+            for (unsigned i = 0; i < jsonArray.size(); ++i)
+                success &= WriteBinaryJSONValue(dest, jsonArray[i]);
+        }
+        break;
+
+    case JSON_OBJECT:
+        {
+            const JSONObject& jsonObject = jsonValue.GetObject();
+            success &= dest.WriteVLE(jsonObject.size());
+            for (auto i = jsonObject.begin(); i != jsonObject.end(); ++i)
+            {
+                success &= dest.WriteString(i->first);
+                success &= WriteBinaryJSONValue(dest, i->second);
+            }
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    return success;
+}
+
+/// Read a JSON value recursively from the pre-parsed binary JSON format.
+static bool ReadBinaryJSONValue(Deserializer& source, JSONValue& jsonValue)
+{
+    if (source.IsEof())
+        return false;
+
+    const unsigned char type = source.ReadUByte();
+
+    switch (type)
+    {
+    case JSON_NULL:
+        jsonValue.SetType(JSON_NULL);
+        break;
+
+    case JSON_BOOL:
+        jsonValue = source.ReadBool();
+        break;
+
+    case JSON_NUMBER:
+        switch (source.ReadUByte())
+        {
+        case JSONNT_INT:
+            jsonValue = source.ReadInt();
+            break;
+
+        case JSONNT_UINT:
+            jsonValue = source.ReadUInt();
+            break;
+
+        default:
+            jsonValue = source.ReadDouble();
+            break;
+        }
+        break;
+
+    case JSON_STRING:
+        jsonValue = source.ReadString();
+        break;
+
+    case JSON_ARRAY:
+        {
+            const unsigned size = source.ReadVLE();
+            jsonValue.Resize(size);
+            for (unsigned i = 0; i < size; ++i)
+            {
+                if (!ReadBinaryJSONValue(source, jsonValue[i]))
+                    return false;
+            }
+        }
+        break;
+
+    case JSON_OBJECT:
+        {
+            const unsigned size = source.ReadVLE();
+            jsonValue.SetType(JSON_OBJECT);
+            for (unsigned i = 0; i < size; ++i)
+            {
+                const ea::string name = source.ReadString();
+                if (!ReadBinaryJSONValue(source, jsonValue[name]))
+                    return false;
+            }
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
 JSONFile::JSONFile(Context* context) :
     Resource(context)
 {
@@ -124,6 +262,22 @@ bool JSONFile::BeginLoad(Deserializer& source)
         return false;
     buffer[dataSize] = '\0';
 
+    if (dataSize >= 4 && memcmp(buffer.get(), binaryJSONFileID, 4) == 0)
+    {
+        // Pre-parsed binary JSON, e.g. converted by PackageTool. Rebuild the value tree without text parsing
+        MemoryBuffer binarySource(buffer.get() + 4, dataSize - 4);
+        root_.SetType(JSON_NULL);
+        if (!ReadBinaryJSONValue(binarySource, root_))
+        {
+            URHO3D_LOGERROR("Could not load binary JSON data from " + source.GetName());
+            root_.SetType(JSON_NULL);
+            return false;
+        }
+
+        SetMemoryUse(dataSize);
+        return true;
+    }
+
     rapidjson::Document document;
     if (document.Parse<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
     {
@@ -214,6 +368,13 @@ bool JSONFile::Save(Serializer& dest) const
     return Save(dest, "\t");
 }
 
+bool JSONFile::SaveBinary(Serializer& dest) const
+{
+    bool success = dest.WriteFileID(binaryJSONFileID);
+    success &= WriteBinaryJSONValue(dest, root_);
+    return success;
+}
+
 bool JSONFile::Save(Serializer& dest, const ea::string& indendation) const
 {
     rapidjson::Document document;
@@ -47,6 +47,8 @@ public:
     bool Save(Serializer& dest) const override;
     /// Save resource with user-defined indentation, only the first character (if any) of the string is used and the length of the string defines the character count. Return true if successful.
     bool Save(Serializer& dest, const ea::string& indendation) const;
+    /// Save the document in pre-parsed binary form, loadable without text parsing. Return true if successful.
+    bool SaveBinary(Serializer& dest) const;
 
     /// Deserialize from a string. Return true if successful.
     bool FromString(const ea::string& source);
@@ -101,6 +101,8 @@ void Localization::SetLanguage(int index)
     if (index != languageIndex_)
     {
         languageIndex_ = index;
+        ++generation_;
+        indexedStringsDirty_ = true;
         VariantMap& eventData = GetEventDataMap();
         SendEvent(E_CHANGELANGUAGE, eventData);
     }
@@ -151,11 +153,74 @@ ea::string Localization::Get(const ea::string& id, int index)
     return result;
 }
 
+unsigned Localization::GetStringIndex(const ea::string& id)
+{
+    if (id.empty())
+        return M_MAX_UNSIGNED;
+
+    StringHash key(id);
+    auto i = stringIndices_.find(key);
+    if (i != stringIndices_.end())
+        return i->second;
+
+    const unsigned index = indexIds_.size();
+    stringIndices_[key] = index;
+    indexIds_.push_back(id);
+    indexedStringsDirty_ = true;
+    return index;
+}
+
+const ea::string& Localization::Get(unsigned stringIndex)
+{
+    if (stringIndex >= indexIds_.size())
+        return EMPTY_STRING;
+    if (indexedStringsDirty_)
+        RebuildIndexedStrings();
+    return indexedStrings_[stringIndex];
+}
+
+const ea::string& Localization::GetFormatted(unsigned stringIndex, const VariantVector& args)
+{
+    FormattedString& cached = formattedStrings_[stringIndex];
+    if (cached.generation_ != generation_ || cached.args_ != args)
+    {
+        const ea::string& format = Get(stringIndex);
+        ea::string result;
+        result.reserve(format.length());
+        unsigned argIndex = 0;
+        for (unsigned i = 0; i < format.length(); ++i)
+        {
+            if (format[i] == '{' && i + 1 < format.length() && format[i + 1] == '}' && argIndex < args.size())
+            {
+                result += args[argIndex++].ToString();
+                ++i;
+            }
+            else
+                result += format[i];
+        }
+
+        cached.args_ = args;
+        cached.result_ = ea::move(result);
+        cached.generation_ = generation_;
+    }
+    return cached.result_;
+}
+
 void Localization::Reset()
 {
     languages_.clear();
     languageIndex_ = -1;
     strings_.clear();
+    ++generation_;
+    indexedStringsDirty_ = true;
+}
+
+void Localization::RebuildIndexedStrings()
+{
+    indexedStrings_.resize(indexIds_.size());
+    for (unsigned i = 0; i < indexIds_.size(); ++i)
+        indexedStrings_[i] = Get(indexIds_[i]);
+    indexedStringsDirty_ = false;
 }
 
 void Localization::LoadJSONFile(const ea::string& name, const ea::string& language)
@@ -218,6 +283,9 @@ void Localization::LoadMultipleLanguageJSON(const JSONValue& source)
         else
             URHO3D_LOGWARNING("Localization::LoadMultipleLanguageJSON(source): failed to load values, string ID=\"" + id + "\"");
     }
+
+    ++generation_;
+    indexedStringsDirty_ = true;
 }
 
 void Localization::LoadSingleLanguageJSON(const JSONValue& source, const ea::string& language)
@@ -255,6 +323,9 @@ void Localization::LoadSingleLanguageJSON(const JSONValue& source, const ea::str
                     "Localization::LoadSingleLanguageJSON(source, language): failed to load value, string ID=\"" + id +
                     "\", language=\"" + language + "\"");
     }
+
+    ++generation_;
+    indexedStringsDirty_ = true;
 }
 
 }
@@ -57,6 +57,20 @@ public:
     void SetLanguage(const ea::string& language);
     /// Return a string in the current language. Returns EMPTY_STRING if id is empty. Returns id if translation is not found and logs a warning.
     ea::string Get(const ea::string& id, int index=-1);
+    /// Resolve a string ID into a stable index for repeated lookups. Resolve once at UI construction and use
+    /// Get(stringIndex) thereafter; the index stays valid for the lifetime of the subsystem. Returns
+    /// M_MAX_UNSIGNED if id is empty.
+    unsigned GetStringIndex(const ea::string& id);
+    /// Return a string in the current language by resolved index as a plain array lookup. Returns the string ID
+    /// if translation is not found.
+    const ea::string& Get(unsigned stringIndex);
+    /// Return a formatted string in the current language by resolved index. Sequential {} placeholders are
+    /// replaced with the string representations of the arguments. The result is cached per index and only
+    /// re-formatted when the arguments or the language change.
+    const ea::string& GetFormatted(unsigned stringIndex, const VariantVector& args);
+    /// Return the change generation, incremented whenever the language changes or strings are loaded or reset.
+    /// Widgets can compare against a remembered value to re-fetch text only when it may have changed.
+    unsigned GetGeneration() const { return generation_; }
     /// Clear all loaded strings.
     void Reset();
     /// Load strings from JSONFile. The file should be UTF8 without BOM.
@@ -67,12 +81,38 @@ public:
     void LoadSingleLanguageJSON(const JSONValue& source, const ea::string& language = EMPTY_STRING);
 
 private:
+    /// Cached formatted string.
+    struct FormattedString
+    {
+        /// Arguments of the cached result.
+        VariantVector args_;
+        /// Formatted result.
+        ea::string result_;
+        /// Generation the result was formatted at.
+        unsigned generation_{M_MAX_UNSIGNED};
+    };
+
+    /// Rebuild the resolved strings of the current language for index-based lookups.
+    void RebuildIndexedStrings();
+
     /// Language names.
     ea::vector<ea::string> languages_;
     /// Index of current language.
     int languageIndex_;
     /// Storage strings: <Language <StringId, Value> >.
     ea::unordered_map<StringHash, ea::unordered_map<StringHash, ea::string> > strings_;
+    /// Mapping from string ID hash to resolved index.
+    ea::unordered_map<StringHash, unsigned> stringIndices_;
+    /// String IDs by resolved index, used as resolution source and not-found fallback.
+    ea::vector<ea::string> indexIds_;
+    /// Resolved strings of the current language by index. Rebuilt lazily after language or content changes.
+    ea::vector<ea::string> indexedStrings_;
+    /// Whether the resolved strings need rebuilding.
+    bool indexedStringsDirty_{};
+    /// Change generation.
+    unsigned generation_{};
+    /// Cached formatted strings by resolved index.
+    ea::unordered_map<unsigned, FormattedString> formattedStrings_;
 };
 
 }
@@ -35,7 +35,8 @@ namespace Urho3D
 Resource::Resource(Context* context) :
     Object(context),
     memoryUse_(0),
-    asyncLoadState_(ASYNC_DONE)
+    asyncLoadState_(ASYNC_DONE),
+    evictionPriority_(EVICTION_STREAMABLE)
 {
 }
 
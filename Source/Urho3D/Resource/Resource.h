@@ -50,6 +50,15 @@ enum AsyncLoadState
     ASYNC_FAIL = 4
 };
 
+/// Eviction priority of a resource when its type group exceeds the memory budget.
+enum ResourceEvictionPriority
+{
+    /// Never evicted by memory budget enforcement.
+    EVICTION_PINNED = 0,
+    /// Evicted in least recently used order when the type group exceeds its memory budget. Default.
+    EVICTION_STREAMABLE = 1
+};
+
 /// Base class for resources.
 class URHO3D_API Resource : public Object
 {
@@ -83,6 +92,12 @@ public:
     void SetAsyncLoadState(AsyncLoadState newState);
     /// Set absolute file name.
     void SetAbsoluteFileName(const ea::string& fileName) { absoluteFileName_ = fileName; }
+    /// Set eviction priority for memory budget enforcement.
+    void SetEvictionPriority(ResourceEvictionPriority priority) { evictionPriority_ = priority; }
+    /// Attempt to reduce memory use without unloading the resource, e.g. by dropping a CPU-side copy of GPU data.
+    /// Called by the resource cache before evicting the resource when the type group is over memory budget.
+    /// Return true if memory use was reduced. The default implementation does nothing.
+    virtual bool ReduceMemoryUse() { return false; }
 
     /// Return name.
     const ea::string& GetName() const { return name_; }
@@ -99,6 +114,9 @@ public:
     /// Return the asynchronous loading state.
     AsyncLoadState GetAsyncLoadState() const { return asyncLoadState_; }
 
+    /// Return eviction priority for memory budget enforcement.
+    ResourceEvictionPriority GetEvictionPriority() const { return evictionPriority_; }
+
     /// Return native file name.
     const ea::string& GetNativeFileName() const { return absoluteFileName_; }
 
@@ -115,6 +133,8 @@ private:
     unsigned memoryUse_;
     /// Asynchronous loading state.
     AsyncLoadState asyncLoadState_;
+    /// Eviction priority for memory budget enforcement.
+    ResourceEvictionPriority evictionPriority_;
 };
 
 /// Base class for resources that support arbitrary metadata stored. Metadata serialization shall be implemented in derived classes.
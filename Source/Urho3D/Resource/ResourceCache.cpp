@@ -75,7 +75,10 @@ ResourceCache::ResourceCache(Context* context) :
     returnFailedResources_(false),
     searchPackagesFirst_(true),
     isRouting_(false),
-    finishBackgroundResourcesMs_(5)
+    finishBackgroundResourcesMs_(5),
+    autoReleaseResources_(false),
+    autoReleaseDelayMs_(DEFAULT_AUTO_RELEASE_DELAY_MS),
+    maxAutoReleaseChecks_(DEFAULT_AUTO_RELEASE_CHECKS)
 {
     // Register Resource library object factories
     RegisterResourceLibrary(context_);
@@ -122,11 +125,13 @@ bool ResourceCache::AddResourceDir(const ea::string& pathName, unsigned priority
         resourceDirs_.insert_at(priority, fixedPath);
     else
         resourceDirs_.push_back(fixedPath);
+    UpdateResourceDirPrefixes();
 
     // If resource auto-reloading active, create a file watcher for the directory
     if (autoReloadResources_)
     {
         SharedPtr<FileWatcher> watcher(new FileWatcher(context_));
+        watcher->SetContentHashing(true);
         watcher->StartWatching(fixedPath, true);
         fileWatchers_.push_back(watcher);
     }
@@ -177,6 +182,8 @@ bool ResourceCache::AddManualResource(Resource* resource)
     }
 
     resource->ResetUseTimer();
+
+    WriteLock lock(resourceGroupsMutex_);
     resourceGroups_[resource->GetType()].resources_[resource->GetNameHash()] = resource;
     UpdateResourceGroup(resource->GetType());
     return true;
@@ -193,6 +200,7 @@ void ResourceCache::RemoveResourceDir(const ea::string& pathName)
         if (!resourceDirs_[i].comparei(fixedPath))
         {
             resourceDirs_.erase_at(i);
+            UpdateResourceDirPrefixes();
             // Remove the filewatcher with the matching path
             for (unsigned j = 0; j < fileWatchers_.size(); ++j)
             {
@@ -255,6 +263,7 @@ void ResourceCache::ReleaseResource(StringHash type, const ea::string& name, boo
     // If other references exist, do not release, unless forced
     if ((existingRes.Refs() == 1 && existingRes.WeakRefs() == 0) || force)
     {
+        WriteLock lock(resourceGroupsMutex_);
         resourceGroups_[type].resources_.erase(nameHash);
         UpdateResourceGroup(type);
     }
@@ -262,6 +271,8 @@ void ResourceCache::ReleaseResource(StringHash type, const ea::string& name, boo
 
 void ResourceCache::ReleaseResources(StringHash type, bool force)
 {
+    WriteLock lock(resourceGroupsMutex_);
+
     bool released = false;
 
     auto i = resourceGroups_.find(type);
@@ -286,6 +297,8 @@ void ResourceCache::ReleaseResources(StringHash type, bool force)
 
 void ResourceCache::ReleaseResources(StringHash type, const ea::string& partialName, bool force)
 {
+    WriteLock lock(resourceGroupsMutex_);
+
     bool released = false;
 
     auto i = resourceGroups_.find(type);
@@ -313,6 +326,8 @@ void ResourceCache::ReleaseResources(StringHash type, const ea::string& partialN
 
 void ResourceCache::ReleaseResources(const ea::string& partialName, bool force)
 {
+    WriteLock lock(resourceGroupsMutex_);
+
     // Some resources refer to others, like materials to textures. Repeat the release logic as many times as necessary to ensure
     // these get released. This is not necessary if forcing release
     bool released;
@@ -346,6 +361,8 @@ void ResourceCache::ReleaseResources(const ea::string& partialName, bool force)
 
 void ResourceCache::ReleaseAllResources(bool force)
 {
+    WriteLock lock(resourceGroupsMutex_);
+
     bool released;
     do
     {
@@ -394,7 +411,10 @@ bool ResourceCache::ReloadResource(Resource* resource)
     if (success)
     {
         resource->ResetUseTimer();
-        UpdateResourceGroup(resource->GetType());
+        {
+            WriteLock lock(resourceGroupsMutex_);
+            UpdateResourceGroup(resource->GetType());
+        }
         resource->SendEvent(E_RELOADFINISHED);
         return true;
     }
@@ -415,12 +435,18 @@ void ResourceCache::ReloadResourceWithDependencies(const ea::string& fileName)
         URHO3D_LOGDEBUG("Reloading changed resource " + fileName);
         ReloadResource(resource.Get());
     }
+
+    ReloadDependentResources(fileName, resource);
+}
+
+void ResourceCache::ReloadDependentResources(const ea::string& fileName, Resource* resource)
+{
     // Always perform dependency resource check for resource loaded from XML file as it could be used in inheritance
     if (!resource || GetExtension(resource->GetName()) == ".xml")
     {
         // Check if this is a dependency resource, reload dependents
         auto j = dependentResources_.find(
-            fileNameHash);
+            StringHash(fileName));
         if (j != dependentResources_.end())
         {
             // Reloading a resource may modify the dependency tracking structure. Therefore collect the
@@ -444,8 +470,89 @@ void ResourceCache::ReloadResourceWithDependencies(const ea::string& fileName)
     }
 }
 
+void ResourceCache::ReloadChangedResources(const ea::vector<ea::string>& fileNames)
+{
+    // Look up which of the changed files are tracked resources
+    ea::vector<SharedPtr<Resource> > resources;
+    for (auto i = fileNames.begin(); i != fileNames.end(); ++i)
+    {
+        const SharedPtr<Resource>& resource = FindResource(StringHash(*i));
+        if (resource && !resources.contains(resource))
+        {
+            URHO3D_LOGDEBUG("Reloading changed resource " + *i);
+            resources.push_back(resource);
+        }
+    }
+
+#ifdef URHO3D_THREADING
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && workQueue->GetNumThreads() && resources.size() > 1)
+    {
+        // Run the heavy load phase of the independent changed resources in parallel work items, then finish them
+        // serially on the main thread, mirroring the split used by background resource loading
+        struct ReloadItem
+        {
+            /// Resource being reloaded.
+            SharedPtr<Resource> resource_;
+            /// Open file to load from.
+            SharedPtr<File> file_;
+            /// BeginLoad result.
+            bool success_{};
+        };
+        ea::vector<ReloadItem> items;
+        items.resize(resources.size());
+
+        for (unsigned i = 0; i < resources.size(); ++i)
+        {
+            ReloadItem& item = items[i];
+            item.resource_ = resources[i];
+            item.resource_->SendEvent(E_RELOADSTARTED);
+            item.file_ = GetFile(item.resource_->GetName());
+            if (item.file_)
+            {
+                item.resource_->SetAsyncLoadState(ASYNC_LOADING);
+                ReloadItem* itemPtr = &item;
+                workQueue->AddWorkItem([itemPtr]() { itemPtr->success_ = itemPtr->resource_->BeginLoad(*itemPtr->file_); },
+                    M_MAX_UNSIGNED);
+            }
+        }
+
+        workQueue->Complete(M_MAX_UNSIGNED);
+
+        for (unsigned i = 0; i < items.size(); ++i)
+        {
+            ReloadItem& item = items[i];
+            bool success = item.success_ && item.resource_->EndLoad();
+            item.resource_->SetAsyncLoadState(ASYNC_DONE);
+
+            if (success)
+            {
+                item.resource_->ResetUseTimer();
+                {
+                    WriteLock lock(resourceGroupsMutex_);
+                    UpdateResourceGroup(item.resource_->GetType());
+                }
+                item.resource_->SendEvent(E_RELOADFINISHED);
+            }
+            else
+                item.resource_->SendEvent(E_RELOADFAILED);
+        }
+    }
+    else
+#endif
+    {
+        for (auto i = resources.begin(); i != resources.end(); ++i)
+            ReloadResource(i->Get());
+    }
+
+    // Reload dependent resources (e.g. XML inheritance) serially afterwards, as they may read the just-reloaded resources
+    for (auto i = fileNames.begin(); i != fileNames.end(); ++i)
+        ReloadDependentResources(*i, FindResource(StringHash(*i)));
+}
+
 void ResourceCache::SetMemoryBudget(StringHash type, unsigned long long budget)
 {
+    WriteLock lock(resourceGroupsMutex_);
     resourceGroups_[type].memoryBudget_ = budget;
 }
 
@@ -458,6 +565,7 @@ void ResourceCache::SetAutoReloadResources(bool enable)
             for (unsigned i = 0; i < resourceDirs_.size(); ++i)
             {
                 SharedPtr<FileWatcher> watcher(new FileWatcher(context_));
+                watcher->SetContentHashing(true);
                 watcher->StartWatching(resourceDirs_[i], true);
                 fileWatchers_.push_back(watcher);
             }
@@ -633,15 +741,19 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
             return nullptr;
     }
 
-    // Store to cache
+    // Store to cache. Note that the resource was loaded outside of the lock so that nested GetResource() calls
+    // for dependent resources do not deadlock
     resource->ResetUseTimer();
-    resourceGroups_[type].resources_[nameHash] = resource;
-    UpdateResourceGroup(type);
+    {
+        WriteLock lock(resourceGroupsMutex_);
+        resourceGroups_[type].resources_[nameHash] = resource;
+        UpdateResourceGroup(type);
+    }
 
     return resource;
 }
 
-bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller)
+bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller, int priority)
 {
 #ifdef URHO3D_THREADING
     // If empty name, fail immediately
@@ -654,7 +766,7 @@ bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& na
     if (FindResource(type, nameHash) != noResource)
         return false;
 
-    return backgroundLoader_->QueueResource(type, sanitatedName, sendEventOnFailure, caller);
+    return backgroundLoader_->QueueResource(type, sanitatedName, sendEventOnFailure, caller, priority);
 #else
     // When threading not supported, fall back to synchronous loading
     return GetResource(type, name, sendEventOnFailure);
@@ -844,27 +956,25 @@ ea::string ResourceCache::GetPreferredResourceDir(const ea::string& path) const
 
 ea::string ResourceCache::SanitateResourceName(const ea::string& name) const
 {
+    // Most lookups pass an already sanitated relative name; detect that without allocating anything
+    if (IsSanitatedResourceName(name))
+        return name;
+
     // Sanitate unsupported constructs from the resource name
     ea::string sanitatedName = GetInternalPath(name);
     sanitatedName.replace("../", "");
     sanitatedName.replace("./", "");
 
     // If the path refers to one of the resource directories, normalize the resource name
-    auto* fileSystem = GetSubsystem<FileSystem>();
     if (resourceDirs_.size())
     {
         ea::string namePath = GetPath(sanitatedName);
-        ea::string exePath = fileSystem->GetProgramDir().replaced("/./", "/");
-        for (unsigned i = 0; i < resourceDirs_.size(); ++i)
+        for (const auto& prefixes : resourceDirPrefixes_)
         {
-            ea::string relativeResourcePath = resourceDirs_[i];
-            if (relativeResourcePath.starts_with(exePath))
-                relativeResourcePath = relativeResourcePath.substr(exePath.length());
-
-            if (namePath.starts_with(resourceDirs_[i], false))
-                namePath = namePath.substr(resourceDirs_[i].length());
-            else if (namePath.starts_with(relativeResourcePath, false))
-                namePath = namePath.substr(relativeResourcePath.length());
+            if (namePath.starts_with(prefixes.first, false))
+                namePath = namePath.substr(prefixes.first.length());
+            else if (!prefixes.second.empty() && namePath.starts_with(prefixes.second, false))
+                namePath = namePath.substr(prefixes.second.length());
         }
 
         sanitatedName = namePath + GetFileNameAndExtension(sanitatedName);
@@ -874,6 +984,46 @@ ea::string ResourceCache::SanitateResourceName(const ea::string& name) const
     return sanitatedName;
 }
 
+bool ResourceCache::IsSanitatedResourceName(const ea::string& name) const
+{
+    if (name.empty())
+        return true;
+
+    // Check for anything the slow path could modify: backslashes, "./" fragments (which also cover "../"),
+    // surrounding whitespace, or a leading resource directory prefix
+    if (name.find('\\') != ea::string::npos || name.find("./") != ea::string::npos)
+        return false;
+    if (isspace((unsigned char)name.front()) || isspace((unsigned char)name.back()))
+        return false;
+
+    for (const auto& prefixes : resourceDirPrefixes_)
+    {
+        if (name.starts_with(prefixes.first, false) ||
+            (!prefixes.second.empty() && name.starts_with(prefixes.second, false)))
+            return false;
+    }
+
+    return true;
+}
+
+void ResourceCache::UpdateResourceDirPrefixes()
+{
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    const ea::string exePath = fileSystem ? fileSystem->GetProgramDir().replaced("/./", "/") : EMPTY_STRING;
+
+    resourceDirPrefixes_.clear();
+    for (const ea::string& resourceDir : resourceDirs_)
+    {
+        // Empty relative form means the directory is not under the program directory, or is the program
+        // directory itself; stripping nothing matches the old behavior in both cases
+        ea::string relativeResourcePath;
+        if (!exePath.empty() && resourceDir.starts_with(exePath) && resourceDir.length() > exePath.length())
+            relativeResourcePath = resourceDir.substr(exePath.length());
+
+        resourceDirPrefixes_.push_back(ea::make_pair(resourceDir, relativeResourcePath));
+    }
+}
+
 ea::string ResourceCache::SanitateResourceDirName(const ea::string& name) const
 {
     ea::string fixedPath = AddTrailingSlash(name);
@@ -982,7 +1132,7 @@ ea::string ResourceCache::PrintMemoryUsage() const
 
 const SharedPtr<Resource>& ResourceCache::FindResource(StringHash type, StringHash nameHash)
 {
-    MutexLock lock(resourceMutex_);
+    ReadLock lock(resourceGroupsMutex_);
 
     auto i = resourceGroups_.find(type);
     if (i == resourceGroups_.end())
@@ -996,7 +1146,7 @@ const SharedPtr<Resource>& ResourceCache::FindResource(StringHash type, StringHa
 
 const SharedPtr<Resource>& ResourceCache::FindResource(StringHash nameHash)
 {
-    MutexLock lock(resourceMutex_);
+    ReadLock lock(resourceGroupsMutex_);
 
     for (auto i = resourceGroups_.begin(); i !=
         resourceGroups_.end(); ++i)
@@ -1011,6 +1161,8 @@ const SharedPtr<Resource>& ResourceCache::FindResource(StringHash nameHash)
 
 void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
 {
+    WriteLock lock(resourceGroupsMutex_);
+
     ea::hash_set<StringHash> affectedGroups;
 
     const ea::unordered_map<ea::string, PackageEntry>& entries = package->GetEntries();
@@ -1046,6 +1198,8 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     if (i == resourceGroups_.end())
         return;
 
+    ea::hash_set<StringHash> reducedResources;
+
     for (;;)
     {
         unsigned totalSize = 0;
@@ -1057,7 +1211,7 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
         {
             totalSize += j->second->GetMemoryUse();
             unsigned useTimer = j->second->GetUseTimer();
-            if (useTimer > oldestTimer)
+            if (useTimer > oldestTimer && j->second->GetEvictionPriority() != EVICTION_PINNED)
             {
                 oldestTimer = useTimer;
                 oldestResource = j;
@@ -1067,10 +1221,14 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
         i->second.memoryUse_ = totalSize;
 
         // If memory budget defined and is exceeded, remove the oldest resource and loop again
-        // (resources in use always return a zero timer and can not be removed)
+        // (resources in use always return a zero timer and can not be removed; pinned resources are never candidates)
         if (i->second.memoryBudget_ && i->second.memoryUse_ > i->second.memoryBudget_ &&
             oldestResource != i->second.resources_.end())
         {
+            // Give the resource one chance to shed memory without being unloaded before evicting it outright
+            if (reducedResources.insert(oldestResource->first).second && oldestResource->second->ReduceMemoryUse())
+                continue;
+
             URHO3D_LOGDEBUG("Resource group " + oldestResource->second->GetTypeName() + " over memory budget, releasing resource " +
                      oldestResource->second->GetName());
             i->second.resources_.erase(oldestResource);
@@ -1080,13 +1238,121 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     }
 }
 
+void ResourceCache::ReleaseResourcesIncremental()
+{
+    // Sweep result per group: released resource count and remaining memory use
+    struct ReleasedGroup
+    {
+        StringHash type_;
+        unsigned releasedCount_;
+        unsigned long long memoryUse_;
+    };
+    ea::vector<ReleasedGroup> releasedGroups;
+
+    {
+        WriteLock lock(resourceGroupsMutex_);
+
+        if (resourceGroups_.empty())
+            return;
+
+        auto group = resourceGroups_.find(releaseSweepType_);
+        if (group == resourceGroups_.end())
+        {
+            group = resourceGroups_.begin();
+            releaseSweepResource_ = StringHash::ZERO;
+        }
+
+        unsigned checksLeft = maxAutoReleaseChecks_;
+        unsigned groupsVisited = 0;
+        const unsigned numGroups = resourceGroups_.size();
+
+        while (checksLeft && groupsVisited <= numGroups)
+        {
+            ResourceGroup& resources = group->second;
+            unsigned releasedCount = 0;
+
+            // Resume from the stored cursor. If the resource is gone, restart the group from the beginning
+            auto j = resources.resources_.begin();
+            if (releaseSweepResource_ != StringHash::ZERO)
+            {
+                auto resume = resources.resources_.find(releaseSweepResource_);
+                if (resume != resources.resources_.end())
+                    j = resume;
+            }
+
+            const bool overBudget = resources.memoryBudget_ && resources.memoryUse_ > resources.memoryBudget_;
+
+            while (checksLeft && j != resources.resources_.end())
+            {
+                auto current = j++;
+                --checksLeft;
+
+                Resource* resource = current->second;
+                // Release when no other references exist and the resource has been unused long enough. When the
+                // group is over its memory budget, unused resources are released regardless of age so that
+                // eviction is continuous instead of spiking on the next full group update
+                if (current->second.Refs() == 1 && current->second.WeakRefs() == 0 &&
+                    resource->GetEvictionPriority() != EVICTION_PINNED &&
+                    (overBudget || resource->GetUseTimer() >= autoReleaseDelayMs_))
+                {
+                    // Adjust the group's memory use directly instead of a full recalculation to keep the sweep bounded
+                    const auto memoryUse = (unsigned long long)resource->GetMemoryUse();
+                    resources.memoryUse_ -= Min(memoryUse, resources.memoryUse_);
+                    resources.resources_.erase(current);
+                    ++releasedCount;
+                }
+            }
+
+            if (releasedCount)
+                releasedGroups.push_back({ group->first, releasedCount, resources.memoryUse_ });
+
+            if (j != resources.resources_.end())
+            {
+                // Check budget exhausted mid-group; resume here on the next frame
+                releaseSweepType_ = group->first;
+                releaseSweepResource_ = j->first;
+                break;
+            }
+
+            // Advance to the next group, wrapping around at the end
+            ++group;
+            ++groupsVisited;
+            if (group == resourceGroups_.end())
+                group = resourceGroups_.begin();
+            releaseSweepType_ = group->first;
+            releaseSweepResource_ = StringHash::ZERO;
+        }
+    }
+
+    // Send the events outside of the lock, as handlers may query the cache
+    for (auto i = releasedGroups.begin(); i != releasedGroups.end(); ++i)
+    {
+        using namespace ResourceGroupReleased;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_RESOURCETYPE] = i->type_;
+        eventData[P_RELEASEDCOUNT] = i->releasedCount_;
+        eventData[P_MEMORYUSE] = i->memoryUse_;
+        SendEvent(E_RESOURCEGROUPRELEASED, eventData);
+    }
+}
+
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
+    // Collect this interval's file changes from all watchers as one batch, so that repeated editor saves of several
+    // files cause at most one reload per file and independent reloads can run in parallel
+    ea::vector<ea::string> changedFiles;
+    ea::vector<ea::pair<ea::string, ea::string> > fileEvents;
     for (unsigned i = 0; i < fileWatchers_.size(); ++i)
     {
-        FileChange change;
-        while (fileWatchers_[i]->GetNextChange(change))
+        ea::vector<FileChange> changes;
+        if (!fileWatchers_[i]->GetChanges(changes))
+            continue;
+
+        for (unsigned j = 0; j < changes.size(); ++j)
         {
+            const FileChange& change = changes[j];
+
             auto it = ignoreResourceAutoReload_.find(change.fileName_);
             if (it != ignoreResourceAutoReload_.end())
             {
@@ -1094,16 +1360,24 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
                 continue;
             }
 
-            ReloadResourceWithDependencies(change.fileName_);
+            if (!changedFiles.contains(change.fileName_))
+                changedFiles.push_back(change.fileName_);
+            fileEvents.push_back(ea::make_pair(fileWatchers_[i]->GetPath() + change.fileName_, change.fileName_));
+        }
+    }
 
-            // Finally send a general file changed event even if the file was not a tracked resource
-            using namespace FileChanged;
+    if (!changedFiles.empty())
+        ReloadChangedResources(changedFiles);
 
-            VariantMap& eventData = GetEventDataMap();
-            eventData[P_FILENAME] = fileWatchers_[i]->GetPath() + change.fileName_;
-            eventData[P_RESOURCENAME] = change.fileName_;
-            SendEvent(E_FILECHANGED, eventData);
-        }
+    // Finally send a general file changed event for each change even if the file was not a tracked resource
+    for (auto i = fileEvents.begin(); i != fileEvents.end(); ++i)
+    {
+        using namespace FileChanged;
+
+        VariantMap& changeEventData = GetEventDataMap();
+        changeEventData[P_FILENAME] = i->first;
+        changeEventData[P_RESOURCENAME] = i->second;
+        SendEvent(E_FILECHANGED, changeEventData);
     }
 
     // Check for background loaded resources that can be finished
@@ -1113,6 +1387,44 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
         backgroundLoader_->FinishResources(finishBackgroundResourcesMs_);
     }
 #endif
+
+    // Release a bounded number of unused resources per frame instead of periodic full scans
+    if (autoReleaseResources_)
+        ReleaseResourcesIncremental();
+
+    // Report resource groups that remain over their memory budget after eviction
+    if (HasEventReceivers(E_RESOURCEMEMORYOVERBUDGET))
+    {
+        struct OverBudgetGroup
+        {
+            StringHash type_;
+            unsigned long long memoryUse_;
+            unsigned long long memoryBudget_;
+        };
+        ea::vector<OverBudgetGroup> overBudgetGroups;
+
+        {
+            ReadLock lock(resourceGroupsMutex_);
+            for (const auto& groupPair : resourceGroups_)
+            {
+                const ResourceGroup& group = groupPair.second;
+                if (group.memoryBudget_ && group.memoryUse_ > group.memoryBudget_)
+                    overBudgetGroups.push_back({ groupPair.first, group.memoryUse_, group.memoryBudget_ });
+            }
+        }
+
+        // Send the events outside of the lock, as handlers may query the cache
+        for (const OverBudgetGroup& group : overBudgetGroups)
+        {
+            using namespace ResourceMemoryOverBudget;
+
+            VariantMap& newEventData = GetEventDataMap();
+            newEventData[P_RESOURCETYPE] = group.type_;
+            newEventData[P_MEMORYUSE] = group.memoryUse_;
+            newEventData[P_MEMORYBUDGET] = group.memoryBudget_;
+            SendEvent(E_RESOURCEMEMORYOVERBUDGET, newEventData);
+        }
+    }
 }
 
 File* ResourceCache::SearchResourceDirs(const ea::string& name)
@@ -1268,6 +1580,8 @@ bool ResourceCache::RenameResource(const ea::string& source, const ea::string& d
     const ea::string destinationDir = AddTrailingSlash(destination);
 
     // Update loaded resource information
+    unsigned renamedResources = 0;
+    resourceGroupsMutex_.AcquireWrite();
     for (auto& groupPair : resourceGroups_)
     {
         bool movedAny = false;
@@ -1306,13 +1620,19 @@ bool ResourceCache::RenameResource(const ea::string& source, const ea::string& d
             resource->SetAbsoluteFileName(newNativeFileName);
             groupPair.second.resources_[resource->GetNameHash()] = resource;
             movedAny = true;
-
-            using namespace ResourceRenamed;
-            SendEvent(E_RESOURCERENAMED, P_FROM, resourceName, P_TO, destinationName);
+            ++renamedResources;
         }
         if (movedAny)
             UpdateResourceGroup(groupPair.first);
     }
+    resourceGroupsMutex_.ReleaseWrite();
+
+    // Send the events outside of the lock, as handlers may query the cache
+    for (unsigned i = 0; i < renamedResources; ++i)
+    {
+        using namespace ResourceRenamed;
+        SendEvent(E_RESOURCERENAMED, P_FROM, resourceName, P_TO, destinationName);
+    }
 
     if (dirMode)
     {
@@ -1347,7 +1667,12 @@ void ResourceCache::RouteResourceName(ea::string& name, ResourceRequest requestT
 
 void ResourceCache::Clear()
 {
-    resourceGroups_.clear();
+    {
+        WriteLock lock(resourceGroupsMutex_);
+        resourceGroups_.clear();
+    }
+
+    MutexLock lock(resourceMutex_);
     dependentResources_.clear();
 }
 
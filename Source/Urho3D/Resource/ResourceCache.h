@@ -42,6 +42,11 @@ class PackageFile;
 /// Sets to priority so that a package or file is pushed to the end of the vector.
 static const unsigned PRIORITY_LAST = 0xffffffff;
 
+/// Default delay in milliseconds before the incremental release sweep may free an unused resource.
+static const unsigned DEFAULT_AUTO_RELEASE_DELAY_MS = 10000;
+/// Default maximum number of resources examined per frame by the incremental release sweep.
+static const unsigned DEFAULT_AUTO_RELEASE_CHECKS = 32;
+
 /// Container of resources with specific type.
 struct ResourceGroup
 {
@@ -135,6 +140,15 @@ public:
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     void SetFinishBackgroundResourcesMs(int ms) { finishBackgroundResourcesMs_ = Max(ms, 1); }
 
+    /// Enable or disable incremental release of unused resources. Default false. When enabled, a bounded number of
+    /// resources is examined each frame and unreferenced ones past the release delay are freed, amortizing the cost
+    /// of periodic ReleaseAllResources() calls over frames.
+    void SetAutoReleaseResources(bool enable) { autoReleaseResources_ = enable; }
+    /// Set how many milliseconds a resource must remain unused before the incremental sweep may release it.
+    void SetAutoReleaseDelayMs(unsigned ms) { autoReleaseDelayMs_ = ms; }
+    /// Set the maximum number of resources the incremental sweep examines per frame.
+    void SetMaxAutoReleaseChecks(unsigned checks) { maxAutoReleaseChecks_ = Max(checks, 1U); }
+
     /// Add a resource router object. By default there is none, so the routing process is skipped.
     void AddResourceRouter(ResourceRouter* router, bool addAsFirst = false);
     /// Remove a resource router object.
@@ -146,8 +160,8 @@ public:
     Resource* GetResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true);
     /// Load a resource without storing it in the resource cache. Return null if not found or if fails. Can be called from outside the main thread if the resource itself is safe to load completely (it does not possess for example GPU data).
     SharedPtr<Resource> GetTempResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true);
-    /// Background load a resource. An event will be sent when complete. Return true if successfully stored to the load queue, false if eg. already exists. Can be called from outside the main thread.
-    bool BackgroundLoadResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true, Resource* caller = nullptr);
+    /// Background load a resource. An event will be sent when complete. Return true if successfully stored to the load queue, false if eg. already exists. Can be called from outside the main thread. Higher priority resources are loaded first; use e.g. distance-based priority so that streamed assets near the viewer load first.
+    bool BackgroundLoadResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true, Resource* caller = nullptr, int priority = 0);
     /// Return number of pending background-loaded resources.
     unsigned GetNumBackgroundLoadResources() const;
     /// Return all loaded resources of a specific type.
@@ -173,7 +187,7 @@ public:
     /// Template version of releasing a resource by name.
     template <class T> void ReleaseResource(const ea::string& name, bool force = false);
     /// Template version of queueing a resource background load.
-    template <class T> bool BackgroundLoadResource(const ea::string& name, bool sendEventOnFailure = true, Resource* caller = nullptr);
+    template <class T> bool BackgroundLoadResource(const ea::string& name, bool sendEventOnFailure = true, Resource* caller = nullptr, int priority = 0);
     /// Template version of returning loaded resources of a specific type.
     template <class T> void GetResources(ea::vector<T*>& result) const;
     /// Return whether a file exists in the resource directories or package files. Does not check manually added in-memory resources.
@@ -199,6 +213,15 @@ public:
     /// Return how many milliseconds maximum to spend on finishing background loaded resources.
     int GetFinishBackgroundResourcesMs() const { return finishBackgroundResourcesMs_; }
 
+    /// Return whether incremental release of unused resources is enabled.
+    bool GetAutoReleaseResources() const { return autoReleaseResources_; }
+
+    /// Return how many milliseconds a resource must remain unused before the incremental sweep may release it.
+    unsigned GetAutoReleaseDelayMs() const { return autoReleaseDelayMs_; }
+
+    /// Return the maximum number of resources the incremental sweep examines per frame.
+    unsigned GetMaxAutoReleaseChecks() const { return maxAutoReleaseChecks_; }
+
     /// Return a resource router by index.
     ResourceRouter* GetResourceRouter(unsigned index) const;
 
@@ -243,21 +266,35 @@ private:
     const SharedPtr<Resource>& FindResource(StringHash nameHash);
     /// Release resources loaded from a package file.
     void ReleasePackageResources(PackageFile* package, bool force = false);
-    /// Update a resource group. Recalculate memory use and release resources if over memory budget.
+    /// Update a resource group. Recalculate memory use and release resources if over memory budget. The caller must hold the resource map mutex exclusively.
     void UpdateResourceGroup(StringHash type);
+    /// Reload resources that depend on the given changed file, e.g. through XML inheritance.
+    void ReloadDependentResources(const ea::string& fileName, Resource* resource);
+    /// Reload a batch of changed files, running the heavy load phase of independent resources in parallel when possible.
+    void ReloadChangedResources(const ea::vector<ea::string>& fileNames);
+    /// Release a bounded number of unused resources, resuming from where the previous frame's sweep left off.
+    void ReleaseResourcesIncremental();
     /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Search FileSystem for file.
     File* SearchResourceDirs(const ea::string& name);
     /// Search resource packages for file.
     File* SearchPackages(const ea::string& name);
+    /// Return whether a resource name needs no sanitation, so that SanitateResourceName() can skip its allocating slow path.
+    bool IsSanitatedResourceName(const ea::string& name) const;
+    /// Rebuild the name prefixes stripped by SanitateResourceName() from the resource directories.
+    void UpdateResourceDirPrefixes();
 
     /// Mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
     mutable Mutex resourceMutex_;
+    /// Reader-writer mutex for the resource map. Lookups take it in shared mode and may run on any thread; mutations take it exclusively and happen on the main thread only.
+    mutable RWMutex resourceGroupsMutex_;
     /// Resources by type.
     ea::unordered_map<StringHash, ResourceGroup> resourceGroups_;
     /// Resource load directories.
     ea::vector<ea::string> resourceDirs_;
+    /// Per resource directory: the absolute path and its program-directory-relative form, stripped from the front of resource names.
+    ea::vector<ea::pair<ea::string, ea::string> > resourceDirPrefixes_;
     /// File watchers for resource directories, if automatic reloading enabled.
     ea::vector<SharedPtr<FileWatcher> > fileWatchers_;
     /// Package files.
@@ -278,6 +315,16 @@ private:
     mutable bool isRouting_;
     /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
     int finishBackgroundResourcesMs_;
+    /// Incremental release of unused resources flag.
+    bool autoReleaseResources_;
+    /// How many milliseconds a resource must remain unused before the incremental sweep may release it.
+    unsigned autoReleaseDelayMs_;
+    /// Maximum number of resources the incremental sweep examines per frame.
+    unsigned maxAutoReleaseChecks_;
+    /// Resource type group the incremental sweep is currently examining.
+    StringHash releaseSweepType_;
+    /// Next resource for the incremental sweep to examine within its current group.
+    StringHash releaseSweepResource_;
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     ea::vector<ea::string> ignoreResourceAutoReload_;
 };
@@ -306,10 +353,10 @@ template <class T> SharedPtr<T> ResourceCache::GetTempResource(const ea::string&
     return StaticCast<T>(GetTempResource(type, name, sendEventOnFailure));
 }
 
-template <class T> bool ResourceCache::BackgroundLoadResource(const ea::string& name, bool sendEventOnFailure, Resource* caller)
+template <class T> bool ResourceCache::BackgroundLoadResource(const ea::string& name, bool sendEventOnFailure, Resource* caller, int priority)
 {
     StringHash type = T::GetTypeStatic();
-    return BackgroundLoadResource(type, name, sendEventOnFailure, caller);
+    return BackgroundLoadResource(type, name, sendEventOnFailure, caller, priority);
 }
 
 template <class T> void ResourceCache::GetResources(ea::vector<T*>& result) const
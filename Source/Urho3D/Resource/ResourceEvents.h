@@ -67,6 +67,22 @@ URHO3D_EVENT(E_UNKNOWNRESOURCETYPE, UnknownResourceType)
     URHO3D_PARAM(P_RESOURCETYPE, ResourceType);            // StringHash
 }
 
+/// Resource type group remains over its memory budget after eviction. Sent once per frame per group.
+URHO3D_EVENT(E_RESOURCEMEMORYOVERBUDGET, ResourceMemoryOverBudget)
+{
+    URHO3D_PARAM(P_RESOURCETYPE, ResourceType);            // StringHash
+    URHO3D_PARAM(P_MEMORYUSE, MemoryUse);                  // unsigned long long
+    URHO3D_PARAM(P_MEMORYBUDGET, MemoryBudget);            // unsigned long long
+}
+
+/// Unused resources released from a resource type group by the incremental release sweep.
+URHO3D_EVENT(E_RESOURCEGROUPRELEASED, ResourceGroupReleased)
+{
+    URHO3D_PARAM(P_RESOURCETYPE, ResourceType);            // StringHash
+    URHO3D_PARAM(P_RELEASEDCOUNT, ReleasedCount);          // unsigned
+    URHO3D_PARAM(P_MEMORYUSE, MemoryUse);                  // unsigned long long
+}
+
 /// Resource background loading finished.
 URHO3D_EVENT(E_RESOURCEBACKGROUNDLOADED, ResourceBackgroundLoaded)
 {
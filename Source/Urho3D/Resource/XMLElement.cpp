@@ -746,6 +746,11 @@ const char* XMLElement::GetAttributeCString(const char* name) const
     return node.attribute(name).value();
 }
 
+ea::string_view XMLElement::GetAttributeView(const char* name) const
+{
+    return ea::string_view(GetAttributeCString(name));
+}
+
 ea::string XMLElement::GetAttributeLower(const ea::string& name) const
 {
     return GetAttribute(name).to_lower();
@@ -786,7 +791,7 @@ ea::vector<ea::string> XMLElement::GetAttributeNames() const
 
 bool XMLElement::GetBool(const ea::string& name) const
 {
-    return ToBool(GetAttribute(name));
+    return ToBool(GetAttributeCString(name.c_str()));
 }
 
 BoundingBox XMLElement::GetBoundingBox() const
@@ -801,7 +806,7 @@ BoundingBox XMLElement::GetBoundingBox() const
 ea::vector<unsigned char> XMLElement::GetBuffer(const ea::string& name) const
 {
     ea::vector<unsigned char> ret;
-    StringToBuffer(ret, GetAttribute(name));
+    StringToBuffer(ret, GetAttributeCString(name.c_str()));
     return ret;
 }
 
@@ -819,67 +824,67 @@ bool XMLElement::GetBuffer(const ea::string& name, void* dest, unsigned size) co
 
 Color XMLElement::GetColor(const ea::string& name) const
 {
-    return ToColor(GetAttribute(name));
+    return ToColor(GetAttributeCString(name.c_str()));
 }
 
 float XMLElement::GetFloat(const ea::string& name) const
 {
-    return ToFloat(GetAttribute(name));
+    return ToFloat(GetAttributeCString(name.c_str()));
 }
 
 double XMLElement::GetDouble(const ea::string& name) const
 {
-    return ToDouble(GetAttribute(name));
+    return ToDouble(GetAttributeCString(name.c_str()));
 }
 
 unsigned XMLElement::GetUInt(const ea::string& name) const
 {
-    return ToUInt(GetAttribute(name));
+    return ToUInt(GetAttributeCString(name.c_str()));
 }
 
 int XMLElement::GetInt(const ea::string& name) const
 {
-    return ToInt(GetAttribute(name));
+    return ToInt(GetAttributeCString(name.c_str()));
 }
 
 unsigned long long XMLElement::GetUInt64(const ea::string& name) const
 {
-    return ToUInt64(GetAttribute(name));
+    return ToUInt64(GetAttributeCString(name.c_str()));
 }
 
 long long XMLElement::GetInt64(const ea::string& name) const
 {
-    return ToInt64(GetAttribute(name));
+    return ToInt64(GetAttributeCString(name.c_str()));
 }
 
 IntRect XMLElement::GetIntRect(const ea::string& name) const
 {
-    return ToIntRect(GetAttribute(name));
+    return ToIntRect(GetAttributeCString(name.c_str()));
 }
 
 IntVector2 XMLElement::GetIntVector2(const ea::string& name) const
 {
-    return ToIntVector2(GetAttribute(name));
+    return ToIntVector2(GetAttributeCString(name.c_str()));
 }
 
 IntVector3 XMLElement::GetIntVector3(const ea::string& name) const
 {
-    return ToIntVector3(GetAttribute(name));
+    return ToIntVector3(GetAttributeCString(name.c_str()));
 }
 
 Quaternion XMLElement::GetQuaternion(const ea::string& name) const
 {
-    return ToQuaternion(GetAttribute(name));
+    return ToQuaternion(GetAttributeCString(name.c_str()));
 }
 
 Rect XMLElement::GetRect(const ea::string& name) const
 {
-    return ToRect(GetAttribute(name));
+    return ToRect(GetAttributeCString(name.c_str()));
 }
 
 Variant XMLElement::GetVariant() const
 {
-    VariantType type = Variant::GetTypeFromName(GetAttribute("type"));
+    VariantType type = Variant::GetTypeFromName(GetAttributeCString("type"));
     return GetVariantValue(type);
 }
 
@@ -1010,42 +1015,42 @@ VariantMap XMLElement::GetVariantMap() const
 
 Vector2 XMLElement::GetVector2(const ea::string& name) const
 {
-    return ToVector2(GetAttribute(name));
+    return ToVector2(GetAttributeCString(name.c_str()));
 }
 
 Vector3 XMLElement::GetVector3(const ea::string& name) const
 {
-    return ToVector3(GetAttribute(name));
+    return ToVector3(GetAttributeCString(name.c_str()));
 }
 
 Vector4 XMLElement::GetVector4(const ea::string& name) const
 {
-    return ToVector4(GetAttribute(name));
+    return ToVector4(GetAttributeCString(name.c_str()));
 }
 
 Vector4 XMLElement::GetVector(const ea::string& name) const
 {
-    return ToVector4(GetAttribute(name), true);
+    return ToVector4(GetAttributeCString(name.c_str()), true);
 }
 
 Variant XMLElement::GetVectorVariant(const ea::string& name) const
 {
-    return ToVectorVariant(GetAttribute(name));
+    return ToVectorVariant(GetAttributeCString(name.c_str()));
 }
 
 Matrix3 XMLElement::GetMatrix3(const ea::string& name) const
 {
-    return ToMatrix3(GetAttribute(name));
+    return ToMatrix3(GetAttributeCString(name.c_str()));
 }
 
 Matrix3x4 XMLElement::GetMatrix3x4(const ea::string& name) const
 {
-    return ToMatrix3x4(GetAttribute(name));
+    return ToMatrix3x4(GetAttributeCString(name.c_str()));
 }
 
 Matrix4 XMLElement::GetMatrix4(const ea::string& name) const
 {
-    return ToMatrix4(GetAttribute(name));
+    return ToMatrix4(GetAttributeCString(name.c_str()));
 }
 
 XMLFile* XMLElement::GetFile() const
@@ -27,6 +27,7 @@
 #include "../Math/BoundingBox.h"
 #include "../Math/Rect.h"
 
+#include <EASTL/string_view.h>
 #include <EASTL/unique_ptr.h>
 
 namespace pugi
@@ -216,6 +217,8 @@ public:
     ea::string GetAttribute(const char* name) const;
     /// Return attribute as C string, or null if missing.
     const char* GetAttributeCString(const char* name) const;
+    /// Return attribute as a view into the document-owned string, or empty view if missing. The view is valid only as long as the document is alive and unmodified.
+    ea::string_view GetAttributeView(const char* name = "") const;
     /// Return attribute in lowercase, or empty if missing.
     ea::string GetAttributeLower(const ea::string& name) const;
     /// Return attribute in lowercase, or empty if missing.
@@ -38,6 +38,98 @@
 namespace Urho3D
 {
 
+/// File ID of the pre-parsed binary XML format.
+static const char* binaryXMLFileID = "BXML";
+
+/// Node types stored in the pre-parsed binary XML format.
+static const unsigned char BINARY_XML_ELEMENT = 0;
+static const unsigned char BINARY_XML_PCDATA = 1;
+static const unsigned char BINARY_XML_CDATA = 2;
+
+/// Return whether the node is stored in the pre-parsed binary XML format.
+static bool IsBinaryXMLNode(const pugi::xml_node& node)
+{
+    const pugi::xml_node_type type = node.type();
+    return type == pugi::node_element || type == pugi::node_pcdata || type == pugi::node_cdata;
+}
+
+/// Write a node recursively in the pre-parsed binary XML format.
+static bool WriteBinaryXMLNode(Serializer& dest, const pugi::xml_node& node)
+{
+    bool success = true;
+    if (node.type() == pugi::node_element)
+    {
+        success &= dest.WriteUByte(BINARY_XML_ELEMENT);
+        success &= dest.WriteString(node.name());
+
+        unsigned numAttributes = 0;
+        for (pugi::xml_attribute attribute = node.first_attribute(); attribute; attribute = attribute.next_attribute())
+            ++numAttributes;
+        success &= dest.WriteVLE(numAttributes);
+        for (pugi::xml_attribute attribute = node.first_attribute(); attribute; attribute = attribute.next_attribute())
+        {
+            success &= dest.WriteString(attribute.name());
+            success &= dest.WriteString(attribute.value());
+        }
+
+        unsigned numChildren = 0;
+        for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling())
+        {
+            if (IsBinaryXMLNode(child))
+                ++numChildren;
+        }
+        success &= dest.WriteVLE(numChildren);
+        for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling())
+        {
+            if (IsBinaryXMLNode(child))
+                success &= WriteBinaryXMLNode(dest, child);
+        }
+    }
+    else
+    {
+        success &= dest.WriteUByte(node.type() == pugi::node_cdata ? BINARY_XML_CDATA : BINARY_XML_PCDATA);
+        success &= dest.WriteString(node.value());
+    }
+    return success;
+}
+
+/// Read a node recursively from the pre-parsed binary XML format.
+static bool ReadBinaryXMLNode(Deserializer& source, pugi::xml_node parent)
+{
+    if (source.IsEof())
+        return false;
+
+    const unsigned char type = source.ReadUByte();
+    if (type == BINARY_XML_ELEMENT)
+    {
+        pugi::xml_node node = parent.append_child(pugi::node_element);
+        node.set_name(source.ReadString().c_str());
+
+        const unsigned numAttributes = source.ReadVLE();
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            pugi::xml_attribute attribute = node.append_attribute(source.ReadString().c_str());
+            attribute.set_value(source.ReadString().c_str());
+        }
+
+        const unsigned numChildren = source.ReadVLE();
+        for (unsigned i = 0; i < numChildren; ++i)
+        {
+            if (!ReadBinaryXMLNode(source, node))
+                return false;
+        }
+        return true;
+    }
+    else if (type == BINARY_XML_PCDATA || type == BINARY_XML_CDATA)
+    {
+        pugi::xml_node node = parent.append_child(type == BINARY_XML_CDATA ? pugi::node_cdata : pugi::node_pcdata);
+        node.set_value(source.ReadString().c_str());
+        return true;
+    }
+    else
+        return false;
+}
+
 /// XML writer for pugixml.
 class XMLWriter : public pugi::xml_writer
 {
@@ -88,7 +180,18 @@ bool XMLFile::BeginLoad(Deserializer& source)
     if (source.Read(buffer.get(), dataSize) != dataSize)
         return false;
 
-    if (!document_->load_buffer(buffer.get(), dataSize))
+    if (dataSize >= 4 && memcmp(buffer.get(), binaryXMLFileID, 4) == 0)
+    {
+        // Pre-parsed binary XML, e.g. converted by PackageTool. Rebuild the document without text parsing
+        MemoryBuffer binarySource(buffer.get() + 4, dataSize - 4);
+        if (!BeginLoadBinary(binarySource))
+        {
+            URHO3D_LOGERROR("Could not load binary XML data from " + source.GetName());
+            document_->reset();
+            return false;
+        }
+    }
+    else if (!document_->load_buffer(buffer.get(), dataSize))
     {
         URHO3D_LOGERROR("Could not parse XML data from " + source.GetName());
         document_->reset();
@@ -101,6 +204,11 @@ bool XMLFile::BeginLoad(Deserializer& source)
     {
         // The existence of this attribute indicates this is an RFC 5261 patch file
         auto* cache = GetSubsystem<ResourceCache>();
+        if (!cache)
+        {
+            URHO3D_LOGERROR("ResourceCache is required to load inherited XML file: " + inherit);
+            return false;
+        }
         // If being async loaded, GetResource() is not safe, so use GetTempResource() instead
         SharedPtr<XMLFile> inheritedXMLFile(
             GetAsyncLoadState() == ASYNC_DONE ? SharedPtr<XMLFile>(cache->GetResource<XMLFile>(inherit)) :
@@ -134,6 +242,38 @@ bool XMLFile::Save(Serializer& dest) const
     return Save(dest, "\t");
 }
 
+bool XMLFile::SaveBinary(Serializer& dest) const
+{
+    bool success = dest.WriteFileID(binaryXMLFileID);
+
+    unsigned numChildren = 0;
+    for (pugi::xml_node child = document_->first_child(); child; child = child.next_sibling())
+    {
+        if (IsBinaryXMLNode(child))
+            ++numChildren;
+    }
+    success &= dest.WriteVLE(numChildren);
+    for (pugi::xml_node child = document_->first_child(); child; child = child.next_sibling())
+    {
+        if (IsBinaryXMLNode(child))
+            success &= WriteBinaryXMLNode(dest, child);
+    }
+    return success;
+}
+
+bool XMLFile::BeginLoadBinary(Deserializer& source)
+{
+    document_->reset();
+
+    const unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        if (!ReadBinaryXMLNode(source, *document_))
+            return false;
+    }
+    return true;
+}
+
 bool XMLFile::Save(Serializer& dest, const ea::string& indentation) const
 {
     XMLWriter writer(dest);
@@ -56,6 +56,8 @@ public:
     bool Save(Serializer& dest) const override;
     /// Save resource with user-defined indentation. Return true if successful.
     bool Save(Serializer& dest, const ea::string& indentation) const;
+    /// Save the document in pre-parsed binary form, loadable without text parsing. Return true if successful.
+    bool SaveBinary(Serializer& dest) const;
 
     /// Deserialize from a string. Return true if successful.
     bool FromString(const ea::string& source);
@@ -79,6 +81,8 @@ public:
     void Patch(const XMLElement& patchElement);
 
 private:
+    /// Load the document from pre-parsed binary form. Source position shall be after the file ID.
+    bool BeginLoadBinary(Deserializer& source);
     /// Add an node in the Patch.
     void PatchAdd(const pugi::xml_node& patch, pugi::xpath_node& original) const;
     /// Replace a node or attribute in the Patch.
@@ -44,7 +44,9 @@ extern const char* wrapModeNames[];
 AttributeAnimationInfo::AttributeAnimationInfo(Animatable* animatable, const AttributeInfo& attributeInfo,
     ValueAnimation* attributeAnimation, WrapMode wrapMode, float speed) :
     ValueAnimationInfo(animatable, attributeAnimation, wrapMode, speed),
-    attributeInfo_(attributeInfo)
+    attributeInfo_(attributeInfo),
+    deferApplyAttributes_(false),
+    applyAttributesPending_(false)
 {
 }
 
@@ -55,11 +57,15 @@ AttributeAnimationInfo::~AttributeAnimationInfo() = default;
 void AttributeAnimationInfo::ApplyValue(const Variant& newValue)
 {
     auto* animatable = static_cast<Animatable*>(target_.Get());
-    if (animatable)
-    {
-        animatable->OnSetAttribute(attributeInfo_, newValue);
+    if (!animatable)
+        return;
+
+    animatable->OnSetAttribute(attributeInfo_, newValue);
+
+    if (deferApplyAttributes_)
+        applyAttributesPending_ = true;
+    else
         animatable->ApplyAttributes();
-    }
 }
 
 Animatable::Animatable(Context* context) :
@@ -422,14 +428,9 @@ void Animatable::SetAttributeAnimation(const ea::string& name, ValueAnimation* a
                 return;
             }
 
-            for (auto i = attributes->begin(); i != attributes->end(); ++i)
-            {
-                if (name == (*i).name_)
-                {
-                    attributeInfo = &(*i);
-                    break;
-                }
-            }
+            const unsigned index = GetAttributeIndex(name);
+            if (index != M_MAX_UNSIGNED)
+                attributeInfo = &attributes->at(index);
         }
 
         if (!attributeInfo)
@@ -594,18 +595,30 @@ void Animatable::UpdateAttributeAnimations(float timeStep)
     WeakPtr<Animatable> self(this);
 
     ea::vector<ea::string> finishedNames;
+    bool applyAttributesPending = false;
     for (auto i = attributeAnimationInfos_.begin();
          i != attributeAnimationInfos_.end(); ++i)
     {
-        bool finished = i->second->Update(timeStep);
+        AttributeAnimationInfo* info = i->second;
+
+        // Batch ApplyAttributes into a single call after all animated attributes have been written, instead of
+        // re-applying per attribute
+        info->SetDeferApplyAttributes(true);
+        bool finished = info->Update(timeStep);
         // If self deleted as a result of an event sent during animation playback, nothing more to do
         if (self.Expired())
             return;
 
+        info->SetDeferApplyAttributes(false);
+        applyAttributesPending |= info->ConsumePendingApplyAttributes();
+
         if (finished)
-            finishedNames.push_back(i->second->GetAttributeInfo().name_);
+            finishedNames.push_back(info->GetAttributeInfo().name_);
     }
 
+    if (applyAttributesPending)
+        ApplyAttributes();
+
     for (unsigned i = 0; i < finishedNames.size(); ++i)
         SetAttributeAnimation(finishedNames[i], nullptr);
 }
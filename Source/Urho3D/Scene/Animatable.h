@@ -52,6 +52,18 @@ public:
     /// Return attribute information.
     const AttributeInfo& GetAttributeInfo() const { return attributeInfo_; }
 
+    /// Set whether ApplyAttributes on the target is deferred to one batched call after all animations have updated.
+    /// Attribute values are still written immediately, only the ApplyAttributes side effects are deferred.
+    void SetDeferApplyAttributes(bool enable) { deferApplyAttributes_ = enable; }
+
+    /// Return whether a deferred ApplyAttributes is pending, and clear the flag.
+    bool ConsumePendingApplyAttributes()
+    {
+        const bool pending = applyAttributesPending_;
+        applyAttributesPending_ = false;
+        return pending;
+    }
+
 protected:
     /// Apply new animation value to the target object. Called by Update().
     void ApplyValue(const Variant& newValue) override;
@@ -59,6 +71,10 @@ protected:
 private:
     /// Attribute information.
     const AttributeInfo& attributeInfo_;
+    /// Whether ApplyAttributes on the target is deferred.
+    bool deferApplyAttributes_;
+    /// Whether a deferred ApplyAttributes is pending.
+    bool applyAttributesPending_;
 };
 
 /// Base class for animatable object, an animatable object can be set animation on it's attributes, or can be set an object animation to it.
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../IO/Log.h"
+#include "../Resource/XMLElement.h"
+#include "../Scene/CompiledPrefab.h"
+#include "../Scene/Component.h"
+#include "../Scene/SceneResolver.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+CompiledPrefab::CompiledPrefab(Context* context) :
+    context_(context)
+{
+}
+
+CompiledPrefab::~CompiledPrefab() = default;
+
+bool CompiledPrefab::Compile(const XMLElement& source)
+{
+    URHO3D_PROFILE("CompilePrefab");
+
+    nodes_.clear();
+
+    if (source.IsNull() || source.GetName() != "node")
+    {
+        URHO3D_LOGERROR("Could not compile prefab, source is not a node element");
+        return false;
+    }
+
+    CompileNode(source, M_MAX_UNSIGNED);
+    if (useSharedDefaults_)
+        BuildSharedDefaults();
+    return true;
+}
+
+void CompiledPrefab::SetUseSharedDefaults(bool enable)
+{
+    useSharedDefaults_ = enable;
+    if (enable && !nodes_.empty() && !nodes_[0].defaults_)
+        BuildSharedDefaults();
+}
+
+Node* CompiledPrefab::Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation,
+    CreateMode mode) const
+{
+    if (nodes_.empty() || !parent)
+        return nullptr;
+
+    URHO3D_PROFILE("InstantiatePrefab");
+
+    SceneResolver resolver;
+    ea::vector<Node*> createdNodes(nodes_.size());
+
+    for (unsigned i = 0; i < nodes_.size(); ++i)
+    {
+        const PrefabNode& prefabNode = nodes_[i];
+
+        // Rewrite IDs when instantiating
+        Node* node = (prefabNode.parent_ == M_MAX_UNSIGNED ? parent : createdNodes[prefabNode.parent_])->
+            CreateChild(EMPTY_STRING, mode);
+        createdNodes[i] = node;
+        resolver.AddNode(prefabNode.oldID_, node);
+
+        for (const PrefabAttribute& attr : prefabNode.attributes_)
+            node->SetAttribute(attr.index_, attr.value_);
+        if (useSharedDefaults_)
+            node->SetSharedDefaults(prefabNode.defaults_);
+
+        for (const PrefabComponent& prefabComponent : prefabNode.components_)
+        {
+            // Use the factory resolved at compile time when available, skipping the per-spawn factory hash lookup
+            Component* component = prefabComponent.factory_
+                ? node->CreateComponent(prefabComponent.factory_, mode)
+                : node->CreateComponent(prefabComponent.type_, mode);
+            if (!component)
+                continue;
+
+            resolver.AddComponent(prefabComponent.oldID_, component);
+            for (const PrefabAttribute& attr : prefabComponent.attributes_)
+                component->SetAttribute(attr.index_, attr.value_);
+            if (useSharedDefaults_)
+                component->SetSharedDefaults(prefabComponent.defaults_);
+        }
+    }
+
+    resolver.Resolve();
+    createdNodes[0]->SetTransform(position, rotation);
+    createdNodes[0]->ApplyAttributes();
+    return createdNodes[0];
+}
+
+unsigned CompiledPrefab::CompileNode(const XMLElement& source, unsigned parentIndex)
+{
+    const unsigned index = nodes_.size();
+    nodes_.push_back(PrefabNode{});
+    nodes_[index].parent_ = parentIndex;
+    nodes_[index].oldID_ = source.GetUInt("id");
+    CompileAttributes(source, context_->GetAttributes(Node::GetTypeStatic()), nodes_[index].attributes_);
+
+    XMLElement compElem = source.GetChild("component");
+    while (compElem)
+    {
+        PrefabComponent component;
+        component.type_ = StringHash(compElem.GetAttribute("type"));
+        component.factory_ = context_->GetFactory(component.type_);
+        component.oldID_ = compElem.GetUInt("id");
+        CompileAttributes(compElem, context_->GetAttributes(component.type_), component.attributes_);
+        nodes_[index].components_.push_back(ea::move(component));
+        compElem = compElem.GetNext("component");
+    }
+
+    XMLElement childElem = source.GetChild("node");
+    while (childElem)
+    {
+        // Do not hold a reference into nodes_ across the recursion, as it may reallocate
+        CompileNode(childElem, index);
+        childElem = childElem.GetNext("node");
+    }
+
+    return index;
+}
+
+void CompiledPrefab::CompileAttributes(const XMLElement& source, const ea::vector<AttributeInfo>* attributes,
+    ea::vector<PrefabAttribute>& dest)
+{
+    if (!attributes)
+        return;
+
+    XMLElement attrElem = source.GetChild("attribute");
+    unsigned startIndex = 0;
+
+    while (attrElem)
+    {
+        ea::string name = attrElem.GetAttribute("name");
+        unsigned i = startIndex;
+        unsigned attempts = attributes->size();
+
+        while (attempts)
+        {
+            const AttributeInfo& attr = attributes->at(i);
+            if (attr.ShouldLoad() && !attr.name_.compare(name))
+            {
+                Variant varValue;
+
+                // If enums specified, do enum lookup and int assignment. Otherwise assign the variant directly
+                if (attr.enumNames_ && attr.type_ == VAR_INT)
+                {
+                    ea::string value = attrElem.GetAttribute("value");
+                    bool enumFound = false;
+                    int enumValue = 0;
+                    const char** enumPtr = attr.enumNames_;
+                    while (*enumPtr)
+                    {
+                        if (!value.comparei(*enumPtr))
+                        {
+                            enumFound = true;
+                            break;
+                        }
+                        ++enumPtr;
+                        ++enumValue;
+                    }
+                    if (enumFound)
+                        varValue = enumValue;
+                    else
+                        URHO3D_LOGWARNING("Unknown enum value " + value + " in attribute " + attr.name_);
+                }
+                else
+                    varValue = attrElem.GetVariantValue(attr.type_, context_);
+
+                if (!varValue.IsEmpty())
+                    dest.push_back(PrefabAttribute{i, ea::move(varValue)});
+
+                startIndex = (i + 1) % attributes->size();
+                break;
+            }
+            else
+            {
+                i = (i + 1) % attributes->size();
+                --attempts;
+            }
+        }
+
+        if (!attempts)
+            URHO3D_LOGWARNING("Unknown attribute " + name + " in prefab XML data");
+
+        attrElem = attrElem.GetNext("attribute");
+    }
+}
+
+void CompiledPrefab::BuildSharedDefaults()
+{
+    const ea::vector<AttributeInfo>* nodeAttributes = context_->GetAttributes(Node::GetTypeStatic());
+
+    for (PrefabNode& prefabNode : nodes_)
+    {
+        prefabNode.defaults_ = BuildDefaultsTable(nodeAttributes, prefabNode.attributes_);
+        for (PrefabComponent& component : prefabNode.components_)
+            component.defaults_ = BuildDefaultsTable(context_->GetAttributes(component.type_), component.attributes_);
+    }
+}
+
+SharedPtr<SharedAttributeDefaults> CompiledPrefab::BuildDefaultsTable(const ea::vector<AttributeInfo>* attributes,
+    const ea::vector<PrefabAttribute>& values) const
+{
+    if (!attributes || values.empty())
+        return nullptr;
+
+    SharedPtr<SharedAttributeDefaults> table(new SharedAttributeDefaults());
+    for (const PrefabAttribute& value : values)
+    {
+        const AttributeInfo& attr = attributes->at(value.index_);
+        // ID references are remapped per instance, so the prefab values are never meaningful defaults
+        if (attr.mode_ & (AM_NODEID | AM_COMPONENTID | AM_NODEIDVECTOR))
+            continue;
+        table->SetDefault(attr.name_, value.value_);
+    }
+
+    return table->Size() ? table : nullptr;
+}
+
+}
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Core/Attribute.h"
+#include "../Core/Variant.h"
+#include "../Math/Quaternion.h"
+#include "../Scene/Node.h"
+
+namespace Urho3D
+{
+
+class XMLElement;
+
+/// Compiled prefab representation for hot-path spawning. Compilation walks a node prefab XML element once
+/// and records a flat creation program: child topology, component types and attribute index/value pairs with
+/// attribute names and enum strings already resolved. Instantiation replays the program with plain Variant
+/// value copies and index-based attribute assignment, skipping XML traversal and per-spawn attribute name
+/// lookups. Node and component ID references within the prefab are remapped on each instantiation. Can
+/// optionally hand instances shared default value tables, see SetUseSharedDefaults(). Used through
+/// Scene::InstantiateXMLCached() or directly for manually managed prefabs.
+class URHO3D_API CompiledPrefab : public RefCounted
+{
+public:
+    /// Construct.
+    explicit CompiledPrefab(Context* context);
+    /// Destruct.
+    ~CompiledPrefab() override;
+
+    /// Compile the creation program from a node prefab XML element. Return true if successful.
+    bool Compile(const XMLElement& source);
+    /// Enable or disable shared default values on instances. When enabled, each spawned node and component
+    /// references one immutable table of the prefab's attribute values in place of per-instance default value
+    /// copies, so unmodified attributes are skipped when instances are serialized and a scene full of identical
+    /// instances stores the prefab values only once. Per-instance default changes copy on write. Only intended
+    /// for instances whose serialization is resolved against the prefab; plain scene saves of such instances
+    /// lose the skipped values. Disabled by default.
+    void SetUseSharedDefaults(bool enable);
+    /// Instantiate the prefab as a child of the given node by replaying the creation program. Return the
+    /// created root node, or null if the prefab is empty.
+    Node* Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation,
+        CreateMode mode = REPLICATED) const;
+
+    /// Return whether instances reference shared default values.
+    bool GetUseSharedDefaults() const { return useSharedDefaults_; }
+    /// Return whether a creation program has been compiled.
+    bool IsCompiled() const { return !nodes_.empty(); }
+    /// Return number of nodes in the creation program.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+
+private:
+    /// Pre-resolved attribute assignment.
+    struct PrefabAttribute
+    {
+        /// Attribute index.
+        unsigned index_;
+        /// Attribute value.
+        Variant value_;
+    };
+
+    /// Component creation record.
+    struct PrefabComponent
+    {
+        /// Component type.
+        StringHash type_;
+        /// Factory resolved at compile time, used as a direct-call creation token. Null if the type was not
+        /// registered when the prefab was compiled.
+        SharedPtr<ObjectFactory> factory_;
+        /// Component ID in the source prefab, used for ID reference remapping.
+        unsigned oldID_;
+        /// Attribute assignments.
+        ea::vector<PrefabAttribute> attributes_;
+        /// Default value table shared by all instances. Null until shared defaults are enabled.
+        SharedPtr<SharedAttributeDefaults> defaults_;
+    };
+
+    /// Node creation record.
+    struct PrefabNode
+    {
+        /// Index of the parent node record, or M_MAX_UNSIGNED for the root.
+        unsigned parent_;
+        /// Node ID in the source prefab, used for ID reference remapping.
+        unsigned oldID_;
+        /// Attribute assignments.
+        ea::vector<PrefabAttribute> attributes_;
+        /// Components to create.
+        ea::vector<PrefabComponent> components_;
+        /// Default value table shared by all instances. Null until shared defaults are enabled.
+        SharedPtr<SharedAttributeDefaults> defaults_;
+    };
+
+    /// Compile one node element and recursively its children. Return the node record index.
+    unsigned CompileNode(const XMLElement& source, unsigned parentIndex);
+    /// Compile the attribute assignments of a node or component element against a type's attribute list.
+    void CompileAttributes(const XMLElement& source, const ea::vector<AttributeInfo>* attributes,
+        ea::vector<PrefabAttribute>& dest);
+    /// Build the shared default value tables for all node and component records.
+    void BuildSharedDefaults();
+    /// Build one shared default value table from attribute assignments. Return null if there is nothing to share.
+    SharedPtr<SharedAttributeDefaults> BuildDefaultsTable(const ea::vector<AttributeInfo>* attributes,
+        const ea::vector<PrefabAttribute>& values) const;
+
+    /// Execution context for attribute resolution.
+    Context* context_;
+    /// Node creation records in parent-before-child order.
+    ea::vector<PrefabNode> nodes_;
+    /// Whether instances reference shared default values.
+    bool useSharedDefaults_{};
+};
+
+}
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Registry of scene objects within one ID range. IDs handed out by Allocate() index a dense slot array
+/// through a free list, making spawn-time allocation, insertion, lookup and removal O(1) array operations
+/// instead of hash-map churn, and keeping the IDs compact for dense iteration. Arbitrary preset IDs, as
+/// assigned by scene loading or network replication, are stored in an overflow hash map until the dense
+/// range grows to cover them, at which point they are migrated. Lookup of a freed ID returns null.
+template <class T> class IdRegistry
+{
+public:
+    /// Construct with the inclusive ID range managed by the registry.
+    IdRegistry(unsigned firstId, unsigned lastId) :
+        firstId_(firstId),
+        lastId_(lastId)
+    {
+    }
+
+    /// Allocate a free ID and reserve its slot. The slot stays empty until Insert() is called for the ID.
+    unsigned Allocate()
+    {
+        // Reuse freed slots first. Entries are validated lazily, as Insert() with a preset ID may have
+        // re-occupied a slot that is still on the free list
+        while (!freeSlots_.empty())
+        {
+            const unsigned index = freeSlots_.back();
+            freeSlots_.pop_back();
+            if (!slots_[index].allocated_)
+            {
+                slots_[index].allocated_ = true;
+                return firstId_ + index;
+            }
+        }
+
+        // Grow the dense array. IDs already taken by preset insertions are migrated from the overflow map
+        // into their slots and skipped. The ID range (at least 16M values) can not be exhausted before
+        // allocation of the slot array fails, matching the old wrapping-counter behavior
+        for (;;)
+        {
+            const unsigned index = slots_.size();
+            const unsigned id = firstId_ + index;
+
+            Slot slot;
+            slot.allocated_ = true;
+
+            auto it = overflow_.find(id);
+            if (it != overflow_.end())
+            {
+                slot.object_ = it->second;
+                overflow_.erase(it);
+                slots_.push_back(slot);
+                continue;
+            }
+
+            slots_.push_back(slot);
+            return id;
+        }
+    }
+
+    /// Insert an object with given ID, overwriting any existing object with the same ID.
+    void Insert(unsigned id, T* object)
+    {
+        const unsigned index = id - firstId_;
+        if (index < slots_.size())
+        {
+            Slot& slot = slots_[index];
+            if (!slot.object_)
+                ++size_;
+            slot.object_ = object;
+            slot.allocated_ = true;
+        }
+        else
+        {
+            T*& ref = overflow_[id];
+            if (!ref)
+                ++size_;
+            ref = object;
+        }
+    }
+
+    /// Remove the object with given ID and free the ID for reuse.
+    void Erase(unsigned id)
+    {
+        const unsigned index = id - firstId_;
+        if (index < slots_.size())
+        {
+            Slot& slot = slots_[index];
+            if (slot.object_)
+                --size_;
+            if (slot.allocated_)
+            {
+                slot.object_ = nullptr;
+                slot.allocated_ = false;
+                freeSlots_.push_back(index);
+            }
+        }
+        else
+            size_ -= overflow_.erase(id);
+    }
+
+    /// Return the object with given ID, or null if not found.
+    T* Get(unsigned id) const
+    {
+        const unsigned index = id - firstId_;
+        if (index < slots_.size())
+            return slots_[index].object_;
+
+        auto it = overflow_.find(id);
+        return it != overflow_.end() ? it->second : nullptr;
+    }
+
+    /// Return whether an object with given ID exists.
+    bool Contains(unsigned id) const { return Get(id) != nullptr; }
+
+    /// Return number of objects.
+    unsigned Size() const { return size_; }
+
+    /// Invoke a callback with the ID and object of each entry. The callback must not insert or remove entries.
+    template <class TCallback> void ForEach(const TCallback& callback) const
+    {
+        for (unsigned i = 0; i < slots_.size(); ++i)
+        {
+            if (slots_[i].object_)
+                callback(firstId_ + i, slots_[i].object_);
+        }
+        for (auto it = overflow_.begin(); it != overflow_.end(); ++it)
+            callback(it->first, it->second);
+    }
+
+private:
+    /// One dense ID slot.
+    struct Slot
+    {
+        /// Stored object. Null while the ID is merely reserved or free.
+        T* object_{};
+        /// Whether the ID is handed out or occupied.
+        bool allocated_{};
+    };
+
+    /// First ID of the managed range.
+    unsigned firstId_;
+    /// Last ID of the managed range.
+    unsigned lastId_;
+    /// Dense slots for IDs counting up from the first ID.
+    ea::vector<Slot> slots_;
+    /// Indices of freed slots. May contain stale entries, validated on allocation.
+    ea::vector<unsigned> freeSlots_;
+    /// Preset IDs beyond the dense range.
+    ea::unordered_map<unsigned, T*> overflow_;
+    /// Number of objects.
+    unsigned size_{};
+};
+
+}
@@ -37,11 +37,17 @@ LogicComponent::LogicComponent(Context* context) :
     Component(context),
     updateEventMask_(USE_UPDATE | USE_POSTUPDATE | USE_FIXEDUPDATE | USE_FIXEDPOSTUPDATE),
     currentEventMask_(0),
+    parallelUpdateScene_(nullptr),
+    threadSafeUpdate_(false),
     delayedStartCalled_(false)
 {
 }
 
-LogicComponent::~LogicComponent() = default;
+LogicComponent::~LogicComponent()
+{
+    if (parallelUpdateScene_)
+        parallelUpdateScene_->RemoveParallelUpdate(this);
+}
 
 void LogicComponent::OnSetEnabled()
 {
@@ -52,6 +58,10 @@ void LogicComponent::Update(float timeStep)
 {
 }
 
+void LogicComponent::CommitUpdate(float timeStep)
+{
+}
+
 void LogicComponent::PostUpdate(float timeStep)
 {
 }
@@ -73,6 +83,15 @@ void LogicComponent::SetUpdateEventMask(UpdateEventFlags mask)
     }
 }
 
+void LogicComponent::SetThreadSafeUpdate(bool enable)
+{
+    if (threadSafeUpdate_ != enable)
+    {
+        threadSafeUpdate_ = enable;
+        UpdateEventSubscription();
+    }
+}
+
 void LogicComponent::OnNodeSet(Node* node)
 {
     if (node)
@@ -99,6 +118,11 @@ void LogicComponent::OnSceneSet(Scene* scene)
         UnsubscribeFromEvent(E_PHYSICSPRESTEP);
         UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
 #endif
+        if (parallelUpdateScene_)
+        {
+            parallelUpdateScene_->RemoveParallelUpdate(this);
+            parallelUpdateScene_ = nullptr;
+        }
         currentEventMask_ = USE_NO_EVENT;
     }
 }
@@ -111,7 +135,9 @@ void LogicComponent::UpdateEventSubscription()
 
     bool enabled = IsEnabledEffective();
 
-    bool needUpdate = enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_);
+    // Thread-safe components get the update from the scene's parallel update phase instead of the event,
+    // but still need the event once for the delayed start
+    bool needUpdate = enabled && (((updateEventMask_ & USE_UPDATE) && !threadSafeUpdate_) || !delayedStartCalled_);
     if (needUpdate && !(currentEventMask_ & USE_UPDATE))
     {
         SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
@@ -123,6 +149,18 @@ void LogicComponent::UpdateEventSubscription()
         currentEventMask_ &= ~USE_UPDATE;
     }
 
+    bool needParallelUpdate = enabled && threadSafeUpdate_ && (updateEventMask_ & USE_UPDATE);
+    if (needParallelUpdate && !parallelUpdateScene_)
+    {
+        scene->AddParallelUpdate(this);
+        parallelUpdateScene_ = scene;
+    }
+    else if (!needParallelUpdate && parallelUpdateScene_)
+    {
+        parallelUpdateScene_->RemoveParallelUpdate(this);
+        parallelUpdateScene_ = nullptr;
+    }
+
     bool needPostUpdate = enabled && (updateEventMask_ & USE_POSTUPDATE);
     if (needPostUpdate && !(currentEventMask_ & USE_POSTUPDATE))
     {
@@ -176,8 +214,8 @@ void LogicComponent::HandleSceneUpdate(StringHash eventType, VariantMap& eventDa
         DelayedStart();
         delayedStartCalled_ = true;
 
-        // If did not need actual update events, unsubscribe now
-        if (!(updateEventMask_ & USE_UPDATE))
+        // If did not need actual update events, or updates come from the parallel update phase, unsubscribe now
+        if (!(updateEventMask_ & USE_UPDATE) || threadSafeUpdate_)
         {
             UnsubscribeFromEvent(GetScene(), E_SCENEUPDATE);
             currentEventMask_ &= ~USE_UPDATE;
@@ -67,8 +67,10 @@ class URHO3D_API LogicComponent : public Component
     /// Called when the component is detached from a scene node, usually on destruction. Note that you will no longer have access to the node and scene at that point.
     virtual void Stop() { }
 
-    /// Called on scene update, variable timestep.
+    /// Called on scene update, variable timestep. If thread-safe update is enabled, may be executed from a worker thread and must not modify shared state.
     virtual void Update(float timeStep);
+    /// Called serially on the main thread after the parallel update phase. Use to apply results of a thread-safe Update.
+    virtual void CommitUpdate(float timeStep);
     /// Called on scene post-update, variable timestep.
     virtual void PostUpdate(float timeStep);
     /// Called on physics update, fixed timestep.
@@ -82,6 +84,12 @@ class URHO3D_API LogicComponent : public Component
     /// Return what update events are subscribed to.
     UpdateEventFlags GetUpdateEventMask() const { return updateEventMask_; }
 
+    /// Set whether Update is thread-safe and should run in the scene's parallel update phase instead of the scene update event. Like the update event mask, this is not an attribute and should be called e.g. in the subclass constructor.
+    void SetThreadSafeUpdate(bool enable);
+
+    /// Return whether Update runs in the scene's parallel update phase.
+    bool HasThreadSafeUpdate() const { return threadSafeUpdate_; }
+
     /// Return whether the DelayedStart() function has been called.
     bool IsDelayedStartCalled() const { return delayedStartCalled_; }
 
@@ -108,6 +116,10 @@ private:
     UpdateEventFlags updateEventMask_;
     /// Current event subscription mask.
     UpdateEventFlags currentEventMask_;
+    /// Scene the component is registered to for parallel update.
+    Scene* parallelUpdateScene_;
+    /// Whether Update is thread-safe and runs in the parallel update phase.
+    bool threadSafeUpdate_;
     /// Flag for delayed start.
     bool delayedStartCalled_;
 };
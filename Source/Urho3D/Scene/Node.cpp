@@ -88,7 +88,7 @@ void Node::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Scale", GetScale, SetScale, Vector3, Vector3::ONE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Variables", VariantMap, vars_, Variant::emptyVariantMap, AM_FILE); // Network replication of vars uses custom data
     URHO3D_ACCESSOR_ATTRIBUTE("Network Position", GetNetPositionAttr, SetNetPositionAttr, Vector3, Vector3::ZERO,
-        AM_NET | AM_LATESTDATA | AM_NOEDIT);
+        AM_NET | AM_LATESTDATA | AM_NOEDIT | AM_QUANTIZE);
     URHO3D_ACCESSOR_ATTRIBUTE("Network Rotation", GetNetRotationAttr, SetNetRotationAttr, ea::vector<unsigned char>, Variant::emptyBuffer,
         AM_NET | AM_LATESTDATA | AM_NOEDIT);
     URHO3D_ACCESSOR_ATTRIBUTE("Network Parent Node", GetNetParentAttr, SetNetParentAttr, ea::vector<unsigned char>, Variant::emptyBuffer,
@@ -1074,6 +1074,31 @@ Component* Node::CreateComponent(StringHash type, CreateMode mode, unsigned id)
     return newComponent;
 }
 
+Component* Node::CreateComponent(ObjectFactory* factory, CreateMode mode, unsigned id)
+{
+    if (!factory)
+    {
+        URHO3D_LOGERROR("Null factory given for CreateComponent");
+        return nullptr;
+    }
+
+    // Do not attempt to create replicated components to local nodes, as that may lead to component ID overwrite
+    // as replicated components are synced over
+    if (mode == REPLICATED && !IsReplicated())
+        mode = LOCAL;
+
+    // Check that creation succeeds and that the object in fact is a component
+    SharedPtr<Component> newComponent = DynamicCast<Component>(factory->CreateObject());
+    if (!newComponent)
+    {
+        URHO3D_LOGERROR("Could not create component from factory of type " + factory->GetTypeName());
+        return nullptr;
+    }
+
+    AddComponent(newComponent, id, mode);
+    return newComponent;
+}
+
 Component* Node::GetOrCreateComponent(StringHash type, CreateMode mode, unsigned id)
 {
     Component* oldComponent = GetComponent(type);
@@ -1611,9 +1636,9 @@ void Node::SetNetRotationAttr(const ea::vector<unsigned char>& value)
     MemoryBuffer buf(value);
     auto* transform = GetComponent<SmoothedTransform>();
     if (transform)
-        transform->SetTargetRotation(buf.ReadPackedQuaternion());
+        transform->SetTargetRotation(buf.ReadQuaternionSmallestThree());
     else
-        SetRotation(buf.ReadPackedQuaternion());
+        SetRotation(buf.ReadQuaternionSmallestThree());
 }
 
 void Node::SetNetParentAttr(const ea::vector<unsigned char>& value)
@@ -1661,7 +1686,7 @@ const Vector3& Node::GetNetPositionAttr() const
 const ea::vector<unsigned char>& Node::GetNetRotationAttr() const
 {
     impl_->attrBuffer_.Clear();
-    impl_->attrBuffer_.WritePackedQuaternion(rotation_);
+    impl_->attrBuffer_.WriteQuaternionSmallestThree(rotation_);
     return impl_->attrBuffer_.GetBuffer();
 }
 
@@ -305,6 +305,9 @@ public:
     void RemoveChildren(bool removeReplicated, bool removeLocal, bool recursive);
     /// Create a component to this node (with specified ID if provided).
     Component* CreateComponent(StringHash type, CreateMode mode = REPLICATED, unsigned id = 0);
+    /// Create a component through a pre-resolved factory, skipping the factory hash lookup. Get the factory once
+    /// with Context::GetFactory() and reuse it on spawn-heavy paths.
+    Component* CreateComponent(ObjectFactory* factory, CreateMode mode = REPLICATED, unsigned id = 0);
     /// Create a component to this node if it does not exist already.
     Component* GetOrCreateComponent(StringHash type, CreateMode mode = REPLICATED, unsigned id = 0);
     /// Clone a component from another node using its create mode. Return the clone if successful or null on failure.
@@ -0,0 +1,397 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Scene/Component.h"
+#include "../Scene/PackedScene.h"
+#include "../Scene/Scene.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Packed scene format version.
+static const unsigned PACKED_SCENE_VERSION = 1;
+/// Minimum number of objects before the attribute decode is spread over the work queue.
+static const unsigned PACKED_SCENE_MIN_PARALLEL_OBJECTS = 64;
+
+/// Attribute blob of one node or component in a packed scene file.
+struct PackedObjectData
+{
+    /// Object type.
+    StringHash type_;
+    /// Blob offset in the blob arena.
+    unsigned blobOffset_{};
+    /// Blob size in bytes.
+    unsigned blobSize_{};
+    /// Decoded attribute values in the order the loadable attributes are registered.
+    ea::vector<Variant> values_;
+};
+
+/// Shared state of the attribute decode work items.
+struct DecodeAttributesState
+{
+    /// Execution context.
+    Context* context_;
+    /// Blob arena.
+    const unsigned char* arena_;
+};
+
+/// Decode the attribute blobs of a range of packed objects into values.
+static void DecodeAttributesRange(const DecodeAttributesState& state, PackedObjectData* start, PackedObjectData* end)
+{
+    for (PackedObjectData* i = start; i != end; ++i)
+    {
+        const ea::vector<AttributeInfo>* attributes = state.context_->GetAttributes(i->type_);
+        if (!attributes || !i->blobSize_)
+            continue;
+
+        MemoryBuffer buffer(state.arena_ + i->blobOffset_, i->blobSize_);
+        i->values_.reserve(attributes->size());
+        for (unsigned j = 0; j < attributes->size(); ++j)
+        {
+            const AttributeInfo& attr = attributes->at(j);
+            if (!attr.ShouldLoad())
+                continue;
+            i->values_.push_back(buffer.ReadVariant(attr.type_, state.context_));
+        }
+    }
+}
+
+/// Attribute decode work function.
+static void DecodeAttributesWork(const WorkItem* item, unsigned threadIndex)
+{
+    DecodeAttributesRange(*static_cast<DecodeAttributesState*>(item->aux_),
+        static_cast<PackedObjectData*>(item->start_), static_cast<PackedObjectData*>(item->end_));
+}
+
+/// Apply decoded attribute values to a created node or component.
+static void ApplyPackedAttributes(Serializable* serializable, const PackedObjectData& data)
+{
+    const ea::vector<AttributeInfo>* attributes = serializable->GetAttributes();
+    if (!attributes)
+        return;
+
+    unsigned valueIndex = 0;
+    for (unsigned i = 0; i < attributes->size() && valueIndex < data.values_.size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        if (!attr.ShouldLoad())
+            continue;
+        serializable->OnSetAttribute(attr, data.values_[valueIndex++]);
+    }
+}
+
+/// Collect the persistent node hierarchy depth-first.
+static void CollectPersistentNodes(const Node* node, ea::vector<const Node*>& dest)
+{
+    const ea::vector<SharedPtr<Node> >& children = node->GetChildren();
+    for (unsigned i = 0; i < children.size(); ++i)
+    {
+        const Node* child = children[i];
+        if (child->IsTemporary())
+            continue;
+
+        dest.push_back(child);
+        CollectPersistentNodes(child, dest);
+    }
+}
+
+/// Write a serializable's attributes as a size-prefixed blob.
+static bool WriteAttributeBlob(Serializer& dest, const Serializable* serializable)
+{
+    VectorBuffer blob;
+    if (!serializable->Serializable::Save(blob))
+        return false;
+
+    return dest.WriteVLE(blob.GetSize()) && dest.Write(blob.GetData(), blob.GetSize()) == blob.GetSize();
+}
+
+bool PackedScene::Save(Serializer& dest, const Scene* scene)
+{
+    dest.WriteVLE(PACKED_SCENE_VERSION);
+
+    // Flatten the hierarchy depth-first; index 0 is the scene itself
+    ea::vector<const Node*> nodes;
+    nodes.push_back(scene);
+    CollectPersistentNodes(scene, nodes);
+
+    ea::unordered_map<const Node*, unsigned> nodeIndices;
+    for (unsigned i = 0; i < nodes.size(); ++i)
+        nodeIndices[nodes[i]] = i;
+
+    // Gather components into per-type buckets, preserving per-node creation order in the records
+    struct ComponentRecord
+    {
+        unsigned nodeIndex_;
+        unsigned typeIndex_;
+        const Component* component_;
+    };
+
+    ea::vector<ea::string> typeNames;
+    ea::unordered_map<StringHash, unsigned> typeIndices;
+    ea::vector<ComponentRecord> records;
+    ea::vector<ea::vector<const Component*> > componentsByType;
+
+    for (unsigned i = 0; i < nodes.size(); ++i)
+    {
+        const ea::vector<SharedPtr<Component> >& components = nodes[i]->GetComponents();
+        for (unsigned j = 0; j < components.size(); ++j)
+        {
+            const Component* component = components[j];
+            if (component->IsTemporary())
+                continue;
+
+            auto t = typeIndices.find(component->GetType());
+            unsigned typeIndex;
+            if (t != typeIndices.end())
+                typeIndex = t->second;
+            else
+            {
+                typeIndex = typeNames.size();
+                typeIndices[component->GetType()] = typeIndex;
+                typeNames.push_back(component->GetTypeName());
+                componentsByType.push_back();
+            }
+
+            records.push_back(ComponentRecord{i, typeIndex, component});
+            componentsByType[typeIndex].push_back(component);
+        }
+    }
+
+    // Component type string table
+    dest.WriteVLE(typeNames.size());
+    for (unsigned i = 0; i < typeNames.size(); ++i)
+        dest.WriteString(typeNames[i]);
+
+    // Scene attributes
+    if (!WriteAttributeBlob(dest, scene))
+        return false;
+
+    // Node chunk: IDs, parent indices and attribute blobs as flat arrays
+    dest.WriteVLE(nodes.size() - 1);
+    for (unsigned i = 1; i < nodes.size(); ++i)
+    {
+        const Node* node = nodes[i];
+        dest.WriteUInt(node->GetID());
+        dest.WriteVLE(nodeIndices[node->GetParent()]);
+        if (!WriteAttributeBlob(dest, node))
+            return false;
+    }
+
+    // Component records in creation order
+    dest.WriteVLE(records.size());
+    for (unsigned i = 0; i < records.size(); ++i)
+    {
+        dest.WriteVLE(records[i].nodeIndex_);
+        dest.WriteVLE(records[i].typeIndex_);
+        dest.WriteUInt(records[i].component_->GetID());
+    }
+
+    // Component attribute blobs grouped by type
+    for (unsigned i = 0; i < componentsByType.size(); ++i)
+    {
+        const ea::vector<const Component*>& components = componentsByType[i];
+        dest.WriteVLE(components.size());
+        for (unsigned j = 0; j < components.size(); ++j)
+        {
+            if (!WriteAttributeBlob(dest, components[j]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool PackedScene::Load(Deserializer& source, Scene* scene)
+{
+    unsigned version = source.ReadVLE();
+    if (version != PACKED_SCENE_VERSION)
+    {
+        URHO3D_LOGERROR("Unsupported packed scene version " + ea::to_string(version));
+        return false;
+    }
+
+    Context* context = scene->GetContext();
+
+    // Component type string table
+    unsigned numTypes = source.ReadVLE();
+    ea::vector<StringHash> types;
+    types.reserve(numTypes);
+    for (unsigned i = 0; i < numTypes; ++i)
+        types.push_back(StringHash(source.ReadString()));
+
+    // Attribute blobs are bulk-read into a single arena and referenced by offset
+    ea::vector<unsigned char> arena;
+    ea::vector<PackedObjectData> objects;
+
+    auto readObject = [&](StringHash type)
+    {
+        PackedObjectData data;
+        data.type_ = type;
+        data.blobSize_ = source.ReadVLE();
+        data.blobOffset_ = arena.size();
+        arena.resize(arena.size() + data.blobSize_);
+        if (data.blobSize_ && source.Read(&arena[data.blobOffset_], data.blobSize_) != data.blobSize_)
+            return false;
+        objects.push_back(ea::move(data));
+        return true;
+    };
+
+    // Scene attributes
+    if (!readObject(Scene::GetTypeStatic()))
+        return false;
+
+    // Node chunk
+    struct PackedNode
+    {
+        unsigned id_;
+        unsigned parentIndex_;
+        unsigned objectIndex_;
+    };
+
+    unsigned numNodes = source.ReadVLE();
+    ea::vector<PackedNode> packedNodes;
+    packedNodes.reserve(numNodes);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        PackedNode node;
+        node.id_ = source.ReadUInt();
+        node.parentIndex_ = source.ReadVLE();
+        node.objectIndex_ = objects.size();
+        if (node.parentIndex_ > i || !readObject(Node::GetTypeStatic()))
+        {
+            URHO3D_LOGERROR("Malformed node chunk in packed scene file");
+            return false;
+        }
+        packedNodes.push_back(node);
+    }
+
+    // Component records
+    struct PackedComponent
+    {
+        unsigned nodeIndex_;
+        unsigned typeIndex_;
+        unsigned id_;
+        unsigned objectIndex_;
+    };
+
+    unsigned numComponents = source.ReadVLE();
+    ea::vector<PackedComponent> packedComponents;
+    ea::vector<ea::vector<unsigned> > recordsByType(numTypes);
+    packedComponents.reserve(numComponents);
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        PackedComponent component;
+        component.nodeIndex_ = source.ReadVLE();
+        component.typeIndex_ = source.ReadVLE();
+        component.id_ = source.ReadUInt();
+        component.objectIndex_ = M_MAX_UNSIGNED;
+        if (component.nodeIndex_ > numNodes || component.typeIndex_ >= numTypes)
+        {
+            URHO3D_LOGERROR("Malformed component records in packed scene file");
+            return false;
+        }
+        recordsByType[component.typeIndex_].push_back(i);
+        packedComponents.push_back(component);
+    }
+
+    // Component attribute blob chunks grouped by type
+    for (unsigned i = 0; i < numTypes; ++i)
+    {
+        unsigned count = source.ReadVLE();
+        if (count != recordsByType[i].size())
+        {
+            URHO3D_LOGERROR("Malformed component blob chunk in packed scene file");
+            return false;
+        }
+        for (unsigned j = 0; j < count; ++j)
+        {
+            packedComponents[recordsByType[i][j]].objectIndex_ = objects.size();
+            if (!readObject(types[i]))
+                return false;
+        }
+    }
+
+    // Decode the attribute blobs, in parallel over the work queue when worthwhile
+    DecodeAttributesState state{context, arena.empty() ? nullptr : &arena[0]};
+    auto* queue = scene->GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads() && objects.size() >= PACKED_SCENE_MIN_PARALLEL_OBJECTS)
+    {
+        unsigned numWorkItems = queue->GetNumThreads() + 1;
+        unsigned objectsPerItem = Max((unsigned)(objects.size() / numWorkItems), 1u);
+        PackedObjectData* start = &objects[0];
+        PackedObjectData* end = start + objects.size();
+        while (start != end)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = DecodeAttributesWork;
+            item->aux_ = &state;
+            item->start_ = start;
+            item->end_ = (unsigned)(end - start) > objectsPerItem ? start + objectsPerItem : end;
+            start = static_cast<PackedObjectData*>(item->end_);
+            queue->AddWorkItem(item);
+        }
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+        DecodeAttributesRange(state, objects.empty() ? nullptr : &objects[0], objects.empty() ? nullptr : &objects[0] + objects.size());
+
+    // Instantiate the scene graph. Nodes appear in depth-first order, so parents always exist before their children
+    ApplyPackedAttributes(scene, objects[0]);
+
+    ea::vector<Node*> createdNodes;
+    createdNodes.reserve(numNodes + 1);
+    createdNodes.push_back(scene);
+    for (unsigned i = 0; i < packedNodes.size(); ++i)
+    {
+        const PackedNode& packedNode = packedNodes[i];
+        Node* parent = createdNodes[packedNode.parentIndex_];
+        Node* node = parent->CreateChild(EMPTY_STRING, Scene::IsReplicatedID(packedNode.id_) ? REPLICATED : LOCAL, packedNode.id_);
+        ApplyPackedAttributes(node, objects[packedNode.objectIndex_]);
+        createdNodes.push_back(node);
+    }
+
+    for (unsigned i = 0; i < packedComponents.size(); ++i)
+    {
+        const PackedComponent& packedComponent = packedComponents[i];
+        Node* node = createdNodes[packedComponent.nodeIndex_];
+        Component* component = node->CreateComponent(types[packedComponent.typeIndex_],
+            Scene::IsReplicatedID(packedComponent.id_) ? REPLICATED : LOCAL, packedComponent.id_);
+        if (component)
+            ApplyPackedAttributes(component, objects[packedComponent.objectIndex_]);
+        else
+            URHO3D_LOGWARNING("Could not create unknown component type " + types[packedComponent.typeIndex_].ToString());
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+class Scene;
+class Serializer;
+
+/// Chunked binary scene format ("UPSN"). Stores a component type string table, the node hierarchy as flat arrays, and
+/// one attribute blob per object grouped into per-type chunks. The layout allows bulk reads from a file or memory
+/// mapping, and the attribute blobs are decoded into values in parallel on the WorkQueue before the scene graph is
+/// instantiated, avoiding the per-node recursive deserialization of the "USCN" format. Used through
+/// Scene::SavePacked() and Scene::LoadPacked().
+class URHO3D_API PackedScene
+{
+public:
+    /// Save a scene in packed format without the file ID. Return true if successful.
+    static bool Save(Serializer& dest, const Scene* scene);
+    /// Load a scene from packed format, the file ID having been read already. Return true if successful.
+    static bool Load(Deserializer& source, Scene* scene);
+};
+
+}
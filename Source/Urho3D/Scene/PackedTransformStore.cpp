@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../Scene/PackedTransformStore.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+unsigned PackedTransformStore::AddNode(Node* node)
+{
+    if (!node)
+        return INVALID_INDEX;
+
+    const unsigned existingIndex = GetIndex(node);
+    if (existingIndex != INVALID_INDEX)
+        return existingIndex;
+
+    const unsigned index = nodes_.size();
+    nodes_.push_back(WeakPtr<Node>(node));
+    parentIndices_.push_back(GetIndex(node->GetParent()));
+    positions_.push_back(node->GetPosition());
+    rotations_.push_back(node->GetRotation());
+    scales_.push_back(node->GetScale());
+    worldTransforms_.push_back(Matrix3x4::IDENTITY);
+    nodeToIndex_[node] = index;
+    return index;
+}
+
+void PackedTransformStore::AddTree(Node* root)
+{
+    if (!root)
+        return;
+
+    // Breadth-first insertion guarantees parents precede children in the dense arrays
+    ea::vector<Node*> queue;
+    queue.push_back(root);
+    for (unsigned i = 0; i < queue.size(); ++i)
+    {
+        Node* node = queue[i];
+        AddNode(node);
+        for (const SharedPtr<Node>& child : node->GetChildren())
+            queue.push_back(child);
+    }
+}
+
+void PackedTransformStore::Clear()
+{
+    nodes_.clear();
+    parentIndices_.clear();
+    positions_.clear();
+    rotations_.clear();
+    scales_.clear();
+    worldTransforms_.clear();
+    nodeToIndex_.clear();
+}
+
+void PackedTransformStore::Update()
+{
+    URHO3D_PROFILE("UpdatePackedTransforms");
+
+    const unsigned numNodes = nodes_.size();
+
+    // Pull local TRS components in linear passes
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        if (Node* node = nodes_[i])
+        {
+            positions_[i] = node->GetPosition();
+            rotations_[i] = node->GetRotation();
+            scales_[i] = node->GetScale();
+        }
+    }
+
+    // Recompute world matrices in one sweep. Parents always precede children, so each
+    // multiplication reads an already updated parent matrix from the previous array slots
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        const Matrix3x4 localTransform(positions_[i], rotations_[i], scales_[i]);
+        const unsigned parentIndex = parentIndices_[i];
+
+        if (parentIndex != INVALID_INDEX)
+            worldTransforms_[i] = worldTransforms_[parentIndex] * localTransform;
+        else
+        {
+            // Store roots are anchored at their scene parent's world transform
+            Node* node = nodes_[i];
+            Node* parent = node ? node->GetParent() : nullptr;
+            worldTransforms_[i] = parent ? parent->GetWorldTransform() * localTransform : localTransform;
+        }
+    }
+}
+
+}
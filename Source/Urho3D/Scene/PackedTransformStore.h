@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Math/Matrix3x4.h"
+#include "../Scene/Node.h"
+
+namespace Urho3D
+{
+
+/// Opt-in packed transform store for a set of scene nodes, typically a bone hierarchy.
+/// Local TRS components and world matrices are kept in structure-of-arrays storage indexed by
+/// a dense id, with parents guaranteed to precede children, so all dirty world transforms can be
+/// recomputed in one cache-friendly linear sweep through the SSE Matrix3x4 path instead of
+/// pointer-chasing through Node::GetWorldTransform() per node.
+class URHO3D_API PackedTransformStore
+{
+public:
+    /// Invalid dense index.
+    static const unsigned INVALID_INDEX = M_MAX_UNSIGNED;
+
+    /// Add a node. Its parent must have been added before it, or the node is treated as a store root
+    /// anchored at its parent's world transform. Return the dense index.
+    unsigned AddNode(Node* node);
+    /// Add a node and all of its children in breadth-first order.
+    void AddTree(Node* root);
+    /// Remove all nodes.
+    void Clear();
+    /// Pull local transforms from the nodes and recompute all world matrices in one sweep.
+    void Update();
+
+    /// Return the dense index of a node, or INVALID_INDEX if not in the store.
+    unsigned GetIndex(Node* node) const
+    {
+        auto it = nodeToIndex_.find(node);
+        return it != nodeToIndex_.end() ? it->second : INVALID_INDEX;
+    }
+
+    /// Return world transform by dense index. Valid after Update().
+    const Matrix3x4& GetWorldTransform(unsigned index) const { return worldTransforms_[index]; }
+    /// Return number of nodes in the store.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+
+private:
+    /// Nodes by dense index.
+    ea::vector<WeakPtr<Node> > nodes_;
+    /// Parent dense indices, or INVALID_INDEX for store roots.
+    ea::vector<unsigned> parentIndices_;
+    /// Local positions.
+    ea::vector<Vector3> positions_;
+    /// Local rotations.
+    ea::vector<Quaternion> rotations_;
+    /// Local scales.
+    ea::vector<Vector3> scales_;
+    /// World transforms.
+    ea::vector<Matrix3x4> worldTransforms_;
+    /// Mapping from node to dense index.
+    ea::unordered_map<Node*, unsigned> nodeToIndex_;
+};
+
+}
@@ -36,12 +36,16 @@
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
 #include "../Scene/CameraViewport.h"
+#include "../Scene/CompiledPrefab.h"
 #include "../Scene/Component.h"
+#include "../Scene/LogicComponent.h"
 #include "../Scene/ObjectAnimation.h"
+#include "../Scene/PackedScene.h"
 #include "../Scene/ReplicationState.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SceneManager.h"
+#include "../Scene/SceneStreamer.h"
 #include "../Scene/SmoothedTransform.h"
 #include "../Scene/SplinePath.h"
 #include "../Scene/UnknownComponent.h"
@@ -72,6 +76,8 @@ Scene::Scene(Context* context) :
     smoothingConstant_(DEFAULT_SMOOTHING_CONSTANT),
     snapThreshold_(DEFAULT_SNAP_THRESHOLD),
     updateEnabled_(true),
+    managedUpdate_(false),
+    parallelUpdatesDone_(false),
     asyncLoading_(false),
     threadedUpdate_(false),
     lightmaps_(Texture2D::GetTypeStatic())
@@ -92,10 +98,8 @@ Scene::~Scene()
     RemoveAllChildren();
 
     // Remove scene reference and owner from all nodes that still exist
-    for (auto i = replicatedNodes_.begin(); i != replicatedNodes_.end(); ++i)
-        i->second->ResetScene();
-    for (auto i = localNodes_.begin(); i != localNodes_.end(); ++i)
-        i->second->ResetScene();
+    replicatedNodes_.ForEach([](unsigned, Node* node) { node->ResetScene(); });
+    localNodes_.ForEach([](unsigned, Node* node) { node->ResetScene(); });
 }
 
 void Scene::RegisterObject(Context* context)
@@ -247,9 +251,7 @@ void Scene::AddReplicationState(NodeReplicationState* state)
     Node::AddReplicationState(state);
 
     // This is the first update for a new connection. Mark all replicated nodes dirty
-    for (auto i = replicatedNodes_.begin(); i !=
-        replicatedNodes_.end(); ++i)
-        state->sceneState_->dirtyNodes_.insert(i->first);
+    replicatedNodes_.ForEach([state](unsigned id, Node*) { state->sceneState_->dirtyNodes_.insert(id); });
 }
 
 void Scene::ResetLightmaps()
@@ -373,6 +375,56 @@ bool Scene::SaveJSON(Serializer& dest, const ea::string& indentation) const
         return false;
 }
 
+bool Scene::LoadPacked(Deserializer& source)
+{
+    URHO3D_PROFILE("LoadScenePacked");
+
+    StopAsyncLoading();
+
+    // Check ID
+    if (source.ReadFileID() != "UPSN")
+    {
+        URHO3D_LOGERROR(source.GetName() + " is not a valid packed scene file");
+        return false;
+    }
+
+    URHO3D_LOGINFO("Loading scene from " + source.GetName());
+
+    Clear();
+
+    if (PackedScene::Load(source, this))
+    {
+        FinishLoading(&source);
+        return true;
+    }
+    else
+        return false;
+}
+
+bool Scene::SavePacked(Serializer& dest) const
+{
+    URHO3D_PROFILE("SaveScenePacked");
+
+    // Write ID first
+    if (!dest.WriteFileID("UPSN"))
+    {
+        URHO3D_LOGERROR("Could not save scene, writing to stream failed");
+        return false;
+    }
+
+    auto* ptr = dynamic_cast<Deserializer*>(&dest);
+    if (ptr)
+        URHO3D_LOGINFO("Saving scene to " + ptr->GetName());
+
+    if (PackedScene::Save(dest, this))
+    {
+        FinishSaving(&dest);
+        return true;
+    }
+    else
+        return false;
+}
+
 bool Scene::LoadAsync(File* file, LoadMode mode)
 {
     if (!file)
@@ -679,6 +731,36 @@ Node* Scene::InstantiateJSON(Deserializer& source, const Vector3& position, cons
     return InstantiateJSON(json->GetRoot(), position, rotation, mode);
 }
 
+Node* Scene::InstantiateXMLCached(XMLFile* file, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    CompiledPrefab* prefab = GetCompiledPrefab(file);
+    return prefab ? prefab->Instantiate(this, position, rotation, mode) : nullptr;
+}
+
+CompiledPrefab* Scene::GetCompiledPrefab(XMLFile* file)
+{
+    if (!file)
+        return nullptr;
+
+    auto it = compiledPrefabs_.find(file);
+    if (it == compiledPrefabs_.end())
+    {
+        SharedPtr<CompiledPrefab> prefab(new CompiledPrefab(context_));
+        if (!prefab->Compile(file->GetRoot()))
+            return nullptr;
+
+        it = compiledPrefabs_.insert(ea::make_pair(file, ea::make_pair(SharedPtr<XMLFile>(file), prefab))).first;
+
+        // Discard the compiled program if the prefab file is reloaded, so the next spawn recompiles it
+        SubscribeToEvent(file, E_RELOADFINISHED, [this, file](StringHash, VariantMap&)
+        {
+            compiledPrefabs_.erase(file);
+        });
+    }
+
+    return it->second.second;
+}
+
 void Scene::Clear(bool clearReplicated, bool clearLocal)
 {
     StopAsyncLoading();
@@ -772,23 +854,14 @@ void Scene::UnregisterAllVars()
 
 bool Scene::IsEmpty(bool ignoreComponents) const
 {
-    const bool noNodesExceptSelf = replicatedNodes_.size() == 1 && localNodes_.size() == 0;
-    const bool noComponents = replicatedComponents_.size() == 0 && localComponents_.size() == 0;
+    const bool noNodesExceptSelf = replicatedNodes_.Size() == 1 && localNodes_.Size() == 0;
+    const bool noComponents = replicatedComponents_.Size() == 0 && localComponents_.Size() == 0;
     return noNodesExceptSelf && (noComponents || ignoreComponents);
 }
 
 Node* Scene::GetNode(unsigned id) const
 {
-    if (IsReplicatedID(id))
-    {
-        auto i = replicatedNodes_.find(id);
-        return i != replicatedNodes_.end() ? i->second : nullptr;
-    }
-    else
-    {
-        auto i = localNodes_.find(id);
-        return i != localNodes_.end() ? i->second : nullptr;
-    }
+    return IsReplicatedID(id) ? replicatedNodes_.Get(id) : localNodes_.Get(id);
 }
 
 bool Scene::GetNodesWithTag(ea::vector<Node*>& dest, const ea::string& tag) const
@@ -808,13 +881,11 @@ Component* Scene::GetComponent(unsigned id) const
 {
     if (IsReplicatedID(id))
     {
-        auto i = replicatedComponents_.find(id);
-        return i != replicatedComponents_.end() ? i->second : nullptr;
+        return replicatedComponents_.Get(id);
     }
     else
     {
-        auto i = localComponents_.find(id);
-        return i != localComponents_.end() ? i->second : nullptr;
+        return localComponents_.Get(id);
     }
 }
 
@@ -854,11 +925,17 @@ void Scene::Update(float timeStep)
     // Update variable timestep logic
     SendEvent(E_SCENEUPDATE, eventData);
 
+    // Update logic components that declare a thread-safe update in parallel, then let them commit results serially
+    UpdateParallelComponents(timeStep);
+
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
-    // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
-    SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
+    // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates.
+    // Direct subscribers are invoked first, they bypass the event plumbing
+    onSubsystemUpdate_(this, timeStep);
+    if (HasEventReceivers(E_SCENESUBSYSTEMUPDATE))
+        SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
 
     // Update transform smoothing
     {
@@ -914,68 +991,95 @@ void Scene::DelayedMarkedDirty(Component* component)
     delayedDirtyComponents_.push_back(component);
 }
 
-unsigned Scene::GetFreeNodeID(CreateMode mode)
+void Scene::AddParallelUpdate(LogicComponent* component)
 {
-    if (mode == REPLICATED)
-    {
-        for (;;)
-        {
-            unsigned ret = replicatedNodeID_;
-            if (replicatedNodeID_ < LAST_REPLICATED_ID)
-                ++replicatedNodeID_;
-            else
-                replicatedNodeID_ = FIRST_REPLICATED_ID;
-
-            if (!replicatedNodes_.contains(ret))
-                return ret;
-        }
-    }
-    else
+    parallelUpdateComponents_.push_back(component);
+}
+
+void Scene::RemoveParallelUpdate(LogicComponent* component)
+{
+    parallelUpdateComponents_.erase_first(component);
+}
+
+void Scene::QueueParallelUpdates(float timeStep)
+{
+    if (parallelUpdateComponents_.empty())
+        return;
+
+    // Take a snapshot so that the commit phase may add or remove components freely
+    parallelUpdateSnapshot_.assign(parallelUpdateComponents_.begin(), parallelUpdateComponents_.end());
+
+    // Perform updates in worker threads. Components must not modify the scene from the threaded update
+    auto* queue = GetSubsystem<WorkQueue>();
+    BeginThreadedUpdate();
+
+    const int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
+    const int componentsPerItem = Max((int)(parallelUpdateSnapshot_.size() / numWorkItems), 1);
+
+    auto start = parallelUpdateSnapshot_.begin();
+    for (int i = 0; i < numWorkItems && start != parallelUpdateSnapshot_.end(); ++i)
     {
-        for (;;)
+        auto end = parallelUpdateSnapshot_.end();
+        if (i < numWorkItems - 1 && end - start > componentsPerItem)
+            end = start + componentsPerItem;
+
+        queue->AddWorkItem([start, end, timeStep]()
         {
-            unsigned ret = localNodeID_;
-            if (localNodeID_ < LAST_LOCAL_ID)
-                ++localNodeID_;
-            else
-                localNodeID_ = FIRST_LOCAL_ID;
-
-            if (!localNodes_.contains(ret))
-                return ret;
-        }
+            for (auto i = start; i != end; ++i)
+                (*i)->Update(timeStep);
+        }, M_MAX_UNSIGNED);
+
+        start = end;
     }
 }
 
-unsigned Scene::GetFreeComponentID(CreateMode mode)
+void Scene::CompleteParallelUpdates(float timeStep)
 {
-    if (mode == REPLICATED)
+    if (parallelUpdateSnapshot_.empty())
+        return;
+
+    EndThreadedUpdate();
+
+    // Commit results serially on the main thread
+    for (const WeakPtr<LogicComponent>& component : parallelUpdateSnapshot_)
     {
-        for (;;)
-        {
-            unsigned ret = replicatedComponentID_;
-            if (replicatedComponentID_ < LAST_REPLICATED_ID)
-                ++replicatedComponentID_;
-            else
-                replicatedComponentID_ = FIRST_REPLICATED_ID;
-
-            if (!replicatedComponents_.contains(ret))
-                return ret;
-        }
+        if (component)
+            component->CommitUpdate(timeStep);
     }
-    else
+    parallelUpdateSnapshot_.clear();
+    parallelUpdatesDone_ = true;
+}
+
+void Scene::UpdateParallelComponents(float timeStep)
+{
+    // Already performed externally as part of a combined multi-scene pass
+    if (parallelUpdatesDone_)
     {
-        for (;;)
-        {
-            unsigned ret = localComponentID_;
-            if (localComponentID_ < LAST_LOCAL_ID)
-                ++localComponentID_;
-            else
-                localComponentID_ = FIRST_LOCAL_ID;
-
-            if (!localComponents_.contains(ret))
-                return ret;
-        }
+        parallelUpdatesDone_ = false;
+        return;
     }
+
+    if (parallelUpdateComponents_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateParallelComponents");
+
+    QueueParallelUpdates(timeStep);
+    GetSubsystem<WorkQueue>()->Complete(M_MAX_UNSIGNED);
+    CompleteParallelUpdates(timeStep);
+
+    // The phase ran inline, not externally; do not skip it on the next frame
+    parallelUpdatesDone_ = false;
+}
+
+unsigned Scene::GetFreeNodeID(CreateMode mode)
+{
+    return mode == REPLICATED ? replicatedNodes_.Allocate() : localNodes_.Allocate();
+}
+
+unsigned Scene::GetFreeComponentID(CreateMode mode)
+{
+    return mode == REPLICATED ? replicatedComponents_.Allocate() : localComponents_.Allocate();
 }
 
 void Scene::NodeAdded(Node* node)
@@ -1001,27 +1105,27 @@ void Scene::NodeAdded(Node* node)
     // If node with same ID exists, remove the scene reference from it and overwrite with the new node
     if (IsReplicatedID(id))
     {
-        auto i = replicatedNodes_.find(id);
-        if (i != replicatedNodes_.end() && i->second != node)
+        Node* existing = replicatedNodes_.Get(id);
+        if (existing && existing != node)
         {
             URHO3D_LOGWARNING("Overwriting node with ID " + ea::to_string(id));
-            NodeRemoved(i->second);
+            NodeRemoved(existing);
         }
 
-        replicatedNodes_[id] = node;
+        replicatedNodes_.Insert(id, node);
 
         MarkNetworkUpdate(node);
         MarkReplicationDirty(node);
     }
     else
     {
-        auto i = localNodes_.find(id);
-        if (i != localNodes_.end() && i->second != node)
+        Node* existing = localNodes_.Get(id);
+        if (existing && existing != node)
         {
             URHO3D_LOGWARNING("Overwriting node with ID " + ea::to_string(id));
-            NodeRemoved(i->second);
+            NodeRemoved(existing);
         }
-        localNodes_[id] = node;
+        localNodes_.Insert(id, node);
     }
 
     // Cache tag if already tagged.
@@ -1059,11 +1163,11 @@ void Scene::NodeRemoved(Node* node)
     unsigned id = node->GetID();
     if (Scene::IsReplicatedID(id))
     {
-        replicatedNodes_.erase(id);
+        replicatedNodes_.Erase(id);
         MarkReplicationDirty(node);
     }
     else
-        localNodes_.erase(id);
+        localNodes_.Erase(id);
 
     node->ResetScene();
 
@@ -1100,25 +1204,25 @@ void Scene::ComponentAdded(Component* component)
 
     if (IsReplicatedID(id))
     {
-        auto i = replicatedComponents_.find(id);
-        if (i != replicatedComponents_.end() && i->second != component)
+        Component* existing = replicatedComponents_.Get(id);
+        if (existing && existing != component)
         {
             URHO3D_LOGWARNING("Overwriting component with ID " + ea::to_string(id));
-            ComponentRemoved(i->second);
+            ComponentRemoved(existing);
         }
 
-        replicatedComponents_[id] = component;
+        replicatedComponents_.Insert(id, component);
     }
     else
     {
-        auto i = localComponents_.find(id);
-        if (i != localComponents_.end() && i->second != component)
+        Component* existing = localComponents_.Get(id);
+        if (existing && existing != component)
         {
             URHO3D_LOGWARNING("Overwriting component with ID " + ea::to_string(id));
-            ComponentRemoved(i->second);
+            ComponentRemoved(existing);
         }
 
-        localComponents_[id] = component;
+        localComponents_.Insert(id, component);
     }
 
     component->OnSceneSet(this);
@@ -1137,9 +1241,9 @@ void Scene::ComponentRemoved(Component* component)
 
     unsigned id = component->GetID();
     if (Scene::IsReplicatedID(id))
-        replicatedComponents_.erase(id);
+        replicatedComponents_.Erase(id);
     else
-        localComponents_.erase(id);
+        localComponents_.Erase(id);
 
     component->SetID(0);
     component->OnSceneSet(nullptr);
@@ -1193,12 +1297,8 @@ void Scene::CleanupConnection(Connection* connection)
 {
     Node::CleanupConnection(connection);
 
-    for (auto i = replicatedNodes_.begin(); i != replicatedNodes_.end(); ++i)
-        i->second->CleanupConnection(connection);
-
-    for (auto i = replicatedComponents_.begin(); i !=
-        replicatedComponents_.end(); ++i)
-        i->second->CleanupConnection(connection);
+    replicatedNodes_.ForEach([connection](unsigned, Node* node) { node->CleanupConnection(connection); });
+    replicatedComponents_.ForEach([connection](unsigned, Component* component) { component->CleanupConnection(connection); });
 }
 
 void Scene::MarkNetworkUpdate(Node* node)
@@ -1244,7 +1344,8 @@ void Scene::MarkReplicationDirty(Node* node)
 
 void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
 {
-    if (!updateEnabled_)
+    // In managed mode the update is driven externally, e.g. by SceneManager
+    if (!updateEnabled_ || managedUpdate_)
         return;
 
     using namespace Update;
@@ -1631,6 +1732,7 @@ void RegisterSceneLibrary(Context* context)
     SmoothedTransform::RegisterObject(context);
     UnknownComponent::RegisterObject(context);
     SplinePath::RegisterObject(context);
+    SceneStreamer::RegisterObject(context);
     SceneManager::RegisterObject(context);
     CameraViewport::RegisterObject(context);
 }
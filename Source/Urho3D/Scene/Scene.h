@@ -28,15 +28,19 @@
 #include <EASTL/unique_ptr.h>
 
 #include "../Core/Mutex.h"
+#include "../Core/Signal.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONFile.h"
+#include "../Scene/IdRegistry.h"
 #include "../Scene/Node.h"
 #include "../Scene/SceneResolver.h"
 
 namespace Urho3D
 {
 
+class CompiledPrefab;
 class File;
+class LogicComponent;
 class PackageFile;
 class Texture2D;
 
@@ -148,6 +152,10 @@ public:
     bool SaveXML(Serializer& dest, const ea::string& indentation = "\t") const;
     /// Save to a JSON file. Return true if successful.
     bool SaveJSON(Serializer& dest, const ea::string& indentation = "\t") const;
+    /// Load from a packed binary scene file ("UPSN"). Removes all existing child nodes and components first. Return true if successful.
+    bool LoadPacked(Deserializer& source);
+    /// Save to a packed binary scene file. Return true if successful.
+    bool SavePacked(Serializer& dest) const;
     /// Load from a binary file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
     bool LoadAsync(File* file, LoadMode mode = LOAD_SCENE_AND_RESOURCES);
     /// Load from an XML file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
@@ -168,6 +176,13 @@ public:
         (const JSONValue& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from JSON data. Return root node if successful.
     Node* InstantiateJSON(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate object prefab content from an XML file using a compiled creation program cached per file. The first
+    /// call compiles the program; subsequent spawns replay it with plain Variant copies instead of re-parsing XML and
+    /// resolving attribute names. The cached program is discarded when the file is reloaded. Return root node if successful.
+    Node* InstantiateXMLCached(XMLFile* file, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Return the cached compiled prefab for an XML file, compiling it first if necessary. Can be used to configure
+    /// the prefab, e.g. enable shared default values, before spawning instances. Return null if compilation fails.
+    CompiledPrefab* GetCompiledPrefab(XMLFile* file);
 
     /// Clear scene completely of either replicated, local or all nodes and components.
     void Clear(bool clearReplicated = true, bool clearLocal = true);
@@ -247,12 +262,33 @@ public:
 
     /// Update scene. Called by HandleUpdate.
     void Update(float timeStep);
+
+    /// Sent during scene update, before the scene subsystem update event. Direct subscribers (e.g. physics worlds) bypass the event plumbing.
+    Signal<float, Scene> onSubsystemUpdate_;
+
     /// Begin a threaded update. During threaded update components can choose to delay dirty processing.
     void BeginThreadedUpdate();
     /// End a threaded update. Notify components that marked themselves for delayed dirty processing.
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Register a logic component for the parallel update phase. Called by LogicComponent.
+    void AddParallelUpdate(LogicComponent* component);
+    /// Unregister a logic component from the parallel update phase. Called by LogicComponent.
+    void RemoveParallelUpdate(LogicComponent* component);
+    /// Queue the parallel component updates of this scene into the work queue without waiting for completion.
+    /// Used by SceneManager to combine the parallel phase of several scenes into one pass. Expects a timestep
+    /// already scaled by the scene time scale.
+    void QueueParallelUpdates(float timeStep);
+    /// Commit queued parallel component updates after the work queue has been completed, and mark the phase done
+    /// so that the following Update() call does not repeat it.
+    void CompleteParallelUpdates(float timeStep);
+    /// Set whether scene update is driven externally (e.g. by SceneManager). When enabled, the scene ignores the
+    /// global update event and expects Update() to be called manually.
+    void SetManagedUpdate(bool enable) { managedUpdate_ = enable; }
+
+    /// Return whether scene update is driven externally.
+    bool GetManagedUpdate() const { return managedUpdate_; }
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
@@ -295,6 +331,8 @@ public:
 private:
     /// Handle the logic update event to update the scene, if active.
     void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    /// Update registered logic components in parallel, then let them commit results serially.
+    void UpdateParallelComponents(float timeStep);
     /// Handle a background loaded resource completing.
     void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
     /// Update asynchronous loading.
@@ -322,15 +360,17 @@ private:
     ea::vector<SceneComponentIndex> componentIndexes_;
 
     /// Replicated scene nodes by ID.
-    ea::unordered_map<unsigned, Node*> replicatedNodes_;
+    IdRegistry<Node> replicatedNodes_{FIRST_REPLICATED_ID, LAST_REPLICATED_ID};
     /// Local scene nodes by ID.
-    ea::unordered_map<unsigned, Node*> localNodes_;
+    IdRegistry<Node> localNodes_{FIRST_LOCAL_ID, LAST_LOCAL_ID};
     /// Replicated components by ID.
-    ea::unordered_map<unsigned, Component*> replicatedComponents_;
+    IdRegistry<Component> replicatedComponents_{FIRST_REPLICATED_ID, LAST_REPLICATED_ID};
     /// Local components by ID.
-    ea::unordered_map<unsigned, Component*> localComponents_;
+    IdRegistry<Component> localComponents_{FIRST_LOCAL_ID, LAST_LOCAL_ID};
     /// Cached tagged nodes by tag.
     ea::unordered_map<StringHash, ea::vector<Node*> > taggedNodes_;
+    /// Compiled prefabs by source file for InstantiateXMLCached(). The file reference keeps the source alive.
+    ea::unordered_map<XMLFile*, ea::pair<SharedPtr<XMLFile>, SharedPtr<CompiledPrefab> > > compiledPrefabs_;
     /// Asynchronous loading progress.
     AsyncProgress asyncProgress_;
     /// Node and component ID resolver for asynchronous loading.
@@ -347,17 +387,21 @@ private:
     ea::hash_set<unsigned> networkUpdateComponents_;
     /// Delayed dirty notification queue for components.
     ea::vector<Component*> delayedDirtyComponents_;
+    /// Logic components registered for the parallel update phase.
+    ea::vector<LogicComponent*> parallelUpdateComponents_;
+    /// Snapshot of parallel update components for the current frame. Weak pointers because the commit phase may remove components.
+    ea::vector<WeakPtr<LogicComponent>> parallelUpdateSnapshot_;
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
-    /// Next free non-local node ID.
+    /// Next free non-local node ID. Legacy, kept for scene file compatibility; IDs are allocated by the registries.
     unsigned replicatedNodeID_;
-    /// Next free non-local component ID.
+    /// Next free non-local component ID. Legacy, kept for scene file compatibility.
     unsigned replicatedComponentID_;
-    /// Next free local node ID.
+    /// Next free local node ID. Legacy, kept for scene file compatibility.
     unsigned localNodeID_;
-    /// Next free local component ID.
+    /// Next free local component ID. Legacy, kept for scene file compatibility.
     unsigned localComponentID_;
     /// Scene source file checksum.
     mutable unsigned checksum_;
@@ -373,6 +417,10 @@ private:
     float snapThreshold_;
     /// Update enabled flag.
     bool updateEnabled_;
+    /// Externally driven update flag.
+    bool managedUpdate_;
+    /// Parallel component updates already performed externally for the current frame.
+    bool parallelUpdatesDone_;
     /// Asynchronous loading flag.
     bool asyncLoading_;
     /// Threaded update flag.
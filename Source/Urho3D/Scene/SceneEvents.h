@@ -110,6 +110,21 @@ URHO3D_EVENT(E_ASYNCLOADFINISHED, AsyncLoadFinished)
     URHO3D_PARAM(P_SCENE, Scene);                  // Scene pointer
 }
 
+/// A streaming sector finished instantiating.
+URHO3D_EVENT(E_SECTORLOADED, SectorLoaded)
+{
+    URHO3D_PARAM(P_STREAMER, Streamer);            // SceneStreamer pointer
+    URHO3D_PARAM(P_INDEX, Index);                  // unsigned
+    URHO3D_PARAM(P_ROOT, Root);                    // Node pointer
+}
+
+/// A streaming sector was unloaded.
+URHO3D_EVENT(E_SECTORUNLOADED, SectorUnloaded)
+{
+    URHO3D_PARAM(P_STREAMER, Streamer);            // SceneStreamer pointer
+    URHO3D_PARAM(P_INDEX, Index);                  // unsigned
+}
+
 /// A child node has been added to a parent node.
 URHO3D_EVENT(E_NODEADDED, NodeAdded)
 {
@@ -21,6 +21,8 @@
 //
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
@@ -56,6 +58,7 @@ Scene* SceneManager::CreateScene(const ea::string& name)
     scene->SetName(name);
     scene->CreateComponentIndex<CameraViewport>();
     scene->GetOrCreateComponent<Octree>();
+    scene->SetManagedUpdate(managedUpdates_);
     scenes_.push_back(scene);
     return scene;
 }
@@ -85,6 +88,7 @@ void SceneManager::UnloadScene(Scene* scene)
     if (activeScene_ == scene)
         SetActiveScene(nullptr);
 
+    scene->SetManagedUpdate(false);
     scenes_.erase_first(SharedPtr<Scene>(scene));
 }
 
@@ -135,6 +139,57 @@ void SceneManager::SetActiveScene(const ea::string& name)
     SetActiveScene(GetScene(name));
 }
 
+void SceneManager::SetManagedUpdates(bool enable)
+{
+    if (managedUpdates_ == enable)
+        return;
+
+    managedUpdates_ = enable;
+    if (enable)
+        SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(SceneManager, HandleUpdate));
+    else
+        UnsubscribeFromEvent(E_UPDATE);
+
+    for (auto& scene : scenes_)
+        scene->SetManagedUpdate(enable);
+}
+
+void SceneManager::UpdateScenes(float timeStep)
+{
+    URHO3D_PROFILE("UpdateScenes");
+
+    // Take a copy so that scene update logic may create or unload scenes freely
+    auto scenesCopy = scenes_;
+
+    // Queue the thread-safe parallel component phase of every scene into one combined work queue pass and
+    // complete it, then run the serial, event-driven remainder of each scene's update. Asynchronously loading
+    // scenes are left to run the phase themselves, as their update may be skipped entirely
+    auto* queue = GetSubsystem<WorkQueue>();
+    for (auto& scene : scenesCopy)
+    {
+        if (scene->IsUpdateEnabled() && !scene->IsAsyncLoading())
+            scene->QueueParallelUpdates(timeStep * scene->GetTimeScale());
+    }
+    queue->Complete(M_MAX_UNSIGNED);
+    for (auto& scene : scenesCopy)
+    {
+        if (scene->IsUpdateEnabled() && !scene->IsAsyncLoading())
+            scene->CompleteParallelUpdates(timeStep * scene->GetTimeScale());
+    }
+
+    for (auto& scene : scenesCopy)
+    {
+        if (scene->IsUpdateEnabled())
+            scene->Update(timeStep);
+    }
+}
+
+void SceneManager::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace Update;
+    UpdateScenes(eventData[P_TIMESTEP].GetFloat());
+}
+
 void SceneManager::SetRenderSurface(RenderSurface* surface)
 {
     renderSurface_ = surface;
@@ -63,10 +63,20 @@ class URHO3D_API SceneManager : public Object
     Scene* GetActiveScene() const { return activeScene_; }
     /// Set surface to which active scene should render. If surface is null then scene will render to main window.
     void SetRenderSurface(RenderSurface* surface);
+    /// Set whether this manager drives the update of its scenes. When enabled, the parallel component phase of
+    /// all update-enabled scenes runs as one combined work queue pass, keeping worker threads saturated across
+    /// scenes instead of fork-joining each scene separately. Intended for servers hosting several scene instances.
+    void SetManagedUpdates(bool enable);
+    /// Return whether this manager drives the update of its scenes.
+    bool GetManagedUpdates() const { return managedUpdates_; }
+    /// Update all update-enabled scenes. Called automatically on the update event when managed updates are enabled.
+    void UpdateScenes(float timeStep);
 
 protected:
     /// Creates and sets up viewports for scene rendering.
     void UpdateViewports();
+    /// Handle the update event when managed updates are enabled.
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
 
     /// Current loaded scenes.
     ea::vector<SharedPtr<Scene>> scenes_;
@@ -74,6 +84,8 @@ protected:
     WeakPtr<Scene> activeScene_;
     /// Surface for rendering active scene into.
     WeakPtr<RenderSurface> renderSurface_;
+    /// Whether this manager drives the update of its scenes.
+    bool managedUpdates_ = false;
 };
 
 }
@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+#include "../Scene/SceneStreamer.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* SUBSYSTEM_CATEGORY;
+
+/// Default distance within which sectors are loaded.
+static const float DEFAULT_LOAD_DISTANCE = 250.0f;
+/// Default distance beyond which loaded sectors are unloaded.
+static const float DEFAULT_UNLOAD_DISTANCE = 300.0f;
+/// Default maximum milliseconds per frame to spend instantiating sector contents.
+static const int DEFAULT_INSTANTIATION_MS = 2;
+
+SceneStreamer::SceneStreamer(Context* context) :
+    Component(context),
+    loadDistance_(DEFAULT_LOAD_DISTANCE),
+    unloadDistance_(DEFAULT_UNLOAD_DISTANCE),
+    instantiationMs_(DEFAULT_INSTANTIATION_MS)
+{
+}
+
+SceneStreamer::~SceneStreamer() = default;
+
+void SceneStreamer::RegisterObject(Context* context)
+{
+    context->RegisterFactory<SceneStreamer>(SUBSYSTEM_CATEGORY);
+
+    URHO3D_ATTRIBUTE("Load Distance", float, loadDistance_, DEFAULT_LOAD_DISTANCE, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Unload Distance", float, unloadDistance_, DEFAULT_UNLOAD_DISTANCE, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Instantiation Ms", int, instantiationMs_, DEFAULT_INSTANTIATION_MS, AM_DEFAULT);
+}
+
+unsigned SceneStreamer::AddSector(const ea::string& sceneName, const BoundingBox& bounds)
+{
+    StreamingSector sector;
+    sector.sceneName_ = sceneName;
+    sector.bounds_ = bounds;
+    sectors_.push_back(ea::move(sector));
+    return sectors_.size() - 1;
+}
+
+void SceneStreamer::ClearSectors()
+{
+    CancelInstantiation();
+    for (unsigned i = 0; i < sectors_.size(); ++i)
+    {
+        if (sectors_[i].root_)
+            UnloadSector(i);
+    }
+    sectors_.clear();
+}
+
+void SceneStreamer::AddObserver(Node* observer)
+{
+    WeakPtr<Node> observerWeak(observer);
+    if (observer && !observers_.contains(observerWeak))
+        observers_.push_back(observerWeak);
+}
+
+void SceneStreamer::RemoveObserver(Node* observer)
+{
+    observers_.erase_first(WeakPtr<Node>(observer));
+}
+
+void SceneStreamer::SetLoadDistance(float distance)
+{
+    loadDistance_ = Max(distance, 0.0f);
+    unloadDistance_ = Max(unloadDistance_, loadDistance_);
+}
+
+void SceneStreamer::SetUnloadDistance(float distance)
+{
+    unloadDistance_ = Max(distance, loadDistance_);
+}
+
+void SceneStreamer::SetInstantiationMs(int ms)
+{
+    instantiationMs_ = Max(ms, 1);
+}
+
+bool SceneStreamer::IsSectorLoaded(unsigned index) const
+{
+    return index < sectors_.size() && sectors_[index].root_ != nullptr;
+}
+
+Node* SceneStreamer::GetSectorRoot(unsigned index) const
+{
+    return index < sectors_.size() ? sectors_[index].root_.Get() : nullptr;
+}
+
+void SceneStreamer::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(SceneStreamer, HandleSceneUpdate));
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+        CancelInstantiation();
+    }
+}
+
+void SceneStreamer::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    URHO3D_PROFILE("UpdateSceneStreaming");
+
+    // Gather live observer positions. Without observers the loaded state is left as is
+    ea::vector<Vector3> observerPositions;
+    for (const WeakPtr<Node>& observer : observers_)
+    {
+        if (observer)
+            observerPositions.push_back(observer->GetWorldPosition());
+    }
+    if (observerPositions.empty())
+        return;
+
+    auto* cache = GetSubsystem<ResourceCache>();
+
+    // Candidate sectors to load, with distance to the closest observer for prioritization
+    ea::vector<ea::pair<float, unsigned>> loadCandidates;
+
+    for (unsigned i = 0; i < sectors_.size(); ++i)
+    {
+        StreamingSector& sector = sectors_[i];
+
+        float distance = M_INFINITY;
+        for (const Vector3& position : observerPositions)
+            distance = Min(distance, sector.bounds_.DistanceToPoint(position));
+
+        if (sector.root_)
+        {
+            if (distance > unloadDistance_)
+                UnloadSector(i);
+        }
+        else if (i == instantiatingSector_)
+        {
+            // Observers retreated while the sector was still instantiating: throw away the partial contents
+            if (distance > unloadDistance_)
+                CancelInstantiation();
+        }
+        else if (distance <= loadDistance_)
+            loadCandidates.push_back(ea::make_pair(distance, i));
+    }
+
+    // Request background loads of the sector files closest-first, so that the I/O layer reads and parses
+    // them in the order they will be needed
+    ea::quick_sort(loadCandidates.begin(), loadCandidates.end());
+    for (const auto& candidate : loadCandidates)
+    {
+        StreamingSector& sector = sectors_[candidate.second];
+        if (!sector.loadQueued_)
+        {
+            cache->BackgroundLoadResource<XMLFile>(sector.sceneName_, true, nullptr, (int)-candidate.first);
+            sector.loadQueued_ = true;
+        }
+    }
+
+    // Instantiate one sector at a time so that a single time-slicing budget applies
+    if (instantiatingSector_ == M_MAX_UNSIGNED)
+    {
+        for (const auto& candidate : loadCandidates)
+        {
+            StreamingSector& sector = sectors_[candidate.second];
+            if (XMLFile* file = cache->GetExistingResource<XMLFile>(sector.sceneName_))
+            {
+                BeginInstantiation(candidate.second, file);
+                break;
+            }
+        }
+    }
+
+    if (instantiatingSector_ != M_MAX_UNSIGNED)
+        UpdateInstantiation();
+}
+
+void SceneStreamer::BeginInstantiation(unsigned index, XMLFile* file)
+{
+    const StreamingSector& sector = sectors_[index];
+    XMLElement rootElem = file->GetRoot();
+
+    if (rootElem.GetName() == "scene")
+        instantiationElement_ = rootElem.GetChild("node");
+    else if (rootElem.GetName() == "node")
+        instantiationElement_ = rootElem;
+    else
+    {
+        URHO3D_LOGERROR(sector.sceneName_ + " is not a scene or node prefab file");
+        sectors_[index].loadQueued_ = false;
+        return;
+    }
+
+    // Sector contents are local and temporary: they do not replicate and are not saved with the scene
+    instantiatingSector_ = index;
+    instantiationFile_ = file;
+    instantiationRoot_ = node_->CreateChild(sector.sceneName_, LOCAL, 0, true);
+}
+
+void SceneStreamer::UpdateInstantiation()
+{
+    URHO3D_PROFILE("InstantiateSector");
+
+    HiresTimer timer;
+
+    // Instantiate one root-level child node with its full sub-hierarchy at a time, rewriting node and
+    // component IDs, until the budget for this frame is exhausted
+    while (instantiationElement_)
+    {
+        unsigned nodeID = instantiationElement_.GetUInt("id");
+        Node* newNode = instantiationRoot_->CreateChild(EMPTY_STRING, LOCAL);
+        resolver_.AddNode(nodeID, newNode);
+        newNode->LoadXML(instantiationElement_, resolver_, true, true, LOCAL);
+        instantiationElement_ = instantiationElement_.GetNext("node");
+
+        if (timer.GetUSec(false) >= instantiationMs_ * 1000LL)
+            return;
+    }
+
+    FinishInstantiation();
+}
+
+void SceneStreamer::FinishInstantiation()
+{
+    resolver_.Resolve();
+    instantiationRoot_->ApplyAttributes();
+
+    StreamingSector& sector = sectors_[instantiatingSector_];
+    sector.root_ = instantiationRoot_;
+
+    const unsigned index = instantiatingSector_;
+    instantiatingSector_ = M_MAX_UNSIGNED;
+    instantiationFile_.Reset();
+    instantiationRoot_.Reset();
+
+    URHO3D_LOGDEBUG("Streamed in sector " + sector.sceneName_);
+
+    using namespace SectorLoaded;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_STREAMER] = this;
+    eventData[P_INDEX] = index;
+    eventData[P_ROOT] = sector.root_.Get();
+    SendEvent(E_SECTORLOADED, eventData);
+}
+
+void SceneStreamer::CancelInstantiation()
+{
+    if (instantiatingSector_ == M_MAX_UNSIGNED)
+        return;
+
+    sectors_[instantiatingSector_].loadQueued_ = false;
+    instantiatingSector_ = M_MAX_UNSIGNED;
+    instantiationFile_.Reset();
+    resolver_.Reset();
+    if (instantiationRoot_)
+    {
+        instantiationRoot_->Remove();
+        instantiationRoot_.Reset();
+    }
+}
+
+void SceneStreamer::UnloadSector(unsigned index)
+{
+    StreamingSector& sector = sectors_[index];
+    sector.root_->Remove();
+    sector.root_.Reset();
+    sector.loadQueued_ = false;
+
+    // Release the sector file so that streamed-out sectors do not accumulate in the resource cache
+    if (auto* cache = GetSubsystem<ResourceCache>())
+        cache->ReleaseResource(XMLFile::GetTypeStatic(), sector.sceneName_);
+
+    URHO3D_LOGDEBUG("Streamed out sector " + sector.sceneName_);
+
+    using namespace SectorUnloaded;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_STREAMER] = this;
+    eventData[P_INDEX] = index;
+    SendEvent(E_SECTORUNLOADED, eventData);
+}
+
+}
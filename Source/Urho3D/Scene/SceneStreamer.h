@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Resource/XMLElement.h"
+#include "../Scene/Component.h"
+#include "../Scene/SceneResolver.h"
+
+namespace Urho3D
+{
+
+class XMLFile;
+
+/// World streaming component. The world is partitioned into sectors, each an XML scene or node prefab file
+/// with world-space bounds. Sectors within the load distance of a registered observer are streamed in and
+/// sectors beyond the unload distance are removed again. The sector files are read and parsed by the
+/// background resource loader in closest-first order, and instantiation into the scene is time-sliced with
+/// a millisecond budget per frame in the manner of async scene loading, so neither I/O nor node creation
+/// spikes the frame time. Node and component ID references within a sector are remapped on instantiation.
+/// Sector contents are created as local, temporary children of the component's node and are not saved with
+/// the scene.
+class URHO3D_API SceneStreamer : public Component
+{
+    URHO3D_OBJECT(SceneStreamer, Component);
+
+public:
+    /// Construct.
+    explicit SceneStreamer(Context* context);
+    /// Destruct.
+    ~SceneStreamer() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Register a sector given its scene or node prefab XML resource name and world-space bounds. Return sector index.
+    unsigned AddSector(const ea::string& sceneName, const BoundingBox& bounds);
+    /// Remove all sectors and unload their contents.
+    void ClearSectors();
+    /// Add an observer node that keeps nearby sectors loaded, typically the camera or the player.
+    void AddObserver(Node* observer);
+    /// Remove an observer node.
+    void RemoveObserver(Node* observer);
+    /// Set distance within which sectors are loaded.
+    void SetLoadDistance(float distance);
+    /// Set distance beyond which loaded sectors are unloaded. Clamped to be at least the load distance,
+    /// and should exceed it to provide hysteresis against observers moving back and forth on the boundary.
+    void SetUnloadDistance(float distance);
+    /// Set maximum milliseconds per frame to spend instantiating sector contents.
+    void SetInstantiationMs(int ms);
+
+    /// Return number of sectors.
+    unsigned GetNumSectors() const { return sectors_.size(); }
+    /// Return whether a sector's contents are fully instantiated.
+    bool IsSectorLoaded(unsigned index) const;
+    /// Return the root node of a loaded sector, or null if not loaded.
+    Node* GetSectorRoot(unsigned index) const;
+    /// Return load distance.
+    float GetLoadDistance() const { return loadDistance_; }
+    /// Return unload distance.
+    float GetUnloadDistance() const { return unloadDistance_; }
+    /// Return maximum milliseconds per frame to spend instantiating sector contents.
+    int GetInstantiationMs() const { return instantiationMs_; }
+
+protected:
+    /// Handle scene being assigned. Subscribe to scene update while in a scene.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// One registered streaming sector.
+    struct StreamingSector
+    {
+        /// Scene or node prefab XML resource name.
+        ea::string sceneName_;
+        /// World-space bounds.
+        BoundingBox bounds_;
+        /// Root node of the instantiated contents. Null while not loaded.
+        SharedPtr<Node> root_;
+        /// Background load of the sector file has been requested.
+        bool loadQueued_{};
+    };
+
+    /// Handle scene update. Drive loading, unloading and time-sliced instantiation.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    /// Begin instantiating a sector whose file has finished background loading.
+    void BeginInstantiation(unsigned index, XMLFile* file);
+    /// Instantiate sector nodes until the millisecond budget runs out. Finish the sector when all are done.
+    void UpdateInstantiation();
+    /// Finish instantiation: resolve remapped ID references and apply attributes.
+    void FinishInstantiation();
+    /// Abort an in-progress instantiation and remove the partial contents.
+    void CancelInstantiation();
+    /// Unload a loaded sector.
+    void UnloadSector(unsigned index);
+
+    /// Registered sectors.
+    ea::vector<StreamingSector> sectors_;
+    /// Observer nodes.
+    ea::vector<WeakPtr<Node>> observers_;
+    /// Distance within which sectors are loaded.
+    float loadDistance_;
+    /// Distance beyond which loaded sectors are unloaded.
+    float unloadDistance_;
+    /// Maximum milliseconds per frame to spend instantiating sector contents.
+    int instantiationMs_;
+    /// Index of the sector being instantiated, or M_MAX_UNSIGNED if none.
+    unsigned instantiatingSector_{M_MAX_UNSIGNED};
+    /// File of the sector being instantiated. Kept to hold the XML document alive until finished.
+    SharedPtr<XMLFile> instantiationFile_;
+    /// Next node element to instantiate of the sector being instantiated.
+    XMLElement instantiationElement_;
+    /// Root node of the sector being instantiated.
+    SharedPtr<Node> instantiationRoot_;
+    /// ID resolver for the sector being instantiated.
+    SceneResolver resolver_;
+};
+
+}
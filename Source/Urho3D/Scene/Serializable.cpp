@@ -47,6 +47,85 @@ namespace Urho3D
 
 static const unsigned MAX_STACK_ATTRIBUTE_COUNT = 128;
 
+/// Raw attribute write function. One per supported variant type, dispatched through a flat table indexed by type.
+using RawAttributeSetter = void (*)(void* dest, const Variant& src);
+/// Raw attribute read function. One per supported variant type, dispatched through a flat table indexed by type.
+using RawAttributeGetter = void (*)(const void* src, Variant& dest);
+
+template <class T> static void SetRawAttributeValue(void* dest, const Variant& src)
+{
+    *(reinterpret_cast<T*>(dest)) = src.Get<T>();
+}
+
+template <class T> static void GetRawAttributeValue(const void* src, Variant& dest)
+{
+    dest = *(reinterpret_cast<const T*>(src));
+}
+
+/// Flat raw attribute write dispatch table. Null entries denote types unsupported for raw access.
+static const RawAttributeSetter rawAttributeSetters[MAX_VAR_TYPES] = {
+    nullptr,                                            // VAR_NONE
+    SetRawAttributeValue<int>,                          // VAR_INT
+    SetRawAttributeValue<bool>,                         // VAR_BOOL
+    SetRawAttributeValue<float>,                        // VAR_FLOAT
+    SetRawAttributeValue<Vector2>,                      // VAR_VECTOR2
+    SetRawAttributeValue<Vector3>,                      // VAR_VECTOR3
+    SetRawAttributeValue<Vector4>,                      // VAR_VECTOR4
+    SetRawAttributeValue<Quaternion>,                   // VAR_QUATERNION
+    SetRawAttributeValue<Color>,                        // VAR_COLOR
+    SetRawAttributeValue<ea::string>,                   // VAR_STRING
+    SetRawAttributeValue<ea::vector<unsigned char> >,   // VAR_BUFFER
+    nullptr,                                            // VAR_VOIDPTR
+    SetRawAttributeValue<ResourceRef>,                  // VAR_RESOURCEREF
+    SetRawAttributeValue<ResourceRefList>,              // VAR_RESOURCEREFLIST
+    SetRawAttributeValue<VariantVector>,                // VAR_VARIANTVECTOR
+    SetRawAttributeValue<VariantMap>,                   // VAR_VARIANTMAP
+    SetRawAttributeValue<IntRect>,                      // VAR_INTRECT
+    SetRawAttributeValue<IntVector2>,                   // VAR_INTVECTOR2
+    nullptr,                                            // VAR_PTR
+    nullptr,                                            // VAR_MATRIX3
+    nullptr,                                            // VAR_MATRIX3X4
+    nullptr,                                            // VAR_MATRIX4
+    SetRawAttributeValue<double>,                       // VAR_DOUBLE
+    SetRawAttributeValue<StringVector>,                 // VAR_STRINGVECTOR
+    nullptr,                                            // VAR_RECT
+    SetRawAttributeValue<IntVector3>,                   // VAR_INTVECTOR3
+    SetRawAttributeValue<long long>,                    // VAR_INT64
+    nullptr,                                            // VAR_CUSTOM
+};
+
+/// Flat raw attribute read dispatch table. Null entries denote types unsupported for raw access.
+static const RawAttributeGetter rawAttributeGetters[MAX_VAR_TYPES] = {
+    nullptr,                                            // VAR_NONE
+    GetRawAttributeValue<int>,                          // VAR_INT
+    GetRawAttributeValue<bool>,                         // VAR_BOOL
+    GetRawAttributeValue<float>,                        // VAR_FLOAT
+    GetRawAttributeValue<Vector2>,                      // VAR_VECTOR2
+    GetRawAttributeValue<Vector3>,                      // VAR_VECTOR3
+    GetRawAttributeValue<Vector4>,                      // VAR_VECTOR4
+    GetRawAttributeValue<Quaternion>,                   // VAR_QUATERNION
+    GetRawAttributeValue<Color>,                        // VAR_COLOR
+    GetRawAttributeValue<ea::string>,                   // VAR_STRING
+    GetRawAttributeValue<ea::vector<unsigned char> >,   // VAR_BUFFER
+    nullptr,                                            // VAR_VOIDPTR
+    GetRawAttributeValue<ResourceRef>,                  // VAR_RESOURCEREF
+    GetRawAttributeValue<ResourceRefList>,              // VAR_RESOURCEREFLIST
+    GetRawAttributeValue<VariantVector>,                // VAR_VARIANTVECTOR
+    GetRawAttributeValue<VariantMap>,                   // VAR_VARIANTMAP
+    GetRawAttributeValue<IntRect>,                      // VAR_INTRECT
+    GetRawAttributeValue<IntVector2>,                   // VAR_INTVECTOR2
+    nullptr,                                            // VAR_PTR
+    nullptr,                                            // VAR_MATRIX3
+    nullptr,                                            // VAR_MATRIX3X4
+    nullptr,                                            // VAR_MATRIX4
+    GetRawAttributeValue<double>,                       // VAR_DOUBLE
+    GetRawAttributeValue<StringVector>,                 // VAR_STRINGVECTOR
+    nullptr,                                            // VAR_RECT
+    GetRawAttributeValue<IntVector3>,                   // VAR_INTVECTOR3
+    GetRawAttributeValue<long long>,                    // VAR_INT64
+    nullptr,                                            // VAR_CUSTOM
+};
+
 static unsigned RemapAttributeIndex(const ea::vector<AttributeInfo>* attributes, const AttributeInfo& netAttr, unsigned netAttrIndex)
 {
     if (!attributes)
@@ -63,6 +142,39 @@ static unsigned RemapAttributeIndex(const ea::vector<AttributeInfo>* attributes,
     return netAttrIndex; // Could not remap
 }
 
+static void WriteNetworkAttributeData(Serializer& dest, const AttributeInfo& attr, const Variant& value)
+{
+    // Quantized attributes use compact encodings for the supported types; everything else is sent at full precision
+    if (attr.mode_ & AM_QUANTIZE)
+    {
+        if (attr.type_ == VAR_VECTOR3)
+        {
+            dest.WriteQuantizedVector3(value.GetVector3());
+            return;
+        }
+        if (attr.type_ == VAR_QUATERNION)
+        {
+            dest.WriteQuaternionSmallestThree(value.GetQuaternion());
+            return;
+        }
+    }
+
+    dest.WriteVariantData(value);
+}
+
+static Variant ReadNetworkAttributeData(Deserializer& source, const AttributeInfo& attr)
+{
+    if (attr.mode_ & AM_QUANTIZE)
+    {
+        if (attr.type_ == VAR_VECTOR3)
+            return source.ReadQuantizedVector3();
+        if (attr.type_ == VAR_QUATERNION)
+            return source.ReadQuaternionSmallestThree();
+    }
+
+    return source.ReadVariant(attr.type_);
+}
+
 static bool SaveAttributeWithName(Archive& archive, const AttributeInfo& attr, const Variant& value)
 {
     assert(!archive.IsInput());
@@ -133,93 +245,13 @@ void Serializable::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
     assert(attr.ptr_);
     void* dest = attr.ptr_;
 
-    switch (attr.type_)
+    // If enum type, use the low 8 bits only
+    if (attr.type_ == VAR_INT && attr.enumNames_)
+        *(reinterpret_cast<unsigned char*>(dest)) = (unsigned char)src.GetInt();
+    else if (attr.type_ < MAX_VAR_TYPES && rawAttributeSetters[attr.type_])
+        rawAttributeSetters[attr.type_](dest, src);
+    else
     {
-    case VAR_INT:
-        // If enum type, use the low 8 bits only
-        if (attr.enumNames_)
-            *(reinterpret_cast<unsigned char*>(dest)) = src.GetInt();
-        else
-            *(reinterpret_cast<int*>(dest)) = src.GetInt();
-        break;
-
-    case VAR_INT64:
-        *(reinterpret_cast<long long*>(dest)) = src.GetInt64();
-        break;
-
-    case VAR_BOOL:
-        *(reinterpret_cast<bool*>(dest)) = src.GetBool();
-        break;
-
-    case VAR_FLOAT:
-        *(reinterpret_cast<float*>(dest)) = src.GetFloat();
-        break;
-
-    case VAR_VECTOR2:
-        *(reinterpret_cast<Vector2*>(dest)) = src.GetVector2();
-        break;
-
-    case VAR_VECTOR3:
-        *(reinterpret_cast<Vector3*>(dest)) = src.GetVector3();
-        break;
-
-    case VAR_VECTOR4:
-        *(reinterpret_cast<Vector4*>(dest)) = src.GetVector4();
-        break;
-
-    case VAR_QUATERNION:
-        *(reinterpret_cast<Quaternion*>(dest)) = src.GetQuaternion();
-        break;
-
-    case VAR_COLOR:
-        *(reinterpret_cast<Color*>(dest)) = src.GetColor();
-        break;
-
-    case VAR_STRING:
-        *(reinterpret_cast<ea::string*>(dest)) = src.GetString();
-        break;
-
-    case VAR_BUFFER:
-        *(reinterpret_cast<ea::vector<unsigned char>*>(dest)) = src.GetBuffer();
-        break;
-
-    case VAR_RESOURCEREF:
-        *(reinterpret_cast<ResourceRef*>(dest)) = src.GetResourceRef();
-        break;
-
-    case VAR_RESOURCEREFLIST:
-        *(reinterpret_cast<ResourceRefList*>(dest)) = src.GetResourceRefList();
-        break;
-
-    case VAR_VARIANTVECTOR:
-        *(reinterpret_cast<VariantVector*>(dest)) = src.GetVariantVector();
-        break;
-
-    case VAR_STRINGVECTOR:
-        *(reinterpret_cast<StringVector*>(dest)) = src.GetStringVector();
-        break;
-
-    case VAR_VARIANTMAP:
-        *(reinterpret_cast<VariantMap*>(dest)) = src.GetVariantMap();
-        break;
-
-    case VAR_INTRECT:
-        *(reinterpret_cast<IntRect*>(dest)) = src.GetIntRect();
-        break;
-
-    case VAR_INTVECTOR2:
-        *(reinterpret_cast<IntVector2*>(dest)) = src.GetIntVector2();
-        break;
-
-    case VAR_INTVECTOR3:
-        *(reinterpret_cast<IntVector3*>(dest)) = src.GetIntVector3();
-        break;
-
-    case VAR_DOUBLE:
-        *(reinterpret_cast<double*>(dest)) = src.GetDouble();
-        break;
-
-    default:
         URHO3D_LOGERROR("Unsupported attribute type for OnSetAttribute()");
         return;
     }
@@ -242,96 +274,13 @@ void Serializable::OnGetAttribute(const AttributeInfo& attr, Variant& dest) cons
     assert(attr.ptr_);
     const void* src = attr.ptr_;
 
-    switch (attr.type_)
-    {
-    case VAR_INT:
-        // If enum type, use the low 8 bits only
-        if (attr.enumNames_)
-            dest = *(reinterpret_cast<const unsigned char*>(src));
-        else
-            dest = *(reinterpret_cast<const int*>(src));
-        break;
-
-    case VAR_INT64:
-        dest = *(reinterpret_cast<const long long*>(src));
-        break;
-
-    case VAR_BOOL:
-        dest = *(reinterpret_cast<const bool*>(src));
-        break;
-
-    case VAR_FLOAT:
-        dest = *(reinterpret_cast<const float*>(src));
-        break;
-
-    case VAR_VECTOR2:
-        dest = *(reinterpret_cast<const Vector2*>(src));
-        break;
-
-    case VAR_VECTOR3:
-        dest = *(reinterpret_cast<const Vector3*>(src));
-        break;
-
-    case VAR_VECTOR4:
-        dest = *(reinterpret_cast<const Vector4*>(src));
-        break;
-
-    case VAR_QUATERNION:
-        dest = *(reinterpret_cast<const Quaternion*>(src));
-        break;
-
-    case VAR_COLOR:
-        dest = *(reinterpret_cast<const Color*>(src));
-        break;
-
-    case VAR_STRING:
-        dest = *(reinterpret_cast<const ea::string*>(src));
-        break;
-
-    case VAR_BUFFER:
-        dest = *(reinterpret_cast<const ea::vector<unsigned char>*>(src));
-        break;
-
-    case VAR_RESOURCEREF:
-        dest = *(reinterpret_cast<const ResourceRef*>(src));
-        break;
-
-    case VAR_RESOURCEREFLIST:
-        dest = *(reinterpret_cast<const ResourceRefList*>(src));
-        break;
-
-    case VAR_VARIANTVECTOR:
-        dest = *(reinterpret_cast<const VariantVector*>(src));
-        break;
-
-    case VAR_STRINGVECTOR:
-        dest = *(reinterpret_cast<const StringVector*>(src));
-        break;
-
-    case VAR_VARIANTMAP:
-        dest = *(reinterpret_cast<const VariantMap*>(src));
-        break;
-
-    case VAR_INTRECT:
-        dest = *(reinterpret_cast<const IntRect*>(src));
-        break;
-
-    case VAR_INTVECTOR2:
-        dest = *(reinterpret_cast<const IntVector2*>(src));
-        break;
-
-    case VAR_INTVECTOR3:
-        dest = *(reinterpret_cast<const IntVector3*>(src));
-        break;
-
-    case VAR_DOUBLE:
-        dest = *(reinterpret_cast<const double*>(src));
-        break;
-
-    default:
+    // If enum type, use the low 8 bits only
+    if (attr.type_ == VAR_INT && attr.enumNames_)
+        dest = *(reinterpret_cast<const unsigned char*>(src));
+    else if (attr.type_ < MAX_VAR_TYPES && rawAttributeGetters[attr.type_])
+        rawAttributeGetters[attr.type_](src, dest);
+    else
         URHO3D_LOGERROR("Unsupported attribute type for OnGetAttribute()");
-        return;
-    }
 }
 
 const ea::vector<AttributeInfo>* Serializable::GetAttributes() const
@@ -883,35 +832,67 @@ bool Serializable::SetAttribute(unsigned index, const Variant& value)
 }
 
 bool Serializable::SetAttribute(const ea::string& name, const Variant& value)
+{
+    const unsigned index = GetAttributeIndex(name);
+    if (index == M_MAX_UNSIGNED)
+    {
+        URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
+        return false;
+    }
+
+    return SetAttribute(index, value);
+}
+
+void Serializable::SnapshotAttributes(ea::vector<Variant>& dest) const
+{
+    const ea::vector<AttributeInfo>* attributes = GetAttributes();
+    dest.clear();
+    if (!attributes)
+        return;
+
+    dest.resize(attributes->size());
+    for (unsigned i = 0; i < attributes->size(); ++i)
+        OnGetAttribute(attributes->at(i), dest[i]);
+}
+
+bool Serializable::DiffAttributes(const ea::vector<Variant>& oldValues, AttributePatch& undoPatch, AttributePatch& redoPatch) const
 {
     const ea::vector<AttributeInfo>* attributes = GetAttributes();
     if (!attributes)
-    {
-        URHO3D_LOGERROR(GetTypeName() + " has no attributes");
         return false;
+
+    bool changed = false;
+    Variant value;
+
+    for (unsigned i = 0; i < attributes->size() && i < oldValues.size(); ++i)
+    {
+        value.Clear();
+        OnGetAttribute(attributes->at(i), value);
+        if (value == oldValues[i])
+            continue;
+
+        undoPatch.Add(i, oldValues[i]);
+        redoPatch.Add(i, value);
+        changed = true;
     }
 
-    for (auto i = attributes->begin(); i != attributes->end(); ++i)
+    return changed;
+}
+
+unsigned Serializable::ApplyAttributePatch(const AttributePatch& patch)
+{
+    unsigned numSet = 0;
+
+    for (unsigned i = 0; i < patch.changes_.size(); ++i)
     {
-        if (!i->name_.compare(name))
-        {
-            // Check that the new value's type matches the attribute type
-            if (value.GetType() == i->type_)
-            {
-                OnSetAttribute(*i, value);
-                return true;
-            }
-            else
-            {
-                URHO3D_LOGERROR("Could not set attribute " + i->name_ + ": expected type " + Variant::GetTypeName(i->type_)
-                         + " but got " + value.GetTypeName());
-                return false;
-            }
-        }
+        if (SetAttribute(patch.changes_[i].first, patch.changes_[i].second))
+            ++numSet;
     }
 
-    URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
-    return false;
+    if (numSet)
+        ApplyAttributes();
+
+    return numSet;
 }
 
 void Serializable::ResetToDefault()
@@ -937,6 +918,7 @@ void Serializable::ResetToDefault()
 void Serializable::RemoveInstanceDefault()
 {
     instanceDefaultValues_.reset();
+    sharedDefaultValues_.Reset();
 }
 
 void Serializable::SetTemporary(bool enable)
@@ -1031,7 +1013,7 @@ void Serializable::WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeS
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteNetworkAttributeData(dest, attributes->at(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -1057,7 +1039,7 @@ void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attribute
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteNetworkAttributeData(dest, attributes->at(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -1080,7 +1062,7 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributes->at(i).mode_ & AM_LATESTDATA)
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteNetworkAttributeData(dest, attributes->at(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -1105,7 +1087,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
             const AttributeInfo& attr = attributes->at(i);
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, ReadNetworkAttributeData(source, attr));
                 changed = true;
             }
             else
@@ -1117,7 +1099,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = ReadNetworkAttributeData(source, attr);
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
@@ -1145,7 +1127,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
         {
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, ReadNetworkAttributeData(source, attr));
                 changed = true;
             }
             else
@@ -1157,7 +1139,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = ReadNetworkAttributeData(source, attr);
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
@@ -1188,26 +1170,14 @@ Variant Serializable::GetAttribute(unsigned index) const
 
 Variant Serializable::GetAttribute(const ea::string& name) const
 {
-    Variant ret;
-
-    const ea::vector<AttributeInfo>* attributes = GetAttributes();
-    if (!attributes)
-    {
-        URHO3D_LOGERROR(GetTypeName() + " has no attributes");
-        return ret;
-    }
-
-    for (auto i = attributes->begin(); i != attributes->end(); ++i)
+    const unsigned index = GetAttributeIndex(name);
+    if (index == M_MAX_UNSIGNED)
     {
-        if (!i->name_.compare(name))
-        {
-            OnGetAttribute(*i, ret);
-            return ret;
-        }
+        URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
+        return Variant::EMPTY;
     }
 
-    URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
-    return ret;
+    return GetAttribute(index);
 }
 
 Variant Serializable::GetAttributeDefault(unsigned index) const
@@ -1235,21 +1205,19 @@ Variant Serializable::GetAttributeDefault(const ea::string& name) const
     if (!defaultValue.IsEmpty())
         return defaultValue;
 
-    const ea::vector<AttributeInfo>* attributes = GetAttributes();
-    if (!attributes)
+    const unsigned index = GetAttributeIndex(name);
+    if (index == M_MAX_UNSIGNED)
     {
-        URHO3D_LOGERROR(GetTypeName() + " has no attributes");
+        URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
         return Variant::EMPTY;
     }
 
-    for (auto i = attributes->begin(); i != attributes->end(); ++i)
-    {
-        if (!i->name_.compare(name))
-            return i->defaultValue_;
-    }
+    return GetAttributes()->at(index).defaultValue_;
+}
 
-    URHO3D_LOGERROR("Could not find attribute " + name + " in " + GetTypeName());
-    return Variant::EMPTY;
+unsigned Serializable::GetAttributeIndex(const ea::string& name) const
+{
+    return context_->GetAttributeIndex(GetType(), StringHash(name));
 }
 
 unsigned Serializable::GetNumAttributes() const
@@ -1293,6 +1261,8 @@ void Serializable::SetInstanceDefault(const ea::string& name, const Variant& def
 
 Variant Serializable::GetInstanceDefault(const ea::string& name) const
 {
+    // The instance's own values shadow the shared table, so changing a default on one instance does not
+    // affect the other instances referencing the same table
     if (instanceDefaultValues_)
     {
         auto i = instanceDefaultValues_->find(name);
@@ -1300,6 +1270,9 @@ Variant Serializable::GetInstanceDefault(const ea::string& name) const
             return i->second;
     }
 
+    if (sharedDefaultValues_)
+        return sharedDefaultValues_->GetDefault(name);
+
     return Variant::EMPTY;
 }
 
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <EASTL/utility.h>
+
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
 
@@ -42,6 +44,50 @@ struct DirtyBits;
 struct NetworkState;
 struct ReplicationState;
 
+/// Immutable table of shared attribute default values. One table is built per prefab node or component and
+/// referenced by every instance spawned from the prefab, replacing the per-instance default value copies that
+/// would otherwise be duplicated across thousands of identical instances. The table must not be modified once
+/// it has been handed to an instance; per-instance default changes are written to the instance's own values,
+/// which shadow the shared table (copy-on-write at attribute granularity).
+class URHO3D_API SharedAttributeDefaults : public RefCounted
+{
+public:
+    /// Set a default value by attribute name. Only valid while building the table, before it is shared.
+    void SetDefault(const ea::string& name, const Variant& value) { defaultValues_[name] = value; }
+
+    /// Return a default value by attribute name, or empty if not defined.
+    Variant GetDefault(const ea::string& name) const
+    {
+        auto it = defaultValues_.find(name);
+        return it != defaultValues_.end() ? it->second : Variant::EMPTY;
+    }
+
+    /// Return number of default values.
+    unsigned Size() const { return defaultValues_.size(); }
+
+private:
+    /// Default values by attribute name hash.
+    VariantMap defaultValues_;
+};
+
+/// Set of changed attribute values of a Serializable, produced by DiffAttributes(). Only changed attributes
+/// are stored, so patches of bulk edits over large selections stay proportional to what actually changed
+/// instead of duplicating full attribute sets per object.
+struct AttributePatch
+{
+    /// Add a changed attribute value.
+    void Add(unsigned index, const Variant& value) { changes_.push_back(ea::make_pair(index, value)); }
+    /// Clear the patch.
+    void Clear() { changes_.clear(); }
+    /// Return number of changed attributes.
+    unsigned Size() const { return changes_.size(); }
+    /// Return whether the patch is empty.
+    bool Empty() const { return changes_.empty(); }
+
+    /// Changed attribute indices and values. Indexed like GetAttributes() of the patched object.
+    ea::vector<ea::pair<unsigned, Variant> > changes_;
+};
+
 /// Base class for objects with automatic serialization through attributes.
 class URHO3D_API Serializable : public Object
 {
@@ -109,6 +155,11 @@ public:
     virtual Variant GetInstanceDefault(const ea::string& name) const;
     /// Reset all editable attributes to their default values.
     void ResetToDefault();
+    /// Set shared default values referenced in place of per-instance copies. Looked up after the instance's
+    /// own default values, so instance-level changes shadow the shared table without modifying it.
+    void SetSharedDefaults(SharedAttributeDefaults* defaults) { sharedDefaultValues_ = defaults; }
+    /// Return shared default values, or null if not set.
+    SharedAttributeDefaults* GetSharedDefaults() const { return sharedDefaultValues_; }
     /// Remove instance's default values if they are set previously.
     void RemoveInstanceDefault();
     /// Set temporary flag. Temporary objects will not be saved.
@@ -128,6 +179,13 @@ public:
     /// Read and apply a network latest data update. Return true if attributes were changed.
     bool ReadLatestDataUpdate(Deserializer& source);
 
+    /// Capture the current values of all attributes into a snapshot, indexed like GetAttributes(). Intended as a transient input for DiffAttributes().
+    void SnapshotAttributes(ea::vector<Variant>& dest) const;
+    /// Compare the current attribute values against a snapshot taken before an edit. Changed attributes are appended to the patches: snapshot values to undoPatch and current values to redoPatch. Return true if any attribute changed.
+    bool DiffAttributes(const ea::vector<Variant>& oldValues, AttributePatch& undoPatch, AttributePatch& redoPatch) const;
+    /// Apply a patch in bulk and perform deferred attribute changes once at the end. Return number of attributes set.
+    unsigned ApplyAttributePatch(const AttributePatch& patch);
+
     /// Return attribute value by index. Return empty if illegal index.
     Variant GetAttribute(unsigned index) const;
     /// Return attribute value by name. Return empty if not found.
@@ -136,6 +194,8 @@ public:
     Variant GetAttributeDefault(unsigned index) const;
     /// Return attribute default value by name. Return empty if not found.
     Variant GetAttributeDefault(const ea::string& name) const;
+    /// Return index of an attribute by name, or M_MAX_UNSIGNED if not found. Resolved through a per-class lookup table instead of a linear scan.
+    unsigned GetAttributeIndex(const ea::string& name) const;
     /// Return number of attributes.
     unsigned GetNumAttributes() const;
     /// Return number of network replication attributes.
@@ -156,6 +216,9 @@ protected:
 
     /// Attribute default value at each instance level.
     ea::unique_ptr<VariantMap> instanceDefaultValues_;
+    /// Shared attribute default values, referenced instead of copied per instance. Null unless the object was
+    /// spawned from a prefab with shared defaults enabled.
+    SharedPtr<SharedAttributeDefaults> sharedDefaultValues_;
     /// When true, store the attribute value as instance's default value (internal use only).
     bool setInstanceDefault_;
     /// Temporary flag.
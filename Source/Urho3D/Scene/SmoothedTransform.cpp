@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Timer.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SmoothedTransform.h"
@@ -32,11 +33,18 @@
 namespace Urho3D
 {
 
+static const float DEFAULT_INTERPOLATION_DELAY = 0.1f;
+static const float DEFAULT_MAX_EXTRAPOLATION_TIME = 0.25f;
+static const unsigned MAX_TRANSFORM_SNAPSHOTS = 16;
+
 SmoothedTransform::SmoothedTransform(Context* context) :
     Component(context),
     targetPosition_(Vector3::ZERO),
     targetRotation_(Quaternion::IDENTITY),
+    interpolationDelay_(DEFAULT_INTERPOLATION_DELAY),
+    maxExtrapolationTime_(DEFAULT_MAX_EXTRAPOLATION_TIME),
     smoothingMask_(SMOOTH_NONE),
+    interpolationEnabled_(false),
     subscribed_(false)
 {
 }
@@ -46,11 +54,17 @@ SmoothedTransform::~SmoothedTransform() = default;
 void SmoothedTransform::RegisterObject(Context* context)
 {
     context->RegisterFactory<SmoothedTransform>();
+
+    URHO3D_ATTRIBUTE("Interpolation Enabled", bool, interpolationEnabled_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Interpolation Delay", float, interpolationDelay_, DEFAULT_INTERPOLATION_DELAY, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Extrapolation Time", float, maxExtrapolationTime_, DEFAULT_MAX_EXTRAPOLATION_TIME, AM_DEFAULT);
 }
 
 void SmoothedTransform::Update(float constant, float squaredSnapThreshold)
 {
-    if (smoothingMask_ && node_)
+    if (interpolationEnabled_ && node_ && snapshots_.size())
+        UpdateInterpolation(constant);
+    else if (smoothingMask_ && node_)
     {
         Vector3 position = node_->GetPosition();
         Quaternion rotation = node_->GetRotation();
@@ -100,6 +114,8 @@ void SmoothedTransform::SetTargetPosition(const Vector3& position)
 {
     targetPosition_ = position;
     smoothingMask_ |= SMOOTH_POSITION;
+    if (interpolationEnabled_)
+        PushSnapshot();
 
     // Subscribe to smoothing update if not yet subscribed
     if (!subscribed_)
@@ -115,6 +131,8 @@ void SmoothedTransform::SetTargetRotation(const Quaternion& rotation)
 {
     targetRotation_ = rotation;
     smoothingMask_ |= SMOOTH_ROTATION;
+    if (interpolationEnabled_)
+        PushSnapshot();
 
     if (!subscribed_)
     {
@@ -141,6 +159,23 @@ void SmoothedTransform::SetTargetWorldRotation(const Quaternion& rotation)
         SetTargetRotation(rotation);
 }
 
+void SmoothedTransform::SetInterpolationEnabled(bool enable)
+{
+    interpolationEnabled_ = enable;
+    if (!enable)
+        snapshots_.clear();
+}
+
+void SmoothedTransform::SetInterpolationDelay(float delay)
+{
+    interpolationDelay_ = Max(delay, 0.0f);
+}
+
+void SmoothedTransform::SetMaxExtrapolationTime(float time)
+{
+    maxExtrapolationTime_ = Max(time, 0.0f);
+}
+
 Vector3 SmoothedTransform::GetTargetWorldPosition() const
 {
     if (node_ && node_->GetParent())
@@ -167,6 +202,81 @@ void SmoothedTransform::OnNodeSet(Node* node)
     }
 }
 
+void SmoothedTransform::PushSnapshot()
+{
+    float now = GetSubsystem<Time>()->GetElapsedTime();
+
+    // Position and rotation typically arrive in the same network update: merge them into one snapshot
+    if (snapshots_.size() && now - snapshots_.back().time_ < M_EPSILON)
+    {
+        snapshots_.back().position_ = targetPosition_;
+        snapshots_.back().rotation_ = targetRotation_;
+        return;
+    }
+
+    if (snapshots_.size() >= MAX_TRANSFORM_SNAPSHOTS)
+        snapshots_.erase(snapshots_.begin());
+
+    snapshots_.push_back(TransformSnapshot{targetPosition_, targetRotation_, now});
+}
+
+void SmoothedTransform::UpdateInterpolation(float constant)
+{
+    // A snap (constant >= 1) jumps straight to the newest snapshot and discards the history
+    if (constant >= 1.0f)
+    {
+        node_->SetPosition(snapshots_.back().position_);
+        node_->SetRotation(snapshots_.back().rotation_);
+        if (snapshots_.size() > 1)
+            snapshots_.erase(snapshots_.begin(), snapshots_.end() - 1);
+        smoothingMask_ = SMOOTH_NONE;
+        return;
+    }
+
+    float sampleTime = GetSubsystem<Time>()->GetElapsedTime() - interpolationDelay_;
+
+    // Drop snapshots no longer needed for bracketing the sample time, but keep the two newest for extrapolation
+    while (snapshots_.size() > 2 && snapshots_[1].time_ <= sampleTime)
+        snapshots_.erase(snapshots_.begin());
+
+    Vector3 position;
+    Quaternion rotation;
+
+    if (snapshots_.size() == 1 || snapshots_.front().time_ >= sampleTime)
+    {
+        // Not enough history yet: hold the oldest snapshot
+        position = snapshots_.front().position_;
+        rotation = snapshots_.front().rotation_;
+    }
+    else if (snapshots_[1].time_ > sampleTime)
+    {
+        // Interpolate between the two snapshots bracketing the sample time
+        const TransformSnapshot& from = snapshots_[0];
+        const TransformSnapshot& to = snapshots_[1];
+        float t = (sampleTime - from.time_) / Max(to.time_ - from.time_, M_EPSILON);
+        position = from.position_.Lerp(to.position_, t);
+        rotation = from.rotation_.Slerp(to.rotation_, t);
+    }
+    else
+    {
+        // Ran out of snapshots: extrapolate along the last known velocity for a bounded time, holding rotation
+        const TransformSnapshot& previous = snapshots_[snapshots_.size() - 2];
+        const TransformSnapshot& newest = snapshots_.back();
+        float extrapolationTime = Min(sampleTime - newest.time_, maxExtrapolationTime_);
+        float dt = newest.time_ - previous.time_;
+        Vector3 velocity = dt > M_EPSILON ? (newest.position_ - previous.position_) / dt : Vector3::ZERO;
+        position = newest.position_ + velocity * extrapolationTime;
+        rotation = newest.rotation_;
+
+        // Nothing will change once the extrapolation limit has been reached; allow unsubscribing
+        if (sampleTime - newest.time_ >= maxExtrapolationTime_)
+            smoothingMask_ = SMOOTH_NONE;
+    }
+
+    node_->SetPosition(position);
+    node_->SetRotation(rotation);
+}
+
 void SmoothedTransform::HandleUpdateSmoothing(StringHash eventType, VariantMap& eventData)
 {
     using namespace UpdateSmoothing;
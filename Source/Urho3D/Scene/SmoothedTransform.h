@@ -40,6 +40,17 @@ enum SmoothingType : unsigned
 };
 URHO3D_FLAGSET(SmoothingType, SmoothingTypeFlags);
 
+/// Timestamped transform snapshot for network interpolation.
+struct TransformSnapshot
+{
+    /// Position in parent space.
+    Vector3 position_;
+    /// Rotation in parent space.
+    Quaternion rotation_;
+    /// Local receive time in seconds.
+    float time_;
+};
+
 /// Transform smoothing component for network updates.
 class URHO3D_API SmoothedTransform : public Component
 {
@@ -63,6 +74,12 @@ public:
     void SetTargetWorldPosition(const Vector3& position);
     /// Set target rotation in world space.
     void SetTargetWorldRotation(const Quaternion& rotation);
+    /// Set whether to use snapshot interpolation instead of exponential smoothing. In this mode received targets are buffered with timestamps and the node is moved along them with a fixed delay, which absorbs network jitter.
+    void SetInterpolationEnabled(bool enable);
+    /// Set the interpolation delay in seconds. Should exceed the expected interval between network updates.
+    void SetInterpolationDelay(float delay);
+    /// Set the maximum time in seconds to extrapolate past the newest snapshot when updates are lost or late.
+    void SetMaxExtrapolationTime(float time);
 
     /// Return target position in parent space.
     const Vector3& GetTargetPosition() const { return targetPosition_; }
@@ -75,6 +92,15 @@ public:
     /// Return target rotation in world space.
     Quaternion GetTargetWorldRotation() const;
 
+    /// Return whether snapshot interpolation is enabled.
+    bool IsInterpolationEnabled() const { return interpolationEnabled_; }
+
+    /// Return the interpolation delay in seconds.
+    float GetInterpolationDelay() const { return interpolationDelay_; }
+
+    /// Return the maximum extrapolation time in seconds.
+    float GetMaxExtrapolationTime() const { return maxExtrapolationTime_; }
+
     /// Return whether smoothing is in progress.
     bool IsInProgress() const { return smoothingMask_ != SMOOTH_NONE; }
 
@@ -85,13 +111,25 @@ protected:
 private:
     /// Handle smoothing update event.
     void HandleUpdateSmoothing(StringHash eventType, VariantMap& eventData);
+    /// Record the current targets into the snapshot buffer.
+    void PushSnapshot();
+    /// Sample the snapshot buffer at render time minus the interpolation delay and apply the result to the node.
+    void UpdateInterpolation(float constant);
 
     /// Target position.
     Vector3 targetPosition_;
     /// Target rotation.
     Quaternion targetRotation_;
+    /// Timestamped snapshot history, oldest first.
+    ea::vector<TransformSnapshot> snapshots_;
+    /// Interpolation delay in seconds.
+    float interpolationDelay_;
+    /// Maximum extrapolation time in seconds.
+    float maxExtrapolationTime_;
     /// Active smoothing operations bitmask.
     SmoothingTypeFlags smoothingMask_;
+    /// Snapshot interpolation enabled flag.
+    bool interpolationEnabled_;
     /// Subscribed to smoothing update event flag.
     bool subscribed_;
 };
@@ -80,7 +80,9 @@ ValueAnimation::ValueAnimation(Context* context) :
     interpolatable_(false),
     beginTime_(M_INFINITY),
     endTime_(-M_INFINITY),
-    splineTangentsDirty_(false)
+    splineTangentsDirty_(false),
+    bakedInvStep_(0.0f),
+    baked_(false)
 {
 }
 
@@ -310,6 +312,7 @@ void ValueAnimation::SetValueType(VariantType valueType)
     eventFrames_.clear();
     beginTime_ = M_INFINITY;
     endTime_ = -M_INFINITY;
+    InvalidateBakedSamples();
 }
 
 void ValueAnimation::SetOwner(void* owner)
@@ -328,12 +331,14 @@ void ValueAnimation::SetInterpolationMethod(InterpMethod method)
 
     interpolationMethod_ = method;
     splineTangentsDirty_ = true;
+    InvalidateBakedSamples();
 }
 
 void ValueAnimation::SetSplineTension(float tension)
 {
     splineTension_ = tension;
     splineTangentsDirty_ = true;
+    InvalidateBakedSamples();
 }
 
 bool ValueAnimation::SetKeyFrame(float time, const Variant& value)
@@ -367,6 +372,7 @@ bool ValueAnimation::SetKeyFrame(float time, const Variant& value)
     beginTime_ = Min(time, beginTime_);
     endTime_ = Max(time, endTime_);
     splineTangentsDirty_ = true;
+    InvalidateBakedSamples();
 
     return true;
 }
@@ -405,6 +411,9 @@ bool ValueAnimation::IsValid() const
 
 Variant ValueAnimation::GetAnimationValue(float scaledTime) const
 {
+    if (baked_)
+        return GetBakedValue(scaledTime);
+
     unsigned index = 1;
     for (; index < keyFrames_.size(); ++index)
     {
@@ -423,6 +432,57 @@ Variant ValueAnimation::GetAnimationValue(float scaledTime) const
     }
 }
 
+void ValueAnimation::GetAnimationValues(ea::span<const float> scaledTimes, ea::span<Variant> values) const
+{
+    const unsigned count = Min((unsigned)scaledTimes.size(), (unsigned)values.size());
+    for (unsigned i = 0; i < count; ++i)
+        values[i] = GetAnimationValue(scaledTimes[i]);
+}
+
+bool ValueAnimation::BakeSamples(float sampleRate)
+{
+    InvalidateBakedSamples();
+
+    if (!IsValid() || interpolationMethod_ == IM_NONE || keyFrames_.empty() || sampleRate <= 0.0f)
+        return false;
+
+    if (valueType_ != VAR_FLOAT && valueType_ != VAR_VECTOR3 && valueType_ != VAR_QUATERNION)
+    {
+        URHO3D_LOGERROR("Can only bake float, Vector3 and Quaternion value animations");
+        return false;
+    }
+
+    const float length = endTime_ - beginTime_;
+    if (length <= 0.0f)
+        return false;
+
+    const unsigned numSamples = Max((unsigned)CeilToInt(length * sampleRate), 1u) + 1;
+    const float step = length / (float)(numSamples - 1);
+
+    for (unsigned i = 0; i < numSamples; ++i)
+    {
+        // The last sample lands exactly on the end time regardless of rounding
+        const float time = i + 1 == numSamples ? endTime_ : beginTime_ + step * (float)i;
+        const Variant value = GetAnimationValue(time);
+        switch (valueType_)
+        {
+        case VAR_FLOAT:
+            bakedFloats_.push_back(value.GetFloat());
+            break;
+        case VAR_VECTOR3:
+            bakedVectors_.push_back(value.GetVector3());
+            break;
+        default:
+            bakedQuaternions_.push_back(value.GetQuaternion());
+            break;
+        }
+    }
+
+    bakedInvStep_ = 1.0f / step;
+    baked_ = true;
+    return true;
+}
+
 void ValueAnimation::GetEventFrames(float beginTime, float endTime, ea::vector<const VAnimEventFrame*>& eventFrames) const
 {
     for (unsigned i = 0; i < eventFrames_.size(); ++i)
@@ -606,4 +666,34 @@ Variant ValueAnimation::SubstractAndMultiply(const Variant& value1, const Varian
     }
 }
 
+Variant ValueAnimation::GetBakedValue(float scaledTime) const
+{
+    const unsigned numSamples = valueType_ == VAR_FLOAT ? bakedFloats_.size() :
+        valueType_ == VAR_VECTOR3 ? bakedVectors_.size() : bakedQuaternions_.size();
+
+    const float pos = Clamp((scaledTime - beginTime_) * bakedInvStep_, 0.0f, (float)(numSamples - 1));
+    const unsigned index = Min((unsigned)pos, numSamples - 2);
+    const float t = pos - (float)index;
+
+    switch (valueType_)
+    {
+    case VAR_FLOAT:
+        return Lerp(bakedFloats_[index], bakedFloats_[index + 1], t);
+    case VAR_VECTOR3:
+        return bakedVectors_[index].Lerp(bakedVectors_[index + 1], t);
+    default:
+        // Adjacent samples are close, so normalized lerp is accurate enough here
+        return bakedQuaternions_[index].Nlerp(bakedQuaternions_[index + 1], t, true);
+    }
+}
+
+void ValueAnimation::InvalidateBakedSamples()
+{
+    bakedFloats_.clear();
+    bakedVectors_.clear();
+    bakedQuaternions_.clear();
+    bakedInvStep_ = 0.0f;
+    baked_ = false;
+}
+
 }
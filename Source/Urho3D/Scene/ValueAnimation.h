@@ -27,6 +27,8 @@
 #include "../Core/Variant.h"
 #include "../Resource/Resource.h"
 
+#include <EASTL/span.h>
+
 namespace Urho3D
 {
 
@@ -134,6 +136,16 @@ public:
 
     /// Return animation value.
     Variant GetAnimationValue(float scaledTime) const;
+    /// Evaluate the animation at several times in one call, e.g. for many instances sharing the clip. Values size must match times size.
+    void GetAnimationValues(ea::span<const float> scaledTimes, ea::span<Variant> values) const;
+
+    /// Bake the animation into uniformly sampled typed tables so that evaluation becomes a single lerp without
+    /// keyframe search or type dispatch. Only float, Vector3 and Quaternion animations with interpolation can be
+    /// baked, and values between samples are approximated. Return true if successful.
+    bool BakeSamples(float sampleRate);
+
+    /// Return whether evaluation uses baked samples.
+    bool IsBaked() const { return baked_; }
 
     /// Return all key frames.
     const ea::vector<VAnimKeyFrame>& GetKeyFrames() const { return keyFrames_; }
@@ -153,6 +165,10 @@ protected:
     void UpdateSplineTangents() const;
     /// Return (value1 - value2) * t.
     Variant SubstractAndMultiply(const Variant& value1, const Variant& value2, float t) const;
+    /// Evaluate the baked sample table.
+    Variant GetBakedValue(float scaledTime) const;
+    /// Discard baked samples after a modification.
+    void InvalidateBakedSamples();
 
     /// Owner.
     void* owner_;
@@ -176,6 +192,16 @@ protected:
     mutable bool splineTangentsDirty_;
     /// Event frames.
     ea::vector<VAnimEventFrame> eventFrames_;
+    /// Baked float samples.
+    ea::vector<float> bakedFloats_;
+    /// Baked Vector3 samples.
+    ea::vector<Vector3> bakedVectors_;
+    /// Baked Quaternion samples.
+    ea::vector<Quaternion> bakedQuaternions_;
+    /// Reciprocal of the baked sample interval.
+    float bakedInvStep_;
+    /// Whether evaluation uses baked samples.
+    bool baked_;
 };
 
 }
@@ -25,6 +25,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameBudget.h"
 #include "../Core/Profiler.h"
 #include "../Engine/Engine.h"
 #include "../Graphics/Graphics.h"
@@ -180,6 +181,24 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
             ui::Text("%s %s", i->first.c_str(), i->second.c_str());
             ui::SetCursorPosX(left_offset);
         }
+
+        if (auto* frameBudget = GetSubsystem<FrameBudget>())
+        {
+            for (const FrameBudgetInfo& counter : frameBudget->GetCounters())
+            {
+                if (counter.budgetMs_ > 0.0f)
+                    ui::Text("%s %.2fms / %.2fms", counter.name_, counter.lastFrameMs_, counter.budgetMs_);
+                else
+                    ui::Text("%s %.2fms", counter.name_, counter.lastFrameMs_);
+                ui::SetCursorPosX(left_offset);
+            }
+        }
+
+        for (const GPUTimingResult& timing : graphics->GetGPUTimings())
+        {
+            ui::Text("GPU %s %.2fms", timing.name_.c_str(), timing.gpuTimeMs_);
+            ui::SetCursorPosX(left_offset);
+        }
     }
 
     if (mode & DEBUGHUD_SHOW_MODE)
@@ -111,6 +111,7 @@ void Button::OnClickBegin(const IntVector2& position, const IntVector2& screenPo
         SetPressed(true);
         repeatTimer_ = repeatDelay_;
         hovering_ = true;
+        MarkBatchesDirty();
 
         using namespace Pressed;
 
@@ -129,6 +130,7 @@ void Button::OnClickEnd(const IntVector2& position, const IntVector2& screenPosi
         // If mouse was released on top of the element, consider it hovering on this frame yet (see issue #1453)
         if (IsInside(screenPosition, true))
             hovering_ = true;
+        MarkBatchesDirty();
 
         using namespace Released;
 
@@ -157,21 +159,25 @@ void Button::OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifiers)
 void Button::SetPressedOffset(const IntVector2& offset)
 {
     pressedOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void Button::SetPressedOffset(int x, int y)
 {
     pressedOffset_ = IntVector2(x, y);
+    MarkBatchesDirty();
 }
 
 void Button::SetPressedChildOffset(const IntVector2& offset)
 {
     pressedChildOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void Button::SetPressedChildOffset(int x, int y)
 {
     pressedChildOffset_ = IntVector2(x, y);
+    MarkBatchesDirty();
 }
 
 void Button::SetRepeat(float delay, float rate)
@@ -194,6 +200,7 @@ void Button::SetPressed(bool enable)
 {
     pressed_ = enable;
     SetChildOffset(pressed_ ? pressedChildOffset_ : IntVector2::ZERO);
+    MarkBatchesDirty();
 }
 
 }
@@ -100,17 +100,21 @@ void CheckBox::SetChecked(bool enable)
         eventData[P_ELEMENT] = this;
         eventData[P_STATE] = checked_;
         SendEvent(E_TOGGLED, eventData);
+
+        MarkBatchesDirty();
     }
 }
 
 void CheckBox::SetCheckedOffset(const IntVector2& offset)
 {
     checkedOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void CheckBox::SetCheckedOffset(int x, int y)
 {
     checkedOffset_ = IntVector2(x, y);
+    MarkBatchesDirty();
 }
 
 }
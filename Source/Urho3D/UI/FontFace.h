@@ -96,6 +96,9 @@ public:
     /// Return textures.
     const ea::vector<SharedPtr<Texture2D> >& GetTextures() const { return textures_; }
 
+    /// Return the glyph version number. Incremented whenever glyphs change their texture page assignment, so that text elements know to refresh their glyph locations.
+    unsigned GetGlyphVersion() const { return glyphVersion_; }
+
 protected:
     friend class FontFaceBitmap;
     /// Create a texture for font rendering.
@@ -115,6 +118,8 @@ protected:
     float pointSize_{};
     /// Row height.
     float rowHeight_{};
+    /// Glyph version number.
+    unsigned glyphVersion_{};
 };
 
 }
@@ -29,6 +29,7 @@
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Math/SkylinePacker.h"
 #include "../Resource/ResourceCache.h"
 #include "../UI/Font.h"
 #include "../UI/FontFaceBitmap.h"
@@ -187,7 +188,7 @@ bool FontFaceBitmap::Load(FontFace* fontFace, bool usedGlyphs)
 
     unsigned numPages = 1;
     int maxTextureSize = font_->GetSubsystem<UI>()->GetMaxFontTextureSize();
-    AreaAllocator allocator(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, maxTextureSize, maxTextureSize);
+    SkylinePacker allocator(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, maxTextureSize, maxTextureSize);
 
     for (auto i = fontFace->glyphMapping_.begin(); i !=
         fontFace->glyphMapping_.end(); ++i)
@@ -201,7 +202,7 @@ bool FontFaceBitmap::Load(FontFace* fontFace, bool usedGlyphs)
         {
             ++numPages;
 
-            allocator = AreaAllocator(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, maxTextureSize, maxTextureSize);
+            allocator = SkylinePacker(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, maxTextureSize, maxTextureSize);
             if (!allocator.Allocate(fontGlyph.width_ + 1, fontGlyph.height_ + 1, x, y))
                 return false;
         }
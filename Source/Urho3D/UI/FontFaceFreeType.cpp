@@ -23,6 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Texture2D.h"
 #include "../IO/FileSystem.h"
@@ -31,6 +35,7 @@
 #include "../UI/Font.h"
 #include "../UI/FontFaceFreeType.h"
 #include "../UI/UI.h"
+#include "../UI/UIEvents.h"
 
 #include <cassert>
 
@@ -48,6 +53,9 @@ inline float FixedToFloat(FT_Pos value)
     return value / 64.0f;
 }
 
+/// Maximum number of glyph texture pages per dynamic face before the least recently used page is recycled.
+static const unsigned MAX_FONT_TEXTURE_PAGES = 4;
+
 /// FreeType library subsystem.
 class FreeTypeLibrary : public Object
 {
@@ -61,6 +69,8 @@ public:
         FT_Error error = FT_Init_FreeType(&library_);
         if (error)
             URHO3D_LOGERROR("Could not initialize FreeType library");
+
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(FreeTypeLibrary, HandleBeginFrame));
     }
 
     /// Destruct.
@@ -71,9 +81,35 @@ public:
 
     FT_Library GetLibrary() const { return library_; }
 
+    /// Register a dynamic font face for once per frame background glyph commits.
+    void AddDynamicFace(FontFaceFreeType* face) { dynamicFaces_.push_back(face); }
+
+    /// Remove a dynamic font face.
+    void RemoveDynamicFace(FontFaceFreeType* face)
+    {
+        auto i = dynamicFaces_.find(face);
+        if (i != dynamicFaces_.end())
+            dynamicFaces_.erase(i);
+    }
+
+    /// Return the running frame number used for LRU texture page tracking.
+    unsigned GetFrameNumber() const { return frameNumber_; }
+
 private:
+    /// Commit the background rasterized glyphs of the registered faces once per frame.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+    {
+        ++frameNumber_;
+        for (FontFaceFreeType* face : dynamicFaces_)
+            face->CommitBackgroundGlyphs();
+    }
+
     /// FreeType library.
     FT_Library library_{};
+    /// Dynamic font faces using background glyph rasterization.
+    ea::vector<FontFaceFreeType*> dynamicFaces_;
+    /// Frame counter.
+    unsigned frameNumber_{1};
 };
 
 FontFaceFreeType::FontFaceFreeType(Font* font) :
@@ -84,6 +120,20 @@ FontFaceFreeType::FontFaceFreeType(Font* font) :
 
 FontFaceFreeType::~FontFaceFreeType()
 {
+    if (freeType_)
+        freeType_->RemoveDynamicFace(this);
+
+    // Make sure the work queue is no longer rasterizing with this face
+    if (rasterizeWorkItem_ && !rasterizeWorkItem_->completed_)
+    {
+        auto* queue = font_->GetSubsystem<WorkQueue>();
+        if (!queue || !queue->RemoveWorkItem(rasterizeWorkItem_))
+        {
+            while (!rasterizeWorkItem_->completed_)
+                Time::Sleep(0);
+        }
+    }
+
     if (face_)
     {
         FT_Done_Face((FT_Face)face_);
@@ -301,6 +351,15 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
         FT_Done_Face(face);
         face_ = nullptr;
     }
+    else
+    {
+        // Keep the page image on the CPU side for batching uploads of dynamically rasterized glyphs,
+        // and register for once per frame commits of background rasterized glyphs
+        currentPageImage_ = image;
+        currentPage_ = 0;
+        pageLastUsed_.push_back(freeType->GetFrameNumber());
+        freeType->AddDynamicFace(this);
+    }
 
     return true;
 }
@@ -312,11 +371,52 @@ const FontGlyph* FontFaceFreeType::GetGlyph(unsigned c)
     {
         FontGlyph& glyph = i->second;
         glyph.used_ = true;
+        if (glyph.page_ < pageLastUsed_.size())
+            pageLastUsed_[glyph.page_] = freeType_->GetFrameNumber();
+        else if (glyph.page_ == M_MAX_UNSIGNED && face_)
+        {
+            // Evicted or still waiting for the rasterizer; duplicates are filtered by the queued set
+            QueueGlyph(c);
+        }
+        return &glyph;
+    }
+
+    if (!face_)
+        return nullptr;
+
+    auto* queue = font_->GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads())
+    {
+        // Load only the metrics now so that text layout can proceed; the bitmap is rasterized in the
+        // background and the glyph becomes visible once committed onto a texture page
+        FontGlyph fontGlyph;
+        {
+            MutexLock lock(faceMutex_);
+            auto face = (FT_Face)face_;
+            FT_Error error = FT_Load_Char(face, c, loadMode_);
+            if (error)
+            {
+                const char* family = face->family_name ? face->family_name : "NULL";
+                URHO3D_LOGERRORF("FT_Load_Char failed (family: %s, char code: %u)", family, c);
+            }
+            else
+                FillGlyphMetrics(face->glyph, fontGlyph, false);
+        }
+
+        FontGlyph& glyph = glyphMapping_[c] = fontGlyph;
+        glyph.used_ = true;
+        if (glyph.texWidth_ > 0 && glyph.texHeight_ > 0)
+            QueueGlyph(c);
+        else
+            glyph.page_ = 0;
         return &glyph;
     }
 
+    // Without worker threads rasterize and upload immediately as before
     if (LoadCharGlyph(c))
     {
+        FlushDirtyRegion();
+
         auto i = glyphMapping_.find(c);
         if (i != glyphMapping_.end())
         {
@@ -329,8 +429,139 @@ const FontGlyph* FontFaceFreeType::GetGlyph(unsigned c)
     return nullptr;
 }
 
+void FontFaceFreeType::QueueGlyph(unsigned charCode)
+{
+    if (queuedGlyphs_.contains(charCode))
+        return;
+    queuedGlyphs_.insert(charCode);
+
+    {
+        MutexLock lock(glyphQueueMutex_);
+        pendingGlyphs_.push_back(charCode);
+    }
+
+    auto* queue = font_->GetSubsystem<WorkQueue>();
+    if (queue && (!rasterizeWorkItem_ || rasterizeWorkItem_->completed_))
+        rasterizeWorkItem_ = queue->AddWorkItem([this]() { RasterizeQueuedGlyphs(); });
+}
+
+void FontFaceFreeType::RasterizeQueuedGlyphs()
+{
+    for (;;)
+    {
+        unsigned charCode;
+        {
+            MutexLock lock(glyphQueueMutex_);
+            if (pendingGlyphs_.empty())
+                return;
+            charCode = pendingGlyphs_.front();
+            pendingGlyphs_.erase(pendingGlyphs_.begin());
+        }
+
+        RasterizedGlyph result;
+        result.charCode_ = charCode;
+
+        {
+            MutexLock lock(faceMutex_);
+            auto face = (FT_Face)face_;
+            FT_GlyphSlot slot = face->glyph;
+            FT_Error error = FT_Load_Char(face, charCode, loadMode_ | FT_LOAD_RENDER);
+            if (error)
+            {
+                const char* family = face->family_name ? face->family_name : "NULL";
+                URHO3D_LOGERRORF("FT_Load_Char failed (family: %s, char code: %u)", family, charCode);
+            }
+            else
+            {
+                FillGlyphMetrics(slot, result.glyph_, true);
+                if (result.glyph_.texWidth_ > 0 && result.glyph_.texHeight_ > 0)
+                {
+                    result.bitmap_.resize((unsigned)(result.glyph_.texWidth_ * result.glyph_.texHeight_));
+                    CopyGlyphBitmap(slot, result.glyph_, result.bitmap_.data(), (unsigned)result.glyph_.texWidth_);
+                }
+            }
+        }
+
+        // Push also failed and empty glyphs, so that the final (possibly zero size) data replaces the estimated metrics
+        MutexLock lock(glyphQueueMutex_);
+        rasterizedGlyphs_.push_back(ea::move(result));
+    }
+}
+
+void FontFaceFreeType::CommitBackgroundGlyphs()
+{
+    ea::vector<RasterizedGlyph> results;
+    bool pendingRemaining;
+    {
+        MutexLock lock(glyphQueueMutex_);
+        ea::swap(results, rasterizedGlyphs_);
+        pendingRemaining = !pendingGlyphs_.empty();
+    }
+
+    // Re-post the work item in case characters were queued just as the previous item was finishing
+    if (pendingRemaining && (!rasterizeWorkItem_ || rasterizeWorkItem_->completed_))
+    {
+        auto* queue = font_->GetSubsystem<WorkQueue>();
+        if (queue)
+            rasterizeWorkItem_ = queue->AddWorkItem([this]() { RasterizeQueuedGlyphs(); });
+    }
+
+    if (results.empty())
+        return;
+
+    URHO3D_PROFILE("CommitFontGlyphs");
+
+    for (RasterizedGlyph& result : results)
+    {
+        queuedGlyphs_.erase(result.charCode_);
+
+        auto i = glyphMapping_.find(result.charCode_);
+        if (i == glyphMapping_.end())
+            continue;
+
+        FontGlyph& glyph = result.glyph_;
+        int x = 0, y = 0;
+        if (glyph.texWidth_ > 0 && glyph.texHeight_ > 0 && AllocateGlyphArea(glyph, x, y))
+        {
+            glyph.x_ = (short)x;
+            glyph.y_ = (short)y;
+            glyph.page_ = currentPage_;
+
+            // Write into the CPU side page image; the dirty region is uploaded below in one batch
+            const int imageWidth = currentPageImage_->GetWidth();
+            unsigned char* dest = currentPageImage_->GetData() + y * imageWidth + x;
+            for (int row = 0; row < glyph.texHeight_; ++row)
+                memcpy(dest + row * imageWidth, &result.bitmap_[row * glyph.texWidth_], (size_t)glyph.texWidth_);
+
+            MarkPageDirty(IntRect(x, y, x + glyph.texWidth_, y + glyph.texHeight_));
+        }
+        else
+        {
+            glyph.x_ = 0;
+            glyph.y_ = 0;
+            glyph.page_ = 0;
+        }
+
+        glyph.used_ = i->second.used_;
+        i->second = glyph;
+    }
+
+    FlushDirtyRegion();
+    NotifyGlyphsUpdated();
+}
+
 bool FontFaceFreeType::SetupNextTexture(int textureWidth, int textureHeight)
 {
+    // Upload what is left of the current page before switching away from it
+    FlushDirtyRegion();
+
+    // At the page limit, recycle the least recently used page instead of growing further
+    if (currentPageImage_ && textures_.size() >= MAX_FONT_TEXTURE_PAGES)
+    {
+        currentPage_ = EvictLRUPage();
+        return true;
+    }
+
     SharedPtr<Image> image(font_->GetContext()->CreateObject<Image>());
     image->SetSize(textureWidth, textureHeight, 1);
     unsigned char* imageData = image->GetData();
@@ -345,9 +576,92 @@ bool FontFaceFreeType::SetupNextTexture(int textureWidth, int textureHeight)
 
     font_->SetMemoryUse(font_->GetMemoryUse() + textureWidth * textureHeight);
 
+    if (currentPageImage_)
+    {
+        currentPageImage_ = image;
+        currentPage_ = textures_.size() - 1;
+        pageLastUsed_.push_back(freeType_->GetFrameNumber());
+    }
+
     return true;
 }
 
+unsigned FontFaceFreeType::EvictLRUPage()
+{
+    unsigned lruPage = currentPage_ == 0 ? 1 : 0;
+    for (unsigned i = 0; i < textures_.size(); ++i)
+    {
+        if (i != currentPage_ && pageLastUsed_[i] < pageLastUsed_[lruPage])
+            lruPage = i;
+    }
+
+    // Invalidate the glyphs resident on the evicted page. Their metrics stay valid and the entries stay in place,
+    // as text elements may still hold pointers to them; the bitmaps are re-rasterized on demand
+    unsigned numEvicted = 0;
+    for (auto i = glyphMapping_.begin(); i != glyphMapping_.end(); ++i)
+    {
+        if (i->second.page_ == lruPage)
+        {
+            i->second.page_ = M_MAX_UNSIGNED;
+            ++numEvicted;
+        }
+    }
+
+    URHO3D_LOGDEBUGF("Font face %s (%.1fpt) recycled glyph texture page %u containing %u glyphs",
+        GetFileName(font_->GetName()).c_str(), pointSize_, lruPage, numEvicted);
+
+    // Reuse the texture slot in place so that the page indices of the remaining glyphs stay stable
+    memset(currentPageImage_->GetData(), 0, (size_t)currentPageImage_->GetWidth() * currentPageImage_->GetHeight());
+    allocator_.Reset(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, currentPageImage_->GetWidth(), currentPageImage_->GetHeight());
+    pageLastUsed_[lruPage] = freeType_->GetFrameNumber();
+
+    NotifyGlyphsUpdated();
+    return lruPage;
+}
+
+void FontFaceFreeType::MarkPageDirty(const IntRect& area)
+{
+    if (dirtyRegion_.right_ <= dirtyRegion_.left_ || dirtyRegion_.bottom_ <= dirtyRegion_.top_)
+        dirtyRegion_ = area;
+    else
+    {
+        dirtyRegion_.left_ = Min(dirtyRegion_.left_, area.left_);
+        dirtyRegion_.top_ = Min(dirtyRegion_.top_, area.top_);
+        dirtyRegion_.right_ = Max(dirtyRegion_.right_, area.right_);
+        dirtyRegion_.bottom_ = Max(dirtyRegion_.bottom_, area.bottom_);
+    }
+}
+
+void FontFaceFreeType::FlushDirtyRegion()
+{
+    if (!currentPageImage_ || dirtyRegion_.right_ <= dirtyRegion_.left_ || dirtyRegion_.bottom_ <= dirtyRegion_.top_)
+        return;
+
+    const int width = dirtyRegion_.Width();
+    const int height = dirtyRegion_.Height();
+    const int imageWidth = currentPageImage_->GetWidth();
+
+    // SetData expects tightly packed data; copy the region rows out of the page image
+    ea::vector<unsigned char> buffer((unsigned)(width * height));
+    const unsigned char* src = currentPageImage_->GetData() + dirtyRegion_.top_ * imageWidth + dirtyRegion_.left_;
+    for (int row = 0; row < height; ++row)
+        memcpy(&buffer[row * width], src + row * imageWidth, (size_t)width);
+
+    textures_[currentPage_]->SetData(0, dirtyRegion_.left_, dirtyRegion_.top_, width, height, buffer.data());
+    dirtyRegion_ = IntRect::ZERO;
+}
+
+void FontFaceFreeType::NotifyGlyphsUpdated()
+{
+    ++glyphVersion_;
+
+    using namespace FontGlyphsUpdated;
+
+    VariantMap& eventData = font_->GetEventDataMap();
+    eventData[P_FONT] = font_;
+    font_->SendEvent(E_FONTGLYPHSUPDATED, eventData);
+}
+
 void FontFaceFreeType::BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize)
 {
     const int filterSize = oversampling_;
@@ -412,6 +726,9 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
     if (!face_)
         return false;
 
+    // Serialize FreeType access against the background rasterizer, which shares the glyph slot of the face
+    MutexLock lock(faceMutex_);
+
     auto face = (FT_Face)face_;
     FT_GlyphSlot slot = face->glyph;
 
@@ -428,104 +745,36 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
         fontGlyph.offsetX_ = 0;
         fontGlyph.offsetY_ = 0;
         fontGlyph.advanceX_ = 0;
-        fontGlyph.page_ = 0;
     }
     else
-    {
-        // Note: position within texture will be filled later
-        fontGlyph.texWidth_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.texHeight_ = slot->bitmap.rows;
-        fontGlyph.width_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.height_ = slot->bitmap.rows;
-        fontGlyph.offsetX_ = slot->bitmap_left - (oversampling_ - 1) / 2.0f;
-        fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - slot->bitmap_top;
-
-        if (subpixel_ && slot->linearHoriAdvance)
-        {
-            // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
-            fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
-        }
-        else
-        {
-            // Round to nearest pixel (only necessary when hinting is disabled)
-            fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
-        }
-
-        fontGlyph.width_ /= oversampling_;
-        fontGlyph.offsetX_ /= oversampling_;
-        fontGlyph.advanceX_ /= oversampling_;
-    }
+        FillGlyphMetrics(slot, fontGlyph, true);
 
     int x = 0, y = 0;
     if (fontGlyph.texWidth_ > 0 && fontGlyph.texHeight_ > 0)
     {
-        if (!allocator_.Allocate(fontGlyph.texWidth_ + 1, fontGlyph.texHeight_ + 1, x, y))
+        if (image)
         {
-            if (image)
-            {
-                // We're rendering into a fixed image and we ran out of room.
-                return false;
-            }
-
-            int w = allocator_.GetWidth();
-            int h = allocator_.GetHeight();
-            if (!SetupNextTexture(w, h))
-            {
-                URHO3D_LOGWARNINGF("FontFaceFreeType::LoadCharGlyph: failed to allocate new %dx%d texture", w, h);
-                return false;
-            }
-
+            // We're rendering into a fixed image; failing to fit means it ran out of room
             if (!allocator_.Allocate(fontGlyph.texWidth_ + 1, fontGlyph.texHeight_ + 1, x, y))
-            {
-                URHO3D_LOGWARNINGF("FontFaceFreeType::LoadCharGlyph: failed to position char code %u in blank page", charCode);
                 return false;
-            }
         }
+        else if (!AllocateGlyphArea(fontGlyph, x, y))
+            return false;
 
         fontGlyph.x_ = (short)x;
         fontGlyph.y_ = (short)y;
 
-        unsigned char* dest = nullptr;
-        unsigned pitch = 0;
         if (image)
         {
             fontGlyph.page_ = 0;
-            dest = image->GetData() + fontGlyph.y_ * image->GetWidth() + fontGlyph.x_;
-            pitch = (unsigned)image->GetWidth();
+            CopyGlyphBitmap(slot, fontGlyph, image->GetData() + y * image->GetWidth() + x, (unsigned)image->GetWidth());
         }
         else
         {
-            fontGlyph.page_ = textures_.size() - 1;
-            dest = new unsigned char[fontGlyph.texWidth_ * fontGlyph.texHeight_];
-            pitch = (unsigned)fontGlyph.texWidth_;
-        }
-
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
-        {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
-            {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
-
-                // Don't do any oversampling, just unpack the bits directly.
-                for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
-                    rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
-            }
-        }
-        else
-        {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
-            {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + y * pitch;
-                BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
-            }
-        }
-
-        if (!image)
-        {
-            textures_.back()->SetData(0, fontGlyph.x_, fontGlyph.y_, fontGlyph.texWidth_, fontGlyph.texHeight_, dest);
-            delete[] dest;
+            fontGlyph.page_ = currentPage_;
+            CopyGlyphBitmap(slot, fontGlyph,
+                currentPageImage_->GetData() + y * currentPageImage_->GetWidth() + x, (unsigned)currentPageImage_->GetWidth());
+            MarkPageDirty(IntRect(x, y, x + fontGlyph.texWidth_, y + fontGlyph.texHeight_));
         }
     }
     else
@@ -540,4 +789,87 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
     return true;
 }
 
+bool FontFaceFreeType::AllocateGlyphArea(FontGlyph& fontGlyph, int& x, int& y)
+{
+    if (allocator_.Allocate(fontGlyph.texWidth_ + 1, fontGlyph.texHeight_ + 1, x, y))
+        return true;
+
+    int w = allocator_.GetWidth();
+    int h = allocator_.GetHeight();
+    if (!SetupNextTexture(w, h))
+    {
+        URHO3D_LOGWARNINGF("FontFaceFreeType::AllocateGlyphArea: failed to allocate new %dx%d texture", w, h);
+        return false;
+    }
+
+    if (!allocator_.Allocate(fontGlyph.texWidth_ + 1, fontGlyph.texHeight_ + 1, x, y))
+    {
+        URHO3D_LOGWARNINGF("FontFaceFreeType::AllocateGlyphArea: failed to position glyph in blank page");
+        return false;
+    }
+
+    return true;
+}
+
+void FontFaceFreeType::FillGlyphMetrics(void* slotPtr, FontGlyph& fontGlyph, bool rendered) const
+{
+    auto slot = (FT_GlyphSlot)slotPtr;
+
+    // When the glyph has not been rendered yet, estimate the bitmap extents from the outline metrics;
+    // the exact values replace them once the rendered glyph is committed
+    const int bitmapWidth = rendered ? (int)slot->bitmap.width : (int)(slot->metrics.width >> 6);
+    const int bitmapRows = rendered ? (int)slot->bitmap.rows : (int)(slot->metrics.height >> 6);
+    const float bitmapLeft = rendered ? (float)slot->bitmap_left : FixedToFloat(slot->metrics.horiBearingX);
+    const float bitmapTop = rendered ? (float)slot->bitmap_top : FixedToFloat(slot->metrics.horiBearingY);
+
+    // Note: position within texture will be filled later
+    fontGlyph.texWidth_ = bitmapWidth + oversampling_ - 1;
+    fontGlyph.texHeight_ = bitmapRows;
+    fontGlyph.width_ = bitmapWidth + oversampling_ - 1;
+    fontGlyph.height_ = bitmapRows;
+    fontGlyph.offsetX_ = bitmapLeft - (oversampling_ - 1) / 2.0f;
+    fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - bitmapTop;
+
+    if (subpixel_ && slot->linearHoriAdvance)
+    {
+        // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
+        fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
+    }
+    else
+    {
+        // Round to nearest pixel (only necessary when hinting is disabled)
+        fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
+    }
+
+    fontGlyph.width_ /= oversampling_;
+    fontGlyph.offsetX_ /= oversampling_;
+    fontGlyph.advanceX_ /= oversampling_;
+}
+
+void FontFaceFreeType::CopyGlyphBitmap(void* slotPtr, const FontGlyph& fontGlyph, unsigned char* dest, unsigned pitch)
+{
+    auto slot = (FT_GlyphSlot)slotPtr;
+
+    if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+    {
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
+        {
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
+
+            // Don't do any oversampling, just unpack the bits directly.
+            for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
+                rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
+        }
+    }
+    else
+    {
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
+        {
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + y * pitch;
+            BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
+        }
+    }
+}
 }
@@ -22,6 +22,10 @@
 
 #pragma once
 
+#include <EASTL/hash_set.h>
+
+#include "../Core/Mutex.h"
+#include "../Math/SkylinePacker.h"
 #include "../UI/FontFace.h"
 
 namespace Urho3D
@@ -29,6 +33,7 @@ namespace Urho3D
 
 class FreeTypeLibrary;
 class Texture2D;
+struct WorkItem;
 
 /// Free type font face description.
 class URHO3D_API FontFaceFreeType : public FontFace
@@ -47,13 +52,45 @@ public:
     /// Return if font face uses mutable glyphs.
     bool HasMutableGlyphs() const override { return hasMutableGlyph_; }
 
+    /// Place the glyphs rasterized on the worker thread onto texture pages and upload them in one batch. Called by FreeTypeLibrary once per frame.
+    void CommitBackgroundGlyphs();
+
 private:
-    /// Setup next texture.
+    /// Glyph rasterized on the worker thread, waiting to be placed on a texture page.
+    struct RasterizedGlyph
+    {
+        /// Character code.
+        unsigned charCode_{};
+        /// Glyph description with final metrics. Texture position and page are filled at commit.
+        FontGlyph glyph_;
+        /// Rasterized glyph image, texWidth_ * texHeight_ bytes.
+        ea::vector<unsigned char> bitmap_;
+    };
+
+    /// Setup next texture. Evicts the least recently used page instead when the page limit has been reached.
     bool SetupNextTexture(int textureWidth, int textureHeight);
     /// Load char glyph.
     bool LoadCharGlyph(unsigned charCode, Image* image = nullptr);
     /// Smooth one row of a horizontally oversampled glyph image.
     void BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize);
+    /// Fill glyph metrics from the glyph slot of the most recent FT_Load_Char. When the glyph has not been rendered, sizes and offsets are estimates that are replaced with exact values at commit.
+    void FillGlyphMetrics(void* slotPtr, FontGlyph& fontGlyph, bool rendered) const;
+    /// Unpack or box filter the rendered glyph slot bitmap into a destination buffer with the given pitch.
+    void CopyGlyphBitmap(void* slotPtr, const FontGlyph& fontGlyph, unsigned char* dest, unsigned pitch);
+    /// Queue a character for background rasterization and post the rasterization work item if one is not pending.
+    void QueueGlyph(unsigned charCode);
+    /// Rasterize queued characters. Called from the work queue, possibly on a worker thread.
+    void RasterizeQueuedGlyphs();
+    /// Allocate an atlas area for a glyph, setting up or recycling a texture page if the current one is full.
+    bool AllocateGlyphArea(FontGlyph& fontGlyph, int& x, int& y);
+    /// Reset the page glyphs of the least recently used texture page and make it the current page again. Return the page index.
+    unsigned EvictLRUPage();
+    /// Merge an area of the current page image into the dirty region.
+    void MarkPageDirty(const IntRect& area);
+    /// Upload the dirty region of the current page image to the page texture.
+    void FlushDirtyRegion();
+    /// Increment the glyph version and notify listeners, e.g. so that UI knows to refresh cached text batches.
+    void NotifyGlyphsUpdated();
 
     /// FreeType library.
     SharedPtr<FreeTypeLibrary> freeType_;
@@ -70,7 +107,27 @@ private:
     /// Has mutable glyph.
     bool hasMutableGlyph_{};
     /// Glyph area allocator.
-    AreaAllocator allocator_;
+    SkylinePacker allocator_;
+    /// CPU side image of the current texture page. Used in dynamic mode for batching glyph uploads.
+    SharedPtr<Image> currentPageImage_;
+    /// Index of the texture page new glyphs are placed on.
+    unsigned currentPage_{};
+    /// Not yet uploaded region of the current page image.
+    IntRect dirtyRegion_{IntRect::ZERO};
+    /// Frame number each texture page was last used on, for LRU eviction.
+    ea::vector<unsigned> pageLastUsed_;
+    /// Characters queued for rasterization or already rasterized but not committed yet.
+    ea::hash_set<unsigned> queuedGlyphs_;
+    /// Characters waiting for the worker thread. Guarded by glyphQueueMutex_.
+    ea::vector<unsigned> pendingGlyphs_;
+    /// Finished worker thread results. Guarded by glyphQueueMutex_.
+    ea::vector<RasterizedGlyph> rasterizedGlyphs_;
+    /// Mutex for the rasterization queues.
+    Mutex glyphQueueMutex_;
+    /// Mutex serializing access to the FreeType face between the main thread and the worker.
+    Mutex faceMutex_;
+    /// Current rasterization work item.
+    SharedPtr<WorkItem> rasterizeWorkItem_;
 };
 
 }
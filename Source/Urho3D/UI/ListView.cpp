@@ -181,7 +181,12 @@ ListView::ListView(Context* context) :
     hierarchyMode_(true),    // Init to true here so that the setter below takes effect
     baseIndent_(0),
     clearSelectionOnDefocus_(false),
-    selectOnClickEnd_(false)
+    selectOnClickEnd_(false),
+    virtualized_(false),
+    virtualItemCount_(0),
+    virtualItemHeight_(1),
+    virtualMargin_(2),
+    virtualFirst_(0)
 {
     resizeContentWidth_ = true;
 
@@ -267,6 +272,13 @@ void ListView::OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifier
 
         case KEY_PAGEDOWN:
             {
+                // In virtualized mode all rows share the same fixed height, so the conversion is a straight division
+                if (virtualized_)
+                {
+                    delta = pageDirection * Max(((int)(pageStep_ * scrollPanel_->GetHeight())) / virtualItemHeight_, 1);
+                    break;
+                }
+
                 // Convert page step to pixels and see how many items have to be skipped to reach that many pixels
                 if (selection == M_MAX_UNSIGNED)
                     selection = 0;      // Assume as if first item is selected
@@ -329,6 +341,10 @@ void ListView::OnResize(const IntVector2& newSize, const IntVector2& delta)
     // When in hierarchy mode also need to resize the overlay container
     if (hierarchyMode_)
         overlayContainer_->SetSize(scrollPanel_->GetSize());
+
+    // When virtualized the visible index range may have changed
+    if (virtualized_)
+        UpdateVirtualItems();
 }
 
 void ListView::UpdateInternalLayout()
@@ -362,6 +378,12 @@ void ListView::InsertItem(unsigned index, UIElement* item, UIElement* parentItem
     if (!item || item->GetParent() == contentElement_)
         return;
 
+    if (virtualized_)
+    {
+        URHO3D_LOGWARNING("Can not insert items while in virtualized mode, modify the item provider's data instead");
+        return;
+    }
+
     // Enable input so that clicking the item can be detected
     item->SetEnabled(true);
     item->SetSelected(false);
@@ -427,6 +449,12 @@ void ListView::RemoveItem(UIElement* item, unsigned index)
     if (!item)
         return;
 
+    if (virtualized_)
+    {
+        URHO3D_LOGWARNING("Can not remove items while in virtualized mode, modify the item provider's data instead");
+        return;
+    }
+
     unsigned numItems = GetNumItems();
     for (unsigned i = index; i < numItems; ++i)
     {
@@ -505,6 +533,12 @@ void ListView::RemoveItem(unsigned index)
 
 void ListView::RemoveAllItems()
 {
+    if (virtualized_)
+    {
+        SetVirtualItemCount(0);
+        return;
+    }
+
     contentElement_->DisableLayoutUpdate();
 
     ClearSelection();
@@ -690,7 +724,8 @@ void ListView::ChangeSelection(int delta, bool additive)
             break;
 
         UIElement* item = GetItem(newSelection);
-        if (item->IsVisible())
+        // In virtualized mode off-screen rows are not materialized as elements, but are always selectable
+        if (!item || item->IsVisible())
         {
             indices.push_back(okSelection = newSelection);
             delta -= direction;
@@ -724,6 +759,12 @@ void ListView::SetHierarchyMode(bool enable)
     if (enable == hierarchyMode_)
         return;
 
+    if (enable && virtualized_)
+    {
+        URHO3D_LOGWARNING("Hierarchy mode is not available while in virtualized mode");
+        return;
+    }
+
     hierarchyMode_ = enable;
     SharedPtr<UIElement> container;
     if (enable)
@@ -781,6 +822,98 @@ void ListView::SetSelectOnClickEnd(bool enable)
     }
 }
 
+void ListView::SetVirtualItemProvider(unsigned itemCount, int itemHeight, const VirtualItemProvider& provider)
+{
+    if (!provider)
+    {
+        // Return to normal mode
+        if (virtualized_)
+        {
+            ClearSelection();
+            contentElement_->RemoveAllChildren();
+            virtualItems_.clear();
+            recycledItems_.clear();
+            virtualItemProvider_ = nullptr;
+            virtualItemCount_ = 0;
+            virtualFirst_ = 0;
+            virtualized_ = false;
+            contentElement_->SetLayout(LM_VERTICAL);
+            UnsubscribeFromEvent(this, E_VIEWCHANGED);
+        }
+        return;
+    }
+
+    if (hierarchyMode_)
+    {
+        URHO3D_LOGWARNING("Virtualized mode is not available in hierarchy mode");
+        return;
+    }
+
+    if (itemHeight < 1)
+    {
+        URHO3D_LOGERROR("Virtualized mode requires a fixed item height of at least one pixel");
+        return;
+    }
+
+    if (!virtualized_)
+    {
+        // Existing items can not be kept, as the provider now owns the item data. Rows are positioned manually
+        RemoveAllItems();
+        contentElement_->SetLayout(LM_FREE);
+        SubscribeToEvent(this, E_VIEWCHANGED, URHO3D_HANDLER(ListView, HandleViewChanged));
+        virtualized_ = true;
+    }
+    else
+    {
+        // Rebuild the window from scratch with the new provider
+        ClearSelection();
+        contentElement_->RemoveAllChildren();
+        virtualItems_.clear();
+        recycledItems_.clear();
+        virtualFirst_ = 0;
+    }
+
+    virtualItemProvider_ = provider;
+    virtualItemCount_ = itemCount;
+    virtualItemHeight_ = itemHeight;
+
+    contentElement_->SetFixedHeight((int)virtualItemCount_ * virtualItemHeight_);
+    UpdateVirtualItems(true);
+}
+
+void ListView::SetVirtualItemCount(unsigned count)
+{
+    if (!virtualized_ || count == virtualItemCount_)
+        return;
+
+    virtualItemCount_ = count;
+
+    // Drop selections that are past the new end of the list
+    ea::vector<unsigned> newSelections;
+    for (auto i = selections_.begin(); i != selections_.end(); ++i)
+    {
+        if (*i < count)
+            newSelections.push_back(*i);
+    }
+    if (newSelections.size() != selections_.size())
+        SetSelections(newSelections);
+
+    contentElement_->SetFixedHeight((int)virtualItemCount_ * virtualItemHeight_);
+    UpdateVirtualItems(true);
+}
+
+void ListView::SetVirtualMargin(unsigned numRows)
+{
+    virtualMargin_ = numRows;
+    if (virtualized_)
+        UpdateVirtualItems();
+}
+
+void ListView::RefreshVirtualItems()
+{
+    UpdateVirtualItems(true);
+}
+
 void ListView::Expand(unsigned index, bool enable, bool recursive)
 {
     if (!hierarchyMode_)
@@ -838,17 +971,34 @@ void ListView::ToggleExpand(unsigned index, bool recursive)
 
 unsigned ListView::GetNumItems() const
 {
-    return contentElement_->GetNumChildren();
+    return virtualized_ ? virtualItemCount_ : contentElement_->GetNumChildren();
 }
 
 UIElement* ListView::GetItem(unsigned index) const
 {
+    // In virtualized mode only rows within the materialized window have elements
+    if (virtualized_)
+        return index >= virtualFirst_ && index - virtualFirst_ < virtualItems_.size() ? virtualItems_[index - virtualFirst_] :
+            nullptr;
+
     return contentElement_->GetChild(index);
 }
 
 ea::vector<UIElement*> ListView::GetItems() const
 {
     ea::vector<UIElement*> items;
+
+    // In virtualized mode only the materialized rows exist as elements
+    if (virtualized_)
+    {
+        for (auto i = virtualItems_.begin(); i != virtualItems_.end(); ++i)
+        {
+            if (*i)
+                items.push_back(*i);
+        }
+        return items;
+    }
+
     contentElement_->GetChildren(items);
     return items;
 }
@@ -862,6 +1012,17 @@ unsigned ListView::FindItem(UIElement* item) const
     if (item->GetParent() != contentElement_)
         return M_MAX_UNSIGNED;
 
+    // In virtualized mode search the materialized window, which holds the actual item indices
+    if (virtualized_)
+    {
+        for (unsigned i = 0; i < virtualItems_.size(); ++i)
+        {
+            if (virtualItems_[i] == item)
+                return virtualFirst_ + i;
+        }
+        return M_MAX_UNSIGNED;
+    }
+
     const ea::vector<SharedPtr<UIElement> >& children = contentElement_->GetChildren();
 
     // Binary search for list item based on screen coordinate Y
@@ -902,7 +1063,7 @@ unsigned ListView::GetSelection() const
 
 UIElement* ListView::GetSelectedItem() const
 {
-    return contentElement_->GetChild(GetSelection());
+    return GetItem(GetSelection());
 }
 
 ea::vector<UIElement*> ListView::GetSelectedItems() const
@@ -989,9 +1150,22 @@ bool ListView::FilterImplicitAttributes(XMLElement& dest) const
 
 void ListView::UpdateSelectionEffect()
 {
-    unsigned numItems = GetNumItems();
     bool highlighted = highlightMode_ == HM_ALWAYS || HasFocus();
 
+    // In virtualized mode only the materialized rows need updating; off-screen rows get their state applied when bound
+    if (virtualized_)
+    {
+        for (unsigned i = 0; i < virtualItems_.size(); ++i)
+        {
+            UIElement* item = virtualItems_[i];
+            if (item)
+                item->SetSelected(highlightMode_ != HM_NEVER && highlighted && selections_.contains(virtualFirst_ + i));
+        }
+        return;
+    }
+
+    unsigned numItems = GetNumItems();
+
     for (unsigned i = 0; i < numItems; ++i)
     {
         UIElement* item = GetItem(i);
@@ -1002,8 +1176,116 @@ void ListView::UpdateSelectionEffect()
     }
 }
 
+void ListView::UpdateVirtualItems(bool forceRebind)
+{
+    if (!virtualized_)
+        return;
+
+    // Compute the index range to materialize: the rows intersecting the scroll panel plus the margin on both sides
+    unsigned newFirst = 0;
+    unsigned newCount = 0;
+    if (virtualItemCount_)
+    {
+        const IntRect& clipBorder = scrollPanel_->GetClipBorder();
+        int panelHeight = Max(scrollPanel_->GetHeight() - clipBorder.top_ - clipBorder.bottom_, 0);
+        int viewY = GetViewPosition().y_;
+
+        newFirst = (unsigned)Max(viewY / virtualItemHeight_ - (int)virtualMargin_, 0);
+        unsigned newLast = Min((unsigned)((viewY + panelHeight) / virtualItemHeight_ + virtualMargin_), virtualItemCount_ - 1);
+        newCount = newLast - newFirst + 1;
+    }
+
+    if (!forceRebind && newFirst == virtualFirst_ && newCount == virtualItems_.size())
+        return;
+
+    contentElement_->DisableLayoutUpdate();
+
+    // Recycle rows that fell outside the new range, or all rows when a full rebind was requested
+    for (unsigned i = 0; i < virtualItems_.size(); ++i)
+    {
+        unsigned index = virtualFirst_ + i;
+        if (forceRebind || index < newFirst || index >= newFirst + newCount)
+        {
+            if (UIElement* item = virtualItems_[i])
+            {
+                contentElement_->RemoveChild(item);
+                recycledItems_.push_back(SharedPtr<UIElement>(item));
+                virtualItems_[i] = nullptr;
+            }
+        }
+    }
+
+    ea::vector<SharedPtr<UIElement> > newItems;
+    newItems.reserve(newCount);
+    bool highlighted = highlightMode_ == HM_ALWAYS || HasFocus();
+
+    for (unsigned index = newFirst; index < newFirst + newCount; ++index)
+    {
+        // Rows still inside the window keep their bound element; others are bound through the provider
+        SharedPtr<UIElement> item;
+        if (index >= virtualFirst_ && index - virtualFirst_ < virtualItems_.size())
+            item = virtualItems_[index - virtualFirst_];
+
+        if (!item)
+        {
+            SharedPtr<UIElement> recycled;
+            if (!recycledItems_.empty())
+            {
+                recycled = recycledItems_.back();
+                recycledItems_.pop_back();
+            }
+
+            item = virtualItemProvider_(index, recycled);
+            // If the provider returned a different element, put the unused recycled element back into the pool
+            if (recycled && item != recycled)
+                recycledItems_.push_back(recycled);
+            if (!item)
+            {
+                URHO3D_LOGWARNING("Virtual item provider returned null element for index " + ea::to_string(index));
+                newItems.push_back(item);
+                continue;
+            }
+
+            // Enable input so that clicking the item can be detected
+            item->SetEnabled(true);
+            if (item->GetParent() != contentElement_)
+                contentElement_->AddChild(item);
+        }
+
+        item->SetPosition(0, (int)index * virtualItemHeight_);
+        item->SetSelected(highlightMode_ != HM_NEVER && highlighted && selections_.contains(index));
+        newItems.push_back(item);
+    }
+
+    virtualFirst_ = newFirst;
+    virtualItems_.swap(newItems);
+
+    contentElement_->EnableLayoutUpdate();
+}
+
 void ListView::EnsureItemVisibility(unsigned index)
 {
+    // In virtualized mode the target row may not be materialized yet, so scroll based on the fixed row height instead.
+    // The resulting view change will materialize it
+    if (virtualized_)
+    {
+        if (index >= virtualItemCount_)
+            return;
+
+        IntVector2 newView = GetViewPosition();
+        const IntRect& clipBorder = scrollPanel_->GetClipBorder();
+        int windowHeight = scrollPanel_->GetHeight() - clipBorder.top_ - clipBorder.bottom_;
+        int itemY = (int)index * virtualItemHeight_;
+
+        if (itemY < newView.y_)
+            newView.y_ = itemY;
+        if (itemY + virtualItemHeight_ > newView.y_ + windowHeight)
+            newView.y_ = itemY + virtualItemHeight_ - windowHeight;
+
+        SetViewPosition(newView);
+        return;
+    }
+
     EnsureItemVisibility(GetItem(index));
 }
 
@@ -1165,6 +1447,11 @@ void ListView::HandleFocusChanged(StringHash eventType, VariantMap& eventData)
         UpdateSelectionEffect();
 }
 
+void ListView::HandleViewChanged(StringHash eventType, VariantMap& eventData)
+{
+    UpdateVirtualItems();
+}
+
 void ListView::UpdateUIClickSubscription()
 {
     UnsubscribeFromEvent(E_UIMOUSECLICK);
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "../Input/InputConstants.h"
 #include "../UI/ScrollView.h"
 
@@ -107,6 +109,21 @@ public:
     /// Enable reacting to click end instead of click start for item selection. Default false.
     void SetSelectOnClickEnd(bool enable);
 
+    /// \brief Item provider callback for virtualized mode. Receives the item index and a recycled element from a row that
+    /// scrolled out of view, or null when no recycled element is available. Returns the element to show for the row.
+    using VirtualItemProvider = std::function<SharedPtr<UIElement>(unsigned index, UIElement* recycledItem)>;
+
+    /// \brief Enable virtualized mode with a fixed item height. Only the visible rows plus a margin are materialized as
+    /// elements; the provider is invoked to fill rows as they scroll into view, reusing recycled elements where possible.
+    /// Existing items will be removed. Not available in hierarchy mode. Pass a null provider to return to normal mode.
+    void SetVirtualItemProvider(unsigned itemCount, int itemHeight, const VirtualItemProvider& provider);
+    /// Set the number of items in virtualized mode. Selections past the new end of the list are dropped.
+    void SetVirtualItemCount(unsigned count);
+    /// Set the number of extra rows materialized above and below the visible range in virtualized mode. Default 2.
+    void SetVirtualMargin(unsigned numRows);
+    /// Rebind the materialized rows from the item provider. Call after the underlying item data has changed in place.
+    void RefreshVirtualItems();
+
     /// Expand item at index. Only has effect in hierarchy mode.
     void Expand(unsigned index, bool enable, bool recursive = false);
     /// Toggle item's expanded flag at index. Only has effect in hierarchy mode.
@@ -155,6 +172,18 @@ public:
     /// Return base indent.
     int GetBaseIndent() const { return baseIndent_; }
 
+    /// Return whether virtualized mode is enabled.
+    bool IsVirtualized() const { return virtualized_; }
+
+    /// Return number of items in virtualized mode.
+    unsigned GetVirtualItemCount() const { return virtualItemCount_; }
+
+    /// Return fixed item height used in virtualized mode.
+    int GetVirtualItemHeight() const { return virtualItemHeight_; }
+
+    /// Return number of extra rows materialized above and below the visible range in virtualized mode.
+    unsigned GetVirtualMargin() const { return virtualMargin_; }
+
     /// Ensure full visibility of the item.
     void EnsureItemVisibility(unsigned index);
     /// Ensure full visibility of the item.
@@ -165,6 +194,8 @@ protected:
     bool FilterImplicitAttributes(XMLElement& dest) const override;
     /// Update selection effect when selection or focus changes.
     void UpdateSelectionEffect();
+    /// Materialize row elements for the currently visible index range in virtualized mode, recycling rows that scrolled out of view.
+    void UpdateVirtualItems(bool forceRebind = false);
 
     /// Current selection.
     ea::vector<unsigned> selections_;
@@ -182,6 +213,22 @@ protected:
     bool clearSelectionOnDefocus_;
     /// React to click end instead of click start flag.
     bool selectOnClickEnd_;
+    /// Virtualized mode flag.
+    bool virtualized_;
+    /// Item provider callback, used in virtualized mode only.
+    VirtualItemProvider virtualItemProvider_;
+    /// Total number of items, used in virtualized mode only.
+    unsigned virtualItemCount_;
+    /// Fixed item height, used in virtualized mode only.
+    int virtualItemHeight_;
+    /// Number of extra rows materialized above and below the visible range.
+    unsigned virtualMargin_;
+    /// Index of the first materialized row.
+    unsigned virtualFirst_;
+    /// Materialized row elements in index order.
+    ea::vector<SharedPtr<UIElement> > virtualItems_;
+    /// Recycled row elements awaiting reuse.
+    ea::vector<SharedPtr<UIElement> > recycledItems_;
 
 private:
     /// Handle global UI mouseclick to check for selection change.
@@ -192,6 +239,8 @@ private:
     void HandleItemFocusChanged(StringHash eventType, VariantMap& eventData);
     /// Handle focus changed.
     void HandleFocusChanged(StringHash eventType, VariantMap& eventData);
+    /// Handle scroll view position changed in virtualized mode.
+    void HandleViewChanged(StringHash eventType, VariantMap& eventData);
     /// Update subscription to UI click events.
     void UpdateUIClickSubscription();
 };
@@ -59,6 +59,9 @@ Text::Text(Context* context) :
     wordWrap_(false),
     autoLocalizable_(false),
     charLocationsDirty_(true),
+    fontGlyphVersion_(0),
+    shapedWordWrap_(false),
+    shapedMaxWidth_(0),
     selectionStart_(0),
     selectionLength_(0),
     textEffect_(TE_NONE),
@@ -127,7 +130,7 @@ void Text::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexDat
     }
 
     // If face has changed or char locations are not valid anymore, update before rendering
-    if (charLocationsDirty_ || !fontFace_ || face != fontFace_)
+    if (charLocationsDirty_ || !fontFace_ || face != fontFace_ || face->GetGlyphVersion() != fontGlyphVersion_)
         UpdateCharLocations();
     // If face uses mutable glyphs mechanism, reacquire glyphs before rendering to make sure they are in the texture
     else if (face->HasMutableGlyphs())
@@ -373,37 +376,44 @@ void Text::SetSelection(unsigned start, unsigned length)
     selectionStart_ = start;
     selectionLength_ = length;
     ValidateSelection();
+    MarkBatchesDirty();
 }
 
 void Text::ClearSelection()
 {
     selectionStart_ = 0;
     selectionLength_ = 0;
+    MarkBatchesDirty();
 }
 
 void Text::SetTextEffect(TextEffect textEffect)
 {
     textEffect_ = textEffect;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectShadowOffset(const IntVector2& offset)
 {
     shadowOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectStrokeThickness(int thickness)
 {
     strokeThickness_ = Abs(thickness);
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectRoundStroke(bool roundStroke)
 {
     roundStroke_ = roundStroke;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectColor(const Color& effectColor)
 {
     effectColor_ = effectColor;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectDepthBias(float bias)
@@ -486,14 +496,17 @@ bool Text::FilterImplicitAttributes(XMLElement& dest) const
 
 void Text::UpdateText(bool onResize)
 {
-    rowWidths_.clear();
-    printText_.clear();
+    MarkBatchesDirty();
 
     if (font_)
     {
         FontFace* face = font_->GetFace(fontSize_);
         if (!face)
+        {
+            rowWidths_.clear();
+            printText_.clear();
             return;
+        }
 
         rowHeight_ = face->GetRowHeight();
 
@@ -501,6 +514,34 @@ void Text::UpdateText(bool onResize)
         int height = 0;
         int rowWidth = 0;
         auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
+        int maxWidth = GetWidth();
+
+        // If only trailing content changed (e.g. lines appended to a log), reuse the shaped rows before the
+        // first edited line instead of re-shaping the whole text
+        unsigned keepChars = 0;
+        if (face == shapedFace_ && wordWrap_ == shapedWordWrap_ && (!wordWrap_ || maxWidth == shapedMaxWidth_))
+        {
+            unsigned minSize = Min(unicodeText_.size(), shapedText_.size());
+            while (keepChars < minSize && unicodeText_[keepChars] == shapedText_[keepChars])
+                ++keepChars;
+            // Only whole lines can be reused; back up to the start of the first changed line
+            while (keepChars && unicodeText_[keepChars - 1] != '\n')
+                --keepChars;
+        }
+
+        // Cut the previous shaped output at the start of the first changed line
+        unsigned keepPrint = 0;
+        while (keepPrint < printToText_.size() && printToText_[keepPrint] < keepChars)
+            ++keepPrint;
+        unsigned keepRows = 0;
+        for (unsigned i = 0; i < keepPrint; ++i)
+        {
+            if (printText_[i] == '\n')
+                ++keepRows;
+        }
+        printText_.resize(keepPrint);
+        printToText_.resize(keepPrint);
+        rowWidths_.resize(keepRows);
 
         // First see if the text must be split up
         if (!wordWrap_)
@@ -512,12 +553,10 @@ void Text::UpdateText(bool onResize)
         }
         else
         {
-            int maxWidth = GetWidth();
-            unsigned nextBreak = 0;
-            unsigned lineStart = 0;
-            printToText_.clear();
+            unsigned nextBreak = keepChars;
+            unsigned lineStart = keepChars;
 
-            for (unsigned i = 0; i < unicodeText_.size(); ++i)
+            for (unsigned i = keepChars; i < unicodeText_.size(); ++i)
             {
                 unsigned j;
                 unsigned c = unicodeText_[i];
@@ -609,9 +648,16 @@ void Text::UpdateText(bool onResize)
             }
         }
 
+        // Measure the kept rows from their cached widths, then only the re-shaped remainder
+        for (unsigned i = 0; i < rowWidths_.size(); ++i)
+        {
+            width = Max(width, (int)rowWidths_[i]);
+            height += rowHeight;
+        }
+
         rowWidth = 0;
 
-        for (unsigned i = 0; i < printText_.size(); ++i)
+        for (unsigned i = keepPrint; i < printText_.size(); ++i)
         {
             unsigned c = printText_[i];
 
@@ -658,11 +704,21 @@ void Text::UpdateText(bool onResize)
         }
         SetFixedHeight(height);
 
+        // Remember the shaping inputs for incremental relayout
+        shapedText_ = unicodeText_;
+        shapedFace_ = face;
+        shapedWordWrap_ = wordWrap_;
+        shapedMaxWidth_ = maxWidth;
+
         charLocationsDirty_ = true;
     }
     else
     {
         // No font, nothing to render
+        rowWidths_.clear();
+        printText_.clear();
+        shapedText_.clear();
+        shapedFace_.Reset();
         pageGlyphLocations_.clear();
     }
 
@@ -740,6 +796,7 @@ void Text::UpdateCharLocations()
     charLocations_[numChars].size_ = Vector2::ZERO;
 
     charLocationsDirty_ = false;
+    fontGlyphVersion_ = face->GetGlyphVersion();
 }
 
 void Text::ValidateSelection()
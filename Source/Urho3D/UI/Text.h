@@ -231,6 +231,8 @@ protected:
     bool wordWrap_;
     /// Char positions dirty flag.
     bool charLocationsDirty_;
+    /// Glyph version of the font face when the char positions were last updated.
+    unsigned fontGlyphVersion_;
     /// Selection start.
     unsigned selectionStart_;
     /// Selection length.
@@ -257,6 +259,14 @@ protected:
     ea::vector<unsigned> printToText_;
     /// Row widths.
     ea::vector<float> rowWidths_;
+    /// Text the current shaped rows were produced from, for incremental relayout.
+    ea::vector<unsigned> shapedText_;
+    /// Font face used for the current shaped rows.
+    WeakPtr<FontFace> shapedFace_;
+    /// Wordwrap mode used for the current shaped rows.
+    bool shapedWordWrap_;
+    /// Wrap width used for the current shaped rows.
+    int shapedMaxWidth_;
     /// Glyph locations per each texture in the font.
     ea::vector<ea::vector<GlyphLocation> > pageGlyphLocations_;
     /// Cached locations of each character in the text.
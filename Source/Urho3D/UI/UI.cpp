@@ -22,14 +22,19 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/sort.h>
+
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameBudget.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/ShaderVariation.h"
 #include "../Graphics/Texture2D.h"
+#include "../Graphics/TransientBuffer.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/Viewport.h"
@@ -79,6 +84,15 @@ static MouseButton MakeTouchIDMask(int id)
 }
 
 StringHash VAR_ORIGIN("Origin");
+/// Return the depth of an element in the UI hierarchy, for solving queued layout updates parents first.
+static unsigned GetElementDepth(UIElement* element)
+{
+    unsigned depth = 0;
+    while (element && (element = element->GetParent()) != nullptr)
+        ++depth;
+    return depth;
+}
+
 const StringHash VAR_ORIGINAL_PARENT("OriginalParent");
 const StringHash VAR_ORIGINAL_CHILD_INDEX("OriginalChildIndex");
 const StringHash VAR_PARENT_CHANGED("ParentChanged");
@@ -124,6 +138,13 @@ UI::UI(Context* context) :
     fontOversampling_(2),
     uiRendered_(false),
     nonModalBatchSize_(0),
+    useBatchCaching_(true),
+    batchCacheValid_(false),
+    cachedBatchCount_(0),
+    cachedVertexDataSize_(0),
+    vertexBufferDirty_(true),
+    usePartialRedraw_(false),
+    damageRect_(IntRect::ZERO),
     dragElementsCount_(0),
     dragConfirmedCount_(0),
     uiScale_(1.0f),
@@ -144,6 +165,7 @@ UI::UI(Context* context) :
     SubscribeToEvent(E_TEXTINPUT, URHO3D_HANDLER(UI, HandleTextInput));
     SubscribeToEvent(E_DROPFILE, URHO3D_HANDLER(UI, HandleDropFile));
     SubscribeToEvent(E_FOCUSED, URHO3D_HANDLER(UI, HandleFocused));
+    SubscribeToEvent(E_FONTGLYPHSUPDATED, URHO3D_HANDLER(UI, HandleFontGlyphsUpdated));
 
     // Try to initialize right now, but skip if screen mode is not yet set
     Initialize();
@@ -317,6 +339,7 @@ void UI::Clear()
     vertexData_.clear();
     debugDrawBatches_.clear();
     debugVertexData_.clear();
+    batchCacheValid_ = false;
 }
 
 void UI::Update(float timeStep)
@@ -324,6 +347,7 @@ void UI::Update(float timeStep)
     assert(rootElement_ && rootModalElement_);
 
     URHO3D_PROFILE("UpdateUI");
+    URHO3D_FRAME_BUDGET("UI");
 
     // Expire hovers
     for (auto i = hoveredElements_.begin(); i !=
@@ -411,6 +435,10 @@ void UI::Update(float timeStep)
             UIElement* element = i->first;
             if (element)
             {
+                // End the hover visuals; the batches built during the hover may still show the hovering appearance
+                element->SetHovering(false);
+                element->MarkBatchesDirty();
+
                 using namespace HoverEnd;
 
                 VariantMap& eventData = GetEventDataMap();
@@ -431,6 +459,9 @@ void UI::RenderUpdate()
 {
     assert(rootElement_ && rootModalElement_ && graphics_);
 
+    // Solve the layout updates deferred during the frame once, before building the batches
+    RunQueuedLayoutUpdates();
+
     URHO3D_PROFILE("GetUIBatches");
 
     uiRendered_ = false;
@@ -438,21 +469,49 @@ void UI::RenderUpdate()
     // If the OS cursor is visible, do not render the UI's own cursor
     bool osCursorVisible = GetSubsystem<Input>()->IsMouseVisible();
 
-    // Get rendering batches from the non-modal UI elements
-    batches_.clear();
-    vertexData_.clear();
     const IntVector2& rootSize = rootElement_->GetSize();
     const IntVector2& rootPos = rootElement_->GetPosition();
     // Note: the scissors operate on unscaled coordinates. Scissor scaling is only performed during render
     IntRect currentScissor = IntRect(rootPos.x_, rootPos.y_, rootPos.x_ + rootSize.x_, rootPos.y_ + rootSize.y_);
-    if (rootElement_->IsVisible())
-        GetBatches(batches_, vertexData_, rootElement_, currentScissor);
 
-    // Save the batch size of the non-modal batches for later use
-    nonModalBatchSize_ = batches_.size();
+    // Reuse the retained batches and vertex data when nothing in either element tree has changed since the last update
+    bool rebuild = !useBatchCaching_ || !batchCacheValid_ || rootElement_->AreBatchesDirty() ||
+        rootModalElement_->AreBatchesDirty();
+    if (rebuild)
+    {
+        if (usePartialRedraw_ && texture_)
+        {
+            // Batch cache invalidations (resize, glyph atlas changes) carry no per-element damage; repaint everything
+            if (!useBatchCaching_ || !batchCacheValid_)
+                damageRect_.Merge(IntRect(0, 0, rootSize.x_, rootSize.y_));
+            rootElement_->CollectDamage(damageRect_);
+            rootModalElement_->CollectDamage(damageRect_);
+        }
+
+        // Get rendering batches from the non-modal UI elements
+        batches_.clear();
+        vertexData_.clear();
+        if (rootElement_->IsVisible())
+            GetBatches(batches_, vertexData_, rootElement_, currentScissor);
 
-    // Get rendering batches from the modal UI elements
-    GetBatches(batches_, vertexData_, rootModalElement_, currentScissor);
+        // Save the batch size of the non-modal batches for later use
+        nonModalBatchSize_ = batches_.size();
+
+        // Get rendering batches from the modal UI elements
+        GetBatches(batches_, vertexData_, rootModalElement_, currentScissor);
+
+        rootElement_->ClearBatchesDirty();
+        rootModalElement_->ClearBatchesDirty();
+        cachedBatchCount_ = batches_.size();
+        cachedVertexDataSize_ = vertexData_.size();
+        batchCacheValid_ = useBatchCaching_;
+    }
+    else
+    {
+        // Drop the cursor and dummy batches appended on the previous frame
+        batches_.resize(cachedBatchCount_);
+        vertexData_.resize(cachedVertexDataSize_);
+    }
 
     // Get batches from the cursor (and its possible children) last to draw it on top of everything
     if (cursor_ && cursor_->IsVisible() && !osCursorVisible)
@@ -460,8 +519,12 @@ void UI::RenderUpdate()
         currentScissor = IntRect(0, 0, rootSize.x_, rootSize.y_);
         cursor_->GetBatches(batches_, vertexData_, currentScissor);
         GetBatches(batches_, vertexData_, cursor_, currentScissor);
+        vertexBufferDirty_ = true;
     }
 
+    if (rebuild)
+        vertexBufferDirty_ = true;
+
     // UIElement does not have anything to show. Insert dummy batch that will clear the texture.
     if (batches_.empty() && texture_)
     {
@@ -469,6 +532,7 @@ void UI::RenderUpdate()
         batch.SetColor(Color::BLACK);
         batch.AddQuad(currentScissor.left_, currentScissor.top_, currentScissor.right_, currentScissor.bottom_, 0, 0);
         batches_.push_back(batch);
+        vertexBufferDirty_ = true;
     }
 }
 
@@ -481,15 +545,37 @@ void UI::Render()
     if (cursor_ && osCursorVisible)
         cursor_->ApplyOSCursorShape();
 
-    SetVertexData(vertexBuffer_, vertexData_);
-    SetVertexData(debugVertexBuffer_, debugVertexData_);
+    // The vertex buffer retains its contents, so upload only when the data has changed
+    if (vertexBufferDirty_)
+    {
+        SetVertexData(vertexBuffer_, vertexData_);
+        vertexBufferDirty_ = false;
+    }
+    // The debug draw geometry changes every frame, so allocate it from the shared transient buffer
+    VertexBuffer* debugVertexBuffer = nullptr;
+    unsigned debugBaseVertex = 0;
+    if (!debugVertexData_.empty())
+    {
+        auto* transientBuffer = GetSubsystem<TransientBuffer>();
+        unsigned numVertices = debugVertexData_.size() / UI_VERTEX_SIZE;
+        void* dest = transientBuffer ? transientBuffer->AllocateVertices(MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1,
+            numVertices, debugVertexBuffer, debugBaseVertex) : nullptr;
+        if (dest)
+        {
+            memcpy(dest, &debugVertexData_[0], debugVertexData_.size() * sizeof(float));
+            debugVertexBuffer->Unlock();
+        }
+        else
+            debugVertexBuffer = nullptr;
+    }
 
     // Render non-modal batches
-    Render(vertexBuffer_, batches_, 0, nonModalBatchSize_);
+    Render(vertexBuffer_, batches_, 0, nonModalBatchSize_, 0);
     // Render debug draw
-    Render(debugVertexBuffer_, debugDrawBatches_, 0, debugDrawBatches_.size());
+    if (debugVertexBuffer)
+        Render(debugVertexBuffer, debugDrawBatches_, 0, debugDrawBatches_.size(), debugBaseVertex);
     // Render modal batches
-    Render(vertexBuffer_, batches_, nonModalBatchSize_, batches_.size());
+    Render(vertexBuffer_, batches_, nonModalBatchSize_, batches_.size(), 0);
 
     // Clear the debug draw batches and data
     debugDrawBatches_.clear();
@@ -639,6 +725,168 @@ void UI::SetUseMutableGlyphs(bool enable)
     }
 }
 
+void UI::SetUseBatchCaching(bool enable)
+{
+    useBatchCaching_ = enable;
+    if (!enable)
+        batchCacheValid_ = false;
+}
+
+void UI::SetUsePartialRedraw(bool enable)
+{
+    if (enable == usePartialRedraw_)
+        return;
+
+    usePartialRedraw_ = enable;
+    // Start from a fully repainted texture
+    damageRect_ = IntRect::ZERO;
+    batchCacheValid_ = false;
+}
+
+void UI::SetDeferredLayoutUpdate(bool enable)
+{
+    deferredLayoutUpdate_ = enable;
+    // Do not leave updates pending indefinitely when disabling
+    if (!enable)
+        RunQueuedLayoutUpdates();
+}
+
+void UI::QueueLayoutUpdate(UIElement* element)
+{
+    layoutDirtyElements_.push_back(WeakPtr<UIElement>(element));
+}
+
+void UI::QueueDeferredEvent(UIElement* element, StringHash eventType, const VariantMap& eventData)
+{
+    MutexLock lock(deferredEventMutex_);
+    deferredEvents_.resize(deferredEvents_.size() + 1);
+    DeferredEvent& event = deferredEvents_.back();
+    event.element_ = element;
+    event.eventType_ = eventType;
+    event.eventData_ = eventData;
+}
+
+void UI::RunQueuedLayoutUpdates()
+{
+    if (layoutDirtyElements_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateUILayout");
+
+    // Take the queue. Solving can not queue more updates, as nested layout updates run immediately during the solve
+    ea::vector<WeakPtr<UIElement> > elements;
+    ea::swap(elements, layoutDirtyElements_);
+
+    // Solve parents before children, so that the cascade from a parent satisfies the children's queued updates
+    ea::quick_sort(elements.begin(), elements.end(), [](const WeakPtr<UIElement>& lhs, const WeakPtr<UIElement>& rhs)
+        { return GetElementDepth(lhs) < GetElementDepth(rhs); });
+
+    solvingLayout_ = true;
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (parallelLayoutUpdate_ && workQueue && workQueue->GetNumThreads() && elements.size() > 1)
+    {
+        // Group the dirtied elements under their top level windows; the windows' subtrees are independent
+        // and can be solved in parallel. Elements at or outside the root elements are solved on the main thread
+        ea::vector<ea::pair<UIElement*, ea::vector<UIElement*> > > groups;
+        ea::vector<UIElement*> ungrouped;
+        for (auto i = elements.begin(); i != elements.end(); ++i)
+        {
+            UIElement* element = *i;
+            if (!element)
+                continue;
+
+            UIElement* top = element;
+            while (top->GetParent() && top->GetParent() != rootElement_ && top->GetParent() != rootModalElement_)
+                top = top->GetParent();
+            if (!top->GetParent())
+            {
+                ungrouped.push_back(element);
+                continue;
+            }
+
+            unsigned j = 0;
+            for (; j < groups.size(); ++j)
+            {
+                if (groups[j].first == top)
+                    break;
+            }
+            if (j == groups.size())
+                groups.push_back(ea::make_pair(top, ea::vector<UIElement*>()));
+            groups[j].second.push_back(element);
+        }
+
+        if (groups.size() > 1)
+        {
+            // Prevent the worker threads from cascading into a concurrent re-layout of the shared root elements
+            rootElement_->DisableLayoutUpdate();
+            rootModalElement_->DisableLayoutUpdate();
+
+            for (auto i = groups.begin(); i != groups.end(); ++i)
+            {
+                const ea::vector<UIElement*>& groupElements = i->second;
+                workQueue->AddWorkItem([&groupElements]()
+                {
+                    for (auto j = groupElements.begin(); j != groupElements.end(); ++j)
+                    {
+                        if ((*j)->HasQueuedLayoutUpdate())
+                            (*j)->UpdateLayout();
+                    }
+                }, M_MAX_UNSIGNED);
+            }
+            workQueue->Complete(M_MAX_UNSIGNED);
+
+            // Apply the root re-layout (anchoring) that was blocked during the parallel solve
+            rootElement_->EnableLayoutUpdate();
+            rootModalElement_->EnableLayoutUpdate();
+            rootElement_->UpdateLayout();
+            rootModalElement_->UpdateLayout();
+        }
+        else if (!groups.empty())
+        {
+            const ea::vector<UIElement*>& groupElements = groups[0].second;
+            for (auto i = groupElements.begin(); i != groupElements.end(); ++i)
+            {
+                if ((*i)->HasQueuedLayoutUpdate())
+                    (*i)->UpdateLayout();
+            }
+        }
+
+        for (auto i = ungrouped.begin(); i != ungrouped.end(); ++i)
+        {
+            if ((*i)->HasQueuedLayoutUpdate())
+                (*i)->UpdateLayout();
+        }
+    }
+    else
+    {
+        for (auto i = elements.begin(); i != elements.end(); ++i)
+        {
+            UIElement* element = *i;
+            // Skip elements whose queued update was already satisfied by a parent's cascade
+            if (element && element->HasQueuedLayoutUpdate())
+                element->UpdateLayout();
+        }
+    }
+
+    solvingLayout_ = false;
+
+    // Send the events raised on the worker threads, in order
+    if (!deferredEvents_.empty())
+    {
+        ea::vector<DeferredEvent> events;
+        {
+            MutexLock lock(deferredEventMutex_);
+            ea::swap(events, deferredEvents_);
+        }
+        for (auto i = events.begin(); i != events.end(); ++i)
+        {
+            if (i->element_)
+                i->element_->SendEvent(i->eventType_, i->eventData_);
+        }
+    }
+}
+
 void UI::SetForceAutoHint(bool enable)
 {
     if (enable != forceAutoHint_)
@@ -864,7 +1112,6 @@ void UI::Initialize()
     ResizeRootElement();
 
     vertexBuffer_ = context_->CreateObject<VertexBuffer>();
-    debugVertexBuffer_ = context_->CreateObject<VertexBuffer>();
 
     initialized_ = true;
 
@@ -911,7 +1158,7 @@ void UI::SetVertexData(VertexBuffer* dest, const ea::vector<float>& vertexData)
     dest->SetData(&vertexData[0]);
 }
 
-void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd)
+void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd, unsigned baseVertex)
 {
     // Engine does not render when window is closed or device is lost
     assert(graphics_ && graphics_->IsInitialized() && !graphics_->IsDeviceLost());
@@ -968,6 +1215,9 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
     ShaderVariation* alphaTexturePS = graphics_->GetShader(PS, "Basic", "ALPHAMAP VERTEXCOLOR");
 
 
+    // When partially redrawing a render target texture, draw only inside the damaged region
+    const bool clipToDamage = usePartialRedraw_ && texture_ && surface;
+
     for (unsigned i = batchStart; i < batchEnd; ++i)
     {
         const UIBatch& batch = batches[i];
@@ -1030,6 +1280,12 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
         graphics_->SetShaderParameter(PSP_ELAPSEDTIME, elapsedTime);
 
         IntRect scissor = batch.scissor_;
+        if (clipToDamage)
+        {
+            scissor.Clip(damageRect_);
+            if (scissor == IntRect::ZERO)
+                continue;
+        }
         scissor.left_ = (int)(scissor.left_ * uiScale_);
         scissor.top_ = (int)(scissor.top_ * uiScale_);
         scissor.right_ = (int)(scissor.right_ * uiScale_);
@@ -1070,7 +1326,7 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
             }
         }
 
-        graphics_->Draw(TRIANGLE_LIST, batch.vertexStart_ / UI_VERTEX_SIZE,
+        graphics_->Draw(TRIANGLE_LIST, baseVertex + batch.vertexStart_ / UI_VERTEX_SIZE,
             (batch.vertexEnd_ - batch.vertexStart_) / UI_VERTEX_SIZE);
 
         if (batch.customMaterial_)
@@ -1314,6 +1570,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
                     // Exit if element is destroyed by the event handling
                     if (!element)
                         return;
+                    element->MarkBatchesDirty();
                 }
                 hoveredElements_[element] = true;
             }
@@ -1359,6 +1616,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
                 // Exit if element is destroyed by the event handling
                 if (!element)
                     return;
+                element->MarkBatchesDirty();
             }
             hoveredElements_[element] = true;
         }
@@ -2024,6 +2282,12 @@ void UI::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
     RenderUpdate();
 }
 
+void UI::HandleFontGlyphsUpdated(StringHash eventType, VariantMap& eventData)
+{
+    // Text elements relayout lazily through the face glyph version; just make sure the cached batches are rebuilt
+    batchCacheValid_ = false;
+}
+
 void UI::HandleDropFile(StringHash eventType, VariantMap& eventData)
 {
     auto* input = GetSubsystem<Input>();
@@ -2072,10 +2336,47 @@ void UI::HandleEndAllViewsRender(StringHash eventType, VariantMap& eventData)
     {
         if (RenderSurface* surface = texture_->GetRenderSurface())
         {
+            const IntRect fullViewport(0, 0, surface->GetWidth(), surface->GetHeight());
+
+            if (usePartialRedraw_)
+            {
+                // Skip the frame entirely when nothing has changed; the texture retains last frame's contents
+                IntRect clearRect((int)(damageRect_.left_ * uiScale_), (int)(damageRect_.top_ * uiScale_),
+                    (int)ceilf(damageRect_.right_ * uiScale_), (int)ceilf(damageRect_.bottom_ * uiScale_));
+                clearRect.Clip(fullViewport);
+                if (clearRect == IntRect::ZERO)
+                {
+                    debugDrawBatches_.clear();
+                    debugVertexData_.clear();
+                    return;
+                }
+
+                graphics_->ResetRenderTargets();
+                graphics_->SetDepthStencil(surface->GetLinkedDepthStencil());
+                graphics_->SetRenderTarget(0, surface);
+
+#ifdef URHO3D_OPENGL
+                // The UI renders vertically flipped into the texture; flip the cleared region to match
+                const int top = clearRect.top_;
+                clearRect.top_ = fullViewport.bottom_ - clearRect.bottom_;
+                clearRect.bottom_ = fullViewport.bottom_ - top;
+#endif
+                // Clear only the damaged region; a partial viewport limits the clear to it
+                graphics_->SetViewport(clearRect);
+                if (clearColor_.a_ > 0)
+                    graphics_->Clear(CLEAR_COLOR, clearColor_);
+
+                // Render with the full viewport so the projection is unaffected; batch scissors are clipped to the damage
+                graphics_->SetViewport(fullViewport);
+                Render();
+                damageRect_ = IntRect::ZERO;
+                return;
+            }
+
             graphics_->ResetRenderTargets();
             graphics_->SetDepthStencil(surface->GetLinkedDepthStencil());
             graphics_->SetRenderTarget(0, surface);
-            graphics_->SetViewport(IntRect(0, 0, surface->GetWidth(), surface->GetHeight()));
+            graphics_->SetViewport(fullViewport);
             if (clearColor_.a_ > 0)
                 graphics_->Clear(CLEAR_COLOR, clearColor_);
             Render();
@@ -2159,6 +2460,8 @@ IntVector2 UI::SumTouchPositions(UI::DragData* dragData, const IntVector2& oldSe
 
 void UI::ResizeRootElement()
 {
+    batchCacheValid_ = false;
+
     IntVector2 effectiveSize = GetEffectiveRootElementSize();
     rootElement_->SetSize(effectiveSize);
     rootModalElement_->SetSize(effectiveSize);
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../UI/Cursor.h"
@@ -112,6 +113,14 @@ public:
     void SetUseScreenKeyboard(bool enable);
     /// Set whether to use mutable (eraseable) glyphs to ensure a font face never expands to more than one texture. Default false.
     void SetUseMutableGlyphs(bool enable);
+    /// Set whether to reuse the UI batches and vertex data from the previous frame when no element has changed. Disable if custom elements modify their rendered output without calling MarkBatchesDirty(). Default true.
+    void SetUseBatchCaching(bool enable);
+    /// Set whether to redraw only the damaged regions of the render target texture, keeping the rest from the previous frame. Effective only when rendering into a texture; the backbuffer is always redrawn in full. Default false.
+    void SetUsePartialRedraw(bool enable);
+    /// Set whether layout updates are deferred and solved in one batch just before rendering, instead of immediately on every change. Collapses cascading layout updates within a frame. Default false.
+    void SetDeferredLayoutUpdate(bool enable);
+    /// Set whether the batched layout solve may process independent top level windows on worker threads. Effective only when deferred layout updates are enabled. Default false.
+    void SetParallelLayoutUpdate(bool enable) { parallelLayoutUpdate_ = enable; }
     /// Set whether to force font autohinting instead of using FreeType's TTF bytecode interpreter.
     void SetForceAutoHint(bool enable);
     /// Set the hinting level used by FreeType fonts.
@@ -203,6 +212,27 @@ public:
     /// Return whether is using mutable (eraseable) glyphs for fonts.
     bool GetUseMutableGlyphs() const { return useMutableGlyphs_; }
 
+    /// Return whether UI batches are reused across frames when no element has changed.
+    bool GetUseBatchCaching() const { return useBatchCaching_; }
+
+    /// Return whether only damaged regions of the render target texture are redrawn.
+    bool GetUsePartialRedraw() const { return usePartialRedraw_; }
+
+    /// Return whether layout updates are deferred into a batched solve before rendering.
+    bool GetDeferredLayoutUpdate() const { return deferredLayoutUpdate_; }
+
+    /// Return whether the batched layout solve may use worker threads.
+    bool GetParallelLayoutUpdate() const { return parallelLayoutUpdate_; }
+
+    /// Return whether the queued layout updates are currently being solved.
+    bool IsSolvingLayout() const { return solvingLayout_; }
+
+    /// Queue a deferred layout update for an element. Called by UIElement.
+    void QueueLayoutUpdate(UIElement* element);
+
+    /// Queue an event raised during a parallel layout solve for sending once the solve completes. Called by UIElement from the worker threads.
+    void QueueDeferredEvent(UIElement* element, StringHash eventType, const VariantMap& eventData);
+
     /// Return whether is using forced autohinting.
     bool GetForceAutoHint() const { return forceAutoHint_; }
 
@@ -265,7 +295,7 @@ private:
     /// Upload UI geometry into a vertex buffer.
     void SetVertexData(VertexBuffer* dest, const ea::vector<float>& vertexData);
     /// Render UI batches to the current rendertarget. Geometry must have been uploaded first.
-    void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd);
+    void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd, unsigned baseVertex);
     /// Generate batches from an UI element recursively. Skip the cursor element.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor);
     /// Return UI element at screen position recursively.
@@ -329,6 +359,8 @@ private:
     void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
     /// Handle a file being drag-dropped into the application window.
     void HandleDropFile(StringHash eventType, VariantMap& eventData);
+    /// Handle font glyphs having been rasterized, relocated or evicted, invalidating cached batches.
+    void HandleFontGlyphsUpdated(StringHash eventType, VariantMap& eventData);
     /// Handle off-screen UI subsystems gaining focus.
     void HandleFocused(StringHash eventType, VariantMap& eventData);
     /// Handle rendering to a texture.
@@ -339,6 +371,8 @@ private:
     void ProcessDragCancel();
     /// Sum touch positions and return the begin position ready to send.
     IntVector2 SumTouchPositions(UI::DragData* dragData, const IntVector2& oldSendPos);
+    /// Solve the queued deferred layout updates, parents first, optionally spreading independent top level windows across worker threads.
+    void RunQueuedLayoutUpdates();
     /// Resize root element to effective size.
     void ResizeRootElement();
     /// Return effective size of the root element, according to UI scale and resolution / custom size.
@@ -366,8 +400,6 @@ private:
     ea::vector<float> debugVertexData_;
     /// UI vertex buffer.
     SharedPtr<VertexBuffer> vertexBuffer_;
-    /// UI debug geometry vertex buffer.
-    SharedPtr<VertexBuffer> debugVertexBuffer_;
     /// UI element query vector.
     ea::vector<UIElement*> tempElements_;
     /// Clipboard text.
@@ -412,6 +444,20 @@ private:
     bool uiRendered_;
     /// Non-modal batch size (used internally for rendering).
     unsigned nonModalBatchSize_;
+    /// Flag for using cross-frame UI batch caching.
+    bool useBatchCaching_;
+    /// Flag for the retained batches and vertex data being valid for reuse.
+    bool batchCacheValid_;
+    /// Number of retained batches, excluding the per-frame cursor and dummy batches appended after them.
+    unsigned cachedBatchCount_;
+    /// Size of the retained vertex data.
+    unsigned cachedVertexDataSize_;
+    /// Flag for the UI vertex buffer needing a data upload before rendering.
+    bool vertexBufferDirty_;
+    /// Flag for redrawing only the damaged regions of the render target texture.
+    bool usePartialRedraw_;
+    /// Accumulated damaged region in unscaled UI coordinates. Empty (degenerate) when nothing has changed.
+    IntRect damageRect_;
     /// Timer used to trigger double click.
     Timer clickTimer_;
     /// UI element last clicked for tracking double clicks.
@@ -442,6 +488,28 @@ private:
     Color clearColor_ = Color::TRANSPARENT_BLACK;
     /// Flag indicating that UI should process input when mouse cursor hovers SystemUI elements.
     bool partOfSystemUI_ = false;
+    /// Flag for deferring layout updates into a batched solve before rendering.
+    bool deferredLayoutUpdate_ = false;
+    /// Flag for allowing the batched layout solve to use worker threads.
+    bool parallelLayoutUpdate_ = false;
+    /// Flag for the queued layout updates currently being solved. Nested layout updates run immediately during the solve.
+    bool solvingLayout_ = false;
+    /// Elements with a queued deferred layout update.
+    ea::vector<WeakPtr<UIElement> > layoutDirtyElements_;
+    /// Guards the deferred event queue while layout solves run on worker threads.
+    Mutex deferredEventMutex_;
+    /// UI event raised while a layout solve ran on a worker thread, deferred until the solve completes.
+    struct DeferredEvent
+    {
+        /// Element that raised the event.
+        WeakPtr<UIElement> element_;
+        /// Event type.
+        StringHash eventType_;
+        /// Event data.
+        VariantMap eventData_;
+    };
+    /// Events raised on worker threads during a parallel layout solve, sent in order once the solve completes.
+    ea::vector<DeferredEvent> deferredEvents_;
 };
 
 /// Register UI library objects.
@@ -26,6 +26,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/Thread.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/ObjectAnimation.h"
@@ -39,6 +40,9 @@
 namespace Urho3D
 {
 
+/// Map for building layout solve events on the worker threads, where the context's pooled event data maps can not be used.
+static thread_local VariantMap layoutEventData;
+
 const char* horizontalAlignments[] =
 {
     "Left",
@@ -557,11 +561,11 @@ void UIElement::SetPosition(const IntVector2& position)
 
         using namespace Positioned;
 
-        VariantMap& eventData = GetEventDataMap();
+        VariantMap& eventData = GetLayoutEventDataMap();
         eventData[P_ELEMENT] = this;
         eventData[P_X] = position.x_;
         eventData[P_Y] = position.y_;
-        SendEvent(E_POSITIONED, eventData);
+        SendLayoutEvent(E_POSITIONED, eventData);
     }
 }
 
@@ -597,13 +601,13 @@ void UIElement::SetSize(const IntVector2& size)
 
             using namespace Resized;
 
-            VariantMap& eventData = GetEventDataMap();
+            VariantMap& eventData = GetLayoutEventDataMap();
             eventData[P_ELEMENT] = this;
             eventData[P_WIDTH] = size_.x_;
             eventData[P_HEIGHT] = size_.y_;
             eventData[P_DX] = delta.x_;
             eventData[P_DY] = delta.y_;
-            SendEvent(E_RESIZED, eventData);
+            SendLayoutEvent(E_RESIZED, eventData);
         }
     }
 
@@ -842,6 +846,7 @@ void UIElement::SetClipBorder(const IntRect& rect)
     clipBorder_.top_ = Max(rect.top_, 0);
     clipBorder_.right_ = Max(rect.right_, 0);
     clipBorder_.bottom_ = Max(rect.bottom_, 0);
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(const Color& color)
@@ -850,6 +855,7 @@ void UIElement::SetColor(const Color& color)
         cornerColor = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(Corner corner, const Color& color)
@@ -857,6 +863,7 @@ void UIElement::SetColor(Corner corner, const Color& color)
     colors_[corner] = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 
     for (unsigned i = 0; i < MAX_UIELEMENT_CORNERS; ++i)
     {
@@ -873,6 +880,7 @@ void UIElement::SetPriority(int priority)
     priority_ = priority;
     if (parent_)
         parent_->sortOrderDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetOpacity(float opacity)
@@ -894,12 +902,16 @@ void UIElement::SetBringToBack(bool enable)
 void UIElement::SetClipChildren(bool enable)
 {
     clipChildren_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetSortChildren(bool enable)
 {
     if (!sortChildren_ && enable)
+    {
         sortOrderDirty_ = true;
+        MarkBatchesDirty();
+    }
 
     sortChildren_ = enable;
 }
@@ -913,11 +925,13 @@ void UIElement::SetEnabled(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetDeepEnabled(bool enable)
 {
     enabled_ = enable;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->SetDeepEnabled(enable);
@@ -926,6 +940,7 @@ void UIElement::SetDeepEnabled(bool enable)
 void UIElement::ResetDeepEnabled()
 {
     enabled_ = enabledPrev_;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->ResetDeepEnabled();
@@ -935,6 +950,7 @@ void UIElement::SetEnabledRecursive(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->SetEnabledRecursive(enable);
@@ -944,6 +960,7 @@ void UIElement::SetEditable(bool enable)
 {
     editable_ = enable;
     OnSetEditable();
+    MarkBatchesDirty();
 }
 
 void UIElement::SetFocusMode(FocusMode mode)
@@ -977,6 +994,7 @@ void UIElement::SetFocus(bool enable)
 void UIElement::SetSelected(bool enable)
 {
     selected_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetVisible(bool enable)
@@ -989,6 +1007,7 @@ void UIElement::SetVisible(bool enable)
     if (enable != visible_)
     {
         visible_ = enable;
+        MarkBatchesDirty();
 
         // Parent's layout may change as a result of visibility change
         if (parent_)
@@ -1122,6 +1141,21 @@ void UIElement::UpdateLayout()
     if (layoutNestingLevel_)
         return;
 
+    // When deferred layout is enabled, only mark the element dirty: the UI subsystem solves the dirtied
+    // elements in one batch before rendering, collapsing cascading layout updates within the frame
+    UI* ui = GetSubsystem<UI>();
+    if (ui && ui->GetDeferredLayoutUpdate() && !ui->IsSolvingLayout())
+    {
+        if (!layoutUpdateQueued_)
+        {
+            layoutUpdateQueued_ = true;
+            ui->QueueLayoutUpdate(this);
+        }
+        return;
+    }
+
+    layoutUpdateQueued_ = false;
+
     // Prevent further updates while this update happens
     DisableLayoutUpdate();
 
@@ -1222,13 +1256,39 @@ void UIElement::UpdateLayout()
 
     using namespace LayoutUpdated;
 
-    VariantMap& eventData = GetEventDataMap();
+    VariantMap& eventData = GetLayoutEventDataMap();
     eventData[P_ELEMENT] = this;
-    SendEvent(E_LAYOUTUPDATED, eventData);
+    SendLayoutEvent(E_LAYOUTUPDATED, eventData);
 
     EnableLayoutUpdate();
 }
 
+VariantMap& UIElement::GetLayoutEventDataMap() const
+{
+    // The context's pooled event data maps are not usable on the worker threads during a parallel layout solve
+    if (!Thread::IsMainThread())
+    {
+        layoutEventData.clear();
+        return layoutEventData;
+    }
+
+    return GetEventDataMap();
+}
+
+void UIElement::SendLayoutEvent(StringHash eventType, VariantMap& eventData)
+{
+    // During a parallel layout solve the event is raised on a worker thread; queue it with the UI subsystem,
+    // which sends the queued events in order once the solve completes
+    if (!Thread::IsMainThread())
+    {
+        if (UI* ui = GetSubsystem<UI>())
+            ui->QueueDeferredEvent(this, eventType, eventData);
+        return;
+    }
+
+    SendEvent(eventType, eventData);
+}
+
 void UIElement::DisableLayoutUpdate()
 {
     ++layoutNestingLevel_;
@@ -1343,6 +1403,8 @@ void UIElement::InsertChild(unsigned index, UIElement* element)
 
     element->parent_ = this;
     element->MarkDirty();
+    // Mark explicitly instead of relying on the child: a reattached subtree may still carry set flags from its old parent
+    MarkBatchesDirty();
 
     // Apply style now if child element (and its children) has it defined
     ApplyStyleRecursive(element);
@@ -1388,6 +1450,7 @@ void UIElement::RemoveChild(UIElement* element, unsigned index)
 
             element->Detach();
             children_.erase_at(i);
+            MarkBatchesDirty();
             UpdateLayout();
             return;
         }
@@ -1415,6 +1478,7 @@ void UIElement::RemoveChildAtIndex(unsigned index)
 
     children_[index]->Detach();
     children_.erase_at(index);
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1441,6 +1505,7 @@ void UIElement::RemoveAllChildren()
         (*i++)->Detach();
     }
     children_.clear();
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1833,7 +1898,11 @@ void UIElement::SetChildOffset(const IntVector2& offset)
 
 void UIElement::SetHovering(bool enable)
 {
-    hovering_ = enable;
+    if (enable != hovering_)
+    {
+        hovering_ = enable;
+        MarkBatchesDirty();
+    }
 }
 
 void UIElement::AdjustScissor(IntRect& currentScissor)
@@ -1961,11 +2030,55 @@ void UIElement::MarkDirty()
     positionDirty_ = true;
     opacityDirty_ = true;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->MarkDirty();
 }
 
+void UIElement::MarkBatchesDirty()
+{
+    damageDirty_ = true;
+
+    // The flags are cleared for the whole subtree when UI rebuilds its batches, so within the element tree an already
+    // set flag implies that the rest of the ancestor chain is set as well
+    for (UIElement* element = this; element && !element->batchesDirty_; element = element->parent_)
+        element->batchesDirty_ = true;
+}
+
+void UIElement::ClearBatchesDirty()
+{
+    batchesDirty_ = false;
+
+    for (auto i = children_.begin(); i != children_.end(); ++i)
+        (*i)->ClearBatchesDirty();
+}
+
+IntRect UIElement::CollectDamage(IntRect& damage)
+{
+    IntVector2 screenPosition(GetScreenPosition());
+    IntRect combined(screenPosition.x_, screenPosition.y_, screenPosition.x_ + size_.x_, screenPosition.y_ + size_.y_);
+
+    // Recurse also into clipped or invisible subtrees so that their change flags and remembered rectangles stay current
+    for (auto i = children_.begin(); i != children_.end(); ++i)
+    {
+        IntRect childRect = (*i)->CollectDamage(damage);
+        if (!clipChildren_)
+            combined.Merge(childRect);
+    }
+
+    if (damageDirty_)
+    {
+        // Damage both where the subtree was drawn last time and where it is now
+        damage.Merge(renderedRect_);
+        damage.Merge(combined);
+        damageDirty_ = false;
+    }
+
+    renderedRect_ = combined;
+    return combined;
+}
+
 bool UIElement::RemoveChildXML(XMLElement& parent, const ea::string& name) const
 {
     static XPathQuery matchXPathQuery("./attribute[@name=$attributeName]", "attributeName:String");
@@ -341,6 +341,8 @@ public:
     void SetIndentSpacing(int indentSpacing);
     /// Manually update layout. Should not be necessary in most cases, but is provided for completeness.
     void UpdateLayout();
+    /// Return whether a deferred layout update has been queued for this element.
+    bool HasQueuedLayoutUpdate() const { return layoutUpdateQueued_; }
     /// Disable automatic layout update. Should only be used if there are performance problems.
     void DisableLayoutUpdate();
     /// Enable automatic layout update.
@@ -632,6 +634,15 @@ public:
     void AdjustScissor(IntRect& currentScissor);
     /// Get UI rendering batches with a specified offset. Also recurse to child elements.
     void GetBatchesWithOffset(IntVector2& offset, ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, IntRect currentScissor);
+    /// Mark the cached UI batches of this element and all its ancestors as needing a rebuild. Called automatically by the element's own mutator functions; call manually after changing rendering-relevant state outside of them.
+    void MarkBatchesDirty();
+    /// Clear the batches dirty flag in this element and all children. Called by UI after rebuilding the batches.
+    void ClearBatchesDirty();
+    /// Accumulate the screen regions changed since the last call into a damage rectangle and return the combined screen rectangle of this subtree. Called by UI when partial redraw is enabled.
+    IntRect CollectDamage(IntRect& damage);
+
+    /// Return whether the cached UI batches of this element's subtree need to be rebuilt.
+    bool AreBatchesDirty() const { return batchesDirty_; }
 
     /// Return color attribute. Uses just the top-left color.
     const Color& GetColorAttr() const { return colors_[0]; }
@@ -667,6 +678,10 @@ protected:
     virtual bool FilterImplicitAttributes(XMLElement& dest) const;
     /// Update anchored size & position. Only called when anchoring is enabled.
     void UpdateAnchoring();
+    /// Return a map for building an event raised by the layout solve. Usable also on worker threads during a parallel layout solve.
+    VariantMap& GetLayoutEventDataMap() const;
+    /// Send an event raised by the layout solve. Deferred through the UI subsystem when raised on a worker thread.
+    void SendLayoutEvent(StringHash eventType, VariantMap& eventData);
 
     /// Name.
     ea::string name_;
@@ -722,6 +737,8 @@ protected:
     unsigned resizeNestingLevel_{};
     /// Layout update nesting level to prevent endless loop.
     unsigned layoutNestingLevel_{};
+    /// Whether a deferred layout update has been queued with the UI subsystem.
+    bool layoutUpdateQueued_{};
     /// Layout element maximum size in layout direction.
     int layoutElementMaxSize_{};
     /// Horizontal indentation.
@@ -799,6 +816,12 @@ private:
     mutable bool derivedColorDirty_{true};
     /// Child priority sorting dirty flag.
     bool sortOrderDirty_{};
+    /// UI batches dirty flag. Set in all ancestors as well whenever rendering-relevant state changes.
+    bool batchesDirty_{true};
+    /// Flag for this element having changed since damage was last collected.
+    bool damageDirty_{true};
+    /// Combined screen rectangle of the subtree when damage was last collected.
+    IntRect renderedRect_{IntRect::ZERO};
     /// Has color gradient flag.
     bool colorGradient_{};
     /// Default style file.
@@ -410,6 +410,12 @@ URHO3D_EVENT(E_DRAGCANCEL, DragCancel)
     URHO3D_PARAM(P_NUMBUTTONS, NumButtons);        // int
 }
 
+/// Glyphs of a font face were rasterized, relocated or evicted; text batches built earlier may be stale.
+URHO3D_EVENT(E_FONTGLYPHSUPDATED, FontGlyphsUpdated)
+{
+    URHO3D_PARAM(P_FONT, Font);                    // Font pointer
+}
+
 /// A file was drag-dropped into the application window. Includes also coordinates and UI element if applicable.
 URHO3D_EVENT(E_UIDROPFILE, UIDropFile)
 {
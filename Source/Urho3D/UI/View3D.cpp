@@ -161,9 +161,9 @@ void View3D::ResetScene()
     if (!ownScene_)
     {
         RefCount* refCount = scene_->RefCountPtr();
-        ea::Internal::atomic_increment(&refCount->refs_);
+        refCount->refs_.fetch_add(1, std::memory_order_relaxed);
         scene_ = nullptr;
-        ea::Internal::atomic_decrement(&refCount->refs_);
+        refCount->refs_.fetch_sub(1, std::memory_order_relaxed);
     }
     else
         scene_ = nullptr;
@@ -30,6 +30,7 @@
 #include "../Scene/SceneEvents.h"
 #include "../Urho2D/AnimatedSprite2D.h"
 #include "../Urho2D/AnimationSet2D.h"
+#include "../Urho2D/Renderer2D.h"
 #include "../Urho2D/Sprite2D.h"
 #include "../Urho2D/SpriterInstance2D.h"
 
@@ -87,15 +88,12 @@ void AnimatedSprite2D::OnSetEnabled()
 {
     StaticSprite2D::OnSetEnabled();
 
-    bool enabled = IsEnabledEffective();
-
-    Scene* scene = GetScene();
-    if (scene)
+    if (renderer_)
     {
-        if (enabled)
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+        if (IsEnabledEffective())
+            renderer_->AddAnimatedSprite(this);
         else
-            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+            renderer_->RemoveAnimatedSprite(this);
     }
 }
 
@@ -136,6 +134,7 @@ void AnimatedSprite2D::SetAnimationSet(AnimationSet2D* animationSet)
     if (animationSet_->GetSpriterData())
     {
         spriterInstance_ = ea::make_unique<Spriter::SpriterInstance>(this, animationSet_->GetSpriterData());
+        spriterInstance_->SetPoseCache(animationSet_->GetSpriterPoseCache());
 
         if (!animationSet_->GetSpriterData()->entities_.empty())
         {
@@ -211,17 +210,18 @@ ResourceRef AnimatedSprite2D::GetAnimationSetAttr() const
 
 void AnimatedSprite2D::OnSceneSet(Scene* scene)
 {
+    if (!scene && renderer_)
+        renderer_->RemoveAnimatedSprite(this);
+
     StaticSprite2D::OnSceneSet(scene);
 
     if (scene)
     {
         if (scene == node_)
             URHO3D_LOGWARNING(GetTypeName() + " should not be created to the root scene node");
-        if (IsEnabledEffective())
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+        if (renderer_ && IsEnabledEffective())
+            renderer_->AddAnimatedSprite(this);
     }
-    else
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
 }
 
 void AnimatedSprite2D::SetAnimationAttr(const ea::string& name)
@@ -242,13 +242,6 @@ void AnimatedSprite2D::UpdateSourceBatches()
     sourceBatchesDirty_ = false;
 }
 
-void AnimatedSprite2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
-{
-    using namespace ScenePostUpdate;
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
-    UpdateAnimation(timeStep);
-}
-
 void AnimatedSprite2D::UpdateAnimation(float timeStep)
 {
 #ifdef URHO3D_SPINE
@@ -259,6 +252,22 @@ void AnimatedSprite2D::UpdateAnimation(float timeStep)
         UpdateSpriterAnimation(timeStep);
 }
 
+void AnimatedSprite2D::PostUpdateAnimation()
+{
+    if (spriterInstance_)
+        spriterInstance_->SendFinishEvent();
+}
+
+bool AnimatedSprite2D::IsUpdateThreadSafe() const
+{
+#ifdef URHO3D_SPINE
+    // The Spine runtime is not thread-safe
+    if (skeleton_)
+        return false;
+#endif
+    return true;
+}
+
 #ifdef URHO3D_SPINE
 void AnimatedSprite2D::SetSpineAnimation()
 {
@@ -302,7 +311,7 @@ void AnimatedSprite2D::UpdateSpineAnimation(float timeStep)
     spAnimationState_apply(animationState_, skeleton_);
     spSkeleton_updateWorldTransform(skeleton_);
 
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     worldBoundingBoxDirty_ = true;
 }
 
@@ -389,7 +398,10 @@ void AnimatedSprite2D::UpdateSourceBatchesSpine()
 void AnimatedSprite2D::SetSpriterAnimation()
 {
     if (!spriterInstance_)
+    {
         spriterInstance_ = ea::make_unique<Spriter::SpriterInstance>(this, animationSet_->GetSpriterData());
+        spriterInstance_->SetPoseCache(animationSet_->GetSpriterPoseCache());
+    }
 
     // Use entity is empty first entity
     if (entity_.empty())
@@ -414,7 +426,7 @@ void AnimatedSprite2D::SetSpriterAnimation()
 void AnimatedSprite2D::UpdateSpriterAnimation(float timeStep)
 {
     spriterInstance_->Update(timeStep * speed_);
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     worldBoundingBoxDirty_ = true;
 }
 
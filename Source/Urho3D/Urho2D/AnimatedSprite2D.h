@@ -98,15 +98,18 @@ public:
     /// Set animation by name.
     void SetAnimationAttr(const ea::string& name);
 
+    /// Update animation. Called by Renderer2D on scene post-update, possibly from a worker thread.
+    void UpdateAnimation(float timeStep);
+    /// Send events deferred during a threaded animation update. Called by Renderer2D on the main thread after all animation updates have completed.
+    void PostUpdateAnimation();
+    /// Return whether the animation update can run on a worker thread.
+    bool IsUpdateThreadSafe() const;
+
 protected:
     /// Handle scene being assigned.
     void OnSceneSet(Scene* scene) override;
     /// Handle update vertices.
     void UpdateSourceBatches() override;
-    /// Handle scene post update.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
-    /// Update animation.
-    void UpdateAnimation(float timeStep);
 #ifdef URHO3D_SPINE
     /// Handle set spine animation.
     void SetSpineAnimation();
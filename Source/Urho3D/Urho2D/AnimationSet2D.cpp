@@ -33,6 +33,7 @@
 #include "../Urho2D/AnimationSet2D.h"
 #include "../Urho2D/Sprite2D.h"
 #include "../Urho2D/SpriterData2D.h"
+#include "../Urho2D/SpriterInstance2D.h"
 #include "../Urho2D/SpriteSheet2D.h"
 
 #include "../DebugNew.h"
@@ -299,6 +300,8 @@ bool AnimationSet2D::BeginLoadSpriter(Deserializer& source)
         return false;
     }
 
+    spriterPoseCache_ = ea::make_unique<Spriter::SpriterPoseCache>();
+
     // Check has sprite sheet
     ea::string parentPath = GetParentPath(GetName());
     auto* cache = GetSubsystem<ResourceCache>();
@@ -521,6 +524,7 @@ void AnimationSet2D::Dispose()
 #endif
 
     spriterData_.reset();
+    spriterPoseCache_.reset();
 
     sprite_.Reset();
     spriteSheet_.Reset();
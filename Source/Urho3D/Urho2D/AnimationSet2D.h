@@ -35,6 +35,7 @@ namespace Urho3D
 
 namespace Spriter
 {
+    class SpriterPoseCache;
     struct SpriterData;
 }
 
@@ -76,6 +77,8 @@ public:
 
     /// Return spriter data.
     Spriter::SpriterData* GetSpriterData() const { return spriterData_.get(); }
+    /// Return shared cache of evaluated spriter poses.
+    Spriter::SpriterPoseCache* GetSpriterPoseCache() const { return spriterPoseCache_.get(); }
     /// Return spriter file sprite.
     Sprite2D* GetSpriterFileSprite(int folderId, int fileId) const;
 
@@ -109,6 +112,8 @@ private:
 
     /// Spriter data.
     ea::unique_ptr<Spriter::SpriterData> spriterData_;
+    /// Shared cache of evaluated spriter poses.
+    ea::unique_ptr<Spriter::SpriterPoseCache> spriterPoseCache_;
     /// Has sprite sheet.
     bool hasSpriteSheet_;
     /// Sprite sheet file path.
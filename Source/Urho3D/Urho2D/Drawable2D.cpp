@@ -47,7 +47,8 @@ Drawable2D::Drawable2D(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY2D),
     layer_(0),
     orderInLayer_(0),
-    sourceBatchesDirty_(true)
+    sourceBatchesDirty_(true),
+    sourceBatchVersion_(0)
 {
 }
 
@@ -126,7 +127,16 @@ void Drawable2D::OnMarkedDirty(Node* node)
 {
     Drawable::OnMarkedDirty(node);
 
+    MarkSourceBatchesDirty();
+}
+
+void Drawable2D::MarkSourceBatchesDirty()
+{
     sourceBatchesDirty_ = true;
+    ++sourceBatchVersion_;
+
+    if (renderer_)
+        renderer_->QueueCellUpdate(this);
 }
 
 }
@@ -124,6 +124,9 @@ public:
     /// Return all source batches (called by Renderer2D).
     const ea::vector<SourceBatch2D>& GetSourceBatches();
 
+    /// Return the source batch content version. Incremented whenever the batches are marked dirty; used by Renderer2D to reuse already uploaded vertex data.
+    unsigned GetSourceBatchVersion() const { return sourceBatchVersion_; }
+
 protected:
     /// Handle scene being assigned.
     void OnSceneSet(Scene* scene) override;
@@ -133,6 +136,8 @@ protected:
     virtual void OnDrawOrderChanged() = 0;
     /// Update source batches.
     virtual void UpdateSourceBatches() = 0;
+    /// Mark the source batches and the renderer's spatial index entry of this drawable as needing an update.
+    void MarkSourceBatchesDirty();
 
     /// Return draw order by layer and order in layer.
     int GetDrawOrder() const { return layer_ << 16u | orderInLayer_; }
@@ -145,6 +150,8 @@ protected:
     ea::vector<SourceBatch2D> sourceBatches_;
     /// Source batches dirty flag.
     bool sourceBatchesDirty_;
+    /// Source batch content version.
+    unsigned sourceBatchVersion_;
     /// Renderer2D.
     WeakPtr<Renderer2D> renderer_;
 };
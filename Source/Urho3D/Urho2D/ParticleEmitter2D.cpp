@@ -355,7 +355,7 @@ void ParticleEmitter2D::Update(float timeStep)
             emissionTime_ = Max(0.0f, emissionTime_ - timeStep);
     }
 
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
 
     OnMarkedDirty(node_);
 }
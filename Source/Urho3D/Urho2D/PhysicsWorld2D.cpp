@@ -23,7 +23,9 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
@@ -65,6 +67,8 @@ PhysicsWorld2D::PhysicsWorld2D(Context* context) :
 
 PhysicsWorld2D::~PhysicsWorld2D()
 {
+    FinishAsyncStep();
+
     for (unsigned i = 0; i < rigidBodies_.size(); ++i)
         if (rigidBodies_[i])
             rigidBodies_[i]->ReleaseBody();
@@ -89,6 +93,9 @@ void PhysicsWorld2D::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Position Iterations", GetPositionIterations, SetPositionIterations, int, DEFAULT_POSITION_ITERATIONS,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Physics FPS", GetFps, SetFps, int, DEFAULT_FPS_2D, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Async Stepping", GetAsyncStepping, SetAsyncStepping, bool, false, AM_DEFAULT);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -97,6 +104,9 @@ void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         URHO3D_PROFILE("Physics2DDrawDebug");
 
+        // The Box2D world may not be queried while a step is in flight
+        FinishAsyncStep();
+
         debugRenderer_ = debug;
         debugDepthTest_ = depthTest;
         world_->DrawDebugData();
@@ -280,6 +290,9 @@ void PhysicsWorld2D::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdatePhysics2D");
 
+    // Ensure any step from the previous frame has been fully applied
+    FinishAsyncStep();
+
     using namespace PhysicsPreStep;
 
     VariantMap& eventData = GetEventDataMap();
@@ -287,16 +300,66 @@ void PhysicsWorld2D::Update(float timeStep)
     eventData[P_TIMESTEP] = timeStep;
     SendEvent(E_PHYSICSPRESTEP, eventData);
 
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (asyncStepping_ && workQueue && workQueue->GetNumThreads())
+    {
+        // Step on a worker thread, overlapped with the rest of the frame. Results are applied in FinishAsyncStep(),
+        // at end of frame at the latest
+        asyncStepTimeStep_ = timeStep;
+        asyncStepItem_ = workQueue->AddWorkItem([this, timeStep]() { StepWorld(timeStep); });
+        return;
+    }
+
+    StepWorld(timeStep);
+    ApplyWorldTransforms();
+
+    SendBeginContactEvents();
+    SendEndContactEvents();
+
+    using namespace PhysicsPostStep;
+    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+}
+
+void PhysicsWorld2D::StepWorld(float timeStep)
+{
+    const float internalTimeStep = 1.0f / fps_;
+    const int maxSubSteps = (int)(timeStep * fps_) + 1;
+
+    timeAcc_ += timeStep;
+    // Prevent the accumulator from building up unbounded when simulation can not keep up with real time
+    if (timeAcc_ > maxSubSteps * internalTimeStep)
+        timeAcc_ = maxSubSteps * internalTimeStep;
+
     physicsStepping_ = true;
-    world_->Step(timeStep, velocityIterations_, positionIterations_);
+
+    while (timeAcc_ >= internalTimeStep)
+    {
+        if (interpolation_)
+        {
+            for (unsigned i = 0; i < rigidBodies_.size(); ++i)
+            {
+                if (rigidBodies_[i])
+                    rigidBodies_[i]->SavePreviousTransform();
+            }
+        }
+
+        world_->Step(internalTimeStep, velocityIterations_, positionIterations_);
+        timeAcc_ -= internalTimeStep;
+    }
+
     physicsStepping_ = false;
+}
+
+void PhysicsWorld2D::ApplyWorldTransforms()
+{
+    const float blendFactor = interpolation_ ? Clamp(timeAcc_ * fps_, 0.0f, 1.0f) : 1.0f;
 
     // Apply world transforms. Unparented transforms first
     for (unsigned i = 0; i < rigidBodies_.size();)
     {
         if (rigidBodies_[i])
         {
-            rigidBodies_[i]->ApplyWorldTransform();
+            rigidBodies_[i]->ApplyWorldTransform(blendFactor);
             ++i;
         }
         else
@@ -324,14 +387,38 @@ void PhysicsWorld2D::Update(float timeStep)
                 ++i;
         }
     }
+}
+
+void PhysicsWorld2D::FinishAsyncStep()
+{
+    if (!asyncStepItem_)
+        return;
+
+    {
+        URHO3D_PROFILE("WaitPhysics2DStep");
+        while (!asyncStepItem_->completed_)
+            Time::Sleep(0);
+    }
+    asyncStepItem_.Reset();
+
+    ApplyWorldTransforms();
 
     SendBeginContactEvents();
     SendEndContactEvents();
 
     using namespace PhysicsPostStep;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_WORLD] = this;
+    eventData[P_TIMESTEP] = asyncStepTimeStep_;
     SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
+void PhysicsWorld2D::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    FinishAsyncStep();
+}
+
 void PhysicsWorld2D::DrawDebugGeometry()
 {
     auto* debug = GetComponent<DebugRenderer>();
@@ -427,6 +514,31 @@ void PhysicsWorld2D::SetPositionIterations(int positionIterations)
     positionIterations_ = positionIterations;
 }
 
+void PhysicsWorld2D::SetFps(int fps)
+{
+    fps_ = Clamp(fps, 1, 1000);
+}
+
+void PhysicsWorld2D::SetInterpolation(bool enable)
+{
+    interpolation_ = enable;
+}
+
+void PhysicsWorld2D::SetAsyncStepping(bool enable)
+{
+    if (enable == asyncStepping_)
+        return;
+
+    FinishAsyncStep();
+    asyncStepping_ = enable;
+
+    // When stepping asynchronously, use end of frame as the latest point to apply the simulation results
+    if (asyncStepping_)
+        SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(PhysicsWorld2D, HandleEndFrame));
+    else
+        UnsubscribeFromEvent(E_ENDFRAME);
+}
+
 void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
 {
     if (!rigidBody)
@@ -436,6 +548,9 @@ void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
     if (rigidBodies_.contains(rigidBodyPtr))
         return;
 
+    // The body list is read during the simulation step, which may be running on a worker thread
+    FinishAsyncStep();
+
     rigidBodies_.push_back(rigidBodyPtr);
 }
 
@@ -444,6 +559,9 @@ void PhysicsWorld2D::RemoveRigidBody(RigidBody2D* rigidBody)
     if (!rigidBody)
         return;
 
+    // The body list is read during the simulation step, which may be running on a worker thread
+    FinishAsyncStep();
+
     WeakPtr<RigidBody2D> rigidBodyPtr(rigidBody);
     rigidBodies_.erase_first(rigidBodyPtr);
 }
@@ -499,6 +617,9 @@ void PhysicsWorld2D::Raycast(ea::vector<PhysicsRaycastResult2D>& results, const
 {
     results.clear();
 
+    // The Box2D world may not be queried while a step is in flight
+    FinishAsyncStep();
+
     RayCastCallback callback(results, startPoint, collisionMask);
     world_->RayCast(&callback, ToB2Vec2(startPoint), ToB2Vec2(endPoint));
 }
@@ -556,6 +677,9 @@ void PhysicsWorld2D::RaycastSingle(PhysicsRaycastResult2D& result, const Vector2
 {
     result.body_ = nullptr;
 
+    // The Box2D world may not be queried while a step is in flight
+    FinishAsyncStep();
+
     SingleRayCastCallback callback(result, startPoint, collisionMask);
     world_->RayCast(&callback, ToB2Vec2(startPoint), ToB2Vec2(endPoint));
 }
@@ -605,6 +729,9 @@ private:
 
 RigidBody2D* PhysicsWorld2D::GetRigidBody(const Vector2& point, unsigned collisionMask)
 {
+    // The Box2D world may not be queried while a step is in flight
+    FinishAsyncStep();
+
     PointQueryCallback callback(ToB2Vec2(point), collisionMask);
 
     b2AABB b2Aabb;
@@ -667,6 +794,9 @@ private:
 
 void PhysicsWorld2D::GetRigidBodies(ea::vector<RigidBody2D*>& results, const Rect& aabb, unsigned collisionMask)
 {
+    // The Box2D world may not be queried while a step is in flight
+    FinishAsyncStep();
+
     AabbQueryCallback callback(results, collisionMask);
 
     b2AABB b2Aabb;
@@ -704,20 +834,23 @@ bool PhysicsWorld2D::GetAutoClearForces() const
 
 void PhysicsWorld2D::OnSceneSet(Scene* scene)
 {
-    // Subscribe to the scene subsystem update, which will trigger the physics simulation step
+    // Subscribe to the scene subsystem update signal, which will trigger the physics simulation step
     if (scene)
-        SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld2D, HandleSceneSubsystemUpdate));
-    else
-        UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+    {
+        scene_ = scene;
+        scene_->onSubsystemUpdate_.Unsubscribe(this);
+        scene_->onSubsystemUpdate_.Subscribe(this, &PhysicsWorld2D::HandleSceneSubsystemUpdate);
+    }
+    else if (scene_)
+        scene_->onSubsystemUpdate_.Unsubscribe(this);
 }
 
-void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+void PhysicsWorld2D::HandleSceneSubsystemUpdate(float& timeStep)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace SceneSubsystemUpdate;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(timeStep);
 }
 
 void PhysicsWorld2D::SendBeginContactEvents()
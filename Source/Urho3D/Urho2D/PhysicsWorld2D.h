@@ -33,6 +33,10 @@ namespace Urho3D
 class Camera;
 class CollisionShape2D;
 class RigidBody2D;
+struct WorkItem;
+
+/// Default 2D physics simulation step frequency.
+static const int DEFAULT_FPS_2D = 60;
 
 /// 2D Physics raycast hit.
 struct URHO3D_API PhysicsRaycastResult2D
@@ -110,6 +114,12 @@ public:
     void Update(float timeStep);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
+    /// Set simulation step frequency. The world is advanced in fixed steps of this length, decoupled from the rendering frame rate.
+    void SetFps(int fps);
+    /// Set whether to interpolate node transforms between the last two simulation steps. Default true.
+    void SetInterpolation(bool enable);
+    /// Set whether to run the simulation step on a worker thread, overlapped with the rest of the frame. Node transforms and physics events are then applied at end of frame. Default false.
+    void SetAsyncStepping(bool enable);
     /// Enable or disable automatic physics simulation during scene update. Enabled by default.
     void SetUpdateEnabled(bool enable);
     /// Set draw shape.
@@ -144,6 +154,8 @@ public:
     void RemoveRigidBody(RigidBody2D* rigidBody);
     /// Add a delayed world transform assignment. Called by RigidBody2D.
     void AddDelayedWorldTransform(const DelayedWorldTransform2D& transform);
+    /// Complete an in-flight asynchronous simulation step and apply its results. Called automatically before queries and modifications of the Box2D world.
+    void FinishAsyncStep();
 
     /// Perform a physics world raycast and return all hits.
     void Raycast(ea::vector<PhysicsRaycastResult2D>& results, const Vector2& startPoint, const Vector2& endPoint,
@@ -187,6 +199,15 @@ public:
     /// Return auto clear forces.
     bool GetAutoClearForces() const;
 
+    /// Return simulation step frequency.
+    int GetFps() const { return fps_; }
+
+    /// Return whether transform interpolation is enabled.
+    bool GetInterpolation() const { return interpolation_; }
+
+    /// Return whether asynchronous stepping is enabled.
+    bool GetAsyncStepping() const { return asyncStepping_; }
+
     /// Return gravity.
     const Vector2& GetGravity() const { return gravity_; }
 
@@ -210,7 +231,13 @@ protected:
     void OnSceneSet(Scene* scene) override;
 
     /// Handle the scene subsystem update event, step simulation here.
-    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneSubsystemUpdate(float& timeStep);
+    /// Step the world in fixed increments, accumulating left-over frame time. May be called from a worker thread.
+    void StepWorld(float timeStep);
+    /// Apply simulation results to scene nodes, interpolating between the last two steps when enabled.
+    void ApplyWorldTransforms();
+    /// Handle end of frame. Completes an asynchronous step.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -224,6 +251,18 @@ protected:
     int velocityIterations_{};
     /// Position iterations.
     int positionIterations_{};
+    /// Simulation step frequency.
+    int fps_{DEFAULT_FPS_2D};
+    /// Interpolation flag.
+    bool interpolation_{true};
+    /// Asynchronous stepping flag.
+    bool asyncStepping_{};
+    /// Left-over frame time not yet consumed by fixed simulation steps.
+    float timeAcc_{};
+    /// Time step handed to an in-flight asynchronous step.
+    float asyncStepTimeStep_{};
+    /// Work item of an in-flight asynchronous step.
+    SharedPtr<WorkItem> asyncStepItem_;
 
     /// Extra weak pointer to scene to allow for cleanup in case the world is destroyed before other components.
     WeakPtr<Scene> scene_;
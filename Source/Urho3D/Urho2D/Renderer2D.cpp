@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
@@ -40,6 +41,8 @@
 #include "../IO/Log.h"
 #include "../Scene/Node.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+#include "../Urho2D/AnimatedSprite2D.h"
 #include "../Urho2D/Drawable2D.h"
 #include "../Urho2D/Renderer2D.h"
 
@@ -50,6 +53,25 @@ namespace Urho3D
 
 static const unsigned MASK_VERTEX2D = MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1;
 
+static const float DRAWABLE_CELL_SIZE = 4.0f;
+static const int MAX_DRAWABLE_CELL_SPAN = 8;
+static const IntRect NO_CELLS(0, 0, -1, -1);
+static const IntRect OVERSIZED_CELLS(M_MIN_INT, M_MIN_INT, M_MAX_INT, M_MAX_INT);
+
+static inline unsigned long long GetCellKey(int x, int y)
+{
+    return ((unsigned long long)(unsigned)y << 32u) | (unsigned)x;
+}
+
+static inline IntRect GetCellRange(const BoundingBox& box)
+{
+    return IntRect(
+        (int)floorf(box.min_.x_ / DRAWABLE_CELL_SIZE),
+        (int)floorf(box.min_.y_ / DRAWABLE_CELL_SIZE),
+        (int)floorf(box.max_.x_ / DRAWABLE_CELL_SIZE),
+        (int)floorf(box.max_.y_ / DRAWABLE_CELL_SIZE));
+}
+
 ViewBatchInfo2D::ViewBatchInfo2D() :
     vertexBufferUpdateFrameNumber_(0),
     indexCount_(0),
@@ -63,6 +85,7 @@ Renderer2D::Renderer2D(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
     material_(context->CreateObject<Material>()),
     indexBuffer_(context_->CreateObject<IndexBuffer>()),
+    animationTimeStep_(0.0f),
     viewMask_(DEFAULT_VIEWMASK)
 {
     material_->SetName("Urho2D");
@@ -79,6 +102,7 @@ Renderer2D::Renderer2D(Context* context) :
 
     frame_.frameNumber_ = 0;
     SubscribeToEvent(E_BEGINVIEWUPDATE, URHO3D_HANDLER(Renderer2D, HandleBeginViewUpdate));
+    SubscribeToEvent(E_SCENEPOSTUPDATE, URHO3D_HANDLER(Renderer2D, HandleScenePostUpdate));
 }
 
 Renderer2D::~Renderer2D() = default;
@@ -193,21 +217,38 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
     {
         unsigned vertexCount = viewBatchInfo.vertexCount_;
         VertexBuffer* vertexBuffer = viewBatchInfo.vertexBuffer_;
+        const ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
+
+        bool fullUpdate = false;
         if (vertexBuffer->GetVertexCount() < vertexCount)
+        {
             vertexBuffer->SetSize(vertexCount, MASK_VERTEX2D, true);
+            fullUpdate = true;
+        }
+        if (vertexBuffer->IsDataLost() || viewBatchInfo.uploadedBatches_.size() != sourceBatches.size())
+            fullUpdate = true;
 
-        if (vertexCount)
+        if (vertexCount && fullUpdate)
         {
             auto* dest = reinterpret_cast<Vertex2D*>(vertexBuffer->Lock(0, vertexCount, true));
             if (dest)
             {
-                const ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
+                viewBatchInfo.uploadedBatches_.resize(sourceBatches.size());
+                viewBatchInfo.uploadedStarts_.resize(sourceBatches.size());
+                viewBatchInfo.uploadedVersions_.resize(sourceBatches.size());
+
+                unsigned start = 0;
                 for (unsigned b = 0; b < sourceBatches.size(); ++b)
                 {
                     const ea::vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
                     for (unsigned i = 0; i < vertices.size(); ++i)
                         dest[i] = vertices[i];
                     dest += vertices.size();
+
+                    viewBatchInfo.uploadedBatches_[b] = sourceBatches[b];
+                    viewBatchInfo.uploadedStarts_[b] = start;
+                    viewBatchInfo.uploadedVersions_[b] = sourceBatches[b]->owner_->GetSourceBatchVersion();
+                    start += vertices.size();
                 }
 
                 vertexBuffer->Unlock();
@@ -215,6 +256,45 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
             else
                 URHO3D_LOGERROR("Failed to lock vertex buffer");
         }
+        else if (vertexCount)
+        {
+            // Upload only the regions whose source batches changed, coalescing adjacent dirty batches
+            ea::vector<Vertex2D> staging;
+            unsigned runStart = 0;
+            unsigned start = 0;
+
+            for (unsigned b = 0; b < sourceBatches.size(); ++b)
+            {
+                const SourceBatch2D* batch = sourceBatches[b];
+                const ea::vector<Vertex2D>& vertices = batch->vertices_;
+                const unsigned version = batch->owner_->GetSourceBatchVersion();
+
+                // Note: the stored batch pointer is only compared, never dereferenced, so stale pointers are safe
+                const bool dirty = viewBatchInfo.uploadedBatches_[b] != batch ||
+                    viewBatchInfo.uploadedStarts_[b] != start || viewBatchInfo.uploadedVersions_[b] != version;
+
+                if (dirty)
+                {
+                    if (staging.empty())
+                        runStart = start;
+                    staging.insert(staging.end(), vertices.begin(), vertices.end());
+
+                    viewBatchInfo.uploadedBatches_[b] = batch;
+                    viewBatchInfo.uploadedStarts_[b] = start;
+                    viewBatchInfo.uploadedVersions_[b] = version;
+                }
+                else if (!staging.empty())
+                {
+                    vertexBuffer->SetDataRange(staging.data(), runStart, staging.size());
+                    staging.clear();
+                }
+
+                start += vertices.size();
+            }
+
+            if (!staging.empty())
+                vertexBuffer->SetDataRange(staging.data(), runStart, staging.size());
+        }
 
         viewBatchInfo.vertexBufferUpdateFrameNumber_ = frame_.frameNumber_;
     }
@@ -231,6 +311,8 @@ void Renderer2D::AddDrawable(Drawable2D* drawable)
         return;
 
     drawables_.push_back(drawable);
+    drawableCells_[drawable] = NO_CELLS;
+    dirtyCellDrawables_.insert(drawable);
 }
 
 void Renderer2D::RemoveDrawable(Drawable2D* drawable)
@@ -239,6 +321,30 @@ void Renderer2D::RemoveDrawable(Drawable2D* drawable)
         return;
 
     drawables_.erase_first(drawable);
+
+    auto i = drawableCells_.find(drawable);
+    if (i != drawableCells_.end())
+    {
+        RemoveFromCells(drawable, i->second);
+        drawableCells_.erase(i);
+    }
+    dirtyCellDrawables_.erase(drawable);
+}
+
+void Renderer2D::AddAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite || animatedSprites_.contains(animatedSprite))
+        return;
+
+    animatedSprites_.push_back(animatedSprite);
+}
+
+void Renderer2D::RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite)
+        return;
+
+    animatedSprites_.erase_first(animatedSprite);
 }
 
 Material* Renderer2D::GetMaterial(Texture2D* texture, BlendMode blendMode)
@@ -275,6 +381,90 @@ bool Renderer2D::CheckVisibility(Drawable2D* drawable) const
     return frustum_.IsInsideFast(box) != OUTSIDE;
 }
 
+void Renderer2D::QueueCellUpdate(Drawable2D* drawable)
+{
+    // May be called from worker threads during the batched animation update
+    MutexLock lock(cellUpdateMutex_);
+
+    // Ignore drawables not (yet) registered to the renderer
+    if (drawableCells_.contains(drawable))
+        dirtyCellDrawables_.insert(drawable);
+}
+
+void Renderer2D::UpdateDirtyCells()
+{
+    for (Drawable2D* drawable : dirtyCellDrawables_)
+    {
+        const BoundingBox& box = drawable->GetWorldBoundingBox();
+
+        IntRect range = NO_CELLS;
+        if (box.Defined())
+        {
+            range = GetCellRange(box);
+            if (range.Width() >= MAX_DRAWABLE_CELL_SPAN || range.Height() >= MAX_DRAWABLE_CELL_SPAN)
+                range = OVERSIZED_CELLS;
+        }
+
+        IntRect& currentRange = drawableCells_[drawable];
+        if (range == currentRange)
+            continue;
+
+        RemoveFromCells(drawable, currentRange);
+        InsertToCells(drawable, range);
+        currentRange = range;
+    }
+
+    dirtyCellDrawables_.clear();
+}
+
+void Renderer2D::InsertToCells(Drawable2D* drawable, const IntRect& range)
+{
+    if (range == NO_CELLS)
+        return;
+
+    if (range == OVERSIZED_CELLS)
+    {
+        oversizedDrawables_.push_back(drawable);
+        return;
+    }
+
+    for (int y = range.top_; y <= range.bottom_; ++y)
+    {
+        for (int x = range.left_; x <= range.right_; ++x)
+        {
+            DrawableCell2D& cell = cells_[GetCellKey(x, y)];
+            cell.coords_ = IntVector2(x, y);
+            cell.drawables_.push_back(drawable);
+        }
+    }
+}
+
+void Renderer2D::RemoveFromCells(Drawable2D* drawable, const IntRect& range)
+{
+    if (range == NO_CELLS)
+        return;
+
+    if (range == OVERSIZED_CELLS)
+    {
+        oversizedDrawables_.erase_first(drawable);
+        return;
+    }
+
+    for (int y = range.top_; y <= range.bottom_; ++y)
+    {
+        for (int x = range.left_; x <= range.right_; ++x)
+        {
+            auto i = cells_.find(GetCellKey(x, y));
+            if (i == cells_.end())
+                continue;
+
+            i->second.drawables_.erase_first(drawable);
+            if (i->second.drawables_.empty())
+                cells_.erase(i);
+        }
+    }
+}
+
 void Renderer2D::OnWorldBoundingBoxUpdate()
 {
     // Set a large dummy bounding box to ensure the renderer is rendered
@@ -320,6 +510,78 @@ void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex)
     }
 }
 
+void UpdateAnimatedSpritesWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* renderer = reinterpret_cast<Renderer2D*>(item->aux_);
+    auto** start = reinterpret_cast<AnimatedSprite2D**>(item->start_);
+    auto** end = reinterpret_cast<AnimatedSprite2D**>(item->end_);
+
+    while (start != end)
+    {
+        AnimatedSprite2D* animatedSprite = *start++;
+        animatedSprite->UpdateAnimation(renderer->animationTimeStep_);
+    }
+}
+
+void Renderer2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    // Check that we are updating the correct scene
+    if (GetScene() != eventData[P_SCENE].GetPtr())
+        return;
+
+    if (animatedSprites_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateAnimatedSprites2D");
+
+    animationTimeStep_ = eventData[P_TIMESTEP].GetFloat();
+
+    // Update sprites that can not be updated from a worker thread on the main thread
+    threadedAnimatedSprites_.clear();
+    for (unsigned i = 0; i < animatedSprites_.size(); ++i)
+    {
+        AnimatedSprite2D* animatedSprite = animatedSprites_[i];
+        if (animatedSprite->IsUpdateThreadSafe())
+            threadedAnimatedSprites_.push_back(animatedSprite);
+        else
+            animatedSprite->UpdateAnimation(animationTimeStep_);
+    }
+
+    if (!threadedAnimatedSprites_.empty())
+    {
+        auto* queue = GetSubsystem<WorkQueue>();
+        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
+        int spritesPerItem = threadedAnimatedSprites_.size() / numWorkItems;
+
+        auto start = threadedAnimatedSprites_.begin();
+        for (int i = 0; i < numWorkItems; ++i)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = UpdateAnimatedSpritesWork;
+            item->aux_ = this;
+
+            auto end = threadedAnimatedSprites_.end();
+            if (i < numWorkItems - 1 && end - start > spritesPerItem)
+                end = start + spritesPerItem;
+
+            item->start_ = &(*start);
+            item->end_ = &(*end);
+            queue->AddWorkItem(item);
+
+            start = end;
+        }
+
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+
+    // Send events deferred during the threaded update. Handlers may add or remove sprites, so re-evaluate the size
+    for (unsigned i = 0; i < animatedSprites_.size(); ++i)
+        animatedSprites_[i]->PostUpdateAnimation();
+}
+
 void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace BeginViewUpdate;
@@ -336,15 +598,51 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
     frustum_ = camera->GetFrustum();
     viewMask_ = camera->GetViewMask();
 
+    UpdateDirtyCells();
+
+    // Collect candidates from the spatial index cells overlapping the frustum
+    {
+        URHO3D_PROFILE("CollectDrawableCandidates");
+
+        candidateDrawables_.clear();
+
+        const BoundingBox frustumBox(frustum_);
+        if (frustumBox.Defined())
+        {
+            const IntRect viewRange = GetCellRange(frustumBox);
+            for (auto i = cells_.begin(); i != cells_.end(); ++i)
+            {
+                const IntVector2& coords = i->second.coords_;
+                if (coords.x_ < viewRange.left_ || coords.x_ > viewRange.right_ ||
+                    coords.y_ < viewRange.top_ || coords.y_ > viewRange.bottom_)
+                    continue;
+
+                candidateDrawables_.insert(candidateDrawables_.end(), i->second.drawables_.begin(),
+                    i->second.drawables_.end());
+            }
+
+            candidateDrawables_.insert(candidateDrawables_.end(), oversizedDrawables_.begin(),
+                oversizedDrawables_.end());
+
+            // Drawables spanning several cells were collected once per cell
+            ea::quick_sort(candidateDrawables_.begin(), candidateDrawables_.end());
+            candidateDrawables_.erase(ea::unique(candidateDrawables_.begin(), candidateDrawables_.end()),
+                candidateDrawables_.end());
+        }
+        else
+            candidateDrawables_ = drawables_;
+    }
+
     // Check visibility
+    if (!candidateDrawables_.empty())
     {
         URHO3D_PROFILE("CheckDrawableVisibility");
 
         auto* queue = GetSubsystem<WorkQueue>();
         int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = drawables_.size() / numWorkItems;
+        int drawablesPerItem = candidateDrawables_.size() / numWorkItems;
 
-        auto start = drawables_.begin();
+        auto start = candidateDrawables_.begin();
         for (int i = 0; i < numWorkItems; ++i)
         {
             SharedPtr<WorkItem> item = queue->GetFreeItem();
@@ -352,7 +650,7 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
             item->workFunction_ = CheckDrawableVisibilityWork;
             item->aux_ = this;
 
-            auto end = drawables_.end();
+            auto end = candidateDrawables_.end();
             if (i < numWorkItems - 1 && end - start > drawablesPerItem)
                 end = start + drawablesPerItem;
 
@@ -405,18 +703,65 @@ void Renderer2D::GetDrawables(ea::vector<Drawable2D*>& drawables, Node* node)
         GetDrawables(drawables, i->Get());
 }
 
-static inline bool CompareSourceBatch2Ds(const SourceBatch2D* lhs, const SourceBatch2D* rhs)
+// Least-significant-digit radix sort over the packed source batch keys: stable byte passes over the secondary
+// key followed by the primary key, so the full 96-bit ordering of draw order, descending distance and material
+// name hash is respected. Passes where all entries share the same digit are skipped, which covers the high bytes
+// of typical draw orders and distances.
+static void RadixSortSourceBatches(ea::vector<SourceBatchSortEntry2D>& entries, ea::vector<SourceBatchSortEntry2D>& temp)
 {
-    if (lhs->drawOrder_ != rhs->drawOrder_)
-        return lhs->drawOrder_ < rhs->drawOrder_;
+    const unsigned size = entries.size();
+    if (size < 2)
+        return;
 
-    if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
+    temp.resize(size);
+    SourceBatchSortEntry2D* src = &entries[0];
+    SourceBatchSortEntry2D* dest = &temp[0];
 
-    if (lhs->material_ != rhs->material_)
-        return lhs->material_->GetNameHash() < rhs->material_->GetNameHash();
+    for (unsigned pass = 0; pass < 12; ++pass)
+    {
+        const bool loPass = pass < 8;
+        const unsigned shift = (loPass ? pass : pass - 8) * 8;
 
-    return lhs < rhs;
+        unsigned counts[256] = {};
+        if (loPass)
+        {
+            for (unsigned i = 0; i < size; ++i)
+                ++counts[(src[i].loKey_ >> shift) & 0xffu];
+        }
+        else
+        {
+            for (unsigned i = 0; i < size; ++i)
+                ++counts[(src[i].hiKey_ >> shift) & 0xffu];
+        }
+
+        const unsigned firstDigit = loPass ? ((src[0].loKey_ >> shift) & 0xffu) : ((src[0].hiKey_ >> shift) & 0xffu);
+        if (counts[firstDigit] == size)
+            continue;
+
+        unsigned start = 0;
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            const unsigned count = counts[i];
+            counts[i] = start;
+            start += count;
+        }
+
+        if (loPass)
+        {
+            for (unsigned i = 0; i < size; ++i)
+                dest[counts[(src[i].loKey_ >> shift) & 0xffu]++] = src[i];
+        }
+        else
+        {
+            for (unsigned i = 0; i < size; ++i)
+                dest[counts[(src[i].hiKey_ >> shift) & 0xffu]++] = src[i];
+        }
+
+        ea::swap(src, dest);
+    }
+
+    if (src != &entries[0])
+        entries.swap(temp);
 }
 
 void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera)
@@ -425,32 +770,41 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
     if (viewBatchInfo.batchUpdatedFrameNumber_ == frame_.frameNumber_)
         return;
 
-    ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
-    sourceBatches.clear();
-    for (unsigned d = 0; d < drawables_.size(); ++d)
+    ea::vector<SourceBatchSortEntry2D>& sortEntries = sortEntries_;
+    sortEntries.clear();
+    for (unsigned d = 0; d < candidateDrawables_.size(); ++d)
     {
-        if (!drawables_[d]->IsInView(camera))
+        if (!candidateDrawables_[d]->IsInView(camera))
             continue;
 
-        const ea::vector<SourceBatch2D>& batches = drawables_[d]->GetSourceBatches();
+        const ea::vector<SourceBatch2D>& batches = candidateDrawables_[d]->GetSourceBatches();
         for (unsigned b = 0; b < batches.size(); ++b)
         {
             if (batches[b].material_ && !batches[b].vertices_.empty())
-                sourceBatches.push_back(&batches[b]);
+                sortEntries.push_back(SourceBatchSortEntry2D{0, 0, &batches[b]});
         }
     }
 
-    for (unsigned i = 0; i < sourceBatches.size(); ++i)
+    for (unsigned i = 0; i < sortEntries.size(); ++i)
     {
-        const SourceBatch2D* sourceBatch = sourceBatches[i];
-        // if (sourceBatch->owner_)
-        {
-            Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
-            sourceBatch->distance_ = camera->GetDistance(worldPos);
-        }
+        const SourceBatch2D* sourceBatch = sortEntries[i].batch_;
+        Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
+        sourceBatch->distance_ = camera->GetDistance(worldPos);
+
+        // Pack draw order, descending distance and material name hash into the radix keys. Camera distances are
+        // non-negative, so the raw float bits order like the values and inverting them gives back-to-front order
+        // in an ascending sort
+        sortEntries[i].hiKey_ = (unsigned)sourceBatch->drawOrder_ ^ 0x80000000u;
+        sortEntries[i].loKey_ = ((unsigned long long)~FloatToRawIntBits(sourceBatch->distance_) << 32) |
+            sourceBatch->material_->GetNameHash().Value();
     }
 
-    ea::quick_sort(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds);
+    RadixSortSourceBatches(sortEntries, sortEntriesTemp_);
+
+    ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
+    sourceBatches.resize(sortEntries.size());
+    for (unsigned i = 0; i < sortEntries.size(); ++i)
+        sourceBatches[i] = sortEntries[i].batch_;
 
     viewBatchInfo.batchCount_ = 0;
     Material* currMaterial = nullptr;
@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <EASTL/hash_set.h>
+
+#include "../Core/Mutex.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Texture2D.h"
 #include "../Math/Frustum.h"
@@ -29,6 +32,7 @@
 namespace Urho3D
 {
 
+class AnimatedSprite2D;
 class Drawable2D;
 class IndexBuffer;
 class Material;
@@ -63,6 +67,32 @@ struct ViewBatchInfo2D
     ea::vector<SharedPtr<Material> > materials_;
     /// Geometries.
     ea::vector<SharedPtr<Geometry> > geometries_;
+    /// Source batches whose vertices are currently in the vertex buffer, in upload order.
+    ea::vector<const SourceBatch2D*> uploadedBatches_;
+    /// First vertex of each uploaded source batch.
+    ea::vector<unsigned> uploadedStarts_;
+    /// Source batch version of the owner at upload time.
+    ea::vector<unsigned> uploadedVersions_;
+};
+
+/// Radix sort entry of a 2D source batch with its ordering packed into integer keys.
+struct SourceBatchSortEntry2D
+{
+    /// Secondary key: inverted distance bits and material name hash.
+    unsigned long long loKey_;
+    /// Primary key: draw order mapped to unsigned.
+    unsigned hiKey_;
+    /// Source batch.
+    const SourceBatch2D* batch_;
+};
+
+/// Spatial index cell of 2D drawables.
+struct DrawableCell2D
+{
+    /// Cell coordinates.
+    IntVector2 coords_;
+    /// Drawables whose world bounding box overlaps the cell.
+    ea::vector<Drawable2D*> drawables_;
 };
 
 /// 2D renderer component.
@@ -71,6 +101,7 @@ class URHO3D_API Renderer2D : public Drawable
     URHO3D_OBJECT(Renderer2D, Drawable);
 
     friend void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex);
+    friend void UpdateAnimatedSpritesWork(const WorkItem* item, unsigned threadIndex);
 
 public:
     /// Construct.
@@ -93,12 +124,19 @@ public:
     void AddDrawable(Drawable2D* drawable);
     /// Remove Drawable2D.
     void RemoveDrawable(Drawable2D* drawable);
+    /// Add animated sprite for batched animation updates. Called by AnimatedSprite2D.
+    void AddAnimatedSprite(AnimatedSprite2D* animatedSprite);
+    /// Remove animated sprite. Called by AnimatedSprite2D.
+    void RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite);
     /// Return material by texture and blend mode.
     Material* GetMaterial(Texture2D* texture, BlendMode blendMode);
 
     /// Check visibility.
     bool CheckVisibility(Drawable2D* drawable) const;
 
+    /// Queue an update of the spatial index cells of a drawable whose transform or content changed. Called by Drawable2D.
+    void QueueCellUpdate(Drawable2D* drawable);
+
 private:
     /// Recalculate the world-space bounding box.
     void OnWorldBoundingBoxUpdate() override;
@@ -106,8 +144,16 @@ private:
     SharedPtr<Material> CreateMaterial(Texture2D* texture, BlendMode blendMode);
     /// Handle view update begin event. Determine Drawable2D's and their batches here.
     void HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle scene post-update. Updates sprite animations across worker threads.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
     /// Get all drawables in node.
     void GetDrawables(ea::vector<Drawable2D*>& drawables, Node* node);
+    /// Update the spatial index cells of the queued drawables.
+    void UpdateDirtyCells();
+    /// Add a drawable to the spatial index cells of the given range.
+    void InsertToCells(Drawable2D* drawable, const IntRect& range);
+    /// Remove a drawable from the spatial index cells of the given range.
+    void RemoveFromCells(Drawable2D* drawable, const IntRect& range);
     /// Update view batch info.
     void UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera);
     /// Add view batch.
@@ -120,6 +166,28 @@ private:
     SharedPtr<Material> material_;
     /// Drawables.
     ea::vector<Drawable2D*> drawables_;
+    /// Animated sprites updated in a batch on scene post-update.
+    ea::vector<AnimatedSprite2D*> animatedSprites_;
+    /// Animated sprites whose update runs on worker threads this frame.
+    ea::vector<AnimatedSprite2D*> threadedAnimatedSprites_;
+    /// Time step of the current batched animation update.
+    float animationTimeStep_;
+    /// Mutex for the dirty cell queue, which worker-thread animation updates may push to.
+    Mutex cellUpdateMutex_;
+    /// Spatial index cells keyed by packed cell coordinates.
+    ea::unordered_map<unsigned long long, DrawableCell2D> cells_;
+    /// Cell range currently occupied by each drawable.
+    ea::unordered_map<Drawable2D*, IntRect> drawableCells_;
+    /// Drawables spanning more cells than the per drawable limit; always view candidates.
+    ea::vector<Drawable2D*> oversizedDrawables_;
+    /// Drawables whose spatial index cells need updating.
+    ea::hash_set<Drawable2D*> dirtyCellDrawables_;
+    /// Candidate drawables of the current view, collected from the cells overlapping the frustum.
+    ea::vector<Drawable2D*> candidateDrawables_;
+    /// Scratch buffer for radix sorting the view source batches.
+    ea::vector<SourceBatchSortEntry2D> sortEntries_;
+    /// Second scratch buffer the radix sort passes scatter into.
+    ea::vector<SourceBatchSortEntry2D> sortEntriesTemp_;
     /// View frame info for current frame.
     FrameInfo frame_;
     /// View batch info.
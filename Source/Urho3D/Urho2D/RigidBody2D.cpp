@@ -50,7 +50,8 @@ static const char* bodyTypeNames[] =
 RigidBody2D::RigidBody2D(Context* context) :
     Component(context),
     useFixtureMass_(true),
-    body_(nullptr)
+    body_(nullptr),
+    previousAngle_(0.0f)
 {
     // Make sure the massData members are zero-initialized.
     massData_.mass = 0.0f;
@@ -370,6 +371,9 @@ void RigidBody2D::CreateBody()
     if (!physicsWorld_ || !physicsWorld_->GetWorld())
         return;
 
+    // The Box2D world may not be modified while a step is in flight
+    physicsWorld_->FinishAsyncStep();
+
     bodyDef_.position = ToB2Vec2(node_->GetWorldPosition());
     bodyDef_.angle = node_->GetWorldRotation().RollAngle() * M_DEGTORAD;
 
@@ -400,6 +404,9 @@ void RigidBody2D::ReleaseBody()
     if (!physicsWorld_ || !physicsWorld_->GetWorld())
         return;
 
+    // The Box2D world may not be modified while a step is in flight
+    physicsWorld_->FinishAsyncStep();
+
     // Make a copy for iteration
     ea::vector<WeakPtr<Constraint2D> > constraints = constraints_;
     for (unsigned i = 0; i < constraints.size(); ++i)
@@ -418,7 +425,22 @@ void RigidBody2D::ReleaseBody()
     body_ = nullptr;
 }
 
+void RigidBody2D::SavePreviousTransform()
+{
+    if (!body_)
+        return;
+
+    const b2Transform& transform = body_->GetTransform();
+    previousPosition_ = Vector2(transform.p.x, transform.p.y);
+    previousAngle_ = transform.q.GetAngle();
+}
+
 void RigidBody2D::ApplyWorldTransform()
+{
+    ApplyWorldTransform(1.0f);
+}
+
+void RigidBody2D::ApplyWorldTransform(float blendFactor)
 {
     if (!body_ || !node_)
         return;
@@ -435,10 +457,19 @@ void RigidBody2D::ApplyWorldTransform()
         return;
 
     const b2Transform& transform = body_->GetTransform();
+    Vector2 position(transform.p.x, transform.p.y);
+    float angle = transform.q.GetAngle();
+    if (blendFactor < 1.0f)
+    {
+        // Box2D angles accumulate without wrapping, so they can be blended directly
+        position = previousPosition_.Lerp(position, blendFactor);
+        angle = Lerp(previousAngle_, angle, blendFactor);
+    }
+
     Vector3 newWorldPosition = node_->GetWorldPosition();
-    newWorldPosition.x_ = transform.p.x;
-    newWorldPosition.y_ = transform.p.y;
-    Quaternion newWorldRotation(transform.q.GetAngle() * M_RADTODEG, Vector3::FORWARD);
+    newWorldPosition.x_ = position.x_;
+    newWorldPosition.y_ = position.y_;
+    Quaternion newWorldRotation(angle * M_RADTODEG, Vector3::FORWARD);
 
     if (parentRigidBody)
     {
@@ -109,8 +109,12 @@ public:
     /// Release body.
     void ReleaseBody();
 
+    /// Save the current simulation transform for interpolation. Called by PhysicsWorld2D before a simulation step.
+    void SavePreviousTransform();
     /// Apply world transform from the Box2D body. Called by PhysicsWorld2D.
     void ApplyWorldTransform();
+    /// Apply world transform from the Box2D body, interpolated towards the previously saved transform. Called by PhysicsWorld2D.
+    void ApplyWorldTransform(float blendFactor);
     /// Apply specified world position & rotation. Called by PhysicsWorld2D.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
     /// Add collision shape.
@@ -181,6 +185,10 @@ private:
     bool useFixtureMass_;
     /// Box2D body.
     b2Body* body_;
+    /// Simulation position before the latest step, for interpolation.
+    Vector2 previousPosition_;
+    /// Simulation angle before the latest step, for interpolation.
+    float previousAngle_;
     /// Collision shapes.
     ea::vector<WeakPtr<CollisionShape2D> > collisionShapes_;
     /// Constraints.
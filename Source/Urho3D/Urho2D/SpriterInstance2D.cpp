@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/Timer.h"
 #include "../Graphics/DrawableEvents.h"
 #include "../Scene/Component.h"
 #include "../Scene/Node.h"
@@ -35,6 +36,48 @@ namespace Urho3D
 namespace Spriter
 {
 
+bool SpriterPoseCache::Get(Animation* animation, float time, unsigned frameNumber, SpriterPose& dest)
+{
+    MutexLock lock(lock_);
+
+    BeginFrame(frameNumber);
+
+    auto i = poses_.find(animation);
+    if (i == poses_.end())
+        return false;
+
+    const ea::vector<Entry>& entries = i->second;
+    for (unsigned j = 0; j < entries.size(); ++j)
+    {
+        if (entries[j].time_ == time)
+        {
+            dest = entries[j].pose_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SpriterPoseCache::Put(Animation* animation, float time, unsigned frameNumber, const SpriterPose& pose)
+{
+    MutexLock lock(lock_);
+
+    BeginFrame(frameNumber);
+
+    // Another thread may have stored the same pose meanwhile; a duplicate entry is harmless
+    poses_[animation].push_back(Entry{time, pose});
+}
+
+void SpriterPoseCache::BeginFrame(unsigned frameNumber)
+{
+    if (frameNumber != frameNumber_)
+    {
+        poses_.clear();
+        frameNumber_ = frameNumber;
+    }
+}
+
 SpriterInstance::SpriterInstance(Component* owner, SpriterData* spriteData) :
     owner_(owner),
     spriterData_(spriteData),
@@ -146,28 +189,40 @@ void SpriterInstance::Update(float deltaTime)
             sendFinishEvent = lastTime != currentTime_;
         }
 
-        if (sendFinishEvent && owner_)
-        {
-            Node* senderNode = owner_->GetNode();
-            if (senderNode)
-            {
-                using namespace AnimationFinished;
-
-                VariantMap& eventData = senderNode->GetEventDataMap();
-                eventData[P_NODE] = senderNode;
-                eventData[P_ANIMATION] = animation_;
-                eventData[P_NAME] = animation_->name_;
-                eventData[P_LOOPED] = looping_;
-
-                senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
-            }
-        }
+        // Defer the event, as the update may run on a worker thread
+        if (sendFinishEvent)
+            finishEventPending_ = true;
     }
 
     UpdateMainlineKey();
     UpdateTimelineKeys();
 }
 
+void SpriterInstance::SendFinishEvent()
+{
+    if (!finishEventPending_)
+        return;
+
+    finishEventPending_ = false;
+
+    if (!animation_ || !owner_)
+        return;
+
+    Node* senderNode = owner_->GetNode();
+    if (senderNode)
+    {
+        using namespace AnimationFinished;
+
+        VariantMap& eventData = senderNode->GetEventDataMap();
+        eventData[P_NODE] = senderNode;
+        eventData[P_ANIMATION] = animation_;
+        eventData[P_NAME] = animation_->name_;
+        eventData[P_LOOPED] = looping_;
+
+        senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
+    }
+}
+
 void SpriterInstance::OnSetEntity(Entity* entity)
 {
     if (entity == this->entity_)
@@ -195,76 +250,75 @@ void SpriterInstance::OnSetAnimation(Animation* animation, LoopMode loopMode)
     }
 
     currentTime_ = 0.0f;
+    finishEventPending_ = false;
     Clear();
 }
 
 void SpriterInstance::UpdateTimelineKeys()
 {
-    for (unsigned i = 0; i < mainlineKey_->boneRefs_.size(); ++i)
+    // Only default root spatial info poses are shareable, as the pose bakes in the root transform
+    if (poseCache_ && owner_ && HasDefaultSpatialInfo())
     {
-        Ref* ref = mainlineKey_->boneRefs_[i];
-        auto* timelineKey = (BoneTimelineKey*)GetTimelineKey(ref);
-        if (ref->parent_ >= 0)
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
-        }
-        else
+        auto* time = owner_->GetSubsystem<Time>();
+        const unsigned frameNumber = time ? time->GetFrameNumber() : 0;
+
+        if (!poseCache_->Get(animation_, currentTime_, frameNumber, pose_))
         {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(spatialInfo_);
+            UpdatePose();
+            poseCache_->Put(animation_, currentTime_, frameNumber, pose_);
         }
-        timelineKeys_.push_back(timelineKey);
     }
+    else
+        UpdatePose();
+
+    RebuildTimelineKeys();
+}
+
+void SpriterInstance::UpdatePose()
+{
+    pose_.boneKeys_.clear();
+    pose_.spriteKeys_.clear();
 
-    for (unsigned i = 0; i < mainlineKey_->objectRefs_.size(); ++i)
+    const ea::vector<Ref*>& boneRefs = mainlineKey_->boneRefs_;
+    pose_.boneKeys_.reserve(boneRefs.size());
+    for (unsigned i = 0; i < boneRefs.size(); ++i)
     {
-        Ref* ref = mainlineKey_->objectRefs_[i];
-        auto* timelineKey = (SpriteTimelineKey*)GetTimelineKey(ref);
+        Ref* ref = boneRefs[i];
+        Timeline* timeline = animation_->timelines_[ref->timeline_];
+        pose_.boneKeys_.push_back(*(BoneTimelineKey*)timeline->keys_[ref->key_]);
+
+        BoneTimelineKey& key = pose_.boneKeys_.back();
+        InterpolateTimelineKey(key, ref);
 
         if (ref->parent_ >= 0)
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
-        }
+            key.info_ = key.info_.UnmapFromParent(pose_.boneKeys_[ref->parent_].info_);
         else
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(spatialInfo_);
-        }
-
-        timelineKey->zIndex_ = ref->zIndex_;
-
-        timelineKeys_.push_back(timelineKey);
+            key.info_ = key.info_.UnmapFromParent(spatialInfo_);
     }
-}
 
-void SpriterInstance::UpdateMainlineKey()
-{
-    const ea::vector<MainlineKey*>& mainlineKeys = animation_->mainlineKeys_;
-    for (unsigned i = 0; i < mainlineKeys.size(); ++i)
+    const ea::vector<Ref*>& objectRefs = mainlineKey_->objectRefs_;
+    pose_.spriteKeys_.reserve(objectRefs.size());
+    for (unsigned i = 0; i < objectRefs.size(); ++i)
     {
-        if (mainlineKeys[i]->time_ <= currentTime_)
-        {
-            mainlineKey_ = mainlineKeys[i];
-        }
+        Ref* ref = objectRefs[i];
+        Timeline* timeline = animation_->timelines_[ref->timeline_];
+        pose_.spriteKeys_.push_back(*(SpriteTimelineKey*)timeline->keys_[ref->key_]);
 
-        if (mainlineKeys[i]->time_ >= currentTime_)
-        {
-            break;
-        }
-    }
+        SpriteTimelineKey& key = pose_.spriteKeys_.back();
+        InterpolateTimelineKey(key, ref);
 
-    if (!mainlineKey_)
-    {
-        mainlineKey_ = mainlineKeys[0];
+        if (ref->parent_ >= 0)
+            key.info_ = key.info_.UnmapFromParent(pose_.boneKeys_[ref->parent_].info_);
+        else
+            key.info_ = key.info_.UnmapFromParent(spatialInfo_);
     }
 }
 
-TimelineKey* SpriterInstance::GetTimelineKey(Ref* ref) const
+void SpriterInstance::InterpolateTimelineKey(SpatialTimelineKey& key, Ref* ref) const
 {
     Timeline* timeline = animation_->timelines_[ref->timeline_];
-    TimelineKey* timelineKey = timeline->keys_[ref->key_]->Clone();
-    if (timeline->keys_.size() == 1 || timelineKey->curveType_ == INSTANT)
-    {
-        return timelineKey;
-    }
+    if (timeline->keys_.size() == 1 || key.curveType_ == INSTANT)
+        return;
 
     unsigned nextTimelineKeyIndex = ref->key_ + 1;
     if (nextTimelineKeyIndex >= timeline->keys_.size())
@@ -275,36 +329,73 @@ TimelineKey* SpriterInstance::GetTimelineKey(Ref* ref) const
         }
         else
         {
-            return timelineKey;
+            return;
         }
     }
 
     TimelineKey* nextTimelineKey = timeline->keys_[nextTimelineKeyIndex];
 
     float nextTimelineKeyTime = nextTimelineKey->time_;
-    if (nextTimelineKey->time_ < timelineKey->time_)
+    if (nextTimelineKey->time_ < key.time_)
     {
         nextTimelineKeyTime += animation_->length_;
     }
 
-    float t = timelineKey->GetTByCurveType(currentTime_, nextTimelineKeyTime);
-    timelineKey->Interpolate(*nextTimelineKey, t);
+    float t = key.GetTByCurveType(currentTime_, nextTimelineKeyTime);
+    key.Interpolate(*nextTimelineKey, t);
+}
+
+void SpriterInstance::RebuildTimelineKeys()
+{
+    timelineKeys_.clear();
+    timelineKeys_.reserve(pose_.boneKeys_.size() + pose_.spriteKeys_.size());
+
+    for (unsigned i = 0; i < pose_.boneKeys_.size(); ++i)
+        timelineKeys_.push_back(&pose_.boneKeys_[i]);
 
-    return timelineKey;
+    const ea::vector<Ref*>& objectRefs = mainlineKey_->objectRefs_;
+    for (unsigned i = 0; i < pose_.spriteKeys_.size(); ++i)
+    {
+        // The z index is run time data of the mainline ref, not part of the shareable pose
+        if (i < objectRefs.size())
+            pose_.spriteKeys_[i].zIndex_ = objectRefs[i]->zIndex_;
+        timelineKeys_.push_back(&pose_.spriteKeys_[i]);
+    }
 }
 
-void SpriterInstance::Clear()
+bool SpriterInstance::HasDefaultSpatialInfo() const
 {
-    mainlineKey_ = nullptr;
+    return spatialInfo_.x_ == 0.0f && spatialInfo_.y_ == 0.0f && spatialInfo_.angle_ == 0.0f &&
+        spatialInfo_.scaleX_ == 1.0f && spatialInfo_.scaleY_ == 1.0f && spatialInfo_.alpha_ == 1.0f &&
+        spatialInfo_.spin_ == 1;
+}
 
-    if (!timelineKeys_.empty())
+void SpriterInstance::UpdateMainlineKey()
+{
+    const ea::vector<MainlineKey*>& mainlineKeys = animation_->mainlineKeys_;
+    for (unsigned i = 0; i < mainlineKeys.size(); ++i)
     {
-        for (unsigned i = 0; i < timelineKeys_.size(); ++i)
+        if (mainlineKeys[i]->time_ <= currentTime_)
+        {
+            mainlineKey_ = mainlineKeys[i];
+        }
+
+        if (mainlineKeys[i]->time_ >= currentTime_)
         {
-            delete timelineKeys_[i];
+            break;
         }
-        timelineKeys_.clear();
     }
+
+    if (!mainlineKey_)
+    {
+        mainlineKey_ = mainlineKeys[0];
+    }
+}
+
+void SpriterInstance::Clear()
+{
+    mainlineKey_ = nullptr;
+    timelineKeys_.clear();
 }
 
 }
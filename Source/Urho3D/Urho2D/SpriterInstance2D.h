@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <EASTL/unordered_map.h>
+
+#include "../Core/Mutex.h"
 #include "../Urho2D/SpriterData2D.h"
 
 namespace Urho3D
@@ -42,6 +45,45 @@ enum LoopMode
     ForceClamped,
 };
 
+/// Evaluated Spriter pose: interpolated and hierarchy-resolved timeline keys for one animation at one playback time.
+struct SpriterPose
+{
+    /// Evaluated bone keys in mainline bone ref order.
+    ea::vector<BoneTimelineKey> boneKeys_;
+    /// Evaluated sprite keys in mainline object ref order.
+    ea::vector<SpriteTimelineKey> spriteKeys_;
+};
+
+/// Cache of evaluated poses shared by all instances of an animation set. Poses are keyed by animation and playback time and kept for one frame, so instances at the same playback time share a single evaluation. Thread-safe.
+class SpriterPoseCache
+{
+public:
+    /// Copy a cached pose to the destination. Return false if the pose has not been evaluated on the given frame.
+    bool Get(Animation* animation, float time, unsigned frameNumber, SpriterPose& dest);
+    /// Store an evaluated pose.
+    void Put(Animation* animation, float time, unsigned frameNumber, const SpriterPose& pose);
+
+private:
+    /// Drop poses evaluated on an earlier frame. Must be called with the mutex held.
+    void BeginFrame(unsigned frameNumber);
+
+    /// Cached pose and the playback time it was evaluated at.
+    struct Entry
+    {
+        /// Playback time.
+        float time_;
+        /// Evaluated pose.
+        SpriterPose pose_;
+    };
+
+    /// Mutex for the pose map.
+    Mutex lock_;
+    /// Cached poses per animation.
+    ea::unordered_map<Animation*, ea::vector<Entry> > poses_;
+    /// Frame number the cached poses were evaluated on.
+    unsigned frameNumber_{};
+};
+
 /// Spriter instance.
 class SpriterInstance
 {
@@ -63,8 +105,12 @@ public:
     void setSpatialInfo(const Spriter::SpatialInfo& spatialInfo);
     /// Set root spatial info.
     void setSpatialInfo(float x, float y, float angle, float scaleX, float scaleY);
-    /// Update animation.
+    /// Set shared pose cache. Instances sharing a cache reuse pose evaluations at equal playback times.
+    void SetPoseCache(SpriterPoseCache* poseCache) { poseCache_ = poseCache; }
+    /// Update animation. May be called from a worker thread; events are deferred until SendFinishEvent().
     void Update(float deltaTime);
+    /// Send the animation finished event deferred by Update(). Must be called from the main thread.
+    void SendFinishEvent();
 
     /// Return current entity.
     Spriter::Entity* GetEntity() const { return entity_; }
@@ -82,10 +128,16 @@ private:
     void OnSetAnimation(Animation* animation, LoopMode loopMode = Default);
     /// Update mainline key.
     void UpdateMainlineKey();
-    /// Update timeline keys.
+    /// Update timeline keys, reusing a cached pose when available.
     void UpdateTimelineKeys();
-    /// Get timeline key by ref.
-    TimelineKey* GetTimelineKey(Ref* ref) const;
+    /// Evaluate the current pose from the mainline key.
+    void UpdatePose();
+    /// Interpolate an evaluated timeline key towards the next key of its timeline.
+    void InterpolateTimelineKey(SpatialTimelineKey& key, Ref* ref) const;
+    /// Rebuild the timeline key pointer list from the current pose.
+    void RebuildTimelineKeys();
+    /// Return whether the root spatial info is the default, making the pose shareable between instances.
+    bool HasDefaultSpatialInfo() const;
     /// Clear mainline key and timeline keys.
     void Clear();
 
@@ -105,8 +157,14 @@ private:
     float currentTime_{};
     /// Current mainline key.
     MainlineKey* mainlineKey_{};
+    /// Current evaluated pose. Storage for the timeline key pointers.
+    SpriterPose pose_;
     /// Current timeline keys.
     ea::vector<SpatialTimelineKey*> timelineKeys_;
+    /// Shared pose cache of the animation set.
+    SpriterPoseCache* poseCache_{};
+    /// Animation finished event pending flag.
+    bool finishEventPending_{};
 };
 
 }
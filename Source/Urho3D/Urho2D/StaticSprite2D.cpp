@@ -37,6 +37,8 @@
 namespace Urho3D
 {
 
+URHO3D_DEFINE_OBJECT_POOL(StaticSprite2D)
+
 extern const char* URHO2D_CATEGORY;
 
 StaticSprite2D::StaticSprite2D(Context* context) :
@@ -89,7 +91,7 @@ void StaticSprite2D::SetSprite(Sprite2D* sprite)
     sprite_ = sprite;
     UpdateMaterial();
 
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
 
     UpdateDrawRect();
@@ -101,7 +103,7 @@ void StaticSprite2D::SetDrawRect(const Rect& rect)
 
     if(useDrawRect_)
     {
-        sourceBatchesDirty_ = true;
+        MarkSourceBatchesDirty();
     }
 }
 
@@ -111,7 +113,7 @@ void StaticSprite2D::SetTextureRect(const Rect& rect)
 
     if(useTextureRect_)
     {
-        sourceBatchesDirty_ = true;
+        MarkSourceBatchesDirty();
     }
 }
 
@@ -134,7 +136,7 @@ void StaticSprite2D::SetFlip(bool flipX, bool flipY, bool swapXY)
     flipX_ = flipX;
     flipY_ = flipY;
     swapXY_ = swapXY;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
 
     MarkNetworkUpdate();
 }
@@ -160,7 +162,7 @@ void StaticSprite2D::SetColor(const Color& color)
         return;
 
     color_ = color;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
 }
 
@@ -170,7 +172,7 @@ void StaticSprite2D::SetAlpha(float alpha)
         return;
 
     color_.a_ = alpha;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
 }
 
@@ -180,7 +182,7 @@ void StaticSprite2D::SetUseHotSpot(bool useHotSpot)
         return;
 
     useHotSpot_ = useHotSpot;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
     UpdateDrawRect();
 }
@@ -191,7 +193,7 @@ void StaticSprite2D::SetUseDrawRect(bool useDrawRect)
         return;
 
     useDrawRect_ = useDrawRect;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
     UpdateDrawRect();
 }
@@ -202,7 +204,7 @@ void StaticSprite2D::SetUseTextureRect(bool useTextureRect)
         return;
 
     useTextureRect_ = useTextureRect;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
     MarkNetworkUpdate();
 }
 
@@ -215,7 +217,7 @@ void StaticSprite2D::SetHotSpot(const Vector2& hotspot)
 
     if (useHotSpot_)
     {
-        sourceBatchesDirty_ = true;
+        MarkSourceBatchesDirty();
         MarkNetworkUpdate();
     }
 
@@ -228,7 +230,7 @@ void StaticSprite2D::SetCustomMaterial(Material* customMaterial)
         return;
 
     customMaterial_ = customMaterial;
-    sourceBatchesDirty_ = true;
+    MarkSourceBatchesDirty();
 
     UpdateMaterial();
     MarkNetworkUpdate();
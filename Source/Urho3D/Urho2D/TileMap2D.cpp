@@ -53,6 +53,7 @@ void TileMap2D::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Tmx File", GetTmxFileAttr, SetTmxFileAttr, ResourceRef, ResourceRef(TmxFile2D::GetTypeStatic()),
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Chunked Rendering", GetUseChunkedRendering, SetUseChunkedRendering, bool, false, AM_DEFAULT);
 }
 
 // Transform vector from node-local space to global space
@@ -144,6 +145,7 @@ void TileMap2D::SetTmxFile(TmxFile2D* tmxFile)
         Node* layerNode(rootNode_->CreateTemporaryChild(tmxLayer->GetName(), LOCAL));
 
         auto* layer = layerNode->CreateComponent<TileMapLayer2D>();
+        layer->SetUseChunkedRendering(useChunkedRendering_);
         layer->Initialize(this, tmxLayer);
         layer->SetDrawOrder(i * 10);
 
@@ -151,6 +153,22 @@ void TileMap2D::SetTmxFile(TmxFile2D* tmxFile)
     }
 }
 
+void TileMap2D::SetUseChunkedRendering(bool enable)
+{
+    if (enable == useChunkedRendering_)
+        return;
+
+    useChunkedRendering_ = enable;
+
+    // Recreate the layers in the new mode
+    if (tmxFile_)
+    {
+        SharedPtr<TmxFile2D> tmxFile(tmxFile_);
+        SetTmxFile(nullptr);
+        SetTmxFile(tmxFile);
+    }
+}
+
 TmxFile2D* TileMap2D::GetTmxFile() const
 {
     return tmxFile_;
@@ -49,12 +49,17 @@ public:
 
     /// Set tmx file.
     void SetTmxFile(TmxFile2D* tmxFile);
+    /// Set whether tile layers are baked into chunk drawables instead of one node per tile. Recreates the layers if a tmx file is set.
+    void SetUseChunkedRendering(bool enable);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
 
     /// Return tmx file.
     TmxFile2D* GetTmxFile() const;
 
+    /// Return whether tile layers are baked into chunk drawables.
+    bool GetUseChunkedRendering() const { return useChunkedRendering_; }
+
     /// Return information.
     const TileMapInfo2D& GetInfo() const { return info_; }
 
@@ -79,6 +84,8 @@ private:
     SharedPtr<TmxFile2D> tmxFile_;
     /// Tile map information.
     TileMapInfo2D info_{};
+    /// Use chunked rendering for tile layers.
+    bool useChunkedRendering_{};
     /// Root node for tile map layer.
     SharedPtr<Node> rootNode_;
     /// Tile map layers.
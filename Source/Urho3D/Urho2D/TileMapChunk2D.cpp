@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Scene/Node.h"
+#include "../Urho2D/Renderer2D.h"
+#include "../Urho2D/Sprite2D.h"
+#include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
+#include "../Urho2D/TileMapLayer2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+TileMapChunk2D::TileMapChunk2D(Context* context) :
+    Drawable2D(context)
+{
+}
+
+TileMapChunk2D::~TileMapChunk2D() = default;
+
+void TileMapChunk2D::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TileMapChunk2D>();
+}
+
+void TileMapChunk2D::Initialize(TileMapLayer2D* layer, int startX, int startY, int width, int height)
+{
+    layer_ = layer;
+    startX_ = startX;
+    startY_ = startY;
+    width_ = width;
+    height_ = height;
+
+    MarkChunkDirty();
+}
+
+void TileMapChunk2D::MarkChunkDirty()
+{
+    MarkSourceBatchesDirty();
+    worldBoundingBoxDirty_ = true;
+}
+
+void TileMapChunk2D::OnWorldBoundingBoxUpdate()
+{
+    boundingBox_.Clear();
+    worldBoundingBox_.Clear();
+
+    // The baked vertices are already in world space
+    const ea::vector<SourceBatch2D>& sourceBatches = GetSourceBatches();
+    for (unsigned b = 0; b < sourceBatches.size(); ++b)
+    {
+        const ea::vector<Vertex2D>& vertices = sourceBatches[b].vertices_;
+        for (unsigned i = 0; i < vertices.size(); ++i)
+            worldBoundingBox_.Merge(vertices[i].position_);
+    }
+
+    if (worldBoundingBox_.Defined())
+        boundingBox_ = worldBoundingBox_.Transformed(node_->GetWorldTransform().Inverse());
+}
+
+void TileMapChunk2D::OnDrawOrderChanged()
+{
+    int drawOrder = GetDrawOrder();
+    for (unsigned b = 0; b < sourceBatches_.size(); ++b)
+        sourceBatches_[b].drawOrder_ = drawOrder;
+}
+
+void TileMapChunk2D::UpdateSourceBatches()
+{
+    if (!sourceBatchesDirty_)
+        return;
+
+    sourceBatches_.clear();
+    sourceBatchesDirty_ = false;
+
+    if (!layer_ || !layer_->GetTileMap() || !renderer_)
+        return;
+
+    const TileMapInfo2D& info = layer_->GetTileMap()->GetInfo();
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    int drawOrder = GetDrawOrder();
+    unsigned color = Color::WHITE.ToUInt();
+
+    // Tiles of one tileset texture are merged into one batch; appending rows in order keeps the painter order of the per-tile path
+    ea::unordered_map<Texture2D*, unsigned> batchIndices;
+
+    for (int y = startY_; y < startY_ + height_; ++y)
+    {
+        for (int x = startX_; x < startX_ + width_; ++x)
+        {
+            const Tile2D* tile = layer_->GetTile(x, y);
+            if (!tile)
+                continue;
+
+            Sprite2D* sprite = tile->GetSprite();
+            if (!sprite || !sprite->GetTexture())
+                continue;
+
+            Rect drawRect;
+            Rect textureRect;
+            if (!sprite->GetDrawRectangle(drawRect, tile->GetFlipX(), tile->GetFlipY()) ||
+                !sprite->GetTextureRectangle(textureRect, tile->GetFlipX(), tile->GetFlipY()))
+                continue;
+
+            Texture2D* texture = sprite->GetTexture();
+            auto it = batchIndices.find(texture);
+            if (it == batchIndices.end())
+            {
+                it = batchIndices.insert(ea::make_pair(texture, (unsigned)sourceBatches_.size())).first;
+                sourceBatches_.resize(sourceBatches_.size() + 1);
+                SourceBatch2D& batch = sourceBatches_.back();
+                batch.owner_ = this;
+                batch.drawOrder_ = drawOrder;
+                batch.material_ = renderer_->GetMaterial(texture, BLEND_ALPHA);
+            }
+
+            ea::vector<Vertex2D>& vertices = sourceBatches_[it->second].vertices_;
+            const Vector2 position = info.TileIndexToPosition(x, y);
+
+            /*
+            V1---------V2
+            |         / |
+            |       /   |
+            |     /     |
+            |   /       |
+            | /         |
+            V0---------V3
+            */
+            Vertex2D vertex0;
+            Vertex2D vertex1;
+            Vertex2D vertex2;
+            Vertex2D vertex3;
+
+            // Convert to world space
+            vertex0.position_ = worldTransform * Vector3(position.x_ + drawRect.min_.x_, position.y_ + drawRect.min_.y_, 0.0f);
+            vertex1.position_ = worldTransform * Vector3(position.x_ + drawRect.min_.x_, position.y_ + drawRect.max_.y_, 0.0f);
+            vertex2.position_ = worldTransform * Vector3(position.x_ + drawRect.max_.x_, position.y_ + drawRect.max_.y_, 0.0f);
+            vertex3.position_ = worldTransform * Vector3(position.x_ + drawRect.max_.x_, position.y_ + drawRect.min_.y_, 0.0f);
+
+            bool swapXY = tile->GetSwapXY();
+            vertex0.uv_ = textureRect.min_;
+            (swapXY ? vertex3.uv_ : vertex1.uv_) = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+            vertex2.uv_ = textureRect.max_;
+            (swapXY ? vertex1.uv_ : vertex3.uv_) = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+            vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = color;
+
+            vertices.push_back(vertex0);
+            vertices.push_back(vertex1);
+            vertices.push_back(vertex2);
+            vertices.push_back(vertex3);
+        }
+    }
+}
+
+}
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Urho2D/Drawable2D.h"
+
+namespace Urho3D
+{
+
+class TileMapLayer2D;
+
+/// Tile map chunk component. Bakes a block of tiles of one tile map layer into merged geometry, one source batch per tileset texture.
+class URHO3D_API TileMapChunk2D : public Drawable2D
+{
+    URHO3D_OBJECT(TileMapChunk2D, Drawable2D);
+
+public:
+    /// Construct.
+    explicit TileMapChunk2D(Context* context);
+    /// Destruct.
+    ~TileMapChunk2D() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Initialize with tile map layer and the tile index range to bake. Called by TileMapLayer2D.
+    void Initialize(TileMapLayer2D* layer, int startX, int startY, int width, int height);
+    /// Mark the baked geometry for rebuild after tiles of the chunk have changed.
+    void MarkChunkDirty();
+
+    /// Return first tile X index.
+    int GetStartX() const { return startX_; }
+
+    /// Return first tile Y index.
+    int GetStartY() const { return startY_; }
+
+    /// Return width in tiles.
+    int GetWidth() const { return width_; }
+
+    /// Return height in tiles.
+    int GetHeight() const { return height_; }
+
+protected:
+    /// Recalculate the world bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+    /// Handle draw order changed.
+    void OnDrawOrderChanged() override;
+    /// Update source batches.
+    void UpdateSourceBatches() override;
+
+private:
+    /// Tile map layer.
+    WeakPtr<TileMapLayer2D> layer_;
+    /// First tile X index.
+    int startX_{};
+    /// First tile Y index.
+    int startY_{};
+    /// Width in tiles.
+    int width_{};
+    /// Height in tiles.
+    int height_{};
+};
+
+}
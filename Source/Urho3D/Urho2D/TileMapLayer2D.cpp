@@ -28,6 +28,7 @@
 #include "../Scene/Node.h"
 #include "../Urho2D/StaticSprite2D.h"
 #include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
 #include "../Urho2D/TileMapLayer2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
@@ -36,6 +37,8 @@
 namespace Urho3D
 {
 
+static const int TILE_MAP_CHUNK_SIZE = 16;
+
 TileMapLayer2D::TileMapLayer2D(Context* context) :
     Component(context)
 {
@@ -214,6 +217,11 @@ void TileMapLayer2D::Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer)
     SetVisible(tmxLayer_->IsVisible());
 }
 
+void TileMapLayer2D::SetUseChunkedRendering(bool enable)
+{
+    useChunkedRendering_ = enable;
+}
+
 void TileMapLayer2D::SetDrawOrder(int drawOrder)
 {
     if (drawOrder == drawOrder_)
@@ -226,9 +234,9 @@ void TileMapLayer2D::SetDrawOrder(int drawOrder)
         if (!nodes_[i])
             continue;
 
-        auto* staticSprite = nodes_[i]->GetComponent<StaticSprite2D>();
-        if (staticSprite)
-            staticSprite->SetLayer(drawOrder_);
+        auto* drawable = nodes_[i]->GetDerivedComponent<Drawable2D>();
+        if (drawable)
+            drawable->SetLayer(drawOrder_);
     }
 }
 
@@ -291,7 +299,7 @@ Tile2D* TileMapLayer2D::GetTile(int x, int y) const
 
 Node* TileMapLayer2D::GetTileNode(int x, int y) const
 {
-    if (!tileLayer_)
+    if (!tileLayer_ || useChunkedRendering_)
         return nullptr;
 
     if (x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
@@ -341,6 +349,47 @@ void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
 
     int width = tileLayer->GetWidth();
     int height = tileLayer->GetHeight();
+
+    if (useChunkedRendering_)
+    {
+        // Bake blocks of tiles into one merged drawable per chunk instead of creating a node per tile
+        for (int startY = 0; startY < height; startY += TILE_MAP_CHUNK_SIZE)
+        {
+            for (int startX = 0; startX < width; startX += TILE_MAP_CHUNK_SIZE)
+            {
+                int chunkWidth = Min(TILE_MAP_CHUNK_SIZE, width - startX);
+                int chunkHeight = Min(TILE_MAP_CHUNK_SIZE, height - startY);
+
+                // Skip chunks without any tiles
+                bool empty = true;
+                for (int y = startY; empty && y < startY + chunkHeight; ++y)
+                {
+                    for (int x = startX; x < startX + chunkWidth; ++x)
+                    {
+                        if (tileLayer->GetTile(x, y))
+                        {
+                            empty = false;
+                            break;
+                        }
+                    }
+                }
+                if (empty)
+                    continue;
+
+                SharedPtr<Node> chunkNode(GetNode()->CreateTemporaryChild("Chunk"));
+
+                auto* chunk = chunkNode->CreateComponent<TileMapChunk2D>();
+                chunk->Initialize(this, startX, startY, chunkWidth, chunkHeight);
+                chunk->SetLayer(drawOrder_);
+                chunk->SetOrderInLayer((int)nodes_.size());
+
+                nodes_.push_back(chunkNode);
+            }
+        }
+
+        return;
+    }
+
     nodes_.resize((unsigned) (width * height));
 
     const TileMapInfo2D& info = tileMap_->GetInfo();
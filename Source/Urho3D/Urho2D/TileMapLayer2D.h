@@ -35,6 +35,7 @@ namespace Urho3D
 class DebugRenderer;
 class Node;
 class TileMap2D;
+class TileMapChunk2D;
 class TmxImageLayer2D;
 class TmxLayer2D;
 class TmxObjectGroup2D;
@@ -58,6 +59,8 @@ public:
 
     /// Initialize with tile map and tmx layer.
     void Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer);
+    /// Set whether tile layers are baked into chunk drawables instead of one node per tile. Must be set before Initialize().
+    void SetUseChunkedRendering(bool enable);
     /// Set draw order.
     void SetDrawOrder(int drawOrder);
     /// Set visible.
@@ -75,6 +78,9 @@ public:
     /// Return visible.
     bool IsVisible() const { return visible_; }
 
+    /// Return whether tile layers are baked into chunk drawables.
+    bool GetUseChunkedRendering() const { return useChunkedRendering_; }
+
     /// Return has property.
     bool HasProperty(const ea::string& name) const;
     /// Return property.
@@ -86,7 +92,7 @@ public:
     int GetWidth() const;
     /// Return height (for tile layer only).
     int GetHeight() const;
-    /// Return tile node (for tile layer only).
+    /// Return tile node (for tile layer only). Not available in chunked rendering mode.
     Node* GetTileNode(int x, int y) const;
     /// Return tile (for tile layer only).
     Tile2D* GetTile(int x, int y) const;
@@ -123,6 +129,8 @@ private:
     int drawOrder_{};
     /// Visible.
     bool visible_{true};
+    /// Use chunked rendering for tile layers.
+    bool useChunkedRendering_{};
     /// Tile node or image nodes.
     ea::vector<SharedPtr<Node> > nodes_;
 };
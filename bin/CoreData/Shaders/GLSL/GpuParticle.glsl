@@ -0,0 +1,91 @@
+#include "Uniforms.glsl"
+#include "Samplers.glsl"
+#include "Transform.glsl"
+#include "ScreenPos.glsl"
+#include "Fog.glsl"
+
+varying vec2 vTexCoord;
+varying vec4 vWorldPos;
+varying vec4 vColor;
+
+#ifdef COMPILEVS
+uniform vec3 cConstantForce;
+uniform float cDampingForce;
+uniform float cSizeAdd;
+uniform float cSizeMul;
+uniform vec4 cColorStart;
+uniform vec4 cColorEnd;
+uniform vec2 cColorTimeRange;
+#endif
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+
+    // Vertex data: iPos.xyz = spawn position, iPos.w = spawn time, iTangent.xyz = initial velocity,
+    // iTangent.w = time to live, iBlendWeights = size / rotation / rotation speed, iTexCoord1 = corner signs
+    float age = cElapsedTime - iPos.w;
+    float timeToLive = iTangent.w;
+    float active = (age >= 0.0 && age < timeToLive) ? 1.0 : 0.0;
+
+    // Closed-form velocity integration with exponential damping:
+    // v(t) = v0 * exp(-d*t) + F * (1 - exp(-d*t)) / d
+    float k1;
+    float k2;
+    if (cDampingForce > 0.0)
+    {
+        float decay = exp(-cDampingForce * age);
+        k1 = (1.0 - decay) / cDampingForce;
+        k2 = (age - k1) / cDampingForce;
+    }
+    else
+    {
+        k1 = age;
+        k2 = 0.5 * age * age;
+    }
+
+    vec3 particlePos = iPos.xyz + iTangent.xyz * k1 + cConstantForce * k2;
+    vec3 worldPos = (vec4(particlePos, 1.0) * modelMatrix).xyz;
+
+    // Size over lifetime; cSizeMul is a per second growth factor. Dead particles collapse to degenerate quads
+    float scale = max(1.0 + cSizeAdd * age, 0.0) * pow(cSizeMul, age) * active;
+    vec2 corner = iTexCoord1 * iBlendWeights.xy * scale;
+
+    float angle = radians(iBlendWeights.z + iBlendWeights.w * age);
+    float sinAngle = sin(angle);
+    float cosAngle = cos(angle);
+    vec2 offset = vec2(corner.x * cosAngle + corner.y * sinAngle, -corner.x * sinAngle + corner.y * cosAngle);
+
+    // Expand along the camera axes
+    worldPos += (vec4(offset.x, offset.y, 0.0, 0.0) * cViewInv).xyz;
+
+    gl_Position = GetClipPos(worldPos);
+    vTexCoord = iTexCoord;
+    vWorldPos = vec4(worldPos, GetDepth(gl_Position));
+
+    float colorTime = clamp((age - cColorTimeRange.x) / max(cColorTimeRange.y - cColorTimeRange.x, 0.0001), 0.0, 1.0);
+    vColor = mix(cColorStart, cColorEnd, colorTime) * iColor;
+}
+
+void PS()
+{
+    // Get material diffuse albedo
+    #ifdef DIFFMAP
+        vec4 diffColor = cMatDiffColor * vColor * texture2D(sDiffMap, vTexCoord);
+        #ifdef ALPHAMASK
+            if (diffColor.a < 0.5)
+                discard;
+        #endif
+    #else
+        vec4 diffColor = cMatDiffColor * vColor;
+    #endif
+
+    // Get fog factor
+    #ifdef HEIGHTFOG
+        float fogFactor = GetHeightFogFactor(vWorldPos.w, vWorldPos.y);
+    #else
+        float fogFactor = GetFogFactor(vWorldPos.w);
+    #endif
+
+    gl_FragColor = vec4(GetFog(diffColor.rgb, fogFactor), diffColor.a);
+}
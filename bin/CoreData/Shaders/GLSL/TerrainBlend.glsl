@@ -51,10 +51,23 @@ uniform vec2 cDetailTiling;
 uniform mediump vec2 cDetailTiling;
 #endif
 
+#if defined(COMPILEVS) && defined(LODMORPH)
+attribute vec2 iTexCoord2;
+uniform vec4 cLodMorph;
+#endif
+
 void VS()
 {
     mat4 modelMatrix = iModelMatrix;
-    vec3 worldPos = GetWorldPos(modelMatrix);
+    #ifdef LODMORPH
+        // Morph vertices that disappear on the next coarser LOD level toward their coarse height to avoid popping
+        vec4 morphedPos = iPos;
+        if (iTexCoord2.y < cLodMorph.y + 1.5)
+            morphedPos.y = mix(morphedPos.y, iTexCoord2.x, cLodMorph.x);
+        vec3 worldPos = (morphedPos * modelMatrix).xyz;
+    #else
+        vec3 worldPos = GetWorldPos(modelMatrix);
+    #endif
     gl_Position = GetClipPos(worldPos);
     vNormal = GetWorldNormal(modelMatrix);
     vWorldPos = vec4(worldPos, GetDepth(gl_Position));
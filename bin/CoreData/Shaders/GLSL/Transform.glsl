@@ -31,10 +31,61 @@ attribute vec4 iCubeTexCoord1;
     #else
         attribute vec4 iTexCoord7;
     #endif
+    #ifdef CROWD
+        // Per-instance crowd animation parameters in the first extra instancing buffer element:
+        // base matrix indices of the two animation frames to blend and the blend factor
+        #ifdef SPHERICALHARMONICS
+            attribute vec4 iTexCoord14;
+            #define iCrowdAnimation iTexCoord14
+        #else
+            attribute vec4 iTexCoord8;
+            #define iCrowdAnimation iTexCoord8
+        #endif
+    #endif
 #endif
 attribute float iObjectIndex;
 
 #ifdef SKINNED
+#ifdef SKINTEX
+uniform sampler2D sSkinMatrixMap;
+uniform float cSkinMatrixIndex;
+
+// Width of the skin matrix texture. Must match SKIN_TEXTURE_WIDTH in Renderer.h
+#define SKINTEX_WIDTH 1024
+
+vec4 FetchSkinMatrixRow(int index)
+{
+    return texelFetch(sSkinMatrixMap, ivec2(index - (index / SKINTEX_WIDTH) * SKINTEX_WIDTH, index / SKINTEX_WIDTH), 0);
+}
+
+#if defined(CROWD) && defined(INSTANCED)
+mat4 FetchSkinMatrix(int blendIndex)
+{
+    // Blend between the two baked animation frames of the crowd instance
+    int idxA = (int(iCrowdAnimation.x) + blendIndex) * 3;
+    int idxB = (int(iCrowdAnimation.y) + blendIndex) * 3;
+    float frameLerp = iCrowdAnimation.z;
+    const vec4 lastColumn = vec4(0.0, 0.0, 0.0, 1.0);
+    return mat4(mix(FetchSkinMatrixRow(idxA), FetchSkinMatrixRow(idxB), frameLerp),
+        mix(FetchSkinMatrixRow(idxA + 1), FetchSkinMatrixRow(idxB + 1), frameLerp),
+        mix(FetchSkinMatrixRow(idxA + 2), FetchSkinMatrixRow(idxB + 2), frameLerp), lastColumn);
+}
+#else
+mat4 FetchSkinMatrix(int blendIndex)
+{
+    int idx = (int(cSkinMatrixIndex) + blendIndex) * 3;
+    const vec4 lastColumn = vec4(0.0, 0.0, 0.0, 1.0);
+    return mat4(FetchSkinMatrixRow(idx), FetchSkinMatrixRow(idx + 1), FetchSkinMatrixRow(idx + 2), lastColumn);
+}
+#endif
+
+mat4 GetSkinMatrix(vec4 blendWeights, vec4 blendIndices)
+{
+    ivec4 idx = ivec4(blendIndices);
+    return FetchSkinMatrix(idx.x) * blendWeights.x + FetchSkinMatrix(idx.y) * blendWeights.y +
+        FetchSkinMatrix(idx.z) * blendWeights.z + FetchSkinMatrix(idx.w) * blendWeights.w;
+}
+#else
 mat4 GetSkinMatrix(vec4 blendWeights, vec4 blendIndices)
 {
     ivec4 idx = ivec4(blendIndices) * 3;
@@ -45,6 +96,7 @@ mat4 GetSkinMatrix(vec4 blendWeights, vec4 blendIndices)
         mat4(cSkinMatrices[idx.w], cSkinMatrices[idx.w + 1], cSkinMatrices[idx.w + 2], lastColumn) * blendWeights.w;
 }
 #endif
+#endif
 
 #ifdef INSTANCED
 mat4 GetInstanceMatrix()
@@ -54,6 +106,63 @@ mat4 GetInstanceMatrix()
 }
 #endif
 
+#ifdef MORPHTEX
+uniform sampler2D sMorphDeltaMap;
+uniform float cMorphWeights[64];
+uniform float cNumMorphs;
+uniform float cMorphVertexCount;
+
+// Width of the morph delta texture. Must match MORPH_TEXTURE_WIDTH in AnimatedModel.cpp
+#define MORPHTEX_WIDTH 1024
+
+#if defined(MORPHNORMAL) && defined(MORPHTANGENT)
+    #define MORPHTEX_ELEMENTS 3
+#elif defined(MORPHNORMAL) || defined(MORPHTANGENT)
+    #define MORPHTEX_ELEMENTS 2
+#else
+    #define MORPHTEX_ELEMENTS 1
+#endif
+
+vec3 FetchMorphDelta(int element)
+{
+    vec3 delta = vec3(0.0, 0.0, 0.0);
+    for (int i = 0; i < int(cNumMorphs); ++i)
+    {
+        float weight = cMorphWeights[i];
+        if (weight != 0.0)
+        {
+            int texel = (i * int(cMorphVertexCount) + gl_VertexID) * MORPHTEX_ELEMENTS + element;
+            delta += weight * texelFetch(sMorphDeltaMap,
+                ivec2(texel - (texel / MORPHTEX_WIDTH) * MORPHTEX_WIDTH, texel / MORPHTEX_WIDTH), 0).xyz;
+        }
+    }
+    return delta;
+}
+
+vec4 GetMorphedPos()
+{
+    return vec4(iPos.xyz + FetchMorphDelta(0), iPos.w);
+}
+
+#ifdef MORPHNORMAL
+vec3 GetMorphedNormal()
+{
+    return iNormal + FetchMorphDelta(1);
+}
+#endif
+
+#ifdef MORPHTANGENT
+vec4 GetMorphedTangent()
+{
+    #ifdef MORPHNORMAL
+    return vec4(iTangent.xyz + FetchMorphDelta(2), iTangent.w);
+    #else
+    return vec4(iTangent.xyz + FetchMorphDelta(1), iTangent.w);
+    #endif
+}
+#endif
+#endif
+
 mat3 GetNormalMatrix(mat4 modelMatrix)
 {
     return mat3(modelMatrix[0].xyz, modelMatrix[1].xyz, modelMatrix[2].xyz);
@@ -162,7 +271,10 @@ vec3 GetTrailNormal(vec4 iPos, vec3 iParentPos, vec3 iForward)
 }
 #endif
 
-#if defined(SKINNED)
+#if defined(SKINNED) && defined(INSTANCED) && defined(CROWD)
+    // Crowd instances combine the baked skinning matrix with the per-instance world transform
+    #define iModelMatrix (GetSkinMatrix(iBlendWeights, iBlendIndices) * GetInstanceMatrix())
+#elif defined(SKINNED)
     #define iModelMatrix GetSkinMatrix(iBlendWeights, iBlendIndices)
 #elif defined(INSTANCED)
     #define iModelMatrix GetInstanceMatrix()
@@ -180,6 +292,8 @@ vec3 GetWorldPos(mat4 modelMatrix)
         return GetTrailPos(iPos, iTangent.xyz, iTangent.w, modelMatrix);
     #elif defined(TRAILBONE)
         return GetTrailPos(iPos, iTangent.xyz, iTangent.w, modelMatrix);
+    #elif defined(MORPHTEX)
+        return (GetMorphedPos() * modelMatrix).xyz;
     #else
         return (iPos * modelMatrix).xyz;
     #endif
@@ -195,6 +309,8 @@ vec3 GetWorldNormal(mat4 modelMatrix)
         return GetTrailNormal(iPos);
     #elif defined(TRAILBONE)
         return GetTrailNormal(iPos, iTangent.xyz, iNormal);
+    #elif defined(MORPHNORMAL)
+        return normalize(GetMorphedNormal() * GetNormalMatrix(modelMatrix));
     #else
         return normalize(iNormal * GetNormalMatrix(modelMatrix));
     #endif
@@ -206,6 +322,8 @@ vec4 GetWorldTangent(mat4 modelMatrix)
         return vec4(normalize(vec3(1.0, 0.0, 0.0) * cBillboardRot), 1.0);
     #elif defined(DIRBILLBOARD)
         return vec4(normalize(vec3(1.0, 0.0, 0.0) * GetNormalMatrix(modelMatrix)), 1.0);
+    #elif defined(MORPHTANGENT)
+        return vec4(normalize(GetMorphedTangent().xyz * GetNormalMatrix(modelMatrix)), iTangent.w);
     #else
         return vec4(normalize(iTangent.xyz * GetNormalMatrix(modelMatrix)), iTangent.w);
     #endif
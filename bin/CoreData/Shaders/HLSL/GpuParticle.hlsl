@@ -0,0 +1,129 @@
+#include "Uniforms.hlsl"
+#include "Samplers.hlsl"
+#include "Transform.hlsl"
+#include "ScreenPos.hlsl"
+#include "Fog.hlsl"
+
+#ifndef D3D11
+
+// D3D9 uniforms
+uniform float3 cConstantForce;
+uniform float cDampingForce;
+uniform float cSizeAdd;
+uniform float cSizeMul;
+uniform float4 cColorStart;
+uniform float4 cColorEnd;
+uniform float2 cColorTimeRange;
+
+#else
+
+// D3D11 constant buffers
+#ifdef COMPILEVS
+cbuffer CustomVS : register(b6)
+{
+    float3 cConstantForce;
+    float cDampingForce;
+    float cSizeAdd;
+    float cSizeMul;
+    float4 cColorStart;
+    float4 cColorEnd;
+    float2 cColorTimeRange;
+}
+#endif
+
+#endif
+
+void VS(float4 iPos : POSITION,
+    float4 iColor : COLOR0,
+    float2 iTexCoord : TEXCOORD0,
+    float2 iCorner : TEXCOORD1,
+    float4 iTangent : TANGENT,
+    float4 iBlendWeights : BLENDWEIGHT,
+    out float2 oTexCoord : TEXCOORD0,
+    out float4 oWorldPos : TEXCOORD2,
+    out float4 oColor : COLOR0,
+    #if defined(D3D11) && defined(CLIPPLANE)
+        out float oClip : SV_CLIPDISTANCE0,
+    #endif
+    out float4 oPos : OUTPOSITION)
+{
+    float4x3 modelMatrix = iModelMatrix;
+
+    // Vertex data: iPos.xyz = spawn position, iPos.w = spawn time, iTangent.xyz = initial velocity,
+    // iTangent.w = time to live, iBlendWeights = size / rotation / rotation speed, iCorner = corner signs
+    float age = cElapsedTime - iPos.w;
+    float timeToLive = iTangent.w;
+    float active = (age >= 0.0 && age < timeToLive) ? 1.0 : 0.0;
+
+    // Closed-form velocity integration with exponential damping:
+    // v(t) = v0 * exp(-d*t) + F * (1 - exp(-d*t)) / d
+    float k1;
+    float k2;
+    if (cDampingForce > 0.0)
+    {
+        float decay = exp(-cDampingForce * age);
+        k1 = (1.0 - decay) / cDampingForce;
+        k2 = (age - k1) / cDampingForce;
+    }
+    else
+    {
+        k1 = age;
+        k2 = 0.5 * age * age;
+    }
+
+    float3 particlePos = iPos.xyz + iTangent.xyz * k1 + cConstantForce * k2;
+    float3 worldPos = mul(float4(particlePos, 1.0), modelMatrix);
+
+    // Size over lifetime; cSizeMul is a per second growth factor. Dead particles collapse to degenerate quads
+    float scale = max(1.0 + cSizeAdd * age, 0.0) * pow(cSizeMul, age) * active;
+    float2 corner = iCorner * iBlendWeights.xy * scale;
+
+    float angle = radians(iBlendWeights.z + iBlendWeights.w * age);
+    float sinAngle;
+    float cosAngle;
+    sincos(angle, sinAngle, cosAngle);
+    float2 offset = float2(corner.x * cosAngle + corner.y * sinAngle, -corner.x * sinAngle + corner.y * cosAngle);
+
+    // Expand along the camera axes
+    worldPos += mul(float4(offset.x, offset.y, 0.0, 0.0), cViewInv);
+
+    oPos = GetClipPos(worldPos);
+    oTexCoord = iTexCoord;
+    oWorldPos = float4(worldPos, GetDepth(oPos));
+
+    #if defined(D3D11) && defined(CLIPPLANE)
+        oClip = dot(oPos, cClipPlane);
+    #endif
+
+    float colorTime = clamp((age - cColorTimeRange.x) / max(cColorTimeRange.y - cColorTimeRange.x, 0.0001), 0.0, 1.0);
+    oColor = lerp(cColorStart, cColorEnd, colorTime) * iColor;
+}
+
+void PS(float2 iTexCoord : TEXCOORD0,
+    float4 iWorldPos : TEXCOORD2,
+    float4 iColor : COLOR0,
+    #if defined(D3D11) && defined(CLIPPLANE)
+        float iClip : SV_CLIPDISTANCE0,
+    #endif
+    out float4 oColor : OUTCOLOR0)
+{
+    // Get material diffuse albedo
+    #ifdef DIFFMAP
+        float4 diffColor = cMatDiffColor * iColor * Sample2D(DiffMap, iTexCoord);
+        #ifdef ALPHAMASK
+            if (diffColor.a < 0.5)
+                discard;
+        #endif
+    #else
+        float4 diffColor = cMatDiffColor * iColor;
+    #endif
+
+    // Get fog factor
+    #ifdef HEIGHTFOG
+        float fogFactor = GetHeightFogFactor(iWorldPos.w, iWorldPos.y);
+    #else
+        float fogFactor = GetFogFactor(iWorldPos.w);
+    #endif
+
+    oColor = float4(GetFog(diffColor.rgb, fogFactor), diffColor.a);
+}
@@ -10,6 +10,9 @@
 // D3D9 uniforms and samplers
 #ifdef COMPILEVS
 uniform float2 cDetailTiling;
+#ifdef LODMORPH
+uniform float4 cLodMorph;
+#endif
 #else
 sampler2D sWeightMap0 : register(s0);
 sampler2D sDetailMap1 : register(s1);
@@ -24,6 +27,9 @@ sampler2D sDetailMap3 : register(s3);
 cbuffer CustomVS : register(b6)
 {
     float2 cDetailTiling;
+    #ifdef LODMORPH
+        float4 cLodMorph;
+    #endif
 }
 #else
 Texture2D tWeightMap0 : register(t0);
@@ -41,6 +47,9 @@ SamplerState sDetailMap3 : register(s3);
 void VS(float4 iPos : POSITION,
     float3 iNormal : NORMAL,
     float2 iTexCoord : TEXCOORD0,
+    #ifdef LODMORPH
+        float2 iMorph : TEXCOORD2,
+    #endif
     #ifdef SKINNED
         float4 iBlendWeights : BLENDWEIGHT,
         int4 iBlendIndices : BLENDINDICES,
@@ -78,7 +87,15 @@ void VS(float4 iPos : POSITION,
     out float4 oPos : OUTPOSITION)
 {
     float4x3 modelMatrix = iModelMatrix;
-    float3 worldPos = GetWorldPos(modelMatrix);
+    #ifdef LODMORPH
+        // Morph vertices that disappear on the next coarser LOD level toward their coarse height to avoid popping
+        float4 morphedPos = iPos;
+        if (iMorph.y < cLodMorph.y + 1.5)
+            morphedPos.y = lerp(morphedPos.y, iMorph.x, cLodMorph.x);
+        float3 worldPos = mul(morphedPos, modelMatrix);
+    #else
+        float3 worldPos = GetWorldPos(modelMatrix);
+    #endif
     oPos = GetClipPos(worldPos);
     oNormal = GetWorldNormal(modelMatrix);
     oWorldPos = float4(worldPos, GetDepth(oPos));